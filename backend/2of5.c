@@ -37,23 +37,23 @@
 #define inline _inline
 #endif
 
-static const char *C25MatrixTable[10] = {
+static const char *const C25MatrixTable[10] = {
     "113311", "311131", "131131", "331111", "113131",
     "313111", "133111", "111331", "311311", "131311"
 };
 
-static const char *C25MatrixStartStop[2] = { "411111", "41111" };
+static const char *const C25MatrixStartStop[2] = { "411111", "41111" };
 
-static const char *C25IndustTable[10] = {
+static const char *const C25IndustTable[10] = {
     "1111313111", "3111111131", "1131111131", "3131111111", "1111311131",
     "3111311111", "1131311111", "1111113131", "3111113111", "1131113111"
 };
 
-static const char *C25IndustStartStop[2] = { "313111", "31113" };
+static const char *const C25IndustStartStop[2] = { "313111", "31113" };
 
-static const char *C25IataLogicStartStop[2] = { "1111", "311" };
+static const char *const C25IataLogicStartStop[2] = { "1111", "311" };
 
-static const char *C25InterTable[10] = {
+static const char *const C25InterTable[10] = {
     "11331", "31113", "13113", "33111", "11313",
     "31311", "13311", "11133", "31131", "13131"
 };
@@ -76,10 +76,12 @@ static unsigned int gs1_checksum(const unsigned char source[], const int length)
 
 /* Common to Standard (Matrix), Industrial, IATA, and Data Logic */
 static int c25_common(struct zint_symbol *symbol, const unsigned char source[], int length, const int max,
-            const char *table[10], const char *start_stop[2], const int error_base) {
+            const char *const table[10], const char *const start_stop[2], const int error_base) {
 
     int i, error_number;
     char dest[512]; /* Largest destination 6 + (80 + 1) * 6 + 5 + 1 = 498 */
+    char *d = dest;
+    const int table_len = (int) strlen(table[0]); /* All entries same length */
     unsigned char temp[80 + 1 + 1]; /* Largest maximum 80 */
     int have_checkdigit = symbol->option_2 == 1 || symbol->option_2 == 2;
 
@@ -87,7 +89,7 @@ static int c25_common(struct zint_symbol *symbol, const unsigned char source[],
         sprintf(symbol->errtxt, "%d: Input too long (maximum %d)", error_base, max);
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         sprintf(symbol->errtxt, "%d: Invalid characters in data", error_base + 1);
         return error_number;
@@ -102,21 +104,26 @@ static int c25_common(struct zint_symbol *symbol, const unsigned char source[],
     }
 
     /* start character */
-    strcpy(dest, start_stop[0]);
+    strcpy(d, start_stop[0]);
+    d += strlen(d);
 
     for (i = 0; i < length; i++) {
-        lookup(NEON, table, temp[i], dest);
+        memcpy(d, table[temp[i] - '0'], table_len);
+        d += table_len;
     }
 
     /* Stop character */
-    strcat(dest, start_stop[1]);
+    strcpy(d, start_stop[1]);
+    d += strlen(d);
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
-    ustrcpy(symbol->text, temp);
-    if (symbol->option_2 == 2) {
-        /* Remove check digit from HRT */
-        symbol->text[length - 1] = '\0';
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, temp);
+        if (symbol->option_2 == 2) {
+            /* Remove check digit from HRT */
+            symbol->text[length - 1] = '\0';
+        }
     }
 
     return error_number;
@@ -143,23 +150,14 @@ INTERNAL int logic_two_of_five(struct zint_symbol *symbol, unsigned char source[
 }
 
 /* Code 2 of 5 Interleaved */
-INTERNAL int interleaved_two_of_five(struct zint_symbol *symbol, unsigned char source[], int length) {
-
-    int i, j, error_number;
-    char bars[7], spaces[7], mixed[14], dest[512]; /* 4 + (90 + 2) * 5 + 3 + 1 = 468 */
+/* Common to Interleaved, ITF-14, DP Leitcode, DP Identcode - `source` must be digits only, length <= 90 */
+static void c25inter_common(struct zint_symbol *symbol, const unsigned char source[], int length) {
+    int i, j;
+    char dest[512]; /* 4 + (90 + 2) * 5 + 3 + 1 = 468 */
+    char *d = dest;
     unsigned char temp[90 + 2 + 1];
     int have_checkdigit = symbol->option_2 == 1 || symbol->option_2 == 2;
 
-    if (length > 90) {
-        strcpy(symbol->errtxt, "309: Input too long");
-        return ZINT_ERROR_TOO_LONG;
-    }
-    error_number = is_sane(NEON, source, length);
-    if (error_number == ZINT_ERROR_INVALID_DATA) {
-        strcpy(symbol->errtxt, "310: Invalid characters in data");
-        return error_number;
-    }
-
     temp[0] = '\0';
     /* Input must be an even number of characters for Interlaced 2 of 5 to work:
        if an odd number of characters has been entered and no check digit or an even number and have check digit
@@ -177,37 +175,50 @@ INTERNAL int interleaved_two_of_five(struct zint_symbol *symbol, unsigned char s
     }
 
     /* start character */
-    strcpy(dest, "1111");
+    memcpy(d, "1111", 4);
+    d += 4;
 
     for (i = 0; i < length; i += 2) {
-        int k = 0;
-        /* look up the bars and the spaces and put them in two strings */
-        bars[0] = '\0';
-        lookup(NEON, C25InterTable, temp[i], bars);
-        spaces[0] = '\0';
-        lookup(NEON, C25InterTable, temp[i + 1], spaces);
-
-        /* then merge (interlace) the strings together */
-        for (j = 0; j <= 4; j++) {
-            mixed[k] = bars[j];
-            k++;
-            mixed[k] = spaces[j];
-            k++;
+        /* look up the bars and the spaces */
+        const char *const bars = C25InterTable[temp[i] - '0'];
+        const char *const spaces = C25InterTable[temp[i + 1] - '0'];
+
+        /* then merge (interlace) them together */
+        for (j = 0; j < 5; j++) {
+            *d++ = bars[j];
+            *d++ = spaces[j];
         }
-        mixed[k] = '\0';
-        strcat(dest, mixed);
     }
 
     /* Stop character */
-    strcat(dest, "311");
+    memcpy(d, "311", 3);
+    d += 3;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
-    ustrcpy(symbol->text, temp);
-    if (symbol->option_2 == 2) {
-        /* Remove check digit from HRT */
-        symbol->text[length - 1] = '\0';
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, temp);
+        if (symbol->option_2 == 2) {
+            /* Remove check digit from HRT */
+            symbol->text[length - 1] = '\0';
+        }
     }
+}
+
+INTERNAL int interleaved_two_of_five(struct zint_symbol *symbol, unsigned char source[], int length) {
+    int error_number;
+
+    if (length > 90) {
+        strcpy(symbol->errtxt, "309: Input too long");
+        return ZINT_ERROR_TOO_LONG;
+    }
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
+    if (error_number == ZINT_ERROR_INVALID_DATA) {
+        strcpy(symbol->errtxt, "310: Invalid characters in data");
+        return error_number;
+    }
+
+    c25inter_common(symbol, source, length);
 
     return error_number;
 }
@@ -222,7 +233,7 @@ INTERNAL int itf14(struct zint_symbol *symbol, unsigned char source[], int lengt
         return ZINT_ERROR_TOO_LONG;
     }
 
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "312: Invalid character in data");
         return error_number;
@@ -238,8 +249,10 @@ INTERNAL int itf14(struct zint_symbol *symbol, unsigned char source[], int lengt
     /* Calculate the check digit - the same method used for EAN-13 */
     localstr[13] = check_digit(gs1_checksum(localstr, 13));
     localstr[14] = '\0';
-    error_number = interleaved_two_of_five(symbol, (unsigned char *) localstr, 14);
-    ustrcpy(symbol->text, localstr);
+    c25inter_common(symbol, localstr, 14); /* Already checked */
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, localstr);
+    }
 
     if (!((symbol->output_options & BARCODE_BOX) || (symbol->output_options & BARCODE_BIND))) {
         // If no option has been selected then uses default box option
@@ -253,6 +266,37 @@ INTERNAL int itf14(struct zint_symbol *symbol, unsigned char source[], int lengt
     return error_number;
 }
 
+/* Encode ITF-14 `localstr`, 14 digits including check digit, for the fixed-length fast path of
+   `ZBarcode_Encode_Batch()`, the settings (without a check digit option) being as adjusted by a full encode. Sets
+   the modules directly a digit pair at a time rather than via `expand()`, giving the same 135 modules as
+   `c25inter_common()` */
+INTERNAL void itf14_batch_draw(struct zint_symbol *symbol, const unsigned char localstr[]) {
+    int x = 0, i, j;
+
+    set_module_bits(symbol, 0, x, 0x05, 4); /* Start (bar, space, bar, space) */
+    x += 4;
+    for (i = 0; i < 14; i += 2) {
+        const char *const bars = C25InterTable[localstr[i] - '0'];
+        const char *const spaces = C25InterTable[localstr[i + 1] - '0'];
+        unsigned long bits = 0;
+        int n = 0;
+
+        for (j = 0; j < 5; j++) {
+            bits |= ((1UL << (bars[j] - '0')) - 1) << n;
+            n += bars[j] - '0' + spaces[j] - '0';
+        }
+        set_module_bits(symbol, 0, x, bits, n); /* 18 modules */
+        x += n;
+    }
+    set_module_bits(symbol, 0, x, 0x17, 5); /* Stop (wide bar, space, bar) */
+
+    symbol->width = x + 5;
+    symbol->rows = 1;
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, localstr);
+    }
+}
+
 /* Deutshe Post Leitcode */
 INTERNAL int dpleit(struct zint_symbol *symbol, unsigned char source[], int length) {
     int i, error_number;
@@ -265,7 +309,7 @@ INTERNAL int dpleit(struct zint_symbol *symbol, unsigned char source[], int leng
         strcpy(symbol->errtxt, "313: Input wrong length");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "314: Invalid characters in data");
         return error_number;
@@ -285,8 +329,10 @@ INTERNAL int dpleit(struct zint_symbol *symbol, unsigned char source[], int leng
     }
     localstr[13] = check_digit(count);
     localstr[14] = '\0';
-    error_number = interleaved_two_of_five(symbol, localstr, 14);
-    ustrcpy(symbol->text, localstr);
+    c25inter_common(symbol, localstr, 14); /* Already checked */
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, localstr);
+    }
     return error_number;
 }
 
@@ -301,7 +347,7 @@ INTERNAL int dpident(struct zint_symbol *symbol, unsigned char source[], int len
         strcpy(symbol->errtxt, "315: Input wrong length");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "316: Invalid characters in data");
         return error_number;
@@ -321,7 +367,9 @@ INTERNAL int dpident(struct zint_symbol *symbol, unsigned char source[], int len
     }
     localstr[11] = check_digit(count);
     localstr[12] = '\0';
-    error_number = interleaved_two_of_five(symbol, localstr, 12);
-    ustrcpy(symbol->text, localstr);
+    c25inter_common(symbol, localstr, 12); /* Already checked */
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, localstr);
+    }
     return error_number;
 }
@@ -0,0 +1,166 @@
+/*  async.c - background encode and print requests (`ZBarcode_Submit()`) */
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <stdio.h>
+#include "common.h"
+#include "library.h"
+
+/* An encode and print submitted by `ZBarcode_Submit()` */
+struct zint_request {
+    struct zint_symbol *symbol;
+    unsigned char *source; /* Copy of input */
+    int length;
+    int rotate_angle;
+    long long deadline; /* `z_clock_ms()` time, or 0 if none */
+    void (*callback)(void *user_data, struct zint_symbol *symbol, int error_number);
+    void *user_data;
+    struct z_async *async;
+    struct zint_allocator allocator; /* Of `symbol`, which may be deleted before the request */
+};
+
+/* Return tagged error if `request` has been cancelled or is past its deadline, else 0 */
+static int submit_check(struct zint_request *request) {
+    if (z_async_cancelled(request->async)) {
+        strcpy(request->symbol->errtxt, "718: Request cancelled");
+        return error_tag(request->symbol->errtxt, ZINT_ERROR_CANCELLED);
+    }
+    if (request->deadline && z_clock_ms() > request->deadline) {
+        strcpy(request->symbol->errtxt, "719: Request deadline exceeded");
+        return error_tag(request->symbol->errtxt, ZINT_ERROR_CANCELLED);
+    }
+    return 0;
+}
+
+/* Background task of `ZBarcode_Submit()`, checking for cancellation and the deadline before each stage */
+static void submit_task(void *arg, int index) {
+    struct zint_request *request = (struct zint_request *) arg;
+    struct zint_symbol *symbol = request->symbol;
+    int error_number;
+    int first_err = 0;
+
+    (void)index;
+
+    if (!(error_number = submit_check(request))) {
+        error_number = ZBarcode_Encode(symbol, request->source, request->length);
+        if (error_number < ZINT_ERROR) {
+            first_err = error_number;
+            if (!(error_number = submit_check(request))) {
+                error_number = ZBarcode_Print(symbol, request->rotate_angle);
+                if (error_number == 0) {
+                    error_number = first_err;
+                }
+            }
+        }
+    }
+    /* A cancel that arrives before settling wins, even if the output was made */
+    if (z_async_finish(request->async) && error_number != ZINT_ERROR_CANCELLED) {
+        strcpy(symbol->errtxt, "718: Request cancelled");
+        error_number = error_tag(symbol->errtxt, ZINT_ERROR_CANCELLED);
+    }
+
+    (*request->callback)(request->user_data, symbol, error_number);
+}
+
+/* Encode `source` into `symbol` and print it to memory (BARCODE_MEMORY_FILE is set), rotated by `rotate_angle`, on
+   a background thread, then call `callback(user_data, symbol, error_number)` (on that thread) with the result as
+   from `ZBarcode_Encode_and_Print()`. If `timeout_ms` > 0 the request fails with ZINT_ERROR_CANCELLED if a stage
+   would start after that many milliseconds. `symbol` must not be used until the callback. Returns a handle for
+   `ZBarcode_Cancel()`, to be freed by `ZBarcode_Request_Delete()`, or NULL (with `symbol->errtxt` set and the
+   callback not called) if the request is invalid or can't be set up. Without threads it's run before returning */
+struct zint_request *ZBarcode_Submit(struct zint_symbol *symbol, const unsigned char *source, int in_length,
+            int rotate_angle, int timeout_ms,
+            void (*callback)(void *user_data, struct zint_symbol *symbol, int error_number), void *user_data) {
+    struct zint_request *request;
+    int error_number;
+
+    if (!symbol) return NULL;
+
+    if (!callback) {
+        strcpy(symbol->errtxt, "748: Callback NULL");
+        (void) error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return NULL;
+    }
+    if ((error_number = check_source(symbol, source, &in_length))) {
+        (void) error_tag(symbol->errtxt, error_number);
+        return NULL;
+    }
+
+    if (!(request = (struct zint_request *) z_malloc(z_allocator(symbol), sizeof(struct zint_request)))
+            || !(request->source = (unsigned char *) z_malloc(z_allocator(symbol), in_length))) {
+        z_free(z_allocator(symbol), request);
+        strcpy(symbol->errtxt, "749: Insufficient memory for request");
+        (void) error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+        return NULL;
+    }
+    if (!(request->async = z_async_create(z_allocator(symbol), submit_task, request))) {
+        z_free(z_allocator(symbol), request->source);
+        z_free(z_allocator(symbol), request);
+        strcpy(symbol->errtxt, "749: Insufficient memory for request");
+        (void) error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+        return NULL;
+    }
+    memcpy(request->source, source, in_length);
+    request->symbol = symbol;
+    request->allocator = symbol->internal->allocator;
+    request->length = in_length;
+    request->rotate_angle = rotate_angle;
+    request->deadline = timeout_ms > 0 ? z_clock_ms() + timeout_ms : 0;
+    request->callback = callback;
+    request->user_data = user_data;
+    symbol->output_options |= BARCODE_MEMORY_FILE;
+
+    (void) z_async_start(request->async);
+
+    return request;
+}
+
+/* Ask the request `request` of `ZBarcode_Submit()` to stop, returning 0 if its callback will report
+   ZINT_ERROR_CANCELLED, or ZINT_ERROR_INVALID_OPTION if too late (its result already settled) */
+int ZBarcode_Cancel(struct zint_request *request) {
+
+    if (!request) return ZINT_ERROR_INVALID_DATA;
+
+    return z_async_cancel(request->async) ? 0 : ZINT_ERROR_INVALID_OPTION;
+}
+
+/* Wait for the request `request` of `ZBarcode_Submit()` to end (after its callback returns), then free it. Must not
+   be called from within the callback */
+void ZBarcode_Request_Delete(struct zint_request *request) {
+    struct zint_allocator allocator;
+
+    if (!request) return;
+
+    allocator = request->allocator;
+    z_async_delete(&allocator, request->async);
+    z_free(&allocator, request->source);
+    z_free(&allocator, request);
+}
@@ -33,11 +33,11 @@
 
 #define GDSET 	"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz #"
 
-static const char *AusNTable[10] = {
+static const char *const AusNTable[10] = {
     "00", "01", "02", "10", "11", "12", "20", "21", "22", "30"
 };
 
-static const char *AusCTable[64] = {
+static const char *const AusCTable[64] = {
     "222", "300", "301", "302", "310", "311", "312", "320", "321", "322",
     "000", "001", "002", "010", "011", "012", "020", "021", "022", "100", "101", "102", "110",
     "111", "112", "120", "121", "122", "200", "201", "202", "210", "211", "212", "220", "221",
@@ -46,7 +46,7 @@ static const char *AusCTable[64] = {
     "003", "013"
 };
 
-static const char *AusBarTable[64] = {
+static const char *const AusBarTable[64] = {
     "000", "001", "002", "003", "010", "011", "012", "013", "020", "021",
     "022", "023", "030", "031", "032", "033", "100", "101", "102", "103", "110", "111", "112",
     "113", "120", "121", "122", "123", "130", "131", "132", "133", "200", "201", "202", "203",
@@ -66,14 +66,14 @@ static inline char convert_pattern(char data, int shift) {
     return (data - '0') << shift;
 }
 
-/* Adds Reed-Solomon error correction to auspost */
-static void rs_error(char data_pattern[]) {
+/* Adds Reed-Solomon error correction to auspost, appending at `d`, and returns the new end */
+static char *rs_error(char data_pattern[], char *d) {
     int reader, len, triple_writer = 0;
     unsigned char triple[31];
     unsigned char result[5];
     rs_t rs;
 
-    for (reader = 2, len = (int) strlen(data_pattern); reader < len; reader += 3, triple_writer++) {
+    for (reader = 2, len = (int) (d - data_pattern); reader < len; reader += 3, triple_writer++) {
         triple[triple_writer] = convert_pattern(data_pattern[reader], 4)
                 + convert_pattern(data_pattern[reader + 1], 2)
                 + convert_pattern(data_pattern[reader + 2], 0);
@@ -84,8 +84,11 @@ static void rs_error(char data_pattern[]) {
     rs_encode(&rs, triple_writer, triple, result);
 
     for (reader = 4; reader > 0; reader--) {
-        strcat(data_pattern, AusBarTable[(int) result[reader - 1]]);
+        memcpy(d, AusBarTable[(int) result[reader - 1]], 3);
+        d += 3;
     }
+
+    return d;
 }
 
 /* Handles Australia Posts's 4 State Codes */
@@ -105,6 +108,7 @@ INTERNAL int australia_post(struct zint_symbol *symbol, unsigned char source[],
     int h;
 
     char data_pattern[200];
+    char *d = data_pattern;
     char fcc[3] = {0, 0, 0}, dpid[10];
     char localstr[30];
 
@@ -128,14 +132,14 @@ INTERNAL int australia_post(struct zint_symbol *symbol, unsigned char source[],
                 break;
             case 16:
                 strcpy(fcc, "59");
-                error_number = is_sane(NEON, source, length);
+                error_number = is_sane_chr(CHR_DIGIT, source, length);
                 break;
             case 18:
                 strcpy(fcc, "62");
                 break;
             case 23:
                 strcpy(fcc, "62");
-                error_number = is_sane(NEON, source, length);
+                error_number = is_sane_chr(CHR_DIGIT, source, length);
                 break;
             default:
                 strcpy(symbol->errtxt, "401: Auspost input is wrong length");
@@ -175,59 +179,65 @@ INTERNAL int australia_post(struct zint_symbol *symbol, unsigned char source[],
     /* Verifiy that the first 8 characters are numbers */
     memcpy(dpid, localstr, 8);
     dpid[8] = '\0';
-    error_number = is_sane(NEON, (unsigned char *) dpid, 8);
+    error_number = is_sane_chr(CHR_DIGIT, (unsigned char *) dpid, 8);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "405: Invalid characters in DPID");
         return error_number;
     }
 
     /* Start character */
-    strcpy(data_pattern, "13");
+    memcpy(d, "13", 2);
+    d += 2;
 
     /* Encode the FCC */
     for (reader = 0; reader < 2; reader++) {
-        lookup(NEON, AusNTable, fcc[reader], data_pattern);
+        memcpy(d, AusNTable[fcc[reader] - '0'], 2);
+        d += 2;
     }
 
     /* Delivery Point Identifier (DPID) */
     for (reader = 0; reader < 8; reader++) {
-        lookup(NEON, AusNTable, dpid[reader], data_pattern);
+        memcpy(d, AusNTable[dpid[reader] - '0'], 2);
+        d += 2;
     }
 
     /* Customer Information */
     if (h > 8) {
         if ((h == 13) || (h == 18)) {
             for (reader = 8; reader < h; reader++) {
-                lookup(GDSET, AusCTable, localstr[reader], data_pattern);
+                memcpy(d, AusCTable[posn(GDSET, localstr[reader])], 3);
+                d += 3;
             }
         } else if ((h == 16) || (h == 23)) {
             for (reader = 8; reader < h; reader++) {
-                lookup(NEON, AusNTable, localstr[reader], data_pattern);
+                memcpy(d, AusNTable[localstr[reader] - '0'], 2);
+                d += 2;
             }
         }
     }
 
     /* Filler bar */
-    h = (int) strlen(data_pattern);
+    h = (int) (d - data_pattern);
     switch (h) {
         case 22:
         case 37:
         case 52:
-            strcat(data_pattern, "3");
+            *d++ = '3';
             break;
         default:
             break;
     }
 
     /* Reed Solomon error correction */
-    rs_error(data_pattern);
+    d = rs_error(data_pattern, d);
 
     /* Stop character */
-    strcat(data_pattern, "13");
+    memcpy(d, "13", 2);
+    d += 2;
 
     /* Turn the symbol into a bar pattern ready for plotting */
     writer = 0;
-    h = (int) strlen(data_pattern);
+    h = (int) (d - data_pattern);
     for (loopey = 0; loopey < h; loopey++) {
         if ((data_pattern[loopey] == '1') || (data_pattern[loopey] == '0')) {
             set_module(symbol, 0, writer);
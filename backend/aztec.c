@@ -41,817 +41,468 @@
 
 #define AZTEC_MAX_CAPACITY  19968 /* ISO/IEC 24778:2008 5.3 Table 1 Maximum Symbol Bit Capacity */
 #define AZTEC_BIN_CAPACITY  17940 /* Above less 169 * 12 = 2028 bits (169 = 10% of 1664 + 3) */
-#define AZTEC_MAP_SIZE      22801 /* AztecMap Version 32 151 x 151 */
-#define AZTEC_MAP_POSN_MAX  20039 /* Maximum position index in AztecMap */
 
-static int az_count_doubles(const unsigned char source[], int i, const int length) {
-    int c = 0;
-
-    while ((i + 1 < length) && ((source[i] == '.') || (source[i] == ',')) && (source[i + 1] == ' ')) {
-        c++;
-        i += 2;
-    }
-
-    return c;
+/* Modes, in order of the `az_latch_seq` table (Table 1 "character sets" plus Byte mode) */
+#define AZ_U    0
+#define AZ_L    1
+#define AZ_M    2
+#define AZ_P    3
+#define AZ_D    4
+#define AZ_MODES 5
+
+/* Actions on data, packed into backtrack bytes as `(act << 5) | len` */
+#define AZ_ACT_CHR  0 /* Character or Punct pair in latched mode */
+#define AZ_ACT_PS   1 /* P/S followed by Punct character or pair */
+#define AZ_ACT_US   2 /* U/S followed by Upper character */
+#define AZ_ACT_BS   3 /* B/S with 5-bit length (up to 31 bytes) */
+#define AZ_ACT_BSL  4 /* B/S with 5 + 11-bit length (32 bytes or more) */
+
+#define AZ_INF      0x3FFFFFFF
+
+/* Latch sequences from mode to mode, each up to 3 codewords of (value, bit length), see Table 3 and Figure 4 */
+static const unsigned char az_latch_seq[AZ_MODES][AZ_MODES][3][2] = {
+    { /* U */
+        { { 0, 0 }, { 0, 0 }, { 0, 0 } }, { { 28, 5 }, { 0, 0 }, { 0, 0 } }, /* -, L/L */
+        { { 29, 5 }, { 0, 0 }, { 0, 0 } }, { { 29, 5 }, { 30, 5 }, { 0, 0 } }, /* M/L, M/L P/L */
+        { { 30, 5 }, { 0, 0 }, { 0, 0 } }, /* D/L */
+    },
+    { /* L */
+        { { 30, 5 }, { 14, 4 }, { 0, 0 } }, { { 0, 0 }, { 0, 0 }, { 0, 0 } }, /* D/L U/L, - */
+        { { 29, 5 }, { 0, 0 }, { 0, 0 } }, { { 29, 5 }, { 30, 5 }, { 0, 0 } }, /* M/L, M/L P/L */
+        { { 30, 5 }, { 0, 0 }, { 0, 0 } }, /* D/L */
+    },
+    { /* M */
+        { { 29, 5 }, { 0, 0 }, { 0, 0 } }, { { 28, 5 }, { 0, 0 }, { 0, 0 } }, /* U/L, L/L */
+        { { 0, 0 }, { 0, 0 }, { 0, 0 } }, { { 30, 5 }, { 0, 0 }, { 0, 0 } }, /* -, P/L */
+        { { 29, 5 }, { 30, 5 }, { 0, 0 } }, /* U/L D/L */
+    },
+    { /* P */
+        { { 31, 5 }, { 0, 0 }, { 0, 0 } }, { { 31, 5 }, { 28, 5 }, { 0, 0 } }, /* U/L, U/L L/L */
+        { { 31, 5 }, { 29, 5 }, { 0, 0 } }, { { 0, 0 }, { 0, 0 }, { 0, 0 } }, /* U/L M/L, - */
+        { { 31, 5 }, { 30, 5 }, { 0, 0 } }, /* U/L D/L */
+    },
+    { /* D */
+        { { 14, 4 }, { 0, 0 }, { 0, 0 } }, { { 14, 4 }, { 28, 5 }, { 0, 0 } }, /* U/L, U/L L/L */
+        { { 14, 4 }, { 29, 5 }, { 0, 0 } }, { { 14, 4 }, { 29, 5 }, { 30, 5 } }, /* U/L M/L, U/L M/L P/L */
+        { { 0, 0 }, { 0, 0 }, { 0, 0 } }, /* - */
+    },
+};
+
+/* Total bit lengths of above */
+static const char az_latch_len[AZ_MODES][AZ_MODES] = {
+    {  0,  5,  5, 10,  5 }, /* U */
+    {  9,  0,  5, 10,  5 }, /* L */
+    {  5,  5,  0,  5, 10 }, /* M */
+    {  5, 10, 10,  0, 10 }, /* P */
+    {  4,  9,  9, 14,  0 }, /* D */
+};
+
+static const char az_mode_chars[AZ_MODES + 1] = "ULMPD";
+
+/* Return value of character `c` in mode `mode`, or -1 if not in that mode's character set */
+static int az_char_value(const unsigned char c, const int mode) {
+    if (c >= 128) {
+        return -1;
+    }
+    switch (c) {
+        case ' ':
+            return mode == AZ_P ? -1 : 1;
+        case 13: /* CR */
+            return mode == AZ_M ? 14 : mode == AZ_P ? 1 : -1;
+        case ',':
+            return mode == AZ_P ? 17 : mode == AZ_D ? 12 : -1;
+        case '.':
+            return mode == AZ_P ? 19 : mode == AZ_D ? 13 : -1;
+    }
+    return is_chr(CHR_AZ_U << mode, c) ? AztecSymbolChar[c] : -1;
 }
 
-static int az_count_dotcomma(const unsigned char source[], int i, const int length) {
-    int c = 0;
-
-    while (i < length && ((source[i] == '.') || (source[i] == ','))) {
-        c++;
-        i++;
-    }
-
-    return c;
+/* Return bit flags of the modes whose character sets include `c` */
+static int az_char_modes(const unsigned char c) {
+    return (chr_class[c] >> CHR_AZ_SHIFT) & 0x1F;
 }
 
-static int az_count_chr(const unsigned char source[], int i, const int length, const unsigned char chr) {
-    int c = 0;
-
-    while (i < length && source[i] == chr) {
-        c++;
-        i++;
+/* Return Punct value of the 2-character combination (CR LF), (. SP), (, SP) or (: SP) at `s`, or -1 if none */
+static int az_pair_value(const unsigned char s[]) {
+    if (s[0] == 13) {
+        return s[1] == 10 ? 2 : -1;
     }
-
-    return c;
-}
-
-static char az_get_next_mode(const char encode_mode[], const int src_len, int i) {
-    int current_mode = encode_mode[i];
-
-    do {
-        i++;
-    } while ((i < src_len) && (encode_mode[i] == current_mode));
-    if (i >= src_len) {
-        return 'E';
-    } else {
-        return encode_mode[i];
+    if (s[1] == ' ') {
+        switch (s[0]) {
+            case '.': return 3;
+            case ',': return 4;
+            case ':': return 5;
+        }
     }
+    return -1;
 }
 
-static int az_bin_append_posn(const int arg, const int length, char *binary, const int bin_posn) {
+/* Append the `length` bits of `arg`, returning 0 if that would exceed the binary capacity */
+static int az_bits_append(struct zint_bits *bits, const int arg, const int length) {
 
-    if (bin_posn + length > AZTEC_BIN_CAPACITY) {
+    if (bits->posn + length > AZTEC_BIN_CAPACITY) {
         return 0; /* Fail */
     }
-    return bin_append_posn(arg, length, binary, bin_posn);
+    bits_append(bits, arg, length);
+    return 1;
 }
 
-static int aztec_text_process(const unsigned char source[], int src_len, char binary_string[], const int gs1,
-            const int eci, int *data_length, const int debug) {
-
-    int i, j;
-    char current_mode;
-    int count;
-    char next_mode;
-    int reduced_length;
-    int byte_mode = 0;
-    int bp;
-
-#ifndef _MSC_VER
-    char encode_mode[src_len + 1];
-    unsigned char reduced_source[src_len + 1];
-    char reduced_encode_mode[src_len + 1];
-#else
-    char *encode_mode = (char *) _alloca(src_len + 1);
-    unsigned char *reduced_source = (unsigned char *) _alloca(src_len + 1);
-    char *reduced_encode_mode = (char *) _alloca(src_len + 1);
-#endif
-
-    for (i = 0; i < src_len; i++) {
-        if (source[i] >= 128) {
-            encode_mode[i] = 'B';
-        } else {
-            encode_mode[i] = AztecModes[(int) source[i]];
-        }
+/* Append the Punct character or pair of length `len` at `s`, returning 0 on overflow */
+static int az_punct_append(const unsigned char s[], const int len, const int gs1, struct zint_bits *bits) {
+    if (len == 2) {
+        return az_bits_append(bits, az_pair_value(s), 5);
     }
-
-    // Deal first with letter combinations which can be combined to one codeword
-    // Combinations are (CR LF) (. SP) (, SP) (: SP) in Punct mode
-    current_mode = 'U';
-    for (i = 0; i + 1 < src_len; i++) {
-        // Combination (CR LF) should always be in Punct mode
-        if ((source[i] == 13) && (source[i + 1] == 10)) {
-            encode_mode[i] = 'P';
-            encode_mode[i + 1] = 'P';
-
-        // Combination (: SP) should always be in Punct mode
-        } else if ((source[i] == ':') && (source[i + 1] == ' ')) {
-            encode_mode[i + 1] = 'P';
-
-        // Combinations (. SP) and (, SP) sometimes use fewer bits in Digit mode
-        } else if (((source[i] == '.') || (source[i] == ',')) && (source[i + 1] == ' ') && (encode_mode[i] == 'X')) {
-            count = az_count_doubles(source, i, src_len);
-            next_mode = az_get_next_mode(encode_mode, src_len, i);
-
-            if (current_mode == 'U') {
-                if ((next_mode == 'D') && (count <= 5)) {
-                    for (j = 0; j < (2 * count); j++) {
-                        encode_mode[i + j] = 'D';
-                    }
-                }
-
-            } else if (current_mode == 'L') {
-                if ((next_mode == 'D') && (count <= 4)) {
-                    for (j = 0; j < (2 * count); j++) {
-                        encode_mode[i + j] = 'D';
-                    }
-                }
-
-            } else if (current_mode == 'M') {
-                if ((next_mode == 'D') && (count == 1)) {
-                    encode_mode[i] = 'D';
-                    encode_mode[i + 1] = 'D';
-                }
-
-            } else if (current_mode == 'D') {
-                if ((next_mode != 'D') && (count <= 4)) {
-                    for (j = 0; j < (2 * count); j++) {
-                        encode_mode[i + j] = 'D';
-                    }
-                } else if ((next_mode == 'D') && (count <= 7)) {
-                    for (j = 0; j < (2 * count); j++) {
-                        encode_mode[i + j] = 'D';
-                    }
-                }
-            }
-
-            // Default is Punct mode
-            if (encode_mode[i] == 'X') {
-                encode_mode[i] = 'P';
-                encode_mode[i + 1] = 'P';
-            }
-        }
-
-        if ((encode_mode[i] != 'X') && (encode_mode[i] != 'B')) {
-            current_mode = encode_mode[i];
-        }
-    }
-
-    if (debug) {
-        printf("First Pass:\n");
-        for (i = 0; i < src_len; i++) {
-            printf("%c", encode_mode[i]);
-        }
-        printf("\n");
+    if (gs1 && s[0] == '[') {
+        return az_bits_append(bits, 0, 5 + 3); // FLG(n) FLG(0) = FNC1
     }
+    return az_bits_append(bits, az_char_value(s[0], AZ_P), 5);
+}
 
-    // Reduce two letter combinations to one codeword marked as [abcd] in Punct mode
-    i = 0;
-    j = 0;
-    while (i < src_len) {
-        if (i + 1 < src_len) {
-            if ((source[i] == 13) && (source[i + 1] == 10)) { // CR LF
-                reduced_source[j] = 'a';
-                reduced_encode_mode[j] = encode_mode[i];
-                i += 2;
-            } else if ((source[i] == '.') && (source[i + 1] == ' ') && (encode_mode[i] == 'P')) {
-                reduced_source[j] = 'b';
-                reduced_encode_mode[j] = encode_mode[i];
-                i += 2;
-            } else if ((source[i] == ',') && (source[i + 1] == ' ') && (encode_mode[i] == 'P')) {
-                reduced_source[j] = 'c';
-                reduced_encode_mode[j] = encode_mode[i];
-                i += 2;
-            } else if ((source[i] == ':') && (source[i + 1] == ' ')) {
-                reduced_source[j] = 'd';
-                reduced_encode_mode[j] = encode_mode[i];
-                i += 2;
-            } else {
-                reduced_source[j] = source[i];
-                reduced_encode_mode[j] = encode_mode[i];
-                i++;
-            }
-        } else {
-            reduced_source[j] = source[i];
-            reduced_encode_mode[j] = encode_mode[i];
-            i++;
-        }
-        j++;
+/* Encode data using the shortest sequence of latches, shifts and Byte runs, found by computing for each position
+ * the cheapest way of arriving there latched into each of the 5 modes (Byte mode returning to the mode it was
+ * shifted from). Runs in time linear in `src_len`, the cheapest start of a Byte run with 5-bit length (up to 31 long)
+ * being tracked as a sliding window minimum, and longer ones as a continuing run. The bits are packed into `binary`
+ * (see `bits_init()`), which must hold AZTEC_BIN_CAPACITY bits */
+static int aztec_text_process(struct zint_symbol *symbol, const unsigned char source[], int src_len,
+            unsigned char binary[], const int gs1, const int eci, const char *sa_header, int *data_length,
+            const int debug) {
+
+    int i, j, k, m, mode;
+    struct zint_bits bits;
+    int cost[32][AZ_MODES]; /* Costs ending latched in mode, indexed by position modulo 32 */
+    int in_cost[AZ_MODES]; /* Costs ending in mode before latching away */
+    int bsl_cost[AZ_M + 1] = { AZ_INF, AZ_INF, AZ_INF }; /* Costs ending in B/S 11-bit length run (U, L, M only) */
+    int bs_start[AZ_M + 1][32]; /* Start positions of B/S 5-bit length runs in order of increasing cost */
+    int bs_val[AZ_M + 1][32]; /* And their costs less 8 bits per byte from start of data */
+    int bs_head[AZ_M + 1] = { 0, 0, 0 }, bs_tail[AZ_M + 1] = { 0, 0, 0 }; /* Indexes into above modulo 32 */
+    int best, min_cost;
+
+    /* Punct pairs are the most compact encodation at 2.5 bits per character, so above this won't fit */
+    if (src_len > AZTEC_BIN_CAPACITY * 2 / 5) {
+        return ZINT_ERROR_TOO_LONG;
     }
 
-    reduced_length = j;
-
-    current_mode = 'U';
-    for (i = 0; i < reduced_length; i++) {
-        // Resolve Carriage Return (CR) which can be Punct or Mixed mode
-        if (reduced_source[i] == 13) {
-            count = az_count_chr(reduced_source, i, reduced_length, 13);
-            next_mode = az_get_next_mode(reduced_encode_mode, reduced_length, i);
-
-            if ((current_mode == 'U') && ((next_mode == 'U') || (next_mode == 'B')) && (count == 1)) {
-                reduced_encode_mode[i] = 'P';
-
-            } else if ((current_mode == 'L') && ((next_mode == 'L') || (next_mode == 'B')) && (count == 1)) {
-                reduced_encode_mode[i] = 'P';
-
-            } else if ((current_mode == 'P') || (next_mode == 'P')) {
-                reduced_encode_mode[i] = 'P';
-            }
-
-            if (current_mode == 'D') {
-                if (((next_mode == 'E') || (next_mode == 'U') || (next_mode == 'D') || (next_mode == 'B'))
-                        && (count <= 2)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'P';
-                    }
-                } else if ((next_mode == 'L') && (count == 1)) {
-                    reduced_encode_mode[i] = 'P';
-                }
-            }
-
-            // Default is Mixed mode
-            if (reduced_encode_mode[i] == 'X') {
-                reduced_encode_mode[i] = 'M';
-            }
-
-        // Resolve full stop and comma which can be in Punct or Digit mode
-        } else if ((reduced_source[i] == '.') || (reduced_source[i] == ',')) {
-            count = az_count_dotcomma(reduced_source, i, reduced_length);
-            next_mode = az_get_next_mode(reduced_encode_mode, reduced_length, i);
-
-            if (current_mode == 'U') {
-                if (((next_mode == 'U') || (next_mode == 'L') || (next_mode == 'M') || (next_mode == 'B'))
-                        && (count == 1)) {
-                    reduced_encode_mode[i] = 'P';
+    {
+        /* How each position reached in each mode, `(act << 5) | len` */
+        z_work_array2(symbol, unsigned char, in_act, src_len + 1, AZ_MODES);
+        /* Mode latched from at each position */
+        z_work_array2(symbol, unsigned char, latch_from, src_len + 1, AZ_MODES);
+        /* Bit flags per mode whether 11-bit length B/S run started here */
+        z_work_array(symbol, unsigned char, bsl_start, src_len + 1);
+        /* Forward sequence: mode of segment starting at position */
+        z_work_array(symbol, unsigned char, seg_mode, src_len + 1);
+        z_work_array(symbol, unsigned char, seg_act, src_len + 1); /* ...and its action */
+        z_work_array(symbol, short, seg_len, src_len + 1); /* ...and its length */
+
+        if (z_work_failed(in_act) || z_work_failed(latch_from) || z_work_failed(bsl_start)
+                || z_work_failed(seg_mode) || z_work_failed(seg_act) || z_work_failed(seg_len)) {
+            return z_work_error(symbol);
+        }
+
+        /* Start latched in Upper */
+        for (m = 0; m < AZ_MODES; m++) {
+            cost[0][m] = az_latch_len[AZ_U][m];
+            latch_from[0][m] = AZ_U;
+        }
+
+        for (j = 1; j <= src_len; j++) {
+            const unsigned char c = source[j - 1];
+            const int modes = az_char_modes(c);
+            const int pair = j >= 2 && az_pair_value(source + j - 2) >= 0;
+            const int p_len = gs1 && c == '[' ? 8 : modes & (1 << AZ_P) ? 5 : 0; /* Punct bits if any */
+            const int *prev = cost[(j - 1) & 0x1F];
+            const int *prev2 = cost[(j - 2) & 0x1F]; /* Only used if `pair` set */
+            int *cur = cost[j & 0x1F];
+            bsl_start[j] = 0;
+
+            /* Punct */
+            best = AZ_INF;
+            k = 1;
+            if (p_len) {
+                best = prev[AZ_P] + p_len;
+            }
+            if (pair && prev2[AZ_P] + 5 < best) {
+                best = prev2[AZ_P] + 5;
+                k = 2;
+            }
+            in_cost[AZ_P] = best;
+            in_act[j][AZ_P] = (unsigned char) ((AZ_ACT_CHR << 5) | k);
+
+            for (m = 0; m < AZ_MODES; m++) {
+                const int shift_len = m == AZ_D ? 4 : 5; /* Also character length */
+                int act = AZ_ACT_CHR, len = 1;
+
+                if (m == AZ_P) {
+                    continue;
                 }
-
-            } else if (current_mode == 'L') {
-                if ((next_mode == 'L') && (count <= 2)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'P';
-                    }
-                } else if (((next_mode == 'M') || (next_mode == 'B')) && (count == 1)) {
-                    reduced_encode_mode[i] = 'P';
+                best = modes & (1 << m) ? prev[m] + shift_len : AZ_INF;
+                if (p_len && prev[m] + shift_len + p_len < best) {
+                    best = prev[m] + shift_len + p_len;
+                    act = AZ_ACT_PS;
                 }
-
-            } else if (current_mode == 'M') {
-                if (((next_mode == 'E') || (next_mode == 'U') || (next_mode == 'L') || (next_mode == 'M'))
-                        && (count <= 4)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'P';
-                    }
-                } else if ((next_mode == 'B') && (count <= 2)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'P';
-                    }
+                if (pair && prev2[m] + shift_len + 5 < best) {
+                    best = prev2[m] + shift_len + 5;
+                    act = AZ_ACT_PS;
+                    len = 2;
                 }
-
-            } else if ((current_mode == 'P') && (next_mode != 'D') && (count <= 9)) {
-                for (j = 0; j < count; j++) {
-                    reduced_encode_mode[i + j] = 'P';
+                if ((m == AZ_L || m == AZ_D) && (modes & (1 << AZ_U)) && prev[m] + shift_len + 5 < best) {
+                    best = prev[m] + shift_len + 5;
+                    act = AZ_ACT_US;
+                    len = 1;
                 }
-            }
-
-            // Default is Digit mode
-            if (reduced_encode_mode[i] == 'X') {
-                reduced_encode_mode[i] = 'D';
-            }
-
-        // Resolve Space (SP) which can be any mode except Punct
-        } else if (reduced_source[i] == ' ') {
-            count = az_count_chr(reduced_source, i, reduced_length, ' ');
-            next_mode = az_get_next_mode(reduced_encode_mode, reduced_length, i);
-
-            if (current_mode == 'U') {
-                if ((next_mode == 'E') && (count <= 5)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'U';
-                    }
-                } else if (((next_mode == 'U') || (next_mode == 'L') || (next_mode == 'M') || (next_mode == 'P')
-                        || (next_mode == 'B')) && (count <= 9)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'U';
+                if (m != AZ_D) {
+                    /* Byte run with 5-bit length (B/S + 5 + 8 bits per byte): add run starting at previous position,
+                       dropping any costing as much or more, and any too far back */
+                    const int v = prev[m] - 8 * (j - 1);
+                    while (bs_tail[m] != bs_head[m] && bs_val[m][(bs_tail[m] - 1) & 0x1F] >= v) {
+                        bs_tail[m]--;
+                    }
+                    bs_start[m][bs_tail[m] & 0x1F] = j - 1;
+                    bs_val[m][bs_tail[m]++ & 0x1F] = v;
+                    if (bs_start[m][bs_head[m] & 0x1F] < j - 31) {
+                        bs_head[m]++;
+                    }
+                    if (bs_val[m][bs_head[m] & 0x1F] + 10 + 8 * j < best) {
+                        best = bs_val[m][bs_head[m] & 0x1F] + 10 + 8 * j;
+                        act = AZ_ACT_BS;
+                        len = j - bs_start[m][bs_head[m] & 0x1F];
+                    }
+                    /* Byte run with 11-bit length (B/S + 5 + 11 + 8 bits per byte), either continued or started */
+                    if (prev[m] + 21 < bsl_cost[m]) {
+                        bsl_cost[m] = prev[m] + 21;
+                        bsl_start[j] |= 1 << m;
+                    }
+                    bsl_cost[m] += 8;
+                    if (bsl_cost[m] < best) {
+                        best = bsl_cost[m];
+                        act = AZ_ACT_BSL;
+                        len = 0;
                     }
                 }
+                in_cost[m] = best;
+                in_act[j][m] = (unsigned char) ((act << 5) | len);
+            }
 
-            } else if (current_mode == 'L') {
-                if ((next_mode == 'E') && (count <= 5)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'L';
-                    }
-
-                } else if ((next_mode == 'U') && (count == 1)) {
-                    reduced_encode_mode[i] = 'L';
-
-                } else if ((next_mode == 'L') && (count <= 14)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'L';
-                    }
-
-                } else if (((next_mode == 'M') || (next_mode == 'P') || (next_mode == 'B')) && (count <= 9)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'L';
-                    }
+            /* Latch, preferring to stay in the same mode */
+            min_cost = in_cost[0];
+            for (m = 1; m < AZ_MODES; m++) {
+                if (in_cost[m] < min_cost) {
+                    min_cost = in_cost[m];
                 }
-
-            } else if (current_mode == 'M') {
-                if (((next_mode == 'E') || (next_mode == 'U')) && (count <= 9)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'M';
-                    }
-
-                } else if (((next_mode == 'L') || (next_mode == 'B')) && (count <= 14)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'M';
-                    }
-
-                } else if (((next_mode == 'M') || (next_mode == 'P')) && (count <= 19)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'M';
-                    }
+            }
+            for (m = 0; m < AZ_MODES; m++) {
+                cur[m] = in_cost[m];
+                latch_from[j][m] = m;
+                if (cur[m] <= min_cost + 4) { /* Can't be beaten as shortest latch is 4 bits */
+                    continue;
                 }
-
-            } else if (current_mode == 'P') {
-                if ((next_mode == 'E') && (count <= 5)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'U';
-                    }
-
-                } else if (((next_mode == 'U') || (next_mode == 'L') || (next_mode == 'M') || (next_mode == 'P')
-                        || (next_mode == 'B')) && (count <= 9)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'U';
+                for (i = 0; i < AZ_MODES; i++) {
+                    if (in_cost[i] + az_latch_len[i][m] < cur[m]) {
+                        cur[m] = in_cost[i] + az_latch_len[i][m];
+                        latch_from[j][m] = i;
                     }
                 }
             }
+        }
 
-            // Default is Digit mode
-            if (reduced_encode_mode[i] == 'X') {
-                reduced_encode_mode[i] = 'D';
+        /* Cheapest end state, which won't be a latch */
+        mode = AZ_U;
+        for (m = 1; m < AZ_MODES; m++) {
+            if (cost[src_len & 0x1F][m] < cost[src_len & 0x1F][mode]) {
+                mode = m;
             }
         }
-
-        if (reduced_encode_mode[i] != 'B') {
-            current_mode = reduced_encode_mode[i];
+        if (cost[src_len & 0x1F][mode] > AZTEC_BIN_CAPACITY) {
+            return ZINT_ERROR_TOO_LONG;
         }
-    }
-
-    // Decide when to use P/S instead of P/L and U/S instead of U/L
-    current_mode = 'U';
-    for (i = 0; i < reduced_length; i++) {
-
-        if (reduced_encode_mode[i] != current_mode) {
-
-            for (count = 0; ((i + count) < reduced_length)
-                            && (reduced_encode_mode[i + count] == reduced_encode_mode[i]); count++);
-            next_mode = az_get_next_mode(reduced_encode_mode, reduced_length, i);
-
-            if (reduced_encode_mode[i] == 'P') {
-                if ((current_mode == 'U') && (count <= 2)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'p';
-                    }
 
-                } else if ((current_mode == 'L') && (next_mode != 'U') && (count <= 2)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'p';
-                    }
-
-                } else if ((current_mode == 'L') && (next_mode == 'U') && (count == 1)) {
-                    reduced_encode_mode[i] = 'p';
-
-                } else if ((current_mode == 'M') && (next_mode != 'M') && (count == 1)) {
-                    reduced_encode_mode[i] = 'p';
-
-                } else if ((current_mode == 'M') && (next_mode == 'M') && (count <= 2)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'p';
-                    }
-
-                } else if ((current_mode == 'D') && (next_mode != 'D') && (count <= 3)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'p';
-                    }
-
-                } else if ((current_mode == 'D') && (next_mode == 'D') && (count <= 6)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'p';
-                    }
-                }
-
-            } else if (reduced_encode_mode[i] == 'U') {
-                if ((current_mode == 'L') && ((next_mode == 'L') || (next_mode == 'M')) && (count <= 2)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'u';
-                    }
-
-                } else if ((current_mode == 'L') && ((next_mode == 'E') || (next_mode == 'D') || (next_mode == 'B')
-                        || (next_mode == 'P')) && (count == 1)) {
-                    reduced_encode_mode[i] = 'u';
-
-                } else if ((current_mode == 'D') && (next_mode == 'D') && (count == 1)) {
-                    reduced_encode_mode[i] = 'u';
-
-                } else if ((current_mode == 'D') && (next_mode == 'P') && (count <= 2)) {
-                    for (j = 0; j < count; j++) {
-                        reduced_encode_mode[i + j] = 'u';
-                    }
-                }
+        /* Backtrack to get segments */
+        for (j = src_len; j > 0;) {
+            int act, len;
+            mode = latch_from[j][mode];
+            act = in_act[j][mode] >> 5;
+            len = in_act[j][mode] & 0x1F;
+            if (act == AZ_ACT_BSL) {
+                for (len = 1; !(bsl_start[j - len + 1] & (1 << mode)); len++);
             }
+            j -= len;
+            seg_mode[j] = (unsigned char) mode;
+            seg_act[j] = (unsigned char) act;
+            seg_len[j] = (short) len;
         }
 
-        if ((reduced_encode_mode[i] != 'p') && (reduced_encode_mode[i] != 'u') && (reduced_encode_mode[i] != 'B')) {
-            current_mode = reduced_encode_mode[i];
-        }
-    }
-
-    if (debug) {
-        for (i = 0; i < reduced_length; i++) {
-            printf("%c", reduced_source[i]);
-        }
-        printf("\n");
-        for (i = 0; i < reduced_length; i++) {
-            printf("%c", reduced_encode_mode[i]);
+        if (debug) {
+            printf("Modes:\n");
+            for (i = 0; i < src_len; i += seg_len[i]) {
+                for (j = 0; j < seg_len[i]; j++) {
+                    printf("%c", seg_act[i] == AZ_ACT_CHR ? az_mode_chars[seg_mode[i]]
+                                    : seg_act[i] == AZ_ACT_PS ? 'p' : seg_act[i] == AZ_ACT_US ? 'u' : 'B');
+                }
+            }
+            printf("\n");
         }
-        printf("\n");
-    }
 
-    *binary_string = '\0';
-    bp = 0;
+        bits_init(&bits, binary, 0);
 
-    if (gs1) {
-        bp = bin_append_posn(0, 5, binary_string, bp); // P/S
-        bp = bin_append_posn(0, 5, binary_string, bp); // FLG(n)
-        bp = bin_append_posn(0, 3, binary_string, bp); // FLG(0)
-    }
-
-    if (eci != 0) {
-        bp = bin_append_posn(0, 5, binary_string, bp); // P/S
-        bp = bin_append_posn(0, 5, binary_string, bp); // FLG(n)
-        if (eci < 10) {
-            bp = bin_append_posn(1, 3, binary_string, bp); // FLG(1)
-            bp = bin_append_posn(2 + eci, 4, binary_string, bp);
-        } else if (eci <= 99) {
-            bp = bin_append_posn(2, 3, binary_string, bp); // FLG(2)
-            bp = bin_append_posn(2 + (eci / 10), 4, binary_string, bp);
-            bp = bin_append_posn(2 + (eci % 10), 4, binary_string, bp);
-        } else if (eci <= 999) {
-            bp = bin_append_posn(3, 3, binary_string, bp); // FLG(3)
-            bp = bin_append_posn(2 + (eci / 100), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 100) / 10), 4, binary_string, bp);
-            bp = bin_append_posn(2 + (eci % 10), 4, binary_string, bp);
-        } else if (eci <= 9999) {
-            bp = bin_append_posn(4, 3, binary_string, bp); // FLG(4)
-            bp = bin_append_posn(2 + (eci / 1000), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 1000) / 100), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 100) / 10), 4, binary_string, bp);
-            bp = bin_append_posn(2 + (eci % 10), 4, binary_string, bp);
-        } else if (eci <= 99999) {
-            bp = bin_append_posn(5, 3, binary_string, bp); // FLG(5)
-            bp = bin_append_posn(2 + (eci / 10000), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 10000) / 1000), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 1000) / 100), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 100) / 10), 4, binary_string, bp);
-            bp = bin_append_posn(2 + (eci % 10), 4, binary_string, bp);
-        } else {
-            bp = bin_append_posn(6, 3, binary_string, bp); // FLG(6)
-            bp = bin_append_posn(2 + (eci / 100000), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 100000) / 10000), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 10000) / 1000), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 1000) / 100), 4, binary_string, bp);
-            bp = bin_append_posn(2 + ((eci % 100) / 10), 4, binary_string, bp);
-            bp = bin_append_posn(2 + (eci % 10), 4, binary_string, bp);
+        if (sa_header) {
+            /* Structured Append - M/L U/L then the header chars (all Upper), ending latched in Upper as at start */
+            bits_append(&bits, (29 << 5) | 29, 10); // M/L U/L
+            for (i = 0; sa_header[i]; i++) {
+                bits_append(&bits, az_char_value(sa_header[i], AZ_U), 5);
+            }
         }
-    }
 
-    current_mode = 'U';
-    for (i = 0; i < reduced_length; i++) {
-
-        if (reduced_encode_mode[i] != 'B') {
-            byte_mode = 0;
+        if (gs1) {
+            bits_append(&bits, 0, 5 + 5 + 3); // P/S FLG(n) FLG(0)
         }
 
-        if ((reduced_encode_mode[i] != current_mode) && (!byte_mode)) {
-            // Change mode
-            if (current_mode == 'U') {
-                switch (reduced_encode_mode[i]) {
-                    case 'L':
-                        if (!(bp = az_bin_append_posn(28, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // L/L
-                        break;
-                    case 'M':
-                        if (!(bp = az_bin_append_posn(29, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // M/L
-                        break;
-                    case 'P':
-                        if (!(bp = az_bin_append_posn(29, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // M/L
-                        if (!(bp = az_bin_append_posn(30, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // P/L
-                        break;
-                    case 'p':
-                        if (!(bp = az_bin_append_posn(0, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // P/S
-                        break;
-                    case 'D':
-                        if (!(bp = az_bin_append_posn(30, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // D/L
-                        break;
-                    case 'B':
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // B/S
-                        break;
-                }
-            } else if (current_mode == 'L') {
-                switch (reduced_encode_mode[i]) {
-                    case 'U':
-                        if (!(bp = az_bin_append_posn(30, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // D/L
-                        if (!(bp = az_bin_append_posn(14, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        break;
-                    case 'u':
-                        if (!(bp = az_bin_append_posn(28, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/S
-                        break;
-                    case 'M':
-                        if (!(bp = az_bin_append_posn(29, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // M/L
-                        break;
-                    case 'P':
-                        if (!(bp = az_bin_append_posn(29, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // M/L
-                        if (!(bp = az_bin_append_posn(30, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // P/L
-                        break;
-                    case 'p':
-                        if (!(bp = az_bin_append_posn(0, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // P/S
-                        break;
-                    case 'D':
-                        if (!(bp = az_bin_append_posn(30, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // D/L
-                        break;
-                    case 'B':
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // B/S
-                        break;
-                }
-            } else if (current_mode == 'M') {
-                switch (reduced_encode_mode[i]) {
-                    case 'U':
-                        if (!(bp = az_bin_append_posn(29, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        break;
-                    case 'L':
-                        if (!(bp = az_bin_append_posn(28, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // L/L
-                        break;
-                    case 'P':
-                        if (!(bp = az_bin_append_posn(30, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // P/L
-                        break;
-                    case 'p':
-                        if (!(bp = az_bin_append_posn(0, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // P/S
-                        break;
-                    case 'D':
-                        if (!(bp = az_bin_append_posn(29, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        if (!(bp = az_bin_append_posn(30, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // D/L
-                        break;
-                    case 'B':
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // B/S
-                        break;
-                }
-            } else if (current_mode == 'P') {
-                switch (reduced_encode_mode[i]) {
-                    case 'U':
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        break;
-                    case 'L':
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        if (!(bp = az_bin_append_posn(28, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // L/L
-                        break;
-                    case 'M':
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        if (!(bp = az_bin_append_posn(29, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // M/L
-                        break;
-                    case 'D':
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        if (!(bp = az_bin_append_posn(30, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // D/L
-                        break;
-                    case 'B':
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        current_mode = 'U';
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // B/S
-                        break;
-                }
-            } else if (current_mode == 'D') {
-                switch (reduced_encode_mode[i]) {
-                    case 'U':
-                        if (!(bp = az_bin_append_posn(14, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        break;
-                    case 'u':
-                        if (!(bp = az_bin_append_posn(15, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/S
-                        break;
-                    case 'L':
-                        if (!(bp = az_bin_append_posn(14, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        if (!(bp = az_bin_append_posn(28, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // L/L
-                        break;
-                    case 'M':
-                        if (!(bp = az_bin_append_posn(14, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        if (!(bp = az_bin_append_posn(29, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // M/L
-                        break;
-                    case 'P':
-                        if (!(bp = az_bin_append_posn(14, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        if (!(bp = az_bin_append_posn(29, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // M/L
-                        if (!(bp = az_bin_append_posn(30, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // P/L
-                        break;
-                    case 'p':
-                        if (!(bp = az_bin_append_posn(0, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // P/S
-                        break;
-                    case 'B':
-                        if (!(bp = az_bin_append_posn(14, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // U/L
-                        current_mode = 'U';
-                        if (!(bp = az_bin_append_posn(31, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // B/S
-                        break;
-                }
+        if (eci != 0) {
+            /* FLG(n) with n the number of digits (up to 6), each 2 + digit in 4 bits */
+            for (k = 1, m = 10; k < 6 && m <= eci; k++, m *= 10);
+            bits_append(&bits, 0, 5 + 5); // P/S FLG(n)
+            bits_append(&bits, k, 3);
+            for (m /= 10; m; m /= 10) {
+                bits_append(&bits, 2 + (eci / m) % 10, 4);
             }
+        }
 
-            // Byte mode length descriptor
-            if ((reduced_encode_mode[i] == 'B') && (!byte_mode)) {
-                for (count = 0; ((i + count) < reduced_length) && (reduced_encode_mode[i + count] == 'B'); count++);
+        mode = AZ_U;
+        for (i = 0; i < src_len; i += seg_len[i]) {
+            const int seg = seg_mode[i];
+            const int len = seg_len[i];
 
-                if (count > 2079) {
+            /* Latch */
+            for (k = 0; k < 3 && az_latch_seq[mode][seg][k][1]; k++) {
+                if (!az_bits_append(&bits, az_latch_seq[mode][seg][k][0], az_latch_seq[mode][seg][k][1])) {
                     return ZINT_ERROR_TOO_LONG;
                 }
-
-                if (count > 31) {
-                    /* Put 00000 followed by 11-bit number of bytes less 31 */
-                    if (!(bp = az_bin_append_posn(0, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG;
-                    if (!(bp = az_bin_append_posn(count - 31, 11, binary_string, bp))) return ZINT_ERROR_TOO_LONG;
-                } else {
-                    /* Put 5-bit number of bytes */
-                    if (!(bp = az_bin_append_posn(count, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG;
-                }
-                byte_mode = 1;
             }
+            mode = seg;
 
-            if ((reduced_encode_mode[i] != 'B') && (reduced_encode_mode[i] != 'u') && (reduced_encode_mode[i] != 'p')) {
-                current_mode = reduced_encode_mode[i];
-            }
-        }
-
-        if ((reduced_encode_mode[i] == 'U') || (reduced_encode_mode[i] == 'u')) {
-            if (reduced_source[i] == ' ') {
-                if (!(bp = az_bin_append_posn(1, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // SP
-            } else {
-                if (!(bp = az_bin_append_posn(AztecSymbolChar[(int) reduced_source[i]], 5, binary_string, bp)))
-                    return ZINT_ERROR_TOO_LONG;
-            }
-        } else if (reduced_encode_mode[i] == 'L') {
-            if (reduced_source[i] == ' ') {
-                if (!(bp = az_bin_append_posn(1, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // SP
-            } else {
-                if (!(bp = az_bin_append_posn(AztecSymbolChar[(int) reduced_source[i]], 5, binary_string, bp)))
-                    return ZINT_ERROR_TOO_LONG;
-            }
-        } else if (reduced_encode_mode[i] == 'M') {
-            if (reduced_source[i] == ' ') {
-                if (!(bp = az_bin_append_posn(1, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // SP
-            } else if (reduced_source[i] == 13) {
-                if (!(bp = az_bin_append_posn(14, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // CR
-            } else {
-                if (!(bp = az_bin_append_posn(AztecSymbolChar[(int) reduced_source[i]], 5, binary_string, bp)))
-                    return ZINT_ERROR_TOO_LONG;
-            }
-        } else if ((reduced_encode_mode[i] == 'P') || (reduced_encode_mode[i] == 'p')) {
-            if (gs1 && (reduced_source[i] == '[')) {
-                if (!(bp = az_bin_append_posn(0, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // FLG(n)
-                if (!(bp = az_bin_append_posn(0, 3, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // FLG(0) = FNC1
-            } else if (reduced_source[i] == 13) {
-                if (!(bp = az_bin_append_posn(1, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // CR
-            } else if (reduced_source[i] == 'a') {
-                if (!(bp = az_bin_append_posn(2, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // CR LF
-            } else if (reduced_source[i] == 'b') {
-                if (!(bp = az_bin_append_posn(3, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // . SP
-            } else if (reduced_source[i] == 'c') {
-                if (!(bp = az_bin_append_posn(4, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // , SP
-            } else if (reduced_source[i] == 'd') {
-                if (!(bp = az_bin_append_posn(5, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // : SP
-            } else if (reduced_source[i] == ',') {
-                if (!(bp = az_bin_append_posn(17, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // Comma
-            } else if (reduced_source[i] == '.') {
-                if (!(bp = az_bin_append_posn(19, 5, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // Full stop
-            } else {
-                if (!(bp = az_bin_append_posn(AztecSymbolChar[(int) reduced_source[i]], 5, binary_string, bp)))
-                    return ZINT_ERROR_TOO_LONG;
-            }
-        } else if (reduced_encode_mode[i] == 'D') {
-            if (reduced_source[i] == ' ') {
-                if (!(bp = az_bin_append_posn(1, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // SP
-            } else if (reduced_source[i] == ',') {
-                if (!(bp = az_bin_append_posn(12, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // Comma
-            } else if (reduced_source[i] == '.') {
-                if (!(bp = az_bin_append_posn(13, 4, binary_string, bp))) return ZINT_ERROR_TOO_LONG; // Full stop
-            } else {
-                if (!(bp = az_bin_append_posn(AztecSymbolChar[(int) reduced_source[i]], 4, binary_string, bp)))
-                    return ZINT_ERROR_TOO_LONG;
+            switch (seg_act[i]) {
+                case AZ_ACT_CHR:
+                    if (mode == AZ_P) {
+                        if (!az_punct_append(source + i, len, gs1, &bits)) return ZINT_ERROR_TOO_LONG;
+                    } else {
+                        if (!az_bits_append(&bits, az_char_value(source[i], mode), mode == AZ_D ? 4 : 5)) {
+                            return ZINT_ERROR_TOO_LONG;
+                        }
+                    }
+                    break;
+                case AZ_ACT_PS:
+                    if (!az_bits_append(&bits, 0, mode == AZ_D ? 4 : 5)) return ZINT_ERROR_TOO_LONG; // P/S
+                    if (!az_punct_append(source + i, len, gs1, &bits)) return ZINT_ERROR_TOO_LONG;
+                    break;
+                case AZ_ACT_US:
+                    if (!az_bits_append(&bits, ((mode == AZ_D ? 15 : 28) << 5) | az_char_value(source[i], AZ_U),
+                                (mode == AZ_D ? 4 : 5) + 5)) { // U/S
+                        return ZINT_ERROR_TOO_LONG;
+                    }
+                    break;
+                default: /* AZ_ACT_BS, AZ_ACT_BSL */
+                    for (j = 0; j < len; j += k) {
+                        k = len - j > 2078 ? 2078 : len - j; /* Split if more than 11-bit length allows */
+                        if (k > 31) {
+                            /* B/S, 00000 followed by 11-bit number of bytes less 31 */
+                            if (!az_bits_append(&bits, (31 << 16) | (k - 31), 5 + 5 + 11)) return ZINT_ERROR_TOO_LONG;
+                        } else {
+                            /* B/S, 5-bit number of bytes */
+                            if (!az_bits_append(&bits, (31 << 5) | k, 5 + 5)) return ZINT_ERROR_TOO_LONG;
+                        }
+                        for (m = 0; m < k; m++) {
+                            if (!az_bits_append(&bits, source[i + j + m], 8)) return ZINT_ERROR_TOO_LONG;
+                        }
+                    }
+                    break;
             }
-        } else if (reduced_encode_mode[i] == 'B') {
-            if (!(bp = az_bin_append_posn(reduced_source[i], 8, binary_string, bp))) return ZINT_ERROR_TOO_LONG;
         }
     }
 
+    *data_length = bits_flush(&bits);
+
     if (debug) {
         printf("Binary String:\n");
-        printf("%s\n", binary_string);
+        bits_print(binary, 0, *data_length);
+        printf("\n");
     }
 
-    *data_length = bp;
-
     return 0;
 }
 
-/* Prevent data from obscuring reference grid */
-static int az_avoidReferenceGrid(int output) {
+/* Calculate the length of the `data_length` bits of packed `binary` after bit-stuffing for codeword size
+   `codeword_size`, placing the codewords in `codewords` unless NULL. 7.3.1.2 "whenever the first B-1 bits ... are
+   all “0”s, then a dummy “1” is inserted..." "Similarly a message codeword that starts with B-1 “1”s has a dummy “0”
+   inserted..." Any last partial codeword is padded with 1s, with its last bit made 0 if then all 1s */
+static int az_bitrun_stuff(const unsigned char binary[], const int data_length, const int codeword_size,
+            unsigned int codewords[]) {
+    const unsigned int b1_ones = (1 << (codeword_size - 1)) - 1;
+    int i = 0, count = 0, remainder;
+    unsigned int cw;
+
+    while (data_length - i >= codeword_size) {
+        cw = bits_get(binary, i, codeword_size - 1);
+        if (cw == 0 || cw == b1_ones) {
+            /* Codeword of B-1 0s or B-1 1s, add the dummy bit */
+            cw = (cw << 1) | (cw == 0);
+            i += codeword_size - 1;
+        } else {
+            cw = bits_get(binary, i, codeword_size);
+            i += codeword_size;
+        }
+        if (codewords) {
+            codewords[count] = cw;
+        }
+        count++;
+    }
 
-    if (output > 10) {
-        output += (output - 11) / 15 + 1;
+    remainder = data_length - i;
+    if (remainder && codewords) {
+        const int pad = codeword_size - remainder;
+        cw = (bits_get(binary, i, remainder) << pad) | ((1 << pad) - 1);
+        if (cw == (b1_ones << 1) + 1) {
+            cw--;
+        }
+        codewords[count] = cw;
     }
 
-    return output;
+    return count * codeword_size + remainder;
 }
 
-/* Calculate the position of the bits in the grid (non-compact) */
-static void az_populate_map(short AztecMap[], const int layers) {
-    int layer, n, i;
-    int x, y;
-    const int offset = AztecOffset[layers - 1];
-    const int endoffset = 151 - offset;
-
-    for (layer = 0; layer < layers; layer++) {
-        const int start = (112 * layer) + (16 * layer * layer) + 2;
-        const int length = 28 + (layer * 4) + (layer + 1) * 4;
-        int av0, av1;
-        /* Top */
-        i = 0;
-        x = 64 - (layer * 2);
-        y = 63 - (layer * 2);
-        av0 = az_avoidReferenceGrid(y) * 151;
-        av1 = az_avoidReferenceGrid(y - 1) * 151;
-        for (n = start; n < (start + length); n += 2) {
-            int avxi = az_avoidReferenceGrid(x + i);
-            AztecMap[av0 + avxi] = n;
-            AztecMap[av1 + avxi] = n + 1;
-            i++;
-        }
-        /* Right */
-        i = 0;
-        x = 78 + (layer * 2);
-        y = 64 - (layer * 2);
-        av0 = az_avoidReferenceGrid(x);
-        av1 = az_avoidReferenceGrid(x + 1);
-        for (n = start + length; n < (start + (length * 2)); n += 2) {
-            int avyi = az_avoidReferenceGrid(y + i) * 151;
-            AztecMap[avyi + av0] = n;
-            AztecMap[avyi + av1] = n + 1;
-            i++;
-        }
-        /* Bottom */
-        i = 0;
-        x = 77 + (layer * 2);
-        y = 78 + (layer * 2);
-        av0 = az_avoidReferenceGrid(y) * 151;
-        av1 = az_avoidReferenceGrid(y + 1) * 151;
-        for (n = start + (length * 2); n < (start + (length * 3)); n += 2) {
-            int avxi = az_avoidReferenceGrid(x - i);
-            AztecMap[av0 + avxi] = n;
-            AztecMap[av1 + avxi] = n + 1;
-            i++;
-        }
-        /* Left */
-        i = 0;
-        x = 63 - (layer * 2);
-        y = 77 + (layer * 2);
-        av0 = az_avoidReferenceGrid(x);
-        av1 = az_avoidReferenceGrid(x - 1);
-        for (n = start + (length * 3); n < (start + (length * 4)); n += 2) {
-            int avyi = az_avoidReferenceGrid(y - i) * 151;
-            AztecMap[avyi + av0] = n;
-            AztecMap[avyi + av1] = n + 1;
-            i++;
-        }
-    }
+/* Whether map position `map` (>= 2) is set, the `total_bits` of packed codewords `binary` being taken in reverse
+   from position 2 and the `desc_len` bits of packed `descriptor` from position `desc_map` - 2 */
+static int az_pattern_bit(const unsigned char binary[], const int total_bits, const unsigned char descriptor[],
+            const int desc_len, const int desc_map, const int map) {
+    const int i = map - 2;
 
-    /* Copy "Core Symbol" (finder, descriptor, orientation) */
-    for (y = 0; y < 15; y++) {
-        memcpy(AztecMap + (y + 68) * 151 + 68, AztecMapCore[y], sizeof(short) * 15);
+    if (i < total_bits) {
+        return bits_is_set(binary, total_bits - 1 - i);
     }
-
-    /* Reference grid guide bars */
-    for (y = offset <= 11 ? 11 : AztecMapGridYOffsets[(offset - 11) / 16]; y < endoffset; y += 16) {
-        for (x = offset; x < endoffset; x++) {
-            AztecMap[(x * 151) + y] = x & 1;
-            AztecMap[(y * 151) + x] = x & 1;
-        }
+    if (i >= desc_map - 2 && i < desc_map - 2 + desc_len) {
+        return bits_is_set(descriptor, i - (desc_map - 2));
     }
+    return 0;
 }
 
 INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int length) {
     int x, y, i, j, p, data_blocks, ecc_blocks, layers, total_bits;
-    char bit_pattern[AZTEC_MAP_POSN_MAX + 1]; /* Note AZTEC_MAP_POSN_MAX > AZTEC_BIN_CAPACITY */
-    /* To lessen stack usage, share binary_string buffer with bit_pattern, as accessed separately */
-    char *binary_string = bit_pattern;
-    char descriptor[42];
-    char adjusted_string[AZTEC_MAX_CAPACITY];
-    short AztecMap[AZTEC_MAP_SIZE];
+    unsigned char descriptor[5]; /* Packed, 28 bits (compact) or 40 bits */
+    int desc_value, desc_len;
+    char sa_header[sizeof(symbol->structapp.id) + 5]; /* Structured Append " ID " plus index and count letters */
     unsigned char desc_data[4], desc_ecc[6];
-    int error_number, ecc_level, compact, data_length, data_maxsize, codeword_size, adjusted_length;
-    int remainder, padbits, count, gs1, adjustment_size;
+    int error_number, ecc_level, compact, data_length = 0, data_maxsize, codeword_size, adjusted_length;
+    int gs1, adjustment_size;
+    int stuffed_lengths[4] = { -1, -1, -1, -1 }; /* Bit-stuffed lengths for codeword sizes 6, 8, 10 and 12 */
     int debug = (symbol->debug & ZINT_DEBUG_PRINT), reader = 0;
     int comp_loop = 4;
     rs_t rs;
-    rs_uint_t rs_uint;
+    struct zint_bits bits;
+    /* Packed data bits, re-used for the final codewords (note AZTEC_MAX_CAPACITY > AZTEC_BIN_CAPACITY) */
+    z_work_array(symbol, unsigned char, binary, (AZTEC_MAX_CAPACITY + 7) / 8);
+    z_work_array(symbol, rs_uint_t, rs_uint, 1); /* Array of 1 so a pointer in all builds */
 
-#ifdef _MSC_VER
-    unsigned int* data_part;
-    unsigned int* ecc_part;
-#endif
-
-    memset(adjusted_string, 0, AZTEC_MAX_CAPACITY);
+    if (z_work_failed(binary) || z_work_failed(rs_uint)) {
+        return z_work_error(symbol);
+    }
 
     if ((symbol->input_mode & 0x07) == GS1_MODE) {
         gs1 = 1;
@@ -867,8 +518,39 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
         return ZINT_ERROR_INVALID_OPTION;
     }
 
-    error_number = aztec_text_process(source, length, binary_string, gs1, symbol->eci, &data_length, debug);
+    if (symbol->structapp.count) {
+        if (symbol->structapp.count < 2 || symbol->structapp.count > 26) {
+            strcpy(symbol->errtxt, "730: Structured Append count out of range (2-26)");
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        if (symbol->structapp.index < 1 || symbol->structapp.index > symbol->structapp.count) {
+            sprintf(symbol->errtxt, "731: Structured Append index out of range (1-%d)", symbol->structapp.count);
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        p = 0;
+        if (symbol->structapp.id[0]) {
+            /* Optional ID, delimited by spaces */
+            sa_header[p++] = ' ';
+            for (i = 0; i < (int) sizeof(symbol->structapp.id) && symbol->structapp.id[i]; i++) {
+                if (symbol->structapp.id[i] < 'A' || symbol->structapp.id[i] > 'Z') {
+                    strcpy(symbol->errtxt, "732: Invalid character in Structured Append ID (A-Z only)");
+                    return ZINT_ERROR_INVALID_OPTION;
+                }
+                sa_header[p++] = symbol->structapp.id[i];
+            }
+            sa_header[p++] = ' ';
+        }
+        sa_header[p++] = 'A' + symbol->structapp.index - 1;
+        sa_header[p++] = 'A' + symbol->structapp.count - 1;
+        sa_header[p] = '\0';
+    }
 
+    error_number = aztec_text_process(symbol, source, length, binary, gs1, symbol->eci,
+                        symbol->structapp.count ? sa_header : NULL, &data_length, debug);
+
+    if (error_number == ZINT_ERROR_MEMORY) {
+        return error_number;
+    }
     if (error_number != 0) {
         strcpy(symbol->errtxt, "502: Input too long or too many extended ASCII characters");
         return error_number;
@@ -979,65 +661,15 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
                 codeword_size = 12;
             }
 
-            j = 0;
-            count = 0;
-            for (i = 0; i < data_length; i++) {
-                if ((j + 1) % codeword_size == 0) {
-                    // Last bit of codeword
-                    /* 7.3.1.2 "whenever the first B-1 bits ... are all “0”s, then a dummy “1” is inserted..."
-                     * "Similarly a message codeword that starts with B-1 “1”s has a dummy “0” inserted..." */
-
-                    if (count == 0 || count == (codeword_size - 1)) {
-                        // Codeword of B-1 '0's or B-1 '1's
-                        adjusted_string[j] = count == 0 ? '1' : '0';
-                        j++;
-                        count = binary_string[i] == '1' ? 1 : 0;
-                    } else {
-                        count = 0;
-                    }
-
-                } else if (binary_string[i] == '1') { /* Skip B so only counting B-1 */
-                    count++;
-                }
-
-                adjusted_string[j] = binary_string[i];
-                j++;
+            /* Bit-stuffed length only depends on the codeword size, so only ever calculated once for each */
+            if (stuffed_lengths[(codeword_size - 6) >> 1] == -1) {
+                stuffed_lengths[(codeword_size - 6) >> 1] = az_bitrun_stuff(binary, data_length, codeword_size, NULL);
             }
-            adjusted_length = j;
+            adjusted_length = stuffed_lengths[(codeword_size - 6) >> 1];
             adjustment_size = adjusted_length - data_length;
 
-            /* Add padding */
-            remainder = adjusted_length % codeword_size;
-
-            padbits = codeword_size - remainder;
-            if (padbits == codeword_size) {
-                padbits = 0;
-            }
-
-            for (i = 0; i < padbits; i++) {
-                adjusted_string[adjusted_length++] = '1';
-            }
-
-            count = 0;
-            for (i = (adjusted_length - codeword_size); i < adjusted_length; i++) {
-                if (adjusted_string[i] == '1') {
-                    count++;
-                }
-            }
-            if (count == codeword_size) {
-                adjusted_string[adjusted_length - 1] = '0';
-            }
-
-            if (debug) {
-                printf("Codewords:\n");
-                for (i = 0; i < (adjusted_length / codeword_size); i++) {
-                    for (j = 0; j < codeword_size; j++) {
-                        printf("%c", adjusted_string[(i * codeword_size) + j]);
-                    }
-                    printf(" ");
-                }
-                printf("\n");
-            }
+            /* Padded length */
+            adjusted_length = ((adjusted_length + codeword_size - 1) / codeword_size) * codeword_size;
 
         } while (adjusted_length > data_maxsize);
         /* This loop will only repeat on the rare occasions when the rule about not having all 1s or all 0s
@@ -1071,51 +703,9 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
             codeword_size = 12;
         }
 
-        j = 0;
-        count = 0;
-        for (i = 0; i < data_length; i++) {
-
-            if ((j + 1) % codeword_size == 0) {
-                // Last bit of codeword
-
-                if (count == 0 || count == (codeword_size - 1)) {
-                    // Codeword of B-1 '0's or B-1 '1's
-                    adjusted_string[j] = count == 0 ? '1' : '0';
-                    j++;
-                    count = binary_string[i] == '1' ? 1 : 0;
-                } else {
-                    count = 0;
-                }
-
-            } else if (binary_string[i] == '1') { /* Skip B so only counting B-1 */
-                count++;
-            }
-
-            adjusted_string[j] = binary_string[i];
-            j++;
-        }
-        adjusted_length = j;
-
-        remainder = adjusted_length % codeword_size;
-
-        padbits = codeword_size - remainder;
-        if (padbits == codeword_size) {
-            padbits = 0;
-        }
-
-        for (i = 0; i < padbits; i++) {
-            adjusted_string[adjusted_length++] = '1';
-        }
-
-        count = 0;
-        for (i = (adjusted_length - codeword_size); i < adjusted_length; i++) {
-            if (adjusted_string[i] == '1') {
-                count++;
-            }
-        }
-        if (count == codeword_size) {
-            adjusted_string[adjusted_length - 1] = '0';
-        }
+        /* Padded bit-stuffed length */
+        adjusted_length = az_bitrun_stuff(binary, data_length, codeword_size, NULL);
+        adjusted_length = ((adjusted_length + codeword_size - 1) / codeword_size) * codeword_size;
 
         /* Check if the data actually fits into the selected symbol size */
         if (compact) {
@@ -1128,18 +718,6 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
             strcpy(symbol->errtxt, "505: Data too long for specified Aztec Code symbol size");
             return ZINT_ERROR_TOO_LONG;
         }
-
-        if (debug) {
-            printf("Codewords:\n");
-            for (i = 0; i < (adjusted_length / codeword_size); i++) {
-                for (j = 0; j < codeword_size; j++) {
-                    printf("%c", adjusted_string[(i * codeword_size) + j]);
-                }
-                printf(" ");
-            }
-            printf("\n");
-        }
-
     }
 
     if (reader && (layers > 22)) {
@@ -1167,25 +745,29 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
         printf("    (%d data words, %d ecc words)\n", data_blocks, ecc_blocks);
     }
 
-#ifndef _MSC_VER
-    unsigned int data_part[data_blocks], ecc_part[ecc_blocks];
-#else
-    data_part = (unsigned int *) _alloca(sizeof(unsigned int) * data_blocks);
-    ecc_part = (unsigned int *) _alloca(sizeof(unsigned int) * ecc_blocks);
-#endif
-    /* Copy across data into separate integers */
-    memset(data_part, 0, sizeof(unsigned int) * data_blocks);
+    z_work_array(symbol, unsigned int, data_part, data_blocks);
+    z_work_array(symbol, unsigned int, ecc_part, ecc_blocks);
+
+    if (z_work_failed(data_part) || z_work_failed(ecc_part)) {
+        return z_work_error(symbol);
+    }
     memset(ecc_part, 0, sizeof(unsigned int) * ecc_blocks);
 
-    /* Split into codewords and calculate reed-solomon error correction codes */
-    for (i = 0; i < data_blocks; i++) {
-        for (p = 0; p < codeword_size; p++) {
-            if (adjusted_string[i * codeword_size + p] == '1') {
-                data_part[i] += 0x01 << (codeword_size - (p + 1));
+    /* Bit-stuff into codewords */
+    az_bitrun_stuff(binary, data_length, codeword_size, data_part);
+
+    if (debug) {
+        printf("Codewords:\n");
+        for (i = 0; i < data_blocks; i++) {
+            for (j = codeword_size - 1; j >= 0; j--) {
+                putchar('0' + ((data_part[i] >> j) & 1));
             }
+            printf(" ");
         }
+        printf("\n");
     }
 
+    /* Calculate reed-solomon error correction codes */
     switch (codeword_size) {
         case 6:
             rs_init_gf(&rs, 0x43);
@@ -1198,177 +780,78 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
             rs_encode_uint(&rs, data_blocks, data_part, ecc_part);
             break;
         case 10:
-            rs_uint_init_gf(&rs_uint, 0x409, 1023);
-            rs_uint_init_code(&rs_uint, ecc_blocks, 1);
-            rs_uint_encode(&rs_uint, data_blocks, data_part, ecc_part);
-            rs_uint_free(&rs_uint);
+            rs_uint_init_gf(rs_uint, 0x409);
+            rs_uint_init_code(rs_uint, ecc_blocks, 1);
+            rs_uint_encode(rs_uint, data_blocks, data_part, ecc_part);
             break;
         case 12:
-            rs_uint_init_gf(&rs_uint, 0x1069, 4095);
-            rs_uint_init_code(&rs_uint, ecc_blocks, 1);
-            rs_uint_encode(&rs_uint, data_blocks, data_part, ecc_part);
-            rs_uint_free(&rs_uint);
+            rs_uint_init_gf(rs_uint, 0x1069);
+            rs_uint_init_code(rs_uint, ecc_blocks, 1);
+            rs_uint_encode(rs_uint, data_blocks, data_part, ecc_part);
             break;
     }
 
-    for (i = (ecc_blocks - 1); i >= 0; i--) {
-        adjusted_length = bin_append_posn(ecc_part[i], codeword_size, adjusted_string, adjusted_length);
+    /* Pack data then ecc (reversed) codewords, the bits being taken in reverse order below so that actual data is
+       on the outside and reed-solomon on the inside */
+    bits_init(&bits, binary, 0);
+    for (i = 0; i < data_blocks; i++) {
+        bits_append(&bits, data_part[i], codeword_size);
     }
-
-    /* Invert the data so that actual data is on the outside and reed-solomon on the inside */
-    memset(bit_pattern, '0', AZTEC_MAP_POSN_MAX + 1);
-
-    total_bits = (data_blocks + ecc_blocks) * codeword_size;
-    for (i = 0; i < total_bits; i++) {
-        bit_pattern[i] = adjusted_string[total_bits - i - 1];
+    for (i = ecc_blocks - 1; i >= 0; i--) {
+        bits_append(&bits, ecc_part[i], codeword_size);
     }
+    total_bits = bits_flush(&bits);
 
     /* Now add the symbol descriptor */
-    memset(desc_data, 0, 4);
     memset(desc_ecc, 0, 6);
-    memset(descriptor, 0, 42);
 
     if (compact) {
-        /* The first 2 bits represent the number of layers minus 1 */
-        if ((layers - 1) & 0x02) {
-            descriptor[0] = '1';
-        } else {
-            descriptor[0] = '0';
-        }
-        if ((layers - 1) & 0x01) {
-            descriptor[1] = '1';
-        } else {
-            descriptor[1] = '0';
-        }
-        /* The next 6 bits represent the number of data blocks minus 1 */
-        if (reader) {
-            descriptor[2] = '1';
-        } else {
-            if ((data_blocks - 1) & 0x20) {
-                descriptor[2] = '1';
-            } else {
-                descriptor[2] = '0';
-            }
-        }
-
-        for (i = 3; i < 8; i++) {
-            if ((data_blocks - 1) & (0x10 >> (i - 3))) {
-                descriptor[i] = '1';
-            } else {
-                descriptor[i] = '0';
-            }
-        }
-        if (debug) printf("Mode Message = %.8s\n", descriptor);
+        /* The first 2 bits represent the number of layers minus 1, the next 6 the number of data blocks minus 1,
+           with the top bit set for reader initialisation */
+        desc_value = ((layers - 1) << 6) | ((data_blocks - 1) & 0x3F) | (reader ? 0x20 : 0);
+        desc_len = 8;
     } else {
-        /* The first 5 bits represent the number of layers minus 1 */
-        for (i = 0; i < 5; i++) {
-            if ((layers - 1) & (0x10 >> i)) {
-                descriptor[i] = '1';
-            } else {
-                descriptor[i] = '0';
-            }
-        }
-
-        /* The next 11 bits represent the number of data blocks minus 1 */
-        if (reader) {
-            descriptor[5] = '1';
-        } else {
-            if ((data_blocks - 1) & 0x400) {
-                descriptor[5] = '1';
-            } else {
-                descriptor[5] = '0';
-            }
-        }
-        for (i = 6; i < 16; i++) {
-            if ((data_blocks - 1) & (0x200 >> (i - 6))) {
-                descriptor[i] = '1';
-            } else {
-                descriptor[i] = '0';
-            }
+        /* The first 5 bits represent the number of layers minus 1, the next 11 the number of data blocks minus 1,
+           with the top bit set for reader initialisation */
+        desc_value = ((layers - 1) << 11) | ((data_blocks - 1) & 0x7FF) | (reader ? 0x400 : 0);
+        desc_len = 16;
+    }
+    if (debug) {
+        printf("Mode Message = ");
+        for (i = desc_len - 1; i >= 0; i--) {
+            putchar('0' + ((desc_value >> i) & 1));
         }
-        if (debug) printf("Mode Message = %.16s\n", descriptor);
+        printf("\n");
     }
 
     /* Split into 4-bit codewords */
-    for (i = 0; i < 4; i++) {
-        if (descriptor[i * 4] == '1') {
-            desc_data[i] += 8;
-        }
-        if (descriptor[(i * 4) + 1] == '1') {
-            desc_data[i] += 4;
-        }
-        if (descriptor[(i * 4) + 2] == '1') {
-            desc_data[i] += 2;
-        }
-        if (descriptor[(i * 4) + 3] == '1') {
-            desc_data[i] += 1;
-        }
+    for (i = 0; i < desc_len / 4; i++) {
+        desc_data[i] = (unsigned char) ((desc_value >> (desc_len - 4 - i * 4)) & 0x0F);
     }
 
     /* Add reed-solomon error correction with Galois field GF(16) and prime modulus
     x^4 + x + 1 (section 7.2.3)*/
 
     rs_init_gf(&rs, 0x13);
+    bits_init(&bits, descriptor, 0);
+    bits_append(&bits, desc_value, desc_len);
     if (compact) {
         rs_init_code(&rs, 5, 1);
         rs_encode(&rs, 2, desc_data, desc_ecc);
         for (i = 0; i < 5; i++) {
-            if (desc_ecc[4 - i] & 0x08) {
-                descriptor[(i * 4) + 8] = '1';
-            } else {
-                descriptor[(i * 4) + 8] = '0';
-            }
-            if (desc_ecc[4 - i] & 0x04) {
-                descriptor[(i * 4) + 9] = '1';
-            } else {
-                descriptor[(i * 4) + 9] = '0';
-            }
-            if (desc_ecc[4 - i] & 0x02) {
-                descriptor[(i * 4) + 10] = '1';
-            } else {
-                descriptor[(i * 4) + 10] = '0';
-            }
-            if (desc_ecc[4 - i] & 0x01) {
-                descriptor[(i * 4) + 11] = '1';
-            } else {
-                descriptor[(i * 4) + 11] = '0';
-            }
+            bits_append(&bits, desc_ecc[4 - i], 4);
         }
     } else {
         rs_init_code(&rs, 6, 1);
         rs_encode(&rs, 4, desc_data, desc_ecc);
         for (i = 0; i < 6; i++) {
-            if (desc_ecc[5 - i] & 0x08) {
-                descriptor[(i * 4) + 16] = '1';
-            } else {
-                descriptor[(i * 4) + 16] = '0';
-            }
-            if (desc_ecc[5 - i] & 0x04) {
-                descriptor[(i * 4) + 17] = '1';
-            } else {
-                descriptor[(i * 4) + 17] = '0';
-            }
-            if (desc_ecc[5 - i] & 0x02) {
-                descriptor[(i * 4) + 18] = '1';
-            } else {
-                descriptor[(i * 4) + 18] = '0';
-            }
-            if (desc_ecc[5 - i] & 0x01) {
-                descriptor[(i * 4) + 19] = '1';
-            } else {
-                descriptor[(i * 4) + 19] = '0';
-            }
+            bits_append(&bits, desc_ecc[5 - i], 4);
         }
     }
+    desc_len = bits_flush(&bits);
 
-    /* Merge descriptor with the rest of the symbol */
-    if (compact) {
-        memcpy(bit_pattern + 2000 - 2, descriptor, 40);
-    } else {
-        memcpy(bit_pattern + 20000 - 2, descriptor, 40);
-    }
-
-    /* Plot all of the data into the symbol in pre-defined spiral pattern */
+    /* Plot all of the data into the symbol in pre-defined spiral pattern, the descriptor being at map positions
+       2000 (compact) or 20000 onwards */
     if (compact) {
         int offset = AztecCompactOffset[layers - 1];
         int end_offset = 27 - offset;
@@ -1376,9 +859,7 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
             int y_map = y * 27;
             for (x = offset; x < end_offset; x++) {
                 int map = CompactAztecMap[y_map + x];
-                if (map == 1) {
-                    set_module(symbol, y - offset, x - offset);
-                } else if (map >= 2 && bit_pattern[map - 2] == '1') {
+                if (map == 1 || (map >= 2 && az_pattern_bit(binary, total_bits, descriptor, desc_len, 2000, map))) {
                     set_module(symbol, y - offset, x - offset);
                 }
             }
@@ -1389,14 +870,11 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
     } else {
         int offset = AztecOffset[layers - 1];
         int end_offset = 151 - offset;
-        az_populate_map(AztecMap, layers);
         for (y = offset; y < end_offset; y++) {
             int y_map = y * 151;
             for (x = offset; x < end_offset; x++) {
                 int map = AztecMap[y_map + x];
-                if (map == 1) {
-                    set_module(symbol, y - offset, x - offset);
-                } else if (map >= 2 && bit_pattern[map - 2] == '1') {
+                if (map == 1 || (map >= 2 && az_pattern_bit(binary, total_bits, descriptor, desc_len, 20000, map))) {
                     set_module(symbol, y - offset, x - offset);
                 }
             }
@@ -1413,9 +891,8 @@ INTERNAL int aztec(struct zint_symbol *symbol, unsigned char source[], int lengt
 INTERNAL int aztec_runes(struct zint_symbol *symbol, unsigned char source[], int length) {
     unsigned int input_value;
     int error_number, i, y, x, r;
-    char binary_string[28];
+    unsigned int bits; /* 28 bits, most significant first */
     unsigned char data_codewords[3], ecc_codewords[6];
-    int bp = 0;
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
     rs_t rs;
 
@@ -1424,7 +901,7 @@ INTERNAL int aztec_runes(struct zint_symbol *symbol, unsigned char source[], int
         strcpy(symbol->errtxt, "507: Input too large");
         return ZINT_ERROR_INVALID_DATA;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number != 0) {
         strcpy(symbol->errtxt, "508: Invalid characters in input");
         return ZINT_ERROR_INVALID_DATA;
@@ -1446,7 +923,7 @@ INTERNAL int aztec_runes(struct zint_symbol *symbol, unsigned char source[], int
         return ZINT_ERROR_INVALID_DATA;
     }
 
-    bp = bin_append_posn(input_value, 8, binary_string, bp);
+    bits = input_value;
 
     data_codewords[0] = (unsigned char) (input_value >> 4);
     data_codewords[1] = (unsigned char) (input_value & 0xF);
@@ -1456,19 +933,18 @@ INTERNAL int aztec_runes(struct zint_symbol *symbol, unsigned char source[], int
     rs_encode(&rs, 2, data_codewords, ecc_codewords);
 
     for (i = 0; i < 5; i++) {
-        bp = bin_append_posn(ecc_codewords[4 - i], 4, binary_string, bp);
+        bits = (bits << 4) | ecc_codewords[4 - i];
     }
 
-    for (i = 0; i < 28; i += 2) {
-        if (binary_string[i] == '1') {
-            binary_string[i] = '0';
-        } else {
-            binary_string[i] = '1';
-        }
-    }
+    /* Invert every other bit, starting with the first */
+    bits ^= 0xAAAAAAA;
 
     if (debug) {
-        printf("Binary String: %.28s\n", binary_string);
+        printf("Binary String: ");
+        for (i = 27; i >= 0; i--) {
+            putchar('0' + ((bits >> i) & 1));
+        }
+        printf("\n");
     }
 
     for (y = 8; y < 19; y++) {
@@ -1476,7 +952,7 @@ INTERNAL int aztec_runes(struct zint_symbol *symbol, unsigned char source[], int
         for (x = 8; x < 19; x++) {
             if (CompactAztecMap[r + x] == 1) {
                 set_module(symbol, y - 8, x - 8);
-            } else if (CompactAztecMap[r + x] >= 2 && binary_string[CompactAztecMap[r + x] - 2000] == '1') {
+            } else if (CompactAztecMap[r + x] >= 2 && ((bits >> (27 - (CompactAztecMap[r + x] - 2000))) & 1)) {
                 set_module(symbol, y - 8, x - 8);
             }
         }
@@ -1487,3 +963,9 @@ INTERNAL int aztec_runes(struct zint_symbol *symbol, unsigned char source[], int
 
     return 0;
 }
+
+/* Page in the module maps (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t aztec_tables_warm(const int touch) {
+    return z_table_warm(AztecMap, sizeof(AztecMap), touch)
+            + z_table_warm(CompactAztecMap, sizeof(CompactAztecMap), touch);
+}
@@ -0,0 +1,286 @@
+/*  batch.c - encoding of many items with the same settings (`ZBarcode_Encode_Batch()`) */
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <stdio.h>
+#include "common.h"
+#include "library.h"
+
+/* ITF-14 and EAN-13/UPC-A fast path drawing */
+INTERNAL void itf14_batch_draw(struct zint_symbol *symbol, const unsigned char localstr[]);
+INTERNAL void upcean_batch_draw(struct zint_symbol *symbol, const unsigned char gtin[], const int length);
+
+#define BATCH_LANES 16 /* Number of items the fixed-length fast path of `ZBarcode_Encode_Batch()` checks at once */
+
+/* Items of the fixed-length fast path set up by `batch_fast_block()`, all of the same input `length` */
+struct batch_block {
+    int length;
+    int n; /* Number of data digits (excluding check digit) */
+    unsigned char ok[BATCH_LANES]; /* Set if item can use the fast path, else encoded in full (giving the error) */
+    unsigned char data[BATCH_LANES][16]; /* Data digits zero-padded to `n`, check digit and NUL */
+};
+
+/* A full encode of the fixed-length fast path, whose adjusted settings and structure are re-used for items of the
+   same input length, as for these symbologies they depend only on the length, not the digits */
+struct batch_template {
+    int length; /* Input length, 0 if not valid */
+    struct batch_settings settings; /* As adjusted by the encode */
+    int row_height;
+    int error_number; /* Settings warning (if any) */
+    char errtxt[100];
+};
+
+/* Whether the fixed-length fast path can be used for the (checked) settings of `symbol`, i.e. EAN-13, UPC-A and
+   ITF-14 digits only input without any per-item tracing, debug output or time budget */
+static int batch_fast_ok(const struct zint_symbol *symbol) {
+    switch (symbol->symbology) {
+        case BARCODE_EANX:
+        case BARCODE_EANX_CHK:
+        case BARCODE_UPCA:
+        case BARCODE_UPCA_CHK:
+            break;
+        case BARCODE_ITF14:
+            if (symbol->option_2 == 1 || symbol->option_2 == 2) { /* Extra check digit */
+                return 0;
+            }
+            break;
+        default:
+            return 0;
+            break;
+    }
+    return ((symbol->input_mode & 0x07) == DATA_MODE || (symbol->input_mode & 0x07) == UNICODE_MODE)
+            && !symbol->trace_func && !(symbol->debug & ZINT_DEBUG_PRINT) && symbol->time_budget_ms <= 0;
+}
+
+/* Number of data digits (excluding check digit) of `symbology` for an input of `length`, 0 if not fast path */
+static int batch_fast_digits(const int symbology, const int length) {
+    if (symbology == BARCODE_ITF14) {
+        return length >= 1 && length <= 13 ? 13 : 0; /* Zero-padded */
+    }
+    if (symbology == BARCODE_UPCA || symbology == BARCODE_UPCA_CHK) {
+        return length == 11 || length == 12 ? 11 : 0;
+    }
+    return length == 12 || length == 13 ? 12 : 0; /* EAN-13 (not EAN-8 or add-ons) */
+}
+
+/* Calculate the GS1 (mod 10, weights 3 and 1 from the right) check digits of `BATCH_LANES` items at once in
+   struct-of-arrays layout, `digits[i][lane]` being digit `i` of `n` of item `lane`. The inner loops over the lanes
+   have fixed counts and no dependencies between lanes so that compilers can vectorise them */
+static void batch_check_digits(const unsigned char digits[][BATCH_LANES], const int n,
+            unsigned char checks[BATCH_LANES]) {
+    unsigned short sums[BATCH_LANES];
+    int i, lane;
+
+    for (lane = 0; lane < BATCH_LANES; lane++) {
+        sums[lane] = 0;
+    }
+    for (i = 0; i < n; i++) {
+        const unsigned short weight = ((n - i) & 1) ? 3 : 1;
+        for (lane = 0; lane < BATCH_LANES; lane++) {
+            sums[lane] += weight * digits[i][lane];
+        }
+    }
+    for (lane = 0; lane < BATCH_LANES; lane++) {
+        checks[lane] = (unsigned char) ((10 - sums[lane] % 10) % 10);
+    }
+}
+
+/* Set up `block` from the leading `items` (up to `BATCH_LANES`) of the same input length, returning how many
+   (at least 1) */
+static int batch_fast_block(const int symbology, const struct zint_batch_item items[], const int count,
+            struct batch_block *block) {
+    unsigned char digits[13][BATCH_LANES];
+    unsigned char checks[BATCH_LANES];
+    int lengths[BATCH_LANES];
+    int lanes, lane, i;
+    int offset;
+
+    block->length = items[0].source ? (items[0].length > 0 ? items[0].length : (int) ustrlen(items[0].source)) : 0;
+    block->n = batch_fast_digits(symbology, block->length);
+    if (block->n == 0) {
+        block->ok[0] = 0;
+        return 1;
+    }
+    offset = block->length < block->n ? block->n - block->length : 0; /* Leading zeroes */
+
+    memset(digits, 0, sizeof(digits));
+    for (lanes = 0; lanes < count && lanes < BATCH_LANES; lanes++) {
+        const struct zint_batch_item *item = items + lanes;
+        if (!item->source) {
+            break;
+        }
+        lengths[lanes] = item->length > 0 ? item->length : (int) ustrlen(item->source);
+        if (lengths[lanes] != block->length) {
+            break;
+        }
+        block->ok[lanes] = is_sane_chr(CHR_DIGIT, item->source, block->length) == 0;
+        if (block->ok[lanes]) {
+            for (i = 0; i < block->n - offset; i++) {
+                digits[offset + i][lanes] = item->source[i] - '0';
+            }
+        }
+    }
+
+    batch_check_digits((const unsigned char (*)[BATCH_LANES]) digits, block->n, checks);
+
+    for (lane = 0; lane < lanes; lane++) {
+        if (block->ok[lane]) {
+            unsigned char *d = block->data[lane];
+            if (block->length > block->n && items[lane].source[block->n] - '0' != checks[lane]) {
+                block->ok[lane] = 0; /* Bad check digit */
+                continue;
+            }
+            for (i = 0; i < block->n; i++) {
+                d[i] = digits[i][lane] + '0';
+            }
+            d[block->n] = checks[lane] + '0';
+            d[block->n + 1] = '\0';
+        }
+    }
+
+    return lanes;
+}
+
+/* Encode item `data` of `block` using `templ` */
+static int batch_fast_item(struct zint_symbol *symbol, const struct batch_template *templ, const unsigned char *data,
+            const int n) {
+    ZBarcode_Clear(symbol);
+    batch_settings_restore(symbol, &templ->settings);
+    symbol->row_height[0] = templ->row_height;
+
+    if (symbol->symbology == BARCODE_ITF14) {
+        /* Human readable text not needed, as `encode_source_data()` */
+        if ((symbol->output_options & BARCODE_NO_HRT) || !symbol->show_hrt) {
+            symbol->debug |= ZINT_NO_HRT_TEXT;
+        }
+        itf14_batch_draw(symbol, data);
+        symbol->debug &= ~ZINT_NO_HRT_TEXT;
+    } else {
+        upcean_batch_draw(symbol, data, n + 1);
+    }
+    strcpy(symbol->errtxt, templ->errtxt);
+
+    return templ->error_number;
+}
+
+/* Encode `count` items with the same settings, checking the settings once only. Each item's result is placed in
+   its `error_number` and `errtxt`, and `item_func` (if non-NULL) is called with the encoded symbol, returning
+   non-zero to stop. Returns an error if the settings are invalid, else the highest item `error_number`.
+   EAN-13, UPC-A and ITF-14 items of the same length are encoded by a fast path that checks them a block at a time
+   and only draws the single row of each, re-using the rest of the result of a full encode of the first */
+int ZBarcode_Encode_Batch(struct zint_symbol *symbol, struct zint_batch_item items[], int count,
+            int (*item_func)(void *context, struct zint_symbol *symbol, int index, int error_number),
+            void *context) {
+    int warn_number, error_number;
+    int ret = 0;
+    int i, j, block_count;
+    int fast;
+    struct batch_settings settings;
+    char settings_errtxt[100];
+    struct batch_block block;
+    struct batch_template templ;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (count < 0 || (count > 0 && items == NULL)) {
+        strcpy(symbol->errtxt, "227: Invalid batch items");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    if (*symbol->outfile == '\0') {
+        strcpy(symbol->outfile, "out.png");
+    }
+
+    symbol->errtxt[0] = '\0';
+    warn_number = check_settings(symbol);
+    if (warn_number >= ZINT_ERROR) {
+        return error_tag(symbol->errtxt, warn_number);
+    }
+    strcpy(settings_errtxt, symbol->errtxt); /* Untagged warning (if any) */
+    batch_settings_save(symbol, &settings);
+    fast = batch_fast_ok(symbol);
+    templ.length = 0;
+
+    for (i = 0; i < count; i += block_count) {
+        if (fast) {
+            block_count = batch_fast_block(symbol->symbology, items + i, count - i, &block);
+        } else {
+            block_count = 1;
+            block.ok[0] = 0;
+        }
+
+        for (j = 0; j < block_count; j++) {
+            struct zint_batch_item *item = items + i + j;
+
+            if (block.ok[j] && templ.length == block.length) {
+                error_number = batch_fast_item(symbol, &templ, block.data[j], block.n);
+            } else {
+                int length = item->length;
+
+                ZBarcode_Clear(symbol);
+                batch_settings_restore(symbol, &settings);
+
+                error_number = check_source(symbol, item->source, &length);
+                if (error_number != 0) {
+                    (void) error_tag(symbol->errtxt, error_number);
+                } else {
+                    strcpy(symbol->errtxt, settings_errtxt);
+                    error_number = encode_source(symbol, item->source, length, warn_number);
+                    z_work_free(symbol);
+                }
+
+                if (block.ok[j]) {
+                    /* Only single row results are re-used (so not composites) */
+                    if (error_number < ZINT_ERROR && symbol->rows == 1) {
+                        templ.length = block.length;
+                        batch_settings_save(symbol, &templ.settings);
+                        templ.row_height = symbol->row_height[0];
+                        templ.error_number = error_number;
+                        strcpy(templ.errtxt, symbol->errtxt);
+                    } else {
+                        templ.length = 0;
+                    }
+                }
+            }
+            item->error_number = error_number;
+            strcpy(item->errtxt, symbol->errtxt);
+            if (error_number > ret) {
+                ret = error_number;
+            }
+
+            if (item_func && (*item_func)(context, symbol, i + j, error_number) != 0) {
+                return ret;
+            }
+        }
+    }
+
+    return ret;
+}
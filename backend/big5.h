@@ -1785,7 +1785,7 @@ static const Big5Summary16 big5_uni2indx_page00[16] = {
   {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x00ac }, {    4, 0x0083 },
   {    7, 0x0000 }, {    7, 0x0080 }, {    8, 0x0000 }, {    8, 0x0080 },
 };
-static const Big5Summary16 big5_uni2indx_page02[38] = {
+static const Big5Summary16 big5_uni2indx_page02[48] = {
   /* 0x0200 */
   {    9, 0x0000 }, {    9, 0x0000 }, {    9, 0x0000 }, {    9, 0x0000 },
   {    9, 0x0000 }, {    9, 0x0000 }, {    9, 0x0000 }, {    9, 0x0000 },
@@ -1798,9 +1798,11 @@ static const Big5Summary16 big5_uni2indx_page02[38] = {
   {   53, 0x03fb }, {   62, 0x0000 }, {   62, 0x0000 }, {   62, 0x0000 },
   /* 0x0400 */
   {   62, 0x0002 }, {   63, 0x1ff0 }, {   72, 0xfff8 }, {   85, 0xffff },
-  {  101, 0xffff }, {  117, 0x0002 },
+  {  101, 0xffff }, {  117, 0x0002 }, {  118, 0x0000 }, {  118, 0x0000 },
+  {  118, 0x0000 }, {  118, 0x0000 }, {  118, 0x0000 }, {  118, 0x0000 },
+  {  118, 0x0000 }, {  118, 0x0000 }, {  118, 0x0000 }, {  118, 0x0000 },
 };
-static const Big5Summary16 big5_uni2indx_page20[44] = {
+static const Big5Summary16 big5_uni2indx_page20[48] = {
   /* 0x2000 */
   {  118, 0x0000 }, {  118, 0x3318 }, {  124, 0x0064 }, {  127, 0x4824 },
   {  131, 0x0000 }, {  131, 0x0000 }, {  131, 0x0000 }, {  131, 0x0000 },
@@ -1815,8 +1817,9 @@ static const Big5Summary16 big5_uni2indx_page20[44] = {
   {  152, 0x0000 }, {  152, 0xc400 }, {  155, 0x4e29 }, {  162, 0x1030 },
   {  165, 0x0000 }, {  165, 0x0004 }, {  166, 0x00c3 }, {  170, 0x0000 },
   {  170, 0x0000 }, {  170, 0x0000 }, {  170, 0x0020 }, {  171, 0x8000 },
+  {  172, 0x0000 }, {  172, 0x0000 }, {  172, 0x0000 }, {  172, 0x0000 },
 };
-static const Big5Summary16 big5_uni2indx_page24[37] = {
+static const Big5Summary16 big5_uni2indx_page24[48] = {
   /* 0x2400 */
   {  172, 0x0000 }, {  172, 0x0000 }, {  172, 0x0000 }, {  172, 0x0000 },
   {  172, 0x0000 }, {  172, 0x0000 }, {  172, 0x03ff }, {  182, 0x3ff0 },
@@ -1829,9 +1832,11 @@ static const Big5Summary16 big5_uni2indx_page24[37] = {
   {  237, 0xc8c0 }, {  242, 0x0000 }, {  242, 0x003c }, {  246, 0x0000 },
   /* 0x2600 */
   {  246, 0x0260 }, {  249, 0x0000 }, {  249, 0x0000 }, {  249, 0x0000 },
-  {  249, 0x0007 },
+  {  249, 0x0007 }, {  252, 0x0000 }, {  252, 0x0000 }, {  252, 0x0000 },
+  {  252, 0x0000 }, {  252, 0x0000 }, {  252, 0x0000 }, {  252, 0x0000 },
+  {  252, 0x0000 }, {  252, 0x0000 }, {  252, 0x0000 }, {  252, 0x0000 },
 };
-static const Big5Summary16 big5_uni2indx_page30[62] = {
+static const Big5Summary16 big5_uni2indx_page30[64] = {
   /* 0x3000 */
   {  252, 0xff2f }, {  265, 0x6037 }, {  272, 0x03fe }, {  281, 0x0000 },
   {  281, 0xfffe }, {  296, 0xffff }, {  312, 0xffff }, {  328, 0xffff },
@@ -1851,9 +1856,9 @@ static const Big5Summary16 big5_uni2indx_page30[62] = {
   {  491, 0x0000 }, {  491, 0x0000 }, {  491, 0x0000 }, {  491, 0x0000 },
   {  491, 0x0000 }, {  491, 0x0000 }, {  491, 0x0000 }, {  491, 0x0000 },
   {  491, 0xc000 }, {  493, 0x7000 }, {  496, 0x0002 }, {  497, 0x0000 },
-  {  497, 0x4010 }, {  499, 0x0026 },
+  {  497, 0x4010 }, {  499, 0x0026 }, {  502, 0x0000 }, {  502, 0x0000 },
 };
-static const Big5Summary16 big5_uni2indx_page4e[1307] = {
+static const Big5Summary16 big5_uni2indx_page4e[1312] = {
   /* 0x4e00 */
   {  502, 0xff8b }, {  514, 0xc373 }, {  523, 0x6840 }, {  527, 0x1b0f },
   {  535, 0xe9ac }, {  544, 0xf34c }, {  553, 0x0200 }, {  554, 0xc008 },
@@ -2262,13 +2267,17 @@ static const Big5Summary16 big5_uni2indx_page4e[1307] = {
   /* 0x9f00 */
   { 13458, 0xc6c3 }, { 13466, 0x5f6d }, { 13477, 0xff3d }, { 13490, 0x69ff },
   { 13502, 0xffcf }, { 13516, 0xfbf4 }, { 13528, 0xdcfb }, { 13540, 0x4ff7 },
-  { 13552, 0x2000 }, { 13553, 0x1137 }, { 13560, 0x0015 },
+  { 13552, 0x2000 }, { 13553, 0x1137 }, { 13560, 0x0015 }, { 13563, 0x0000 },
+  { 13563, 0x0000 }, { 13563, 0x0000 }, { 13563, 0x0000 }, { 13563, 0x0000 },
 };
-static const Big5Summary16 big5_uni2indx_pagefa[1] = {
+static const Big5Summary16 big5_uni2indx_pagefa[16] = {
   /* 0xfa00 */
-  { 13563, 0x3000 },
+  { 13563, 0x3000 }, { 13565, 0x0000 }, { 13565, 0x0000 }, { 13565, 0x0000 },
+  { 13565, 0x0000 }, { 13565, 0x0000 }, { 13565, 0x0000 }, { 13565, 0x0000 },
+  { 13565, 0x0000 }, { 13565, 0x0000 }, { 13565, 0x0000 }, { 13565, 0x0000 },
+  { 13565, 0x0000 }, { 13565, 0x0000 }, { 13565, 0x0000 }, { 13565, 0x0000 },
 };
-static const Big5Summary16 big5_uni2indx_pagefe[23] = {
+static const Big5Summary16 big5_uni2indx_pagefe[32] = {
   /* 0xfe00 */
   { 13565, 0x0000 }, { 13565, 0x0000 }, { 13565, 0x0000 }, { 13565, 0xfffb },
   { 13580, 0xfe1f }, { 13592, 0xfef5 }, { 13605, 0x0e7f }, { 13615, 0x0000 },
@@ -2276,28 +2285,101 @@ static const Big5Summary16 big5_uni2indx_pagefe[23] = {
   { 13615, 0x0000 }, { 13615, 0x0000 }, { 13615, 0x0000 }, { 13615, 0x0000 },
   /* 0xff00 */
   { 13615, 0xff7a }, { 13628, 0xffff }, { 13644, 0xffff }, { 13660, 0x97ff },
-  { 13673, 0xfffe }, { 13688, 0x3fff }, { 13702, 0x0010 },
+  { 13673, 0xfffe }, { 13688, 0x3fff }, { 13702, 0x0010 }, { 13703, 0x0000 },
+  { 13703, 0x0000 }, { 13703, 0x0000 }, { 13703, 0x0000 }, { 13703, 0x0000 },
+  { 13703, 0x0000 }, { 13703, 0x0000 }, { 13703, 0x0000 }, { 13703, 0x0000 },
 };
 
 /* Returns 2 on success, 0 if no mapping */
+/* ZINT: Direct index by Unicode high byte to pages of 16 summaries (page arrays padded to a multiple of
+ * 16 entries), replacing range checks */
+static const Big5Summary16 *const big5_uni2indx_pages[256] = {
+  /* 0x00 */ big5_uni2indx_page00 + 0x000,
+  /* 0x01 */ NULL,
+  /* 0x02 */ big5_uni2indx_page02 + 0x000, big5_uni2indx_page02 + 0x010,
+  /* 0x04 */ big5_uni2indx_page02 + 0x020,
+  /* 0x05 */ NULL, NULL, NULL,
+  /* 0x08 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x10 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x18 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x20 */ big5_uni2indx_page20 + 0x000, big5_uni2indx_page20 + 0x010,
+  /* 0x22 */ big5_uni2indx_page20 + 0x020,
+  /* 0x23 */ NULL,
+  /* 0x24 */ big5_uni2indx_page24 + 0x000, big5_uni2indx_page24 + 0x010,
+  /* 0x26 */ big5_uni2indx_page24 + 0x020,
+  /* 0x27 */ NULL,
+  /* 0x28 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x30 */ big5_uni2indx_page30 + 0x000, big5_uni2indx_page30 + 0x010,
+  /* 0x32 */ big5_uni2indx_page30 + 0x020, big5_uni2indx_page30 + 0x030,
+  /* 0x34 */ NULL, NULL, NULL, NULL,
+  /* 0x38 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x40 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x48 */ NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x4e */ big5_uni2indx_page4e + 0x000, big5_uni2indx_page4e + 0x010,
+  /* 0x50 */ big5_uni2indx_page4e + 0x020, big5_uni2indx_page4e + 0x030,
+  /* 0x52 */ big5_uni2indx_page4e + 0x040, big5_uni2indx_page4e + 0x050,
+  /* 0x54 */ big5_uni2indx_page4e + 0x060, big5_uni2indx_page4e + 0x070,
+  /* 0x56 */ big5_uni2indx_page4e + 0x080, big5_uni2indx_page4e + 0x090,
+  /* 0x58 */ big5_uni2indx_page4e + 0x0a0, big5_uni2indx_page4e + 0x0b0,
+  /* 0x5a */ big5_uni2indx_page4e + 0x0c0, big5_uni2indx_page4e + 0x0d0,
+  /* 0x5c */ big5_uni2indx_page4e + 0x0e0, big5_uni2indx_page4e + 0x0f0,
+  /* 0x5e */ big5_uni2indx_page4e + 0x100, big5_uni2indx_page4e + 0x110,
+  /* 0x60 */ big5_uni2indx_page4e + 0x120, big5_uni2indx_page4e + 0x130,
+  /* 0x62 */ big5_uni2indx_page4e + 0x140, big5_uni2indx_page4e + 0x150,
+  /* 0x64 */ big5_uni2indx_page4e + 0x160, big5_uni2indx_page4e + 0x170,
+  /* 0x66 */ big5_uni2indx_page4e + 0x180, big5_uni2indx_page4e + 0x190,
+  /* 0x68 */ big5_uni2indx_page4e + 0x1a0, big5_uni2indx_page4e + 0x1b0,
+  /* 0x6a */ big5_uni2indx_page4e + 0x1c0, big5_uni2indx_page4e + 0x1d0,
+  /* 0x6c */ big5_uni2indx_page4e + 0x1e0, big5_uni2indx_page4e + 0x1f0,
+  /* 0x6e */ big5_uni2indx_page4e + 0x200, big5_uni2indx_page4e + 0x210,
+  /* 0x70 */ big5_uni2indx_page4e + 0x220, big5_uni2indx_page4e + 0x230,
+  /* 0x72 */ big5_uni2indx_page4e + 0x240, big5_uni2indx_page4e + 0x250,
+  /* 0x74 */ big5_uni2indx_page4e + 0x260, big5_uni2indx_page4e + 0x270,
+  /* 0x76 */ big5_uni2indx_page4e + 0x280, big5_uni2indx_page4e + 0x290,
+  /* 0x78 */ big5_uni2indx_page4e + 0x2a0, big5_uni2indx_page4e + 0x2b0,
+  /* 0x7a */ big5_uni2indx_page4e + 0x2c0, big5_uni2indx_page4e + 0x2d0,
+  /* 0x7c */ big5_uni2indx_page4e + 0x2e0, big5_uni2indx_page4e + 0x2f0,
+  /* 0x7e */ big5_uni2indx_page4e + 0x300, big5_uni2indx_page4e + 0x310,
+  /* 0x80 */ big5_uni2indx_page4e + 0x320, big5_uni2indx_page4e + 0x330,
+  /* 0x82 */ big5_uni2indx_page4e + 0x340, big5_uni2indx_page4e + 0x350,
+  /* 0x84 */ big5_uni2indx_page4e + 0x360, big5_uni2indx_page4e + 0x370,
+  /* 0x86 */ big5_uni2indx_page4e + 0x380, big5_uni2indx_page4e + 0x390,
+  /* 0x88 */ big5_uni2indx_page4e + 0x3a0, big5_uni2indx_page4e + 0x3b0,
+  /* 0x8a */ big5_uni2indx_page4e + 0x3c0, big5_uni2indx_page4e + 0x3d0,
+  /* 0x8c */ big5_uni2indx_page4e + 0x3e0, big5_uni2indx_page4e + 0x3f0,
+  /* 0x8e */ big5_uni2indx_page4e + 0x400, big5_uni2indx_page4e + 0x410,
+  /* 0x90 */ big5_uni2indx_page4e + 0x420, big5_uni2indx_page4e + 0x430,
+  /* 0x92 */ big5_uni2indx_page4e + 0x440, big5_uni2indx_page4e + 0x450,
+  /* 0x94 */ big5_uni2indx_page4e + 0x460, big5_uni2indx_page4e + 0x470,
+  /* 0x96 */ big5_uni2indx_page4e + 0x480, big5_uni2indx_page4e + 0x490,
+  /* 0x98 */ big5_uni2indx_page4e + 0x4a0, big5_uni2indx_page4e + 0x4b0,
+  /* 0x9a */ big5_uni2indx_page4e + 0x4c0, big5_uni2indx_page4e + 0x4d0,
+  /* 0x9c */ big5_uni2indx_page4e + 0x4e0, big5_uni2indx_page4e + 0x4f0,
+  /* 0x9e */ big5_uni2indx_page4e + 0x500, big5_uni2indx_page4e + 0x510,
+  /* 0xa0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xa8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xb0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xb8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xc0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xc8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xd0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xd8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf8 */ NULL, NULL,
+  /* 0xfa */ big5_uni2indx_pagefa + 0x000,
+  /* 0xfb */ NULL, NULL, NULL,
+  /* 0xfe */ big5_uni2indx_pagefe + 0x000, big5_uni2indx_pagefe + 0x010,
+};
+
 static int big5_wctomb_zint(unsigned int *r, const unsigned int wc) {
     const Big5Summary16 *summary = NULL;
-    if (wc < 0x0100) {
-        summary = &big5_uni2indx_page00[(wc>>4)];
-    } else if (wc >= 0x0200 && wc < 0x0460) {
-        summary = &big5_uni2indx_page02[(wc>>4)-0x020];
-    } else if (wc >= 0x2000 && wc < 0x22c0) {
-        summary = &big5_uni2indx_page20[(wc>>4)-0x200];
-    } else if (wc >= 0x2400 && wc < 0x2650) {
-        summary = &big5_uni2indx_page24[(wc>>4)-0x240];
-    } else if (wc >= 0x3000 && wc < 0x33e0) {
-        summary = &big5_uni2indx_page30[(wc>>4)-0x300];
-    } else if (wc >= 0x4e00 && wc < 0x9fb0) {
-        summary = &big5_uni2indx_page4e[(wc>>4)-0x4e0];
-    } else if (wc >= 0xfa00 && wc < 0xfa10) {
-        summary = &big5_uni2indx_pagefa[(wc>>4)-0xfa0];
-    } else if (wc >= 0xfe00 && wc < 0xff70) {
-        summary = &big5_uni2indx_pagefe[(wc>>4)-0xfe0];
+    if (wc < 0x10000) {
+        const Big5Summary16 *page = big5_uni2indx_pages[wc >> 8];
+        if (page) {
+            summary = &page[(wc >> 4) & 0x0f];
+        }
     }
     if (summary) {
         unsigned short used = summary->used;
@@ -34,55 +34,166 @@
 #include <stdio.h>
 #include "common.h"
 #include "bmp.h"        /* Bitmap header structure */
-#ifdef _MSC_VER
-#include <io.h>
-#include <fcntl.h>
-#endif
+#include "filemem.h"
+#include "output.h"
+#include "raster.h"
 
-INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+#define BMP_BI_RGB  0
+#define BMP_BI_RLE8 1
+
+/* Run-length encode a row of `width` pixels as BI_RLE8 palette indexes into `out`, which must be able to hold
+   `2 * width + 2` bytes, ending with end-of-line, or if `last` end-of-bitmap. Returns number of bytes output */
+static int bmp_rle8_row(const unsigned char *pixels, const unsigned char map[128], const int width, const int last,
+            unsigned char *out) {
+    unsigned char *op = out;
+    int i = 0;
+
+    while (i < width) {
+        const unsigned char idx = map[pixels[i]];
+        int run = 1;
+        while (i + run < width && run < 255 && map[pixels[i + run]] == idx) {
+            run++;
+        }
+        if (run == 1) {
+            /* Gather single pixels, using absolute mode if 3 or more */
+            int count = 1;
+            while (i + count < width && count < 255
+                    && (i + count + 1 == width || map[pixels[i + count]] != map[pixels[i + count + 1]])) {
+                count++;
+            }
+            if (count >= 3) {
+                *op++ = 0;
+                *op++ = count;
+                for (run = 0; run < count; run++) {
+                    *op++ = map[pixels[i + run]];
+                }
+                if (count & 1) {
+                    *op++ = 0; /* Pad to word boundary */
+                }
+            } else {
+                for (run = 0; run < count; run++) {
+                    *op++ = 1;
+                    *op++ = map[pixels[i + run]];
+                }
+            }
+            i += count;
+        } else {
+            *op++ = run;
+            *op++ = idx;
+            i += run;
+        }
+    }
+    *op++ = 0;
+    *op++ = last ? 1 : 0; /* End of bitmap or end of line */
+
+    return (int) (op - out);
+}
+
+INTERNAL int bmp_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows) {
     int i, row, column;
     int row_size;
     int bits_per_pixel;
     int colour_count;
+    int compression;
+    unsigned char map[128];
     unsigned int data_offset, data_size, file_size;
     unsigned char *bitmap_file_start, *bmp_posn;
     unsigned char *bitmap;
-    FILE *bmp_file;
+    int mapped = 0;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     bitmap_file_header_t file_header;
     bitmap_info_header_t info_header;
     color_ref_t bg_color_ref;
     color_ref_t fg_color_ref;
     color_ref_t ultra_color_ref[8];
 
+    memset(map, 0, sizeof(map)); /* Background */
     if (symbol->symbology == BARCODE_ULTRA) {
+        static const char ultra_chars[8] = { 'C', 'B', 'M', 'R', 'Y', 'G', 'K', 'W' };
+        for (i = 0; i < 8; i++) {
+            map[(unsigned char) ultra_chars[i]] = i + 1;
+        }
         bits_per_pixel = 4;
         colour_count = 9;
     } else {
+        map['1'] = 1;
         bits_per_pixel = 1;
         colour_count = 2;
     }
-    row_size = 4 * ((bits_per_pixel * symbol->bitmap_width + 31) / 32);
-    data_size = symbol->bitmap_height * row_size;
     data_offset = sizeof (bitmap_file_header_t) + sizeof (bitmap_info_header_t);
     data_offset += (colour_count * (sizeof(color_ref_t)));
-    file_size = data_offset + data_size;
 
-    bitmap_file_start = (unsigned char *) malloc(file_size);
-    if (bitmap_file_start == NULL) {
-        strcpy(symbol->errtxt, "602: Out of memory");
-        return ZINT_ERROR_MEMORY;
+    /* Open output file in binary mode */
+    if (!fm_open(fmp, symbol, "wb")) {
+        strcpy(symbol->errtxt, "601: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
-    memset(bitmap_file_start, 0, file_size); /* Not required but keeps padding bytes consistent */
 
-    bitmap = bitmap_file_start + data_offset;
+    if (symbol->output_options & BMP_RLE8) {
+        /* Runs are encoded into memory first as compressed size not known in advance */
+        struct filemem rle_fm = {0};
+        unsigned char *rle_row;
+
+        compression = BMP_BI_RLE8;
+        bits_per_pixel = 8;
+        row_size = 0;
+
+        if (!(rle_row = (unsigned char *) z_malloc(z_allocator(symbol), 2 * symbol->bitmap_width + 2))) {
+            (void) fm_close(fmp, symbol);
+            strcpy(symbol->errtxt, "604: Out of memory");
+            return ZINT_ERROR_MEMORY;
+        }
+        rle_fm.flags = BARCODE_MEMORY_FILE;
+        rle_fm.allocator = z_allocator(symbol);
+        for (row = 0; row < symbol->bitmap_height; row++) { /* Bottom-up */
+            const int len = bmp_rle8_row(raster_rows_get(rows, symbol->bitmap_height - row - 1), map,
+                                symbol->bitmap_width, row + 1 == symbol->bitmap_height, rle_row);
+            fm_write(rle_row, 1, len, &rle_fm);
+        }
+        z_free(z_allocator(symbol), rle_row);
+        data_size = (unsigned int) rle_fm.memend;
+        file_size = data_offset + data_size;
 
-    fg_color_ref.red = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
-    fg_color_ref.green = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
-    fg_color_ref.blue = (16 * ctoi(symbol->fgcolour[4])) + ctoi(symbol->fgcolour[5]);
+        if (fm_error(&rle_fm) || !(bitmap_file_start = (unsigned char *) z_malloc(z_allocator(symbol), file_size))) {
+            z_free(z_allocator(symbol), rle_fm.mem);
+            (void) fm_close(fmp, symbol);
+            strcpy(symbol->errtxt, "605: Out of memory");
+            return ZINT_ERROR_MEMORY;
+        }
+        memset(bitmap_file_start, 0, data_offset);
+        bitmap = bitmap_file_start + data_offset;
+        memcpy(bitmap, rle_fm.mem, data_size);
+        z_free(z_allocator(symbol), rle_fm.mem);
+    } else {
+        compression = BMP_BI_RGB;
+        row_size = 4 * ((bits_per_pixel * symbol->bitmap_width + 31) / 32);
+        data_size = symbol->bitmap_height * row_size;
+        file_size = data_offset + data_size;
+
+        /* Plot straight into the output if possible (OUT_FILE_MMAP or memory file) */
+        if ((bitmap_file_start = fm_map(fmp, file_size))) {
+            mapped = 1;
+        } else {
+            bitmap_file_start = (unsigned char *) z_malloc(z_allocator(symbol), file_size);
+            if (bitmap_file_start == NULL) {
+                (void) fm_close(fmp, symbol);
+                strcpy(symbol->errtxt, "602: Out of memory");
+                return ZINT_ERROR_MEMORY;
+            }
+            memset(bitmap_file_start, 0, file_size); /* Not required but keeps padding bytes consistent */
+        }
+
+        bitmap = bitmap_file_start + data_offset;
+    }
+
+    fg_color_ref.red = OUT_RED(symbol->fgcolour_rgba);
+    fg_color_ref.green = OUT_GREEN(symbol->fgcolour_rgba);
+    fg_color_ref.blue = OUT_BLUE(symbol->fgcolour_rgba);
     fg_color_ref.reserved = 0x00;
-    bg_color_ref.red = (16 * ctoi(symbol->bgcolour[0])) + ctoi(symbol->bgcolour[1]);
-    bg_color_ref.green = (16 * ctoi(symbol->bgcolour[2])) + ctoi(symbol->bgcolour[3]);
-    bg_color_ref.blue = (16 * ctoi(symbol->bgcolour[4])) + ctoi(symbol->bgcolour[5]);
+    bg_color_ref.red = OUT_RED(symbol->bgcolour_rgba);
+    bg_color_ref.green = OUT_GREEN(symbol->bgcolour_rgba);
+    bg_color_ref.blue = OUT_BLUE(symbol->bgcolour_rgba);
     bg_color_ref.reserved = 0x00;
     
     for (i = 0; i < 8; i++) {
@@ -93,43 +204,22 @@ INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     }
 
     /* Pixel Plotting */
-    if (symbol->symbology == BARCODE_ULTRA) {
+    if (compression == BMP_BI_RLE8) {
+        /* Already done */
+    } else if (symbol->symbology == BARCODE_ULTRA) {
         for (row = 0; row < symbol->bitmap_height; row++) {
+            const unsigned char *const pb = raster_rows_get(rows, symbol->bitmap_height - row - 1);
             for (column = 0; column < symbol->bitmap_width; column++) {
                 i = (column / 2) + (row * row_size);
-                switch (*(pixelbuf + (symbol->bitmap_width * (symbol->bitmap_height - row - 1)) + column)) {
-                    case 'C': // Cyan
-                        bitmap[i] += 1 << (4 * (1 - (column % 2)));
-                        break;
-                    case 'B': // Blue
-                        bitmap[i] += 2 << (4 * (1 - (column % 2)));
-                        break;
-                    case 'M': // Magenta
-                        bitmap[i] += 3 << (4 * (1 - (column % 2)));
-                        break;
-                    case 'R': // Red
-                        bitmap[i] += 4 << (4 * (1 - (column % 2)));
-                        break;
-                    case 'Y': // Yellow
-                        bitmap[i] += 5 << (4 * (1 - (column % 2)));
-                        break;
-                    case 'G': // Green
-                        bitmap[i] += 6 << (4 * (1 - (column % 2)));
-                        break;
-                    case 'K': // Black
-                        bitmap[i] += 7 << (4 * (1 - (column % 2)));
-                        break;
-                    case 'W': // White
-                        bitmap[i] += 8 << (4 * (1 - (column % 2)));
-                        break;
-                }
+                bitmap[i] += map[pb[column]] << (4 * (1 - (column % 2)));
             }
         }
     } else {
         for (row = 0; row < symbol->bitmap_height; row++) {
+            const unsigned char *const pb = raster_rows_get(rows, symbol->bitmap_height - row - 1);
             for (column = 0; column < symbol->bitmap_width; column++) {
                 i = (column / 8) + (row * row_size);
-                if ((*(pixelbuf + (symbol->bitmap_width * (symbol->bitmap_height - row - 1)) + column)) == '1') {
+                if (pb[column] == '1') {
                     bitmap[i] += (0x01 << (7 - (column % 8)));
                 }
             }
@@ -148,8 +238,8 @@ INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     info_header.height = symbol->bitmap_height;
     info_header.colour_planes = 1;
     info_header.bits_per_pixel = bits_per_pixel;
-    info_header.compression_method = 0; // BI_RGB
-    info_header.image_size = 0;
+    info_header.compression_method = compression;
+    info_header.image_size = compression == BMP_BI_RGB ? 0 : data_size; /* Required if compressed */
     info_header.horiz_res = 0;
     info_header.vert_res = 0;
     info_header.colours = colour_count;
@@ -172,27 +262,21 @@ INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         memcpy(bmp_posn, &fg_color_ref, sizeof(color_ref_t));
     }
 
-    /* Open output file in binary mode */
-    if ((symbol->output_options & BARCODE_STDOUT) != 0) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "600: Can't open output file");
-            free(bitmap_file_start);
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-#endif
-        bmp_file = stdout;
-    } else {
-        if (!(bmp_file = fopen(symbol->outfile, "wb"))) {
-            free(bitmap_file_start);
-            strcpy(symbol->errtxt, "601: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!mapped) {
+        fm_write(bitmap_file_start, file_header.file_size, 1, fmp);
+        z_free(z_allocator(symbol), bitmap_file_start);
+    }
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "603: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
     }
 
-    fwrite(bitmap_file_start, file_header.file_size, 1, bmp_file);
-    fclose(bmp_file);
-
-    free(bitmap_file_start);
     return 0;
 }
+
+INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    struct raster_rows rows;
+
+    raster_rows_image(&rows, symbol, pixelbuf);
+    return bmp_plot_rows(symbol, &rows);
+}
@@ -29,78 +29,134 @@
  */
 /* vim: set ts=4 sw=4 et : */
 
-/* Channel code precalculated values to avoid excessive looping */
+/* Channel Code precalculated symbol counts (see `channel_counts` in "code.c") */
 /* To generate uncomment CHANNEL_GENERATE_PRECALCS define and run "./test_channel -f generate -g" */
 /* Paste result below here */
-static channel_precalc channel_precalcs7[] = {
-    {  115338, { 1, 3, 1, 1, 1, 1, 5, 1, }, { 1, 1, 1, 2, 1, 2, 3, 3, }, { 1, 7, 5, 5, 5, 5, 5, }, { 1, 7, 7, 7, 6, 6, 5, }, },
-    {  230676, { 1, 1, 2, 2, 4, 1, 1, 2, }, { 1, 2, 1, 3, 2, 1, 3, 1, }, { 1, 7, 7, 6, 5, 2, 2, }, { 1, 7, 6, 6, 4, 3, 3, }, },
-    {  346014, { 1, 2, 3, 1, 1, 1, 3, 2, }, { 1, 2, 2, 1, 1, 3, 1, 3, }, { 1, 7, 6, 4, 4, 4, 4, }, { 1, 7, 6, 5, 5, 5, 3, }, },
-    {  461352, { 1, 2, 1, 1, 1, 2, 2, 4, }, { 1, 3, 1, 1, 3, 2, 2, 1, }, { 1, 7, 6, 6, 6, 6, 5, }, { 1, 7, 5, 5, 5, 3, 2, }, },
-};
-static channel_precalc channel_precalcs8[] = {
-    {  119121, { 2, 1, 3, 2, 1, 3, 2, 1, }, { 1, 1, 1, 4, 3, 2, 1, 2, }, { 8, 7, 7, 5, 4, 4, 2, }, { 8, 8, 8, 8, 5, 3, 2, }, },
-    {  238242, { 2, 1, 1, 2, 2, 2, 1, 4, }, { 1, 1, 3, 1, 1, 2, 4, 2, }, { 8, 7, 7, 7, 6, 5, 4, }, { 8, 8, 8, 6, 6, 6, 5, }, },
-    {  357363, { 2, 2, 1, 4, 1, 1, 1, 3, }, { 1, 1, 1, 1, 3, 2, 5, 1, }, { 8, 7, 6, 6, 3, 3, 3, }, { 8, 8, 8, 8, 8, 6, 5, }, },
-    {  476484, { 2, 2, 1, 1, 3, 2, 3, 1, }, { 1, 1, 3, 1, 2, 2, 3, 2, }, { 8, 7, 6, 6, 6, 4, 3, }, { 8, 8, 8, 6, 6, 5, 4, }, },
-    {  595605, { 2, 3, 3, 2, 1, 1, 1, 2, }, { 1, 1, 2, 1, 1, 1, 5, 3, }, { 8, 7, 5, 3, 2, 2, 2, }, { 8, 8, 8, 7, 7, 7, 7, }, },
-    {  714726, { 2, 1, 1, 6, 1, 1, 2, 1, }, { 1, 2, 1, 3, 1, 4, 1, 2, }, { 8, 7, 7, 7, 2, 2, 2, }, { 8, 8, 7, 7, 5, 5, 2, }, },
-    {  833847, { 2, 1, 1, 3, 1, 3, 3, 1, }, { 1, 2, 3, 1, 1, 3, 2, 2, }, { 8, 7, 7, 7, 5, 5, 3, }, { 8, 8, 7, 5, 5, 5, 3, }, },
-    {  952968, { 2, 2, 2, 3, 2, 1, 2, 1, }, { 1, 2, 2, 1, 2, 2, 2, 3, }, { 8, 7, 6, 5, 3, 2, 2, }, { 8, 8, 7, 6, 6, 5, 4, }, },
-    { 1072089, { 2, 5, 1, 1, 2, 2, 1, 1, }, { 1, 2, 1, 3, 1, 3, 3, 1, }, { 8, 7, 3, 3, 3, 2, 1, }, { 8, 8, 7, 7, 5, 5, 3, }, },
-    { 1191210, { 2, 2, 1, 2, 1, 1, 3, 3, }, { 1, 3, 1, 1, 5, 1, 1, 2, }, { 8, 7, 6, 6, 5, 5, 5, }, { 8, 8, 6, 6, 6, 2, 2, }, },
-    { 1310331, { 2, 1, 2, 1, 2, 3, 2, 2, }, { 1, 4, 1, 3, 1, 1, 2, 2, }, { 8, 7, 7, 6, 6, 5, 3, }, { 8, 8, 5, 5, 3, 3, 3, }, },
-    { 1429452, { 2, 2, 1, 2, 2, 3, 2, 1, }, { 1, 5, 3, 1, 2, 1, 1, 1, }, { 8, 7, 6, 6, 5, 4, 2, }, { 8, 8, 4, 2, 2, 1, 1, }, },
-    { 1548573, { 3, 1, 1, 2, 5, 1, 1, 1, }, { 1, 1, 2, 2, 1, 2, 5, 1, }, { 8, 6, 6, 6, 5, 1, 1, }, { 8, 8, 8, 7, 6, 6, 5, }, },
-    { 1667694, { 3, 2, 2, 1, 1, 3, 2, 1, }, { 1, 1, 1, 1, 2, 4, 3, 2, }, { 8, 6, 5, 4, 4, 4, 2, }, { 8, 8, 8, 8, 8, 7, 4, }, },
-    { 1786815, { 3, 4, 2, 1, 2, 1, 1, 1, }, { 1, 1, 2, 1, 1, 2, 1, 6, }, { 8, 6, 3, 2, 2, 1, 1, }, { 8, 8, 8, 7, 7, 7, 6, }, },
-    { 1905936, { 3, 2, 1, 3, 1, 3, 1, 1, }, { 1, 2, 1, 1, 1, 4, 2, 3, }, { 8, 6, 5, 5, 3, 3, 1, }, { 8, 8, 7, 7, 7, 7, 4, }, },
-    { 2025057, { 3, 1, 2, 2, 1, 1, 4, 1, }, { 1, 3, 2, 1, 1, 1, 5, 1, }, { 8, 6, 6, 5, 4, 4, 4, }, { 8, 8, 6, 5, 5, 5, 5, }, },
-    { 2144178, { 3, 1, 2, 1, 2, 2, 2, 2, }, { 1, 5, 1, 1, 4, 1, 1, 1, }, { 8, 6, 6, 5, 5, 4, 3, }, { 8, 8, 4, 4, 4, 1, 1, }, },
-    { 2263299, { 4, 2, 1, 2, 1, 1, 1, 3, }, { 1, 1, 1, 1, 3, 3, 3, 2, }, { 8, 5, 4, 4, 3, 3, 3, }, { 8, 8, 8, 8, 8, 6, 4, }, },
-    { 2382420, { 4, 2, 1, 1, 1, 1, 4, 1, }, { 1, 2, 2, 2, 2, 2, 2, 2, }, { 8, 5, 4, 4, 4, 4, 4, }, { 8, 8, 7, 6, 5, 4, 3, }, },
-    { 2501541, { 5, 1, 1, 2, 2, 1, 1, 2, }, { 1, 1, 2, 3, 3, 1, 1, 3, }, { 8, 4, 4, 4, 3, 2, 2, }, { 8, 8, 8, 7, 5, 3, 3, }, },
-    { 2620662, { 6, 1, 1, 1, 2, 1, 1, 2, }, { 1, 2, 4, 1, 2, 3, 1, 1, }, { 8, 3, 3, 3, 3, 2, 2, }, { 8, 8, 7, 4, 4, 3, 1, }, },
-    { 2739783, { 1, 1, 1, 1, 3, 3, 4, 1, }, { 2, 1, 2, 1, 6, 1, 1, 1, }, { 8, 8, 8, 8, 8, 6, 4, }, { 8, 7, 7, 6, 6, 1, 1, }, },
-    { 2858904, { 1, 1, 2, 3, 3, 1, 3, 1, }, { 2, 1, 3, 1, 3, 1, 2, 2, }, { 8, 8, 8, 7, 5, 3, 3, }, { 8, 7, 7, 5, 5, 3, 3, }, },
-    { 2978025, { 1, 2, 2, 4, 1, 2, 1, 2, }, { 2, 1, 1, 1, 1, 3, 4, 2, }, { 8, 8, 7, 6, 3, 3, 2, }, { 8, 7, 7, 7, 7, 7, 5, }, },
-    { 3097146, { 1, 2, 2, 1, 3, 3, 2, 1, }, { 2, 1, 3, 3, 2, 2, 1, 1, }, { 8, 8, 7, 6, 6, 4, 2, }, { 8, 7, 7, 5, 3, 2, 1, }, },
-    { 3216267, { 1, 3, 1, 1, 1, 3, 1, 4, }, { 2, 1, 3, 2, 3, 2, 1, 1, }, { 8, 8, 6, 6, 6, 6, 4, }, { 8, 7, 7, 5, 4, 2, 1, }, },
-    { 3335388, { 1, 1, 1, 4, 4, 1, 2, 1, }, { 2, 2, 1, 1, 1, 1, 3, 4, }, { 8, 8, 8, 8, 5, 2, 2, }, { 8, 7, 6, 6, 6, 6, 6, }, },
-    { 3454509, { 1, 1, 2, 4, 3, 1, 2, 1, }, { 2, 2, 2, 5, 1, 1, 1, 1, }, { 8, 8, 8, 7, 4, 2, 2, }, { 8, 7, 6, 5, 1, 1, 1, }, },
-    { 3573630, { 1, 2, 1, 3, 1, 2, 3, 2, }, { 2, 2, 2, 1, 1, 4, 2, 1, }, { 8, 8, 7, 7, 5, 5, 4, }, { 8, 7, 6, 5, 5, 5, 2, }, },
-    { 3692751, { 1, 4, 2, 3, 2, 1, 1, 1, }, { 2, 2, 1, 1, 2, 1, 2, 4, }, { 8, 8, 5, 4, 2, 1, 1, }, { 8, 7, 6, 6, 6, 5, 5, }, },
-    { 3811872, { 1, 1, 2, 1, 3, 5, 1, 1, }, { 2, 3, 3, 2, 2, 1, 1, 1, }, { 8, 8, 8, 7, 7, 5, 1, }, { 8, 7, 5, 3, 2, 1, 1, }, },
-    { 3930993, { 1, 1, 1, 1, 6, 2, 2, 1, }, { 2, 4, 1, 2, 1, 3, 1, 1, }, { 8, 8, 8, 8, 8, 3, 2, }, { 8, 7, 4, 4, 3, 3, 1, }, },
-    { 4050114, { 1, 3, 3, 2, 2, 1, 2, 1, }, { 2, 6, 2, 1, 1, 1, 1, 1, }, { 8, 8, 6, 4, 3, 2, 2, }, { 8, 7, 2, 1, 1, 1, 1, }, },
-    { 4169235, { 2, 1, 2, 2, 4, 2, 1, 1, }, { 2, 1, 2, 1, 1, 1, 4, 3, }, { 8, 7, 7, 6, 5, 2, 1, }, { 8, 7, 7, 6, 6, 6, 6, }, },
-    { 4288356, { 2, 2, 2, 1, 1, 3, 3, 1, }, { 2, 1, 1, 4, 2, 1, 1, 3, }, { 8, 7, 6, 5, 5, 5, 3, }, { 8, 7, 7, 7, 4, 3, 3, }, },
-    { 4407477, { 2, 3, 3, 1, 2, 1, 1, 2, }, { 2, 1, 3, 2, 4, 1, 1, 1, }, { 8, 7, 5, 3, 3, 2, 2, }, { 8, 7, 7, 5, 4, 1, 1, }, },
-    { 4526598, { 2, 1, 4, 1, 4, 1, 1, 1, }, { 2, 2, 2, 1, 2, 3, 1, 2, }, { 8, 7, 7, 4, 4, 1, 1, }, { 8, 7, 6, 5, 5, 4, 2, }, },
-    { 4645719, { 2, 4, 2, 1, 1, 2, 1, 2, }, { 2, 2, 1, 1, 3, 2, 3, 1, }, { 8, 7, 4, 3, 3, 3, 2, }, { 8, 7, 6, 6, 6, 4, 3, }, },
-    { 4764840, { 2, 1, 1, 1, 2, 4, 1, 3, }, { 2, 4, 1, 2, 1, 3, 1, 1, }, { 8, 7, 7, 7, 7, 6, 3, }, { 8, 7, 4, 4, 3, 3, 1, }, },
-    { 4883961, { 3, 1, 1, 3, 2, 2, 1, 2, }, { 2, 1, 2, 2, 2, 1, 2, 3, }, { 8, 6, 6, 6, 4, 3, 2, }, { 8, 7, 7, 6, 5, 4, 4, }, },
-    { 5003082, { 3, 3, 3, 1, 1, 1, 2, 1, }, { 2, 1, 2, 1, 1, 3, 1, 4, }, { 8, 6, 4, 2, 2, 2, 2, }, { 8, 7, 7, 6, 6, 6, 4, }, },
-    { 5122203, { 3, 1, 1, 2, 1, 2, 1, 4, }, { 2, 3, 1, 1, 1, 2, 4, 1, }, { 8, 6, 6, 6, 5, 5, 4, }, { 8, 7, 5, 5, 5, 5, 4, }, },
-    { 5241324, { 4, 1, 1, 3, 1, 2, 2, 1, }, { 2, 1, 3, 1, 1, 3, 3, 1, }, { 8, 5, 5, 5, 3, 3, 2, }, { 8, 7, 7, 5, 5, 5, 3, }, },
-    { 5360445, { 4, 3, 1, 1, 2, 1, 1, 2, }, { 2, 4, 1, 3, 2, 1, 1, 1, }, { 8, 5, 3, 3, 3, 2, 2, }, { 8, 7, 4, 4, 2, 1, 1, }, },
-    { 5479566, { 1, 1, 3, 1, 3, 2, 1, 3, }, { 3, 1, 1, 2, 1, 2, 1, 4, }, { 8, 8, 8, 6, 6, 4, 3, }, { 8, 6, 6, 6, 5, 5, 4, }, },
-    { 5598687, { 1, 2, 1, 1, 5, 1, 3, 1, }, { 3, 1, 1, 1, 1, 3, 1, 4, }, { 8, 8, 7, 7, 7, 3, 3, }, { 8, 6, 6, 6, 6, 6, 4, }, },
-    { 5717808, { 1, 3, 1, 2, 1, 3, 1, 3, }, { 3, 1, 1, 2, 4, 1, 1, 2, }, { 8, 8, 6, 6, 5, 5, 3, }, { 8, 6, 6, 6, 5, 2, 2, }, },
-    { 5836929, { 1, 1, 2, 3, 1, 2, 3, 2, }, { 3, 2, 1, 1, 1, 1, 2, 4, }, { 8, 8, 8, 7, 5, 5, 4, }, { 8, 6, 5, 5, 5, 5, 5, }, },
-    { 5956050, { 1, 2, 3, 3, 2, 2, 1, 1, }, { 3, 2, 3, 1, 1, 1, 1, 3, }, { 8, 8, 7, 5, 3, 2, 1, }, { 8, 6, 5, 3, 3, 3, 3, }, },
-    { 6075171, { 1, 3, 1, 1, 3, 3, 2, 1, }, { 3, 3, 1, 1, 3, 1, 2, 1, }, { 8, 8, 6, 6, 6, 4, 2, }, { 8, 6, 4, 4, 4, 2, 2, }, },
-    { 6194292, { 2, 1, 1, 3, 4, 1, 2, 1, }, { 3, 1, 2, 1, 3, 1, 3, 1, }, { 8, 7, 7, 7, 5, 2, 2, }, { 8, 6, 6, 5, 5, 3, 3, }, },
-    { 6313413, { 2, 3, 2, 2, 1, 2, 2, 1, }, { 3, 1, 1, 2, 1, 3, 2, 2, }, { 8, 7, 5, 4, 3, 3, 2, }, { 8, 6, 6, 6, 5, 5, 3, }, },
-    { 6432534, { 2, 3, 1, 1, 2, 2, 3, 1, }, { 3, 2, 1, 2, 3, 1, 2, 1, }, { 8, 7, 5, 5, 5, 4, 3, }, { 8, 6, 5, 5, 4, 2, 2, }, },
-    { 6551655, { 3, 1, 1, 2, 1, 4, 1, 2, }, { 3, 1, 2, 3, 1, 1, 3, 1, }, { 8, 6, 6, 6, 5, 5, 2, }, { 8, 6, 6, 5, 3, 3, 3, }, },
-    { 6670776, { 3, 1, 1, 1, 1, 3, 4, 1, }, { 3, 3, 1, 2, 1, 1, 3, 1, }, { 8, 6, 6, 6, 6, 6, 4, }, { 8, 6, 4, 4, 3, 3, 3, }, },
-    { 6789897, { 5, 2, 1, 1, 2, 1, 2, 1, }, { 3, 1, 1, 1, 2, 2, 3, 2, }, { 8, 4, 3, 3, 3, 2, 2, }, { 8, 6, 6, 6, 6, 5, 4, }, },
-    { 6909018, { 1, 2, 2, 2, 2, 1, 4, 1, }, { 4, 1, 1, 2, 1, 2, 1, 3, }, { 8, 8, 7, 6, 5, 4, 4, }, { 8, 5, 5, 5, 4, 4, 3, }, },
-    { 7028139, { 1, 1, 3, 2, 2, 2, 1, 3, }, { 4, 2, 2, 1, 2, 2, 1, 1, }, { 8, 8, 8, 6, 5, 4, 3, }, { 8, 5, 4, 3, 3, 2, 1, }, },
-    { 7147260, { 2, 1, 4, 3, 2, 1, 1, 1, }, { 4, 1, 1, 1, 4, 1, 1, 2, }, { 8, 7, 7, 4, 2, 1, 1, }, { 8, 5, 5, 5, 5, 2, 2, }, },
-    { 7266381, { 2, 4, 1, 3, 2, 1, 1, 1, }, { 4, 2, 1, 1, 1, 2, 1, 3, }, { 8, 7, 4, 4, 2, 1, 1, }, { 8, 5, 4, 4, 4, 4, 3, }, },
-    { 7385502, { 4, 2, 1, 3, 1, 2, 1, 1, }, { 4, 1, 1, 4, 2, 1, 1, 1, }, { 8, 5, 4, 4, 2, 2, 1, }, { 8, 5, 5, 5, 2, 1, 1, }, },
-    { 7504623, { 1, 1, 3, 4, 3, 1, 1, 1, }, { 5, 2, 1, 1, 1, 1, 1, 3, }, { 8, 8, 8, 6, 3, 1, 1, }, { 8, 4, 3, 3, 3, 3, 3, }, },
-    { 7623744, { 3, 1, 1, 2, 2, 1, 2, 3, }, { 5, 2, 1, 1, 1, 2, 1, 2, }, { 8, 6, 6, 6, 5, 4, 4, }, { 8, 4, 3, 3, 3, 3, 2, }, },
+static const int channel_counts[7][8][8][4] = {
+    { /* 1 pair */
+        { { 1, 1, 1, 0, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, },
+          { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, },
+        { { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, },
+          { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, },
+        { { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, },
+          { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, },
+        { { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, },
+          { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, },
+        { { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, },
+          { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, },
+        { { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, },
+          { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, },
+        { { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, },
+          { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, },
+        { { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, },
+          { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, { 1, 1, 1, 1, }, },
+    },
+    { /* 2 pairs */
+        { { 1, 0, 0, 0, }, { 2, 2, 2, 1, }, { 3, 3, 3, 2, }, { 4, 4, 4, 3, },
+          { 5, 5, 5, 4, }, { 6, 6, 6, 5, }, { 7, 7, 7, 6, }, { 8, 8, 8, 7, }, },
+        { { 2, 2, 2, 1, }, { 4, 4, 4, 3, }, { 6, 6, 6, 5, }, { 8, 8, 8, 7, },
+          { 10, 10, 10, 9, }, { 12, 12, 12, 11, }, { 14, 14, 14, 13, }, { 16, 16, 16, 15, }, },
+        { { 3, 3, 3, 2, }, { 6, 6, 6, 5, }, { 9, 9, 9, 8, }, { 12, 12, 12, 11, },
+          { 15, 15, 15, 14, }, { 18, 18, 18, 17, }, { 21, 21, 21, 20, }, { 24, 24, 24, 23, }, },
+        { { 4, 4, 4, 3, }, { 8, 8, 8, 7, }, { 12, 12, 12, 11, }, { 16, 16, 16, 15, },
+          { 20, 20, 20, 19, }, { 24, 24, 24, 23, }, { 28, 28, 28, 27, }, { 32, 32, 32, 31, }, },
+        { { 5, 5, 5, 4, }, { 10, 10, 10, 9, }, { 15, 15, 15, 14, }, { 20, 20, 20, 19, },
+          { 25, 25, 25, 24, }, { 30, 30, 30, 29, }, { 35, 35, 35, 34, }, { 40, 40, 40, 39, }, },
+        { { 6, 6, 6, 5, }, { 12, 12, 12, 11, }, { 18, 18, 18, 17, }, { 24, 24, 24, 23, },
+          { 30, 30, 30, 29, }, { 36, 36, 36, 35, }, { 42, 42, 42, 41, }, { 48, 48, 48, 47, }, },
+        { { 7, 7, 7, 6, }, { 14, 14, 14, 13, }, { 21, 21, 21, 20, }, { 28, 28, 28, 27, },
+          { 35, 35, 35, 34, }, { 42, 42, 42, 41, }, { 49, 49, 49, 48, }, { 56, 56, 56, 55, }, },
+        { { 8, 8, 8, 7, }, { 16, 16, 16, 15, }, { 24, 24, 24, 23, }, { 32, 32, 32, 31, },
+          { 40, 40, 40, 39, }, { 48, 48, 48, 47, }, { 56, 56, 56, 55, }, { 64, 64, 64, 63, }, },
+    },
+    { /* 3 pairs */
+        { { 0, 0, 0, 0, }, { 3, 2, 2, 1, }, { 6, 5, 5, 3, }, { 10, 9, 9, 6, },
+          { 15, 14, 14, 10, }, { 21, 20, 20, 15, }, { 28, 27, 27, 21, }, { 36, 35, 35, 28, }, },
+        { { 2, 1, 1, 0, }, { 9, 8, 8, 5, }, { 18, 17, 17, 12, }, { 30, 29, 29, 22, },
+          { 45, 44, 44, 35, }, { 63, 62, 62, 51, }, { 84, 83, 83, 70, }, { 108, 107, 107, 92, }, },
+        { { 5, 4, 4, 2, }, { 18, 17, 17, 12, }, { 36, 35, 35, 27, }, { 60, 59, 59, 48, },
+          { 90, 89, 89, 75, }, { 126, 125, 125, 108, }, { 168, 167, 167, 147, }, { 216, 215, 215, 192, }, },
+        { { 9, 8, 8, 5, }, { 30, 29, 29, 22, }, { 60, 59, 59, 48, }, { 100, 99, 99, 84, },
+          { 150, 149, 149, 130, }, { 210, 209, 209, 186, }, { 280, 279, 279, 252, }, { 360, 359, 359, 328, }, },
+        { { 14, 13, 13, 9, }, { 45, 44, 44, 35, }, { 90, 89, 89, 75, }, { 150, 149, 149, 130, },
+          { 225, 224, 224, 200, }, { 315, 314, 314, 285, }, { 420, 419, 419, 385, }, { 540, 539, 539, 500, }, },
+        { { 20, 19, 19, 14, }, { 63, 62, 62, 51, }, { 126, 125, 125, 108, }, { 210, 209, 209, 186, },
+          { 315, 314, 314, 285, }, { 441, 440, 440, 405, }, { 588, 587, 587, 546, }, { 756, 755, 755, 708, }, },
+        { { 27, 26, 26, 20, }, { 84, 83, 83, 70, }, { 168, 167, 167, 147, }, { 280, 279, 279, 252, },
+          { 420, 419, 419, 385, }, { 588, 587, 587, 546, }, { 784, 783, 783, 735, }, { 1008, 1007, 1007, 952, }, },
+        { { 35, 34, 34, 27, }, { 108, 107, 107, 92, }, { 216, 215, 215, 192, }, { 360, 359, 359, 328, },
+          { 540, 539, 539, 500, }, { 756, 755, 755, 708, }, { 1008, 1007, 1007, 952, }, { 1296, 1295, 1295, 1232, }, },
+    },
+    { /* 4 pairs */
+        { { 0, 0, 0, 0, }, { 2, 1, 1, 0, }, { 8, 6, 6, 3, }, { 18, 15, 15, 9, },
+          { 33, 29, 29, 19, }, { 54, 49, 49, 34, }, { 82, 76, 76, 55, }, { 118, 111, 111, 83, }, },
+        { { 1, 0, 0, 0, }, { 12, 9, 9, 4, }, { 36, 31, 31, 19, }, { 76, 69, 69, 47, },
+          { 136, 127, 127, 92, }, { 220, 209, 209, 158, }, { 332, 319, 319, 249, }, { 476, 461, 461, 369, }, },
+        { { 5, 3, 3, 1, }, { 34, 29, 29, 17, }, { 94, 86, 86, 59, }, { 194, 183, 183, 135, },
+          { 344, 330, 330, 255, }, { 554, 537, 537, 429, }, { 834, 814, 814, 667, }, { 1194, 1171, 1171, 979, }, },
+        { { 13, 10, 10, 5, }, { 72, 65, 65, 43, }, { 192, 181, 181, 133, }, { 392, 377, 377, 293, },
+          { 692, 673, 673, 543, }, { 1112, 1089, 1089, 903, }, { 1672, 1645, 1645, 1393, }, { 2392, 2361, 2361, 2033, }, },
+        { { 26, 22, 22, 13, }, { 130, 121, 121, 86, }, { 340, 326, 326, 251, }, { 690, 671, 671, 541, },
+          { 1215, 1191, 1191, 991, }, { 1950, 1921, 1921, 1636, }, { 2930, 2896, 2896, 2511, }, { 4190, 4151, 4151, 3651, }, },
+        { { 45, 40, 40, 26, }, { 212, 201, 201, 150, }, { 548, 531, 531, 423, }, { 1108, 1085, 1085, 899, },
+          { 1948, 1919, 1919, 1634, }, { 3124, 3089, 3089, 2684, }, { 4692, 4651, 4651, 4105, }, { 6708, 6661, 6661, 5953, }, },
+        { { 71, 65, 65, 45, }, { 322, 309, 309, 239, }, { 826, 806, 806, 659, }, { 1666, 1639, 1639, 1387, },
+          { 2926, 2892, 2892, 2507, }, { 4690, 4649, 4649, 4103, }, { 7042, 6994, 6994, 6259, }, { 10066, 10011, 10011, 9059, }, },
+        { { 105, 98, 98, 71, }, { 464, 449, 449, 357, }, { 1184, 1161, 1161, 969, }, { 2384, 2353, 2353, 2025, },
+          { 4184, 4145, 4145, 3645, }, { 6704, 6657, 6657, 5949, }, { 10064, 10009, 10009, 9057, }, { 14384, 14321, 14321, 13089, }, },
+    },
+    { /* 5 pairs */
+        { { 0, 0, 0, 0, }, { 1, 0, 0, 0, }, { 8, 5, 5, 2, }, { 25, 19, 19, 10, },
+          { 57, 47, 47, 28, }, { 110, 95, 95, 61, }, { 191, 170, 170, 115, }, { 308, 280, 280, 197, }, },
+        { { 0, 0, 0, 0, }, { 11, 6, 6, 2, }, { 52, 40, 40, 21, }, { 143, 121, 121, 74, },
+          { 309, 274, 274, 182, }, { 580, 529, 529, 371, }, { 991, 921, 921, 672, }, { 1582, 1490, 1490, 1121, }, },
+        { { 3, 1, 1, 0, }, { 45, 33, 33, 16, }, { 177, 150, 150, 91, }, { 459, 411, 411, 276, },
+          { 966, 891, 891, 636, }, { 1788, 1680, 1680, 1251, }, { 3030, 2883, 2883, 2216, }, { 4812, 4620, 4620, 3641, }, },
+        { { 13, 8, 8, 3, }, { 123, 101, 101, 58, }, { 443, 395, 395, 262, }, { 1113, 1029, 1029, 736, },
+          { 2308, 2178, 2178, 1635, }, { 4238, 4052, 4052, 3149, }, { 7148, 6896, 6896, 5503, }, { 11318, 10990, 10990, 8957, }, },
+        { { 35, 26, 26, 13, }, { 270, 235, 235, 149, }, { 925, 850, 850, 599, }, { 2280, 2150, 2150, 1609, },
+          { 4685, 4485, 4485, 3494, }, { 8560, 8275, 8275, 6639, }, { 14395, 14010, 14010, 11499, }, { 22750, 22250, 22250, 18599, }, },
+        { { 75, 61, 61, 35, }, { 516, 465, 465, 315, }, { 1713, 1605, 1605, 1182, }, { 4170, 3984, 3984, 3085, },
+          { 8517, 8232, 8232, 6598, }, { 15510, 15105, 15105, 12421, }, { 26031, 25485, 25485, 21380, }, { 41088, 40380, 40380, 34427, }, },
+        { { 140, 120, 120, 75, }, { 896, 826, 826, 587, }, { 2912, 2765, 2765, 2106, }, { 7028, 6776, 6776, 5389, },
+          { 14294, 13909, 13909, 11402, }, { 25970, 25424, 25424, 21321, }, { 43526, 42791, 42791, 36532, }, { 68642, 67690, 67690, 58631, }, },
+        { { 238, 211, 211, 140, }, { 1450, 1358, 1358, 1001, }, { 4642, 4450, 4450, 3481, }, { 11134, 10806, 10806, 8781, },
+          { 22576, 22076, 22076, 18431, }, { 40948, 40240, 40240, 34291, }, { 68560, 67608, 67608, 58551, }, { 108052, 106820, 106820, 93731, }, },
+    },
+    { /* 6 pairs */
+        { { 0, 0, 0, 0, }, { 0, 0, 0, 0, }, { 6, 3, 3, 1, }, { 28, 19, 19, 9, },
+          { 81, 62, 62, 34, }, { 186, 152, 152, 91, }, { 371, 316, 316, 201, }, { 672, 589, 589, 392, }, },
+        { { 0, 0, 0, 0, }, { 6, 2, 2, 0, }, { 57, 38, 38, 17, }, { 212, 165, 165, 91, },
+          { 561, 469, 469, 287, }, { 1230, 1072, 1072, 701, }, { 2387, 2138, 2138, 1466, }, { 4248, 3879, 3879, 2758, }, },
+        { { 1, 0, 0, 0, }, { 42, 25, 25, 9, }, { 255, 196, 196, 105, }, { 848, 713, 713, 437, },
+          { 2136, 1881, 1881, 1245, }, { 4560, 4131, 4131, 2880, }, { 8708, 8041, 8041, 5825, }, { 15336, 14357, 14357, 10716, }, },
+        { { 9, 4, 4, 1, }, { 156, 113, 113, 55, }, { 786, 653, 653, 391, }, { 2456, 2163, 2163, 1427, },
+          { 6006, 5463, 5463, 3828, }, { 12612, 11709, 11709, 8560, }, { 23842, 22449, 22449, 16946, }, { 41712, 39679, 39679, 30722, }, },
+        { { 35, 22, 22, 9, }, { 426, 340, 340, 191, }, { 1941, 1690, 1690, 1091, }, { 5836, 5295, 5295, 3686, },
+          { 14001, 13010, 13010, 9516, }, { 29082, 27446, 27446, 20807, }, { 54607, 52096, 52096, 40597, }, { 95112, 91461, 91461, 72862, }, },
+        { { 96, 70, 70, 35, }, { 966, 816, 816, 501, }, { 4137, 3714, 3714, 2532, }, { 12124, 11225, 11225, 8140, },
+          { 28707, 27073, 27073, 20475, }, { 59178, 56494, 56494, 44073, }, { 110593, 106488, 106488, 85108, }, { 192024, 186071, 186071, 151644, }, },
+        { { 216, 171, 171, 96, }, { 1932, 1693, 1693, 1106, }, { 7938, 7279, 7279, 5173, }, { 22848, 21461, 21461, 16072, },
+          { 53592, 51085, 51085, 39683, }, { 109872, 105769, 105769, 84448, }, { 204624, 198365, 198365, 161833, }, { 354480, 345421, 345421, 286790, }, },
+        { { 427, 356, 356, 216, }, { 3528, 3171, 3171, 2170, }, { 14076, 13107, 13107, 9626, }, { 39984, 37959, 37959, 29178, },
+          { 93132, 89487, 89487, 71056, }, { 190152, 184203, 184203, 149912, }, { 353220, 344163, 344163, 285612, }, { 610848, 597759, 597759, 504028, }, },
+    },
+    { /* 7 pairs */
+        { { 0, 0, 0, 0, }, { 0, 0, 0, 0, }, { 3, 1, 1, 0, }, { 25, 15, 15, 6, },
+          { 96, 68, 68, 34, }, { 267, 206, 206, 115, }, { 617, 502, 502, 301, }, { 1261, 1064, 1064, 672, }, },
+        { { 0, 0, 0, 0, }, { 2, 0, 0, 0, }, { 47, 26, 26, 9, }, { 253, 179, 179, 88, },
+          { 840, 658, 658, 371, }, { 2175, 1804, 1804, 1103, }, { 4821, 4149, 4149, 2683, }, { 9593, 8472, 8472, 5714, }, },
+        { { 0, 0, 0, 0, }, { 28, 12, 12, 3, }, { 286, 195, 195, 90, }, { 1264, 988, 988, 551, },
+          { 3867, 3231, 3231, 1986, }, { 9588, 8337, 8337, 5457, }, { 20704, 18488, 18488, 12663, }, { 40500, 36859, 36859, 26143, }, },
+        { { 4, 1, 1, 0, }, { 150, 92, 92, 37, }, { 1104, 842, 842, 451, }, { 4378, 3642, 3642, 2215, },
+          { 12737, 11102, 11102, 7274, }, { 30710, 27561, 27561, 19001, }, { 65178, 59675, 59675, 42729, }, { 126046, 117089, 117089, 86367, }, },
+        { { 26, 13, 13, 4, }, { 525, 376, 376, 185, }, { 3255, 2656, 2656, 1565, }, { 12075, 10466, 10466, 6780, },
+          { 33985, 30491, 30491, 20975, }, { 80395, 73756, 73756, 52949, }, { 168595, 157096, 157096, 116499, }, { 323435, 304836, 304836, 231974, }, },
+        { { 96, 61, 61, 26, }, { 1437, 1122, 1122, 621, }, { 8031, 6849, 6849, 4317, }, { 28499, 25414, 25414, 17274, },
+          { 78381, 71783, 71783, 51308, }, { 182919, 170498, 170498, 126425, }, { 380291, 358911, 358911, 273803, }, { 725307, 690880, 690880, 539236, }, },
+        { { 267, 192, 192, 96, }, { 3346, 2759, 2759, 1653, }, { 17458, 15352, 15352, 10179, }, { 60046, 54657, 54657, 38585, },
+          { 162400, 150998, 150998, 111315, }, { 375214, 353893, 353893, 269445, }, { 775054, 738522, 738522, 576689, }, { 1471750, 1413119, 1413119, 1126329, }, },
+        { { 623, 483, 483, 267, }, { 6944, 5943, 5943, 3773, }, { 34520, 31039, 31039, 21413, }, { 116036, 107255, 107255, 78077, },
+          { 309902, 291471, 291471, 220415, }, { 710564, 676273, 676273, 526361, }, { 1460516, 1401965, 1401965, 1116353, }, { 2764028, 2670297, 2670297, 2166269, }, },
+    },
 };
@@ -65,7 +65,7 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
 #define aCodeC (uchar)(134)
 #define aShift (uchar)(135)
 
-static const char *C128Table[107] = {
+static const char *const C128Table[107] = {
     /* Code 128 character encodation - Table 1 */
     "212222", "222122", "222221", "121223", "121322", "131222", "122213",
     "122312", "132212", "221213", "221312", "231212", "112232", "122132", "122231", "113222",
@@ -122,7 +122,8 @@ static int GetPossibleCharacterSet(unsigned char C)
 static void CreateCharacterSetTable(CharacterSetTable T[], unsigned char *data, const int dataLength)
 {
     int charCur;
-    int runChar;
+    int runFollowing;
+    int nextFollowing=0, nextNextFollowing=0;
 
     /* Treat the Data backwards */
     charCur=dataLength-1;
@@ -142,33 +143,22 @@ static void CreateCharacterSetTable(CharacterSetTable T[], unsigned char *data,
 
     }
     /* Find the CodeC-chains */
-    for (charCur=0;charCur<dataLength;charCur++)
+    /* Worked backwards so that each chain is only walked once: `runFollowing` is the count if a chain is continued
+       at `charCur`, whether or not that character may itself begin a chain */
+    runFollowing=0;
+    for (charCur=dataLength-1;charCur>=0;charCur--)
     {
-        T[charCur].CFollowing=0;
-        if ((T[charCur].CharacterSet & CodeC)!=0)
-        {
-            /* CodeC possible */
-            runChar=charCur;
-            do{
-                /* Whether this is FNC1, whether next is */
-                /* numeric */
-                if (T[runChar].CharacterSet==ZTFNC1)
-                    /* FNC1 */
-                    ++(T[charCur].CFollowing);
-                else
-                {
-                    ++runChar;
-                    if (runChar>=dataLength)
-                        break;
-                    /* Only a Number may follow */
-                    if (T[runChar].CharacterSet==ZTNum)
-                        T[charCur].CFollowing+=2;
-                    else
-                        break;
-                }
-                ++runChar;
-            } while (runChar<dataLength);
-        }
+        if (T[charCur].CharacterSet==ZTFNC1)
+            /* FNC1 */
+            runFollowing=nextFollowing+1;
+        else if (charCur+1<dataLength && T[charCur+1].CharacterSet==ZTNum)
+            /* Only a Number may follow */
+            runFollowing=nextNextFollowing+2;
+        else
+            runFollowing=0;
+        T[charCur].CFollowing=((T[charCur].CharacterSet & CodeC)!=0)?runFollowing:0;
+        nextNextFollowing=nextFollowing;
+        nextFollowing=runFollowing;
     }
 }
 
@@ -389,7 +379,8 @@ static int Columns2Rows(struct zint_symbol *symbol, CharacterSetTable *T, const
             /* > End of Codeline */
             pSet[charCur-1]|=CEnd;
             ++rowsCur;
-        } while (charCur<dataLength); /* <= Data.Len-1 */
+        /* Stop early if too many rows as will have to try again with more columns anyway */
+        } while (charCur<dataLength && rowsCur<=44); /* <= Data.Len-1 */
 
         /* Allow for check characters K1, K2 */
         switch (emptyColumns) {
@@ -444,11 +435,11 @@ static int Rows2Columns(struct zint_symbol *symbol, CharacterSetTable *T, const
     int fBackupOk = 0;      /* The memorised set is o.k. */
     int testListSize = 0;
     int pTestList[62];
-#ifndef _MSC_VER
-    int *pBackupSet[dataLength];
-#else
-    int *pBackupSet = (int *)_alloca(dataLength*sizeof(int));
-#endif
+    z_work_array(symbol, int, pBackupSet, dataLength);
+
+    if (z_work_failed(pBackupSet)) {
+        return z_work_error(symbol);
+    }
 
     rowsRequested=*pRows;
     columnsRequested = *pUseColumns >= 4 ? *pUseColumns : 0;
@@ -524,6 +515,13 @@ static int Rows2Columns(struct zint_symbol *symbol, CharacterSetTable *T, const
                 *pUseColumns=backupColumns;
                 return 0;
             }
+            if (useColumns >= 62) {
+                /* Can't get any longer so give this one back */
+                *pFillings=fillings;
+                *pRows=rowsCur;
+                *pUseColumns=useColumns;
+                return 0;
+            }
             /* > Test less rows (longer code) */
             backupRows=rowsCur;
             memcpy(pBackupSet,pSet,dataLength*sizeof(int));
@@ -638,12 +636,6 @@ INTERNAL int codablock(struct zint_symbol *symbol, unsigned char source[], int l
     int emptyColumns;
     char dest[1000];
     int r, c;
-#ifdef _MSC_VER
-    CharacterSetTable *T;
-    unsigned char *data;
-    int *pSet;
-    uchar * pOutput;
-#endif
     /* Suppresses clang-analyzer-core.VLASize warning */
     assert(length > 0);
 
@@ -672,11 +664,11 @@ INTERNAL int codablock(struct zint_symbol *symbol, unsigned char source[], int l
         return ZINT_ERROR_INVALID_OPTION;
     }
 
-#ifndef _MSC_VER
-    unsigned char data[length*2+1];
-#else
-    data = (unsigned char *) _alloca(length * 2+1);
-#endif
+    z_work_array(symbol, unsigned char, data, length*2+1);
+
+    if (z_work_failed(data)) {
+        return z_work_error(symbol);
+    }
 
     dataLength = 0;
     if (symbol->output_options & READER_INIT) {
@@ -696,13 +688,12 @@ INTERNAL int codablock(struct zint_symbol *symbol, unsigned char source[], int l
     }
 
     /* Build character set table */
-#ifndef _MSC_VER
-    CharacterSetTable T[dataLength];
-    int pSet[dataLength];
-#else
-    T=(CharacterSetTable *)_alloca(dataLength*sizeof(CharacterSetTable));
-    pSet = (int *)_alloca(dataLength*sizeof(int));
-#endif
+    z_work_array(symbol, CharacterSetTable, T, dataLength);
+    z_work_array(symbol, int, pSet, dataLength);
+
+    if (z_work_failed(T) || z_work_failed(pSet)) {
+        return z_work_error(symbol);
+    }
     CreateCharacterSetTable(T,data,dataLength);
 
     /* Find final row and column count */
@@ -776,11 +767,11 @@ INTERNAL int codablock(struct zint_symbol *symbol, unsigned char source[], int l
 
     /* >>> Build C128 code numbers */
     /* The C128 column count contains Start (2CW), Row ID, Checksum, Stop */
-#ifndef _MSC_VER
-    uchar pOutput[columns * rows];
-#else
-    pOutput = (unsigned char *)_alloca(columns * rows * sizeof(char));
-#endif
+    z_work_array(symbol, uchar, pOutput, columns * rows);
+
+    if (z_work_failed(pOutput)) {
+        return z_work_error(symbol);
+    }
     pOutPos = pOutput;
     charCur=0;
     /* >> Loop over rows */
@@ -971,11 +962,13 @@ INTERNAL int codablock(struct zint_symbol *symbol, unsigned char source[], int l
 
     /* Paint the C128 patterns */
     for (r = 0; r < rows; r++) {
-        strcpy(dest, "");
-        for(c = 0; c < columns; c++) {
-            strcat(dest, C128Table[pOutput[r * columns + c]]);
+        char *d = dest;
+        for (c = 0; c < columns; c++) {
+            const int len = pOutput[r * columns + c] == 106 ? 7 : 6; /* Stop character has extra bar */
+            memcpy(d, C128Table[pOutput[r * columns + c]], len);
+            d += len;
         }
-        expand(symbol, dest);
+        expand(symbol, dest, d - dest);
         symbol->row_height[r] = 10;
     }
 
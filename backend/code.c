@@ -44,7 +44,7 @@
 #define SILVER  "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%abcd"
 #define ARSENIC "0123456789ABCDEFGHJKLMNPRSTUVWXYZ"
 
-static const char *C11Table[11] = {
+static const char *const C11Table[11] = {
     "111121", "211121", "121121", "221111", "112121", "212111", "122111",
     "111221", "211211", "211111", "112111"
 };
@@ -53,7 +53,7 @@ static const char *C11Table[11] = {
 
 /* Incorporates Table A1 */
 
-static const char *C39Table[43] = {
+static const char *const C39Table[43] = {
     /* Code 39 character assignments (Table 1) */
     "1112212111", "2112111121", "1122111121", "2122111111", "1112211121",
     "2112211111", "1122211111", "1112112121", "2112112111", "1122112111", "2111121121",
@@ -65,7 +65,7 @@ static const char *C39Table[43] = {
     "1211121211", "1112121211"
 };
 
-static const char *EC39Ctrl[128] = {
+static const char *const EC39Ctrl[128] = {
     /* Encoding the full ASCII character set in Code 39 (Table A2) */
     "%U", "$A", "$B", "$C", "$D", "$E", "$F", "$G", "$H", "$I", "$J", "$K",
     "$L", "$M", "$N", "$O", "$P", "$Q", "$R", "$S", "$T", "$U", "$V", "$W", "$X", "$Y", "$Z",
@@ -77,7 +77,7 @@ static const char *EC39Ctrl[128] = {
     "+P", "+Q", "+R", "+S", "+T", "+U", "+V", "+W", "+X", "+Y", "+Z", "%P", "%Q", "%R", "%S", "%T"
 };
 
-static const char *C93Ctrl[128] = {
+static const char *const C93Ctrl[128] = {
     "bU", "aA", "aB", "aC", "aD", "aE", "aF", "aG", "aH", "aI", "aJ", "aK",
     "aL", "aM", "aN", "aO", "aP", "aQ", "aR", "aS", "aT", "aU", "aV", "aW", "aX", "aY", "aZ",
     "bA", "bB", "bC", "bD", "bE", " ", "cA", "cB", "cC", "$", "%", "cF", "cG", "cH", "cI", "cJ",
@@ -88,7 +88,7 @@ static const char *C93Ctrl[128] = {
     "dP", "dQ", "dR", "dS", "dT", "dU", "dV", "dW", "dX", "dY", "dZ", "bP", "bQ", "bR", "bS", "bT"
 };
 
-static const char *C93Table[47] = {
+static const char *const C93Table[47] = {
     "131112", "111213", "111312", "111411", "121113", "121212", "121311",
     "111114", "131211", "141111", "211113", "211212", "211311", "221112", "221211", "231111",
     "112113", "112212", "112311", "122112", "132111", "111123", "111222", "111321", "121122",
@@ -104,6 +104,7 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
     int h, c_digit, c_weight, c_count, k_digit, k_weight, k_count;
     int weight[122], error_number;
     char dest[750]; /* 6 + 121 * 6 + 2 * 6 + 5 + 1 == 750 */
+    char *d = dest;
     char checkstr[3];
     int num_check_digits;
 
@@ -138,15 +139,17 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
     k_count = 0;
 
     /* start character */
-    strcpy(dest, "112211");
+    memcpy(d, "112211", 6);
+    d += 6;
 
     /* Draw main body of barcode */
     for (i = 0; i < length; i++) {
-        lookup(SODIUM, C11Table, source[i], dest);
         if (source[i] == '-')
             weight[i] = 10;
         else
             weight[i] = ctoi(source[i]);
+        memcpy(d, C11Table[weight[i]], 6);
+        d += 6;
     }
 
     if (num_check_digits) {
@@ -167,7 +170,8 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
                 checkstr[0] = '-';
             }
             checkstr[1] = '\0';
-            lookup(SODIUM, C11Table, checkstr[0], dest);
+            memcpy(d, C11Table[c_digit], 6);
+            d += 6;
         } else {
             weight[length] = c_digit;
 
@@ -191,8 +195,10 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
                 checkstr[1] = '-';
             }
             checkstr[2] = '\0';
-            lookup(SODIUM, C11Table, checkstr[0], dest);
-            lookup(SODIUM, C11Table, checkstr[1], dest);
+            memcpy(d, C11Table[c_digit], 6);
+            d += 6;
+            memcpy(d, C11Table[k_digit], 6);
+            d += 6;
         }
     }
 
@@ -201,13 +207,16 @@ INTERNAL int code_11(struct zint_symbol *symbol, unsigned char source[], int len
     }
 
     /* Stop character */
-    strcat(dest, "11221");
+    memcpy(d, "11221", 5);
+    d += 5;
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
-    ustrcpy(symbol->text, source);
-    if (num_check_digits) {
-        ustrcat(symbol->text, checkstr);
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, source);
+        if (num_check_digits) {
+            ustrcat(symbol->text, checkstr);
+        }
     }
     return error_number;
 }
@@ -217,7 +226,9 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], int length)
     int i;
     int counter;
     int error_number;
+    int posns[85];
     char dest[880]; /* 10 (Start) + 85 * 10 + 10 (Check) + 9 (Stop) + 1 = 880 */
+    char *d = dest;
     char localstr[2] = {0};
 
     counter = 0;
@@ -237,18 +248,20 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], int length)
         return ZINT_ERROR_TOO_LONG;
     }
     to_upper(source);
-    error_number = is_sane(SILVER, source, length);
+    error_number = is_sane_lookup(SILVER, 43, source, length, posns);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "324: Invalid characters in data");
         return error_number;
     }
 
     /* Start character */
-    strcpy(dest, "1211212111");
+    memcpy(d, "1211212111", 10);
+    d += 10;
 
     for (i = 0; i < length; i++) {
-        lookup(SILVER, C39Table, source[i], dest);
-        counter += posn(SILVER, source[i]);
+        memcpy(d, C39Table[posns[i]], 10);
+        d += 10;
+        counter += posns[i];
     }
 
     if (symbol->option_2 == 1) {
@@ -281,7 +294,8 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], int length)
                 }
             }
         }
-        lookup(SILVER, C39Table, check_digit, dest);
+        memcpy(d, C39Table[counter], 10);
+        d += 10;
 
         /* Display a space check digit as _, otherwise it looks like an error */
         if (check_digit == ' ') {
@@ -293,11 +307,12 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], int length)
     }
 
     /* Stop character */
-    strcat(dest, "121121211");
+    memcpy(d, "121121211", 9);
+    d += 9;
 
     if ((symbol->symbology == BARCODE_LOGMARS) || (symbol->symbology == BARCODE_HIBC_39)) {
         /* LOGMARS uses wider 'wide' bars than normal Code 39 */
-        counter = (int) strlen(dest);
+        counter = (int) (d - dest);
         for (i = 0; i < counter; i++) {
             if (dest[i] == '2') {
                 dest[i] = '3';
@@ -305,13 +320,15 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], int length)
         }
     }
 
-	if (symbol->debug) {
-		printf("Barspaces: %s\n", dest);
-	}
+    if (symbol->debug & ZINT_DEBUG_PRINT) {
+        printf("Barspaces: %.*s\n", (int) (d - dest), dest);
+    }
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
-    if (symbol->symbology == BARCODE_CODE39) {
+    if (!z_hrt(symbol)) {
+        /* No text */
+    } else if (symbol->symbology == BARCODE_CODE39) {
         ustrcpy(symbol->text, "*");
         ustrncat(symbol->text, source, length);
         ustrcat(symbol->text, localstr);
@@ -334,7 +351,7 @@ INTERNAL int pharmazentral(struct zint_symbol *symbol, unsigned char source[], i
         strcpy(symbol->errtxt, "325: Input wrong length");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "326: Invalid characters in data");
         return error_number;
@@ -364,8 +381,10 @@ INTERNAL int pharmazentral(struct zint_symbol *symbol, unsigned char source[], i
     localstr[8] = itoc(check_digit);
     localstr[9] = '\0';
     error_number = c39(symbol, (unsigned char *) localstr, 9);
-    ustrcpy(symbol->text, "PZN ");
-    ustrcat(symbol->text, localstr);
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, "PZN ");
+        ustrcat(symbol->text, localstr);
+    }
     return error_number;
 }
 
@@ -373,6 +392,7 @@ INTERNAL int pharmazentral(struct zint_symbol *symbol, unsigned char source[], i
 INTERNAL int ec39(struct zint_symbol *symbol, unsigned char source[], int length) {
 
     unsigned char buffer[85 * 2 + 1] = {0};
+    unsigned char *b = buffer;
     int i;
     int error_number;
 
@@ -388,15 +408,21 @@ INTERNAL int ec39(struct zint_symbol *symbol, unsigned char source[], int length
             strcpy(symbol->errtxt, "329: Invalid characters in input data");
             return ZINT_ERROR_INVALID_DATA;
         }
-        ustrcat(buffer, EC39Ctrl[source[i]]);
+        /* Controls are 1 or 2 characters */
+        *b++ = EC39Ctrl[source[i]][0];
+        if (EC39Ctrl[source[i]][1]) {
+            *b++ = EC39Ctrl[source[i]][1];
+        }
     }
 
     /* Then sends the buffer to the C39 function */
-    error_number = c39(symbol, buffer, (int) ustrlen(buffer));
+    error_number = c39(symbol, buffer, (int) (b - buffer));
 
-    for (i = 0; i < length; i++)
-        symbol->text[i] = source[i] >= ' ' && source[i] != 0x7F ? source[i] : ' ';
-    symbol->text[length] = '\0';
+    if (z_hrt(symbol)) {
+        for (i = 0; i < length; i++)
+            symbol->text[i] = source[i] >= ' ' && source[i] != 0x7F ? source[i] : ' ';
+        symbol->text[length] = '\0';
+    }
 
     return error_number;
 }
@@ -412,10 +438,11 @@ INTERNAL int c93(struct zint_symbol *symbol, unsigned char source[], int length)
     int h, weight, c, k, values[128], error_number;
     char buffer[220];
     char dest[670];
+    char *d = dest;
     char set_copy[] = SILVER;
 
     error_number = 0;
-    strcpy(buffer, "");
+    h = 0;
 
     if (length > 107) {
         strcpy(symbol->errtxt, "330: Input too long");
@@ -429,12 +456,14 @@ INTERNAL int c93(struct zint_symbol *symbol, unsigned char source[], int length)
             strcpy(symbol->errtxt, "331: Invalid characters in input data");
             return ZINT_ERROR_INVALID_DATA;
         }
-        strcat(buffer, C93Ctrl[source[i]]);
-        symbol->text[i] = source[i] >= ' ' && source[i] != 0x7F ? source[i] : ' ';
+        /* Controls are 1 or 2 characters */
+        buffer[h++] = C93Ctrl[source[i]][0];
+        if (C93Ctrl[source[i]][1]) {
+            buffer[h++] = C93Ctrl[source[i]][1];
+        }
     }
 
     /* Now we can check the true length of the barcode */
-    h = (int) strlen(buffer);
     if (h > 107) {
         strcpy(symbol->errtxt, "332: Input too long");
         return ZINT_ERROR_TOO_LONG;
@@ -457,7 +486,6 @@ INTERNAL int c93(struct zint_symbol *symbol, unsigned char source[], int length)
     }
     c = c % 47;
     values[h] = c;
-    buffer[h] = set_copy[c];
 
     /* Check digit K */
     k = 0;
@@ -469,146 +497,159 @@ INTERNAL int c93(struct zint_symbol *symbol, unsigned char source[], int length)
             weight = 1;
     }
     k = k % 47;
-    buffer[++h] = set_copy[k];
-    buffer[++h] = '\0';
+    values[++h] = k;
+    h++;
 
     /* Start character */
-    strcpy(dest, "111141");
+    memcpy(d, "111141", 6);
+    d += 6;
 
     for (i = 0; i < h; i++) {
-        lookup(SILVER, C93Table, buffer[i], dest);
+        memcpy(d, C93Table[values[i]], 6);
+        d += 6;
     }
 
     /* Stop character */
-    strcat(dest, "1111411");
-    expand(symbol, dest);
+    memcpy(d, "1111411", 7);
+    d += 7;
+    expand(symbol, dest, d - dest);
 
-    symbol->text[length] = set_copy[c];
-    symbol->text[length + 1] = set_copy[k];
-    symbol->text[length + 2] = '\0';
+    if (z_hrt(symbol)) {
+        for (i = 0; i < length; i++) {
+            symbol->text[i] = source[i] >= ' ' && source[i] != 0x7F ? source[i] : ' ';
+        }
+        symbol->text[length] = set_copy[c];
+        symbol->text[length + 1] = set_copy[k];
+        symbol->text[length + 2] = '\0';
+    }
 
     return error_number;
 }
 
-typedef const struct s_channel_precalc {
-    long value; unsigned char B[8]; unsigned char S[8]; unsigned char bmax[7]; unsigned char smax[7];
-} channel_precalc;
+/* Channel Code symbols of a given number of channels are numbered in ascending lexicographic order of their
+   space/bar widths S[0], B[0], S[1], B[1]..., where the spaces and the bars each total 2 * channels - 1 modules,
+   and no 1-module bar may complete a run of 5 1-module elements (the finder pattern counting as a run of 1-module
+   elements) - see ANSI/AIM BC12-1998 Annex D. Rather than enumerating symbols up to the value (as CHNCHR in Annex D
+   Figure D5 does), the value is unranked directly by counting the completions of each partial symbol.
+
+   `channel_counts[p - 1][es][eb][run]` is the number of ways of placing the last `p` space/bar pairs, where `es`
+   and `eb` are the modules the spaces and bars still have to cover in excess of 1 each, and `run` is the number of
+   1-module elements (capped at 3) immediately preceding */
 
 //#define CHANNEL_GENERATE_PRECALCS
 
 #ifdef CHANNEL_GENERATE_PRECALCS
-/* To generate precalc tables uncomment define and run "./test_channel -f generate -g" and place result in "channel_precalcs.h" */
-static void channel_generate_precalc(int channels, long value, int mod, int last, int B[8], int S[8], int bmax[7], int smax[7]) {
-    int i;
-    if (value == mod) printf("static channel_precalc channel_precalcs%d[] = {\n", channels);
-    printf("    { %7ld, {", value); for (i = 0; i < 8; i++) printf(" %d,", B[i]); printf(" },");
-    printf(" {"); for (i = 0; i < 8; i++) printf(" %d,", S[i]); printf(" },");
-    printf(" {"); for (i = 0; i < 7; i++) printf(" %d,", bmax[i]); printf(" },");
-    printf(" {"); for (i = 0; i < 7; i++) printf(" %d,", smax[i]); printf(" }, },\n");
-    if (value == last) printf("};\n");
+static int channel_counts[7][8][8][4];
+
+/* To generate precalc table uncomment define and run "./test_channel -f generate -g" and place result in "channel_precalcs.h" */
+static void channel_generate_precalc(void) {
+    int p, es, eb, run, s, b, i;
+
+    for (p = 1; p <= 7; p++) {
+        for (es = 0; es < 8; es++) {
+            for (eb = 0; eb < 8; eb++) {
+                for (run = 0; run < 4; run++) {
+                    int count = 0;
+                    for (s = 0; s <= es; s++) {
+                        for (b = 0; b <= eb; b++) {
+                            const int next_run = b ? 0 : s ? 1 : run + 2 > 3 ? 3 : run + 2;
+                            if (s == 0 && b == 0 && run == 3) {
+                                continue; /* 1-module bar would complete a run of 5 */
+                            }
+                            if (p == 1) {
+                                count += es == s && eb == b;
+                            } else {
+                                count += channel_counts[p - 2][es - s][eb - b][next_run];
+                            }
+                        }
+                    }
+                    channel_counts[p - 1][es][eb][run] = count;
+                }
+            }
+        }
+    }
+
+    printf("static const int channel_counts[7][8][8][4] = {\n");
+    for (p = 0; p < 7; p++) {
+        printf("    { /* %d pair%s */\n", p + 1, p ? "s" : "");
+        for (es = 0; es < 8; es++) {
+            printf("        {");
+            for (eb = 0; eb < 8; eb++) {
+                if (eb == 4) printf("\n         ");
+                printf(" {");
+                for (i = 0; i < 4; i++) printf(" %d,", channel_counts[p][es][eb][i]);
+                printf(" },");
+            }
+            printf(" },\n");
+        }
+        printf("    },\n");
+    }
+    printf("};\n");
 }
 #else
 #include "channel_precalcs.h"
 #endif
 
-static long channel_copy_precalc(channel_precalc precalc, int B[8], int S[8], int bmax[7], int smax[7]) {
-    int i;
+/* Number of completions of a partial symbol up to and including the space of a pair, `p` the pairs left after
+   this one, `rs` the number of 1-module elements ending with the space */
+static long channel_count_after_space(const int p, const int es, const int eb, const int rs) {
+    long count = 0;
+    int b;
 
-    for (i = 0; i < 7; i++) {
-        B[i] = precalc.B[i];
-        S[i] = precalc.S[i];
-        bmax[i] = precalc.bmax[i];
-        smax[i] = precalc.smax[i];
+    if (rs < 4) { /* 1-module bar */
+        count = channel_counts[p - 1][es][eb][rs + 1 > 3 ? 3 : rs + 1];
     }
-    B[7] = precalc.B[7];
-    S[7] = precalc.S[7];
-
-    return precalc.value;
+    for (b = 1; b <= eb; b++) {
+        count += channel_counts[p - 1][es][eb - b][0];
+    }
+    return count;
 }
 
-/* CHNCHR is adapted from ANSI/AIM BC12-1998 Annex D Figure D5 and is Copyright (c) AIM 1997 */
-
-/* It is used here on the understanding that it forms part of the specification
-   for Channel Code and therefore its use is permitted under the following terms
-   set out in that document:
-
-   "It is the intent and understanding of AIM [t]hat the symbology presented in this
-   specification is entirely in the public domain and free of all use restrictions,
-   licenses and fees. AIM USA, its member companies, or individual officers
-   assume no liability for the use of this document." */
-
-static void CHNCHR(int channels, long target_value, int B[8], int S[8]) {
-    /* Use of initial pre-calculations taken from Barcode Writer in Pure PostScript (bwipp)
-     * Copyright (c) 2004-2020 Terry Burton (MIT/X-Consortium license) */
-    static channel_precalc initial_precalcs[6] = {
-        { 0, { 1, 1, 1, 1, 1, 2, 1, 2, }, { 1, 1, 1, 1, 1, 1, 1, 3, }, { 1, 1, 1, 1, 1, 3, 2, }, { 1, 1, 1, 1, 1, 3, 3, }, },
-        { 0, { 1, 1, 1, 1, 2, 1, 1, 3, }, { 1, 1, 1, 1, 1, 1, 1, 4, }, { 1, 1, 1, 1, 4, 3, 3, }, { 1, 1, 1, 1, 4, 4, 4, }, },
-        { 0, { 1, 1, 1, 2, 1, 1, 2, 3, }, { 1, 1, 1, 1, 1, 1, 1, 5, }, { 1, 1, 1, 5, 4, 4, 4, }, { 1, 1, 1, 5, 5, 5, 5, }, },
-        { 0, { 1, 1, 2, 1, 1, 2, 1, 4, }, { 1, 1, 1, 1, 1, 1, 1, 6, }, { 1, 1, 6, 5, 5, 5, 4, }, { 1, 1, 6, 6, 6, 6, 6, }, },
-        { 0, { 1, 2, 1, 1, 2, 1, 1, 5, }, { 1, 1, 1, 1, 1, 1, 1, 7, }, { 1, 7, 6, 6, 6, 5, 5, }, { 1, 7, 7, 7, 7, 7, 7, }, },
-        { 0, { 2, 1, 1, 2, 1, 1, 2, 5, }, { 1, 1, 1, 1, 1, 1, 1, 8, }, { 8, 7, 7, 7, 6, 6, 6, }, { 8, 8, 8, 8, 8, 8, 8, }, },
-    };
-    int bmax[7], smax[7];
-    long value = 0;
-
-    channel_copy_precalc(initial_precalcs[channels - 3], B, S, bmax, smax);
-
-#ifndef CHANNEL_GENERATE_PRECALCS
-    if (channels == 7 && target_value >= channel_precalcs7[0].value) {
-        value = channel_copy_precalc(channel_precalcs7[(target_value / channel_precalcs7[0].value) - 1], B, S, bmax, smax);
-    } else if (channels == 8 && target_value >= channel_precalcs8[0].value) {
-        value = channel_copy_precalc(channel_precalcs8[(target_value / channel_precalcs8[0].value) - 1], B, S, bmax, smax);
-    }
-#endif
+/* Set the space/bar widths of the symbol numbered `value` */
+static void channel_unrank(const int channels, long value, int B[8], int S[8]) {
+    int es = channels - 1, eb = channels - 1; /* Modules in excess of 1 each left to the spaces/bars */
+    int run = 3; /* 1-module elements preceding (capped at 3), the finder pattern counting as ones */
+    int i, s, b, rs;
 
-    goto chkchr;
-
-ls0:smax[1] = smax[0] + 1 - S[0]; B[0] = 1;
-    if (S[0] == 1) goto nb0;
-lb0:    bmax[1] = bmax[0] + 1 - B[0]; S[1] = 1;
-ls1:        smax[2] = smax[1] + 1 - S[1]; B[1] = 1;
-            if (S[0] + B[0] + S[1] == 3) goto nb1;
-lb1:            bmax[2] = bmax[1] + 1 - B[1]; S[2] = 1;
-ls2:                smax[3] = smax[2] + 1 - S[2]; B[2] = 1;
-                    if (B[0] + S[1] + B[1] + S[2] == 4) goto nb2;
-lb2:                    bmax[3] = bmax[2] + 1 - B[2]; S[3] = 1;
-ls3:                        smax[4] = smax[3] + 1 - S[3]; B[3] = 1;
-                            if (B[1] + S[2] + B[2] + S[3] == 4) goto nb3;
-lb3:                            bmax[4] = bmax[3] + 1 - B[3]; S[4] = 1;
-ls4:                                smax[5] = smax[4] + 1 - S[4]; B[4] = 1;
-                                    if (B[2] + S[3] + B[3] + S[4] == 4) goto nb4;
-lb4:                                    bmax[5] = bmax[4] + 1 - B[4]; S[5] = 1;
-ls5:                                        smax[6] = smax[5] + 1 - S[5]; B[5] = 1;
-                                            if (B[3] + S[4] + B[4] + S[5] == 4) goto nb5;
-lb5:                                            bmax[6] = bmax[5] + 1 - B[5]; S[6] = 1;
-ls6:                                                S[7] = smax[6] + 1 - S[6]; B[6] = 1;
-                                                    if (B[4] + S[5] + B[5] + S[6] == 4) goto nb6;
-lb6:                                                    B[7] = bmax[6] + 1 - B[6];
-                                                        if (B[5] + S[6] + B[6] + S[7] + B[7] == 5) goto nb6;
-chkchr:
 #ifdef CHANNEL_GENERATE_PRECALCS
-                                                        if (channels == 7 && value && value % 115338 == 0) { /* 115338 == (576688 + 2) / 5 */
-                                                            channel_generate_precalc(channels, value, 115338, 115338 * (5 - 1), B, S, bmax, smax);
-                                                        } else if (channels == 8 && value && value % 119121 == 0) { /* 119121 == (7742862 + 3) / 65 */
-                                                            channel_generate_precalc(channels, value, 119121, 119121 * (65 - 1), B, S, bmax, smax);
-                                                        }
+    channel_generate_precalc();
 #endif
-                                                        if (value == target_value) return;
-                                                        value++;
-nb6:                                                    if (++B[6] <= bmax[6]) goto lb6;
-                                                    if (++S[6] <= smax[6]) goto ls6;
-nb5:                                            if (++B[5] <= bmax[5]) goto lb5;
-                                            if (++S[5] <= smax[5]) goto ls5;
-nb4:                                    if (++B[4] <= bmax[4]) goto lb4;
-                                    if (++S[4] <= smax[4]) goto ls4;
-nb3:                            if (++B[3] <= bmax[3]) goto lb3;
-                            if (++S[3] <= smax[3]) goto ls3;
-nb2:                    if (++B[2] <= bmax[2]) goto lb2;
-                    if (++S[2] <= smax[2]) goto ls2;
-nb1:            if (++B[1] <= bmax[1]) goto lb1;
-            if (++S[1] <= smax[1]) goto ls1;
-nb0:    if (++B[0] <= bmax[0]) goto lb0;
-    if (++S[0] <= smax[0]) goto ls0;
+
+    for (i = 8 - channels; i < 7; i++) {
+        const int p = 7 - i;
+        long count;
+
+        for (s = 0; s < es; s++) {
+            count = channel_count_after_space(p, es - s, eb, s ? 0 : run + 1);
+            if (value < count) {
+                break;
+            }
+            value -= count;
+        }
+        es -= s;
+        rs = s ? 0 : run + 1;
+        S[i] = s + 1;
+
+        for (b = 0; b < eb; b++) {
+            if (b == 0) {
+                if (rs >= 4) {
+                    continue; /* 1-module bar would complete a run of 5 */
+                }
+                count = channel_counts[p - 1][es][eb][rs + 1 > 3 ? 3 : rs + 1];
+            } else {
+                count = channel_counts[p - 1][es][eb - b][0];
+            }
+            if (value < count) {
+                break;
+            }
+            value -= count;
+        }
+        eb -= b;
+        run = b ? 0 : rs + 1 > 3 ? 3 : rs + 1;
+        B[i] = b + 1;
+    }
+    S[7] = es + 1;
+    B[7] = eb + 1;
 }
 
 /* Channel Code - According to ANSI/AIM BC12-1998 */
@@ -616,6 +657,7 @@ INTERNAL int channel_code(struct zint_symbol *symbol, unsigned char source[], in
     int S[8] = {0}, B[8] = {0};
     long target_value = 0;
     char pattern[30];
+    char *pp = pattern;
     int channels, i;
     int error_number, range = 0, zeroes;
     char hrt[9];
@@ -624,7 +666,7 @@ INTERNAL int channel_code(struct zint_symbol *symbol, unsigned char source[], in
         strcpy(symbol->errtxt, "333: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "334: Invalid characters in data");
         return error_number;
@@ -690,26 +732,26 @@ INTERNAL int channel_code(struct zint_symbol *symbol, unsigned char source[], in
         return ZINT_ERROR_INVALID_DATA;
     }
 
-    CHNCHR(channels, target_value, B, S);
+    channel_unrank(channels, target_value, B, S);
 
-    strcpy(pattern, "111111111"); /* Finder pattern */
+    memcpy(pp, "111111111", 9); /* Finder pattern */
+    pp += 9;
     for (i = 8 - channels; i < 8; i++) {
-        char part[3];
-        part[0] = itoc(S[i]);
-        part[1] = itoc(B[i]);
-        part[2] = '\0';
-        strcat(pattern, part);
+        *pp++ = itoc(S[i]);
+        *pp++ = itoc(B[i]);
     }
 
     zeroes = channels - 1 - length;
     if (zeroes < 0) {
         zeroes = 0;
     }
-    memset(hrt, '0', zeroes);
-    ustrcpy(hrt + zeroes, source);
-    ustrcpy(symbol->text, hrt);
+    if (z_hrt(symbol)) {
+        memset(hrt, '0', zeroes);
+        ustrcpy(hrt + zeroes, source);
+        ustrcpy(symbol->text, hrt);
+    }
 
-    expand(symbol, pattern);
+    expand(symbol, pattern, pp - pattern);
 
     return error_number;
 }
@@ -721,10 +763,11 @@ INTERNAL int vin(struct zint_symbol *symbol, unsigned char source[], int length)
 
     char local_source[18];
     char dest[200]; /* 10 + 10 + 17 * 10 + 9 + 1 = 200 */
+    char *d = dest;
     char input_check;
     char output_check;
     int value[17];
-    int weight[17] = {8, 7, 6, 5, 4, 3, 2, 10, 0, 9, 8, 7, 6, 5, 4, 3, 2};
+    static const char weight[17] = {8, 7, 6, 5, 4, 3, 2, 10, 0, 9, 8, 7, 6, 5, 4, 3, 2};
     int sum;
     int i;
 
@@ -784,22 +827,28 @@ INTERNAL int vin(struct zint_symbol *symbol, unsigned char source[], int length)
     }
 
     /* Start character */
-    strcpy(dest, "1211212111");
+    memcpy(d, "1211212111", 10);
+    d += 10;
 
     /* Import character 'I' prefix? */
     if (symbol->option_2 & 1) {
-        strcat(dest, "1121122111");
+        memcpy(d, "1121122111", 10);
+        d += 10;
     }
 
     // Copy glyphs to symbol
     for (i = 0; i < 17; i++) {
-        lookup(SILVER, C39Table, local_source[i], dest);
+        memcpy(d, C39Table[posn(SILVER, local_source[i])], 10);
+        d += 10;
     }
 
-    strcat(dest, "121121211");
+    memcpy(d, "121121211", 9);
+    d += 9;
 
-    ustrcpy(symbol->text, local_source);
-    expand(symbol, dest);
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, local_source);
+    }
+    expand(symbol, dest, d - dest);
 
     return 0;
 }
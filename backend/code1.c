@@ -36,6 +36,7 @@
 #include "reedsol.h"
 #include "large.h"
 #include <stdio.h>
+#include <limits.h>
 #include <math.h>
 #ifdef _MSC_VER
 #include <malloc.h>
@@ -105,38 +106,18 @@ static void spigot(struct zint_symbol *symbol, const int row_no) {
 }
 
 /* Is basic (non-shifted) C40? */
-static int isc40(const unsigned char input) {
-    if ((input >= '0' && input <= '9') || (input >= 'A' && input <= 'Z') || input == ' ') {
-        return 1;
-    }
-    return 0;
-}
+#define isc40(input) is_chr(CHR_C40, input)
 
 /* Is basic (non-shifted) TEXT? */
-static int istext(const unsigned char input) {
-    if ((input >= '0' && input <= '9') || (input >= 'a' && input <= 'z') || input == ' ') {
-        return 1;
-    }
-    return 0;
-}
+#define istext(input) is_chr(CHR_TEXT, input)
 
 /* Is basic (non-shifted) C40/TEXT? */
 static int isc40text(const int current_mode, const unsigned char input) {
-    return current_mode == C1_C40 ? isc40(input) : istext(input);
+    return is_chr(current_mode == C1_C40 ? CHR_C40 : CHR_TEXT, input);
 }
 
 /* EDI characters are uppercase alphanumerics plus space plus EDI terminator (CR) plus 2 EDI separator chars */
-static int isedi(const unsigned char input) {
-
-    if (isc40(input)) {
-        return 1;
-    }
-    if (input == 13 || input == '*' || input == '>') {
-        return 1;
-    }
-
-    return 0;
-}
+#define isedi(input) is_chr(CHR_X12, input)
 
 /* Whether Step Q4bi applies, i.e. if one of the 3 EDI terminator/separator chars appears before a non-EDI char */
 static int is_step_Q4bi_applicable(const unsigned char source[], const int sourcelen, const int position) {
@@ -302,7 +283,7 @@ static int c1_look_ahead_test(const unsigned char source[], const int sourcelen,
 
 /* Whether can fit last character or characters in a single ASCII codeword */
 static int is_last_single_ascii(const unsigned char string[], const int length, const int sp) {
-    if (length - sp == 1 && string[sp + 1] <= 127) {
+    if (length - sp == 1 && string[sp] <= 127) {
         return 1;
     }
     if (length - sp == 2 && istwodigits(string, length, sp)) {
@@ -448,6 +429,255 @@ static int c40text_cnt(const int current_mode, const int gs1, unsigned char inpu
     return cnt;
 }
 
+/* Minimal encodation states: the mode, and for C40/TEXT/EDI the values pending (0-2) and for DECIMAL the bits
+   pending (0, 2, 4 or 6) */
+#define C1_MIN_ASCII    0
+#define C1_MIN_C40      1
+#define C1_MIN_TEXT     4
+#define C1_MIN_EDI      7
+#define C1_MIN_DECIMAL  10
+#define C1_MIN_BYTE     14
+#define C1_MIN_STATES   15
+
+#define C1_MIN_NONE     INT_MAX /* Cost of a state not reached */
+#define C1_MIN_START    0xFF /* Predecessor of a starting state */
+
+/* Bits `c1_encode()` adds at the end of data when in minimal encodation `state` having used `cost` bits, or -1 if
+   it would backtrack instead (which is costed by unlatching before the incomplete triplet) */
+static int c1_minimal_end_cost(struct zint_symbol *symbol, const int state, const int cost,
+            const unsigned char last) {
+    int cws_remaining;
+
+    if (state == C1_MIN_ASCII || state == C1_MIN_BYTE) {
+        return 0;
+    }
+    cws_remaining = codewords_remaining(symbol, cost >> 3);
+
+    if (state < C1_MIN_EDI) { /* C40/TEXT */
+        const int pending = (state - C1_MIN_C40) % 3;
+        if (pending == 0) {
+            return 0;
+        }
+        if (pending == 1 && cws_remaining == 1 && isc40text(state < C1_MIN_TEXT ? C1_C40 : C1_TEXT, last)) {
+            return 8; /* As ASCII */
+        }
+        if (pending == 2 && cws_remaining == 2) {
+            return 16; /* Padded with Shift 0 */
+        }
+        return -1;
+    }
+    if (state < C1_MIN_DECIMAL) { /* EDI */
+        return state == C1_MIN_EDI ? 0 : -1;
+    }
+    /* DECIMAL: unlatch unless only one codeword remaining, then pad to a codeword boundary */
+    return (((cost + (cws_remaining > 1 ? 6 : 0)) + 7) & ~7) - cost;
+}
+
+/* Set `modes[]` to the modes to encode `source[]` in that give the fewest codewords, for `c1_encode()` to use in
+   place of `c1_look_ahead_test()` and the digit run rules, given `tp` codewords already output. Finds the cheapest
+   path (in bits) through the states the encoder can be in before each character, following its rules: ASCII pairs
+   digits and latches to another mode before any character, C40/TEXT/EDI unlatch only after a complete triplet,
+   DECIMAL encodes 3 digits at a time and its unlatch pads to a codeword boundary (taking in a following digit if 4
+   or more bits are free), and BYTE may stop before any character. A GS1 FNC1 followed by DECIMAL is a single
+   codeword. A digit taken in by a DECIMAL unlatch is given mode C1_ASCII, as is the encoder's cue to unlatch, and a
+   FNC1 and DECIMAL latch mode C1_DECIMAL. Returns 0 on success, else ZINT_ERROR_MEMORY */
+static int c1_minimal_modes(struct zint_symbol *symbol, const unsigned char source[], const int length,
+            const int gs1, const int tp, char modes[]) {
+    static const char state_modes[C1_MIN_STATES] = {
+        C1_ASCII, C1_C40, C1_C40, C1_C40, C1_TEXT, C1_TEXT, C1_TEXT, C1_EDI, C1_EDI, C1_EDI,
+        C1_DECIMAL, C1_DECIMAL, C1_DECIMAL, C1_DECIMAL, C1_BYTE
+    };
+    int *costs, *byte_lens;
+    unsigned char *preds; /* Characters advanced (0-3) << 4 | previous state */
+    int i, p, state, best_cost;
+
+    costs = (int *) z_malloc(z_allocator(symbol), sizeof(int) * (length + 1) * C1_MIN_STATES);
+    byte_lens = (int *) z_malloc(z_allocator(symbol), sizeof(int) * (length + 1));
+    preds = (unsigned char *) z_malloc(z_allocator(symbol), (size_t) (length + 1) * C1_MIN_STATES);
+    if (!costs || !byte_lens || !preds) {
+        z_free(z_allocator(symbol), costs);
+        z_free(z_allocator(symbol), byte_lens);
+        z_free(z_allocator(symbol), preds);
+        strcpy(symbol->errtxt, "535: Insufficient memory for minimal encodation");
+        return ZINT_ERROR_MEMORY;
+    }
+    for (i = 0; i < (length + 1) * C1_MIN_STATES; i++) {
+        costs[i] = C1_MIN_NONE;
+    }
+    costs[C1_MIN_ASCII] = tp * 8;
+    preds[C1_MIN_ASCII] = C1_MIN_START;
+    if (gs1) {
+        /* Initial FNC1 may also change to DECIMAL */
+        costs[C1_MIN_DECIMAL] = tp * 8;
+        preds[C1_MIN_DECIMAL] = C1_MIN_START;
+    }
+
+#define C1_MIN_STEP(advance, next_state, next_cost) do { \
+        const int c1_i = (p + (advance)) * C1_MIN_STATES + (next_state); \
+        if ((next_cost) < costs[c1_i]) { \
+            costs[c1_i] = (next_cost); \
+            preds[c1_i] = (unsigned char) ((advance) << 4 | state); \
+        } \
+    } while (0)
+
+    for (p = 0; p < length; p++) {
+        int *const cost = costs + p * C1_MIN_STATES;
+        const unsigned char ch = source[p];
+        const int digit = ch >= '0' && ch <= '9';
+
+        /* Unlatch to ASCII (DECIMAL taking in a digit is done below) */
+        for (state = C1_MIN_C40; state < C1_MIN_STATES; state++) {
+            int unlatch;
+            if (cost[state] == C1_MIN_NONE) {
+                continue;
+            }
+            if (state < C1_MIN_DECIMAL) {
+                if ((state - C1_MIN_C40) % 3) {
+                    continue; /* Mid-triplet */
+                }
+                /* EDI doesn't unlatch if data fits as ASCII in last data codeword */
+                unlatch = state == C1_MIN_EDI && is_last_single_ascii(source, length, p)
+                            && codewords_remaining(symbol, cost[state] >> 3) == 1 ? 0 : 8;
+            } else if (state < C1_MIN_BYTE) {
+                if (digit && state >= C1_MIN_DECIMAL + 2) {
+                    continue; /* 4 or more bits free after unlatch so digit taken in */
+                }
+                unlatch = ((cost[state] + 6 + 7) & ~7) - cost[state];
+            } else {
+                unlatch = 0;
+            }
+            if (cost[state] + unlatch < cost[C1_MIN_ASCII]) {
+                cost[C1_MIN_ASCII] = cost[state] + unlatch;
+                preds[p * C1_MIN_STATES + C1_MIN_ASCII] = (unsigned char) state;
+            }
+        }
+
+        /* Latch from ASCII */
+        if (cost[C1_MIN_ASCII] != C1_MIN_NONE) {
+            static const char latch_states[4] = { C1_MIN_C40, C1_MIN_TEXT, C1_MIN_EDI, C1_MIN_BYTE };
+            const int ascii_cost = cost[C1_MIN_ASCII];
+            for (i = 0; i < 4; i++) {
+                state = latch_states[i];
+                /* BYTE also has its length field */
+                if (ascii_cost + 8 + (state == C1_MIN_BYTE) * 8 < cost[state]) {
+                    cost[state] = ascii_cost + 8 + (state == C1_MIN_BYTE) * 8;
+                    preds[p * C1_MIN_STATES + state] = C1_MIN_ASCII;
+                    if (state == C1_MIN_BYTE) {
+                        byte_lens[p] = 0;
+                    }
+                }
+            }
+            /* DECIMAL latch is 4 bits (not at start if GS1, as initial FNC1 will change to DECIMAL instead) */
+            if (digit && !(gs1 && p == 0) && ascii_cost + 4 < cost[C1_MIN_DECIMAL + 2]) {
+                cost[C1_MIN_DECIMAL + 2] = ascii_cost + 4;
+                preds[p * C1_MIN_STATES + C1_MIN_DECIMAL + 2] = C1_MIN_ASCII;
+            }
+        }
+
+        /* Encode the character (or characters) in each state reached */
+        for (state = 0; state < C1_MIN_STATES; state++) {
+            const int state_cost = cost[state];
+            if (state_cost == C1_MIN_NONE) {
+                continue;
+            }
+            if (state == C1_MIN_ASCII) {
+                if (istwodigits(source, length, p)) {
+                    C1_MIN_STEP(2, C1_MIN_ASCII, state_cost + 8);
+                }
+                C1_MIN_STEP(1, C1_MIN_ASCII, state_cost + (ch > 127 ? 16 : 8)); /* FNC4 for extended ASCII */
+                if (gs1 && ch == '[') {
+                    C1_MIN_STEP(1, C1_MIN_DECIMAL, state_cost + 8); /* FNC1 and change to DECIMAL */
+                }
+            } else if (state < C1_MIN_EDI) {
+                const int base = state < C1_MIN_TEXT ? C1_MIN_C40 : C1_MIN_TEXT;
+                const int values = state - base + c40text_cnt(state_modes[state], gs1, ch);
+                C1_MIN_STEP(1, base + values % 3, state_cost + (values / 3) * 16);
+            } else if (state < C1_MIN_DECIMAL) {
+                if (isedi(ch)) {
+                    if (state == C1_MIN_EDI + 2) {
+                        C1_MIN_STEP(1, C1_MIN_EDI, state_cost + 16);
+                    } else {
+                        C1_MIN_STEP(1, state + 1, state_cost);
+                    }
+                }
+            } else if (state < C1_MIN_BYTE) {
+                if (length - p < 3 && codewords_remaining(symbol, state_cost >> 3) == 1) {
+                    /* Step F1: last character or last 2 digits as ASCII, or last digit in 4 bits, without unlatch */
+                    if (state == C1_MIN_DECIMAL && is_last_single_ascii(source, length, p)) {
+                        C1_MIN_STEP(length - p, C1_MIN_ASCII, state_cost + 8);
+                    } else if (digit && p + 1 == length && state <= C1_MIN_DECIMAL + 2) {
+                        C1_MIN_STEP(1, C1_MIN_ASCII, (state_cost + 4 + 7) & ~7);
+                    }
+                }
+                if (digit && p + 2 < length && source[p + 1] >= '0' && source[p + 1] <= '9'
+                        && source[p + 2] >= '0' && source[p + 2] <= '9') {
+                    /* 10 bits leave 2 more bits pending, modulo 8 */
+                    C1_MIN_STEP(3, C1_MIN_DECIMAL + (state - C1_MIN_DECIMAL + 1) % 4, state_cost + 10);
+                }
+                if (digit && state >= C1_MIN_DECIMAL + 2) {
+                    /* Unlatch taking in the digit as 4 bits */
+                    C1_MIN_STEP(1, C1_MIN_ASCII, ((state_cost + 6 + 4 + 7) & ~7));
+                }
+            } else if (!(gs1 && ch == '[')) { /* BYTE can't encode FNC1 */
+                /* Byte count becomes 2 codewords after 249 */
+                const int c1_i = (p + 1) * C1_MIN_STATES + C1_MIN_BYTE;
+                const int next_cost = state_cost + 8 + (byte_lens[p] + 1 == 250) * 8;
+                if (next_cost < costs[c1_i]) {
+                    costs[c1_i] = next_cost;
+                    preds[c1_i] = (unsigned char) (1 << 4 | C1_MIN_BYTE);
+                    byte_lens[p + 1] = byte_lens[p] + 1;
+                }
+            }
+        }
+    }
+#undef C1_MIN_STEP
+
+    /* Choose the state to end in, costing the end of data as `c1_encode()` will for the symbol size */
+    best_cost = C1_MIN_NONE;
+    state = C1_MIN_ASCII;
+    for (i = 0; i < C1_MIN_STATES; i++) {
+        const int cost = costs[length * C1_MIN_STATES + i];
+        int end_cost;
+        if (cost == C1_MIN_NONE
+                || (end_cost = c1_minimal_end_cost(symbol, i, cost, source[length - 1])) == -1) {
+            continue;
+        }
+        if (cost + end_cost < best_cost) {
+            best_cost = cost + end_cost;
+            state = i;
+        }
+    }
+    if (symbol->debug & ZINT_DEBUG_PRINT) {
+        printf("Minimal encodation codewords: %d\n", (best_cost + 7) >> 3);
+    }
+
+    /* Trace back from the end, setting the modes of the states each character was encoded in */
+    p = length;
+    while (preds[p * C1_MIN_STATES + state] != C1_MIN_START) {
+        const int advance = preds[p * C1_MIN_STATES + state] >> 4;
+        const int prev_state = preds[p * C1_MIN_STATES + state] & 0x0F;
+        if (advance) {
+            char mode = state_modes[prev_state];
+            if (prev_state == C1_MIN_ASCII && state == C1_MIN_DECIMAL && advance == 1) {
+                mode = C1_DECIMAL; /* FNC1 and change to DECIMAL */
+            } else if (prev_state >= C1_MIN_DECIMAL && prev_state < C1_MIN_BYTE && state == C1_MIN_ASCII) {
+                mode = C1_ASCII; /* Digit taken in by DECIMAL unlatch */
+            }
+            for (i = p - advance; i < p; i++) {
+                modes[i] = mode;
+            }
+        }
+        p -= advance;
+        state = prev_state;
+    }
+
+    z_free(z_allocator(symbol), costs);
+    z_free(z_allocator(symbol), byte_lens);
+    z_free(z_allocator(symbol), preds);
+
+    return 0;
+}
+
 /* Copy `source` to `eci_buf` with "\NNNNNN" ECI indicator at start and backslashes escaped */
 static void eci_escape(const int eci, unsigned char *source, const int length, unsigned char *eci_buf,
             const int eci_length) {
@@ -464,7 +694,7 @@ static void eci_escape(const int eci, unsigned char *source, const int length, u
     eci_buf[j] = '\0';
 }
 
-/* Convert to codewords */
+/* Convert to codewords. Returns number of codewords, 0 if too many, or -1 if out of memory */
 static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigned int target[], int length,
             int *p_last_mode) {
     int current_mode, next_mode;
@@ -475,13 +705,15 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
     int byte_start = 0;
     int debug_print = symbol->debug & ZINT_DEBUG_PRINT;
     int eci_length = length + 7 + chr_cnt(source, length, '\\');
-#ifndef _MSC_VER
-    unsigned char eci_buf[eci_length + 1];
-    int num_digits[eci_length + 1];
-#else
-    unsigned char *eci_buf = (unsigned char *) _alloca(eci_length + 1);
-    int *num_digits = (int *) _alloca(sizeof(int) * (eci_length + 1));
-#endif
+    const int minimal = symbol->input_mode & MINIMAL_MODE;
+    char *modes = NULL; /* If MINIMAL_MODE, the modes from `c1_minimal_modes()` */
+    z_work_array(symbol, unsigned char, eci_buf, eci_length + 1);
+    z_work_array(symbol, int, num_digits, eci_length + 1);
+
+    if (z_work_failed(eci_buf) || z_work_failed(num_digits)) {
+        z_work_error(symbol);
+        return -1;
+    }
 
     sp = 0;
     tp = 0;
@@ -496,12 +728,28 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
     } else {
         gs1 = 0;
     }
+    if (!gs1 && symbol->eci) {
+        eci_escape(symbol->eci, source, length, eci_buf, eci_length);
+        source = eci_buf;
+        length = eci_length;
+    }
+    if (minimal) {
+        modes = (char *) z_malloc(z_allocator(symbol), length);
+        if (!modes || c1_minimal_modes(symbol, source, length, gs1, gs1 ? 1 : symbol->eci ? 2 : 0, modes)) {
+            if (!modes) {
+                strcpy(symbol->errtxt, "535: Insufficient memory for minimal encodation");
+            }
+            z_free(z_allocator(symbol), modes);
+            return -1;
+        }
+    }
+
     if (gs1) {
         set_num_digits(source, length, num_digits);
-        if (length >= 15 && num_digits[0] >= 15) {
+        if (minimal ? modes[0] == C1_DECIMAL && source[0] != '[' : length >= 15 && num_digits[0] >= 15) {
             target[tp++] = 236; /* FNC1 and change to Decimal */
             next_mode = C1_DECIMAL;
-        } else if (length >= 7 && num_digits[0] == length) {
+        } else if (!minimal && length >= 7 && num_digits[0] == length) {
             target[tp++] = 236; /* FNC1 and change to Decimal */
             next_mode = C1_DECIMAL;
         } else {
@@ -512,9 +760,6 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
         if (symbol->eci) {
             target[tp++] = 129; /* Pad */
             target[tp++] = '\\' + 1; /* Escape char */
-            eci_escape(symbol->eci, source, length, eci_buf, eci_length);
-            source = eci_buf;
-            length = eci_length;
         }
         set_num_digits(source, length, num_digits);
     }
@@ -541,7 +786,39 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
             /* Step B - ASCII encodation */
             next_mode = C1_ASCII;
 
-            if ((length - sp) >= 21 && num_digits[sp] >= 21) {
+            if (minimal) {
+                if (modes[sp] == C1_DECIMAL) {
+                    if (gs1 && source[sp] == '[') {
+                        target[tp++] = 236; /* FNC1 and change to Decimal */
+                        sp++;
+                    } else {
+                        db_p = bin_append_posn(15, 4, decimal_binary, db_p);
+                    }
+                    next_mode = C1_DECIMAL;
+                } else if (modes[sp] != C1_ASCII) {
+                    next_mode = modes[sp];
+                } else {
+                    if (istwodigits(source, length, sp) && modes[sp + 1] == C1_ASCII) {
+                        if (debug_print) printf("ASCII double-digits ");
+
+                        target[tp++] = (10 * ctoi(source[sp])) + ctoi(source[sp + 1]) + 130;
+                        sp += 2;
+                    } else {
+                        if (debug_print) printf("ASCII ");
+
+                        if (source[sp] > 127) {
+                            target[tp++] = 235; /* FNC4 (Upper Shift) */
+                            target[tp++] = (source[sp] - 128) + 1;
+                        } else if ((gs1) && (source[sp] == '[')) {
+                            target[tp++] = 232; /* FNC1 */
+                        } else {
+                            target[tp++] = source[sp] + 1;
+                        }
+                        sp++;
+                    }
+                }
+
+            } else if ((length - sp) >= 21 && num_digits[sp] >= 21) {
                 /* Step B1 */
                 next_mode = C1_DECIMAL;
                 db_p = bin_append_posn(15, 4, decimal_binary, db_p);
@@ -551,7 +828,7 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
                 db_p = bin_append_posn(15, 4, decimal_binary, db_p);
             }
 
-            if (next_mode == C1_ASCII) {
+            if (!minimal && next_mode == C1_ASCII) {
                 if (istwodigits(source, length, sp)) {
                     if (debug_print) printf("ASCII double-digits ");
 
@@ -604,7 +881,9 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
             next_mode = current_mode;
             if (cte_p == 0) {
                 /* Step C/D1 */
-                if ((length - sp) >= 12 && num_digits[sp] >= 12) {
+                if (minimal) {
+                    next_mode = modes[sp] == current_mode ? current_mode : C1_ASCII;
+                } else if ((length - sp) >= 12 && num_digits[sp] >= 12) {
                     /* Step C/D1a */
                     next_mode = C1_ASCII;
                 } else if ((length - sp) >= 8 && num_digits[sp] == (length - sp)) {
@@ -660,7 +939,9 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
             next_mode = C1_EDI;
             if (cte_p == 0) {
                 /* Step E1 */
-                if ((length - sp) >= 12 && num_digits[sp] >= 12) {
+                if (minimal) {
+                    next_mode = modes[sp] == C1_EDI ? C1_EDI : C1_ASCII;
+                } else if ((length - sp) >= 12 && num_digits[sp] >= 12) {
                     /* Step E1a */
                     next_mode = C1_ASCII;
                 } else if ((length - sp) >= 8 && num_digits[sp] == (length - sp)) {
@@ -737,7 +1018,7 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
                 next_mode = C1_ASCII;
 
             } else {
-                if (num_digits[sp] < 3) {
+                if (minimal ? modes[sp] != C1_DECIMAL || (gs1 && source[sp] == '[') : num_digits[sp] < 3) {
                     /* Step F2 */
                     db_p = decimal_unlatch(decimal_binary, db_p, target, &tp, num_digits[sp], source, &sp);
                     current_mode = next_mode = C1_ASCII; /* Note need to set current_mode also in case exit loop */
@@ -758,6 +1039,8 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
 
             if (gs1 && (source[sp] == '[')) {
                 next_mode = C1_ASCII;
+            } else if (minimal) {
+                next_mode = modes[sp] == C1_BYTE ? C1_BYTE : C1_ASCII;
             } else {
                 if (source[sp] <= 127) {
                     next_mode = c1_look_ahead_test(source, length, sp, current_mode, gs1);
@@ -787,10 +1070,13 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
         if (tp > 1480) {
             if (debug_print) printf("\n");
             /* Data is too large for symbol */
+            z_free(z_allocator(symbol), modes);
             return 0;
         }
     } while (sp < length);
 
+    z_free(z_allocator(symbol), modes);
+
     if (debug_print) {
         printf("\nEnd Current Mode: %d, tp %d, cte_p %d, db_p %d\n", current_mode, tp, cte_p, db_p);
     }
@@ -904,28 +1190,303 @@ static int c1_encode(struct zint_symbol *symbol, unsigned char source[], unsigne
     return tp;
 }
 
-/* Set symbol from datagrid */
-static void block_copy(struct zint_symbol *symbol, char datagrid[136][120], const int start_row, const int start_col,
-            const int height, const int width, const int row_offset, const int col_offset) {
+/* Add to the placement map of `templ` the datagrid block at `start_row`, `start_col` of `height` x `width`, as
+   pairs of datagrid index and symbol module (row << 8 | column) offset by `row_offset`, `col_offset` */
+static void block_copy(struct zint_template *templ, const int start_row, const int start_col, const int height,
+            const int width, const int row_offset, const int col_offset) {
     int i, j;
+    int *positions = templ->positions + templ->positions_len;
 
     for (i = start_row; i < (start_row + height); i++) {
         for (j = start_col; j < (start_col + width); j++) {
-            if (datagrid[i][j]) {
-                set_module(symbol, i + row_offset, j + col_offset);
-            }
+            *positions++ = i * 120 + j;
+            *positions++ = ((i + row_offset) << 8) | (j + col_offset);
         }
     }
+    templ->positions_len = (int) (positions - templ->positions);
+}
+
+/* Draw the recognition patterns of version `size` (and `sub_version` if S or T) into `symbol`, which must be clear,
+   keeping them in `templ->grid` (bit-packed rows), and add the placement map of the data regions to `templ` */
+static void c1_setup_grid(struct zint_symbol *symbol, struct zint_template *templ, const int size,
+            const int sub_version) {
+    const int row_bytes = (symbol->width + 7) >> 3;
+    int i;
+
+    templ->positions_len = 0;
+
+    switch (size) {
+        case 1: /* Version A */
+            central_finder(symbol, 6, 3, 1);
+            vert(symbol, 4, 6, 1);
+            vert(symbol, 12, 5, 0);
+            set_module(symbol, 5, 12);
+            spigot(symbol, 0);
+            spigot(symbol, 15);
+            block_copy(templ, 0, 0, 5, 4, 0, 0);
+            block_copy(templ, 0, 4, 5, 12, 0, 2);
+            block_copy(templ, 5, 0, 5, 12, 6, 0);
+            block_copy(templ, 5, 12, 5, 4, 6, 2);
+            break;
+        case 2: /* Version B */
+            central_finder(symbol, 8, 4, 1);
+            vert(symbol, 4, 8, 1);
+            vert(symbol, 16, 7, 0);
+            set_module(symbol, 7, 16);
+            spigot(symbol, 0);
+            spigot(symbol, 21);
+            block_copy(templ, 0, 0, 7, 4, 0, 0);
+            block_copy(templ, 0, 4, 7, 16, 0, 2);
+            block_copy(templ, 7, 0, 7, 16, 8, 0);
+            block_copy(templ, 7, 16, 7, 4, 8, 2);
+            break;
+        case 3: /* Version C */
+            central_finder(symbol, 11, 4, 2);
+            vert(symbol, 4, 11, 1);
+            vert(symbol, 26, 13, 1);
+            vert(symbol, 4, 10, 0);
+            vert(symbol, 26, 10, 0);
+            spigot(symbol, 0);
+            spigot(symbol, 27);
+            block_copy(templ, 0, 0, 10, 4, 0, 0);
+            block_copy(templ, 0, 4, 10, 20, 0, 2);
+            block_copy(templ, 0, 24, 10, 4, 0, 4);
+            block_copy(templ, 10, 0, 10, 4, 8, 0);
+            block_copy(templ, 10, 4, 10, 20, 8, 2);
+            block_copy(templ, 10, 24, 10, 4, 8, 4);
+            break;
+        case 4: /* Version D */
+            central_finder(symbol, 16, 5, 1);
+            vert(symbol, 4, 16, 1);
+            vert(symbol, 20, 16, 1);
+            vert(symbol, 36, 16, 1);
+            vert(symbol, 4, 15, 0);
+            vert(symbol, 20, 15, 0);
+            vert(symbol, 36, 15, 0);
+            spigot(symbol, 0);
+            spigot(symbol, 12);
+            spigot(symbol, 27);
+            spigot(symbol, 39);
+            block_copy(templ, 0, 0, 15, 4, 0, 0);
+            block_copy(templ, 0, 4, 15, 14, 0, 2);
+            block_copy(templ, 0, 18, 15, 14, 0, 4);
+            block_copy(templ, 0, 32, 15, 4, 0, 6);
+            block_copy(templ, 15, 0, 15, 4, 10, 0);
+            block_copy(templ, 15, 4, 15, 14, 10, 2);
+            block_copy(templ, 15, 18, 15, 14, 10, 4);
+            block_copy(templ, 15, 32, 15, 4, 10, 6);
+            break;
+        case 5: /* Version E */
+            central_finder(symbol, 22, 5, 2);
+            vert(symbol, 4, 22, 1);
+            vert(symbol, 26, 24, 1);
+            vert(symbol, 48, 22, 1);
+            vert(symbol, 4, 21, 0);
+            vert(symbol, 26, 21, 0);
+            vert(symbol, 48, 21, 0);
+            spigot(symbol, 0);
+            spigot(symbol, 12);
+            spigot(symbol, 39);
+            spigot(symbol, 51);
+            block_copy(templ, 0, 0, 21, 4, 0, 0);
+            block_copy(templ, 0, 4, 21, 20, 0, 2);
+            block_copy(templ, 0, 24, 21, 20, 0, 4);
+            block_copy(templ, 0, 44, 21, 4, 0, 6);
+            block_copy(templ, 21, 0, 21, 4, 10, 0);
+            block_copy(templ, 21, 4, 21, 20, 10, 2);
+            block_copy(templ, 21, 24, 21, 20, 10, 4);
+            block_copy(templ, 21, 44, 21, 4, 10, 6);
+            break;
+        case 6: /* Version F */
+            central_finder(symbol, 31, 5, 3);
+            vert(symbol, 4, 31, 1);
+            vert(symbol, 26, 35, 1);
+            vert(symbol, 48, 31, 1);
+            vert(symbol, 70, 35, 1);
+            vert(symbol, 4, 30, 0);
+            vert(symbol, 26, 30, 0);
+            vert(symbol, 48, 30, 0);
+            vert(symbol, 70, 30, 0);
+            spigot(symbol, 0);
+            spigot(symbol, 12);
+            spigot(symbol, 24);
+            spigot(symbol, 45);
+            spigot(symbol, 57);
+            spigot(symbol, 69);
+            block_copy(templ, 0, 0, 30, 4, 0, 0);
+            block_copy(templ, 0, 4, 30, 20, 0, 2);
+            block_copy(templ, 0, 24, 30, 20, 0, 4);
+            block_copy(templ, 0, 44, 30, 20, 0, 6);
+            block_copy(templ, 0, 64, 30, 4, 0, 8);
+            block_copy(templ, 30, 0, 30, 4, 10, 0);
+            block_copy(templ, 30, 4, 30, 20, 10, 2);
+            block_copy(templ, 30, 24, 30, 20, 10, 4);
+            block_copy(templ, 30, 44, 30, 20, 10, 6);
+            block_copy(templ, 30, 64, 30, 4, 10, 8);
+            break;
+        case 7: /* Version G */
+            central_finder(symbol, 47, 6, 2);
+            vert(symbol, 6, 47, 1);
+            vert(symbol, 27, 49, 1);
+            vert(symbol, 48, 47, 1);
+            vert(symbol, 69, 49, 1);
+            vert(symbol, 90, 47, 1);
+            vert(symbol, 6, 46, 0);
+            vert(symbol, 27, 46, 0);
+            vert(symbol, 48, 46, 0);
+            vert(symbol, 69, 46, 0);
+            vert(symbol, 90, 46, 0);
+            spigot(symbol, 0);
+            spigot(symbol, 12);
+            spigot(symbol, 24);
+            spigot(symbol, 36);
+            spigot(symbol, 67);
+            spigot(symbol, 79);
+            spigot(symbol, 91);
+            spigot(symbol, 103);
+            block_copy(templ, 0, 0, 46, 6, 0, 0);
+            block_copy(templ, 0, 6, 46, 19, 0, 2);
+            block_copy(templ, 0, 25, 46, 19, 0, 4);
+            block_copy(templ, 0, 44, 46, 19, 0, 6);
+            block_copy(templ, 0, 63, 46, 19, 0, 8);
+            block_copy(templ, 0, 82, 46, 6, 0, 10);
+            block_copy(templ, 46, 0, 46, 6, 12, 0);
+            block_copy(templ, 46, 6, 46, 19, 12, 2);
+            block_copy(templ, 46, 25, 46, 19, 12, 4);
+            block_copy(templ, 46, 44, 46, 19, 12, 6);
+            block_copy(templ, 46, 63, 46, 19, 12, 8);
+            block_copy(templ, 46, 82, 46, 6, 12, 10);
+            break;
+        case 8: /* Version H */
+            central_finder(symbol, 69, 6, 3);
+            vert(symbol, 6, 69, 1);
+            vert(symbol, 26, 73, 1);
+            vert(symbol, 46, 69, 1);
+            vert(symbol, 66, 73, 1);
+            vert(symbol, 86, 69, 1);
+            vert(symbol, 106, 73, 1);
+            vert(symbol, 126, 69, 1);
+            vert(symbol, 6, 68, 0);
+            vert(symbol, 26, 68, 0);
+            vert(symbol, 46, 68, 0);
+            vert(symbol, 66, 68, 0);
+            vert(symbol, 86, 68, 0);
+            vert(symbol, 106, 68, 0);
+            vert(symbol, 126, 68, 0);
+            spigot(symbol, 0);
+            spigot(symbol, 12);
+            spigot(symbol, 24);
+            spigot(symbol, 36);
+            spigot(symbol, 48);
+            spigot(symbol, 60);
+            spigot(symbol, 87);
+            spigot(symbol, 99);
+            spigot(symbol, 111);
+            spigot(symbol, 123);
+            spigot(symbol, 135);
+            spigot(symbol, 147);
+            block_copy(templ, 0, 0, 68, 6, 0, 0);
+            block_copy(templ, 0, 6, 68, 18, 0, 2);
+            block_copy(templ, 0, 24, 68, 18, 0, 4);
+            block_copy(templ, 0, 42, 68, 18, 0, 6);
+            block_copy(templ, 0, 60, 68, 18, 0, 8);
+            block_copy(templ, 0, 78, 68, 18, 0, 10);
+            block_copy(templ, 0, 96, 68, 18, 0, 12);
+            block_copy(templ, 0, 114, 68, 6, 0, 14);
+            block_copy(templ, 68, 0, 68, 6, 12, 0);
+            block_copy(templ, 68, 6, 68, 18, 12, 2);
+            block_copy(templ, 68, 24, 68, 18, 12, 4);
+            block_copy(templ, 68, 42, 68, 18, 12, 6);
+            block_copy(templ, 68, 60, 68, 18, 12, 8);
+            block_copy(templ, 68, 78, 68, 18, 12, 10);
+            block_copy(templ, 68, 96, 68, 18, 12, 12);
+            block_copy(templ, 68, 114, 68, 6, 12, 14);
+            break;
+        case 9: /* Version S */
+            horiz(symbol, 5, 1);
+            horiz(symbol, 7, 1);
+            set_module(symbol, 6, 0);
+            set_module(symbol, 6, symbol->width - 1);
+            unset_module(symbol, 7, 1);
+            unset_module(symbol, 7, symbol->width - 2);
+            switch (sub_version) {
+                case 1: /* Version S-10 */
+                    set_module(symbol, 0, 5);
+                    block_copy(templ, 0, 0, 4, 5, 0, 0);
+                    block_copy(templ, 0, 5, 4, 5, 0, 1);
+                    break;
+                case 2: /* Version S-20 */
+                    set_module(symbol, 0, 10);
+                    set_module(symbol, 4, 10);
+                    block_copy(templ, 0, 0, 4, 10, 0, 0);
+                    block_copy(templ, 0, 10, 4, 10, 0, 1);
+                    break;
+                case 3: /* Version S-30 */
+                    set_module(symbol, 0, 15);
+                    set_module(symbol, 4, 15);
+                    set_module(symbol, 6, 15);
+                    block_copy(templ, 0, 0, 4, 15, 0, 0);
+                    block_copy(templ, 0, 15, 4, 15, 0, 1);
+                    break;
+            }
+            break;
+        case 10: /* Version T */
+            horiz(symbol, 11, 1);
+            horiz(symbol, 13, 1);
+            horiz(symbol, 15, 1);
+            set_module(symbol, 12, 0);
+            set_module(symbol, 12, symbol->width - 1);
+            set_module(symbol, 14, 0);
+            set_module(symbol, 14, symbol->width - 1);
+            unset_module(symbol, 13, 1);
+            unset_module(symbol, 13, symbol->width - 2);
+            unset_module(symbol, 15, 1);
+            unset_module(symbol, 15, symbol->width - 2);
+            switch (sub_version) {
+                case 1: /* Version T-16 */
+                    set_module(symbol, 0, 8);
+                    set_module(symbol, 10, 8);
+                    block_copy(templ, 0, 0, 10, 8, 0, 0);
+                    block_copy(templ, 0, 8, 10, 8, 0, 1);
+                    break;
+                case 2: /* Version T-32 */
+                    set_module(symbol, 0, 16);
+                    set_module(symbol, 10, 16);
+                    set_module(symbol, 12, 16);
+                    block_copy(templ, 0, 0, 10, 16, 0, 0);
+                    block_copy(templ, 0, 16, 10, 16, 0, 1);
+                    break;
+                case 3: /* Verion T-48 */
+                    set_module(symbol, 0, 24);
+                    set_module(symbol, 10, 24);
+                    set_module(symbol, 12, 24);
+                    set_module(symbol, 14, 24);
+                    block_copy(templ, 0, 0, 10, 24, 0, 0);
+                    block_copy(templ, 0, 24, 10, 24, 0, 1);
+                    break;
+            }
+            break;
+    }
+
+    for (i = 0; i < symbol->rows; i++) {
+        memcpy(templ->grid + i * row_bytes, symbol->internal->encoded_data[i], row_bytes);
+    }
+    templ->built = 1;
 }
 
 INTERNAL int code_one(struct zint_symbol *symbol, unsigned char source[], int length) {
     int size = 1, i, j;
 
-    char datagrid[136][120];
     int row, col;
     int sub_version = 0;
+    struct zint_template *templ;
     rs_t rs;
     int error_number = 0;
+    z_work_array2(symbol, char, datagrid, 136, 120);
+
+    if (z_work_failed(datagrid)) {
+        return z_work_error(symbol);
+    }
 
     if ((symbol->option_2 < 0) || (symbol->option_2 > 10)) {
         strcpy(symbol->errtxt, "513: Invalid symbol size");
@@ -943,7 +1504,7 @@ INTERNAL int code_one(struct zint_symbol *symbol, unsigned char source[], int le
             strcpy(symbol->errtxt, "514: Input data too long for Version S");
             return ZINT_ERROR_TOO_LONG;
         }
-        if (is_sane(NEON, source, length) == ZINT_ERROR_INVALID_DATA) {
+        if (is_sane_chr(CHR_DIGIT, source, length) == ZINT_ERROR_INVALID_DATA) {
             strcpy(symbol->errtxt, "515: Invalid input data (Version S encodes numeric input only)");
             return ZINT_ERROR_INVALID_DATA;
         }
@@ -1024,6 +1585,9 @@ INTERNAL int code_one(struct zint_symbol *symbol, unsigned char source[], int le
 
         data_length = c1_encode(symbol, source, data, length, &last_mode);
 
+        if (data_length < 0) {
+            return ZINT_ERROR_MEMORY;
+        }
         if (data_length == 0 || data_length > 38) {
             strcpy(symbol->errtxt, "516: Input data too long for Version T");
             return ZINT_ERROR_TOO_LONG;
@@ -1097,15 +1661,22 @@ INTERNAL int code_one(struct zint_symbol *symbol, unsigned char source[], int le
 
     } else {
         /* Versions A to H */
-        unsigned int data[1480 + 560];
         unsigned int sub_data[185], sub_ecc[70];
         int data_length;
         int data_cw;
         int blocks, data_blocks, ecc_blocks, ecc_length;
         int last_mode;
+        z_work_array(symbol, unsigned int, data, 1480 + 560);
+
+        if (z_work_failed(data)) {
+            return z_work_error(symbol);
+        }
 
         data_length = c1_encode(symbol, source, data, length, &last_mode);
 
+        if (data_length < 0) {
+            return ZINT_ERROR_MEMORY;
+        }
         if (data_length == 0) {
             strcpy(symbol->errtxt, "517: Input data is too long");
             return ZINT_ERROR_TOO_LONG;
@@ -1190,257 +1761,26 @@ INTERNAL int code_one(struct zint_symbol *symbol, unsigned char source[], int le
         printf("Version: %d\n", size);
     }
 
-    switch (size) {
-        case 1: /* Version A */
-            central_finder(symbol, 6, 3, 1);
-            vert(symbol, 4, 6, 1);
-            vert(symbol, 12, 5, 0);
-            set_module(symbol, 5, 12);
-            spigot(symbol, 0);
-            spigot(symbol, 15);
-            block_copy(symbol, datagrid, 0, 0, 5, 4, 0, 0);
-            block_copy(symbol, datagrid, 0, 4, 5, 12, 0, 2);
-            block_copy(symbol, datagrid, 5, 0, 5, 12, 6, 0);
-            block_copy(symbol, datagrid, 5, 12, 5, 4, 6, 2);
-            break;
-        case 2: /* Version B */
-            central_finder(symbol, 8, 4, 1);
-            vert(symbol, 4, 8, 1);
-            vert(symbol, 16, 7, 0);
-            set_module(symbol, 7, 16);
-            spigot(symbol, 0);
-            spigot(symbol, 21);
-            block_copy(symbol, datagrid, 0, 0, 7, 4, 0, 0);
-            block_copy(symbol, datagrid, 0, 4, 7, 16, 0, 2);
-            block_copy(symbol, datagrid, 7, 0, 7, 16, 8, 0);
-            block_copy(symbol, datagrid, 7, 16, 7, 4, 8, 2);
-            break;
-        case 3: /* Version C */
-            central_finder(symbol, 11, 4, 2);
-            vert(symbol, 4, 11, 1);
-            vert(symbol, 26, 13, 1);
-            vert(symbol, 4, 10, 0);
-            vert(symbol, 26, 10, 0);
-            spigot(symbol, 0);
-            spigot(symbol, 27);
-            block_copy(symbol, datagrid, 0, 0, 10, 4, 0, 0);
-            block_copy(symbol, datagrid, 0, 4, 10, 20, 0, 2);
-            block_copy(symbol, datagrid, 0, 24, 10, 4, 0, 4);
-            block_copy(symbol, datagrid, 10, 0, 10, 4, 8, 0);
-            block_copy(symbol, datagrid, 10, 4, 10, 20, 8, 2);
-            block_copy(symbol, datagrid, 10, 24, 10, 4, 8, 4);
-            break;
-        case 4: /* Version D */
-            central_finder(symbol, 16, 5, 1);
-            vert(symbol, 4, 16, 1);
-            vert(symbol, 20, 16, 1);
-            vert(symbol, 36, 16, 1);
-            vert(symbol, 4, 15, 0);
-            vert(symbol, 20, 15, 0);
-            vert(symbol, 36, 15, 0);
-            spigot(symbol, 0);
-            spigot(symbol, 12);
-            spigot(symbol, 27);
-            spigot(symbol, 39);
-            block_copy(symbol, datagrid, 0, 0, 15, 4, 0, 0);
-            block_copy(symbol, datagrid, 0, 4, 15, 14, 0, 2);
-            block_copy(symbol, datagrid, 0, 18, 15, 14, 0, 4);
-            block_copy(symbol, datagrid, 0, 32, 15, 4, 0, 6);
-            block_copy(symbol, datagrid, 15, 0, 15, 4, 10, 0);
-            block_copy(symbol, datagrid, 15, 4, 15, 14, 10, 2);
-            block_copy(symbol, datagrid, 15, 18, 15, 14, 10, 4);
-            block_copy(symbol, datagrid, 15, 32, 15, 4, 10, 6);
-            break;
-        case 5: /* Version E */
-            central_finder(symbol, 22, 5, 2);
-            vert(symbol, 4, 22, 1);
-            vert(symbol, 26, 24, 1);
-            vert(symbol, 48, 22, 1);
-            vert(symbol, 4, 21, 0);
-            vert(symbol, 26, 21, 0);
-            vert(symbol, 48, 21, 0);
-            spigot(symbol, 0);
-            spigot(symbol, 12);
-            spigot(symbol, 39);
-            spigot(symbol, 51);
-            block_copy(symbol, datagrid, 0, 0, 21, 4, 0, 0);
-            block_copy(symbol, datagrid, 0, 4, 21, 20, 0, 2);
-            block_copy(symbol, datagrid, 0, 24, 21, 20, 0, 4);
-            block_copy(symbol, datagrid, 0, 44, 21, 4, 0, 6);
-            block_copy(symbol, datagrid, 21, 0, 21, 4, 10, 0);
-            block_copy(symbol, datagrid, 21, 4, 21, 20, 10, 2);
-            block_copy(symbol, datagrid, 21, 24, 21, 20, 10, 4);
-            block_copy(symbol, datagrid, 21, 44, 21, 4, 10, 6);
-            break;
-        case 6: /* Version F */
-            central_finder(symbol, 31, 5, 3);
-            vert(symbol, 4, 31, 1);
-            vert(symbol, 26, 35, 1);
-            vert(symbol, 48, 31, 1);
-            vert(symbol, 70, 35, 1);
-            vert(symbol, 4, 30, 0);
-            vert(symbol, 26, 30, 0);
-            vert(symbol, 48, 30, 0);
-            vert(symbol, 70, 30, 0);
-            spigot(symbol, 0);
-            spigot(symbol, 12);
-            spigot(symbol, 24);
-            spigot(symbol, 45);
-            spigot(symbol, 57);
-            spigot(symbol, 69);
-            block_copy(symbol, datagrid, 0, 0, 30, 4, 0, 0);
-            block_copy(symbol, datagrid, 0, 4, 30, 20, 0, 2);
-            block_copy(symbol, datagrid, 0, 24, 30, 20, 0, 4);
-            block_copy(symbol, datagrid, 0, 44, 30, 20, 0, 6);
-            block_copy(symbol, datagrid, 0, 64, 30, 4, 0, 8);
-            block_copy(symbol, datagrid, 30, 0, 30, 4, 10, 0);
-            block_copy(symbol, datagrid, 30, 4, 30, 20, 10, 2);
-            block_copy(symbol, datagrid, 30, 24, 30, 20, 10, 4);
-            block_copy(symbol, datagrid, 30, 44, 30, 20, 10, 6);
-            block_copy(symbol, datagrid, 30, 64, 30, 4, 10, 8);
-            break;
-        case 7: /* Version G */
-            central_finder(symbol, 47, 6, 2);
-            vert(symbol, 6, 47, 1);
-            vert(symbol, 27, 49, 1);
-            vert(symbol, 48, 47, 1);
-            vert(symbol, 69, 49, 1);
-            vert(symbol, 90, 47, 1);
-            vert(symbol, 6, 46, 0);
-            vert(symbol, 27, 46, 0);
-            vert(symbol, 48, 46, 0);
-            vert(symbol, 69, 46, 0);
-            vert(symbol, 90, 46, 0);
-            spigot(symbol, 0);
-            spigot(symbol, 12);
-            spigot(symbol, 24);
-            spigot(symbol, 36);
-            spigot(symbol, 67);
-            spigot(symbol, 79);
-            spigot(symbol, 91);
-            spigot(symbol, 103);
-            block_copy(symbol, datagrid, 0, 0, 46, 6, 0, 0);
-            block_copy(symbol, datagrid, 0, 6, 46, 19, 0, 2);
-            block_copy(symbol, datagrid, 0, 25, 46, 19, 0, 4);
-            block_copy(symbol, datagrid, 0, 44, 46, 19, 0, 6);
-            block_copy(symbol, datagrid, 0, 63, 46, 19, 0, 8);
-            block_copy(symbol, datagrid, 0, 82, 46, 6, 0, 10);
-            block_copy(symbol, datagrid, 46, 0, 46, 6, 12, 0);
-            block_copy(symbol, datagrid, 46, 6, 46, 19, 12, 2);
-            block_copy(symbol, datagrid, 46, 25, 46, 19, 12, 4);
-            block_copy(symbol, datagrid, 46, 44, 46, 19, 12, 6);
-            block_copy(symbol, datagrid, 46, 63, 46, 19, 12, 8);
-            block_copy(symbol, datagrid, 46, 82, 46, 6, 12, 10);
-            break;
-        case 8: /* Version H */
-            central_finder(symbol, 69, 6, 3);
-            vert(symbol, 6, 69, 1);
-            vert(symbol, 26, 73, 1);
-            vert(symbol, 46, 69, 1);
-            vert(symbol, 66, 73, 1);
-            vert(symbol, 86, 69, 1);
-            vert(symbol, 106, 73, 1);
-            vert(symbol, 126, 69, 1);
-            vert(symbol, 6, 68, 0);
-            vert(symbol, 26, 68, 0);
-            vert(symbol, 46, 68, 0);
-            vert(symbol, 66, 68, 0);
-            vert(symbol, 86, 68, 0);
-            vert(symbol, 106, 68, 0);
-            vert(symbol, 126, 68, 0);
-            spigot(symbol, 0);
-            spigot(symbol, 12);
-            spigot(symbol, 24);
-            spigot(symbol, 36);
-            spigot(symbol, 48);
-            spigot(symbol, 60);
-            spigot(symbol, 87);
-            spigot(symbol, 99);
-            spigot(symbol, 111);
-            spigot(symbol, 123);
-            spigot(symbol, 135);
-            spigot(symbol, 147);
-            block_copy(symbol, datagrid, 0, 0, 68, 6, 0, 0);
-            block_copy(symbol, datagrid, 0, 6, 68, 18, 0, 2);
-            block_copy(symbol, datagrid, 0, 24, 68, 18, 0, 4);
-            block_copy(symbol, datagrid, 0, 42, 68, 18, 0, 6);
-            block_copy(symbol, datagrid, 0, 60, 68, 18, 0, 8);
-            block_copy(symbol, datagrid, 0, 78, 68, 18, 0, 10);
-            block_copy(symbol, datagrid, 0, 96, 68, 18, 0, 12);
-            block_copy(symbol, datagrid, 0, 114, 68, 6, 0, 14);
-            block_copy(symbol, datagrid, 68, 0, 68, 6, 12, 0);
-            block_copy(symbol, datagrid, 68, 6, 68, 18, 12, 2);
-            block_copy(symbol, datagrid, 68, 24, 68, 18, 12, 4);
-            block_copy(symbol, datagrid, 68, 42, 68, 18, 12, 6);
-            block_copy(symbol, datagrid, 68, 60, 68, 18, 12, 8);
-            block_copy(symbol, datagrid, 68, 78, 68, 18, 12, 10);
-            block_copy(symbol, datagrid, 68, 96, 68, 18, 12, 12);
-            block_copy(symbol, datagrid, 68, 114, 68, 6, 12, 14);
-            break;
-        case 9: /* Version S */
-            horiz(symbol, 5, 1);
-            horiz(symbol, 7, 1);
-            set_module(symbol, 6, 0);
-            set_module(symbol, 6, symbol->width - 1);
-            unset_module(symbol, 7, 1);
-            unset_module(symbol, 7, symbol->width - 2);
-            switch (sub_version) {
-                case 1: /* Version S-10 */
-                    set_module(symbol, 0, 5);
-                    block_copy(symbol, datagrid, 0, 0, 4, 5, 0, 0);
-                    block_copy(symbol, datagrid, 0, 5, 4, 5, 0, 1);
-                    break;
-                case 2: /* Version S-20 */
-                    set_module(symbol, 0, 10);
-                    set_module(symbol, 4, 10);
-                    block_copy(symbol, datagrid, 0, 0, 4, 10, 0, 0);
-                    block_copy(symbol, datagrid, 0, 10, 4, 10, 0, 1);
-                    break;
-                case 3: /* Version S-30 */
-                    set_module(symbol, 0, 15);
-                    set_module(symbol, 4, 15);
-                    set_module(symbol, 6, 15);
-                    block_copy(symbol, datagrid, 0, 0, 4, 15, 0, 0);
-                    block_copy(symbol, datagrid, 0, 15, 4, 15, 0, 1);
-                    break;
-            }
-            break;
-        case 10: /* Version T */
-            horiz(symbol, 11, 1);
-            horiz(symbol, 13, 1);
-            horiz(symbol, 15, 1);
-            set_module(symbol, 12, 0);
-            set_module(symbol, 12, symbol->width - 1);
-            set_module(symbol, 14, 0);
-            set_module(symbol, 14, symbol->width - 1);
-            unset_module(symbol, 13, 1);
-            unset_module(symbol, 13, symbol->width - 2);
-            unset_module(symbol, 15, 1);
-            unset_module(symbol, 15, symbol->width - 2);
-            switch (sub_version) {
-                case 1: /* Version T-16 */
-                    set_module(symbol, 0, 8);
-                    set_module(symbol, 10, 8);
-                    block_copy(symbol, datagrid, 0, 0, 10, 8, 0, 0);
-                    block_copy(symbol, datagrid, 0, 8, 10, 8, 0, 1);
-                    break;
-                case 2: /* Version T-32 */
-                    set_module(symbol, 0, 16);
-                    set_module(symbol, 10, 16);
-                    set_module(symbol, 12, 16);
-                    block_copy(symbol, datagrid, 0, 0, 10, 16, 0, 0);
-                    block_copy(symbol, datagrid, 0, 16, 10, 16, 0, 1);
-                    break;
-                case 3: /* Verion T-48 */
-                    set_module(symbol, 0, 24);
-                    set_module(symbol, 10, 24);
-                    set_module(symbol, 12, 24);
-                    set_module(symbol, 14, 24);
-                    block_copy(symbol, datagrid, 0, 0, 10, 24, 0, 0);
-                    block_copy(symbol, datagrid, 0, 24, 10, 24, 0, 1);
-                    break;
-            }
-            break;
+    /* Recognition patterns and placement map depend only on the version, so kept for re-use */
+    if (!(templ = z_template_get(symbol, size * 4 + sub_version, symbol->rows * ((symbol->width + 7) >> 3),
+                                    symbol->rows * symbol->width * 2))) {
+        strcpy(symbol->errtxt, "548: Insufficient memory for Code One template");
+        return ZINT_ERROR_MEMORY;
+    }
+    if (!templ->built) {
+        c1_setup_grid(symbol, templ, size, sub_version);
+    } else {
+        const int row_bytes = (symbol->width + 7) >> 3;
+        for (i = 0; i < symbol->rows; i++) {
+            memcpy(symbol->internal->encoded_data[i], templ->grid + i * row_bytes, row_bytes);
+        }
+    }
+
+    /* Set symbol from datagrid */
+    for (i = 0; i < templ->positions_len; i += 2) {
+        if (((const char *) datagrid)[templ->positions[i]]) {
+            set_module(symbol, templ->positions[i + 1] >> 8, templ->positions[i + 1] & 0xFF);
+        }
     }
 
     for (i = 0; i < symbol->rows; i++) {
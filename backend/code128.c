@@ -43,7 +43,7 @@
 
 /* Code 128 tables checked against ISO/IEC 15417:2007 */
 
-static const char *C128Table[107] = {
+static const char *const C128Table[107] = {
     /* Code 128 character encodation - Table 1 */
     /*  0         1         2         3         4         5         6         7         8         9 */
     "212222", "222122", "222221", "121223", "121322", "131222", "122213", "122312", "132212", "221213", /*  0 */
@@ -205,26 +205,124 @@ INTERNAL void dxsmooth(int list[2][C128_MAX], int *indexliste) {
     grwp(list, indexliste);
 }
 
+#define C128_SHIFT  3
+
+/* Set `set[]` to the code sets A, B or C (shifts 'a' and 'b') giving the fewest symbol characters, for use in
+   place of `dxsmooth()` when MINIMAL_MODE is set. `fset[]` is the extended ASCII (FNC4) mode of each character, or
+   NULL for GS1-128, where FNC1 ('[') may appear in any set. Set C is not used if `no_c`. `start_costs[]` are the
+   costs of starting in A, B and C, e.g. an extra Code C if starting with Reader Initialisation (Start B FNC3 Code C).
+   Also used by Code 16K. Returns the number of symbol characters (excluding start, FNC1/FNC3 after start, FNC4s,
+   check and stop) */
+INTERNAL int c128_minimal_sets(const unsigned char source[], const int length, const char fset[], const int no_c,
+            const int start_costs[3], char set[]) {
+    static const char latched[3] = { 'A', 'B', 'C' };
+    static const char prefs[3] = { 1, 0, 2 }; /* Prefer B, then A, then C on a tie */
+    int costs[C128_MAX + 1][3];
+    char latch_from[C128_MAX + 1][3]; /* Set latched from if `advances` 0 */
+    char advances[C128_MAX + 1][3]; /* Characters encoded to reach the set at this position, 0 if latched, or
+                                       C128_SHIFT if 1 character shifted to the other of A and B */
+    int i, j, s, t, best;
+
+    costs[0][0] = start_costs[0];
+    costs[0][1] = start_costs[1];
+    costs[0][2] = no_c ? C128_MAX * 2 + 1 : start_costs[2];
+    for (i = 1; i <= length; i++) {
+        costs[i][0] = costs[i][1] = costs[i][2] = C128_MAX * 2 + 1; /* More than any reachable cost */
+    }
+
+    for (i = 0; i < length; i++) {
+        const unsigned char ch = source[i];
+        const unsigned char low = ch & 0x7F; /* Extended ASCII encodes as its low half */
+        const int fnc1 = fset == NULL && ch == '[';
+        int unlatched_costs[2];
+
+        /* Shifts can't follow a latch (`code_128()` would put them in the previous set), which loses nothing as
+           latching to the other set and back costs the same */
+        unlatched_costs[0] = costs[i][0];
+        unlatched_costs[1] = costs[i][1];
+
+        /* Latch before character */
+        for (t = 0; t < 3; t++) {
+            for (j = 0; j < 3; j++) {
+                s = prefs[j];
+                if (s != t && (t != 2 || !no_c) && costs[i][s] + 1 < costs[i][t]) {
+                    costs[i][t] = costs[i][s] + 1;
+                    latch_from[i][t] = (char) s;
+                    advances[i][t] = 0;
+                }
+            }
+        }
+
+        /* Encode character in A or B, shifting if not in the set (but not at the start, which would need a
+           lowercase `set[0]`, nor for GS1-128, all of whose characters are in B) */
+        for (s = 0; s < 2; s++) {
+            const int in_set = fnc1 || (s == 0 ? low < 96 : low >= 32);
+            const int cost = in_set ? costs[i][s] + 1 : unlatched_costs[s] + 2;
+            if ((in_set || (i != 0 && fset)) && cost < costs[i + 1][s]) {
+                costs[i + 1][s] = cost;
+                advances[i + 1][s] = in_set ? 1 : C128_SHIFT;
+            }
+        }
+
+        /* Encode FNC1 or digit pair in C (not in or just after extended ASCII latch, see `code_128()`) */
+        if (!no_c && costs[i][2] < C128_MAX * 2 + 1) {
+            int advance = 0;
+            if (fnc1) {
+                advance = 1;
+            } else if (i + 1 < length && (ch >= '0' && ch <= '9') && (source[i + 1] >= '0' && source[i + 1] <= '9')
+                    && (fset == NULL || (fset[i] == ' ' && fset[i + 1] == ' '
+                                            && (i == 0 || fset[i - 1] == ' ' || fset[i - 1] == 'f')))) {
+                advance = 2;
+            }
+            if (advance && costs[i][2] + 1 < costs[i + advance][2]) {
+                costs[i + advance][2] = costs[i][2] + 1;
+                advances[i + advance][2] = (char) advance;
+            }
+        }
+    }
+
+    best = prefs[0];
+    for (j = 1; j < 3; j++) {
+        if (costs[length][(int) prefs[j]] < costs[length][best]) {
+            best = prefs[j];
+        }
+    }
+
+    /* Trace back through the latches and characters */
+    i = length;
+    s = best;
+    while (i > 0) {
+        const int advance = advances[i][s];
+        if (advance == 0) { /* Latch */
+            s = latch_from[i][s];
+        } else if (advance == C128_SHIFT) {
+            set[--i] = s == 0 ? 'b' : 'a';
+        } else {
+            for (t = 0; t < advance; t++) {
+                set[--i] = latched[s];
+            }
+        }
+    }
+
+    return costs[length][best];
+}
+
 /**
  * Translate Code 128 Set A characters into barcodes.
  * This set handles all control characters NUL to US.
  */
-static void c128_set_a(const unsigned char source, char dest[], int values[], int *bar_chars) {
+static void c128_set_a(const unsigned char source, int values[], int *bar_chars) {
 
     if (source > 127) {
         if (source < 160) {
-            strcat(dest, C128Table[(source - 128) + 64]);
             values[(*bar_chars)] = (source - 128) + 64;
         } else {
-            strcat(dest, C128Table[(source - 128) - 32]);
             values[(*bar_chars)] = (source - 128) - 32;
         }
     } else {
         if (source < 32) {
-            strcat(dest, C128Table[source + 64]);
             values[(*bar_chars)] = source + 64;
         } else {
-            strcat(dest, C128Table[source - 32]);
             values[(*bar_chars)] = source - 32;
         }
     }
@@ -236,12 +334,10 @@ static void c128_set_a(const unsigned char source, char dest[], int values[], in
  * This set handles all characters which are not part of long numbers and not
  * control characters.
  */
-static void c128_set_b(const unsigned char source, char dest[], int values[], int *bar_chars) {
+static void c128_set_b(const unsigned char source, int values[], int *bar_chars) {
     if (source > 127) {
-        strcat(dest, C128Table[source - 32 - 128]);
         values[(*bar_chars)] = source - 32 - 128;
     } else {
-        strcat(dest, C128Table[source - 32]);
         values[(*bar_chars)] = source - 32;
     }
     (*bar_chars)++;
@@ -250,16 +346,28 @@ static void c128_set_b(const unsigned char source, char dest[], int values[], in
 /* Translate Code 128 Set C characters into barcodes
  * This set handles numbers in a compressed form
  */
-static void c128_set_c(const unsigned char source_a, const unsigned char source_b, char dest[], int values[],
-            int *bar_chars) {
+static void c128_set_c(const unsigned char source_a, const unsigned char source_b, int values[], int *bar_chars) {
     int weight;
 
     weight = (10 * ctoi(source_a)) + ctoi(source_b);
-    strcat(dest, C128Table[weight]);
     values[(*bar_chars)] = weight;
     (*bar_chars)++;
 }
 
+/* Put the bar/space widths of the `bar_chars` codewords `values` into `dest`, returning the number of widths */
+static int c128_widths(const int values[], const int bar_chars, char dest[]) {
+    int i;
+    char *d = dest;
+
+    for (i = 0; i < bar_chars; i++) {
+        const int len = values[i] == 106 ? 7 : 6; /* Stop character has extra bar */
+        memcpy(d, C128Table[values[i]], len);
+        d += len;
+    }
+
+    return (int) (d - dest);
+}
+
 /* Treats source as ISO 8859-1 and copies into symbol->text, converting to UTF-8. Returns length of symbol->text */
 STATIC_UNLESS_ZINT_TEST int hrt_cpy_iso8859_1(struct zint_symbol *symbol, const unsigned char *source,
                             const int source_len) {
@@ -303,12 +411,12 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
     char set[C128_MAX] = {0}, fset[C128_MAX], mode, last_set, current_set = ' ';
     float glyph_count;
     char dest[1000];
+    int dest_len;
 
     /* Suppresses clang-analyzer-core.UndefinedBinaryOperatorResult warning on fset which is fully set */
     assert(length > 0);
 
     error_number = 0;
-    strcpy(dest, "");
 
     sourcelen = length;
 
@@ -369,72 +477,77 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
         }
     }
 
-    /* Decide on mode using same system as PDF417 and rules of ISO 15417 Annex E */
-    indexliste = 0;
-    indexchaine = 0;
+    if (symbol->input_mode & MINIMAL_MODE) {
+        const int start_costs[3] = { 0, 0, (symbol->output_options & READER_INIT) ? 1 : 0 };
+        c128_minimal_sets(source, sourcelen, fset, symbol->symbology == BARCODE_CODE128B, start_costs, set);
+    } else {
+        /* Decide on mode using same system as PDF417 and rules of ISO 15417 Annex E */
+        indexliste = 0;
+        indexchaine = 0;
 
-    mode = parunmodd(source[indexchaine]);
-    if ((symbol->symbology == BARCODE_CODE128B) && (mode == ABORC)) {
-        mode = AORB;
-    }
+        mode = parunmodd(source[indexchaine]);
+        if ((symbol->symbology == BARCODE_CODE128B) && (mode == ABORC)) {
+            mode = AORB;
+        }
 
-    do {
-        list[1][indexliste] = mode;
-        while ((list[1][indexliste] == mode) && (indexchaine < sourcelen)) {
-            list[0][indexliste]++;
-            indexchaine++;
-            if (indexchaine == sourcelen) {
-                break;
+        do {
+            list[1][indexliste] = mode;
+            while ((list[1][indexliste] == mode) && (indexchaine < sourcelen)) {
+                list[0][indexliste]++;
+                indexchaine++;
+                if (indexchaine == sourcelen) {
+                    break;
+                }
+                mode = parunmodd(source[indexchaine]);
+                if ((symbol->symbology == BARCODE_CODE128B) && (mode == ABORC)) {
+                    mode = AORB;
+                }
             }
-            mode = parunmodd(source[indexchaine]);
-            if ((symbol->symbology == BARCODE_CODE128B) && (mode == ABORC)) {
-                mode = AORB;
+            indexliste++;
+        } while (indexchaine < sourcelen);
+
+        dxsmooth(list, &indexliste);
+
+        /* Resolve odd length LATCHC blocks */
+        if ((list[1][0] == LATCHC) && (list[0][0] & 1)) {
+            /* Rule 2 */
+            list[0][1]++;
+            list[0][0]--;
+            if (indexliste == 1) {
+                list[0][1] = 1;
+                list[1][1] = LATCHB;
+                indexliste = 2;
             }
         }
-        indexliste++;
-    } while (indexchaine < sourcelen);
-
-    dxsmooth(list, &indexliste);
-
-    /* Resolve odd length LATCHC blocks */
-    if ((list[1][0] == LATCHC) && (list[0][0] & 1)) {
-        /* Rule 2 */
-        list[0][1]++;
-        list[0][0]--;
-        if (indexliste == 1) {
-            list[0][1] = 1;
-            list[1][1] = LATCHB;
-            indexliste = 2;
-        }
-    }
-    if (indexliste > 1) {
-        for (i = 1; i < indexliste; i++) {
-            if ((list[1][i] == LATCHC) && (list[0][i] & 1)) {
-                /* Rule 3b */
-                list[0][i - 1]++;
-                list[0][i]--;
+        if (indexliste > 1) {
+            for (i = 1; i < indexliste; i++) {
+                if ((list[1][i] == LATCHC) && (list[0][i] & 1)) {
+                    /* Rule 3b */
+                    list[0][i - 1]++;
+                    list[0][i]--;
+                }
             }
         }
-    }
 
-    /* Put set data into set[] */
+        /* Put set data into set[] */
 
-    read = 0;
-    for (i = 0; i < indexliste; i++) {
-        for (j = 0; j < list[0][i]; j++) {
-            switch (list[1][i]) {
-                case SHIFTA: set[read] = 'a';
-                    break;
-                case LATCHA: set[read] = 'A';
-                    break;
-                case SHIFTB: set[read] = 'b';
-                    break;
-                case LATCHB: set[read] = 'B';
-                    break;
-                case LATCHC: set[read] = 'C';
-                    break;
+        read = 0;
+        for (i = 0; i < indexliste; i++) {
+            for (j = 0; j < list[0][i]; j++) {
+                switch (list[1][i]) {
+                    case SHIFTA: set[read] = 'a';
+                        break;
+                    case LATCHA: set[read] = 'A';
+                        break;
+                    case SHIFTB: set[read] = 'b';
+                        break;
+                    case LATCHB: set[read] = 'B';
+                        break;
+                    case LATCHC: set[read] = 'C';
+                        break;
+                }
+                read++;
             }
-            read++;
         }
     }
 
@@ -443,6 +556,7 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
         printf(" Set: %.*s\n", sourcelen, set);
         printf("FSet: %.*s\n", sourcelen, fset);
     }
+    z_record_modes(symbol, set, sourcelen);
 
     /* Now we can calculate how long the barcode is going to be - and stop it from
        being too long */
@@ -490,27 +604,20 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
         /* Reader Initialisation mode */
         switch (set[0]) {
             case 'A': /* Start A */
-                strcat(dest, C128Table[103]);
                 values[0] = 103;
                 current_set = 'A';
-                strcat(dest, C128Table[96]); /* FNC3 */
                 values[1] = 96;
                 bar_characters++;
                 break;
             case 'B': /* Start B */
-                strcat(dest, C128Table[104]);
                 values[0] = 104;
                 current_set = 'B';
-                strcat(dest, C128Table[96]); /* FNC3 */
                 values[1] = 96;
                 bar_characters++;
                 break;
             case 'C': /* Start C */
-                strcat(dest, C128Table[104]); /* Start B */
                 values[0] = 104;
-                strcat(dest, C128Table[96]); /* FNC3 */
                 values[1] = 96;
-                strcat(dest, C128Table[99]); /* Code C */
                 values[2] = 99;
                 bar_characters += 2;
                 current_set = 'C';
@@ -520,17 +627,14 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
         /* Normal mode */
         switch (set[0]) {
             case 'A': /* Start A */
-                strcat(dest, C128Table[103]);
                 values[0] = 103;
                 current_set = 'A';
                 break;
             case 'B': /* Start B */
-                strcat(dest, C128Table[104]);
                 values[0] = 104;
                 current_set = 'B';
                 break;
             case 'C': /* Start C */
-                strcat(dest, C128Table[105]);
                 values[0] = 105;
                 current_set = 'C';
                 break;
@@ -541,14 +645,10 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
     if (fset[0] == 'F') {
         switch (current_set) {
             case 'A':
-                strcat(dest, C128Table[101]);
-                strcat(dest, C128Table[101]);
                 values[bar_characters] = 101;
                 values[bar_characters + 1] = 101;
                 break;
             case 'B':
-                strcat(dest, C128Table[100]);
-                strcat(dest, C128Table[100]);
                 values[bar_characters] = 100;
                 values[bar_characters + 1] = 100;
                 break;
@@ -564,18 +664,15 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
         if ((read != 0) && (set[read] != current_set)) {
             /* Latch different code set */
             switch (set[read]) {
-                case 'A': strcat(dest, C128Table[101]);
-                    values[bar_characters] = 101;
+                case 'A': values[bar_characters] = 101;
                     bar_characters++;
                     current_set = 'A';
                     break;
-                case 'B': strcat(dest, C128Table[100]);
-                    values[bar_characters] = 100;
+                case 'B': values[bar_characters] = 100;
                     bar_characters++;
                     current_set = 'B';
                     break;
-                case 'C': strcat(dest, C128Table[99]);
-                    values[bar_characters] = 99;
+                case 'C': values[bar_characters] = 99;
                     bar_characters++;
                     current_set = 'C';
                     break;
@@ -587,14 +684,10 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
                 /* Latch beginning of extended mode */
                 switch (current_set) {
                     case 'A':
-                        strcat(dest, C128Table[101]);
-                        strcat(dest, C128Table[101]);
                         values[bar_characters] = 101;
                         values[bar_characters + 1] = 101;
                         break;
                     case 'B':
-                        strcat(dest, C128Table[100]);
-                        strcat(dest, C128Table[100]);
                         values[bar_characters] = 100;
                         values[bar_characters + 1] = 100;
                         break;
@@ -606,14 +699,10 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
                 /* Latch end of extended mode */
                 switch (current_set) {
                     case 'A':
-                        strcat(dest, C128Table[101]);
-                        strcat(dest, C128Table[101]);
                         values[bar_characters] = 101;
                         values[bar_characters + 1] = 101;
                         break;
                     case 'B':
-                        strcat(dest, C128Table[100]);
-                        strcat(dest, C128Table[100]);
                         values[bar_characters] = 100;
                         values[bar_characters + 1] = 100;
                         break;
@@ -627,11 +716,9 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
             /* Shift to or from extended mode */
             switch (current_set) {
                 case 'A':
-                    strcat(dest, C128Table[101]); /* FNC 4 */
                     values[bar_characters] = 101;
                     break;
                 case 'B':
-                    strcat(dest, C128Table[100]); /* FNC 4 */
                     values[bar_characters] = 100;
                     break;
             }
@@ -640,21 +727,20 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
 
         if ((set[read] == 'a') || (set[read] == 'b')) {
             /* Insert shift character */
-            strcat(dest, C128Table[98]);
             values[bar_characters] = 98;
             bar_characters++;
         }
 
         switch (set[read]) { /* Encode data characters */
             case 'a':
-            case 'A': c128_set_a(source[read], dest, values, &bar_characters);
+            case 'A': c128_set_a(source[read], values, &bar_characters);
                 read++;
                 break;
             case 'b':
-            case 'B': c128_set_b(source[read], dest, values, &bar_characters);
+            case 'B': c128_set_b(source[read], values, &bar_characters);
                 read++;
                 break;
-            case 'C': c128_set_c(source[read], source[read + 1], dest, values, &bar_characters);
+            case 'C': c128_set_c(source[read], source[read + 1], values, &bar_characters);
                 read += 2;
                 break;
         }
@@ -667,22 +753,22 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
     for (i = 1; i < bar_characters; i++) {
         total_sum = (total_sum + values[i] * i) % 103;
     }
-    strcat(dest, C128Table[total_sum]);
     values[bar_characters] = total_sum;
     bar_characters++;
 
     /* Stop character */
-    strcat(dest, C128Table[106]);
     values[bar_characters] = 106;
     bar_characters++;
 
+    dest_len = c128_widths(values, bar_characters, dest);
+
     if (symbol->debug & ZINT_DEBUG_PRINT) {
         printf("Codewords:");
         for (i = 0; i < bar_characters; i++) {
             printf(" %d", values[i]);
         }
         printf(" (%d)\n", bar_characters);
-        printf("Barspaces: %s\n", dest);
+        printf("Barspaces: %.*s\n", dest_len, dest);
     }
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) {
@@ -690,9 +776,11 @@ INTERNAL int code_128(struct zint_symbol *symbol, unsigned char source[], int le
     }
 #endif
 
-    expand(symbol, dest);
+    expand(symbol, dest, dest_len);
 
-    hrt_cpy_iso8859_1(symbol, source, length);
+    if (z_hrt(symbol)) {
+        hrt_cpy_iso8859_1(symbol, source, length);
+    }
 
     return error_number;
 }
@@ -705,15 +793,15 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
     char set[C128_MAX] = {0}, mode, last_set;
     float glyph_count;
     char dest[1000];
+    int dest_len;
     int separator_row, linkage_flag, c_count;
     int reduced_length;
-#ifndef _MSC_VER
-    unsigned char reduced[length + 1];
-#else
-    unsigned char *reduced = (unsigned char *) _alloca(length + 1);
-#endif
+    z_work_array(symbol, unsigned char, reduced, length + 1);
+
+    if (z_work_failed(reduced)) {
+        return z_work_error(symbol);
+    }
 
-    strcpy(dest, "");
     linkage_flag = 0;
 
     bar_characters = 0;
@@ -733,64 +821,79 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
         symbol->rows += 1;
     }
 
-    error_number = gs1_verify(symbol, source, length, reduced);
+    error_number = gs1_verify(symbol, source, length, reduced, &reduced_length);
     if (error_number >= ZINT_ERROR) {
         return error_number;
     }
-    reduced_length = (int) ustrlen(reduced);
 
-    /* Decide on mode using same system as PDF417 and rules of ISO 15417 Annex E */
-    indexliste = 0;
-    indexchaine = 0;
+    if (symbol->input_mode & MINIMAL_MODE) {
+        static const int start_costs[3] = { 0, 0, 0 };
+        c128_minimal_sets(reduced, reduced_length, NULL /*fset*/, 0 /*no_c*/, start_costs, set);
+    } else {
+        /* Decide on mode using same system as PDF417 and rules of ISO 15417 Annex E */
+        indexliste = 0;
+        indexchaine = 0;
 
-    mode = parunmodd(reduced[indexchaine]);
-    if (reduced[indexchaine] == '[') {
-        mode = ABORC;
-    }
+        mode = parunmodd(reduced[indexchaine]);
+        if (reduced[indexchaine] == '[') {
+            mode = ABORC;
+        }
 
-    do {
-        list[1][indexliste] = mode;
-        while ((list[1][indexliste] == mode) && (indexchaine < reduced_length)) {
-            list[0][indexliste]++;
-            indexchaine++;
-            if (indexchaine == reduced_length) {
-                break;
-            }
-            mode = parunmodd(reduced[indexchaine]);
-            if (reduced[indexchaine] == '[') {
-                mode = ABORC;
+        do {
+            list[1][indexliste] = mode;
+            while ((list[1][indexliste] == mode) && (indexchaine < reduced_length)) {
+                list[0][indexliste]++;
+                indexchaine++;
+                if (indexchaine == reduced_length) {
+                    break;
+                }
+                mode = parunmodd(reduced[indexchaine]);
+                if (reduced[indexchaine] == '[') {
+                    mode = ABORC;
+                }
             }
-        }
-        indexliste++;
-    } while (indexchaine < reduced_length);
+            indexliste++;
+        } while (indexchaine < reduced_length);
 
-    dxsmooth(list, &indexliste);
+        dxsmooth(list, &indexliste);
 
-    /* Put set data into set[] */
-    read = 0;
-    for (i = 0; i < indexliste; i++) {
-        for (j = 0; j < list[0][i]; j++) {
-            switch (list[1][i]) {
-                case SHIFTA: set[read] = 'a';
-                    break;
-                case LATCHA: set[read] = 'A';
-                    break;
-                case SHIFTB: set[read] = 'b';
-                    break;
-                case LATCHB: set[read] = 'B';
-                    break;
-                case LATCHC: set[read] = 'C';
-                    break;
+        /* Put set data into set[] */
+        read = 0;
+        for (i = 0; i < indexliste; i++) {
+            for (j = 0; j < list[0][i]; j++) {
+                switch (list[1][i]) {
+                    case SHIFTA: set[read] = 'a';
+                        break;
+                    case LATCHA: set[read] = 'A';
+                        break;
+                    case SHIFTB: set[read] = 'b';
+                        break;
+                    case LATCHB: set[read] = 'B';
+                        break;
+                    case LATCHC: set[read] = 'C';
+                        break;
+                }
+                read++;
             }
-            read++;
         }
-    }
 
-    /* Watch out for odd-length Mode C blocks */
-    c_count = 0;
-    for (i = 0; i < read; i++) {
-        if (set[i] == 'C') {
-            if (reduced[i] == '[') {
+        /* Watch out for odd-length Mode C blocks */
+        c_count = 0;
+        for (i = 0; i < read; i++) {
+            if (set[i] == 'C') {
+                if (reduced[i] == '[') {
+                    if (c_count & 1) {
+                        if ((i - c_count) != 0) {
+                            set[i - c_count] = 'B';
+                        } else {
+                            set[i - 1] = 'B';
+                        }
+                    }
+                    c_count = 0;
+                } else {
+                    c_count++;
+                }
+            } else {
                 if (c_count & 1) {
                     if ((i - c_count) != 0) {
                         set[i - c_count] = 'B';
@@ -799,30 +902,19 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
                     }
                 }
                 c_count = 0;
-            } else {
-                c_count++;
             }
-        } else {
-            if (c_count & 1) {
-                if ((i - c_count) != 0) {
-                    set[i - c_count] = 'B';
-                } else {
-                    set[i - 1] = 'B';
-                }
-            }
-            c_count = 0;
         }
-    }
-    if (c_count & 1) {
-        if ((i - c_count) != 0) {
-            set[i - c_count] = 'B';
-        } else {
-            set[i - 1] = 'B';
+        if (c_count & 1) {
+            if ((i - c_count) != 0) {
+                set[i - c_count] = 'B';
+            } else {
+                set[i - 1] = 'B';
+            }
         }
-    }
-    for (i = 1; i < read - 1; i++) {
-        if ((set[i] == 'C') && ((set[i - 1] == 'B') && (set[i + 1] == 'B'))) {
-            set[i] = 'B';
+        for (i = 1; i < read - 1; i++) {
+            if ((set[i] == 'C') && ((set[i - 1] == 'B') && (set[i + 1] == 'B'))) {
+                set[i] = 'B';
+            }
         }
     }
 
@@ -830,6 +922,7 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
         printf("Data: %s (%d)\n", reduced, reduced_length);
         printf(" Set: %.*s\n", reduced_length, set);
     }
+    z_record_modes(symbol, set, reduced_length);
 
     /* Now we can calculate how long the barcode is going to be - and stop it from
     being too long */
@@ -860,21 +953,17 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
     /* So now we know what start character to use - we can get on with it! */
     switch (set[0]) {
         case 'A': /* Start A */
-            strcat(dest, C128Table[103]);
             values[0] = 103;
             break;
         case 'B': /* Start B */
-            strcat(dest, C128Table[104]);
             values[0] = 104;
             break;
         case 'C': /* Start C */
-            strcat(dest, C128Table[105]);
             values[0] = 105;
             break;
     }
     bar_characters++;
 
-    strcat(dest, C128Table[102]);
     values[1] = 102;
     bar_characters++;
 
@@ -884,16 +973,13 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
 
         if ((read != 0) && (set[read] != set[read - 1])) { /* Latch different code set */
             switch (set[read]) {
-                case 'A': strcat(dest, C128Table[101]);
-                    values[bar_characters] = 101;
+                case 'A': values[bar_characters] = 101;
                     bar_characters++;
                     break;
-                case 'B': strcat(dest, C128Table[100]);
-                    values[bar_characters] = 100;
+                case 'B': values[bar_characters] = 100;
                     bar_characters++;
                     break;
-                case 'C': strcat(dest, C128Table[99]);
-                    values[bar_characters] = 99;
+                case 'C': values[bar_characters] = 99;
                     bar_characters++;
                     break;
             }
@@ -901,7 +987,6 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
 
         if ((set[read] == 'a') || (set[read] == 'b')) {
             /* Insert shift character */
-            strcat(dest, C128Table[98]);
             values[bar_characters] = 98;
             bar_characters++;
         }
@@ -910,21 +995,20 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
             switch (set[read]) { /* Encode data characters */
                 case 'A':
                 case 'a':
-                    c128_set_a(reduced[read], dest, values, &bar_characters);
+                    c128_set_a(reduced[read], values, &bar_characters);
                     read++;
                     break;
                 case 'B':
                 case 'b':
-                    c128_set_b(reduced[read], dest, values, &bar_characters);
+                    c128_set_b(reduced[read], values, &bar_characters);
                     read++;
                     break;
                 case 'C':
-                    c128_set_c(reduced[read], reduced[read + 1], dest, values, &bar_characters);
+                    c128_set_c(reduced[read], reduced[read + 1], values, &bar_characters);
                     read += 2;
                     break;
             }
         } else {
-            strcat(dest, C128Table[102]);
             values[bar_characters] = 102;
             bar_characters++;
             read++;
@@ -963,7 +1047,6 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
     }
 
     if (linkage_flag != 0) {
-        strcat(dest, C128Table[linkage_flag]);
         values[bar_characters] = linkage_flag;
         bar_characters++;
     }
@@ -974,22 +1057,22 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
     for (i = 1; i < bar_characters; i++) {
         total_sum = (total_sum + values[i] * i) % 103;
     }
-    strcat(dest, C128Table[total_sum]);
     values[bar_characters] = total_sum;
     bar_characters++;
 
     /* Stop character */
-    strcat(dest, C128Table[106]);
     values[bar_characters] = 106;
     bar_characters++;
 
+    dest_len = c128_widths(values, bar_characters, dest);
+
     if (symbol->debug & ZINT_DEBUG_PRINT) {
         printf("Codewords:");
         for (i = 0; i < bar_characters; i++) {
             printf(" %d", values[i]);
         }
         printf(" (%d)\n", bar_characters);
-        printf("Barspaces: %s\n", dest);
+        printf("Barspaces: %.*s\n", dest_len, dest);
     }
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) {
@@ -997,7 +1080,7 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
     }
 #endif
 
-    expand(symbol, dest);
+    expand(symbol, dest, dest_len);
 
     /* Add the separator pattern for composite symbols */
     if (symbol->symbology == BARCODE_GS1_128_CC) {
@@ -1008,15 +1091,17 @@ INTERNAL int ean_128(struct zint_symbol *symbol, unsigned char source[], int len
         }
     }
 
-    for (i = 0; i < length; i++) {
-        if ((source[i] != '[') && (source[i] != ']')) {
-            symbol->text[i] = source[i];
-        }
-        if (source[i] == '[') {
-            symbol->text[i] = '(';
-        }
-        if (source[i] == ']') {
-            symbol->text[i] = ')';
+    if (z_hrt(symbol)) {
+        for (i = 0; i < length; i++) {
+            if ((source[i] != '[') && (source[i] != ']')) {
+                symbol->text[i] = source[i];
+            }
+            if (source[i] == '[') {
+                symbol->text[i] = '(';
+            }
+            if (source[i] == ']') {
+                symbol->text[i] = ')';
+            }
         }
     }
 
@@ -1034,7 +1119,7 @@ INTERNAL int nve_18(struct zint_symbol *symbol, unsigned char source[], int leng
         return ZINT_ERROR_TOO_LONG;
     }
 
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "346: Invalid characters in data");
         return error_number;
@@ -1072,7 +1157,7 @@ INTERNAL int ean_14(struct zint_symbol *symbol, unsigned char source[], int leng
         return ZINT_ERROR_TOO_LONG;
     }
 
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "348: Invalid character in data");
         return error_number;
@@ -1131,6 +1216,9 @@ INTERNAL int dpd_parcel(struct zint_symbol *symbol, unsigned char source[], int
     
     source[0] = identifier;
     error_number = code_128(symbol, source, length);
+    if (!z_hrt(symbol)) {
+        return error_number;
+    }
     
     cd = mod;
     
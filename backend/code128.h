@@ -51,6 +51,8 @@ extern "C" {
 
 INTERNAL int parunmodd(const unsigned char llyth);
 INTERNAL void dxsmooth(int list[2][C128_MAX], int *indexliste);
+INTERNAL int c128_minimal_sets(const unsigned char source[], const int length, const char fset[], const int no_c,
+            const int start_costs[3], char set[]);
 
 #ifdef __cplusplus
 }
@@ -40,7 +40,7 @@
 #include "common.h"
 #include "code128.h"
 
-static const char *C16KTable[107] = {
+static const char *const C16KTable[107] = {
     /* EN 12323 Table 1 - "Code 16K" character encodations */
     "212222", "222122", "222221", "121223", "121322", "131222", "122213",
     "122312", "132212", "221213", "221312", "231212", "112232", "122132", "122231", "113222",
@@ -58,7 +58,7 @@ static const char *C16KTable[107] = {
 };
 
 
-static const char *C16KStartStop[8] = {
+static const char *const C16KStartStop[8] = {
     /* EN 12323 Table 3 and Table 4 - Start patterns and stop patterns */
     "3211", "2221", "2122", "1411", "1132", "1231", "1114", "3112"
 };
@@ -106,19 +106,102 @@ static void c16k_set_c(const unsigned char source_a, unsigned char source_b, int
     (*bar_chars)++;
 }
 
+/* Return the number of symbol characters needed by `set[]`, allowing for the start modes that include latches (Table
+   2) */
+static float c16k_glyph_count(const unsigned char source[], const int length, const char set[], const char fset[],
+            const int gs1, const int reader_init) {
+    int i;
+    char last_set;
+    float glyph_count;
+
+    last_set = set[0];
+    glyph_count = 0.0f;
+    for (i = 0; i < length; i++) {
+        if ((set[i] == 'a') || (set[i] == 'b')) {
+            glyph_count = glyph_count + 1.0f;
+        }
+        if (fset[i] == 'f') {
+            glyph_count = glyph_count + 1.0f;
+        }
+        if (((set[i] == 'A') || (set[i] == 'B')) || (set[i] == 'C')) {
+            if (set[i] != last_set) {
+                last_set = set[i];
+                glyph_count = glyph_count + 1.0f;
+            }
+        }
+        if (i == 0 && !gs1) { /* Start modes 5 and 6 not available with FNC1 */
+            if ((set[i] == 'B') && (set[1] == 'C')) {
+                glyph_count = glyph_count - 1.0f;
+            }
+            if ((set[i] == 'B') && (set[1] == 'B') && !reader_init) {
+                if (set[2] == 'C') {
+                    glyph_count = glyph_count - 1.0f;
+                }
+            }
+        }
+
+        if ((set[i] == 'C') && (!((gs1) && (source[i] == '[')))) {
+            glyph_count = glyph_count + 0.5f;
+        } else {
+            glyph_count = glyph_count + 1.0f;
+        }
+    }
+
+    if ((gs1) && (set[0] != 'A')) {
+        /* FNC1 can be integrated with mode character */
+        glyph_count--;
+    }
+
+    return glyph_count;
+}
+
+/* Set `set[]` to the fewest symbol characters using the Code 128 minimal code set selection, trying also a
+   leading 1 or 2 characters in B followed by C, which Start modes 5 and 6 encode without a latch (for use in place of
+   `dxsmooth()` when MINIMAL_MODE is set) */
+static void c16k_minimal_sets(const unsigned char source[], const int length, const char fset[], const int gs1,
+            const int reader_init, char set[]) {
+    static const int start_costs[3] = { 0, 0, 0 };
+    static const int c_start_costs[3] = { 1, 0, 0 }; /* After leading B, C needs no latch */
+    char candidate[C128_MAX + 2];
+    float glyph_count, best_count;
+    int i, k;
+
+    c128_minimal_sets(source, length, gs1 ? NULL : fset, 0 /*no_c*/, start_costs, set);
+
+    if (gs1) { /* Start modes 5 and 6 only used otherwise */
+        return;
+    }
+    best_count = c16k_glyph_count(source, length, set, fset, gs1, reader_init);
+    for (k = 1; k <= (reader_init ? 1 : 2) && k < length; k++) { /* Only Mode C/Shift B with FNC3 */
+        for (i = 0; i < k && (source[i] & 0x7F) >= 32; i++) {
+            candidate[i] = 'B';
+        }
+        if (i < k) { /* Not in B */
+            break;
+        }
+        memset(candidate + k, 0, length + 2 - k); /* Count may look ahead 2 */
+        c128_minimal_sets(source + k, length - k, fset + k, 0 /*no_c*/, c_start_costs, candidate + k);
+        glyph_count = c16k_glyph_count(source, length, candidate, fset, gs1, reader_init);
+        if (glyph_count < best_count) {
+            best_count = glyph_count;
+            memcpy(set, candidate, length);
+        }
+    }
+}
+
 INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[], int length) {
     char width_pattern[100];
     int current_row, rows, looper, first_check, second_check;
     int indexchaine;
     int list[2][C128_MAX] = {{0}};
-    char set[C128_MAX] = {0}, fset[C128_MAX], mode, last_set, current_set;
+    char set[C128_MAX] = {0}, fset[C128_MAX], mode, current_set;
     int pads_needed, indexliste, i, j, m, read, mx_reader;
     int values[C128_MAX] = {0};
     int bar_characters;
     float glyph_count;
     int error_number, first_sum, second_sum;
     int input_length;
-    int gs1, c_count;
+    int gs1, c_count, implied_c;
 
     /* Suppresses clang-analyzer-core.UndefinedBinaryOperatorResult warning on fset which is fully set */
     assert(length > 0);
@@ -146,58 +229,73 @@ INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[], int len
     }
     /* Note to be safe not using extended ASCII latch as not mentioned in BS EN 12323:2005 */
 
-    /* Detect mode A, B and C characters */
-    indexliste = 0;
-    indexchaine = 0;
-
-    mode = parunmodd(source[indexchaine]);
-    if ((gs1) && (source[indexchaine] == '[')) {
-        mode = ABORC;
-    } /* FNC1 */
-
-    do {
-        list[1][indexliste] = mode;
-        while ((list[1][indexliste] == mode) && (indexchaine < input_length)) {
-            list[0][indexliste]++;
-            indexchaine++;
-            if (indexchaine == input_length) {
-                break;
-            }
-            mode = parunmodd(source[indexchaine]);
-            if ((gs1) && (source[indexchaine] == '[')) {
-                mode = ABORC;
-            } /* FNC1 */
-        }
-        indexliste++;
-    } while (indexchaine < input_length);
-
-    dxsmooth(list, &indexliste);
-
-    /* Put set data into set[] */
-    read = 0;
-    for (i = 0; i < indexliste; i++) {
-        for (j = 0; j < list[0][i]; j++) {
-            switch (list[1][i]) {
-                case SHIFTA: set[read] = 'a';
-                    break;
-                case LATCHA: set[read] = 'A';
-                    break;
-                case SHIFTB: set[read] = 'b';
-                    break;
-                case LATCHB: set[read] = 'B';
-                    break;
-                case LATCHC: set[read] = 'C';
+    if (symbol->input_mode & MINIMAL_MODE) {
+        c16k_minimal_sets(source, input_length, fset, gs1, symbol->output_options & READER_INIT, set);
+    } else {
+        /* Detect mode A, B and C characters */
+        indexliste = 0;
+        indexchaine = 0;
+
+        mode = parunmodd(source[indexchaine]);
+        if ((gs1) && (source[indexchaine] == '[')) {
+            mode = ABORC;
+        } /* FNC1 */
+
+        do {
+            list[1][indexliste] = mode;
+            while ((list[1][indexliste] == mode) && (indexchaine < input_length)) {
+                list[0][indexliste]++;
+                indexchaine++;
+                if (indexchaine == input_length) {
                     break;
+                }
+                mode = parunmodd(source[indexchaine]);
+                if ((gs1) && (source[indexchaine] == '[')) {
+                    mode = ABORC;
+                } /* FNC1 */
+            }
+            indexliste++;
+        } while (indexchaine < input_length);
+
+        dxsmooth(list, &indexliste);
+
+        /* Put set data into set[] */
+        read = 0;
+        for (i = 0; i < indexliste; i++) {
+            for (j = 0; j < list[0][i]; j++) {
+                switch (list[1][i]) {
+                    case SHIFTA: set[read] = 'a';
+                        break;
+                    case LATCHA: set[read] = 'A';
+                        break;
+                    case SHIFTB: set[read] = 'b';
+                        break;
+                    case LATCHB: set[read] = 'B';
+                        break;
+                    case LATCHC: set[read] = 'C';
+                        break;
+                }
+                read++;
             }
-            read++;
         }
-    }
 
-    /* Watch out for odd-length Mode C blocks */
-    c_count = 0;
-    for (i = 0; i < read; i++) {
-        if (set[i] == 'C') {
-            if (source[i] == '[') {
+        /* Watch out for odd-length Mode C blocks */
+        c_count = 0;
+        for (i = 0; i < read; i++) {
+            if (set[i] == 'C') {
+                if (source[i] == '[') {
+                    if (c_count & 1) {
+                        if ((i - c_count) != 0) {
+                            set[i - c_count] = 'B';
+                        } else {
+                            set[i - 1] = 'B';
+                        }
+                    }
+                    c_count = 0;
+                } else {
+                    c_count++;
+                }
+            } else {
                 if (c_count & 1) {
                     if ((i - c_count) != 0) {
                         set[i - c_count] = 'B';
@@ -206,30 +304,19 @@ INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[], int len
                     }
                 }
                 c_count = 0;
-            } else {
-                c_count++;
             }
-        } else {
-            if (c_count & 1) {
-                if ((i - c_count) != 0) {
-                    set[i - c_count] = 'B';
-                } else {
-                    set[i - 1] = 'B';
-                }
-            }
-            c_count = 0;
         }
-    }
-    if (c_count & 1) {
-        if ((i - c_count) != 0) {
-            set[i - c_count] = 'B';
-        } else {
-            set[i - 1] = 'B';
+        if (c_count & 1) {
+            if ((i - c_count) != 0) {
+                set[i - c_count] = 'B';
+            } else {
+                set[i - 1] = 'B';
+            }
         }
-    }
-    for (i = 1; i < read - 1; i++) {
-        if ((set[i] == 'C') && ((set[i - 1] == 'B') && (set[i + 1] == 'B'))) {
-            set[i] = 'B';
+        for (i = 1; i < read - 1; i++) {
+            if ((set[i] == 'C') && ((set[i - 1] == 'B') && (set[i + 1] == 'B'))) {
+                set[i] = 'B';
+            }
         }
     }
 
@@ -240,43 +327,8 @@ INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[], int len
     }
 
     /* Make sure the data will fit in the symbol */
-    last_set = set[0];
-    glyph_count = 0.0f;
-    for (i = 0; i < input_length; i++) {
-        if ((set[i] == 'a') || (set[i] == 'b')) {
-            glyph_count = glyph_count + 1.0f;
-        }
-        if (fset[i] == 'f') {
-            glyph_count = glyph_count + 1.0f;
-        }
-        if (((set[i] == 'A') || (set[i] == 'B')) || (set[i] == 'C')) {
-            if (set[i] != last_set) {
-                last_set = set[i];
-                glyph_count = glyph_count + 1.0f;
-            }
-        }
-        if (i == 0) {
-            if ((set[i] == 'B') && (set[1] == 'C')) {
-                glyph_count = glyph_count - 1.0f;
-            }
-            if ((set[i] == 'B') && (set[1] == 'B')) {
-                if (set[2] == 'C') {
-                    glyph_count = glyph_count - 1.0f;
-                }
-            }
-        }
-
-        if ((set[i] == 'C') && (!((gs1) && (source[i] == '[')))) {
-            glyph_count = glyph_count + 0.5f;
-        } else {
-            glyph_count = glyph_count + 1.0f;
-        }
-    }
-
-    if ((gs1) && (set[0] != 'A')) {
-        /* FNC1 can be integrated with mode character */
-        glyph_count--;
-    }
+    glyph_count = c16k_glyph_count(source, input_length, set, fset, gs1,
+                    symbol->output_options & READER_INIT);
 
     if (glyph_count > 77.0f) {
         strcpy(symbol->errtxt, "421: Input too long");
@@ -297,6 +349,7 @@ INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[], int len
 
     /* start with the mode character - Table 2 */
     m = 0;
+    implied_c = 0; /* Position of latch to C included in start mode */
     switch (set[0]) {
         case 'A': m = 0;
             break;
@@ -316,6 +369,7 @@ INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[], int len
         } else {
             if ((set[0] == 'B') && (set[1] == 'C')) {
                 m = 6;
+                implied_c = 1;
             }
         }
         values[bar_characters] = (7 * (rows - 2)) + m; /* see 4.3.4.2 */
@@ -333,9 +387,11 @@ INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[], int len
         } else {
             if ((set[0] == 'B') && (set[1] == 'C')) {
                 m = 5;
+                implied_c = 1;
             }
             if (((set[0] == 'B') && (set[1] == 'B')) && (set[2] == 'C')) {
                 m = 6;
+                implied_c = 2;
             }
         }
         values[bar_characters] = (7 * (rows - 2)) + m; /* see 4.3.4.2 */
@@ -348,8 +404,8 @@ INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[], int len
     /* Encode the data */
     do {
 
-        if ((read != 0) && (set[read] != set[read - 1])) {
-            /* Latch different code set */
+        if ((read != 0) && (set[read] != current_set)) {
+            /* Latch different code set (shifts leave it unchanged) */
             switch (set[read]) {
                 case 'A':
                     values[bar_characters] = 101;
@@ -362,13 +418,10 @@ INTERNAL int code16k(struct zint_symbol *symbol, unsigned char source[], int len
                     current_set = 'B';
                     break;
                 case 'C':
-                    if (!((read == 1) && (set[0] == 'B'))) {
-                        /* Not Mode C/Shift B */
-                        if (!((read == 2) && ((set[0] == 'B') && (set[1] == 'B')))) {
-                            /* Not Mode C/Double Shift B */
-                            values[bar_characters] = 99;
-                            bar_characters++;
-                        }
+                    if (read != implied_c) {
+                        /* Not Mode C/Shift B or C/Double Shift B */
+                        values[bar_characters] = 99;
+                        bar_characters++;
                     }
                     current_set = 'C';
                     break;
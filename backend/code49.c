@@ -48,6 +48,7 @@ INTERNAL int code_49(struct zint_symbol *symbol, unsigned char source[], int len
     int pad_count = 0;
     char pattern[80];
     int gs1;
+    int minimal = symbol->input_mode & MINIMAL_MODE;
     int h, len;
 
     if (length > 81) {
@@ -79,7 +80,10 @@ INTERNAL int code_49(struct zint_symbol *symbol, unsigned char source[], int len
         if ((intermediate[i] >= '0') && (intermediate[i] <= '9')) {
             /* Numeric data */
             for (j = 0; (intermediate[i + j] >= '0') && (intermediate[i + j] <= '9'); j++);
-            if (j >= 5) {
+            /* Each run is encoded independently, so choosing per run is optimal: Numeric Encodation never takes
+               more codewords for 5 or more digits, and only takes fewer for 3 or 4 when they're all the data
+               (nothing to shift in or out of with Start mode 2), which MINIMAL_MODE allows */
+            if (j >= 5 || (minimal && j >= 3 && i == 0 && j == h)) {
                 /* Use Numeric Encodation Method */
                 int block_count, c;
                 int block_remain;
@@ -188,6 +192,12 @@ INTERNAL int code_49(struct zint_symbol *symbol, unsigned char source[], int len
                 i++;
             }
         } else {
+            if ((intermediate[i] == '!' || intermediate[i] == '&') && i + 1 < h) {
+                /* Shifted character, which may be a digit that can't start Numeric Encodation */
+                codewords[codeword_count] = posn(INSET, intermediate[i]);
+                codeword_count++;
+                i++;
+            }
             codewords[codeword_count] = posn(INSET, intermediate[i]);
             codeword_count++;
             i++;
@@ -358,3 +368,9 @@ INTERNAL int code_49(struct zint_symbol *symbol, unsigned char source[], int len
 
     return 0;
 }
+
+/* Page in the bit patterns (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t c49_tables_warm(const int touch) {
+    return z_table_warm(c49_even_bitpattern, sizeof(c49_even_bitpattern), touch)
+            + z_table_warm(c49_odd_bitpattern, sizeof(c49_odd_bitpattern), touch);
+}
@@ -32,7 +32,7 @@
 
 /* This data set taken from ANSI/AIM-BC6-2000, 4th April 2000 */
 
-static const char *c49_table7[128] = {
+static const char *const c49_table7[128] = {
     /* Table 7: Code 49 ASCII Chart */
     "! ", "!A", "!B", "!C", "!D", "!E", "!F", "!G", "!H", "!I", "!J", "!K", "!L",
     "!M", "!N", "!O", "!P", "!Q", "!R", "!S", "!T", "!U", "!V", "!W", "!X", "!Y",
@@ -62,7 +62,7 @@ static const char c49_z_weight[] = {
     13, 5, 41, 33, 36, 8, 4, 32, 3, 19, 40, 25, 29, 10, 24, 30
 };
 
-static const char *c49_table4[8] = {
+static const char *const c49_table4[8] = {
     /* Table 4: Row Parity Pattern for Code 49 Symbols */
     "OEEO", "EOEO", "OOEE", "EEOO", "OEOE", "EOOE", "OOOO", "EEEE"
 };
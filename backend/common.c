@@ -35,7 +35,17 @@
 #endif
 #ifdef _MSC_VER
 #include <malloc.h>
+#include "ms_stdint.h"
+#else
+#include <stdint.h>
 #endif
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(ZINT_HAVE_PTHREAD)
+#include <pthread.h>
+#endif
+#include <time.h>
 #include "common.h"
 
 /* Converts a character 0-9, A-F to its equivalent integer value */
@@ -97,6 +107,42 @@ INTERNAL int chr_cnt(const unsigned char string[], const int length, const unsig
     return count;
 }
 
+/* Character class flags (`CHR_DIGIT` etc) of each character, see `is_chr()` */
+INTERNAL const unsigned short chr_class[256] = {
+    0x0000, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, /* 0x00-0x07 */
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0610, 0x0000, 0x0000, /* 0x08-0x0F */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0x10-0x17 */
+    0x0000, 0x0000, 0x0000, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, /* 0x18-0x1F */
+    0x0BE8, 0x0420, 0x0420, 0x0420, 0x0460, 0x0460, 0x0420, 0x0420, /* 0x20-0x27 */
+    0x0420, 0x0420, 0x0470, 0x0460, 0x0C20, 0x0460, 0x0C60, 0x0460, /* 0x28-0x2F */
+    0x0821, 0x0821, 0x0821, 0x0821, 0x0821, 0x0821, 0x0821, 0x0821, /* 0x30-0x37 */
+    0x0821, 0x0821, 0x0460, 0x0420, 0x0420, 0x0420, 0x0430, 0x0420, /* 0x38-0x3F */
+    0x0220, 0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, /* 0x40-0x47 */
+    0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, /* 0x48-0x4F */
+    0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, 0x00A2, /* 0x50-0x57 */
+    0x00A2, 0x00A2, 0x00A2, 0x0420, 0x0220, 0x0420, 0x0220, 0x0200, /* 0x58-0x5F */
+    0x0200, 0x0104, 0x0104, 0x0104, 0x0104, 0x0104, 0x0104, 0x0104, /* 0x60-0x67 */
+    0x0104, 0x0104, 0x0104, 0x0104, 0x0104, 0x0104, 0x0104, 0x0104, /* 0x68-0x6F */
+    0x0104, 0x0104, 0x0104, 0x0104, 0x0104, 0x0104, 0x0104, 0x0104, /* 0x70-0x77 */
+    0x0104, 0x0104, 0x0104, 0x0400, 0x0200, 0x0400, 0x0200, 0x0200, /* 0x78-0x7F */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0x80-0x87 */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0x88-0x8F */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0x90-0x97 */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0x98-0x9F */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xA0-0xA7 */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xA8-0xAF */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xB0-0xB7 */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xB8-0xBF */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xC0-0xC7 */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xC8-0xCF */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xD0-0xD7 */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xD8-0xDF */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xE0-0xE7 */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xE8-0xEF */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, /* 0xF0-0xF7 */
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 /* 0xF8-0xFF */
+};
+
 /* Verifies that a string only uses valid characters */
 INTERNAL int is_sane(const char test_string[], const unsigned char source[], const int length) {
     int i, j, lt = (int) strlen(test_string);
@@ -117,16 +163,49 @@ INTERNAL int is_sane(const char test_string[], const unsigned char source[], con
     return 0;
 }
 
-/* Replaces huge switch statements for looking up in tables */
-INTERNAL void lookup(const char set_string[], const char *table[], const char data, char dest[]) {
-    int i, n = (int) strlen(set_string);
+/* Verifies that a string only uses characters in the `flags` character classes (see `is_chr()`) */
+INTERNAL int is_sane_chr(const int flags, const unsigned char source[], const int length) {
+    int i;
 
-    for (i = 0; i < n; i++) {
-        if (data == set_string[i]) {
-            strcat(dest, table[i]);
-            break;
+    for (i = 0; i < length; i++) {
+        if (!is_chr(flags, source[i])) {
+            return ZINT_ERROR_INVALID_DATA;
         }
     }
+
+    return 0;
+}
+
+/* Set `runs[i]` to the number of consecutive characters in the `flags` character classes (see `is_chr()`)
+   starting at `source[i]`, and `runs[length]` to 0, so that look-aheads over a run are a single load */
+INTERNAL void chr_runs(const int flags, const unsigned char source[], const int length, int runs[]) {
+    int i;
+
+    runs[length] = 0;
+    for (i = length - 1; i >= 0; i--) {
+        runs[i] = is_chr(flags, source[i]) ? runs[i + 1] + 1 : 0;
+    }
+}
+
+/* Verifies that a string only uses valid characters, and returns `test_string` position of each in `posns` array */
+INTERNAL int is_sane_lookup(const char test_string[], const int test_length, const unsigned char source[],
+                const int length, int *posns) {
+    signed char lookup[256];
+    int i;
+
+    /* Position of each character, or -1, so that each input character is a single load */
+    memset(lookup, -1, sizeof(lookup));
+    for (i = test_length - 1; i >= 0; i--) {
+        lookup[(unsigned char) test_string[i]] = (signed char) i;
+    }
+
+    for (i = 0; i < length; i++) {
+        if ((posns[i] = lookup[source[i]]) == -1) {
+            return ZINT_ERROR_INVALID_DATA;
+        }
+    }
+
+    return 0;
 }
 
 /* Convert an integer value to a string representing its binary equivalent */
@@ -155,6 +234,81 @@ INTERNAL int bin_append_posn(const int arg, const int length, char *binary, cons
     return bin_posn + length;
 }
 
+/* Start writing a packed bit stream to `data` at bit `posn`, keeping any bits of `data` before it */
+INTERNAL void bits_init(struct zint_bits *bits, unsigned char *data, const int posn) {
+    const int pending = posn & 0x07;
+
+    bits->data = data;
+    bits->posn = posn;
+    bits->acc = pending ? data[posn >> 3] >> (8 - pending) : 0;
+}
+
+/* Append the `length` (at most 24) least significant bits of `arg`, writing whole bytes as they complete */
+INTERNAL void bits_append(struct zint_bits *bits, const unsigned int arg, const int length) {
+    unsigned int acc = (bits->acc << length) | (arg & ((1U << length) - 1));
+    int pending = (bits->posn & 0x07) + length;
+    unsigned char *d = bits->data + (bits->posn >> 3);
+
+    while (pending >= 8) {
+        pending -= 8;
+        *d++ = (unsigned char) (acc >> pending);
+    }
+    bits->acc = acc & ((1U << pending) - 1);
+    bits->posn += length;
+}
+
+/* Write any partial last byte, zero-padded (appending may continue after). Returns the number of bits */
+INTERNAL int bits_flush(struct zint_bits *bits) {
+    const int pending = bits->posn & 0x07;
+
+    if (pending) {
+        bits->data[bits->posn >> 3] = (unsigned char) (bits->acc << (8 - pending));
+    }
+    return bits->posn;
+}
+
+/* Overwrite the `length` (at most 24) bits at bit `posn` with `arg`, where `posn + length` must not be beyond
+   the bits already appended (used to back-fill reserved fields such as a length indicator) */
+INTERNAL void bits_put(struct zint_bits *bits, const int posn, const unsigned int arg, const int length) {
+    const int whole = bits->posn & ~0x07; /* Bits before `whole` are in `data`, the rest in `acc` */
+    int i;
+
+    for (i = 0; i < length; i++) {
+        const int b = posn + i;
+        const unsigned int bit = (arg >> (length - 1 - i)) & 1;
+
+        if (b < whole) {
+            const unsigned char mask = (unsigned char) (0x80 >> (b & 0x07));
+            bits->data[b >> 3] = bit ? bits->data[b >> 3] | mask : bits->data[b >> 3] & ~mask;
+        } else {
+            const unsigned int mask = 1U << (bits->posn - 1 - b);
+            bits->acc = bit ? bits->acc | mask : bits->acc & ~mask;
+        }
+    }
+}
+
+/* Return the `length` (at most 24) bits at bit `posn` of packed bit stream `data`, which must be flushed */
+INTERNAL int bits_get(const unsigned char data[], const int posn, const int length) {
+    const unsigned char *d = data + (posn >> 3);
+    const int end = (posn & 0x07) + length;
+    unsigned int acc = 0;
+    int got;
+
+    for (got = 0; got < end; got += 8) {
+        acc = (acc << 8) | *d++;
+    }
+    return (int) ((acc >> (got - end)) & ((1U << length) - 1));
+}
+
+/* Print the `length` bits at bit `posn` of packed bit stream `data`, which must be flushed, as '0's and '1's */
+INTERNAL void bits_print(const unsigned char data[], const int posn, const int length) {
+    int i;
+
+    for (i = posn; i < posn + length; i++) {
+        putchar('0' + bits_is_set(data, i));
+    }
+}
+
 /* Returns the position of data in set_string */
 INTERNAL int posn(const char set_string[], const char data) {
     int i, n = (int) strlen(set_string);
@@ -170,47 +324,106 @@ INTERNAL int posn(const char set_string[], const char data) {
 #ifndef COMMON_INLINE
 /* Return true (1) if a module is dark/black, otherwise false (0) */
 INTERNAL int module_is_set(const struct zint_symbol *symbol, const int y_coord, const int x_coord) {
-    return (symbol->encoded_data[y_coord][x_coord >> 3] >> (x_coord & 0x07)) & 1;
+    return (symbol->internal->encoded_data[y_coord][x_coord >> 3] >> (x_coord & 0x07)) & 1;
 }
 
 /* Set a module to dark/black */
 INTERNAL void set_module(struct zint_symbol *symbol, const int y_coord, const int x_coord) {
-    symbol->encoded_data[y_coord][x_coord >> 3] |= 1 << (x_coord & 0x07);
+    symbol->internal->encoded_data[y_coord][x_coord >> 3] |= 1 << (x_coord & 0x07);
 }
 
 /* Return true (1-8) if a module is colour, otherwise false (0) */
 INTERNAL int module_colour_is_set(const struct zint_symbol *symbol, const int y_coord, const int x_coord) {
-    return symbol->encoded_data[y_coord][x_coord];
+    return symbol->internal->encoded_data[y_coord][x_coord];
 }
 
 /* Set a module to a colour */
 INTERNAL void set_module_colour(struct zint_symbol *symbol, const int y_coord, const int x_coord, const int colour) {
-    symbol->encoded_data[y_coord][x_coord] = colour;
+    symbol->internal->encoded_data[y_coord][x_coord] = colour;
 }
-#endif
 
 /* Set a dark/black module to white (i.e. unset) */
 INTERNAL void unset_module(struct zint_symbol *symbol, const int y_coord, const int x_coord) {
-    symbol->encoded_data[y_coord][x_coord >> 3] &= ~(1 << (x_coord & 0x07));
+    symbol->internal->encoded_data[y_coord][x_coord >> 3] &= ~(1 << (x_coord & 0x07));
+}
+#endif
+
+/* Set `length` modules from `x_coord` in row `y_coord` to dark/black, a byte (8 modules) at a time where possible */
+INTERNAL void set_module_run(struct zint_symbol *symbol, const int y_coord, const int x_coord, const int length) {
+    unsigned char *row = symbol->internal->encoded_data[y_coord];
+    int x = x_coord;
+    const int end = x_coord + length;
+
+    for (; x < end && (x & 0x07); x++) {
+        set_module(symbol, y_coord, x);
+    }
+    if (end - x >= 8) {
+        memset(row + (x >> 3), 0xFF, (end - x) >> 3);
+        x += (end - x) & ~0x07;
+    }
+    for (; x < end; x++) {
+        set_module(symbol, y_coord, x);
+    }
 }
 
-/* Expands from a width pattern to a bit pattern */
-INTERNAL void expand(struct zint_symbol *symbol, const char data[]) {
+/* Set the `count` (<= 24) modules from `x_coord` in row `y_coord` whose bits are set in `bits`, the first module
+   being the least significant bit, a byte at a time */
+INTERNAL void set_module_bits(struct zint_symbol *symbol, const int y_coord, const int x_coord,
+            const unsigned long bits, const int count) {
+    unsigned char *row = symbol->internal->encoded_data[y_coord] + (x_coord >> 3);
+    unsigned long acc = bits << (x_coord & 0x07);
+    int n;
+
+    for (n = (x_coord & 0x07) + count; n > 0; n -= 8, acc >>= 8) {
+        *row++ |= (unsigned char) acc;
+    }
+}
 
-    int reader, n = (int) strlen(data);
-    int writer, i;
+/* Return the number of modules from `x_coord` in row `y_coord` that have the same setting as the module at
+   `x_coord` (up to `symbol->width`), scanning 64 modules at a time where possible */
+INTERNAL int module_run_length(const struct zint_symbol *symbol, const int y_coord, const int x_coord) {
+    const unsigned char *row = symbol->internal->encoded_data[y_coord];
+    const int fill = module_is_set(symbol, y_coord, x_coord);
+    const unsigned char fill_byte = fill ? 0xFF : 0;
+    const uint64_t fill_word = fill ? ~((uint64_t) 0) : 0;
+    const int width = symbol->width;
+    int x = x_coord + 1;
+
+    for (; x < width && (x & 0x07); x++) {
+        if (module_is_set(symbol, y_coord, x) != fill) {
+            return x - x_coord;
+        }
+    }
+    for (; x + 64 <= width; x += 64) {
+        uint64_t word;
+        memcpy(&word, row + (x >> 3), sizeof(word)); /* Row not aligned */
+        if (word != fill_word) {
+            break;
+        }
+    }
+    for (; x + 8 <= width && row[x >> 3] == fill_byte; x += 8);
+    for (; x < width && module_is_set(symbol, y_coord, x) == fill; x++);
+
+    return x - x_coord;
+}
+
+/* Expands from a width pattern of `length` digits to a bit pattern */
+INTERNAL void expand(struct zint_symbol *symbol, const char data[], const int length) {
+
+    int reader;
+    int writer;
     int latch, num;
 
     writer = 0;
     latch = 1;
 
-    for (reader = 0; reader < n; reader++) {
+    for (reader = 0; reader < length; reader++) {
         num = ctoi(data[reader]);
-        for (i = 0; i < num; i++) {
+        if (num > 0) {
             if (latch) {
-                set_module(symbol, symbol->rows, writer);
+                set_module_run(symbol, symbol->rows, writer, num);
             }
-            writer++;
+            writer += num;
         }
 
         latch = !latch;
@@ -341,6 +554,16 @@ INTERNAL int is_valid_utf8(const unsigned char source[], const int length) {
     unsigned int codepoint, state = 0;
 
     for (i = 0; i < length; i++) {
+        /* Fast path skipping 8 ASCII bytes at a time (only between sequences) */
+        if (state == 0) {
+            while (i + 8 <= length && !((source[i] | source[i + 1] | source[i + 2] | source[i + 3] | source[i + 4]
+                                        | source[i + 5] | source[i + 6] | source[i + 7]) & 0x80)) {
+                i += 8;
+            }
+            if (i == length) {
+                break;
+            }
+        }
         if (decode_utf8(&state, &codepoint, source[i]) == 12) {
             return 0;
         }
@@ -361,6 +584,10 @@ INTERNAL int utf8_to_unicode(struct zint_symbol *symbol, const unsigned char sou
     jpos = 0;
 
     while (bpos < *length) {
+        if (source[bpos] < 0x80) { /* ASCII fast path (state always 0 here) */
+            vals[jpos++] = source[bpos++];
+            continue;
+        }
         do {
             decode_utf8(&state, &codepoint, source[bpos++]);
         } while (bpos < *length && state != 0 && state != 12);
@@ -456,6 +683,453 @@ INTERNAL int colour_to_blue(const int colour) {
     return return_val;
 }
 
+/* As `malloc()`, using `allocator` if given and set (see `ZBarcode_Create_Allocator()`) */
+INTERNAL void *z_malloc(const struct zint_allocator *allocator, const size_t size) {
+    return allocator && allocator->malloc_fn ? (*allocator->malloc_fn)(allocator->context, size) : malloc(size);
+}
+
+/* As `calloc()`, using `allocator` if given and set */
+INTERNAL void *z_calloc(const struct zint_allocator *allocator, const size_t nmemb, const size_t size) {
+    void *ptr;
+    if (!allocator || !allocator->malloc_fn) {
+        return calloc(nmemb, size);
+    }
+    if (size && nmemb > (size_t) -1 / size) {
+        return NULL;
+    }
+    if ((ptr = (*allocator->malloc_fn)(allocator->context, nmemb * size))) {
+        memset(ptr, 0, nmemb * size);
+    }
+    return ptr;
+}
+
+/* As `realloc()`, using `allocator` if given and set */
+INTERNAL void *z_realloc(const struct zint_allocator *allocator, void *ptr, const size_t size) {
+    return allocator && allocator->realloc_fn ? (*allocator->realloc_fn)(allocator->context, ptr, size)
+            : realloc(ptr, size);
+}
+
+/* As `free()`, using `allocator` if given and set */
+INTERNAL void z_free(const struct zint_allocator *allocator, void *ptr) {
+    if (allocator && allocator->free_fn) {
+        if (ptr) {
+            (*allocator->free_fn)(allocator->context, ptr);
+        }
+    } else {
+        free(ptr);
+    }
+}
+
+/* Header of a working block allocated by `z_work_alloc()`, linked newest first from `internal->work` */
+struct zint_work {
+    struct zint_work *next;
+    union { void *p; double d; long l; } align; /* So that the block proper is suitably aligned for any type */
+};
+
+/* Allocate a working block of `size` bytes for `symbol` (for ZINT_BOUNDED_STACK builds, see `z_work_array()`),
+   kept until `z_work_free()`. Returns NULL on failure */
+INTERNAL void *z_work_alloc(struct zint_symbol *symbol, const size_t size) {
+    struct zint_work *work;
+
+    if (size > (size_t) -1 - sizeof(struct zint_work)
+            || !(work = (struct zint_work *) z_malloc(z_allocator(symbol), sizeof(struct zint_work) + size))) {
+        return NULL;
+    }
+    work->next = symbol->internal->work;
+    symbol->internal->work = work;
+
+    return work + 1;
+}
+
+/* Set `symbol->errtxt` for failure to allocate working arrays, returning ZINT_ERROR_MEMORY */
+INTERNAL int z_work_error(struct zint_symbol *symbol) {
+    strcpy(symbol->errtxt, "709: Insufficient memory for working arrays");
+    return ZINT_ERROR_MEMORY;
+}
+
+/* Free all the working blocks of `symbol`, newest first (so the allocator sees frees in reverse order of
+   allocation) */
+INTERNAL void z_work_free(struct zint_symbol *symbol) {
+    while (symbol->internal->work) {
+        struct zint_work *next = symbol->internal->work->next;
+        z_free(z_allocator(symbol), symbol->internal->work);
+        symbol->internal->work = next;
+    }
+}
+
+/* Return the template kept for `version` of `symbol->symbology`, or else a new one (replacing any kept) with room
+   for a `grid_size` grid and `positions_max` data module positions, `built` unset for the encoder to fill in.
+   Returns NULL on failure */
+INTERNAL struct zint_template *z_template_get(struct zint_symbol *symbol, const int version,
+            const int grid_size, const int positions_max) {
+    struct zint_template *templ = symbol->internal->grid_template;
+
+    if (templ && templ->symbology == symbol->symbology && templ->version == version
+            && templ->grid_size == grid_size) {
+        return templ;
+    }
+    z_template_free(symbol);
+
+    /* Single block, positions first for alignment */
+    if (!(templ = (struct zint_template *) z_malloc(z_allocator(symbol), sizeof(struct zint_template)
+                                                    + sizeof(int) * positions_max + grid_size))) {
+        return NULL;
+    }
+    templ->symbology = symbol->symbology;
+    templ->version = version;
+    templ->built = 0;
+    templ->positions = (int *) (templ + 1);
+    templ->positions_len = 0;
+    templ->grid = (unsigned char *) (templ->positions + positions_max);
+    templ->grid_size = grid_size;
+    symbol->internal->grid_template = templ;
+
+    return templ;
+}
+
+/* Free any template kept by `symbol` */
+INTERNAL void z_template_free(struct zint_symbol *symbol) {
+    if (symbol->internal->grid_template) {
+        z_free(z_allocator(symbol), symbol->internal->grid_template);
+        symbol->internal->grid_template = NULL;
+    }
+}
+
+/* Read a byte of each cache line of the `size` bytes of static `table` if `touch`, so that it's resident before
+   first use (see `ZBarcode_Init()`), returning `size` */
+INTERNAL size_t z_table_warm(const void *table, const size_t size, const int touch) {
+    if (touch) {
+        const volatile unsigned char *p = (const volatile unsigned char *) table;
+        size_t i;
+        for (i = 0; i < size; i += 64) {
+            (void) p[i];
+        }
+    }
+    return size;
+}
+
+#define Z_THREADS_MAX   32 /* Most threads used by the built-in executor for one `z_parallel()` */
+
+/* Tasks of a `z_parallel()` run by the built-in executor, each thread taking the next one not yet taken as it
+   finishes the last, so that uneven tasks are balanced */
+struct z_tasks {
+    void (*task_fn)(void *arg, int index);
+    void *arg;
+    int count;
+    int next; /* Next task to be taken, guarded by `lock` */
+#if defined(_WIN32)
+    CRITICAL_SECTION lock;
+#elif defined(ZINT_HAVE_PTHREAD)
+    pthread_mutex_t lock;
+#endif
+};
+
+#if defined(_WIN32)
+#define Z_THREADS
+typedef HANDLE z_thread_t;
+#define z_tasks_lock(tasks)     EnterCriticalSection(&(tasks)->lock)
+#define z_tasks_unlock(tasks)   LeaveCriticalSection(&(tasks)->lock)
+#elif defined(ZINT_HAVE_PTHREAD)
+#define Z_THREADS
+typedef pthread_t z_thread_t;
+#define z_tasks_lock(tasks)     pthread_mutex_lock(&(tasks)->lock)
+#define z_tasks_unlock(tasks)   pthread_mutex_unlock(&(tasks)->lock)
+#else
+#define z_tasks_lock(tasks)     ((void) 0)
+#define z_tasks_unlock(tasks)   ((void) 0)
+#endif
+
+#ifdef Z_THREADS
+/* Set up `tasks`, returning 0 on failure */
+static int z_tasks_init(struct z_tasks *tasks, void (*task_fn)(void *arg, int index), void *arg, const int count) {
+    tasks->task_fn = task_fn;
+    tasks->arg = arg;
+    tasks->count = count;
+    tasks->next = 0;
+#if defined(_WIN32)
+    InitializeCriticalSection(&tasks->lock);
+    return 1;
+#else
+    return pthread_mutex_init(&tasks->lock, NULL) == 0;
+#endif
+}
+
+static void z_tasks_destroy(struct z_tasks *tasks) {
+#if defined(_WIN32)
+    DeleteCriticalSection(&tasks->lock);
+#else
+    pthread_mutex_destroy(&tasks->lock);
+#endif
+}
+
+/* Run tasks until none are left */
+static void z_tasks_work(struct z_tasks *tasks) {
+    int index;
+
+    for (;;) {
+        z_tasks_lock(tasks);
+        index = tasks->next < tasks->count ? tasks->next++ : -1;
+        z_tasks_unlock(tasks);
+        if (index < 0) {
+            break;
+        }
+        (*tasks->task_fn)(tasks->arg, index);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI z_thread_func(LPVOID arg) {
+    z_tasks_work((struct z_tasks *) arg);
+    return 0;
+}
+
+/* Start a thread working on `tasks`, returning 0 on failure */
+static int z_thread_start(z_thread_t *p_thread, struct z_tasks *tasks) {
+    *p_thread = CreateThread(NULL, 0, z_thread_func, tasks, 0, NULL);
+    return *p_thread != NULL;
+}
+
+static void z_thread_join(z_thread_t thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#else
+static void *z_thread_func(void *arg) {
+    z_tasks_work((struct z_tasks *) arg);
+    return NULL;
+}
+
+/* Start a thread working on `tasks`, returning 0 on failure */
+static int z_thread_start(z_thread_t *p_thread, struct z_tasks *tasks) {
+    return pthread_create(p_thread, NULL, z_thread_func, tasks) == 0;
+}
+
+static void z_thread_join(z_thread_t thread) {
+    pthread_join(thread, NULL);
+}
+#endif
+#endif /* Z_THREADS */
+
+/* Call `task_fn(arg, index)` for each `index` from 0 to `count - 1`, in any order and possibly concurrently on up
+   to `max_threads` threads (including the calling one), returning when all are done. Uses the executor set for
+   `symbol` by `ZBarcode_SetExecutor()` if any (running the tasks on the calling thread if it declines), else the
+   built-in one, which starts threads for the call (if available), the calling thread taking any left if they fail
+   to start */
+INTERNAL void z_parallel(const struct zint_symbol *symbol, void (*task_fn)(void *arg, int index), void *arg,
+            const int count, int max_threads) {
+    const struct zint_internal *const internal = symbol->internal;
+    int i;
+#ifdef Z_THREADS
+    struct z_tasks tasks;
+    z_thread_t handles[Z_THREADS_MAX];
+    int started[Z_THREADS_MAX];
+#endif
+
+    if (max_threads > count) {
+        max_threads = count;
+    }
+    if (max_threads > 1 && internal->run_fn) {
+        if ((*internal->run_fn)(internal->run_context, task_fn, arg, count, max_threads) == 0) {
+            return;
+        }
+        max_threads = 1; /* Declined, so keep to the calling thread */
+    }
+#ifdef Z_THREADS
+    if (max_threads > Z_THREADS_MAX) {
+        max_threads = Z_THREADS_MAX;
+    }
+    if (max_threads > 1 && z_tasks_init(&tasks, task_fn, arg, count)) {
+        for (i = 1; i < max_threads; i++) {
+            started[i] = z_thread_start(&handles[i], &tasks);
+        }
+        z_tasks_work(&tasks);
+        for (i = 1; i < max_threads; i++) {
+            if (started[i]) {
+                z_thread_join(handles[i]);
+            }
+        }
+        z_tasks_destroy(&tasks);
+        return;
+    }
+#endif /* Z_THREADS */
+    for (i = 0; i < count; i++) {
+        (*task_fn)(arg, i);
+    }
+}
+
+/* A task run in the background by `z_async_start()` */
+struct z_async {
+    struct z_tasks tasks; /* The task (count 1) */
+    int cancelled; /* Guarded by `tasks.lock` */
+    int done; /* Guarded by `tasks.lock` */
+#ifdef Z_THREADS
+    z_thread_t thread;
+    int started;
+#endif
+};
+
+/* Create a background task `task_fn(arg, 0)` using `allocator`, to be started by `z_async_start()`. Returns NULL on
+   failure */
+INTERNAL struct z_async *z_async_create(const struct zint_allocator *allocator,
+            void (*task_fn)(void *arg, int index), void *arg) {
+    struct z_async *async = (struct z_async *) z_malloc(allocator, sizeof(struct z_async));
+
+    if (!async) {
+        return NULL;
+    }
+    async->cancelled = async->done = 0;
+#ifdef Z_THREADS
+    async->started = 0;
+    if (!z_tasks_init(&async->tasks, task_fn, arg, 1)) {
+        z_free(allocator, async);
+        return NULL;
+    }
+#else
+    async->tasks.task_fn = task_fn;
+    async->tasks.arg = arg;
+    async->tasks.count = 1;
+    async->tasks.next = 0;
+#endif
+    return async;
+}
+
+/* Start the task of `async` on its own thread, or if threads aren't available (or it fails to start) run it on the
+   calling thread before returning. Returns 1 if started in the background, else 0 */
+INTERNAL int z_async_start(struct z_async *async) {
+#ifdef Z_THREADS
+    if ((async->started = z_thread_start(&async->thread, &async->tasks))) {
+        return 1;
+    }
+    z_tasks_work(&async->tasks);
+#else
+    (*async->tasks.task_fn)(async->tasks.arg, 0);
+#endif
+    return 0;
+}
+
+/* Ask the task of `async` to stop, returning 1 if it hasn't yet called `z_async_finish()`, else 0 */
+INTERNAL int z_async_cancel(struct z_async *async) {
+    int pending;
+
+    z_tasks_lock(&async->tasks);
+    if ((pending = !async->done)) {
+        async->cancelled = 1;
+    }
+    z_tasks_unlock(&async->tasks);
+    return pending;
+}
+
+/* Return 1 if the task of `async` has been asked to stop by `z_async_cancel()`, else 0 */
+INTERNAL int z_async_cancelled(struct z_async *async) {
+    int cancelled;
+
+    z_tasks_lock(&async->tasks);
+    cancelled = async->cancelled;
+    z_tasks_unlock(&async->tasks);
+    return cancelled;
+}
+
+/* Called by the task of `async` once its result is settled, after which it can't be cancelled. Returns 1 if it was
+   cancelled beforehand, else 0 */
+INTERNAL int z_async_finish(struct z_async *async) {
+    int cancelled;
+
+    z_tasks_lock(&async->tasks);
+    async->done = 1;
+    cancelled = async->cancelled;
+    z_tasks_unlock(&async->tasks);
+    return cancelled;
+}
+
+/* Wait for the task of `async` to end (which mustn't be called from the task itself), then free it with the
+   `allocator` it was created with */
+INTERNAL void z_async_delete(const struct zint_allocator *allocator, struct z_async *async) {
+    if (!async) {
+        return;
+    }
+#ifdef Z_THREADS
+    if (async->started) {
+        z_thread_join(async->thread);
+    }
+    z_tasks_destroy(&async->tasks);
+#endif
+    z_free(allocator, async);
+}
+
+/* Return a monotonic time in milliseconds (for deadlines, so only differences are meaningful) */
+INTERNAL long long z_clock_ms(void) {
+#if defined(_WIN32)
+    return (long long) GetTickCount64();
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+        return (long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    }
+    return (long long) time(NULL) * 1000;
+#else
+    return (long long) time(NULL) * 1000;
+#endif
+}
+
+/* Return 1 if encoding is past the deadline of `symbol->time_budget_ms`, noting that the caller then makes a faster
+   choice (e.g. greedy mode selection or a fixed mask) so that a warning is given, else 0 */
+INTERNAL int z_over_budget(struct zint_symbol *symbol) {
+    if (symbol->internal->budget && z_clock_ms() > symbol->internal->budget->deadline) {
+        symbol->internal->budget->exceeded = 1;
+        return 1;
+    }
+    return 0;
+}
+
+/* Add a structured trace record to the ring `trace_records` (allocated on the first record of the symbol),
+   overwriting the oldest if full. The record is dropped if the ring can't be allocated */
+INTERNAL void z_trace_record(struct zint_symbol *symbol, const int phase, const int kind, const int v0,
+            const int v1, const int v2, const int v3) {
+    struct zint_internal *const internal = symbol->internal;
+    struct zint_trace_record *record;
+
+    if (!internal->trace_records && !(internal->trace_records = (struct zint_trace_record *)
+                            z_malloc(z_allocator(symbol), sizeof(struct zint_trace_record) * ZINT_TRACE_RECORDS))) {
+        return;
+    }
+    record = internal->trace_records + symbol->trace_record_count % ZINT_TRACE_RECORDS;
+    record->phase = phase;
+    record->kind = kind;
+    record->values[0] = v0;
+    record->values[1] = v1;
+    record->values[2] = v2;
+    record->values[3] = v3;
+    symbol->trace_record_count++;
+}
+
+/* Record each run of the same mode in `modes` (one per character) as ZINT_RECORD_MODE, if tracing */
+INTERNAL void z_record_modes(struct zint_symbol *symbol, const char modes[], const int length) {
+    int i, start;
+
+    if (!(symbol->debug & ZINT_DEBUG_TRACE)) {
+        return;
+    }
+    for (i = 1, start = 0; i <= length; i++) {
+        if (i == length || modes[i] != modes[start]) {
+            z_trace_record(symbol, ZINT_PHASE_MODES, ZINT_RECORD_MODE, modes[start], start, i - start, -1);
+            start = i;
+        }
+    }
+}
+
+/* Set the size of a symbol being measured (ZINT_MEASURE_ONLY) once known, leaving its modules unset. Returns 0 */
+INTERNAL int z_measured(struct zint_symbol *symbol, const int rows, const int width) {
+    int i;
+
+    symbol->rows = rows;
+    symbol->width = width;
+    for (i = 0; i < rows && i < 200; i++) {
+        symbol->row_height[i] = 1;
+    }
+    return 0;
+}
+
 #ifdef ZINT_TEST
 /* Dumps hex-formatted codewords in symbol->errtxt (for use in testing) */
 void debug_test_codeword_dump(struct zint_symbol *symbol, const unsigned char *codewords, const int length) {
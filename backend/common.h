@@ -46,10 +46,37 @@
 /* The most commonly used set */
 #define NEON   "0123456789"
 
+/* Character class flags of `chr_class[]`, tested by `is_chr()` */
+#define CHR_DIGIT       0x0001 /* 0-9 */
+#define CHR_UPPER       0x0002 /* A-Z */
+#define CHR_LOWER       0x0004 /* a-z */
+#define CHR_SPACE       0x0008 /* Space */
+#define CHR_X12_TERM    0x0010 /* X12 terminator/separators CR, "*" and ">" (Data Matrix X12, Code One EDI) */
+#define CHR_EDIFACT     0x0020 /* EDIFACT space to "^" (Data Matrix) */
+#define CHR_QR_PUNCT    0x0040 /* Alphanumeric mode punctuation " $%*+-./:" (QR Code) */
+#define CHR_AZ_U        0x0080 /* Aztec Upper, Lower, Mixed, Punct and Digit modes, in `AZ_U` etc order */
+#define CHR_AZ_L        0x0100
+#define CHR_AZ_M        0x0200
+#define CHR_AZ_P        0x0400
+#define CHR_AZ_D        0x0800
+#define CHR_AZ_SHIFT    7 /* `chr_class[c] >> CHR_AZ_SHIFT` gives Aztec mode bit flags (masked with 0x1F) */
+
+/* Unions of the above */
+#define CHR_C40         (CHR_DIGIT | CHR_UPPER | CHR_SPACE) /* Basic (non-shifted) C40 */
+#define CHR_TEXT        (CHR_DIGIT | CHR_LOWER | CHR_SPACE) /* Basic (non-shifted) Text */
+#define CHR_X12         (CHR_C40 | CHR_X12_TERM) /* X12 (Data Matrix), EDI (Code One) */
+#define CHR_QR_ALNUM    (CHR_DIGIT | CHR_UPPER | CHR_QR_PUNCT) /* Alphanumeric mode (QR Code) */
+
+/* Whether character `c` is in any of the `flags` character classes - a table load and a mask */
+#define is_chr(flags, c) (chr_class[(unsigned char) (c)] & (flags))
+
 #include "zint.h"
 #include "zintconfig.h"
 #include <stdlib.h>
 #include <string.h>
+#ifdef _MSC_VER
+#include <malloc.h> /* For `_alloca()` */
+#endif
 
 /* Helpers to cast away char pointer signedness */
 #define ustrlen(source) strlen((const char *) (source))
@@ -73,40 +100,134 @@
 
 #ifdef COMMON_INLINE
 /* Return true (1) if a module is dark/black, otherwise false (0) */
-#define module_is_set(s, y, x) (((s)->encoded_data[(y)][(x) >> 3] >> ((x) & 0x07)) & 1)
+#define module_is_set(s, y, x) (((s)->internal->encoded_data[(y)][(x) >> 3] >> ((x) & 0x07)) & 1)
 
 /* Set a module to dark/black */
-#define set_module(s, y, x) do { (s)->encoded_data[(y)][(x) >> 3] |= 1 << ((x) & 0x07); } while (0)
+#define set_module(s, y, x) do { (s)->internal->encoded_data[(y)][(x) >> 3] |= 1 << ((x) & 0x07); } while (0)
 
 /* Return true (1-8) if a module is colour, otherwise false (0) */
-#define module_colour_is_set(s, y, x) ((s)->encoded_data[(y)][(x)])
+#define module_colour_is_set(s, y, x) ((s)->internal->encoded_data[(y)][(x)])
 
 /* Set a module to a colour */
-#define set_module_colour(s, y, x, c) do { (s)->encoded_data[(y)][(x)] = (c); } while (0)
+#define set_module_colour(s, y, x, c) do { (s)->internal->encoded_data[(y)][(x)] = (c); } while (0)
+
+/* Set a dark/black module to white (i.e. unset) */
+#define unset_module(s, y, x) do { (s)->internal->encoded_data[(y)][(x) >> 3] &= ~(1 << ((x) & 0x07)); } while (0)
 #endif
 
+/* Instrumentation event, calling `symbol->trace_func` if set (a test and branch only if not) */
+#define z_trace(s, phase, event, length) \
+    do { if ((s)->trace_func) (*(s)->trace_func)((s)->trace_context, (s), (phase), (event), (length)); } while (0)
+
+/* Internal `symbol->debug` flag set by `ZBarcode_Measure()`: encoders may stop once sized, see `z_measured()` */
+#define ZINT_MEASURE_ONLY   0x40000000
+
+/* Internal `symbol->debug` flag set by `encode_source()` if human readable text isn't wanted, see `z_hrt()` */
+#define ZINT_NO_HRT_TEXT    0x20000000
+
+/* Whether encoders should set `symbol->text`, i.e. unless BARCODE_NO_HRT set or `show_hrt` 0 */
+#define z_hrt(s) (!((s)->debug & ZINT_NO_HRT_TEXT))
+
+/* Structured trace record if `symbol->debug & ZINT_DEBUG_TRACE` (a test and branch only if not) */
+#define z_record(s, phase, kind, v0, v1, v2, v3) \
+    do { if ((s)->debug & ZINT_DEBUG_TRACE) z_trace_record((s), (phase), (kind), (v0), (v1), (v2), (v3)); } while (0)
+
+/* Packed bit stream writer, most significant bit first, see `bits_init()` */
+struct zint_bits {
+    unsigned char *data; /* Output bytes, only whole bytes written until `bits_flush()` */
+    int posn; /* Number of bits appended */
+    unsigned int acc; /* The `posn % 8` bits not yet written, right-aligned */
+};
+
+/* Get bit `i` of packed bit stream `data` */
+#define bits_is_set(data, i) (((data)[(i) >> 3] >> (7 - ((i) & 0x07))) & 1)
+
+/* State kept between `ZBarcode_Encode_Incremental()` calls, set in `internal->incremental` during each. Encoders
+   supporting it keep their own `data` (freed by `data_free`), which is dropped if `symbology` changes */
+struct zint_incremental {
+    int symbology;
+    void *data;
+    void (*data_free)(void *data);
+};
+
+/* Function pattern template of the version last encoded by a matrix symbology, kept in `internal->grid_template`
+   until `ZBarcode_Delete()` so that encoding the same version again is a copy and a scatter of the data bits, see
+   `z_template_get()` */
+struct zint_template {
+    int symbology;
+    int version;
+    int built; /* Set by the encoder once `grid` and `positions` are filled in */
+    unsigned char *grid; /* `grid_size` bytes, function modules non-zero and data modules zero */
+    int grid_size;
+    int *positions; /* Indexes into `grid` of the data modules in placement order */
+    int positions_len;
+};
+
+/* Deadline of `symbol->time_budget_ms`, set in `internal->budget` while encoding, see `z_over_budget()` */
+struct zint_budget {
+    long long deadline; /* `z_clock_ms()` time */
+    int exceeded; /* Set once a faster choice has been made because the deadline passed */
+};
+
+#define ZINT_TRACE_RECORDS  64 /* Size of the ring of structured trace records, see `z_trace_record()` */
+
+/* Library-private state of a symbol, `symbol->internal`, allocated with it by `ZBarcode_Create()` */
+struct zint_internal {
+    unsigned char encoded_data[200][143]; /* Modules, bit-packed LSB first (Ultracode a byte per module colour) */
+    struct zint_allocator allocator; /* As given to `ZBarcode_Create_Allocator()`, all NULL for default */
+    /* Executor set by `ZBarcode_SetExecutor()`, NULL for built-in */
+    int (*run_fn)(void *context, void (*task_fn)(void *arg, int index), void *arg, int count, int max_threads);
+    void *run_context;
+    struct zint_trace_record *trace_records; /* Ring of ZINT_TRACE_RECORDS, allocated by the first record */
+    struct zint_scratch *scratch; /* Raster working buffers, kept until `ZBarcode_Delete()` */
+    /* BARCODE_MEMORY_FILE buffer, lent to `symbol->memfile` and kept for re-use until `ZBarcode_Delete()` */
+    unsigned char *memfile_buf;
+    size_t memfile_capacity; /* Allocated size of `memfile_buf` */
+    struct zint_work *work; /* Encoder working arrays (ZINT_BOUNDED_STACK builds), freed after encoding */
+    struct zint_incremental *incremental; /* Set only while encoding incrementally */
+    struct zint_template *grid_template; /* Matrix function pattern template, kept until `ZBarcode_Delete()` */
+    struct zint_eci_segs *eci_segs; /* Set only while encoding data split into ECI segments (see MULTI_ECI_MODE) */
+    struct zint_budget *budget; /* Set only while encoding with a time budget */
+    struct zint_gs1_prepared *gs1_prepared; /* Set only while encoding by `ZBarcode_Encode_GS1()` */
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+    extern INTERNAL const unsigned short chr_class[256];
+
     INTERNAL int ctoi(const char source);
     INTERNAL char itoc(const int source);
     INTERNAL int to_int(const unsigned char source[], const int length);
     INTERNAL void to_upper(unsigned char source[]);
     INTERNAL int chr_cnt(const unsigned char string[], const int length, const unsigned char c);
     INTERNAL int is_sane(const char test_string[], const unsigned char source[], const int length);
-    INTERNAL void lookup(const char set_string[], const char *table[], const char data, char dest[]);
+    INTERNAL int is_sane_chr(const int flags, const unsigned char source[], const int length);
+    INTERNAL void chr_runs(const int flags, const unsigned char source[], const int length, int runs[]);
+    INTERNAL int is_sane_lookup(const char test_string[], const int test_length, const unsigned char source[],
+                    const int length, int *posns);
     INTERNAL void bin_append(const int arg, const int length, char *binary);
     INTERNAL int bin_append_posn(const int arg, const int length, char *binary, const int bin_posn);
+    INTERNAL void bits_init(struct zint_bits *bits, unsigned char *data, const int posn);
+    INTERNAL void bits_append(struct zint_bits *bits, const unsigned int arg, const int length);
+    INTERNAL int bits_flush(struct zint_bits *bits);
+    INTERNAL void bits_put(struct zint_bits *bits, const int posn, const unsigned int arg, const int length);
+    INTERNAL int bits_get(const unsigned char data[], const int posn, const int length);
+    INTERNAL void bits_print(const unsigned char data[], const int posn, const int length);
     INTERNAL int posn(const char set_string[], const char data);
     #ifndef COMMON_INLINE
     INTERNAL int module_is_set(const struct zint_symbol *symbol, const int y_coord, const int x_coord);
     INTERNAL void set_module(struct zint_symbol *symbol, const int y_coord, const int x_coord);
     INTERNAL int module_colour_is_set(const struct zint_symbol *symbol, const int y_coord, const int x_coord);
     INTERNAL void set_module_colour(struct zint_symbol *symbol, const int y_coord, const int x_coord, const int colour);
-    #endif
     INTERNAL void unset_module(struct zint_symbol *symbol, const int y_coord, const int x_coord);
-    INTERNAL void expand(struct zint_symbol *symbol, const char data[]);
+    #endif
+    INTERNAL void set_module_run(struct zint_symbol *symbol, const int y_coord, const int x_coord, const int length);
+    INTERNAL void set_module_bits(struct zint_symbol *symbol, const int y_coord, const int x_coord,
+                const unsigned long bits, const int count);
+    INTERNAL int module_run_length(const struct zint_symbol *symbol, const int y_coord, const int x_coord);
+    INTERNAL void expand(struct zint_symbol *symbol, const char data[], const int length);
     INTERNAL int is_stackable(const int symbology);
     INTERNAL int is_extendable(const int symbology);
     INTERNAL int is_composite(const int symbology);
@@ -121,6 +242,62 @@ extern "C" {
     INTERNAL int colour_to_green(const int colour);
     INTERNAL int colour_to_blue(const int colour);
 
+    /* Allocator of `symbol`, for `z_malloc()` etc */
+    #define z_allocator(s) (&(s)->internal->allocator)
+    INTERNAL void *z_malloc(const struct zint_allocator *allocator, const size_t size);
+    INTERNAL void *z_calloc(const struct zint_allocator *allocator, const size_t nmemb, const size_t size);
+    INTERNAL void *z_realloc(const struct zint_allocator *allocator, void *ptr, const size_t size);
+    INTERNAL void z_free(const struct zint_allocator *allocator, void *ptr);
+
+    INTERNAL void z_parallel(const struct zint_symbol *symbol, void (*task_fn)(void *arg, int index), void *arg,
+                const int count, int max_threads);
+
+    struct z_async;
+    INTERNAL struct z_async *z_async_create(const struct zint_allocator *allocator,
+                void (*task_fn)(void *arg, int index), void *arg);
+    INTERNAL int z_async_start(struct z_async *async);
+    INTERNAL int z_async_cancel(struct z_async *async);
+    INTERNAL int z_async_cancelled(struct z_async *async);
+    INTERNAL int z_async_finish(struct z_async *async);
+    INTERNAL void z_async_delete(const struct zint_allocator *allocator, struct z_async *async);
+    INTERNAL long long z_clock_ms(void);
+    INTERNAL int z_over_budget(struct zint_symbol *symbol);
+
+    INTERNAL void *z_work_alloc(struct zint_symbol *symbol, const size_t size);
+    INTERNAL int z_work_error(struct zint_symbol *symbol);
+    INTERNAL void z_work_free(struct zint_symbol *symbol);
+
+    INTERNAL struct zint_template *z_template_get(struct zint_symbol *symbol, const int version,
+                const int grid_size, const int positions_max);
+    INTERNAL void z_template_free(struct zint_symbol *symbol);
+
+    INTERNAL size_t z_table_warm(const void *table, const size_t size, const int touch);
+
+    /* Declare working array `name` of `n` `type`s (or `n` rows of `m` for 2-dimensional), for arrays that are large
+       or sized by the input. Normally these are on the stack (VLAs, or `_alloca()` for MSVC), but ZINT_BOUNDED_STACK
+       builds allocate them instead (see `z_work_alloc()`), `z_work_failed(name)` then needing to be checked (and
+       `z_work_error()` returned if so). Note sizeof can't be used on them */
+    #ifdef ZINT_BOUNDED_STACK
+    #define z_work_array(s, type, name, n) type *name = (type *) z_work_alloc((s), sizeof(type) * (n))
+    #define z_work_array2(s, type, name, n, m) \
+                type (*name)[m] = (type (*)[m]) z_work_alloc((s), sizeof(type) * (m) * (n))
+    #define z_work_failed(name) ((name) == NULL)
+    #elif defined(_MSC_VER)
+    #define z_work_array(s, type, name, n) type *name = (type *) _alloca(sizeof(type) * (n))
+    #define z_work_array2(s, type, name, n, m) \
+                type (*name)[m] = (type (*)[m]) _alloca(sizeof(type) * (m) * (n))
+    #define z_work_failed(name) 0
+    #else
+    #define z_work_array(s, type, name, n) type name[n]
+    #define z_work_array2(s, type, name, n, m) type name[n][m]
+    #define z_work_failed(name) 0
+    #endif
+
+    INTERNAL void z_trace_record(struct zint_symbol *symbol, const int phase, const int kind, const int v0,
+                const int v1, const int v2, const int v3);
+    INTERNAL void z_record_modes(struct zint_symbol *symbol, const char modes[], const int length);
+    INTERNAL int z_measured(struct zint_symbol *symbol, const int rows, const int width);
+
     #ifdef ZINT_TEST
     void debug_test_codeword_dump(struct zint_symbol *symbol, const unsigned char *codewords, const int length);
     void debug_test_codeword_dump_int(struct zint_symbol *symbol, const int *codewords, const int length);
@@ -59,6 +59,7 @@
 #include "pdf417.h"
 #include "gs1.h"
 #include "general_field.h"
+#include "large.h"
 
 #define UINT unsigned short
 #include "composite.h"
@@ -80,65 +81,48 @@ static int _min(const int first, const int second) {
         return second;
 }
 
-/* gets bit in bitString at bitPos */
-static int getBit(const UINT *bitStr, const int bitPos) {
-    return !!(bitStr[bitPos >> 4] & (0x8000 >> (bitPos & 15)));
+/* gets bit in packed bitString at bitPos */
+static int getBit(const unsigned char *bitStr, const int bitPos) {
+    return bits_is_set(bitStr, bitPos);
 }
 
 /* converts bit string to base 928 values, codeWords[0] is highest order */
-static int encode928(const UINT bitString[], UINT codeWords[], const int bitLng) {
-    int i, j, b, cwNdx, cwLng;
+static int encode928(const unsigned char bitString[], UINT codeWords[], const int bitLng) {
+    int i, b, cwNdx, cwLng;
     for (cwNdx = cwLng = b = 0; b < bitLng; b += 69, cwNdx += 7) {
         int bitCnt = _min(bitLng - b, 69);
         int cwCnt;
+        large_int t;
         cwLng += cwCnt = bitCnt / 10 + 1;
-        for (i = 0; i < cwCnt; i++)
-            codeWords[cwNdx + i] = 0; /* init 0 */
+        /* load the (up to 69-bit) chunk as a single value and convert by repeated division */
+        large_load_u64(&t, 0);
         for (i = 0; i < bitCnt; i++) {
-            if (getBit(bitString, b + bitCnt - i - 1)) {
-                for (j = 0; j < cwCnt; j++)
-                    codeWords[cwNdx + j] += pwr928[i][j + 7 - cwCnt];
-            }
+            t.hi = (t.hi << 1) | (t.lo >> 63);
+            t.lo = (t.lo << 1) | getBit(bitString, b + i);
         }
-        for (i = cwCnt - 1; i > 0; i--) {
-            /* add "carries" */
-            codeWords[cwNdx + i - 1] += codeWords[cwNdx + i] / 928;
-            codeWords[cwNdx + i] %= 928;
+        for (i = cwCnt - 1; i >= 0; i--) {
+            codeWords[cwNdx + i] = (UINT) large_div_u64(&t, 928);
         }
     }
     return (cwLng);
 }
 
 /* CC-A 2D component */
-static int cc_a(struct zint_symbol *symbol, const char source[], const int cc_width) {
-    int i, segment, bitlen, cwCnt, variant, rows;
+static int cc_a(struct zint_symbol *symbol, const unsigned char source[], const int bitlen, const int cc_width) {
+    int i, cwCnt, variant, rows;
     int k, offset, j, total, rsCodeWords[8] = {0};
     int LeftRAPStart, RightRAPStart, CentreRAPStart, StartCluster;
     int LeftRAP, RightRAP, CentreRAP, Cluster;
     int loop;
     UINT codeWords[28] = {0};
-    UINT bitStr[13] = {0};
-    char pattern[580];
+    unsigned char pattern[(580 + 7) / 8];
+    struct zint_bits bits;
     int bp = 0;
 
     variant = 0;
 
-    bitlen = (int)strlen(source);
-
-    for (segment = 0; segment < 13; segment++) {
-        int strpos = segment * 16;
-        if (strpos >= bitlen) {
-            break;
-        }
-        for (i = 0; i < 16 && strpos + i < bitlen; i++) {
-            if (source[strpos + i] == '1') {
-                bitStr[segment] |= (0x8000 >> i);
-            }
-        }
-    }
-
-    /* encode codeWords from bitStr */
-    cwCnt = encode928(bitStr, codeWords, bitlen);
+    /* encode codeWords from packed bit string */
+    cwCnt = encode928(source, codeWords, bitlen);
 
     switch (cc_width) {
         case 2:
@@ -229,39 +213,40 @@ static int cc_a(struct zint_symbol *symbol, const char source[], const int cc_wi
     Cluster = StartCluster; /* Cluster can be 0, 1 or 2 for Cluster(0), Cluster(3) and Cluster(6) */
 
     for (i = 0; i < rows; i++) {
-        bp = 0;
+        bits_init(&bits, pattern, 0);
         offset = 929 * Cluster;
         k = i * cc_width;
         /* Copy the data into codebarre */
         if (cc_width != 3) {
-            bp = bin_append_posn(rap_side[LeftRAP - 1], 10, pattern, bp);
+            bits_append(&bits, rap_side[LeftRAP - 1], 10);
         }
-        bp = bin_append_posn(pdf_bitpattern[offset + codeWords[k]], 16, pattern, bp);
-        pattern[bp++] = '0';
+        bits_append(&bits, pdf_bitpattern[offset + codeWords[k]], 16);
+        bits_append(&bits, 0, 1);
         if (cc_width >= 2) {
             if (cc_width == 3) {
-                bp = bin_append_posn(rap_centre[CentreRAP - 1], 10, pattern, bp);
+                bits_append(&bits, rap_centre[CentreRAP - 1], 10);
             }
-            bp = bin_append_posn(pdf_bitpattern[offset + codeWords[k + 1]], 16, pattern, bp);
-            pattern[bp++] = '0';
+            bits_append(&bits, pdf_bitpattern[offset + codeWords[k + 1]], 16);
+            bits_append(&bits, 0, 1);
             if (cc_width >= 3) {
                 if (cc_width == 4) {
-                    bp = bin_append_posn(rap_centre[CentreRAP - 1], 10, pattern, bp);
+                    bits_append(&bits, rap_centre[CentreRAP - 1], 10);
                 }
-                bp = bin_append_posn(pdf_bitpattern[offset + codeWords[k + 2]], 16, pattern, bp);
-                pattern[bp++] = '0';
+                bits_append(&bits, pdf_bitpattern[offset + codeWords[k + 2]], 16);
+                bits_append(&bits, 0, 1);
                 if (cc_width == 4) {
-                    bp = bin_append_posn(pdf_bitpattern[offset + codeWords[k + 3]], 16, pattern, bp);
-                    pattern[bp++] = '0';
+                    bits_append(&bits, pdf_bitpattern[offset + codeWords[k + 3]], 16);
+                    bits_append(&bits, 0, 1);
                 }
             }
         }
-        bp = bin_append_posn(rap_side[RightRAP - 1], 10, pattern, bp);
-        pattern[bp++] = '1'; /* stop */
+        bits_append(&bits, rap_side[RightRAP - 1], 10);
+        bits_append(&bits, 1, 1); /* stop */
 
-        /* so now pattern[] holds the string of '1's and '0's. - copy this to the symbol */
+        /* so now pattern[] holds the packed bits - copy this to the symbol */
+        bp = bits_flush(&bits);
         for (loop = 0; loop < bp; loop++) {
-            if (pattern[loop] == '1') {
+            if (bits_is_set(pattern, loop)) {
                 set_module(symbol, i, loop);
             }
         }
@@ -297,34 +282,26 @@ static int cc_a(struct zint_symbol *symbol, const char source[], const int cc_wi
 }
 
 /* CC-B 2D component */
-static int cc_b(struct zint_symbol *symbol, const char source[], const int cc_width) {
-    int length = (int) strlen(source) / 8;
+static int cc_b(struct zint_symbol *symbol, const unsigned char source[], const int bitlen, const int cc_width) {
+    int length = bitlen / 8;
     int i;
-#ifndef _MSC_VER
-    unsigned char data_string[length + 3];
-#else
-    unsigned char *data_string = (unsigned char *) _alloca(length + 3);
-#endif
+    z_work_array(symbol, unsigned char, data_string, length + 3);
     int chainemc[180], mclength;
-    int k, j, p, longueur, mccorrection[50] = {0}, offset;
+    int k, j, longueur, mccorrection[50] = {0}, offset;
     int total;
-    char pattern[580];
+    unsigned char pattern[(580 + 7) / 8];
+    struct zint_bits bits;
     int variant, LeftRAPStart, CentreRAPStart, RightRAPStart, StartCluster;
     int LeftRAP, CentreRAP, RightRAP, Cluster, loop;
     int columns;
     int bp = 0;
 
-    for (i = 0; i < length; i++) {
-        int binloc = i * 8;
-
-        data_string[i] = 0;
-        for (p = 0; p < 8; p++) {
-            if (source[binloc + p] == '1') {
-                data_string[i] |= (0x80 >> p);
-            }
-        }
+    if (z_work_failed(data_string)) {
+        return z_work_error(symbol);
     }
 
+    memcpy(data_string, source, length);
+
     mclength = 0;
 
     /* "the CC-B component shall have codeword 920 in the first symbol character position" (section 9a) */
@@ -457,37 +434,38 @@ static int cc_b(struct zint_symbol *symbol, const char source[], const int cc_wi
     /* Cluster can be 0, 1 or 2 for Cluster(0), Cluster(3) and Cluster(6) */
 
     for (i = 0; i < symbol->rows; i++) {
-        bp = 0;
+        bits_init(&bits, pattern, 0);
         offset = 929 * Cluster;
         k = i * columns;
         /* Copy the data into codebarre */
-        bp = bin_append_posn(rap_side[LeftRAP - 1], 10, pattern, bp);
-        bp = bin_append_posn(pdf_bitpattern[offset + chainemc[k]], 16, pattern, bp);
-        pattern[bp++] = '0';
+        bits_append(&bits, rap_side[LeftRAP - 1], 10);
+        bits_append(&bits, pdf_bitpattern[offset + chainemc[k]], 16);
+        bits_append(&bits, 0, 1);
         if (cc_width >= 2) {
             if (cc_width == 3) {
-                bp = bin_append_posn(rap_centre[CentreRAP - 1], 10, pattern, bp);
+                bits_append(&bits, rap_centre[CentreRAP - 1], 10);
             }
-            bp = bin_append_posn(pdf_bitpattern[offset + chainemc[k + 1]], 16, pattern, bp);
-            pattern[bp++] = '0';
+            bits_append(&bits, pdf_bitpattern[offset + chainemc[k + 1]], 16);
+            bits_append(&bits, 0, 1);
             if (cc_width >= 3) {
                 if (cc_width == 4) {
-                    bp = bin_append_posn(rap_centre[CentreRAP - 1], 10, pattern, bp);
+                    bits_append(&bits, rap_centre[CentreRAP - 1], 10);
                 }
-                bp = bin_append_posn(pdf_bitpattern[offset + chainemc[k + 2]], 16, pattern, bp);
-                pattern[bp++] = '0';
+                bits_append(&bits, pdf_bitpattern[offset + chainemc[k + 2]], 16);
+                bits_append(&bits, 0, 1);
                 if (cc_width == 4) {
-                    bp = bin_append_posn(pdf_bitpattern[offset + chainemc[k + 3]], 16, pattern, bp);
-                    pattern[bp++] = '0';
+                    bits_append(&bits, pdf_bitpattern[offset + chainemc[k + 3]], 16);
+                    bits_append(&bits, 0, 1);
                 }
             }
         }
-        bp = bin_append_posn(rap_side[RightRAP - 1], 10, pattern, bp);
-        pattern[bp++] = '1'; /* stop */
+        bits_append(&bits, rap_side[RightRAP - 1], 10);
+        bits_append(&bits, 1, 1); /* stop */
 
-        /* so now pattern[] holds the string of '1's and '0's. - copy this to the symbol */
+        /* so now pattern[] holds the packed bits - copy this to the symbol */
+        bp = bits_flush(&bits);
         for (loop = 0; loop < bp; loop++) {
-            if (pattern[loop] == '1') {
+            if (bits_is_set(pattern, loop)) {
                 set_module(symbol, i, loop);
             }
         }
@@ -522,31 +500,24 @@ static int cc_b(struct zint_symbol *symbol, const char source[], const int cc_wi
 }
 
 /* CC-C 2D component - byte compressed PDF417 */
-static int cc_c(struct zint_symbol *symbol, const char source[], const int cc_width, const int ecc_level) {
-    int length = (int) strlen(source) / 8;
-    int i, p;
-#ifndef _MSC_VER
-    unsigned char data_string[length + 4];
-#else
-    unsigned char *data_string = (unsigned char *) _alloca(length + 4);
-#endif
+static int cc_c(struct zint_symbol *symbol, const unsigned char source[], const int bitlen, const int cc_width,
+            const int ecc_level) {
+    int length = bitlen / 8;
+    int i;
+    z_work_array(symbol, unsigned char, data_string, length + 4);
     int chainemc[1000], mclength, k;
     int offset, longueur, loop, total, j, mccorrection[520] = {0};
     int c1, c2, c3, dummy[35];
-    char pattern[580];
+    unsigned char pattern[(580 + 7) / 8];
+    struct zint_bits bits;
     int bp = 0;
 
-    for (i = 0; i < length; i++) {
-        int binloc = i * 8;
-
-        data_string[i] = 0;
-        for (p = 0; p < 8; p++) {
-            if (source[binloc + p] == '1') {
-                data_string[i] |= (0x80 >> p);
-            }
-        }
+    if (z_work_failed(data_string)) {
+        return z_work_error(symbol);
     }
 
+    memcpy(data_string, source, length);
+
     mclength = 0;
 
     chainemc[mclength] = 0; /* space for length descriptor */
@@ -637,17 +608,18 @@ static int cc_c(struct zint_symbol *symbol, const char source[], const int cc_wi
                 offset = 1858; /* cluster(6) */
                 break;
         }
-        bp = 0;
-        bp = bin_append_posn(0x1FEA8, 17, pattern, bp); /* Row start */
+        bits_init(&bits, pattern, 0);
+        bits_append(&bits, 0x1FEA8, 17); /* Row start */
 
         for (j = 0; j <= cc_width + 1; j++) {
-            bp = bin_append_posn(pdf_bitpattern[offset + dummy[j]], 16, pattern, bp);
-            pattern[bp++] = '0';
+            bits_append(&bits, pdf_bitpattern[offset + dummy[j]], 16);
+            bits_append(&bits, 0, 1);
         }
-        bp = bin_append_posn(0x3FA29, 18, pattern, bp); /* Row Stop */
+        bits_append(&bits, 0x3FA29, 18); /* Row Stop */
 
+        bp = bits_flush(&bits);
         for (loop = 0; loop < bp; loop++) {
-            if (pattern[loop] == '1') {
+            if (bits_is_set(pattern, loop)) {
                 set_module(symbol, i, loop);
             }
         }
@@ -853,23 +825,40 @@ static int calc_padding_ccc(const int binary_length, int *cc_width, const int li
     return target_bitsize;
 }
 
-/* Handles all data encodation from section 5 of ISO/IEC 24723 */
+/* Padded bit size for 2D component type `cc_mode`, 0 if `binary_length` doesn't fit (sets `cc_width` & `ecc` if
+   CC-C) */
+static int calc_padding(const int binary_length, const int cc_mode, int *cc_width, const int lin_width, int *ecc) {
+    if (cc_mode == 1) {
+        return calc_padding_cca(binary_length, *cc_width);
+    }
+    if (cc_mode == 2) {
+        return calc_padding_ccb(binary_length, *cc_width);
+    }
+    return calc_padding_ccc(binary_length, cc_width, lin_width, ecc);
+}
+
+/* Handles all data encodation from section 5 of ISO/IEC 24723. The bit string doesn't depend on the 2D component
+   type, so it's encoded once and the smallest type from `*p_cc_mode` on that fits is selected from the capacity
+   tables, escalating CC-A to CC-B, and CC-B to CC-C if the linear component is GS1-128 */
 static int cc_binary_string(struct zint_symbol *symbol, const unsigned char source[], const int source_len,
-            char binary_string[], const int cc_mode, int *cc_width, int *ecc, const int lin_width) {
+            unsigned char binary_string[], int *p_bin_len, int *p_cc_mode, int *cc_width, int *ecc,
+            const int lin_width) {
+    int cc_mode, max_cc_mode;
+    const char *too_long_errtxt = NULL;
     int encoding_method, read_posn, alpha_pad;
     int i, j, ai_crop, ai_crop_posn, fnc1_latch;
     int ai90_mode, remainder;
     char last_digit = '\0';
     int mode;
-#ifndef _MSC_VER
-    char general_field[source_len + 1];
-#else
-    char *general_field = (char *) _alloca(source_len + 1);
-#endif
+    z_work_array(symbol, char, general_field, source_len + 1);
     int target_bitsize;
-    int bp = 0;
+    struct zint_bits bits;
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
 
+    if (z_work_failed(general_field)) {
+        return z_work_error(symbol);
+    }
+
     encoding_method = 1;
     read_posn = 0;
     ai_crop = 0;
@@ -879,6 +868,7 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
     *ecc = 0;
     target_bitsize = 0;
     mode = NUMERIC;
+    bits_init(&bits, binary_string, 0);
 
     if ((source[0] == '1') && ((source[1] == '0') || (source[1] == '1') || (source[1] == '7'))) {
         /* Source starts (10), (11) or (17) */
@@ -891,29 +881,29 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
     }
 
     if (encoding_method == 1) {
-        binary_string[bp++] = '0';
-        if (debug) printf("CC-%c Encodation Method: 0\n", 'A' + (cc_mode - 1));
+        bits_append(&bits, 0, 1);
+        if (debug) printf("CC Encodation Method: 0\n");
 
     } else if (encoding_method == 2) {
         /* Encoding Method field "10" - date and lot number */
 
-        bp = bin_append_posn(2, 2, binary_string, bp); /* "10" */
+        bits_append(&bits, 2, 2); /* "10" */
 
         if (source[1] == '0') {
             /* No date data */
-            bp = bin_append_posn(3, 2, binary_string, bp); /* "11" */
+            bits_append(&bits, 3, 2); /* "11" */
             read_posn = 2;
         } else {
             /* Production Date (11) or Expiration Date (17) */
 
-            bp = bin_append_posn(rss_date(source, 2), 16, binary_string, bp);
+            bits_append(&bits, rss_date(source, 2), 16);
 
             if (source[1] == '1') {
                 /* Production Date AI 11 */
-                binary_string[bp++] = '0';
+                bits_append(&bits, 0, 1);
             } else {
                 /* Expiration Date AI 17 */
-                binary_string[bp++] = '1';
+                bits_append(&bits, 1, 1);
             }
             read_posn = 8;
 
@@ -929,24 +919,24 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
                 /* So still need FNC1 character but can't do single FNC1 in numeric mode, so insert alphanumeric latch
                    "0000" and alphanumeric FNC1 "01111" (this implementation detail taken from BWIPP
                    https://github.com/bwipp/postscriptbarcode Copyright (c) 2004-2019 Terry Burton) */
-                bp = bin_append_posn(15, 9, binary_string, bp); /* "000001111" */
+                bits_append(&bits, 15, 9); /* "000001111" */
                 /* Note an alphanumeric FNC1 is also a numeric latch, so now in numeric mode */
             }
         }
 
         if (debug) {
-            printf("CC-%c Encodation Method: 10, Compaction Field: %.*s\n", 'A' + (cc_mode - 1), read_posn, source);
+            printf("CC Encodation Method: 10, Compaction Field: %.*s\n", read_posn, source);
         }
 
     } else if (encoding_method == 3) {
         /* Encodation Method field of "11" - AI 90 */
-#ifndef _MSC_VER
-        char ninety[source_len + 1];
-#else
-        char *ninety = (char *) _alloca(source_len + 1);
-#endif
+        z_work_array(symbol, char, ninety, source_len + 1);
         int ninety_len, alpha, alphanum, numeric, test1, test2, test3;
 
+        if (z_work_failed(ninety)) {
+            return z_work_error(symbol);
+        }
+
         /* "This encodation method may be used if an element string with an AI
         90 occurs at the start of the data message, and if the data field
         following the two-digit AI 90 starts with an alphanumeric string which
@@ -1007,7 +997,7 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
             int numeric_value;
             int table3_letter;
             /* Encodation method "11" can be used */
-            bp = bin_append_posn(3, 2, binary_string, bp); /* "11" */
+            bits_append(&bits, 3, 2); /* "11" */
 
             numeric -= test1;
             alpha--;
@@ -1017,17 +1007,17 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
 
             if (alphanum == 0 && alpha > numeric) {
                 /* Alpha mode */
-                bp = bin_append_posn(3, 2, binary_string, bp); /* "11" */
+                bits_append(&bits, 3, 2); /* "11" */
                 ai90_mode = 2;
             } else if (alphanum == 0 && alpha == 0) {
                 /* Numeric mode */
-                bp = bin_append_posn(2, 2, binary_string, bp); /* "10" */
+                bits_append(&bits, 2, 2); /* "10" */
                 ai90_mode = 3;
             } else {
                 /* Note if first 4 are digits then it would be shorter to go into NUMERIC mode first; not
                    implemented */
                 /* Alphanumeric mode */
-                binary_string[bp++] = '0';
+                bits_append(&bits, 0, 1);
                 ai90_mode = 1;
                 mode = ALPHANUMERIC;
             }
@@ -1049,12 +1039,12 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
             }
 
             switch (ai_crop) {
-                case 0: binary_string[bp++] = '0';
+                case 0: bits_append(&bits, 0, 1);
                     break;
-                case 1: bp = bin_append_posn(2, 2, binary_string, bp); /* "10" */
+                case 1: bits_append(&bits, 2, 2); /* "10" */
                     ai_crop_posn = next_ai_posn + 1;
                     break;
-                case 3: bp = bin_append_posn(3, 2, binary_string, bp); /* "11" */
+                case 3: bits_append(&bits, 3, 2); /* "11" */
                     ai_crop_posn = next_ai_posn + 1;
                     break;
             }
@@ -1078,18 +1068,18 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
             if (table3_letter != -1) {
                 /* Encoding can be done according to 5.3.2 c) 2) */
                 /* five bit binary string representing value before letter */
-                bp = bin_append_posn(numeric_value, 5, binary_string, bp);
+                bits_append(&bits, numeric_value, 5);
 
                 /* followed by four bit representation of letter from Table 3 */
-                bp = bin_append_posn(table3_letter, 4, binary_string, bp);
+                bits_append(&bits, table3_letter, 4);
             } else {
                 /* Encoding is done according to 5.3.2 c) 3) */
-                bp = bin_append_posn(31, 5, binary_string, bp);
+                bits_append(&bits, 31, 5);
                 /* ten bit representation of number */
-                bp = bin_append_posn(numeric_value, 10, binary_string, bp);
+                bits_append(&bits, numeric_value, 10);
 
                 /* five bit representation of ASCII character */
-                bp = bin_append_posn(ninety[test1] - 65, 5, binary_string, bp);
+                bits_append(&bits, ninety[test1] - 65, 5);
             }
 
             read_posn = test1 + 3;
@@ -1099,13 +1089,13 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
                 /* Alpha encodation (section 5.3.3) */
                 do {
                     if ((source[read_posn] >= 'A') && (source[read_posn] <= 'Z')) {
-                        bp = bin_append_posn(source[read_posn] - 65, 5, binary_string, bp);
+                        bits_append(&bits, source[read_posn] - 65, 5);
 
                     } else if ((source[read_posn] >= '0') && (source[read_posn] <= '9')) {
-                        bp = bin_append_posn(source[read_posn] + 4, 6, binary_string, bp);
+                        bits_append(&bits, source[read_posn] + 4, 6);
 
                     } else if (source[read_posn] == '[') {
-                        bp = bin_append_posn(31, 5, binary_string, bp);
+                        bits_append(&bits, 31, 5);
                     }
 
                     read_posn++;
@@ -1114,14 +1104,16 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
             }
 
             if (debug) {
-                printf("CC-%c Encodation Method: 11, Compaction Field: %.*s, Binary: %.*s (%d)\n",
-                        'A' + (cc_mode - 1), read_posn, source, bp, binary_string, bp);
+                (void) bits_flush(&bits);
+                printf("CC Encodation Method: 11, Compaction Field: %.*s, Binary: ", read_posn, source);
+                bits_print(binary_string, 0, bits.posn);
+                printf(" (%d)\n", bits.posn);
             }
         } else {
             /* Use general field encodation instead */
-            binary_string[bp++] = '0';
+            bits_append(&bits, 0, 1);
             read_posn = 0;
-            if (debug) printf("CC-%c Encodation Method: 0\n", 'A' + (cc_mode - 1));
+            if (debug) printf("CC Encodation Method: 0\n");
         }
     }
 
@@ -1156,31 +1148,37 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
     if (j != 0) { /* If general field not empty */
         alpha_pad = 0;
 
-        if (!general_field_encode(general_field, j, &mode, &last_digit, binary_string, &bp)) {
+        if (!general_field_encode(general_field, j, &mode, &last_digit, &bits)) {
             /* Invalid characters in input data */
             strcpy(symbol->errtxt, "441: Invalid characters in input data");
             return ZINT_ERROR_INVALID_DATA;
         }
     }
 
-    switch (cc_mode) {
-        case 1:
-            target_bitsize = calc_padding_cca(bp, *(cc_width));
-            break;
-        case 2:
-            target_bitsize = calc_padding_ccb(bp, *(cc_width));
-            break;
-        case 3:
-            target_bitsize = calc_padding_ccc(bp, cc_width, lin_width, ecc);
+    max_cc_mode = symbol->symbology == BARCODE_GS1_128_CC ? 3 : 2;
+    for (cc_mode = *p_cc_mode; cc_mode <= max_cc_mode; cc_mode++) {
+        target_bitsize = calc_padding(bits.posn, cc_mode, cc_width, lin_width, ecc);
+        if (target_bitsize == 0) {
+            too_long_errtxt = "442: Input too long for selected 2D component";
+        } else if (last_digit && (target_bitsize - bits.posn < 4 || target_bitsize - bits.posn > 6)) {
+            /* The last digit will take 7 bits (see below), which may push the symbol up to the next size */
+            target_bitsize = calc_padding(bits.posn + 7, cc_mode, cc_width, lin_width, ecc);
+            if (target_bitsize == 0) {
+                too_long_errtxt = "444: Input too long for selected 2D component";
+            }
+        }
+        if (target_bitsize) {
             break;
+        }
     }
 
     if (target_bitsize == 0) {
-        strcpy(symbol->errtxt, "442: Input too long for selected 2D component");
+        strcpy(symbol->errtxt, too_long_errtxt);
         return ZINT_ERROR_TOO_LONG;
     }
+    *p_cc_mode = cc_mode;
 
-    remainder = target_bitsize - bp;
+    remainder = target_bitsize - bits.posn;
 
     if (last_digit) {
         /* There is still one more numeric digit to encode */
@@ -1188,100 +1186,80 @@ static int cc_binary_string(struct zint_symbol *symbol, const unsigned char sour
         if ((remainder >= 4) && (remainder <= 6)) {
             /* ISO/IEC 24723:2010 5.4.1 c) 2) "If four to six bits remain, add 1 to the digit value and encode the
                result in the next four bits. ..." */
-            bp = bin_append_posn(ctoi(last_digit) + 1, 4, binary_string, bp);
+            bits_append(&bits, ctoi(last_digit) + 1, 4);
             if (remainder > 4) {
                 /* "... The fifth and sixth bits, if present, shall be “0”s." (Covered by adding truncated
                    alphanumeric latch below but do explicitly anyway) */
-                bp = bin_append_posn(0, remainder - 4, binary_string, bp);
+                bits_append(&bits, 0, remainder - 4);
             }
         } else {
-            bp = bin_append_posn((11 * ctoi(last_digit)) + 18, 7, binary_string, bp);
+            bits_append(&bits, (11 * ctoi(last_digit)) + 18, 7);
             /* This may push the symbol up to the next size */
         }
     }
 
-    if (bp > 11805) { /* (2361 * 5) */
+    if (bits.posn > 11805) { /* (2361 * 5) */
         strcpy(symbol->errtxt, "443: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
 
-    switch (cc_mode) {
-        case 1:
-            target_bitsize = calc_padding_cca(bp, *(cc_width));
-            break;
-        case 2:
-            target_bitsize = calc_padding_ccb(bp, *(cc_width));
-            break;
-        case 3:
-            target_bitsize = calc_padding_ccc(bp, cc_width, lin_width, ecc);
-            break;
-    }
-
-    if (target_bitsize == 0) {
-        strcpy(symbol->errtxt, "444: Input too long for selected 2D component");
-        return ZINT_ERROR_TOO_LONG;
-    }
-
-    if (bp < target_bitsize) {
+    if (bits.posn < target_bitsize) {
         /* Now add padding to binary string */
         if (alpha_pad == 1) {
-            bp = bin_append_posn(31, 5, binary_string, bp); /* "11111" */
+            bits_append(&bits, 31, 5); /* "11111" */
             /* Extra FNC1 character required after Alpha encodation (section 5.3.3) */
         }
 
         if (mode == NUMERIC) {
-            bp = bin_append_posn(0, 4, binary_string, bp); /* "0000" */
+            bits_append(&bits, 0, 4); /* "0000" */
         }
 
-        while (bp < target_bitsize) {
-            bp = bin_append_posn(4, 5, binary_string, bp); /* "00100" */
+        while (bits.posn < target_bitsize) {
+            bits_append(&bits, 4, 5); /* "00100" */
         }
     }
-    binary_string[target_bitsize] = '\0';
+    (void) bits_flush(&bits);
+    *p_bin_len = target_bitsize; /* Any excess padding bits are ignored */
 
     if (debug) {
-        printf("ECC: %d, CC width %d\n", *ecc, *cc_width);
-        printf("Binary: %s (%d)\n", binary_string, target_bitsize);
+        printf("CC-%c, ECC: %d, CC width %d\n", 'A' + (cc_mode - 1), *ecc, *cc_width);
+        fputs("Binary: ", stdout);
+        bits_print(binary_string, 0, target_bitsize);
+        printf(" (%d)\n", target_bitsize);
     }
 
     return 0;
 }
 
-static int linear_dummy_run(int input_mode, unsigned char *source, const int length, char *errtxt) {
-    struct zint_symbol *dummy;
-    int error_number;
-    int linear_width;
-
-    dummy = ZBarcode_Create();
-    dummy->symbology = BARCODE_GS1_128_CC;
-    dummy->input_mode = input_mode;
-    dummy->option_1 = 3;
-    error_number = ean_128(dummy, source, length);
-    linear_width = dummy->width;
-    if (error_number >= ZINT_ERROR) {
-        strcpy(errtxt, dummy->errtxt);
-    }
-    ZBarcode_Delete(dummy);
+/* Create the linear component symbol, `option_1` being its component linkage setting */
+static struct zint_symbol *linear_create(const struct zint_symbol *symbol, const int option_1) {
+    struct zint_symbol *linear = ZBarcode_Create_Allocator(z_allocator(symbol));
 
-    if (error_number >= ZINT_ERROR) {
-        return 0;
-    }
-    return linear_width;
+    linear->symbology = symbol->symbology;
+    linear->input_mode = symbol->input_mode;
+    linear->option_1 = option_1;
+    linear->option_2 = symbol->option_2;
+    linear->debug = symbol->debug;
+
+    return linear;
 }
 
 INTERNAL int composite(struct zint_symbol *symbol, unsigned char source[], int length) {
     int error_number, cc_mode, cc_width = 0, ecc_level = 0;
-    int j, i, k;
-    unsigned int bs = 13 * length + 500 + 1; /* Allow for 8 bits + 5-bit latch per char + 500 bits overhead/padding */
-#ifndef _MSC_VER
-    char binary_string[bs];
-#else
-    char *binary_string = (char *) _alloca(bs);
-#endif
+    int j, i, k, bin_len;
+    /* Allow for 8 bits + 5-bit latch per char + 500 bits overhead/padding, but at least enough for a minimum size
+       (3-row, 30-column) CC-C, which may be padded to 752 bits however little data */
+    unsigned int bs = 13 * length + 500 + 1 > 752 + 1 ? 13 * length + 500 + 1 : 752 + 1;
+    z_work_array(symbol, unsigned char, binary_string, (bs + 7) / 8);
     unsigned int pri_len;
-    struct zint_symbol *linear;
+    struct zint_symbol *linear = NULL;
     int top_shift, bottom_shift;
     int linear_width = 0;
+    int linear_warn = 0;
+
+    if (z_work_failed(binary_string)) {
+        return z_work_error(symbol);
+    }
 
     /* Perform sanity checks on input options first */
     error_number = 0;
@@ -1304,12 +1282,18 @@ INTERNAL int composite(struct zint_symbol *symbol, unsigned char source[], int l
     }
 
     if (symbol->symbology == BARCODE_GS1_128_CC) {
-        /* Do a test run of encoding the linear component to establish its width */
-        linear_width = linear_dummy_run(symbol->input_mode, (unsigned char *) symbol->primary, pri_len, symbol->errtxt);
-        if (linear_width == 0) {
+        /* Encode the linear component first to establish its width, which the 2D component depends on. The width
+           doesn't depend on the linkage flag, so link provisionally for the requested mode, re-encoding below only
+           if CC-A/B had to be escalated to CC-C */
+        linear = linear_create(symbol, cc_mode == 3 ? 3 : 1);
+        linear_warn = ean_128(linear, (unsigned char *) symbol->primary, pri_len);
+        if (linear_warn >= ZINT_ERROR) {
+            strcpy(symbol->errtxt, linear->errtxt);
             strcat(symbol->errtxt, " in linear component");
+            ZBarcode_Delete(linear);
             return ZINT_ERROR_INVALID_DATA;
         }
+        linear_width = linear->width;
         if (symbol->debug & ZINT_DEBUG_PRINT) {
             printf("GS1-128 linear width: %d\n", linear_width);
         }
@@ -1377,87 +1361,64 @@ INTERNAL int composite(struct zint_symbol *symbol, unsigned char source[], int l
         cc_mode = 1;
     }
 
-    if (cc_mode == 1) {
-        i = cc_binary_string(symbol, source, length, binary_string, cc_mode, &cc_width, &ecc_level, linear_width);
-        if (i == ZINT_ERROR_TOO_LONG) {
-            cc_mode = 2;
-        } else if (i != 0) {
-            return i;
-        }
-    }
-
-    if (cc_mode == 2) {
-        /* If the data didn't fit into CC-A it is recalculated for CC-B */
-        i = cc_binary_string(symbol, source, length, binary_string, cc_mode, &cc_width, &ecc_level, linear_width);
-        if (i == ZINT_ERROR_TOO_LONG) {
-            if (symbol->symbology != BARCODE_GS1_128_CC) {
-                return ZINT_ERROR_TOO_LONG;
-            }
-            cc_mode = 3;
-        } else if (i != 0) {
-            return i;
-        }
-    }
-
-    if (cc_mode == 3) {
-        /* If the data didn't fit in CC-B (and linear part is GS1-128) it is recalculated for CC-C */
-        i = cc_binary_string(symbol, source, length, binary_string, cc_mode, &cc_width, &ecc_level, linear_width);
-        if (i != 0) {
-            return i;
-        }
+    /* Selects CC-A, CC-B or CC-C (escalating from `cc_mode` if the data doesn't fit) */
+    i = cc_binary_string(symbol, source, length, binary_string, &bin_len, &cc_mode, &cc_width, &ecc_level,
+            linear_width);
+    if (i != 0) {
+        ZBarcode_Delete(linear);
+        return i;
     }
 
     switch (cc_mode) {
             /* Note that ecc_level is only relevant to CC-C */
-        case 1: error_number = cc_a(symbol, binary_string, cc_width);
+        case 1: error_number = cc_a(symbol, binary_string, bin_len, cc_width);
             break;
-        case 2: error_number = cc_b(symbol, binary_string, cc_width);
+        case 2: error_number = cc_b(symbol, binary_string, bin_len, cc_width);
             break;
-        case 3: error_number = cc_c(symbol, binary_string, cc_width, ecc_level);
+        case 3: error_number = cc_c(symbol, binary_string, bin_len, cc_width, ecc_level);
             break;
     }
 
     if (error_number != 0) {
+        ZBarcode_Delete(linear);
         return ZINT_ERROR_ENCODING_PROBLEM;
     }
 
     /* 2D component done, now calculate linear component */
-    linear = ZBarcode_Create(); /* Symbol contains the 2D component and Linear contains the rest */
-
-    linear->symbology = symbol->symbology;
-    linear->input_mode = symbol->input_mode;
-    linear->option_2 = symbol->option_2;
-    linear->debug = symbol->debug;
-
-    if (linear->symbology != BARCODE_GS1_128_CC) {
-        /* Set the "component linkage" flag in the linear component */
-        linear->option_1 = 2;
+    if (symbol->symbology == BARCODE_GS1_128_CC) {
+        /* Already encoded above - redo only if the linkage flag differs (i.e. CC-A/B escalated to CC-C) */
+        if ((linear->option_1 == 3) != (cc_mode == 3)) {
+            ZBarcode_Clear(linear);
+            /* GS1-128 needs to know which type of 2D component is used */
+            linear->option_1 = cc_mode;
+            linear_warn = ean_128(linear, (unsigned char *) symbol->primary, pri_len);
+        }
+        error_number = linear_warn;
     } else {
-        /* GS1-128 needs to know which type of 2D component is used */
-        linear->option_1 = cc_mode;
-    }
+        /* Symbol contains the 2D component and Linear contains the rest */
+        linear = linear_create(symbol, 2 /* Set the "component linkage" flag in the linear component */);
 
-    switch (symbol->symbology) {
-        case BARCODE_EANX_CC: error_number = eanx(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
-        case BARCODE_GS1_128_CC: error_number = ean_128(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
-        case BARCODE_DBAR_OMN_CC: error_number = rss14(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
-        case BARCODE_DBAR_LTD_CC: error_number = rsslimited(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
-        case BARCODE_DBAR_EXP_CC: error_number = rssexpanded(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
-        case BARCODE_UPCA_CC: error_number = eanx(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
-        case BARCODE_UPCE_CC: error_number = eanx(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
-        case BARCODE_DBAR_STK_CC: error_number = rss14(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
-        case BARCODE_DBAR_OMNSTK_CC: error_number = rss14(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
-        case BARCODE_DBAR_EXPSTK_CC: error_number = rssexpanded(linear, (unsigned char *) symbol->primary, pri_len);
-            break;
+        switch (symbol->symbology) {
+            case BARCODE_EANX_CC: error_number = eanx(linear, (unsigned char *) symbol->primary, pri_len);
+                break;
+            case BARCODE_DBAR_OMN_CC: error_number = rss14(linear, (unsigned char *) symbol->primary, pri_len);
+                break;
+            case BARCODE_DBAR_LTD_CC: error_number = rsslimited(linear, (unsigned char *) symbol->primary, pri_len);
+                break;
+            case BARCODE_DBAR_EXP_CC: error_number = rssexpanded(linear, (unsigned char *) symbol->primary, pri_len);
+                break;
+            case BARCODE_UPCA_CC: error_number = eanx(linear, (unsigned char *) symbol->primary, pri_len);
+                break;
+            case BARCODE_UPCE_CC: error_number = eanx(linear, (unsigned char *) symbol->primary, pri_len);
+                break;
+            case BARCODE_DBAR_STK_CC: error_number = rss14(linear, (unsigned char *) symbol->primary, pri_len);
+                break;
+            case BARCODE_DBAR_OMNSTK_CC: error_number = rss14(linear, (unsigned char *) symbol->primary, pri_len);
+                break;
+            case BARCODE_DBAR_EXPSTK_CC:
+                error_number = rssexpanded(linear, (unsigned char *) symbol->primary, pri_len);
+                break;
+        }
     }
 
     if (error_number >= ZINT_ERROR) {
@@ -65,76 +65,3 @@ static const char aRAPTable[68] = {
 };
 
 /* Row Address Patterns are as defined in pdf417.h */
-
-/* Generated by tools/gen_pwr928_table.php */
-static const UINT pwr928[69][7] = {
-    {   0,   0,   0,   0,   0,   0,   1, },
-    {   0,   0,   0,   0,   0,   0,   2, },
-    {   0,   0,   0,   0,   0,   0,   4, },
-    {   0,   0,   0,   0,   0,   0,   8, },
-    {   0,   0,   0,   0,   0,   0,  16, },
-    {   0,   0,   0,   0,   0,   0,  32, },
-    {   0,   0,   0,   0,   0,   0,  64, },
-    {   0,   0,   0,   0,   0,   0, 128, },
-    {   0,   0,   0,   0,   0,   0, 256, },
-    {   0,   0,   0,   0,   0,   0, 512, },
-    {   0,   0,   0,   0,   0,   1,  96, },
-    {   0,   0,   0,   0,   0,   2, 192, },
-    {   0,   0,   0,   0,   0,   4, 384, },
-    {   0,   0,   0,   0,   0,   8, 768, },
-    {   0,   0,   0,   0,   0,  17, 608, },
-    {   0,   0,   0,   0,   0,  35, 288, },
-    {   0,   0,   0,   0,   0,  70, 576, },
-    {   0,   0,   0,   0,   0, 141, 224, },
-    {   0,   0,   0,   0,   0, 282, 448, },
-    {   0,   0,   0,   0,   0, 564, 896, },
-    {   0,   0,   0,   0,   1, 201, 864, },
-    {   0,   0,   0,   0,   2, 403, 800, },
-    {   0,   0,   0,   0,   4, 807, 672, },
-    {   0,   0,   0,   0,   9, 687, 416, },
-    {   0,   0,   0,   0,  19, 446, 832, },
-    {   0,   0,   0,   0,  38, 893, 736, },
-    {   0,   0,   0,   0,  77, 859, 544, },
-    {   0,   0,   0,   0, 155, 791, 160, },
-    {   0,   0,   0,   0, 311, 654, 320, },
-    {   0,   0,   0,   0, 623, 380, 640, },
-    {   0,   0,   0,   1, 318, 761, 352, },
-    {   0,   0,   0,   2, 637, 594, 704, },
-    {   0,   0,   0,   5, 347, 261, 480, },
-    {   0,   0,   0,  10, 694, 523,  32, },
-    {   0,   0,   0,  21, 461, 118,  64, },
-    {   0,   0,   0,  42, 922, 236, 128, },
-    {   0,   0,   0,  85, 916, 472, 256, },
-    {   0,   0,   0, 171, 905,  16, 512, },
-    {   0,   0,   0, 343, 882,  33,  96, },
-    {   0,   0,   0, 687, 836,  66, 192, },
-    {   0,   0,   1, 447, 744, 132, 384, },
-    {   0,   0,   2, 895, 560, 264, 768, },
-    {   0,   0,   5, 863, 192, 529, 608, },
-    {   0,   0,  11, 798, 385, 131, 288, },
-    {   0,   0,  23, 668, 770, 262, 576, },
-    {   0,   0,  47, 409, 612, 525, 224, },
-    {   0,   0,  94, 819, 297, 122, 448, },
-    {   0,   0, 189, 710, 594, 244, 896, },
-    {   0,   0, 379, 493, 260, 489, 864, },
-    {   0,   0, 759,  58, 521,  51, 800, },
-    {   0,   1, 590, 117, 114, 103, 672, },
-    {   0,   3, 252, 234, 228, 207, 416, },
-    {   0,   6, 504, 468, 456, 414, 832, },
-    {   0,  13,  81,   8, 912, 829, 736, },
-    {   0,  26, 162,  17, 897, 731, 544, },
-    {   0,  52, 324,  35, 867, 535, 160, },
-    {   0, 104, 648,  71, 807, 142, 320, },
-    {   0, 209, 368, 143, 686, 284, 640, },
-    {   0, 418, 736, 287, 444, 569, 352, },
-    {   0, 837, 544, 574, 889, 210, 704, },
-    {   1, 747, 161, 221, 850, 421, 480, },
-    {   3, 566, 322, 443, 772, 843,  32, },
-    {   7, 204, 644, 887, 617, 758,  64, },
-    {  14, 409, 361, 847, 307, 588, 128, },
-    {  28, 818, 723, 766, 615, 248, 256, },
-    {  57, 709, 519, 605, 302, 496, 512, },
-    { 115, 491, 111, 282, 605,  65,  96, },
-    { 231,  54, 222, 565, 282, 130, 192, },
-    { 462, 108, 445, 202, 564, 260, 384, },
-};
@@ -41,6 +41,7 @@
 
 #include <stdio.h>
 #include <assert.h>
+#include <limits.h>
 #include <math.h>
 #ifdef _MSC_VER
 #include <malloc.h>
@@ -192,68 +193,40 @@ static void ecc200placement(int *array, const int NR, const int NC) {
 /* calculate and append ecc code, and if necessary interleave */
 static void ecc200(unsigned char *binary, const int bytes, const int datablock, const int rsblock, const int skew) {
     int blocks = (bytes + 2) / datablock, b;
-    int rsblocks = rsblock * blocks;
     int n;
     rs_t rs;
 
     rs_init_gf(&rs, 0x12d);
     rs_init_code(&rs, rsblock, 1);
     for (b = 0; b < blocks; b++) {
-        unsigned char buf[256], ecc[256];
-        int p = 0;
-        for (n = b; n < bytes; n += blocks)
-            buf[p++] = binary[n];
-        rs_encode(&rs, p, buf, ecc);
-        p = rsblock - 1; // comes back reversed
-        for (n = b; n < rsblocks; n += blocks) {
-            if (skew) {
-                /* Rotate ecc data to make 144x144 size symbols acceptable */
-                /* See http://groups.google.com/group/postscriptbarcode/msg/5ae8fda7757477da */
-                if (b < 8) {
-                    binary[bytes + n + 2] = ecc[p--];
-                } else {
-                    binary[bytes + n - 8] = ecc[p--];
-                }
+        const int p = (bytes - b + blocks - 1) / blocks; /* Data codewords of this block (every `blocks`th) */
+        n = bytes + b;
+        if (skew) {
+            /* Rotate ecc data to make 144x144 size symbols acceptable */
+            /* See http://groups.google.com/group/postscriptbarcode/msg/5ae8fda7757477da */
+            if (b < 8) {
+                n += 2;
             } else {
-                binary[bytes + n] = ecc[p--];
+                n -= 8;
             }
         }
+        rs_encode_step(&rs, p, binary + b, blocks, binary + n, blocks);
     }
 }
 
 /* Is basic (non-shifted) C40? */
-static int isc40(const unsigned char input) {
-    if ((input >= '0' && input <= '9') || (input >= 'A' && input <= 'Z') || input == ' ') {
-        return 1;
-    }
-    return 0;
-}
+#define isc40(input) is_chr(CHR_C40, input)
 
 /* Is basic (non-shifted) TEXT? */
-static int istext(const unsigned char input) {
-    if ((input >= '0' && input <= '9') || (input >= 'a' && input <= 'z') || input == ' ') {
-        return 1;
-    }
-    return 0;
-}
+#define istext(input) is_chr(CHR_TEXT, input)
 
 /* Is basic (non-shifted) C40/TEXT? */
 static int isc40text(const int current_mode, const unsigned char input) {
-    return current_mode == DM_C40 ? isc40(input) : istext(input);
+    return is_chr(current_mode == DM_C40 ? CHR_C40 : CHR_TEXT, input);
 }
 
-/* Return true (1) if a character is valid in X12 set */
-static int isX12(const unsigned char input) {
-
-    if (isc40(input)) {
-        return 1;
-    }
-    if (input == 13 || input == '*' || input == '>') {
-        return 1;
-    }
-
-    return 0;
-}
+/* Return true if a character is valid in X12 set */
+#define isX12(input) is_chr(CHR_X12, input)
 
 static int p_r_6_2_1(const unsigned char inputData[], const int position, const int sourcelen) {
     /* Annex P section (r)(6)(ii)(I)
@@ -271,9 +244,10 @@ static int p_r_6_2_1(const unsigned char inputData[], const int position, const
     return 0;
 }
 
-/* 'look ahead test' from Annex P */
+/* 'look ahead test' from Annex P. Sets `*p_horizon` to the furthest position read if greater, or to `sourcelen` if
+   the decision depends on the end of data */
 static int look_ahead_test(const unsigned char inputData[], const int sourcelen, const int position,
-            const int current_mode, const int gs1) {
+            const int current_mode, const int gs1, int *p_horizon) {
     float ascii_count, c40_count, text_count, x12_count, edf_count, b256_count;
     int ascii_rnded, c40_rnded, text_rnded, x12_rnded, edf_rnded, b256_rnded;
     float cnt_1;
@@ -355,7 +329,7 @@ static int look_ahead_test(const unsigned char inputData[], const int sourcelen,
         }
 
         /* edifact ... step (p) */
-        if ((inputData[sp] >= ' ') && (inputData[sp] <= '^')) {
+        if (is_chr(CHR_EDIFACT, inputData[sp])) {
             edf_count += (3.0F / 4.0F); // (p)(1)
         } else {
             if (inputData[sp] > 127) {
@@ -376,6 +350,9 @@ static int look_ahead_test(const unsigned char inputData[], const int sourcelen,
         if (sp >= position + 4) {
             /* At least 5 data characters processed ... step (r) */
             /* NOTE: different than spec, where it's at least 4. Following previous behaviour here (and BWIPP) */
+            if (sp > *p_horizon) {
+                *p_horizon = sp;
+            }
 
             cnt_1 = ascii_count + 1.0f;
             if (cnt_1 <= b256_count && cnt_1 <= edf_count && cnt_1 <= text_count && cnt_1 <= x12_count
@@ -408,6 +385,7 @@ static int look_ahead_test(const unsigned char inputData[], const int sourcelen,
                     return DM_C40; /* step (r)(6)(i) */
                 }
                 if (c40_count == x12_count) {
+                    *p_horizon = sourcelen; /* May read to the end */
                     if (p_r_6_2_1(inputData, sp, sourcelen) == 1) {
                         return DM_X12; /* step (r)(6)(ii)(I) */
                     }
@@ -418,6 +396,7 @@ static int look_ahead_test(const unsigned char inputData[], const int sourcelen,
     }
 
     /* At the end of data ... step (k) */
+    *p_horizon = sourcelen;
     /* step (k)(1) */
     ascii_rnded = (int) ceilf(ascii_count);
     b256_rnded = (int) ceilf(b256_count);
@@ -539,6 +518,18 @@ static int get_symbolsize(struct zint_symbol *symbol, const int minimum) {
     return 0;
 }
 
+/* Version (as `option_2`) of internal symbol size index `symbolsize` */
+static int dm_version(const int symbolsize) {
+    int i;
+
+    for (i = 0; i < DMSIZESCOUNT; i++) {
+        if (intsymbol[i] == symbolsize) {
+            return i + 1;
+        }
+    }
+    return 0; /* Not reached */
+}
+
 /* Number of codewords remaining in a particular version (may be negative) */
 static int codewords_remaining(struct zint_symbol *symbol, const int tp, const int process_p) {
     int symbolsize = get_symbolsize(symbol, tp + process_p); /* Allow for the remaining data characters */
@@ -581,6 +572,295 @@ static int update_b256_field_length(unsigned char target[], int tp, int b256_sta
     return tp;
 }
 
+/* B.2.1 255-state randomising algorithm, applied to the Base 256 field `target[b256_start]` to `target[tp - 1]` */
+static void b256_randomise(unsigned char target[], const int b256_start, const int tp) {
+    int i;
+    int prn = (149 * (b256_start + 1)) % 255; /* Pseudo-random number less 1, stepped by 149 mod 255 */
+
+    for (i = b256_start; i < tp; i++) {
+        target[i] = (unsigned char) ((target[i] + prn + 1) & 0xFF);
+        if ((prn += 149) >= 255) {
+            prn -= 255;
+        }
+    }
+}
+
+/* States of the encoder before a character for `dm_minimal_modes()`: ASCII, C40/TEXT/X12 with 0-2 values pending
+   (i.e. the state + 0, 1 or 2), EDIFACT with 0-3 values pending and Base 256 */
+#define DM_MIN_ASCII    0
+#define DM_MIN_C40      1
+#define DM_MIN_TEXT     4
+#define DM_MIN_X12      7
+#define DM_MIN_EDIFACT  10
+#define DM_MIN_BASE256  14
+#define DM_MIN_STATES   15
+
+#define DM_MIN_NONE     INT_MAX /* Cost of a state not reached */
+
+/* Codewords `dm200encode()` adds at the end of data when in minimal encodation `state` having output `tp`
+   codewords, or -1 if it would backtrack instead (which is costed by unlatching before the incomplete triplet) */
+static int dm_minimal_end_cost(struct zint_symbol *symbol, const int state, const int tp, const unsigned char last) {
+    int pending, symbols_left;
+
+    if (state == DM_MIN_ASCII || state == DM_MIN_BASE256) {
+        return 0;
+    }
+    pending = state < DM_MIN_EDIFACT ? (state - DM_MIN_C40) % 3 : state - DM_MIN_EDIFACT;
+    symbols_left = codewords_remaining(symbol, tp, pending);
+
+    if (state < DM_MIN_X12) { /* C40/TEXT */
+        if (pending == 0) {
+            return symbols_left > 0; /* Unlatch */
+        }
+        if (pending == 2 && symbols_left == 2) {
+            return 2; /* Padded with Shift 1 */
+        }
+        if (pending == 1 && symbols_left <= 2 && isc40text(state < DM_MIN_TEXT ? DM_C40 : DM_TEXT, last)) {
+            return (symbols_left > 1) + 1; /* Unlatch if room, and ASCII */
+        }
+        return -1;
+    }
+    if (state < DM_MIN_EDIFACT) { /* X12 */
+        if (symbols_left == 1 && pending == 1) {
+            return 1; /* Unlatch not required */
+        }
+        return (symbols_left > 0) + pending; /* Unlatch if room, and ASCII */
+    }
+    /* EDIFACT */
+    if (symbols_left <= 2 && pending <= symbols_left) {
+        return pending; /* Unlatch not required, ASCII */
+    }
+    return 3; /* Unlatch padded to a quadruplet */
+}
+
+/* Set `modes[]` to the modes to encode `source[start]` to `source[inputlen - 1]` in that give the fewest
+   codewords, for `dm200encode()` to use in place of `look_ahead_test()`, given `tp` codewords already output.
+   Finds the cheapest path through the states the encoder can be in before each character, following its rules:
+   ASCII latches to another mode before any character other than the first of a digit pair, C40/TEXT/X12 unlatch
+   only after a complete triplet, EDIFACT only with 3 values pending (completing the quadruplet), and Base 256 may
+   stop before any character. Returns 0 on success, else ZINT_ERROR_MEMORY */
+static int dm_minimal_modes(struct zint_symbol *symbol, const unsigned char source[], const int start,
+            const int inputlen, const int gs1, const int tp, char modes[]) {
+    static const char state_modes[DM_MIN_STATES] = {
+        DM_ASCII, DM_C40, DM_C40, DM_C40, DM_TEXT, DM_TEXT, DM_TEXT, DM_X12, DM_X12, DM_X12,
+        DM_EDIFACT, DM_EDIFACT, DM_EDIFACT, DM_EDIFACT, DM_BASE256
+    };
+    const int length = inputlen - start;
+    int *costs, *b256_lens;
+    unsigned char *preds; /* Characters advanced (0-2) << 4 | previous state */
+    int i, p, state, best_cost;
+
+    costs = (int *) z_malloc(z_allocator(symbol), sizeof(int) * (length + 1) * DM_MIN_STATES);
+    b256_lens = (int *) z_malloc(z_allocator(symbol), sizeof(int) * (length + 1));
+    preds = (unsigned char *) z_malloc(z_allocator(symbol), (size_t) (length + 1) * DM_MIN_STATES);
+    if (!costs || !b256_lens || !preds) {
+        z_free(z_allocator(symbol), costs);
+        z_free(z_allocator(symbol), b256_lens);
+        z_free(z_allocator(symbol), preds);
+        strcpy(symbol->errtxt, "530: Insufficient memory for minimal encodation");
+        return ZINT_ERROR_MEMORY;
+    }
+    for (i = 0; i < (length + 1) * DM_MIN_STATES; i++) {
+        costs[i] = DM_MIN_NONE;
+    }
+    costs[DM_MIN_ASCII] = tp;
+
+    for (p = 0; p < length; p++) {
+        int *const cost = costs + p * DM_MIN_STATES;
+        unsigned char *const pred = preds + p * DM_MIN_STATES;
+
+        /* Unlatch to ASCII */
+        for (state = DM_MIN_C40; state < DM_MIN_STATES; state++) {
+            int unlatch;
+            if (cost[state] == DM_MIN_NONE) {
+                continue;
+            }
+            if (state < DM_MIN_EDIFACT) {
+                if ((state - DM_MIN_C40) % 3) {
+                    continue; /* Mid-triplet */
+                }
+                unlatch = 1;
+            } else if (state < DM_MIN_BASE256) {
+                if (state != DM_MIN_EDIFACT + 3) {
+                    continue;
+                }
+                unlatch = 3; /* Unlatch completes the quadruplet */
+            } else {
+                unlatch = 0;
+            }
+            if (cost[state] + unlatch < cost[DM_MIN_ASCII]) {
+                cost[DM_MIN_ASCII] = cost[state] + unlatch;
+                pred[DM_MIN_ASCII] = (unsigned char) state;
+            }
+        }
+
+        /* Latch from ASCII */
+        if (cost[DM_MIN_ASCII] != DM_MIN_NONE && !istwodigits(source, inputlen, start + p)) {
+            static const char latch_states[5] = {
+                DM_MIN_C40, DM_MIN_TEXT, DM_MIN_X12, DM_MIN_EDIFACT, DM_MIN_BASE256
+            };
+            for (i = 0; i < 5; i++) {
+                state = latch_states[i];
+                /* Base 256 also has its length field */
+                if (cost[DM_MIN_ASCII] + 1 + (state == DM_MIN_BASE256) < cost[state]) {
+                    cost[state] = cost[DM_MIN_ASCII] + 1 + (state == DM_MIN_BASE256);
+                    pred[state] = DM_MIN_ASCII;
+                    if (state == DM_MIN_BASE256) {
+                        b256_lens[p] = 0;
+                    }
+                }
+            }
+        }
+
+        /* Encode the character (or digit pair) in each state reached */
+        for (state = 0; state < DM_MIN_STATES; state++) {
+            const unsigned char ch = source[start + p];
+            int advance = 1, next_state = -1, next_cost = 0;
+            if (cost[state] == DM_MIN_NONE) {
+                continue;
+            }
+            if (state == DM_MIN_ASCII) {
+                next_state = DM_MIN_ASCII;
+                if (istwodigits(source, inputlen, start + p)) {
+                    advance = 2;
+                    next_cost = 1;
+                } else {
+                    next_cost = ch > 127 ? 2 : 1; /* FNC4 for extended ASCII */
+                }
+            } else if (state < DM_MIN_X12) {
+                const int base = state < DM_MIN_TEXT ? DM_MIN_C40 : DM_MIN_TEXT;
+                const int values = state - base + c40text_cnt(state_modes[state], gs1, ch);
+                next_state = base + values % 3;
+                next_cost = (values / 3) * 2;
+            } else if (state < DM_MIN_EDIFACT) {
+                if (isX12(ch)) {
+                    next_state = state == DM_MIN_X12 + 2 ? DM_MIN_X12 : state + 1;
+                    next_cost = state == DM_MIN_X12 + 2 ? 2 : 0;
+                }
+            } else if (state < DM_MIN_BASE256) {
+                if (is_chr(CHR_EDIFACT, ch) && !(gs1 && ch == '[')) {
+                    next_state = state == DM_MIN_EDIFACT + 3 ? DM_MIN_EDIFACT : state + 1;
+                    next_cost = state == DM_MIN_EDIFACT + 3 ? 3 : 0;
+                }
+            } else if (!(gs1 && ch == '[')) { /* Base 256 can't encode FNC1 */
+                next_state = DM_MIN_BASE256;
+                next_cost = 1 + (b256_lens[p] + 1 == 250); /* Length field becomes 2 codewords */
+            }
+            if (next_state != -1 && cost[state] + next_cost < costs[(p + advance) * DM_MIN_STATES + next_state]) {
+                costs[(p + advance) * DM_MIN_STATES + next_state] = cost[state] + next_cost;
+                preds[(p + advance) * DM_MIN_STATES + next_state] = (unsigned char) (advance << 4 | state);
+                if (next_state == DM_MIN_BASE256) {
+                    b256_lens[p + 1] = b256_lens[p] + 1;
+                }
+            }
+        }
+    }
+
+    /* Choose the state to end in, costing the end of data as `dm200encode()` will for the symbol size */
+    best_cost = DM_MIN_NONE;
+    state = DM_MIN_ASCII;
+    for (i = 0; i < DM_MIN_STATES; i++) {
+        const int cost = costs[length * DM_MIN_STATES + i];
+        int end_cost;
+        if (cost == DM_MIN_NONE
+                || (end_cost = dm_minimal_end_cost(symbol, i, cost, source[inputlen - 1])) == -1) {
+            continue;
+        }
+        if (cost + end_cost < best_cost) {
+            best_cost = cost + end_cost;
+            state = i;
+        }
+    }
+    if (symbol->debug & ZINT_DEBUG_PRINT) {
+        printf("Minimal encodation codewords: %d\n", best_cost);
+    }
+
+    /* Trace back from the end, setting the modes of the states each character was encoded in */
+    p = length;
+    while (p || state != DM_MIN_ASCII) {
+        const int advance = preds[p * DM_MIN_STATES + state] >> 4;
+        const int prev_state = preds[p * DM_MIN_STATES + state] & 0x0F;
+        for (i = p - advance; i < p; i++) {
+            modes[start + i] = state_modes[prev_state];
+        }
+        p -= advance;
+        state = prev_state;
+    }
+
+    z_free(z_allocator(symbol), costs);
+    z_free(z_allocator(symbol), b256_lens);
+    z_free(z_allocator(symbol), preds);
+
+    return 0;
+}
+
+/* State kept in `internal->incremental` by `ZBarcode_Encode_Incremental()`, so that data sharing a prefix with the
+   previous (e.g. serial numbers) can resume encodation from the last checkpoint the prefix fully determines */
+struct dm_incremental {
+    int gs1; /* Settings of the previous encodation affecting its codewords */
+    int reader_init;
+    int eci;
+    struct zint_structapp structapp;
+    int valid; /* Set if the previous encodation was successful and checkpointed */
+    unsigned char *source; /* Previous data, as given to `dm200encode()` */
+    int length;
+    int size; /* Allocated length of `source` (and `checkpoints` in triples less 1) */
+    int *checkpoints; /* Triples of source position, codeword position and furthest position read by the mode
+                         decisions before (`length` if the end), at each point in ASCII with nothing pending */
+    int count; /* Number of checkpoint triples */
+    unsigned char target[1560]; /* Previous codewords up to the last checkpoint */
+    int symbolsize; /* Index of symbol size of `places`, -1 if none */
+    int *places; /* Placement template of `symbolsize`, followed by row and column positions and the grid */
+    struct zint_allocator allocator; /* Of the symbol first encoded, used for all the above */
+};
+
+static void dm_incremental_free(void *data) {
+    struct dm_incremental *inc = (struct dm_incremental *) data;
+    const struct zint_allocator allocator = inc->allocator;
+
+    z_free(&allocator, inc->source);
+    z_free(&allocator, inc->checkpoints);
+    z_free(&allocator, inc->places);
+    z_free(&allocator, inc);
+}
+
+/* Return incremental state of `symbol` with room for `length` data, allocating if need be, or NULL if none (or
+   failure to allocate, in which case encodation just proceeds without) */
+static struct dm_incremental *dm_incremental(struct zint_symbol *symbol, const int length) {
+    struct zint_incremental *incremental = symbol->internal->incremental;
+    struct dm_incremental *inc;
+
+    if (!incremental) {
+        return NULL;
+    }
+    if (!(inc = (struct dm_incremental *) incremental->data)) {
+        if (!(inc = (struct dm_incremental *) z_calloc(z_allocator(symbol), 1, sizeof(struct dm_incremental)))) {
+            return NULL;
+        }
+        inc->symbolsize = -1;
+        inc->allocator = symbol->internal->allocator;
+        incremental->data = inc;
+        incremental->data_free = dm_incremental_free;
+    }
+    if (length > inc->size) {
+        unsigned char *source = (unsigned char *) z_realloc(&inc->allocator, inc->source, length);
+        int *checkpoints;
+        if (source) {
+            inc->source = source;
+        }
+        if (!source || !(checkpoints = (int *) z_realloc(&inc->allocator, inc->checkpoints,
+                                                            sizeof(int) * 3 * (length + 1)))) {
+            dm_incremental_free(inc);
+            incremental->data = NULL;
+            return NULL;
+        }
+        inc->checkpoints = checkpoints;
+        inc->size = length;
+    }
+
+    return inc;
+}
+
 /* Encodes data using ASCII, C40, Text, X12, EDIFACT or Base 256 modes as appropriate
    Supports encoding FNC1 in supporting systems */
 static int dm200encode(struct zint_symbol *symbol, const unsigned char source[], unsigned char target[],
@@ -595,6 +875,9 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
     int b256_start = 0;
     int symbols_left;
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
+    char *modes = NULL; /* If MINIMAL_MODE, the modes from `dm_minimal_modes()` */
+    int horizon = -1; /* Furthest position read by mode decisions so far (`inputlen` if the end) */
+    struct dm_incremental *inc = NULL; /* If `ZBarcode_Encode_Incremental()` */
 
     sp = 0;
     tp = 0;
@@ -614,6 +897,46 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
         gs1 = 0;
     }
 
+    if (symbol->structapp.count) {
+        int id1, id2;
+
+        if (symbol->structapp.count < 2 || symbol->structapp.count > 16) {
+            strcpy(symbol->errtxt, "720: Structured Append count out of range (2-16)");
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        if (symbol->structapp.index < 1 || symbol->structapp.index > symbol->structapp.count) {
+            sprintf(symbol->errtxt, "721: Structured Append index out of range (1-%d)", symbol->structapp.count);
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        if (symbol->output_options & READER_INIT) {
+            strcpy(symbol->errtxt, "722: Cannot have Structured Append and Reader Initialisation at the same time");
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        id1 = id2 = 1; /* Default File Identification */
+        if (symbol->structapp.id[0]) {
+            /* ID is "ID1ID2" with ID2 the last 3 digits, e.g. "1002" for ID1 1, ID2 2 */
+            const int id_len = (int) strlen(symbol->structapp.id);
+            int id;
+            if (id_len > 6 || (id = to_int((const unsigned char *) symbol->structapp.id, id_len)) == -1) {
+                strcpy(symbol->errtxt, "723: Invalid Structured Append ID (6 digits maximum)");
+                return ZINT_ERROR_INVALID_OPTION;
+            }
+            id1 = id / 1000;
+            id2 = id % 1000;
+            if (id1 < 1 || id1 > 254 || id2 < 1 || id2 > 254) {
+                strcpy(symbol->errtxt, "724: Structured Append ID1 or ID2 out of range (001-254)");
+                return ZINT_ERROR_INVALID_OPTION;
+            }
+        }
+
+        /* Structured Append (Section 5.6.2), must be first (before any FNC1) */
+        target[tp++] = 233;
+        target[tp++] = (unsigned char) (((symbol->structapp.index - 1) << 4) | (17 - symbol->structapp.count));
+        target[tp++] = (unsigned char) id1;
+        target[tp++] = (unsigned char) id2;
+        if (debug) printf("SA %d/%d %d %d ", symbol->structapp.index, symbol->structapp.count, id1, id2);
+    }
+
     if (gs1) {
         target[tp] = 232;
         tp++;
@@ -678,21 +1001,86 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
         *p_length -= 2;
     }
 
+    /* Past the time budget use `look_ahead_test()` instead */
+    if ((symbol->input_mode & MINIMAL_MODE) && sp < inputlen && !z_over_budget(symbol)) {
+        int error_number;
+        modes = (char *) z_malloc(z_allocator(symbol), inputlen);
+        if (!modes) {
+            strcpy(symbol->errtxt, "530: Insufficient memory for minimal encodation");
+            return ZINT_ERROR_MEMORY;
+        }
+        if ((error_number = dm_minimal_modes(symbol, source, sp, inputlen, gs1, tp, modes))) {
+            z_free(z_allocator(symbol), modes);
+            return error_number;
+        }
+        if (debug) {
+            printf("Modes: ");
+            for (i = sp; i < inputlen; i++) printf("%c", " ACTXEB"[(int) modes[i]]);
+            printf("\n");
+        }
+    }
+
+    /* Not if Macro05/Macro06, which depends on the end of data */
+    if (!modes && sp == 0 && inputlen && (inc = dm_incremental(symbol, inputlen))) {
+        const int reader_init = symbol->output_options & READER_INIT;
+        if (inc->valid && inc->gs1 == gs1 && inc->reader_init == reader_init && inc->eci == symbol->eci
+                && memcmp(&inc->structapp, &symbol->structapp, sizeof(symbol->structapp)) == 0) {
+            /* Resume from the last checkpoint whose decisions only read data common to the previous */
+            const int max = inputlen < inc->length ? inputlen : inc->length;
+            int prefix, c;
+            for (prefix = 0; prefix < max && source[prefix] == inc->source[prefix]; prefix++);
+            for (c = inc->count - 1; c > 0 && inc->checkpoints[c * 3 + 2] >= prefix; c--);
+            if (c > 0) {
+                const int *checkpoint = inc->checkpoints + c * 3;
+                memcpy(target + tp, inc->target + tp, checkpoint[1] - tp);
+                sp = checkpoint[0];
+                tp = checkpoint[1];
+                horizon = checkpoint[2];
+            }
+            inc->count = c; /* Checkpoint `c` recorded again below */
+        } else {
+            inc->count = 0;
+            inc->gs1 = gs1;
+            inc->reader_init = reader_init;
+            inc->eci = symbol->eci;
+            inc->structapp = symbol->structapp;
+        }
+        inc->valid = 0;
+    }
+
+    z_record(symbol, ZINT_PHASE_MODES, ZINT_RECORD_MODE, 'A', sp, -1, tp);
+
     while (sp < inputlen) {
 
+        if (inc && next_mode == DM_ASCII && process_p == 0
+                && (inc->count == 0 || inc->checkpoints[inc->count * 3 - 3] != sp)) {
+            int *checkpoint = inc->checkpoints + inc->count++ * 3;
+            checkpoint[0] = sp;
+            checkpoint[1] = tp;
+            checkpoint[2] = horizon;
+        }
+
+        if (next_mode != current_mode) {
+            z_record(symbol, ZINT_PHASE_MODES, ZINT_RECORD_MODE, " ACTXEB"[next_mode], sp, -1, tp);
+        }
         current_mode = next_mode;
 
         /* step (b) - ASCII encodation */
         if (current_mode == DM_ASCII) {
             next_mode = DM_ASCII;
 
+            if (sp + 1 >= inputlen) {
+                horizon = inputlen; /* Two digit test depends on the end of data */
+            } else if (sp + 1 > horizon) {
+                horizon = sp + 1;
+            }
             if (istwodigits(source, inputlen, sp)) {
                 target[tp] = (unsigned char) ((10 * ctoi(source[sp])) + ctoi(source[sp + 1]) + 130);
                 if (debug) printf("N%02d ", target[tp] - 130);
                 tp++;
                 sp += 2;
             } else {
-                next_mode = look_ahead_test(source, inputlen, sp, current_mode, gs1);
+                next_mode = modes ? modes[sp] : look_ahead_test(source, inputlen, sp, current_mode, gs1, &horizon);
 
                 if (next_mode != DM_ASCII) {
                     switch (next_mode) {
@@ -750,7 +1138,7 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
 
             next_mode = current_mode;
             if (process_p == 0) {
-                next_mode = look_ahead_test(source, inputlen, sp, current_mode, gs1);
+                next_mode = modes ? modes[sp] : look_ahead_test(source, inputlen, sp, current_mode, gs1, &horizon);
             }
 
             if (next_mode != current_mode) {
@@ -806,7 +1194,7 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
 
             next_mode = DM_X12;
             if (process_p == 0) {
-                next_mode = look_ahead_test(source, inputlen, sp, current_mode, gs1);
+                next_mode = modes ? modes[sp] : look_ahead_test(source, inputlen, sp, current_mode, gs1, &horizon);
             }
 
             if (next_mode != DM_X12) {
@@ -841,7 +1229,7 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
             if (process_p == 3) {
                 /* Note different then spec Step (f)(1), which suggests checking when 0, but this seems to work
                    better in many cases. */
-                next_mode = look_ahead_test(source, inputlen, sp, current_mode, gs1);
+                next_mode = modes ? modes[sp] : look_ahead_test(source, inputlen, sp, current_mode, gs1, &horizon);
             }
 
             if (next_mode != DM_EDIFACT) {
@@ -865,7 +1253,7 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
 
         /* step (g) Base 256 encodation */
         } else if (current_mode == DM_BASE256) {
-            next_mode = look_ahead_test(source, inputlen, sp, current_mode, gs1);
+            next_mode = modes ? modes[sp] : look_ahead_test(source, inputlen, sp, current_mode, gs1, &horizon);
 
             if (next_mode == DM_BASE256) {
                 target[tp] = source[sp];
@@ -874,23 +1262,30 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
                 if (debug) printf("B%02X ", target[tp - 1]);
             } else {
                 tp = update_b256_field_length(target, tp, b256_start);
-                /* B.2.1 255-state randomising algorithm */
-                for (i = b256_start; i < tp; i++) {
-                    int prn = ((149 * (i + 1)) % 255) + 1;
-                    target[i] = (unsigned char) ((target[i] + prn) & 0xFF);
-                }
+                b256_randomise(target, b256_start, tp);
                 next_mode = DM_ASCII;
                 if (debug) printf("ASC ");
             }
         }
 
         if (tp > 1558) {
+            z_free(z_allocator(symbol), modes);
             strcpy(symbol->errtxt, "520: Data too long to fit in symbol");
             return ZINT_ERROR_TOO_LONG;
         }
 
     } /* while */
 
+    z_free(z_allocator(symbol), modes);
+
+    if (inc) {
+        /* Keep data and codewords up to the last checkpoint for next time */
+        memcpy(inc->source, source, inputlen);
+        inc->length = inputlen;
+        memcpy(inc->target, target, inc->checkpoints[inc->count * 3 - 2]);
+        inc->valid = 1;
+    }
+
     symbols_left = codewords_remaining(symbol, tp, process_p);
 
     if (debug) printf("\nsymbols_left %d, process_p %d ", symbols_left, process_p);
@@ -1008,11 +1403,7 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
         if (symbols_left > 0) {
             tp = update_b256_field_length(target, tp, b256_start);
         }
-        /* B.2.1 255-state randomising algorithm */
-        for (i = b256_start; i < tp; i++) {
-            int prn = ((149 * (i + 1)) % 255) + 1;
-            target[i] = (unsigned char) ((target[i] + prn) & 0xFF);
-        }
+        b256_randomise(target, b256_start, tp);
     }
 
     if (debug) {
@@ -1030,23 +1421,19 @@ static int dm200encode(struct zint_symbol *symbol, const unsigned char source[],
 
 /* add pad bits */
 static void add_tail(unsigned char target[], int tp, const int tail_length) {
-    int i, prn, temp;
+    const int end = tp + tail_length;
+    int prn;
 
-    for (i = tail_length; i > 0; i--) {
-        if (i == tail_length) {
-            target[tp] = 129;
-            tp++; /* Pad */
-        } else {
-            /* B.1.1 253-state randomising algorithm */
-            prn = ((149 * (tp + 1)) % 253) + 1;
-            temp = 129 + prn;
-            if (temp <= 254) {
-                target[tp] = (unsigned char) (temp);
-                tp++;
-            } else {
-                target[tp] = (unsigned char) (temp - 254);
-                tp++;
-            }
+    if (tp < end) {
+        target[tp++] = 129; /* Pad */
+    }
+    /* B.1.1 253-state randomising algorithm */
+    prn = (149 * (tp + 1)) % 253; /* Pseudo-random number less 1, stepped by 149 mod 253 */
+    while (tp < end) {
+        const int temp = 130 + prn;
+        target[tp++] = (unsigned char) (temp <= 254 ? temp : temp - 254);
+        if ((prn += 149) >= 253) {
+            prn -= 253;
         }
     }
 }
@@ -1061,7 +1448,9 @@ static int data_matrix_200(struct zint_symbol *symbol, const unsigned char sourc
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
 
     /* inputlen may be decremented by 2 if macro character is used */
+    z_trace(symbol, ZINT_PHASE_MODES, ZINT_TRACE_BEGIN, inputlen);
     error_number = dm200encode(symbol, source, binary, &inputlen, &binlen);
+    z_trace(symbol, ZINT_PHASE_MODES, ZINT_TRACE_END, error_number ? -1 : binlen);
     if (error_number != 0) {
         return error_number;
     }
@@ -1087,6 +1476,11 @@ static int data_matrix_200(struct zint_symbol *symbol, const unsigned char sourc
     rsblock = matrixrsblock[symbolsize];
 
     taillength = bytes - binlen;
+    z_record(symbol, ZINT_PHASE_ENCODE, ZINT_RECORD_SIZE, dm_version(symbolsize), H, W, -1);
+    z_record(symbol, ZINT_PHASE_RS, ZINT_RECORD_CODEWORDS, bytes, rsblock * (bytes / datablock), binlen, 0);
+    if (symbol->debug & ZINT_MEASURE_ONLY) {
+        return z_measured(symbol, H, W);
+    }
 
     if (taillength != 0) {
         add_tail(binary, binlen, taillength);
@@ -1101,7 +1495,9 @@ static int data_matrix_200(struct zint_symbol *symbol, const unsigned char sourc
     if (symbolsize == INTSYMBOL144) {
         skew = 1;
     }
+    z_trace(symbol, ZINT_PHASE_RS, ZINT_TRACE_BEGIN, bytes);
     ecc200(binary, bytes, datablock, rsblock, skew);
+    z_trace(symbol, ZINT_PHASE_RS, ZINT_TRACE_END, bytes + rsblock * (bytes / datablock));
     if (debug) {
         printf("ECC (%d): ", rsblock * (bytes / datablock));
         for (i = bytes; i < bytes + rsblock * (bytes / datablock); i++) printf("%d ", binary[i]);
@@ -1114,25 +1510,49 @@ static int data_matrix_200(struct zint_symbol *symbol, const unsigned char sourc
     }
 #endif
     { // placement
-        int x, y, NC, NR, *places;
+        int x, y, NC, NR, *places, *row_posns, *col_posns;
         unsigned char *grid;
+        struct zint_incremental *const incremental = symbol->internal->incremental;
+        struct dm_incremental *inc = incremental ? (struct dm_incremental *) incremental->data : NULL;
         NC = W - 2 * (W / FW);
         NR = H - 2 * (H / FH);
-        places = (int *) malloc(sizeof(int) * NC * NR);
-        ecc200placement(places, NR, NC);
-        grid = (unsigned char *) malloc((size_t) W * H);
-        memset(grid, 0, W * H);
-        for (y = 0; y < H; y += FH) {
-            for (x = 0; x < W; x++)
-                grid[y * W + x] = 1;
-            for (x = 0; x < W; x += 2)
-                grid[(y + FH - 1) * W + x] = 1;
-        }
-        for (x = 0; x < W; x += FW) {
-            for (y = 0; y < H; y++)
-                grid[y * W + x] = 1;
-            for (y = 0; y < H; y += 2)
-                grid[y * W + x + FW - 1] = 1;
+        if (inc && inc->symbolsize == symbolsize) {
+            /* Same size as previous incremental encodation so template kept, the data modules all being set below */
+            places = inc->places;
+            row_posns = places + NC * NR;
+            col_posns = row_posns + NR;
+            grid = (unsigned char *) (col_posns + NC);
+        } else {
+            /* Grid follows placement and its row/column positions in the same block */
+            places = (int *) z_malloc(inc ? &inc->allocator : z_allocator(symbol),
+                                        sizeof(int) * (NC * NR + NR + NC) + (size_t) W * H);
+            row_posns = places + NC * NR;
+            col_posns = row_posns + NR;
+            grid = (unsigned char *) (col_posns + NC);
+            ecc200placement(places, NR, NC);
+            // grid positions of the mapping matrix rows and columns, stepping over the finder/alignment patterns
+            for (y = 0; y < NR; y++)
+                row_posns[y] = (1 + y + 2 * (y / (FH - 2))) * W;
+            for (x = 0; x < NC; x++)
+                col_posns[x] = 1 + x + 2 * (x / (FW - 2));
+            memset(grid, 0, W * H);
+            for (y = 0; y < H; y += FH) {
+                for (x = 0; x < W; x++)
+                    grid[y * W + x] = 1;
+                for (x = 0; x < W; x += 2)
+                    grid[(y + FH - 1) * W + x] = 1;
+            }
+            for (x = 0; x < W; x += FW) {
+                for (y = 0; y < H; y++)
+                    grid[y * W + x] = 1;
+                for (y = 0; y < H; y += 2)
+                    grid[y * W + x + FW - 1] = 1;
+            }
+            if (inc) {
+                z_free(&inc->allocator, inc->places);
+                inc->places = places;
+                inc->symbolsize = symbolsize;
+            }
         }
 #ifdef DEBUG
         // Print position matrix as in standard
@@ -1148,10 +1568,12 @@ static int data_matrix_200(struct zint_symbol *symbol, const unsigned char sourc
         }
 #endif
         for (y = 0; y < NR; y++) {
+            const int *place = places + (NR - y - 1) * NC;
+            unsigned char *grid_row = grid + row_posns[y];
             for (x = 0; x < NC; x++) {
-                int v = places[(NR - y - 1) * NC + x];
-                if (v == 1 || (v > 7 && (binary[(v >> 3) - 1] & (1 << (v & 7)))))
-                    grid[(1 + y + 2 * (y / (FH - 2))) * W + 1 + x + 2 * (x / (FW - 2))] = 1;
+                int v = place[x];
+                // assigned rather than tested so that random data doesn't upset branch prediction
+                grid_row[col_posns[x]] = v > 7 ? (binary[(v >> 3) - 1] >> (v & 7)) & 1 : v == 1;
             }
         }
         for (y = H - 1; y >= 0; y--) {
@@ -1162,8 +1584,9 @@ static int data_matrix_200(struct zint_symbol *symbol, const unsigned char sourc
             }
             symbol->row_height[(H - y) - 1] = 1;
         }
-        free(grid);
-        free(places);
+        if (!inc) {
+            z_free(z_allocator(symbol), places);
+        }
     }
 
     symbol->rows = H;
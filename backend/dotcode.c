@@ -39,6 +39,7 @@
 
 #include <stdio.h>
 #include <assert.h>
+#include <limits.h>
 #include <math.h>
 #ifndef _MSC_VER
 #include <stdint.h>
@@ -69,209 +70,121 @@ static const unsigned short int dot_patterns[113] = {
     0x1b8, 0x1c6, 0x1cc
 };
 
-// Printed() routine from Annex A adapted to char array of ASCII 1's and 0's
-static int get_dot(const char Dots[], const int Hgt, const int Wid, const int x, const int y) {
-    int retval = 0;
-
-    if ((x >= 0) && (x < Wid) && (y >= 0) && (y < Hgt)) {
-        if (Dots[(y * Wid) + x] == '1') {
-            retval = 1;
-        }
-    }
+/* The 4 masks are evaluated together, each dot being a byte with bit `mask` set if lit when that mask is applied, and
+   bit `mask + 4` if lit when that mask is applied with forced corners (masks 4-7) */
+#define DC_LANES    8
 
-    return retval;
-}
+/* Dot arrays are bordered by 2 unlit dots so that the scoring needs no bounds checks */
+#define DC_BORDER   2
 
-static int clr_col(const char *Dots, const int Hgt, const int Wid, const int x) {
-    int y;
-    for (y = x & 1; y < Hgt; y += 2) {
-        if (get_dot(Dots, Hgt, Wid, x, y)) {
-            return 0;
-        }
-    }
+/* Accumulate the Sum(N ^ n) penalty for a row/column of `lit` lanes, where N is the number of positions in the
+   row/column and n the number of consecutive empty rows/columns */
+static void dc_penalty(const unsigned char lit, const int N, int penalty[], int penalty_local[]) {
+    int l;
 
-    return 1;
-}
-
-static int clr_row(const char *Dots, const int Hgt, const int Wid, const int y) {
-    int x;
-    for (x = y & 1; x < Wid; x += 2) {
-        if (get_dot(Dots, Hgt, Wid, x, y)) {
-            return 0;
-        }
-    }
-
-    return 1;
-}
-
-// calc penalty for empty interior columns
-static int col_penalty(const char *Dots, const int Hgt, const int Wid) {
-    int x, penalty = 0, penalty_local = 0;
-
-    for (x = 1; x < Wid - 1; x++) {
-        if (clr_col(Dots, Hgt, Wid, x)) {
-            if (penalty_local == 0) {
-                penalty_local = Hgt;
+    for (l = 0; l < DC_LANES; l++) {
+        if (!(lit & (1 << l))) {
+            if (penalty_local[l] == 0) {
+                penalty_local[l] = N;
             } else {
-                penalty_local *= Hgt;
-            }
-        } else {
-            if (penalty_local) {
-                penalty += penalty_local;
-                penalty_local = 0;
+                penalty_local[l] *= N;
             }
+        } else if (penalty_local[l]) {
+            penalty[l] += penalty_local[l];
+            penalty_local[l] = 0;
         }
     }
-
-    return penalty + penalty_local;
 }
 
-// calc penalty for empty interior rows
-static int row_penalty(const char *Dots, const int Hgt, const int Wid) {
-    int y, penalty = 0, penalty_local = 0;
-
-    for (y = 1; y < Hgt - 1; y++) {
-        if (clr_row(Dots, Hgt, Wid, y)) {
-            if (penalty_local == 0) {
-                penalty_local = Wid;
-            } else {
-                penalty_local *= Wid;
+/* Count the printed dots along an edge and measure their extent, setting `worstedge` to the product with `mult` if
+   less (or if `first_edge`), and flagging lanes with no printed dots in `unlit` */
+static void dc_edge(const unsigned char *dots, const int step, const int n, const int mult, const int first_edge,
+            int worstedge[], unsigned char *unlit) {
+    int first[DC_LANES], last[DC_LANES], sum[DC_LANES] = {0};
+    int i, l;
+
+    for (i = 0; i < n; i++, dots += step) {
+        for (l = 0; l < DC_LANES; l++) {
+            if (*dots & (1 << l)) {
+                if (!sum[l]) {
+                    first[l] = i;
+                }
+                last[l] = i;
+                sum[l]++;
             }
+        }
+    }
+    for (l = 0; l < DC_LANES; l++) {
+        if (!sum[l]) {
+            *unlit |= 1 << l;
         } else {
-            if (penalty_local) {
-                penalty += penalty_local;
-                penalty_local = 0;
+            /* Positions are every 2nd dot */
+            const int score = (sum[l] + 2 * (last[l] - first[l])) * mult;
+            if (first_edge || score < worstedge[l]) {
+                worstedge[l] = score;
             }
         }
     }
-
-    return penalty + penalty_local;
 }
 
-/* Dot pattern scoring routine from Annex A */
-static int score_array(const char Dots[], const int Hgt, const int Wid) {
-    int x, y, worstedge, first, last, sum;
-    int penalty = 0;
+/* Dot pattern scoring routine from Annex A, scoring all `DC_LANES` dot arrays of bordered `dots` at once */
+static void score_arrays(const unsigned char dots[], const int Hgt, const int Wid, int scores[DC_LANES]) {
+    const int pw = Wid + DC_BORDER * 2; /* Bordered width */
+    const unsigned char *const d = dots + DC_BORDER * pw + DC_BORDER; /* Top left dot */
+    int penalty[DC_LANES] = {0}, penalty_local[DC_LANES] = {0};
+    int worstedge[DC_LANES], sum[DC_LANES] = {0};
+    unsigned char unlit = 0;
+    int x, y, l;
 
     // first, guard against "pathelogical" gaps in the array
     // subtract a penalty score for empty rows/columns from total code score for each mask,
     // where the penalty is Sum(N ^ n), where N is the number of positions in a column/row,
     // and n is the number of consecutive empty rows/columns
-    penalty = row_penalty(Dots, Hgt, Wid) + col_penalty(Dots, Hgt, Wid);
-
-    sum = 0;
-    first = -1;
-    last = -1;
-
-    // across the top edge, count printed dots and measure their extent
-    for (x = 0; x < Wid; x += 2) {
-        if (get_dot(Dots, Hgt, Wid, x, 0)) {
-            if (first < 0) {
-                first = x;
-            }
-            last = x;
-            sum++;
-        }
-    }
-    if (sum == 0) {
-        return SCORE_UNLIT_EDGE;      // guard against empty top edge
-    }
-
-    worstedge = sum + last - first;
-    worstedge *= Hgt;
-
-    sum = 0;
-    first = -1;
-    last = -1;
-
-    // across the bottom edge, ditto
-    for (x = Wid & 1; x < Wid; x += 2) {
-        if (get_dot(Dots, Hgt, Wid, x, Hgt - 1)) {
-            if (first < 0) {
-                first = x;
-            }
-            last = x;
-            sum++;
-        }
-    }
-    if (sum == 0) {
-        return SCORE_UNLIT_EDGE;      // guard against empty bottom edge
-    }
-
-    sum += last - first;
-    sum *= Hgt;
-    if (sum < worstedge) {
-        worstedge = sum;
-    }
-
-    sum = 0;
-    first = -1;
-    last = -1;
-
-    // down the left edge, ditto
-    for (y = 0; y < Hgt; y += 2) {
-        if (get_dot(Dots, Hgt, Wid, 0, y)) {
-            if (first < 0) {
-                first = y;
-            }
-            last = y;
-            sum++;
+    for (y = 1; y < Hgt - 1; y++) {
+        unsigned char lit = 0;
+        for (x = y & 1; x < Wid; x += 2) {
+            lit |= d[y * pw + x];
         }
+        dc_penalty(lit, Wid, penalty, penalty_local);
     }
-    if (sum == 0) {
-        return SCORE_UNLIT_EDGE;      // guard against empty left edge
-    }
-
-    sum += last - first;
-    sum *= Wid;
-    if (sum < worstedge) {
-        worstedge = sum;
-    }
-
-    sum = 0;
-    first = -1;
-    last = -1;
-
-    // down the right edge, ditto
-    for (y = Hgt & 1; y < Hgt; y += 2) {
-        if (get_dot(Dots, Hgt, Wid, Wid - 1, y)) {
-            if (first < 0) {
-                first = y;
-            }
-            last = y;
-            sum++;
+    dc_penalty(0xFF, Wid, penalty, penalty_local); /* Flush */
+    for (x = 1; x < Wid - 1; x++) {
+        unsigned char lit = 0;
+        for (y = x & 1; y < Hgt; y += 2) {
+            lit |= d[y * pw + x];
         }
+        dc_penalty(lit, Hgt, penalty, penalty_local);
     }
-    if (sum == 0) {
-        return SCORE_UNLIT_EDGE;      // guard against empty right edge
-    }
+    dc_penalty(0xFF, Hgt, penalty, penalty_local); /* Flush */
 
-    sum += last - first;
-    sum *= Wid;
-    if (sum < worstedge) {
-        worstedge = sum;
-    }
+    // across the top and bottom edges and down the left and right edges, count printed dots and measure their
+    // extent, guarding against empty edges
+    dc_edge(d, 2, (Wid + 1) / 2, Hgt, 1 /*first_edge*/, worstedge, &unlit);
+    dc_edge(d + (Hgt - 1) * pw + (Wid & 1), 2, (Wid - (Wid & 1) + 1) / 2, Hgt, 0, worstedge, &unlit);
+    dc_edge(d, 2 * pw, (Hgt + 1) / 2, Wid, 0, worstedge, &unlit);
+    dc_edge(d + (Hgt & 1) * pw + Wid - 1, 2 * pw, (Hgt - (Hgt & 1) + 1) / 2, Wid, 0, worstedge, &unlit);
 
     // throughout the array, count the # of unprinted 5-somes (cross patterns)
     // plus the # of printed dots surrounded by 8 unprinted neighbors
-    sum = 0;
     for (y = 0; y < Hgt; y++) {
-        for (x = y & 1; x < Wid; x += 2) {
-            if ((!get_dot(Dots, Hgt, Wid, x - 1, y - 1))
-                    && (!get_dot(Dots, Hgt, Wid, x + 1, y - 1))
-                    && (!get_dot(Dots, Hgt, Wid, x - 1, y + 1))
-                    && (!get_dot(Dots, Hgt, Wid, x + 1, y + 1))
-                    && ((!get_dot(Dots, Hgt, Wid, x, y))
-                    || ((!get_dot(Dots, Hgt, Wid, x - 2, y))
-                    && (!get_dot(Dots, Hgt, Wid, x, y - 2))
-                    && (!get_dot(Dots, Hgt, Wid, x + 2, y))
-                    && (!get_dot(Dots, Hgt, Wid, x, y + 2))))) {
-                sum++;
+        const unsigned char *c = d + y * pw + (y & 1);
+        for (x = y & 1; x < Wid; x += 2, c += 2) {
+            const unsigned char diagonals = c[-pw - 1] | c[-pw + 1] | c[pw - 1] | c[pw + 1];
+            const unsigned char orthogonals = c[-2] | c[-2 * pw] | c[2] | c[2 * pw];
+            unsigned char crosses = (unsigned char) ~(diagonals | (c[0] & orthogonals));
+            for (l = 0; crosses; l++, crosses >>= 1) {
+                sum[l] += crosses & 1;
             }
         }
     }
 
-    return (worstedge - sum * sum - penalty);
+    for (l = 0; l < DC_LANES; l++) {
+        if (unlit & (1 << l)) {
+            scores[l] = SCORE_UNLIT_EDGE;
+        } else {
+            scores[l] = worstedge[l] - penalty[l] - sum[l] * sum[l];
+        }
+    }
 }
 
 //-------------------------------------------------------------------------
@@ -281,7 +194,7 @@ static int score_array(const char Dots[], const int Hgt, const int Wid) {
 
 static void rsencode(const int nd, const int nc, unsigned char *wd) {
     // roots (antilogs): root[0] = 1; for (i = 1; i < GF - 1; i++) root[i] = (PM * root[i - 1]) % GF;
-    static int root[GF - 1] = {
+    static const int root[GF - 1] = {
           1,   3,   9,  27,  81,  17,  51,  40,   7,  21,
          63,  76,   2,   6,  18,  54,  49,  34, 102,  80,
          14,  42,  13,  39,   4,  12,  36, 108,  98,  68,
@@ -379,32 +292,16 @@ static int datum_b(const unsigned char source[], const int position, const int l
 }
 
 /* Check if the next characters are directly encodable in code set C (Annex F.II.D) */
-static int datum_c(const unsigned char source[], const int position, const int length) {
-    int retval = 0;
-
-    if (position + 1 < length) {
-        if (((source[position] >= '0') && (source[position] <= '9'))
-                && ((source[position + 1] >= '0') && (source[position + 1] <= '9')))
-            retval = 1;
-    }
-
-    return retval;
-}
-
-/* Returns how many consecutive digits lie immediately ahead (Annex F.II.A) */
-static int n_digits(const unsigned char source[], const int position, const int length) {
-    int i;
-
-    for (i = position; (i < length) && ((source[i] >= '0') && (source[i] <= '9')); i++);
-
-    return i - position;
+/* Whether the next two characters are digits, given the digit runs `digits` (see `chr_runs()`) */
+static int datum_c(const int digits[], const int position) {
+    return digits[position] >= 2;
 }
 
 /* checks ahead for 10 or more digits starting "17xxxxxx10..." (Annex F.II.B) */
-static int seventeen_ten(const unsigned char source[], const int position, const int length) {
+static int seventeen_ten(const unsigned char source[], const int digits[], const int position) {
     int found = 0;
 
-    if (n_digits(source, position, length) >= 10) {
+    if (digits[position] >= 10) {
         if (((source[position] == '1') && (source[position + 1] == '7'))
                 && ((source[position + 8] == '1') && (source[position + 9] == '0'))) {
             found = 1;
@@ -415,26 +312,19 @@ static int seventeen_ten(const unsigned char source[], const int position, const
 }
 
 /*  checks how many characters ahead can be reached while datum_c is true,
- *  returning the resulting number of codewords (Annex F.II.E)
+ *  returning the resulting number of codewords (Annex F.II.E) - i.e. the number of digit pairs in the run
  */
-static int ahead_c(const unsigned char source[], const int position, const int length) {
-    int count = 0;
-    int i;
-
-    for (i = position; (i < length) && datum_c(source, i, length); i += 2) {
-        count++;
-    }
-
-    return count;
+static int ahead_c(const int digits[], const int position) {
+    return digits[position] >> 1;
 }
 
 /* Annex F.II.F */
-static int try_c(const unsigned char source[], const int position, const int length) {
+static int try_c(const int digits[], const int position) {
     int retval = 0;
 
-    if (n_digits(source, position, length) > 0) {
-        if (ahead_c(source, position, length) > ahead_c(source, position + 1, length)) {
-            retval = ahead_c(source, position, length);
+    if (digits[position] > 0) {
+        if (ahead_c(digits, position) > ahead_c(digits, position + 1)) {
+            retval = ahead_c(digits, position);
         }
     }
 
@@ -442,12 +332,12 @@ static int try_c(const unsigned char source[], const int position, const int len
 }
 
 /* Annex F.II.G */
-static int ahead_a(const unsigned char source[], const int position, const int length) {
+static int ahead_a(const unsigned char source[], const int digits[], const int position, const int length) {
     int count = 0;
     int i;
 
     for (i = position; ((i < length) && datum_a(source, i, length))
-            && (try_c(source, i, length) < 2); i++) {
+            && (try_c(digits, i) < 2); i++) {
         count++;
     }
 
@@ -455,12 +345,13 @@ static int ahead_a(const unsigned char source[], const int position, const int l
 }
 
 /* Annex F.II.H Note: changed to return number of chars encodable. Number of codewords returned in *p_nx. */
-static int ahead_b(const unsigned char source[], const int position, const int length, int *p_nx) {
+static int ahead_b(const unsigned char source[], const int digits[], const int position, const int length,
+            int *p_nx) {
     int count = 0;
     int i, incr;
 
     for (i = position; (i < length) && (incr = datum_b(source, i, length))
-            && (try_c(source, i, length) < 2); i += incr) {
+            && (try_c(digits, i) < 2); i += incr) {
         count++;
     }
 
@@ -482,10 +373,11 @@ static int binary(const unsigned char source[], const int length, const int posi
     return retval;
 }
 
-/* Analyse input data stream and encode using algorithm from Annex F */
+/* Analyse input data stream and encode using algorithm from Annex F. `digits` gives the digit runs of `source`
+   (see `chr_runs()`), so that the look-aheads don't rescan them */
 static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned char source[], const int length,
-            unsigned char *codeword_array, int *binary_finish) {
-    static char lead_specials[] = "\x09\x1C\x1D\x1E"; // HT, FS, GS, RS
+            const int digits[], unsigned char *codeword_array, int *binary_finish) {
+    static const char lead_specials[] = "\x09\x1C\x1D\x1E"; // HT, FS, GS, RS
 
     int input_position, array_length, i;
     char encoding_mode;
@@ -646,7 +538,7 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
 
         /* Step C2 */
         if ((!done) && (encoding_mode == 'C')) {
-            if (seventeen_ten(source, input_position, length)) {
+            if (seventeen_ten(source, digits, input_position)) {
                 codeword_array[array_length] = 100; // (17)...(10)
                 array_length++;
                 codeword_array[array_length] = to_int(source + input_position + 2, 2);
@@ -664,7 +556,7 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
         }
 
         if ((!done) && (encoding_mode == 'C')) {
-            if (datum_c(source, input_position, length)
+            if (datum_c(digits, input_position)
                     || ((source[input_position] == '[') && ((symbol->input_mode & 0x07) == GS1_MODE))) {
                 if (source[input_position] == '[') {
                     codeword_array[array_length] = 107; // FNC1
@@ -684,7 +576,7 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
         /* Step C3 */
         if ((!done) && (encoding_mode == 'C')) {
             if (binary(source, length, input_position)) {
-                if (n_digits(source, input_position + 1, length) > 0) {
+                if (digits[input_position + 1] > 0) {
                     if ((source[input_position] - 128) < 32) {
                         codeword_array[array_length] = 110; // Upper Shift A
                         array_length++;
@@ -711,8 +603,8 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
 
         /* Step C4 */
         if ((!done) && (encoding_mode == 'C')) {
-            int m = ahead_a(source, input_position, length);
-            int n = ahead_b(source, input_position, length, &nx);
+            int m = ahead_a(source, digits, input_position, length);
+            int n = ahead_b(source, digits, input_position, length, &nx);
             if (m > n) {
                 codeword_array[array_length] = 101; // Latch A
                 array_length++;
@@ -753,7 +645,7 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
 
         /* Step D1 */
         if ((!done) && (encoding_mode == 'B')) {
-            int n = try_c(source, input_position, length);
+            int n = try_c(digits, input_position);
 
             if (n >= 2) {
                 if (n <= 4) {
@@ -860,7 +752,7 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
 
         /* Step D4 */
         if ((!done) && (encoding_mode == 'B')) {
-            if (ahead_a(source, input_position, length) == 1) {
+            if (ahead_a(source, digits, input_position, length) == 1) {
                 codeword_array[array_length] = 101; // Shift A
                 array_length++;
                 if (source[input_position] < 32) {
@@ -883,7 +775,7 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
 
         /* Step E1 */
         if ((!done) && (encoding_mode == 'A')) {
-            int n = try_c(source, input_position, length);
+            int n = try_c(digits, input_position);
             if (n >= 2) {
                 if (n <= 4) {
                     codeword_array[array_length] = 103 + (n - 2); // nx Shift C
@@ -963,7 +855,7 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
 
         /* Step E4 */
         if ((!done) && (encoding_mode == 'A')) {
-            ahead_b(source, input_position, length, &nx);
+            ahead_b(source, digits, input_position, length, &nx);
 
             if (nx >= 1 && nx <= 6) {
                 codeword_array[array_length] = 95 + nx; // nx Shift B
@@ -998,7 +890,7 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
 
         /* Step F1 */
         if ((!done) && (encoding_mode == 'X')) {
-            int n = try_c(source, input_position, length);
+            int n = try_c(digits, input_position);
 
             if (n >= 2) {
                 /* Empty binary buffer */
@@ -1084,7 +976,8 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
             binary_buffer = 0;
             binary_buffer_size = 0;
 
-            if (ahead_a(source, input_position, length) > ahead_b(source, input_position, length, NULL)) {
+            if (ahead_a(source, digits, input_position, length)
+                    > ahead_b(source, digits, input_position, length, NULL)) {
                 codeword_array[array_length] = 109; // Terminate with Latch to A
                 encoding_mode = 'A';
             } else {
@@ -1122,21 +1015,29 @@ static int dotcode_encode_message(struct zint_symbol *symbol, const unsigned cha
     return array_length;
 }
 
-/* Convert codewords to binary data stream */
-static int make_dotstream(const unsigned char masked_array[], const int array_length, char dot_stream[]) {
-    int i;
+/* Convert codewords to dot stream, setting `lanes` for each printed dot */
+static int make_dotstream(const unsigned char masked_array[], const int array_length, const unsigned char lanes,
+            unsigned char dot_stream[]) {
+    int i, j;
     int bp = 0;
 
     /* Mask value is encoded as two dots */
-    bp = bin_append_posn(masked_array[0], 2, dot_stream, bp);
+    for (j = 0x02; j; j >>= 1, bp++) {
+        if (masked_array[0] & j) {
+            dot_stream[bp] |= lanes;
+        }
+    }
 
     /* The rest of the data uses 9-bit dot patterns from Annex C */
     for (i = 1; i < array_length; i++) {
-        bp = bin_append_posn(dot_patterns[masked_array[i]], 9, dot_stream, bp);
+        const int pattern = dot_patterns[masked_array[i]];
+        for (j = 0x100; j; j >>= 1, bp++) {
+            if (pattern & j) {
+                dot_stream[bp] |= lanes;
+            }
+        }
     }
 
-    dot_stream[bp] = '\0';
-
     return bp;
 }
 
@@ -1184,69 +1085,70 @@ static int is_corner(const int column, const int row, const int width, const int
     return corner;
 }
 
-/* Place the dots in the symbol*/
-static void fold_dotstream(const char dot_stream[], const int width, const int height, char dot_array[]) {
+/* Place the dots in the symbol, `dot_array` having a border of `DC_BORDER` unlit dots */
+static void fold_dotstream(const unsigned char dot_stream[], const int width, const int height,
+            unsigned char dot_array[]) {
+    const int pw = width + DC_BORDER * 2; /* Bordered width */
+    unsigned char *const d = dot_array + DC_BORDER * pw + DC_BORDER; /* Top left dot */
     int column, row;
     int input_position = 0;
 
+    memset(dot_array, 0, (height + DC_BORDER * 2) * pw);
+
     if (height % 2) {
         /* Horizontal folding */
         for (row = 0; row < height; row++) {
             for (column = 0; column < width; column++) {
                 if (!((column + row) % 2)) {
                     if (is_corner(column, row, width, height)) {
-                        dot_array[(row * width) + column] = 'C';
+                        d[(row * pw) + column] = 0;
                     } else {
-                        dot_array[((height - row - 1) * width) + column] = dot_stream[input_position];
+                        d[((height - row - 1) * pw) + column] = dot_stream[input_position];
                         input_position++;
                     }
-                } else {
-                    dot_array[((height - row - 1) * width) + column] = ' '; // Non-data position
                 }
             }
         }
 
         /* Corners */
-        dot_array[width - 2] = dot_stream[input_position];
+        d[width - 2] = dot_stream[input_position];
         input_position++;
-        dot_array[(height * width) - 2] = dot_stream[input_position];
+        d[((height - 1) * pw) + width - 2] = dot_stream[input_position];
         input_position++;
-        dot_array[(width * 2) - 1] = dot_stream[input_position];
+        d[pw + width - 1] = dot_stream[input_position];
         input_position++;
-        dot_array[((height - 1) * width) - 1] = dot_stream[input_position];
+        d[((height - 2) * pw) + width - 1] = dot_stream[input_position];
         input_position++;
-        dot_array[0] = dot_stream[input_position];
+        d[0] = dot_stream[input_position];
         input_position++;
-        dot_array[(height - 1) * width] = dot_stream[input_position];
+        d[(height - 1) * pw] = dot_stream[input_position];
     } else {
         /* Vertical folding */
         for (column = 0; column < width; column++) {
             for (row = 0; row < height; row++) {
                 if (!((column + row) % 2)) {
                     if (is_corner(column, row, width, height)) {
-                        dot_array[(row * width) + column] = 'C';
+                        d[(row * pw) + column] = 0;
                     } else {
-                        dot_array[(row * width) + column] = dot_stream[input_position];
+                        d[(row * pw) + column] = dot_stream[input_position];
                         input_position++;
                     }
-                } else {
-                    dot_array[(row * width) + column] = ' '; // Non-data position
                 }
             }
         }
 
         /* Corners */
-        dot_array[((height - 1) * width) - 1] = dot_stream[input_position];
+        d[((height - 2) * pw) + width - 1] = dot_stream[input_position];
         input_position++;
-        dot_array[(height - 2) * width] = dot_stream[input_position];
+        d[(height - 2) * pw] = dot_stream[input_position];
         input_position++;
-        dot_array[(height * width) - 2] = dot_stream[input_position];
+        d[((height - 1) * pw) + width - 2] = dot_stream[input_position];
         input_position++;
-        dot_array[((height - 1) * width) + 1] = dot_stream[input_position];
+        d[((height - 1) * pw) + 1] = dot_stream[input_position];
         input_position++;
-        dot_array[width - 1] = dot_stream[input_position];
+        d[width - 1] = dot_stream[input_position];
         input_position++;
-        dot_array[0] = dot_stream[input_position];
+        d[0] = dot_stream[input_position];
     }
 }
 
@@ -1289,50 +1191,53 @@ static void apply_mask(const int mask, const int data_length, unsigned char *mas
     rsencode(data_length + 1, ecc_length, masked_codeword_array);
 }
 
-static void force_corners(const int width, const int height, char *dot_array) {
+/* Set the corner dots of the forced corner lanes (masks 4-7) */
+static void force_corners(const int width, const int height, unsigned char *dot_array) {
+    const int pw = width + DC_BORDER * 2; /* Bordered width */
+    unsigned char *const d = dot_array + DC_BORDER * pw + DC_BORDER; /* Top left dot */
+
     if (width % 2) {
         // "Vertical" symbol
-        dot_array[0] = '1';
-        dot_array[width - 1] = '1';
-        dot_array[(height - 2) * width] = '1';
-        dot_array[((height - 1) * width) - 1] = '1';
-        dot_array[((height - 1) * width) + 1] = '1';
-        dot_array[(height * width) - 2] = '1';
+        d[0] |= 0xF0;
+        d[width - 1] |= 0xF0;
+        d[(height - 2) * pw] |= 0xF0;
+        d[((height - 2) * pw) + width - 1] |= 0xF0;
+        d[((height - 1) * pw) + 1] |= 0xF0;
+        d[((height - 1) * pw) + width - 2] |= 0xF0;
     } else {
         // "Horizontal" symbol
-        dot_array[0] = '1';
-        dot_array[width - 2] = '1';
-        dot_array[(2 * width) - 1] = '1';
-        dot_array[((height - 1) * width) - 1] = '1';
-        dot_array[(height - 1) * width] = '1';
-        dot_array[(height * width) - 2] = '1';
+        d[0] |= 0xF0;
+        d[width - 2] |= 0xF0;
+        d[pw + width - 1] |= 0xF0;
+        d[((height - 2) * pw) + width - 1] |= 0xF0;
+        d[(height - 1) * pw] |= 0xF0;
+        d[((height - 1) * pw) + width - 2] |= 0xF0;
     }
 }
 
 INTERNAL int dotcode(struct zint_symbol *symbol, unsigned char source[], int length) {
     int i, j, k;
-    int jc, n_dots;
+    int n_dots;
     int data_length, ecc_length;
     int min_dots, min_area;
     int height, width;
-    int mask_score[8];
+    int mask_score[DC_LANES];
     int user_mask;
     int dot_stream_length;
+    int mask, lanes_start, lanes_end, lanes_size;
     int high_score, best_mask;
     int binary_finish = 0;
     int debug = symbol->debug;
-    int padding_dots, is_first;
+    int padding_dots, is_first, unpadded_length;
     /* Allow up to 4 codewords per input + 2 (FNC) + 4 (ECI) + 2 (special char 1st position) */
     int codeword_array_len = length * 4 + 8;
 
-#ifndef _MSC_VER
-    unsigned char codeword_array[codeword_array_len];
-#else
-    unsigned char *codeword_array = (unsigned char *) _alloca(codeword_array_len);
-    char *dot_stream;
-    char *dot_array;
-    unsigned char *masked_codeword_array;
-#endif /* _MSC_VER */
+    z_work_array(symbol, unsigned char, codeword_array, codeword_array_len);
+    z_work_array(symbol, int, digits, length + 1);
+
+    if (z_work_failed(codeword_array) || z_work_failed(digits)) {
+        return z_work_error(symbol);
+    }
 
     if (symbol->eci > 811799) {
         strcpy(symbol->errtxt, "525: Invalid ECI");
@@ -1344,7 +1249,8 @@ INTERNAL int dotcode(struct zint_symbol *symbol, unsigned char source[], int len
         user_mask = 0; /* Ignore */
     }
 
-    data_length = dotcode_encode_message(symbol, source, length, codeword_array, &binary_finish);
+    chr_runs(CHR_DIGIT, source, length, digits);
+    data_length = dotcode_encode_message(symbol, source, length, digits, codeword_array, &binary_finish);
 
     /* Suppresses clang-tidy clang-analyzer-core.UndefinedBinaryOperatorResult/uninitialized.ArraySubscript
      * warnings */
@@ -1445,17 +1351,19 @@ INTERNAL int dotcode(struct zint_symbol *symbol, unsigned char source[], int len
 
     n_dots = (height * width) / 2;
 
-#ifndef _MSC_VER
-    char dot_stream[height * width * 3];
-    char dot_array[width * height];
-#else
-    dot_stream = (char *) _alloca(height * width * 3);
-    dot_array = (char *) _alloca(width * height);
-#endif
+    lanes_size = (height + DC_BORDER * 2) * (width + DC_BORDER * 2);
+
+    z_work_array(symbol, unsigned char, dot_stream, n_dots);
+    z_work_array(symbol, unsigned char, dot_array, lanes_size);
+
+    if (z_work_failed(dot_stream) || z_work_failed(dot_array)) {
+        return z_work_error(symbol);
+    }
 
     /* Add pad characters */
     padding_dots = n_dots - min_dots; /* get the number of free dots available for padding */
     is_first = 1; /* first padding character flag */
+    unpadded_length = data_length;
 
     while (padding_dots >= 9) {
         if (padding_dots < 18 && ((data_length % 2) == 0))
@@ -1479,44 +1387,63 @@ INTERNAL int dotcode(struct zint_symbol *symbol, unsigned char source[], int len
     }
 
     ecc_length = 3 + (data_length / 2);
+    z_record(symbol, ZINT_PHASE_ENCODE, ZINT_RECORD_SIZE, 0, height, width, -1);
+    z_record(symbol, ZINT_PHASE_RS, ZINT_RECORD_CODEWORDS, data_length, ecc_length, unpadded_length, 0);
+    if (!(symbol->output_options & BARCODE_DOTTY_MODE)) {
+        symbol->output_options += BARCODE_DOTTY_MODE;
+    }
+    if (symbol->debug & ZINT_MEASURE_ONLY) {
+        return z_measured(symbol, height, width);
+    }
 
-#ifndef _MSC_VER
-    unsigned char masked_codeword_array[data_length + 1 + ecc_length];
-#else
-    masked_codeword_array = (unsigned char *) _alloca(data_length + 1 + ecc_length);
-#endif /* _MSC_VER */
+    z_work_array(symbol, unsigned char, masked_codeword_array, data_length + 1 + ecc_length);
+
+    if (z_work_failed(masked_codeword_array)) {
+        return z_work_error(symbol);
+    }
 
     if (user_mask) {
         best_mask = user_mask - 1;
-        if (debug & ZINT_DEBUG_PRINT) {
-            printf("Applying mask %d (specified)\n", best_mask);
-        }
+        lanes_start = best_mask % 4;
+        lanes_end = lanes_start + 1;
     } else {
-        /* Evaluate data mask options */
-        for (i = 0; i < 4; i++) {
+        best_mask = 0;
+        lanes_start = 0;
+        lanes_end = 4;
+    }
 
-            apply_mask(i, data_length, masked_codeword_array, codeword_array, ecc_length);
+    /* Make the dot stream of each mask in its own lanes, lit padding dots being common to all */
+    memset(dot_stream, 0, n_dots);
+    for (mask = lanes_start; mask < lanes_end; mask++) {
+        apply_mask(mask, data_length, masked_codeword_array, codeword_array, ecc_length);
 
-            dot_stream_length = make_dotstream(masked_codeword_array, (data_length + ecc_length + 1), dot_stream);
+        dot_stream_length = make_dotstream(masked_codeword_array, (data_length + ecc_length + 1),
+                                (unsigned char) (0x11 << mask), dot_stream);
+    }
+    assert(dot_stream_length <= n_dots);
 
-            /* Add pad bits */
-            for (jc = dot_stream_length; jc < n_dots; jc++) {
-                strcat(dot_stream, "1");
-            }
+    /* Add pad bits */
+    memset(dot_stream + dot_stream_length, 0xFF, n_dots - dot_stream_length);
+
+    fold_dotstream(dot_stream, width, height, dot_array);
 
-            fold_dotstream(dot_stream, width, height, dot_array);
+    force_corners(width, height, dot_array);
 
-            mask_score[i] = score_array(dot_array, height, width);
+    if (user_mask) {
+        if (debug & ZINT_DEBUG_PRINT) {
+            printf("Applying mask %d (specified)\n", best_mask);
+        }
+    } else {
+        /* Evaluate data mask options, with and without forced corners, all at once */
+        score_arrays(dot_array, height, width, mask_score);
 
+        high_score = INT_MIN;
+        for (i = 0; i < 4; i++) {
             if (debug & ZINT_DEBUG_PRINT) {
                 printf("Mask %d score is %d\n", i, mask_score[i]);
             }
-        }
+            z_record(symbol, ZINT_PHASE_MASK, ZINT_RECORD_PENALTY, i, mask_score[i], 0, 0);
 
-        high_score = mask_score[0];
-        best_mask = 0;
-
-        for (i = 1; i < 4; i++) {
             if (mask_score[i] >= high_score) {
                 high_score = mask_score[i];
                 best_mask = i;
@@ -1529,29 +1456,12 @@ INTERNAL int dotcode(struct zint_symbol *symbol, unsigned char source[], int len
                 printf("High score %d <= %d (height * width) / 2\n", high_score, (height * width) / 2);
             }
 
-            for (i = 0; i < 4; i++) {
-
-                apply_mask(i, data_length, masked_codeword_array, codeword_array, ecc_length);
-
-                dot_stream_length = make_dotstream(masked_codeword_array, (data_length + ecc_length + 1), dot_stream);
-
-                /* Add pad bits */
-                for (jc = dot_stream_length; jc < n_dots; jc++) {
-                    strcat(dot_stream, "1");
-                }
-
-                fold_dotstream(dot_stream, width, height, dot_array);
-
-                force_corners(width, height, dot_array);
-
-                mask_score[i + 4] = score_array(dot_array, height, width);
-
+            for (i = 4; i < 8; i++) {
                 if (debug & ZINT_DEBUG_PRINT) {
-                    printf("Mask %d score is %d\n", i + 4, mask_score[i + 4]);
+                    printf("Mask %d score is %d\n", i, mask_score[i]);
                 }
-            }
+                z_record(symbol, ZINT_PHASE_MASK, ZINT_RECORD_PENALTY, i, mask_score[i], 0, 0);
 
-            for (i = 4; i < 8; i++) {
                 if (mask_score[i] >= high_score) {
                     high_score = mask_score[i];
                     best_mask = i;
@@ -1563,39 +1473,21 @@ INTERNAL int dotcode(struct zint_symbol *symbol, unsigned char source[], int len
             printf("Applying mask %d, high_score %d\n", best_mask, high_score);
         }
     }
-
-    /* Apply best mask */
-    apply_mask(best_mask % 4, data_length, masked_codeword_array, codeword_array, ecc_length);
-
-    dot_stream_length = make_dotstream(masked_codeword_array, (data_length + ecc_length + 1), dot_stream);
-
-    /* Add pad bits */
-    for (jc = dot_stream_length; jc < n_dots; jc++) {
-        strcat(dot_stream, "1");
-    }
-
-    fold_dotstream(dot_stream, width, height, dot_array);
-
-    if (best_mask >= 4) {
-        force_corners(width, height, dot_array);
-    }
+    z_record(symbol, ZINT_PHASE_MASK, ZINT_RECORD_MASK, best_mask, user_mask ? -1 : high_score, !!user_mask, 0);
 
     /* Copy values to symbol */
     symbol->width = width;
     symbol->rows = height;
 
     for (k = 0; k < height; k++) {
+        const unsigned char *const row = dot_array + (k + DC_BORDER) * (width + DC_BORDER * 2) + DC_BORDER;
         for (j = 0; j < width; j++) {
-            if (dot_array[(k * width) + j] == '1') {
+            if (row[j] & (1 << best_mask)) {
                 set_module(symbol, k, j);
             }
         }
         symbol->row_height[k] = 1;
     }
 
-    if (!(symbol->output_options & BARCODE_DOTTY_MODE)) {
-        symbol->output_options += BARCODE_DOTTY_MODE;
-    }
-
     return 0;
 }
@@ -37,9 +37,15 @@
 #include "eci.h"
 #include "eci_sb.h"
 #include "sjis.h"
-#include "big5.h"
 #include "gb2312.h"
+#ifndef NO_CJK
+#include "big5.h"
 #include "ksx1001.h"
+#else
+/* Multibyte tables excluded so no mappings */
+#define big5_wctomb_zint(r, wc) ((void) (r), (void) (wc), 0)
+#define ksx1001_wctomb_zint(r, wc) ((void) (r), (void) (wc), 0)
+#endif
 
 /* ECI 20 Shift JIS */
 static int sjis_wctomb(unsigned char *r, const unsigned int wc) {
@@ -176,57 +182,80 @@ INTERNAL int get_eci_length(const int eci, const unsigned char source[], int len
     return length;
 }
 
+typedef int (*eci_func_t)(unsigned char *r, const unsigned int wc);
+
+/* Conversion functions indexed by ECI (ECIs 0 to 24 other than Shift JIS 20 are single-byte and table-driven, see
+   `utf8_to_eci_sb()`) */
+static const eci_func_t eci_funcs[31] = {
+                 NULL,              NULL,              NULL,              NULL,              NULL,
+                 NULL,              NULL,              NULL,              NULL,              NULL,
+                 NULL,              NULL,              NULL,              NULL,              NULL,
+                 NULL,              NULL,              NULL,              NULL,              NULL,
+          sjis_wctomb,              NULL,              NULL,              NULL,              NULL,
+        ucs2be_wctomb,              NULL,      ascii_wctosb,       big5_wctomb,     gb2312_wctomb,
+        euc_kr_wctomb,
+};
+
+/* Bitmask of the table-driven single-byte ECIs 3 to 24 (excluding reserved 14 & 19 and Shift JIS 20) */
+#define ECI_SB_MASK 0x1E7BFF8
+
+/* Convert a whole UTF-8 string to single-byte ECI 3 to 24 using the direct tables of "eci_sb.h", copying runs of ASCII
+   straight through */
+static int utf8_to_eci_sb(const int eci, const unsigned char source[], unsigned char dest[], int *p_length) {
+    const unsigned char *const index = ECI_SB_INDEX(eci);
+    const int length = *p_length;
+    unsigned int codepoint, state = 0;
+    int in_posn = 0;
+    int out_posn = 0;
+
+    while (in_posn < length) {
+        unsigned char c;
+        if (source[in_posn] < 0x80) {
+            dest[out_posn++] = source[in_posn++];
+            continue;
+        }
+        do {
+            decode_utf8(&state, &codepoint, source[in_posn++]);
+        } while (in_posn < length && state != 0 && state != 12);
+        if (state != 0) {
+            return ZINT_ERROR_INVALID_DATA;
+        }
+        if ((c = ECI_SB_WCTOSB(index, codepoint)) == 0) {
+            return ZINT_ERROR_INVALID_DATA;
+        }
+        dest[out_posn++] = c;
+    }
+    dest[out_posn] = '\0';
+    *p_length = out_posn;
+
+    return 0;
+}
+
 /* Convert UTF-8 Unicode to other character encodings */
 INTERNAL int utf8_to_eci(const int eci, const unsigned char source[], unsigned char dest[], int *p_length) {
 
-    typedef int (*eci_func_t)(unsigned char *r, const unsigned int wc);
-    static const eci_func_t eci_funcs[31] = {
-                     NULL,              NULL,              NULL,              NULL,  iso8859_2_wctosb,
-         iso8859_3_wctosb,  iso8859_4_wctosb,  iso8859_5_wctosb,  iso8859_6_wctosb,  iso8859_7_wctosb,
-         iso8859_8_wctosb,  iso8859_9_wctosb, iso8859_10_wctosb, iso8859_11_wctosb,              NULL,
-        iso8859_13_wctosb, iso8859_14_wctosb, iso8859_15_wctosb, iso8859_16_wctosb,              NULL,
-              sjis_wctomb,     cp1250_wctosb,     cp1251_wctosb,     cp1252_wctosb,     cp1256_wctosb,
-            ucs2be_wctomb,              NULL,      ascii_wctosb,       big5_wctomb,     gb2312_wctomb,
-            euc_kr_wctomb,
-    };
     eci_func_t eci_func;
     unsigned int codepoint, state;
     int in_posn;
     int out_posn;
     int length = *p_length;
 
-    in_posn = 0;
-    out_posn = 0;
-
-    /* Special case ISO/IEC 8859-1 */
-    if (eci == 0 || eci == 3) { /* Default ECI 0 to ISO/IEC 8859-1 */
-        state = 0;
-        while (in_posn < length) {
-            do {
-                decode_utf8(&state, &codepoint, source[in_posn++]);
-            } while (in_posn < length && state != 0 && state != 12);
-            if (state != 0) {
-                return ZINT_ERROR_INVALID_DATA;
-            }
-            if (codepoint >= 0x80 && (codepoint < 0x00a0 || codepoint >= 0x0100)) {
-                return ZINT_ERROR_INVALID_DATA;
-            }
-            dest[out_posn++] = (unsigned char) codepoint;
-        }
-        dest[out_posn] = '\0';
-        *p_length = out_posn;
-        return 0;
+    /* Default ECI 0 to ISO/IEC 8859-1 */
+    if (eci == 0 || (eci <= 24 && (ECI_SB_MASK & (1 << eci)))) {
+        return utf8_to_eci_sb(eci == 0 ? 3 : eci, source, dest, p_length);
     }
 
     if (eci == 170) { /* ASCII Invariant (archaic subset) */
         eci_func = ascii_invariant_wctosb;
     } else {
-        eci_func = eci_funcs[eci];
+        eci_func = eci > 30 ? NULL : eci_funcs[eci];
         if (eci_func == NULL) {
             return ZINT_ERROR_INVALID_DATA;
         }
     }
 
+    in_posn = 0;
+    out_posn = 0;
     state = 0;
     while (in_posn < length) {
         int incr;
@@ -248,32 +277,172 @@ INTERNAL int utf8_to_eci(const int eci, const unsigned char source[], unsigned c
     return 0;
 }
 
+/* Bitmask of the single-byte ECIs that encode each of U+00A0..U+00FF */
+static const unsigned int eci_sb_latin1_masks[96] = {
+    0x1E7BFF8, 0x820808, 0x1828C08, 0x1838E28, 0x1E08D78, 0x1820C08, 0x1E08E08, 0x1E79EF8,
+    0x1A00E78, 0x1E78E08, 0x820808, 0x1E68E08, 0x1E28E08, 0x1E79FF8, 0x1E38C08, 0x1820C48,
+    0x1E69E78, 0x1E68E08, 0x1828E28, 0x1828E28, 0x1A00C78, 0x1E28C28, 0x1E78C08, 0x1E69E28,
+    0x1A00C78, 0x1828C08, 0x820808, 0x1E68E08, 0x1808C08, 0x1808E28, 0x1808C08, 0x820808,
+    0x870828, 0xA71878, 0xA71878, 0x831848, 0xA79878, 0x839848, 0x879848, 0xA70838,
+    0x870828, 0xA79878, 0x870828, 0xA71878, 0x870828, 0xA71878, 0xA71878, 0x871828,
+    0x821008, 0x830828, 0x870828, 0xA79838, 0xA71878, 0x839848, 0xA79878, 0x1A28C78,
+    0x839848, 0x870828, 0xA71878, 0x871868, 0xA79878, 0xA31018, 0x821008, 0xA79878,
+    0x1870828, 0xA71878, 0x1A71878, 0x831848, 0xA79878, 0x839848, 0x879848, 0x1A70838,
+    0x1870828, 0x1A79878, 0x1870828, 0x1A71878, 0x870828, 0xA71878, 0x1A71878, 0x1871828,
+    0x821008, 0x830828, 0x870828, 0xA79838, 0x1A71878, 0x839848, 0xA79878, 0x1A28C78,
+    0x839848, 0x1870828, 0xA71878, 0x1871868, 0x1A79878, 0xA31018, 0x821008, 0x870808,
+};
+
 /* Find the lowest single-byte ECI mode which will encode a given set of Unicode text */
 INTERNAL int get_best_eci(const unsigned char source[], int length) {
-    int eci = 3;
+    /* Intersect, in one pass, the ECIs able to encode each character */
+    unsigned int eci_mask = ECI_SB_MASK;
+    unsigned int codepoint, state = 0;
+    int eci, i;
+
+    for (i = 0; i < length; i++) {
+        if (decode_utf8(&state, &codepoint, source[i]) != 0) {
+            if (state == 12) {
+                return 0;
+            }
+            continue;
+        }
+        if (codepoint < 0x80 || !eci_mask) {
+            continue;
+        }
+        if (codepoint >= 0xA0 && codepoint <= 0xFF) {
+            eci_mask &= eci_sb_latin1_masks[codepoint - 0xA0];
+        } else {
+            eci_mask &= ~(1 << 3); /* ISO/IEC 8859-1 only covers U+00A0..U+00FF */
+            for (eci = 4; eci <= 24; eci++) {
+                if ((eci_mask & (1 << eci)) && !ECI_SB_WCTOSB(ECI_SB_INDEX(eci), codepoint)) {
+                    eci_mask &= ~(1 << eci);
+                }
+            }
+        }
+    }
+    if (state != 0) {
+        return 0;
+    }
 
-    /* Note: attempting single-byte conversions only, so get_eci_length() unnecessary */
-#ifndef _MSC_VER
-    unsigned char local_source[length + 1];
-#else
-    unsigned char *local_source = (unsigned char *) _alloca(length + 1);
-#endif
+    if (eci_mask) {
+        for (eci = 3; !(eci_mask & (1 << eci)); eci++);
+        return eci;
+    }
+
+    return 26; // If all of these fail, use Unicode!
+}
+
+/* Candidate ECIs of `get_best_eci_segs()` - the single-byte ECIs of `ECI_SB_MASK` and UTF-8 */
+static const unsigned char eci_seg_cands[20] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 15, 16, 17, 18, 21, 22, 23, 24, 26
+};
+
+#define ECI_SEG_CANDS       20
+#define ECI_SEG_UTF8        19 /* Index of ECI 26 in `eci_seg_cands` */
+#define ECI_SEG_BEST_BITS   5 /* Low bits of a `get_best_eci_segs()` decision, the cheapest candidate before */
+#define ECI_SEG_INF         0x3FFFFFFF
+
+/* Split UTF-8 `source` into segments of different ECIs, chosen to minimise the total bit cost of the data with each
+   character costing 8 bits per byte in its ECI and a change of ECI `switch_bits`, by a DP over the candidate ECIs.
+   ECI 3 (ISO/IEC 8859-1) is the default so costs nothing to start with. Returns the number of segments placed in
+   `segs`, or 0 if the data isn't valid UTF-8, memory allocation failed or there would be more than
+   ZINT_ECI_SEGS_MAX segments */
+INTERNAL int get_best_eci_segs(struct zint_symbol *symbol, const unsigned char source[], const int length,
+                const int switch_bits, struct zint_eci_segs *segs) {
+    unsigned int cost[ECI_SEG_CANDS];
+    unsigned int switched; /* Cost of switching from the cheapest before a character */
+    unsigned int codepoint, state = 0;
+    int best = 0;
+    int i, c, start, seg_end, count;
+
+    /* For each character start, the candidates switched to before it and the cheapest candidate before that */
+    z_work_array(symbol, unsigned int, decisions, length + 1);
+
+    (void) symbol; /* Unused unless ZINT_BOUNDED_STACK */
+
+    if (z_work_failed(decisions) || length == 0) {
+        return 0;
+    }
+
+    for (c = 0; c < ECI_SEG_CANDS; c++) {
+        cost[c] = eci_seg_cands[c] == 3 ? 0 : switch_bits;
+    }
 
-    do {
-        if (eci == 14) { /* Reserved */
-            eci = 15;
-        } else if (eci == 19) { /* Reserved */
-            eci = 21; /* Skip 20 Shift JIS */
+    for (i = 0, start = 0; i < length; i++) {
+        unsigned int decision;
+        if (decode_utf8(&state, &codepoint, source[i]) != 0) {
+            if (state == 12) {
+                return 0;
+            }
+            continue;
         }
-        if (utf8_to_eci(eci, source, local_source, &length) == 0) {
-            return eci;
+        decision = best;
+        switched = cost[best] + switch_bits;
+        for (c = 0; c < ECI_SEG_CANDS; c++) {
+            if (start != 0 && switched < cost[c]) {
+                cost[c] = switched;
+                decision |= 1 << (ECI_SEG_BEST_BITS + c);
+            }
+            if (cost[c] != ECI_SEG_INF) {
+                if (c == ECI_SEG_UTF8) {
+                    cost[c] += (i + 1 - start) * 8;
+                } else if (codepoint < 0x80 || ECI_SB_WCTOSB(ECI_SB_INDEX(eci_seg_cands[c]), codepoint)) {
+                    cost[c] += 8;
+                } else {
+                    cost[c] = ECI_SEG_INF;
+                }
+            }
         }
-        eci++;
-    } while (eci < 25);
-
-    if (!is_valid_utf8(source, length)) {
+        decisions[start] = decision;
+        for (c = 1, best = 0; c < ECI_SEG_CANDS; c++) {
+            if (cost[c] < cost[best]) {
+                best = c;
+            }
+        }
+        start = i + 1;
+    }
+    if (state != 0) {
         return 0;
     }
 
-    return 26; // If all of these fail, use Unicode!
+    /* Trace back from the cheapest at the end, segments coming out last first */
+    count = 0;
+    seg_end = length;
+    c = best;
+    for (i = length - 1; i >= 0; i--) {
+        if ((source[i] & 0xC0) == 0x80) { /* UTF-8 continuation byte */
+            continue;
+        }
+        if (i == 0 || (decisions[i] & (1 << (ECI_SEG_BEST_BITS + c)))) {
+            if (count == ZINT_ECI_SEGS_MAX) {
+                return 0;
+            }
+            segs->segs[count].eci = eci_seg_cands[c];
+            segs->segs[count].start = i;
+            segs->segs[count].length = seg_end - i;
+            count++;
+            seg_end = i;
+            c = decisions[i] & ((1 << ECI_SEG_BEST_BITS) - 1);
+        }
+    }
+    for (i = 0; i < count / 2; i++) {
+        const struct zint_eci_seg seg = segs->segs[i];
+        segs->segs[i] = segs->segs[count - 1 - i];
+        segs->segs[count - 1 - i] = seg;
+    }
+    segs->count = count;
+
+    return count;
+}
+
+/* Page in the single-byte, Big5 and KS X 1001 conversion tables (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t eci_tables_warm(const int touch) {
+    return z_table_warm(eci_sb_blocks, sizeof(eci_sb_blocks), touch)
+            + z_table_warm(eci_sb_block_index, sizeof(eci_sb_block_index), touch)
+            + z_table_warm(big5_2charset, sizeof(big5_2charset), touch)
+            + z_table_warm(big5_uni2indx_page4e, sizeof(big5_uni2indx_page4e), touch)
+            + z_table_warm(ksc5601_2charset, sizeof(ksc5601_2charset), touch)
+            + z_table_warm(ksc5601_uni2indx_page4e, sizeof(ksc5601_uni2indx_page4e), touch)
+            + z_table_warm(ksc5601_uni2indx_pageac, sizeof(ksc5601_uni2indx_pageac), touch);
 }
@@ -37,10 +37,24 @@
 extern "C" {
 #endif
 
+#define ZINT_ECI_SEGS_MAX   32 /* Maximum number of ECI segments chosen by `get_best_eci_segs()` */
+
+/* ECI segments of UTF-8 data, with `start` and `length` in bytes */
+struct zint_eci_segs {
+    int count;
+    struct zint_eci_seg {
+        int eci;
+        int start;
+        int length;
+    } segs[ZINT_ECI_SEGS_MAX];
+};
+
 INTERNAL int is_eci_convertible(const int eci);
 INTERNAL int get_eci_length(const int eci, const unsigned char source[], int length);
 INTERNAL int utf8_to_eci(const int eci, const unsigned char source[], unsigned char dest[], int *p_length);
 INTERNAL int get_best_eci(const unsigned char source[], int length);
+INTERNAL int get_best_eci_segs(struct zint_symbol *symbol, const unsigned char source[], const int length,
+                const int switch_bits, struct zint_eci_segs *segs);
 
 #ifdef __cplusplus
 }
@@ -36,81 +36,22 @@
 #include <stdio.h>
 #include <assert.h>
 #include <math.h>
-#ifdef _MSC_VER
-#include <malloc.h>
-#endif
 #include "common.h"
+#include "filemem.h"
+#include "output.h"
 #include "emf.h"
 
-static int count_rectangles(struct zint_symbol *symbol) {
-    int rectangles = 0;
-    struct zint_vector_rect *rect;
-
-    rect = symbol->vector->rectangles;
-    while (rect) {
-        rectangles++;
-        rect = rect->next;
-    }
-
-    return rectangles;
-}
-
-static int count_circles(struct zint_symbol *symbol) {
-    int circles = 0;
-    struct zint_vector_circle *circ;
-
-    circ = symbol->vector->circles;
-    while (circ) {
-        circles++;
-        circ = circ->next;
-    }
-
-    return circles;
-}
-
-static int count_hexagons(struct zint_symbol *symbol) {
-    int hexagons = 0;
-    struct zint_vector_hexagon *hex;
-
-    hex = symbol->vector->hexagons;
-    while (hex) {
-        hexagons++;
-        hex = hex->next;
-    }
-
-    return hexagons;
-}
-
-static int count_strings(struct zint_symbol *symbol, float *fsize, float *fsize2, int *halign, int *halign1,
-            int *halign2) {
-    int strings = 0;
-    struct zint_vector_string *str;
-
-    *fsize = *fsize2 = 0.0f;
-    *halign = *halign1 = *halign2 = 0;
-
-    str = symbol->vector->strings;
-    while (str) {
-        /* Allow 2 font sizes */
-        if (*fsize == 0.0f) {
-            *fsize = str->fsize;
-        } else if (str->fsize != *fsize && *fsize2 == 0.0f) {
-            *fsize2 = str->fsize;
-        }
-        /* Only 3 haligns possible */
-        if (str->halign) {
-            if (str->halign == 1) {
-                *halign1 = str->halign;
-            } else {
-                *halign2 = str->halign;
-            }
-        }
-        strings++;
-        str = str->next;
-    }
+/* Records are built in a single pass over the vector lists into memory buffers, which are assembled in drawing
+   order once the objects used (colours, fonts) and record counts are known, and only then output */
+#define EMF_FM_COLOUR   0 /* 8 buffers for Ultracode rectangles by colour, colour 1 to 8 */
+#define EMF_FM_SHAPES   8 /* Foreground rectangles, hexagons and circles */
+#define EMF_FM_TEXT     9 /* 2 buffers for text by font size, 1st size and 2nd size */
+#define EMF_FM_COUNTS   11 /* 9 buffers for EMF_COMPACT polypolygon counts, by colour slot */
+#define EMF_FM_POINTS   20 /* 9 buffers for EMF_COMPACT polypolygon points, by colour slot */
+#define EMF_FM_OUT      29 /* Assembled records after header */
+#define EMF_FM_NUM      30
 
-    return strings;
-}
+#define EMF_POLY_SLOTS  9 /* Ultracode colours 1 to 8 in slots 0 to 7, foreground in slot 8 */
 
 static void utfle_copy(unsigned char *output, unsigned char *input, int length) {
     int i;
@@ -158,26 +99,146 @@ static int utfle_length(unsigned char *input, int length) {
     return result;
 }
 
+/* Write `record` of `size` bytes to `fmp`, incrementing record count */
+static void emf_put_record(const void *record, const size_t size, struct filemem *fmp, int *p_recordcount) {
+    fm_write(record, size, 1, fmp);
+    (*p_recordcount)++;
+}
+
+/* Write EMR_SELECTOBJECT for object `ih_object` */
+static void emf_put_selectobject(const uint32_t ih_object, struct filemem *fmp, int *p_recordcount) {
+    emr_selectobject_t emr_selectobject;
+
+    emr_selectobject.type = 0x00000025; // EMR_SELECTOBJECT
+    emr_selectobject.size = 12;
+    emr_selectobject.ih_object = ih_object;
+    emf_put_record(&emr_selectobject, sizeof(emr_selectobject_t), fmp, p_recordcount);
+}
+
+/* Write EMR_CREATEBRUSHINDIRECT for solid brush `ih_brush` */
+static void emf_put_createbrush(const uint32_t ih_brush, const int red, const int green, const int blue,
+            struct filemem *fmp, int *p_recordcount) {
+    emr_createbrushindirect_t emr_createbrushindirect;
+
+    emr_createbrushindirect.type = 0x00000027; // EMR_CREATEBRUSHINDIRECT
+    emr_createbrushindirect.size = 24;
+    emr_createbrushindirect.ih_brush = ih_brush;
+    emr_createbrushindirect.log_brush.brush_style = 0x0000; // BS_SOLID
+    emr_createbrushindirect.log_brush.color.red = red;
+    emr_createbrushindirect.log_brush.color.green = green;
+    emr_createbrushindirect.log_brush.color.blue = blue;
+    emr_createbrushindirect.log_brush.color.reserved = 0;
+    emr_createbrushindirect.log_brush.brush_hatch = 0x0006; // HS_SOLIDCLR
+    emf_put_record(&emr_createbrushindirect, sizeof(emr_createbrushindirect_t), fmp, p_recordcount);
+}
+
+/* Write EMR_SETTEXTALIGN for `halign` (0 centre, 1 left, 2 right) */
+static void emf_put_textalign(const int halign, struct filemem *fmp, int *p_recordcount) {
+    emr_settextalign_t emr_settextalign;
+
+    emr_settextalign.type = 0x00000016; // EMR_SETTEXTALIGN
+    emr_settextalign.size = 12;
+    if (halign == 0) {
+        emr_settextalign.text_alignment_mode = 0x0006 | 0x0018; // TA_CENTER | TA_BASELINE
+    } else if (halign == 1) {
+        emr_settextalign.text_alignment_mode = 0x0000 | 0x0018; // TA_LEFT | TA_BASELINE
+    } else {
+        emr_settextalign.text_alignment_mode = 0x0002 | 0x0018; // TA_RIGHT | TA_BASELINE
+    }
+    emf_put_record(&emr_settextalign, sizeof(emr_settextalign_t), fmp, p_recordcount);
+}
+
+/* Add polygon of `count` `points` to polypolygon count and point buffers, updating `bounds` */
+static void emf_poly_add(const point_l_t *points, const int count, struct filemem *counts_fmp,
+            struct filemem *points_fmp, rect_l_t *bounds) {
+    const uint32_t count32 = count;
+    int i;
+
+    if (counts_fmp->memend == 0) {
+        bounds->left = bounds->right = points[0].x;
+        bounds->top = bounds->bottom = points[0].y;
+    }
+    for (i = 0; i < count; i++) {
+        if (points[i].x < bounds->left) {
+            bounds->left = points[i].x;
+        } else if (points[i].x > bounds->right) {
+            bounds->right = points[i].x;
+        }
+        if (points[i].y < bounds->top) {
+            bounds->top = points[i].y;
+        } else if (points[i].y > bounds->bottom) {
+            bounds->bottom = points[i].y;
+        }
+    }
+    fm_write(&count32, sizeof(uint32_t), 1, counts_fmp);
+    fm_write(points, sizeof(point_l_t), count, points_fmp);
+}
+
+/* Write EMR_POLYPOLYGON16 (or EMR_POLYPOLYGON if `bounds` exceed 16 bits) from polypolygon count and point
+   buffers, if any */
+static void emf_poly_put(const struct filemem *counts_fmp, const struct filemem *points_fmp, const rect_l_t *bounds,
+            struct filemem *fmp, int *p_recordcount) {
+    emr_polypolygon_t emr_polypolygon;
+    const int use_16 = bounds->left >= -32768 && bounds->top >= -32768 && bounds->right <= 32767
+                        && bounds->bottom <= 32767;
+    size_t i;
+
+    if (counts_fmp->memend == 0 || fm_error(counts_fmp) || fm_error(points_fmp)) {
+        return;
+    }
+    emr_polypolygon.type = use_16 ? 0x0000005b : 0x00000008; // EMR_POLYPOLYGON16 : EMR_POLYPOLYGON
+    emr_polypolygon.size = (uint32_t) (sizeof(emr_polypolygon_t) + counts_fmp->memend
+                                        + (use_16 ? points_fmp->memend / 2 : points_fmp->memend));
+    emr_polypolygon.bounds = *bounds;
+    emr_polypolygon.n_polys = (uint32_t) (counts_fmp->memend / sizeof(uint32_t));
+    emr_polypolygon.count = (uint32_t) (points_fmp->memend / sizeof(point_l_t));
+    emf_put_record(&emr_polypolygon, sizeof(emr_polypolygon_t), fmp, p_recordcount);
+    fm_write(counts_fmp->mem, 1, counts_fmp->memend, fmp);
+    if (use_16) {
+        const point_l_t *points = (const point_l_t *) points_fmp->mem;
+        for (i = 0; i < emr_polypolygon.count; i++) {
+            point_s_t point_s;
+            point_s.x = (int16_t) points[i].x;
+            point_s.y = (int16_t) points[i].y;
+            fm_write(&point_s, sizeof(point_s_t), 1, fmp);
+        }
+    } else {
+        fm_write(points_fmp->mem, 1, points_fmp->memend, fmp);
+    }
+}
+
+/* Free any memory buffers */
+static void emf_free_mem(struct filemem fms[EMF_FM_NUM]) {
+    int i;
+
+    for (i = 0; i < EMF_FM_NUM; i++) {
+        z_free(fms[i].allocator, fms[i].mem);
+    }
+}
+
 INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
     int i;
-    FILE *emf_file;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
+    struct filemem fms[EMF_FM_NUM] = {{0}};
+    struct filemem *const shapes_fmp = &fms[EMF_FM_SHAPES];
+    struct filemem *const out_fmp = &fms[EMF_FM_OUT];
+    rect_l_t poly_bounds[EMF_POLY_SLOTS];
+    point_l_t points[6];
     int fgred, fggrn, fgblu, bgred, bggrn, bgblu;
     int error_number = 0;
-    int rectangle_count, this_rectangle;
-    int circle_count, this_circle;
-    int hexagon_count, this_hexagon;
-    int string_count, this_text;
-    int bytecount, recordcount;
+    int recordcount;
     float previous_diameter;
     float radius, half_radius, half_sqrt3_radius;
-    int colours_used = 0;
-    int rectangle_count_bycolour[9];
-    unsigned char *this_string[6];
+    int colour_used[8] = {0}; // Ultracode colours 1 to 8
+    int slot;
+    unsigned char *this_string;
     int width, height;
     int utfle_len;
     int bumped_len;
     int draw_background = 1;
     int bold;
+    const int compact = symbol->output_options & EMF_COMPACT;
 
     float ax, ay, bx, by, cx, cy, dx, dy, ex, ey, fx, fy;
 
@@ -190,291 +251,77 @@ INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
     emr_eof_t emr_eof;
     emr_mapmode_t emr_mapmode;
     emr_setworldtransform_t emr_setworldtransform;
-    emr_createbrushindirect_t emr_createbrushindirect_fg;
-    emr_createbrushindirect_t emr_createbrushindirect_bg;
-    emr_createbrushindirect_t emr_createbrushindirect_colour[8]; // Used for colour symbols only
-    emr_selectobject_t emr_selectobject_fgbrush;
-    emr_selectobject_t emr_selectobject_bgbrush;
-    emr_selectobject_t emr_selectobject_colour[8]; // Used for colour symbols only
     emr_createpen_t emr_createpen;
-    emr_selectobject_t emr_selectobject_pen;
-    emr_rectangle_t background;
+    emr_rectangle_t rectangle;
+    emr_ellipse_t circle;
+    emr_polygon_t hexagon;
+    emr_exttextoutw_t text;
     emr_settextcolor_t emr_settextcolor;
-
-    float fsize;
     emr_extcreatefontindirectw_t emr_extcreatefontindirectw;
-    emr_selectobject_t emr_selectobject_font;
-    float fsize2;
-    emr_extcreatefontindirectw_t emr_extcreatefontindirectw2;
-    emr_selectobject_t emr_selectobject_font2;
-    int halign;
-    emr_settextalign_t emr_settextalign;
-    int halign1;
-    emr_settextalign_t emr_settextalign1;
-    int halign2;
-    emr_settextalign_t emr_settextalign2;
-
-    float current_fsize;
-    int current_halign;
-
-#ifdef _MSC_VER
-    emr_rectangle_t *rectangle;
-    emr_ellipse_t *circle;
-    emr_polygon_t *hexagon;
-    emr_exttextoutw_t *text;
-    float *text_fsizes;
-    int *text_haligns;
-#endif
-
-    fgred = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
-    fggrn = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
-    fgblu = (16 * ctoi(symbol->fgcolour[4])) + ctoi(symbol->fgcolour[5]);
-    bgred = (16 * ctoi(symbol->bgcolour[0])) + ctoi(symbol->bgcolour[1]);
-    bggrn = (16 * ctoi(symbol->bgcolour[2])) + ctoi(symbol->bgcolour[3]);
-    bgblu = (16 * ctoi(symbol->bgcolour[4])) + ctoi(symbol->bgcolour[5]);
+
+    float fsize = 0.0f, fsize2 = 0.0f; // Only 2 font sizes allowed, the 1st and 1st different
+    int text_halign[2] = { -1, -1 }; // Current alignment of each font size buffer
+    int text_halign2_first = -1; // Alignment of 1st 2nd font size string, selected on assembly
+
+    fgred = OUT_RED(symbol->fgcolour_rgba);
+    fggrn = OUT_GREEN(symbol->fgcolour_rgba);
+    fgblu = OUT_BLUE(symbol->fgcolour_rgba);
+    bgred = OUT_RED(symbol->bgcolour_rgba);
+    bggrn = OUT_GREEN(symbol->bgcolour_rgba);
+    bgblu = OUT_BLUE(symbol->bgcolour_rgba);
     
-    if (strlen(symbol->bgcolour) > 6) {
-        if ((ctoi(symbol->bgcolour[6]) == 0) && (ctoi(symbol->bgcolour[7]) == 0)) {
-            draw_background = 0;
-        }
+    if (OUT_ALPHA(symbol->bgcolour_rgba) == 0) {
+        draw_background = 0;
     }
 
-    rectangle_count = count_rectangles(symbol);
-    circle_count = count_circles(symbol);
-    hexagon_count = count_hexagons(symbol);
-    string_count = count_strings(symbol, &fsize, &fsize2, &halign, &halign1, &halign2);
-
-#ifndef _MSC_VER
-    // Avoid sanitize runtime error by making always non-zero
-    emr_rectangle_t rectangle[rectangle_count ? rectangle_count : 1];
-    emr_ellipse_t circle[circle_count ? circle_count : 1];
-    emr_polygon_t hexagon[hexagon_count ? hexagon_count : 1];
-    emr_exttextoutw_t text[string_count ? string_count: 1];
-    float text_fsizes[string_count ? string_count: 1];
-    int text_haligns[string_count ? string_count: 1];
-#else
-    rectangle = (emr_rectangle_t*) _alloca(rectangle_count * sizeof (emr_rectangle_t));
-    circle = (emr_ellipse_t*) _alloca(circle_count * sizeof (emr_ellipse_t));
-    hexagon = (emr_polygon_t*) _alloca(hexagon_count * sizeof (emr_polygon_t));
-    text = (emr_exttextoutw_t*) _alloca(string_count * sizeof (emr_exttextoutw_t));
-    text_fsizes = (float *) _alloca(string_count * sizeof (float));
-    text_haligns = (int *) _alloca(string_count * sizeof (int));
-#endif
-
-    //Calculate how many coloured rectangles
-    if (symbol->symbology == BARCODE_ULTRA) {
-        for (i = 0; i <= 8; i++) {
-            rectangle_count_bycolour[i] = 0;
-        }
-
-        rect = symbol->vector->rectangles;
-        while (rect) {
-            if (rectangle_count_bycolour[rect->colour] == 0) {
-                colours_used++;
-            }
-            rectangle_count_bycolour[rect->colour]++;
-            rect = rect->next;
-        }
+    for (i = 0; i < EMF_FM_NUM; i++) {
+        fms[i].flags = BARCODE_MEMORY_FILE;
+        fms[i].allocator = z_allocator(symbol);
     }
+    recordcount = 1; // Header
 
     width = (int) ceil(symbol->vector->width);
     height = (int) ceil(symbol->vector->height);
 
-    /* Header */
-    emr_header.type = 0x00000001; // EMR_HEADER
-    emr_header.size = 108; // Including extensions
-    emr_header.emf_header.bounds.left = 0;
-    emr_header.emf_header.bounds.right = rotate_angle == 90 || rotate_angle == 270 ? height : width;
-    emr_header.emf_header.bounds.bottom = rotate_angle == 90 || rotate_angle == 270 ? width : height;
-    emr_header.emf_header.bounds.top = 0;
-    emr_header.emf_header.frame.left = 0;
-    emr_header.emf_header.frame.right = emr_header.emf_header.bounds.right * 30;
-    emr_header.emf_header.frame.top = 0;
-    emr_header.emf_header.frame.bottom = emr_header.emf_header.bounds.bottom * 30;
-    emr_header.emf_header.record_signature = 0x464d4520; // ENHMETA_SIGNATURE
-    emr_header.emf_header.version = 0x00010000;
-    if (symbol->symbology == BARCODE_ULTRA) {
-        emr_header.emf_header.handles = 11; // Number of graphics objects
-    } else {
-        emr_header.emf_header.handles = fsize2 != 0.0f ? 5 : 4;
-    }
-    emr_header.emf_header.reserved = 0x0000;
-    emr_header.emf_header.n_description = 0;
-    emr_header.emf_header.off_description = 0;
-    emr_header.emf_header.n_pal_entries = 0;
-    emr_header.emf_header.device.cx = 1000;
-    emr_header.emf_header.device.cy = 1000;
-    emr_header.emf_header.millimeters.cx = 300;
-    emr_header.emf_header.millimeters.cy = 300;
-    /* HeaderExtension1 */
-    emr_header.emf_header.cb_pixel_format = 0x0000; // None set
-    emr_header.emf_header.off_pixel_format = 0x0000; // None set
-    emr_header.emf_header.b_open_gl = 0x0000; // OpenGL not present
-    /* HeaderExtension2 */
-    emr_header.emf_header.micrometers.cx = 0;
-    emr_header.emf_header.micrometers.cy = 0;
-    bytecount = 108;
-    recordcount = 1;
-
-    emr_mapmode.type = 0x00000011; // EMR_SETMAPMODE
-    emr_mapmode.size = 12;
-    emr_mapmode.mapmode = 0x01; // MM_TEXT
-    bytecount += 12;
-    recordcount++;
-
-    if (rotate_angle) {
-        emr_setworldtransform.type = 0x00000023; // EMR_SETWORLDTRANSFORM
-        emr_setworldtransform.size = 32;
-        emr_setworldtransform.m11 = rotate_angle == 90 ? 0.0f : rotate_angle == 180 ? -1.0f : 0.0f;
-        emr_setworldtransform.m12 = rotate_angle == 90 ? 1.0f : rotate_angle == 180 ? 0.0f : -1.0f;
-        emr_setworldtransform.m21 = rotate_angle == 90 ? -1.0f : rotate_angle == 180 ? 0.0f : 1.0f;
-        emr_setworldtransform.m22 = rotate_angle == 90 ? 0.0f : rotate_angle == 180 ? -1.0f : 0.0f;
-        emr_setworldtransform.dx = rotate_angle == 90 ? height : rotate_angle == 180 ? width : 0.0f;
-        emr_setworldtransform.dy = rotate_angle == 90 ? 0.0f : rotate_angle == 180 ? height : width;
-        bytecount += 32;
-        recordcount++;
-    }
-
-    /* Create Brushes */
-    emr_createbrushindirect_bg.type = 0x00000027; // EMR_CREATEBRUSHINDIRECT
-    emr_createbrushindirect_bg.size = 24;
-    emr_createbrushindirect_bg.ih_brush = 1;
-    emr_createbrushindirect_bg.log_brush.brush_style = 0x0000; // BS_SOLID
-    emr_createbrushindirect_bg.log_brush.color.red = bgred;
-    emr_createbrushindirect_bg.log_brush.color.green = bggrn;
-    emr_createbrushindirect_bg.log_brush.color.blue = bgblu;
-    emr_createbrushindirect_bg.log_brush.color.reserved = 0;
-    emr_createbrushindirect_bg.log_brush.brush_hatch = 0x0006; // HS_SOLIDCLR
-    bytecount += 24;
-    recordcount++;
-
-    if (symbol->symbology == BARCODE_ULTRA) {
-        for (i = 0; i < 8; i++) {
-            emr_createbrushindirect_colour[i].type = 0x00000027; // EMR_CREATEBRUSHINDIRECT
-            emr_createbrushindirect_colour[i].size = 24;
-            emr_createbrushindirect_colour[i].ih_brush = 2 + i;
-            emr_createbrushindirect_colour[i].log_brush.brush_style = 0x0000; // BS_SOLID
-            emr_createbrushindirect_colour[i].log_brush.color.red = colour_to_red(i + 1);
-            emr_createbrushindirect_colour[i].log_brush.color.green = colour_to_green(i + 1);
-            emr_createbrushindirect_colour[i].log_brush.color.blue = colour_to_blue(i + 1);
-            emr_createbrushindirect_colour[i].log_brush.color.reserved = 0;
-            emr_createbrushindirect_colour[i].log_brush.brush_hatch = 0x0006; // HS_SOLIDCLR
-        }
-        bytecount += colours_used * 24;
-        recordcount += colours_used;
-    } else {
-        emr_createbrushindirect_fg.type = 0x00000027; // EMR_CREATEBRUSHINDIRECT
-        emr_createbrushindirect_fg.size = 24;
-        emr_createbrushindirect_fg.ih_brush = 2;
-        emr_createbrushindirect_fg.log_brush.brush_style = 0x0000; // BS_SOLID
-        emr_createbrushindirect_fg.log_brush.color.red = fgred;
-        emr_createbrushindirect_fg.log_brush.color.green = fggrn;
-        emr_createbrushindirect_fg.log_brush.color.blue = fgblu;
-        emr_createbrushindirect_fg.log_brush.color.reserved = 0;
-        emr_createbrushindirect_fg.log_brush.brush_hatch = 0x0006; // HS_SOLIDCLR
-        bytecount += 24;
-        recordcount++;
-    }
-
-    emr_selectobject_bgbrush.type = 0x00000025; // EMR_SELECTOBJECT
-    emr_selectobject_bgbrush.size = 12;
-    emr_selectobject_bgbrush.ih_object = 1;
-    bytecount += 12;
-    recordcount++;
-
-    if (symbol->symbology == BARCODE_ULTRA) {
-        for (i = 0; i < 8; i++) {
-            emr_selectobject_colour[i].type = 0x00000025; // EMR_SELECTOBJECT
-            emr_selectobject_colour[i].size = 12;
-            emr_selectobject_colour[i].ih_object = 2 + i;
-        }
-        bytecount += colours_used * 12;
-        recordcount += colours_used;
-    } else {
-        emr_selectobject_fgbrush.type = 0x00000025; // EMR_SELECTOBJECT
-        emr_selectobject_fgbrush.size = 12;
-        emr_selectobject_fgbrush.ih_object = 2;
-        bytecount += 12;
-        recordcount++;
-    }
-
-    /* Create Pens */
-    emr_createpen.type = 0x00000026; // EMR_CREATEPEN
-    emr_createpen.size = 28;
-    emr_createpen.ih_pen = 10;
-    emr_createpen.log_pen.pen_style = 0x00000005; // PS_NULL
-    emr_createpen.log_pen.width.x = 1;
-    emr_createpen.log_pen.width.y = 0; // ignored
-    emr_createpen.log_pen.color_ref.red = 0;
-    emr_createpen.log_pen.color_ref.green = 0;
-    emr_createpen.log_pen.color_ref.blue = 0;
-    emr_createpen.log_pen.color_ref.reserved = 0;
-    bytecount += 28;
-    recordcount++;
-
-    emr_selectobject_pen.type = 0x00000025; // EMR_SELECTOBJECT
-    emr_selectobject_pen.size = 12;
-    emr_selectobject_pen.ih_object = 10;
-    bytecount += 12;
-    recordcount++;
-
-    if (draw_background) {
-        /* Make background from a rectangle */
-        background.type = 0x0000002b; // EMR_RECTANGLE
-        background.size = 24;
-        background.box.top = 0;
-        background.box.left = 0;
-        background.box.right = emr_header.emf_header.bounds.right;
-        background.box.bottom = emr_header.emf_header.bounds.bottom;
-        bytecount += 24;
-        recordcount++;
-    }
-
     //Rectangles
     rect = symbol->vector->rectangles;
-    this_rectangle = 0;
     while (rect) {
-        rectangle[this_rectangle].type = 0x0000002b; // EMR_RECTANGLE
-        rectangle[this_rectangle].size = 24;
-        rectangle[this_rectangle].box.top = (int32_t) rect->y;
-        rectangle[this_rectangle].box.bottom = (int32_t) (rect->y + rect->height);
-        rectangle[this_rectangle].box.left = (int32_t) rect->x;
-        rectangle[this_rectangle].box.right = (int32_t) (rect->x + rect->width);
-        this_rectangle++;
-        bytecount += 24;
-        recordcount++;
-        rect = rect->next;
-    }
-
-    //Circles
-    previous_diameter = radius = 0.0f;
-    circ = symbol->vector->circles;
-    this_circle = 0;
-    while (circ) {
-        if (previous_diameter != circ->diameter) {
-            previous_diameter = circ->diameter;
-            radius = (float) (0.5 * previous_diameter);
+        if (symbol->symbology == BARCODE_ULTRA) {
+            if (rect->colour < 1 || rect->colour > 8) { // Not drawn
+                rect = rect->next;
+                continue;
+            }
+            colour_used[rect->colour - 1] = 1;
+            slot = rect->colour - 1;
+        } else {
+            slot = EMF_POLY_SLOTS - 1;
         }
-        circle[this_circle].type = 0x0000002a; // EMR_ELLIPSE
-        circle[this_circle].size = 24;
-        circle[this_circle].box.top = (int32_t) (circ->y - radius);
-        circle[this_circle].box.bottom = (int32_t) (circ->y + radius);
-        circle[this_circle].box.left = (int32_t) (circ->x - radius);
-        circle[this_circle].box.right = (int32_t) (circ->x + radius);
-        this_circle++;
-        bytecount += 24;
-        recordcount++;
-        circ = circ->next;
+        rectangle.type = 0x0000002b; // EMR_RECTANGLE
+        rectangle.size = 24;
+        rectangle.box.top = (int32_t) rect->y;
+        rectangle.box.bottom = (int32_t) (rect->y + rect->height);
+        rectangle.box.left = (int32_t) rect->x;
+        rectangle.box.right = (int32_t) (rect->x + rect->width);
+        if (compact) {
+            points[0].x = points[3].x = rectangle.box.left;
+            points[1].x = points[2].x = rectangle.box.right;
+            points[0].y = points[1].y = rectangle.box.top;
+            points[2].y = points[3].y = rectangle.box.bottom;
+            emf_poly_add(points, 4, &fms[EMF_FM_COUNTS + slot], &fms[EMF_FM_POINTS + slot], &poly_bounds[slot]);
+        } else {
+            emf_put_record(&rectangle, sizeof(emr_rectangle_t),
+                    symbol->symbology == BARCODE_ULTRA ? &fms[EMF_FM_COLOUR + slot] : shapes_fmp, &recordcount);
+        }
+        rect = rect->next;
     }
 
     //Hexagons
     previous_diameter = radius = half_radius = half_sqrt3_radius = 0.0f;
     hex = symbol->vector->hexagons;
-    this_hexagon = 0;
     while (hex) {
-        hexagon[this_hexagon].type = 0x00000003; // EMR_POLYGON
-        hexagon[this_hexagon].size = 76;
-        hexagon[this_hexagon].count = 6;
+        hexagon.type = 0x00000003; // EMR_POLYGON
+        hexagon.size = 76;
+        hexagon.count = 6;
 
         if (previous_diameter != hex->diameter) {
             previous_diameter = hex->diameter;
@@ -510,295 +357,310 @@ INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle) {
             fx = hex->x - half_radius;
         }
 
-        hexagon[this_hexagon].a_points_a.x = (int32_t) ax;
-        hexagon[this_hexagon].a_points_a.y = (int32_t) ay;
-        hexagon[this_hexagon].a_points_b.x = (int32_t) bx;
-        hexagon[this_hexagon].a_points_b.y = (int32_t) by;
-        hexagon[this_hexagon].a_points_c.x = (int32_t) cx;
-        hexagon[this_hexagon].a_points_c.y = (int32_t) cy;
-        hexagon[this_hexagon].a_points_d.x = (int32_t) dx;
-        hexagon[this_hexagon].a_points_d.y = (int32_t) dy;
-        hexagon[this_hexagon].a_points_e.x = (int32_t) ex;
-        hexagon[this_hexagon].a_points_e.y = (int32_t) ey;
-        hexagon[this_hexagon].a_points_f.x = (int32_t) fx;
-        hexagon[this_hexagon].a_points_f.y = (int32_t) fy;
-
-        hexagon[this_hexagon].bounds.top = hexagon[this_hexagon].a_points_d.y;
-        hexagon[this_hexagon].bounds.bottom = hexagon[this_hexagon].a_points_a.y;
-        hexagon[this_hexagon].bounds.left = hexagon[this_hexagon].a_points_e.x;
-        hexagon[this_hexagon].bounds.right = hexagon[this_hexagon].a_points_c.x;
-        this_hexagon++;
-        bytecount += 76;
-        recordcount++;
+        hexagon.a_points_a.x = (int32_t) ax;
+        hexagon.a_points_a.y = (int32_t) ay;
+        hexagon.a_points_b.x = (int32_t) bx;
+        hexagon.a_points_b.y = (int32_t) by;
+        hexagon.a_points_c.x = (int32_t) cx;
+        hexagon.a_points_c.y = (int32_t) cy;
+        hexagon.a_points_d.x = (int32_t) dx;
+        hexagon.a_points_d.y = (int32_t) dy;
+        hexagon.a_points_e.x = (int32_t) ex;
+        hexagon.a_points_e.y = (int32_t) ey;
+        hexagon.a_points_f.x = (int32_t) fx;
+        hexagon.a_points_f.y = (int32_t) fy;
+
+        hexagon.bounds.top = hexagon.a_points_d.y;
+        hexagon.bounds.bottom = hexagon.a_points_a.y;
+        hexagon.bounds.left = hexagon.a_points_e.x;
+        hexagon.bounds.right = hexagon.a_points_c.x;
+        if (compact) {
+            slot = EMF_POLY_SLOTS - 1;
+            memcpy(points, &hexagon.a_points_a, sizeof(points)); // Packed so contiguous
+            emf_poly_add(points, 6, &fms[EMF_FM_COUNTS + slot], &fms[EMF_FM_POINTS + slot],
+                    &poly_bounds[slot]);
+        } else {
+            emf_put_record(&hexagon, sizeof(emr_polygon_t), shapes_fmp, &recordcount);
+        }
         hex = hex->next;
     }
 
-    /* Create font records, alignment records and text color */
-    if (symbol->vector->strings) {
-        bold = (symbol->output_options & BOLD_TEXT) &&
-                (!is_extendable(symbol->symbology) || (symbol->output_options & SMALL_TEXT));
-        memset(&emr_extcreatefontindirectw, 0, sizeof(emr_extcreatefontindirectw));
-        emr_extcreatefontindirectw.type = 0x00000052; // EMR_EXTCREATEFONTINDIRECTW
-        emr_extcreatefontindirectw.size = 104;
-        emr_extcreatefontindirectw.ih_fonts = 11;
-        emr_extcreatefontindirectw.elw.height = (int32_t) fsize;
-        emr_extcreatefontindirectw.elw.width = 0; // automatic
-        emr_extcreatefontindirectw.elw.weight = bold ? 700 : 400;
-        emr_extcreatefontindirectw.elw.char_set = 0x00; // ANSI_CHARSET
-        emr_extcreatefontindirectw.elw.out_precision = 0x00; // OUT_DEFAULT_PRECIS
-        emr_extcreatefontindirectw.elw.clip_precision = 0x00; // CLIP_DEFAULT_PRECIS
-        emr_extcreatefontindirectw.elw.pitch_and_family = 0x02 | (0x02 << 6); // FF_SWISS | VARIABLE_PITCH
-        utfle_copy(emr_extcreatefontindirectw.elw.facename, (unsigned char*) "sans-serif", 10);
-        bytecount += 104;
-        recordcount++;
-
-        emr_selectobject_font.type = 0x00000025; // EMR_SELECTOBJECT
-        emr_selectobject_font.size = 12;
-        emr_selectobject_font.ih_object = 11;
-        bytecount += 12;
-        recordcount++;
-
-        if (fsize2) {
-            memcpy(&emr_extcreatefontindirectw2, &emr_extcreatefontindirectw, sizeof(emr_extcreatefontindirectw));
-            emr_extcreatefontindirectw2.ih_fonts = 12;
-            emr_extcreatefontindirectw2.elw.height = (int32_t) fsize2;
-            bytecount += 104;
-            recordcount++;
-
-            emr_selectobject_font2.type = 0x00000025; // EMR_SELECTOBJECT
-            emr_selectobject_font2.size = 12;
-            emr_selectobject_font2.ih_object = 12;
-            bytecount += 12;
-            recordcount++;
+    if (compact) {
+        /* One polypolygon per colour, foreground one drawn before any circles */
+        for (slot = 0; slot < EMF_POLY_SLOTS; slot++) {
+            emf_poly_put(&fms[EMF_FM_COUNTS + slot], &fms[EMF_FM_POINTS + slot], &poly_bounds[slot],
+                    slot == EMF_POLY_SLOTS - 1 ? shapes_fmp : &fms[EMF_FM_COLOUR + slot], &recordcount);
         }
+    }
 
-        /* Note select aligns counted below in strings loop */
-
-        emr_settextalign.type = 0x00000016; // EMR_SETTEXTALIGN
-        emr_settextalign.size = 12;
-        emr_settextalign.text_alignment_mode = 0x0006 | 0x0018; // TA_CENTER | TA_BASELINE
-        if (halign1) {
-            emr_settextalign1.type = 0x00000016; // EMR_SETTEXTALIGN
-            emr_settextalign1.size = 12;
-            emr_settextalign1.text_alignment_mode = 0x0000 | 0x0018; // TA_LEFT | TA_BASELINE
+    //Circles
+    previous_diameter = radius = 0.0f;
+    circ = symbol->vector->circles;
+    i = 0;
+    while (circ) {
+        if (previous_diameter != circ->diameter) {
+            previous_diameter = circ->diameter;
+            radius = (float) (0.5 * previous_diameter);
         }
-        if (halign2) {
-            emr_settextalign2.type = 0x00000016; // EMR_SETTEXTALIGN
-            emr_settextalign2.size = 12;
-            emr_settextalign2.text_alignment_mode = 0x0002 | 0x0018; // TA_RIGHT | TA_BASELINE
+        circle.type = 0x0000002a; // EMR_ELLIPSE
+        circle.size = 24;
+        circle.box.top = (int32_t) (circ->y - radius);
+        circle.box.bottom = (int32_t) (circ->y + radius);
+        circle.box.left = (int32_t) (circ->x - radius);
+        circle.box.right = (int32_t) (circ->x + radius);
+        emf_put_record(&circle, sizeof(emr_ellipse_t), shapes_fmp, &recordcount);
+        if (symbol->symbology == BARCODE_MAXICODE && circ->next) {
+            // Bullseye needed, alternating background and foreground brushes
+            emf_put_selectobject(i % 2 ? 2 : 1, shapes_fmp, &recordcount);
         }
-
-        emr_settextcolor.type = 0x0000018; // EMR_SETTEXTCOLOR
-        emr_settextcolor.size = 12;
-        emr_settextcolor.color.red = fgred;
-        emr_settextcolor.color.green = fggrn;
-        emr_settextcolor.color.blue = fgblu;
-        emr_settextcolor.color.reserved = 0;
-        bytecount += 12;
-        recordcount++;
+        i++;
+        circ = circ->next;
     }
 
     //Text
-    this_text = 0;
-    // Loop over font sizes so that they're grouped together, so only have to select font twice at most
-    for (current_fsize = fsize; current_fsize; current_fsize = fsize2) {
-        str = symbol->vector->strings;
-        current_halign = -1;
-        while (str) {
-            if (str->fsize != current_fsize) {
-                str = str->next;
-                continue;
-            }
-            text_fsizes[this_text] = str->fsize;
-            text_haligns[this_text] = str->halign;
-            if (text_haligns[this_text] != current_halign) {
-                current_halign = text_haligns[this_text];
-                bytecount += 12;
-                recordcount++;
-            }
-            assert(str->length > 0);
-            utfle_len = utfle_length(str->text, str->length);
-            bumped_len = bump_up(utfle_len) * 2;
-            this_string[this_text] = (unsigned char *) malloc(bumped_len);
-            memset(this_string[this_text], 0, bumped_len);
-            text[this_text].type = 0x00000054; // EMR_EXTTEXTOUTW
-            text[this_text].size = 76 + bumped_len;
-            text[this_text].bounds.top = 0; // ignored
-            text[this_text].bounds.left = 0; // ignored
-            text[this_text].bounds.right = 0xffffffff; // ignored
-            text[this_text].bounds.bottom = 0xffffffff; // ignored
-            text[this_text].i_graphics_mode = 0x00000002; // GM_ADVANCED
-            text[this_text].ex_scale = 1.0f;
-            text[this_text].ey_scale = 1.0f;
-            text[this_text].w_emr_text.reference.x = (int32_t) str->x;
-            text[this_text].w_emr_text.reference.y = (int32_t) str->y;
-            text[this_text].w_emr_text.chars = utfle_len;
-            text[this_text].w_emr_text.off_string = 76;
-            text[this_text].w_emr_text.options = 0;
-            text[this_text].w_emr_text.rectangle.top = 0;
-            text[this_text].w_emr_text.rectangle.left = 0;
-            text[this_text].w_emr_text.rectangle.right = 0xffffffff;
-            text[this_text].w_emr_text.rectangle.bottom = 0xffffffff;
-            text[this_text].w_emr_text.off_dx = 0;
-            utfle_copy(this_string[this_text], str->text, str->length);
-            bytecount += 76 + bumped_len;
-            recordcount++;
-
-            this_text++;
+    str = symbol->vector->strings;
+    while (str) {
+        int text_idx;
+        struct filemem *text_fmp;
+        /* Allow 2 font sizes */
+        if (fsize == 0.0f) {
+            fsize = str->fsize;
+        } else if (str->fsize != fsize && fsize2 == 0.0f) {
+            fsize2 = str->fsize;
+        }
+        if (str->fsize != fsize && str->fsize != fsize2) { // Not drawn
             str = str->next;
+            continue;
         }
-        if (current_fsize == fsize2) {
-            break;
+        text_idx = str->fsize == fsize ? 0 : 1;
+        text_fmp = &fms[EMF_FM_TEXT + text_idx];
+        if (str->halign != text_halign[text_idx]) {
+            if (text_idx == 1 && text_halign[1] == -1) {
+                // 1st alignment of 2nd font size depends on last of 1st font size so leave till assembly
+                text_halign2_first = str->halign;
+            } else {
+                emf_put_textalign(str->halign, text_fmp, &recordcount);
+            }
+            text_halign[text_idx] = str->halign;
         }
-    }
-
-    /* Create EOF record */
-    emr_eof.type = 0x0000000e; // EMR_EOF
-    emr_eof.size = 20; // Assuming no palette entries
-    emr_eof.n_pal_entries = 0;
-    emr_eof.off_pal_entries = 0;
-    emr_eof.size_last = emr_eof.size;
-    bytecount += 20;
-    recordcount++;
-
-    if (symbol->symbology == BARCODE_MAXICODE) {
-        bytecount += 5 * sizeof (emr_selectobject_t);
-        recordcount += 5;
-    }
-
-    /* Put final counts in header */
-    emr_header.emf_header.bytes = bytecount;
-    emr_header.emf_header.records = recordcount;
+        assert(str->length > 0);
+        utfle_len = utfle_length(str->text, str->length);
+        bumped_len = bump_up(utfle_len) * 2;
+        if (!(this_string = (unsigned char *) z_malloc(z_allocator(symbol), bumped_len))) {
+            emf_free_mem(fms);
+            strcpy(symbol->errtxt, "642: Out of memory");
+            return ZINT_ERROR_MEMORY;
+        }
+        memset(this_string, 0, bumped_len);
+        text.type = 0x00000054; // EMR_EXTTEXTOUTW
+        text.size = 76 + bumped_len;
+        text.bounds.top = 0; // ignored
+        text.bounds.left = 0; // ignored
+        text.bounds.right = 0xffffffff; // ignored
+        text.bounds.bottom = 0xffffffff; // ignored
+        text.i_graphics_mode = 0x00000002; // GM_ADVANCED
+        text.ex_scale = 1.0f;
+        text.ey_scale = 1.0f;
+        text.w_emr_text.reference.x = (int32_t) str->x;
+        text.w_emr_text.reference.y = (int32_t) str->y;
+        text.w_emr_text.chars = utfle_len;
+        text.w_emr_text.off_string = 76;
+        text.w_emr_text.options = 0;
+        text.w_emr_text.rectangle.top = 0;
+        text.w_emr_text.rectangle.left = 0;
+        text.w_emr_text.rectangle.right = 0xffffffff;
+        text.w_emr_text.rectangle.bottom = 0xffffffff;
+        text.w_emr_text.off_dx = 0;
+        utfle_copy(this_string, str->text, str->length);
+        emf_put_record(&text, sizeof(emr_exttextoutw_t), text_fmp, &recordcount);
+        fm_write(this_string, bumped_len, 1, text_fmp);
+        z_free(z_allocator(symbol), this_string);
 
-    /* Send EMF data to file */
-    if (symbol->output_options & BARCODE_STDOUT) {
-        emf_file = stdout;
-    } else {
-        emf_file = fopen(symbol->outfile, "wb");
-    }
-    if (emf_file == NULL) {
-        strcpy(symbol->errtxt, "640: Could not open output file");
-        return ZINT_ERROR_FILE_ACCESS;
+        str = str->next;
     }
 
-    fwrite(&emr_header, sizeof (emr_header_t), 1, emf_file);
-
-    fwrite(&emr_mapmode, sizeof (emr_mapmode_t), 1, emf_file);
+    /* Assemble records, starting with object creation */
+    emr_mapmode.type = 0x00000011; // EMR_SETMAPMODE
+    emr_mapmode.size = 12;
+    emr_mapmode.mapmode = 0x01; // MM_TEXT
+    emf_put_record(&emr_mapmode, sizeof(emr_mapmode_t), out_fmp, &recordcount);
 
     if (rotate_angle) {
-        fwrite(&emr_setworldtransform, sizeof (emr_setworldtransform_t), 1, emf_file);
+        emr_setworldtransform.type = 0x00000023; // EMR_SETWORLDTRANSFORM
+        emr_setworldtransform.size = 32;
+        emr_setworldtransform.m11 = rotate_angle == 90 ? 0.0f : rotate_angle == 180 ? -1.0f : 0.0f;
+        emr_setworldtransform.m12 = rotate_angle == 90 ? 1.0f : rotate_angle == 180 ? 0.0f : -1.0f;
+        emr_setworldtransform.m21 = rotate_angle == 90 ? -1.0f : rotate_angle == 180 ? 0.0f : 1.0f;
+        emr_setworldtransform.m22 = rotate_angle == 90 ? 0.0f : rotate_angle == 180 ? -1.0f : 0.0f;
+        emr_setworldtransform.dx = rotate_angle == 90 ? height : rotate_angle == 180 ? width : 0.0f;
+        emr_setworldtransform.dy = rotate_angle == 90 ? 0.0f : rotate_angle == 180 ? height : width;
+        emf_put_record(&emr_setworldtransform, sizeof(emr_setworldtransform_t), out_fmp, &recordcount);
     }
 
-    fwrite(&emr_createbrushindirect_bg, sizeof (emr_createbrushindirect_t), 1, emf_file);
-
+    /* Create Brushes */
+    emf_put_createbrush(1, bgred, bggrn, bgblu, out_fmp, &recordcount);
     if (symbol->symbology == BARCODE_ULTRA) {
         for (i = 0; i < 8; i++) {
-            if (rectangle_count_bycolour[i + 1]) {
-                fwrite(&emr_createbrushindirect_colour[i], sizeof (emr_createbrushindirect_t), 1, emf_file);
+            if (colour_used[i]) {
+                emf_put_createbrush(2 + i, colour_to_red(i + 1), colour_to_green(i + 1), colour_to_blue(i + 1),
+                        out_fmp, &recordcount);
             }
         }
     } else {
-        fwrite(&emr_createbrushindirect_fg, sizeof (emr_createbrushindirect_t), 1, emf_file);
+        emf_put_createbrush(2, fgred, fggrn, fgblu, out_fmp, &recordcount);
     }
 
-    fwrite(&emr_createpen, sizeof (emr_createpen_t), 1, emf_file);
+    /* Create Pens */
+    emr_createpen.type = 0x00000026; // EMR_CREATEPEN
+    emr_createpen.size = 28;
+    emr_createpen.ih_pen = 10;
+    emr_createpen.log_pen.pen_style = 0x00000005; // PS_NULL
+    emr_createpen.log_pen.width.x = 1;
+    emr_createpen.log_pen.width.y = 0; // ignored
+    emr_createpen.log_pen.color_ref.red = 0;
+    emr_createpen.log_pen.color_ref.green = 0;
+    emr_createpen.log_pen.color_ref.blue = 0;
+    emr_createpen.log_pen.color_ref.reserved = 0;
+    emf_put_record(&emr_createpen, sizeof(emr_createpen_t), out_fmp, &recordcount);
 
+    /* Create font records */
     if (symbol->vector->strings) {
-        fwrite(&emr_extcreatefontindirectw, sizeof (emr_extcreatefontindirectw_t), 1, emf_file);
+        bold = (symbol->output_options & BOLD_TEXT) &&
+                (!is_extendable(symbol->symbology) || (symbol->output_options & SMALL_TEXT));
+        memset(&emr_extcreatefontindirectw, 0, sizeof(emr_extcreatefontindirectw));
+        emr_extcreatefontindirectw.type = 0x00000052; // EMR_EXTCREATEFONTINDIRECTW
+        emr_extcreatefontindirectw.size = 104;
+        emr_extcreatefontindirectw.ih_fonts = 11;
+        emr_extcreatefontindirectw.elw.height = (int32_t) fsize;
+        emr_extcreatefontindirectw.elw.width = 0; // automatic
+        emr_extcreatefontindirectw.elw.weight = bold ? 700 : 400;
+        emr_extcreatefontindirectw.elw.char_set = 0x00; // ANSI_CHARSET
+        emr_extcreatefontindirectw.elw.out_precision = 0x00; // OUT_DEFAULT_PRECIS
+        emr_extcreatefontindirectw.elw.clip_precision = 0x00; // CLIP_DEFAULT_PRECIS
+        emr_extcreatefontindirectw.elw.pitch_and_family = 0x02 | (0x02 << 6); // FF_SWISS | VARIABLE_PITCH
+        utfle_copy(emr_extcreatefontindirectw.elw.facename, (unsigned char*) "sans-serif", 10);
+        emf_put_record(&emr_extcreatefontindirectw, sizeof(emr_extcreatefontindirectw_t), out_fmp, &recordcount);
+
         if (fsize2) {
-            fwrite(&emr_extcreatefontindirectw2, sizeof (emr_extcreatefontindirectw_t), 1, emf_file);
+            emr_extcreatefontindirectw.ih_fonts = 12;
+            emr_extcreatefontindirectw.elw.height = (int32_t) fsize2;
+            emf_put_record(&emr_extcreatefontindirectw, sizeof(emr_extcreatefontindirectw_t), out_fmp,
+                    &recordcount);
         }
     }
 
-    fwrite(&emr_selectobject_bgbrush, sizeof (emr_selectobject_t), 1, emf_file);
-    fwrite(&emr_selectobject_pen, sizeof (emr_selectobject_t), 1, emf_file);
+    emf_put_selectobject(1, out_fmp, &recordcount); // Background brush
+    emf_put_selectobject(10, out_fmp, &recordcount); // Pen
+
     if (draw_background) {
-        fwrite(&background, sizeof (emr_rectangle_t), 1, emf_file);
+        /* Make background from a rectangle */
+        rectangle.type = 0x0000002b; // EMR_RECTANGLE
+        rectangle.size = 24;
+        rectangle.box.top = 0;
+        rectangle.box.left = 0;
+        rectangle.box.right = rotate_angle == 90 || rotate_angle == 270 ? height : width;
+        rectangle.box.bottom = rotate_angle == 90 || rotate_angle == 270 ? width : height;
+        emf_put_record(&rectangle, sizeof(emr_rectangle_t), out_fmp, &recordcount);
     }
 
     if (symbol->symbology == BARCODE_ULTRA) {
-        for(i = 0; i < 8; i++) {
-            if (rectangle_count_bycolour[i + 1]) {
-                fwrite(&emr_selectobject_colour[i], sizeof (emr_selectobject_t), 1, emf_file);
-
-                rect = symbol->vector->rectangles;
-                this_rectangle = 0;
-                while (rect) {
-                    if (rect->colour == i + 1) {
-                        fwrite(&rectangle[this_rectangle], sizeof (emr_rectangle_t), 1, emf_file);
-                    }
-                    this_rectangle++;
-                    rect = rect->next;
-                }
+        for (i = 0; i < 8; i++) {
+            if (colour_used[i]) {
+                emf_put_selectobject(2 + i, out_fmp, &recordcount);
+                fm_write(fms[EMF_FM_COLOUR + i].mem, 1, fms[EMF_FM_COLOUR + i].memend, out_fmp);
             }
         }
     } else {
-        fwrite(&emr_selectobject_fgbrush, sizeof (emr_selectobject_t), 1, emf_file);
+        emf_put_selectobject(2, out_fmp, &recordcount); // Foreground brush
+    }
+    fm_write(shapes_fmp->mem, 1, shapes_fmp->memend, out_fmp);
 
-        // Rectangles
-        for (i = 0; i < rectangle_count; i++) {
-            fwrite(&rectangle[i], sizeof (emr_rectangle_t), 1, emf_file);
+    if (fsize != 0.0f) {
+        emf_put_selectobject(11, out_fmp, &recordcount); // 1st font
+        emr_settextcolor.type = 0x0000018; // EMR_SETTEXTCOLOR
+        emr_settextcolor.size = 12;
+        emr_settextcolor.color.red = fgred;
+        emr_settextcolor.color.green = fggrn;
+        emr_settextcolor.color.blue = fgblu;
+        emr_settextcolor.color.reserved = 0;
+        emf_put_record(&emr_settextcolor, sizeof(emr_settextcolor_t), out_fmp, &recordcount);
+        fm_write(fms[EMF_FM_TEXT].mem, 1, fms[EMF_FM_TEXT].memend, out_fmp);
+        if (fsize2 != 0.0f) {
+            emf_put_selectobject(12, out_fmp, &recordcount); // 2nd font
+            if (text_halign2_first != text_halign[0]) {
+                emf_put_textalign(text_halign2_first, out_fmp, &recordcount);
+            }
+            fm_write(fms[EMF_FM_TEXT + 1].mem, 1, fms[EMF_FM_TEXT + 1].memend, out_fmp);
         }
     }
 
-    // Hexagons
-    for (i = 0; i < hexagon_count; i++) {
-        fwrite(&hexagon[i], sizeof (emr_polygon_t), 1, emf_file);
-    }
+    /* Create EOF record */
+    emr_eof.type = 0x0000000e; // EMR_EOF
+    emr_eof.size = 20; // Assuming no palette entries
+    emr_eof.n_pal_entries = 0;
+    emr_eof.off_pal_entries = 0;
+    emr_eof.size_last = emr_eof.size;
+    emf_put_record(&emr_eof, sizeof(emr_eof_t), out_fmp, &recordcount);
 
-    // Circles
-    if (symbol->symbology == BARCODE_MAXICODE) {
-        // Bullseye needed
-        for (i = 0; i < circle_count; i++) {
-            fwrite(&circle[i], sizeof (emr_ellipse_t), 1, emf_file);
-            if (i < circle_count - 1) {
-                if (i % 2) {
-                    fwrite(&emr_selectobject_fgbrush, sizeof (emr_selectobject_t), 1, emf_file);
-                } else {
-                    fwrite(&emr_selectobject_bgbrush, sizeof (emr_selectobject_t), 1, emf_file);
-                }
-            }
-        }
-    } else {
-        for (i = 0; i < circle_count; i++) {
-            fwrite(&circle[i], sizeof (emr_ellipse_t), 1, emf_file);
+    for (i = 0; i < EMF_FM_NUM; i++) {
+        if (fm_error(&fms[i])) {
+            emf_free_mem(fms);
+            strcpy(symbol->errtxt, "643: Out of memory");
+            return ZINT_ERROR_MEMORY;
         }
     }
 
-    // Text
-    if (string_count > 0) {
-        fwrite(&emr_selectobject_font, sizeof (emr_selectobject_t), 1, emf_file);
-        fwrite(&emr_settextcolor, sizeof (emr_settextcolor_t), 1, emf_file);
+    /* Header */
+    emr_header.type = 0x00000001; // EMR_HEADER
+    emr_header.size = 108; // Including extensions
+    emr_header.emf_header.bounds.left = 0;
+    emr_header.emf_header.bounds.right = rotate_angle == 90 || rotate_angle == 270 ? height : width;
+    emr_header.emf_header.bounds.bottom = rotate_angle == 90 || rotate_angle == 270 ? width : height;
+    emr_header.emf_header.bounds.top = 0;
+    emr_header.emf_header.frame.left = 0;
+    emr_header.emf_header.frame.right = emr_header.emf_header.bounds.right * 30;
+    emr_header.emf_header.frame.top = 0;
+    emr_header.emf_header.frame.bottom = emr_header.emf_header.bounds.bottom * 30;
+    emr_header.emf_header.record_signature = 0x464d4520; // ENHMETA_SIGNATURE
+    emr_header.emf_header.version = 0x00010000;
+    emr_header.emf_header.bytes = (uint32_t) (108 + out_fmp->memend);
+    emr_header.emf_header.records = recordcount;
+    if (symbol->symbology == BARCODE_ULTRA) {
+        emr_header.emf_header.handles = 11; // Number of graphics objects
+    } else {
+        emr_header.emf_header.handles = fsize2 != 0.0f ? 5 : 4;
     }
+    emr_header.emf_header.reserved = 0x0000;
+    emr_header.emf_header.n_description = 0;
+    emr_header.emf_header.off_description = 0;
+    emr_header.emf_header.n_pal_entries = 0;
+    emr_header.emf_header.device.cx = 1000;
+    emr_header.emf_header.device.cy = 1000;
+    emr_header.emf_header.millimeters.cx = 300;
+    emr_header.emf_header.millimeters.cy = 300;
+    /* HeaderExtension1 */
+    emr_header.emf_header.cb_pixel_format = 0x0000; // None set
+    emr_header.emf_header.off_pixel_format = 0x0000; // None set
+    emr_header.emf_header.b_open_gl = 0x0000; // OpenGL not present
+    /* HeaderExtension2 */
+    emr_header.emf_header.micrometers.cx = 0;
+    emr_header.emf_header.micrometers.cy = 0;
 
-    current_fsize = fsize;
-    current_halign = -1;
-    for (i = 0; i < string_count; i++) {
-        if (text_fsizes[i] != current_fsize) {
-            current_fsize = text_fsizes[i];
-            fwrite(&emr_selectobject_font2, sizeof (emr_selectobject_t), 1, emf_file);
-        }
-        if (text_haligns[i] != current_halign) {
-            current_halign = text_haligns[i];
-            if (current_halign == 0) {
-                fwrite(&emr_settextalign, sizeof (emr_settextalign_t), 1, emf_file);
-            } else if (current_halign == 1) {
-                fwrite(&emr_settextalign1, sizeof (emr_settextalign_t), 1, emf_file);
-            } else {
-                fwrite(&emr_settextalign2, sizeof (emr_settextalign_t), 1, emf_file);
-            }
-        }
-        fwrite(&text[i], sizeof (emr_exttextoutw_t), 1, emf_file);
-        fwrite(this_string[i], bump_up(text[i].w_emr_text.chars) * 2, 1, emf_file);
-        free(this_string[i]);
+    /* Send EMF data to file */
+    if (!fm_open(fmp, symbol, "wb")) {
+        emf_free_mem(fms);
+        strcpy(symbol->errtxt, "640: Could not open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
-    fwrite(&emr_eof, sizeof (emr_eof_t), 1, emf_file);
+    fm_write(&emr_header, sizeof (emr_header_t), 1, fmp);
+    fm_write(out_fmp->mem, 1, out_fmp->memend, fmp);
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(emf_file);
-    } else {
-        fclose(emf_file);
+    emf_free_mem(fms);
+
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "641: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
     }
     return error_number;
 }
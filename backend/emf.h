@@ -62,6 +62,11 @@ extern "C" {
         int32_t y;
     } point_l_t;
 
+    typedef struct point_s {
+        int16_t x;
+        int16_t y;
+    } point_s_t;
+
     typedef struct color_ref {
         uint8_t red;
         uint8_t green;
@@ -197,6 +202,15 @@ extern "C" {
         point_l_t a_points_f;
     } emr_polygon_t;
 
+    /* Followed by `n_polys` uint32_t point counts, then `count` point_l_t points (point_s_t if POLYPOLYGON16) */
+    typedef struct emr_polypolygon {
+        uint32_t type;
+        uint32_t size;
+        rect_l_t bounds;
+        uint32_t n_polys;
+        uint32_t count;
+    } emr_polypolygon_t;
+
     typedef struct emr_extcreatefontindirectw {
         uint32_t type;
         uint32_t size;
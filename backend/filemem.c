@@ -0,0 +1,662 @@
+/*  filemem.c - write to file or memory abstraction used by the output formats */
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#ifdef _MSC_VER
+#include <io.h>
+#include <fcntl.h>
+#endif
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#define FM_HAVE_MMAP
+#elif defined(__unix__) || defined(__APPLE__)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define FM_HAVE_MMAP
+#endif
+#ifndef NO_PNG
+#include <zlib.h>
+#endif
+#include "filemem.h"
+
+#define FM_MEMCHUNK 1024 /* Initial size of memory buffer, doubled as needed */
+#define FM_FUNCBUF  256 /* Size of stack buffer used by `fm_printf()` for `write_func` and gzipping */
+#define FM_GZBUF    0x4000 /* Size of the input and output buffers of gzipping */
+
+#ifndef NO_PNG
+/* Deflate stream of `fm_gzip()`, input gathered in `in` and compressed a buffer-full at a time */
+struct fm_gzip {
+    z_stream strm;
+    size_t in_len;
+    unsigned char in[FM_GZBUF];
+    unsigned char out[FM_GZBUF];
+};
+#endif
+
+/* Make sure at least `size` bytes available from `mempos`, growing buffer if need be */
+static int fm_mem_expand(struct filemem *fmp, const size_t size) {
+    size_t new_size;
+    unsigned char *new_mem;
+
+    if (fmp->err) {
+        return 0;
+    }
+    if (size > (size_t) -1 - fmp->mempos) { /* Overflow */
+        fmp->err = 1;
+        return 0;
+    }
+    if (fmp->mempos + size <= fmp->memsize) {
+        return 1;
+    }
+    new_size = fmp->memsize ? fmp->memsize : FM_MEMCHUNK;
+    while (new_size < fmp->mempos + size) {
+        if (new_size > (size_t) -1 / 2) {
+            new_size = fmp->mempos + size;
+            break;
+        }
+        new_size *= 2;
+    }
+    if (!(new_mem = (unsigned char *) z_realloc(fmp->allocator, fmp->mem, new_size))) {
+        fmp->err = 1;
+        return 0;
+    }
+    fmp->mem = new_mem;
+    fmp->memsize = new_size;
+    return 1;
+}
+
+/* Pass `size` bytes to callback, in `int` sized pieces */
+static int fm_func_write(struct filemem *fmp, const unsigned char *data, size_t size) {
+    if (fmp->err) {
+        return 0;
+    }
+    while (size) {
+        const int length = size > INT_MAX ? INT_MAX : (int) size;
+        if ((*fmp->write_func)(fmp->write_context, data, length) != 0) {
+            fmp->err = 1;
+            return 0;
+        }
+        data += length;
+        size -= length;
+        fmp->mempos += length; /* Bytes written, for `fm_tell()` */
+    }
+    return 1;
+}
+
+/* Note position after a memory write */
+static void fm_mem_advance(struct filemem *fmp, const size_t size) {
+    fmp->mempos += size;
+    if (fmp->mempos > fmp->memend) {
+        fmp->memend = fmp->mempos;
+    }
+}
+
+static int fm_open_output(struct filemem *fmp, struct zint_symbol *symbol, const char *mode) {
+    memset(fmp, 0, sizeof(*fmp));
+    fmp->flags = symbol->output_options & (BARCODE_STDOUT | BARCODE_MEMORY_FILE | BARCODE_WRITE_FUNC | OUT_FILE_MMAP);
+    fmp->allocator = z_allocator(symbol);
+
+    if (fmp->flags & BARCODE_MEMORY_FILE) {
+        /* Take back the buffer of any previous print, so that printing again needn't allocate */
+        fmp->mem = symbol->internal->memfile_buf;
+        fmp->memsize = symbol->internal->memfile_capacity;
+        symbol->internal->memfile_buf = NULL;
+        symbol->internal->memfile_capacity = 0;
+        symbol->memfile = NULL;
+        symbol->memfile_size = 0;
+        return fm_mem_expand(fmp, FM_MEMCHUNK);
+    }
+    if (fmp->flags & BARCODE_WRITE_FUNC) {
+        if (!symbol->write_func) {
+            fmp->err = 1;
+            return 0;
+        }
+        fmp->write_func = symbol->write_func;
+        fmp->write_context = symbol->write_context;
+        return 1;
+    }
+    if (fmp->flags & BARCODE_STDOUT) {
+#ifdef _MSC_VER
+        if (strchr(mode, 'b') != NULL && _setmode(_fileno(stdout), _O_BINARY) == -1) {
+            fmp->err = 1;
+            return 0;
+        }
+#endif
+        fmp->fp = stdout;
+        return 1;
+    }
+    if (!(fmp->fp = fopen(symbol->outfile, mode))) {
+        fmp->err = 1;
+        return 0;
+    }
+    return 1;
+}
+
+#ifndef NO_PNG
+/* zlib allocators, using the library's with the allocator `opaque` */
+static voidpf fm_zalloc(voidpf opaque, uInt items, uInt size) {
+    return z_malloc((const struct zint_allocator *) opaque, (size_t) items * size);
+}
+
+static void fm_zfree(voidpf opaque, voidpf ptr) {
+    z_free((const struct zint_allocator *) opaque, ptr);
+}
+
+/* Deflate the gathered input with `flush`, writing the compressed output through to the underlying output */
+static int fm_gz_deflate(struct filemem *fmp, const int flush) {
+    struct fm_gzip *const gz = fmp->gz;
+    int ret;
+
+    if (fmp->err) {
+        return 0;
+    }
+    gz->strm.next_in = gz->in;
+    gz->strm.avail_in = (uInt) gz->in_len;
+    fmp->gz = NULL; /* Write through */
+    do {
+        size_t have;
+        gz->strm.next_out = gz->out;
+        gz->strm.avail_out = FM_GZBUF;
+        ret = deflate(&gz->strm, flush);
+        if (ret == Z_STREAM_ERROR) {
+            fmp->err = 1;
+            break;
+        }
+        have = FM_GZBUF - gz->strm.avail_out;
+        if (have && fm_write(gz->out, 1, have, fmp) != have) {
+            break;
+        }
+    } while (gz->strm.avail_out == 0);
+    fmp->gz = gz;
+    gz->in_len = 0;
+
+    if (!fmp->err && flush == Z_FINISH && ret != Z_STREAM_END) {
+        fmp->err = 1;
+    }
+    return !fmp->err;
+}
+
+/* Gather `size` bytes of `data` for deflating */
+static int fm_gz_write(struct filemem *fmp, const unsigned char *data, size_t size) {
+    struct fm_gzip *const gz = fmp->gz;
+
+    while (size) {
+        size_t len = FM_GZBUF - gz->in_len;
+        if (len > size) {
+            len = size;
+        }
+        memcpy(gz->in + gz->in_len, data, len);
+        gz->in_len += len;
+        data += len;
+        size -= len;
+        if (gz->in_len == FM_GZBUF && !fm_gz_deflate(fmp, Z_NO_FLUSH)) {
+            return 0;
+        }
+    }
+    return !fmp->err;
+}
+
+/* Finish the gzip stream (unless an error has occurred) and free it */
+static void fm_gz_end(struct filemem *fmp) {
+    (void) fm_gz_deflate(fmp, Z_FINISH);
+    (void) deflateEnd(&fmp->gz->strm);
+    z_free(fmp->allocator, fmp->gz);
+    fmp->gz = NULL;
+}
+#else
+#define fm_gz_write(fmp, data, size) 0
+#define fm_gz_end(fmp)
+#endif /* NO_PNG */
+
+INTERNAL int fm_gzip(struct filemem *fmp, const int fast) {
+#ifndef NO_PNG
+    struct fm_gzip *gz;
+
+    if (fmp->err || fmp->gz || fmp->map) {
+        return 0;
+    }
+    if (!(gz = (struct fm_gzip *) z_malloc(fmp->allocator, sizeof(struct fm_gzip)))) {
+        return 0;
+    }
+    memset(&gz->strm, 0, sizeof(gz->strm));
+    gz->strm.zalloc = fm_zalloc;
+    gz->strm.zfree = fm_zfree;
+    gz->strm.opaque = (voidpf) fmp->allocator;
+    /* Window bits + 16 for a gzip rather than zlib wrapper */
+    if (deflateInit2(&gz->strm, fast ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+            Z_DEFAULT_STRATEGY) != Z_OK) {
+        z_free(fmp->allocator, gz);
+        return 0;
+    }
+    gz->in_len = 0;
+    fmp->gz = gz;
+    return 1;
+#else
+    (void) fmp; (void) fast;
+    return 0;
+#endif
+}
+
+INTERNAL int fm_open(struct filemem *fmp, struct zint_symbol *symbol, const char *mode) {
+    if (!fm_open_output(fmp, symbol, mode)) {
+        return 0;
+    }
+    z_trace(symbol, ZINT_PHASE_OUTPUT, ZINT_TRACE_BEGIN, 0);
+    return 1;
+}
+
+INTERNAL size_t fm_write(const void *ptr, size_t size, size_t nitems, struct filemem *fmp) {
+    if (fmp->gz) {
+        if (size == 0 || nitems == 0) {
+            return 0;
+        }
+        if (nitems > (size_t) -1 / size) {
+            fmp->err = 1;
+            return 0;
+        }
+        return fm_gz_write(fmp, (const unsigned char *) ptr, size * nitems) ? nitems : 0;
+    }
+    if (fmp->flags & BARCODE_MEMORY_FILE) {
+        size_t total;
+        if (size == 0 || nitems == 0) {
+            return 0;
+        }
+        if (nitems > (size_t) -1 / size) {
+            fmp->err = 1;
+            return 0;
+        }
+        total = size * nitems;
+        if (!fm_mem_expand(fmp, total)) {
+            return 0;
+        }
+        memcpy(fmp->mem + fmp->mempos, ptr, total);
+        fm_mem_advance(fmp, total);
+        return nitems;
+    }
+    if (fmp->flags & BARCODE_WRITE_FUNC) {
+        if (size == 0 || nitems == 0) {
+            return 0;
+        }
+        if (nitems > (size_t) -1 / size) {
+            fmp->err = 1;
+            return 0;
+        }
+        return fm_func_write(fmp, (const unsigned char *) ptr, size * nitems) ? nitems : 0;
+    }
+    if (fwrite(ptr, size, nitems, fmp->fp) != nitems) {
+        fmp->err = 1;
+        return 0;
+    }
+    return nitems;
+}
+
+INTERNAL int fm_putc(int ch, struct filemem *fmp) {
+    if (fmp->gz) {
+        const unsigned char uch = (unsigned char) ch;
+        return fm_gz_write(fmp, &uch, 1) ? uch : EOF;
+    }
+    if (fmp->flags & BARCODE_MEMORY_FILE) {
+        if (!fm_mem_expand(fmp, 1)) {
+            return EOF;
+        }
+        fmp->mem[fmp->mempos] = (unsigned char) ch;
+        fm_mem_advance(fmp, 1);
+        return (unsigned char) ch;
+    }
+    if (fmp->flags & BARCODE_WRITE_FUNC) {
+        const unsigned char uch = (unsigned char) ch;
+        return fm_func_write(fmp, &uch, 1) ? uch : EOF;
+    }
+    if (fputc(ch, fmp->fp) == EOF) {
+        fmp->err = 1;
+        return EOF;
+    }
+    return ch;
+}
+
+INTERNAL int fm_puts(const char *str, struct filemem *fmp) {
+    if (fmp->gz || (fmp->flags & (BARCODE_MEMORY_FILE | BARCODE_WRITE_FUNC))) {
+        const size_t len = strlen(str);
+        if (len == 0) {
+            return 0;
+        }
+        return fm_write(str, 1, len, fmp) == len ? 0 : EOF;
+    }
+    if (fputs(str, fmp->fp) == EOF) {
+        fmp->err = 1;
+        return EOF;
+    }
+    return 0;
+}
+
+INTERNAL int fm_printf(struct filemem *fmp, const char *format, ...) {
+    va_list ap;
+    int ret;
+
+    if (!fmp->gz && (fmp->flags & BARCODE_MEMORY_FILE)) {
+        size_t avail;
+        if (!fm_mem_expand(fmp, 128)) { /* Pre-expand for the usual short output */
+            return -1;
+        }
+        avail = fmp->memsize - fmp->mempos;
+        va_start(ap, format);
+        ret = vsnprintf((char *) fmp->mem + fmp->mempos, avail, format, ap);
+        va_end(ap);
+        if (ret < 0) {
+            fmp->err = 1;
+            return ret;
+        }
+        if ((size_t) ret >= avail) { /* Truncated (NUL takes last byte) so expand and redo */
+            if (!fm_mem_expand(fmp, (size_t) ret + 1)) {
+                return -1;
+            }
+            va_start(ap, format);
+            ret = vsnprintf((char *) fmp->mem + fmp->mempos, fmp->memsize - fmp->mempos, format, ap);
+            va_end(ap);
+            if (ret < 0) {
+                fmp->err = 1;
+                return ret;
+            }
+        }
+        fm_mem_advance(fmp, (size_t) ret);
+        return ret;
+    }
+    if (fmp->gz || (fmp->flags & BARCODE_WRITE_FUNC)) {
+        char buf[FM_FUNCBUF];
+        char *str = buf;
+        if (fmp->err) {
+            return -1;
+        }
+        va_start(ap, format);
+        ret = vsnprintf(buf, sizeof(buf), format, ap);
+        va_end(ap);
+        if (ret < 0) {
+            fmp->err = 1;
+            return ret;
+        }
+        if ((size_t) ret >= sizeof(buf)) { /* Truncated so allocate and redo */
+            if (!(str = (char *) z_malloc(fmp->allocator, (size_t) ret + 1))) {
+                fmp->err = 1;
+                return -1;
+            }
+            va_start(ap, format);
+            ret = vsnprintf(str, (size_t) ret + 1, format, ap);
+            va_end(ap);
+        }
+        if (ret < 0 || !(fmp->gz ? fm_gz_write(fmp, (const unsigned char *) str, (size_t) ret)
+                                    : fm_func_write(fmp, (const unsigned char *) str, (size_t) ret))) {
+            fmp->err = 1;
+            ret = -1;
+        }
+        if (str != buf) {
+            z_free(fmp->allocator, str);
+        }
+        return ret;
+    }
+
+    va_start(ap, format);
+    ret = vfprintf(fmp->fp, format, ap);
+    va_end(ap);
+    if (ret < 0) {
+        fmp->err = 1;
+    }
+    return ret;
+}
+
+INTERNAL int fm_putsf(const char *prefix, const int dp, const float arg, struct filemem *fmp) {
+    char buf[64]; /* Plenty for `float` (max 39 digits) to reasonable `dp` */
+    int i, len;
+
+    if (prefix && *prefix && fm_puts(prefix, fmp) == EOF) {
+        return 0;
+    }
+    if (dp < 0 || dp > 15) {
+        fmp->err = 1;
+        return 0;
+    }
+    len = sprintf(buf, "%.*f", dp, arg);
+    if (len < 0) {
+        fmp->err = 1;
+        return 0;
+    }
+    /* Replace locale decimal point (only non-digit after sign) */
+    for (i = len - 1; i > 0; i--) {
+        if (buf[i] < '0' || buf[i] > '9') {
+            buf[i] = '.';
+            break;
+        }
+    }
+    return fm_write(buf, 1, len, fmp) == (size_t) len;
+}
+
+INTERNAL int fm_seek(struct filemem *fmp, long offset, int whence) {
+    if (fmp->gz) {
+        fmp->err = 1;
+        return -1;
+    }
+    if (fmp->flags & BARCODE_MEMORY_FILE) {
+        const size_t start = whence == SEEK_SET ? 0 : whence == SEEK_CUR ? fmp->mempos : fmp->memend;
+        if ((offset < 0 && (size_t) -offset > start) || (offset > 0 && start + offset > fmp->memend)) {
+            fmp->err = 1;
+            return -1;
+        }
+        fmp->mempos = start + offset;
+        return 0;
+    }
+    if (fmp->flags & BARCODE_WRITE_FUNC) {
+        fmp->err = 1;
+        return -1;
+    }
+    if (fseek(fmp->fp, offset, whence) != 0) {
+        fmp->err = 1;
+        return -1;
+    }
+    return 0;
+}
+
+INTERNAL long fm_tell(struct filemem *fmp) {
+    long ret;
+#ifndef NO_PNG
+    if (fmp->gz) {
+        return (long) (fmp->gz->strm.total_in + fmp->gz->in_len); /* Uncompressed */
+    }
+#endif
+    if (fmp->flags & (BARCODE_MEMORY_FILE | BARCODE_WRITE_FUNC)) {
+        return (long) fmp->mempos;
+    }
+    ret = ftell(fmp->fp);
+    if (ret < 0) {
+        fmp->err = 1;
+    }
+    return ret;
+}
+
+#ifdef FM_HAVE_MMAP
+/* Size file `fmp->fp`, as yet unwritten, to `size` bytes and map it read/write into `fmp->map`. Returns 1 if mapped,
+   0 if not (file left empty) */
+static int fm_map_file(struct filemem *fmp, const size_t size) {
+    void *map;
+#ifdef _WIN32
+    HANDLE file, mapping;
+    ULARGE_INTEGER li;
+
+    if (fflush(fmp->fp) != 0 || ftell(fmp->fp) != 0) {
+        return 0;
+    }
+    file = (HANDLE) _get_osfhandle(_fileno(fmp->fp));
+    if (file == INVALID_HANDLE_VALUE || GetFileType(file) != FILE_TYPE_DISK) {
+        return 0;
+    }
+    li.QuadPart = size;
+    /* Mapping beyond the end extends the file, zero-filled */
+    mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, li.HighPart, li.LowPart, NULL);
+    map = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size) : NULL;
+    if (mapping) {
+        CloseHandle(mapping); /* View keeps it open */
+    }
+    if (!map) {
+        return 0;
+    }
+#else
+    int fd;
+
+    if ((off_t) size < 0 || (size_t) (off_t) size != size || fflush(fmp->fp) != 0 || ftell(fmp->fp) != 0) {
+        return 0;
+    }
+    fd = fileno(fmp->fp);
+#ifdef __linux__
+    /* Reserve the blocks, so that a full disk fails here (and the output is then written) rather than with SIGBUS on
+       storing into the mapping */
+    if (posix_fallocate(fd, 0, (off_t) size) == ENOSPC) {
+        return 0;
+    }
+#endif
+    if (ftruncate(fd, (off_t) size) != 0) {
+        return 0;
+    }
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        (void) ftruncate(fd, 0);
+        return 0;
+    }
+#endif
+    fmp->map = (unsigned char *) map;
+    fmp->mapsize = size;
+    return 1;
+}
+#endif /* FM_HAVE_MMAP */
+
+INTERNAL unsigned char *fm_map(struct filemem *fmp, const size_t size) {
+    if (fmp->err || size == 0 || fmp->map || fmp->gz) {
+        return NULL;
+    }
+    if (fmp->flags & BARCODE_MEMORY_FILE) {
+        if (fmp->memend != 0 || !fm_mem_expand(fmp, size)) {
+            return NULL;
+        }
+        memset(fmp->mem, 0, size);
+        fm_mem_advance(fmp, size);
+        return fmp->mem;
+    }
+#ifdef FM_HAVE_MMAP
+    if ((fmp->flags & (OUT_FILE_MMAP | BARCODE_STDOUT | BARCODE_WRITE_FUNC)) == OUT_FILE_MMAP
+            && fm_map_file(fmp, size)) {
+        return fmp->map;
+    }
+#endif
+    return NULL;
+}
+
+INTERNAL int fm_seekable(const struct filemem *fmp) {
+    if (fmp->gz) {
+        return 0;
+    }
+    if (fmp->flags & BARCODE_MEMORY_FILE) {
+        return 1;
+    }
+    return (fmp->flags & (BARCODE_STDOUT | BARCODE_WRITE_FUNC)) == 0;
+}
+
+INTERNAL int fm_error(const struct filemem *fmp) {
+    return fmp->err;
+}
+
+static int fm_close_output(struct filemem *fmp, struct zint_symbol *symbol) {
+    if (fmp->flags & BARCODE_MEMORY_FILE) {
+        if (fmp->err || !fmp->mem || fmp->memend > INT_MAX) {
+            if (fmp->mem) {
+                z_free(fmp->allocator, fmp->mem);
+            }
+            fmp->mem = NULL;
+            return 0;
+        }
+        /* Hand over to symbol, unshrunk so that it can be re-used by the next print */
+        symbol->internal->memfile_buf = symbol->memfile = fmp->mem;
+        symbol->internal->memfile_capacity = fmp->memsize;
+        symbol->memfile_size = (int) fmp->memend;
+        fmp->mem = NULL;
+        return 1;
+    }
+    if (fmp->flags & BARCODE_WRITE_FUNC) {
+        fmp->write_func = NULL;
+        return !fmp->err;
+    }
+#ifdef FM_HAVE_MMAP
+    if (fmp->map) {
+#ifdef _WIN32
+        if (!UnmapViewOfFile(fmp->map)) {
+#else
+        if (munmap(fmp->map, fmp->mapsize) != 0) {
+#endif
+            fmp->err = 1;
+        }
+        fmp->map = NULL;
+    }
+#endif
+    if (fmp->flags & BARCODE_STDOUT) {
+        if (fflush(fmp->fp) != 0) {
+            fmp->err = 1;
+        }
+    } else if (fclose(fmp->fp) != 0) {
+        fmp->err = 1;
+    }
+    fmp->fp = NULL;
+    return !fmp->err;
+}
+
+INTERNAL int fm_close(struct filemem *fmp, struct zint_symbol *symbol) {
+    long written;
+    int ret;
+
+    if (fmp->gz) {
+        fm_gz_end(fmp);
+    }
+    if (fmp->flags & BARCODE_MEMORY_FILE) {
+        written = (long) fmp->memend;
+    } else if (fmp->flags & BARCODE_WRITE_FUNC) {
+        written = (long) fmp->mempos;
+    } else if (fmp->map) {
+        written = (long) fmp->mapsize;
+    } else if (!symbol->trace_func || (written = ftell(fmp->fp)) < 0) {
+        written = 0; /* Unknown (stdout pipe) */
+    }
+    ret = fm_close_output(fmp, symbol);
+    z_trace(symbol, ZINT_PHASE_OUTPUT, ZINT_TRACE_END, !ret ? -1 : written > INT_MAX ? INT_MAX : (int) written);
+
+    return ret;
+}
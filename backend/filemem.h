@@ -0,0 +1,113 @@
+/*  filemem.h - write to file or memory abstraction used by the output formats */
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#ifndef FILEMEM_H
+#define FILEMEM_H
+
+#include <stdio.h>
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Output handle, writing either to a file (`fp` set), to a growable memory buffer (`mem`) or through a
+   caller-supplied callback (`write_func`) */
+struct filemem {
+    FILE *fp;
+    int (*write_func)(void *write_context, const unsigned char *data, int length);
+    void *write_context;
+    unsigned char *mem;
+    size_t memsize; /* Allocated size of `mem` */
+    size_t mempos; /* Current position in `mem` */
+    size_t memend; /* End of data in `mem` (may be beyond `mempos` after `fm_seek()`) */
+    unsigned char *map; /* File `fp` memory-mapped by `fm_map()`, NULL if not */
+    size_t mapsize;
+    struct fm_gzip *gz; /* If non-NULL output is being gzipped, see `fm_gzip()` */
+    int flags; /* `symbol->output_options` masked with BARCODE_STDOUT | BARCODE_MEMORY_FILE | BARCODE_WRITE_FUNC |
+                  OUT_FILE_MMAP */
+    int err; /* Non-zero if an error has occurred */
+    const struct zint_allocator *allocator; /* Of the symbol, for `mem` (set by `fm_open()`, else by the user) */
+};
+
+/* Open for writing to `symbol->outfile`, stdout, memory or `symbol->write_func` as set by
+   `symbol->output_options`. `mode` is as `fopen()` (only relevant to files). Returns 1 on success, 0 on failure */
+INTERNAL int fm_open(struct filemem *fmp, struct zint_symbol *symbol, const char *mode);
+
+/* Compress all further output with gzip (RFC 1952) as it is written, favouring speed if `fast`, finishing on
+   `fm_close()`. Must be called straight after `fm_open()`. Returns 1 on success, 0 on failure (out of memory, or
+   if built without zlib (NO_PNG)) */
+INTERNAL int fm_gzip(struct filemem *fmp, const int fast);
+
+/* As `fwrite()`, returns `nitems` on success, 0 on failure */
+INTERNAL size_t fm_write(const void *ptr, size_t size, size_t nitems, struct filemem *fmp);
+
+/* As `fputc()`, returns `ch` on success, EOF on failure */
+INTERNAL int fm_putc(int ch, struct filemem *fmp);
+
+/* As `fputs()`, returns non-negative on success, EOF on failure */
+INTERNAL int fm_puts(const char *str, struct filemem *fmp);
+
+/* As `fprintf()`, returns number of chars output on success, negative on failure */
+INTERNAL int fm_printf(struct filemem *fmp, const char *format, ...);
+
+/* Output `prefix` (if non-NULL) followed by `arg` to `dp` decimal places, always using '.' as decimal point
+   whatever the locale (so no need for non-thread-safe `setlocale()`). Returns 1 on success, 0 on failure */
+INTERNAL int fm_putsf(const char *prefix, const int dp, const float arg, struct filemem *fmp);
+
+/* As `fseek()`, returns 0 on success, -1 on failure (always fails for `write_func` or if gzipping) */
+INTERNAL int fm_seek(struct filemem *fmp, long offset, int whence);
+
+/* As `ftell()`, returns -1 on failure (for `write_func` returns number of bytes written) */
+INTERNAL long fm_tell(struct filemem *fmp);
+
+/* Make the output exactly `size` bytes, zeroed, returning them to be written directly: for BARCODE_MEMORY_FILE the
+   memory buffer, else if OUT_FILE_MMAP set and writing to a file, the pre-sized file memory-mapped. Must be called
+   straight after `fm_open()`, nothing else being output. Returns NULL if not possible (or not OUT_FILE_MMAP), the
+   output then to be written as usual */
+INTERNAL unsigned char *fm_map(struct filemem *fmp, const size_t size);
+
+/* Returns 1 if can seek (i.e. not stdout or `write_func`, and not gzipping), 0 otherwise */
+INTERNAL int fm_seekable(const struct filemem *fmp);
+
+/* Returns non-zero if an error has occurred */
+INTERNAL int fm_error(const struct filemem *fmp);
+
+/* Close, flushing stdout or transferring the memory buffer to `symbol->memfile`. Returns 1 on success, 0 if
+   an error occurred at any point (memory is freed, file is closed regardless) */
+INTERNAL int fm_close(struct filemem *fmp, struct zint_symbol *symbol);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FILEMEM_H */
@@ -39,7 +39,7 @@ typedef const unsigned short font_item;
 #define NORMAL_FONT_WIDTH   7
 #define NORMAL_FONT_HEIGHT  14
 
-static font_item ascii_font[] = {
+static const font_item ascii_font[] = {
     /* Each character is 7 x 14 pixels */
     0, 0, 8, 8, 8, 8, 8, 8, 8, 0, 8, 8, 0, 0, /* ! */
     0, 20, 20, 20, 20, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* " */
@@ -235,7 +235,7 @@ static font_item ascii_font[] = {
 #define SMALL_FONT_WIDTH    5
 #define SMALL_FONT_HEIGHT   9
 
-static font_item small_font[] = {
+static const font_item small_font[] = {
     /* Each character is 5 x 9 pixels */
     0, 2, 2, 2, 2, 0, 2, 0, 0, /* ! */
     0, 5, 5, 5, 0, 0, 0, 0, 0, /* " */
@@ -456,7 +456,7 @@ static font_item small_font[] = {
 #define UPCEAN_FONT_HEIGHT  14
 
 /* Each character is 9 x 14 pixels */
-static font_item upcean_font[] = {
+static const font_item upcean_font[] = {
     /*30*/ 0x007C, 0x00FE, 0x00C6, 0x0183, 0x0183, 0x0183, 0x0183, 0x0183, 0x0183, 0x0183, 0x0183, 0x00C6, 0x00FE, 0x007C, /* 0 */
     /*31*/ 0x000C, 0x001C, 0x003C, 0x006C, 0x004C, 0x000C, 0x000C, 0x000C, 0x000C, 0x000C, 0x000C, 0x000C, 0x000C, 0x000C, /* 1 */
     /*32*/ 0x007C, 0x00FE, 0x0183, 0x0003, 0x0007, 0x000E, 0x001C, 0x0038, 0x0070, 0x00E0, 0x01C0, 0x0180, 0x01FE, 0x00FF, /* 2 */
@@ -473,7 +473,7 @@ static font_item upcean_font[] = {
 #define UPCEAN_SMALL_FONT_HEIGHT  13
 
 /* Each character is 8 x 13 pixels */
-static font_item upcean_small_font[] = {
+static const font_item upcean_small_font[] = {
     /*30*/ 0x3C, 0x7E, 0x66, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0x66, 0x7E, 0x3C, /* 0 */
     /*31*/ 0x00, 0x0E, 0x1E, 0x36, 0x26, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, /* 1 */
     /*32*/ 0x38, 0x7C, 0xC6, 0x02, 0x02, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0xFC, 0x7E, /* 2 */
@@ -60,6 +60,7 @@
 #include "gb18030.h"
 #include "eci.h"
 
+#ifndef NO_CJK /* GBK and GB 18030 two-byte tables excluded if NO_CJK */
 /*
  * CP936 extensions (libiconv-1.16/lib/cp936ext.h)
  */
@@ -1897,14 +1898,14 @@ typedef struct {
   unsigned short used; /* bitmask of used entries */
 } Summary16;
 
-static const Summary16 gbkext_inv_uni2indx_page02[14] = {
+static const Summary16 gbkext_inv_uni2indx_page02[16] = {
   /* 0x0200 */
   {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 },
   {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 },
   {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 },
-  {    0, 0x0c00 }, {    2, 0x0200 },
+  {    0, 0x0c00 }, {    2, 0x0200 }, {    3, 0x0000 }, {    3, 0x0000 },
 };
-static const Summary16 gbkext_inv_uni2indx_page20[44] = {
+static const Summary16 gbkext_inv_uni2indx_page20[48] = {
   /* 0x2000 */
   {    3, 0x0000 }, {    3, 0x0029 }, {    6, 0x0020 }, {    7, 0x0020 },
   {    8, 0x0000 }, {    8, 0x0000 }, {    8, 0x0000 }, {    8, 0x0000 },
@@ -1919,15 +1920,19 @@ static const Summary16 gbkext_inv_uni2indx_page20[44] = {
   {   15, 0x0000 }, {   15, 0x8020 }, {   17, 0x0008 }, {   18, 0x0000 },
   {   18, 0x0000 }, {   18, 0x0004 }, {   19, 0x00c0 }, {   21, 0x0000 },
   {   21, 0x0000 }, {   21, 0x0020 }, {   22, 0x0000 }, {   22, 0x8000 },
+  {   23, 0x0000 }, {   23, 0x0000 }, {   23, 0x0000 }, {   23, 0x0000 },
 };
-static const Summary16 gbkext_inv_uni2indx_page25[17] = {
+static const Summary16 gbkext_inv_uni2indx_page25[32] = {
   /* 0x2500 */
   {   23, 0x0000 }, {   23, 0x0000 }, {   23, 0x0000 }, {   23, 0x0000 },
   {   23, 0x0000 }, {   23, 0xffff }, {   39, 0xffff }, {   55, 0x000f },
   {   59, 0xfffe }, {   74, 0x0038 }, {   77, 0x0000 }, {   77, 0x3000 },
   {   79, 0x0000 }, {   79, 0x0000 }, {   79, 0x003c }, {   83, 0x0000 },
   /* 0x2600 */
-  {   83, 0x0200 },
+  {   83, 0x0200 }, {   84, 0x0000 }, {   84, 0x0000 }, {   84, 0x0000 },
+  {   84, 0x0000 }, {   84, 0x0000 }, {   84, 0x0000 }, {   84, 0x0000 },
+  {   84, 0x0000 }, {   84, 0x0000 }, {   84, 0x0000 }, {   84, 0x0000 },
+  {   84, 0x0000 }, {   84, 0x0000 }, {   84, 0x0000 }, {   84, 0x0000 },
 };
 static const Summary16 gbkext_inv_uni2indx_page30[16] = {
   /* 0x3000 */
@@ -1936,7 +1941,7 @@ static const Summary16 gbkext_inv_uni2indx_page30[16] = {
   {   98, 0x0000 }, {   98, 0x7800 }, {  102, 0x0000 }, {  102, 0x0000 },
   {  102, 0x0000 }, {  102, 0x0000 }, {  102, 0x0000 }, {  102, 0x7000 },
 };
-static const Summary16 gbkext_inv_uni2indx_page32[30] = {
+static const Summary16 gbkext_inv_uni2indx_page32[32] = {
   /* 0x3200 */
   {  105, 0x0000 }, {  105, 0x0000 }, {  105, 0x0000 }, {  105, 0x0002 },
   {  106, 0x0000 }, {  106, 0x0000 }, {  106, 0x0000 }, {  106, 0x0000 },
@@ -1946,9 +1951,9 @@ static const Summary16 gbkext_inv_uni2indx_page32[30] = {
   {  107, 0x0000 }, {  107, 0x0000 }, {  107, 0x0000 }, {  107, 0x0000 },
   {  107, 0x0000 }, {  107, 0x0000 }, {  107, 0x0000 }, {  107, 0x0000 },
   {  107, 0xc000 }, {  109, 0x7000 }, {  112, 0x0002 }, {  113, 0x0000 },
-  {  113, 0x4010 }, {  115, 0x0026 },
+  {  113, 0x4010 }, {  115, 0x0026 }, {  118, 0x0000 }, {  118, 0x0000 },
 };
-static const Summary16 gbkext_inv_uni2indx_page4e[1307] = {
+static const Summary16 gbkext_inv_uni2indx_page4e[1312] = {
   /* 0x4e00 */
   {  118, 0x8074 }, {  123, 0x8084 }, {  126, 0xc24b }, {  133, 0x10aa },
   {  138, 0x0457 }, {  144, 0x0ca2 }, {  149, 0xfdbc }, {  161, 0xbff4 },
@@ -2357,18 +2362,22 @@ static const Summary16 gbkext_inv_uni2indx_page4e[1307] = {
   /* 0x9f00 */
   { 14127, 0x97ff }, { 14140, 0xfd76 }, { 14152, 0x6ffa }, { 14164, 0x957f },
   { 14175, 0xffef }, { 14190, 0xfffc }, { 14204, 0xffff }, { 14220, 0x7fff },
-  { 14235, 0xe006 }, { 14240, 0x71ff }, { 14252, 0x003e },
+  { 14235, 0xe006 }, { 14240, 0x71ff }, { 14252, 0x003e }, { 14257, 0x0000 },
+  { 14257, 0x0000 }, { 14257, 0x0000 }, { 14257, 0x0000 }, { 14257, 0x0000 },
 };
-static const Summary16 gbkext_inv_uni2indx_pagef9[19] = {
+static const Summary16 gbkext_inv_uni2indx_pagef9[32] = {
   /* 0xf900 */
   { 14257, 0x0000 }, { 14257, 0x0000 }, { 14257, 0x1000 }, { 14258, 0x0000 },
   { 14258, 0x0000 }, { 14258, 0x0000 }, { 14258, 0x0000 }, { 14258, 0x0200 },
   { 14259, 0x0000 }, { 14259, 0x0020 }, { 14260, 0x0000 }, { 14260, 0x0000 },
   { 14260, 0x0000 }, { 14260, 0x0000 }, { 14260, 0x0080 }, { 14261, 0x0002 },
   /* 0xfa00 */
-  { 14262, 0xf000 }, { 14266, 0x811a }, { 14271, 0x039b },
+  { 14262, 0xf000 }, { 14266, 0x811a }, { 14271, 0x039b }, { 14278, 0x0000 },
+  { 14278, 0x0000 }, { 14278, 0x0000 }, { 14278, 0x0000 }, { 14278, 0x0000 },
+  { 14278, 0x0000 }, { 14278, 0x0000 }, { 14278, 0x0000 }, { 14278, 0x0000 },
+  { 14278, 0x0000 }, { 14278, 0x0000 }, { 14278, 0x0000 }, { 14278, 0x0000 },
 };
-static const Summary16 gbkext_inv_uni2indx_pagefe[31] = {
+static const Summary16 gbkext_inv_uni2indx_pagefe[32] = {
   /* 0xfe00 */
   { 14278, 0x0000 }, { 14278, 0x0000 }, { 14278, 0x0000 }, { 14278, 0x0001 },
   { 14279, 0xfe00 }, { 14286, 0xfef7 }, { 14300, 0x0f7f }, { 14311, 0x0000 },
@@ -2378,27 +2387,96 @@ static const Summary16 gbkext_inv_uni2indx_pagefe[31] = {
   { 14311, 0x0000 }, { 14311, 0x0000 }, { 14311, 0x0000 }, { 14311, 0x0000 },
   { 14311, 0x0000 }, { 14311, 0x0000 }, { 14311, 0x0000 }, { 14311, 0x0000 },
   { 14311, 0x0000 }, { 14311, 0x0000 }, { 14311, 0x0000 }, { 14311, 0x0000 },
-  { 14311, 0x0000 }, { 14311, 0x0000 }, { 14311, 0x0014 },
+  { 14311, 0x0000 }, { 14311, 0x0000 }, { 14311, 0x0014 }, { 14313, 0x0000 },
+};
+
+/* ZINT: Direct index by Unicode high byte to pages of 16 summaries (page arrays padded to a multiple of
+ * 16 entries), replacing range checks */
+static const Summary16 *const gbkext_inv_uni2indx_pages[256] = {
+  /* 0x00 */ NULL, NULL,
+  /* 0x02 */ gbkext_inv_uni2indx_page02 + 0x000,
+  /* 0x03 */ NULL, NULL, NULL, NULL, NULL,
+  /* 0x08 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x10 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x18 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x20 */ gbkext_inv_uni2indx_page20 + 0x000, gbkext_inv_uni2indx_page20 + 0x010,
+  /* 0x22 */ gbkext_inv_uni2indx_page20 + 0x020,
+  /* 0x23 */ NULL, NULL,
+  /* 0x25 */ gbkext_inv_uni2indx_page25 + 0x000, gbkext_inv_uni2indx_page25 + 0x010,
+  /* 0x27 */ NULL,
+  /* 0x28 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x30 */ gbkext_inv_uni2indx_page30 + 0x000,
+  /* 0x31 */ NULL,
+  /* 0x32 */ gbkext_inv_uni2indx_page32 + 0x000, gbkext_inv_uni2indx_page32 + 0x010,
+  /* 0x34 */ NULL, NULL, NULL, NULL,
+  /* 0x38 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x40 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x48 */ NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x4e */ gbkext_inv_uni2indx_page4e + 0x000, gbkext_inv_uni2indx_page4e + 0x010,
+  /* 0x50 */ gbkext_inv_uni2indx_page4e + 0x020, gbkext_inv_uni2indx_page4e + 0x030,
+  /* 0x52 */ gbkext_inv_uni2indx_page4e + 0x040, gbkext_inv_uni2indx_page4e + 0x050,
+  /* 0x54 */ gbkext_inv_uni2indx_page4e + 0x060, gbkext_inv_uni2indx_page4e + 0x070,
+  /* 0x56 */ gbkext_inv_uni2indx_page4e + 0x080, gbkext_inv_uni2indx_page4e + 0x090,
+  /* 0x58 */ gbkext_inv_uni2indx_page4e + 0x0a0, gbkext_inv_uni2indx_page4e + 0x0b0,
+  /* 0x5a */ gbkext_inv_uni2indx_page4e + 0x0c0, gbkext_inv_uni2indx_page4e + 0x0d0,
+  /* 0x5c */ gbkext_inv_uni2indx_page4e + 0x0e0, gbkext_inv_uni2indx_page4e + 0x0f0,
+  /* 0x5e */ gbkext_inv_uni2indx_page4e + 0x100, gbkext_inv_uni2indx_page4e + 0x110,
+  /* 0x60 */ gbkext_inv_uni2indx_page4e + 0x120, gbkext_inv_uni2indx_page4e + 0x130,
+  /* 0x62 */ gbkext_inv_uni2indx_page4e + 0x140, gbkext_inv_uni2indx_page4e + 0x150,
+  /* 0x64 */ gbkext_inv_uni2indx_page4e + 0x160, gbkext_inv_uni2indx_page4e + 0x170,
+  /* 0x66 */ gbkext_inv_uni2indx_page4e + 0x180, gbkext_inv_uni2indx_page4e + 0x190,
+  /* 0x68 */ gbkext_inv_uni2indx_page4e + 0x1a0, gbkext_inv_uni2indx_page4e + 0x1b0,
+  /* 0x6a */ gbkext_inv_uni2indx_page4e + 0x1c0, gbkext_inv_uni2indx_page4e + 0x1d0,
+  /* 0x6c */ gbkext_inv_uni2indx_page4e + 0x1e0, gbkext_inv_uni2indx_page4e + 0x1f0,
+  /* 0x6e */ gbkext_inv_uni2indx_page4e + 0x200, gbkext_inv_uni2indx_page4e + 0x210,
+  /* 0x70 */ gbkext_inv_uni2indx_page4e + 0x220, gbkext_inv_uni2indx_page4e + 0x230,
+  /* 0x72 */ gbkext_inv_uni2indx_page4e + 0x240, gbkext_inv_uni2indx_page4e + 0x250,
+  /* 0x74 */ gbkext_inv_uni2indx_page4e + 0x260, gbkext_inv_uni2indx_page4e + 0x270,
+  /* 0x76 */ gbkext_inv_uni2indx_page4e + 0x280, gbkext_inv_uni2indx_page4e + 0x290,
+  /* 0x78 */ gbkext_inv_uni2indx_page4e + 0x2a0, gbkext_inv_uni2indx_page4e + 0x2b0,
+  /* 0x7a */ gbkext_inv_uni2indx_page4e + 0x2c0, gbkext_inv_uni2indx_page4e + 0x2d0,
+  /* 0x7c */ gbkext_inv_uni2indx_page4e + 0x2e0, gbkext_inv_uni2indx_page4e + 0x2f0,
+  /* 0x7e */ gbkext_inv_uni2indx_page4e + 0x300, gbkext_inv_uni2indx_page4e + 0x310,
+  /* 0x80 */ gbkext_inv_uni2indx_page4e + 0x320, gbkext_inv_uni2indx_page4e + 0x330,
+  /* 0x82 */ gbkext_inv_uni2indx_page4e + 0x340, gbkext_inv_uni2indx_page4e + 0x350,
+  /* 0x84 */ gbkext_inv_uni2indx_page4e + 0x360, gbkext_inv_uni2indx_page4e + 0x370,
+  /* 0x86 */ gbkext_inv_uni2indx_page4e + 0x380, gbkext_inv_uni2indx_page4e + 0x390,
+  /* 0x88 */ gbkext_inv_uni2indx_page4e + 0x3a0, gbkext_inv_uni2indx_page4e + 0x3b0,
+  /* 0x8a */ gbkext_inv_uni2indx_page4e + 0x3c0, gbkext_inv_uni2indx_page4e + 0x3d0,
+  /* 0x8c */ gbkext_inv_uni2indx_page4e + 0x3e0, gbkext_inv_uni2indx_page4e + 0x3f0,
+  /* 0x8e */ gbkext_inv_uni2indx_page4e + 0x400, gbkext_inv_uni2indx_page4e + 0x410,
+  /* 0x90 */ gbkext_inv_uni2indx_page4e + 0x420, gbkext_inv_uni2indx_page4e + 0x430,
+  /* 0x92 */ gbkext_inv_uni2indx_page4e + 0x440, gbkext_inv_uni2indx_page4e + 0x450,
+  /* 0x94 */ gbkext_inv_uni2indx_page4e + 0x460, gbkext_inv_uni2indx_page4e + 0x470,
+  /* 0x96 */ gbkext_inv_uni2indx_page4e + 0x480, gbkext_inv_uni2indx_page4e + 0x490,
+  /* 0x98 */ gbkext_inv_uni2indx_page4e + 0x4a0, gbkext_inv_uni2indx_page4e + 0x4b0,
+  /* 0x9a */ gbkext_inv_uni2indx_page4e + 0x4c0, gbkext_inv_uni2indx_page4e + 0x4d0,
+  /* 0x9c */ gbkext_inv_uni2indx_page4e + 0x4e0, gbkext_inv_uni2indx_page4e + 0x4f0,
+  /* 0x9e */ gbkext_inv_uni2indx_page4e + 0x500, gbkext_inv_uni2indx_page4e + 0x510,
+  /* 0xa0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xa8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xb0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xb8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xc0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xc8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xd0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xd8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf8 */ NULL,
+  /* 0xf9 */ gbkext_inv_uni2indx_pagef9 + 0x000, gbkext_inv_uni2indx_pagef9 + 0x010,
+  /* 0xfb */ NULL, NULL, NULL,
+  /* 0xfe */ gbkext_inv_uni2indx_pagefe + 0x000, gbkext_inv_uni2indx_pagefe + 0x010,
 };
 
 static int gbkext_inv_wctomb(unsigned int *r, const unsigned int wc) {
     const Summary16 *summary = NULL;
-    if (wc >= 0x0200 && wc < 0x02e0) {
-        summary = &gbkext_inv_uni2indx_page02[(wc>>4)-0x020];
-    } else if (wc >= 0x2000 && wc < 0x22c0) {
-        summary = &gbkext_inv_uni2indx_page20[(wc>>4)-0x200];
-    } else if (wc >= 0x2500 && wc < 0x2610) {
-        summary = &gbkext_inv_uni2indx_page25[(wc>>4)-0x250];
-    } else if (wc >= 0x3000 && wc < 0x3100) {
-        summary = &gbkext_inv_uni2indx_page30[(wc>>4)-0x300];
-    } else if (wc >= 0x3200 && wc < 0x33e0) {
-        summary = &gbkext_inv_uni2indx_page32[(wc>>4)-0x320];
-    } else if (wc >= 0x4e00 && wc < 0x9fb0) {
-        summary = &gbkext_inv_uni2indx_page4e[(wc>>4)-0x4e0];
-    } else if (wc >= 0xf900 && wc < 0xfa30) {
-        summary = &gbkext_inv_uni2indx_pagef9[(wc>>4)-0xf90];
-    } else if (wc >= 0xfe00 && wc < 0xfff0) {
-        summary = &gbkext_inv_uni2indx_pagefe[(wc>>4)-0xfe0];
+    if (wc < 0x10000) {
+        const Summary16 *page = gbkext_inv_uni2indx_pages[wc >> 8];
+        if (page) {
+            summary = &page[(wc >> 4) & 0x0f];
+        }
     }
     if (summary) {
         unsigned short used = summary->used;
@@ -2553,6 +2631,10 @@ static const unsigned short gb18030ext_pagefe[16] = {
 
 static int gb18030ext_wctomb(unsigned int *r, const unsigned int wc) {
     unsigned short c = 0;
+    /* ZINT: Quick reject of ranges with no mappings (in particular main CJK and Hangul blocks) */
+    if (wc < 0x01f9 || (wc > 0x4dae && wc < 0x9fb4) || (wc > 0xfe19 && wc < 0x20087) || wc > 0x241fe) {
+        return 0;
+    }
     if (wc == 0x01f9) {
         c = 0xa8bf;
     } else if (wc == 0x1e3f) {
@@ -2633,6 +2715,8 @@ static int gb18030ext_wctomb(unsigned int *r, const unsigned int wc) {
     return 0;
 }
 
+#endif /* NO_CJK */
+
 /*
  * GB18030 four-byte extension (libiconv-1.16/lib/gb18030uni.h)
  */
@@ -2805,6 +2889,7 @@ INTERNAL int gb18030_wctomb_zint(unsigned int *r1, unsigned int *r2, const unsig
         return 1;
     }
 
+#ifndef NO_CJK
     /* Code set 1 (GBK extended) */
     ret = gbk_wctomb(r1, wc);
     if (ret) {
@@ -2815,6 +2900,7 @@ INTERNAL int gb18030_wctomb_zint(unsigned int *r1, unsigned int *r2, const unsig
     if (ret) {
         return ret;
     }
+#endif
 
     /* Code set 2 (remainder of Unicode U+0000..U+FFFF) */
     if (wc >= 0xe000 && wc <= 0xe864) {
@@ -2872,11 +2958,12 @@ INTERNAL int gb18030_utf8(struct zint_symbol *symbol, const unsigned char source
                 unsigned int *gbdata) {
     int error_number, ret;
     unsigned int i, j, length;
-#ifndef _MSC_VER
-    unsigned int utfdata[*p_length + 1];
-#else
-    unsigned int *utfdata = (unsigned int *) _alloca((*p_length + 1) * sizeof(unsigned int));
-#endif
+    /* May expand to 2 entries per character so can't convert in place */
+    z_work_array(symbol, unsigned int, utfdata, *p_length + 1);
+
+    if (z_work_failed(utfdata)) {
+        return z_work_error(symbol);
+    }
 
     error_number = utf8_to_unicode(symbol, source, utfdata, p_length, 0 /*disallow_4byte*/);
     if (error_number != 0) {
@@ -2904,17 +2991,17 @@ INTERNAL int gb18030_utf8(struct zint_symbol *symbol, const unsigned char source
 }
 
 /* Convert UTF-8 string to ECI and place in array of ints */
-INTERNAL int gb18030_utf8_to_eci(const int eci, const unsigned char source[], int *p_length, unsigned int *gbdata,
-                const int full_multibyte) {
+INTERNAL int gb18030_utf8_to_eci(struct zint_symbol *symbol, const int eci, const unsigned char source[],
+                int *p_length, unsigned int *gbdata, const int full_multibyte) {
 
     if (is_eci_convertible(eci)) {
         int error_number;
         int eci_length = get_eci_length(eci, source, *p_length);
-#ifndef _MSC_VER
-        unsigned char converted[eci_length + 1];
-#else
-        unsigned char *converted = (unsigned char *) _alloca(eci_length + 1);
-#endif
+        z_work_array(symbol, unsigned char, converted, eci_length + 1);
+
+        if (z_work_failed(converted)) {
+            return z_work_error(symbol);
+        }
 
         error_number = utf8_to_eci(eci, source, converted, p_length);
         if (error_number != 0) {
@@ -2973,3 +3060,11 @@ INTERNAL void gb18030_cpy(const unsigned char source[], int *p_length, unsigned
         }
     }
 }
+
+/* Page in the main conversion tables (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t gb18030_tables_warm(const int touch) {
+    return z_table_warm(gbkext_inv_2charset, sizeof(gbkext_inv_2charset), touch)
+            + z_table_warm(gbkext_inv_uni2indx_page4e, sizeof(gbkext_inv_uni2indx_page4e), touch)
+            + z_table_warm(gb18030uni_uni2charset_ranges, sizeof(gb18030uni_uni2charset_ranges), touch)
+            + z_table_warm(gb18030uni_ranges, sizeof(gb18030uni_ranges), touch);
+}
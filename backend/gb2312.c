@@ -59,6 +59,7 @@
 #include "gb2312.h"
 #include "eci.h"
 
+#ifndef NO_CJK /* GB 2312 tables excluded if NO_CJK */
 /*
  * GB2312.1980-0 (libiconv-1.16/lib/gb2312.h)
  */
@@ -1010,7 +1011,7 @@ typedef struct {
   unsigned short used; /* bitmask of used entries */
 } Summary16;
 
-static const Summary16 gb2312_uni2indx_page00[70] = {
+static const Summary16 gb2312_uni2indx_page00[80] = {
   /* 0x0000 */
   {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 },
   {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 },
@@ -1033,9 +1034,11 @@ static const Summary16 gb2312_uni2indx_page00[70] = {
   {   74, 0x03fb }, {   83, 0x0000 }, {   83, 0x0000 }, {   83, 0x0000 },
   /* 0x0400 */
   {   83, 0x0002 }, {   84, 0xffff }, {  100, 0xffff }, {  116, 0xffff },
-  {  132, 0xffff }, {  148, 0x0002 },
+  {  132, 0xffff }, {  148, 0x0002 }, {  149, 0x0000 }, {  149, 0x0000 },
+  {  149, 0x0000 }, {  149, 0x0000 }, {  149, 0x0000 }, {  149, 0x0000 },
+  {  149, 0x0000 }, {  149, 0x0000 }, {  149, 0x0000 }, {  149, 0x0000 },
 };
-static const Summary16 gb2312_uni2indx_page20[101] = {
+static const Summary16 gb2312_uni2indx_page20[112] = {
   /* 0x2000 */
   {  149, 0x0000 }, {  149, 0x3360 }, {  155, 0x0040 }, {  156, 0x080d },
   {  160, 0x0000 }, {  160, 0x0000 }, {  160, 0x0000 }, {  160, 0x0000 },
@@ -1068,9 +1071,11 @@ static const Summary16 gb2312_uni2indx_page20[101] = {
   {  338, 0xc8c0 }, {  343, 0x0000 }, {  343, 0x0000 }, {  343, 0x0000 },
   /* 0x2600 */
   {  343, 0x0060 }, {  345, 0x0000 }, {  345, 0x0000 }, {  345, 0x0000 },
-  {  345, 0x0005 },
+  {  345, 0x0005 }, {  347, 0x0000 }, {  347, 0x0000 }, {  347, 0x0000 },
+  {  347, 0x0000 }, {  347, 0x0000 }, {  347, 0x0000 }, {  347, 0x0000 },
+  {  347, 0x0000 }, {  347, 0x0000 }, {  347, 0x0000 }, {  347, 0x0000 },
 };
-static const Summary16 gb2312_uni2indx_page30[35] = {
+static const Summary16 gb2312_uni2indx_page30[48] = {
   /* 0x3000 */
   {  347, 0xff2f }, {  360, 0x00fb }, {  367, 0x0000 }, {  367, 0x0000 },
   {  367, 0xfffe }, {  382, 0xffff }, {  398, 0xffff }, {  414, 0xffff },
@@ -1082,9 +1087,12 @@ static const Summary16 gb2312_uni2indx_page30[35] = {
   {  574, 0x0000 }, {  574, 0x0000 }, {  574, 0x0000 }, {  574, 0x0000 },
   {  574, 0x0000 }, {  574, 0x0000 }, {  574, 0x0000 }, {  574, 0x0000 },
   /* 0x3200 */
-  {  574, 0x0000 }, {  574, 0x0000 }, {  574, 0x03ff },
+  {  574, 0x0000 }, {  574, 0x0000 }, {  574, 0x03ff }, {  584, 0x0000 },
+  {  584, 0x0000 }, {  584, 0x0000 }, {  584, 0x0000 }, {  584, 0x0000 },
+  {  584, 0x0000 }, {  584, 0x0000 }, {  584, 0x0000 }, {  584, 0x0000 },
+  {  584, 0x0000 }, {  584, 0x0000 }, {  584, 0x0000 }, {  584, 0x0000 },
 };
-static const Summary16 gb2312_uni2indx_page4e[1263] = {
+static const Summary16 gb2312_uni2indx_page4e[1264] = {
   /* 0x4e00 */
   {  584, 0x7f8b }, {  595, 0x7f7b }, {  608, 0x3db4 }, {  617, 0xef55 },
   {  628, 0xfba8 }, {  638, 0xf35d }, {  649, 0x0243 }, {  653, 0x400b },
@@ -1479,9 +1487,9 @@ static const Summary16 gb2312_uni2indx_page4e[1263] = {
   { 7140, 0x0000 }, { 7140, 0x0000 }, { 7140, 0x0000 }, { 7140, 0x0000 },
   { 7140, 0x0000 }, { 7140, 0x0000 }, { 7140, 0x0000 }, { 7140, 0x9000 },
   { 7142, 0x69e6 }, { 7151, 0xdc37 }, { 7161, 0x6bff }, { 7174, 0x3dff },
-  { 7187, 0xfcf8 }, { 7198, 0xf3f9 }, { 7210, 0x0004 },
+  { 7187, 0xfcf8 }, { 7198, 0xf3f9 }, { 7210, 0x0004 }, { 7211, 0x0000 },
 };
-static const Summary16 gb2312_uni2indx_page9e[27] = {
+static const Summary16 gb2312_uni2indx_page9e[32] = {
   /* 0x9e00 */
   { 7211, 0x0000 }, { 7211, 0x8000 }, { 7212, 0xbf6f }, { 7225, 0xe7ee },
   { 7237, 0xdffe }, { 7251, 0x5da2 }, { 7259, 0x3fd8 }, { 7269, 0xc00b },
@@ -1490,38 +1498,117 @@ static const Summary16 gb2312_uni2indx_page9e[27] = {
   /* 0x9f00 */
   { 7311, 0x6800 }, { 7314, 0x0289 }, { 7318, 0x9005 }, { 7322, 0x6a80 },
   { 7327, 0x0010 }, { 7328, 0x0003 }, { 7330, 0x0000 }, { 7330, 0x8000 },
-  { 7331, 0x1ff9 }, { 7342, 0x8e00 }, { 7346, 0x0001 },
+  { 7331, 0x1ff9 }, { 7342, 0x8e00 }, { 7346, 0x0001 }, { 7347, 0x0000 },
+  { 7347, 0x0000 }, { 7347, 0x0000 }, { 7347, 0x0000 }, { 7347, 0x0000 },
 };
-static const Summary16 gb2312_uni2indx_pageff[15] = {
+static const Summary16 gb2312_uni2indx_pageff[16] = {
   /* 0xff00 */
   { 7347, 0xfffe }, { 7362, 0xffff }, { 7378, 0xffff }, { 7394, 0xffff },
   { 7410, 0xffff }, { 7426, 0x7fff }, { 7441, 0x0000 }, { 7441, 0x0000 },
   { 7441, 0x0000 }, { 7441, 0x0000 }, { 7441, 0x0000 }, { 7441, 0x0000 },
-  { 7441, 0x0000 }, { 7441, 0x0000 }, { 7441, 0x002b },
+  { 7441, 0x0000 }, { 7441, 0x0000 }, { 7441, 0x002b }, { 7445, 0x0000 },
 };
 
+/* ZINT: Direct index by Unicode high byte to pages of 16 summaries (page arrays padded to a multiple of
+ * 16 entries), replacing range checks */
+static const Summary16 *const gb2312_uni2indx_pages[256] = {
+  /* 0x00 */ gb2312_uni2indx_page00 + 0x000, gb2312_uni2indx_page00 + 0x010,
+  /* 0x02 */ gb2312_uni2indx_page00 + 0x020, gb2312_uni2indx_page00 + 0x030,
+  /* 0x04 */ gb2312_uni2indx_page00 + 0x040,
+  /* 0x05 */ NULL, NULL, NULL,
+  /* 0x08 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x10 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x18 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x20 */ gb2312_uni2indx_page20 + 0x000, gb2312_uni2indx_page20 + 0x010,
+  /* 0x22 */ gb2312_uni2indx_page20 + 0x020, gb2312_uni2indx_page20 + 0x030,
+  /* 0x24 */ gb2312_uni2indx_page20 + 0x040, gb2312_uni2indx_page20 + 0x050,
+  /* 0x26 */ gb2312_uni2indx_page20 + 0x060,
+  /* 0x27 */ NULL,
+  /* 0x28 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x30 */ gb2312_uni2indx_page30 + 0x000, gb2312_uni2indx_page30 + 0x010,
+  /* 0x32 */ gb2312_uni2indx_page30 + 0x020,
+  /* 0x33 */ NULL, NULL, NULL, NULL, NULL,
+  /* 0x38 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x40 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x48 */ NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x4e */ gb2312_uni2indx_page4e + 0x000, gb2312_uni2indx_page4e + 0x010,
+  /* 0x50 */ gb2312_uni2indx_page4e + 0x020, gb2312_uni2indx_page4e + 0x030,
+  /* 0x52 */ gb2312_uni2indx_page4e + 0x040, gb2312_uni2indx_page4e + 0x050,
+  /* 0x54 */ gb2312_uni2indx_page4e + 0x060, gb2312_uni2indx_page4e + 0x070,
+  /* 0x56 */ gb2312_uni2indx_page4e + 0x080, gb2312_uni2indx_page4e + 0x090,
+  /* 0x58 */ gb2312_uni2indx_page4e + 0x0a0, gb2312_uni2indx_page4e + 0x0b0,
+  /* 0x5a */ gb2312_uni2indx_page4e + 0x0c0, gb2312_uni2indx_page4e + 0x0d0,
+  /* 0x5c */ gb2312_uni2indx_page4e + 0x0e0, gb2312_uni2indx_page4e + 0x0f0,
+  /* 0x5e */ gb2312_uni2indx_page4e + 0x100, gb2312_uni2indx_page4e + 0x110,
+  /* 0x60 */ gb2312_uni2indx_page4e + 0x120, gb2312_uni2indx_page4e + 0x130,
+  /* 0x62 */ gb2312_uni2indx_page4e + 0x140, gb2312_uni2indx_page4e + 0x150,
+  /* 0x64 */ gb2312_uni2indx_page4e + 0x160, gb2312_uni2indx_page4e + 0x170,
+  /* 0x66 */ gb2312_uni2indx_page4e + 0x180, gb2312_uni2indx_page4e + 0x190,
+  /* 0x68 */ gb2312_uni2indx_page4e + 0x1a0, gb2312_uni2indx_page4e + 0x1b0,
+  /* 0x6a */ gb2312_uni2indx_page4e + 0x1c0, gb2312_uni2indx_page4e + 0x1d0,
+  /* 0x6c */ gb2312_uni2indx_page4e + 0x1e0, gb2312_uni2indx_page4e + 0x1f0,
+  /* 0x6e */ gb2312_uni2indx_page4e + 0x200, gb2312_uni2indx_page4e + 0x210,
+  /* 0x70 */ gb2312_uni2indx_page4e + 0x220, gb2312_uni2indx_page4e + 0x230,
+  /* 0x72 */ gb2312_uni2indx_page4e + 0x240, gb2312_uni2indx_page4e + 0x250,
+  /* 0x74 */ gb2312_uni2indx_page4e + 0x260, gb2312_uni2indx_page4e + 0x270,
+  /* 0x76 */ gb2312_uni2indx_page4e + 0x280, gb2312_uni2indx_page4e + 0x290,
+  /* 0x78 */ gb2312_uni2indx_page4e + 0x2a0, gb2312_uni2indx_page4e + 0x2b0,
+  /* 0x7a */ gb2312_uni2indx_page4e + 0x2c0, gb2312_uni2indx_page4e + 0x2d0,
+  /* 0x7c */ gb2312_uni2indx_page4e + 0x2e0, gb2312_uni2indx_page4e + 0x2f0,
+  /* 0x7e */ gb2312_uni2indx_page4e + 0x300, gb2312_uni2indx_page4e + 0x310,
+  /* 0x80 */ gb2312_uni2indx_page4e + 0x320, gb2312_uni2indx_page4e + 0x330,
+  /* 0x82 */ gb2312_uni2indx_page4e + 0x340, gb2312_uni2indx_page4e + 0x350,
+  /* 0x84 */ gb2312_uni2indx_page4e + 0x360, gb2312_uni2indx_page4e + 0x370,
+  /* 0x86 */ gb2312_uni2indx_page4e + 0x380, gb2312_uni2indx_page4e + 0x390,
+  /* 0x88 */ gb2312_uni2indx_page4e + 0x3a0, gb2312_uni2indx_page4e + 0x3b0,
+  /* 0x8a */ gb2312_uni2indx_page4e + 0x3c0, gb2312_uni2indx_page4e + 0x3d0,
+  /* 0x8c */ gb2312_uni2indx_page4e + 0x3e0, gb2312_uni2indx_page4e + 0x3f0,
+  /* 0x8e */ gb2312_uni2indx_page4e + 0x400, gb2312_uni2indx_page4e + 0x410,
+  /* 0x90 */ gb2312_uni2indx_page4e + 0x420, gb2312_uni2indx_page4e + 0x430,
+  /* 0x92 */ gb2312_uni2indx_page4e + 0x440, gb2312_uni2indx_page4e + 0x450,
+  /* 0x94 */ gb2312_uni2indx_page4e + 0x460, gb2312_uni2indx_page4e + 0x470,
+  /* 0x96 */ gb2312_uni2indx_page4e + 0x480, gb2312_uni2indx_page4e + 0x490,
+  /* 0x98 */ gb2312_uni2indx_page4e + 0x4a0, gb2312_uni2indx_page4e + 0x4b0,
+  /* 0x9a */ gb2312_uni2indx_page4e + 0x4c0, gb2312_uni2indx_page4e + 0x4d0,
+  /* 0x9c */ gb2312_uni2indx_page4e + 0x4e0,
+  /* 0x9d */ NULL,
+  /* 0x9e */ gb2312_uni2indx_page9e + 0x000, gb2312_uni2indx_page9e + 0x010,
+  /* 0xa0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xa8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xb0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xb8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xc0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xc8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xd0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xd8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xff */ gb2312_uni2indx_pageff + 0x000,
+};
+
+#endif /* NO_CJK */
+
 INTERNAL int gb2312_wctomb_zint(unsigned int *r, const unsigned int wc) {
+#ifdef NO_CJK
+    (void)r; (void)wc;
+    return 0;
+#else
     const Summary16 *summary = NULL;
-    if (wc < 0x0460) {
-        if (wc == 0x00b7) { /* ZINT: Patched to duplicate map to 0xA1A4 */
-            *r = 0xA1A4;
-            return 2;
-        }
-        summary = &gb2312_uni2indx_page00[(wc>>4)];
-    } else if (wc >= 0x2000 && wc < 0x2650) {
-        if (wc == 0x2014) { /* ZINT: Patched to duplicate map to 0xA1AA */
-            *r = 0xA1AA;
-            return 2;
+    if (wc == 0x00b7) { /* ZINT: Patched to duplicate map to 0xA1A4 */
+        *r = 0xA1A4;
+        return 2;
+    }
+    if (wc == 0x2014) { /* ZINT: Patched to duplicate map to 0xA1AA */
+        *r = 0xA1AA;
+        return 2;
+    }
+    if (wc < 0x10000) {
+        const Summary16 *page = gb2312_uni2indx_pages[wc >> 8];
+        if (page) {
+            summary = &page[(wc >> 4) & 0x0f];
         }
-        summary = &gb2312_uni2indx_page20[(wc>>4)-0x200];
-    } else if (wc >= 0x3000 && wc < 0x3230) {
-        summary = &gb2312_uni2indx_page30[(wc>>4)-0x300];
-    } else if (wc >= 0x4e00 && wc < 0x9cf0) {
-        summary = &gb2312_uni2indx_page4e[(wc>>4)-0x4e0];
-    } else if (wc >= 0x9e00 && wc < 0x9fb0) {
-        summary = &gb2312_uni2indx_page9e[(wc>>4)-0x9e0];
-    } else if (wc >= 0xff00 && wc < 0xfff0) {
-        summary = &gb2312_uni2indx_pageff[(wc>>4)-0xff0];
     }
     if (summary) {
         unsigned short used = summary->used;
@@ -1539,6 +1626,7 @@ INTERNAL int gb2312_wctomb_zint(unsigned int *r, const unsigned int wc) {
         }
     }
     return 0;
+#endif /* NO_CJK */
 }
 
 /* Convert UTF-8 string to GB 2312 (EUC-CN) and place in array of ints */
@@ -1546,22 +1634,16 @@ INTERNAL int gb2312_utf8(struct zint_symbol *symbol, const unsigned char source[
                 unsigned int *gbdata) {
     int error_number;
     unsigned int i, length;
-#ifndef _MSC_VER
-    unsigned int utfdata[*p_length + 1];
-#else
-    unsigned int *utfdata = (unsigned int *) _alloca((*p_length + 1) * sizeof(unsigned int));
-#endif
 
-    error_number = utf8_to_unicode(symbol, source, utfdata, p_length, 1 /*disallow_4byte*/);
+    /* Decode into `gbdata` and convert in place, each character giving one entry */
+    error_number = utf8_to_unicode(symbol, source, gbdata, p_length, 1 /*disallow_4byte*/);
     if (error_number != 0) {
         return error_number;
     }
 
     for (i = 0, length = *p_length; i < length; i++) {
-        if (utfdata[i] < 0x80) {
-            gbdata[i] = utfdata[i];
-        } else {
-            if (!gb2312_wctomb_zint(gbdata + i, utfdata[i])) {
+        if (gbdata[i] >= 0x80) {
+            if (!gb2312_wctomb_zint(gbdata + i, gbdata[i])) {
                 strcpy(symbol->errtxt, "810: Invalid character in input data");
                 return ZINT_ERROR_INVALID_DATA;
             }
@@ -1572,17 +1654,17 @@ INTERNAL int gb2312_utf8(struct zint_symbol *symbol, const unsigned char source[
 }
 
 /* Convert UTF-8 string to ECI and place in array of ints */
-INTERNAL int gb2312_utf8_to_eci(const int eci, const unsigned char source[], int *p_length, unsigned int *gbdata,
-                const int full_multibyte) {
+INTERNAL int gb2312_utf8_to_eci(struct zint_symbol *symbol, const int eci, const unsigned char source[],
+                int *p_length, unsigned int *gbdata, const int full_multibyte) {
 
     if (is_eci_convertible(eci)) {
         int error_number;
         int eci_length = get_eci_length(eci, source, *p_length);
-#ifndef _MSC_VER
-        unsigned char converted[eci_length + 1];
-#else
-        unsigned char *converted = (unsigned char *) _alloca(eci_length + 1);
-#endif
+        z_work_array(symbol, unsigned char, converted, eci_length + 1);
+
+        if (z_work_failed(converted)) {
+            return z_work_error(symbol);
+        }
 
         error_number = utf8_to_eci(eci, source, converted, p_length);
         if (error_number != 0) {
@@ -1630,3 +1712,9 @@ INTERNAL void gb2312_cpy(const unsigned char source[], int *p_length, unsigned i
         }
     }
 }
+
+/* Page in the main conversion tables (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t gb2312_tables_warm(const int touch) {
+    return z_table_warm(gb2312_2charset, sizeof(gb2312_2charset), touch)
+            + z_table_warm(gb2312_uni2indx_page4e, sizeof(gb2312_uni2indx_page4e), touch);
+}
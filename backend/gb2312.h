@@ -40,8 +40,8 @@ extern "C" {
 INTERNAL int gb2312_wctomb_zint(unsigned int *r, const unsigned int wc);
 INTERNAL int gb2312_utf8(struct zint_symbol *symbol, const unsigned char source[], int *p_length,
                 unsigned int *gbdata);
-INTERNAL int gb2312_utf8_to_eci(const int eci, const unsigned char source[], int *p_length, unsigned int *gbdata,
-                const int full_multibyte);
+INTERNAL int gb2312_utf8_to_eci(struct zint_symbol *symbol, const int eci, const unsigned char source[],
+                int *p_length, unsigned int *gbdata, const int full_multibyte);
 INTERNAL void gb2312_cpy(const unsigned char source[], int *p_length, unsigned int *gbdata,
                 const int full_multibyte);
 
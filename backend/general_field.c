@@ -31,97 +31,90 @@
  */
 /* vim: set ts=4 sw=4 et : */
 
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
 #include "common.h"
 #include "general_field.h"
 
-static char alphanum_puncs[] = "*,-./";
-static char isoiec_puncs[] = "!\"%&'()*+,-./:;<=>?_ ";
+static const char alphanum_puncs[] = "*,-./";
+static const char isoiec_puncs[] = "!\"%&'()*+,-./:;<=>?_ ";
 
-/* Returns type of char at `i`. FNC1 counted as NUMERIC. Returns 0 if invalid char */
-static int general_field_type(const char *general_field, const int i) {
-    if (general_field[i] == '[' || (general_field[i] >= '0' && general_field[i] <= '9')) {
-        return NUMERIC;
-    }
-    if ((general_field[i] >= 'A' && general_field[i] <= 'Z') || strchr(alphanum_puncs, general_field[i])) {
-        return ALPHANUMERIC;
-    }
-    if ((general_field[i] >= 'a' && general_field[i] <= 'z') || strchr(isoiec_puncs, general_field[i])) {
-        return ISOIEC;
-    }
-    return 0;
-}
-
-/* Returns true if next (including `i`) `num` chars of type `type`, or if given (non-zero), `type2` */
-static int general_field_next(const char *general_field, int i, const int general_field_len, int num, const int type,
-            const int type2) {
-    if (i + num > general_field_len) {
-        return 0;
-    }
-    for (; i < general_field_len && num; i++, num--) {
-        int type_i = general_field_type(general_field, i);
-        if ((type_i != type && !type2) || (type_i != type && type_i != type2)) {
-            return 0;
-        }
-    }
-    return num == 0;
-}
-
-/* Returns true if next (including `i`) `num` up to `max_num` chars of type `type` and occur at end */
-static int general_field_next_terminate(const char *general_field, int i, const int general_field_len, int num,
-            const int max_num, const int type) {
-    if (i + max_num < general_field_len) {
-        return 0;
-    }
-    for (; i < general_field_len; i++, num--) {
-        if (general_field_type(general_field, i) != type) {
-            return 0;
-        }
-    }
-    return i == general_field_len && num <= 0;
-}
+/* Type of each ASCII char (8 per row), FNC1 ('[') counted as NUMERIC, 0 if invalid */
+static const char general_field_types[128] = {
+               0,            0,            0,            0,            0,            0,            0,            0,
+               0,            0,            0,            0,            0,            0,            0,            0,
+               0,            0,            0,            0,            0,            0,            0,            0,
+               0,            0,            0,            0,            0,            0,            0,            0,
+          ISOIEC,       ISOIEC,       ISOIEC,            0,            0,       ISOIEC,       ISOIEC,       ISOIEC,
+          ISOIEC,       ISOIEC, ALPHANUMERIC,       ISOIEC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC,
+         NUMERIC,      NUMERIC,      NUMERIC,      NUMERIC,      NUMERIC,      NUMERIC,      NUMERIC,      NUMERIC,
+         NUMERIC,      NUMERIC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,
+               0, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC,
+    ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC,
+    ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC,
+    ALPHANUMERIC, ALPHANUMERIC, ALPHANUMERIC,      NUMERIC,            0,            0,            0,       ISOIEC,
+               0,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,
+          ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,
+          ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,       ISOIEC,
+          ISOIEC,       ISOIEC,       ISOIEC,            0,            0,            0,            0,            0,
+};
 
-/* Returns true if none of the next (including `i`) `num` chars (or end occurs) of type `type` */
-static int general_field_next_none(const char *general_field, int i, const int general_field_len, int num,
-            const int type) {
-    for (; i < general_field_len && num; i++, num--) {
-        if (general_field_type(general_field, i) == type) {
-            return 0;
-        }
-    }
-    return num == 0 || i == general_field_len;
-}
+/* Returns type of char `ch`. Returns 0 if invalid char */
+#define general_field_type(ch) ((ch) & 0x80 ? 0 : general_field_types[(int) (ch)])
 
 /* Attempts to apply encoding rules from sections 7.2.5.5.1 to 7.2.5.5.3
  * of ISO/IEC 24724:2011 (same as sections 5.4.1 to 5.4.3 of ISO/IEC 24723:2010) */
 INTERNAL int general_field_encode(const char *general_field, const int general_field_len, int *p_mode,
-                char *p_last_digit, char binary_string[], int *p_bp) {
+                char *p_last_digit, struct zint_bits *bits) {
     int i, d1, d2;
     int mode = *p_mode;
     char last_digit = '\0'; /* Set to odd remaining digit at end if any */
-    int bp = *p_bp;
+    /* Per char lookahead, computed in one pass from the end: `numeric_run[i]` NUMERICs starting at `i`,
+       `alphanum_run[i]` ALPHANUMERICs or NUMERICs starting at `i`, and `next_isoiec[i]` the index of the first
+       ISOIEC at or after `i` (`general_field_len` if none) */
+#ifndef _MSC_VER
+    char types[general_field_len];
+    int numeric_run[general_field_len + 1], alphanum_run[general_field_len + 1], next_isoiec[general_field_len + 1];
+#else
+    char *types = (char *) _alloca(general_field_len);
+    int *numeric_run = (int *) _alloca((general_field_len + 1) * sizeof(int));
+    int *alphanum_run = (int *) _alloca((general_field_len + 1) * sizeof(int));
+    int *next_isoiec = (int *) _alloca((general_field_len + 1) * sizeof(int));
+#endif
 
-    for (i = 0; i < general_field_len; ) {
-        int type = general_field_type(general_field, i);
+    numeric_run[general_field_len] = alphanum_run[general_field_len] = 0;
+    next_isoiec[general_field_len] = general_field_len;
+    for (i = general_field_len - 1; i >= 0; i--) {
+        const int type = general_field_type(general_field[i]);
         if (!type) {
             return 0;
         }
+        types[i] = (char) type;
+        numeric_run[i] = type == NUMERIC ? numeric_run[i + 1] + 1 : 0;
+        alphanum_run[i] = type != ISOIEC ? alphanum_run[i + 1] + 1 : 0;
+        next_isoiec[i] = type == ISOIEC ? i : next_isoiec[i + 1];
+    }
+
+    for (i = 0; i < general_field_len; ) {
+        const int type = types[i];
         switch (mode) {
             case NUMERIC:
                 if (i < general_field_len - 1) { /* If at least 2 characters remain */
-                    if (type != NUMERIC || general_field_type(general_field, i + 1) != NUMERIC) {
+                    if (numeric_run[i] < 2) {
                         /* 7.2.5.5.1/5.4.1 a) */
-                        bp = bin_append_posn(0, 4, binary_string, bp); /* Alphanumeric latch "0000" */
+                        bits_append(bits, 0, 4); /* Alphanumeric latch "0000" */
                         mode = ALPHANUMERIC;
                     } else {
                         d1 = general_field[i] == '[' ? 10 : ctoi(general_field[i]);
                         d2 = general_field[i + 1] == '[' ? 10 : ctoi(general_field[i + 1]);
-                        bp = bin_append_posn((11 * d1) + d2 + 8, 7, binary_string, bp);
+                        bits_append(bits, (11 * d1) + d2 + 8, 7);
                         i += 2;
                     }
                 } else { /* If 1 character remains */
                     if (type != NUMERIC) {
                         /* 7.2.5.5.1/5.4.1 b) */
-                        bp = bin_append_posn(0, 4, binary_string, bp); /* Alphanumeric latch "0000" */
+                        bits_append(bits, 0, 4); /* Alphanumeric latch "0000" */
                         mode = ALPHANUMERIC;
                     } else {
                         /* Ending with single digit.
@@ -134,63 +127,60 @@ INTERNAL int general_field_encode(const char *general_field, const int general_f
             case ALPHANUMERIC:
                 if (general_field[i] == '[') {
                     /* 7.2.5.5.2/5.4.2 a) */
-                    bp = bin_append_posn(15, 5, binary_string, bp); /* "01111" */
+                    bits_append(bits, 15, 5); /* "01111" */
                     mode = NUMERIC;
                     i++;
                 } else if (type == ISOIEC) {
                     /* 7.2.5.5.2/5.4.2 b) */
-                    bp = bin_append_posn(4, 5, binary_string, bp); /* ISO/IEC 646 latch "00100" */
+                    bits_append(bits, 4, 5); /* ISO/IEC 646 latch "00100" */
                     mode = ISOIEC;
-                } else if (general_field_next(general_field, i, general_field_len, 6, NUMERIC, 0)) {
+                } else if (numeric_run[i] >= 6) {
                     /* 7.2.5.5.2/5.4.2 c) */
-                    bp = bin_append_posn(0, 3, binary_string, bp); /* Numeric latch "000" */
+                    bits_append(bits, 0, 3); /* Numeric latch "000" */
                     mode = NUMERIC;
-                } else if (general_field_next_terminate(general_field, i, general_field_len, 4,
-                            5 /*Can limit to 5 max due to above*/, NUMERIC)) {
+                } else if (numeric_run[i] >= 4 && numeric_run[i] == general_field_len - i) { /* 4 or 5 (see above) */
                     /* 7.2.5.5.2/5.4.2 d) */
-                    bp = bin_append_posn(0, 3, binary_string, bp); /* Numeric latch "000" */
+                    bits_append(bits, 0, 3); /* Numeric latch "000" */
                     mode = NUMERIC;
                 } else if ((general_field[i] >= '0') && (general_field[i] <= '9')) {
-                    bp = bin_append_posn(general_field[i] - 43, 5, binary_string, bp);
+                    bits_append(bits, general_field[i] - 43, 5);
                     i++;
                 } else if ((general_field[i] >= 'A') && (general_field[i] <= 'Z')) {
-                    bp = bin_append_posn(general_field[i] - 33, 6, binary_string, bp);
+                    bits_append(bits, general_field[i] - 33, 6);
                     i++;
                 } else {
-                    bp = bin_append_posn(posn(alphanum_puncs, general_field[i]) + 58, 6, binary_string, bp);
+                    bits_append(bits, posn(alphanum_puncs, general_field[i]) + 58, 6);
                     i++;
                 }
                 break;
             case ISOIEC:
                 if (general_field[i] == '[') {
                     /* 7.2.5.5.3/5.4.3 a) */
-                    bp = bin_append_posn(15, 5, binary_string, bp); /* "01111" */
+                    bits_append(bits, 15, 5); /* "01111" */
                     mode = NUMERIC;
                     i++;
                 } else {
-                    int next_10_not_isoiec = general_field_next_none(general_field, i, general_field_len, 10, ISOIEC);
-                    if (next_10_not_isoiec && general_field_next(general_field, i, general_field_len, 4,
-                                                NUMERIC, 0)) {
+                    const int next_10_not_isoiec = next_isoiec[i] >= i + 10 || next_isoiec[i] == general_field_len;
+                    if (next_10_not_isoiec && numeric_run[i] >= 4) {
                         /* 7.2.5.5.3/5.4.3 b) */
-                        bp = bin_append_posn(0, 3, binary_string, bp); /* Numeric latch "000" */
+                        bits_append(bits, 0, 3); /* Numeric latch "000" */
                         mode = NUMERIC;
-                    } else if (next_10_not_isoiec && general_field_next(general_field, i, general_field_len, 5,
-                                                        ALPHANUMERIC, NUMERIC)) {
+                    } else if (next_10_not_isoiec && alphanum_run[i] >= 5) {
                         /* 7.2.5.5.3/5.4.3 c) */
                         /* Note this rule can produce longer bitstreams if most of the alphanumerics are numeric */
-                        bp = bin_append_posn(4, 5, binary_string, bp); /* Alphanumeric latch "00100" */
+                        bits_append(bits, 4, 5); /* Alphanumeric latch "00100" */
                         mode = ALPHANUMERIC;
                     } else if ((general_field[i] >= '0') && (general_field[i] <= '9')) {
-                        bp = bin_append_posn(general_field[i] - 43, 5, binary_string, bp);
+                        bits_append(bits, general_field[i] - 43, 5);
                         i++;
                     } else if ((general_field[i] >= 'A') && (general_field[i] <= 'Z')) {
-                        bp = bin_append_posn(general_field[i] - 1, 7, binary_string, bp);
+                        bits_append(bits, general_field[i] - 1, 7);
                         i++;
                     } else if ((general_field[i] >= 'a') && (general_field[i] <= 'z')) {
-                        bp = bin_append_posn(general_field[i] - 7, 7, binary_string, bp);
+                        bits_append(bits, general_field[i] - 7, 7);
                         i++;
                     } else {
-                        bp = bin_append_posn(posn(isoiec_puncs, general_field[i]) + 232, 8, binary_string, bp);
+                        bits_append(bits, posn(isoiec_puncs, general_field[i]) + 232, 8);
                         i++;
                     }
                 }
@@ -200,7 +190,6 @@ INTERNAL int general_field_encode(const char *general_field, const int general_f
 
     *p_mode = mode;
     *p_last_digit = last_digit;
-    *p_bp = bp;
 
     return 1;
 }
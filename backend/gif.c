@@ -34,12 +34,10 @@
 #include <stdio.h>
 #include <string.h>
 #include "common.h"
+#include "filemem.h"
+#include "output.h"
+#include "raster.h"
 #include <math.h>
-#ifdef _MSC_VER
-#include <io.h>
-#include <fcntl.h>
-#include <malloc.h>
-#endif
 
 #define SSET    "0123456789ABCDEF"
 
@@ -54,30 +52,22 @@ typedef struct s_statestruct {
     unsigned short FreeCode;
     char fByteCountByteSet;
     unsigned char OutBitsFree;
-    unsigned short NodeAxon[4096];
-    unsigned short NodeNext[4096];
-    unsigned char NodePix[4096];
+    /* String table, indexed directly by prefix code * ClearCode + pixel (a perfect hash, as there are at most
+       16 pixel values), giving the code of the extended string or 0 if none */
+    unsigned short *NodeChild;
     unsigned char colourCode[10];
     unsigned char colourPaletteIndex[10];
     int colourCount;
+    unsigned char colourMap[256]; /* Colour code to palette index */
 } statestruct;
 
 /* Transform a Pixel to a lzw colourmap index and move to next pixel.
- * All colour values are listed in colourCode with corresponding palette index
+ * All colour values are mapped to their palette index in colourMap
  */
 static unsigned char NextPaletteIndex(statestruct *pState)
 {
-    unsigned char pixelColour;
-    int colourIndex;
-    pixelColour = *(pState->pIn);
-    (pState->pIn)++;
     (pState->InLen)--;
-    for (colourIndex = 0; colourIndex < pState->colourCount; colourIndex++) {
-        if (pixelColour == pState->colourCode[colourIndex])
-            return pState->colourPaletteIndex[colourIndex];
-
-    }
-    return 0; /* Not reached */
+    return pState->colourMap[*(pState->pIn)++];
 }
 
 
@@ -131,22 +121,11 @@ static char AddCodeToBuffer(statestruct *pState, unsigned short CodeIn, unsigned
 }
 
 static void FlushStringTable(statestruct *pState) {
-    unsigned short Pos;
-    for (Pos = 0; Pos < pState->ClearCode; Pos++) {
-        (pState->NodeAxon)[Pos] = 0;
-    }
+    memset(pState->NodeChild, 0, sizeof(unsigned short) * pState->FreeCode * pState->ClearCode);
 }
 
 static unsigned short FindPixelOutlet(statestruct *pState, unsigned short HeadNode, unsigned char Byte) {
-    unsigned short Outlet;
-
-    Outlet = (pState->NodeAxon)[HeadNode];
-    while (Outlet) {
-        if ((pState->NodePix)[Outlet] == Byte)
-            return Outlet;
-        Outlet = (pState->NodeNext)[Outlet];
-    }
-    return 0;
+    return (pState->NodeChild)[HeadNode * pState->ClearCode + Byte];
 }
 
 static char NextCode(statestruct *pState, unsigned char * pPixelValueCur, unsigned char CodeBits) {
@@ -170,26 +149,14 @@ static char NextCode(statestruct *pState, unsigned char * pPixelValueCur, unsign
     if (AddCodeToBuffer(pState, UpNode, CodeBits))
         return -1;
     /* ... and extend the string by appending 'PixelValueCur' */
-    /* Create a successor node for 'PixelValueCur' whose code is 'freecode' */
-    (pState->NodePix)[pState->FreeCode] = *pPixelValueCur;
-    (pState->NodeAxon)[pState->FreeCode] = (pState->NodeNext)[pState->FreeCode] = 0;
-    /* ...and link it to the end of the chain emanating from fg_axon[UpNode]. */
-    DownNode = (pState->NodeAxon)[UpNode];
-    if (!DownNode) {
-        (pState->NodeAxon)[UpNode] = pState->FreeCode;
-    } else {
-        while ((pState->NodeNext)[DownNode]) {
-            DownNode = (pState->NodeNext)[DownNode];
-        }
-        (pState->NodeNext)[DownNode] = pState->FreeCode;
-    }
+    /* Add the string 'UpNode' + 'PixelValueCur' to the table with code 'freecode' */
+    (pState->NodeChild)[UpNode * pState->ClearCode + *pPixelValueCur] = pState->FreeCode;
     return 1;
 }
 
 static int gif_lzw(statestruct *pState, int paletteBitSize) {
     unsigned char PixelValueCur;
     unsigned char CodeBits;
-    unsigned short Pos;
 
     // > Get first data byte
     if (pState->InLen == 0)
@@ -205,6 +172,8 @@ static int gif_lzw(statestruct *pState, int paletteBitSize) {
     /* initial size of compression codes */
     CodeBits = paletteBitSize+1;
     pState->ClearCode = (1 << paletteBitSize);
+    pState->FreeCode = 4096; /* Flush whole table */
+    FlushStringTable(pState);
     pState->FreeCode = pState->ClearCode+2;
     pState->OutBitsFree = 8;
     pState->OutPosCur = -1;
@@ -213,11 +182,6 @@ static int gif_lzw(statestruct *pState, int paletteBitSize) {
     if (BufferNextByte(pState))
         return 0;
 
-    for (Pos = 0; Pos < pState->ClearCode; Pos++)
-        (pState->NodePix)[Pos] = (unsigned char) Pos;
-
-    FlushStringTable(pState);
-
     /* Write what the GIF specification calls the "code size". */
     (pState->pOut)[pState->OutPosCur] = paletteBitSize;
     /* Reserve first bytecount byte */
@@ -275,7 +239,8 @@ static int gif_lzw(statestruct *pState, int paletteBitSize) {
  */
 INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
     unsigned char outbuf[10];
-    FILE *gif_file;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     unsigned short usTemp;
     int byte_out;
     int colourCount;
@@ -297,18 +262,11 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     int fFound;
 
     unsigned char pixelColour;
+    unsigned char colourSeen[256] = {0};
 
     /* Allow for overhead of 4 == code size + byte count + overflow byte + zero terminator */
     unsigned int lzoutbufSize = symbol->bitmap_height * symbol->bitmap_width + 4;
-#ifdef _MSC_VER
-    char * lzwoutbuf;
-#endif
-
-#ifndef _MSC_VER
-    char lzwoutbuf[lzoutbufSize];
-#else
-    lzwoutbuf = (char *) _alloca(lzoutbufSize);
-#endif /* _MSC_VER */
+    unsigned char *lzwoutbuf;
 
     /*
      * Build a table of the used palette items.
@@ -339,6 +297,8 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
      *  paletteItem: ['0']=0 (white), ['1']=1 (blue), ['W']=0 (white),
      *               ['K']=2 (black)
      *  Thus, there are 4 colour codes and 3 palette entries.
+     * state.colourMap: palette index for each colour code, for quick lookup
+     *  when encoding
 
      */
     colourCount = 0;
@@ -346,32 +306,25 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     /* loop over all pixels */
     for ( pixelIndex = 0; pixelIndex < (symbol->bitmap_height * symbol->bitmap_width); pixelIndex++)
     {
-        fFound = 0;
         /* get pixel colour code */
         pixelColour = pixelbuf[pixelIndex];
-        /* look, if colour code is already in colour list */
-        for (colourIndex = 0; colourIndex < colourCount; colourIndex++) {
-            if ((State.colourCode)[colourIndex] == pixelColour) {
-                fFound = 1;
-                break;
-            }
-        }
         /* If colour is already present, go to next colour code */
-        if (fFound)
+        if (colourSeen[pixelColour])
             continue;
+        colourSeen[pixelColour] = 1;
 
         /* Colour code not present - add colour code */
         /* Get RGB value */
         switch (pixelColour) {
             case '0': /* standard background */
-                RGBCur[0] = (unsigned char) (16 * ctoi(symbol->bgcolour[0])) + ctoi(symbol->bgcolour[1]);
-                RGBCur[1] = (unsigned char) (16 * ctoi(symbol->bgcolour[2])) + ctoi(symbol->bgcolour[3]);
-                RGBCur[2] = (unsigned char) (16 * ctoi(symbol->bgcolour[4])) + ctoi(symbol->bgcolour[5]);
+                RGBCur[0] = (unsigned char) OUT_RED(symbol->bgcolour_rgba);
+                RGBCur[1] = (unsigned char) OUT_GREEN(symbol->bgcolour_rgba);
+                RGBCur[2] = (unsigned char) OUT_BLUE(symbol->bgcolour_rgba);
                 break;
             case '1': /* standard foreground */
-                RGBCur[0] = (unsigned char) (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
-                RGBCur[1] = (unsigned char) (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
-                RGBCur[2] = (unsigned char) (16 * ctoi(symbol->fgcolour[4])) + ctoi(symbol->fgcolour[5]);
+                RGBCur[0] = (unsigned char) OUT_RED(symbol->fgcolour_rgba);
+                RGBCur[1] = (unsigned char) OUT_GREEN(symbol->fgcolour_rgba);
+                RGBCur[2] = (unsigned char) OUT_BLUE(symbol->fgcolour_rgba);
                 break;
             case 'W': /* white */
                 RGBCur[0] = 255; RGBCur[1] = 255; RGBCur[2] = 255;
@@ -428,6 +381,7 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         /* Add palette index to current colour code */
         (State.colourCode)[colourCount] = pixelColour;
         (State.colourPaletteIndex)[colourCount] = paletteIndex;
+        (State.colourMap)[pixelColour] = paletteIndex;
         colourCount++;
     }
     State.colourCount = colourCount;
@@ -436,17 +390,13 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     /* Note: does not allow both transparent foreground and background -
      * background takes prioroty */
     transparent_index = -1;
-    if (strlen(symbol->fgcolour) > 6) {
-        if ((symbol->fgcolour[6] == '0') && (symbol->fgcolour[7] == '0')) {
-            // Transparent foreground
-            transparent_index = fgindex;
-        }
+    if (OUT_ALPHA(symbol->fgcolour_rgba) == 0) {
+        // Transparent foreground
+        transparent_index = fgindex;
     }
-    if (strlen(symbol->bgcolour) > 6) {
-        if ((symbol->bgcolour[6] == '0') && (symbol->bgcolour[7] == '0')) {
-            // Transparent background
-            transparent_index = bgindex;
-        }
+    if (OUT_ALPHA(symbol->bgcolour_rgba) == 0) {
+        // Transparent background
+        transparent_index = bgindex;
     }
 
     /* find palette bit size from palette size*/
@@ -465,20 +415,20 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     /* palette size 2 ^ bit size */
     paletteSize = 1<<paletteBitSize;
 
+    /* Kept with the symbol so that printing again doesn't allocate (see `raster_output_buffer()`) */
+    lzwoutbuf = raster_output_buffer(symbol, 0, lzoutbufSize);
+    /* String table, allowing for `gif_lzw()` using a minimum bit size of 2 */
+    State.NodeChild = (unsigned short *) raster_output_buffer(symbol, 1,
+                                        sizeof(unsigned short) * 4096 * (paletteSize < 4 ? 4 : paletteSize));
+    if (!lzwoutbuf || !State.NodeChild) {
+        strcpy(symbol->errtxt, "613: Insufficient memory for LZW buffer");
+        return ZINT_ERROR_MEMORY;
+    }
+
     /* Open output file in binary mode */
-    if ((symbol->output_options & BARCODE_STDOUT) != 0) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "610: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-#endif
-        gif_file = stdout;
-    } else {
-        if (!(gif_file = fopen(symbol->outfile, "wb"))) {
-            strcpy(symbol->errtxt, "611: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!fm_open(fmp, symbol, "wb")) {
+        strcpy(symbol->errtxt, "611: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
     /* GIF signature (6) */
@@ -486,7 +436,7 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     if (transparent_index != -1)
         outbuf[4] = '9';
 
-    fwrite(outbuf, 6, 1, gif_file);
+    fm_write(outbuf, 6, 1, fmp);
     /* Screen Descriptor (7) */
     /* Screen Width */
     usTemp = (unsigned short) symbol->bitmap_width;
@@ -521,12 +471,12 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     outbuf[5] = backgroundColourIndex;
     /* Byte 7 must be 0x00  */
     outbuf[6] = 0x00;
-    fwrite(outbuf, 7, 1, gif_file);
+    fm_write(outbuf, 7, 1, fmp);
     /* Global Color Table (paletteSize*3) */
-    fwrite(paletteRGB, 3*paletteCount, 1, gif_file);
+    fm_write(paletteRGB, 3*paletteCount, 1, fmp);
     /* add unused palette items to fill palette size */
     for (paletteIndex = paletteCount; paletteIndex < paletteSize; paletteIndex++) {
-        fwrite(RGBUnused, 3, 1, gif_file);
+        fm_write(RGBUnused, 3, 1, fmp);
     }
 
     /* Graphic control extension (8) */
@@ -554,7 +504,7 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         outbuf[6] = (unsigned char) transparent_index;
         /* Block Terminator */
         outbuf[7] = 0;
-        fwrite(outbuf, 8, 1, gif_file);
+        fm_write(outbuf, 8, 1, fmp);
     }
     /* Image Descriptor */
     /* Image separator character = ',' */
@@ -577,25 +527,28 @@ INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
      * There is no local color table if its most significant bit is reset.
      */
     outbuf[9] = 0x00;
-    fwrite(outbuf, 10, 1, gif_file);
+    fm_write(outbuf, 10, 1, fmp);
 
     /* prepare state array */
     State.pIn = pixelbuf;
     State.InLen = symbol->bitmap_height * symbol->bitmap_width;
-    State.pOut = (unsigned char *) lzwoutbuf;
+    State.pOut = lzwoutbuf;
     State.OutLength = lzoutbufSize;
 
     /* call lzw encoding */
     byte_out = gif_lzw(&State, paletteBitSize);
     if (byte_out <= 0) {
-        fclose(gif_file);
+        (void) fm_close(fmp, symbol);
         return ZINT_ERROR_MEMORY;
     }
-    fwrite(lzwoutbuf, byte_out, 1, gif_file);
+    fm_write(lzwoutbuf, byte_out, 1, fmp);
 
     /* GIF terminator */
-    fputc('\x3b', gif_file);
-    fclose(gif_file);
+    fm_putc('\x3b', fmp);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "612: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
+    }
 
     return 0;
 }
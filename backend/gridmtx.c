@@ -45,64 +45,8 @@
 
 /* define_mode() stuff */
 
-/* Bits multiplied by this for costs, so as to be whole integer divisible by 2 and 3 */
-#define GM_MULT 6
-
 static const char numeral_nondigits[] = " +-.,"; /* Non-digit numeral set, excluding EOL (carriage return/linefeed) */
 
-/* Whether in numeral or not. If in numeral, *p_numeral_end is set to position after numeral,
- * and *p_numeral_cost is set to per-numeral cost */
-static int in_numeral(const unsigned int gbdata[], const int length, const int in_posn,
-            unsigned int *p_numeral_end, unsigned int *p_numeral_cost) {
-    int i, digit_cnt, nondigit, nondigit_posn;
-
-    if (in_posn < (int) *p_numeral_end) {
-        return 1;
-    }
-
-    /* Attempt to calculate the average 'cost' of using numeric mode in number of bits (times GM_MULT) */
-    /* Also ensures that numeric mode is not selected when it cannot be used: for example in
-       a string which has "2.2.0" (cannot have more than one non-numeric character for each
-       block of three numeric characters) */
-    for (i = in_posn, digit_cnt = 0, nondigit = 0, nondigit_posn = 0; i < length && i < in_posn + 4 && digit_cnt < 3; i++) {
-        if (gbdata[i] >= '0' && gbdata[i] <= '9') {
-            digit_cnt++;
-        } else if (strchr(numeral_nondigits, gbdata[i])) {
-            if (nondigit) {
-                break;
-            }
-            nondigit = 1;
-            nondigit_posn = i;
-        } else if (i < length - 1 && gbdata[i] == 13 && gbdata[i + 1] == 10) {
-            if (nondigit) {
-                break;
-            }
-            i++;
-            nondigit = 2;
-            nondigit_posn = i;
-        } else {
-            break;
-        }
-    }
-    if (digit_cnt == 0) { /* Must have at least one digit */
-        *p_numeral_end = 0;
-        return 0;
-    }
-    if (nondigit && nondigit_posn == i - 1) { /* Non-digit can't be at end */
-        nondigit = 0;
-    }
-    *p_numeral_end = in_posn + digit_cnt + nondigit;
-    /* Calculate per-numeral cost where 120 == (10 + 10) * GM_MULT, 60 == 10 * GM_MULT */
-    if (digit_cnt == 3) {
-        *p_numeral_cost = nondigit == 2 ? 24 /* (120 / 5) */ : nondigit == 1 ? 30 /* (120 / 4) */ : 20 /* (60 / 3) */;
-    } else if (digit_cnt == 2) {
-        *p_numeral_cost = nondigit == 2 ? 30 /* (120 / 4) */ : nondigit == 1 ? 40 /* (120 / 3) */ : 30 /* (60 / 2) */;
-    } else {
-        *p_numeral_cost = nondigit == 2 ? 40 /* (120 / 3) */ : nondigit == 1 ? 60 /* (120 / 2) */ : 60 /* (60 / 1) */;
-    }
-    return 1;
-}
-
 /* Encoding modes */
 #define GM_CHINESE  'H'
 #define GM_NUMBER   'N'
@@ -122,184 +66,226 @@ static int in_numeral(const unsigned int gbdata[], const int length, const int i
 
 #define GM_NUM_MODES 6
 
-/* Calculate optimized encoding modes. Adapted from Project Nayuki */
-/* Copyright (c) Project Nayuki. (MIT License) See qr.c for detailed notice */
-static void define_mode(char *mode, const unsigned int gbdata[], const int length, const int debug) {
+#define GM_NC  6 /* Numeral ended by a group of less than 3 digits, so can only be switched from */
+
+#define GM_NUM_STATES 7
+
+#define GM_MAX_STEP 5 /* Most characters encoded in one step (numeral group of 3 digits plus EOL) */
+
+#define GM_INF 0x3FFFFFFF
+
+/* Calculate optimized encoding modes, by finding for each position the cheapest way of arriving there in each mode,
+ * each step encoding a character or, in Chinese mode, a pair of digits or EOL, or in Numeral mode, a group of up to
+ * 3 digits with at most one non-digit (only the last group of a Numeral segment can have less than 3 digits). Costs
+ * are exact numbers of bits, apart from Byte mode, where the blocks of at most 512 bytes are counted along the
+ * cheapest path only */
+static int define_mode(struct zint_symbol *symbol, char *mode, const unsigned int gbdata[], const int length,
+            const int debug) {
     /* Must be in same order as GM_H etc */
     static const char mode_types[] = { GM_CHINESE, GM_NUMBER, GM_LOWER, GM_UPPER, GM_MIXED, GM_BYTE, '\0' };
 
     /* Initial mode costs */
-    static unsigned int head_costs[GM_NUM_MODES] = {
-    /*  H            N (+pad prefix)    L            U            M            B (+byte count) */
-        4 * GM_MULT, (4 + 2) * GM_MULT, 4 * GM_MULT, 4 * GM_MULT, 4 * GM_MULT, (4 + 9) * GM_MULT
+    static const unsigned int head_costs[GM_NUM_MODES] = {
+    /*  H  N (+pad prefix)  L  U  M  B (+byte count) */
+        4, 4 + 2,           4, 4, 4, 4 + 9
     };
 
     /* Cost of switching modes from k to j - see AIMD014 Rev. 1.63 Table 9 – Type conversion codes */
     static const unsigned int switch_costs[GM_NUM_MODES][GM_NUM_MODES] = {
-        /*      H             N                   L             U             M             B  */
-        /*H*/ {            0, (13 + 2) * GM_MULT, 13 * GM_MULT, 13 * GM_MULT, 13 * GM_MULT, (13 + 9) * GM_MULT },
-        /*N*/ { 10 * GM_MULT,                  0, 10 * GM_MULT, 10 * GM_MULT, 10 * GM_MULT, (10 + 9) * GM_MULT },
-        /*L*/ {  5 * GM_MULT,  (5 + 2) * GM_MULT,            0,  5 * GM_MULT,  7 * GM_MULT,  (7 + 9) * GM_MULT },
-        /*U*/ {  5 * GM_MULT,  (5 + 2) * GM_MULT,  5 * GM_MULT,            0,  7 * GM_MULT,  (7 + 9) * GM_MULT },
-        /*M*/ { 10 * GM_MULT, (10 + 2) * GM_MULT, 10 * GM_MULT, 10 * GM_MULT,            0, (10 + 9) * GM_MULT },
-        /*B*/ {  4 * GM_MULT,  (4 + 2) * GM_MULT,  4 * GM_MULT,  4 * GM_MULT,  4 * GM_MULT,                  0 },
+        /*      H   N        L   U   M   B  */
+        /*H*/ {  0, 13 + 2, 13, 13, 13, 13 + 9 },
+        /*N*/ { 10,      0, 10, 10, 10, 10 + 9 },
+        /*L*/ {  5,  5 + 2,  0,  5,  7,  7 + 9 },
+        /*U*/ {  5,  5 + 2,  5,  0,  7,  7 + 9 },
+        /*M*/ { 10, 10 + 2, 10, 10,  0, 10 + 9 },
+        /*B*/ {  4,  4 + 2,  4,  4,  4,      0 },
     };
 
     /* Final end-of-data cost - see AIMD014 Rev. 1.63 Table 9 – Type conversion codes */
     static const unsigned int eod_costs[GM_NUM_MODES] = {
-    /*  H             N             L            U            M             B  */
-        13 * GM_MULT, 10 * GM_MULT, 5 * GM_MULT, 5 * GM_MULT, 10 * GM_MULT, 4 * GM_MULT
+    /*  H   N   L  U  M   B  */
+        13, 10, 5, 5, 10, 4
     };
 
-    unsigned int numeral_end = 0, numeral_cost = 0, byte_count = 0; /* State */
-    int double_byte, space, numeric, lower, upper, control, double_digit, eol;
+    int i, j, k, m, len;
+    int cur_state = GM_NC;
+    unsigned int best;
+    unsigned int in_costs[GM_MAX_STEP + 1][GM_NUM_STATES]; /* Costs arriving in state, indexed by position modulo */
+    unsigned int in_bytes[GM_MAX_STEP + 1]; /* Bytes in current Byte block arriving in GM_B, as `in_costs` */
+    unsigned int costs[GM_NUM_MODES]; /* Costs at current position after any switch */
+    /* Characters encoded by step arriving in state */
+    z_work_array2(symbol, unsigned char, step_lens, length + 1, GM_NUM_STATES);
+    /* State switched from (or same mode if none) */
+    z_work_array2(symbol, unsigned char, switch_from, length + 1, GM_NUM_MODES);
+
+    if (z_work_failed(step_lens) || z_work_failed(switch_from)) {
+        return z_work_error(symbol);
+    }
 
-    int i, j, k, cm_i;
-    unsigned int min_cost;
-    char cur_mode;
-    unsigned int prev_costs[GM_NUM_MODES];
-    unsigned int cur_costs[GM_NUM_MODES];
-#ifndef _MSC_VER
-    char char_modes[length * GM_NUM_MODES];
-#else
-    char *char_modes = (char *) _alloca(length * GM_NUM_MODES);
-#endif
+    for (i = 0; i <= GM_MAX_STEP; i++) {
+        for (m = 0; m < GM_NUM_STATES; m++) {
+            in_costs[i][m] = GM_INF;
+        }
+    }
 
-    /* char_modes[i * GM_NUM_MODES + j] represents the mode to encode the code point at index i such that the final
-     * segment ends in mode_types[j] and the total number of bits is minimized over all possible choices */
-    memset(char_modes, 0, length * GM_NUM_MODES);
-
-    /* At the beginning of each iteration of the loop below, prev_costs[j] is the minimum number of 1/6 (1/XX_MULT)
-     * bits needed to encode the entire string prefix of length i, and end in mode_types[j] */
-    memcpy(prev_costs, head_costs, GM_NUM_MODES * sizeof(unsigned int));
-
-    /* Calculate costs using dynamic programming */
-    for (i = 0, cm_i = 0; i < length; i++, cm_i += GM_NUM_MODES) {
-        memset(cur_costs, 0, GM_NUM_MODES * sizeof(unsigned int));
-
-        space = numeric = lower = upper = control = double_digit = eol = 0;
-
-        double_byte = gbdata[i] > 0xFF;
-        if (!double_byte) {
-            space = gbdata[i] == ' ';
-            if (!space) {
-                numeric = gbdata[i] >= '0' && gbdata[i] <= '9';
-                if (!numeric) {
-                    lower = gbdata[i] >= 'a' && gbdata[i] <= 'z';
-                    if (!lower) {
-                        upper = gbdata[i] >= 'A' && gbdata[i] <= 'Z';
-                        if (!upper) {
-                            control = gbdata[i] < 0x7F; /* Exclude DEL */
-                            if (control && i + 1 < length) {
-                                eol = gbdata[i] == 13 && gbdata[i + 1] == 10;
-                            }
-                        }
+    for (i = 0; i <= length; i++) {
+        unsigned int *const in = in_costs[i % (GM_MAX_STEP + 1)];
+        unsigned int byte_count = 0;
+
+        /* Start new segment to switch modes. As the switch costs are such that switching twice always costs more
+         * than switching directly, one pass suffices */
+        if (i == 0) {
+            memcpy(costs, head_costs, sizeof(costs));
+        } else {
+            for (m = 0; m < GM_NUM_MODES; m++) { /* To mode */
+                costs[m] = in[m];
+                switch_from[i][m] = (unsigned char) m;
+                for (k = 0; k < GM_NUM_STATES; k++) { /* From state */
+                    const int from_mode = k == GM_NC ? GM_N : k;
+                    if (from_mode != m && in[k] + switch_costs[from_mode][m] < costs[m]) {
+                        costs[m] = in[k] + switch_costs[from_mode][m];
+                        switch_from[i][m] = (unsigned char) k;
                     }
-                } else if (i + 1 < length) {
-                    double_digit = gbdata[i + 1] >= '0' && gbdata[i + 1] <= '9';
                 }
             }
+            if (switch_from[i][GM_B] == GM_B) {
+                byte_count = in_bytes[i % (GM_MAX_STEP + 1)];
+            }
         }
 
-        /* Hanzi mode can encode anything */
-        cur_costs[GM_H] = prev_costs[GM_H] + (double_digit || eol ? 39 : 78); /* (6.5 : 13) * GM_MULT */
-        char_modes[cm_i + GM_H] = GM_CHINESE;
-
-        /* Byte mode can encode anything */
-        if (byte_count == 512 || (double_byte && byte_count == 511)) {
-            cur_costs[GM_B] = head_costs[GM_B];
-            if (double_byte && byte_count == 511) {
-                cur_costs[GM_B] += 48; /* 8 * GM_MULT */
-                double_byte = 0; /* Splitting double-byte so mark as single */
+        if (i == length) {
+            /* Find optimal ending state, which may be a Numeral ended by a short group */
+            best = in[GM_NC] + eod_costs[GM_N];
+            cur_state = GM_NC;
+            for (m = 0; m < GM_NUM_MODES; m++) {
+                if (costs[m] + eod_costs[m] < best) {
+                    best = costs[m] + eod_costs[m];
+                    cur_state = i ? switch_from[i][m] : m;
+                }
             }
-            byte_count = 0;
+            break;
         }
-        cur_costs[GM_B] += prev_costs[GM_B] + (double_byte ? 96 : 48); /* (16 : 8) * GM_MULT */
-        char_modes[cm_i + GM_B] = GM_BYTE;
-        byte_count += double_byte ? 2 : 1;
 
-        if (in_numeral(gbdata, length, i, &numeral_end, &numeral_cost)) {
-            cur_costs[GM_N] = prev_costs[GM_N] + numeral_cost;
-            char_modes[cm_i + GM_N] = GM_NUMBER;
+        for (m = 0; m < GM_NUM_STATES; m++) {
+            in[m] = GM_INF; /* Clear for reuse by position `i + GM_MAX_STEP + 1` */
         }
 
-        if (control) {
-            cur_costs[GM_L] = prev_costs[GM_L] + 78; /* (7 + 6) * GM_MULT */
-            char_modes[cm_i + GM_L] = GM_LOWER;
-            cur_costs[GM_U] = prev_costs[GM_U] + 78; /* (7 + 6) * GM_MULT */
-            char_modes[cm_i + GM_U] = GM_UPPER;
-            cur_costs[GM_M] = prev_costs[GM_M] + 96; /* (10 + 6) * GM_MULT */
-            char_modes[cm_i + GM_M] = GM_MIXED;
-        } else {
-            if (lower || space) {
-                cur_costs[GM_L] = prev_costs[GM_L] + 30; /* 5 * GM_MULT */
-                char_modes[cm_i + GM_L] = GM_LOWER;
+        {
+            const unsigned int c = gbdata[i];
+            const int space = c == ' ';
+            const int digit = c >= '0' && c <= '9';
+            const int lower = c >= 'a' && c <= 'z';
+            const int upper = c >= 'A' && c <= 'Z';
+            const int control = c < 0x7F && !space && !digit && !lower && !upper; /* Exclude DEL */
+            const int count = c > 0xFF ? 2 : 1;
+            unsigned int *const in1 = in_costs[(i + 1) % (GM_MAX_STEP + 1)];
+            unsigned int cost;
+
+#define GM_STEP(s, n, b) do { \
+                unsigned int *const in_n = in_costs[(i + (n)) % (GM_MAX_STEP + 1)]; \
+                if ((b) < in_n[s]) { \
+                    in_n[s] = (b); \
+                    step_lens[i + (n)][s] = (unsigned char) (n); \
+                } \
+            } while (0)
+
+            /* Hanzi mode can encode anything, and 2 digits or EOL (CR/LF) as one */
+            GM_STEP(GM_H, 1, costs[GM_H] + 13);
+            if (i + 1 < length && ((digit && gbdata[i + 1] >= '0' && gbdata[i + 1] <= '9')
+                                    || (c == 13 && gbdata[i + 1] == 10))) {
+                GM_STEP(GM_H, 2, costs[GM_H] + 13);
             }
-            if (upper || space) {
-                cur_costs[GM_U] = prev_costs[GM_U] + 30; /* 5 * GM_MULT */
-                char_modes[cm_i + GM_U] = GM_UPPER;
+
+            /* Byte mode can encode anything, starting a new block of up to 512 bytes as needed */
+            cost = costs[GM_B] + 8 * count;
+            byte_count += count;
+            if (byte_count > 512) { /* Any double-byte split across the blocks */
+                cost += 4 + 9;
+                byte_count -= 512;
             }
-            if (numeric || lower || upper || space) {
-                cur_costs[GM_M] = prev_costs[GM_M] + 36; /* 6 * GM_MULT */
-                char_modes[cm_i + GM_M] = GM_MIXED;
+            if (cost < in1[GM_B] || (cost == in1[GM_B] && byte_count < in_bytes[(i + 1) % (GM_MAX_STEP + 1)])) {
+                in1[GM_B] = cost;
+                step_lens[i + 1][GM_B] = 1;
+                in_bytes[(i + 1) % (GM_MAX_STEP + 1)] = byte_count;
             }
-        }
 
-        if (i == length - 1) { /* Add end of data costs if last character */
-            for (j = 0; j < GM_NUM_MODES; j++) {
-                if (char_modes[cm_i + j]) {
-                    cur_costs[j] += eod_costs[j];
+            if (control) {
+                GM_STEP(GM_L, 1, costs[GM_L] + 7 + 6);
+                GM_STEP(GM_U, 1, costs[GM_U] + 7 + 6);
+                GM_STEP(GM_M, 1, costs[GM_M] + 10 + 6);
+            } else {
+                if (lower || space) {
+                    GM_STEP(GM_L, 1, costs[GM_L] + 5);
+                }
+                if (upper || space) {
+                    GM_STEP(GM_U, 1, costs[GM_U] + 5);
+                }
+                if (digit || lower || upper || space) {
+                    GM_STEP(GM_M, 1, costs[GM_M] + 6);
                 }
             }
-        }
 
-        /* Start new segment at the end to switch modes */
-        for (j = 0; j < GM_NUM_MODES; j++) { /* To mode */
-            for (k = 0; k < GM_NUM_MODES; k++) { /* From mode */
-                if (j != k && char_modes[cm_i + k]) {
-                    unsigned int new_cost = cur_costs[k] + switch_costs[k][j];
-                    if (!char_modes[cm_i + j] || new_cost < cur_costs[j]) {
-                        cur_costs[j] = new_cost;
-                        char_modes[cm_i + j] = mode_types[k];
+            /* Numeral groups starting here, ending with a digit, with the non-digit (if any) adding 10 bits */
+            if (digit || c == 13 || (c && c < 0x7F && strchr(numeral_nondigits, c))) {
+                int digit_cnt = 0, nondigit = 0;
+                for (j = i; j < length; j++) {
+                    if (gbdata[j] >= '0' && gbdata[j] <= '9') {
+                        digit_cnt++;
+                        cost = costs[GM_N] + (nondigit ? 20 : 10);
+                        if (digit_cnt == 3) {
+                            GM_STEP(GM_N, j + 1 - i, cost);
+                            break;
+                        }
+                        GM_STEP(GM_NC, j + 1 - i, cost);
+                    } else if (!nondigit && gbdata[j] < 0x7F && gbdata[j] && strchr(numeral_nondigits, gbdata[j])) {
+                        nondigit = 1;
+                    } else if (!nondigit && j + 1 < length && gbdata[j] == 13 && gbdata[j + 1] == 10) {
+                        nondigit = 1;
+                        j++;
+                    } else {
+                        break;
                     }
                 }
             }
-        }
-
-        memcpy(prev_costs, cur_costs, GM_NUM_MODES * sizeof(unsigned int));
-    }
-
-    /* Find optimal ending mode */
-    min_cost = prev_costs[0];
-    cur_mode = mode_types[0];
-    for (i = 1; i < GM_NUM_MODES; i++) {
-        if (prev_costs[i] < min_cost) {
-            min_cost = prev_costs[i];
-            cur_mode = mode_types[i];
+#undef GM_STEP
         }
     }
 
     /* Get optimal mode for each code point by tracing backwards */
-    for (i = length - 1, cm_i = i * GM_NUM_MODES; i >= 0; i--, cm_i -= GM_NUM_MODES) {
-        j = strchr(mode_types, cur_mode) - mode_types;
-        cur_mode = char_modes[cm_i + j];
-        mode[i] = cur_mode;
+    for (i = length; i > 0; i -= len) {
+        const int cur_mode = cur_state == GM_NC ? GM_N : cur_state;
+        len = step_lens[i][cur_state];
+        for (j = i - len; j < i; j++) {
+            mode[j] = mode_types[cur_mode];
+        }
+        if (i - len > 0) {
+            cur_state = switch_from[i - len][cur_mode];
+        }
     }
 
     if (debug & ZINT_DEBUG_PRINT) {
         printf("  Mode: %.*s\n", length, mode);
     }
+
+    return 0;
 }
 
 /* Add the length indicator for byte encoded blocks */
-static void add_byte_count(char binary[], const int byte_count_posn, const int byte_count) {
+static void add_byte_count(struct zint_bits *bits, const int byte_count_posn, const int byte_count) {
     /* AIMD014 6.3.7: "Let L be the number of bytes of input data to be encoded in the 8-bit binary data set.
      * First output (L-1) as a 9-bit binary prefix to record the number of bytes..." */
-    bin_append_posn(byte_count - 1, 9, binary, byte_count_posn);
+    bits_put(bits, byte_count_posn, byte_count - 1, 9);
+}
+
+/* Add the numeric block padding value, i.e. the number of pad digits (2, 1 or 0) in the last triplet */
+static void add_number_pad(struct zint_bits *bits, const int number_pad_posn, const int p) {
+    if (p) {
+        bits_put(bits, number_pad_posn, 3 - p, 2);
+    }
 }
 
 /* Add a control character to the data stream */
-static int add_shift_char(char binary[], int bp, int shifty, int debug) {
+static void add_shift_char(struct zint_bits *bits, int shifty, int debug) {
     int i;
     int glyph = 0;
 
@@ -318,13 +304,11 @@ static int add_shift_char(char binary[], int bp, int shifty, int debug) {
         printf("SHIFT [%d] ", glyph);
     }
 
-    bp = bin_append_posn(glyph, 6, binary, bp);
-
-    return bp;
+    bits_append(bits, glyph, 6);
 }
 
-static int gm_encode(unsigned int gbdata[], const int length, char binary[], const int reader, const int eci,
-            int *bin_len, int debug) {
+static int gm_encode(struct zint_symbol *symbol, unsigned int gbdata[], const int length, unsigned char binary[],
+            const int reader, const int eci, int *bin_len, int debug) {
     /* Create a binary stream representation of the input data.
        7 sets are defined - Chinese characters, Numerals, Lower case letters, Upper case letters,
        Mixed numerals and latters, Control characters and 8-bit binary data */
@@ -337,39 +321,40 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
     int number_pad_posn, byte_count_posn = 0;
     int byte_count = 0;
     int shift;
-    int bp;
-#ifndef _MSC_VER
-    char mode[length];
-#else
-    char *mode = (char *) _alloca(length);
-#endif
+    struct zint_bits bits;
+    z_work_array(symbol, char, mode, length);
+
+    if (z_work_failed(mode)) {
+        return z_work_error(symbol);
+    }
 
-    *binary = '\0';
-    bp = 0;
+    bits_init(&bits, binary, 0);
 
     sp = 0;
     current_mode = 0;
     number_pad_posn = 0;
 
     if (reader) {
-        bp = bin_append_posn(10, 4, binary, bp); /* FNC3 - Reader Initialisation */
+        bits_append(&bits, 10, 4); /* FNC3 - Reader Initialisation */
     }
 
     if (eci != 0) {
         /* ECI assignment according to Table 8 */
-        bp = bin_append_posn(12, 4, binary, bp); /* ECI */
+        bits_append(&bits, 12, 4); /* ECI */
         if (eci <= 1023) {
-            bp = bin_append_posn(eci, 11, binary, bp);
+            bits_append(&bits, eci, 11);
         } else if (eci <= 32767) {
-            bp = bin_append_posn(2, 2, binary, bp);
-            bp = bin_append_posn(eci, 15, binary, bp);
+            bits_append(&bits, 2, 2);
+            bits_append(&bits, eci, 15);
         } else {
-            bp = bin_append_posn(3, 2, binary, bp);
-            bp = bin_append_posn(eci, 20, binary, bp);
+            bits_append(&bits, 3, 2);
+            bits_append(&bits, eci, 20);
         }
     }
 
-    define_mode(mode, gbdata, length, debug);
+    if (define_mode(symbol, mode, gbdata, length, debug)) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     do {
         int next_mode = mode[sp];
@@ -378,104 +363,94 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
             switch (current_mode) {
                 case 0:
                     switch (next_mode) {
-                        case GM_CHINESE: bp = bin_append_posn(1, 4, binary, bp);
+                        case GM_CHINESE: bits_append(&bits, 1, 4);
                             break;
-                        case GM_NUMBER: bp = bin_append_posn(2, 4, binary, bp);
+                        case GM_NUMBER: bits_append(&bits, 2, 4);
                             break;
-                        case GM_LOWER: bp = bin_append_posn(3, 4, binary, bp);
+                        case GM_LOWER: bits_append(&bits, 3, 4);
                             break;
-                        case GM_UPPER: bp = bin_append_posn(4, 4, binary, bp);
+                        case GM_UPPER: bits_append(&bits, 4, 4);
                             break;
-                        case GM_MIXED: bp = bin_append_posn(5, 4, binary, bp);
+                        case GM_MIXED: bits_append(&bits, 5, 4);
                             break;
-                        case GM_BYTE: bp = bin_append_posn(6, 4, binary, bp);
+                        case GM_BYTE: bits_append(&bits, 6, 4);
                             break;
                     }
                     break;
                 case GM_CHINESE:
                     switch (next_mode) {
-                        case GM_NUMBER: bp = bin_append_posn(8161, 13, binary, bp);
+                        case GM_NUMBER: bits_append(&bits, 8161, 13);
                             break;
-                        case GM_LOWER: bp = bin_append_posn(8162, 13, binary, bp);
+                        case GM_LOWER: bits_append(&bits, 8162, 13);
                             break;
-                        case GM_UPPER: bp = bin_append_posn(8163, 13, binary, bp);
+                        case GM_UPPER: bits_append(&bits, 8163, 13);
                             break;
-                        case GM_MIXED: bp = bin_append_posn(8164, 13, binary, bp);
+                        case GM_MIXED: bits_append(&bits, 8164, 13);
                             break;
-                        case GM_BYTE: bp = bin_append_posn(8165, 13, binary, bp);
+                        case GM_BYTE: bits_append(&bits, 8165, 13);
                             break;
                     }
                     break;
                 case GM_NUMBER:
                     /* add numeric block padding value */
-                    switch (p) {
-                        case 1: binary[number_pad_posn] = '1';
-                            binary[number_pad_posn + 1] = '0';
-                            break; // 2 pad digits
-                        case 2: binary[number_pad_posn] = '0';
-                            binary[number_pad_posn + 1] = '1';
-                            break; // 1 pad digits
-                        case 3: binary[number_pad_posn] = '0';
-                            binary[number_pad_posn + 1] = '0';
-                            break; // 0 pad digits
-                    }
+                    add_number_pad(&bits, number_pad_posn, p);
                     switch (next_mode) {
-                        case GM_CHINESE: bp = bin_append_posn(1019, 10, binary, bp);
+                        case GM_CHINESE: bits_append(&bits, 1019, 10);
                             break;
-                        case GM_LOWER: bp = bin_append_posn(1020, 10, binary, bp);
+                        case GM_LOWER: bits_append(&bits, 1020, 10);
                             break;
-                        case GM_UPPER: bp = bin_append_posn(1021, 10, binary, bp);
+                        case GM_UPPER: bits_append(&bits, 1021, 10);
                             break;
-                        case GM_MIXED: bp = bin_append_posn(1022, 10, binary, bp);
+                        case GM_MIXED: bits_append(&bits, 1022, 10);
                             break;
-                        case GM_BYTE: bp = bin_append_posn(1023, 10, binary, bp);
+                        case GM_BYTE: bits_append(&bits, 1023, 10);
                             break;
                     }
                     break;
                 case GM_LOWER:
                 case GM_UPPER:
                     switch (next_mode) {
-                        case GM_CHINESE: bp = bin_append_posn(28, 5, binary, bp);
+                        case GM_CHINESE: bits_append(&bits, 28, 5);
                             break;
-                        case GM_NUMBER: bp = bin_append_posn(29, 5, binary, bp);
+                        case GM_NUMBER: bits_append(&bits, 29, 5);
                             break;
                         case GM_LOWER:
-                        case GM_UPPER: bp = bin_append_posn(30, 5, binary, bp);
+                        case GM_UPPER: bits_append(&bits, 30, 5);
                             break;
-                        case GM_MIXED: bp = bin_append_posn(124, 7, binary, bp);
+                        case GM_MIXED: bits_append(&bits, 124, 7);
                             break;
-                        case GM_BYTE: bp = bin_append_posn(126, 7, binary, bp);
+                        case GM_BYTE: bits_append(&bits, 126, 7);
                             break;
                     }
                     break;
                 case GM_MIXED:
                     switch (next_mode) {
-                        case GM_CHINESE: bp = bin_append_posn(1009, 10, binary, bp);
+                        case GM_CHINESE: bits_append(&bits, 1009, 10);
                             break;
-                        case GM_NUMBER: bp = bin_append_posn(1010, 10, binary, bp);
+                        case GM_NUMBER: bits_append(&bits, 1010, 10);
                             break;
-                        case GM_LOWER: bp = bin_append_posn(1011, 10, binary, bp);
+                        case GM_LOWER: bits_append(&bits, 1011, 10);
                             break;
-                        case GM_UPPER: bp = bin_append_posn(1012, 10, binary, bp);
+                        case GM_UPPER: bits_append(&bits, 1012, 10);
                             break;
-                        case GM_BYTE: bp = bin_append_posn(1015, 10, binary, bp);
+                        case GM_BYTE: bits_append(&bits, 1015, 10);
                             break;
                     }
                     break;
                 case GM_BYTE:
                     /* add byte block length indicator */
-                    add_byte_count(binary, byte_count_posn, byte_count);
+                    add_byte_count(&bits, byte_count_posn, byte_count);
                     byte_count = 0;
                     switch (next_mode) {
-                        case GM_CHINESE: bp = bin_append_posn(1, 4, binary, bp);
+                        case GM_CHINESE: bits_append(&bits, 1, 4);
                             break;
-                        case GM_NUMBER: bp = bin_append_posn(2, 4, binary, bp);
+                        case GM_NUMBER: bits_append(&bits, 2, 4);
                             break;
-                        case GM_LOWER: bp = bin_append_posn(3, 4, binary, bp);
+                        case GM_LOWER: bits_append(&bits, 3, 4);
                             break;
-                        case GM_UPPER: bp = bin_append_posn(4, 4, binary, bp);
+                        case GM_UPPER: bits_append(&bits, 4, 4);
                             break;
-                        case GM_MIXED: bp = bin_append_posn(5, 4, binary, bp);
+                        case GM_MIXED: bits_append(&bits, 5, 4);
                             break;
                     }
                     break;
@@ -516,7 +491,7 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
                     done = 1; /* GB 2312 always within above ranges */
                 }
                 if (!(done)) {
-                    if (sp != (length - 1)) {
+                    if (sp != (length - 1) && mode[sp + 1] == GM_CHINESE) {
                         if ((gbdata[sp] == 13) && (gbdata[sp + 1] == 10)) {
                             /* End of Line */
                             glyph = 7776;
@@ -526,7 +501,7 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
                     }
                 }
                 if (!(done)) {
-                    if (sp != (length - 1)) {
+                    if (sp != (length - 1) && mode[sp + 1] == GM_CHINESE) {
                         if (((gbdata[sp] >= '0') && (gbdata[sp] <= '9')) &&
                                 ((gbdata[sp + 1] >= '0') && (gbdata[sp + 1] <= '9'))) {
                             /* Two digits */
@@ -545,15 +520,15 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
                     printf("[%d] ", glyph);
                 }
 
-                bp = bin_append_posn(glyph, 13, binary, bp);
+                bits_append(&bits, glyph, 13);
                 sp++;
                 break;
 
             case GM_NUMBER:
                 if (last_mode != current_mode) {
                     /* Reserve a space for numeric digit padding value (2 bits) */
-                    number_pad_posn = bp;
-                    bp = bin_append_posn(0, 2, binary, bp);
+                    number_pad_posn = bits.posn;
+                    bits_append(&bits, 0, 2);
                 }
                 p = 0;
                 ppos = -1;
@@ -610,7 +585,7 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
                         printf("[%d] ", glyph);
                     }
 
-                    bp = bin_append_posn(glyph, 10, binary, bp);
+                    bits_append(&bits, glyph, 10);
                 }
 
                 glyph = (100 * (numbuf[0] - '0')) + (10 * (numbuf[1] - '0')) + (numbuf[2] - '0');
@@ -618,34 +593,34 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
                     printf("[%d] ", glyph);
                 }
 
-                bp = bin_append_posn(glyph, 10, binary, bp);
+                bits_append(&bits, glyph, 10);
                 break;
 
             case GM_BYTE:
                 if (last_mode != current_mode) {
                     /* Reserve space for byte block length indicator (9 bits) */
-                    byte_count_posn = bp;
-                    bp = bin_append_posn(0, 9, binary, bp);
+                    byte_count_posn = bits.posn;
+                    bits_append(&bits, 0, 9);
                 }
                 glyph = gbdata[sp];
                 if (byte_count == 512 || (glyph > 0xFF && byte_count == 511)) {
                     /* Maximum byte block size is 512 bytes. If longer is needed then start a new block */
                     if (glyph > 0xFF && byte_count == 511) { /* Split double-byte */
-                        bp = bin_append_posn(glyph >> 8, 8, binary, bp);
+                        bits_append(&bits, glyph >> 8, 8);
                         glyph &= 0xFF;
                         byte_count++;
                     }
-                    add_byte_count(binary, byte_count_posn, byte_count);
-                    bp = bin_append_posn(7, 4, binary, bp);
-                    byte_count_posn = bp;
-                    bp = bin_append_posn(0, 9, binary, bp);
+                    add_byte_count(&bits, byte_count_posn, byte_count);
+                    bits_append(&bits, 7, 4);
+                    byte_count_posn = bits.posn;
+                    bits_append(&bits, 0, 9);
                     byte_count = 0;
                 }
 
                 if (debug & ZINT_DEBUG_PRINT) {
                     printf("[%d] ", glyph);
                 }
-                bp = bin_append_posn(glyph, glyph > 0xFF ? 16 : 8, binary, bp);
+                bits_append(&bits, glyph, glyph > 0xFF ? 16 : 8);
                 sp++;
                 byte_count++;
                 if (glyph > 0xFF) {
@@ -672,11 +647,11 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
                         printf("[%d] ", glyph);
                     }
 
-                    bp = bin_append_posn(glyph, 6, binary, bp);
+                    bits_append(&bits, glyph, 6);
                 } else {
                     /* Shift Mode character */
-                    bp = bin_append_posn(1014, 10, binary, bp); /* shift indicator */
-                    bp = add_shift_char(binary, bp, gbdata[sp], debug);
+                    bits_append(&bits, 1014, 10); /* shift indicator */
+                    add_shift_char(&bits, gbdata[sp], debug);
                 }
 
                 sp++;
@@ -697,11 +672,11 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
                         printf("[%d] ", glyph);
                     }
 
-                    bp = bin_append_posn(glyph, 5, binary, bp);
+                    bits_append(&bits, glyph, 5);
                 } else {
                     /* Shift Mode character */
-                    bp = bin_append_posn(125, 7, binary, bp); /* shift indicator */
-                    bp = add_shift_char(binary, bp, gbdata[sp], debug);
+                    bits_append(&bits, 125, 7); /* shift indicator */
+                    add_shift_char(&bits, gbdata[sp], debug);
                 }
 
                 sp++;
@@ -722,17 +697,17 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
                         printf("[%d] ", glyph);
                     }
 
-                    bp = bin_append_posn(glyph, 5, binary, bp);
+                    bits_append(&bits, glyph, 5);
                 } else {
                     /* Shift Mode character */
-                    bp = bin_append_posn(125, 7, binary, bp); /* shift indicator */
-                    bp = add_shift_char(binary, bp, gbdata[sp], debug);
+                    bits_append(&bits, 125, 7); /* shift indicator */
+                    add_shift_char(&bits, gbdata[sp], debug);
                 }
 
                 sp++;
                 break;
         }
-        if (bp > 9191) {
+        if (bits.posn > 9191) {
             return ZINT_ERROR_TOO_LONG;
         }
 
@@ -740,65 +715,55 @@ static int gm_encode(unsigned int gbdata[], const int length, char binary[], con
 
     if (current_mode == GM_NUMBER) {
         /* add numeric block padding value */
-        switch (p) {
-            case 1: binary[number_pad_posn] = '1';
-                binary[number_pad_posn + 1] = '0';
-                break; // 2 pad digits
-            case 2: binary[number_pad_posn] = '0';
-                binary[number_pad_posn + 1] = '1';
-                break; // 1 pad digit
-            case 3: binary[number_pad_posn] = '0';
-                binary[number_pad_posn + 1] = '0';
-                break; // 0 pad digits
-        }
+        add_number_pad(&bits, number_pad_posn, p);
     }
 
     if (current_mode == GM_BYTE) {
         /* Add byte block length indicator */
-        add_byte_count(binary, byte_count_posn, byte_count);
+        add_byte_count(&bits, byte_count_posn, byte_count);
     }
 
     /* Add "end of data" character */
     switch (current_mode) {
-        case GM_CHINESE: bp = bin_append_posn(8160, 13, binary, bp);
+        case GM_CHINESE: bits_append(&bits, 8160, 13);
             break;
-        case GM_NUMBER: bp = bin_append_posn(1018, 10, binary, bp);
+        case GM_NUMBER: bits_append(&bits, 1018, 10);
             break;
         case GM_LOWER:
-        case GM_UPPER: bp = bin_append_posn(27, 5, binary, bp);
+        case GM_UPPER: bits_append(&bits, 27, 5);
             break;
-        case GM_MIXED: bp = bin_append_posn(1008, 10, binary, bp);
+        case GM_MIXED: bits_append(&bits, 1008, 10);
             break;
-        case GM_BYTE: bp = bin_append_posn(0, 4, binary, bp);
+        case GM_BYTE: bits_append(&bits, 0, 4);
             break;
     }
 
     /* Add padding bits if required */
-    p = 7 - (bp % 7);
+    p = 7 - (bits.posn % 7);
     if (p % 7) {
-        bp = bin_append_posn(0, p, binary, bp);
+        bits_append(&bits, 0, p);
     }
 
-    if (bp > 9191) {
+    if (bits.posn > 9191) {
         return ZINT_ERROR_TOO_LONG;
     }
-    binary[bp] = '\0';
-    *bin_len = bp;
+    *bin_len = bits_flush(&bits);
 
     if (debug & ZINT_DEBUG_PRINT) {
-        printf("\nBinary (%d): %s\n", bp, binary);
+        printf("\nBinary (%d): ", *bin_len);
+        bits_print(binary, 0, *bin_len);
+        putchar('\n');
     }
 
     return 0;
 }
 
-static void gm_add_ecc(const char binary[], const int data_posn, const int layers, const int ecc_level,
+static void gm_add_ecc(const unsigned char binary[], const int data_posn, const int layers, const int ecc_level,
             unsigned char word[]) {
-    int data_cw, i, j, wp, p;
+    int data_cw, i, j, wp;
     int n1, b1, n2, b2, e1, b3, e2;
-    int block_size, ecc_size;
-    unsigned char data[1320], block[130];
-    unsigned char data_block[115], ecc_block[70];
+    int block_size, ecc_size, rs_ecc_size = 0;
+    unsigned char data[1320];
     rs_t rs;
 
     data_cw = gm_data_codewords[((layers - 1) * 5) + (ecc_level - 1)];
@@ -809,11 +774,7 @@ static void gm_add_ecc(const char binary[], const int data_posn, const int layer
 
     /* Convert from binary stream to 7-bit codewords */
     for (i = 0; i < data_posn; i++) {
-        for (p = 0; p < 7; p++) {
-            if (binary[i * 7 + p] == '1') {
-                data[i] += (0x40 >> p);
-            }
-        }
+        data[i] = (unsigned char) bits_get(binary, i * 7, 7);
     }
 
     /* Add padding codewords */
@@ -855,79 +816,37 @@ static void gm_add_ecc(const char binary[], const int data_posn, const int layer
 
         /* printf("block %d/%d: data %d / ecc %d\n", i + 1, (b1 + b2), data_size, ecc_size);*/
 
+        /* Codeword `j` of each block is interleaved at `word[(b1 + b2) * j + i]` */
         for (j = 0; j < data_size; j++) {
-            data_block[j] = data[wp];
-            wp++;
+            word[((b1 + b2) * j) + i] = data[wp + j];
         }
 
-        /* Calculate ECC data for this block */
-        rs_init_code(&rs, ecc_size, 1);
-        rs_encode(&rs, data_size, data_block, ecc_block);
-
-        /* Correct error correction data but in reverse order */
-        for (j = 0; j < data_size; j++) {
-            block[j] = data_block[j];
-        }
-        for (j = 0; j < ecc_size; j++) {
-            block[(j + data_size)] = ecc_block[ecc_size - j - 1];
-        }
-
-        for (j = 0; j < n2; j++) {
-            word[((b1 + b2) * j) + i] = block[j];
-        }
-        if (block_size == n1) {
-            word[((b1 + b2) * (n1 - 1)) + i] = block[(n1 - 1)];
+        /* Calculate ECC data for this block (generator polynomial only rebuilt if ECC size changes) */
+        if (ecc_size != rs_ecc_size) {
+            rs_init_code(&rs, ecc_size, 1);
+            rs_ecc_size = ecc_size;
         }
+        rs_encode_step(&rs, data_size, data + wp, 1, word + ((b1 + b2) * data_size) + i, b1 + b2);
+        wp += data_size;
     }
 }
 
-static void place_macromodule(char grid[], int x, int y, int word1, int word2, int size) {
-    int i, j;
-
-    i = (x * 6) + 1;
-    j = (y * 6) + 1;
+/* Place the 14 data bits of a macromodule (2 7-bit codewords) into its 4x4 interior, less the top left 2 modules */
+static void place_macromodule(char grid[], const int x, const int y, const int word1, const int word2,
+            const int size) {
+    /* Interior row/column offsets of each bit, from MSB of `word2` to LSB of `word1` */
+    static const unsigned char bit_posns[14][2] = {
+        { 0, 2 }, { 0, 3 }, { 1, 0 }, { 1, 1 }, { 1, 2 }, { 1, 3 }, { 2, 0 },
+        { 2, 1 }, { 2, 2 }, { 2, 3 }, { 3, 0 }, { 3, 1 }, { 3, 2 }, { 3, 3 },
+    };
+    const int words = (word2 << 7) | word1;
+    char *const macro = grid + ((y * 6) + 1) * size + (x * 6) + 1;
+    int b;
 
-    if (word2 & 0x40) {
-        grid[(j * size) + i + 2] = '1';
-    }
-    if (word2 & 0x20) {
-        grid[(j * size) + i + 3] = '1';
-    }
-    if (word2 & 0x10) {
-        grid[((j + 1) * size) + i] = '1';
-    }
-    if (word2 & 0x08) {
-        grid[((j + 1) * size) + i + 1] = '1';
-    }
-    if (word2 & 0x04) {
-        grid[((j + 1) * size) + i + 2] = '1';
-    }
-    if (word2 & 0x02) {
-        grid[((j + 1) * size) + i + 3] = '1';
-    }
-    if (word2 & 0x01) {
-        grid[((j + 2) * size) + i] = '1';
-    }
-    if (word1 & 0x40) {
-        grid[((j + 2) * size) + i + 1] = '1';
-    }
-    if (word1 & 0x20) {
-        grid[((j + 2) * size) + i + 2] = '1';
-    }
-    if (word1 & 0x10) {
-        grid[((j + 2) * size) + i + 3] = '1';
-    }
-    if (word1 & 0x08) {
-        grid[((j + 3) * size) + i] = '1';
-    }
-    if (word1 & 0x04) {
-        grid[((j + 3) * size) + i + 1] = '1';
-    }
-    if (word1 & 0x02) {
-        grid[((j + 3) * size) + i + 2] = '1';
-    }
-    if (word1 & 0x01) {
-        grid[((j + 3) * size) + i + 3] = '1';
+    for (b = 0; b < 14; b++) {
+        if (words & (0x2000 >> b)) {
+            macro[bit_posns[b][0] * size + bit_posns[b][1]] = '1';
+        }
     }
 }
 
@@ -1002,20 +921,19 @@ INTERNAL int grid_matrix(struct zint_symbol *symbol, unsigned char source[], int
     int auto_layers, min_layers, layers, auto_ecc_level, min_ecc_level, ecc_level;
     int x, y, i;
     int full_multibyte;
-    char binary[9300];
     int data_cw, input_latch = 0;
     unsigned char word[1460] = {0};
     int data_max, reader = 0;
     int size_squared;
-    int bin_len;
+    int bin_len = 0;
     int eci_length = get_eci_length(symbol->eci, source, length);
 
-#ifndef _MSC_VER
-    unsigned int gbdata[eci_length + 1];
-#else
-    char *grid;
-    unsigned int *gbdata = (unsigned int *) _alloca((eci_length + 1) * sizeof(unsigned int));
-#endif
+    z_work_array(symbol, unsigned int, gbdata, eci_length + 1);
+    z_work_array(symbol, unsigned char, binary, (9300 + 7) / 8);
+
+    if (z_work_failed(gbdata) || z_work_failed(binary)) {
+        return z_work_error(symbol);
+    }
 
     /* If ZINT_FULL_MULTIBYTE set use Hanzi mode in DATA_MODE or for non-GB 2312 in UNICODE_MODE */
     full_multibyte = (symbol->option_3 & 0xFF) == ZINT_FULL_MULTIBYTE;
@@ -1026,9 +944,11 @@ INTERNAL int grid_matrix(struct zint_symbol *symbol, unsigned char source[], int
         int done = 0;
         if (symbol->eci != 29) { /* Unless ECI 29 (GB) */
             /* Try other conversions (ECI 0 defaults to ISO/IEC 8859-1) */
-            error_number = gb2312_utf8_to_eci(symbol->eci, source, &length, gbdata, full_multibyte);
+            error_number = gb2312_utf8_to_eci(symbol, symbol->eci, source, &length, gbdata, full_multibyte);
             if (error_number == 0) {
                 done = 1;
+            } else if (error_number == ZINT_ERROR_MEMORY) {
+                return error_number;
             } else if (symbol->eci) {
                 strcpy(symbol->errtxt, "575: Invalid characters in input data");
                 return error_number;
@@ -1050,7 +970,10 @@ INTERNAL int grid_matrix(struct zint_symbol *symbol, unsigned char source[], int
         return ZINT_ERROR_INVALID_OPTION;
     }
 
-    error_number = gm_encode(gbdata, length, binary, reader, symbol->eci, &bin_len, symbol->debug);
+    error_number = gm_encode(symbol, gbdata, length, binary, reader, symbol->eci, &bin_len, symbol->debug);
+    if (error_number == ZINT_ERROR_MEMORY) {
+        return error_number;
+    }
     if (error_number != 0) {
         strcpy(symbol->errtxt, "531: Input data too long");
         return error_number;
@@ -1146,11 +1069,11 @@ INTERNAL int grid_matrix(struct zint_symbol *symbol, unsigned char source[], int
     modules = 1 + (layers * 2);
     size_squared = size * size;
 
-#ifndef _MSC_VER
-    char grid[size_squared];
-#else
-    grid = (char *) _alloca(size_squared);
-#endif
+    z_work_array(symbol, char, grid, size_squared);
+
+    if (z_work_failed(grid)) {
+        return z_work_error(symbol);
+    }
 
     memset(grid, '0', size_squared);
 
@@ -1180,13 +1103,14 @@ INTERNAL int grid_matrix(struct zint_symbol *symbol, unsigned char source[], int
     symbol->width = size;
     symbol->rows = size;
 
-    for (x = 0; x < size; x++) {
-        for (y = 0; y < size; y++) {
-            if (grid[(y * size) + x] == '1') {
+    for (y = 0; y < size; y++) {
+        const char *const row = grid + (y * size);
+        for (x = 0; x < size; x++) {
+            if (row[x] == '1') {
                 set_module(symbol, y, x);
             }
         }
-        symbol->row_height[x] = 1;
+        symbol->row_height[y] = 1;
     }
 
     return 0;
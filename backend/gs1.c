@@ -248,7 +248,7 @@ static int key(const unsigned char *data, int data_len, int offset, int min, int
 static int yymmd0(const unsigned char *data, int data_len, int offset, int min, int max, int *p_err_no,
             int *p_err_posn, char err_msg[50], const int length_only) {
 
-    static char days_in_month[] = { 0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    static const char days_in_month[] = { 0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
 
     (void)max;
 
@@ -1179,56 +1179,68 @@ static int couponposoffer(const unsigned char *data, int data_len, int offset, i
 /* Generated by "php backend/tools/gen_gs1_linter.php > backend/gs1_lint.h" */
 #include "gs1_lint.h"
 
-/* Verify a GS1 input string */
+/* Whether an AI whose first 2 digits are `ai2` is of predefined length, so needs no FNC1 after its data. The values
+   are from "GS1 General Specifications Release 21.0.1" Figure 7.8.4-2 "Element strings with predefined length using
+   GS1 Application Identifiers" */
+static int gs1_predefined(const int ai2) {
+    return (ai2 >= 0 && ai2 <= 4) || (ai2 >= 11 && ai2 <= 20) || ai2 == 23 /* legacy support */
+            || (ai2 >= 31 && ai2 <= 36) || ai2 == 41;
+}
+
+/* Check the data of AI `ai` according to GS1 General Specifications Release 21.0.1, January 2021, returning
+   ZINT_WARN_NONCOMPLIANT or ZINT_ERROR_INVALID_DATA with `symbol->errtxt` set if it fails */
+static int gs1_lint_ai(struct zint_symbol *symbol, const int ai, const unsigned char data[], const int data_len) {
+    int err_no, err_posn;
+    char err_msg[50];
+
+    if (gs1_lint(ai, data, data_len, &err_no, &err_posn, err_msg)) {
+        return 0;
+    }
+    if (err_no == 1) {
+        sprintf(symbol->errtxt, "260: Invalid AI (%02d)", ai);
+    } else if (err_no == 2 || err_no == 4) { /* 4 is backward-incompatible bad length */
+        sprintf(symbol->errtxt, "259: Invalid data length for AI (%02d)", ai);
+    } else {
+        sprintf(symbol->errtxt, "261: AI (%02d) position %d: %s", ai, err_posn, err_msg);
+    }
+    /* For backward compatibility only error on unknown AI or bad length */
+    if ((err_no == 1 || err_no == 2) && symbol->warn_level != WARN_ZPL_COMPAT) {
+        return ZINT_ERROR_INVALID_DATA;
+    }
+    return ZINT_WARN_NONCOMPLIANT;
+}
+
+/* Verify a GS1 input string, placing the reduced string (with '[' for FNC1) in `reduced` and its length in
+   `p_reduced_length` */
 INTERNAL int gs1_verify(struct zint_symbol *symbol, const unsigned char source[], const int src_len,
-                unsigned char reduced[]) {
-    int i, j, last_ai, ai_latch;
-    char ai_string[5]; /* 4 char max "NNNN" */
+                unsigned char reduced[], int *p_reduced_length) {
+    int i, j, ai_latch;
     int bracket_level, max_bracket_level, ai_length, max_ai_length, min_ai_length;
     int ai_count;
     int error_value = 0;
     char obracket = symbol->input_mode & GS1PARENS_MODE ? '(' : '[';
     char cbracket = symbol->input_mode & GS1PARENS_MODE ? ')' : ']';
     int ai_max = chr_cnt(source, src_len, obracket) + 1; /* Plus 1 so non-zero */
-#ifndef _MSC_VER
-    int ai_value[ai_max], ai_location[ai_max], data_location[ai_max], data_length[ai_max];
-#else
-    int *ai_value = (int *) _alloca(ai_max * sizeof(int));
-    int *ai_location = (int *) _alloca(ai_max * sizeof(int));
-    int *data_location = (int *) _alloca(ai_max * sizeof(int));
-    int *data_length = (int *) _alloca(ai_max * sizeof(int));
-#endif
+    z_work_array(symbol, int, ai_value, ai_max);
+    z_work_array(symbol, int, data_location, ai_max);
+    z_work_array(symbol, int, data_length, ai_max);
 
-    /* Detect extended ASCII characters */
-    for (i = 0; i < src_len; i++) {
-        if (source[i] >= 128) {
-            strcpy(symbol->errtxt, "250: Extended ASCII characters are not supported by GS1");
-            return ZINT_ERROR_INVALID_DATA;
-        }
-        if (source[i] == '\0') {
-            strcpy(symbol->errtxt, "262: NUL characters not permitted in GS1 mode");
-            return ZINT_ERROR_INVALID_DATA;
-        }
-        if (source[i] < 32) {
-            strcpy(symbol->errtxt, "251: Control characters are not supported by GS1");
-            return ZINT_ERROR_INVALID_DATA;
-        }
-        if (source[i] == 127) {
-            strcpy(symbol->errtxt, "263: DEL characters are not supported by GS1");
-            return ZINT_ERROR_INVALID_DATA;
+    if (symbol->internal->gs1_prepared) {
+        const struct zint_gs1_prepared *const gs1_prepared = symbol->internal->gs1_prepared;
+        /* Already reduced (and checked) by `gs1_elements()` */
+        memcpy(reduced, gs1_prepared->reduced, gs1_prepared->reduced_length + 1);
+        *p_reduced_length = gs1_prepared->reduced_length;
+        if (gs1_prepared->warn_number) {
+            strcpy(symbol->errtxt, gs1_prepared->errtxt);
         }
+        return gs1_prepared->warn_number;
     }
 
-    if (source[0] != obracket) {
-        strcpy(symbol->errtxt, "252: Data does not start with an AI");
-        if (symbol->warn_level != WARN_ZPL_COMPAT) {
-            return ZINT_ERROR_INVALID_DATA;
-        } else {
-            error_value = ZINT_WARN_NONCOMPLIANT;
-        }
+    if (z_work_failed(ai_value) || z_work_failed(data_location) || z_work_failed(data_length)) {
+        return z_work_error(symbol);
     }
 
-    /* Check the position of the brackets */
+    /* Detect extended ASCII and control characters, and check the position of the brackets, in one pass */
     bracket_level = 0;
     max_bracket_level = 0;
     ai_length = 0;
@@ -1237,6 +1249,22 @@ INTERNAL int gs1_verify(struct zint_symbol *symbol, const unsigned char source[]
     j = 0;
     ai_latch = 0;
     for (i = 0; i < src_len; i++) {
+        if (source[i] < 32 || source[i] >= 127) {
+            if (source[i] >= 128) {
+                strcpy(symbol->errtxt, "250: Extended ASCII characters are not supported by GS1");
+                return ZINT_ERROR_INVALID_DATA;
+            }
+            if (source[i] == '\0') {
+                strcpy(symbol->errtxt, "262: NUL characters not permitted in GS1 mode");
+                return ZINT_ERROR_INVALID_DATA;
+            }
+            if (source[i] < 32) {
+                strcpy(symbol->errtxt, "251: Control characters are not supported by GS1");
+                return ZINT_ERROR_INVALID_DATA;
+            }
+            strcpy(symbol->errtxt, "263: DEL characters are not supported by GS1");
+            return ZINT_ERROR_INVALID_DATA;
+        }
         ai_length += j;
         if (((j == 1) && (source[i] != cbracket)) && ((source[i] < '0') || (source[i] > '9'))) {
             ai_latch = 1;
@@ -1262,6 +1290,15 @@ INTERNAL int gs1_verify(struct zint_symbol *symbol, const unsigned char source[]
     }
     min_ai_length--;
 
+    if (source[0] != obracket) {
+        strcpy(symbol->errtxt, "252: Data does not start with an AI");
+        if (symbol->warn_level != WARN_ZPL_COMPAT) {
+            return ZINT_ERROR_INVALID_DATA;
+        } else {
+            error_value = ZINT_WARN_NONCOMPLIANT;
+        }
+    }
+
     if (bracket_level != 0) {
         /* Not all brackets are closed */
         strcpy(symbol->errtxt, "253: Malformed AI in input data (brackets don\'t match)");
@@ -1292,34 +1329,48 @@ INTERNAL int gs1_verify(struct zint_symbol *symbol, const unsigned char source[]
         return ZINT_ERROR_INVALID_DATA;
     }
 
+    /* Now well-formed, so in one pass find the AIs and their data, and resolve AI data - put resulting string in
+       'reduced' */
     ai_count = 0;
-    for (i = 1; i < src_len; i++) {
-        if (source[i - 1] == obracket) {
-            ai_location[ai_count] = i;
-            j = 0;
-            do {
-                ai_string[j] = source[i + j];
-                j++;
-            } while (ai_string[j - 1] != cbracket);
-            ai_string[j - 1] = '\0';
-            ai_value[ai_count] = atoi(ai_string);
+    j = 0;
+    ai_latch = 1;
+    for (i = 0; i < src_len; i++) {
+        if (source[i] == obracket) {
+            /* Start of an AI string */
+            int ai_posn;
+            if (ai_count) {
+                /* Data of previous AI runs up to here */
+                data_length[ai_count - 1] = i - data_location[ai_count - 1];
+            }
+            ai_value[ai_count] = 0;
+            for (ai_posn = i + 1; source[ai_posn] != cbracket; ai_posn++) {
+                ai_value[ai_count] = ai_value[ai_count] * 10 + source[ai_posn] - '0';
+            }
+            data_location[ai_count] = i + 4;
+            if (ai_value[ai_count] >= 100) {
+                data_location[ai_count]++;
+                if (ai_value[ai_count] >= 1000) {
+                    data_location[ai_count]++;
+                }
+            }
             ai_count++;
+
+            if (ai_latch == 0) {
+                reduced[j++] = '[';
+            }
+            ai_latch = gs1_predefined((source[i + 1] - '0') * 10 + source[i + 2] - '0');
+        } else if (source[i] != cbracket) {
+            reduced[j++] = source[i];
         }
+        /* The ']' character is simply dropped from the input */
+    }
+    reduced[j] = '\0';
+    *p_reduced_length = j;
+    if (ai_count) {
+        data_length[ai_count - 1] = src_len - data_location[ai_count - 1];
     }
 
     for (i = 0; i < ai_count; i++) {
-        data_location[i] = ai_location[i] + 3;
-        if (ai_value[i] >= 100) {
-            data_location[i]++;
-            if (ai_value[i] >= 1000) {
-                data_location[i]++;
-            }
-        }
-        data_length[i] = 0;
-        while ((data_location[i] + data_length[i] < src_len)
-                    && (source[data_location[i] + data_length[i]] != obracket)) {
-            data_length[i]++;
-        }
         if (data_length[i] == 0) {
             /* No data for given AI */
             strcpy(symbol->errtxt, "258: Empty data field in input data");
@@ -1327,62 +1378,120 @@ INTERNAL int gs1_verify(struct zint_symbol *symbol, const unsigned char source[]
         }
     }
 
-    strcpy(ai_string, "");
+    if (symbol->input_mode & GS1NOCHECK_MODE) {
+        /* Data pre-validated by caller */
+        return error_value;
+    }
 
-    // Check for valid AI values and data lengths according to GS1 General
-    // Specifications Release 21.0.1, January 2021
+    // Check for valid AI values and data lengths
     for (i = 0; i < ai_count; i++) {
-        int err_no, err_posn;
-        char err_msg[50];
-        if (!gs1_lint(ai_value[i], source + data_location[i], data_length[i], &err_no, &err_posn, err_msg)) {
-            if (err_no == 1) {
-                sprintf(symbol->errtxt, "260: Invalid AI (%02d)", ai_value[i]);
-            } else if (err_no == 2 || err_no == 4) { /* 4 is backward-incompatible bad length */
-                sprintf(symbol->errtxt, "259: Invalid data length for AI (%02d)", ai_value[i]);
-            } else {
-                sprintf(symbol->errtxt, "261: AI (%02d) position %d: %s", ai_value[i], err_posn, err_msg);
-            }
-            /* For backward compatibility only error on unknown AI or bad length */
-            if ((err_no == 1 || err_no == 2) && symbol->warn_level != WARN_ZPL_COMPAT) {
-                return ZINT_ERROR_INVALID_DATA;
-            }
-            error_value = ZINT_WARN_NONCOMPLIANT;
+        const int lint_error = gs1_lint_ai(symbol, ai_value[i], source + data_location[i], data_length[i]);
+        if (lint_error >= ZINT_ERROR) {
+            return lint_error;
+        }
+        if (lint_error) {
+            error_value = lint_error;
         }
     }
 
-    /* Resolve AI data - put resulting string in 'reduced' */
-    j = 0;
-    ai_latch = 1;
-    for (i = 0; i < src_len; i++) {
-        if ((source[i] != obracket) && (source[i] != cbracket)) {
-            reduced[j++] = source[i];
+    /* the character '[' in the reduced string refers to the FNC1 character */
+    return error_value;
+}
+
+/* Set bracketed `source` (for the symbologies' human readable text) and `reduced` (FNC1 as '[') directly from the
+   `count` AI/value `elements`, checking each value unless GS1NOCHECK_MODE. `source` and `reduced` must each be at
+   least `gs1_elements_size()`. Sets `prepared` for `internal->gs1_prepared`, so that
+   `gs1_verify()` takes `reduced` as is */
+INTERNAL int gs1_elements(struct zint_symbol *symbol, const struct zint_gs1_element elements[], const int count,
+                unsigned char source[], int *p_source_len, unsigned char reduced[],
+                struct zint_gs1_prepared *prepared) {
+    int error_value = 0;
+    int i, k;
+    int s_len = 0, r_len = 0;
+    int predefined = 1; /* No FNC1 before first */
+
+    for (i = 0; i < count; i++) {
+        const int ai = elements[i].ai;
+        const unsigned char *const data = elements[i].data;
+        const int data_len = data && elements[i].length < 0 ? (int) ustrlen(data) : elements[i].length;
+        char ai_str[5];
+        int ai_len;
+
+        if (ai < 0 || ai > 9999) {
+            sprintf(symbol->errtxt, "759: Invalid AI %d in element %d", ai, i);
+            return ZINT_ERROR_INVALID_DATA;
         }
-        if (source[i] == obracket) {
-            /* Start of an AI string */
-            if (ai_latch == 0) {
-                reduced[j++] = '[';
+        if (!data || data_len <= 0) {
+            strcpy(symbol->errtxt, "258: Empty data field in input data");
+            return ZINT_ERROR_INVALID_DATA;
+        }
+        for (k = 0; k < data_len; k++) {
+            if (data[k] < 32 || data[k] >= 127) {
+                if (data[k] >= 128) {
+                    strcpy(symbol->errtxt, "250: Extended ASCII characters are not supported by GS1");
+                } else if (data[k] == '\0') {
+                    strcpy(symbol->errtxt, "262: NUL characters not permitted in GS1 mode");
+                } else if (data[k] < 32) {
+                    strcpy(symbol->errtxt, "251: Control characters are not supported by GS1");
+                } else {
+                    strcpy(symbol->errtxt, "263: DEL characters are not supported by GS1");
+                }
+                return ZINT_ERROR_INVALID_DATA;
             }
-            ai_string[0] = source[i + 1];
-            ai_string[1] = source[i + 2];
-            ai_string[2] = '\0';
-            last_ai = atoi(ai_string);
-            ai_latch = 0;
-            /* The following values from "GS1 General Specifications Release 21.0.1"
-               Figure 7.8.4-2 "Element strings with predefined length using GS1 Application Identifiers" */
-            if (
-                    ((last_ai >= 0) && (last_ai <= 4))
-                    || ((last_ai >= 11) && (last_ai <= 20))
-                    || (last_ai == 23) /* legacy support */
-                    || ((last_ai >= 31) && (last_ai <= 36))
-                    || (last_ai == 41)
-                    ) {
-                ai_latch = 1;
+            if (data[k] == '[' || data[k] == ']') {
+                sprintf(symbol->errtxt, "760: Brackets not permitted in AI (%02d) data", ai);
+                return ZINT_ERROR_INVALID_DATA;
             }
         }
-        /* The ']' character is simply dropped from the input */
+        if (!(symbol->input_mode & GS1NOCHECK_MODE)) {
+            const int lint_error = gs1_lint_ai(symbol, ai, data, data_len);
+            if (lint_error >= ZINT_ERROR) {
+                return lint_error;
+            }
+            if (lint_error) {
+                error_value = lint_error;
+                strcpy(prepared->errtxt, symbol->errtxt);
+            }
+        }
+
+        ai_len = sprintf(ai_str, "%02d", ai);
+        source[s_len++] = '[';
+        memcpy(source + s_len, ai_str, ai_len);
+        s_len += ai_len;
+        source[s_len++] = ']';
+        memcpy(source + s_len, data, data_len);
+        s_len += data_len;
+
+        if (!predefined) {
+            reduced[r_len++] = '[';
+        }
+        memcpy(reduced + r_len, ai_str, ai_len);
+        r_len += ai_len;
+        memcpy(reduced + r_len, data, data_len);
+        r_len += data_len;
+        predefined = gs1_predefined((ai_str[0] - '0') * 10 + ai_str[1] - '0');
     }
-    reduced[j] = '\0';
+    source[s_len] = '\0';
+    reduced[r_len] = '\0';
+    *p_source_len = s_len;
+
+    prepared->reduced = reduced;
+    prepared->reduced_length = r_len;
+    prepared->warn_number = error_value;
 
-    /* the character '[' in the reduced string refers to the FNC1 character */
     return error_value;
 }
+
+/* Size needed for `gs1_elements()` `source` */
+INTERNAL int gs1_elements_size(const struct zint_gs1_element elements[], const int count) {
+    int size = 1;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        const int data_len = elements[i].data && elements[i].length < 0 ? (int) ustrlen(elements[i].data)
+                                : elements[i].length;
+        size += 6 + (data_len > 0 ? data_len : 0);
+    }
+
+    return size;
+}
@@ -37,8 +37,21 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/* GS1 data reduced from AI/value elements by `gs1_elements()`, set in `internal->gs1_prepared` while encoding them */
+struct zint_gs1_prepared {
+    const unsigned char *reduced; /* NUL-terminated */
+    int reduced_length;
+    int warn_number; /* ZINT_WARN_NONCOMPLIANT if a value failed checking, with `errtxt` */
+    char errtxt[100];
+};
+
 INTERNAL int gs1_verify(struct zint_symbol *symbol, const unsigned char source[], const int src_len,
-                unsigned char reduced[]);
+                unsigned char reduced[], int *p_reduced_length);
+
+INTERNAL int gs1_elements(struct zint_symbol *symbol, const struct zint_gs1_element elements[], const int count,
+                unsigned char source[], int *p_source_len, unsigned char reduced[],
+                struct zint_gs1_prepared *prepared);
+INTERNAL int gs1_elements_size(const struct zint_gs1_element elements[], const int count);
 
 #ifdef __cplusplus
 }
@@ -33,9 +33,13 @@
 /* This code attempts to implement Han Xin Code according to ISO/IEC 20830 (draft 2019-10-10)
  * (previously AIMD-015:2010 (Rev 0.8)) */
 
+#include <limits.h>
 #include <stdio.h>
 #ifdef _MSC_VER
 #include <malloc.h>
+#include "ms_stdint.h"
+#else
+#include <stdint.h>
 #endif
 #include "common.h"
 #include "reedsol.h"
@@ -285,47 +289,6 @@ static int lookup_text2(const unsigned int input) {
 /* Bits multiplied by this for costs, so as to be whole integer divisible by 2 and 3 */
 #define HX_MULT 6
 
-/* Whether in numeric or not. If in numeric, *p_end is set to position after numeric,
- * and *p_cost is set to per-numeric cost */
-static int in_numeric(const unsigned int gbdata[], const int length, const int in_posn,
-            unsigned int *p_end, unsigned int *p_cost) {
-    int i, digit_cnt;
-
-    if (in_posn < (int) *p_end) {
-        return 1;
-    }
-
-    /* Attempt to calculate the average 'cost' of using numeric mode in number of bits (times HX_MULT) */
-    for (i = in_posn; i < length && i < in_posn + 4 && gbdata[i] >= '0' && gbdata[i] <= '9'; i++);
-
-    digit_cnt = i - in_posn;
-
-    if (digit_cnt == 0) {
-        *p_end = 0;
-        return 0;
-    }
-    *p_end = i;
-    *p_cost = digit_cnt == 1 ? 60 /* 10 * HX_MULT */ : digit_cnt == 2 ? 30 /* (10 / 2) * HX_MULT */ : 20 /* (10 / 3) * HX_MULT */;
-    return 1;
-}
-
-/* Whether in four-byte or not. If in four-byte, *p_fourbyte is set to position after four-byte,
- * and *p_fourbyte_cost is set to per-position cost */
-static int in_fourbyte(const unsigned int gbdata[], const int length, const int in_posn,
-            unsigned int *p_end, unsigned int *p_cost) {
-    if (in_posn < (int) *p_end) {
-        return 1;
-    }
-
-    if (in_posn == length - 1 || !isFourByte(gbdata[in_posn], gbdata[in_posn + 1])) {
-        *p_end = 0;
-        return 0;
-    }
-    *p_end = in_posn + 2;
-    *p_cost = 75; /* ((4 + 21) / 2) * HX_MULT */
-    return 1;
-}
-
 /* Indexes into mode_types array */
 #define HX_N   0 /* Numeric */
 #define HX_T   1 /* Text */
@@ -338,173 +301,371 @@ static int in_fourbyte(const unsigned int gbdata[], const int length, const int
 
 #define HX_NUM_MODES 7
 
-/* Calculate optimized encoding modes. Adapted from Project Nayuki */
-/* Copyright (c) Project Nayuki. (MIT License) See qr.c for detailed notice */
-static void hx_define_mode(char *mode, const unsigned int gbdata[], const int length, const int debug) {
-    /* Must be in same order as HX_N etc */
-    static const char mode_types[] = { 'n', 't', 'b', '1', '2', 'd', 'f', '\0' };
-
-    /* Initial mode costs */
-    static unsigned int head_costs[HX_NUM_MODES] = {
-    /*  N            T            B                   1            2            D            F */
-        4 * HX_MULT, 4 * HX_MULT, (4 + 13) * HX_MULT, 4 * HX_MULT, 4 * HX_MULT, 4 * HX_MULT, 0
-    };
+/* Must be in same order as HX_N etc */
+static const char hx_mode_types[] = { 'n', 't', 'b', '1', '2', 'd', 'f', '\0' };
+
+/* Character class flags, set by `hx_char_classes()` */
+#define HX_C_NUM        0x03 /* Numeric, index into `numeric_costs[]` of `hx_define_mode()` */
+#define HX_C_TEXT       0x04 /* Text */
+#define HX_C_TEXT_SHIFT 0x08 /* Text, needing a change of sub-mode */
+#define HX_C_FOURBYTE   0x10 /* Half of a GB 18030 4-byte sequence */
+#define HX_C_DOUBLE     0x20 /* GB 18030 2-byte */
+#define HX_C_REGION1    0x40 /* GB 18030 2-byte Region One */
+#define HX_C_REGION2    0x80 /* GB 18030 2-byte Region Two */
+
+/* Initial mode costs */
+static const unsigned int hx_head_costs[HX_NUM_MODES] = {
+/*  N            T            B                   1            2            D            F */
+    4 * HX_MULT, 4 * HX_MULT, (4 + 13) * HX_MULT, 4 * HX_MULT, 4 * HX_MULT, 4 * HX_MULT, 0
+};
+
+/* Cost of switching modes from k to j */
+static const unsigned int hx_switch_costs[HX_NUM_MODES][HX_NUM_MODES] = {
+    /*      N                   T                   B                        1                   2                   D                   F */
+    /*N*/ {                  0, (10 + 4) * HX_MULT, (10 + 4 + 13) * HX_MULT, (10 + 4) * HX_MULT, (10 + 4) * HX_MULT, (10 + 4) * HX_MULT, 10 * HX_MULT },
+    /*T*/ {  (6 + 4) * HX_MULT,                  0,  (6 + 4 + 13) * HX_MULT,  (6 + 4) * HX_MULT,  (6 + 4) * HX_MULT,  (6 + 4) * HX_MULT,  6 * HX_MULT },
+    /*B*/ {        4 * HX_MULT,        4 * HX_MULT,                       0,        4 * HX_MULT,        4 * HX_MULT,        4 * HX_MULT,  0 },
+    /*1*/ { (12 + 4) * HX_MULT, (12 + 4) * HX_MULT, (12 + 4 + 13) * HX_MULT,                  0,       12 * HX_MULT, (12 + 4) * HX_MULT, 12 * HX_MULT },
+    /*2*/ { (12 + 4) * HX_MULT, (12 + 4) * HX_MULT, (12 + 4 + 13) * HX_MULT,       12 * HX_MULT,                  0, (12 + 4) * HX_MULT, 12 * HX_MULT },
+    /*D*/ { (15 + 4) * HX_MULT, (15 + 4) * HX_MULT, (15 + 4 + 13) * HX_MULT, (15 + 4) * HX_MULT, (15 + 4) * HX_MULT,                  0, 15 * HX_MULT },
+    /*F*/ {        4 * HX_MULT,        4 * HX_MULT,      (4 + 13) * HX_MULT,        4 * HX_MULT,        4 * HX_MULT,        4 * HX_MULT,  0 },
+};
+
+/* Final end-of-data costs */
+static const unsigned int hx_eod_costs[HX_NUM_MODES] = {
+/*  N             T            B  1             2             D             F */
+    10 * HX_MULT, 6 * HX_MULT, 0, 12 * HX_MULT, 12 * HX_MULT, 15 * HX_MULT, 0
+};
+
+/* Classify each character of `gbdata`, splitting digits into groups of up to 3 (4 if a fourth follows, which costs
+ * the same), pairing 4-byte halves, and tracking the Text sub-mode */
+static void hx_char_classes(unsigned char classes[], const unsigned int gbdata[], const int length) {
+    int i, j, digit_cnt;
+    int text_submode = 1;
+
+    for (i = 0; i < length; i++) {
+        classes[i] = 0;
+    }
+
+    for (i = 0; i < length; i = j) {
+        for (j = i; j < length && j < i + 4 && gbdata[j] >= '0' && gbdata[j] <= '9'; j++);
+        digit_cnt = j - i;
+        if (digit_cnt == 0) {
+            j = i + 1;
+        } else {
+            const unsigned char num = digit_cnt == 1 ? 1 : digit_cnt == 2 ? 2 : 3;
+            for (; i < j; i++) {
+                classes[i] = num;
+            }
+        }
+    }
 
-    /* Cost of switching modes from k to j */
-    static const unsigned int switch_costs[HX_NUM_MODES][HX_NUM_MODES] = {
-        /*      N                   T                   B                        1                   2                   D                   F */
-        /*N*/ {                  0, (10 + 4) * HX_MULT, (10 + 4 + 13) * HX_MULT, (10 + 4) * HX_MULT, (10 + 4) * HX_MULT, (10 + 4) * HX_MULT, 10 * HX_MULT },
-        /*T*/ {  (6 + 4) * HX_MULT,                  0,  (6 + 4 + 13) * HX_MULT,  (6 + 4) * HX_MULT,  (6 + 4) * HX_MULT,  (6 + 4) * HX_MULT,  6 * HX_MULT },
-        /*B*/ {        4 * HX_MULT,        4 * HX_MULT,                       0,        4 * HX_MULT,        4 * HX_MULT,        4 * HX_MULT,  0 },
-        /*1*/ { (12 + 4) * HX_MULT, (12 + 4) * HX_MULT, (12 + 4 + 13) * HX_MULT,                  0,       12 * HX_MULT, (12 + 4) * HX_MULT, 12 * HX_MULT },
-        /*2*/ { (12 + 4) * HX_MULT, (12 + 4) * HX_MULT, (12 + 4 + 13) * HX_MULT,       12 * HX_MULT,                  0, (12 + 4) * HX_MULT, 12 * HX_MULT },
-        /*D*/ { (15 + 4) * HX_MULT, (15 + 4) * HX_MULT, (15 + 4 + 13) * HX_MULT, (15 + 4) * HX_MULT, (15 + 4) * HX_MULT,                  0, 15 * HX_MULT },
-        /*F*/ {        4 * HX_MULT,        4 * HX_MULT,      (4 + 13) * HX_MULT,        4 * HX_MULT,        4 * HX_MULT,        4 * HX_MULT,  0 },
-    };
+    for (i = 0; i < length; i++) {
+        const int text1 = (classes[i] & HX_C_NUM) || lookup_text1(gbdata[i]) != -1;
+        const int text2 = !(classes[i] & HX_C_NUM) && lookup_text2(gbdata[i]) != -1;
 
-    /* Final end-of-data costs */
-    static const unsigned int eod_costs[HX_NUM_MODES] = {
-    /*  N             T            B  1             2             D             F */
-        10 * HX_MULT, 6 * HX_MULT, 0, 12 * HX_MULT, 12 * HX_MULT, 15 * HX_MULT, 0
-    };
+        if (text1 || text2) {
+            if ((text_submode == 1 && text2) || (text_submode == 2 && text1)) {
+                classes[i] |= HX_C_TEXT | HX_C_TEXT_SHIFT;
+                text_submode = text2 ? 2 : 1;
+            } else {
+                classes[i] |= HX_C_TEXT;
+            }
+        } else {
+            text_submode = 1;
+        }
 
-    unsigned int numeric_end = 0, numeric_cost = 0, text_submode = 1, fourbyte_end = 0, fourbyte_cost = 0; /* State */
-    int text1, text2;
+        if (i + 1 < length && isFourByte(gbdata[i], gbdata[i + 1])) {
+            classes[i] |= HX_C_FOURBYTE;
+            classes[++i] |= HX_C_FOURBYTE;
+            /* Second half can't be text or numeric (low byte 0x30-0x39 but high byte 0x81-0xFE) */
+            text_submode = 1;
+        } else if (isDoubleByte(gbdata[i])) {
+            classes[i] |= HX_C_DOUBLE;
+            if (isRegion1(gbdata[i])) { /* Subset */
+                classes[i] |= HX_C_REGION1;
+            } else if (isRegion2(gbdata[i])) { /* Subset */
+                classes[i] |= HX_C_REGION2;
+            }
+        }
+    }
+}
+
+/* Calculate optimized encoding modes. Adapted from Project Nayuki */
+/* Copyright (c) Project Nayuki. (MIT License) See qr.c for detailed notice */
+static int hx_define_mode(struct zint_symbol *symbol, char *mode, const unsigned int gbdata[], const int length) {
+    /* Per-digit numeric costs for groups of 1, 2 and 3 (or 4) digits, indexed by HX_C_NUM */
+    static const unsigned int numeric_costs[4] = {
+        0, 10 * HX_MULT, (10 / 2) * HX_MULT, 20 /* (10 / 3) * HX_MULT */
+    };
 
     int i, j, k, cm_i;
     unsigned int min_cost;
-    char cur_mode;
+    int cur_mode;
     unsigned int prev_costs[HX_NUM_MODES];
     unsigned int cur_costs[HX_NUM_MODES];
-#ifndef _MSC_VER
-    char char_modes[length * HX_NUM_MODES];
-#else
-    char *char_modes = (char *) _alloca(length * HX_NUM_MODES);
-#endif
+    z_work_array(symbol, unsigned char, classes, length);
+    z_work_array(symbol, char, char_modes, length * HX_NUM_MODES);
+
+    if (z_work_failed(classes) || z_work_failed(char_modes)) {
+        return z_work_error(symbol);
+    }
 
-    /* char_modes[i * HX_NUM_MODES + j] represents the mode to encode the code point at index i such that the final
-     * segment ends in mode_types[j] and the total number of bits is minimized over all possible choices */
-    memset(char_modes, 0, length * HX_NUM_MODES);
+    hx_char_classes(classes, gbdata, length);
+
+    /* char_modes[i * HX_NUM_MODES + j] represents the mode (index into mode_types) to encode the code point at
+     * index i such that the final segment ends in mode_types[j] and the total number of bits is minimized over all
+     * possible choices */
 
     /* At the beginning of each iteration of the loop below, prev_costs[j] is the minimum number of 1/6 (1/XX_MULT)
      * bits needed to encode the entire string prefix of length i, and end in mode_types[j] */
-    memcpy(prev_costs, head_costs, HX_NUM_MODES * sizeof(unsigned int));
+    memcpy(prev_costs, hx_head_costs, HX_NUM_MODES * sizeof(unsigned int));
 
     /* Calculate costs using dynamic programming */
     for (i = 0, cm_i = 0; i < length; i++, cm_i += HX_NUM_MODES) {
-        memset(cur_costs, 0, HX_NUM_MODES * sizeof(unsigned int));
-
-        if (in_numeric(gbdata, length, i, &numeric_end, &numeric_cost)) {
-            cur_costs[HX_N] = prev_costs[HX_N] + numeric_cost;
-            char_modes[cm_i + HX_N] = 'n';
-            text1 = 1;
-            text2 = 0;
-        } else {
-            text1 = lookup_text1(gbdata[i]) != -1;
-            text2 = lookup_text2(gbdata[i]) != -1;
-        }
-
-        if (text1 || text2) {
-            if ((text_submode == 1 && text2) || (text_submode == 2 && text1)) {
-                cur_costs[HX_T] = prev_costs[HX_T] + 72; /* (6 + 6) * HX_MULT */
-                text_submode = text2 ? 2 : 1;
-            } else {
-                cur_costs[HX_T] = prev_costs[HX_T] + 36; /* 6 * HX_MULT */
-            }
-            char_modes[cm_i + HX_T] = 't';
-        } else {
-            text_submode = 1;
-        }
+        const unsigned int cls = classes[i];
+        unsigned int avail = 1 << HX_B; /* Bit flags of modes that can encode the code point */
 
         /* Binary mode can encode anything */
         cur_costs[HX_B] = prev_costs[HX_B] + (gbdata[i] > 0xFF ? 96 : 48); /* (16 : 8) * HX_MULT */
-        char_modes[cm_i + HX_B] = 'b';
 
-        if (in_fourbyte(gbdata, length, i, &fourbyte_end, &fourbyte_cost)) {
-            cur_costs[HX_F] = prev_costs[HX_F] + fourbyte_cost;
-            char_modes[cm_i + HX_F] = 'f';
-        } else {
-            if (isDoubleByte(gbdata[i])) {
-                cur_costs[HX_D] = prev_costs[HX_D] + 90; /* 15 * HX_MULT */
-                char_modes[cm_i + HX_D] = 'd';
-                if (isRegion1(gbdata[i])) { /* Subset */
-                    cur_costs[HX_1] = prev_costs[HX_1] + 72; /* 12 * HX_MULT */
-                    char_modes[cm_i + HX_1] = '1';
-                } else if (isRegion2(gbdata[i])) { /* Subset */
-                    cur_costs[HX_2] = prev_costs[HX_2] + 72; /* 12 * HX_MULT */
-                    char_modes[cm_i + HX_2] = '2';
-                }
+        if (cls & HX_C_NUM) {
+            cur_costs[HX_N] = prev_costs[HX_N] + numeric_costs[cls & HX_C_NUM];
+            avail |= 1 << HX_N;
+        }
+        if (cls & HX_C_TEXT) {
+            cur_costs[HX_T] = prev_costs[HX_T] + (cls & HX_C_TEXT_SHIFT ? 72 : 36); /* (6 + 6 : 6) * HX_MULT */
+            avail |= 1 << HX_T;
+        }
+        if (cls & HX_C_FOURBYTE) {
+            cur_costs[HX_F] = prev_costs[HX_F] + 75; /* ((4 + 21) / 2) * HX_MULT */
+            avail |= 1 << HX_F;
+        } else if (cls & HX_C_DOUBLE) {
+            cur_costs[HX_D] = prev_costs[HX_D] + 90; /* 15 * HX_MULT */
+            avail |= 1 << HX_D;
+            if (cls & HX_C_REGION1) {
+                cur_costs[HX_1] = prev_costs[HX_1] + 72; /* 12 * HX_MULT */
+                avail |= 1 << HX_1;
+            } else if (cls & HX_C_REGION2) {
+                cur_costs[HX_2] = prev_costs[HX_2] + 72; /* 12 * HX_MULT */
+                avail |= 1 << HX_2;
             }
         }
 
         if (i == length - 1) { /* Add end of data costs if last character */
             for (j = 0; j < HX_NUM_MODES; j++) {
-                if (char_modes[cm_i + j]) {
-                    cur_costs[j] += eod_costs[j];
+                if (avail & (1 << j)) {
+                    cur_costs[j] += hx_eod_costs[j];
                 }
             }
         }
 
-        /* Start new segment at the end to switch modes */
+        /* Start new segment at the end to switch modes. As switching twice always costs more than switching
+         * directly, only modes that can encode the code point need be switched from */
         for (j = 0; j < HX_NUM_MODES; j++) { /* To mode */
+            unsigned int best_cost;
+            int best_mode;
+            if (avail & (1 << j)) {
+                best_cost = cur_costs[j];
+                best_mode = j;
+            } else {
+                best_cost = UINT_MAX;
+                best_mode = 0;
+            }
             for (k = 0; k < HX_NUM_MODES; k++) { /* From mode */
-                if (j != k && char_modes[cm_i + k]) {
-                    unsigned int new_cost = cur_costs[k] + switch_costs[k][j];
-                    if (!char_modes[cm_i + j] || new_cost < cur_costs[j]) {
-                        cur_costs[j] = new_cost;
-                        char_modes[cm_i + j] = mode_types[k];
-                    }
+                if (j != k && (avail & (1 << k)) && cur_costs[k] + hx_switch_costs[k][j] < best_cost) {
+                    best_cost = cur_costs[k] + hx_switch_costs[k][j];
+                    best_mode = k;
                 }
             }
+            prev_costs[j] = best_cost;
+            char_modes[cm_i + j] = (char) best_mode;
         }
-
-        memcpy(prev_costs, cur_costs, HX_NUM_MODES * sizeof(unsigned int));
     }
 
     /* Find optimal ending mode */
     min_cost = prev_costs[0];
-    cur_mode = mode_types[0];
+    cur_mode = 0;
     for (i = 1; i < HX_NUM_MODES; i++) {
         if (prev_costs[i] < min_cost) {
             min_cost = prev_costs[i];
-            cur_mode = mode_types[i];
+            cur_mode = i;
         }
     }
 
     /* Get optimal mode for each code point by tracing backwards */
     for (i = length - 1, cm_i = i * HX_NUM_MODES; i >= 0; i--, cm_i -= HX_NUM_MODES) {
-        j = strchr(mode_types, cur_mode) - mode_types;
-        cur_mode = char_modes[cm_i + j];
-        mode[i] = cur_mode;
+        cur_mode = char_modes[cm_i + cur_mode];
+        mode[i] = hx_mode_types[cur_mode];
     }
 
-    if (debug & ZINT_DEBUG_PRINT) {
+    if (symbol->debug & ZINT_DEBUG_PRINT) {
+        printf("  Mode: %.*s\n", length, mode);
+    }
+
+    return 0;
+}
+
+/* Cost in bits (times HX_MULT) of encoding `gbdata[start]` to `gbdata[end - 1]` in a single segment of mode `m`
+ * (HX_N etc), excluding mode indicators, terminators and byte counts */
+static unsigned int hx_run_cost(const int m, const unsigned int gbdata[], const int start, const int end) {
+    const int n = end - start;
+    int i, submode;
+    unsigned int bits = 0;
+
+    switch (m) {
+        case HX_N:
+            bits = ((n + 2) / 3) * 10;
+            break;
+        case HX_T:
+            for (i = start, submode = 1; i < end; i++) {
+                if (getsubmode(gbdata[i]) != submode) {
+                    bits += 6;
+                    submode = getsubmode(gbdata[i]);
+                }
+                bits += 6;
+            }
+            break;
+        case HX_B:
+            for (i = start; i < end; i++) {
+                bits += gbdata[i] > 0xFF ? 16 : 8;
+            }
+            break;
+        case HX_1:
+        case HX_2:
+            bits = n * 12;
+            break;
+        case HX_D:
+            bits = n * 15;
+            break;
+        case HX_F:
+            return n * 75; /* ((4 + 21) / 2) * HX_MULT */
+    }
+
+    return bits * HX_MULT;
+}
+
+/* Cost of switching from mode `a` to mode `b`, where -1 is the beginning or end of data */
+static unsigned int hx_trans_cost(const int a, const int b) {
+    if (a == b) {
+        return 0;
+    }
+    if (a == -1) {
+        return hx_head_costs[b];
+    }
+    if (b == -1) {
+        return hx_eod_costs[a];
+    }
+    return hx_switch_costs[a][b];
+}
+
+/* Whether mode `x` can encode characters whose narrowest mode is `m` (Binary can take anything, Text can take
+ * digits, and GB 18030 2-byte can take Region One/Two) */
+static int hx_can_take(const int x, const int m) {
+    return x == m || x == HX_B || (x == HX_T && m == HX_N) || (x == HX_D && (m == HX_1 || m == HX_2));
+}
+
+/* Choose modes in a single greedy pass (FAST_MODE), which may give a longer bitstream than `hx_define_mode()`: each
+ * character is given its narrowest mode, and then each run of the same mode in turn is given the mode that is
+ * cheapest to encode it in, looking ahead to the following run only */
+static int hx_fast_mode(struct zint_symbol *symbol, char *mode, const unsigned int gbdata[], const int length) {
+    int i, j, j2, x, y;
+    z_work_array(symbol, unsigned char, classes, length);
+
+    if (z_work_failed(classes)) {
+        return z_work_error(symbol);
+    }
+
+    hx_char_classes(classes, gbdata, length);
+
+    /* `mode` holds indexes into `hx_mode_types` until the end */
+    for (i = 0; i < length; i++) {
+        const unsigned int cls = classes[i];
+        mode[i] = cls & HX_C_FOURBYTE ? HX_F : cls & HX_C_REGION1 ? HX_1 : cls & HX_C_REGION2 ? HX_2
+                    : cls & HX_C_DOUBLE ? HX_D : cls & HX_C_NUM ? HX_N : cls & HX_C_TEXT ? HX_T : HX_B;
+    }
+
+    for (i = 0; i < length; i = j) {
+        const int m = mode[i];
+        const int p = i ? mode[i - 1] : -1;
+        int q = -1, q2 = -1, best = m;
+        unsigned int best_cost = UINT_MAX;
+
+        for (j = i + 1; j < length && mode[j] == m; j++);
+        if (m == p) {
+            continue;
+        }
+        if (j < length) {
+            q = mode[j];
+            for (j2 = j + 1; j2 < length && mode[j2] == q; j2++);
+            q2 = j2 < length ? mode[j2] : -1;
+        }
+
+        for (x = 0; x < HX_NUM_MODES; x++) {
+            unsigned int cost, next_cost;
+            if (!hx_can_take(x, m)) {
+                continue;
+            }
+            cost = hx_trans_cost(p, x) + hx_run_cost(x, gbdata, i, j);
+            if (q == -1) {
+                next_cost = hx_trans_cost(x, -1);
+            } else {
+                next_cost = UINT_MAX;
+                for (y = 0; y < HX_NUM_MODES; y++) {
+                    if (hx_can_take(y, q)) {
+                        const unsigned int c = hx_trans_cost(x, y) + hx_run_cost(y, gbdata, j, j2)
+                                                + hx_trans_cost(y, q2);
+                        if (c < next_cost) {
+                            next_cost = c;
+                        }
+                    }
+                }
+            }
+            if (cost + next_cost < best_cost || (cost + next_cost == best_cost && x == p)) {
+                best = x;
+                best_cost = cost + next_cost;
+            }
+        }
+        if (best != m) {
+            memset(mode + i, best, j - i);
+        }
+    }
+
+    for (i = 0; i < length; i++) {
+        mode[i] = hx_mode_types[(int) mode[i]];
+    }
+
+    if (symbol->debug & ZINT_DEBUG_PRINT) {
         printf("  Mode: %.*s\n", length, mode);
     }
+
+    return 0;
 }
 
 /* Convert input data to binary stream */
-static void calculate_binary(char binary[], const char mode[], unsigned int source[], const int length, const int eci,
-            int *bin_len, const int debug) {
+static void calculate_binary(unsigned char binary[], const char mode[], unsigned int source[], const int length,
+            const int eci, int *bin_len, const int debug) {
     int position = 0;
     int i, count, encoding_value;
     int first_byte, second_byte;
     int third_byte, fourth_byte;
     int glyph;
     int submode;
-    int bp = 0;
+    struct zint_bits bits;
+
+    bits_init(&bits, binary, 0);
 
     if (eci != 0) {
         /* Encoding ECI assignment number, according to Table 5 */
-        bp = bin_append_posn(8, 4, binary, bp); // ECI
+        bits_append(&bits, 8, 4); // ECI
         if (eci <= 127) {
-            bp = bin_append_posn(eci, 8, binary, bp);
+            bits_append(&bits, eci, 8);
         } else if (eci <= 16383) {
-            bp = bin_append_posn(2, 2, binary, bp);
-            bp = bin_append_posn(eci, 14, binary, bp);
+            bits_append(&bits, 2, 2);
+            bits_append(&bits, eci, 14);
         } else {
-            bp = bin_append_posn(6, 3, binary, bp);
-            bp = bin_append_posn(eci, 21, binary, bp);
+            bits_append(&bits, 6, 3);
+            bits_append(&bits, eci, 21);
         }
     }
 
@@ -522,7 +683,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
             case 'n':
                 /* Numeric mode */
                 /* Mode indicator */
-                bp = bin_append_posn(1, 4, binary, bp);
+                bits_append(&bits, 1, 4);
 
                 if (debug & ZINT_DEBUG_PRINT) {
                     printf("Numeric\n");
@@ -550,7 +711,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                         }
                     }
 
-                    bp = bin_append_posn(encoding_value, 10, binary, bp);
+                    bits_append(&bits, encoding_value, 10);
 
                     if (debug & ZINT_DEBUG_PRINT) {
                         printf("0x%3x (%d)", encoding_value, encoding_value);
@@ -562,13 +723,13 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                 /* Mode terminator depends on number of characters in last group (Table 2) */
                 switch (count) {
                     case 1:
-                        bp = bin_append_posn(1021, 10, binary, bp);
+                        bits_append(&bits, 1021, 10);
                         break;
                     case 2:
-                        bp = bin_append_posn(1022, 10, binary, bp);
+                        bits_append(&bits, 1022, 10);
                         break;
                     case 3:
-                        bp = bin_append_posn(1023, 10, binary, bp);
+                        bits_append(&bits, 1023, 10);
                         break;
                 }
 
@@ -580,7 +741,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
             case 't':
                 /* Text mode */
                 /* Mode indicator */
-                bp = bin_append_posn(2, 4, binary, bp);
+                bits_append(&bits, 2, 4);
 
                 if (debug & ZINT_DEBUG_PRINT) {
                     printf("Text\n");
@@ -594,7 +755,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
 
                     if (getsubmode(source[i + position]) != submode) {
                         /* Change submode */
-                        bp = bin_append_posn(62, 6, binary, bp);
+                        bits_append(&bits, 62, 6);
                         submode = getsubmode(source[i + position]);
                         if (debug & ZINT_DEBUG_PRINT) {
                             printf("SWITCH ");
@@ -607,7 +768,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                         encoding_value = lookup_text2(source[i + position]);
                     }
 
-                    bp = bin_append_posn(encoding_value, 6, binary, bp);
+                    bits_append(&bits, encoding_value, 6);
 
                     if (debug & ZINT_DEBUG_PRINT) {
                         printf("%.2x [ASC %.2x] ", encoding_value, source[i + position]);
@@ -616,7 +777,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                 }
 
                 /* Terminator */
-                bp = bin_append_posn(63, 6, binary, bp);
+                bits_append(&bits, 63, 6);
 
                 if (debug & ZINT_DEBUG_PRINT) {
                     printf("\n");
@@ -625,10 +786,10 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
             case 'b':
                 /* Binary Mode */
                 /* Mode indicator */
-                bp = bin_append_posn(3, 4, binary, bp);
+                bits_append(&bits, 3, 4);
 
                 /* Count indicator */
-                bp = bin_append_posn(block_length + double_byte, 13, binary, bp);
+                bits_append(&bits, block_length + double_byte, 13);
 
                 if (debug & ZINT_DEBUG_PRINT) {
                     printf("Binary (length %d)\n", block_length + double_byte);
@@ -639,7 +800,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                 while (i < block_length) {
 
                     /* 8-bit bytes with no conversion */
-                    bp = bin_append_posn(source[i + position], source[i + position] > 0xFF ? 16 : 8, binary, bp);
+                    bits_append(&bits, source[i + position], source[i + position] > 0xFF ? 16 : 8);
 
                     if (debug & ZINT_DEBUG_PRINT) {
                         printf("%d ", source[i + position]);
@@ -656,7 +817,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                 /* Region 1 encoding */
                 /* Mode indicator */
                 if (position == 0 || mode[position - 1] != '2') { /* Unless previous mode Region 2 */
-                    bp = bin_append_posn(4, 4, binary, bp);
+                    bits_append(&bits, 4, 4);
                 }
 
                 if (debug & ZINT_DEBUG_PRINT) {
@@ -688,12 +849,13 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                         printf("%.3x [GB %.4x] ", glyph, source[i + position]);
                     }
 
-                    bp = bin_append_posn(glyph, 12, binary, bp);
+                    bits_append(&bits, glyph, 12);
                     i++;
                 }
 
                 /* Terminator */
-                bp = bin_append_posn(position + block_length == length || mode[position + block_length] != '2' ? 4095 : 4094, 12, binary, bp);
+                bits_append(&bits, position + block_length == length || mode[position + block_length] != '2'
+                        ? 4095 : 4094, 12);
 
                 if (debug & ZINT_DEBUG_PRINT) {
                     printf("(TERM %x)\n", position + block_length == length || mode[position + block_length] != '2' ? 4095 : 4094);
@@ -704,7 +866,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                 /* Region 2 encoding */
                 /* Mode indicator */
                 if (position == 0 || mode[position - 1] != '1') { /* Unless previous mode Region 1 */
-                    bp = bin_append_posn(5, 4, binary, bp);
+                    bits_append(&bits, 5, 4);
                 }
 
                 if (debug & ZINT_DEBUG_PRINT) {
@@ -723,12 +885,13 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                         printf("%.3x [GB %.4x] ", glyph, source[i + position]);
                     }
 
-                    bp = bin_append_posn(glyph, 12, binary, bp);
+                    bits_append(&bits, glyph, 12);
                     i++;
                 }
 
                 /* Terminator */
-                bp = bin_append_posn(position + block_length == length || mode[position + block_length] != '1' ? 4095 : 4094, 12, binary, bp);
+                bits_append(&bits, position + block_length == length || mode[position + block_length] != '1'
+                        ? 4095 : 4094, 12);
 
                 if (debug & ZINT_DEBUG_PRINT) {
                     printf("(TERM %x)\n", position + block_length == length || mode[position + block_length] != '1' ? 4095 : 4094);
@@ -738,7 +901,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
             case 'd':
                 /* Double byte encoding */
                 /* Mode indicator */
-                bp = bin_append_posn(6, 4, binary, bp);
+                bits_append(&bits, 6, 4);
 
                 if (debug & ZINT_DEBUG_PRINT) {
                     printf("Double byte\n");
@@ -760,12 +923,12 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                         printf("%.4x ", glyph);
                     }
 
-                    bp = bin_append_posn(glyph, 15, binary, bp);
+                    bits_append(&bits, glyph, 15);
                     i++;
                 }
 
                 /* Terminator */
-                bp = bin_append_posn(32767, 15, binary, bp);
+                bits_append(&bits, 32767, 15);
                 /* Terminator sequence of length 12 is a mistake
                    - confirmed by Wang Yi */
 
@@ -784,7 +947,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                 while (i < block_length) {
 
                     /* Mode indicator */
-                    bp = bin_append_posn(7, 4, binary, bp);
+                    bits_append(&bits, 7, 4);
 
                     first_byte = (source[i + position] & 0xff00) >> 8;
                     second_byte = source[i + position] & 0xff;
@@ -798,7 +961,7 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
                         printf("%d ", glyph);
                     }
 
-                    bp = bin_append_posn(glyph, 21, binary, bp);
+                    bits_append(&bits, glyph, 21);
                     i += 2;
                 }
 
@@ -814,18 +977,20 @@ static void calculate_binary(char binary[], const char mode[], unsigned int sour
 
     } while (position < length);
 
-    binary[bp] = '\0';
+    *bin_len = bits_flush(&bits);
 
-    if (debug & ZINT_DEBUG_PRINT) printf("Binary (%d): %s\n", bp, binary);
-
-    *bin_len = bp;
+    if (debug & ZINT_DEBUG_PRINT) {
+        printf("Binary (%d): ", *bin_len);
+        bits_print(binary, 0, *bin_len);
+        putchar('\n');
+    }
 }
 
 /* Finder pattern for top left of symbol */
 static void hx_place_finder_top_left(unsigned char *grid, const int size) {
     int xp, yp;
     int x = 0, y = 0;
-    char finder[] = {0x7F, 0x40, 0x5F, 0x50, 0x57, 0x57, 0x57};
+    static const char finder[] = {0x7F, 0x40, 0x5F, 0x50, 0x57, 0x57, 0x57};
 
     for (xp = 0; xp < 7; xp++) {
         for (yp = 0; yp < 7; yp++) {
@@ -841,7 +1006,7 @@ static void hx_place_finder_top_left(unsigned char *grid, const int size) {
 /* Finder pattern for top right and bottom left of symbol */
 static void hx_place_finder(unsigned char *grid, const int size, const int x, const int y) {
     int xp, yp;
-    char finder[] = {0x7F, 0x01, 0x7D, 0x05, 0x75, 0x75, 0x75};
+    static const char finder[] = {0x7F, 0x01, 0x7D, 0x05, 0x75, 0x75, 0x75};
 
     for (xp = 0; xp < 7; xp++) {
         for (yp = 0; yp < 7; yp++) {
@@ -858,7 +1023,7 @@ static void hx_place_finder(unsigned char *grid, const int size, const int x, co
 static void hx_place_finder_bottom_right(unsigned char *grid, const int size) {
     int xp, yp;
     int x = size - 7, y = size - 7;
-    char finder[] = {0x75, 0x75, 0x75, 0x05, 0x7D, 0x01, 0x7F};
+    static const char finder[] = {0x75, 0x75, 0x75, 0x05, 0x7D, 0x01, 0x7F};
 
     for (xp = 0; xp < 7; xp++) {
         for (yp = 0; yp < 7; yp++) {
@@ -1071,11 +1236,9 @@ static void hx_setup_grid(unsigned char *grid, const int size, const int version
 /* Calculate error correction codes */
 static void hx_add_ecc(unsigned char fullstream[], const unsigned char datastream[], const int data_codewords,
             const int version, const int ecc_level) {
-    unsigned char data_block[180];
-    unsigned char ecc_block[36];
     int i, j, block;
-    int input_position = -1;
-    int output_position = -1;
+    int input_position = 0;
+    int output_position = 0;
     int table_d1_pos = ((version - 1) * 36) + ((ecc_level - 1) * 9);
     rs_t rs;
 
@@ -1089,44 +1252,34 @@ static void hx_add_ecc(unsigned char fullstream[], const unsigned char datastrea
         rs_init_code(&rs, ecc_length, 1);
 
         for (block = 0; block < batch_size; block++) {
-            for (j = 0; j < data_length; j++) {
-                input_position++;
-                output_position++;
-                data_block[j] = input_position < data_codewords ? datastream[input_position] : 0;
-                fullstream[output_position] = data_block[j];
+            for (j = 0; j < data_length; j++, input_position++) {
+                fullstream[output_position + j] = input_position < data_codewords ? datastream[input_position] : 0;
             }
 
-            rs_encode(&rs, data_length, data_block, ecc_block);
-
-            for (j = 0; j < ecc_length; j++) {
-                output_position++;
-                fullstream[output_position] = ecc_block[ecc_length - j - 1];
-            }
+            rs_encode_step(&rs, data_length, fullstream + output_position, 1,
+                        fullstream + output_position + data_length, 1);
+            output_position += data_length + ecc_length;
         }
     }
 }
 
-static void hx_set_function_info(unsigned char *grid, const int size, const int version, const int ecc_level,
-            const int bitmask, const int debug) {
-    int i, j;
-    char function_information[34];
-    unsigned char fi_cw[3] = {0};
+/* Form the 34-bit Structural Info as packed bits, including its error correction */
+static void hx_function_info(unsigned char function_information[5], const int version, const int ecc_level,
+            const int bitmask) {
+    int i;
+    unsigned char fi_cw[3];
     unsigned char fi_ecc[4];
-    int bp = 0;
+    struct zint_bits bits;
     rs_t rs;
 
     /* Form function information string */
 
-    bp = bin_append_posn(version + 20, 8, function_information, bp);
-    bp = bin_append_posn(ecc_level - 1, 2, function_information, bp);
-    bp = bin_append_posn(bitmask, 2, function_information, bp);
+    bits_init(&bits, function_information, 0);
+    bits_append(&bits, ((version + 20) << 4) | ((ecc_level - 1) << 2) | bitmask, 12);
+    (void) bits_flush(&bits);
 
     for (i = 0; i < 3; i++) {
-        for (j = 0; j < 4; j++) {
-            if (function_information[(i * 4) + j] == '1') {
-                fi_cw[i] += (0x08 >> j);
-            }
-        }
+        fi_cw[i] = (unsigned char) bits_get(function_information, i * 4, 4);
     }
 
     rs_init_gf(&rs, 0x13);
@@ -1134,38 +1287,43 @@ static void hx_set_function_info(unsigned char *grid, const int size, const int
     rs_encode(&rs, 3, fi_cw, fi_ecc);
 
     for (i = 3; i >= 0; i--) {
-        bp = bin_append_posn(fi_ecc[i], 4, function_information, bp);
+        bits_append(&bits, fi_ecc[i], 4);
     }
 
     /* This alternating filler pattern at end not mentioned in ISO/IEC 20830 (draft 2019-10-10) and does not appear
      * in Figure 1 or the figures in Annex K but does appear in Figure 2 and Figures 4-9 */
-    for (i = 28; i < 34; i++) {
-        if (i & 1) {
-            function_information[i] = '1';
-        } else {
-            function_information[i] = '0';
-        }
-    }
+    bits_append(&bits, 0x15, 6); /* 010101 */
+    (void) bits_flush(&bits);
+}
+
+static void hx_set_function_info(unsigned char *grid, const int size, const int version, const int ecc_level,
+            const int bitmask, const int debug) {
+    int i;
+    unsigned char function_information[5];
+
+    hx_function_info(function_information, version, ecc_level, bitmask);
 
     if (debug & ZINT_DEBUG_PRINT) {
-        printf("Version: %d, ECC: %d, Mask: %d, Structural Info: %.34s\n", version, ecc_level, bitmask, function_information);
+        printf("Version: %d, ECC: %d, Mask: %d, Structural Info: ", version, ecc_level, bitmask);
+        bits_print(function_information, 0, 34);
+        putchar('\n');
     }
 
     /* Add function information to symbol */
     for (i = 0; i < 9; i++) {
-        if (function_information[i] == '1') {
+        if (bits_is_set(function_information, i)) {
             grid[(8 * size) + i] = 0x01;
             grid[((size - 8 - 1) * size) + (size - i - 1)] = 0x01;
         }
-        if (function_information[i + 8] == '1') {
+        if (bits_is_set(function_information, i + 8)) {
             grid[((8 - i) * size) + 8] = 0x01;
             grid[((size - 8 - 1 + i) * size) + (size - 8 - 1)] = 0x01;
         }
-        if (function_information[i + 17] == '1') {
+        if (bits_is_set(function_information, i + 17)) {
             grid[(i * size) + (size - 1 - 8)] = 0x01;
             grid[((size - 1 - i) * size) + 8] = 0x01;
         }
-        if (function_information[i + 25] == '1') {
+        if (bits_is_set(function_information, i + 25)) {
             grid[(8 * size) + (size - 1 - 8 + i)] = 0x01;
             grid[((size - 1 - 8) * size) + (8 - i)] = 0x01;
         }
@@ -1187,193 +1345,197 @@ static void make_picket_fence(const unsigned char fullstream[], unsigned char pi
     }
 }
 
-/* Evaluate a bitmask according to table 9 */
-static int hx_evaluate(const unsigned char *local, const int size) {
-    static const unsigned char h1010111[7] = { 1, 0, 1, 0, 1, 1, 1 };
-    static const unsigned char h1110101[7] = { 1, 1, 1, 0, 1, 0, 1 };
+#define HX_LINE_WORDS   3 /* 64-bit words per row or column of the largest Han Xin Code (189 modules) */
 
-    int x, y, r, block;
-    int result = 0;
-    int state;
-    int a, b, afterCount, beforeCount;
+/* Return number of set bits in `word` */
+static int hx_popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word -= (word >> 1) & 0x5555555555555555;
+    word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return (int) ((word * 0x0101010101010101) >> 56);
+#endif
+}
 
-    /* Test 1: 1:1:1:1:3 or 3:1:1:1:1 ratio pattern in row/column */
-    /* Vertical */
-    for (x = 0; x < size; x++) {
-        for (y = 0; y <= (size - 7); y++) {
-            if (local[y * size + x] && local[(y + 1) * size + x] != local[(y + 5) * size + x] &&
-                    local[(y + 2) * size + x] && !local[(y + 3) * size + x] &&
-                    local[(y + 4) * size + x] && local[(y + 6) * size + x]) {
-                /* Pattern found, check before and after */
-                beforeCount = 0;
-                for (b = (y - 1); b >= (y - 3); b--) {
-                    if (b < 0) { /* Count < edge as whitespace */
-                        beforeCount = 3;
-                        break;
-                    }
-                    if (local[(b * size) + x]) {
-                        break;
-                    }
-                    beforeCount++;
-                }
-                if (beforeCount == 3) {
-                    /* Pattern is preceded by light area 3 modules wide */
-                    result += 50;
-                } else {
-                    afterCount = 0;
-                    for (a = (y + 7); a <= (y + 9); a++) {
-                        if (a >= size) { /* Count > edge as whitespace */
-                            afterCount = 3;
-                            break;
-                        }
-                        if (local[(a * size) + x]) {
-                            break;
-                        }
-                        afterCount++;
-                    }
-                    if (afterCount == 3) {
-                        /* Pattern is followed by light area 3 modules wide */
-                        result += 50;
-                    }
-                }
-                y++; /* Skip to next possible match */
-            }
-        }
+/* In the mask evaluation each row and column of modules is a line of bits, module `i` being bit `i & 63` of word
+   `i >> 6`, with bits past the end clear. Shift line `v` down by `n` (1 to 63), so bit `i` of `out` is bit `i + n`
+   of `v` (clear past the end) */
+static void hx_line_down(const uint64_t *v, const int n, uint64_t *out) {
+    int i;
+    for (i = 0; i < HX_LINE_WORDS - 1; i++) {
+        out[i] = (v[i] >> n) | (v[i + 1] << (64 - n));
     }
+    out[HX_LINE_WORDS - 1] = v[HX_LINE_WORDS - 1] >> n;
+}
 
-    /* Horizontal */
-    for (y = 0; y < size; y++) {
-        r = y * size;
-        for (x = 0; x <= (size - 7); x++) {
-            if (memcmp(local + r + x, h1010111, 7) == 0 || memcmp(local + r + x, h1110101, 7) == 0) {
-                /* Pattern found, check before and after */
-                beforeCount = 0;
-                for (b = (x - 1); b >= (x - 3); b--) {
-                    if (b < 0) { /* Count < edge as whitespace */
-                        beforeCount = 3;
-                        break;
-                    }
-                    if (local[r + b]) {
-                        break;
-                    }
-                    beforeCount++;
-                }
+/* Shift line `v` up by `n` (1 to 63), so bit `i` of `out` is bit `i - n` of `v` (clear before the start) */
+static void hx_line_up(const uint64_t *v, const int n, uint64_t *out) {
+    int i;
+    for (i = HX_LINE_WORDS - 1; i > 0; i--) {
+        out[i] = (v[i] << n) | (v[i - 1] >> (64 - n));
+    }
+    out[0] = v[0] << n;
+}
 
-                if (beforeCount == 3) {
-                    /* Pattern is preceded by light area 3 modules wide */
-                    result += 50;
-                } else {
-                    afterCount = 0;
-                    for (a = (x + 7); a <= (x + 9); a++) {
-                        if (a >= size) { /* Count > edge as whitespace */
-                            afterCount = 3;
-                            break;
-                        }
-                        if (local[r + a]) {
-                            break;
-                        }
-                        afterCount++;
-                    }
-                    if (afterCount == 3) {
-                        /* Pattern is followed by light area 3 modules wide */
-                        result += 50;
-                    }
-                }
-                x++; /* Skip to next possible match */
-            }
+/* Set module `x`, `y` in `rows` and `cols` of bits (see `hx_line_down()`) if `bit` set */
+static void hx_set_module_bits(uint64_t *rows, uint64_t *cols, const int x, const int y, const unsigned int bit) {
+    rows[y * HX_LINE_WORDS + (x >> 6)] |= (uint64_t) (bit & 0x01) << (x & 63);
+    cols[x * HX_LINE_WORDS + (y >> 6)] |= (uint64_t) (bit & 0x01) << (y & 63);
+}
+
+/* Add Structural Info to `rows` and `cols` of bits (see `hx_line_down()`), as `hx_set_function_info()` */
+static void hx_set_function_info_bits(uint64_t *rows, uint64_t *cols, const int size, const int version,
+            const int ecc_level, const int bitmask) {
+    int i;
+    unsigned char function_information[5];
+
+    hx_function_info(function_information, version, ecc_level, bitmask);
+
+    /* Structural Info modules aren't masked so are clear in the unmasked bits */
+    for (i = 0; i < 9; i++) {
+        if (bits_is_set(function_information, i)) {
+            hx_set_module_bits(rows, cols, i, 8, 1);
+            hx_set_module_bits(rows, cols, size - i - 1, size - 8 - 1, 1);
+        }
+        if (bits_is_set(function_information, i + 8)) {
+            hx_set_module_bits(rows, cols, 8, 8 - i, 1);
+            hx_set_module_bits(rows, cols, size - 8 - 1, size - 8 - 1 + i, 1);
+        }
+        if (bits_is_set(function_information, i + 17)) {
+            hx_set_module_bits(rows, cols, size - 1 - 8, i, 1);
+            hx_set_module_bits(rows, cols, 8, size - 1 - i, 1);
         }
+        if (bits_is_set(function_information, i + 25)) {
+            hx_set_module_bits(rows, cols, size - 1 - 8 + i, 8, 1);
+            hx_set_module_bits(rows, cols, 8 - i, size - 1 - 8, 1);
+        }
+    }
+}
+
+/* Penalty of line `v` according to table 9, for the 1:1:1:1:3 or 3:1:1:1:1 ratio pattern with 3 light modules (or
+   the edge) before or after it (Test 1), and for runs of 3 or more modules of the same colour (Test 2). `pairs` has
+   the bits set of the modules that have a next module (all but the last) */
+static int hx_evaluate_line(const uint64_t *v, const uint64_t *pairs) {
+    uint64_t down[10][HX_LINE_WORDS], up[4][HX_LINE_WORDS];
+    uint64_t eq[HX_LINE_WORDS], eq_down[HX_LINE_WORDS], windows_up[HX_LINE_WORDS];
+    uint64_t windows[HX_LINE_WORDS];
+    int n, i;
+    int pattern = 0, block = 0;
+
+    for (n = 1; n <= 9; n++) {
+        hx_line_down(v, n, down[n]);
+    }
+    for (n = 1; n <= 3; n++) {
+        hx_line_up(v, n, up[n]);
+    }
+
+    /* Test 1: 1010111 or 1110101 at each position, i.e. 1?1011? with the 2nd and 6th differing (out of range
+       modules being clear, so light, and a pattern can't match starting at the next position) */
+    for (i = 0; i < HX_LINE_WORDS; i++) {
+        const uint64_t match = v[i] & down[2][i] & ~down[3][i] & down[4][i] & down[6][i] & (down[1][i] ^ down[5][i]);
+        const uint64_t light_before = ~(up[1][i] | up[2][i] | up[3][i]);
+        const uint64_t light_after = ~(down[7][i] | down[8][i] | down[9][i]);
+        pattern += hx_popcount(match & (light_before | light_after));
+    }
+
+    /* Test 2: `eq` bit set if module same as the next. A run of length L >= 3 has L - 2 windows of 3 the same, and
+       scores 4 * L, i.e. 4 for each window plus 8 for the window starting it */
+    for (i = 0; i < HX_LINE_WORDS; i++) {
+        eq[i] = ~(v[i] ^ down[1][i]) & pairs[i];
+    }
+    hx_line_down(eq, 1, eq_down);
+    for (i = 0; i < HX_LINE_WORDS; i++) {
+        windows[i] = eq[i] & eq_down[i];
+    }
+    hx_line_up(windows, 1, windows_up);
+    for (i = 0; i < HX_LINE_WORDS; i++) {
+        block += hx_popcount(windows[i]) + 2 * hx_popcount(windows[i] & ~windows_up[i]);
     }
 
-    /* Test 2: Adjacent modules in row/column in same colour */
+    return 50 * pattern + 4 * block;
+}
+
+/* Evaluate a bitmask according to table 9, given as the `rows` and `cols` of bits of the masked symbol (see
+   `hx_line_down()`), stopping early with the partial penalty once it reaches `bound` */
+static int hx_evaluate(const uint64_t *rows, const uint64_t *cols, const int size, const int bound) {
+    uint64_t pairs[HX_LINE_WORDS];
+    int x, y, i;
+    int result = 0;
+
     /* In AIMD-15 section 5.8.3.2 it is stated... “In Table 9 below, i refers to the row
      * position of the module.” - however i being the length of the run of the
      * same colour (i.e. "block" below) in the same fashion as ISO/IEC 18004
      * makes more sense. -- Confirmed by Wang Yi */
     /* Fixed in ISO/IEC 20830 (draft 2019-10-10) section 5.8.3.2 "In Table 12 below, i refers to the modules with same color." */
 
+    for (i = 0; i < HX_LINE_WORDS; i++) {
+        const int n = size - 1 - 64 * i; /* Modules in this word with a next module */
+        pairs[i] = n >= 64 ? ~((uint64_t) 0) : n > 0 ? ((uint64_t) 1 << n) - 1 : 0;
+    }
+
     /* Vertical */
     for (x = 0; x < size; x++) {
-        block = 0;
-        state = 0;
-        for (y = 0; y < size; y++) {
-            if (local[(y * size) + x] == state) {
-                block++;
-            } else {
-                if (block >= 3) {
-                    result += block * 4;
-                }
-                block = 1;
-                state = local[(y * size) + x];
-            }
-        }
-        if (block >= 3) {
-            result += block * 4;
+        result += hx_evaluate_line(cols + x * HX_LINE_WORDS, pairs);
+        if (result >= bound) {
+            return result;
         }
     }
 
     /* Horizontal */
     for (y = 0; y < size; y++) {
-        r = y * size;
-        block = 0;
-        state = 0;
-        for (x = 0; x < size; x++) {
-            if (local[r + x] == state) {
-                block++;
-            } else {
-                if (block >= 3) {
-                    result += block * 4;
-                }
-                block = 1;
-                state = local[r + x];
-            }
-        }
-        if (block >= 3) {
-            result += block * 4;
+        result += hx_evaluate_line(rows + y * HX_LINE_WORDS, pairs);
+        if (result >= bound) {
+            return result;
         }
     }
 
     return result;
 }
 
-/* Apply the four possible bitmasks for evaluation */
+/* Apply the four possible bitmasks for evaluation. The grid and the masks are held as rows and columns of bits so
+ * that each mask is evaluated a word at a time */
 /* TODO: Haven't been able to replicate (or even get close to) the penalty scores in ISO/IEC 20830
  * (draft 2019-10-10) Annex K examples; however they don't use alternating filler pattern on structural info */
-static void hx_apply_bitmask(unsigned char *grid, const int size, const int version, const int ecc_level,
-            const int user_mask, const int debug) {
+static int hx_apply_bitmask(struct zint_symbol *symbol, unsigned char *grid, const int size, const int version,
+            const int ecc_level, const int user_mask, const int debug) {
     int x, y;
     int i, j, r, k;
     int pattern, penalty[4] = {0};
-    int best_pattern;
-    int bit;
-    int size_squared = size * size;
+    int best_pattern, evaluated = 0;
+    const int lines_size = size * HX_LINE_WORDS; /* Words in the rows (or columns) of the symbol */
+    const uint64_t *best_mask;
 
-#ifndef _MSC_VER
-    unsigned char mask[size_squared];
-    unsigned char local[size_squared];
-#else
-    unsigned char *mask = (unsigned char *) _alloca(size_squared * sizeof(unsigned char));
-    unsigned char *local = (unsigned char *) _alloca(size_squared * sizeof(unsigned char));
-#endif
+    /* Rows then columns of the modules each mask pattern flips */
+    z_work_array(symbol, uint64_t, masks, 4 * 2 * lines_size);
+    z_work_array(symbol, uint64_t, unmasked, 2 * lines_size);
+    z_work_array(symbol, uint64_t, local, 2 * lines_size);
+
+    if (z_work_failed(masks) || z_work_failed(unmasked) || z_work_failed(local)) {
+        return z_work_error(symbol);
+    }
+
+    assert(size <= 64 * HX_LINE_WORDS);
 
-    /* Perform data masking */
-    memset(mask, 0, size_squared);
+    /* Perform data masking (null pattern 00 left clear) */
+    memset(masks, 0, sizeof(uint64_t) * 4 * 2 * lines_size);
+    memset(unmasked, 0, sizeof(uint64_t) * 2 * lines_size);
     for (y = 0; y < size; y++) {
         r = y * size;
         for (x = 0; x < size; x++) {
             k = r + x;
 
+            hx_set_module_bits(unmasked, unmasked + lines_size, x, y, grid[k]);
             if (!(grid[k] & 0xf0)) {
                 j = x + 1;
                 i = y + 1;
-                if (((i + j) & 1) == 0) {
-                    mask[k] |= 0x02;
-                }
-                if (((((i + j) % 3) + (j % 3)) & 1) == 0) {
-                    mask[k] |= 0x04;
-                }
-                if ((((i % j) + (j % i) + (i % 3) + (j % 3)) & 1) == 0) {
-                    mask[k] |= 0x08;
-                }
+                /* Patterns 01, 10 and 11 */
+                hx_set_module_bits(masks + 2 * lines_size, masks + 3 * lines_size, x, y, ((i + j) & 1) == 0);
+                hx_set_module_bits(masks + 4 * lines_size, masks + 5 * lines_size, x, y,
+                            ((((i + j) % 3) + (j % 3)) & 1) == 0);
+                hx_set_module_bits(masks + 6 * lines_size, masks + 7 * lines_size, x, y,
+                            (((i % j) + (j % i) + (i % 3) + (j % 3)) & 1) == 0);
             }
         }
     }
@@ -1381,63 +1543,52 @@ static void hx_apply_bitmask(unsigned char *grid, const int size, const int vers
     if (user_mask) {
         best_pattern = user_mask - 1;
     } else {
-        // apply data masks to grid, result in local
-
-        /* Do null pattern 00 separately first */
-        pattern = 0;
-        for (k = 0; k < size_squared; k++) {
-            local[k] = grid[k] & 0x0f;
-        }
-        /* Set the Structural Info */
-        hx_set_function_info(local, size, version, ecc_level, pattern, 0 /*debug*/);
-
-        /* Evaluate result */
-        penalty[pattern] = hx_evaluate(local, size);
-
+        /* Evaluate each mask applied to the grid along with its Structural Info */
         best_pattern = 0;
-        for (pattern = 1; pattern < 4; pattern++) {
-            bit = 1 << pattern;
-            for (k = 0; k < size_squared; k++) {
-                if (mask[k] & bit) {
-                    local[k] = grid[k] ^ 0x01;
-                } else {
-                    local[k] = grid[k] & 0x0f;
-                }
+        for (pattern = 0; pattern < 4; pattern++) {
+            const uint64_t *const mask_rows = masks + pattern * 2 * lines_size;
+
+            /* Past the time budget keep the best so far (or the null pattern if none evaluated yet) */
+            if (z_over_budget(symbol)) {
+                break;
+            }
+            for (k = 0; k < 2 * lines_size; k++) {
+                local[k] = unmasked[k] ^ mask_rows[k];
             }
-            /* Set the Structural Info */
-            hx_set_function_info(local, size, version, ecc_level, pattern, 0 /*debug*/);
+            hx_set_function_info_bits(local, local + lines_size, size, version, ecc_level, pattern);
 
-            /* Evaluate result */
-            penalty[pattern] = hx_evaluate(local, size);
+            /* Evaluate result, abandoning it once it can't beat the best so far (unless debugging, which prints the
+               full penalties) */
+            penalty[pattern] = hx_evaluate(local, local + lines_size, size,
+                                    pattern && !(debug & ZINT_DEBUG_PRINT) ? penalty[best_pattern] : INT_MAX);
             if (penalty[pattern] < penalty[best_pattern]) {
                 best_pattern = pattern;
             }
+            evaluated++;
         }
     }
 
     if (debug & ZINT_DEBUG_PRINT) {
-        printf("Mask: %d (%s)", best_pattern, user_mask ? "specified" : "automatic");
-        if (!user_mask) {
-            for (pattern = 0; pattern < 4; pattern++) printf(" %d:%d", pattern, penalty[pattern]);
-        }
+        printf("Mask: %d (%s)", best_pattern, user_mask ? "specified" : evaluated < 4 ? "time budget" : "automatic");
+        for (pattern = 0; pattern < evaluated; pattern++) printf(" %d:%d", pattern, penalty[pattern]);
         printf("\n");
     }
 
     /* Apply mask */
     if (best_pattern) { /* If not null mask */
-        if (!user_mask && best_pattern == 3) { /* Reuse last */
-            memcpy(grid, local, size_squared);
-        } else {
-            bit = 1 << best_pattern;
-            for (k = 0; k < size_squared; k++) {
-                if (mask[k] & bit) {
-                    grid[k] ^= 0x01;
-                }
+        best_mask = masks + best_pattern * 2 * lines_size;
+        for (y = 0; y < size; y++) {
+            const uint64_t *const mask_row = best_mask + y * HX_LINE_WORDS;
+            r = y * size;
+            for (x = 0; x < size; x++) {
+                grid[r + x] ^= (unsigned char) ((mask_row[x >> 6] >> (x & 63)) & 0x01);
             }
         }
     }
     /* Set the Structural Info */
     hx_set_function_info(grid, size, version, ecc_level, best_pattern, debug);
+
+    return 0;
 }
 
 /* Han Xin Code - main */
@@ -1449,22 +1600,17 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
     int user_mask;
     int data_codewords = 0, size;
     int size_squared;
+    struct zint_template *templ;
     int codewords;
     int bin_len;
     int eci_length = get_eci_length(symbol->eci, source, length);
 
-#ifndef _MSC_VER
-    unsigned int gbdata[eci_length + 1];
-    char mode[eci_length];
-#else
-    unsigned int *gbdata = (unsigned int *) _alloca((eci_length + 1) * sizeof(unsigned int));
-    char *mode = (char *) _alloca(eci_length);
-    char *binary;
-    unsigned char *datastream;
-    unsigned char *fullstream;
-    unsigned char *picket_fence;
-    unsigned char *grid;
-#endif
+    z_work_array(symbol, unsigned int, gbdata, eci_length + 1);
+    z_work_array(symbol, char, mode, eci_length);
+
+    if (z_work_failed(gbdata) || z_work_failed(mode)) {
+        return z_work_error(symbol);
+    }
 
     /* If ZINT_FULL_MULTIBYTE set use Hanzi mode in DATA_MODE or for non-GB 18030 in UNICODE_MODE */
     full_multibyte = (symbol->option_3 & 0xFF) == ZINT_FULL_MULTIBYTE;
@@ -1477,13 +1623,18 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
         gb18030_cpy(source, &length, gbdata, full_multibyte);
     } else {
         int done = 0;
+        z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_BEGIN, length);
         if (symbol->eci != 29) { /* Unless ECI 29 (GB) */
             /* Try other conversions (ECI 0 defaults to ISO/IEC 8859-1) */
-            int error_number = gb18030_utf8_to_eci(symbol->eci, source, &length, gbdata, full_multibyte);
+            int error_number = gb18030_utf8_to_eci(symbol, symbol->eci, source, &length, gbdata, full_multibyte);
             if (error_number == 0) {
                 done = 1;
+            } else if (error_number == ZINT_ERROR_MEMORY) {
+                z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, -1);
+                return error_number;
             } else if (symbol->eci) {
                 strcpy(symbol->errtxt, "575: Invalid characters in input data");
+                z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, -1);
                 return error_number;
             }
         }
@@ -1491,20 +1642,29 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
             /* Try GB 18030 */
             int error_number = gb18030_utf8(symbol, source, &length, gbdata);
             if (error_number != 0) {
+                z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, -1);
                 return error_number;
             }
         }
+        z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, length);
     }
 
-    hx_define_mode(mode, gbdata, length, symbol->debug);
+    z_trace(symbol, ZINT_PHASE_MODES, ZINT_TRACE_BEGIN, length);
+    if ((symbol->input_mode & FAST_MODE) || z_over_budget(symbol) ? hx_fast_mode(symbol, mode, gbdata, length)
+            : hx_define_mode(symbol, mode, gbdata, length)) {
+        z_trace(symbol, ZINT_PHASE_MODES, ZINT_TRACE_END, -1);
+        return ZINT_ERROR_MEMORY;
+    }
+    z_record_modes(symbol, mode, length);
 
     est_binlen = calculate_binlength(mode, gbdata, length, symbol->eci);
+    z_trace(symbol, ZINT_PHASE_MODES, ZINT_TRACE_END, (est_binlen + 7) / 8);
 
-#ifndef _MSC_VER
-    char binary[est_binlen + 1];
-#else
-    binary = (char *) _alloca((est_binlen + 1));
-#endif
+    z_work_array(symbol, unsigned char, binary, (est_binlen + 7) / 8);
+
+    if (z_work_failed(binary)) {
+        return z_work_error(symbol);
+    }
 
     if ((ecc_level <= 0) || (ecc_level >= 5)) {
         ecc_level = 1;
@@ -1589,26 +1749,19 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
     size = (version * 2) + 21;
     size_squared = size * size;
 
-#ifndef _MSC_VER
-    unsigned char datastream[data_codewords];
-    unsigned char fullstream[hx_total_codewords[version - 1]];
-    unsigned char picket_fence[hx_total_codewords[version - 1]];
-    unsigned char grid[size_squared];
-#else
-    datastream = (unsigned char *) _alloca((data_codewords) * sizeof (unsigned char));
-    fullstream = (unsigned char *) _alloca((hx_total_codewords[version - 1]) * sizeof (unsigned char));
-    picket_fence = (unsigned char *) _alloca((hx_total_codewords[version - 1]) * sizeof (unsigned char));
-    grid = (unsigned char *) _alloca(size_squared * sizeof(unsigned char));
-#endif
-
-    memset(datastream, 0, data_codewords);
+    z_work_array(symbol, unsigned char, datastream, data_codewords);
+    z_work_array(symbol, unsigned char, fullstream, hx_total_codewords[version - 1]);
+    z_work_array(symbol, unsigned char, picket_fence, hx_total_codewords[version - 1]);
+    z_work_array(symbol, unsigned char, grid, size_squared);
 
-    for (i = 0; i < bin_len; i++) {
-        if (binary[i] == '1') {
-            datastream[i >> 3] |= 0x80 >> (i & 0x07);
-        }
+    if (z_work_failed(datastream) || z_work_failed(fullstream) || z_work_failed(picket_fence)
+            || z_work_failed(grid)) {
+        return z_work_error(symbol);
     }
 
+    memcpy(datastream, binary, codewords); /* Last partial byte zero-padded by `bits_flush()` */
+    memset(datastream + codewords, 0, data_codewords - codewords);
+
     if (symbol->debug & ZINT_DEBUG_PRINT) {
         printf("Datastream length: %d\n", data_codewords);
         printf("Datastream:\n");
@@ -1621,29 +1774,45 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, datastream, data_codewords);
 #endif
 
-    hx_setup_grid(grid, size, version);
+    j_max = hx_total_codewords[version - 1] * 8;
+
+    /* Function patterns and data module order depend only on the version, so kept for re-use */
+    if (!(templ = z_template_get(symbol, version, size_squared, j_max))) {
+        strcpy(symbol->errtxt, "547: Insufficient memory for Han Xin template");
+        return ZINT_ERROR_MEMORY;
+    }
+    if (!templ->built) {
+        hx_setup_grid(templ->grid, size, version);
+        j = 0;
+        for (i = 0; i < size_squared && j < j_max; i++) {
+            if (templ->grid[i] == 0x00) {
+                templ->positions[j++] = i;
+            }
+        }
+        templ->positions_len = j;
+        templ->built = 1;
+    }
+    memcpy(grid, templ->grid, size_squared);
 
+    z_trace(symbol, ZINT_PHASE_RS, ZINT_TRACE_BEGIN, data_codewords);
     hx_add_ecc(fullstream, datastream, data_codewords, version, ecc_level);
+    z_trace(symbol, ZINT_PHASE_RS, ZINT_TRACE_END, hx_total_codewords[version - 1]);
 
     make_picket_fence(fullstream, picket_fence, hx_total_codewords[version - 1]);
 
-    /* Populate grid */
-    j = 0;
-    j_max = hx_total_codewords[version - 1] * 8;
-    for (i = 0; i < size_squared; i++) {
-        if (grid[i] == 0x00) {
-            if (j < j_max) {
-                if (picket_fence[(j >> 3)] & (0x80 >> (j & 0x07))) {
-                    grid[i] = 0x01;
-                }
-                j++;
-            } else {
-                break;
-            }
+    /* Populate grid, scattering the bits over the data modules of the template */
+    for (j = 0; j < templ->positions_len; j++) {
+        if (picket_fence[(j >> 3)] & (0x80 >> (j & 0x07))) {
+            grid[templ->positions[j]] = 0x01;
         }
     }
 
-    hx_apply_bitmask(grid, size, version, ecc_level, user_mask, symbol->debug);
+    z_trace(symbol, ZINT_PHASE_MASK, ZINT_TRACE_BEGIN, size_squared);
+    if (hx_apply_bitmask(symbol, grid, size, version, ecc_level, user_mask, symbol->debug)) {
+        z_trace(symbol, ZINT_PHASE_MASK, ZINT_TRACE_END, -1);
+        return ZINT_ERROR_MEMORY;
+    }
+    z_trace(symbol, ZINT_PHASE_MASK, ZINT_TRACE_END, size_squared);
 
     symbol->width = size;
     symbol->rows = size;
@@ -1660,3 +1829,8 @@ INTERNAL int han_xin(struct zint_symbol *symbol, unsigned char source[], int len
 
     return 0;
 }
+
+/* Page in the function information table (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t hx_tables_warm(const int touch) {
+    return z_table_warm(hx_table_d1, sizeof(hx_table_d1), touch);
+}
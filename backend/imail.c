@@ -197,6 +197,32 @@ static const unsigned short int AppxD_IV[130] = {
     5, 74, 22, 101, 128, 58, 118, 48, 108, 38, 98, 93, 23, 83, 13, 73, 3
 };
 
+/* CRC-11 (generator polynomial 0x0F35) of each byte value, MSB first, for bytewise calculation of FCS */
+static const unsigned short crc11_table[256] = {
+    0x000, 0x735, 0x15F, 0x66A, 0x2BE, 0x58B, 0x3E1, 0x4D4, 0x57C, 0x249, 0x423, 0x316,
+    0x7C2, 0x0F7, 0x69D, 0x1A8, 0x5CD, 0x2F8, 0x492, 0x3A7, 0x773, 0x046, 0x62C, 0x119,
+    0x0B1, 0x784, 0x1EE, 0x6DB, 0x20F, 0x53A, 0x350, 0x465, 0x4AF, 0x39A, 0x5F0, 0x2C5,
+    0x611, 0x124, 0x74E, 0x07B, 0x1D3, 0x6E6, 0x08C, 0x7B9, 0x36D, 0x458, 0x232, 0x507,
+    0x162, 0x657, 0x03D, 0x708, 0x3DC, 0x4E9, 0x283, 0x5B6, 0x41E, 0x32B, 0x541, 0x274,
+    0x6A0, 0x195, 0x7FF, 0x0CA, 0x66B, 0x15E, 0x734, 0x001, 0x4D5, 0x3E0, 0x58A, 0x2BF,
+    0x317, 0x422, 0x248, 0x57D, 0x1A9, 0x69C, 0x0F6, 0x7C3, 0x3A6, 0x493, 0x2F9, 0x5CC,
+    0x118, 0x62D, 0x047, 0x772, 0x6DA, 0x1EF, 0x785, 0x0B0, 0x464, 0x351, 0x53B, 0x20E,
+    0x2C4, 0x5F1, 0x39B, 0x4AE, 0x07A, 0x74F, 0x125, 0x610, 0x7B8, 0x08D, 0x6E7, 0x1D2,
+    0x506, 0x233, 0x459, 0x36C, 0x709, 0x03C, 0x656, 0x163, 0x5B7, 0x282, 0x4E8, 0x3DD,
+    0x275, 0x540, 0x32A, 0x41F, 0x0CB, 0x7FE, 0x194, 0x6A1, 0x3E3, 0x4D6, 0x2BC, 0x589,
+    0x15D, 0x668, 0x002, 0x737, 0x69F, 0x1AA, 0x7C0, 0x0F5, 0x421, 0x314, 0x57E, 0x24B,
+    0x62E, 0x11B, 0x771, 0x044, 0x490, 0x3A5, 0x5CF, 0x2FA, 0x352, 0x467, 0x20D, 0x538,
+    0x1EC, 0x6D9, 0x0B3, 0x786, 0x74C, 0x079, 0x613, 0x126, 0x5F2, 0x2C7, 0x4AD, 0x398,
+    0x230, 0x505, 0x36F, 0x45A, 0x08E, 0x7BB, 0x1D1, 0x6E4, 0x281, 0x5B4, 0x3DE, 0x4EB,
+    0x03F, 0x70A, 0x160, 0x655, 0x7FD, 0x0C8, 0x6A2, 0x197, 0x543, 0x276, 0x41C, 0x329,
+    0x588, 0x2BD, 0x4D7, 0x3E2, 0x736, 0x003, 0x669, 0x15C, 0x0F4, 0x7C1, 0x1AB, 0x69E,
+    0x24A, 0x57F, 0x315, 0x420, 0x045, 0x770, 0x11A, 0x62F, 0x2FB, 0x5CE, 0x3A4, 0x491,
+    0x539, 0x20C, 0x466, 0x353, 0x787, 0x0B2, 0x6D8, 0x1ED, 0x127, 0x612, 0x078, 0x74D,
+    0x399, 0x4AC, 0x2C6, 0x5F3, 0x45B, 0x36E, 0x504, 0x231, 0x6E5, 0x1D0, 0x7BA, 0x08F,
+    0x4EA, 0x3DF, 0x5B5, 0x280, 0x654, 0x161, 0x70B, 0x03E, 0x196, 0x6A3, 0x0C9, 0x7FC,
+    0x328, 0x41D, 0x277, 0x542
+};
+
 /***************************************************************************
  ** USPS_MSB_Math_CRC11GenerateFrameCheckSequence
  **
@@ -225,19 +251,10 @@ static unsigned short USPS_MSB_Math_CRC11GenerateFrameCheckSequence(unsigned cha
         FrameCheckSequence &= 0x7FF;
         Data <<= 1;
     }
-    /* Do rest of the bytes */
+    /* Do rest of the bytes a byte at a time */
     for (ByteIndex = 1; ByteIndex < 13; ByteIndex++) {
-        Data = *ByteArrayPtr << 3;
-        ByteArrayPtr++;
-        for (Bit = 0; Bit < 8; Bit++) {
-            if ((FrameCheckSequence ^ Data) & 0x0400) {
-                FrameCheckSequence = (FrameCheckSequence << 1) ^ GeneratorPolynomial;
-            } else {
-                FrameCheckSequence = (FrameCheckSequence << 1);
-            }
-            FrameCheckSequence &= 0x7FF;
-            Data <<= 1;
-        }
+        FrameCheckSequence = ((FrameCheckSequence << 8) & 0x7FF)
+                                ^ crc11_table[((FrameCheckSequence >> 3) ^ *ByteArrayPtr++) & 0xFF];
     }
     return FrameCheckSequence;
 }
@@ -1094,7 +1094,7 @@ static const unsigned short ksc5601_2charset[8227] = {
   0x237e, 0x214d, 0x235c,
 };
 
-static const KSX1001Summary16 ksc5601_uni2indx_page00[70] = {
+static const KSX1001Summary16 ksc5601_uni2indx_page00[80] = {
   /* 0x0000 */
   {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 },
   {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x0000 },
@@ -1117,9 +1117,11 @@ static const KSX1001Summary16 ksc5601_uni2indx_page00[70] = {
   {   96, 0x03fb }, {  105, 0x0000 }, {  105, 0x0000 }, {  105, 0x0000 },
   /* 0x0400 */
   {  105, 0x0002 }, {  106, 0xffff }, {  122, 0xffff }, {  138, 0xffff },
-  {  154, 0xffff }, {  170, 0x0002 },
+  {  154, 0xffff }, {  170, 0x0002 }, {  171, 0x0000 }, {  171, 0x0000 },
+  {  171, 0x0000 }, {  171, 0x0000 }, {  171, 0x0000 }, {  171, 0x0000 },
+  {  171, 0x0000 }, {  171, 0x0000 }, {  171, 0x0000 }, {  171, 0x0000 },
 };
-static const KSX1001Summary16 ksc5601_uni2indx_page20[103] = {
+static const KSX1001Summary16 ksc5601_uni2indx_page20[112] = {
   /* 0x2000 */
   {  171, 0x0000 }, {  171, 0x3320 }, {  176, 0x0063 }, {  180, 0x080d },
   {  184, 0x0000 }, {  184, 0x0000 }, {  184, 0x0000 }, {  184, 0x8010 },
@@ -1152,9 +1154,11 @@ static const KSX1001Summary16 ksc5601_uni2indx_page20[103] = {
   {  441, 0xc9c3 }, {  449, 0x0003 }, {  451, 0x0000 }, {  451, 0x0000 },
   /* 0x2600 */
   {  451, 0xc060 }, {  455, 0x5000 }, {  457, 0x0000 }, {  457, 0x0000 },
-  {  457, 0x0005 }, {  459, 0x0000 }, {  459, 0x37bb },
+  {  457, 0x0005 }, {  459, 0x0000 }, {  459, 0x37bb }, {  470, 0x0000 },
+  {  470, 0x0000 }, {  470, 0x0000 }, {  470, 0x0000 }, {  470, 0x0000 },
+  {  470, 0x0000 }, {  470, 0x0000 }, {  470, 0x0000 }, {  470, 0x0000 },
 };
-static const KSX1001Summary16 ksc5601_uni2indx_page30[62] = {
+static const KSX1001Summary16 ksc5601_uni2indx_page30[64] = {
   /* 0x3000 */
   {  470, 0xff0f }, {  482, 0x003b }, {  487, 0x0000 }, {  487, 0x0000 },
   {  487, 0xfffe }, {  502, 0xffff }, {  518, 0xffff }, {  534, 0xffff },
@@ -1174,9 +1178,9 @@ static const KSX1001Summary16 ksc5601_uni2indx_page30[62] = {
   {  809, 0x0000 }, {  809, 0x0000 }, {  809, 0x0000 }, {  809, 0x0000 },
   {  809, 0x0000 }, {  809, 0x0000 }, {  809, 0x0000 }, {  809, 0x0000 },
   {  809, 0xff1f }, {  822, 0xffff }, {  838, 0xffff }, {  854, 0xffff },
-  {  870, 0x87ff }, {  882, 0x3949 },
+  {  870, 0x87ff }, {  882, 0x3949 }, {  889, 0x0000 }, {  889, 0x0000 },
 };
-static const KSX1001Summary16 ksc5601_uni2indx_page4e[1306] = {
+static const KSX1001Summary16 ksc5601_uni2indx_page4e[1312] = {
   /* 0x4e00 */
   {  889, 0x2f8b }, {  898, 0x4372 }, {  905, 0x2000 }, {  906, 0x0b04 },
   {  910, 0xe82c }, {  917, 0xe340 }, {  923, 0x2800 }, {  925, 0x40c8 },
@@ -1585,9 +1589,10 @@ static const KSX1001Summary16 ksc5601_uni2indx_page4e[1306] = {
   /* 0x9f00 */
   { 5489, 0x4180 }, { 5492, 0x0008 }, { 5493, 0x0001 }, { 5494, 0x0800 },
   { 5495, 0x4c00 }, { 5498, 0x8004 }, { 5500, 0x1482 }, { 5504, 0x0080 },
-  { 5505, 0x2000 }, { 5506, 0x1021 },
+  { 5505, 0x2000 }, { 5506, 0x1021 }, { 5509, 0x0000 }, { 5509, 0x0000 },
+  { 5509, 0x0000 }, { 5509, 0x0000 }, { 5509, 0x0000 }, { 5509, 0x0000 },
 };
-static const KSX1001Summary16 ksc5601_uni2indx_pageac[698] = {
+static const KSX1001Summary16 ksc5601_uni2indx_pageac[704] = {
   /* 0xac00 */
   { 5509, 0x0793 }, { 5516, 0x3eff }, { 5529, 0xb011 }, { 5534, 0x1303 },
   { 5539, 0x2801 }, { 5542, 0x1110 }, { 5545, 0x0000 }, { 5545, 0x0593 },
@@ -1806,41 +1811,133 @@ static const KSX1001Summary16 ksc5601_uni2indx_pageac[698] = {
   /* 0xd700 */
   { 7815, 0x0011 }, { 7817, 0x1302 }, { 7821, 0x2b01 }, { 7826, 0x1130 },
   { 7830, 0x0290 }, { 7833, 0x03d3 }, { 7840, 0x122b }, { 7846, 0x3011 },
-  { 7850, 0x1302 }, { 7854, 0x2b01 },
+  { 7850, 0x1302 }, { 7854, 0x2b01 }, { 7859, 0x0000 }, { 7859, 0x0000 },
+  { 7859, 0x0000 }, { 7859, 0x0000 }, { 7859, 0x0000 }, { 7859, 0x0000 },
 };
-static const KSX1001Summary16 ksc5601_uni2indx_pagef9[17] = {
+static const KSX1001Summary16 ksc5601_uni2indx_pagef9[32] = {
   /* 0xf900 */
   { 7859, 0xffff }, { 7875, 0xffff }, { 7891, 0xffff }, { 7907, 0xffff },
   { 7923, 0xffff }, { 7939, 0xffff }, { 7955, 0xffff }, { 7971, 0xffff },
   { 7987, 0xffff }, { 8003, 0xffff }, { 8019, 0xffff }, { 8035, 0xffff },
   { 8051, 0xffff }, { 8067, 0xffff }, { 8083, 0xffff }, { 8099, 0xffff },
   /* 0xfa00 */
-  { 8115, 0x0fff },
+  { 8115, 0x0fff }, { 8127, 0x0000 }, { 8127, 0x0000 }, { 8127, 0x0000 },
+  { 8127, 0x0000 }, { 8127, 0x0000 }, { 8127, 0x0000 }, { 8127, 0x0000 },
+  { 8127, 0x0000 }, { 8127, 0x0000 }, { 8127, 0x0000 }, { 8127, 0x0000 },
+  { 8127, 0x0000 }, { 8127, 0x0000 }, { 8127, 0x0000 }, { 8127, 0x0000 },
 };
-static const KSX1001Summary16 ksc5601_uni2indx_pageff[15] = {
+static const KSX1001Summary16 ksc5601_uni2indx_pageff[16] = {
   /* 0xff00 */
   { 8127, 0xfffe }, { 8142, 0xffff }, { 8158, 0xffff }, { 8174, 0xffff },
   { 8190, 0xffff }, { 8206, 0x7fff }, { 8221, 0x0000 }, { 8221, 0x0000 },
   { 8221, 0x0000 }, { 8221, 0x0000 }, { 8221, 0x0000 }, { 8221, 0x0000 },
-  { 8221, 0x0000 }, { 8221, 0x0000 }, { 8221, 0x006f },
+  { 8221, 0x0000 }, { 8221, 0x0000 }, { 8221, 0x006f }, { 8227, 0x0000 },
+};
+
+/* ZINT: Direct index by Unicode high byte to pages of 16 summaries (page arrays padded to a multiple of
+ * 16 entries), replacing range checks */
+static const KSX1001Summary16 *const ksc5601_uni2indx_pages[256] = {
+  /* 0x00 */ ksc5601_uni2indx_page00 + 0x000, ksc5601_uni2indx_page00 + 0x010,
+  /* 0x02 */ ksc5601_uni2indx_page00 + 0x020, ksc5601_uni2indx_page00 + 0x030,
+  /* 0x04 */ ksc5601_uni2indx_page00 + 0x040,
+  /* 0x05 */ NULL, NULL, NULL,
+  /* 0x08 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x10 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x18 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x20 */ ksc5601_uni2indx_page20 + 0x000, ksc5601_uni2indx_page20 + 0x010,
+  /* 0x22 */ ksc5601_uni2indx_page20 + 0x020, ksc5601_uni2indx_page20 + 0x030,
+  /* 0x24 */ ksc5601_uni2indx_page20 + 0x040, ksc5601_uni2indx_page20 + 0x050,
+  /* 0x26 */ ksc5601_uni2indx_page20 + 0x060,
+  /* 0x27 */ NULL,
+  /* 0x28 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x30 */ ksc5601_uni2indx_page30 + 0x000, ksc5601_uni2indx_page30 + 0x010,
+  /* 0x32 */ ksc5601_uni2indx_page30 + 0x020, ksc5601_uni2indx_page30 + 0x030,
+  /* 0x34 */ NULL, NULL, NULL, NULL,
+  /* 0x38 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x40 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x48 */ NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x4e */ ksc5601_uni2indx_page4e + 0x000, ksc5601_uni2indx_page4e + 0x010,
+  /* 0x50 */ ksc5601_uni2indx_page4e + 0x020, ksc5601_uni2indx_page4e + 0x030,
+  /* 0x52 */ ksc5601_uni2indx_page4e + 0x040, ksc5601_uni2indx_page4e + 0x050,
+  /* 0x54 */ ksc5601_uni2indx_page4e + 0x060, ksc5601_uni2indx_page4e + 0x070,
+  /* 0x56 */ ksc5601_uni2indx_page4e + 0x080, ksc5601_uni2indx_page4e + 0x090,
+  /* 0x58 */ ksc5601_uni2indx_page4e + 0x0a0, ksc5601_uni2indx_page4e + 0x0b0,
+  /* 0x5a */ ksc5601_uni2indx_page4e + 0x0c0, ksc5601_uni2indx_page4e + 0x0d0,
+  /* 0x5c */ ksc5601_uni2indx_page4e + 0x0e0, ksc5601_uni2indx_page4e + 0x0f0,
+  /* 0x5e */ ksc5601_uni2indx_page4e + 0x100, ksc5601_uni2indx_page4e + 0x110,
+  /* 0x60 */ ksc5601_uni2indx_page4e + 0x120, ksc5601_uni2indx_page4e + 0x130,
+  /* 0x62 */ ksc5601_uni2indx_page4e + 0x140, ksc5601_uni2indx_page4e + 0x150,
+  /* 0x64 */ ksc5601_uni2indx_page4e + 0x160, ksc5601_uni2indx_page4e + 0x170,
+  /* 0x66 */ ksc5601_uni2indx_page4e + 0x180, ksc5601_uni2indx_page4e + 0x190,
+  /* 0x68 */ ksc5601_uni2indx_page4e + 0x1a0, ksc5601_uni2indx_page4e + 0x1b0,
+  /* 0x6a */ ksc5601_uni2indx_page4e + 0x1c0, ksc5601_uni2indx_page4e + 0x1d0,
+  /* 0x6c */ ksc5601_uni2indx_page4e + 0x1e0, ksc5601_uni2indx_page4e + 0x1f0,
+  /* 0x6e */ ksc5601_uni2indx_page4e + 0x200, ksc5601_uni2indx_page4e + 0x210,
+  /* 0x70 */ ksc5601_uni2indx_page4e + 0x220, ksc5601_uni2indx_page4e + 0x230,
+  /* 0x72 */ ksc5601_uni2indx_page4e + 0x240, ksc5601_uni2indx_page4e + 0x250,
+  /* 0x74 */ ksc5601_uni2indx_page4e + 0x260, ksc5601_uni2indx_page4e + 0x270,
+  /* 0x76 */ ksc5601_uni2indx_page4e + 0x280, ksc5601_uni2indx_page4e + 0x290,
+  /* 0x78 */ ksc5601_uni2indx_page4e + 0x2a0, ksc5601_uni2indx_page4e + 0x2b0,
+  /* 0x7a */ ksc5601_uni2indx_page4e + 0x2c0, ksc5601_uni2indx_page4e + 0x2d0,
+  /* 0x7c */ ksc5601_uni2indx_page4e + 0x2e0, ksc5601_uni2indx_page4e + 0x2f0,
+  /* 0x7e */ ksc5601_uni2indx_page4e + 0x300, ksc5601_uni2indx_page4e + 0x310,
+  /* 0x80 */ ksc5601_uni2indx_page4e + 0x320, ksc5601_uni2indx_page4e + 0x330,
+  /* 0x82 */ ksc5601_uni2indx_page4e + 0x340, ksc5601_uni2indx_page4e + 0x350,
+  /* 0x84 */ ksc5601_uni2indx_page4e + 0x360, ksc5601_uni2indx_page4e + 0x370,
+  /* 0x86 */ ksc5601_uni2indx_page4e + 0x380, ksc5601_uni2indx_page4e + 0x390,
+  /* 0x88 */ ksc5601_uni2indx_page4e + 0x3a0, ksc5601_uni2indx_page4e + 0x3b0,
+  /* 0x8a */ ksc5601_uni2indx_page4e + 0x3c0, ksc5601_uni2indx_page4e + 0x3d0,
+  /* 0x8c */ ksc5601_uni2indx_page4e + 0x3e0, ksc5601_uni2indx_page4e + 0x3f0,
+  /* 0x8e */ ksc5601_uni2indx_page4e + 0x400, ksc5601_uni2indx_page4e + 0x410,
+  /* 0x90 */ ksc5601_uni2indx_page4e + 0x420, ksc5601_uni2indx_page4e + 0x430,
+  /* 0x92 */ ksc5601_uni2indx_page4e + 0x440, ksc5601_uni2indx_page4e + 0x450,
+  /* 0x94 */ ksc5601_uni2indx_page4e + 0x460, ksc5601_uni2indx_page4e + 0x470,
+  /* 0x96 */ ksc5601_uni2indx_page4e + 0x480, ksc5601_uni2indx_page4e + 0x490,
+  /* 0x98 */ ksc5601_uni2indx_page4e + 0x4a0, ksc5601_uni2indx_page4e + 0x4b0,
+  /* 0x9a */ ksc5601_uni2indx_page4e + 0x4c0, ksc5601_uni2indx_page4e + 0x4d0,
+  /* 0x9c */ ksc5601_uni2indx_page4e + 0x4e0, ksc5601_uni2indx_page4e + 0x4f0,
+  /* 0x9e */ ksc5601_uni2indx_page4e + 0x500, ksc5601_uni2indx_page4e + 0x510,
+  /* 0xa0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xa8 */ NULL, NULL, NULL, NULL,
+  /* 0xac */ ksc5601_uni2indx_pageac + 0x000, ksc5601_uni2indx_pageac + 0x010,
+  /* 0xae */ ksc5601_uni2indx_pageac + 0x020, ksc5601_uni2indx_pageac + 0x030,
+  /* 0xb0 */ ksc5601_uni2indx_pageac + 0x040, ksc5601_uni2indx_pageac + 0x050,
+  /* 0xb2 */ ksc5601_uni2indx_pageac + 0x060, ksc5601_uni2indx_pageac + 0x070,
+  /* 0xb4 */ ksc5601_uni2indx_pageac + 0x080, ksc5601_uni2indx_pageac + 0x090,
+  /* 0xb6 */ ksc5601_uni2indx_pageac + 0x0a0, ksc5601_uni2indx_pageac + 0x0b0,
+  /* 0xb8 */ ksc5601_uni2indx_pageac + 0x0c0, ksc5601_uni2indx_pageac + 0x0d0,
+  /* 0xba */ ksc5601_uni2indx_pageac + 0x0e0, ksc5601_uni2indx_pageac + 0x0f0,
+  /* 0xbc */ ksc5601_uni2indx_pageac + 0x100, ksc5601_uni2indx_pageac + 0x110,
+  /* 0xbe */ ksc5601_uni2indx_pageac + 0x120, ksc5601_uni2indx_pageac + 0x130,
+  /* 0xc0 */ ksc5601_uni2indx_pageac + 0x140, ksc5601_uni2indx_pageac + 0x150,
+  /* 0xc2 */ ksc5601_uni2indx_pageac + 0x160, ksc5601_uni2indx_pageac + 0x170,
+  /* 0xc4 */ ksc5601_uni2indx_pageac + 0x180, ksc5601_uni2indx_pageac + 0x190,
+  /* 0xc6 */ ksc5601_uni2indx_pageac + 0x1a0, ksc5601_uni2indx_pageac + 0x1b0,
+  /* 0xc8 */ ksc5601_uni2indx_pageac + 0x1c0, ksc5601_uni2indx_pageac + 0x1d0,
+  /* 0xca */ ksc5601_uni2indx_pageac + 0x1e0, ksc5601_uni2indx_pageac + 0x1f0,
+  /* 0xcc */ ksc5601_uni2indx_pageac + 0x200, ksc5601_uni2indx_pageac + 0x210,
+  /* 0xce */ ksc5601_uni2indx_pageac + 0x220, ksc5601_uni2indx_pageac + 0x230,
+  /* 0xd0 */ ksc5601_uni2indx_pageac + 0x240, ksc5601_uni2indx_pageac + 0x250,
+  /* 0xd2 */ ksc5601_uni2indx_pageac + 0x260, ksc5601_uni2indx_pageac + 0x270,
+  /* 0xd4 */ ksc5601_uni2indx_pageac + 0x280, ksc5601_uni2indx_pageac + 0x290,
+  /* 0xd6 */ ksc5601_uni2indx_pageac + 0x2a0, ksc5601_uni2indx_pageac + 0x2b0,
+  /* 0xd8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf8 */ NULL,
+  /* 0xf9 */ ksc5601_uni2indx_pagef9 + 0x000, ksc5601_uni2indx_pagef9 + 0x010,
+  /* 0xfb */ NULL, NULL, NULL, NULL,
+  /* 0xff */ ksc5601_uni2indx_pageff + 0x000,
 };
 
 static int ksx1001_wctomb_zint(unsigned int *r, const unsigned int wc) {
     const KSX1001Summary16 *summary = NULL;
-    if (wc < 0x0460) {
-        summary = &ksc5601_uni2indx_page00[(wc>>4)];
-    } else if (wc >= 0x2000 && wc < 0x2670) {
-        summary = &ksc5601_uni2indx_page20[(wc>>4)-0x200];
-    } else if (wc >= 0x3000 && wc < 0x33e0) {
-        summary = &ksc5601_uni2indx_page30[(wc>>4)-0x300];
-    } else if (wc >= 0x4e00 && wc < 0x9fa0) {
-        summary = &ksc5601_uni2indx_page4e[(wc>>4)-0x4e0];
-    } else if (wc >= 0xac00 && wc < 0xd7a0) {
-        summary = &ksc5601_uni2indx_pageac[(wc>>4)-0xac0];
-    } else if (wc >= 0xf900 && wc < 0xfa10) {
-        summary = &ksc5601_uni2indx_pagef9[(wc>>4)-0xf90];
-    } else if (wc >= 0xff00 && wc < 0xfff0) {
-        summary = &ksc5601_uni2indx_pageff[(wc>>4)-0xff0];
+    if (wc < 0x10000) {
+        const KSX1001Summary16 *page = ksc5601_uni2indx_pages[wc >> 8];
+        if (page) {
+            summary = &page[(wc >> 4) & 0x0f];
+        }
     }
     if (summary) {
         unsigned short used = summary->used;
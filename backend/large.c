@@ -52,6 +52,18 @@
 #include "common.h"
 #include "large.h"
 
+/* Use native 128-bit arithmetic where available, falling back to the portable 64-bit versions otherwise */
+#if defined(__SIZEOF_INT128__)
+#define LARGE_HAVE_INT128
+__extension__ typedef unsigned __int128 large_uint128; /* `__extension__` to avoid pedantic warning */
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#define LARGE_HAVE_UMUL128
+#if _MSC_VER >= 1920 /* _udiv128() only available from Visual Studio 2019 */
+#define LARGE_HAVE_UDIV128
+#endif
+#endif
+
 #define MASK32  0xFFFFFFFF
 
 /* Convert decimal string `s` of (at most) length `length` to 64-bit and place in 128-bit `t` */
@@ -111,6 +123,17 @@ INTERNAL void large_sub_u64(large_int *t, const uint64_t s) {
  *      p11 + k10
  */
 INTERNAL void large_mul_u64(large_int *t, const uint64_t s) {
+#if defined(LARGE_HAVE_INT128)
+    large_uint128 p = (large_uint128) t->lo * s;
+
+    t->hi = (uint64_t) (p >> 64) + t->hi * s;
+    t->lo = (uint64_t) p;
+#elif defined(LARGE_HAVE_UMUL128)
+    uint64_t phi;
+
+    t->lo = _umul128(t->lo, s, &phi);
+    t->hi = phi + t->hi * s;
+#else
     uint64_t thi = t->hi;
     uint64_t tlo0 = t->lo & MASK32;
     uint64_t tlo1 = t->lo >> 32;
@@ -129,10 +152,18 @@ INTERNAL void large_mul_u64(large_int *t, const uint64_t s) {
 
     t->lo = (tmp << 32) + p00; /* (p01 + p10 + k00) << 32 + p00 (note any carry from unmasked p01 shifted out) */
     t->hi = (s1 * tlo1) + k10 + (tmp >> 32) + thi * s; /* p11 + k10 + k01 + thi * s */
+#endif
 }
 
+#if !(defined(LARGE_HAVE_INT128) || defined(LARGE_HAVE_UDIV128)) || defined(ZINT_TEST)
 /* Count leading zeroes. See Hickman `r128__clz64()` */
 STATIC_UNLESS_ZINT_TEST int clz_u64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return x ? __builtin_clzll(x) : 64;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    return _BitScanReverse64(&idx, x) ? 63 - (int) idx : 64;
+#else
    uint64_t n = 64, y;
    y = x >> 32; if (y) { n -= 32; x = y; }
    y = x >> 16; if (y) { n -= 16; x = y; }
@@ -141,12 +172,29 @@ STATIC_UNLESS_ZINT_TEST int clz_u64(uint64_t x) {
    y = x >>  2; if (y) { n -=  2; x = y; }
    y = x >>  1; if (y) { n -=  1; x = y; }
    return (int) (n - x);
+#endif
 }
+#endif
 
 /* Divide 128-bit dividend `t` by 64-bit divisor `v`
  * See Jacob `divmod128by128/64()` and Warren Section 9–2 (divmu64.c.txt)
  * Note digits are 32-bit parts */
 INTERNAL uint64_t large_div_u64(large_int *t, uint64_t v) {
+#if defined(LARGE_HAVE_INT128)
+    large_uint128 n = ((large_uint128) t->hi << 64) | t->lo;
+    large_uint128 q = n / v;
+
+    t->lo = (uint64_t) q;
+    t->hi = (uint64_t) (q >> 64);
+    return (uint64_t) (n - q * v);
+#elif defined(LARGE_HAVE_UDIV128)
+    uint64_t r;
+    uint64_t qhi = t->hi / v; /* `_udiv128()` requires high part of dividend < divisor */
+
+    t->lo = _udiv128(t->hi % v, t->lo, v, &r);
+    t->hi = qhi;
+    return r;
+#else
     const uint64_t b = 0x100000000; /* Number base (2**32) */
     uint64_t qhi = 0; /* High digit of returned quotient */
 
@@ -234,6 +282,7 @@ INTERNAL uint64_t large_div_u64(large_int *t, uint64_t v) {
 
     /* Unnormalize remainder */
     return ((rnhilo1 << 32) + tnlo0 - (qhat0 * v)) >> norm_shift;
+#endif
 }
 
 /* Unset a bit (zero-based) */
@@ -35,36 +35,76 @@
 #include <limits.h>
 #ifdef _MSC_VER
 #include <malloc.h>
+#include "ms_stdint.h"
+#else
+#include <stdint.h>
+#endif
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define ZINT_HAVE_MMAP
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ZINT_HAVE_MMAP
 #endif
 #include "common.h"
 #include "eci.h"
+#include "filemem.h"
 #include "gs1.h"
+#include "library.h"
+#include "output.h"
 #include "zfiletypes.h"
 
+#define STRUCTAPP_MAX   26 /* Most symbols in a Structured Append sequence (Aztec Code) */
+
 #define TECHNETIUM  "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%"
 
 /* It's assumed that int is at least 32 bits, the following will compile-time fail if not
  * https://stackoverflow.com/a/1980056/664741 */
 typedef int static_assert_int_at_least_32bits[CHAR_BIT != 8 || sizeof(int) < 4 ? -1 : 1];
 
+/* A symbol and its library-private state, allocated together by `ZBarcode_Create_Allocator()` */
+struct symbol_block {
+    struct zint_symbol symbol;
+    struct zint_internal internal;
+};
+
 struct zint_symbol *ZBarcode_Create() {
+    return ZBarcode_Create_Allocator(NULL);
+}
+
+/* As `ZBarcode_Create()`, except that all memory of the symbol (itself, its outputs and working buffers, and
+   anything created from it) is allocated by `allocator`, which is copied. Its functions must all be given, or all
+   NULL for `malloc()`, `realloc()` and `free()`. Returns NULL on failure */
+struct zint_symbol *ZBarcode_Create_Allocator(const struct zint_allocator *allocator) {
+    struct symbol_block *block;
     struct zint_symbol *symbol;
 
-    symbol = (struct zint_symbol *) malloc(sizeof(*symbol));
-    if (!symbol) return NULL;
+    if (allocator && ((allocator->malloc_fn == NULL) != (allocator->free_fn == NULL)
+                        || (allocator->malloc_fn == NULL) != (allocator->realloc_fn == NULL))) {
+        return NULL;
+    }
+    block = (struct symbol_block *) z_malloc(allocator, sizeof(*block));
+    if (!block) return NULL;
 
-    memset(symbol, 0, sizeof(*symbol));
+    memset(block, 0, sizeof(*block));
+    symbol = &block->symbol;
+    symbol->internal = &block->internal;
+    if (allocator) {
+        symbol->internal->allocator = *allocator;
+    }
 
     symbol->symbology = BARCODE_CODE128;
     strcpy(symbol->fgcolour, "000000");
     symbol->fgcolor = &symbol->fgcolour[0];
     strcpy(symbol->bgcolour, "ffffff");
     symbol->bgcolor = &symbol->bgcolour[0];
-#ifdef NO_PNG
-    strcpy(symbol->outfile, "out.gif");
-#else
+    symbol->fgcolour_rgba = 0x000000FF;
+    symbol->bgcolour_rgba = 0xFFFFFFFF;
     strcpy(symbol->outfile, "out.png");
-#endif
     symbol->scale = 1.0f;
     symbol->option_1 = -1;
     symbol->show_hrt = 1; // Show human readable text
@@ -81,48 +121,63 @@ struct zint_symbol *ZBarcode_Create() {
 }
 
 INTERNAL void vector_free(struct zint_symbol *symbol); /* Free vector structures */
+INTERNAL void raster_release_bitmap(struct zint_symbol *symbol); /* Free or unlend bitmap & alphamap */
+INTERNAL void raster_free_scratch(struct zint_symbol *symbol); /* Free raster working buffers */
+
+/* Static table warmers for `ZBarcode_Init()` */
+INTERNAL size_t rs_tables_warm(const int touch);
+INTERNAL size_t eci_tables_warm(const int touch);
+INTERNAL size_t sjis_tables_warm(const int touch);
+INTERNAL size_t gb2312_tables_warm(const int touch);
+INTERNAL size_t gb18030_tables_warm(const int touch);
+INTERNAL size_t aztec_tables_warm(const int touch);
+INTERNAL size_t pdf417_tables_warm(const int touch);
+INTERNAL size_t c49_tables_warm(const int touch);
+INTERNAL size_t hx_tables_warm(const int touch);
+INTERNAL size_t raster_fonts_warm(const int touch);
 
 void ZBarcode_Clear(struct zint_symbol *symbol) {
-    int i, j;
+    int i;
 
     if (!symbol) return;
 
-    for (i = 0; i < symbol->rows; i++) {
-        for (j = 0; j < symbol->width; j++) {
-            unset_module(symbol, i, j);
-        }
+    /* Whole rows (which also covers Ultracode's byte-per-module colours), but only those used */
+    for (i = 0; i < symbol->rows && i < 200; i++) {
+        memset(symbol->internal->encoded_data[i], 0, sizeof(symbol->internal->encoded_data[0]));
     }
     symbol->rows = 0;
     symbol->width = 0;
     memset(symbol->text, 0, sizeof(symbol->text));
     symbol->errtxt[0] = '\0';
-    if (symbol->bitmap != NULL) {
-        free(symbol->bitmap);
-        symbol->bitmap = NULL;
-    }
-    if (symbol->alphamap != NULL) {
-        free(symbol->alphamap);
-        symbol->alphamap = NULL;
-    }
+    symbol->trace_record_count = 0;
+    raster_release_bitmap(symbol); /* Raster working buffers are kept for re-use */
     symbol->bitmap_width = 0;
     symbol->bitmap_height = 0;
+    symbol->memfile = NULL; /* Its buffer is kept for re-use by the next print */
+    symbol->memfile_size = 0;
 
     // If there is a rendered version, ensure its memory is released
     vector_free(symbol);
 }
 
 void ZBarcode_Delete(struct zint_symbol *symbol) {
+    struct zint_allocator allocator;
+
     if (!symbol) return;
 
-    if (symbol->bitmap != NULL)
-        free(symbol->bitmap);
-    if (symbol->alphamap != NULL)
-        free(symbol->alphamap);
+    raster_release_bitmap(symbol);
+    raster_free_scratch(symbol);
+    z_work_free(symbol);
+    z_template_free(symbol);
+    z_free(z_allocator(symbol), symbol->internal->trace_records);
+    if (symbol->internal->memfile_buf != NULL)
+        z_free(z_allocator(symbol), symbol->internal->memfile_buf);
 
     // If there is a rendered version, ensure its memory is released
     vector_free(symbol);
 
-    free(symbol);
+    allocator = symbol->internal->allocator;
+    z_free(&allocator, symbol); /* Along with its `internal`, see `struct symbol_block` */
 }
 
 INTERNAL int eanx(struct zint_symbol *symbol, unsigned char source[], int length); /* EAN system barcodes */
@@ -189,10 +244,158 @@ INTERNAL int ultracode(struct zint_symbol *symbol, unsigned char source[], int l
 INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length); /* rMQR */
 INTERNAL int dpd_parcel(struct zint_symbol *symbol, unsigned char source[], int length); /* DPD Code */
 
-INTERNAL int plot_raster(struct zint_symbol *symbol, int rotate_angle, int file_type); /* Plot to PNG/BMP/PCX */
-INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_type); /* Plot to EPS/EMF/SVG */
+/* Stands in for the encoders of sources left out of the build (see ZINT_SYMBOLOGIES in "CMakeLists.txt"), their
+   symbologies then being unsupported and failing as invalid options (see `check_settings()`) */
+static int excluded_encode(struct zint_symbol *symbol, unsigned char source[], int length) {
+    (void)source; (void)length;
+    strcpy(symbol->errtxt, "708: Symbology not included in this build");
+    return ZINT_ERROR_INVALID_OPTION;
+}
+
+#ifdef ZINT_NO_CODE
+#define c39 excluded_encode
+#define pharmazentral excluded_encode
+#define ec39 excluded_encode
+#define c93 excluded_encode
+#define code_11 excluded_encode
+#define channel_code excluded_encode
+#define vin excluded_encode
+#define hibc_39 excluded_encode
+#else
+#define hibc_39 hibc
+#endif
+#ifdef ZINT_NO_CODE128
+#define code_128 excluded_encode
+#define ean_128 excluded_encode
+#define ean_14 excluded_encode
+#define nve_18 excluded_encode
+#define dpd_parcel excluded_encode
+#define hibc_128 excluded_encode
+#else
+#define hibc_128 hibc
+#endif
+#ifdef ZINT_NO_2OF5
+#define matrix_two_of_five excluded_encode
+#define industrial_two_of_five excluded_encode
+#define iata_two_of_five excluded_encode
+#define interleaved_two_of_five excluded_encode
+#define logic_two_of_five excluded_encode
+#define itf14 excluded_encode
+#define dpleit excluded_encode
+#define dpident excluded_encode
+#endif
+#ifdef ZINT_NO_UPCEAN
+#define eanx excluded_encode
+#endif
+#ifdef ZINT_NO_TELEPEN
+#define telepen excluded_encode
+#define telepen_num excluded_encode
+#endif
+#ifdef ZINT_NO_MEDICAL
+#define codabar excluded_encode
+#define pharma_one excluded_encode
+#define pharma_two excluded_encode
+#define code32 excluded_encode
+#endif
+#ifdef ZINT_NO_PLESSEY
+#define msi_handle excluded_encode
+#define plessey excluded_encode
+#endif
+#ifdef ZINT_NO_RSS
+#define rss14 excluded_encode
+#define rsslimited excluded_encode
+#define rssexpanded excluded_encode
+#endif
+#ifdef ZINT_NO_POSTAL
+#define flattermarken excluded_encode
+#define fim excluded_encode
+#define post_plot excluded_encode
+#define planet_plot excluded_encode
+#define royal_plot excluded_encode
+#define kix_code excluded_encode
+#define daft_code excluded_encode
+#define korea_post excluded_encode
+#define japan_post excluded_encode
+#endif
+#ifdef ZINT_NO_AUSPOST
+#define australia_post excluded_encode
+#endif
+#ifdef ZINT_NO_IMAIL
+#define imail excluded_encode
+#endif
+#ifdef ZINT_NO_MAILMARK
+#define mailmark excluded_encode
+#endif
+#ifdef ZINT_NO_CODE16K
+#define code16k excluded_encode
+#endif
+#ifdef ZINT_NO_CODABLOCK
+#define codablock excluded_encode
+#define hibc_blockf excluded_encode
+#else
+#define hibc_blockf hibc
+#endif
+#ifdef ZINT_NO_DMATRIX
+#define dmatrix excluded_encode
+#define hibc_dm excluded_encode
+#else
+#define hibc_dm hibc
+#endif
+#ifdef ZINT_NO_PDF417
+#define pdf417enc excluded_encode
+#define micro_pdf417 excluded_encode
+#define hibc_pdf excluded_encode
+#define hibc_micpdf excluded_encode
+#else
+#define hibc_pdf hibc
+#define hibc_micpdf hibc
+#endif
+#ifdef ZINT_NO_QR
+#define qr_code excluded_encode
+#define microqr excluded_encode
+#define upnqr excluded_encode
+#define rmqr excluded_encode
+#define hibc_qr excluded_encode
+#else
+#define hibc_qr hibc
+#endif
+#ifdef ZINT_NO_MAXICODE
+#define maxicode excluded_encode
+#endif
+#ifdef ZINT_NO_COMPOSITE
+#define composite excluded_encode
+#endif
+#ifdef ZINT_NO_AZTEC
+#define aztec excluded_encode
+#define aztec_runes excluded_encode
+#define hibc_aztec excluded_encode
+#else
+#define hibc_aztec hibc
+#endif
+#ifdef ZINT_NO_CODE49
+#define code_49 excluded_encode
+#endif
+#ifdef ZINT_NO_CODE1
+#define code_one excluded_encode
+#endif
+#ifdef ZINT_NO_GRIDMTX
+#define grid_matrix excluded_encode
+#endif
+#ifdef ZINT_NO_HANXIN
+#define han_xin excluded_encode
+#endif
+#ifdef ZINT_NO_DOTCODE
+#define dotcode excluded_encode
+#endif
+#ifdef ZINT_NO_ULTRA
+#define ultracode excluded_encode
+#endif
+#if defined(ZINT_NO_CODE) && defined(ZINT_NO_CODE128) && defined(ZINT_NO_CODABLOCK) && defined(ZINT_NO_DMATRIX) \
+        && defined(ZINT_NO_PDF417) && defined(ZINT_NO_QR) && defined(ZINT_NO_AZTEC)
+#define ZINT_NO_HIBC /* No HIBC variants left */
+#endif
 
-STATIC_UNLESS_ZINT_TEST int error_tag(char error_string[100], int error_number) {
+INTERNAL int error_tag(char error_string[100], int error_number) {
 
     if (error_number != 0) {
         const char *fmt = error_number >= ZINT_ERROR ? "Error %.93s" : "Warning %.91s"; /* Truncate if too long */
@@ -206,21 +409,17 @@ STATIC_UNLESS_ZINT_TEST int error_tag(char error_string[100], int error_number)
 }
 
 /* Output a hexadecimal representation of the rendered symbol */
-static int dump_plot(struct zint_symbol *symbol) {
-    FILE *f;
+INTERNAL int dump_plot(struct zint_symbol *symbol) {
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     int i, r;
-    char hex[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8',
+    static const char hex[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8',
         '9', 'A', 'B', 'C', 'D', 'E', 'F'};
     int space = 0;
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        f = stdout;
-    } else {
-        f = fopen(symbol->outfile, "w");
-        if (!f) {
-            strcpy(symbol->errtxt, "201: Could not open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!fm_open(fmp, symbol, "w")) {
+        strcpy(symbol->errtxt, "201: Could not open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
     for (r = 0; r < symbol->rows; r++) {
@@ -237,33 +436,33 @@ static int dump_plot(struct zint_symbol *symbol) {
                 }
             }
             if (((i + 1) % 4) == 0) {
-                fputc(hex[byt], f);
+                fm_putc(hex[byt], fmp);
                 space++;
                 byt = 0;
             }
             if (space == 2 && i + 1 < symbol->width) {
-                fputc(' ', f);
+                fm_putc(' ', fmp);
                 space = 0;
             }
         }
 
         if ((symbol->width % 4) != 0) {
             byt = byt << (4 - (symbol->width % 4));
-            fputc(hex[byt], f);
+            fm_putc(hex[byt], fmp);
         }
-        fputs("\n", f);
+        fm_puts("\n", fmp);
         space = 0;
     }
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(f);
-    } else {
-        fclose(f);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "247: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
     }
 
     return 0;
 }
 
+#ifndef ZINT_NO_HIBC
 /* Process health industry bar code data */
 static int hibc(struct zint_symbol *symbol, unsigned char source[], int length) {
     int i;
@@ -324,16 +523,20 @@ static int hibc(struct zint_symbol *symbol, unsigned char source[], int length)
     switch (symbol->symbology) {
         case BARCODE_HIBC_128:
             error_number = code_128(symbol, (unsigned char *) to_process, length);
-            ustrcpy(symbol->text, "*");
-            ustrcat(symbol->text, to_process);
-            ustrcat(symbol->text, "*");
+            if (z_hrt(symbol)) {
+                ustrcpy(symbol->text, "*");
+                ustrcat(symbol->text, to_process);
+                ustrcat(symbol->text, "*");
+            }
             break;
         case BARCODE_HIBC_39:
             symbol->option_2 = 0;
             error_number = c39(symbol, (unsigned char *) to_process, length);
-            ustrcpy(symbol->text, "*");
-            ustrcat(symbol->text, to_process);
-            ustrcat(symbol->text, "*");
+            if (z_hrt(symbol)) {
+                ustrcpy(symbol->text, "*");
+                ustrcat(symbol->text, to_process);
+                ustrcat(symbol->text, "*");
+            }
             break;
         case BARCODE_HIBC_DM:
             error_number = dmatrix(symbol, (unsigned char *) to_process, length);
@@ -357,6 +560,7 @@ static int hibc(struct zint_symbol *symbol, unsigned char source[], int length)
 
     return error_number;
 }
+#endif /* ZINT_NO_HIBC */
 
 static void check_row_heights(struct zint_symbol *symbol) {
     /* Check that rows with undefined heights are never less than 5x  */
@@ -389,578 +593,318 @@ static void check_row_heights(struct zint_symbol *symbol) {
     }
 }
 
-static int check_force_gs1(const int symbology) {
-    /* Returns 1 if symbology MUST have GS1 data */
-
-    int result = is_composite(symbology);
-
-    switch (symbology) {
-        case BARCODE_GS1_128:
-        case BARCODE_EAN14:
-        case BARCODE_NVE18:
-        case BARCODE_DBAR_EXP:
-        case BARCODE_DBAR_EXPSTK:
-            result = 1;
-            break;
-    }
-
-    return result;
-}
-
-static int gs1_compliant(const int symbology) {
-    /* Returns 1 if symbology supports GS1 data */
-
-    int result = check_force_gs1(symbology);
-
-    switch (symbology) {
-        case BARCODE_CODE16K:
-        case BARCODE_AZTEC:
-        case BARCODE_DATAMATRIX:
-        case BARCODE_CODEONE:
-        case BARCODE_CODE49:
-        case BARCODE_QRCODE:
-        case BARCODE_DOTCODE:
-        case BARCODE_RMQR:
-        case BARCODE_ULTRA:
-            result = 1;
-            break;
-    }
-
-    return result;
-}
-
-static int is_dotty(const int symbology) {
-    /* Returns 1 if symbology is a matrix design renderable as dots */
-
-    int result = 0;
-
-    switch (symbology) {
-        /* Note MAXICODE and ULTRA absent */
-        case BARCODE_QRCODE:
-        case BARCODE_DATAMATRIX:
-        case BARCODE_MICROQR:
-        case BARCODE_HIBC_DM:
-        case BARCODE_AZTEC:
-        case BARCODE_HIBC_QR:
-        case BARCODE_HIBC_AZTEC:
-        case BARCODE_AZRUNE:
-        case BARCODE_CODEONE:
-        case BARCODE_GRIDMATRIX:
-        case BARCODE_HANXIN:
-        case BARCODE_DOTCODE:
-        case BARCODE_UPNQR:
-        case BARCODE_RMQR:
-            result = 1;
-            break;
-    }
-
-    return result;
-}
-
-static int is_fixed_ratio(const int symbology) {
-    /* Returns 1 if symbology has fixed aspect ratio (matrix design) */
-
-    int result = 0;
-
-    if (is_dotty(symbology)) {
-        return 1;
-    }
-
-    switch (symbology) {
-        case BARCODE_MAXICODE:
-        case BARCODE_ULTRA:
-            result = 1;
-            break;
-    }
-
-    return result;
-}
-
-static int is_linear(const int symbology) {
-    /* Returns 1 if symbology is linear (1 dimensional) */
-
-    int result = 0;
-    switch (symbology) {
-        case BARCODE_CODE11:
-        case BARCODE_C25STANDARD:
-        case BARCODE_C25INTER:
-        case BARCODE_C25IATA:
-        case BARCODE_C25LOGIC:
-        case BARCODE_C25IND:
-        case BARCODE_CODE39:
-        case BARCODE_EXCODE39:
-        case BARCODE_EANX:
-        case BARCODE_EANX_CHK:
-        case BARCODE_GS1_128:
-        case BARCODE_CODABAR:
-        case BARCODE_CODE128:
-        case BARCODE_DPLEIT:
-        case BARCODE_DPIDENT:
-        case BARCODE_CODE93:
-        case BARCODE_FLAT:
-        case BARCODE_DBAR_OMN:
-        case BARCODE_DBAR_LTD:
-        case BARCODE_DBAR_EXP:
-        case BARCODE_TELEPEN:
-        case BARCODE_UPCA:
-        case BARCODE_UPCA_CHK:
-        case BARCODE_UPCE:
-        case BARCODE_UPCE_CHK:
-        case BARCODE_MSI_PLESSEY:
-        case BARCODE_FIM:
-        case BARCODE_LOGMARS:
-        case BARCODE_PHARMA:
-        case BARCODE_PZN:
-        case BARCODE_CODE128B:
-        case BARCODE_ISBNX:
-        case BARCODE_EAN14:
-        case BARCODE_NVE18:
-        case BARCODE_KOREAPOST:
-        case BARCODE_USPS_IMAIL:
-        case BARCODE_PLESSEY:
-        case BARCODE_TELEPEN_NUM:
-        case BARCODE_ITF14:
-        case BARCODE_HIBC_128:
-        case BARCODE_HIBC_39:
-        case BARCODE_CODE32:
-        case BARCODE_EANX_CC:
-        case BARCODE_GS1_128_CC:
-        case BARCODE_DBAR_OMN_CC:
-        case BARCODE_DBAR_LTD_CC:
-        case BARCODE_DBAR_EXP_CC:
-        case BARCODE_UPCA_CC:
-        case BARCODE_UPCE_CC:
-        case BARCODE_CHANNEL:
-        case BARCODE_VIN:
-        case BARCODE_DPD:
-            result = 1;
-            break;
-    }
-
-    return result;
-}
-
-static int supports_eci(const int symbology) {
-    /* Returns 1 if symbology can encode the ECI character */
-
-    int result = 0;
-
-    switch (symbology) {
-        case BARCODE_AZTEC:
-        case BARCODE_DATAMATRIX:
-        case BARCODE_MAXICODE:
-        case BARCODE_MICROPDF417:
-        case BARCODE_PDF417:
-        case BARCODE_PDF417COMP:
-        case BARCODE_QRCODE:
-        case BARCODE_DOTCODE:
-        case BARCODE_CODEONE:
-        case BARCODE_GRIDMATRIX:
-        case BARCODE_HANXIN:
-        case BARCODE_ULTRA:
-            result = 1;
-            break;
-    }
-
-    return result;
+/* Internal symbology descriptor flags, above the ZINT_CAP_XXX capability flags */
+#define SYM_CAPS            0xFFFF /* Mask of the ZINT_CAP_XXX flags */
+#define SYM_LINEAR          0x10000 /* Linear (1 dimensional), default height 50 */
+#define SYM_FORCE_GS1       0x20000 /* Must have GS1 data */
+#define SYM_FULL_CHARSET    0x40000 /* "Elite" standards with support for specific character sets (no ECI
+                                       conversion of input) */
+#define SYM_CONST_INPUT     0x80000 /* Encoder neither modifies its input nor needs it NUL-terminated, so may be
+                                       passed the caller's data directly */
+#define SYM_ECI_SEGS        0x100000 /* Encoder handles data split into ECI segments (`internal->eci_segs`) */
+
+/* Per-symbology descriptor, indexed by symbology ID */
+struct symbology_desc {
+    int (*encode)(struct zint_symbol *symbol, unsigned char source[], int length); /* NULL if ID not supported */
+    unsigned int flags; /* ZINT_CAP_XXX and SYM_XXX */
+    unsigned char remap; /* For IDs not supported, legacy (tbarcode) symbology mapped to (0 if none) */
+    const char *remap_errtxt; /* Warning if remapped (error if WARN_FAIL_ALL), else error (NULL if none) */
+};
+
+static const struct symbology_desc symbologies[146] = {
+    /*  0*/ { NULL, 0, 0, NULL },
+    /*  1*/ { code_11, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* CODE11 */
+    /*  2*/ { matrix_two_of_five, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* C25STANDARD */
+    /*  3*/ { interleaved_two_of_five, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* C25INTER */
+    /*  4*/ { iata_two_of_five, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* C25IATA */
+    /*  5*/ { NULL, 0, BARCODE_C25STANDARD, NULL },
+    /*  6*/ { logic_two_of_five, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* C25LOGIC */
+    /*  7*/ { industrial_two_of_five, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* C25IND */
+    /*  8*/ { c39, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* CODE39 */
+    /*  9*/ { ec39, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* EXCODE39 */
+    /* 10*/ { NULL, 0, BARCODE_EANX, NULL },
+    /* 11*/ { NULL, 0, BARCODE_EANX, NULL },
+    /* 12*/ { NULL, 0, BARCODE_EANX, NULL },
+    /* 13*/ { eanx, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE | ZINT_CAP_EXTENDABLE, 0, NULL }, /* EANX */
+    /* 14*/ { eanx, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE | ZINT_CAP_EXTENDABLE, 0, NULL }, /* EANX_CHK */
+    /* 15*/ { NULL, 0, BARCODE_EANX, NULL },
+    /* 16*/ { ean_128, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_STACKABLE
+                | ZINT_CAP_GS1, 0, NULL }, /* GS1_128 */
+    /* 17*/ { NULL, 0, BARCODE_UPCA, NULL },
+    /* 18*/ { codabar, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* CODABAR */
+    /* 19*/ { NULL, 0, BARCODE_CODABAR, "207: Codabar 18 not supported" },
+    /* 20*/ { code_128, SYM_CONST_INPUT | SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE
+                | ZINT_CAP_READER_INIT, 0, NULL }, /* CODE128 */
+    /* 21*/ { dpleit, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* DPLEIT */
+    /* 22*/ { dpident, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* DPIDENT */
+    /* 23*/ { code16k, SYM_CONST_INPUT | ZINT_CAP_STACKABLE | ZINT_CAP_GS1
+                | ZINT_CAP_READER_INIT, 0, NULL }, /* CODE16K */
+    /* 24*/ { code_49, ZINT_CAP_STACKABLE | ZINT_CAP_GS1, 0, NULL }, /* CODE49 */
+    /* 25*/ { c93, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* CODE93 */
+    /* 26*/ { NULL, 0, BARCODE_UPCA, NULL },
+    /* 27*/ { NULL, 0, 0, "208: UPCD1 not supported" },
+    /* 28*/ { flattermarken, SYM_LINEAR | ZINT_CAP_STACKABLE, 0, NULL }, /* FLAT */
+    /* 29*/ { rss14, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* DBAR_OMN */
+    /* 30*/ { rsslimited, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* DBAR_LTD */
+    /* 31*/ { rssexpanded, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_STACKABLE
+                | ZINT_CAP_GS1, 0, NULL }, /* DBAR_EXP */
+    /* 32*/ { telepen, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* TELEPEN */
+    /* 33*/ { NULL, 0, BARCODE_GS1_128, NULL },
+    /* 34*/ { eanx, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE | ZINT_CAP_EXTENDABLE, 0, NULL }, /* UPCA */
+    /* 35*/ { eanx, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE | ZINT_CAP_EXTENDABLE, 0, NULL }, /* UPCA_CHK */
+    /* 36*/ { NULL, 0, BARCODE_UPCA, NULL },
+    /* 37*/ { eanx, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE | ZINT_CAP_EXTENDABLE, 0, NULL }, /* UPCE */
+    /* 38*/ { eanx, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE | ZINT_CAP_EXTENDABLE, 0, NULL }, /* UPCE_CHK */
+    /* 39*/ { NULL, 0, 0, NULL },
+    /* 40*/ { post_plot, 0, 0, NULL }, /* POSTNET */
+    /* 41*/ { NULL, 0, BARCODE_POSTNET, NULL },
+    /* 42*/ { NULL, 0, BARCODE_POSTNET, NULL },
+    /* 43*/ { NULL, 0, BARCODE_POSTNET, NULL },
+    /* 44*/ { NULL, 0, BARCODE_POSTNET, NULL },
+    /* 45*/ { NULL, 0, BARCODE_POSTNET, NULL },
+    /* 46*/ { NULL, 0, BARCODE_PLESSEY, NULL },
+    /* 47*/ { msi_handle, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* MSI_PLESSEY */
+    /* 48*/ { NULL, 0, BARCODE_NVE18, NULL },
+    /* 49*/ { fim, SYM_LINEAR | ZINT_CAP_STACKABLE, 0, NULL }, /* FIM */
+    /* 50*/ { c39, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* LOGMARS */
+    /* 51*/ { pharma_one, SYM_LINEAR | ZINT_CAP_STACKABLE, 0, NULL }, /* PHARMA */
+    /* 52*/ { pharmazentral, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* PZN */
+    /* 53*/ { pharma_two, 0, 0, NULL }, /* PHARMA_TWO */
+    /* 54*/ { NULL, 0, BARCODE_CODE128, "210: General Parcel Code not supported" },
+    /* 55*/ { pdf417enc, ZINT_CAP_ECI | ZINT_CAP_READER_INIT, 0, NULL }, /* PDF417 */
+    /* 56*/ { pdf417enc, ZINT_CAP_ECI | ZINT_CAP_READER_INIT, 0, NULL }, /* PDF417COMP */
+    /* 57*/ { maxicode, SYM_CONST_INPUT | ZINT_CAP_ECI | ZINT_CAP_FIXED_RATIO | ZINT_CAP_STRUCTAPP, 0,
+                NULL }, /* MAXICODE */
+    /* 58*/ { qr_code, SYM_CONST_INPUT | SYM_FULL_CHARSET | SYM_ECI_SEGS | ZINT_CAP_ECI | ZINT_CAP_GS1 | ZINT_CAP_DOTTY
+                | ZINT_CAP_FIXED_RATIO | ZINT_CAP_FULL_MULTIBYTE | ZINT_CAP_MASK | ZINT_CAP_STRUCTAPP, 0,
+                NULL }, /* QRCODE */
+    /* 59*/ { NULL, 0, BARCODE_CODE128, NULL },
+    /* 60*/ { code_128, SYM_CONST_INPUT | SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE
+                | ZINT_CAP_READER_INIT, 0, NULL }, /* CODE128B */
+    /* 61*/ { NULL, 0, BARCODE_CODE128, NULL },
+    /* 62*/ { NULL, 0, BARCODE_CODE93, NULL },
+    /* 63*/ { australia_post, 0, 0, NULL }, /* AUSPOST */
+    /* 64*/ { NULL, 0, BARCODE_AUSPOST, NULL },
+    /* 65*/ { NULL, 0, BARCODE_AUSPOST, NULL },
+    /* 66*/ { australia_post, 0, 0, NULL }, /* AUSREPLY */
+    /* 67*/ { australia_post, 0, 0, NULL }, /* AUSROUTE */
+    /* 68*/ { australia_post, 0, 0, NULL }, /* AUSREDIRECT */
+    /* 69*/ { eanx, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE | ZINT_CAP_EXTENDABLE, 0, NULL }, /* ISBNX */
+    /* 70*/ { royal_plot, 0, 0, NULL }, /* RM4SCC */
+    /* 71*/ { dmatrix, SYM_CONST_INPUT | ZINT_CAP_ECI | ZINT_CAP_GS1 | ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO
+                | ZINT_CAP_READER_INIT | ZINT_CAP_STRUCTAPP, 0, NULL }, /* DATAMATRIX */
+    /* 72*/ { ean_14, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_STACKABLE
+                | ZINT_CAP_GS1, 0, NULL }, /* EAN14 */
+    /* 73*/ { vin, SYM_LINEAR | ZINT_CAP_HRT, 0, NULL }, /* VIN */
+    /* 74*/ { codablock, ZINT_CAP_STACKABLE | ZINT_CAP_READER_INIT, 0, NULL }, /* CODABLOCKF */
+    /* 75*/ { nve_18, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_STACKABLE
+                | ZINT_CAP_GS1, 0, NULL }, /* NVE18 */
+    /* 76*/ { japan_post, 0, 0, NULL }, /* JAPANPOST */
+    /* 77*/ { korea_post, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* KOREAPOST */
+    /* 78*/ { NULL, 0, BARCODE_DBAR_OMN, NULL },
+    /* 79*/ { rss14, 0, 0, NULL }, /* DBAR_STK */
+    /* 80*/ { rss14, 0, 0, NULL }, /* DBAR_OMNSTK */
+    /* 81*/ { rssexpanded, SYM_FORCE_GS1 | ZINT_CAP_GS1, 0, NULL }, /* DBAR_EXPSTK */
+    /* 82*/ { planet_plot, 0, 0, NULL }, /* PLANET */
+    /* 83*/ { NULL, 0, BARCODE_PLANET, NULL },
+    /* 84*/ { micro_pdf417, ZINT_CAP_ECI | ZINT_CAP_READER_INIT, 0, NULL }, /* MICROPDF417 */
+    /* 85*/ { imail, SYM_LINEAR, 0, NULL }, /* USPS_IMAIL */
+    /* 86*/ { plessey, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* PLESSEY */
+    /* 87*/ { telepen_num, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* TELEPEN_NUM */
+    /* 88*/ { NULL, 0, BARCODE_GS1_128, NULL },
+    /* 89*/ { itf14, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* ITF14 */
+    /* 90*/ { kix_code, 0, 0, NULL }, /* KIX */
+    /* 91*/ { NULL, 0, BARCODE_CODE128, "212: Symbology out of range" },
+    /* 92*/ { aztec, SYM_CONST_INPUT | ZINT_CAP_ECI | ZINT_CAP_GS1 | ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO
+                | ZINT_CAP_READER_INIT | ZINT_CAP_STRUCTAPP, 0, NULL }, /* AZTEC */
+    /* 93*/ { daft_code, 0, 0, NULL }, /* DAFT */
+    /* 94*/ { NULL, 0, BARCODE_CODE128, "213: Symbology out of range" },
+    /* 95*/ { NULL, 0, BARCODE_CODE128, "213: Symbology out of range" },
+    /* 96*/ { dpd_parcel, SYM_LINEAR | ZINT_CAP_HRT, 0, NULL }, /* DPD */
+    /* 97*/ { microqr, SYM_CONST_INPUT | SYM_FULL_CHARSET | ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO
+                | ZINT_CAP_FULL_MULTIBYTE | ZINT_CAP_MASK, 0, NULL }, /* MICROQR */
+    /* 98*/ { hibc_128, SYM_LINEAR | ZINT_CAP_HRT, 0, NULL }, /* HIBC_128 */
+    /* 99*/ { hibc_39, SYM_LINEAR | ZINT_CAP_HRT, 0, NULL }, /* HIBC_39 */
+    /*100*/ { NULL, 0, BARCODE_HIBC_128, NULL },
+    /*101*/ { NULL, 0, BARCODE_HIBC_39, NULL },
+    /*102*/ { hibc_dm, ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO, 0, NULL }, /* HIBC_DM */
+    /*103*/ { NULL, 0, BARCODE_HIBC_DM, NULL },
+    /*104*/ { hibc_qr, ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO, 0, NULL }, /* HIBC_QR */
+    /*105*/ { NULL, 0, BARCODE_HIBC_QR, NULL },
+    /*106*/ { hibc_pdf, 0, 0, NULL }, /* HIBC_PDF */
+    /*107*/ { NULL, 0, BARCODE_HIBC_PDF, NULL },
+    /*108*/ { hibc_micpdf, 0, 0, NULL }, /* HIBC_MICPDF */
+    /*109*/ { NULL, 0, BARCODE_HIBC_MICPDF, NULL },
+    /*110*/ { hibc_blockf, ZINT_CAP_STACKABLE, 0, NULL }, /* HIBC_BLOCKF */
+    /*111*/ { NULL, 0, BARCODE_HIBC_BLOCKF, NULL },
+    /*112*/ { hibc_aztec, ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO, 0, NULL }, /* HIBC_AZTEC */
+    /*113*/ { NULL, 0, BARCODE_CODE128, "214: Symbology out of range" },
+    /*114*/ { NULL, 0, BARCODE_CODE128, "214: Symbology out of range" },
+    /*115*/ { dotcode, SYM_CONST_INPUT | ZINT_CAP_ECI | ZINT_CAP_GS1 | ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO
+                | ZINT_CAP_READER_INIT | ZINT_CAP_MASK, 0, NULL }, /* DOTCODE */
+    /*116*/ { han_xin, SYM_CONST_INPUT | SYM_FULL_CHARSET | ZINT_CAP_ECI | ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO
+                | ZINT_CAP_FULL_MULTIBYTE | ZINT_CAP_MASK, 0, NULL }, /* HANXIN */
+    /*117*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*118*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*119*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*120*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*121*/ { mailmark, 0, 0, NULL }, /* MAILMARK */
+    /*122*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*123*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*124*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*125*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*126*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*127*/ { NULL, 0, BARCODE_CODE128, "215: Symbology out of range" },
+    /*128*/ { aztec_runes, ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO, 0, NULL }, /* AZRUNE */
+    /*129*/ { code32, SYM_LINEAR | ZINT_CAP_HRT | ZINT_CAP_STACKABLE, 0, NULL }, /* CODE32 */
+    /*130*/ { composite, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_EXTENDABLE | ZINT_CAP_COMPOSITE
+                | ZINT_CAP_GS1, 0, NULL }, /* EANX_CC */
+    /*131*/ { composite, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_COMPOSITE
+                | ZINT_CAP_GS1, 0, NULL }, /* GS1_128_CC */
+    /*132*/ { composite, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_COMPOSITE
+                | ZINT_CAP_GS1, 0, NULL }, /* DBAR_OMN_CC */
+    /*133*/ { composite, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_COMPOSITE
+                | ZINT_CAP_GS1, 0, NULL }, /* DBAR_LTD_CC */
+    /*134*/ { composite, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_COMPOSITE
+                | ZINT_CAP_GS1, 0, NULL }, /* DBAR_EXP_CC */
+    /*135*/ { composite, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_EXTENDABLE | ZINT_CAP_COMPOSITE
+                | ZINT_CAP_GS1, 0, NULL }, /* UPCA_CC */
+    /*136*/ { composite, SYM_LINEAR | SYM_FORCE_GS1 | ZINT_CAP_HRT | ZINT_CAP_EXTENDABLE | ZINT_CAP_COMPOSITE
+                | ZINT_CAP_GS1, 0, NULL }, /* UPCE_CC */
+    /*137*/ { composite, SYM_FORCE_GS1 | ZINT_CAP_COMPOSITE | ZINT_CAP_GS1, 0, NULL }, /* DBAR_STK_CC */
+    /*138*/ { composite, SYM_FORCE_GS1 | ZINT_CAP_COMPOSITE | ZINT_CAP_GS1, 0, NULL }, /* DBAR_OMNSTK_CC */
+    /*139*/ { composite, SYM_FORCE_GS1 | ZINT_CAP_COMPOSITE | ZINT_CAP_GS1, 0, NULL }, /* DBAR_EXPSTK_CC */
+    /*140*/ { channel_code, SYM_LINEAR | ZINT_CAP_HRT, 0, NULL }, /* CHANNEL */
+    /*141*/ { code_one, ZINT_CAP_ECI | ZINT_CAP_GS1 | ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO, 0, NULL }, /* CODEONE */
+    /*142*/ { grid_matrix, SYM_CONST_INPUT | SYM_FULL_CHARSET | ZINT_CAP_ECI | ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO
+                | ZINT_CAP_READER_INIT | ZINT_CAP_FULL_MULTIBYTE, 0, NULL }, /* GRIDMATRIX */
+    /*143*/ { upnqr, SYM_CONST_INPUT | SYM_FULL_CHARSET | ZINT_CAP_DOTTY
+                | ZINT_CAP_FIXED_RATIO, 0, NULL }, /* UPNQR */
+    /*144*/ { ultracode, SYM_CONST_INPUT | ZINT_CAP_ECI | ZINT_CAP_GS1 | ZINT_CAP_FIXED_RATIO
+                | ZINT_CAP_READER_INIT, 0, NULL }, /* ULTRA */
+    /*145*/ { rmqr, SYM_CONST_INPUT | SYM_FULL_CHARSET | ZINT_CAP_GS1 | ZINT_CAP_DOTTY | ZINT_CAP_FIXED_RATIO
+                | ZINT_CAP_FULL_MULTIBYTE, 0, NULL }, /* RMQR */
+};
+
+/* Return the descriptor flags of `symbology`, 0 if not supported */
+INTERNAL unsigned int symbology_flags(const int symbology) {
+    return symbology >= 0 && symbology <= 145 ? symbologies[symbology].flags : 0;
 }
 
-static int has_hrt(const int symbology) {
-    /* Returns 1 if symbology supports HRT */
-
-    if (is_fixed_ratio(symbology)) {
+unsigned int ZBarcode_Cap(int symbol_id, unsigned int cap_flag) {
+    /* Unsupported IDs (including those left out of the build) have no flags */
+    if (!ZBarcode_ValidID(symbol_id)) {
         return 0;
     }
-
-    switch (symbology) { /* These don't support HRT */
-        case BARCODE_CODE16K:
-        case BARCODE_CODE49:
-        case BARCODE_FLAT:
-        case BARCODE_POSTNET:
-        case BARCODE_FIM:
-        case BARCODE_PHARMA:
-        case BARCODE_PHARMA_TWO:
-        case BARCODE_PDF417:
-        case BARCODE_PDF417COMP:
-        case BARCODE_AUSPOST:
-        case BARCODE_AUSREPLY:
-        case BARCODE_AUSROUTE:
-        case BARCODE_AUSREDIRECT:
-        case BARCODE_RM4SCC:
-        case BARCODE_CODABLOCKF:
-        case BARCODE_JAPANPOST:
-        case BARCODE_DBAR_STK:
-        case BARCODE_DBAR_OMNSTK:
-        case BARCODE_DBAR_EXPSTK:
-        case BARCODE_PLANET:
-        case BARCODE_MICROPDF417:
-        case BARCODE_USPS_IMAIL:
-        case BARCODE_KIX:
-        case BARCODE_DAFT:
-        case BARCODE_HIBC_PDF:
-        case BARCODE_HIBC_MICPDF:
-        case BARCODE_HIBC_BLOCKF:
-        case BARCODE_MAILMARK:
-        case BARCODE_DBAR_STK_CC:
-        case BARCODE_DBAR_OMNSTK_CC:
-        case BARCODE_DBAR_EXPSTK_CC:
-            return 0;
-            break;
-    }
-
-    return 1;
+    return symbology_flags(symbol_id) & cap_flag & SYM_CAPS;
 }
 
-unsigned int ZBarcode_Cap(int symbol_id, unsigned int cap_flag) {
-    unsigned int result = 0;
+/* Set the executor used to run the parallel work of `symbol` (Structured Append encoding, PNG_PARALLEL deflating,
+   RASTER_PARALLEL drawing), `context` being passed to it, or NULL to reset to the built-in one. `run_fn` must call
+   `task_fn(arg, index)` for each `index` from 0 to `count - 1`, using up to `max_threads` threads, and return 0 once
+   all are done, or return non-zero without calling any to have them run on the calling thread. The executor is
+   kept by the symbol (and given to the symbols of `ZBarcode_Encode_Structapp()`), so `context` must stay valid
+   until it is reset or the symbol deleted. Like any setting it mustn't be changed while the symbol is in use */
+int ZBarcode_SetExecutor(struct zint_symbol *symbol, int (*run_fn)(void *context,
+            void (*task_fn)(void *arg, int index), void *arg, int count, int max_threads), void *context) {
 
-    if (!ZBarcode_ValidID(symbol_id)) {
-        return 0;
-    }
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
 
-    if ((cap_flag & ZINT_CAP_HRT) && has_hrt(symbol_id)) {
-        result |= ZINT_CAP_HRT;
-    }
-    if ((cap_flag & ZINT_CAP_STACKABLE) && is_stackable(symbol_id)) {
-        result |= ZINT_CAP_STACKABLE;
-    }
-    if ((cap_flag & ZINT_CAP_EXTENDABLE) && is_extendable(symbol_id)) {
-        result |= ZINT_CAP_EXTENDABLE;
-    }
-    if ((cap_flag & ZINT_CAP_COMPOSITE) && is_composite(symbol_id)) {
-        result |= ZINT_CAP_COMPOSITE;
-    }
-    if ((cap_flag & ZINT_CAP_ECI) && supports_eci(symbol_id)) {
-        result |= ZINT_CAP_ECI;
-    }
-    if ((cap_flag & ZINT_CAP_GS1) && gs1_compliant(symbol_id)) {
-        result |= ZINT_CAP_GS1;
-    }
-    if ((cap_flag & ZINT_CAP_DOTTY) && is_dotty(symbol_id)) {
-        result |= ZINT_CAP_DOTTY;
-    }
-    if ((cap_flag & ZINT_CAP_FIXED_RATIO) && is_fixed_ratio(symbol_id)) {
-        result |= ZINT_CAP_FIXED_RATIO;
-    }
-    if (cap_flag & ZINT_CAP_READER_INIT) {
-        /* Note does not include HIBC versions */
-        switch (symbol_id) {
-            case BARCODE_CODE128: /* Note does not include GS1_128 or NVE18 */
-            case BARCODE_CODE128B:
-            case BARCODE_CODE16K:
-            case BARCODE_CODABLOCKF:
-            case BARCODE_PDF417:
-            case BARCODE_PDF417COMP:
-            case BARCODE_DATAMATRIX:
-            case BARCODE_MICROPDF417:
-            case BARCODE_AZTEC:
-            case BARCODE_DOTCODE:
-            case BARCODE_GRIDMATRIX:
-            case BARCODE_ULTRA:
-                result |= ZINT_CAP_READER_INIT;
-                break;
-        }
-    }
-    if (cap_flag & ZINT_CAP_FULL_MULTIBYTE) {
-        switch (symbol_id) {
-            case BARCODE_QRCODE:
-            case BARCODE_MICROQR:
-            //case BARCODE_HIBC_QR: Note character set restricted to ASCII subset
-            //case BARCODE_UPNQR: Note does not use Kanji mode
-            case BARCODE_RMQR:
-            case BARCODE_HANXIN:
-            case BARCODE_GRIDMATRIX:
-                result |= ZINT_CAP_FULL_MULTIBYTE;
-                break;
-        }
-    }
-    if (cap_flag & ZINT_CAP_MASK) {
-        switch (symbol_id) {
-            case BARCODE_QRCODE:
-            case BARCODE_MICROQR:
-            case BARCODE_HANXIN:
-            case BARCODE_DOTCODE:
-                result |= ZINT_CAP_MASK;
-                break;
-        }
-    }
+    symbol->internal->run_fn = run_fn;
+    symbol->internal->run_context = run_fn ? context : NULL;
 
-    return result;
+    return 0;
 }
 
 int ZBarcode_ValidID(int symbol_id) {
     /* Checks whether a symbology is supported */
-    static const unsigned char ids[146] = {
-          0,   1,   2,   3,   4,   0,   6,   7,   8,   9,
-          0,   0,   0,  13,  14,   0,  16,   0,  18,   0,
-         20,  21,  22,  23,  24,  25,   0,   0,  28,  29,
-         30,  31,  32,   0,  34,  35,   0,  37,  38,   0,
-         40,   0,   0,   0,   0,   0,   0,  47,   0,  49,
-         50,  51,  52,  53,   0,  55,  56,  57,  58,   0,
-         60,   0,   0,  63,   0,   0,  66,  67,  68,  69,
-         70,  71,  72,  73,  74,  75,  76,  77,   0,  79,
-         80,  81,  82,   0,  84,  85,  86,  87,   0,  89,
-         90,   0,  92,  93,   0,   0,  96,  97,  98,  99,
-          0,   0, 102,   0, 104,   0, 106,   0, 108,   0,
-        110,   0, 112,   0,   0, 115, 116,   0,   0,   0,
-          0, 121,   0,   0,   0,   0,   0,   0, 128, 129,
-        130, 131, 132, 133, 134, 135, 136, 137, 138, 139,
-        140, 141, 142, 143, 144, 145,
-    };
-
-    if (symbol_id <= 0 || symbol_id > 145) {
-        return 0;
-    }
-
-    return ids[symbol_id] != 0;
-}
-
-static int reduced_charset(struct zint_symbol *symbol, unsigned char *source, int in_length);
-
-static int extended_or_reduced_charset(struct zint_symbol *symbol, unsigned char *source, const int length) {
-    int error_number = 0;
-
-    switch (symbol->symbology) {
-        /* These are the "elite" standards which have support for specific character sets */
-        case BARCODE_QRCODE: error_number = qr_code(symbol, source, length);
-            break;
-        case BARCODE_MICROQR: error_number = microqr(symbol, source, length);
-            break;
-        case BARCODE_GRIDMATRIX: error_number = grid_matrix(symbol, source, length);
-            break;
-        case BARCODE_HANXIN: error_number = han_xin(symbol, source, length);
-            break;
-        case BARCODE_UPNQR: error_number = upnqr(symbol, source, length);
-            break;
-        case BARCODE_RMQR: error_number = rmqr(symbol, source, length);
-            break;
-        default: error_number = reduced_charset(symbol, source, length);
-            break;
-    }
-
-    return error_number;
+    return symbol_id > 0 && symbol_id <= 145 && symbologies[symbol_id].encode != NULL
+            && symbologies[symbol_id].encode != excluded_encode;
 }
 
-static int reduced_charset(struct zint_symbol *symbol, unsigned char *source, int in_length) {
+static int reduced_charset(struct zint_symbol *symbol, const struct symbology_desc *desc, unsigned char *source,
+            int in_length) {
     /* These are the "norm" standards which only support Latin-1 at most, though a few support ECI */
     int error_number = 0;
     unsigned char *preprocessed = source;
+    const int convert = (symbol->input_mode & 0x07) == UNICODE_MODE && is_eci_convertible(symbol->eci);
 
-    int eci_length = get_eci_length(symbol->eci, source, in_length);
-#ifndef _MSC_VER
-    unsigned char preprocessed_buf[eci_length + 1];
-#else
-    unsigned char *preprocessed_buf = (unsigned char *) _alloca(eci_length + 1);
-#endif
+    /* Only allocate conversion buffer if needed */
+    int eci_length = convert ? get_eci_length(symbol->eci, source, in_length) : 0;
+    z_work_array(symbol, unsigned char, preprocessed_buf, eci_length + 1);
+
+    if (z_work_failed(preprocessed_buf)) {
+        return z_work_error(symbol);
+    }
 
-    if ((symbol->input_mode & 0x07) == UNICODE_MODE && is_eci_convertible(symbol->eci)) {
+    if (convert) {
         /* Prior check ensures ECI only set for those that support it */
         preprocessed = preprocessed_buf;
+        z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_BEGIN, in_length);
         error_number = utf8_to_eci(symbol->eci, source, preprocessed, &in_length);
+        z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, error_number ? -1 : in_length);
         if (error_number != 0) {
             strcpy(symbol->errtxt, "204: Invalid characters in input data");
             return error_number;
         }
     }
 
-    if ((symbol->height == 0) && is_linear(symbol->symbology)) {
+    if ((symbol->height == 0) && (desc->flags & SYM_LINEAR)) {
         symbol->height = 50;
     }
 
-    switch (symbol->symbology) {
-        case BARCODE_C25STANDARD: error_number = matrix_two_of_five(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_C25IND: error_number = industrial_two_of_five(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_C25INTER: error_number = interleaved_two_of_five(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_C25IATA: error_number = iata_two_of_five(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_C25LOGIC: error_number = logic_two_of_five(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_DPLEIT: error_number = dpleit(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_DPIDENT: error_number = dpident(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_UPCA:
-        case BARCODE_UPCA_CHK:
-        case BARCODE_UPCE:
-        case BARCODE_UPCE_CHK:
-        case BARCODE_EANX:
-        case BARCODE_EANX_CHK:
-            error_number = eanx(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_GS1_128: error_number = ean_128(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODE39: error_number = c39(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_PZN: error_number = pharmazentral(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_EXCODE39: error_number = ec39(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODABAR: error_number = codabar(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODE93: error_number = c93(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_LOGMARS: error_number = c39(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODE128:
-        case BARCODE_CODE128B:
-            error_number = code_128(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_NVE18: error_number = nve_18(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODE11: error_number = code_11(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_MSI_PLESSEY: error_number = msi_handle(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_TELEPEN: error_number = telepen(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_TELEPEN_NUM: error_number = telepen_num(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_PHARMA: error_number = pharma_one(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_PLESSEY: error_number = plessey(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_ITF14: error_number = itf14(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_FLAT: error_number = flattermarken(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_FIM: error_number = fim(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_POSTNET: error_number = post_plot(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_PLANET: error_number = planet_plot(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_RM4SCC: error_number = royal_plot(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_AUSPOST:
-        case BARCODE_AUSREPLY:
-        case BARCODE_AUSROUTE:
-        case BARCODE_AUSREDIRECT:
-            error_number = australia_post(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODE16K: error_number = code16k(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_PHARMA_TWO: error_number = pharma_two(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_USPS_IMAIL: error_number = imail(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_ISBNX: error_number = eanx(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_DBAR_OMN:
-        case BARCODE_DBAR_STK:
-        case BARCODE_DBAR_OMNSTK:
-            error_number = rss14(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_DBAR_LTD: error_number = rsslimited(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_DBAR_EXP:
-        case BARCODE_DBAR_EXPSTK:
-            error_number = rssexpanded(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_EANX_CC:
-        case BARCODE_GS1_128_CC:
-        case BARCODE_DBAR_OMN_CC:
-        case BARCODE_DBAR_LTD_CC:
-        case BARCODE_DBAR_EXP_CC:
-        case BARCODE_UPCA_CC:
-        case BARCODE_UPCE_CC:
-        case BARCODE_DBAR_STK_CC:
-        case BARCODE_DBAR_OMNSTK_CC:
-        case BARCODE_DBAR_EXPSTK_CC:
-            error_number = composite(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_KIX: error_number = kix_code(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODE32: error_number = code32(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_DAFT: error_number = daft_code(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_EAN14:
-            error_number = ean_14(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_AZRUNE: error_number = aztec_runes(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_KOREAPOST: error_number = korea_post(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_HIBC_128:
-        case BARCODE_HIBC_39:
-        case BARCODE_HIBC_DM:
-        case BARCODE_HIBC_QR:
-        case BARCODE_HIBC_PDF:
-        case BARCODE_HIBC_MICPDF:
-        case BARCODE_HIBC_AZTEC:
-        case BARCODE_HIBC_BLOCKF:
-            error_number = hibc(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_JAPANPOST: error_number = japan_post(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODE49: error_number = code_49(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CHANNEL: error_number = channel_code(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODEONE: error_number = code_one(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_DATAMATRIX: error_number = dmatrix(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_PDF417:
-        case BARCODE_PDF417COMP:
-            error_number = pdf417enc(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_MICROPDF417: error_number = micro_pdf417(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_MAXICODE: error_number = maxicode(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_AZTEC: error_number = aztec(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_DOTCODE: error_number = dotcode(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_CODABLOCKF: error_number = codablock(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_VIN: error_number = vin(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_MAILMARK: error_number = mailmark(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_ULTRA: error_number = ultracode(symbol, preprocessed, in_length);
-            break;
-        case BARCODE_DPD: error_number = dpd_parcel(symbol, preprocessed, in_length);
-            break;
+    if (desc->encode) {
+        error_number = desc->encode(symbol, preprocessed, in_length);
     }
 
     return error_number;
 }
 
-STATIC_UNLESS_ZINT_TEST void strip_bom(unsigned char *source, int *input_length) {
-    int i;
+static int extended_or_reduced_charset(struct zint_symbol *symbol, unsigned char *source, const int length) {
+    const struct symbology_desc *desc = &symbologies[symbol->symbology]; /* In range once settings checked */
+
+    if (desc->flags & SYM_FULL_CHARSET) {
+        /* These are the "elite" standards which have support for specific character sets */
+        return desc->encode(symbol, source, length);
+    }
+
+    return reduced_charset(symbol, desc, source, length);
+}
+
+/* Return length of any BOM at start of input data to be stripped in accordance with RFC 3629, i.e. 3 or 0 */
+STATIC_UNLESS_ZINT_TEST int bom_length(const unsigned char *source, const int length) {
 
     /* Note if BOM is only data then not stripped */
-    if (*input_length > 3 && (source[0] == 0xef) && (source[1] == 0xbb) && (source[2] == 0xbf)) {
-        /* BOM at start of input data, strip in accordance with RFC 3629 */
-        for (i = 3; i <= *input_length; i++) { /* Include terminating NUL */
-            source[i - 3] = source[i];
-        }
-        *input_length -= 3;
+    if (length > 3 && (source[0] == 0xef) && (source[1] == 0xbb) && (source[2] == 0xbf)) {
+        return 3;
     }
+
+    return 0;
 }
 
-static int escape_char_process(struct zint_symbol *symbol, unsigned char *input_string, int *length) {
+/* Process escape sequences in `input_string` of length `*length` into `escaped_string` (at least `*length + 1`
+   bytes), NUL-terminating it and setting `*length` to its length */
+static int escape_char_process(struct zint_symbol *symbol, const unsigned char *input_string, int *length,
+            unsigned char *escaped_string) {
     int error_number;
     int in_posn, out_posn;
     int hex1, hex2;
     int i, unicode;
 
-#ifndef _MSC_VER
-    unsigned char escaped_string[*length + 1];
-#else
-    unsigned char *escaped_string = (unsigned char *) _alloca(*length + 1);
-#endif
-
     in_posn = 0;
     out_posn = 0;
 
-    do {
-        if (input_string[in_posn] == '\\') {
+    while (in_posn < *length) {
+        /* Bulk copy the run up to the next backslash, if any */
+        const unsigned char *backslash = (const unsigned char *) memchr(input_string + in_posn, '\\',
+                                                                        *length - in_posn);
+        const int run = backslash ? (int) (backslash - input_string) - in_posn : *length - in_posn;
+        if (run) {
+            memcpy(escaped_string + out_posn, input_string + in_posn, run);
+            in_posn += run;
+            out_posn += run;
+        }
+        if (backslash) {
             if (in_posn + 1 >= *length) {
                 strcpy(symbol->errtxt, "236: Incomplete escape character in input data");
                 return ZINT_ERROR_INVALID_DATA;
@@ -1057,15 +1001,11 @@ static int escape_char_process(struct zint_symbol *symbol, unsigned char *input_
                     return ZINT_ERROR_INVALID_DATA;
                     break;
             }
-        } else {
-            escaped_string[out_posn] = input_string[in_posn];
-            in_posn++;
+            out_posn++;
         }
-        out_posn++;
-    } while (in_posn < *length);
+    }
 
-    memcpy(input_string, escaped_string, out_posn);
-    input_string[out_posn] = '\0';
+    escaped_string[out_posn] = '\0';
     *length = out_posn;
 
     error_number = 0;
@@ -1073,183 +1013,121 @@ static int escape_char_process(struct zint_symbol *symbol, unsigned char *input_
     return error_number;
 }
 
-int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int in_length) {
-    int error_number, warn_number;
-#ifdef _MSC_VER
-    unsigned char *local_source;
-#endif
-
-    if (!symbol) return ZINT_ERROR_INVALID_DATA;
-
-    if (symbol->debug & ZINT_DEBUG_PRINT) {
-        printf("ZBarcode_Encode: symbology: %d, input_mode: 0x%X, ECI: %d, option_1: %d, option_2: %d,"
-                " option_3: %d, scale: %g\n    output_options: 0x%X, fg: %s, bg: %s,"
-                " in_length: %d, First 10 source: \"%.10s\", First 10 primary: \"%.10s\"\n",
-                symbol->symbology, symbol->input_mode, symbol->eci, symbol->option_1, symbol->option_2,
-                symbol->option_3, symbol->scale, symbol->output_options, symbol->fgcolour, symbol->bgcolour,
-                in_length, source, symbol->primary);
-    }
-
-    warn_number = 0;
+/* Check input data `source` of length `*p_length` (set if <= 0 to `source` length) */
+INTERNAL int check_source(struct zint_symbol *symbol, const unsigned char *source, int *p_length) {
 
     if (source == NULL) {
         strcpy(symbol->errtxt, "200: Input data NULL");
-        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+        return ZINT_ERROR_INVALID_DATA;
     }
-    if (in_length <= 0) {
-        in_length = (int) ustrlen(source);
+    if (*p_length <= 0) {
+        *p_length = (int) ustrlen(source);
     }
-    if (in_length <= 0) {
+    if (*p_length <= 0) {
         strcpy(symbol->errtxt, "205: No input data");
-        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+        return ZINT_ERROR_INVALID_DATA;
     }
-    if (in_length > ZINT_MAX_DATA_LEN) {
+    if (*p_length > ZINT_MAX_DATA_LEN) {
         strcpy(symbol->errtxt, "243: Input data too long");
-        return error_tag(symbol->errtxt, ZINT_ERROR_TOO_LONG);
+        return ZINT_ERROR_TOO_LONG;
     }
 
-    if (*symbol->outfile == '\0') {
-#ifdef NO_PNG
-        strcpy(symbol->outfile, "out.gif");
-#else
-        strcpy(symbol->outfile, "out.png");
-#endif
-    }
+    return 0;
+}
+
+/* Check and adjust symbology, ECI and dot size settings, returning warning or (untagged) error */
+INTERNAL int check_settings(struct zint_symbol *symbol) {
+    int warn_number = 0;
 
     /* First check the symbology field */
     if (!ZBarcode_ValidID(symbol->symbology)) {
-        if (symbol->symbology < 1) {
-            strcpy(symbol->errtxt, "206: Symbology out of range");
+        if (symbol->symbology < 1 || symbol->symbology > 145) {
+            strcpy(symbol->errtxt, symbol->symbology < 1 ? "206: Symbology out of range"
+                                                         : "216: Symbology out of range");
             if (symbol->warn_level == WARN_FAIL_ALL) {
-                return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+                return ZINT_ERROR_INVALID_OPTION;
             }
             symbol->symbology = BARCODE_CODE128;
             warn_number = ZINT_WARN_INVALID_OPTION;
-        /* symbol->symbologys 1 to 86 are defined by tbarcode */
-        } else if (symbol->symbology == 5) {
-            symbol->symbology = BARCODE_C25STANDARD;
-        } else if ((symbol->symbology >= 10) && (symbol->symbology <= 12)) {
-            symbol->symbology = BARCODE_EANX;
-        } else if (symbol->symbology == 15) {
-            symbol->symbology = BARCODE_EANX;
-        } else if (symbol->symbology == 17) {
-            symbol->symbology = BARCODE_UPCA;
-        } else if (symbol->symbology == 19) {
-            strcpy(symbol->errtxt, "207: Codabar 18 not supported");
-            if (symbol->warn_level == WARN_FAIL_ALL) {
-                return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
-            }
-            symbol->symbology = BARCODE_CODABAR;
-            warn_number = ZINT_WARN_INVALID_OPTION;
-        } else if (symbol->symbology == 26) {
-            symbol->symbology = BARCODE_UPCA;
-        } else if (symbol->symbology == 27) {
-            strcpy(symbol->errtxt, "208: UPCD1 not supported");
-            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
-        } else if (symbol->symbology == 33) {
-            symbol->symbology = BARCODE_GS1_128;
-        } else if (symbol->symbology == 36) {
-            symbol->symbology = BARCODE_UPCA;
-        } else if ((symbol->symbology >= 41) && (symbol->symbology <= 45)) {
-            symbol->symbology = BARCODE_POSTNET;
-        } else if (symbol->symbology == 46) {
-            symbol->symbology = BARCODE_PLESSEY;
-        } else if (symbol->symbology == 48) {
-            symbol->symbology = BARCODE_NVE18;
-        } else if (symbol->symbology == 54) {
-            strcpy(symbol->errtxt, "210: General Parcel Code not supported");
-            if (symbol->warn_level == WARN_FAIL_ALL) {
-                return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
-            }
-            symbol->symbology = BARCODE_CODE128;
-            warn_number = ZINT_WARN_INVALID_OPTION;
-        } else if ((symbol->symbology == 59) || (symbol->symbology == 61)) {
-            symbol->symbology = BARCODE_CODE128;
-        } else if (symbol->symbology == 62) {
-            symbol->symbology = BARCODE_CODE93;
-        } else if ((symbol->symbology == 64) || (symbol->symbology == 65)) {
-            symbol->symbology = BARCODE_AUSPOST;
-        } else if (symbol->symbology == 78) {
-            symbol->symbology = BARCODE_DBAR_OMN;
-        } else if (symbol->symbology == 83) {
-            symbol->symbology = BARCODE_PLANET;
-        } else if (symbol->symbology == 88) {
-            symbol->symbology = BARCODE_GS1_128;
-        } else if (symbol->symbology == 91) {
-            strcpy(symbol->errtxt, "212: Symbology out of range");
-            if (symbol->warn_level == WARN_FAIL_ALL) {
-                return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
-            }
-            symbol->symbology = BARCODE_CODE128;
-            warn_number = ZINT_WARN_INVALID_OPTION;
-        } else if ((symbol->symbology >= 94) && (symbol->symbology <= 95)) {
-            strcpy(symbol->errtxt, "213: Symbology out of range");
-            if (symbol->warn_level == WARN_FAIL_ALL) {
-                return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
-            }
-            symbol->symbology = BARCODE_CODE128;
-            warn_number = ZINT_WARN_INVALID_OPTION;
-        } else if (symbol->symbology == 100) {
-            symbol->symbology = BARCODE_HIBC_128;
-        } else if (symbol->symbology == 101) {
-            symbol->symbology = BARCODE_HIBC_39;
-        } else if (symbol->symbology == 103) {
-            symbol->symbology = BARCODE_HIBC_DM;
-        } else if (symbol->symbology == 105) {
-            symbol->symbology = BARCODE_HIBC_QR;
-        } else if (symbol->symbology == 107) {
-            symbol->symbology = BARCODE_HIBC_PDF;
-        } else if (symbol->symbology == 109) {
-            symbol->symbology = BARCODE_HIBC_MICPDF;
-        } else if (symbol->symbology == 111) {
-            symbol->symbology = BARCODE_HIBC_BLOCKF;
-        } else if ((symbol->symbology == 113) || (symbol->symbology == 114)) {
-            strcpy(symbol->errtxt, "214: Symbology out of range");
-            if (symbol->warn_level == WARN_FAIL_ALL) {
-                return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
-            }
-            symbol->symbology = BARCODE_CODE128;
-            warn_number = ZINT_WARN_INVALID_OPTION;
-        } else if (symbol->symbology == 115) {
-            symbol->symbology = BARCODE_DOTCODE;
-        } else if ((symbol->symbology >= 117) && (symbol->symbology <= 127)) {
-            if (symbol->symbology != 121) {
-                strcpy(symbol->errtxt, "215: Symbology out of range");
-                if (symbol->warn_level == WARN_FAIL_ALL) {
-                    return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        } else {
+            /* Symbologies 1 to 86 are defined by tbarcode (everything from 128 up is Zint-specific) */
+            const struct symbology_desc *desc = &symbologies[symbol->symbology];
+            if (desc->remap_errtxt) {
+                strcpy(symbol->errtxt, desc->remap_errtxt);
+                if (!desc->remap || symbol->warn_level == WARN_FAIL_ALL) {
+                    return ZINT_ERROR_INVALID_OPTION;
                 }
-                symbol->symbology = BARCODE_CODE128;
                 warn_number = ZINT_WARN_INVALID_OPTION;
             }
-        /* Everything from 128 up is Zint-specific */
-        } else if (symbol->symbology > 145) {
-            strcpy(symbol->errtxt, "216: Symbology out of range");
-            if (symbol->warn_level == WARN_FAIL_ALL) {
-                return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            if (desc->remap) {
+                symbol->symbology = desc->remap;
             }
-            symbol->symbology = BARCODE_CODE128;
-            warn_number = ZINT_WARN_INVALID_OPTION;
         }
     }
+    if (symbologies[symbol->symbology].encode == excluded_encode) {
+        strcpy(symbol->errtxt, "708: Symbology not included in this build");
+        return ZINT_ERROR_INVALID_OPTION;
+    }
 
     if (symbol->eci != 0) {
-        if (!(supports_eci(symbol->symbology))) {
+        if (!(symbology_flags(symbol->symbology) & ZINT_CAP_ECI)) {
             strcpy(symbol->errtxt, "217: Symbology does not support ECI switching");
-            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            return ZINT_ERROR_INVALID_OPTION;
         }
         if ((symbol->eci < 0) || (symbol->eci == 1) || (symbol->eci == 2) || (symbol->eci > 999999)) {
             strcpy(symbol->errtxt, "218: Invalid ECI mode");
-            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            return ZINT_ERROR_INVALID_OPTION;
         }
     }
 
+    if (symbol->structapp.count && !(symbology_flags(symbol->symbology) & ZINT_CAP_STRUCTAPP)) {
+        strcpy(symbol->errtxt, "700: Symbology does not support Structured Append");
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
     if ((symbol->dot_size < 0.01f) || (symbol->dot_size > 20.0f)) {
         strcpy(symbol->errtxt, "221: Invalid dot size");
-        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        return ZINT_ERROR_INVALID_OPTION;
     }
 
+    return warn_number;
+}
+
+/* Approximate cost in bits of changing ECI within the data for symbologies with SYM_ECI_SEGS */
+static int eci_switch_bits(const int symbology) {
+    (void) symbology; /* Only QR Code for now */
+
+    /* ECI mode indicator and 8-bit designator, and a new Byte mode header with up to 16-bit character count */
+    return 4 + 8 + 4 + 16;
+}
+
+/* Symbology encoding phase */
+static int encode_charset(struct zint_symbol *symbol, unsigned char *source, const int length) {
+    int error_number;
+
+    z_trace(symbol, ZINT_PHASE_ENCODE, ZINT_TRACE_BEGIN, length);
+    error_number = extended_or_reduced_charset(symbol, source, length);
+    z_trace(symbol, ZINT_PHASE_ENCODE, ZINT_TRACE_END,
+            error_number >= ZINT_ERROR ? -1 : symbol->rows * symbol->width);
+
+    return error_number;
+}
+
+/* Encode `source` of length `in_length` once settings checked, `warn_number` being any settings warning */
+static int encode_source_data(struct zint_symbol *symbol, const unsigned char *source, int in_length,
+            int warn_number) {
+    const unsigned int flags = symbology_flags(symbol->symbology);
+    int error_number;
+    int escape, gs1_reduce, copy;
+    /* Input as passed to encoder, only copied if modified or if encoder may modify it */
+    unsigned char *local_source = (unsigned char *) source;
+    int bom_len;
+
+    z_trace(symbol, ZINT_PHASE_PREPROCESS, ZINT_TRACE_BEGIN, in_length);
+
     if ((symbol->input_mode & 0x07) == UNICODE_MODE && !is_valid_utf8(source, in_length)) {
         strcpy(symbol->errtxt, "245: Invalid UTF-8");
+        z_trace(symbol, ZINT_PHASE_PREPROCESS, ZINT_TRACE_END, -1);
         return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
     }
 
@@ -1257,65 +1135,95 @@ int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int
         symbol->input_mode = DATA_MODE; /* Reset completely */
     }
 
-#ifndef _MSC_VER
-    unsigned char local_source[in_length + 1];
-#else
-    local_source = (unsigned char *) _alloca(in_length + 1);
-#endif
+    /* Reduce input for GS1 composite and non-forced symbologies, others (EAN128 and RSS_EXP based) will handle it
+       themselves */
+    gs1_reduce = ((symbol->input_mode & 0x07) == GS1_MODE || (flags & SYM_FORCE_GS1)) && (flags & ZINT_CAP_GS1)
+                    && ((flags & ZINT_CAP_COMPOSITE) || !(flags & SYM_FORCE_GS1));
+    /* Nothing to do for escape mode if no backslashes */
+    escape = (symbol->input_mode & ESCAPE_MODE) && memchr(source, '\\', in_length) != NULL;
+    /* GS1 reduction makes its own copy */
+    copy = escape || (!(flags & SYM_CONST_INPUT) && !gs1_reduce);
+
+    z_work_array(symbol, unsigned char, copy_buf, copy ? in_length + 1 : 1);
+    z_work_array(symbol, unsigned char, reduced, gs1_reduce ? in_length + 1 : 1);
 
-    memcpy(local_source, source, in_length);
-    local_source[in_length] = '\0';
+    if (z_work_failed(copy_buf) || z_work_failed(reduced)) {
+        z_trace(symbol, ZINT_PHASE_PREPROCESS, ZINT_TRACE_END, -1);
+        return error_tag(symbol->errtxt, z_work_error(symbol));
+    }
 
     /* Start acting on input mode */
-    if (symbol->input_mode & ESCAPE_MODE) {
-        error_number = escape_char_process(symbol, local_source, &in_length);
+    if (escape) {
+        error_number = escape_char_process(symbol, source, &in_length, copy_buf);
         if (error_number != 0) {
+            z_trace(symbol, ZINT_PHASE_PREPROCESS, ZINT_TRACE_END, -1);
             return error_tag(symbol->errtxt, error_number);
         }
+        local_source = copy_buf;
+    } else if (copy) {
+        memcpy(copy_buf, source, in_length);
+        copy_buf[in_length] = '\0';
+        local_source = copy_buf;
     }
 
-    if ((symbol->input_mode & 0x07) == UNICODE_MODE) {
-        strip_bom(local_source, &in_length);
+    if ((symbol->input_mode & 0x07) == UNICODE_MODE && (bom_len = bom_length(local_source, in_length))) {
+        local_source += bom_len;
+        in_length -= bom_len;
     }
 
-    if (((symbol->input_mode & 0x07) == GS1_MODE) || (check_force_gs1(symbol->symbology))) {
-        if (gs1_compliant(symbol->symbology) == 1) {
-            // Reduce input for composite and non-forced symbologies, others (EAN128 and RSS_EXP based) will
-            // handle it themselves
-            if (is_composite(symbol->symbology) || !check_force_gs1(symbol->symbology)) {
-#ifndef _MSC_VER
-                unsigned char reduced[in_length + 1];
-#else
-                unsigned char *reduced = (unsigned char *) _alloca(in_length + 1);
-#endif
-                error_number = gs1_verify(symbol, local_source, in_length, reduced);
-                if (error_number >= ZINT_ERROR) {
-                    const char in_2d_comp[] = " in 2D component";
-                    if (is_composite(symbol->symbology) && strlen(symbol->errtxt) < 100 - strlen(in_2d_comp)) {
-                        strcat(symbol->errtxt, in_2d_comp);
-                    }
-                    return error_tag(symbol->errtxt, error_number);
-                }
-                if (error_number && warn_number == 0) {
-                    warn_number = error_number;
-                }
-                ustrcpy(local_source, reduced); // Cannot contain nul char
-                in_length = (int) ustrlen(local_source);
+    z_trace(symbol, ZINT_PHASE_PREPROCESS, ZINT_TRACE_END, in_length);
+
+    if (gs1_reduce) {
+        int reduced_length;
+        z_trace(symbol, ZINT_PHASE_GS1, ZINT_TRACE_BEGIN, in_length);
+        error_number = gs1_verify(symbol, local_source, in_length, reduced, &reduced_length);
+        z_trace(symbol, ZINT_PHASE_GS1, ZINT_TRACE_END, error_number >= ZINT_ERROR ? -1 : reduced_length);
+        if (error_number >= ZINT_ERROR) {
+            const char in_2d_comp[] = " in 2D component";
+            if ((flags & ZINT_CAP_COMPOSITE) && strlen(symbol->errtxt) < 100 - strlen(in_2d_comp)) {
+                strcat(symbol->errtxt, in_2d_comp);
             }
-        } else {
-            strcpy(symbol->errtxt, "220: Selected symbology does not support GS1 mode");
-            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            return error_tag(symbol->errtxt, error_number);
         }
+        if (error_number && warn_number == 0) {
+            warn_number = error_number;
+        }
+        local_source = reduced; /* NUL-terminated */
+        in_length = reduced_length;
+    } else if (((symbol->input_mode & 0x07) == GS1_MODE || (flags & SYM_FORCE_GS1)) && !(flags & ZINT_CAP_GS1)) {
+        strcpy(symbol->errtxt, "220: Selected symbology does not support GS1 mode");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
     }
 
-    error_number = extended_or_reduced_charset(symbol, local_source, in_length);
+    /* Human readable text not needed unless EAN/UPC, whose layout depends on it */
+    if (!(flags & ZINT_CAP_EXTENDABLE) && ((symbol->output_options & BARCODE_NO_HRT) || !symbol->show_hrt)) {
+        symbol->debug |= ZINT_NO_HRT_TEXT;
+    }
 
-    if ((error_number == ZINT_ERROR_INVALID_DATA) && symbol->eci == 0 && supports_eci(symbol->symbology)
+    error_number = encode_charset(symbol, local_source, in_length);
+
+    if ((error_number == ZINT_ERROR_INVALID_DATA) && symbol->eci == 0 && (flags & ZINT_CAP_ECI)
             && (symbol->input_mode & 0x07) == UNICODE_MODE) {
-        /* Try another ECI mode */
-        symbol->eci = get_best_eci(local_source, in_length);
+        struct zint_eci_segs segs;
+        if ((symbol->input_mode & MULTI_ECI_MODE) && (flags & SYM_ECI_SEGS)
+                && get_best_eci_segs(symbol, local_source, in_length, eci_switch_bits(symbol->symbology), &segs) > 1) {
+            /* Switch ECIs within the data, `symbol->eci` staying 0 */
+            symbol->internal->eci_segs = &segs;
+            error_number = encode_charset(symbol, local_source, in_length);
+            symbol->internal->eci_segs = NULL;
+            if (error_number == 0) {
+                error_number = ZINT_WARN_USES_ECI;
+                if (!(symbol->debug & ZINT_DEBUG_TEST)) {
+                    strcpy(symbol->errtxt, "222: Encoded data includes ECI");
+                }
+                if (symbol->debug & ZINT_DEBUG_PRINT) printf("Added %d ECI segments\n", segs.count);
+            }
+        } else {
+            /* Try another ECI mode */
+            symbol->eci = get_best_eci(local_source, in_length);
+        }
         if (symbol->eci != 0) {
-            error_number = extended_or_reduced_charset(symbol, local_source, in_length);
+            error_number = encode_charset(symbol, local_source, in_length);
             if (error_number == 0) {
                 error_number = ZINT_WARN_USES_ECI;
                 if (!(symbol->debug & ZINT_DEBUG_TEST)) {
@@ -1325,6 +1233,7 @@ int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int
             }
         }
     }
+    symbol->debug &= ~ZINT_NO_HRT_TEXT;
 
     if (error_number == 0) {
         error_number = warn_number;
@@ -1338,6 +1247,745 @@ int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int
     return error_number;
 }
 
+/* Encode as `encode_source_data()`, within `symbol->time_budget_ms` if set, warning if it was exceeded (unless
+   another warning was given) */
+INTERNAL int encode_source(struct zint_symbol *symbol, const unsigned char *source, int in_length, int warn_number) {
+    struct zint_budget budget;
+    int error_number;
+
+    if (symbol->time_budget_ms <= 0) {
+        symbol->internal->budget = NULL;
+        return encode_source_data(symbol, source, in_length, warn_number);
+    }
+
+    budget.deadline = z_clock_ms() + symbol->time_budget_ms;
+    budget.exceeded = 0;
+    symbol->internal->budget = &budget;
+    error_number = encode_source_data(symbol, source, in_length, warn_number);
+    symbol->internal->budget = NULL;
+
+    if (budget.exceeded && error_number == 0) {
+        strcpy(symbol->errtxt, "743: Time budget exceeded, faster encoding used");
+        error_number = error_tag(symbol->errtxt, ZINT_WARN_TIME_BUDGET);
+    }
+
+    return error_number;
+}
+
+int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int in_length) {
+    int error_number, warn_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    symbol->trace_record_count = 0;
+
+    if (symbol->debug & ZINT_DEBUG_PRINT) {
+        printf("ZBarcode_Encode: symbology: %d, input_mode: 0x%X, ECI: %d, option_1: %d, option_2: %d,"
+                " option_3: %d, scale: %g\n    output_options: 0x%X, fg: %s, bg: %s,"
+                " in_length: %d, First 10 source: \"%.10s\", First 10 primary: \"%.10s\"\n",
+                symbol->symbology, symbol->input_mode, symbol->eci, symbol->option_1, symbol->option_2,
+                symbol->option_3, symbol->scale, symbol->output_options, symbol->fgcolour, symbol->bgcolour,
+                in_length, source, symbol->primary);
+    }
+
+    error_number = check_source(symbol, source, &in_length);
+    if (error_number != 0) {
+        return error_tag(symbol->errtxt, error_number);
+    }
+
+    if (*symbol->outfile == '\0') {
+        strcpy(symbol->outfile, "out.png");
+    }
+
+    warn_number = check_settings(symbol);
+    if (warn_number >= ZINT_ERROR) {
+        return error_tag(symbol->errtxt, warn_number);
+    }
+
+    error_number = encode_source(symbol, source, in_length, warn_number);
+    z_work_free(symbol);
+
+    return error_number;
+}
+
+/* Encode GS1 data given as `count` AI/value `elements` rather than as a bracketed string, the FNC1-separated data
+   being built directly (see `gs1_elements()`) instead of being parsed by `gs1_verify()`. The values are checked
+   unless GS1NOCHECK_MODE is set (pre-validated). GS1_MODE is implied, and GS1PARENS_MODE and ESCAPE_MODE ignored */
+int ZBarcode_Encode_GS1(struct zint_symbol *symbol, const struct zint_gs1_element *elements, int count) {
+    struct zint_gs1_prepared prepared;
+    const int input_mode = symbol ? symbol->input_mode : 0;
+    unsigned char *source;
+    unsigned char *reduced;
+    int size, length;
+    int error_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (count <= 0 || !elements) {
+        strcpy(symbol->errtxt, "761: GS1 elements NULL or count not positive");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+    /* These take digits only, adding the AI themselves */
+    if (symbol->symbology == BARCODE_EAN14 || symbol->symbology == BARCODE_NVE18) {
+        strcpy(symbol->errtxt, "762: Selected symbology does not support GS1 elements");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    size = gs1_elements_size(elements, count);
+    source = (unsigned char *) malloc(size);
+    reduced = (unsigned char *) malloc(size);
+    if (!source || !reduced) {
+        free(source);
+        free(reduced);
+        strcpy(symbol->errtxt, "763: Insufficient memory for GS1 elements");
+        return error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+    }
+
+    symbol->input_mode = (input_mode & ~(0x07 | GS1PARENS_MODE | ESCAPE_MODE)) | GS1_MODE;
+    error_number = gs1_elements(symbol, elements, count, source, &length, reduced, &prepared);
+    if (error_number >= ZINT_ERROR) {
+        error_number = error_tag(symbol->errtxt, error_number);
+    } else {
+        symbol->internal->gs1_prepared = &prepared;
+        error_number = ZBarcode_Encode(symbol, source, length);
+        symbol->internal->gs1_prepared = NULL;
+    }
+    symbol->input_mode = input_mode;
+
+    free(source);
+    free(reduced);
+
+    return error_number;
+}
+
+INTERNAL void batch_settings_save(const struct zint_symbol *symbol, struct batch_settings *settings) {
+    settings->symbology = symbol->symbology;
+    settings->height = symbol->height;
+    settings->whitespace_width = symbol->whitespace_width;
+    settings->whitespace_height = symbol->whitespace_height;
+    settings->border_width = symbol->border_width;
+    settings->output_options = symbol->output_options;
+    settings->scale = symbol->scale;
+    settings->option_1 = symbol->option_1;
+    settings->option_2 = symbol->option_2;
+    settings->option_3 = symbol->option_3;
+    settings->show_hrt = symbol->show_hrt;
+    settings->input_mode = symbol->input_mode;
+    settings->eci = symbol->eci;
+    settings->dot_size = symbol->dot_size;
+}
+
+INTERNAL void batch_settings_restore(struct zint_symbol *symbol, const struct batch_settings *settings) {
+    symbol->symbology = settings->symbology;
+    symbol->height = settings->height;
+    symbol->whitespace_width = settings->whitespace_width;
+    symbol->whitespace_height = settings->whitespace_height;
+    symbol->border_width = settings->border_width;
+    symbol->output_options = settings->output_options;
+    symbol->scale = settings->scale;
+    symbol->option_1 = settings->option_1;
+    symbol->option_2 = settings->option_2;
+    symbol->option_3 = settings->option_3;
+    symbol->show_hrt = settings->show_hrt;
+    symbol->input_mode = settings->input_mode;
+    symbol->eci = settings->eci;
+    symbol->dot_size = settings->dot_size;
+}
+
+/* Prepared encoder, see `ZBarcode_Prepare()`, read-only once created */
+struct zint_prepared {
+    struct batch_settings settings; /* As adjusted by `check_settings()` */
+    char fgcolour[10]; /* Checked and upper-cased */
+    char bgcolour[10];
+    int fontsize;
+    int warn_level;
+    int warn_number; /* Settings warning (if any) */
+    char errtxt[100]; /* Untagged settings warning text */
+    struct zint_allocator allocator; /* Of the symbol it was created from */
+};
+
+/* Check the settings of `symbol` once, including its colours, creating in `*p_prepared` a prepared encoder for use
+   by `ZBarcode_Encode_Prepared()`. The settings of `symbol` are left unchanged apart from `errtxt`. Returns an
+   error (with `*p_prepared` set to NULL) if the settings are invalid, else any settings warning */
+int ZBarcode_Prepare(struct zint_symbol *symbol, struct zint_prepared **p_prepared) {
+    struct zint_prepared *prepared;
+    struct batch_settings settings;
+    int warn_number, error_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!p_prepared) {
+        strcpy(symbol->errtxt, "462: Prepared encoder pointer NULL");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    *p_prepared = NULL;
+
+    symbol->errtxt[0] = '\0';
+    batch_settings_save(symbol, &settings);
+    warn_number = check_settings(symbol);
+    if (warn_number >= ZINT_ERROR) {
+        batch_settings_restore(symbol, &settings);
+        return error_tag(symbol->errtxt, warn_number);
+    }
+
+    if (!(prepared = (struct zint_prepared *) z_malloc(z_allocator(symbol), sizeof(struct zint_prepared)))) {
+        batch_settings_restore(symbol, &settings);
+        strcpy(symbol->errtxt, "475: Insufficient memory for prepared encoder");
+        return error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+    }
+    batch_settings_save(symbol, &prepared->settings);
+    batch_settings_restore(symbol, &settings);
+    strcpy(prepared->errtxt, symbol->errtxt);
+    prepared->allocator = symbol->internal->allocator;
+
+    error_number = output_check_colour_options(symbol);
+    if (error_number != 0) {
+        z_free(z_allocator(symbol), prepared);
+        return error_tag(symbol->errtxt, error_number);
+    }
+    strcpy(prepared->fgcolour, symbol->fgcolour);
+    strcpy(prepared->bgcolour, symbol->bgcolour);
+    prepared->fontsize = symbol->fontsize;
+    prepared->warn_level = symbol->warn_level;
+    prepared->warn_number = warn_number;
+
+    *p_prepared = prepared;
+
+    return error_tag(symbol->errtxt, warn_number);
+}
+
+/* Encode `source` into `symbol` (which is cleared first) using the settings of `prepared`, leaving only the
+   input-dependent work. Other fields of `symbol` (`outfile`, `primary`, `debug`, callbacks) are used as is. As
+   `prepared` is not changed, it may be shared between threads, each using its own `symbol` */
+int ZBarcode_Encode_Prepared(const struct zint_prepared *prepared, struct zint_symbol *symbol,
+            const unsigned char *source, int in_length) {
+    int error_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    ZBarcode_Clear(symbol);
+
+    if (!prepared) {
+        strcpy(symbol->errtxt, "476: Prepared encoder NULL");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    batch_settings_restore(symbol, &prepared->settings);
+    strcpy(symbol->fgcolour, prepared->fgcolour);
+    strcpy(symbol->bgcolour, prepared->bgcolour);
+    symbol->fontsize = prepared->fontsize;
+    symbol->warn_level = prepared->warn_level;
+
+    error_number = check_source(symbol, source, &in_length);
+    if (error_number != 0) {
+        return error_tag(symbol->errtxt, error_number);
+    }
+
+    if (*symbol->outfile == '\0') {
+        strcpy(symbol->outfile, "out.png");
+    }
+
+    strcpy(symbol->errtxt, prepared->errtxt);
+
+    error_number = encode_source(symbol, source, in_length, prepared->warn_number);
+    z_work_free(symbol);
+
+    return error_number;
+}
+
+void ZBarcode_Prepared_Delete(struct zint_prepared *prepared) {
+    struct zint_allocator allocator;
+
+    if (!prepared) return;
+
+    allocator = prepared->allocator;
+    z_free(&allocator, prepared);
+}
+
+/* Maximum number of symbols in a Structured Append sequence of `symbology` */
+static int structapp_max_count(const int symbology) {
+    switch (symbology) {
+        case BARCODE_AZTEC: return 26;
+        case BARCODE_MAXICODE: return 8;
+    }
+    return 16; /* QR Code, Data Matrix */
+}
+
+/* Return the character boundary in (`lo`, `hi`] nearest to `mid`, searching back first, or `lo` if none. All are
+   boundaries unless `unicode`, when UTF-8 sequences are not split */
+static int structapp_boundary(const unsigned char source[], const int length, const int lo, const int mid,
+            const int hi, const int unicode) {
+    int end;
+
+    if (!unicode) {
+        return mid;
+    }
+    for (end = mid; end > lo && end < length && (source[end] & 0xC0) == 0x80; end--);
+    if (end > lo) {
+        return end;
+    }
+    for (end = mid + 1; end <= hi && end < length && (source[end] & 0xC0) == 0x80; end++);
+
+    return end <= hi ? end : lo;
+}
+
+/* A symbol of a Structured Append sequence to be encoded by `structapp_encode_part()` */
+struct structapp_part {
+    struct zint_symbol *symbol;
+    const unsigned char *source;
+    int length;
+    int error_number;
+};
+
+/* The parts of a Structured Append sequence being encoded by `structapp_encode_part()` */
+struct structapp_job {
+    const struct zint_prepared *prepared;
+    struct structapp_part *parts;
+};
+
+/* Task of `z_parallel()`, encoding part `index` */
+static void structapp_encode_part(void *arg, int index) {
+    const struct structapp_job *job = (const struct structapp_job *) arg;
+    struct structapp_part *part = &job->parts[index];
+
+    part->error_number = ZBarcode_Encode_Prepared(job->prepared, part->symbol, part->source, part->length);
+}
+
+/* Encode the `count` parts using up to `threads` threads (including the calling one), see `z_parallel()` */
+static void structapp_encode(const struct zint_symbol *symbol, const struct zint_prepared *prepared,
+            struct structapp_part parts[], const int count, const int threads) {
+    struct structapp_job job;
+
+    job.prepared = prepared;
+    job.parts = parts;
+    z_parallel(symbol, structapp_encode_part, &job, count, threads);
+}
+
+/* Split `source` of length `length` into the `*p_count` parts starting at `starts` (followed by `length`), sizing
+   each with `probe`, whose `structapp` must already be set. Returns an error (tagged in `symbol->errtxt`) if it
+   can't be split into at most `max_count` parts */
+static int structapp_split(struct zint_symbol *symbol, const struct zint_prepared *prepared,
+            struct zint_symbol *probe, const unsigned char source[], const int length, const int max_count,
+            const int unicode, int starts[], int *p_count) {
+    int error_number;
+    int count, start;
+
+    for (count = 0, start = 0; start < length; count++) {
+        int lo = 0, hi = length - start; /* Longest known to fit, and longest that may */
+        if (count == max_count) {
+            sprintf(symbol->errtxt, "705: Input too long for Structured Append sequence (maximum %d symbols)",
+                    max_count);
+            return error_tag(symbol->errtxt, ZINT_ERROR_TOO_LONG);
+        }
+        while (lo < hi) {
+            const int end = structapp_boundary(source, length, start + lo, start + (lo + hi + 1) / 2, start + hi,
+                                unicode) - start;
+            if (end <= lo) {
+                break; /* No character boundary above `lo` */
+            }
+            error_number = ZBarcode_Encode_Prepared(prepared, probe, source + start, end);
+            if (error_number < ZINT_ERROR) {
+                lo = end;
+            } else if (error_number == ZINT_ERROR_TOO_LONG) {
+                hi = end - 1;
+            } else {
+                strcpy(symbol->errtxt, probe->errtxt); /* Already tagged */
+                return error_number;
+            }
+        }
+        if (lo == 0) {
+            strcpy(symbol->errtxt, probe->errtxt); /* Nothing fits, so last error too long */
+            return ZINT_ERROR_TOO_LONG;
+        }
+        starts[count] = start;
+        start += lo;
+    }
+    starts[count] = length;
+    *p_count = count;
+
+    return 0;
+}
+
+/* Delete the first `count` symbols of `symbols`, then the array itself, allocated with `allocator` */
+static void structapp_free(struct zint_symbol **symbols, const int count, const struct zint_allocator *allocator) {
+    int i;
+
+    for (i = 0; i < count; i++) {
+        ZBarcode_Delete(symbols[i]);
+    }
+    z_free(allocator, symbols);
+}
+
+/* Create the `count` symbols of the sequence in `*p_symbols`, setting up `parts` to encode them. Returns 0 on
+   failure */
+static int structapp_create(const struct zint_symbol *symbol, const struct zint_structapp *structapp,
+            const unsigned char source[], const int starts[], const int count, struct structapp_part parts[],
+            struct zint_symbol ***p_symbols) {
+    struct zint_symbol **symbols;
+    int i;
+
+    if (!(symbols = (struct zint_symbol **) z_malloc(z_allocator(symbol), sizeof(struct zint_symbol *) * count))) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        if (!(symbols[i] = ZBarcode_Create_Allocator(z_allocator(symbol)))) {
+            structapp_free(symbols, i, z_allocator(symbol));
+            return 0;
+        }
+        strcpy(symbols[i]->outfile, symbol->outfile);
+        strcpy(symbols[i]->primary, symbol->primary);
+        symbols[i]->internal->run_fn = symbol->internal->run_fn;
+        symbols[i]->internal->run_context = symbol->internal->run_context;
+        symbols[i]->debug = symbol->debug;
+        if (count > 1) {
+            symbols[i]->structapp = *structapp;
+            symbols[i]->structapp.index = i + 1;
+            symbols[i]->structapp.count = count;
+        }
+        parts[i].symbol = symbols[i];
+        parts[i].source = source + starts[i];
+        parts[i].length = starts[i + 1] - starts[i];
+    }
+    *p_symbols = symbols;
+
+    return 1;
+}
+
+/* Encode `source` of length `in_length` (set to its length if <= 0) as a Structured Append sequence of as few
+   symbols as it needs, each with the settings of `symbol`, which is left unchanged apart from `errtxt`. The input is
+   split greedily, each symbol taking the longest remaining part that fits (found by binary search on measuring
+   encodes, see `ZBarcode_Measure()`), UTF-8 sequences not being split in UNICODE_MODE. If it all fits into one
+   symbol, the sequence is that symbol without Structured Append. The symbols are then encoded on up to `threads`
+   threads (if available, else serially), and returned in `*p_symbols` (`*p_count` of them), to be freed by
+   `ZBarcode_Structapp_Delete()`. `symbol->structapp.id` is used as the sequence ID, defaulting for QR Code to the
+   parity of the whole input */
+int ZBarcode_Encode_Structapp(struct zint_symbol *symbol, const unsigned char *source, int in_length, int threads,
+            struct zint_symbol ***p_symbols, int *p_count) {
+    struct zint_prepared *prepared;
+    struct zint_symbol *probe;
+    struct zint_symbol **symbols = NULL;
+    struct structapp_part parts[STRUCTAPP_MAX];
+    struct zint_structapp structapp;
+    int starts[STRUCTAPP_MAX + 1];
+    int warn_number, error_number;
+    int symbology, count, i;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!p_symbols || !p_count) {
+        strcpy(symbol->errtxt, "701: Structured Append result pointers NULL");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    *p_symbols = NULL;
+    *p_count = 0;
+
+    if ((symbol->input_mode & 0x07) == GS1_MODE || (symbol->input_mode & ESCAPE_MODE)) {
+        strcpy(symbol->errtxt, "702: Cannot split input for Structured Append in GS1 or escape mode");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    error_number = check_source(symbol, source, &in_length);
+    if (error_number != 0) {
+        return error_tag(symbol->errtxt, error_number);
+    }
+
+    warn_number = ZBarcode_Prepare(symbol, &prepared);
+    if (warn_number >= ZINT_ERROR) {
+        return warn_number;
+    }
+    symbology = prepared->settings.symbology; /* As possibly remapped */
+    if (!(symbology_flags(symbology) & ZINT_CAP_STRUCTAPP)) {
+        ZBarcode_Prepared_Delete(prepared);
+        strcpy(symbol->errtxt, "703: Symbology does not support Structured Append");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    if (!(probe = ZBarcode_Create_Allocator(z_allocator(symbol)))) {
+        ZBarcode_Prepared_Delete(prepared);
+        strcpy(symbol->errtxt, "704: Insufficient memory for Structured Append");
+        return error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+    }
+    strcpy(probe->primary, symbol->primary);
+    probe->debug = ZINT_MEASURE_ONLY; /* Sizing only */
+
+    structapp = symbol->structapp;
+    if (symbology == BARCODE_QRCODE && !structapp.id[0]) {
+        int parity = 0;
+        for (i = 0; i < in_length; i++) {
+            parity ^= source[i];
+        }
+        sprintf(structapp.id, "%d", parity);
+    }
+
+    /* Try the whole input first, only splitting if too long */
+    starts[0] = 0;
+    starts[1] = in_length;
+    count = 1;
+    error_number = ZBarcode_Encode_Prepared(prepared, probe, source, in_length);
+    if (error_number == ZINT_ERROR_TOO_LONG) {
+        /* The size of the SA Info doesn't depend on the index or count, so size with the maximum */
+        probe->structapp = structapp;
+        probe->structapp.index = 1;
+        probe->structapp.count = structapp_max_count(symbology);
+        error_number = structapp_split(symbol, prepared, probe, source, in_length, probe->structapp.count,
+                                (prepared->settings.input_mode & 0x07) == UNICODE_MODE, starts, &count);
+    } else if (error_number >= ZINT_ERROR) {
+        strcpy(symbol->errtxt, probe->errtxt); /* Already tagged */
+    } else {
+        error_number = 0;
+    }
+    ZBarcode_Delete(probe);
+
+    if (error_number == 0 && !structapp_create(symbol, &structapp, source, starts, count, parts, &symbols)) {
+        strcpy(symbol->errtxt, "704: Insufficient memory for Structured Append");
+        error_number = error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+    }
+    if (error_number == 0) {
+        structapp_encode(symbol, prepared, parts, count, threads);
+
+        for (i = 0; i < count; i++) {
+            if (parts[i].error_number >= ZINT_ERROR) {
+                sprintf(symbol->errtxt, "706: Structured Append symbol %d: %.60s", i + 1, symbols[i]->errtxt);
+                error_number = error_tag(symbol->errtxt, parts[i].error_number);
+                ZBarcode_Structapp_Delete(symbols, count);
+                break;
+            }
+            if (parts[i].error_number > warn_number) {
+                warn_number = parts[i].error_number;
+                strcpy(symbol->errtxt, symbols[i]->errtxt);
+            }
+        }
+    }
+    ZBarcode_Prepared_Delete(prepared);
+
+    if (error_number != 0) {
+        return error_number;
+    }
+    *p_symbols = symbols;
+    *p_count = count;
+
+    return warn_number;
+}
+
+void ZBarcode_Structapp_Delete(struct zint_symbol **symbols, int count) {
+    struct zint_allocator allocator;
+
+    if (!symbols) return;
+
+    /* The array was allocated with the allocator of the symbols */
+    if (count > 0 && symbols[0]) {
+        allocator = symbols[0]->internal->allocator;
+    } else {
+        memset(&allocator, 0, sizeof(allocator));
+    }
+    structapp_free(symbols, count, &allocator);
+}
+
+/* The `index`th oldest structured trace record kept by the last `ZBarcode_Encode()` (if `debug` ZINT_DEBUG_TRACE),
+   or NULL if none. Only the last ZINT_TRACE_RECORDS (64) of `trace_record_count` are kept */
+const struct zint_trace_record *ZBarcode_Trace_Record(const struct zint_symbol *symbol, int index) {
+    int count;
+
+    if (!symbol || index < 0 || !symbol->internal->trace_records) {
+        return NULL;
+    }
+    count = symbol->trace_record_count < ZINT_TRACE_RECORDS ? symbol->trace_record_count : ZINT_TRACE_RECORDS;
+    if (index >= count) {
+        return NULL;
+    }
+    return symbol->internal->trace_records + (symbol->trace_record_count - count + index) % ZINT_TRACE_RECORDS;
+}
+
+/* Free the symbology-specific data of `incremental` */
+static void incremental_data_free(struct zint_incremental *incremental) {
+    if (incremental->data) {
+        (*incremental->data_free)(incremental->data);
+        incremental->data = NULL;
+    }
+}
+
+struct zint_incremental *ZBarcode_Incremental_Create(void) {
+    return (struct zint_incremental *) z_calloc(NULL, 1, sizeof(struct zint_incremental));
+}
+
+/* As `ZBarcode_Encode()`, except that encoders that support it (currently Data Matrix) keep state in
+   `incremental` so that the part of `source` unchanged from the previous call needn't be encoded again */
+int ZBarcode_Encode_Incremental(struct zint_incremental *incremental, struct zint_symbol *symbol,
+            const unsigned char *source, int in_length) {
+    int error_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!incremental || (symbol->debug & (ZINT_DEBUG_PRINT | ZINT_DEBUG_TRACE))) {
+        return ZBarcode_Encode(symbol, source, in_length);
+    }
+
+    if (incremental->symbology != symbol->symbology) {
+        incremental_data_free(incremental);
+        incremental->symbology = symbol->symbology;
+    }
+
+    symbol->internal->incremental = incremental;
+    error_number = ZBarcode_Encode(symbol, source, in_length);
+    symbol->internal->incremental = NULL;
+
+    return error_number;
+}
+
+void ZBarcode_Incremental_Delete(struct zint_incremental *incremental) {
+    if (!incremental) return;
+
+    incremental_data_free(incremental);
+    z_free(NULL, incremental);
+}
+
+/* Write `value` to `buf` as decimal, padded on the left with `pad` to at least `width`, returning length */
+static int sequence_counter(char buf[], unsigned long value, const int width, const char pad) {
+    char digits[24];
+    int len = 0, i = 0;
+
+    do {
+        digits[len++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value);
+    for (; i < width - len; i++) {
+        buf[i] = pad;
+    }
+    while (len) {
+        buf[i++] = digits[--len];
+    }
+
+    return i;
+}
+
+/* GS1 or Luhn Mod 10 check digit of the digits at the end of `data` */
+static char sequence_check_digit(const char data[], int length, const int check_digit) {
+    int sum = 0, weight3 = 1;
+
+    for (; length && data[length - 1] >= '0' && data[length - 1] <= '9'; length--, weight3 = !weight3) {
+        const int digit = data[length - 1] - '0';
+        if (check_digit == SEQUENCE_CHECK_GS1) {
+            sum += weight3 ? digit * 3 : digit;
+        } else {
+            sum += weight3 ? (digit < 5 ? digit * 2 : digit * 2 - 9) : digit; /* Luhn doubles the rightmost */
+        }
+    }
+
+    return (char) ('0' + (10 - sum % 10) % 10);
+}
+
+/* Encode `count` items generated from `sequence` with the same settings, as `ZBarcode_Encode_Batch()` would given
+   the data of each, but without the caller formatting it, and encoding incrementally so that the unchanged
+   prefix of each item needn't be encoded again where supported (see `ZBarcode_Encode_Incremental()`). `item_func`
+   (if non-NULL) is called with the encoded symbol, returning non-zero to stop. Returns an error if the settings or
+   sequence are invalid, else the highest item result */
+int ZBarcode_Encode_Sequence(struct zint_symbol *symbol, const struct zint_sequence *sequence, int count,
+            int (*item_func)(void *context, struct zint_symbol *symbol, int index, int error_number),
+            void *context) {
+    int warn_number, error_number;
+    int ret = 0;
+    int i;
+    int prefix_len, suffix_len;
+    char pad;
+    char *data;
+    struct batch_settings settings;
+    char settings_errtxt[100];
+    struct zint_incremental incremental;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!sequence || count < 0) {
+        strcpy(symbol->errtxt, "725: Invalid sequence");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    if (sequence->width < 0 || sequence->width > 20) {
+        strcpy(symbol->errtxt, "726: Sequence counter width out of range (0 to 20)");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    if (sequence->check_digit < SEQUENCE_CHECK_NONE || sequence->check_digit > SEQUENCE_CHECK_LUHN) {
+        strcpy(symbol->errtxt, "727: Invalid sequence check digit type");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    /* All counter values must be >= 0 and not overflow */
+    if (sequence->start < 0 || (count > 1 && sequence->step > 0
+                                    && (LONG_MAX - sequence->start) / sequence->step < count - 1)
+            || (count > 1 && sequence->step < 0
+                && (sequence->step == LONG_MIN || sequence->start / -sequence->step < count - 1))) {
+        strcpy(symbol->errtxt, "728: Sequence counter out of range");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    if (*symbol->outfile == '\0') {
+        strcpy(symbol->outfile, "out.png");
+    }
+
+    symbol->errtxt[0] = '\0';
+    warn_number = check_settings(symbol);
+    if (warn_number >= ZINT_ERROR) {
+        return error_tag(symbol->errtxt, warn_number);
+    }
+
+    prefix_len = sequence->prefix ? (int) strlen(sequence->prefix) : 0;
+    suffix_len = sequence->suffix ? (int) strlen(sequence->suffix) : 0;
+    if (prefix_len > ZINT_MAX_DATA_LEN || suffix_len > ZINT_MAX_DATA_LEN
+            || !(data = (char *) z_malloc(z_allocator(symbol), prefix_len + 20 + 1 + suffix_len + 1))) {
+        strcpy(symbol->errtxt, "729: Insufficient memory for sequence data");
+        return error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+    }
+    if (prefix_len) {
+        memcpy(data, sequence->prefix, prefix_len);
+    }
+    pad = sequence->pad ? sequence->pad : '0';
+
+    strcpy(settings_errtxt, symbol->errtxt); /* Untagged warning (if any) */
+    batch_settings_save(symbol, &settings);
+
+    memset(&incremental, 0, sizeof(incremental));
+    incremental.symbology = symbol->symbology;
+
+    for (i = 0; i < count; i++) {
+        int length = prefix_len + sequence_counter(data + prefix_len,
+                                    (unsigned long) (sequence->start + i * sequence->step), sequence->width, pad);
+        if (sequence->check_digit != SEQUENCE_CHECK_NONE) {
+            data[length] = sequence_check_digit(data, length, sequence->check_digit);
+            length++;
+        }
+        if (suffix_len) {
+            memcpy(data + length, sequence->suffix, suffix_len);
+            length += suffix_len;
+        }
+        data[length] = '\0';
+
+        ZBarcode_Clear(symbol);
+        batch_settings_restore(symbol, &settings);
+
+        error_number = check_source(symbol, (const unsigned char *) data, &length);
+        if (error_number != 0) {
+            (void) error_tag(symbol->errtxt, error_number);
+        } else {
+            strcpy(symbol->errtxt, settings_errtxt);
+            if (!(symbol->debug & (ZINT_DEBUG_PRINT | ZINT_DEBUG_TRACE))) {
+                symbol->internal->incremental = &incremental;
+            }
+            error_number = encode_source(symbol, (const unsigned char *) data, length, warn_number);
+            symbol->internal->incremental = NULL;
+            z_work_free(symbol);
+        }
+        if (error_number > ret) {
+            ret = error_number;
+        }
+
+        if (item_func && (*item_func)(context, symbol, i, error_number) != 0) {
+            break;
+        }
+    }
+
+    incremental_data_free(&incremental);
+    z_free(z_allocator(symbol), data);
+
+    return ret;
+}
+
 int ZBarcode_Print(struct zint_symbol *symbol, int rotate_angle) {
     int error_number;
 
@@ -1356,7 +2004,7 @@ int ZBarcode_Print(struct zint_symbol *symbol, int rotate_angle) {
     }
 
     if (symbol->output_options & BARCODE_DOTTY_MODE) {
-        if (!(is_dotty(symbol->symbology))) {
+        if (!(symbology_flags(symbol->symbology) & ZINT_CAP_DOTTY)) {
             strcpy(symbol->errtxt, "224: Selected symbology cannot be rendered as dots");
             return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
         }
@@ -1370,23 +2018,59 @@ int ZBarcode_Print(struct zint_symbol *symbol, int rotate_angle) {
         output[3] = '\0';
         to_upper((unsigned char *) output);
 
-        if (!(strcmp(output, "PNG"))) {
+        if (!(strcmp(output, "PNG"))) {
+            if (symbol->scale < 1.0f) {
+                symbol->text[0] = '\0';
+            }
+            error_number = plot_raster(symbol, rotate_angle, OUT_PNG_FILE);
+
+        } else if (!(strcmp(output, "BMP"))) {
+            if (symbol->scale < 1.0f) {
+                symbol->text[0] = '\0';
+            }
+            error_number = plot_raster(symbol, rotate_angle, OUT_BMP_FILE);
+
+        } else if (!(strcmp(output, "PCX"))) {
+            if (symbol->scale < 1.0f) {
+                symbol->text[0] = '\0';
+            }
+            error_number = plot_raster(symbol, rotate_angle, OUT_PCX_FILE);
+
+        } else if (!(strcmp(output, "PBM"))) {
+            if (symbol->scale < 1.0f) {
+                symbol->text[0] = '\0';
+            }
+            error_number = plot_raster(symbol, rotate_angle, OUT_PBM_FILE);
+
+        } else if (!(strcmp(output, "PGM"))) {
             if (symbol->scale < 1.0f) {
                 symbol->text[0] = '\0';
             }
-            error_number = plot_raster(symbol, rotate_angle, OUT_PNG_FILE);
+            error_number = plot_raster(symbol, rotate_angle, OUT_PGM_FILE);
 
-        } else if (!(strcmp(output, "BMP"))) {
+        } else if (!(strcmp(output, "ZPL"))) {
             if (symbol->scale < 1.0f) {
                 symbol->text[0] = '\0';
             }
-            error_number = plot_raster(symbol, rotate_angle, OUT_BMP_FILE);
+            error_number = plot_raster(symbol, rotate_angle, OUT_ZPL_FILE);
 
-        } else if (!(strcmp(output, "PCX"))) {
+        } else if (!(strcmp(output, "EPL"))) {
             if (symbol->scale < 1.0f) {
                 symbol->text[0] = '\0';
             }
-            error_number = plot_raster(symbol, rotate_angle, OUT_PCX_FILE);
+            error_number = plot_raster(symbol, rotate_angle, OUT_EPL_FILE);
+
+        } else if (!(strcmp(output, "PCL"))) {
+            if (symbol->scale < 1.0f) {
+                symbol->text[0] = '\0';
+            }
+            error_number = plot_raster(symbol, rotate_angle, OUT_PCL_FILE);
+
+        } else if (!(strcmp(output, "QOI"))) {
+            if (symbol->scale < 1.0f) {
+                symbol->text[0] = '\0';
+            }
+            error_number = plot_raster(symbol, rotate_angle, OUT_QOI_FILE);
 
         } else if (!(strcmp(output, "GIF"))) {
             if (symbol->scale < 1.0f) {
@@ -1409,9 +2093,19 @@ int ZBarcode_Print(struct zint_symbol *symbol, int rotate_angle) {
         } else if (!(strcmp(output, "SVG"))) {
             error_number = plot_vector(symbol, rotate_angle, OUT_SVG_FILE);
 
+        } else if (!(strcmp(output, "VGZ")) && (symbol->outfile[strlen(symbol->outfile) - 4] | 0x20) == 's') {
+            /* ".svgz" is gzipped SVG */
+            const int output_options = symbol->output_options;
+            symbol->output_options |= SVG_GZIP;
+            error_number = plot_vector(symbol, rotate_angle, OUT_SVG_FILE);
+            symbol->output_options = output_options;
+
         } else if (!(strcmp(output, "EMF"))) {
             error_number = plot_vector(symbol, rotate_angle, OUT_EMF_FILE);
 
+        } else if (!(strcmp(output, "PDF"))) {
+            error_number = plot_vector(symbol, rotate_angle, OUT_PDF_FILE);
+
         } else {
             strcpy(symbol->errtxt, "225: Unknown output format");
             return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
@@ -1442,7 +2136,7 @@ int ZBarcode_Buffer(struct zint_symbol *symbol, int rotate_angle) {
     }
 
     if (symbol->output_options & BARCODE_DOTTY_MODE) {
-        if (!(is_dotty(symbol->symbology))) {
+        if (!(symbology_flags(symbol->symbology) & ZINT_CAP_DOTTY)) {
             strcpy(symbol->errtxt, "237: Selected symbology cannot be rendered as dots");
             return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
         }
@@ -1452,6 +2146,160 @@ int ZBarcode_Buffer(struct zint_symbol *symbol, int rotate_angle) {
     return error_tag(symbol->errtxt, error_number);
 }
 
+/* As `ZBarcode_Buffer()` but render into caller's buffer `target` at its offset instead of `symbol->bitmap`, which
+   is left NULL (`bitmap_width` and `bitmap_height` are set). OUT_BUFFER_XXX options are ignored */
+int ZBarcode_Buffer_Target(struct zint_symbol *symbol, int rotate_angle, const struct zint_target *target) {
+    int min_stride;
+    int error_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!target) {
+        strcpy(symbol->errtxt, "477: Target NULL");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+
+    switch (target->format) {
+        case ZINT_PIXEL_GRAY8:
+            min_stride = target->width;
+            break;
+        case ZINT_PIXEL_MONO1:
+            min_stride = (target->width + 7) / 8;
+            break;
+        case ZINT_PIXEL_RGB24:
+            min_stride = target->width * 3;
+            break;
+        case ZINT_PIXEL_RGBA32:
+        case ZINT_PIXEL_BGRA32:
+            min_stride = target->width * 4;
+            break;
+        default:
+            sprintf(symbol->errtxt, "478: Invalid target pixel format %d", target->format);
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            break;
+    }
+    if (!target->pixels || target->width <= 0 || target->height <= 0 || target->width > INT_MAX / 4
+            || target->stride < min_stride) {
+        strcpy(symbol->errtxt, "479: Invalid target buffer, size or stride");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    switch (rotate_angle) {
+        case 0:
+        case 90:
+        case 180:
+        case 270:
+            break;
+        default:
+            strcpy(symbol->errtxt, "536: Invalid rotation angle");
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            break;
+    }
+
+    if (symbol->output_options & BARCODE_DOTTY_MODE) {
+        if (!(symbology_flags(symbol->symbology) & ZINT_CAP_DOTTY)) {
+            strcpy(symbol->errtxt, "537: Selected symbology cannot be rendered as dots");
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+    }
+
+    error_number = plot_raster_target(symbol, rotate_angle, target);
+    return error_tag(symbol->errtxt, error_number);
+}
+
+/* Set `*p_width` and `*p_height` to the `ZBarcode_Buffer()` bitmap dimensions at `scale` without plotting */
+static int buffer_fit_measure(struct zint_symbol *symbol, const int rotate_angle, const float scale, int *p_width,
+            int *p_height) {
+    int error_number;
+
+    symbol->scale = scale;
+    error_number = plot_raster(symbol, rotate_angle, OUT_MEASURE);
+    *p_width = symbol->bitmap_width;
+    *p_height = symbol->bitmap_height;
+    symbol->bitmap_width = symbol->bitmap_height = 0;
+
+    return error_number;
+}
+
+#define FIT_REF_SCALE   10.0f /* Reference scale at which the bitmap is measured to estimate the fit */
+#define FIT_MAX_SCALE   1000.0f
+
+/* Render encoded `symbol` to `symbol->bitmap` as `ZBarcode_Buffer()` at the largest scale giving a bitmap within
+   `max_width` x `max_height` pixels (either may be zero for no limit), leaving `symbol->scale` set to it. If
+   `integer_modules_only`, the scale is a multiple of 0.5 (a whole number of pixels per module, no resampling),
+   otherwise a multiple of 0.01. As the bitmap dimensions are (near) linear in the scale, it is estimated from
+   those at a reference scale, then checked (and bracketed if rounding means it doesn't quite fit) by measuring
+   without plotting, so that the bitmap is rendered just once */
+int ZBarcode_Buffer_Fit(struct zint_symbol *symbol, int rotate_angle, int max_width, int max_height,
+            int integer_modules_only) {
+    const float step = integer_modules_only ? 0.5f : 0.01f;
+    const int lo_min = integer_modules_only ? 1 : 50; /* Scale 0.5 minimum */
+    const float scale = symbol ? symbol->scale : 0.0f;
+    float estimate = 0.0f;
+    int ref_width, ref_height;
+    int lo, hi;
+    int error_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (max_width < 0 || max_height < 0 || (max_width == 0 && max_height == 0)) {
+        sprintf(symbol->errtxt, "755: Invalid maximum size %dx%d", max_width, max_height);
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    if (rotate_angle != 0 && rotate_angle != 90 && rotate_angle != 180 && rotate_angle != 270) {
+        strcpy(symbol->errtxt, "756: Invalid rotation angle");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    if ((symbol->output_options & BARCODE_DOTTY_MODE) && !(symbology_flags(symbol->symbology) & ZINT_CAP_DOTTY)) {
+        strcpy(symbol->errtxt, "757: Selected symbology cannot be rendered as dots");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    error_number = buffer_fit_measure(symbol, rotate_angle, FIT_REF_SCALE, &ref_width, &ref_height);
+    if (error_number >= ZINT_ERROR) {
+        symbol->scale = scale;
+        return error_tag(symbol->errtxt, error_number);
+    }
+    if (max_width) {
+        estimate = FIT_REF_SCALE * max_width / ref_width;
+    }
+    if (max_height && (!max_width || FIT_REF_SCALE * max_height / ref_height < estimate)) {
+        estimate = FIT_REF_SCALE * max_height / ref_height;
+    }
+    if (estimate > FIT_MAX_SCALE) {
+        estimate = FIT_MAX_SCALE;
+    }
+
+    /* Largest step count `lo` that fits, allowing some leeway for rounding either side of the estimate */
+    lo = lo_min;
+    hi = (int) (estimate / step);
+    hi += hi / 8 + 2;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo + 1) / 2;
+        int width, height;
+        (void) buffer_fit_measure(symbol, rotate_angle, mid * step, &width, &height);
+        if ((!max_width || width <= max_width) && (!max_height || height <= max_height)) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    if (lo == lo_min) {
+        int width, height;
+        (void) buffer_fit_measure(symbol, rotate_angle, lo * step, &width, &height);
+        if ((max_width && width > max_width) || (max_height && height > max_height)) {
+            symbol->scale = scale;
+            sprintf(symbol->errtxt, "758: Symbol too large (%dx%d pixels at minimum scale) for %dx%d", width,
+                    height, max_width, max_height);
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+    }
+
+    symbol->scale = lo * step;
+    error_number = plot_raster(symbol, rotate_angle, OUT_BUFFER);
+    return error_tag(symbol->errtxt, error_number);
+}
+
 int ZBarcode_Buffer_Vector(struct zint_symbol *symbol, int rotate_angle) {
     int error_number;
 
@@ -1470,7 +2318,7 @@ int ZBarcode_Buffer_Vector(struct zint_symbol *symbol, int rotate_angle) {
     }
 
     if (symbol->output_options & BARCODE_DOTTY_MODE) {
-        if (!(is_dotty(symbol->symbology))) {
+        if (!(symbology_flags(symbol->symbology) & ZINT_CAP_DOTTY)) {
             strcpy(symbol->errtxt, "238: Selected symbology cannot be rendered as dots");
             return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
         }
@@ -1480,6 +2328,125 @@ int ZBarcode_Buffer_Vector(struct zint_symbol *symbol, int rotate_angle) {
     return error_tag(symbol->errtxt, error_number);
 }
 
+/* As `ZBarcode_Buffer_Vector()` but pass each element to `callbacks` as it's plotted, scaled and rotated, instead of
+   building `symbol->vector` (left NULL). UPC/EAN elements are passed on once their guard bars are extended */
+int ZBarcode_Render_Callbacks(struct zint_symbol *symbol, int rotate_angle,
+            const struct zint_render_callbacks *callbacks) {
+    int error_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!callbacks) {
+        strcpy(symbol->errtxt, "738: Invalid render callbacks argument");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    switch (rotate_angle) {
+        case 0:
+        case 90:
+        case 180:
+        case 270:
+            break;
+        default:
+            strcpy(symbol->errtxt, "219: Invalid rotation angle");
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            break;
+    }
+
+    if (symbol->output_options & BARCODE_DOTTY_MODE) {
+        if (!(symbology_flags(symbol->symbology) & ZINT_CAP_DOTTY)) {
+            strcpy(symbol->errtxt, "238: Selected symbology cannot be rendered as dots");
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+    }
+
+    error_number = plot_vector_callbacks(symbol, rotate_angle, callbacks);
+    return error_tag(symbol->errtxt, error_number);
+}
+
+/* Size the symbol that `ZBarcode_Encode()` and `ZBarcode_Buffer()` would give without placing its modules or
+   rendering it: matrix symbologies that can (QR Code, Micro QR, rMQR, UPNQR, Data Matrix and DotCode) stop once
+   their mode optimisation and capacity lookup have chosen a size, skipping error correction, placement and masking,
+   while others are encoded fully. The symbol is left cleared, other than `errtxt`, and its settings unchanged */
+int ZBarcode_Measure(struct zint_symbol *symbol, const unsigned char *source, int in_length, int rotate_angle,
+            struct zint_measure *measure) {
+    const struct zint_trace_record *record;
+    struct batch_settings settings;
+    int debug, trace_record_count;
+    char errtxt[sizeof(symbol->errtxt)];
+    int error_number, i;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!measure) {
+        strcpy(symbol->errtxt, "297: Invalid measure argument");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    memset(measure, 0, sizeof(*measure));
+    measure->ecc_level = -1;
+    measure->data_codewords = -1;
+    measure->ecc_codewords = -1;
+
+    switch (rotate_angle) {
+        case 0:
+        case 90:
+        case 180:
+        case 270:
+            break;
+        default:
+            strcpy(symbol->errtxt, "298: Invalid rotation angle");
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+            break;
+    }
+
+    /* The size and codeword counts are taken from the trace records */
+    batch_settings_save(symbol, &settings);
+    debug = symbol->debug;
+    symbol->debug |= ZINT_MEASURE_ONLY | ZINT_DEBUG_TRACE;
+    ZBarcode_Clear(symbol);
+    error_number = ZBarcode_Encode(symbol, source, in_length);
+
+    if (error_number < ZINT_ERROR) {
+        measure->rows = symbol->rows;
+        measure->width = symbol->width;
+        measure->height = symbol->height;
+        for (i = 0; (record = ZBarcode_Trace_Record(symbol, i)); i++) {
+            if (record->kind == ZINT_RECORD_SIZE) {
+                measure->version = record->values[0];
+                measure->ecc_level = record->values[3];
+            } else if (record->kind == ZINT_RECORD_CODEWORDS) {
+                measure->data_codewords = record->values[0];
+                measure->ecc_codewords = record->values[1];
+            }
+        }
+        if ((symbol->output_options & BARCODE_DOTTY_MODE)
+                && !(symbology_flags(symbol->symbology) & ZINT_CAP_DOTTY)) {
+            strcpy(symbol->errtxt, "299: Selected symbology cannot be rendered as dots");
+            error_number = error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        } else {
+            const int raster_error = plot_raster(symbol, rotate_angle, OUT_MEASURE);
+            if (raster_error) {
+                error_number = error_tag(symbol->errtxt, raster_error);
+            } else {
+                measure->bitmap_width = symbol->bitmap_width;
+                measure->bitmap_height = symbol->bitmap_height;
+            }
+        }
+    }
+
+    batch_settings_restore(symbol, &settings);
+    symbol->debug = debug;
+    strcpy(errtxt, symbol->errtxt);
+    trace_record_count = symbol->trace_record_count;
+    ZBarcode_Clear(symbol);
+    strcpy(symbol->errtxt, errtxt);
+    if (debug & ZINT_DEBUG_TRACE) {
+        symbol->trace_record_count = trace_record_count;
+    }
+
+    return error_number;
+}
+
 int ZBarcode_Encode_and_Print(struct zint_symbol *symbol, unsigned char *input, int length, int rotate_angle) {
     int error_number;
     int first_err;
@@ -1533,10 +2500,129 @@ int ZBarcode_Encode_and_Buffer_Vector(struct zint_symbol *symbol, unsigned char
     return error_number;
 }
 
+#ifdef ZINT_HAVE_MMAP
+/* Map regular file `filename` read-only into `*p_data` of length `*p_length`, to be unmapped with `unmap_file()`.
+   Returns 1 if mapped, 0 if not (not a regular file, or mapping failed), leaving it to be read, or an error */
+static int map_file(struct zint_symbol *symbol, const char *filename, const unsigned char **p_data, int *p_length) {
+    long long file_len;
+    void *data;
+#ifdef _WIN32
+    HANDLE file, mapping;
+    LARGE_INTEGER size;
+
+    file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return 0; /* Leave error reporting to `fopen()` */
+    }
+    if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return 0;
+    }
+    file_len = size.QuadPart;
+#else
+    int fd;
+    struct stat st;
+
+    fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        return 0; /* Leave error reporting to `fopen()` */
+    }
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return 0;
+    }
+    file_len = st.st_size;
+#endif
+
+    if (file_len <= 0 || file_len > ZINT_MAX_DATA_LEN) {
+#ifdef _WIN32
+        CloseHandle(file);
+#else
+        close(fd);
+#endif
+        if (file_len <= 0) {
+            strcpy(symbol->errtxt, "235: Input file empty or unseekable");
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+        }
+        strcpy(symbol->errtxt, "230: Input file too long");
+        return error_tag(symbol->errtxt, ZINT_ERROR_TOO_LONG);
+    }
+
+#ifdef _WIN32
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (mapping) {
+        CloseHandle(mapping); /* View keeps it open */
+    }
+    CloseHandle(file);
+    if (!data) {
+        return 0;
+    }
+#else
+    data = mmap(NULL, (size_t) file_len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /* Mapping keeps it open */
+    if (data == MAP_FAILED) {
+        return 0;
+    }
+#endif
+
+    *p_data = (const unsigned char *) data;
+    *p_length = (int) file_len;
+
+    return 1;
+}
+
+static void unmap_file(const unsigned char *data, const int length) {
+#ifdef _WIN32
+    (void) length;
+    UnmapViewOfFile(data);
+#else
+    munmap((void *) data, (size_t) length);
+#endif
+}
+#endif /* ZINT_HAVE_MMAP */
+
+/* Read stream `file` (stdin or pipe) into a buffer grown as needed, up to ZINT_MAX_DATA_LEN bytes */
+static int read_stream(struct zint_symbol *symbol, FILE *file, unsigned char **p_buffer, int *p_length) {
+    unsigned char *buffer = NULL;
+    int size = 0;
+    int nRead = 0;
+    size_t n;
+
+    do {
+        if (nRead == size) {
+            unsigned char *new_buffer;
+            size = size ? size * 2 : 4096;
+            if (size > ZINT_MAX_DATA_LEN) {
+                size = ZINT_MAX_DATA_LEN;
+            }
+            if (!(new_buffer = (unsigned char *) z_realloc(z_allocator(symbol), buffer, size))) {
+                z_free(z_allocator(symbol), buffer);
+                strcpy(symbol->errtxt, "231: Internal memory error");
+                return error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+            }
+            buffer = new_buffer;
+        }
+        n = fread(buffer + nRead, 1, size - nRead, file);
+        if (ferror(file)) {
+            sprintf(symbol->errtxt, "241: Input file read error (%.30s)", strerror(errno));
+            z_free(z_allocator(symbol), buffer);
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+        }
+        nRead += (int) n;
+    } while (!feof(file) && (0 < n) && (nRead < ZINT_MAX_DATA_LEN));
+
+    *p_buffer = buffer;
+    *p_length = nRead;
+
+    return 0;
+}
+
+/* Encode the contents of `filename` ("-" for stdin). Regular files are memory-mapped where supported and passed
+   to the encoder directly */
 int ZBarcode_Encode_File(struct zint_symbol *symbol, char *filename) {
     FILE *file;
-    int file_opened = 0;
-    unsigned char *buffer;
+    unsigned char *buffer = NULL;
     long fileLen;
     size_t n;
     int nRead = 0;
@@ -1550,41 +2636,58 @@ int ZBarcode_Encode_File(struct zint_symbol *symbol, char *filename) {
     }
 
     if (!strcmp(filename, "-")) {
-        file = stdin;
-        fileLen = ZINT_MAX_DATA_LEN;
-    } else {
-        file = fopen(filename, "rb");
-        if (!file) {
-            sprintf(symbol->errtxt, "229: Unable to read input file (%.30s)", strerror(errno));
-            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+        ret = read_stream(symbol, stdin, &buffer, &nRead);
+        if (ret != 0) {
+            return ret;
         }
-        file_opened = 1;
-
-        /* Get file length */
-        fseek(file, 0, SEEK_END);
-        fileLen = ftell(file);
-        fseek(file, 0, SEEK_SET);
+        ret = ZBarcode_Encode(symbol, buffer, nRead);
+        z_free(z_allocator(symbol), buffer);
+        return ret;
+    }
 
-        /* On many Linux distros ftell() returns LONG_MAX not -1 on error */
-        if (fileLen <= 0 || fileLen == LONG_MAX) {
-            strcpy(symbol->errtxt, "235: Input file empty or unseekable");
-            fclose(file);
-            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+#ifdef ZINT_HAVE_MMAP
+    {
+        const unsigned char *data = NULL;
+        ret = map_file(symbol, filename, &data, &nRead);
+        if (ret >= ZINT_ERROR) {
+            return ret;
         }
-        if (fileLen > ZINT_MAX_DATA_LEN) {
-            strcpy(symbol->errtxt, "230: Input file too long");
-            fclose(file);
-            return error_tag(symbol->errtxt, ZINT_ERROR_TOO_LONG);
+        if (ret == 1) {
+            ret = ZBarcode_Encode(symbol, data, nRead);
+            unmap_file(data, nRead);
+            return ret;
         }
     }
+#endif
+
+    file = fopen(filename, "rb");
+    if (!file) {
+        sprintf(symbol->errtxt, "229: Unable to read input file (%.30s)", strerror(errno));
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+
+    /* Get file length */
+    fseek(file, 0, SEEK_END);
+    fileLen = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    /* On many Linux distros ftell() returns LONG_MAX not -1 on error */
+    if (fileLen <= 0 || fileLen == LONG_MAX) {
+        strcpy(symbol->errtxt, "235: Input file empty or unseekable");
+        fclose(file);
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+    if (fileLen > ZINT_MAX_DATA_LEN) {
+        strcpy(symbol->errtxt, "230: Input file too long");
+        fclose(file);
+        return error_tag(symbol->errtxt, ZINT_ERROR_TOO_LONG);
+    }
 
     /* Allocate memory */
-    buffer = (unsigned char *) malloc(fileLen);
+    buffer = (unsigned char *) z_malloc(z_allocator(symbol), fileLen);
     if (!buffer) {
         strcpy(symbol->errtxt, "231: Internal memory error");
-        if (file_opened) {
-            fclose(file);
-        }
+        fclose(file);
         return error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
     }
 
@@ -1594,20 +2697,16 @@ int ZBarcode_Encode_File(struct zint_symbol *symbol, char *filename) {
         n = fread(buffer + nRead, 1, fileLen - nRead, file);
         if (ferror(file)) {
             sprintf(symbol->errtxt, "241: Input file read error (%.30s)", strerror(errno));
-            if (file_opened) {
-                fclose(file);
-            }
-            free(buffer);
+            fclose(file);
+            z_free(z_allocator(symbol), buffer);
             return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
         }
         nRead += n;
     } while (!feof(file) && (0 < n) && (nRead < fileLen));
 
-    if (file_opened) {
-        fclose(file);
-    }
+    fclose(file);
     ret = ZBarcode_Encode(symbol, buffer, nRead);
-    free(buffer);
+    z_free(z_allocator(symbol), buffer);
     return ret;
 }
 
@@ -1665,6 +2764,86 @@ int ZBarcode_Encode_File_and_Buffer_Vector(struct zint_symbol *symbol, char *fil
     return error_number;
 }
 
+/* Set `fgcolour` and/or `bgcolour` (NULL to leave as is), each 6 hex digits RRGGBB or 8 RRGGBBAA, checking them and
+   setting `fgcolour_rgba`, `bgcolour_rgba` now rather than on output. Neither is changed on error */
+int ZBarcode_Set_Colours(struct zint_symbol *symbol, const char *fgcolour, const char *bgcolour) {
+    char fg_prev[10], bg_prev[10];
+    unsigned int fg_rgba_prev, bg_rgba_prev;
+    int error_number;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (fgcolour && strlen(fgcolour) > 8) {
+        strcpy(symbol->errtxt, "651: Malformed foreground colour target");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    if (bgcolour && strlen(bgcolour) > 8) {
+        strcpy(symbol->errtxt, "652: Malformed background colour target");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    strcpy(fg_prev, symbol->fgcolour);
+    strcpy(bg_prev, symbol->bgcolour);
+    fg_rgba_prev = symbol->fgcolour_rgba;
+    bg_rgba_prev = symbol->bgcolour_rgba;
+    if (fgcolour) {
+        strcpy(symbol->fgcolour, fgcolour);
+    }
+    if (bgcolour) {
+        strcpy(symbol->bgcolour, bgcolour);
+    }
+
+    error_number = output_check_colour_options(symbol);
+    if (error_number) {
+        strcpy(symbol->fgcolour, fg_prev);
+        strcpy(symbol->bgcolour, bg_prev);
+        symbol->fgcolour_rgba = fg_rgba_prev;
+        symbol->bgcolour_rgba = bg_rgba_prev;
+        return error_tag(symbol->errtxt, error_number);
+    }
+
+    return 0;
+}
+
+/* Size of the static tables selected by `flags` (ZINT_INIT_XXX), paging them in if `touch` */
+static size_t init_tables(const int flags, const int touch) {
+    size_t size = 0;
+
+    if (flags & ZINT_INIT_RS) {
+        size += rs_tables_warm(touch);
+    }
+    if (flags & ZINT_INIT_ECI) {
+        size += eci_tables_warm(touch) + sjis_tables_warm(touch) + gb2312_tables_warm(touch)
+                + gb18030_tables_warm(touch);
+    }
+    if (flags & ZINT_INIT_SYMBOLOGY) {
+        size += aztec_tables_warm(touch) + pdf417_tables_warm(touch) + c49_tables_warm(touch)
+                + hx_tables_warm(touch);
+    }
+    if (flags & ZINT_INIT_FONTS) {
+        size += raster_fonts_warm(touch);
+    }
+    return size;
+}
+
+/* Make the tables selected by `flags` (ZINT_INIT_XXX) resident, so that the first encodes of a new process don't
+   pay for paging them in. As they are all static (read-only) this is thread-safe and may be called at any time */
+int ZBarcode_Init(int flags) {
+    if (flags & ~ZINT_INIT_ALL) {
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+    (void) init_tables(flags, 1 /*touch*/);
+    return 0;
+}
+
+/* Memory in bytes of the tables selected by `flags` (ZINT_INIT_XXX), -1 if `flags` invalid. As they are
+   read-only this is shared between processes using the same library */
+int ZBarcode_Init_Memory(int flags) {
+    if (flags & ~ZINT_INIT_ALL) {
+        return -1;
+    }
+    return (int) init_tables(flags, 0 /*touch*/);
+}
+
 int ZBarcode_Version() {
     if (ZINT_VERSION_BUILD) {
         return (ZINT_VERSION_MAJOR * 10000) + (ZINT_VERSION_MINOR * 100) + ZINT_VERSION_RELEASE * 10
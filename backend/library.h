@@ -0,0 +1,113 @@
+/*  library.h - internal functions of libzint shared by the API source files */
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#ifndef LIBRARY_H
+#define LIBRARY_H
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+struct out_target;
+
+/* Prefix `error_string` with "Error " or "Warning " as `error_number` is an error or a warning (if non-zero),
+   returning `error_number` */
+INTERNAL int error_tag(char error_string[100], int error_number);
+
+/* Settings that encoding may adjust, restored before each item by `ZBarcode_Encode_Batch()` */
+struct batch_settings {
+    int symbology;
+    int height;
+    int whitespace_width;
+    int whitespace_height;
+    int border_width;
+    int output_options;
+    float scale;
+    int option_1;
+    int option_2;
+    int option_3;
+    int show_hrt;
+    int input_mode;
+    int eci;
+    float dot_size;
+};
+
+
+INTERNAL void batch_settings_save(const struct zint_symbol *symbol, struct batch_settings *settings);
+INTERNAL void batch_settings_restore(struct zint_symbol *symbol, const struct batch_settings *settings);
+
+/* Check and adjust symbology, ECI and dot size settings, returning warning or (untagged) error */
+INTERNAL int check_settings(struct zint_symbol *symbol);
+
+/* Encode as `encode_source_data()`, within `symbol->time_budget_ms` if set, warning if it was exceeded (unless
+   another warning was given) */
+INTERNAL int encode_source(struct zint_symbol *symbol, const unsigned char *source, int in_length, int warn_number);
+
+/* Output a hexadecimal representation of the rendered symbol */
+INTERNAL int dump_plot(struct zint_symbol *symbol);
+
+INTERNAL int plot_raster(struct zint_symbol *symbol, int rotate_angle, int file_type); /* Plot to PNG/BMP/PCX */
+INTERNAL int plot_raster_target(struct zint_symbol *symbol, int rotate_angle, const struct zint_target *target);
+INTERNAL int plot_raster_sheet(struct zint_symbol *sheet, const int width, const int height,
+            const struct zint_sheet_item *items, const int count, const int file_type);
+INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_type); /* Plot to EPS/EMF/PDF/SVG */
+INTERNAL int plot_vector_callbacks(struct zint_symbol *symbol, int rotate_angle,
+            const struct zint_render_callbacks *callbacks); /* Plot to callbacks */
+INTERNAL int plot_raster_multi(struct zint_symbol *symbol, int rotate_angle, const struct out_target *targets,
+            const int count); /* Plot raster once to many files */
+INTERNAL int plot_vector_multi(struct zint_symbol *symbol, int rotate_angle, const struct out_target *targets,
+            const int count); /* Plot vector once to many files */
+INTERNAL int output_check_colour_options(struct zint_symbol *symbol); /* Check and upper-case colours */
+INTERNAL int pdf_plot_symbols(struct zint_symbol *symbols[], const int count); /* Multi-page PDF of plotted symbols */
+INTERNAL int tif_plot_symbols(struct zint_symbol *symbols[], const int count, const int rotate_angle);
+INTERNAL int output_excluded(struct zint_symbol *symbol); /* Fail output format left out of the build */
+
+#ifdef ZINT_NO_OUT_PDF
+#define pdf_plot_symbols(symbols, count) output_excluded(symbols[0])
+#endif
+#ifdef ZINT_NO_OUT_TIF
+#define tif_plot_symbols(symbols, count, rotate_angle) output_excluded(symbols[0])
+#endif
+
+/* Return the descriptor flags of `symbology`, 0 if not supported */
+INTERNAL unsigned int symbology_flags(const int symbology);
+
+/* Check input data `source` of length `*p_length` (set if <= 0 to `source` length) */
+INTERNAL int check_source(struct zint_symbol *symbol, const unsigned char *source, int *p_length);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LIBRARY_H */
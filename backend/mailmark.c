@@ -55,7 +55,7 @@
 #define SET_N "0123456789"
 #define SET_S " "
 
-static const char *postcode_format[6] = {
+static const char *const postcode_format[6] = {
     "FNFNLLNLS", "FFNNLLNLS", "FFNNNLLNL", "FFNFNLLNL", "FNNLLNLSS", "FNNNLLNLS"
 };
 
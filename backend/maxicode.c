@@ -103,16 +103,6 @@ static void maxi_do_secondary_chk_even(unsigned char maxi_codeword[144], const i
         maxi_codeword[ datalen + (2 * j) + 20] = results[ecclen - 1 - j];
 }
 
-/* Moves everything up so that a shift or latch can be inserted */
-static void maxi_bump(unsigned char set[], unsigned char character[], const int bump_posn, int *p_length) {
-
-    if (bump_posn < 143) {
-        memmove(set + bump_posn + 1, set + bump_posn, 143 - bump_posn);
-        memmove(character + bump_posn + 1, character + bump_posn, 143 - bump_posn);
-    }
-    (*p_length)++; /* Increment length regardless to make sure too long always triggered */
-}
-
 /* If the value is present in  array, return the value, else return badvalue */
 static int value_in_array(const unsigned char val, const unsigned char arr[], const int badvalue, const int arrLength) {
     int i;
@@ -144,10 +134,11 @@ static int bestSurroundingSet(const int index, const int length, const unsigned
 
 /* Format text according to Appendix A */
 static int maxi_text_process(unsigned char maxi_codeword[144], const int mode, const unsigned char in_source[], int length,
-            const int eci, const int scm_vv, const int debug_print) {
+            const int eci, const int scm_vv, const int structapp_cw, const int debug_print) {
 
     unsigned char set[144], character[144] = {0};
-    int i, count, current_set, padding_set;
+    unsigned char codewords[144 * 2 + 8]; /* At most 2 per character plus Structured Append, ECI and padding latch */
+    int i, count, current_set, padding_set, cw_len;
 
     static const unsigned char set15[2] = { 1, 5 };
     static const unsigned char set12[2] = { 1, 2 };
@@ -292,12 +283,56 @@ static int maxi_text_process(unsigned char maxi_codeword[144], const int mode, c
         }
     }
 
-    /* Add shift and latch characters */
+    /* Write the codewords in a single pass, inserting shifts and latches, compressing numbers and prefixing any
+       Structured Append and ECI as we go */
+    cw_len = 0;
+
+    /* Structured Append (Section 6.8), PAD followed by the position and total, at the beginning of message */
+    if (structapp_cw) {
+        codewords[cw_len++] = 33; /* PAD */
+        codewords[cw_len++] = structapp_cw;
+        if (debug_print) printf("SA %d ", structapp_cw);
+    }
+
+    /* Insert ECI at the beginning of message if needed */
+    /* Encode ECI assignment numbers according to table 3 */
+    if (eci != 0) {
+        codewords[cw_len++] = 27; // ECI
+        if (eci <= 31) {
+            codewords[cw_len++] = eci;
+        } else if (eci <= 1023) {
+            codewords[cw_len++] = 0x20 | ((eci >> 6) & 0x0F);
+            codewords[cw_len++] = eci & 0x3F;
+        } else if (eci <= 32767) {
+            codewords[cw_len++] = 0x30 | ((eci >> 12) & 0x07);
+            codewords[cw_len++] = (eci >> 6) & 0x3F;
+            codewords[cw_len++] = eci & 0x3F;
+        } else {
+            codewords[cw_len++] = 0x38 | ((eci >> 18) & 0x03);
+            codewords[cw_len++] = (eci >> 12) & 0x3F;
+            codewords[cw_len++] = (eci >> 6) & 0x3F;
+            codewords[cw_len++] = eci & 0x3F;
+        }
+    }
+
     current_set = 1;
-    i = 0;
-    do {
+    for (i = 0; i < length; i++) {
+
+        if (set[i] == 6) {
+            /* Number compression */
+            int value = to_int(character + i, 9);
+
+            codewords[cw_len++] = 31; /* NS */
+            codewords[cw_len++] = (value & 0x3f000000) >> 24;
+            codewords[cw_len++] = (value & 0xfc0000) >> 18;
+            codewords[cw_len++] = (value & 0x3f000) >> 12;
+            codewords[cw_len++] = (value & 0xfc0) >> 6;
+            codewords[cw_len++] = (value & 0x3f);
+            i += 8; /* Skip over remaining 8 digits */
+            continue;
+        }
 
-        if ((set[i] != current_set) && (set[i] != 6)) {
+        if (set[i] != current_set) {
             switch (set[i]) {
                 case 1:
                     if (current_set == 2) { /* Set B */
@@ -305,35 +340,30 @@ static int maxi_text_process(unsigned char maxi_codeword[144], const int mode, c
                             if (i + 2 < 144 && set[i + 2] == 1) {
                                 if (i + 3 < 144 && set[i + 3] == 1) {
                                     /* Latch A */
-                                    maxi_bump(set, character, i, &length);
-                                    character[i] = 63; /* Set B Latch A */
+                                    codewords[cw_len++] = 63; /* Set B Latch A */
                                     current_set = 1;
-                                    i += 3; /* Next 3 Set A so skip over */
                                     if (debug_print) printf("LCHA ");
                                 } else {
                                     /* 3 Shift A */
-                                    maxi_bump(set, character, i, &length);
-                                    character[i] = 57; /* Set B triple shift A */
-                                    i += 2; /* Next 2 Set A so skip over */
+                                    codewords[cw_len++] = 57; /* Set B triple shift A */
+                                    codewords[cw_len++] = character[i++];
+                                    codewords[cw_len++] = character[i++];
                                     if (debug_print) printf("3SHA ");
                                 }
                             } else {
                                 /* 2 Shift A */
-                                maxi_bump(set, character, i, &length);
-                                character[i] = 56; /* Set B double shift A */
-                                i++; /* Next Set A so skip over */
+                                codewords[cw_len++] = 56; /* Set B double shift A */
+                                codewords[cw_len++] = character[i++];
                                 if (debug_print) printf("2SHA ");
                             }
                         } else {
                             /* Shift A */
-                            maxi_bump(set, character, i, &length);
-                            character[i] = 59; /* Set A Shift B */
+                            codewords[cw_len++] = 59; /* Set B Shift A */
                             if (debug_print) printf("SHA ");
                         }
                     } else { /* All sets other than B only have latch */
                         /* Latch A */
-                        maxi_bump(set, character, i, &length);
-                        character[i] = 58; /* Sets C,D,E Latch A */
+                        codewords[cw_len++] = 58; /* Sets C,D,E Latch A */
                         current_set = 1;
                         if (debug_print) printf("LCHA ");
                     }
@@ -341,14 +371,12 @@ static int maxi_text_process(unsigned char maxi_codeword[144], const int mode, c
                 case 2: /* Set B */
                     if (current_set != 1 || (i + 1 < 144 && set[i + 1] == 2)) { /* If not Set A or next Set B */
                         /* Latch B */
-                        maxi_bump(set, character, i, &length);
-                        character[i] = 63; /* Sets A,C,D,E Latch B */
+                        codewords[cw_len++] = 63; /* Sets A,C,D,E Latch B */
                         current_set = 2;
                         if (debug_print) printf("LCHB ");
                     } else { /* Only available from Set A */
                         /* Shift B */
-                        maxi_bump(set, character, i, &length);
-                        character[i] = 59; /* Set B Shift A */
+                        codewords[cw_len++] = 59; /* Set A Shift B */
                         if (debug_print) printf("SHB ");
                     }
                     break;
@@ -362,89 +390,35 @@ static int maxi_text_process(unsigned char maxi_codeword[144], const int mode, c
                                 && set[i + 2] == set[i])) {
                         /* Lock in C/D/E */
                         if (i == 0) {
-                            maxi_bump(set, character, i, &length);
-                            character[i] = 60 + set[i] - 3;
-                            i++; /* Extra bump */
-                            maxi_bump(set, character, i, &length);
-                            character[i] = 60 + set[i] - 3;
-                            i += 3; /* Next 3 same set so skip over */
+                            codewords[cw_len++] = 60 + set[i] - 3;
+                            codewords[cw_len++] = 60 + set[i] - 3;
                         } else {
-                            /* Add single Shift to previous Shift */
-                            maxi_bump(set, character, i - 1, &length);
-                            character[i - 1] = 60 + set[i] - 3;
-                            i += 2; /* Next 2 same set so skip over */
+                            /* Add single Shift to previous Shift (previous character was shifted so is last) */
+                            codewords[cw_len] = codewords[cw_len - 1];
+                            codewords[cw_len - 1] = 60 + set[i] - 3;
+                            cw_len++;
                         }
                         current_set = set[i];
                         if (debug_print) printf("LCK%c ", 'C' + set[i] - 3);
                     } else {
                         /* Shift C/D/E */
-                        maxi_bump(set, character, i, &length);
-                        character[i] = 60 + set[i] - 3;
+                        codewords[cw_len++] = 60 + set[i] - 3;
                         if (debug_print) printf("SH%c ", 'C' + set[i] - 3);
                     }
                     break;
             }
-            i++; /* Allow for bump */
-        }
-        i++;
-    } while (i < 144);
-
-    if (debug_print) printf("\n");
-
-    /* Number compression has not been forgotten! - It's handled below */
-    i = 0;
-    do {
-        if (set[i] == 6) {
-            /* Number compression */
-            int value = to_int(character + i, 9);
-
-            character[i] = 31; /* NS */
-            character[i + 1] = (value & 0x3f000000) >> 24;
-            character[i + 2] = (value & 0xfc0000) >> 18;
-            character[i + 3] = (value & 0x3f000) >> 12;
-            character[i + 4] = (value & 0xfc0) >> 6;
-            character[i + 5] = (value & 0x3f);
-
-            i += 6;
-            memmove(set + i, set + i + 3, 141 - i);
-            memmove(character + i, character + i + 3, 141 - i);
-            length -= 3;
-        } else {
-            i++;
         }
-    } while (i <= 135); /* 144 - 9 */
+        codewords[cw_len++] = character[i];
+    }
 
-    /* Insert ECI at the beginning of message if needed */
-    /* Encode ECI assignment numbers according to table 3 */
-    if (eci != 0) {
-        maxi_bump(set, character, 0, &length);
-        character[0] = 27; // ECI
-        if (eci <= 31) {
-            maxi_bump(set, character, 1, &length);
-            character[1] = eci;
-        } else if (eci <= 1023) {
-            maxi_bump(set, character, 1, &length);
-            maxi_bump(set, character, 1, &length);
-            character[1] = 0x20 | ((eci >> 6) & 0x0F);
-            character[2] = eci & 0x3F;
-        } else if (eci <= 32767) {
-            maxi_bump(set, character, 1, &length);
-            maxi_bump(set, character, 1, &length);
-            maxi_bump(set, character, 1, &length);
-            character[1] = 0x30 | ((eci >> 12) & 0x07);
-            character[2] = (eci >> 6) & 0x3F;
-            character[3] = eci & 0x3F;
-        } else {
-            maxi_bump(set, character, 1, &length);
-            maxi_bump(set, character, 1, &length);
-            maxi_bump(set, character, 1, &length);
-            maxi_bump(set, character, 1, &length);
-            character[1] = 0x38 | ((eci >> 18) & 0x03);
-            character[2] = (eci >> 12) & 0x3F;
-            character[3] = (eci >> 6) & 0x3F;
-            character[4] = eci & 0x3F;
-        }
+    /* Latch into padding set if necessary (counted in length) */
+    if (padding_set != current_set) {
+        codewords[cw_len++] = padding_set == 2 || current_set == 2 ? 63 : 58;
+        if (debug_print) printf("LCH%c ", 'A' + padding_set - 1);
     }
+    length = cw_len;
+
+    if (debug_print) printf("\n");
 
     if (debug_print) printf("Length: %d\n", length);
 
@@ -458,27 +432,22 @@ static int maxi_text_process(unsigned char maxi_codeword[144], const int mode, c
         return ZINT_ERROR_TOO_LONG;
     }
 
+    /* Add the padding */
+    if (cw_len < 93) {
+        memset(codewords + cw_len, 33, 93 - cw_len);
+    }
+
     /* Copy the encoded text into the codeword array */
     if ((mode == 2) || (mode == 3)) {
-        for (i = 0; i < 84; i++) { /* secondary only */
-            maxi_codeword[i + 20] = character[i];
-        }
+        memcpy(maxi_codeword + 20, codewords, 84); /* secondary only */
 
     } else if ((mode == 4) || (mode == 6)) {
-        for (i = 0; i < 9; i++) { /* primary */
-            maxi_codeword[i + 1] = character[i];
-        }
-        for (i = 0; i < 84; i++) { /* secondary */
-            maxi_codeword[i + 20] = character[i + 9];
-        }
+        memcpy(maxi_codeword + 1, codewords, 9); /* primary */
+        memcpy(maxi_codeword + 20, codewords + 9, 84); /* secondary */
 
     } else { /* Mode 5 */
-        for (i = 0; i < 9; i++) { /* primary */
-            maxi_codeword[i + 1] = character[i];
-        }
-        for (i = 0; i < 68; i++) { /* secondary */
-            maxi_codeword[i + 20] = character[i + 9];
-        }
+        memcpy(maxi_codeword + 1, codewords, 9); /* primary */
+        memcpy(maxi_codeword + 20, codewords + 9, 68); /* secondary */
     }
 
     return 0;
@@ -530,6 +499,7 @@ INTERNAL int maxicode(struct zint_symbol *symbol, unsigned char source[], int le
     int error_number = 0, eclen;
     unsigned char maxi_codeword[144] = {0};
     int scm_vv = -1;
+    int structapp_cw = 0;
 
     mode = symbol->option_1;
 
@@ -631,7 +601,24 @@ INTERNAL int maxicode(struct zint_symbol *symbol, unsigned char source[], int le
         printf("Mode: %d\n", mode);
     }
 
-    i = maxi_text_process(maxi_codeword, mode, source, length, symbol->eci, scm_vv, symbol->debug & ZINT_DEBUG_PRINT);
+    if (symbol->structapp.count) {
+        if (symbol->structapp.count < 2 || symbol->structapp.count > 8) {
+            strcpy(symbol->errtxt, "740: Structured Append count out of range (2-8)");
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        if (symbol->structapp.index < 1 || symbol->structapp.index > symbol->structapp.count) {
+            sprintf(symbol->errtxt, "741: Structured Append index out of range (1-%d)", symbol->structapp.count);
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        if (symbol->structapp.id[0]) {
+            strcpy(symbol->errtxt, "742: Structured Append ID not available for MaxiCode");
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        structapp_cw = (symbol->structapp.count - 1) | ((symbol->structapp.index - 1) << 3);
+    }
+
+    i = maxi_text_process(maxi_codeword, mode, source, length, symbol->eci, scm_vv, structapp_cw,
+            symbol->debug & ZINT_DEBUG_PRINT);
     if (i == ZINT_ERROR_TOO_LONG) {
         strcpy(symbol->errtxt, "553: Input data too long");
         return i;
@@ -38,10 +38,9 @@ INTERNAL int c39(struct zint_symbol *symbol, unsigned char source[], int length)
 
 /* Codabar table checked against EN 798:1995 */
 
-#define CALCIUM         "0123456789-$:/.+ABCD"
 #define CALCIUM_INNER   "0123456789-$:/.+"
 
-static const char *CodaTable[20] = {
+static const char *const CodaTable[20] = {
     "11111221", "11112211", "11121121", "22111111", "11211211", "21111211",
     "12111121", "12112111", "12211111", "21121111", "11122111", "11221111", "21112121", "21211121",
     "21212111", "11212121", "11221211", "12121121", "11121221", "11122211"
@@ -63,14 +62,15 @@ INTERNAL int pharma_one(struct zint_symbol *symbol, unsigned char source[], int
 
     unsigned long int tester;
     int counter, error_number, h;
-    char inter[18] = {0}; /* 131070 -> 17 bits */
+    char inter[18]; /* 131070 -> 17 bits */
     char dest[64]; /* 17 * 2 + 1 */
+    char *d = dest;
 
     if (length > 6) {
         strcpy(symbol->errtxt, "350: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "351: Invalid characters in data");
         return error_number;
@@ -83,27 +83,23 @@ INTERNAL int pharma_one(struct zint_symbol *symbol, unsigned char source[], int
         return ZINT_ERROR_INVALID_DATA;
     }
 
+    h = 0;
     do {
         if (!(tester & 1)) {
-            strcat(inter, "W");
+            inter[h++] = 'W';
             tester = (tester - 2) / 2;
         } else {
-            strcat(inter, "N");
+            inter[h++] = 'N';
             tester = (tester - 1) / 2;
         }
     } while (tester != 0);
 
-    h = (int) strlen(inter) - 1;
-    *dest = '\0';
-    for (counter = h; counter >= 0; counter--) {
-        if (inter[counter] == 'W') {
-            strcat(dest, "32");
-        } else {
-            strcat(dest, "12");
-        }
+    for (counter = h - 1; counter >= 0; counter--) {
+        memcpy(d, inter[counter] == 'W' ? "32" : "12", 2);
+        d += 2;
     }
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
     return error_number;
 }
@@ -126,25 +122,25 @@ static int pharma_two_calc(struct zint_symbol *symbol, unsigned char source[], c
         return ZINT_ERROR_INVALID_DATA;
     }
     error_number = 0;
-    strcpy(inter, "");
+    h = 0;
     do {
         switch (tester % 3) {
             case 0:
-                strcat(inter, "3");
+                inter[h++] = '3';
                 tester = (tester - 3) / 3;
                 break;
             case 1:
-                strcat(inter, "1");
+                inter[h++] = '1';
                 tester = (tester - 1) / 3;
                 break;
             case 2:
-                strcat(inter, "2");
+                inter[h++] = '2';
                 tester = (tester - 2) / 3;
                 break;
         }
     } while (tester != 0);
 
-    h = (int) strlen(inter) - 1;
+    h--;
     for (counter = h; counter >= 0; counter--) {
         dest[h - counter] = inter[counter];
     }
@@ -165,7 +161,7 @@ INTERNAL int pharma_two(struct zint_symbol *symbol, unsigned char source[], int
         strcpy(symbol->errtxt, "354: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "355: Invalid characters in data");
         return error_number;
@@ -197,11 +193,11 @@ INTERNAL int pharma_two(struct zint_symbol *symbol, unsigned char source[], int
 INTERNAL int codabar(struct zint_symbol *symbol, unsigned char source[], int length) {
 
     int i, error_number;
+    int posns[60];
     char dest[512];
+    char *d = dest;
     int add_checksum, count = 0, checksum;
 
-    strcpy(dest, "");
-
     if (length > 60) { /* No stack smashing please */
         strcpy(symbol->errtxt, "356: Input too long");
         return ZINT_ERROR_TOO_LONG;
@@ -227,17 +223,21 @@ INTERNAL int codabar(struct zint_symbol *symbol, unsigned char source[], int len
     }
 
     /* And must not use A, B, C or D otherwise (BS EN 798:1995 4.3.2) */
-    error_number = is_sane(CALCIUM_INNER, source + 1, length - 2);
+    error_number = is_sane_lookup(CALCIUM_INNER, 16, source + 1, length - 2, posns + 1);
     if (error_number) {
         strcpy(symbol->errtxt, "363: Cannot contain \"A\", \"B\", \"C\" or \"D\"");
         return error_number;
     }
 
+    /* Start and stop A, B, C or D are CodaTable positions 16 to 19, following CALCIUM_INNER */
+    posns[0] = source[0] - 'A' + 16;
+    posns[length - 1] = source[length - 1] - 'A' + 16;
+
     add_checksum = symbol->option_2 == 1;
 
     for (i = 0; i < length; i++) {
         if (add_checksum) {
-            count += strchr(CALCIUM, source[i]) - CALCIUM;
+            count += posns[i];
             if (i + 1 == length) {
                 checksum = count % 16;
                 if (checksum) {
@@ -246,14 +246,18 @@ INTERNAL int codabar(struct zint_symbol *symbol, unsigned char source[], int len
                 if (symbol->debug & ZINT_DEBUG_PRINT) {
                     printf("Codabar: %s, count %d, checksum %d\n", source, count, checksum);
                 }
-                strcat(dest, CodaTable[checksum]);
+                memcpy(d, CodaTable[checksum], 8);
+                d += 8;
             }
         }
-        lookup(CALCIUM, CodaTable, source[i], dest);
+        memcpy(d, CodaTable[posns[i]], 8);
+        d += 8;
     }
 
-    expand(symbol, dest);
-    ustrcpy(symbol->text, source);
+    expand(symbol, dest, d - dest);
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, source);
+    }
     return error_number;
 }
 
@@ -270,7 +274,7 @@ INTERNAL int code32(struct zint_symbol *symbol, unsigned char source[], int leng
         strcpy(symbol->errtxt, "360: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "361: Invalid characters in data");
         return error_number;
@@ -325,8 +329,10 @@ INTERNAL int code32(struct zint_symbol *symbol, unsigned char source[], int leng
     }
 
     /* Override the normal text output with the Pharmacode number */
-    ustrcpy(symbol->text, "A");
-    ustrcat(symbol->text, localstr);
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, "A");
+        ustrcat(symbol->text, localstr);
+    }
 
     return error_number;
 }
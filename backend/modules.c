@@ -0,0 +1,493 @@
+/*  modules.c - compact copies and serialized forms of encoded symbols */
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <stdio.h>
+#ifdef _MSC_VER
+#include "ms_stdint.h"
+#else
+#include <stdint.h>
+#endif
+#include "common.h"
+#include "library.h"
+
+/* Bytes per row of `zint_modules` data, bit-packed except for Ultracode, which uses a byte per module */
+static int modules_row_stride(const int symbology, const int width) {
+    return symbology == BARCODE_ULTRA ? width : (width + 7) / 8;
+}
+
+/* A `zint_modules` and the allocator of the symbol it was copied from, for `ZBarcode_Modules_Delete()` */
+struct modules_block {
+    struct zint_modules modules;
+    struct zint_allocator allocator;
+};
+
+/* Right-sized copy of the encoded symbol's modules in a single allocation, with the run-lengths of each row if
+   `with_runs` (and not Ultracode), NULL on failure */
+static struct zint_modules *modules_copy(const struct zint_symbol *symbol, const int with_runs) {
+    struct modules_block *block;
+    struct zint_modules *modules;
+    int row_stride, text_size, run_count = 0, i, x;
+    size_t size;
+
+    if (!symbol || symbol->rows <= 0 || symbol->rows > 200 || symbol->width <= 0) return NULL;
+
+    row_stride = modules_row_stride(symbol->symbology, symbol->width);
+    if (row_stride > (int) sizeof(symbol->internal->encoded_data[0])) return NULL;
+    text_size = (int) ustrlen(symbol->text) + 1;
+
+    if (with_runs && symbol->symbology != BARCODE_ULTRA) {
+        for (i = 0; i < symbol->rows; i++) {
+            run_count += module_is_set(symbol, i, 0); /* Zero-length leading space */
+            for (x = 0; x < symbol->width; x += module_run_length(symbol, i, x), run_count++);
+        }
+        run_count += symbol->rows + 1; /* `run_offset` */
+    }
+
+    size = sizeof(struct modules_block) + sizeof(int) * (symbol->rows + run_count)
+            + (size_t) row_stride * symbol->rows + text_size;
+    if (!(block = (struct modules_block *) z_malloc(z_allocator(symbol), size))) return NULL;
+    block->allocator = symbol->internal->allocator;
+    modules = &block->modules;
+
+    modules->symbology = symbol->symbology;
+    modules->height = symbol->height;
+    modules->rows = symbol->rows;
+    modules->width = symbol->width;
+    modules->row_stride = row_stride;
+    modules->row_height = (int *) (block + 1);
+    modules->data = (unsigned char *) (modules->row_height + symbol->rows + run_count);
+    modules->text = modules->data + (size_t) row_stride * symbol->rows;
+    modules->run_offset = run_count ? modules->row_height + symbol->rows : NULL;
+    modules->runs = run_count ? modules->run_offset + symbol->rows + 1 : NULL;
+
+    for (i = 0; i < symbol->rows; i++) {
+        modules->row_height[i] = symbol->row_height[i];
+        memcpy(modules->data + (size_t) row_stride * i, symbol->internal->encoded_data[i], row_stride);
+    }
+    memcpy(modules->text, symbol->text, text_size);
+
+    if (run_count) {
+        int *run = modules->runs;
+        for (i = 0; i < symbol->rows; i++) {
+            modules->run_offset[i] = (int) (run - modules->runs);
+            if (module_is_set(symbol, i, 0)) {
+                *run++ = 0;
+            }
+            for (x = 0; x < symbol->width; x += *run++) {
+                *run = module_run_length(symbol, i, x);
+            }
+        }
+        modules->run_offset[i] = (int) (run - modules->runs);
+    }
+
+    return modules;
+}
+
+/* Return a right-sized copy of the encoded symbol's modules in a single allocation, NULL on failure */
+struct zint_modules *ZBarcode_Modules(const struct zint_symbol *symbol) {
+    return modules_copy(symbol, 0 /*with_runs*/);
+}
+
+/* As `ZBarcode_Modules()` but also giving the run-lengths of each row (other than for Ultracode) */
+struct zint_modules *ZBarcode_Export_Modules(const struct zint_symbol *symbol) {
+    return modules_copy(symbol, 1 /*with_runs*/);
+}
+
+/* Load `modules` into `symbol` (after clearing it) so that it can be output */
+int ZBarcode_Load_Modules(struct zint_symbol *symbol, const struct zint_modules *modules) {
+    int i;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!modules || modules->rows <= 0 || modules->rows > 200 || modules->width <= 0
+            || modules->row_stride != modules_row_stride(modules->symbology, modules->width)
+            || modules->row_stride > (int) sizeof(symbol->internal->encoded_data[0])
+            || ustrlen(modules->text) >= sizeof(symbol->text)) {
+        strcpy(symbol->errtxt, "240: Invalid modules");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+
+    ZBarcode_Clear(symbol);
+
+    symbol->symbology = modules->symbology;
+    symbol->height = modules->height;
+    symbol->rows = modules->rows;
+    symbol->width = modules->width;
+    for (i = 0; i < modules->rows; i++) {
+        symbol->row_height[i] = modules->row_height[i];
+        memcpy(symbol->internal->encoded_data[i], modules->data + (size_t) modules->row_stride * i,
+                modules->row_stride);
+    }
+    ustrcpy(symbol->text, modules->text);
+
+    return 0;
+}
+
+void ZBarcode_Modules_Delete(struct zint_modules *modules) {
+    struct zint_allocator allocator;
+
+    if (!modules) return;
+
+    allocator = ((struct modules_block *) modules)->allocator;
+    z_free(&allocator, modules); /* Single allocation, see `struct modules_block` */
+}
+
+#define SETTINGS_DEST_FLAGS (BARCODE_STDOUT | BARCODE_MEMORY_FILE | BARCODE_WRITE_FUNC)
+
+/* Settings affecting encoding or output, as kept by `ZBarcode_Serialize()` and hashed by `ZBarcode_Content_Hash()`,
+   zeroed before being set so that strings are zero-padded */
+struct symbol_settings {
+    int symbology;
+    int height;
+    int whitespace_width;
+    int whitespace_height;
+    int border_width;
+    int output_options; /* Excluding `SETTINGS_DEST_FLAGS` */
+    char fgcolour[10];
+    char bgcolour[10];
+    float scale;
+    int option_1;
+    int option_2;
+    int option_3;
+    int show_hrt;
+    int fontsize;
+    int input_mode;
+    int eci;
+    char primary[128];
+    float dot_size;
+    int warn_level;
+    struct zint_structapp structapp;
+};
+
+static void settings_save(const struct zint_symbol *symbol, struct symbol_settings *settings) {
+    memset(settings, 0, sizeof(*settings));
+    settings->symbology = symbol->symbology;
+    settings->height = symbol->height;
+    settings->whitespace_width = symbol->whitespace_width;
+    settings->whitespace_height = symbol->whitespace_height;
+    settings->border_width = symbol->border_width;
+    settings->output_options = symbol->output_options & ~SETTINGS_DEST_FLAGS;
+    strcpy(settings->fgcolour, symbol->fgcolour);
+    strcpy(settings->bgcolour, symbol->bgcolour);
+    settings->scale = symbol->scale;
+    settings->option_1 = symbol->option_1;
+    settings->option_2 = symbol->option_2;
+    settings->option_3 = symbol->option_3;
+    settings->show_hrt = symbol->show_hrt;
+    settings->fontsize = symbol->fontsize;
+    settings->input_mode = symbol->input_mode;
+    settings->eci = symbol->eci;
+    strcpy(settings->primary, symbol->primary);
+    settings->dot_size = symbol->dot_size;
+    settings->warn_level = symbol->warn_level;
+    settings->structapp = symbol->structapp;
+}
+
+static void settings_restore(struct zint_symbol *symbol, const struct symbol_settings *settings) {
+    symbol->symbology = settings->symbology;
+    symbol->height = settings->height;
+    symbol->whitespace_width = settings->whitespace_width;
+    symbol->whitespace_height = settings->whitespace_height;
+    symbol->border_width = settings->border_width;
+    symbol->output_options = settings->output_options | (symbol->output_options & SETTINGS_DEST_FLAGS);
+    strcpy(symbol->fgcolour, settings->fgcolour);
+    strcpy(symbol->bgcolour, settings->bgcolour);
+    symbol->scale = settings->scale;
+    symbol->option_1 = settings->option_1;
+    symbol->option_2 = settings->option_2;
+    symbol->option_3 = settings->option_3;
+    symbol->show_hrt = settings->show_hrt;
+    symbol->fontsize = settings->fontsize;
+    symbol->input_mode = settings->input_mode;
+    symbol->eci = settings->eci;
+    strcpy(symbol->primary, settings->primary);
+    symbol->dot_size = settings->dot_size;
+    symbol->warn_level = settings->warn_level;
+    symbol->structapp = settings->structapp;
+}
+
+/* Serialized encoded symbol, portable between platforms: 32-bit little-endian integers (floats as their IEEE 754
+   bits), fixed-size zero-padded strings, and an FNV-1a check value over all preceding bytes at the end:
+     "ZSYM", format version, library version, settings (`serial_settings()`), rows, width, row heights,
+     text length, text, modules (`modules_row_stride()` bytes per row), check value */
+
+#define SERIAL_MAGIC            "ZSYM"
+#define SERIAL_VERSION          1
+#define SERIAL_SETTINGS_SIZE    (4 * 18 + 10 + 10 + 128 + 32) /* Bytes of `serial_settings()` */
+#define SERIAL_HEADER_SIZE      (4 * 3 + SERIAL_SETTINGS_SIZE + 4 * 2) /* Up to and including width */
+
+static unsigned char *serial_put(unsigned char *p, const unsigned int val) {
+    p[0] = (unsigned char) (val & 0xFF);
+    p[1] = (unsigned char) ((val >> 8) & 0xFF);
+    p[2] = (unsigned char) ((val >> 16) & 0xFF);
+    p[3] = (unsigned char) ((val >> 24) & 0xFF);
+    return p + 4;
+}
+
+static unsigned int serial_get(const unsigned char *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24);
+}
+
+static unsigned char *serial_put_float(unsigned char *p, const float val) {
+    unsigned int bits;
+    memcpy(&bits, &val, 4);
+    return serial_put(p, bits);
+}
+
+static float serial_get_float(const unsigned char *p) {
+    const unsigned int bits = serial_get(p);
+    float val;
+    memcpy(&val, &bits, 4);
+    return val;
+}
+
+/* Write `settings` to `p` in portable form, `SERIAL_SETTINGS_SIZE` bytes. Strings are zero-padded as
+   `settings_save()` zeroes `settings` first */
+static void serial_settings(const struct symbol_settings *settings, unsigned char *p) {
+    p = serial_put(p, (unsigned int) settings->symbology);
+    p = serial_put(p, (unsigned int) settings->height);
+    p = serial_put(p, (unsigned int) settings->whitespace_width);
+    p = serial_put(p, (unsigned int) settings->whitespace_height);
+    p = serial_put(p, (unsigned int) settings->border_width);
+    p = serial_put(p, (unsigned int) settings->output_options);
+    memcpy(p, settings->fgcolour, 10);
+    memcpy(p + 10, settings->bgcolour, 10);
+    p = serial_put_float(p + 20, settings->scale);
+    p = serial_put(p, (unsigned int) settings->option_1);
+    p = serial_put(p, (unsigned int) settings->option_2);
+    p = serial_put(p, (unsigned int) settings->option_3);
+    p = serial_put(p, (unsigned int) settings->show_hrt);
+    p = serial_put(p, (unsigned int) settings->fontsize);
+    p = serial_put(p, (unsigned int) settings->input_mode);
+    p = serial_put(p, (unsigned int) settings->eci);
+    memcpy(p, settings->primary, 128);
+    p = serial_put_float(p + 128, settings->dot_size);
+    p = serial_put(p, (unsigned int) settings->warn_level);
+    p = serial_put(p, (unsigned int) settings->structapp.index);
+    p = serial_put(p, (unsigned int) settings->structapp.count);
+    memcpy(p, settings->structapp.id, 32);
+}
+
+/* Read `settings` from `p` as written by `serial_settings()`, returning 0 if its strings aren't NUL-terminated */
+static int serial_get_settings(struct symbol_settings *settings, const unsigned char *p) {
+    memset(settings, 0, sizeof(*settings));
+    settings->symbology = (int) serial_get(p);
+    settings->height = (int) serial_get(p + 4);
+    settings->whitespace_width = (int) serial_get(p + 8);
+    settings->whitespace_height = (int) serial_get(p + 12);
+    settings->border_width = (int) serial_get(p + 16);
+    settings->output_options = (int) serial_get(p + 20) & ~SETTINGS_DEST_FLAGS;
+    memcpy(settings->fgcolour, p + 24, 10);
+    memcpy(settings->bgcolour, p + 34, 10);
+    p += 44;
+    settings->scale = serial_get_float(p);
+    settings->option_1 = (int) serial_get(p + 4);
+    settings->option_2 = (int) serial_get(p + 8);
+    settings->option_3 = (int) serial_get(p + 12);
+    settings->show_hrt = (int) serial_get(p + 16);
+    settings->fontsize = (int) serial_get(p + 20);
+    settings->input_mode = (int) serial_get(p + 24);
+    settings->eci = (int) serial_get(p + 28);
+    memcpy(settings->primary, p + 32, 128);
+    p += 160;
+    settings->dot_size = serial_get_float(p);
+    settings->warn_level = (int) serial_get(p + 4);
+    settings->structapp.index = (int) serial_get(p + 8);
+    settings->structapp.count = (int) serial_get(p + 12);
+    memcpy(settings->structapp.id, p + 16, 32);
+
+    return memchr(settings->fgcolour, '\0', 10) && memchr(settings->bgcolour, '\0', 10)
+            && memchr(settings->primary, '\0', 128);
+}
+
+/* FNV-1a check value of `size` bytes of `data` */
+static unsigned int serial_check(const unsigned char *data, const int size) {
+    unsigned int hash = 2166136261u;
+    int i;
+
+    for (i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* Serialize the encoded `symbol` (modules, row heights, text and the settings affecting output) into a buffer
+   allocated in `*p_buffer` of `*p_size` bytes, to be freed with `ZBarcode_Serialize_Delete()`, so that it can be
+   stored or transmitted and later loaded by `ZBarcode_Deserialize()`, possibly on another platform */
+int ZBarcode_Serialize(const struct zint_symbol *symbol, unsigned char **p_buffer, int *p_size) {
+    struct symbol_settings settings;
+    unsigned char *buffer, *p;
+    int row_stride, text_length, size, i;
+
+    if (!p_buffer || !p_size) return ZINT_ERROR_INVALID_OPTION;
+    *p_buffer = NULL;
+    *p_size = 0;
+
+    if (!symbol || symbol->rows <= 0 || symbol->rows > 200 || symbol->width <= 0) return ZINT_ERROR_INVALID_DATA;
+    row_stride = modules_row_stride(symbol->symbology, symbol->width);
+    if (row_stride > (int) sizeof(symbol->internal->encoded_data[0])) return ZINT_ERROR_INVALID_DATA;
+    text_length = (int) ustrlen(symbol->text);
+
+    size = SERIAL_HEADER_SIZE + 4 * symbol->rows + 4 + text_length + row_stride * symbol->rows + 4;
+    /* The allocator of `symbol` is kept ahead of the buffer for `ZBarcode_Serialize_Delete()` */
+    if (!(p = (unsigned char *) z_malloc(z_allocator(symbol), sizeof(struct zint_allocator) + size))) {
+        return ZINT_ERROR_MEMORY;
+    }
+    memcpy(p, &symbol->internal->allocator, sizeof(struct zint_allocator));
+    buffer = p + sizeof(struct zint_allocator);
+
+    memcpy(buffer, SERIAL_MAGIC, 4);
+    p = serial_put(buffer + 4, SERIAL_VERSION);
+    p = serial_put(p, (unsigned int) ZBarcode_Version());
+    settings_save(symbol, &settings);
+    serial_settings(&settings, p);
+    p = serial_put(p + SERIAL_SETTINGS_SIZE, (unsigned int) symbol->rows);
+    p = serial_put(p, (unsigned int) symbol->width);
+    for (i = 0; i < symbol->rows; i++) {
+        p = serial_put(p, (unsigned int) symbol->row_height[i]);
+    }
+    p = serial_put(p, (unsigned int) text_length);
+    memcpy(p, symbol->text, text_length);
+    p += text_length;
+    for (i = 0; i < symbol->rows; i++, p += row_stride) {
+        memcpy(p, symbol->internal->encoded_data[i], row_stride);
+    }
+    (void) serial_put(p, serial_check(buffer, size - 4));
+
+    *p_buffer = buffer;
+    *p_size = size;
+
+    return 0;
+}
+
+/* Load `size` bytes of `buffer` as serialized by `ZBarcode_Serialize()` into `symbol` (after clearing it) so that
+   it can be output. The output destination (`outfile` and the output options selecting it) is left as is */
+int ZBarcode_Deserialize(struct zint_symbol *symbol, const unsigned char *buffer, int size) {
+    struct symbol_settings settings;
+    const unsigned char *p;
+    int rows, width, row_stride, text_length, i;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!buffer || size < SERIAL_HEADER_SIZE + 4 || memcmp(buffer, SERIAL_MAGIC, 4) != 0) {
+        strcpy(symbol->errtxt, "735: Invalid serialized symbol");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+    if (serial_get(buffer + 4) != SERIAL_VERSION) {
+        sprintf(symbol->errtxt, "736: Unsupported serialized symbol format version %u", serial_get(buffer + 4));
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+    if (serial_check(buffer, size - 4) != serial_get(buffer + size - 4)) {
+        strcpy(symbol->errtxt, "737: Serialized symbol check value mismatch");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+
+    p = buffer + 12;
+    rows = (int) serial_get(p + SERIAL_SETTINGS_SIZE);
+    width = (int) serial_get(p + SERIAL_SETTINGS_SIZE + 4);
+    if (!serial_get_settings(&settings, p) || rows <= 0 || rows > 200 || width <= 0
+            || (row_stride = modules_row_stride(settings.symbology, width))
+                > (int) sizeof(symbol->internal->encoded_data[0])
+            || size < SERIAL_HEADER_SIZE + 4 * rows + 4 + 4) {
+        strcpy(symbol->errtxt, "735: Invalid serialized symbol");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+    p = buffer + SERIAL_HEADER_SIZE + 4 * rows;
+    text_length = (int) serial_get(p);
+    if (text_length < 0 || text_length >= (int) sizeof(symbol->text)
+            || size != SERIAL_HEADER_SIZE + 4 * rows + 4 + text_length + row_stride * rows + 4
+            || memchr(p + 4, '\0', text_length)) {
+        strcpy(symbol->errtxt, "735: Invalid serialized symbol");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+
+    ZBarcode_Clear(symbol);
+
+    settings_restore(symbol, &settings);
+    symbol->rows = rows;
+    symbol->width = width;
+    for (i = 0; i < rows; i++) {
+        symbol->row_height[i] = (int) serial_get(buffer + SERIAL_HEADER_SIZE + 4 * i);
+    }
+    memcpy(symbol->text, p + 4, text_length);
+    p += 4 + text_length;
+    for (i = 0; i < rows; i++, p += row_stride) {
+        memcpy(symbol->internal->encoded_data[i], p, row_stride);
+    }
+
+    return 0;
+}
+
+void ZBarcode_Serialize_Delete(unsigned char *buffer) {
+    struct zint_allocator allocator;
+
+    if (!buffer) return;
+
+    buffer -= sizeof(struct zint_allocator);
+    memcpy(&allocator, buffer, sizeof(struct zint_allocator));
+    z_free(&allocator, buffer);
+}
+
+/* Set `hash` to a 64-bit FNV-1a hash (as 16 lowercase hex digits) of the library version, the settings of `symbol`
+   affecting encoding or output, and `source`, stable across platforms and processes, for use as a key when
+   sharing `ZBarcode_Serialize()` results */
+int ZBarcode_Content_Hash(const struct zint_symbol *symbol, const unsigned char *source, int in_length,
+            char hash[17]) {
+    static const char hex[] = "0123456789abcdef";
+    struct symbol_settings settings;
+    unsigned char header[4 + SERIAL_SETTINGS_SIZE + 4];
+    uint64_t value = 0xCBF29CE484222325;
+    int i;
+
+    if (!symbol || !source || !hash) return ZINT_ERROR_INVALID_DATA;
+    if (in_length <= 0) {
+        in_length = (int) ustrlen(source);
+    }
+
+    (void) serial_put(header, (unsigned int) ZBarcode_Version());
+    settings_save(symbol, &settings);
+    serial_settings(&settings, header + 4);
+    (void) serial_put(header + 4 + SERIAL_SETTINGS_SIZE, (unsigned int) in_length);
+
+    for (i = 0; i < (int) sizeof(header); i++) {
+        value = (value ^ header[i]) * 0x100000001B3;
+    }
+    for (i = 0; i < in_length; i++) {
+        value = (value ^ source[i]) * 0x100000001B3;
+    }
+    for (i = 15; i >= 0; i--, value >>= 4) {
+        hash[i] = hex[value & 0xF];
+    }
+    hash[16] = '\0';
+
+    return 0;
+}
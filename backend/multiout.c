@@ -0,0 +1,310 @@
+/*  multiout.c - output of a symbol to several files, or of several symbols to one file */
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <stdio.h>
+#include <limits.h>
+#include "common.h"
+#include "library.h"
+#include "output.h"
+#include "zfiletypes.h"
+
+/* Output encoded `symbol` to each of the `count` files `outfiles`, the format of each given by its extension as for
+   `ZBarcode_Print()`. The vector and raster geometry are plotted once and shared between the files (see
+   `plot_vector_multi()` and `plot_raster_multi()`), the vector files being written first. Stops on the first
+   error, `symbol->outfile` being left unchanged */
+int ZBarcode_Print_Multi(struct zint_symbol *symbol, int rotate_angle, const char *const *outfiles, int count) {
+    static const struct { char ext[4]; int file_type; } multi_types[] = {
+        { "PNG", OUT_PNG_FILE }, { "BMP", OUT_BMP_FILE }, { "GIF", OUT_GIF_FILE }, { "PCX", OUT_PCX_FILE },
+        { "PBM", OUT_PBM_FILE }, { "PGM", OUT_PGM_FILE }, { "TIF", OUT_TIF_FILE }, { "ZPL", OUT_ZPL_FILE },
+        { "EPL", OUT_EPL_FILE }, { "PCL", OUT_PCL_FILE }, { "QOI", OUT_QOI_FILE }, { "EPS", OUT_EPS_FILE },
+        { "SVG", OUT_SVG_FILE }, { "VGZ", OUT_SVG_FILE }, { "EMF", OUT_EMF_FILE }, { "PDF", OUT_PDF_FILE },
+        { "TXT", OUT_BUFFER }, /* `dump_plot()` */
+    };
+    struct out_target *targets;
+    char outfile[sizeof(symbol->outfile)];
+    int have_raster = 0;
+    int warn_number = 0;
+    int error_number;
+    int i, j;
+
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (rotate_angle != 0 && rotate_angle != 90 && rotate_angle != 180 && rotate_angle != 270) {
+        strcpy(symbol->errtxt, "223: Invalid rotation angle");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    if ((symbol->output_options & BARCODE_DOTTY_MODE) && !(symbology_flags(symbol->symbology) & ZINT_CAP_DOTTY)) {
+        strcpy(symbol->errtxt, "224: Selected symbology cannot be rendered as dots");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    if (count <= 0 || !outfiles) {
+        strcpy(symbol->errtxt, "750: Output files NULL or count not positive");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+    if (count > 1 && (symbol->output_options & BARCODE_MEMORY_FILE)) {
+        strcpy(symbol->errtxt, "751: Memory file output limited to one output file");
+        return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    if (!(targets = (struct out_target *) malloc(sizeof(struct out_target) * count))) {
+        strcpy(symbol->errtxt, "752: Insufficient memory for output files");
+        return error_tag(symbol->errtxt, ZINT_ERROR_MEMORY);
+    }
+    for (i = 0; i < count; i++) {
+        const int len = outfiles[i] ? (int) strlen(outfiles[i]) : 0;
+        char output[4];
+
+        if (len >= (int) sizeof(symbol->outfile)) {
+            free(targets);
+            sprintf(symbol->errtxt, "753: Output file %d name too long", i);
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+        targets[i].outfile = outfiles[i];
+        targets[i].file_type = -1;
+        targets[i].output_options = 0;
+        if (len > 3) {
+            memcpy(output, outfiles[i] + len - 3, 4);
+            to_upper((unsigned char *) output);
+            for (j = 0; j < (int) (sizeof(multi_types) / sizeof(multi_types[0])); j++) {
+                if (strcmp(output, multi_types[j].ext) == 0) {
+                    targets[i].file_type = multi_types[j].file_type;
+                    break;
+                }
+            }
+            if (output[0] == 'V') { /* ".svgz" only */
+                if ((outfiles[i][len - 4] | 0x20) == 's') {
+                    targets[i].output_options = SVG_GZIP;
+                } else {
+                    targets[i].file_type = -1;
+                }
+            }
+        }
+        if (targets[i].file_type == -1) {
+            free(targets);
+            sprintf(symbol->errtxt, "754: Output file %d unknown output format", i);
+            return error_tag(symbol->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+        have_raster |= targets[i].file_type >= OUT_PNG_FILE;
+    }
+
+    strcpy(outfile, symbol->outfile);
+
+    error_number = plot_vector_multi(symbol, rotate_angle, targets, count);
+    if (error_number < ZINT_ERROR) {
+        warn_number = error_number;
+        for (i = 0; i < count && error_number < ZINT_ERROR; i++) {
+            if (targets[i].file_type == OUT_BUFFER) {
+                strcpy(symbol->outfile, targets[i].outfile);
+                error_number = dump_plot(symbol);
+                if (error_number > warn_number) {
+                    warn_number = error_number;
+                }
+            }
+        }
+    }
+    if (error_number < ZINT_ERROR && have_raster) {
+        if (symbol->scale < 1.0f) {
+            symbol->text[0] = '\0';
+        }
+        error_number = plot_raster_multi(symbol, rotate_angle, targets, count);
+    }
+    if (error_number < warn_number) {
+        error_number = warn_number;
+    }
+
+    strcpy(symbol->outfile, outfile);
+    free(targets);
+
+    return error_tag(symbol->errtxt, error_number);
+}
+
+/* Render encoded symbols `items` onto a single `width` x `height` pixel sheet, output as one raster file (PNG, BMP,
+   GIF, PCX, PBM, PGM, TIF, ZPL, EPL, PCL or QOI) as given by `sheet`'s `outfile`. The sheet's (not the items')
+   colours and output options apply; `sheet` need not be encoded */
+int ZBarcode_Print_Sheet(struct zint_symbol *sheet, int width, int height, const struct zint_sheet_item *items,
+            int count) {
+    static const struct { char ext[4]; int file_type; } sheet_types[] = {
+        { "PNG", OUT_PNG_FILE }, { "BMP", OUT_BMP_FILE }, { "GIF", OUT_GIF_FILE }, { "PCX", OUT_PCX_FILE },
+        { "PBM", OUT_PBM_FILE }, { "PGM", OUT_PGM_FILE }, { "TIF", OUT_TIF_FILE }, { "ZPL", OUT_ZPL_FILE },
+        { "EPL", OUT_EPL_FILE }, { "PCL", OUT_PCL_FILE }, { "QOI", OUT_QOI_FILE },
+    };
+    int outfile_len;
+    int file_type = -1;
+    int error_number;
+    int i;
+
+    if (!sheet) return ZINT_ERROR_INVALID_DATA;
+
+    if (width <= 0 || height <= 0 || width > INT_MAX / height) {
+        sprintf(sheet->errtxt, "538: Invalid sheet size %dx%d", width, height);
+        return error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+    if (count < 0 || (count && !items)) {
+        strcpy(sheet->errtxt, "539: Sheet items NULL or count negative");
+        return error_tag(sheet->errtxt, ZINT_ERROR_INVALID_DATA);
+    }
+
+    outfile_len = (int) strlen(sheet->outfile);
+    if (outfile_len > 3) {
+        char output[4];
+        memcpy(output, sheet->outfile + outfile_len - 3, 4);
+        to_upper((unsigned char *) output);
+        for (i = 0; i < (int) (sizeof(sheet_types) / sizeof(sheet_types[0])); i++) {
+            if (strcmp(output, sheet_types[i].ext) == 0) {
+                file_type = sheet_types[i].file_type;
+                break;
+            }
+        }
+    }
+    if (file_type == -1) {
+        strcpy(sheet->errtxt, "540: Unknown or non-raster sheet output format");
+        return error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    for (i = 0; i < count; i++) {
+        const struct zint_symbol *symbol = items[i].symbol;
+        if (!symbol) {
+            sprintf(sheet->errtxt, "543: Sheet item %d symbol NULL", i);
+            return error_tag(sheet->errtxt, ZINT_ERROR_INVALID_DATA);
+        }
+        if (items[i].rotate_angle != 0 && items[i].rotate_angle != 90 && items[i].rotate_angle != 180
+                && items[i].rotate_angle != 270) {
+            sprintf(sheet->errtxt, "544: Sheet item %d invalid rotation angle", i);
+            return error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+        /* Ultracode's colours aren't in the sheet's palette */
+        if (symbol->symbology == BARCODE_ULTRA) {
+            sprintf(sheet->errtxt, "545: Sheet item %d Ultracode not supported", i);
+            return error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+        if ((symbol->output_options & BARCODE_DOTTY_MODE)
+                && !(symbology_flags(symbol->symbology) & ZINT_CAP_DOTTY)) {
+            sprintf(sheet->errtxt, "546: Sheet item %d symbology cannot be rendered as dots", i);
+            return error_tag(sheet->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+    }
+
+    error_number = plot_raster_sheet(sheet, width, height, items, count, file_type);
+    return error_tag(sheet->errtxt, error_number);
+}
+
+/* Output `count` encoded symbols as a PDF document with a page per symbol to the output of `symbols[0]` (`outfile`
+   whatever its extension, or stdout/memory/write function as set by its `output_options`). Identical symbols are
+   drawn once and shared, as are fonts. Each symbol's `vector` is left set as by `ZBarcode_Buffer_Vector()` */
+int ZBarcode_Print_PDF(struct zint_symbol *symbols[], int count, int rotate_angle) {
+    int error_number;
+    int i;
+
+    if (!symbols || !symbols[0]) return ZINT_ERROR_INVALID_DATA;
+
+    switch (rotate_angle) {
+        case 0:
+        case 90:
+        case 180:
+        case 270:
+            break;
+        default:
+            strcpy(symbols[0]->errtxt, "242: Invalid rotation angle");
+            return error_tag(symbols[0]->errtxt, ZINT_ERROR_INVALID_OPTION);
+            break;
+    }
+
+    if (count < 1 || count > (INT_MAX - 16) / 2) {
+        strcpy(symbols[0]->errtxt, "244: Invalid number of symbols");
+        return error_tag(symbols[0]->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!symbols[i]) {
+            strcpy(symbols[0]->errtxt, "248: Invalid symbol");
+            return error_tag(symbols[0]->errtxt, ZINT_ERROR_INVALID_DATA);
+        }
+        if ((symbols[i]->output_options & BARCODE_DOTTY_MODE)
+                && !(symbology_flags(symbols[i]->symbology) & ZINT_CAP_DOTTY)) {
+            strcpy(symbols[0]->errtxt, "249: Selected symbology cannot be rendered as dots");
+            return error_tag(symbols[0]->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+        error_number = plot_vector(symbols[i], rotate_angle, OUT_BUFFER);
+        if (error_number >= ZINT_ERROR) {
+            if (i) {
+                strcpy(symbols[0]->errtxt, symbols[i]->errtxt);
+            }
+            return error_tag(symbols[0]->errtxt, error_number);
+        }
+    }
+
+    error_number = pdf_plot_symbols(symbols, count);
+    return error_tag(symbols[0]->errtxt, error_number);
+}
+
+/* Output `count` encoded symbols as a multi-page TIFF with a page (IFD) per symbol to the output of `symbols[0]`
+   (`outfile` whatever its extension, or stdout/memory/write function as set by its `output_options`). Each page is
+   set up as for "TIF" by its own symbol's options (so may be CCITT G4 etc.), its `bitmap` being left set as by
+   `ZBarcode_Buffer()` with OUT_BUFFER_INTERMEDIATE */
+int ZBarcode_Print_TIF(struct zint_symbol *symbols[], int count, int rotate_angle) {
+    int error_number;
+    int i;
+
+    if (!symbols || !symbols[0]) return ZINT_ERROR_INVALID_DATA;
+
+    switch (rotate_angle) {
+        case 0:
+        case 90:
+        case 180:
+        case 270:
+            break;
+        default:
+            strcpy(symbols[0]->errtxt, "714: Invalid rotation angle");
+            return error_tag(symbols[0]->errtxt, ZINT_ERROR_INVALID_OPTION);
+            break;
+    }
+
+    if (count < 1 || count > 0xffff) {
+        strcpy(symbols[0]->errtxt, "715: Invalid number of symbols");
+        return error_tag(symbols[0]->errtxt, ZINT_ERROR_INVALID_OPTION);
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!symbols[i]) {
+            strcpy(symbols[0]->errtxt, "716: Invalid symbol");
+            return error_tag(symbols[0]->errtxt, ZINT_ERROR_INVALID_DATA);
+        }
+        if ((symbols[i]->output_options & BARCODE_DOTTY_MODE)
+                && !(symbology_flags(symbols[i]->symbology) & ZINT_CAP_DOTTY)) {
+            strcpy(symbols[0]->errtxt, "717: Selected symbology cannot be rendered as dots");
+            return error_tag(symbols[0]->errtxt, ZINT_ERROR_INVALID_OPTION);
+        }
+    }
+
+    error_number = tif_plot_symbols(symbols, count, rotate_angle);
+    return error_tag(symbols[0]->errtxt, error_number);
+}
@@ -33,17 +33,39 @@
 #include "common.h"
 #include "output.h"
 
-#define SSET "0123456789ABCDEF"
+/* Parse `colour`, 6 hex digits RRGGBB or 8 RRGGBBAA, into `*p_rgba` as 0xRRGGBBAA (alpha 0xFF if none). Returns 0 if
+   good, 1 if wrong length, 2 if not hex */
+static int output_parse_colour(const char *colour, unsigned int *p_rgba) {
+    const int len = (int) strlen(colour);
+    unsigned int rgba = 0;
+    int i;
+
+    if (len != 6 && len != 8) {
+        return 1;
+    }
+    for (i = 0; i < len; i++) {
+        const int val = ctoi(colour[i]);
+        if (val < 0 || val > 15) {
+            return 2;
+        }
+        rgba = (rgba << 4) | val;
+    }
+    *p_rgba = len == 6 ? (rgba << 8) | 0xFF : rgba;
 
-/* Check colour options are good. Note: using raster.c error nos 651-654 */
+    return 0;
+}
+
+/* Check colour options are good, upper-casing them and setting `fgcolour_rgba`, `bgcolour_rgba`. Note: using raster.c
+   error nos 651-654 */
 INTERNAL int output_check_colour_options(struct zint_symbol *symbol) {
-    int error_number;
+    const int fg_ret = output_parse_colour(symbol->fgcolour, &symbol->fgcolour_rgba);
+    const int bg_ret = output_parse_colour(symbol->bgcolour, &symbol->bgcolour_rgba);
 
-    if ((strlen(symbol->fgcolour) != 6) && (strlen(symbol->fgcolour) != 8)) {
+    if (fg_ret == 1) {
         strcpy(symbol->errtxt, "651: Malformed foreground colour target");
         return ZINT_ERROR_INVALID_OPTION;
     }
-    if ((strlen(symbol->bgcolour) != 6) && (strlen(symbol->bgcolour) != 8)) {
+    if (bg_ret == 1) {
         strcpy(symbol->errtxt, "652: Malformed background colour target");
         return ZINT_ERROR_INVALID_OPTION;
     }
@@ -51,14 +73,11 @@ INTERNAL int output_check_colour_options(struct zint_symbol *symbol) {
     to_upper((unsigned char *) symbol->fgcolour);
     to_upper((unsigned char *) symbol->bgcolour);
 
-    error_number = is_sane(SSET, (unsigned char *) symbol->fgcolour, strlen(symbol->fgcolour));
-    if (error_number == ZINT_ERROR_INVALID_DATA) {
+    if (fg_ret) {
         strcpy(symbol->errtxt, "653: Malformed foreground colour target");
         return ZINT_ERROR_INVALID_OPTION;
     }
-
-    error_number = is_sane(SSET, (unsigned char *) symbol->bgcolour, strlen(symbol->bgcolour));
-    if (error_number == ZINT_ERROR_INVALID_DATA) {
+    if (bg_ret) {
         strcpy(symbol->errtxt, "654: Malformed background colour target");
         return ZINT_ERROR_INVALID_OPTION;
     }
@@ -585,3 +604,48 @@ INTERNAL void output_upcean_split_text(int upceanflag, unsigned char text[],
         textpart3[6] = '\0';
     }
 }
+
+/* Round `arg` to hundredths */
+INTERNAL int output_hundredths(const float arg) {
+    return (int) (arg < 0.0f ? arg * 100.0f - 0.5f : arg * 100.0f + 0.5f);
+}
+
+/* Put `cmd` (unless NUL, or a space separator and `val` negative) followed by `val` hundredths as a minimal decimal (no
+   trailing zeros, no leading zero before point), returning end of output (at least 13 chars needed) */
+INTERNAL char *output_put_hundredths(char *out, const char cmd, const int val) {
+    char digits[12];
+    unsigned int u = val < 0 ? 0u - (unsigned int) val : (unsigned int) val;
+    unsigned int frac = u % 100;
+    int i = 0;
+
+    if (cmd && (cmd != ' ' || val >= 0)) {
+        *out++ = cmd;
+    }
+    if (val < 0) {
+        *out++ = '-';
+    }
+    u /= 100;
+    if (u || !frac) {
+        do {
+            digits[i++] = '0' + u % 10;
+            u /= 10;
+        } while (u);
+        while (i) {
+            *out++ = digits[--i];
+        }
+    }
+    if (frac) {
+        *out++ = '.';
+        *out++ = '0' + frac / 10;
+        if (frac % 10) {
+            *out++ = '0' + frac % 10;
+        }
+    }
+    return out;
+}
+
+/* Stands in for the plotter of an output format left out of the build (see ZINT_OUTPUTS in "CMakeLists.txt") */
+INTERNAL int output_excluded(struct zint_symbol *symbol) {
+    strcpy(symbol->errtxt, "707: Output format not included in this build");
+    return ZINT_ERROR_INVALID_OPTION;
+}
@@ -38,12 +38,34 @@ extern "C" {
 #endif /* __cplusplus */
 
 INTERNAL int output_check_colour_options(struct zint_symbol *symbol);
+
+/* Components of a colour packed as 0xRRGGBBAA, see `output_check_colour_options()` */
+#define OUT_RED(rgba)   ((unsigned char) ((rgba) >> 24))
+#define OUT_GREEN(rgba) ((unsigned char) ((rgba) >> 16))
+#define OUT_BLUE(rgba)  ((unsigned char) ((rgba) >> 8))
+#define OUT_ALPHA(rgba) ((unsigned char) (rgba))
 INTERNAL void output_set_whitespace_offsets(struct zint_symbol *symbol, int *xoffset, int *yoffset, int *roffset, int *boffset);
 INTERNAL int output_process_upcean(struct zint_symbol *symbol, int *p_main_width, int *p_comp_offset, unsigned char addon[6], int *p_addon_gap);
 INTERNAL float output_large_bar_height(struct zint_symbol *symbol);
 INTERNAL void output_upcean_split_text(int upceanflag, unsigned char text[],
                 unsigned char textpart1[], unsigned char textpart2[], unsigned char textpart3[], unsigned char textpart4[]);
 
+/* Round `arg` to hundredths */
+INTERNAL int output_hundredths(const float arg);
+/* Put `cmd` (unless NUL, or a space separator and `val` negative) followed by `val` hundredths as a minimal decimal (no
+   trailing zeros, no leading zero before point), returning end of output (at least 13 chars needed) */
+INTERNAL char *output_put_hundredths(char *out, const char cmd, const int val);
+
+/* An output file of `ZBarcode_Print_Multi()` */
+struct out_target {
+    const char *outfile;
+    int file_type; /* OUT_XXX_FILE */
+    int output_options; /* Added to the symbol's for this file only (SVG_GZIP for ".svgz") */
+};
+
+/* Stands in for the plotter of an output format left out of the build, failing as an invalid option */
+INTERNAL int output_excluded(struct zint_symbol *symbol);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -36,18 +36,20 @@
 #include <string.h>
 #include "common.h"
 #include "pcx.h"        /* PCX header structure */
+#include "filemem.h"
+#include "output.h"
 #include <math.h>
 #ifdef _MSC_VER
-#include <io.h>
-#include <fcntl.h>
 #include <malloc.h>
 #endif
 
 INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
-    int fgred, fggrn, fgblu, bgred, bggrn, bgblu;
+    static const char ultra_colour[] = "0CBMRYGKW";
+    unsigned char plane_map[3][128]; /* Red, green and blue of each pixel value (background unless set) */
     int row, column, i, colour;
     int run_count;
-    FILE *pcx_file;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     pcx_header_t header;
     int bytes_per_line = symbol->bitmap_width + (symbol->bitmap_width & 1); // Must be even
     unsigned char previous;
@@ -63,13 +65,18 @@ INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
 
     rle_row[bytes_per_line - 1] = 0; // Will remain zero if bitmap_width odd
 
-    fgred = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
-    fggrn = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
-    fgblu = (16 * ctoi(symbol->fgcolour[4])) + ctoi(symbol->fgcolour[5]);
-    bgred = (16 * ctoi(symbol->bgcolour[0])) + ctoi(symbol->bgcolour[1]);
-    bggrn = (16 * ctoi(symbol->bgcolour[2])) + ctoi(symbol->bgcolour[3]);
-    bgblu = (16 * ctoi(symbol->bgcolour[4])) + ctoi(symbol->bgcolour[5]);
-
+    memset(plane_map[0], OUT_RED(symbol->bgcolour_rgba), sizeof(plane_map[0]));
+    memset(plane_map[1], OUT_GREEN(symbol->bgcolour_rgba), sizeof(plane_map[1]));
+    memset(plane_map[2], OUT_BLUE(symbol->bgcolour_rgba), sizeof(plane_map[2]));
+    plane_map[0]['1'] = OUT_RED(symbol->fgcolour_rgba);
+    plane_map[1]['1'] = OUT_GREEN(symbol->fgcolour_rgba);
+    plane_map[2]['1'] = OUT_BLUE(symbol->fgcolour_rgba);
+    for (i = 1; i < 9; i++) {
+        const unsigned char value = (unsigned char) ultra_colour[i];
+        plane_map[0][value] = (unsigned char) colour_to_red(i);
+        plane_map[1][value] = (unsigned char) colour_to_green(i);
+        plane_map[2][value] = (unsigned char) colour_to_blue(i);
+    }
 
     header.manufacturer = 10; // ZSoft
     header.version = 5; // Version 3.0
@@ -100,94 +107,19 @@ INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     }
 
     /* Open output file in binary mode */
-    if (symbol->output_options & BARCODE_STDOUT) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "620: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-#endif
-        pcx_file = stdout;
-    } else {
-        if (!(pcx_file = fopen(symbol->outfile, "wb"))) {
-            strcpy(symbol->errtxt, "621: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
+    if (!fm_open(fmp, symbol, "wb")) {
+        strcpy(symbol->errtxt, "621: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
     }
 
-    fwrite(&header, sizeof (pcx_header_t), 1, pcx_file);
+    fm_write(&header, sizeof (pcx_header_t), 1, fmp);
 
     for (row = 0; row < symbol->bitmap_height; row++) {
+        const unsigned char *const pb = pixelbuf + (size_t) row * symbol->bitmap_width;
         for (colour = 0; colour < 3; colour++) {
+            const unsigned char *const map = plane_map[colour];
             for (column = 0; column < symbol->bitmap_width; column++) {
-                switch (colour) {
-                    case 0:
-                        switch(pixelbuf[(row * symbol->bitmap_width) + column]) {
-                            case 'W': // White
-                            case 'M': // Magenta
-                            case 'R': // Red
-                            case 'Y': // Yellow
-                                rle_row[column] = 255;
-                                break;
-                            case 'C': // Cyan
-                            case 'B': // Blue
-                            case 'G': // Green
-                            case 'K': // Black
-                                rle_row[column] = 0;
-                                break;
-                            case '1':
-                                rle_row[column] = fgred;
-                                break;
-                            default:
-                                rle_row[column] = bgred;
-                                break;
-                        }
-                        break;
-                    case 1:
-                        switch(pixelbuf[(row * symbol->bitmap_width) + column]) {
-                            case 'W': // White
-                            case 'C': // Cyan
-                            case 'Y': // Yellow
-                            case 'G': // Green
-                                rle_row[column] = 255;
-                                break;
-                            case 'B': // Blue
-                            case 'M': // Magenta
-                            case 'R': // Red
-                            case 'K': // Black
-                                rle_row[column] = 0;
-                                break;
-                            case '1':
-                                rle_row[column] = fggrn;
-                                break;
-                            default:
-                                rle_row[column] = bggrn;
-                                break;
-                        }
-                        break;
-                    case 2:
-                        switch(pixelbuf[(row * symbol->bitmap_width) + column]) {
-                            case 'W': // White
-                            case 'C': // Cyan
-                            case 'B': // Blue
-                            case 'M': // Magenta
-                                rle_row[column] = 255;
-                                break;
-                            case 'R': // Red
-                            case 'Y': // Yellow
-                            case 'G': // Green
-                            case 'K': // Black
-                                rle_row[column] = 0;
-                                break;
-                            case '1':
-                                rle_row[column] = fgblu;
-                                break;
-                            default:
-                                rle_row[column] = bgblu;
-                                break;
-                        }
-                        break;
-                }
+                rle_row[column] = map[pb[column]];
             }
 
             /* Based on ImageMagick/coders/pcx.c PCXWritePixels()
@@ -200,9 +132,9 @@ INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
                 } else {
                     if (run_count > 1 || (previous & 0xc0) == 0xc0) {
                         run_count += 0xc0;
-                        fputc(run_count, pcx_file);
+                        fm_putc(run_count, fmp);
                     }
-                    fputc(previous, pcx_file);
+                    fm_putc(previous, fmp);
                     previous = rle_row[column];
                     run_count = 1;
                 }
@@ -210,13 +142,16 @@ INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
 
             if (run_count > 1 || (previous & 0xc0) == 0xc0) {
                 run_count += 0xc0;
-                fputc(run_count, pcx_file);
+                fm_putc(run_count, fmp);
             }
-            fputc(previous, pcx_file);
+            fm_putc(previous, fmp);
         }
     }
 
-    fclose(pcx_file);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "622: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
+    }
 
     return 0;
 }
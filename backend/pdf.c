@@ -0,0 +1,570 @@
+/* pdf.c - Handles output to PDF (Portable Document Format) files */
+/* PDF Reference 1.4 (Adobe, 2001) */
+
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2009-2020 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <stdio.h>
+#include "common.h"
+#include "output.h"
+#include "filemem.h"
+
+/* Fixed object numbers, followed by the fonts (as first used) and each symbol's form (unless a duplicate) and
+   page */
+#define PDF_OBJ_CATALOG     1
+#define PDF_OBJ_PAGES       2
+#define PDF_OBJ_CONTENTS    3 /* Page contents "/X1 Do", shared by all pages */
+#define PDF_OBJ_INFO        4
+#define PDF_OBJ_FIXED       4
+
+/* Fill colours, besides Ultracode colours 0 to 8 */
+#define PDF_NONE            -2
+#define PDF_INK             -1
+#define PDF_PAPER           9
+
+/* Widths (1000 units per em) of standard fonts Helvetica and Helvetica-Bold in WinAnsiEncoding for 0x20 to 0x7E
+   then 0xA0 to 0xFF (ISO/IEC 8859-1), needed to centre or right-align text */
+static const unsigned short pdf_font_widths[2][191] = {
+    {
+        278, 278, 355, 556, 556, 889, 667, 191, 333, 333, 389, 584, 278, 333, 278, 278, /* 0x20 */
+        556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 278, 278, 584, 584, 584, 556, /* 0x30 */
+       1015, 667, 667, 722, 722, 667, 611, 778, 722, 278, 500, 667, 556, 833, 722, 778, /* 0x40 */
+        667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 278, 278, 278, 469, 556, /* 0x50 */
+        333, 556, 556, 500, 556, 556, 278, 556, 556, 222, 222, 500, 222, 833, 556, 556, /* 0x60 */
+        556, 556, 333, 500, 278, 556, 500, 722, 500, 500, 500, 334, 260, 334, 584,      /* 0x70 */
+        278, 333, 556, 556, 556, 556, 260, 556, 333, 737, 370, 556, 584, 333, 737, 333, /* 0xA0 */
+        400, 584, 333, 333, 333, 556, 537, 278, 333, 333, 365, 556, 834, 834, 834, 611, /* 0xB0 */
+        667, 667, 667, 667, 667, 667, 1000, 722, 667, 667, 667, 667, 278, 278, 278, 278, /* 0xC0 */
+        722, 722, 778, 778, 778, 778, 778, 584, 778, 722, 722, 722, 722, 667, 667, 611, /* 0xD0 */
+        556, 556, 556, 556, 556, 556, 889, 500, 556, 556, 556, 556, 278, 278, 278, 278, /* 0xE0 */
+        556, 556, 556, 556, 556, 556, 556, 584, 611, 556, 556, 556, 556, 500, 556, 500, /* 0xF0 */
+    },
+    {
+        278, 333, 474, 556, 556, 889, 722, 238, 333, 333, 389, 584, 278, 333, 278, 278, /* 0x20 */
+        556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 333, 333, 584, 584, 584, 611, /* 0x30 */
+        975, 722, 722, 722, 722, 667, 611, 778, 722, 278, 556, 722, 611, 833, 722, 778, /* 0x40 */
+        667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 333, 278, 333, 584, 556, /* 0x50 */
+        333, 556, 611, 556, 611, 556, 333, 611, 611, 278, 278, 556, 278, 889, 611, 611, /* 0x60 */
+        611, 611, 389, 556, 333, 611, 556, 778, 556, 556, 500, 389, 280, 389, 584,      /* 0x70 */
+        278, 333, 556, 556, 556, 556, 280, 556, 333, 737, 370, 556, 584, 333, 737, 333, /* 0xA0 */
+        400, 584, 333, 333, 333, 611, 556, 278, 333, 333, 365, 556, 834, 834, 834, 611, /* 0xB0 */
+        722, 722, 722, 722, 722, 722, 1000, 722, 667, 667, 667, 667, 278, 278, 278, 278, /* 0xC0 */
+        722, 722, 778, 778, 778, 778, 778, 584, 778, 722, 722, 722, 722, 667, 667, 611, /* 0xD0 */
+        556, 556, 556, 556, 556, 556, 889, 556, 556, 556, 556, 556, 278, 278, 278, 278, /* 0xE0 */
+        611, 611, 611, 611, 611, 611, 611, 584, 611, 611, 611, 611, 611, 556, 611, 556, /* 0xF0 */
+    },
+};
+
+static const char *const pdf_font_names[2] = { "Helvetica", "Helvetica-Bold" };
+
+/* Document state, tracking the offset of each object for the cross-reference table */
+struct pdf_doc {
+    struct filemem *fmp;
+    long pos; /* Bytes output so far */
+    long *offsets; /* Offset of each object, indexed by object number */
+    int obj_num; /* Last object number allocated */
+    int font_objs[2]; /* Helvetica and Helvetica-Bold objects, 0 if not (yet) used */
+};
+
+/* A form XObject, kept to detect duplicate symbols */
+struct pdf_form {
+    unsigned char *content;
+    size_t length;
+    unsigned int hash; /* Of `content`, to speed up comparison */
+    int width, height; /* Hundredths */
+    int font_obj;
+    int obj;
+};
+
+/* Fill colour state of a form */
+struct pdf_fill {
+    int ink[3];
+    int paper[3];
+    int cmyk;
+    int current; /* PDF_NONE, PDF_INK, PDF_PAPER or an Ultracode colour */
+};
+
+static void pdf_write(struct pdf_doc *doc, const char *str, const size_t len) {
+    fm_write(str, 1, len, doc->fmp);
+    doc->pos += (long) len;
+}
+
+static void pdf_puts(struct pdf_doc *doc, const char *str) {
+    pdf_write(doc, str, strlen(str));
+}
+
+/* Start object `obj`, recording its offset */
+static void pdf_obj_begin(struct pdf_doc *doc, const int obj) {
+    char buf[24];
+    doc->offsets[obj] = doc->pos;
+    sprintf(buf, "%d 0 obj\n", obj);
+    pdf_puts(doc, buf);
+}
+
+/* Put `n` hundredths `vals` (at most 8) separated by spaces, followed by operator `op` and a newline */
+static void pdf_put_op(const int vals[], const int n, const char *op, struct filemem *fmp) {
+    char buf[8 * 14 + 8];
+    char *b = buf;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        b = output_put_hundredths(b, '\0', vals[i]);
+        *b++ = ' ';
+    }
+    while (*op) {
+        *b++ = *op++;
+    }
+    *b++ = '\n';
+    fm_write(buf, 1, b - buf, fmp);
+}
+
+/* Put operator setting fill colour to RGB `rgb`, converted to DeviceCMYK if `cmyk` */
+static void pdf_put_colour(const int rgb[3], const int cmyk, struct filemem *fmp) {
+    int vals[4];
+    int i;
+
+    if (!cmyk) {
+        for (i = 0; i < 3; i++) {
+            vals[i] = output_hundredths(rgb[i] / 255.0f);
+        }
+        pdf_put_op(vals, 3, "rg", fmp);
+    } else {
+        const int max = rgb[0] > rgb[1] ? (rgb[0] > rgb[2] ? rgb[0] : rgb[2]) : (rgb[1] > rgb[2] ? rgb[1] : rgb[2]);
+        for (i = 0; i < 3; i++) {
+            vals[i] = max ? output_hundredths((max - rgb[i]) / (float) max) : 0;
+        }
+        vals[3] = output_hundredths((255 - max) / 255.0f);
+        pdf_put_op(vals, 4, "k", fmp);
+    }
+}
+
+/* Set fill colour to `colour` (PDF_INK, PDF_PAPER or an Ultracode colour) unless already set */
+static void pdf_fill_colour(struct pdf_fill *fill, const int colour, struct filemem *fmp) {
+    if (colour == fill->current) {
+        return;
+    }
+    fill->current = colour;
+    if (colour == PDF_INK) {
+        pdf_put_colour(fill->ink, fill->cmyk, fmp);
+    } else if (colour == PDF_PAPER) {
+        pdf_put_colour(fill->paper, fill->cmyk, fmp);
+    } else {
+        int rgb[3];
+        rgb[0] = colour_to_red(colour);
+        rgb[1] = colour_to_green(colour);
+        rgb[2] = colour_to_blue(colour);
+        pdf_put_colour(rgb, fill->cmyk, fmp);
+    }
+}
+
+/* Convert UTF-8 `string` to a PDF WinAnsiEncoding string literal body `pdf_string` (escaping parentheses and
+   backslashes), dropping anything not in ISO/IEC 8859-1, and return its width in 1000ths of the font size */
+static int pdf_convert(const unsigned char *string, unsigned char *pdf_string, const int bold) {
+    const unsigned char *s;
+    unsigned char *p = pdf_string;
+    int width = 0;
+
+    for (s = string; *s; s++) {
+        int ch;
+        if (*s < 0x80) {
+            ch = *s;
+        } else if (*s == 0xC2 || *s == 0xC3) { /* See `to_iso8859_1()` in raster.c */
+            if (!s[1]) {
+                break;
+            }
+            ch = *s == 0xC2 ? s[1] : s[1] + 64;
+            s++;
+        } else {
+            continue;
+        }
+        if (ch < 0x20 || (ch >= 0x7F && ch < 0xA0)) {
+            continue;
+        }
+        if (ch == '(' || ch == ')' || ch == '\\') {
+            *p++ = '\\';
+        }
+        *p++ = (unsigned char) ch;
+        width += pdf_font_widths[bold][ch < 0x7F ? ch - 0x20 : ch - 0xA0 + 0x5F];
+    }
+    *p = '\0';
+
+    return width;
+}
+
+/* Put the drawing operators of `symbol->vector`, filling rectangles, hexagons and each run of same-coloured
+   circles as single paths. Returns font used (0 Helvetica, 1 Helvetica-Bold), or -1 if none */
+static int pdf_form_content(const struct zint_symbol *symbol, struct filemem *fmp) {
+    const struct zint_vector *vector = symbol->vector;
+    const float height = vector->height;
+    struct zint_vector_rect *rect;
+    struct zint_vector_hexagon *hex;
+    struct zint_vector_circle *circle;
+    struct zint_vector_string *string;
+    struct pdf_fill fill;
+    int colours[10]; /* Foreground (-1) and Ultracode colours 0 to 8 */
+    int colours_size = 0;
+    int vals[6];
+    int font = -1;
+    int i;
+
+    fill.ink[0] = OUT_RED(symbol->fgcolour_rgba);
+    fill.ink[1] = OUT_GREEN(symbol->fgcolour_rgba);
+    fill.ink[2] = OUT_BLUE(symbol->fgcolour_rgba);
+    fill.paper[0] = OUT_RED(symbol->bgcolour_rgba);
+    fill.paper[1] = OUT_GREEN(symbol->bgcolour_rgba);
+    fill.paper[2] = OUT_BLUE(symbol->bgcolour_rgba);
+    fill.cmyk = symbol->output_options & CMYK_COLOUR;
+    fill.current = PDF_NONE;
+
+    /* Background, unless fully transparent */
+    if (OUT_ALPHA(symbol->bgcolour_rgba)) {
+        pdf_fill_colour(&fill, PDF_PAPER, fmp);
+        vals[0] = vals[1] = 0;
+        vals[2] = output_hundredths(vector->width);
+        vals[3] = output_hundredths(height);
+        pdf_put_op(vals, 4, "re f", fmp);
+    }
+
+    /* Rectangles, one path per colour in order of first appearance (bars and modules don't overlap) */
+    for (rect = vector->rectangles; rect; rect = rect->next) {
+        for (i = 0; i < colours_size && colours[i] != rect->colour; i++);
+        if (i == colours_size) {
+            colours[colours_size++] = rect->colour;
+        }
+    }
+    for (i = 0; i < colours_size; i++) {
+        pdf_fill_colour(&fill, colours[i] == -1 ? PDF_INK : colours[i], fmp);
+        for (rect = vector->rectangles; rect; rect = rect->next) {
+            if (rect->colour == colours[i]) {
+                vals[0] = output_hundredths(rect->x);
+                vals[1] = output_hundredths(height - rect->y - rect->height);
+                vals[2] = output_hundredths(rect->width);
+                vals[3] = output_hundredths(rect->height);
+                pdf_put_op(vals, 4, "re", fmp);
+            }
+        }
+        fm_puts("f\n", fmp);
+    }
+
+    /* Hexagons, as a single path */
+    if (vector->hexagons) {
+        pdf_fill_colour(&fill, PDF_INK, fmp);
+        for (hex = vector->hexagons; hex; hex = hex->next) {
+            const float radius = hex->diameter * 0.5f;
+            const float half_radius = hex->diameter * 0.25f;
+            const float half_sqrt3_radius = hex->diameter * 0.43301270189221932338f;
+            const float y = height - hex->y;
+            float xs[6], ys[6];
+            if (hex->rotation == 0 || hex->rotation == 180) {
+                xs[0] = hex->x;                     ys[0] = y + radius;
+                xs[1] = hex->x + half_sqrt3_radius; ys[1] = y + half_radius;
+                xs[2] = hex->x + half_sqrt3_radius; ys[2] = y - half_radius;
+                xs[3] = hex->x;                     ys[3] = y - radius;
+                xs[4] = hex->x - half_sqrt3_radius; ys[4] = y - half_radius;
+                xs[5] = hex->x - half_sqrt3_radius; ys[5] = y + half_radius;
+            } else {
+                xs[0] = hex->x - radius;      ys[0] = y;
+                xs[1] = hex->x - half_radius; ys[1] = y + half_sqrt3_radius;
+                xs[2] = hex->x + half_radius; ys[2] = y + half_sqrt3_radius;
+                xs[3] = hex->x + radius;      ys[3] = y;
+                xs[4] = hex->x + half_radius; ys[4] = y - half_sqrt3_radius;
+                xs[5] = hex->x - half_radius; ys[5] = y - half_sqrt3_radius;
+            }
+            for (i = 0; i < 6; i++) {
+                vals[0] = output_hundredths(xs[i]);
+                vals[1] = output_hundredths(ys[i]);
+                pdf_put_op(vals, 2, i ? "l" : "m", fmp);
+            }
+            fm_puts("h\n", fmp);
+        }
+        fm_puts("f\n", fmp);
+    }
+
+    /* Circles, as 4 Bézier curves each, a path for each run of the same colour (order matters as they can
+       overlap, e.g. MaxiCode bullseye) */
+    circle = vector->circles;
+    while (circle) {
+        const int colour = circle->colour;
+        pdf_fill_colour(&fill, colour ? PDF_PAPER : PDF_INK, fmp);
+        for (; circle && circle->colour == colour; circle = circle->next) {
+            const int x = output_hundredths(circle->x);
+            const int y = output_hundredths(height - circle->y);
+            const int r = output_hundredths(circle->diameter * 0.5f);
+            const int k = output_hundredths(circle->diameter * 0.5f * 0.55228475f); /* 4 * (sqrt(2) - 1) / 3 */
+            vals[0] = x + r; vals[1] = y;
+            pdf_put_op(vals, 2, "m", fmp);
+            vals[0] = x + r; vals[1] = y + k; vals[2] = x + k; vals[3] = y + r; vals[4] = x; vals[5] = y + r;
+            pdf_put_op(vals, 6, "c", fmp);
+            vals[0] = x - k; vals[1] = y + r; vals[2] = x - r; vals[3] = y + k; vals[4] = x - r; vals[5] = y;
+            pdf_put_op(vals, 6, "c", fmp);
+            vals[0] = x - r; vals[1] = y - k; vals[2] = x - k; vals[3] = y - r; vals[4] = x; vals[5] = y - r;
+            pdf_put_op(vals, 6, "c", fmp);
+            vals[0] = x + k; vals[1] = y - r; vals[2] = x + r; vals[3] = y - k; vals[4] = x + r; vals[5] = y;
+            pdf_put_op(vals, 6, "c", fmp);
+            fm_puts("h\n", fmp);
+        }
+        fm_puts("f\n", fmp);
+    }
+
+    /* Text, placed by text matrix (x axis rotated clockwise by `rotation`) with origin moved back along the
+       baseline by the full or half width for right or centre alignment */
+    if (vector->strings) {
+        unsigned char pdf_string[sizeof(symbol->text) * 2];
+        int fsize = -1;
+        if ((symbol->output_options & BOLD_TEXT)
+                && (!is_extendable(symbol->symbology) || (symbol->output_options & SMALL_TEXT))) {
+            font = 1;
+        } else {
+            font = 0;
+        }
+        pdf_fill_colour(&fill, PDF_INK, fmp);
+        fm_puts("BT\n", fmp);
+        for (string = vector->strings; string; string = string->next) {
+            const int width = pdf_convert(string->text, pdf_string, font);
+            const int cos_r = string->rotation == 0 ? 1 : string->rotation == 180 ? -1 : 0;
+            const int sin_r = string->rotation == 90 ? 1 : string->rotation == 270 ? -1 : 0;
+            float advance = 0.0f;
+            if (string->halign == 0 || string->halign == 2) {
+                advance = width * string->fsize / (string->halign == 2 ? 1000.0f : 2000.0f);
+            }
+            if (output_hundredths(string->fsize) != fsize) {
+                fsize = output_hundredths(string->fsize);
+                fm_puts("/F1 ", fmp);
+                pdf_put_op(&fsize, 1, "Tf", fmp);
+            }
+            vals[0] = cos_r * 100;
+            vals[1] = -sin_r * 100;
+            vals[2] = sin_r * 100;
+            vals[3] = cos_r * 100;
+            vals[4] = output_hundredths(string->x - cos_r * advance);
+            vals[5] = output_hundredths(height - string->y + sin_r * advance);
+            pdf_put_op(vals, 6, "Tm", fmp);
+            fm_printf(fmp, "(%s) Tj\n", pdf_string);
+        }
+        fm_puts("ET\n", fmp);
+    }
+
+    return font;
+}
+
+/* FNV-1a hash of `length` bytes of `data` */
+static unsigned int pdf_hash(const unsigned char *data, const size_t length) {
+    unsigned int hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* Output `count` symbols, each already plotted to `symbol->vector`, as a PDF document with a page per symbol sized
+   to fit, to the output file (or stdout/memory/write function) of `symbols[0]`. Each symbol is drawn by a form
+   XObject which identical symbols share, and fonts are shared by all */
+INTERNAL int pdf_plot_symbols(struct zint_symbol *symbols[], const int count) {
+    struct zint_symbol *const symbol = symbols[0];
+    struct filemem fm;
+    struct pdf_doc doc;
+    struct pdf_form *forms;
+    int forms_size = 0;
+    int *page_objs;
+    char buf[256];
+    char *b;
+    long xref_pos;
+    int error_number = 0;
+    int i, j;
+
+    doc.offsets = (long *) z_malloc(z_allocator(symbol), sizeof(long) * (PDF_OBJ_FIXED + 3 + 2 * (size_t) count));
+    forms = (struct pdf_form *) z_malloc(z_allocator(symbol), sizeof(struct pdf_form) * count);
+    page_objs = (int *) z_malloc(z_allocator(symbol), sizeof(int) * count);
+    if (!doc.offsets || !forms || !page_objs) {
+        z_free(z_allocator(symbol), doc.offsets);
+        z_free(z_allocator(symbol), forms);
+        z_free(z_allocator(symbol), page_objs);
+        strcpy(symbol->errtxt, "677: Insufficient memory for PDF output");
+        return ZINT_ERROR_MEMORY;
+    }
+
+    if (!fm_open(&fm, symbol, "wb")) {
+        z_free(z_allocator(symbol), doc.offsets);
+        z_free(z_allocator(symbol), forms);
+        z_free(z_allocator(symbol), page_objs);
+        strcpy(symbol->errtxt, "608: Could not open output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+    doc.fmp = &fm;
+    doc.pos = 0;
+    doc.obj_num = PDF_OBJ_FIXED;
+    doc.font_objs[0] = doc.font_objs[1] = 0;
+
+    /* Header, with binary comment so that transports treat as binary */
+    pdf_puts(&doc, "%PDF-1.4\n%\xE2\xE3\xCF\xD3\n");
+
+    pdf_obj_begin(&doc, PDF_OBJ_CONTENTS);
+    pdf_puts(&doc, "<< /Length 7 >>\nstream\n/X1 Do\nendstream\nendobj\n");
+
+    for (i = 0; i < count; i++) {
+        const struct zint_vector *vector = symbols[i]->vector;
+        struct filemem cfm;
+        struct pdf_form form;
+        int font;
+
+        memset(&cfm, 0, sizeof(cfm));
+        cfm.flags = BARCODE_MEMORY_FILE;
+        cfm.allocator = z_allocator(symbol);
+        font = pdf_form_content(symbols[i], &cfm);
+        if (fm_error(&cfm)) {
+            z_free(z_allocator(symbol), cfm.mem);
+            strcpy(symbol->errtxt, "677: Insufficient memory for PDF output");
+            error_number = ZINT_ERROR_MEMORY;
+            break;
+        }
+        form.content = cfm.mem;
+        form.length = cfm.memend;
+        form.hash = pdf_hash(form.content, form.length);
+        form.width = output_hundredths(vector->width);
+        form.height = output_hundredths(vector->height);
+        if (font == -1) {
+            form.font_obj = 0;
+        } else {
+            if (!doc.font_objs[font]) {
+                doc.font_objs[font] = ++doc.obj_num;
+            }
+            form.font_obj = doc.font_objs[font];
+        }
+
+        for (j = 0; j < forms_size; j++) {
+            if (forms[j].hash == form.hash && forms[j].length == form.length && forms[j].width == form.width
+                    && forms[j].height == form.height && forms[j].font_obj == form.font_obj
+                    && (form.length == 0 || memcmp(forms[j].content, form.content, form.length) == 0)) {
+                break;
+            }
+        }
+        if (j == forms_size) {
+            form.obj = ++doc.obj_num;
+            forms[forms_size++] = form;
+
+            pdf_obj_begin(&doc, form.obj);
+            b = buf + sprintf(buf, "<< /Type /XObject /Subtype /Form /BBox [0 0");
+            b = output_put_hundredths(b, ' ', form.width);
+            b = output_put_hundredths(b, ' ', form.height);
+            if (form.font_obj) {
+                b += sprintf(b, "] /Resources << /Font << /F1 %d 0 R >> >>", form.font_obj);
+            } else {
+                b += sprintf(b, "] /Resources << >>");
+            }
+            sprintf(b, " /Length %d >>\nstream\n", (int) form.length);
+            pdf_puts(&doc, buf);
+            if (form.length) {
+                pdf_write(&doc, (const char *) form.content, form.length);
+            }
+            pdf_puts(&doc, "endstream\nendobj\n");
+        } else {
+            z_free(z_allocator(symbol), form.content);
+        }
+
+        page_objs[i] = ++doc.obj_num;
+        pdf_obj_begin(&doc, page_objs[i]);
+        b = buf + sprintf(buf, "<< /Type /Page /Parent %d 0 R /MediaBox [0 0", PDF_OBJ_PAGES);
+        b = output_put_hundredths(b, ' ', form.width);
+        b = output_put_hundredths(b, ' ', form.height);
+        sprintf(b, "] /Resources << /XObject << /X1 %d 0 R >> >> /Contents %d 0 R >>\nendobj\n", forms[j].obj,
+                PDF_OBJ_CONTENTS);
+        pdf_puts(&doc, buf);
+    }
+
+    if (error_number == 0) {
+        for (i = 0; i < 2; i++) {
+            if (doc.font_objs[i]) {
+                pdf_obj_begin(&doc, doc.font_objs[i]);
+                sprintf(buf, "<< /Type /Font /Subtype /Type1 /BaseFont /%s /Encoding /WinAnsiEncoding >>\nendobj\n",
+                        pdf_font_names[i]);
+                pdf_puts(&doc, buf);
+            }
+        }
+
+        pdf_obj_begin(&doc, PDF_OBJ_PAGES);
+        pdf_puts(&doc, "<< /Type /Pages /Kids [");
+        for (i = 0; i < count; i++) {
+            sprintf(buf, i && i % 10 == 0 ? "\n%d 0 R" : i ? " %d 0 R" : "%d 0 R", page_objs[i]);
+            pdf_puts(&doc, buf);
+        }
+        sprintf(buf, "] /Count %d >>\nendobj\n", count);
+        pdf_puts(&doc, buf);
+
+        pdf_obj_begin(&doc, PDF_OBJ_CATALOG);
+        sprintf(buf, "<< /Type /Catalog /Pages %d 0 R >>\nendobj\n", PDF_OBJ_PAGES);
+        pdf_puts(&doc, buf);
+
+        pdf_obj_begin(&doc, PDF_OBJ_INFO);
+        if (ZINT_VERSION_BUILD) {
+            sprintf(buf, "<< /Producer (Zint %d.%d.%d.%d) >>\nendobj\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR,
+                    ZINT_VERSION_RELEASE, ZINT_VERSION_BUILD);
+        } else {
+            sprintf(buf, "<< /Producer (Zint %d.%d.%d) >>\nendobj\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR,
+                    ZINT_VERSION_RELEASE);
+        }
+        pdf_puts(&doc, buf);
+
+        /* Cross-reference table, entries exactly 20 bytes */
+        xref_pos = doc.pos;
+        sprintf(buf, "xref\n0 %d\n0000000000 65535 f \n", doc.obj_num + 1);
+        pdf_puts(&doc, buf);
+        for (i = 1; i <= doc.obj_num; i++) {
+            sprintf(buf, "%010ld 00000 n \n", doc.offsets[i]);
+            pdf_puts(&doc, buf);
+        }
+        sprintf(buf, "trailer\n<< /Size %d /Root %d 0 R /Info %d 0 R >>\nstartxref\n%ld\n%%%%EOF\n",
+                doc.obj_num + 1, PDF_OBJ_CATALOG, PDF_OBJ_INFO, xref_pos);
+        pdf_puts(&doc, buf);
+    }
+
+    for (i = 0; i < forms_size; i++) {
+        z_free(z_allocator(symbol), forms[i].content);
+    }
+    z_free(z_allocator(symbol), doc.offsets);
+    z_free(z_allocator(symbol), forms);
+    z_free(z_allocator(symbol), page_objs);
+
+    if (!fm_close(&fm, symbol)) {
+        if (error_number == 0) {
+            strcpy(symbol->errtxt, "609: Failed to write output");
+            error_number = ZINT_ERROR_FILE_WRITE;
+        }
+    }
+
+    return error_number;
+}
+
+/* Output a single symbol as a one page PDF document */
+INTERNAL int pdf_plot(struct zint_symbol *symbol) {
+    return pdf_plot_symbols(&symbol, 1);
+}
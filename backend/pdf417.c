@@ -43,6 +43,7 @@
    number of codeword columns not including row start and end data) */
 
 #include <stdio.h>
+#include <limits.h>
 #include <math.h>
 #ifndef _MSC_VER
 #include <stdint.h>
@@ -58,6 +59,18 @@
 #define BYT 901
 #define NUM 902
 
+/* States of `pdf_minimal_modes()` after a character: Text Compaction in submode Alpha, Lower, Mixed or Punctuation
+   having output an even or odd number of values (i.e. PDF_MIN_TEX + submode * 2 + odd), Byte Compaction having
+   output 0-5 bytes of a group of 6 and Numeric Compaction having output 0-43 digits of a group of 44 */
+#define PDF_MIN_TEX     0
+#define PDF_MIN_BYT     8
+#define PDF_MIN_NUM     14
+#define PDF_MIN_STATES  58
+
+#define PDF_MIN_NONE    (INT_MAX / 2) /* Cost of a state not reached, with headroom to add to it */
+#define PDF_MIN_LATCH   0x80 /* Flags a predecessor state at the same position in `preds` */
+#define PDF_MIN_SHIFT   0x10 /* Flags a character in `tables[]` encoded by a shift from the table */
+
 /*
    Three figure numbers in comments give the location of command equivalents in the
    original Visual Basic source code file pdf417.frm
@@ -94,6 +107,11 @@ static const char MicroAutosize[56] = {
 
 /* ISO/IEC 24728:2006 5.1.1 c) 3) Max possible number of characters (Numeric Compaction mode) */
 #define MICRO_PDF417_MAX_LEN    366
+/* Text Compaction can need up to 3 values (a 2 value latch plus the character) per input character, so allow for
+   that in the compacted stream before it's checked against the max codewords */
+#define PDF417_MAX_STREAM_LEN   (PDF417_MAX_LEN * 3)
+/* Working space of `textprocess()` and `textminimal()` */
+#define PDF_TEXT_BUF_LEN        (PDF417_MAX_LEN * 2 + PDF417_MAX_STREAM_LEN)
 
 /* 866 */
 
@@ -112,27 +130,19 @@ static int quelmode(unsigned char codeascii) {
 /* 844 */
 static void regroupe(int liste[2][PDF417_MAX_LEN], int *indexliste) {
 
-    /* bring together same type blocks */
+    /* bring together same type blocks in a single pass, block `j` accumulating the blocks of its type */
     if (*(indexliste) > 1) {
-        int i = 1;
-        while (i < *(indexliste)) {
-            if (liste[1][i - 1] == liste[1][i]) {
-                int j;
-                /* bring together */
-                liste[0][i - 1] = liste[0][i - 1] + liste[0][i];
-                j = i + 1;
-
-                /* decreace the list */
-                while (j < *(indexliste)) {
-                    liste[0][j - 1] = liste[0][j];
-                    liste[1][j - 1] = liste[1][j];
-                    j++;
-                }
-                *(indexliste) = *(indexliste) - 1;
-                i--;
+        int i, j = 0;
+        for (i = 1; i < *(indexliste); i++) {
+            if (liste[1][j] == liste[1][i]) {
+                liste[0][j] += liste[0][i];
+            } else {
+                j++;
+                liste[0][j] = liste[0][i];
+                liste[1][j] = liste[1][i];
             }
-            i++;
         }
+        *(indexliste) = j + 1;
     }
     /* 865 */
 }
@@ -233,9 +243,106 @@ static void pdfsmooth(int liste[2][PDF417_MAX_LEN], int *indexliste) {
     regroupe(liste, indexliste);
 }
 
+/* 619 - add the latch from text submode `curtable` to `newtable` to `chainet`, returning the new `wnet` */
+static int textlatch(int chainet[], int wnet, const int curtable, const int newtable) {
+    switch (curtable) {
+        case 1:
+            switch (newtable) {
+                case 2: chainet[wnet] = 27;
+                    wnet++;
+                    break;
+                case 4: chainet[wnet] = 28;
+                    wnet++;
+                    break;
+                case 8: chainet[wnet] = 28;
+                    wnet++;
+                    chainet[wnet] = 25;
+                    wnet++;
+                    break;
+            }
+            break;
+        case 2:
+            switch (newtable) {
+                case 1: chainet[wnet] = 28;
+                    wnet++;
+                    chainet[wnet] = 28;
+                    wnet++;
+                    break;
+                case 4: chainet[wnet] = 28;
+                    wnet++;
+                    break;
+                case 8: chainet[wnet] = 28;
+                    wnet++;
+                    chainet[wnet] = 25;
+                    wnet++;
+                    break;
+            }
+            break;
+        case 4:
+            switch (newtable) {
+                case 1: chainet[wnet] = 28;
+                    wnet++;
+                    break;
+                case 2: chainet[wnet] = 27;
+                    wnet++;
+                    break;
+                case 8: chainet[wnet] = 25;
+                    wnet++;
+                    break;
+            }
+            break;
+        case 8:
+            switch (newtable) {
+                case 1: chainet[wnet] = 29;
+                    wnet++;
+                    break;
+                case 2: chainet[wnet] = 29;
+                    wnet++;
+                    chainet[wnet] = 27;
+                    wnet++;
+                    break;
+                case 4: chainet[wnet] = 29;
+                    wnet++;
+                    chainet[wnet] = 28;
+                    wnet++;
+                    break;
+            }
+            break;
+    }
+    return wnet;
+}
+
+/* 663 - pad and translate the `wnet` text values in `chainet` into codewords */
+static void textcodewords(int *chainemc, int *mclength, int chainet[], int wnet, const int is_micro) {
+    int j;
+
+    if (wnet & 1) {
+        chainet[wnet] = 29;
+        wnet++;
+    }
+    /* Now translate the string chainet into codewords */
+
+    /* Default mode for PDF417 is Text Compaction Alpha (ISO/IEC 1543:2015 5.4.2.1), and for MICROPDF417 is Byte
+     * Compaction (ISO/IEC 24728:2006 5.4.3), so only add flag if not first codeword or is MICROPDF417 */
+    if (*mclength || is_micro) {
+        chainemc[(*mclength)++] = 900;
+    }
+
+    for (j = 0; j < wnet; j += 2) {
+        int cw_number;
+
+        cw_number = (30 * chainet[j]) + chainet[j + 1];
+        chainemc[(*mclength)++] = cw_number;
+    }
+}
+
 /* 547 */
-static void textprocess(int *chainemc, int *mclength, char chaine[], int start, int length, int is_micro) {
-    int j, indexlistet, curtable, listet[2][PDF417_MAX_LEN] = {{0}}, chainet[PDF417_MAX_LEN], wnet;
+/* `text_buf` is working space of PDF_TEXT_BUF_LEN ints, holding `listet` and `chainet` */
+static void textprocess(int *chainemc, int *mclength, char chaine[], int start, int length, int is_micro,
+            int text_buf[]) {
+    int j, indexlistet, curtable, wnet;
+    int (*listet)[PDF417_MAX_LEN] = (int (*)[PDF417_MAX_LEN]) text_buf;
+    int *chainet = text_buf + 2 * PDF417_MAX_LEN;
 
     wnet = 0;
 
@@ -302,70 +409,7 @@ static void textprocess(int *chainemc, int *mclength, char chaine[], int start,
                 }
 
                 /* 619 - select the switch */
-                switch (curtable) {
-                    case 1:
-                        switch (newtable) {
-                            case 2: chainet[wnet] = 27;
-                                wnet++;
-                                break;
-                            case 4: chainet[wnet] = 28;
-                                wnet++;
-                                break;
-                            case 8: chainet[wnet] = 28;
-                                wnet++;
-                                chainet[wnet] = 25;
-                                wnet++;
-                                break;
-                        }
-                        break;
-                    case 2:
-                        switch (newtable) {
-                            case 1: chainet[wnet] = 28;
-                                wnet++;
-                                chainet[wnet] = 28;
-                                wnet++;
-                                break;
-                            case 4: chainet[wnet] = 28;
-                                wnet++;
-                                break;
-                            case 8: chainet[wnet] = 28;
-                                wnet++;
-                                chainet[wnet] = 25;
-                                wnet++;
-                                break;
-                        }
-                        break;
-                    case 4:
-                        switch (newtable) {
-                            case 1: chainet[wnet] = 28;
-                                wnet++;
-                                break;
-                            case 2: chainet[wnet] = 27;
-                                wnet++;
-                                break;
-                            case 8: chainet[wnet] = 25;
-                                wnet++;
-                                break;
-                        }
-                        break;
-                    case 8:
-                        switch (newtable) {
-                            case 1: chainet[wnet] = 29;
-                                wnet++;
-                                break;
-                            case 2: chainet[wnet] = 29;
-                                wnet++;
-                                chainet[wnet] = 27;
-                                wnet++;
-                                break;
-                            case 4: chainet[wnet] = 29;
-                                wnet++;
-                                chainet[wnet] = 28;
-                                wnet++;
-                                break;
-                        }
-                        break;
-                }
+                wnet = textlatch(chainet, wnet, curtable, newtable);
                 curtable = newtable;
                 /* 659 - at last we add the character */
                 chainet[wnet] = listet[1][j];
@@ -374,25 +418,32 @@ static void textprocess(int *chainemc, int *mclength, char chaine[], int start,
         }
     }
 
-    /* 663 */
-    if (wnet & 1) {
-        chainet[wnet] = 29;
-        wnet++;
-    }
-    /* Now translate the string chainet into codewords */
+    textcodewords(chainemc, mclength, chainet, wnet, is_micro);
+}
 
-    /* Default mode for PDF417 is Text Compaction Alpha (ISO/IEC 1543:2015 5.4.2.1), and for MICROPDF417 is Byte
-     * Compaction (ISO/IEC 24728:2006 5.4.3), so only add flag if not first codeword or is MICROPDF417 */
-    if (*mclength || is_micro) {
-        chainemc[(*mclength)++] = 900;
-    }
+/* Like `textprocess()` but following the submodes set in `tables[]` by `pdf_minimal_modes()`, using `text_buf`
+   for `chainet` */
+static void textminimal(int *chainemc, int *mclength, unsigned char chaine[], const char tables[], int start,
+            int length, int is_micro, int text_buf[]) {
+    int j, curtable;
+    int *chainet = text_buf; /* Allow a 2 value latch or shift before each character */
+    int wnet = 0;
 
-    for (j = 0; j < wnet; j += 2) {
-        int cw_number;
-
-        cw_number = (30 * chainet[j]) + chainet[j + 1];
-        chainemc[(*mclength)++] = cw_number;
+    curtable = 1; /* default table */
+    for (j = start; j < start + length; j++) {
+        const int table = tables[j] & 0x0F;
+        if (table != curtable) {
+            wnet = textlatch(chainet, wnet, curtable, table);
+            curtable = table;
+        }
+        if (tables[j] & PDF_MIN_SHIFT) {
+            /* T_UPP if Lower and character in Alpha, else T_PUN */
+            chainet[wnet++] = curtable == 2 && (asciix[chaine[j]] & 1) ? 27 : 29;
+        }
+        chainet[wnet++] = asciiy[chaine[j]];
     }
+
+    textcodewords(chainemc, mclength, chainet, wnet, is_micro);
 }
 
 /* 671 */
@@ -453,93 +504,301 @@ INTERNAL void byteprocess(int *chainemc, int *mclength, unsigned char chaine[],
 }
 
 /* 712 */
-static void numbprocess(int *chainemc, int *mclength, char chaine[], int start, int length) {
-    int j, loop, dummy[50] = {0}, diviseur, nombre;
-    char chainemod[46], chainemult[46];
+static void numbprocess(int *chainemc, int *mclength, const char chaine[], const int start, const int length) {
+    static const uint64_t limb_base = UINT64_C(1000000000000000); /* 10^15, so 900 * base fits easily in 64 bits */
+    int j;
 
     chainemc[(*mclength)++] = 902;
 
-    j = 0;
-    while (j < length) {
-        int longueur;
-        int dumlength = 0;
-        int p;
-        longueur = length - j;
-        if (longueur > 44) {
-            longueur = 44;
-        }
-        chainemod[0] = '1';
-        for (loop = 1; loop <= longueur; loop++) {
-            chainemod[loop] = chaine[start + loop + j - 1];
+    for (j = 0; j < length; j += 44) {
+        const int longueur = length - j > 44 ? 44 : length - j;
+        const char *digits = chaine + start + j;
+        /* "1" followed by up to 44 digits in base 10^15 limbs, most significant first */
+        uint64_t limbs[3];
+        int num_limbs = (longueur + 1 + 14) / 15;
+        int first = 0; /* Index of most significant non-zero limb */
+        int base900[16];
+        int count = 0;
+        int i, d, limb_digits;
+
+        /* Load the number, the leading "1" going into the first (possibly partial) limb */
+        limb_digits = longueur + 1 - 15 * (num_limbs - 1);
+        d = 0;
+        for (i = 0; i < num_limbs; i++) {
+            uint64_t limb = i == 0 ? 1 : 0;
+            const int end = d + (i == 0 ? limb_digits - 1 : 15);
+            for (; d < end; d++) {
+                limb = limb * 10 + (digits[d] - '0');
+            }
+            limbs[i] = limb;
         }
-        chainemod[longueur + 1] = '\0';
+
+        /* Repeatedly divide by 900, collecting the remainders as the base 900 digits */
         do {
-            diviseur = 900;
-
-            /* 877 - gosub Modulo */
-            p = 0;
-            chainemult[p] = '\0';
-            nombre = 0;
-            for (loop = 0; chainemod[loop]; loop++) {
-                nombre *= 10;
-                nombre += ctoi(chainemod[loop]);
-                if (nombre < diviseur) {
-                    if (p) {
-                        chainemult[p++] = '0';
-                    }
-                } else {
-                    chainemult[p++] = (nombre / diviseur) + '0';
-                    nombre = nombre % diviseur;
+            uint64_t rem = 0;
+            for (i = first; i < num_limbs; i++) {
+                const uint64_t cur = rem * limb_base + limbs[i];
+                limbs[i] = cur / 900;
+                rem = cur % 900;
+            }
+            base900[count++] = (int) rem;
+            while (first < num_limbs && limbs[first] == 0) {
+                first++;
+            }
+        } while (first < num_limbs);
+
+        while (count) {
+            chainemc[(*mclength)++] = base900[--count];
+        }
+    }
+}
+
+/* Set `liste` to the blocks of compaction modes to encode `chaine` in that give the fewest codewords, for use in
+   place of `pdfsmooth()`, and `tables[]` to the table (submode) of each character in a Text block. Costs are
+   in text values (half codewords), so that each state has an exact cost: latching to a mode takes 2 (plus 1 to pad
+   an odd Text block), except Text if `text_free` (no codewords yet in PDF417, where it's the default), bytes of a
+   group take 2 each bar the 6th, and digits 2 for each extra codeword their group needs. Only the costs of the
+   current position are kept, and only the Numeric states reachable by the current run of digits are visited, so
+   it's linear in `length`. Returns 0 on success, else ZINT_ERROR_MEMORY */
+static int pdf_minimal_modes(struct zint_symbol *symbol, const unsigned char chaine[], const int length,
+            const int text_free, int liste[2][PDF417_MAX_LEN], int *p_indexliste, char tables[]) {
+    /* Text values to latch between Alpha, Lower, Mixed and Punctuation, as output by `textlatch()` */
+    static const char text_latches[4][4] = {
+        { 0, 1, 1, 2 }, { 2, 0, 1, 2 }, { 1, 1, 0, 1 }, { 1, 2, 2, 0 }
+    };
+    /* Codewords `numbprocess()` outputs for a group of 0-44 digits (base 900 digits of "1" followed by them) */
+    static const char num_cws[45] = {
+        0, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8,
+        9, 9, 9, 10, 10, 10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15
+    };
+    int costs[2][PDF_MIN_STATES];
+    int *cost = costs[0], *next = costs[1];
+    int num_states; /* Numeric states 0 to `num_states - 1` reached (others undefined) */
+    unsigned char *preds; /* Previous state, flagged with PDF_MIN_LATCH if at the same position */
+    int i, p, state, best_cost, indexliste;
+
+    preds = (unsigned char *) z_malloc(z_allocator(symbol), (size_t) (length + 1) * PDF_MIN_STATES);
+    if (!preds) {
+        strcpy(symbol->errtxt, "466: Insufficient memory for minimal compaction");
+        return ZINT_ERROR_MEMORY;
+    }
+    memset(preds, 0, PDF_MIN_STATES);
+    for (i = 0; i < PDF_MIN_NUM; i++) {
+        cost[i] = PDF_MIN_NONE;
+    }
+    cost[PDF_MIN_TEX] = text_free ? 0 : 2;
+    cost[PDF_MIN_BYT] = 2;
+    cost[PDF_MIN_NUM] = 2;
+    num_states = 1;
+
+    for (p = 0; p < length; p++) {
+        unsigned char *const pred = preds + p * PDF_MIN_STATES;
+        const int table = chaine[p] < 127 ? asciix[chaine[p]] : 0;
+        int best[3], best_preds[3], text_costs[PDF_MIN_BYT], next_num_states;
+        unsigned char *to_pred;
+        int *swap;
+
+        /* Latch to another mode from the cheapest state of each of the others, Text padded to a whole codeword */
+        best[0] = best[1] = best[2] = PDF_MIN_NONE;
+        best_preds[0] = best_preds[1] = best_preds[2] = 0;
+        for (state = 0; state < PDF_MIN_NUM + num_states; state++) {
+            const int mode = state < PDF_MIN_BYT ? 0 : state < PDF_MIN_NUM ? 1 : 2;
+            if (cost[state] + (mode == 0 && (state & 1)) < best[mode]) {
+                best[mode] = cost[state] + (mode == 0 && (state & 1));
+                best_preds[mode] = state;
+            }
+        }
+        if (num_states == 0) {
+            cost[PDF_MIN_NUM] = PDF_MIN_NONE;
+            num_states = 1;
+        }
+        for (i = 0; i < 3; i++) {
+            static const int latch_states[3] = { PDF_MIN_TEX, PDF_MIN_BYT, PDF_MIN_NUM };
+            const int from = best[(i + 1) % 3] <= best[(i + 2) % 3] ? (i + 1) % 3 : (i + 2) % 3;
+            if (best[from] + 2 < cost[latch_states[i]]) {
+                cost[latch_states[i]] = best[from] + 2;
+                pred[latch_states[i]] = (unsigned char) (PDF_MIN_LATCH | best_preds[from]);
+            }
+        }
+
+        /* Latch to another Text submode */
+        memcpy(text_costs, cost, sizeof(text_costs));
+        for (state = PDF_MIN_TEX; state < PDF_MIN_BYT; state++) {
+            int sub;
+            for (sub = 0; sub < 4; sub++) {
+                const int latch = text_latches[state >> 1][sub];
+                const int next_state = PDF_MIN_TEX + sub * 2 + ((state + latch) & 1);
+                if (latch && text_costs[state] + latch < cost[next_state]) {
+                    cost[next_state] = text_costs[state] + latch;
+                    pred[next_state] = (unsigned char) (PDF_MIN_LATCH | state);
                 }
             }
-            chainemult[p] = '\0';
-            diviseur = nombre;
-            /* return to 723 */
+        }
 
-            dummy[dumlength++] = diviseur;
-            strcpy(chainemod, chainemult);
-        } while (p);
-        for (loop = dumlength - 1; loop >= 0; loop--) {
-            chainemc[(*mclength)++] = dummy[loop];
+        /* Encode the character in each state, each state after being reachable from only one before */
+        to_pred = pred + PDF_MIN_STATES;
+        for (state = PDF_MIN_TEX; state < PDF_MIN_BYT; state++) {
+            const int sub = state >> 1;
+            if (table & (1 << sub)) { /* Directly, changing parity */
+                next[state ^ 1] = cost[state] + 1;
+                to_pred[state ^ 1] = (unsigned char) state;
+            } else if (((table & 1) && sub == 1) || ((table & 8) && sub != 3)) { /* T_UPP or T_PUN */
+                next[state] = cost[state] + 2;
+                to_pred[state] = (unsigned char) state;
+            } else {
+                next[state] = PDF_MIN_NONE;
+            }
         }
-        j += longueur;
+        for (state = PDF_MIN_BYT; state < PDF_MIN_NUM; state++) {
+            const int next_state = state == PDF_MIN_NUM - 1 ? PDF_MIN_BYT : state + 1;
+            next[next_state] = cost[state] + (next_state == PDF_MIN_BYT ? 0 : 2); /* 6 bytes take 5 codewords */
+            to_pred[next_state] = (unsigned char) state;
+        }
+        next_num_states = 0;
+        if (chaine[p] >= '0' && chaine[p] <= '9') {
+            next_num_states = num_states < 44 ? num_states + 1 : 44;
+            next[PDF_MIN_NUM] = PDF_MIN_NONE; /* Unless 44 reached */
+            for (i = 0; i < num_states; i++) {
+                const int next_state = PDF_MIN_NUM + (i + 1) % 44;
+                next[next_state] = cost[PDF_MIN_NUM + i] + (num_cws[i + 1] - num_cws[i]) * 2;
+                to_pred[next_state] = (unsigned char) (PDF_MIN_NUM + i);
+            }
+        }
+        swap = cost;
+        cost = next;
+        next = swap;
+        num_states = next_num_states;
+    }
+
+    best_cost = PDF_MIN_NONE;
+    state = PDF_MIN_TEX;
+    for (i = 0; i < PDF_MIN_NUM + num_states; i++) {
+        if (cost[i] + (i < PDF_MIN_BYT && (i & 1)) < best_cost) {
+            best_cost = cost[i] + (i < PDF_MIN_BYT && (i & 1));
+            state = i;
+        }
+    }
+    if (symbol->debug & ZINT_DEBUG_PRINT) {
+        printf("Minimal compaction codewords: %d\n", best_cost / 2);
+    }
+
+    /* Trace back from the end, building the blocks in reverse */
+    indexliste = 0;
+    p = length;
+    while (p || (preds[state] & PDF_MIN_LATCH)) {
+        const int prev_state = preds[p * PDF_MIN_STATES + state] & ~PDF_MIN_LATCH;
+        int mode;
+        if (preds[p * PDF_MIN_STATES + state] & PDF_MIN_LATCH) {
+            state = prev_state;
+            continue;
+        }
+        p--;
+        mode = prev_state < PDF_MIN_BYT ? TEX : prev_state < PDF_MIN_NUM ? BYT : NUM;
+        if (mode == TEX) {
+            /* Encoding a character directly changes parity, shifting doesn't */
+            tables[p] = (char) ((1 << (prev_state >> 1)) | ((prev_state & 1) == (state & 1) ? PDF_MIN_SHIFT : 0));
+        }
+        if (indexliste == 0 || liste[1][indexliste - 1] != mode) {
+            liste[0][indexliste] = 0;
+            liste[1][indexliste++] = mode;
+        }
+        liste[0][indexliste - 1]++;
+        state = prev_state;
+    }
+    for (i = 0; i < indexliste / 2; i++) {
+        int tmp = liste[0][i];
+        liste[0][i] = liste[0][indexliste - 1 - i];
+        liste[0][indexliste - 1 - i] = tmp;
+        tmp = liste[1][i];
+        liste[1][i] = liste[1][indexliste - 1 - i];
+        liste[1][indexliste - 1 - i] = tmp;
+    }
+    *p_indexliste = indexliste;
+
+    z_free(z_allocator(symbol), preds);
+
+    return 0;
+}
+
+/* Append the `k` Reed-Solomon error correction codewords over GF(929) of the `mclength` codewords of `chainemc`,
+   `coefs` the generator polynomial coefficients for `k` */
+static void pdf_rs_ecc(int chainemc[], const int mclength, const unsigned short coefs[], const int k) {
+    /* The shift register is held negated, so needs no complementing at the end, and rather than being shifted
+       moves down the buffer one position per codeword, leaving a plain multiply-add per coefficient. As each entry
+       gets at most `k` (<= 512) products of 2 values < 929 added before leaving the register, the sums fit in 32
+       bits, and need only be reduced modulo 929 when they reach the top */
+    unsigned int ecc[PDF417_MAX_LEN];
+    unsigned int *e = ecc + mclength;
+    int i, j;
+
+    assert(mclength + k <= PDF417_MAX_LEN && k <= 512);
+
+    for (j = 0; j < k; j++) {
+        e[j] = 0;
+    }
+    for (i = 0; i < mclength; i++) {
+        const unsigned int total = (chainemc[i] + 929 - e[k - 1] % 929) % 929;
+        *--e = 0;
+        for (j = 0; j < k; j++) {
+            e[j] += total * coefs[j];
+        }
+    }
+
+    for (i = k - 1; i >= 0; i--) {
+        chainemc[mclength + k - 1 - i] = e[i] % 929;
     }
 }
 
 /* 366 */
 static int pdf417(struct zint_symbol *symbol, unsigned char chaine[], const int length) {
-    int i, k, j, indexchaine, indexliste, mode, longueur, loop, mccorrection[520] = {0}, offset;
-    int total, chainemc[PDF417_MAX_LEN], mclength, c1, c2, c3, dummy[35], calcheight;
-    int liste[2][PDF417_MAX_LEN] = {{0}};
+    int i, k, j, indexchaine, indexliste, mode, longueur, loop, offset;
+    int mclength, c1, c2, c3, dummy[35], calcheight;
     char pattern[580];
     int bp = 0;
     int error_number = 0;
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
+    z_work_array(symbol, int, chainemc, PDF417_MAX_STREAM_LEN);
+    z_work_array2(symbol, int, liste, 2, PDF417_MAX_LEN);
+    z_work_array(symbol, char, tables, PDF417_MAX_LEN); /* Text submodes if MINIMAL_MODE */
+    z_work_array(symbol, int, text_buf, PDF_TEXT_BUF_LEN);
+
+    if (z_work_failed(chainemc) || z_work_failed(liste) || z_work_failed(tables) || z_work_failed(text_buf)) {
+        return z_work_error(symbol);
+    }
+    memset(liste, 0, sizeof(int) * 2 * PDF417_MAX_LEN);
 
     if (length > PDF417_MAX_LEN) {
         strcpy(symbol->errtxt, "463: Input string too long");
         return ZINT_ERROR_TOO_LONG;
     }
 
-    /* 456 */
-    indexliste = 0;
-    indexchaine = 0;
+    if (symbol->input_mode & MINIMAL_MODE) {
+        const int text_free = !(symbol->output_options & READER_INIT) && !symbol->eci;
+        error_number = pdf_minimal_modes(symbol, chaine, length, text_free, liste, &indexliste, tables);
+        if (error_number) {
+            return error_number;
+        }
+    } else {
+        /* 456 */
+        indexliste = 0;
+        indexchaine = 0;
 
-    mode = quelmode(chaine[indexchaine]);
+        mode = quelmode(chaine[indexchaine]);
 
-    /* 463 */
-    do {
-        liste[1][indexliste] = mode;
-        while ((liste[1][indexliste] == mode) && (indexchaine < length)) {
-            liste[0][indexliste]++;
-            indexchaine++;
-            mode = quelmode(chaine[indexchaine]);
-        }
-        indexliste++;
-    } while (indexchaine < length);
+        /* 463 */
+        do {
+            liste[1][indexliste] = mode;
+            while ((liste[1][indexliste] == mode) && (indexchaine < length)) {
+                liste[0][indexliste]++;
+                indexchaine++;
+                mode = quelmode(chaine[indexchaine]);
+            }
+            indexliste++;
+        } while (indexchaine < length);
 
-    /* 474 */
-    pdfsmooth(liste, &indexliste);
+        /* 474 */
+        pdfsmooth(liste, &indexliste);
+    }
 
     if (debug) {
         printf("Initial block pattern:\n");
@@ -596,7 +855,13 @@ static int pdf417(struct zint_symbol *symbol, unsigned char chaine[], const int
     for (i = 0; i < indexliste; i++) {
         switch (liste[1][i]) {
             case TEX: /* 547 - text mode */
-                textprocess(chainemc, &mclength, (char*) chaine, indexchaine, liste[0][i], 0 /*is_micro*/);
+                if (symbol->input_mode & MINIMAL_MODE) {
+                    textminimal(chainemc, &mclength, chaine, tables, indexchaine, liste[0][i], 0 /*is_micro*/,
+                                text_buf);
+                } else {
+                    textprocess(chainemc, &mclength, (char*) chaine, indexchaine, liste[0][i], 0 /*is_micro*/,
+                                text_buf);
+                }
                 break;
             case BYT: /* 670 - octet stream mode */
                 byteprocess(chainemc, &mclength, chaine, indexchaine, liste[0][i], debug);
@@ -702,19 +967,8 @@ static int pdf417(struct zint_symbol *symbol, unsigned char chaine[], const int
             break;
     }
 
-    longueur = mclength;
-    for (i = 0; i < longueur; i++) {
-        total = (chainemc[i] + mccorrection[k - 1]) % 929;
-        for (j = k - 1; j > 0; j--) {
-            mccorrection[j] = (mccorrection[j - 1] + 929 - (total * coefrs[offset + j]) % 929) % 929;
-        }
-        mccorrection[0] = (929 - (total * coefrs[offset]) % 929) % 929;
-    }
-
-    /* we add these codes to the string */
-    for (i = k - 1; i >= 0; i--) {
-        chainemc[mclength++] = mccorrection[i] ? 929 - mccorrection[i] : 0;
-    }
+    pdf_rs_ecc(chainemc, mclength, coefrs + offset, k);
+    mclength += k;
     
     if (debug) {
         printf("Complete CW string:\n");
@@ -837,14 +1091,22 @@ INTERNAL int pdf417enc(struct zint_symbol *symbol, unsigned char source[], int l
 
 /* like PDF417 only much smaller! */
 INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], int length) {
-    int i, k, j, indexchaine, indexliste, mode, longueur, mccorrection[50] = {0}, offset;
-    int total, chainemc[PDF417_MAX_LEN], mclength, codeerr;
-    int liste[2][PDF417_MAX_LEN] = {{0}};
+    int i, k, j, indexchaine, indexliste, mode, longueur, offset;
+    int mclength, codeerr;
+    char tables[MICRO_PDF417_MAX_LEN]; /* Text submodes if MINIMAL_MODE */
     char pattern[580];
     int bp = 0;
     int variant, LeftRAPStart, CentreRAPStart, RightRAPStart, StartCluster;
     int LeftRAP, CentreRAP, RightRAP, Cluster, loop, calcheight;
     int debug = symbol->debug & ZINT_DEBUG_PRINT;
+    z_work_array(symbol, int, chainemc, PDF417_MAX_LEN);
+    z_work_array2(symbol, int, liste, 2, PDF417_MAX_LEN);
+    z_work_array(symbol, int, text_buf, PDF_TEXT_BUF_LEN);
+
+    if (z_work_failed(chainemc) || z_work_failed(liste) || z_work_failed(text_buf)) {
+        return z_work_error(symbol);
+    }
+    memset(liste, 0, sizeof(int) * 2 * PDF417_MAX_LEN);
 
     if (length > MICRO_PDF417_MAX_LEN) {
         strcpy(symbol->errtxt, "474: Input data too long");
@@ -854,25 +1116,32 @@ INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], in
     /* Encoding starts out the same as PDF417, so use the same code */
     codeerr = 0;
 
-    /* 456 */
-    indexliste = 0;
-    indexchaine = 0;
+    if (symbol->input_mode & MINIMAL_MODE) {
+        codeerr = pdf_minimal_modes(symbol, chaine, length, 0 /*text_free*/, liste, &indexliste, tables);
+        if (codeerr) {
+            return codeerr;
+        }
+    } else {
+        /* 456 */
+        indexliste = 0;
+        indexchaine = 0;
 
-    mode = quelmode(chaine[indexchaine]);
+        mode = quelmode(chaine[indexchaine]);
 
-    /* 463 */
-    do {
-        liste[1][indexliste] = mode;
-        while ((liste[1][indexliste] == mode) && (indexchaine < length)) {
-            liste[0][indexliste]++;
-            indexchaine++;
-            mode = quelmode(chaine[indexchaine]);
-        }
-        indexliste++;
-    } while (indexchaine < length);
+        /* 463 */
+        do {
+            liste[1][indexliste] = mode;
+            while ((liste[1][indexliste] == mode) && (indexchaine < length)) {
+                liste[0][indexliste]++;
+                indexchaine++;
+                mode = quelmode(chaine[indexchaine]);
+            }
+            indexliste++;
+        } while (indexchaine < length);
 
-    /* 474 */
-    pdfsmooth(liste, &indexliste);
+        /* 474 */
+        pdfsmooth(liste, &indexliste);
+    }
 
     if (debug) {
         printf("Initial mapping:\n");
@@ -930,7 +1199,13 @@ INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], in
     for (i = 0; i < indexliste; i++) {
         switch (liste[1][i]) {
             case TEX: /* 547 - text mode */
-                textprocess(chainemc, &mclength, (char*) chaine, indexchaine, liste[0][i], 1 /*is_micro*/);
+                if (symbol->input_mode & MINIMAL_MODE) {
+                    textminimal(chainemc, &mclength, chaine, tables, indexchaine, liste[0][i], 1 /*is_micro*/,
+                                text_buf);
+                } else {
+                    textprocess(chainemc, &mclength, (char*) chaine, indexchaine, liste[0][i], 1 /*is_micro*/,
+                                text_buf);
+                }
                 break;
             case BYT: /* 670 - octet stream mode */
                 byteprocess(chainemc, &mclength, chaine, indexchaine, liste[0][i], debug);
@@ -1119,28 +1394,8 @@ INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], in
     }
 
     /* Reed-Solomon error correction */
-    longueur = mclength;
-    for (i = 0; i < longueur; i++) {
-        total = (chainemc[i] + mccorrection[k - 1]) % 929;
-        for (j = k - 1; j >= 0; j--) {
-            if (j == 0) {
-                mccorrection[j] = (929 - (total * Microcoeffs[offset + j]) % 929) % 929;
-            } else {
-                mccorrection[j] = (mccorrection[j - 1] + 929 - (total * Microcoeffs[offset + j]) % 929) % 929;
-            }
-        }
-    }
-
-    for (j = 0; j < k; j++) {
-        if (mccorrection[j] != 0) {
-            mccorrection[j] = 929 - mccorrection[j];
-        }
-    }
-    /* we add these codes to the string */
-    for (i = k - 1; i >= 0; i--) {
-        chainemc[mclength] = mccorrection[i];
-        mclength++;
-    }
+    pdf_rs_ecc(chainemc, mclength, Microcoeffs + offset, k);
+    mclength += k;
 
     if (debug) {
         printf("Encoded Data Stream with ECC:\n");
@@ -1243,3 +1498,9 @@ INTERNAL int micro_pdf417(struct zint_symbol *symbol, unsigned char chaine[], in
 
     return codeerr;
 }
+
+/* Page in the codeword patterns and error correction coefficients (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t pdf417_tables_warm(const int touch) {
+    return z_table_warm(pdf_bitpattern, sizeof(pdf_bitpattern), touch) + z_table_warm(coefrs, sizeof(coefrs), touch)
+            + z_table_warm(Microcoeffs, sizeof(Microcoeffs), touch);
+}
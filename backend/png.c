@@ -33,115 +33,102 @@
 
 #include <stdio.h>
 #ifdef _MSC_VER
-#include <fcntl.h>
-#include <io.h>
 #include <malloc.h>
 #endif
 #include "common.h"
+#include "filemem.h"
+#include "output.h"
+#include "raster.h"
 
-#ifndef NO_PNG
-#include <png.h>
-#include <zlib.h>
-#include <setjmp.h>
-
-#define SSET	"0123456789ABCDEF"
 
-struct mainprog_info_type {
-    long width;
-    long height;
-    FILE *outfile;
-    jmp_buf jmpbuf;
+/* Palette colour, same layout as libpng's `png_color` */
+struct png_colour {
+    unsigned char red;
+    unsigned char green;
+    unsigned char blue;
 };
 
-static void writepng_error_handler(png_structp png_ptr, png_const_charp msg) {
-    struct mainprog_info_type *graphic;
+/* Palette and row format shared by the libpng and built-in encoders */
+struct png_palette {
+    unsigned char map[128]; /* Pixel character to palette index */
+    struct png_colour colours[32];
+    int num_colours;
+    unsigned char trans_alpha[32];
+    int num_trans;
+    int bit_depth;
+    int row_bytes;
+};
 
-    fprintf(stderr, "writepng libpng error: %s (F30)\n", msg);
-    fflush(stderr);
+/* Remove unused colours from palette, adjusting `map` and `trans_alpha` to match */
+static void compact_palette(const struct zint_symbol *symbol, struct raster_rows *rows,
+            struct png_palette *pal) {
+    unsigned char used_chars[128] = {0};
+    unsigned char used[32] = {0};
+    unsigned char new_idx[32];
+    const unsigned char *prev = NULL;
+    const int num_colours = pal->num_colours, num_trans = pal->num_trans;
+    int row, i;
 
-    graphic = (struct mainprog_info_type*) png_get_error_ptr(png_ptr);
-    if (graphic == NULL) {
-        /* we are completely hosed now */
-        fprintf(stderr,
-                "writepng severe error:  jmpbuf not recoverable; terminating. (F31)\n");
-        fflush(stderr);
-        return;
+    for (row = 0; row < symbol->bitmap_height; row++) {
+        const unsigned char *const pb = raster_rows_get(rows, row);
+        if (pb != prev) { /* Skip rows returned again as repeats */
+            for (i = 0; i < symbol->bitmap_width; i++) {
+                used_chars[pb[i] & 0x7F] = 1;
+            }
+            prev = pb;
+        }
     }
-    longjmp(graphic->jmpbuf, 1);
-}
-
-/* Guestimate best compression strategy */
-static int guess_compression_strategy(struct zint_symbol *symbol, unsigned char *pixelbuf) {
-    (void)pixelbuf;
-
-    /* TODO: Do properly */
-
-    /* It seems the best choice for typical barcode pngs is one of Z_DEFAULT_STRATEGY and Z_FILTERED */
-
-    /* Some guesses */
-    if (symbol->symbology == BARCODE_MAXICODE) {
-        return Z_DEFAULT_STRATEGY;
+    for (i = 0; i < 128; i++) {
+        if (used_chars[i]) {
+            used[pal->map[i]] = 1;
+        }
     }
-    if (symbol->symbology == BARCODE_AZTEC && symbol->bitmap_width <= 30) {
-        return Z_DEFAULT_STRATEGY;
+    /* Counts of used colours and of those up to the last with alpha */
+    pal->num_colours = pal->num_trans = 0;
+    for (i = 0; i < num_colours; i++) {
+        if (used[i]) {
+            const int idx = pal->num_colours++;
+            new_idx[i] = idx;
+            pal->colours[idx] = pal->colours[i];
+            pal->trans_alpha[idx] = i < num_trans ? pal->trans_alpha[i] : 0xff;
+            if (pal->trans_alpha[idx] != 0xff) {
+                pal->num_trans = idx + 1;
+            }
+        }
+    }
+    for (i = 0; i < 128; i++) {
+        if (used_chars[i]) {
+            pal->map[i] = new_idx[pal->map[i]];
+        }
     }
-
-    /* Z_FILTERED seems to work better for slightly more barcodes+data so default to that */
-    return Z_FILTERED;
 }
 
-INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
-    struct mainprog_info_type wpng_info;
-    struct mainprog_info_type *graphic;
-    png_structp png_ptr;
-    png_infop info_ptr;
-    int i;
-    int row, column;
-    png_color bg, fg;
+/* Set up palette, transparency, bit depth and row size from the symbol's colours */
+static void setup_palette(const struct zint_symbol *symbol, struct raster_rows *rows,
+            struct png_palette *pal) {
+    struct png_colour bg, fg;
     unsigned char bg_alpha, fg_alpha;
-    unsigned char map[128];
-    png_color palette[32];
+    unsigned char *const map = pal->map;
+    struct png_colour *const palette = pal->colours;
+    unsigned char *const trans_alpha = pal->trans_alpha;
     int num_palette;
-    unsigned char trans_alpha[32];
     int num_trans;
-    int bit_depth;
-    int compression_strategy;
-    unsigned char *pb;
-
-#ifndef _MSC_VER
-    unsigned char outdata[symbol->bitmap_width];
-#else
-    unsigned char* outdata = (unsigned char*) _alloca(symbol->bitmap_width);
-#endif
-
-    graphic = &wpng_info;
-
-    graphic->width = symbol->bitmap_width;
-    graphic->height = symbol->bitmap_height;
-
-    fg.red = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
-    fg.green = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
-    fg.blue = (16 * ctoi(symbol->fgcolour[4])) + ctoi(symbol->fgcolour[5]);
-    bg.red = (16 * ctoi(symbol->bgcolour[0])) + ctoi(symbol->bgcolour[1]);
-    bg.green = (16 * ctoi(symbol->bgcolour[2])) + ctoi(symbol->bgcolour[3]);
-    bg.blue = (16 * ctoi(symbol->bgcolour[4])) + ctoi(symbol->bgcolour[5]);
+    int i;
 
-    if (strlen(symbol->fgcolour) > 6) {
-        fg_alpha = (16 * ctoi(symbol->fgcolour[6])) + ctoi(symbol->fgcolour[7]);
-    } else {
-        fg_alpha = 0xff;
-    }
+    fg.red = OUT_RED(symbol->fgcolour_rgba);
+    fg.green = OUT_GREEN(symbol->fgcolour_rgba);
+    fg.blue = OUT_BLUE(symbol->fgcolour_rgba);
+    bg.red = OUT_RED(symbol->bgcolour_rgba);
+    bg.green = OUT_GREEN(symbol->bgcolour_rgba);
+    bg.blue = OUT_BLUE(symbol->bgcolour_rgba);
 
-    if (strlen(symbol->bgcolour) > 6) {
-        bg_alpha = (16 * ctoi(symbol->bgcolour[6])) + ctoi(symbol->bgcolour[7]);
-    } else {
-        bg_alpha = 0xff;
-    }
+    fg_alpha = OUT_ALPHA(symbol->fgcolour_rgba);
+    bg_alpha = OUT_ALPHA(symbol->bgcolour_rgba);
 
     num_trans = 0;
     if (symbol->symbology == BARCODE_ULTRA) {
         static const int ultra_chars[8] = { 'W', 'C', 'B', 'M', 'R', 'Y', 'G', 'K' };
-        static png_color ultra_colours[8] = {
+        static const struct png_colour ultra_colours[8] = {
             { 0xff, 0xff, 0xff, }, /* White */
             {    0, 0xff, 0xff, }, /* Cyan */
             {    0,    0, 0xff, }, /* Blue */
@@ -219,35 +206,619 @@ INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         map['1'] = fg_idx;
         palette[fg_idx] = fg;
         num_palette = 2;
+
+        if (symbol->output_options & BARCODE_ANTIALIAS) {
+            /* Anti-aliased coverage levels '2' to '?' blended between background and foreground */
+            int level;
+            if (num_trans) {
+                trans_alpha[bg_idx] = bg_alpha;
+                trans_alpha[fg_idx] = fg_alpha;
+            }
+            for (level = 1; level < RASTER_AA_LEVELS; level++) {
+                map['1' + level] = num_palette;
+                palette[num_palette].red = RASTER_AA_BLEND(bg.red, fg.red, level);
+                palette[num_palette].green = RASTER_AA_BLEND(bg.green, fg.green, level);
+                palette[num_palette].blue = RASTER_AA_BLEND(bg.blue, fg.blue, level);
+                if (num_trans) {
+                    trans_alpha[num_palette] = RASTER_AA_BLEND(bg_alpha, fg_alpha, level);
+                }
+                num_palette++;
+            }
+            if (num_trans) {
+                num_trans = num_palette;
+            }
+        }
+    }
+    pal->num_colours = num_palette;
+    pal->num_trans = num_trans;
+
+    if (symbol->symbology == BARCODE_ULTRA || (symbol->output_options & BARCODE_ANTIALIAS)) {
+        /* Only include colours actually used, which usually allows a smaller bit depth */
+        compact_palette(symbol, rows, pal);
     }
 
-    if (num_palette <= 2) {
-        bit_depth = 1;
-    } else if (num_palette <= 16) {
-        bit_depth = 4;
+    if (pal->num_colours <= 2) {
+        pal->bit_depth = 1;
+    } else if (pal->num_colours <= 4) {
+        pal->bit_depth = 2;
+    } else if (pal->num_colours <= 16) {
+        pal->bit_depth = 4;
     } else {
-        bit_depth = 8;
+        pal->bit_depth = 8;
+    }
+    pal->row_bytes = (symbol->bitmap_width * pal->bit_depth + 7) / 8;
+}
+
+/* Pack a row of pixels `pb` into palette indexes at the bit depth */
+static void pack_row(const struct zint_symbol *symbol, const struct png_palette *pal,
+            const unsigned char *pb, unsigned char *outdata) {
+    const unsigned char *const map = pal->map;
+    unsigned char *image_data = outdata;
+    int i, column;
+
+    if (pal->bit_depth == 1) {
+        for (column = 0; column < symbol->bitmap_width; column += 8, image_data++) {
+            unsigned char byte = 0;
+            for (i = 0; i < 8 && column + i < symbol->bitmap_width; i++, pb++) {
+                byte |= map[*pb] << (7 - i);
+            }
+            *image_data = byte;
+        }
+    } else if (pal->bit_depth == 2) {
+        for (column = 0; column < symbol->bitmap_width; column += 4, image_data++) {
+            unsigned char byte = 0;
+            for (i = 0; i < 4 && column + i < symbol->bitmap_width; i++, pb++) {
+                byte |= map[*pb] << (6 - i * 2);
+            }
+            *image_data = byte;
+        }
+    } else if (pal->bit_depth == 4) {
+        for (column = 0; column < symbol->bitmap_width; column += 2, image_data++) {
+            unsigned char byte = map[*pb++] << 4;
+            if (column + 1 < symbol->bitmap_width) {
+                byte |= map[*pb++];
+            }
+            *image_data = byte;
+        }
+    } else { /* Bit depth 8 */
+        for (column = 0; column < symbol->bitmap_width; column++, pb++, image_data++) {
+            *image_data = map[*pb];
+        }
+    }
+}
+
+/* Update PNG chunk CRC (ISO 3309) using a nibble table */
+static unsigned int chunk_crc(unsigned int crc, const unsigned char *data, const size_t length) {
+    static const unsigned int crc_nibble[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0F];
+    }
+    return crc;
+}
+
+static void put_u32(unsigned char *buf, const unsigned int value) {
+    buf[0] = (unsigned char) (value >> 24);
+    buf[1] = (unsigned char) ((value >> 16) & 0xFF);
+    buf[2] = (unsigned char) ((value >> 8) & 0xFF);
+    buf[3] = (unsigned char) (value & 0xFF);
+}
+
+/* Write PNG chunk of `type` with `length` bytes of `data` */
+static void write_chunk(struct filemem *fmp, const char *type, const unsigned char *data,
+            const size_t length) {
+    unsigned char buf[4];
+    unsigned int crc;
+
+    put_u32(buf, (unsigned int) length);
+    (void) fm_write(buf, 1, 4, fmp);
+    (void) fm_write(type, 1, 4, fmp);
+    crc = chunk_crc(0xFFFFFFFF, (const unsigned char *) type, 4);
+    if (length) {
+        (void) fm_write(data, 1, length, fmp);
+        crc = chunk_crc(crc, data, length);
+    }
+    put_u32(buf, crc ^ 0xFFFFFFFF);
+    (void) fm_write(buf, 1, 4, fmp);
+}
+
+/* Write the PNG signature and the IHDR, PLTE and (if any transparency) tRNS chunks */
+static void write_header_chunks(const struct zint_symbol *symbol, const struct png_palette *pal,
+            struct filemem *fmp) {
+    static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    unsigned char ihdr[13];
+    unsigned char plte[32 * 3];
+    int i;
+
+    (void) fm_write(signature, 1, sizeof(signature), fmp);
+
+    put_u32(ihdr, symbol->bitmap_width);
+    put_u32(ihdr + 4, symbol->bitmap_height);
+    ihdr[8] = pal->bit_depth;
+    ihdr[9] = 3; /* Colour type palette */
+    ihdr[10] = 0; /* Compression method deflate */
+    ihdr[11] = 0; /* Filter method adaptive */
+    ihdr[12] = 0; /* No interlace */
+    write_chunk(fmp, "IHDR", ihdr, sizeof(ihdr));
+
+    for (i = 0; i < pal->num_colours; i++) {
+        plte[i * 3] = pal->colours[i].red;
+        plte[i * 3 + 1] = pal->colours[i].green;
+        plte[i * 3 + 2] = pal->colours[i].blue;
+    }
+    write_chunk(fmp, "PLTE", plte, pal->num_colours * 3);
+    if (pal->num_trans) {
+        write_chunk(fmp, "tRNS", pal->trans_alpha, pal->num_trans);
+    }
+}
+
+#ifndef NO_PNG
+#include <png.h>
+#include <zlib.h>
+#include <setjmp.h>
+
+struct mainprog_info_type {
+    long width;
+    long height;
+    struct filemem *fmp;
+    jmp_buf jmpbuf;
+};
+
+static void writepng_error_handler(png_structp png_ptr, png_const_charp msg) {
+    struct mainprog_info_type *graphic;
+
+    fprintf(stderr, "writepng libpng error: %s (F30)\n", msg);
+    fflush(stderr);
+
+    graphic = (struct mainprog_info_type*) png_get_error_ptr(png_ptr);
+    if (graphic == NULL) {
+        /* we are completely hosed now */
+        fprintf(stderr,
+                "writepng severe error:  jmpbuf not recoverable; terminating. (F31)\n");
+        fflush(stderr);
+        return;
+    }
+    longjmp(graphic->jmpbuf, 1);
+}
+
+/* libpng write callback, redirects output to file or memory */
+static void writepng_write(png_structp png_ptr, png_bytep data, png_size_t length) {
+    struct mainprog_info_type *graphic = (struct mainprog_info_type *) png_get_io_ptr(png_ptr);
+    (void) fm_write(data, 1, length, graphic->fmp);
+}
+
+/* libpng flush callback, no-op as `fm_close()` flushes */
+static void writepng_flush(png_structp png_ptr) {
+    (void) png_ptr;
+}
+
+/* Return number of rows identical to the previous row */
+static int repeated_rows(const struct zint_symbol *symbol, struct raster_rows *rows) {
+    const unsigned char *prev = raster_rows_get(rows, 0);
+    int row;
+    int count = 0;
+
+    for (row = 1; row < symbol->bitmap_height; row++) {
+        const unsigned char *const pb = raster_rows_get(rows, row);
+        if (pb == prev || memcmp(pb, prev, symbol->bitmap_width) == 0) {
+            count++;
+        }
+        prev = pb;
+    }
+    return count;
+}
+
+/* Select compression level, strategy and whether to filter repeated rows from the pixel rows. Repeated rows are
+   common (scaling, linear barcodes), and filtering them with the Up filter makes them all zero. This helps once a
+   row is too long for a single deflate match (258 bytes), or always at the fast level (where deflate seeks matches
+   less hard), where a mostly repeated image then favours run-length encoding. Otherwise it seems the best choice
+   for barcode PNGs is Z_DEFAULT_STRATEGY for largely unique rows (e.g. MaxiCode, dotty) and Z_FILTERED for the
+   rest */
+static void choose_compression(const struct zint_symbol *symbol, struct raster_rows *rows, const int row_bytes,
+            int *p_level, int *p_strategy, int *p_filter_repeats) {
+    const int row_cnt = symbol->bitmap_height > 1 ? symbol->bitmap_height - 1 : 1;
+    const int repeats = repeated_rows(symbol, rows);
+
+    if (symbol->output_options & BARCODE_FAST_COMPRESS) {
+        *p_level = 1;
+        *p_strategy = row_bytes > 128 && repeats >= row_cnt - row_cnt / 10 ? Z_RLE : Z_DEFAULT_STRATEGY;
+        *p_filter_repeats = 1;
+    } else {
+        *p_level = 9;
+        *p_strategy = repeats * 2 < row_cnt ? Z_DEFAULT_STRATEGY : Z_FILTERED; /* Less than half repeated */
+        *p_filter_repeats = row_bytes > 258;
+    }
+}
+
+/* Filter rows `start_row` up to `end_row` into `raw`, using Up for repeated rows (which makes them all zero) if
+   `filter_repeats`, otherwise None, as does the libpng path */
+static void filter_rows(const struct zint_symbol *symbol, struct raster_rows *rows, const struct png_palette *pal,
+            const int filter_repeats, const int start_row, const int end_row, unsigned char *raw) {
+    int row;
+
+    for (row = start_row; row < end_row; row++, raw += pal->row_bytes + 1) {
+        const unsigned char *const prev_pb = filter_repeats && row ? raster_rows_get(rows, row - 1) : NULL;
+        const unsigned char *const pb = raster_rows_get(rows, row);
+        if (prev_pb && (pb == prev_pb || memcmp(pb, prev_pb, symbol->bitmap_width) == 0)) {
+            raw[0] = 2; /* Filter type Up */
+            memset(raw + 1, 0, pal->row_bytes);
+        } else {
+            raw[0] = 0; /* Filter type None */
+            pack_row(symbol, pal, pb, raw + 1);
+        }
+    }
+}
+
+/* Put zlib (RFC 1950) header for raw deflate data of `window_bits` at `level` and `strategy` into `out`, as
+   zlib itself would */
+static void zlib_header(unsigned char *out, const int window_bits, const int level, const int strategy) {
+    const int flevel = strategy >= Z_HUFFMAN_ONLY || level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    const int cmf = ((window_bits - 8) << 4) | Z_DEFLATED;
+    const int flg = flevel << 6;
+
+    out[0] = (unsigned char) cmf;
+    out[1] = (unsigned char) (flg + 31 - ((cmf * 256 + flg) % 31));
+}
+
+#define PNG_BAND_BYTES  0x40000 /* Target size of the filtered rows of each parallel deflate band */
+#define PNG_THREADS     4       /* Maximum bands deflated at once */
+#define PNG_DICT_SIZE   32768   /* Deflate window, primed with the end of the preceding band */
+
+/* A band of rows deflated independently by `deflate_band()`, pigz-style */
+struct png_band {
+    unsigned char *raw; /* Filtered rows, preceded by up to PNG_DICT_SIZE bytes of dictionary */
+    size_t dict_len;
+    size_t raw_len;
+    unsigned char *out; /* 2 bytes room for zlib header, deflate data, 4 bytes room for Adler-32 */
+    size_t out_size;
+    size_t out_len;
+    unsigned long adler; /* Adler-32 of `raw` */
+    int level;
+    int strategy;
+    int last;
+    int error;
+    const struct zint_allocator *allocator; /* Of the symbol, for zlib */
+};
+
+/* zlib allocators, using the library's with the allocator `opaque` */
+static voidpf png_zalloc(voidpf opaque, uInt items, uInt size) {
+    return z_malloc((const struct zint_allocator *) opaque, (size_t) items * size);
+}
+
+static void png_zfree(voidpf opaque, voidpf ptr) {
+    z_free((const struct zint_allocator *) opaque, ptr);
+}
+
+/* Raw deflate `band`, ending with a sync flush (so that the bands simply concatenate) unless it's the last */
+static void deflate_band(struct png_band *band) {
+    z_stream strm;
+    int ret;
+
+    memset(&strm, 0, sizeof(strm));
+    strm.zalloc = png_zalloc;
+    strm.zfree = png_zfree;
+    strm.opaque = (voidpf) band->allocator;
+    if (deflateInit2(&strm, band->level, Z_DEFLATED, -15 /*raw*/, 8, band->strategy) != Z_OK) {
+        band->error = 1;
+        return;
+    }
+    if (band->dict_len) {
+        (void) deflateSetDictionary(&strm, band->raw - band->dict_len, (uInt) band->dict_len);
+    }
+    strm.next_in = band->raw;
+    strm.avail_in = (uInt) band->raw_len;
+    strm.next_out = band->out + 2;
+    strm.avail_out = (uInt) (band->out_size - 6);
+    ret = deflate(&strm, band->last ? Z_FINISH : Z_SYNC_FLUSH);
+    /* Full flush only guaranteed if output space left over */
+    band->error = band->last ? ret != Z_STREAM_END : ret != Z_OK || strm.avail_out == 0;
+    band->out_len = 2 + strm.total_out;
+    (void) deflateEnd(&strm);
+
+    band->adler = adler32(adler32(0L, Z_NULL, 0), band->raw, (uInt) band->raw_len);
+}
+
+/* Task of `z_parallel()`, deflating band `index` of `bands` */
+static void deflate_band_task(void *bands, int index) {
+    deflate_band((struct png_band *) bands + index);
+}
+
+/* Deflate the `count` bands, on up to `count` threads (including the calling one), see `z_parallel()` */
+static void deflate_bands(const struct zint_symbol *symbol, struct png_band bands[], const int count) {
+    z_parallel(symbol, deflate_band_task, bands, count, count);
+}
+
+/* Return number of rows in a parallel deflate band */
+static int band_rows(const struct png_palette *pal) {
+    const int rows = PNG_BAND_BYTES / (pal->row_bytes + 1);
+    return rows ? rows : 1;
+}
+
+/* Write PNG with the image data deflated in bands of rows, PNG_THREADS bands at a time, each band primed with the
+   last 32K of the data before it so that little compression is lost. The rows are got and filtered in order on the
+   calling thread, so only the bands in hand are held in memory */
+static int png_parallel_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows,
+            const struct png_palette *pal) {
+    struct png_band bands[PNG_THREADS];
+    struct filemem fm;
+    const size_t raw_row_len = pal->row_bytes + 1;
+    const int rows_per_band = band_rows(pal);
+    const size_t band_raw_size = raw_row_len * rows_per_band;
+    const size_t out_size = compressBound((uLong) band_raw_size) + 16 + 6; /* Slack for sync flush */
+    unsigned char *buf;
+    unsigned long adler = adler32(0L, Z_NULL, 0);
+    size_t total_len = 0;
+    int compression_level, compression_strategy, filter_repeats;
+    int row = 0;
+    int first = 1;
+    int error = 0;
+    int i;
+
+    buf = (unsigned char *) z_malloc(z_allocator(symbol), (PNG_DICT_SIZE + band_raw_size + out_size) * PNG_THREADS);
+    if (!buf) {
+        strcpy(symbol->errtxt, "623: Insufficient memory for PNG band buffers");
+        return ZINT_ERROR_MEMORY;
+    }
+    choose_compression(symbol, rows, pal->row_bytes, &compression_level, &compression_strategy,
+            &filter_repeats);
+    for (i = 0; i < PNG_THREADS; i++) {
+        bands[i].raw = buf + (PNG_DICT_SIZE + band_raw_size + out_size) * i + PNG_DICT_SIZE;
+        bands[i].out = bands[i].raw + band_raw_size;
+        bands[i].out_size = out_size;
+        bands[i].level = compression_level;
+        bands[i].strategy = compression_strategy;
+        bands[i].allocator = z_allocator(symbol);
     }
 
     /* Open output file in binary mode */
-    if (symbol->output_options & BARCODE_STDOUT) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "631: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
+    if (!fm_open(&fm, symbol, "wb")) {
+        z_free(z_allocator(symbol), buf);
+        strcpy(symbol->errtxt, "624: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+    write_header_chunks(symbol, pal, &fm);
+
+    while (row < symbol->bitmap_height && !error) {
+        int count;
+        for (count = 0; count < PNG_THREADS && row < symbol->bitmap_height; count++) {
+            struct png_band *const band = &bands[count];
+            const struct png_band *const prev = &bands[(count + PNG_THREADS - 1) % PNG_THREADS];
+            const int end_row = row + rows_per_band < symbol->bitmap_height ? row + rows_per_band
+                                : symbol->bitmap_height;
+
+            /* Dictionary is the end of the data so far, which the previous band holds (with its dictionary) */
+            band->dict_len = total_len < PNG_DICT_SIZE ? total_len : PNG_DICT_SIZE;
+            if (band->dict_len) {
+                memmove(band->raw - band->dict_len, prev->raw + prev->raw_len - band->dict_len, band->dict_len);
+            }
+            filter_rows(symbol, rows, pal, filter_repeats, row, end_row, band->raw);
+            band->raw_len = raw_row_len * (end_row - row);
+            row = end_row;
+            band->last = row == symbol->bitmap_height;
+            band->error = 0;
+            total_len += band->raw_len;
         }
-#endif
-        graphic->outfile = stdout;
+
+        deflate_bands(symbol, bands, count);
+
+        for (i = 0; i < count && !error; i++) {
+            struct png_band *const band = &bands[i];
+            const unsigned char *data = band->out + 2;
+            size_t len = band->out_len - 2;
+            if (band->error) {
+                error = 1;
+                break;
+            }
+            adler = adler32_combine(adler, band->adler, (z_off_t) band->raw_len);
+            if (first) {
+                zlib_header(band->out, 15, compression_level, compression_strategy);
+                data -= 2;
+                len += 2;
+                first = 0;
+            }
+            if (band->last) {
+                put_u32(band->out + band->out_len, (unsigned int) adler);
+                len += 4;
+            }
+            write_chunk(&fm, "IDAT", data, len);
+        }
+    }
+    z_free(z_allocator(symbol), buf);
+
+    if (error) {
+        (void) fm_close(&fm, symbol);
+        strcpy(symbol->errtxt, "625: zlib error occurred");
+        return ZINT_ERROR_MEMORY;
+    }
+    write_chunk(&fm, "IEND", NULL, 0);
+
+    if (!fm_close(&fm, symbol)) {
+        strcpy(symbol->errtxt, "626: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
+    }
+
+    return 0;
+}
+
+#define PNG_SMALL_BYTES 16384 /* Filtered image size up to which the per-symbol deflate context is used */
+
+/* Deflate context kept with the symbol (see `raster_output_context()`) for small images, so that encoding them
+   repeatedly doesn't set up libpng and zlib each time */
+struct png_deflate {
+    z_stream strm;
+    int window_bits; /* Of `strm`, 0 if not initialised */
+    int level;
+    int strategy;
+    unsigned char *buf; /* Filtered rows followed by the zlib data */
+    size_t buf_size;
+    const struct zint_allocator *allocator; /* Of the symbol, which the context lives with */
+};
+
+static void png_deflate_free(void *context) {
+    struct png_deflate *def = (struct png_deflate *) context;
+
+    if (def->window_bits) {
+        (void) deflateEnd(&def->strm);
+    }
+    z_free(def->allocator, def->buf);
+    z_free(def->allocator, def);
+}
+
+/* Write small PNG using the symbol's deflate context, initialising it if the window size differs from the last
+   time or resetting it otherwise. The window is the smallest that holds the image (as libpng chooses), and the
+   memory level (hash table and symbol buffer sizes) is matched to it, so that the context is typically 20 to
+   50K rather than the 256K of the defaults */
+static int png_small_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows,
+            const struct png_palette *pal) {
+    struct filemem fm;
+    const size_t raw_len = (size_t) (pal->row_bytes + 1) * symbol->bitmap_height;
+    void **p_context = raster_output_context(symbol, png_deflate_free);
+    struct png_deflate *def;
+    unsigned char *out;
+    size_t out_size, len;
+    int compression_level, compression_strategy, filter_repeats;
+    int window_bits = 15, header_bits = 15;
+
+    if (!p_context || (!*p_context && !(*p_context = z_calloc(z_allocator(symbol), 1, sizeof(struct png_deflate))))) {
+        strcpy(symbol->errtxt, "627: Insufficient memory for PNG deflate context");
+        return ZINT_ERROR_MEMORY;
+    }
+    def = (struct png_deflate *) *p_context;
+    def->allocator = z_allocator(symbol);
+
+    choose_compression(symbol, rows, pal->row_bytes, &compression_level, &compression_strategy,
+            &filter_repeats);
+    /* Allow for deflate's lookahead (MIN_LOOKAHEAD), windows below 512 not being supported */
+    while (window_bits > 9 && raw_len + 262 <= ((size_t) 1 << (window_bits - 1))) {
+        window_bits--;
+    }
+    if (def->window_bits != window_bits) {
+        const int mem_level = window_bits - 6 < 8 ? window_bits - 6 : 8;
+        if (def->window_bits) {
+            (void) deflateEnd(&def->strm);
+            def->window_bits = 0;
+        }
+        memset(&def->strm, 0, sizeof(def->strm));
+        def->strm.zalloc = png_zalloc;
+        def->strm.zfree = png_zfree;
+        def->strm.opaque = (voidpf) def->allocator;
+        if (deflateInit2(&def->strm, compression_level, Z_DEFLATED, -window_bits /*raw*/, mem_level,
+                compression_strategy) != Z_OK) {
+            strcpy(symbol->errtxt, "628: Insufficient memory for PNG deflate context");
+            return ZINT_ERROR_MEMORY;
+        }
+        def->window_bits = window_bits;
     } else {
-        if (!(graphic->outfile = fopen(symbol->outfile, "wb"))) {
-            strcpy(symbol->errtxt, "632: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
+        (void) deflateReset(&def->strm);
+        if (def->level != compression_level || def->strategy != compression_strategy) {
+            (void) deflateParams(&def->strm, compression_level, compression_strategy);
         }
     }
+    def->level = compression_level;
+    def->strategy = compression_strategy;
+
+    /* Room for zlib header and Adler-32 */
+    out_size = deflateBound(&def->strm, (uLong) raw_len) + 6;
+    if (def->buf_size < raw_len + out_size) {
+        z_free(def->allocator, def->buf);
+        if (!(def->buf = (unsigned char *) z_malloc(def->allocator, raw_len + out_size))) {
+            def->buf_size = 0;
+            strcpy(symbol->errtxt, "629: Insufficient memory for PNG image buffer");
+            return ZINT_ERROR_MEMORY;
+        }
+        def->buf_size = raw_len + out_size;
+    }
+    out = def->buf + raw_len;
+
+    filter_rows(symbol, rows, pal, filter_repeats, 0, symbol->bitmap_height, def->buf);
+    def->strm.next_in = def->buf;
+    def->strm.avail_in = (uInt) raw_len;
+    def->strm.next_out = out + 2;
+    def->strm.avail_out = (uInt) (out_size - 6);
+    if (deflate(&def->strm, Z_FINISH) != Z_STREAM_END) {
+        strcpy(symbol->errtxt, "631: zlib error occurred");
+        return ZINT_ERROR_MEMORY;
+    }
+    /* Header gives the smallest window that holds the image, which may be less than deflate needed */
+    while (header_bits > 8 && raw_len <= ((size_t) 1 << (header_bits - 1))) {
+        header_bits--;
+    }
+    zlib_header(out, header_bits, compression_level, compression_strategy);
+    len = 2 + def->strm.total_out;
+    put_u32(out + len, (unsigned int) adler32(adler32(0L, Z_NULL, 0), def->buf, (uInt) raw_len));
+    len += 4;
+
+    /* Open output file in binary mode */
+    if (!fm_open(&fm, symbol, "wb")) {
+        strcpy(symbol->errtxt, "644: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+    write_header_chunks(symbol, pal, &fm);
+    write_chunk(&fm, "IDAT", out, len);
+    write_chunk(&fm, "IEND", NULL, 0);
+
+    if (!fm_close(&fm, symbol)) {
+        strcpy(symbol->errtxt, "647: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
+    }
+
+    return 0;
+}
+
+INTERNAL int png_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows) {
+    struct mainprog_info_type wpng_info;
+    struct mainprog_info_type *graphic;
+    struct filemem fm;
+    png_structp png_ptr;
+    png_infop info_ptr;
+    int i;
+    int row;
+    struct png_palette pal;
+    png_color palette[32];
+    int compression_level, compression_strategy, filter_repeats;
+    const unsigned char *pb;
+
+#ifndef _MSC_VER
+    unsigned char outdata[symbol->bitmap_width];
+#else
+    unsigned char* outdata = (unsigned char*) _alloca(symbol->bitmap_width);
+#endif
+
+    graphic = &wpng_info;
+
+    graphic->width = symbol->bitmap_width;
+    graphic->height = symbol->bitmap_height;
+
+    setup_palette(symbol, rows, &pal);
+    if ((symbol->output_options & PNG_PARALLEL) && symbol->bitmap_height > band_rows(&pal)) {
+        return png_parallel_plot_rows(symbol, rows, &pal);
+    }
+    if ((size_t) (pal.row_bytes + 1) * symbol->bitmap_height <= PNG_SMALL_BYTES) {
+        return png_small_plot_rows(symbol, rows, &pal);
+    }
+    for (i = 0; i < pal.num_colours; i++) {
+        palette[i].red = pal.colours[i].red;
+        palette[i].green = pal.colours[i].green;
+        palette[i].blue = pal.colours[i].blue;
+    }
+
+    /* Open output file in binary mode */
+    if (!fm_open(&fm, symbol, "wb")) {
+        strcpy(symbol->errtxt, "632: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+    graphic->fmp = &fm;
 
     /* Set up error handling routine as proc() above */
     png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, graphic, writepng_error_handler, NULL);
     if (!png_ptr) {
+        (void) fm_close(&fm, symbol);
         strcpy(symbol->errtxt, "633: Out of memory");
         return ZINT_ERROR_MEMORY;
     }
@@ -255,6 +826,7 @@ INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     info_ptr = png_create_info_struct(png_ptr);
     if (!info_ptr) {
         png_destroy_write_struct(&png_ptr, NULL);
+        (void) fm_close(&fm, symbol);
         strcpy(symbol->errtxt, "634: Out of memory");
         return ZINT_ERROR_MEMORY;
     }
@@ -262,85 +834,399 @@ INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     /* catch jumping here */
     if (setjmp(graphic->jmpbuf)) {
         png_destroy_write_struct(&png_ptr, &info_ptr);
+        (void) fm_close(&fm, symbol);
         strcpy(symbol->errtxt, "635: libpng error occurred");
         return ZINT_ERROR_MEMORY;
     }
 
-    /* open output file with libpng */
-    png_init_io(png_ptr, graphic->outfile);
-
-    /* set compression */
-    png_set_compression_level(png_ptr, 9);
+    /* direct libpng output to file or memory */
+    png_set_write_fn(png_ptr, graphic, writepng_write, writepng_flush);
 
-    /* Compression strategy can make a difference */
-    compression_strategy = guess_compression_strategy(symbol, pixelbuf);
+    /* set compression - level and strategy can make a difference */
+    choose_compression(symbol, rows, pal.row_bytes, &compression_level, &compression_strategy,
+            &filter_repeats);
+    png_set_compression_level(png_ptr, compression_level);
     if (compression_strategy != Z_DEFAULT_STRATEGY) {
         png_set_compression_strategy(png_ptr, compression_strategy);
     }
+    if (filter_repeats) {
+        /* Set both so that libpng allocates the previous row buffer, then choose per row below */
+        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE | PNG_FILTER_UP);
+    }
 
     /* set Header block */
     png_set_IHDR(png_ptr, info_ptr, graphic->width, graphic->height,
-            bit_depth, PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE,
+            pal.bit_depth, PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE,
             PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
 
-    png_set_PLTE(png_ptr, info_ptr, palette, num_palette);
-    if (num_trans) {
-        png_set_tRNS(png_ptr, info_ptr, trans_alpha, num_trans, NULL);
+    png_set_PLTE(png_ptr, info_ptr, palette, pal.num_colours);
+    if (pal.num_trans) {
+        png_set_tRNS(png_ptr, info_ptr, pal.trans_alpha, pal.num_trans, NULL);
     }
 
     /* write all chunks up to (but not including) first IDAT */
     png_write_info(png_ptr, info_ptr);
 
     /* Pixel Plotting */
-    pb = pixelbuf;
-    if (bit_depth == 1) {
-        for (row = 0; row < symbol->bitmap_height; row++) {
-            unsigned char *image_data = outdata;
-            for (column = 0; column < symbol->bitmap_width; column += 8, image_data++) {
-                unsigned char byte = 0;
-                for (i = 0; i < 8 && column + i < symbol->bitmap_width; i++, pb++) {
-                    byte |= map[*pb] << (7 - i);
+    for (row = 0; row < symbol->bitmap_height; row++) {
+        if (filter_repeats && row) { /* Not first row, as libpng only allocates Up buffer when it starts */
+            /* Repeated row filters to zeroes with Up */
+            const unsigned char *const prev = raster_rows_get(rows, row - 1);
+            int repeat;
+            pb = raster_rows_get(rows, row);
+            repeat = pb == prev || memcmp(pb, prev, symbol->bitmap_width) == 0;
+            png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, repeat ? PNG_FILTER_UP : PNG_FILTER_NONE);
+        } else {
+            pb = raster_rows_get(rows, row);
+        }
+        pack_row(symbol, &pal, pb, outdata);
+        /* write row contents to file */
+        png_write_row(png_ptr, outdata);
+    }
+
+    /* End the file */
+    png_write_end(png_ptr, NULL);
+
+    /* make sure we have disengaged */
+    if (png_ptr && info_ptr) png_destroy_write_struct(&png_ptr, &info_ptr);
+    if (!fm_close(&fm, symbol)) {
+        strcpy(symbol->errtxt, "636: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
+    }
+
+    return 0;
+}
+
+INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    struct raster_rows rows;
+
+    raster_rows_image(&rows, symbol, pixelbuf);
+    return png_plot_rows(symbol, &rows);
+}
+#endif /* NO_PNG */
+
+#if defined(NO_PNG) || defined(ZINT_TEST)
+/* Built-in PNG encoder, used if libpng not available. Rows are filtered with None or Up (whichever gives more zero
+   bytes, so repeated rows become all zeroes), and deflated as a single fixed Huffman block, or as stored blocks if
+   that doesn't compress. The image and output are buffered in memory, IDAT being written as a single chunk */
+
+/* Deflate (RFC 1951) length code bases and extra bits for codes 257 to 285 */
+static const unsigned short deflate_len_base[29] = {
+      3,   4,   5,   6,   7,   8,   9,  10,  11,  13,  15,  17,  19,  23,  27,  31,
+     35,  43,  51,  59,  67,  83,  99, 115, 131, 163, 195, 227, 258,
+};
+static const unsigned char deflate_len_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+
+/* Distance code bases and extra bits for codes 0 to 29 */
+static const unsigned short deflate_dist_base[30] = {
+        1,     2,     3,     4,     5,     7,     9,    13,    17,    25,    33,    49,    65,    97,   129,
+      193,   257,   385,   513,   769,  1025,  1537,  2049,  3073,  4097,  6145,  8193, 12289, 16385, 24577,
+};
+static const unsigned char deflate_dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+/* Deflate output buffer */
+struct png_zstream {
+    const struct zint_allocator *allocator; /* Of the symbol, for `buf` */
+    unsigned char *buf;
+    size_t size;
+    size_t len;
+    unsigned int bits; /* Bits pending output, least significant first */
+    int bit_count;
+    int memory_error;
+};
+
+static void zs_byte(struct png_zstream *zs, const unsigned char byte) {
+    if (zs->len == zs->size) {
+        const size_t new_size = zs->size ? zs->size * 2 : 4096;
+        unsigned char *new_buf;
+        if (zs->memory_error || !(new_buf = (unsigned char *) z_realloc(zs->allocator, zs->buf, new_size))) {
+            zs->memory_error = 1;
+            return;
+        }
+        zs->buf = new_buf;
+        zs->size = new_size;
+    }
+    zs->buf[zs->len++] = byte;
+}
+
+/* Output `count` bits of `value`, least significant first */
+static void zs_bits(struct png_zstream *zs, const unsigned int value, const int count) {
+    zs->bits |= value << zs->bit_count;
+    zs->bit_count += count;
+    while (zs->bit_count >= 8) {
+        zs_byte(zs, (unsigned char) (zs->bits & 0xFF));
+        zs->bits >>= 8;
+        zs->bit_count -= 8;
+    }
+}
+
+/* Output Huffman code, which goes most significant bit first */
+static void zs_code(struct png_zstream *zs, const unsigned int code, const int length) {
+    unsigned int reversed = 0;
+    int i;
+    for (i = 0; i < length; i++) {
+        reversed |= ((code >> i) & 1) << (length - 1 - i);
+    }
+    zs_bits(zs, reversed, length);
+}
+
+/* Output fixed Huffman literal/length symbol */
+static void zs_symbol(struct png_zstream *zs, const int symbol) {
+    if (symbol < 144) {
+        zs_code(zs, 0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        zs_code(zs, 0x190 + symbol - 144, 9);
+    } else if (symbol < 280) {
+        zs_code(zs, symbol - 256, 7);
+    } else {
+        zs_code(zs, 0xC0 + symbol - 280, 8);
+    }
+}
+
+/* Output match of `length` (3 to 258) at `distance` (1 to 32768) */
+static void zs_match(struct png_zstream *zs, const int length, const int distance) {
+    int i = 28, d = 29;
+    while (deflate_len_base[i] > length) {
+        i--;
+    }
+    zs_symbol(zs, 257 + i);
+    zs_bits(zs, length - deflate_len_base[i], deflate_len_extra[i]);
+    while (deflate_dist_base[d] > distance) {
+        d--;
+    }
+    zs_code(zs, d, 5);
+    zs_bits(zs, distance - deflate_dist_base[d], deflate_dist_extra[d]);
+}
+
+#define PNG_HASH_SIZE   0x8000
+#define PNG_WINDOW      32768
+
+/* Return length (up to `max_len`) that data at `pos` matches data `distance` before */
+static int match_length(const unsigned char *raw, const size_t pos, const size_t distance, const int max_len) {
+    const unsigned char *p = raw + pos, *q = p - distance;
+    int len = 0;
+    while (len < max_len && p[len] == q[len]) {
+        len++;
+    }
+    return len;
+}
+
+/* Deflate `raw` as a single fixed Huffman block. Matches are found greedily from three candidates: the last
+   position with the same 3-byte hash, the previous byte (runs) and the same place in the previous row (repeated
+   rows), which between them catch most of the redundancy in barcode images */
+static void deflate_fixed(struct png_zstream *zs, const unsigned char *raw, const size_t raw_len,
+            const size_t row_len, size_t *head) {
+    size_t pos = 0;
+    int i;
+
+    for (i = 0; i < PNG_HASH_SIZE; i++) {
+        head[i] = (size_t) -1;
+    }
+
+    zs_bits(zs, 1 | (1 << 1), 3); /* BFINAL set, BTYPE 01 (fixed Huffman) */
+
+    while (pos < raw_len) {
+        const int max_len = raw_len - pos > 258 ? 258 : (int) (raw_len - pos);
+        int best_len = 0;
+        size_t best_dist = 0;
+
+        if (max_len >= 3) {
+            const unsigned int hash = ((raw[pos] << 10) ^ (raw[pos + 1] << 5) ^ raw[pos + 2]) & (PNG_HASH_SIZE - 1);
+            size_t candidates[3];
+            candidates[0] = 1;
+            candidates[1] = row_len;
+            candidates[2] = head[hash] != (size_t) -1 ? pos - head[hash] : 0;
+            for (i = 0; i < 3; i++) {
+                const size_t dist = candidates[i];
+                if (dist && dist <= pos && dist <= PNG_WINDOW) {
+                    const int len = match_length(raw, pos, dist, max_len);
+                    if (len > best_len) {
+                        best_len = len;
+                        best_dist = dist;
+                    }
                 }
-                *image_data = byte;
             }
-            /* write row contents to file */
-            png_write_row(png_ptr, outdata);
+            if (best_len < 3) {
+                best_len = 0;
+            }
         }
-    } else if (bit_depth == 4) {
-        for (row = 0; row < symbol->bitmap_height; row++) {
-            unsigned char *image_data = outdata;
-            for (column = 0; column < symbol->bitmap_width; column += 2, image_data++) {
-                unsigned char byte = map[*pb++] << 4;
-                if (column + 1 < symbol->bitmap_width) {
-                    byte |= map[*pb++];
+
+        if (best_len) {
+            const size_t end = pos + best_len;
+            zs_match(zs, best_len, (int) best_dist);
+            for (; pos < end; pos++) {
+                if (pos + 2 < raw_len) {
+                    head[((raw[pos] << 10) ^ (raw[pos + 1] << 5) ^ raw[pos + 2]) & (PNG_HASH_SIZE - 1)] = pos;
                 }
-                *image_data = byte;
             }
-            /* write row contents to file */
-            png_write_row(png_ptr, outdata);
+        } else {
+            zs_symbol(zs, raw[pos]);
+            if (max_len >= 3) {
+                head[((raw[pos] << 10) ^ (raw[pos + 1] << 5) ^ raw[pos + 2]) & (PNG_HASH_SIZE - 1)] = pos;
+            }
+            pos++;
         }
-    } else { /* Bit depth 8 */
-        for (row = 0; row < symbol->bitmap_height; row++) {
-            unsigned char *image_data = outdata;
-            for (column = 0; column < symbol->bitmap_width; column++, pb++, image_data++) {
-                *image_data = map[*pb];
+    }
+
+    zs_symbol(zs, 256); /* End of block */
+    if (zs->bit_count) {
+        zs_bits(zs, 0, 8 - zs->bit_count);
+    }
+}
+
+/* Output `raw` as stored blocks */
+static void deflate_stored(struct png_zstream *zs, const unsigned char *raw, const size_t raw_len) {
+    size_t pos = 0;
+
+    do {
+        const size_t block_len = raw_len - pos > 0xFFFF ? 0xFFFF : raw_len - pos;
+        size_t i;
+        zs_byte(zs, pos + block_len == raw_len); /* BFINAL, BTYPE 00 (stored), padding */
+        zs_byte(zs, (unsigned char) (block_len & 0xFF));
+        zs_byte(zs, (unsigned char) (block_len >> 8));
+        zs_byte(zs, (unsigned char) (~block_len & 0xFF));
+        zs_byte(zs, (unsigned char) ((~block_len >> 8) & 0xFF));
+        for (i = 0; i < block_len; i++) {
+            zs_byte(zs, raw[pos + i]);
+        }
+        pos += block_len;
+    } while (pos < raw_len);
+}
+
+/* Return Adler-32 checksum of `data` */
+static unsigned int adler32_sum(const unsigned char *data, const size_t length) {
+    unsigned int a = 1, b = 0;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        a += data[i];
+        b += a;
+        if ((i & 0xFFF) == 0xFFF) { /* Well before `b` can overflow (5552 bytes) */
+            a %= 65521;
+            b %= 65521;
+        }
+    }
+    return ((b % 65521) << 16) | (a % 65521);
+}
+
+/* Pack and filter the image rows into `raw`, using None or Up, whichever gives more zero bytes */
+static void filter_image(const struct zint_symbol *symbol, struct raster_rows *rows,
+            const struct png_palette *pal, unsigned char *rowbufs, unsigned char *raw) {
+    const int row_bytes = pal->row_bytes;
+    unsigned char *prev = rowbufs, *cur = rowbufs + row_bytes;
+    int row, i;
+
+    memset(prev, 0, row_bytes);
+    for (row = 0; row < symbol->bitmap_height; row++, raw += row_bytes + 1) {
+        unsigned char *const swap = prev;
+        int none_zeroes = 0, up_zeroes = 0;
+        pack_row(symbol, pal, raster_rows_get(rows, row), cur);
+        for (i = 0; i < row_bytes; i++) {
+            none_zeroes += cur[i] == 0;
+            up_zeroes += cur[i] == prev[i];
+        }
+        if (up_zeroes > none_zeroes) {
+            raw[0] = 2; /* Filter type Up */
+            for (i = 0; i < row_bytes; i++) {
+                raw[i + 1] = cur[i] - prev[i];
             }
-            /* write row contents to file */
-            png_write_row(png_ptr, outdata);
+        } else {
+            raw[0] = 0; /* Filter type None */
+            memcpy(raw + 1, cur, row_bytes);
         }
+        prev = cur;
+        cur = swap;
     }
+}
 
-    /* End the file */
-    png_write_end(png_ptr, NULL);
+static int png_builtin_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows) {
+    struct filemem fm;
+    struct png_palette pal;
+    struct png_zstream zs;
+    unsigned char adler[4];
+    unsigned char *rowbufs, *raw;
+    size_t *head;
+    size_t raw_len, stored_len;
+    int i;
 
-    /* make sure we have disengaged */
-    if (png_ptr && info_ptr) png_destroy_write_struct(&png_ptr, &info_ptr);
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(wpng_info.outfile);
-    } else {
-        fclose(wpng_info.outfile);
+    setup_palette(symbol, rows, &pal);
+
+    raw_len = (size_t) symbol->bitmap_height * (pal.row_bytes + 1);
+    rowbufs = (unsigned char *) z_malloc(z_allocator(symbol), (size_t) pal.row_bytes * 2);
+    raw = (unsigned char *) z_malloc(z_allocator(symbol), raw_len);
+    head = (size_t *) z_malloc(z_allocator(symbol), sizeof(size_t) * PNG_HASH_SIZE);
+    if (!rowbufs || !raw || !head) {
+        z_free(z_allocator(symbol), rowbufs);
+        z_free(z_allocator(symbol), raw);
+        z_free(z_allocator(symbol), head);
+        strcpy(symbol->errtxt, "637: Insufficient memory for PNG image buffer");
+        return ZINT_ERROR_MEMORY;
+    }
+    filter_image(symbol, rows, &pal, rowbufs, raw);
+    z_free(z_allocator(symbol), rowbufs);
+
+    /* Zlib stream (RFC 1950), compressed or, if that's bigger, stored */
+    memset(&zs, 0, sizeof(zs));
+    zs.allocator = z_allocator(symbol);
+    zs_byte(&zs, 0x78); /* CMF: deflate, 32K window */
+    zs_byte(&zs, 0x01); /* FLG: no dictionary, fastest, check bits */
+    deflate_fixed(&zs, raw, raw_len, pal.row_bytes + 1, head);
+    z_free(z_allocator(symbol), head);
+    stored_len = 2 + raw_len + 5 * ((raw_len + 0xFFFE) / 0xFFFF);
+    if (zs.len > stored_len) {
+        zs.len = 2;
+        deflate_stored(&zs, raw, raw_len);
+    }
+    put_u32(adler, adler32_sum(raw, raw_len));
+    for (i = 0; i < 4; i++) {
+        zs_byte(&zs, adler[i]);
+    }
+    z_free(z_allocator(symbol), raw);
+    if (zs.memory_error) {
+        z_free(z_allocator(symbol), zs.buf);
+        strcpy(symbol->errtxt, "638: Insufficient memory for PNG data buffer");
+        return ZINT_ERROR_MEMORY;
+    }
+
+    /* Open output file in binary mode */
+    if (!fm_open(&fm, symbol, "wb")) {
+        z_free(z_allocator(symbol), zs.buf);
+        strcpy(symbol->errtxt, "639: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+
+    write_header_chunks(symbol, &pal, &fm);
+    write_chunk(&fm, "IDAT", zs.buf, zs.len);
+    write_chunk(&fm, "IEND", NULL, 0);
+
+    z_free(z_allocator(symbol), zs.buf);
+
+    if (!fm_close(&fm, symbol)) {
+        strcpy(symbol->errtxt, "630: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
     }
 
     return 0;
 }
+
+INTERNAL int png_builtin_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    struct raster_rows rows;
+
+    raster_rows_image(&rows, symbol, pixelbuf);
+    return png_builtin_plot_rows(symbol, &rows);
+}
+#endif /* NO_PNG || ZINT_TEST */
+
+#ifdef NO_PNG
+INTERNAL int png_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows) {
+    return png_builtin_plot_rows(symbol, rows);
+}
+
+INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    return png_builtin_pixel_plot(symbol, pixelbuf);
+}
 #endif /* NO_PNG */
@@ -0,0 +1,149 @@
+/* pnm.c - Handles output to Netpbm PBM (bilevel) and PGM (greyscale) files */
+/* Netpbm formats http://netpbm.sourceforge.net/doc/pbm.html and http://netpbm.sourceforge.net/doc/pgm.html */
+
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <stdio.h>
+#include "common.h"
+#include "filemem.h"
+#include "output.h"
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+/* Luma (ITU-R BT.601) of RGB, 0 to 255 */
+static unsigned char pnm_grey(const int red, const int green, const int blue) {
+    return (unsigned char) ((299 * red + 587 * green + 114 * blue + 500) / 1000);
+}
+
+/* Set `grey_map` to the grey level of each pixel value (background '0', foreground '1' and Ultracode colours) */
+static void pnm_grey_map(const struct zint_symbol *symbol, unsigned char grey_map[128]) {
+    static const char ultra_colour[] = "0CBMRYGKW";
+    int i;
+
+    for (i = 1; i < 9; i++) {
+        grey_map[(unsigned char) ultra_colour[i]] = pnm_grey(colour_to_red(i), colour_to_green(i),
+                                                                colour_to_blue(i));
+    }
+    grey_map['0'] = pnm_grey(OUT_RED(symbol->bgcolour_rgba), OUT_GREEN(symbol->bgcolour_rgba),
+                            OUT_BLUE(symbol->bgcolour_rgba));
+    grey_map['1'] = pnm_grey(OUT_RED(symbol->fgcolour_rgba), OUT_GREEN(symbol->fgcolour_rgba),
+                            OUT_BLUE(symbol->fgcolour_rgba));
+}
+
+/* Output raw PBM (P4) if `pgm` zero, where background and Ultracode white pixels are white and all others black
+   (reversed if the foreground is lighter than the background), else raw PGM (P5) of the grey levels of the colours.
+   Any alpha is ignored */
+static int pnm_pixel_plot(struct zint_symbol *symbol, const unsigned char *pixelbuf, const int pgm) {
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
+    unsigned char map[128];
+    const int row_size = pgm ? symbol->bitmap_width : (symbol->bitmap_width + 7) / 8;
+    const unsigned char *pb = pixelbuf;
+    char header[40];
+    int header_len;
+    unsigned char *out_map;
+    int row, column;
+#ifdef _MSC_VER
+    unsigned char *row_buf;
+#endif
+
+#ifndef _MSC_VER
+    unsigned char row_buf[row_size];
+#else
+    row_buf = (unsigned char *) _alloca(row_size);
+#endif
+
+    pnm_grey_map(symbol, map);
+    if (!pgm) {
+        const unsigned char ink = map['1'] > map['0'] ? 0 : 1; /* Black (1) unless foreground lighter */
+        const unsigned char paper = !ink;
+        memset(map, ink, sizeof(map));
+        map['0'] = map['W'] = paper;
+    }
+
+    if (!fm_open(fmp, symbol, "wb")) {
+        strcpy(symbol->errtxt, "606: Could not open output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+
+    header_len = sprintf(header, "%s\n%d %d\n%s", pgm ? "P5" : "P4", symbol->bitmap_width, symbol->bitmap_height,
+                        pgm ? "255\n" : "");
+
+    /* Plot the rows straight into the output if possible (OUT_FILE_MMAP or memory file) */
+    if ((out_map = fm_map(fmp, header_len + (size_t) row_size * symbol->bitmap_height))) {
+        memcpy(out_map, header, header_len);
+    } else {
+        fm_write(header, 1, header_len, fmp);
+    }
+
+    for (row = 0; row < symbol->bitmap_height; row++) {
+        unsigned char *const out = out_map ? out_map + header_len + (size_t) row_size * row : row_buf;
+        if (pgm) {
+            for (column = 0; column < symbol->bitmap_width; column++) {
+                out[column] = map[*pb++];
+            }
+        } else {
+            /* Packed MSB first, rows padded to a byte */
+            unsigned char *rb = out;
+            unsigned char byte = 0;
+            for (column = 0; column < symbol->bitmap_width; column++) {
+                byte = (unsigned char) ((byte << 1) | map[*pb++]);
+                if ((column & 7) == 7) {
+                    *rb++ = byte;
+                    byte = 0;
+                }
+            }
+            if (symbol->bitmap_width & 7) {
+                *rb = (unsigned char) (byte << (8 - (symbol->bitmap_width & 7)));
+            }
+        }
+        if (!out_map) {
+            fm_write(row_buf, 1, row_size, fmp);
+        }
+    }
+
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "607: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
+    }
+
+    return 0;
+}
+
+INTERNAL int pbm_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    return pnm_pixel_plot(symbol, pixelbuf, 0 /*pgm*/);
+}
+
+INTERNAL int pgm_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    return pnm_pixel_plot(symbol, pixelbuf, 1 /*pgm*/);
+}
@@ -45,40 +45,40 @@
 #define SHKASUTSET "1234567890-ABCDEFGHIJKLMNOPQRSTUVWXYZ"
 
 /* PostNet number encoding table - In this table L is long as S is short */
-static const char *PNTable[10] = {
+static const char *const PNTable[10] = {
     "LLSSS", "SSSLL", "SSLSL", "SSLLS", "SLSSL", "SLSLS", "SLLSS", "LSSSL",
     "LSSLS", "LSLSS"
 };
 
-static const char *PLTable[10] = {
+static const char *const PLTable[10] = {
     "SSLLL", "LLLSS", "LLSLS", "LLSSL", "LSLLS", "LSLSL", "LSSLL", "SLLLS",
     "SLLSL", "SLSLL"
 };
 
-static const char *RoyalValues[36] = {
+static const char *const RoyalValues[36] = {
     "11", "12", "13", "14", "15", "10", "21", "22", "23", "24", "25",
     "20", "31", "32", "33", "34", "35", "30", "41", "42", "43", "44", "45", "40", "51", "52",
     "53", "54", "55", "50", "01", "02", "03", "04", "05", "00"
 };
 
 /* 0 = Full, 1 = Ascender, 2 = Descender, 3 = Tracker */
-static const char *RoyalTable[36] = {
+static const char *const RoyalTable[36] = {
     "3300", "3210", "3201", "2310", "2301", "2211", "3120", "3030", "3021",
     "2130", "2121", "2031", "3102", "3012", "3003", "2112", "2103", "2013", "1320", "1230",
     "1221", "0330", "0321", "0231", "1302", "1212", "1203", "0312", "0303", "0213", "1122",
     "1032", "1023", "0132", "0123", "0033"
 };
 
-static const char *FlatTable[10] = {
+static const char *const FlatTable[10] = {
     "0504", "18", "0117", "0216", "0315", "0414", "0513", "0612", "0711", "0810"
 };
 
-static const char *KoreaTable[10] = {
+static const char *const KoreaTable[10] = {
     "1313150613", "0713131313", "0417131313", "1506131313",
     "0413171313", "17171313", "1315061313", "0413131713", "17131713", "13171713"
 };
 
-static const char *JapanTable[19] = {
+static const char *const JapanTable[19] = {
     "114", "132", "312", "123", "141", "321", "213", "231", "411", "144",
     "414", "324", "342", "234", "432", "243", "423", "441", "111"
 };
@@ -87,12 +87,13 @@ static const char *JapanTable[19] = {
 static int postnet(struct zint_symbol *symbol, unsigned char source[], char dest[], int length) {
     int i, sum, check_digit;
     int error_number;
+    char *d = dest;
 
     if (length != 5 && length != 9 && length != 11) {
         strcpy(symbol->errtxt, "480: Input wrong length");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "481: Invalid characters in data");
         return error_number;
@@ -100,18 +101,20 @@ static int postnet(struct zint_symbol *symbol, unsigned char source[], char dest
     sum = 0;
 
     /* start character */
-    strcpy(dest, "L");
+    *d++ = 'L';
 
     for (i = 0; i < length; i++) {
-        lookup(NEON, PNTable, source[i], dest);
+        memcpy(d, PNTable[source[i] - '0'], 5);
+        d += 5;
         sum += ctoi(source[i]);
     }
 
     check_digit = (10 - (sum % 10)) % 10;
-    strcat(dest, PNTable[check_digit]);
+    memcpy(d, PNTable[check_digit], 5);
+    d += 5;
 
     /* stop character */
-    strcat(dest, "L");
+    strcpy(d, "L");
 
     return error_number;
 }
@@ -149,12 +152,13 @@ INTERNAL int post_plot(struct zint_symbol *symbol, unsigned char source[], int l
 static int planet(struct zint_symbol *symbol, unsigned char source[], char dest[], int length) {
     int i, sum, check_digit;
     int error_number;
+    char *d = dest;
 
     if (length != 11 && length != 13) {
         strcpy(symbol->errtxt, "482: Input wrong length");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "483: Invalid characters in data");
         return error_number;
@@ -162,18 +166,20 @@ static int planet(struct zint_symbol *symbol, unsigned char source[], char dest[
     sum = 0;
 
     /* start character */
-    strcpy(dest, "L");
+    *d++ = 'L';
 
     for (i = 0; i < length; i++) {
-        lookup(NEON, PLTable, source[i], dest);
+        memcpy(d, PLTable[source[i] - '0'], 5);
+        d += 5;
         sum += ctoi(source[i]);
     }
 
     check_digit = (10 - (sum % 10)) % 10;
-    strcat(dest, PLTable[check_digit]);
+    memcpy(d, PLTable[check_digit], 5);
+    d += 5;
 
     /* stop character */
-    strcat(dest, "L");
+    strcpy(d, "L");
 
     return error_number;
 }
@@ -211,12 +217,13 @@ INTERNAL int planet_plot(struct zint_symbol *symbol, unsigned char source[], int
 INTERNAL int korea_post(struct zint_symbol *symbol, unsigned char source[], int length) {
     int total, loop, check, zeroes, error_number;
     char localstr[8], dest[80];
+    char *d = dest;
 
     if (length > 6) {
         strcpy(symbol->errtxt, "484: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "485: Invalid characters in data");
         return error_number;
@@ -235,13 +242,16 @@ INTERNAL int korea_post(struct zint_symbol *symbol, unsigned char source[], int
     }
     localstr[6] = itoc(check);
     localstr[7] = '\0';
-    *dest = '\0';
     for (loop = 5; loop >= 0; loop--) {
-        lookup(NEON, KoreaTable, localstr[loop], dest);
+        strcpy(d, KoreaTable[localstr[loop] - '0']);
+        d += strlen(d);
+    }
+    strcpy(d, KoreaTable[check]);
+    d += strlen(d);
+    expand(symbol, dest, d - dest);
+    if (z_hrt(symbol)) {
+        ustrcpy(symbol->text, (unsigned char*) localstr);
     }
-    lookup(NEON, KoreaTable, localstr[6], dest);
-    expand(symbol, dest);
-    ustrcpy(symbol->text, (unsigned char*) localstr);
 
     return error_number;
 }
@@ -279,28 +289,29 @@ INTERNAL int fim(struct zint_symbol *symbol, unsigned char source[], int length)
             break;
     }
 
-    expand(symbol, dest);
+    expand(symbol, dest, (int) strlen(dest));
 
     return 0;
 }
 
 /* Handles the 4 State barcodes used in the UK by Royal Mail */
-static char rm4scc(unsigned char source[], char dest[], int length) {
+static char rm4scc(const int posns[], char dest[], int length) {
     int i;
     int top, bottom, row, column, check_digit;
-    char values[3], set_copy[] = KRSET;
+    char set_copy[] = KRSET;
+    char *d = dest;
 
     top = 0;
     bottom = 0;
 
     /* start character */
-    strcpy(dest, "1");
+    *d++ = '1';
 
     for (i = 0; i < length; i++) {
-        lookup(KRSET, RoyalTable, source[i], dest);
-        strcpy(values, RoyalValues[posn(KRSET, source[i])]);
-        top += ctoi(values[0]);
-        bottom += ctoi(values[1]);
+        memcpy(d, RoyalTable[posns[i]], 4);
+        d += 4;
+        top += RoyalValues[posns[i]][0] - '0';
+        bottom += RoyalValues[posns[i]][1] - '0';
     }
 
     /* Calculate the check digit */
@@ -313,10 +324,11 @@ static char rm4scc(unsigned char source[], char dest[], int length) {
         column = 5;
     }
     check_digit = (6 * row) + column;
-    strcat(dest, RoyalTable[check_digit]);
+    memcpy(d, RoyalTable[check_digit], 4);
+    d += 4;
 
     /* stop character */
-    strcat(dest, "0");
+    strcpy(d, "0");
 
     return set_copy[check_digit];
 }
@@ -324,22 +336,22 @@ static char rm4scc(unsigned char source[], char dest[], int length) {
 /* Puts RM4SCC into the data matrix */
 INTERNAL int royal_plot(struct zint_symbol *symbol, unsigned char source[], int length) {
     char height_pattern[210];
+    int posns[50];
     int loopey, h;
     int writer;
     int error_number;
-    strcpy(height_pattern, "");
 
     if (length > 50) {
         strcpy(symbol->errtxt, "488: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
     to_upper(source);
-    error_number = is_sane(KRSET, source, length);
+    error_number = is_sane_lookup(KRSET, 36, source, length, posns);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "489: Invalid characters in data");
         return error_number;
     }
-    /*check = */rm4scc(source, height_pattern, length);
+    /*check = */rm4scc(posns, height_pattern, length);
 
     writer = 0;
     h = strlen(height_pattern);
@@ -367,32 +379,32 @@ INTERNAL int royal_plot(struct zint_symbol *symbol, unsigned char source[], int
    The same as RM4SCC but without check digit
    Specification at http://www.tntpost.nl/zakelijk/klantenservice/downloads/kIX_code/download.aspx */
 INTERNAL int kix_code(struct zint_symbol *symbol, unsigned char source[], int length) {
-    char height_pattern[75], localstr[20];
+    char height_pattern[75];
+    char *d = height_pattern;
+    int posns[18];
     int loopey;
     int writer, i, h;
     int error_number;
-    strcpy(height_pattern, "");
 
     if (length > 18) {
         strcpy(symbol->errtxt, "490: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
     to_upper(source);
-    error_number = is_sane(KRSET, source, length);
+    error_number = is_sane_lookup(KRSET, 36, source, length, posns);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "491: Invalid characters in data");
         return error_number;
     }
 
-    strcpy(localstr, (char *) source);
-
     /* Encode data */
     for (i = 0; i < length; i++) {
-        lookup(KRSET, RoyalTable, localstr[i], height_pattern);
+        memcpy(d, RoyalTable[posns[i]], 4);
+        d += 4;
     }
 
     writer = 0;
-    h = strlen(height_pattern);
+    h = (int) (d - height_pattern);
     for (loopey = 0; loopey < h; loopey++) {
         if ((height_pattern[loopey] == '1') || (height_pattern[loopey] == '0')) {
             set_module(symbol, 0, writer);
@@ -418,7 +430,6 @@ INTERNAL int daft_code(struct zint_symbol *symbol, unsigned char source[], int l
     char height_pattern[100];
     unsigned int loopey, h;
     int writer, i, error_number;
-    strcpy(height_pattern, "");
 
     if (length > 50) {
         strcpy(symbol->errtxt, "492: Input too long");
@@ -434,21 +445,18 @@ INTERNAL int daft_code(struct zint_symbol *symbol, unsigned char source[], int l
 
     for (i = 0; i < length; i++) {
         if (source[i] == 'D') {
-            strcat(height_pattern, "2");
-        }
-        if (source[i] == 'A') {
-            strcat(height_pattern, "1");
-        }
-        if (source[i] == 'F') {
-            strcat(height_pattern, "0");
-        }
-        if (source[i] == 'T') {
-            strcat(height_pattern, "3");
+            height_pattern[i] = '2';
+        } else if (source[i] == 'A') {
+            height_pattern[i] = '1';
+        } else if (source[i] == 'F') {
+            height_pattern[i] = '0';
+        } else { /* 'T' */
+            height_pattern[i] = '3';
         }
     }
 
     writer = 0;
-    h = strlen(height_pattern);
+    h = length;
     for (loopey = 0; loopey < h; loopey++) {
         if ((height_pattern[loopey] == '1') || (height_pattern[loopey] == '0')) {
             set_module(symbol, 0, writer);
@@ -473,22 +481,23 @@ INTERNAL int daft_code(struct zint_symbol *symbol, unsigned char source[], int l
 INTERNAL int flattermarken(struct zint_symbol *symbol, unsigned char source[], int length) {
     int loop, error_number;
     char dest[512]; /* 90 * 4 + 1 ~ */
+    char *d = dest;
 
     if (length > 90) {
         strcpy(symbol->errtxt, "494: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, length);
+    error_number = is_sane_chr(CHR_DIGIT, source, length);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "495: Invalid characters in data");
         return error_number;
     }
-    *dest = '\0';
     for (loop = 0; loop < length; loop++) {
-        lookup(NEON, FlatTable, source[loop], dest);
+        strcpy(d, FlatTable[source[loop] - '0']);
+        d += strlen(d);
     }
 
-    expand(symbol, dest);
+    expand(symbol, dest, d - dest);
 
     return error_number;
 }
@@ -497,15 +506,16 @@ INTERNAL int flattermarken(struct zint_symbol *symbol, unsigned char source[], i
 INTERNAL int japan_post(struct zint_symbol *symbol, unsigned char source[], int length) {
     int error_number, h;
     char pattern[69];
+    char *d = pattern;
     int writer, loopey, inter_posn, i, sum, check;
     char check_char;
     char inter[23];
 
-#ifndef _MSC_VER
-    char local_source[length + 1];
-#else
-    char* local_source = (char*) _alloca(length + 1);
-#endif
+    z_work_array(symbol, char, local_source, length + 1);
+
+    if (z_work_failed(local_source)) {
+        return z_work_error(symbol);
+    }
 
     if (length > 20) {
         strcpy(symbol->errtxt, "496: Input too long");
@@ -551,11 +561,13 @@ INTERNAL int japan_post(struct zint_symbol *symbol, unsigned char source[], int
     } while ((i < length) && (inter_posn < 20));
     inter[20] = '\0';
 
-    strcpy(pattern, "13"); /* Start */
+    memcpy(d, "13", 2); /* Start */
+    d += 2;
 
     sum = 0;
     for (i = 0; i < 20; i++) {
-        strcat(pattern, JapanTable[posn(KASUTSET, inter[i])]);
+        memcpy(d, JapanTable[posn(KASUTSET, inter[i])], 3);
+        d += 3;
         sum += posn(CHKASUTSET, inter[i]);
     }
 
@@ -571,13 +583,15 @@ INTERNAL int japan_post(struct zint_symbol *symbol, unsigned char source[], int
     } else {
         check_char = (check - 11) + 'a';
     }
-    strcat(pattern, JapanTable[posn(KASUTSET, check_char)]);
+    memcpy(d, JapanTable[posn(KASUTSET, check_char)], 3);
+    d += 3;
 
-    strcat(pattern, "31"); /* Stop */
+    memcpy(d, "31", 2); /* Stop */
+    d += 2;
 
     /* Resolve pattern to 4-state symbols */
     writer = 0;
-    h = strlen(pattern);
+    h = (int) (d - pattern);
     for (loopey = 0; loopey < h; loopey++) {
         if ((pattern[loopey] == '2') || (pattern[loopey] == '1')) {
             set_module(symbol, 0, writer);
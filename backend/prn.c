@@ -0,0 +1,296 @@
+/* prn.c - Handles output to label printer languages ZPL II, EPL2 and PCL 5 */
+/* Zebra ZPL II Programming Guide (^GF), Zebra EPL2 Programming Manual (GW) and
+   HP PCL 5 Printer Language Technical Reference Manual (Raster Graphics) */
+
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "common.h"
+#include "filemem.h"
+#include "zfiletypes.h"
+
+/* Luma (ITU-R BT.601, times 1000) of hex RGB `colour` */
+static int prn_luma(const char *colour) {
+    return 299 * (16 * ctoi(colour[0]) + ctoi(colour[1])) + 587 * (16 * ctoi(colour[2]) + ctoi(colour[3]))
+            + 114 * (16 * ctoi(colour[4]) + ctoi(colour[5]));
+}
+
+/* Pack row `row` of `pixelbuf` into `out`, MSB first, padded to a byte, 1 meaning a printed dot (or if `white`,
+   1 meaning no dot). Background and Ultracode white pixels are not printed and all others are, reversed if the
+   foreground is lighter than the background, as for PBM */
+static void prn_pack_row(const struct zint_symbol *symbol, const unsigned char *pixelbuf, const int row,
+            const int reverse, const int white, unsigned char *out) {
+    const unsigned char *pb = pixelbuf + (size_t) row * symbol->bitmap_width;
+    const unsigned char flip = (unsigned char) (reverse != white);
+    unsigned char byte = 0;
+    int column;
+
+    for (column = 0; column < symbol->bitmap_width; column++, pb++) {
+        byte = (unsigned char) ((byte << 1) | ((*pb != '0' && *pb != 'W') ^ flip));
+        if ((column & 7) == 7) {
+            *out++ = byte;
+            byte = 0;
+        }
+    }
+    if (symbol->bitmap_width & 7) {
+        /* Padding not printed */
+        const int shift = 8 - (symbol->bitmap_width & 7);
+        *out = (unsigned char) ((byte << shift) | (white ? (1 << shift) - 1 : 0));
+    }
+}
+
+/* Put ZPL repeat count `count` (1 or more) for the hex digit following - "G" to "Y" are 1 to 19 and "g" to "z" are
+   20 to 400 in steps of 20, summed */
+static char *zpl_put_count(char *out, int count) {
+    while (count >= 400) {
+        *out++ = 'z';
+        count -= 400;
+    }
+    if (count >= 20) {
+        *out++ = (char) ('g' + count / 20 - 1);
+        count %= 20;
+    }
+    if (count) {
+        *out++ = (char) ('G' + count - 1);
+    }
+    return out;
+}
+
+/* Compress a row of `hex` digits using ZPL ASCII hex compression into `out`, returning end of output. Runs of 3 or
+   more digits are prefixed by their count, and the rest of the row is given by "," if all zeroes or "!" if all
+   "F"s */
+static char *zpl_compress_row(const char *hex, const int hex_len, char *out) {
+    int end = hex_len;
+    char fill = '\0';
+    int i, j;
+
+    if (hex[end - 1] == '0' || hex[end - 1] == 'F') {
+        for (j = end - 1; j > 0 && hex[j - 1] == hex[end - 1]; j--);
+        if (end - j > 1) {
+            fill = hex[end - 1] == '0' ? ',' : '!';
+            end = j;
+        }
+    }
+    for (i = 0; i < end; i = j) {
+        for (j = i + 1; j < end && hex[j] == hex[i]; j++);
+        if (j - i >= 3) {
+            out = zpl_put_count(out, j - i);
+            *out++ = hex[i];
+        } else {
+            memcpy(out, hex + i, j - i);
+            out += j - i;
+        }
+    }
+    if (fill) {
+        *out++ = fill;
+    }
+    return out;
+}
+
+/* Compress `row` using PCL mode 2 (TIFF PackBits) into `out`, returning length. Trailing zero bytes are dropped
+   as the printer zero-fills short rows */
+static int pcl_mode2(const unsigned char *row, int length, unsigned char *out) {
+    unsigned char *o = out;
+    int i, j;
+
+    while (length && row[length - 1] == 0) {
+        length--;
+    }
+    for (i = 0; i < length; ) {
+        for (j = i + 1; j < length && j - i < 128 && row[j] == row[i]; j++);
+        if (j - i >= 2) {
+            *o++ = (unsigned char) (257 - (j - i)); /* -(count - 1) */
+            *o++ = row[i];
+            i = j;
+        } else {
+            const int start = i;
+            while (i < length && i - start < 128
+                    && !(i + 2 < length && row[i] == row[i + 1] && row[i] == row[i + 2])) {
+                i++;
+            }
+            *o++ = (unsigned char) (i - start - 1);
+            memcpy(o, row + start, i - start);
+            o += i - start;
+        }
+    }
+    return (int) (o - out);
+}
+
+/* Compress `row` using PCL mode 3 (delta row) against `seed`, the previous row, into `out`, returning length.
+   Each command replaces up to 8 changed bytes, its low 5 bits giving the offset from the end of the last
+   replacement, with extension bytes if offset 31 or more */
+static int pcl_mode3(const unsigned char *row, const unsigned char *seed, const int length, unsigned char *out) {
+    unsigned char *o = out;
+    int posn = 0;
+    int i = 0;
+
+    while (i < length) {
+        int start, offset;
+        if (row[i] == seed[i]) {
+            i++;
+            continue;
+        }
+        for (start = i; i < length && i - start < 8 && row[i] != seed[i]; i++);
+        offset = start - posn;
+        if (offset < 31) {
+            *o++ = (unsigned char) (((i - start - 1) << 5) | offset);
+        } else {
+            *o++ = (unsigned char) (((i - start - 1) << 5) | 31);
+            for (offset -= 31; offset >= 255; offset -= 255) {
+                *o++ = 255;
+            }
+            *o++ = (unsigned char) offset;
+        }
+        memcpy(o, row + start, i - start);
+        o += i - start;
+        posn = i;
+    }
+    return (int) (o - out);
+}
+
+/* Output the raster as a ZPL II ^GF graphic field (compressed ASCII hex), an EPL2 GW graphic (uncompressed
+   binary), or PCL 5 raster graphics at 300 dpi (per row the smaller of modes 2 and 3), one dot per pixel */
+static int prn_pixel_plot(struct zint_symbol *symbol, const unsigned char *pixelbuf, const int file_type) {
+    static const char hex_digits[] = "0123456789ABCDEF";
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
+    const int row_bytes = (symbol->bitmap_width + 7) / 8;
+    const int total = row_bytes * symbol->bitmap_height;
+    const int reverse = prn_luma(symbol->fgcolour) > prn_luma(symbol->bgcolour);
+    unsigned char *rows, *row, *prev;
+    unsigned char *out;
+    int mode = 0;
+    int r, i;
+
+    /* Current and previous rows, and output (ZPL hex twice row, PCL mode 3 worst case under 2 times too) */
+    if (!(rows = (unsigned char *) z_malloc(z_allocator(symbol),
+                                            (size_t) row_bytes * 2 + (size_t) row_bytes * 4 + 8))) {
+        strcpy(symbol->errtxt, "616: Insufficient memory for printer raster buffer");
+        return ZINT_ERROR_MEMORY;
+    }
+    row = rows;
+    prev = rows + row_bytes;
+    out = rows + row_bytes * 2;
+    memset(prev, 0, row_bytes); /* PCL seed row starts zeroed */
+
+    if (!fm_open(fmp, symbol, "wb")) {
+        z_free(z_allocator(symbol), rows);
+        strcpy(symbol->errtxt, "614: Could not open output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+
+    switch (file_type) {
+        case OUT_ZPL_FILE:
+            fm_printf(fmp, "^XA\n^FO0,0^GFA,%d,%d,%d,", total, total, row_bytes);
+            break;
+        case OUT_EPL_FILE:
+            fm_printf(fmp, "\nN\nGW0,0,%d,%d,", row_bytes, symbol->bitmap_height);
+            break;
+        default: /* OUT_PCL_FILE */
+            fm_printf(fmp, "\033E\033*t300R\033*r%dS\033*r%dT\033*p0x0Y\033*r1A", symbol->bitmap_width,
+                        symbol->bitmap_height);
+            break;
+    }
+
+    for (r = 0; r < symbol->bitmap_height; r++) {
+        unsigned char *swap;
+        prn_pack_row(symbol, pixelbuf, r, reverse, file_type == OUT_EPL_FILE, row);
+        if (file_type == OUT_ZPL_FILE) {
+            if (r && memcmp(row, prev, row_bytes) == 0) {
+                fm_putc(':', fmp); /* Repeat previous row */
+            } else {
+                char *hex = (char *) out + row_bytes * 2 + 2;
+                for (i = 0; i < row_bytes; i++) {
+                    hex[i * 2] = hex_digits[row[i] >> 4];
+                    hex[i * 2 + 1] = hex_digits[row[i] & 0x0F];
+                }
+                fm_write(out, 1, zpl_compress_row(hex, row_bytes * 2, (char *) out) - (char *) out, fmp);
+            }
+        } else if (file_type == OUT_EPL_FILE) {
+            fm_write(row, 1, row_bytes, fmp);
+        } else {
+            int len3 = pcl_mode3(row, prev, row_bytes, out);
+            int len2 = len3 ? pcl_mode2(row, row_bytes, out + len3) : len3;
+            if (len3 && len2 < len3) {
+                if (mode != 2) {
+                    fm_puts("\033*b2M", fmp);
+                    mode = 2;
+                }
+                fm_printf(fmp, "\033*b%dW", len2);
+                fm_write(out + len3, 1, len2, fmp);
+            } else {
+                if (mode != 3) {
+                    fm_puts("\033*b3M", fmp);
+                    mode = 3;
+                }
+                fm_printf(fmp, "\033*b%dW", len3);
+                fm_write(out, 1, len3, fmp);
+            }
+        }
+        swap = prev;
+        prev = row;
+        row = swap;
+    }
+
+    switch (file_type) {
+        case OUT_ZPL_FILE:
+            fm_puts("^FS\n^XZ\n", fmp);
+            break;
+        case OUT_EPL_FILE:
+            fm_puts("\nP1\n", fmp);
+            break;
+        default: /* OUT_PCL_FILE */
+            fm_puts("\033*rB\033E", fmp);
+            break;
+    }
+    z_free(z_allocator(symbol), rows);
+
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "615: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
+    }
+
+    return 0;
+}
+
+INTERNAL int zpl_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    return prn_pixel_plot(symbol, pixelbuf, OUT_ZPL_FILE);
+}
+
+INTERNAL int epl_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    return prn_pixel_plot(symbol, pixelbuf, OUT_EPL_FILE);
+}
+
+INTERNAL int pcl_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    return prn_pixel_plot(symbol, pixelbuf, OUT_PCL_FILE);
+}
@@ -31,13 +31,14 @@
  */
 /* vim: set ts=4 sw=4 et : */
 
-#include <locale.h>
 #include <stdio.h>
 #include <math.h>
 #ifdef _MSC_VER
 #include <malloc.h>
 #endif
 #include "common.h"
+#include "output.h"
+#include "filemem.h"
 
 static void colour_to_pscolor(int option, int colour, char* output) {
     strcpy(output, "");
@@ -102,6 +103,96 @@ static void colour_to_pscolor(int option, int colour, char* output) {
     }
 }
 
+/* Put colour setting operator, RGB unless `cmyk`, followed by `suffix` */
+static void ps_put_colour(const int cmyk, const float red, const float green, const float blue, const float cyan,
+            const float magenta, const float yellow, const float black, const char *suffix, struct filemem *fmp) {
+    if (!cmyk) {
+        fm_putsf(NULL, 2, red, fmp);
+        fm_putsf(" ", 2, green, fmp);
+        fm_putsf(" ", 2, blue, fmp);
+        fm_puts(" setrgbcolor", fmp);
+    } else {
+        fm_putsf(NULL, 2, cyan, fmp);
+        fm_putsf(" ", 2, magenta, fmp);
+        fm_putsf(" ", 2, yellow, fmp);
+        fm_putsf(" ", 2, black, fmp);
+        fm_puts(" setcmykcolor", fmp);
+    }
+    fm_puts(suffix, fmp);
+}
+
+/* Put `val` hundredths preceded by a space (unless `*p_line_len` negative), or a newline if the line would become
+   too long (DSC limits lines to 255 chars), updating `p_line_len` */
+static void ps_put_num(const int val, int *p_line_len, struct filemem *fmp) {
+    char buf[16];
+    char *const b = buf + 1;
+    const int len = (int) (output_put_hundredths(b, '\0', val) - b);
+
+    if (*p_line_len < 0) {
+        *p_line_len = len;
+        fm_write(b, 1, len, fmp);
+        return;
+    }
+    if (*p_line_len + 1 + len > 250) {
+        buf[0] = '\n';
+        *p_line_len = len;
+    } else {
+        buf[0] = ' ';
+        *p_line_len += 1 + len;
+    }
+    fm_write(buf, 1, 1 + len, fmp);
+}
+
+/* EPS_COMPACT rectangles of `colour` (-1 for all): rectangles sharing a row (same y and height, increasing x) are
+   drawn by a single `TC` call given the row's left edge, y, height and an array of alternating bar and space widths.
+   Positions are rounded before taking differences so that the widths don't accumulate error */
+static void ps_compact_rects(const struct zint_symbol *symbol, const int colour, struct filemem *fmp) {
+    struct zint_vector_rect *rect;
+    int in_row = 0;
+    int row_y = 0, row_h = 0, row_end = 0, bar_width = 0;
+    int line_len = 0;
+
+    for (rect = symbol->vector->rectangles; rect; rect = rect->next) {
+        int x0, x1, y, h;
+        if (colour != -1 && rect->colour != colour) {
+            continue;
+        }
+        x0 = output_hundredths(rect->x);
+        x1 = output_hundredths(rect->x + rect->width);
+        y = output_hundredths((symbol->vector->height - rect->y) - rect->height);
+        h = output_hundredths(rect->height);
+        if (in_row && y == row_y && h == row_h && x0 >= row_end) {
+            if (x0 == row_end) { /* Abutting so merge */
+                bar_width += x1 - x0;
+            } else {
+                ps_put_num(bar_width, &line_len, fmp);
+                ps_put_num(x0 - row_end, &line_len, fmp);
+                bar_width = x1 - x0;
+            }
+        } else {
+            if (in_row) {
+                ps_put_num(bar_width, &line_len, fmp);
+                fm_puts(" ] TC\n", fmp);
+            }
+            line_len = -1; /* Skip leading space */
+            ps_put_num(x0, &line_len, fmp);
+            ps_put_num(y, &line_len, fmp);
+            ps_put_num(h, &line_len, fmp);
+            fm_puts(" [", fmp);
+            line_len += 2;
+            bar_width = x1 - x0;
+            row_y = y;
+            row_h = h;
+            in_row = 1;
+        }
+        row_end = x1;
+    }
+    if (in_row) {
+        ps_put_num(bar_width, &line_len, fmp);
+        fm_puts(" ] TC\n", fmp);
+    }
+}
+
 STATIC_UNLESS_ZINT_TEST void ps_convert(const unsigned char *string, unsigned char *ps_string) {
     const unsigned char *s;
     unsigned char *p = ps_string;
@@ -132,7 +223,8 @@ STATIC_UNLESS_ZINT_TEST void ps_convert(const unsigned char *string, unsigned ch
 }
 
 INTERNAL int ps_plot(struct zint_symbol *symbol) {
-    FILE *feps;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     int fgred, fggrn, fgblu, bgred, bggrn, bgblu;
     float red_ink, green_ink, blue_ink, red_paper, green_paper, blue_paper;
     float cyan_ink, magenta_ink, yellow_ink, black_ink;
@@ -148,39 +240,33 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
     struct zint_vector_hexagon *hex;
     struct zint_vector_circle *circle;
     struct zint_vector_string *string;
-    const char *locale = NULL;
     const char *font;
     int i, len;
+    const int compact = symbol->output_options & EPS_COMPACT;
+    const int cmyk = symbol->output_options & CMYK_COLOUR;
+    int hex_v[12], hex_rel[10], prev_hex_rel[10];
+    int circle_radius, prev_circle_radius, circle_paper;
     int ps_len = 0;
     int iso_latin1 = 0;
 #ifdef _MSC_VER
     unsigned char *ps_string;
 #endif
 
-    if (strlen(symbol->bgcolour) > 6) {
-        if ((ctoi(symbol->bgcolour[6]) == 0) && (ctoi(symbol->bgcolour[7]) == 0)) {
-            draw_background = 0;
-        }
+    if (OUT_ALPHA(symbol->bgcolour_rgba) == 0) {
+        draw_background = 0;
     }
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        feps = stdout;
-    } else {
-        feps = fopen(symbol->outfile, "w");
-    }
-    if (feps == NULL) {
+    if (!fm_open(fmp, symbol, "w")) {
         strcpy(symbol->errtxt, "645: Could not open output file");
         return ZINT_ERROR_FILE_ACCESS;
     }
 
-    locale = setlocale(LC_ALL, "C");
-
-    fgred = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
-    fggrn = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
-    fgblu = (16 * ctoi(symbol->fgcolour[4])) + ctoi(symbol->fgcolour[5]);
-    bgred = (16 * ctoi(symbol->bgcolour[0])) + ctoi(symbol->bgcolour[1]);
-    bggrn = (16 * ctoi(symbol->bgcolour[2])) + ctoi(symbol->bgcolour[3]);
-    bgblu = (16 * ctoi(symbol->bgcolour[4])) + ctoi(symbol->bgcolour[5]);
+    fgred = OUT_RED(symbol->fgcolour_rgba);
+    fggrn = OUT_GREEN(symbol->fgcolour_rgba);
+    fgblu = OUT_BLUE(symbol->fgcolour_rgba);
+    bgred = OUT_RED(symbol->bgcolour_rgba);
+    bggrn = OUT_GREEN(symbol->bgcolour_rgba);
+    bgblu = OUT_BLUE(symbol->bgcolour_rgba);
     red_ink = (float) (fgred / 256.0);
     green_ink = (float) (fggrn / 256.0);
     blue_ink = (float) (fgblu / 256.0);
@@ -258,47 +344,48 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
 #endif
 
     /* Start writing the header */
-    fprintf(feps, "%%!PS-Adobe-3.0 EPSF-3.0\n");
+    fm_printf(fmp, "%%!PS-Adobe-3.0 EPSF-3.0\n");
     if (ZINT_VERSION_BUILD) {
-        fprintf(feps, "%%%%Creator: Zint %d.%d.%d.%d\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR, ZINT_VERSION_RELEASE, ZINT_VERSION_BUILD);
+        fm_printf(fmp, "%%%%Creator: Zint %d.%d.%d.%d\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR, ZINT_VERSION_RELEASE, ZINT_VERSION_BUILD);
     } else {
-        fprintf(feps, "%%%%Creator: Zint %d.%d.%d\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR, ZINT_VERSION_RELEASE);
+        fm_printf(fmp, "%%%%Creator: Zint %d.%d.%d\n", ZINT_VERSION_MAJOR, ZINT_VERSION_MINOR, ZINT_VERSION_RELEASE);
     }
-    fprintf(feps, "%%%%Title: Zint Generated Symbol\n");
-    fprintf(feps, "%%%%Pages: 0\n");
-    fprintf(feps, "%%%%BoundingBox: 0 0 %d %d\n", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height));
-    fprintf(feps, "%%%%EndComments\n");
+    fm_printf(fmp, "%%%%Title: Zint Generated Symbol\n");
+    fm_printf(fmp, "%%%%Pages: 0\n");
+    fm_printf(fmp, "%%%%BoundingBox: 0 0 %d %d\n", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height));
+    fm_printf(fmp, "%%%%EndComments\n");
 
     /* Definitions */
-    fprintf(feps, "/TL { setlinewidth moveto lineto stroke } bind def\n");
-    fprintf(feps, "/TD { newpath 0 360 arc fill } bind def\n");
-    fprintf(feps, "/TH { 0 setlinewidth moveto lineto lineto lineto lineto lineto closepath fill } bind def\n");
-    fprintf(feps, "/TB { 2 copy } bind def\n");
-    fprintf(feps, "/TR { newpath 4 1 roll exch moveto 1 index 0 rlineto 0 exch rlineto neg 0 rlineto closepath fill } bind def\n");
-    fprintf(feps, "/TE { pop pop } bind def\n");
+    fm_printf(fmp, "/TL { setlinewidth moveto lineto stroke } bind def\n");
+    fm_printf(fmp, "/TD { newpath 0 360 arc fill } bind def\n");
+    fm_printf(fmp, "/TH { 0 setlinewidth moveto lineto lineto lineto lineto lineto closepath fill } bind def\n");
+    fm_printf(fmp, "/TB { 2 copy } bind def\n");
+    fm_printf(fmp, "/TR { newpath 4 1 roll exch moveto 1 index 0 rlineto 0 exch rlineto neg 0 rlineto closepath fill } bind def\n");
+    fm_printf(fmp, "/TE { pop pop } bind def\n");
+    if (compact && symbol->vector->rectangles) {
+        /* x y h [ bar space bar ... ] TC */
+        fm_printf(fmp, "/TC { exch /TZ exch def exch /TY exch def exch /TX exch def /TW true def { TW { newpath TX TY"
+                    " moveto dup 0 rlineto 0 TZ rlineto dup neg 0 rlineto closepath fill } if TX add /TX exch def"
+                    " /TW TW not def } forall } bind def\n");
+    }
 
-    fprintf(feps, "newpath\n");
+    fm_printf(fmp, "newpath\n");
 
     /* Now the actual representation */
     
     //Background
     if (draw_background) {
-        if ((symbol->output_options & CMYK_COLOUR) == 0) {
-            fprintf(feps, "%.2f %.2f %.2f setrgbcolor\n", red_paper, green_paper, blue_paper);
-        } else {
-            fprintf(feps, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_paper, magenta_paper, yellow_paper, black_paper);
-        }
-        
-        fprintf(feps, "%.2f 0.00 TB 0.00 %.2f TR\n", symbol->vector->height, symbol->vector->width);
-        fprintf(feps, "TE\n");
+        ps_put_colour(cmyk, red_paper, green_paper, blue_paper, cyan_paper, magenta_paper, yellow_paper, black_paper,
+                "\n", fmp);
+
+        fm_putsf(NULL, 2, symbol->vector->height, fmp);
+        fm_putsf(" 0.00 TB 0.00 ", 2, symbol->vector->width, fmp);
+        fm_puts(" TR\n", fmp);
+        fm_printf(fmp, "TE\n");
     }
 
     if (symbol->symbology != BARCODE_ULTRA) {
-        if ((symbol->output_options & CMYK_COLOUR) == 0) {
-            fprintf(feps, "%.2f %.2f %.2f setrgbcolor\n", red_ink, green_ink, blue_ink);
-        } else {
-            fprintf(feps, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_ink, magenta_ink, yellow_ink, black_ink);
-        }
+        ps_put_colour(cmyk, red_ink, green_ink, blue_ink, cyan_ink, magenta_ink, yellow_ink, black_ink, "\n", fmp);
     }
 
     // Rectangles
@@ -311,26 +398,41 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
                     if (colour_rect_counter == 0) {
                         //Set new colour
                         colour_to_pscolor(symbol->output_options, colour_index, ps_color);
-                        fprintf(feps, "%s\n", ps_color);
+                        fm_printf(fmp, "%s\n", ps_color);
+                        if (compact) {
+                            ps_compact_rects(symbol, colour_index, fmp);
+                            break;
+                        }
                     }
                     colour_rect_counter++;
-                    fprintf(feps, "%.2f %.2f TB %.2f %.2f TR\n", rect->height, (symbol->vector->height - rect->y) - rect->height, rect->x, rect->width);
-                    fprintf(feps, "TE\n");
+                    fm_putsf(NULL, 2, rect->height, fmp);
+                    fm_putsf(" ", 2, (symbol->vector->height - rect->y) - rect->height, fmp);
+                    fm_putsf(" TB ", 2, rect->x, fmp);
+                    fm_putsf(" ", 2, rect->width, fmp);
+                    fm_puts(" TR\n", fmp);
+                    fm_printf(fmp, "TE\n");
                 }
                 rect = rect->next;
             }
         }
+    } else if (compact) {
+        ps_compact_rects(symbol, -1, fmp);
     } else {
         rect = symbol->vector->rectangles;
         while (rect) {
-            fprintf(feps, "%.2f %.2f TB %.2f %.2f TR\n", rect->height, (symbol->vector->height - rect->y) - rect->height, rect->x, rect->width);
-            fprintf(feps, "TE\n");
+            fm_putsf(NULL, 2, rect->height, fmp);
+            fm_putsf(" ", 2, (symbol->vector->height - rect->y) - rect->height, fmp);
+            fm_putsf(" TB ", 2, rect->x, fmp);
+            fm_putsf(" ", 2, rect->width, fmp);
+            fm_puts(" TR\n", fmp);
+            fm_printf(fmp, "TE\n");
             rect = rect->next;
         }
     }
 
     // Hexagons
     previous_diameter = radius = half_radius = half_sqrt3_radius = 0.0f;
+    prev_hex_rel[0] = 0x7FFFFFFF; /* Force first definition */
     hex = symbol->vector->hexagons;
     while (hex) {
         if (previous_diameter != hex->diameter) {
@@ -366,13 +468,91 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
             ex = hex->x + half_radius;
             fx = hex->x - half_radius;
         }
-        fprintf(feps, "%.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f TH\n", ax, ay, bx, by, cx, cy, dx, dy, ex, ey, fx, fy);
+        if (compact) {
+            /* x y TJ, with TJ (re)defined to draw the other vertices relative to the first, rounded first so that
+               the shape closes exactly */
+            hex_v[0] = output_hundredths(ax);
+            hex_v[1] = output_hundredths(ay);
+            hex_v[2] = output_hundredths(bx);
+            hex_v[3] = output_hundredths(by);
+            hex_v[4] = output_hundredths(cx);
+            hex_v[5] = output_hundredths(cy);
+            hex_v[6] = output_hundredths(dx);
+            hex_v[7] = output_hundredths(dy);
+            hex_v[8] = output_hundredths(ex);
+            hex_v[9] = output_hundredths(ey);
+            hex_v[10] = output_hundredths(fx);
+            hex_v[11] = output_hundredths(fy);
+            for (i = 0; i < 10; i++) {
+                hex_rel[i] = hex_v[i + 2] - hex_v[i];
+            }
+            if (memcmp(hex_rel, prev_hex_rel, sizeof(hex_rel)) != 0) {
+                memcpy(prev_hex_rel, hex_rel, sizeof(hex_rel));
+                fm_puts("/TJ { newpath moveto", fmp);
+                for (i = 0; i < 10; i += 2) {
+                    len = 0;
+                    ps_put_num(hex_rel[i], &len, fmp);
+                    ps_put_num(hex_rel[i + 1], &len, fmp);
+                    fm_puts(" rlineto", fmp);
+                }
+                fm_puts(" closepath fill } bind def\n", fmp);
+            }
+            len = -1;
+            ps_put_num(hex_v[0], &len, fmp);
+            ps_put_num(hex_v[1], &len, fmp);
+            fm_puts(" TJ\n", fmp);
+            hex = hex->next;
+            continue;
+        }
+        fm_putsf(NULL, 2, ax, fmp);
+        fm_putsf(" ", 2, ay, fmp);
+        fm_putsf(" ", 2, bx, fmp);
+        fm_putsf(" ", 2, by, fmp);
+        fm_putsf(" ", 2, cx, fmp);
+        fm_putsf(" ", 2, cy, fmp);
+        fm_putsf(" ", 2, dx, fmp);
+        fm_putsf(" ", 2, dy, fmp);
+        fm_putsf(" ", 2, ex, fmp);
+        fm_putsf(" ", 2, ey, fmp);
+        fm_putsf(" ", 2, fx, fmp);
+        fm_putsf(" ", 2, fy, fmp);
+        fm_puts(" TH\n", fmp);
         hex = hex->next;
     }
 
     // Circles
     previous_diameter = radius = 0.0f;
     circle = symbol->vector->circles;
+    if (compact && circle) {
+        /* x y TF, with TI/TP setting ink/paper colour and TF (re)defined when radius changes */
+        fm_puts("/TI { ", fmp);
+        ps_put_colour(cmyk, red_ink, green_ink, blue_ink, cyan_ink, magenta_ink, yellow_ink, black_ink,
+                " } bind def\n", fmp);
+        fm_puts("/TP { ", fmp);
+        ps_put_colour(cmyk, red_paper, green_paper, blue_paper, cyan_paper, magenta_paper, yellow_paper,
+                black_paper, " } bind def\n", fmp);
+        circle_paper = 0;
+        prev_circle_radius = -1;
+        while (circle) {
+            if (circle->colour != circle_paper) {
+                circle_paper = circle->colour;
+                fm_puts(circle_paper ? "TP\n" : "TI\n", fmp);
+            }
+            circle_radius = output_hundredths(0.5f * circle->diameter);
+            if (circle_radius != prev_circle_radius) {
+                prev_circle_radius = circle_radius;
+                len = -1;
+                fm_puts("/TF { newpath ", fmp);
+                ps_put_num(circle_radius, &len, fmp);
+                fm_puts(" 0 360 arc fill } bind def\n", fmp);
+            }
+            len = -1;
+            ps_put_num(output_hundredths(circle->x), &len, fmp);
+            ps_put_num(output_hundredths(symbol->vector->height - circle->y), &len, fmp);
+            fm_puts(" TF\n", fmp);
+            circle = circle->next;
+        }
+    }
     while (circle) {
         if (previous_diameter != circle->diameter) {
             previous_diameter = circle->diameter;
@@ -380,22 +560,22 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
         }
         if (circle->colour) {
             // A 'white' circle
-            if ((symbol->output_options & CMYK_COLOUR) == 0) {
-                fprintf(feps, "%.2f %.2f %.2f setrgbcolor\n", red_paper, green_paper, blue_paper);
-            } else {
-                fprintf(feps, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_paper, magenta_paper, yellow_paper, black_paper);
-            }
-            fprintf(feps, "%.2f %.2f %.2f TD\n", circle->x, (symbol->vector->height - circle->y), radius);
+            ps_put_colour(cmyk, red_paper, green_paper, blue_paper, cyan_paper,
+                    magenta_paper, yellow_paper, black_paper, "\n", fmp);
+            fm_putsf(NULL, 2, circle->x, fmp);
+            fm_putsf(" ", 2, (symbol->vector->height - circle->y), fmp);
+            fm_putsf(" ", 2, radius, fmp);
+            fm_puts(" TD\n", fmp);
             if (circle->next) {
-                if ((symbol->output_options & CMYK_COLOUR) == 0) {
-                    fprintf(feps, "%.2f %.2f %.2f setrgbcolor\n", red_ink, green_ink, blue_ink);
-                } else {
-                    fprintf(feps, "%.2f %.2f %.2f %.2f setcmykcolor\n", cyan_ink, magenta_ink, yellow_ink, black_ink);
-                }
+                ps_put_colour(cmyk, red_ink, green_ink, blue_ink, cyan_ink,
+                        magenta_ink, yellow_ink, black_ink, "\n", fmp);
             }
         } else {
             // A 'black' circle
-            fprintf(feps, "%.2f %.2f %.2f TD\n", circle->x, (symbol->vector->height - circle->y), radius);
+            fm_putsf(NULL, 2, circle->x, fmp);
+            fm_putsf(" ", 2, (symbol->vector->height - circle->y), fmp);
+            fm_putsf(" ", 2, radius, fmp);
+            fm_puts(" TD\n", fmp);
         }
         circle = circle->next;
     }
@@ -411,51 +591,50 @@ INTERNAL int ps_plot(struct zint_symbol *symbol) {
             font = "Helvetica";
         }
         if (iso_latin1) { /* Change encoding to ISO 8859-1, see Postscript Language Reference Manual 2nd Edition Example 5.6 */
-            fprintf(feps, "/%s findfont\n", font);
-            fprintf(feps, "dup length dict begin\n");
-            fprintf(feps, "{1 index /FID ne {def} {pop pop} ifelse} forall\n");
-            fprintf(feps, "/Encoding ISOLatin1Encoding def\n");
-            fprintf(feps, "currentdict\n");
-            fprintf(feps, "end\n");
-            fprintf(feps, "/Helvetica-ISOLatin1 exch definefont pop\n");
+            fm_printf(fmp, "/%s findfont\n", font);
+            fm_printf(fmp, "dup length dict begin\n");
+            fm_printf(fmp, "{1 index /FID ne {def} {pop pop} ifelse} forall\n");
+            fm_printf(fmp, "/Encoding ISOLatin1Encoding def\n");
+            fm_printf(fmp, "currentdict\n");
+            fm_printf(fmp, "end\n");
+            fm_printf(fmp, "/Helvetica-ISOLatin1 exch definefont pop\n");
             font = "Helvetica-ISOLatin1";
         }
         do {
             ps_convert(string->text, ps_string);
-            fprintf(feps, "matrix currentmatrix\n");
-            fprintf(feps, "/%s findfont\n", font);
-            fprintf(feps, "%.2f scalefont setfont\n", string->fsize);
-            fprintf(feps, " 0 0 moveto %.2f %.2f translate 0.00 rotate 0 0 moveto\n", string->x, (symbol->vector->height - string->y));
+            fm_printf(fmp, "matrix currentmatrix\n");
+            fm_printf(fmp, "/%s findfont\n", font);
+            fm_putsf(NULL, 2, string->fsize, fmp);
+            fm_puts(" scalefont setfont\n", fmp);
+            fm_putsf(" 0 0 moveto ", 2, string->x, fmp);
+            fm_putsf(" ", 2, (symbol->vector->height - string->y), fmp);
+            fm_puts(" translate 0.00 rotate 0 0 moveto\n", fmp);
             if (string->halign == 0 || string->halign == 2) { /* Need width for middle or right align */
-                fprintf(feps, " (%s) stringwidth\n", ps_string);
+                fm_printf(fmp, " (%s) stringwidth\n", ps_string);
             }
             if (string->rotation != 0) {
-                fprintf(feps, "gsave\n");
-                fprintf(feps, "%d rotate\n", 360 - string->rotation);
+                fm_printf(fmp, "gsave\n");
+                fm_printf(fmp, "%d rotate\n", 360 - string->rotation);
             }
             if (string->halign == 0 || string->halign == 2) {
-                fprintf(feps, "pop\n");
-                fprintf(feps, "%s 0 rmoveto\n", string->halign == 2 ? "neg" : "-2 div");
+                fm_printf(fmp, "pop\n");
+                fm_printf(fmp, "%s 0 rmoveto\n", string->halign == 2 ? "neg" : "-2 div");
             }
-            fprintf(feps, " (%s) show\n", ps_string);
+            fm_printf(fmp, " (%s) show\n", ps_string);
             if (string->rotation != 0) {
-                fprintf(feps, "grestore\n");
+                fm_printf(fmp, "grestore\n");
             }
-            fprintf(feps, "setmatrix\n");
+            fm_printf(fmp, "setmatrix\n");
             string = string->next;
         } while (string);
     }
 
-    //fprintf(feps, "\nshowpage\n");
+    //fm_printf(fmp, "\nshowpage\n");
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(feps);
-    } else {
-        fclose(feps);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "646: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
     }
 
-    if (locale)
-        setlocale(LC_ALL, locale);
-
     return error_number;
 }
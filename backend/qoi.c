@@ -0,0 +1,205 @@
+/* qoi.c - Handles output to QOI (Quite OK Image) files */
+/* QOI Specification Version 1.0 https://qoiformat.org/qoi-specification.pdf */
+
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include <stdio.h>
+#include "common.h"
+#include "filemem.h"
+#include "output.h"
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+#define QOI_OP_INDEX    0x00 /* 00xxxxxx */
+#define QOI_OP_DIFF     0x40 /* 01xxxxxx */
+#define QOI_OP_LUMA     0x80 /* 10xxxxxx */
+#define QOI_OP_RUN      0xC0 /* 11xxxxxx */
+#define QOI_OP_RGB      0xFE
+#define QOI_OP_RGBA     0xFF
+
+#define QOI_RUN_MAX     62
+
+/* Index into the array of previously seen pixels */
+#define QOI_HASH(c) (((c)[0] * 3 + (c)[1] * 5 + (c)[2] * 7 + (c)[3] * 11) % 64)
+
+/* Append the op(s) encoding pixel `px` following `prev` (not equal, any run already flushed) to `out` */
+static unsigned char *qoi_pixel(unsigned char *out, const unsigned char px[4], const unsigned char prev[4],
+            unsigned char index[64][4]) {
+    const int hash = QOI_HASH(px);
+
+    if (memcmp(index[hash], px, 4) == 0) {
+        *out++ = (unsigned char) (QOI_OP_INDEX | hash);
+        return out;
+    }
+    memcpy(index[hash], px, 4);
+
+    if (px[3] == prev[3]) {
+        /* Differences wrap around (as signed chars) */
+        const int vr = (signed char) (px[0] - prev[0]);
+        const int vg = (signed char) (px[1] - prev[1]);
+        const int vb = (signed char) (px[2] - prev[2]);
+        const int vg_r = vr - vg;
+        const int vg_b = vb - vg;
+
+        if (vr >= -2 && vr <= 1 && vg >= -2 && vg <= 1 && vb >= -2 && vb <= 1) {
+            *out++ = (unsigned char) (QOI_OP_DIFF | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2));
+        } else if (vg_r >= -8 && vg_r <= 7 && vg >= -32 && vg <= 31 && vg_b >= -8 && vg_b <= 7) {
+            *out++ = (unsigned char) (QOI_OP_LUMA | (vg + 32));
+            *out++ = (unsigned char) (((vg_r + 8) << 4) | (vg_b + 8));
+        } else {
+            *out++ = QOI_OP_RGB;
+            memcpy(out, px, 3);
+            out += 3;
+        }
+    } else {
+        *out++ = QOI_OP_RGBA;
+        memcpy(out, px, 4);
+        out += 4;
+    }
+
+    return out;
+}
+
+/* Output QOI, RGB unless the foreground or background has alpha, in which case RGBA. Pixels are compared by their
+   colour so that the runs, which make up most of a barcode image, are found without touching the index */
+INTERNAL int qoi_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    static const char ultra_colour[] = "0CBMRYGKW";
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
+    unsigned char colours[10][4]; /* Distinct colours */
+    unsigned char map[128]; /* Pixel value to `colours` index */
+    unsigned char index[64][4];
+    unsigned char header[14];
+    static const unsigned char end_marker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    const unsigned char fg_alpha = OUT_ALPHA(symbol->fgcolour_rgba);
+    const unsigned char bg_alpha = OUT_ALPHA(symbol->bgcolour_rgba);
+    const int width = symbol->bitmap_width;
+    const int height = symbol->bitmap_height;
+    const unsigned char *pb = pixelbuf;
+    unsigned char prev[4] = { 0, 0, 0, 0xFF };
+    int prev_colour = -1;
+    int num_colours = 0;
+    int run = 0;
+    int row, column, i, j;
+#ifdef _MSC_VER
+    unsigned char *row_buf;
+#endif
+
+#ifndef _MSC_VER
+    unsigned char row_buf[5 * width + 1]; /* Worst case QOI_OP_RGBA for each pixel plus a run */
+#else
+    row_buf = (unsigned char *) _alloca(5 * width + 1);
+#endif
+
+    memset(map, 0, sizeof(map));
+    for (i = 0; i < 10; i++) {
+        const int value = i == 9 ? '1' : ultra_colour[i];
+        unsigned char colour[4];
+        if (value == '0') {
+            colour[0] = OUT_RED(symbol->bgcolour_rgba);
+            colour[1] = OUT_GREEN(symbol->bgcolour_rgba);
+            colour[2] = OUT_BLUE(symbol->bgcolour_rgba);
+            colour[3] = bg_alpha;
+        } else if (value == '1') {
+            colour[0] = OUT_RED(symbol->fgcolour_rgba);
+            colour[1] = OUT_GREEN(symbol->fgcolour_rgba);
+            colour[2] = OUT_BLUE(symbol->fgcolour_rgba);
+            colour[3] = fg_alpha;
+        } else {
+            /* Ultracode colours take the foreground alpha, as in PNG */
+            colour[0] = (unsigned char) colour_to_red(i);
+            colour[1] = (unsigned char) colour_to_green(i);
+            colour[2] = (unsigned char) colour_to_blue(i);
+            colour[3] = fg_alpha;
+        }
+        for (j = 0; j < num_colours && memcmp(colours[j], colour, 4) != 0; j++);
+        if (j == num_colours) {
+            memcpy(colours[num_colours++], colour, 4);
+        }
+        map[value] = (unsigned char) j;
+    }
+
+    if (!fm_open(fmp, symbol, "wb")) {
+        strcpy(symbol->errtxt, "733: Could not open output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+
+    memcpy(header, "qoif", 4);
+    for (i = 0; i < 4; i++) {
+        header[4 + i] = (unsigned char) (width >> (24 - 8 * i));
+        header[8 + i] = (unsigned char) (height >> (24 - 8 * i));
+    }
+    header[12] = fg_alpha != 0xFF || bg_alpha != 0xFF ? 4 : 3; /* Channels */
+    header[13] = 0; /* sRGB with linear alpha */
+    fm_write(header, 1, sizeof(header), fmp);
+
+    memset(index, 0, sizeof(index));
+    for (row = 0; row < height; row++) {
+        unsigned char *out = row_buf;
+        for (column = 0; column < width; column++) {
+            const int colour = map[*pb++];
+            if (colour == prev_colour) {
+                if (++run == QOI_RUN_MAX) {
+                    *out++ = (unsigned char) (QOI_OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run) {
+                *out++ = (unsigned char) (QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+            if (memcmp(colours[colour], prev, 4) == 0) {
+                /* Only the initial previous pixel can match without being `prev_colour` */
+                prev_colour = colour;
+                run = 1;
+                continue;
+            }
+            out = qoi_pixel(out, colours[colour], prev, index);
+            memcpy(prev, colours[colour], 4);
+            prev_colour = colour;
+        }
+        if (run && row + 1 == height) {
+            *out++ = (unsigned char) (QOI_OP_RUN | (run - 1));
+        }
+        fm_write(row_buf, 1, (size_t) (out - row_buf), fmp);
+    }
+    fm_write(end_marker, 1, sizeof(end_marker), fmp);
+
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "734: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
+    }
+
+    return 0;
+}
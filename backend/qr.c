@@ -30,9 +30,13 @@
  */
 /* vim: set ts=4 sw=4 et : */
 
+#include <limits.h>
 #include <math.h>
 #ifdef _MSC_VER
 #include <malloc.h>
+#include "ms_stdint.h"
+#else
+#include <stdint.h>
 #endif
 #include "common.h"
 #include <stdio.h>
@@ -44,31 +48,7 @@
 
 /* Returns true if input glyph is in the Alphanumeric set */
 static int is_alpha(const unsigned int glyph, const int gs1) {
-    int retval = 0;
-
-    if ((glyph >= '0') && (glyph <= '9')) {
-        retval = 1;
-    } else if ((glyph >= 'A') && (glyph <= 'Z')) {
-        retval = 1;
-    } else if (gs1 && glyph == '[') {
-        retval = 1;
-    } else {
-        switch (glyph) {
-            case ' ':
-            case '$':
-            case '%':
-            case '*':
-            case '+':
-            case '-':
-            case '.':
-            case '/':
-            case ':':
-                retval = 1;
-                break;
-        }
-    }
-
-    return retval;
+    return glyph <= 0xFF && (is_chr(CHR_QR_ALNUM, glyph) || (gs1 && glyph == '['));
 }
 
 /* Bits multiplied by this for costs, so as to be whole integer divisible by 2 and 3 */
@@ -302,6 +282,124 @@ static void qr_define_mode(char mode[], const unsigned int jisdata[], const int
     }
 }
 
+/* Cost in bits (times QR_MULT) of encoding `jisdata[start]` to `jisdata[end - 1]` in a single segment of mode `m`
+ * (index into mode_types), excluding the mode and character count indicators */
+static unsigned int qr_run_cost(const int m, const unsigned int jisdata[], const int start, const int end,
+            const int gs1) {
+    int n = end - start;
+    int i;
+    unsigned int bits = 0;
+
+    switch (m) {
+        case QR_N:
+            bits = (n / 3) * 10 + (n % 3 == 2 ? 7 : n % 3 == 1 ? 4 : 0);
+            break;
+        case QR_A:
+            if (gs1) {
+                for (i = start; i < end; i++) {
+                    if (jisdata[i] == '%') {
+                        n++; /* Doubled-up */
+                    }
+                }
+            }
+            bits = (n / 2) * 11 + (n & 1) * 6;
+            break;
+        case QR_B:
+            for (i = start; i < end; i++) {
+                bits += jisdata[i] > 0xFF ? 16 : 8;
+            }
+            break;
+        case QR_K:
+            bits = n * 13;
+            break;
+    }
+
+    return bits * QR_MULT;
+}
+
+/* Whether mode `x` can encode characters whose narrowest mode is `m` (Byte can take anything, and Alphanumeric can
+ * take digits) */
+static int qr_can_take(const int x, const int m) {
+    return x == m || x == QR_B || (x == QR_A && m == QR_N);
+}
+
+/* Choose modes in a single greedy pass (FAST_MODE), which may give a longer bitstream than `qr_define_mode()`: each
+ * character is given its narrowest mode, and then each run of the same mode in turn is given the mode that is
+ * cheapest to encode it in, looking ahead to the following run only. Not for MICROQR */
+static void qr_fast_mode(char mode[], const unsigned int jisdata[], const int length, const int gs1,
+            const int version, const int debug_print) {
+    unsigned int state[10] = { 0 };
+    const unsigned int *head_costs; /* Switch costs same as head costs */
+    int i, j, j2, x, y;
+
+    state[QR_VER] = (unsigned int) version;
+    head_costs = qr_head_costs(state);
+
+    /* `mode` holds indexes into `mode_types` until the end */
+    for (i = 0; i < length; i++) {
+        if (jisdata[i] > 0xFF) {
+            mode[i] = QR_K;
+        } else if (jisdata[i] >= '0' && jisdata[i] <= '9') {
+            mode[i] = QR_N;
+        } else if (is_alpha(jisdata[i], gs1)) {
+            mode[i] = QR_A;
+        } else {
+            mode[i] = QR_B;
+        }
+    }
+
+    for (i = 0; i < length; i = j) {
+        const int m = mode[i];
+        const int p = i ? mode[i - 1] : -1;
+        int q = -1, best = m;
+        unsigned int best_cost = UINT_MAX;
+
+        for (j = i + 1; j < length && mode[j] == m; j++);
+        if (m == p) {
+            continue;
+        }
+        if (j < length) {
+            q = mode[j];
+            for (j2 = j + 1; j2 < length && mode[j2] == q; j2++);
+        }
+
+        for (x = 0; x < QR_NUM_MODES; x++) {
+            unsigned int cost, next_cost = 0;
+            if (!qr_can_take(x, m)) {
+                continue;
+            }
+            cost = (x == p ? 0 : head_costs[x]) + qr_run_cost(x, jisdata, i, j, gs1);
+            if (q != -1) {
+                next_cost = UINT_MAX;
+                for (y = 0; y < QR_NUM_MODES; y++) {
+                    if (qr_can_take(y, q)) {
+                        const unsigned int c = (y == x ? 0 : head_costs[y]) + qr_run_cost(y, jisdata, j, j2, gs1)
+                                                + (j2 < length && mode[j2] != y ? head_costs[(int) mode[j2]] : 0);
+                        if (c < next_cost) {
+                            next_cost = c;
+                        }
+                    }
+                }
+            }
+            if (cost + next_cost < best_cost || (cost + next_cost == best_cost && x == p)) {
+                best = x;
+                best_cost = cost + next_cost;
+            }
+        }
+        if (best != m) {
+            memset(mode + i, best, j - i);
+        }
+    }
+
+    for (i = 0; i < length; i++) {
+        mode[i] = mode_types[(int) mode[i]];
+    }
+
+    if (debug_print) {
+        printf("  Mode: %.*s\n", length, mode);
+    }
+}
+
 /* Returns mode indicator based on version and mode */
 static int mode_indicator(const int version, const int mode) {
     static const int mode_indicators[6][QR_NUM_MODES] = {
@@ -379,42 +477,51 @@ static int terminator_bits(const int version) {
     return 3 + (version - MICROQR_VERSION) * 2; /* MICROQR (Note not actually using this at the moment) */
 }
 
-/* Convert input data to a binary stream and add padding */
-static void qr_binary(unsigned char datastream[], const int version, const int target_codewords, const char mode[],
-            const unsigned int jisdata[], const int length, const int gs1, const int eci, const int est_binlen,
-            const int debug_print) {
+/* Append ECI mode indicator and designator (Table 4) */
+static void qr_append_eci(struct zint_bits *bits, const int eci) {
+    bits_append(bits, 7, 4); /* ECI (Table 4) */
+    if (eci <= 127) {
+        bits_append(bits, eci, 8); /* 000000 to 000127 */
+    } else if (eci <= 16383) {
+        bits_append(bits, 0x8000 + eci, 16); /* 000128 to 016383 */
+    } else {
+        bits_append(bits, 0xC00000 + eci, 24); /* 016384 to 999999 */
+    }
+}
+
+/* Convert input data to a packed bit stream in `datastream` and add padding, returning the number of bits (before
+   padding for MICROQR, which does its own). `structapp` if non-zero is the 16-bit Structured Append header
+   (index - 1, count - 1 and parity, see `qr_structapp()`), QR Code only. If `segs` non-NULL (QR Code only) the data
+   is in ECI segments (positions in `jisdata`, first ECI 0 if default), `eci` being ignored */
+static int qr_binary(unsigned char datastream[], const int version, const int target_codewords, const char mode[],
+            const unsigned int jisdata[], const int length, const int gs1, const int eci,
+            const struct zint_eci_segs *segs, const int structapp, const int debug_print) {
     int position = 0;
-    int i, j, bp;
+    int seg = 0, seg_end = segs ? segs->segs[0].length : length;
+    int i;
     int termbits, padbits, modebits;
     int current_bytes;
     int toggle, percent;
     int percent_count;
+    struct zint_bits bits;
 
-#ifndef _MSC_VER
-    char binary[est_binlen + 12];
-#else
-    char* binary = (char *) _alloca(est_binlen + 12);
-#endif
-    *binary = '\0';
-    bp = 0;
+    bits_init(&bits, datastream, 0);
+
+    if (structapp) { /* QR Code only */
+        bits_append(&bits, 3, 4); /* Structured Append (Table 2) */
+        bits_append(&bits, structapp, 16);
+    }
 
     if (gs1) { /* Not applicable to MICROQR */
         if (version < RMQR_VERSION) {
-            bp = bin_append_posn(5, 4, binary, bp); /* FNC1 */
+            bits_append(&bits, 5, 4); /* FNC1 */
         } else {
-            bp = bin_append_posn(5, 3, binary, bp);
+            bits_append(&bits, 5, 3);
         }
     }
 
-    if (eci != 0) { /* Not applicable to RMQR or MICROQR */
-        bp = bin_append_posn(7, 4, binary, bp); /* ECI (Table 4) */
-        if (eci <= 127) {
-            bp = bin_append_posn(eci, 8, binary, bp); /* 000000 to 000127 */
-        } else if (eci <= 16383) {
-            bp = bin_append_posn(0x8000 + eci, 16, binary, bp); /* 000128 to 016383 */
-        } else {
-            bp = bin_append_posn(0xC00000 + eci, 24, binary, bp); /* 016384 to 999999 */
-        }
+    if (segs ? segs->segs[0].eci != 0 : eci != 0) { /* Not applicable to RMQR or MICROQR */
+        qr_append_eci(&bits, segs ? segs->segs[0].eci : eci);
     }
 
     percent = 0;
@@ -422,20 +529,29 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
     modebits = mode_bits(version);
 
     do {
-        char data_block = mode[position];
+        char data_block;
         int short_data_block_length = 0;
         int double_byte = 0;
+        if (position == seg_end) { /* Next ECI segment */
+            seg++;
+            seg_end += segs->segs[seg].length;
+            qr_append_eci(&bits, segs->segs[seg].eci);
+            if (debug_print) {
+                printf("ECI %d\n", segs->segs[seg].eci);
+            }
+        }
+        data_block = mode[position];
         do {
             if (data_block == 'B' && jisdata[position + short_data_block_length] > 0xFF) {
                 double_byte++;
             }
             short_data_block_length++;
-        } while (((short_data_block_length + position) < length)
+        } while (((short_data_block_length + position) < seg_end)
                 && (mode[position + short_data_block_length] == data_block));
 
         /* Mode indicator */
         if (modebits) {
-            bp = bin_append_posn(mode_indicator(version, data_block), modebits, binary, bp);
+            bits_append(&bits, mode_indicator(version, data_block), modebits);
         }
 
         switch (data_block) {
@@ -443,7 +559,7 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
                 /* Kanji mode */
 
                 /* Character count indicator */
-                bp = bin_append_posn(short_data_block_length, cci_bits(version, data_block), binary, bp);
+                bits_append(&bits, short_data_block_length, cci_bits(version, data_block));
 
                 if (debug_print) {
                     printf("Kanji block (length %d)\n\t", short_data_block_length);
@@ -462,7 +578,7 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
 
                     prod = ((jis >> 8) * 0xc0) + (jis & 0xff);
 
-                    bp = bin_append_posn(prod, 13, binary, bp);
+                    bits_append(&bits, prod, 13);
 
                     if (debug_print) {
                         printf("0x%04X ", prod);
@@ -478,7 +594,7 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
                 /* Byte mode */
 
                 /* Character count indicator */
-                bp = bin_append_posn(short_data_block_length + double_byte, cci_bits(version, data_block), binary, bp);
+                bits_append(&bits, short_data_block_length + double_byte, cci_bits(version, data_block));
 
                 if (debug_print) {
                     printf("Byte block (length %d)\n\t", short_data_block_length + double_byte);
@@ -492,7 +608,7 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
                         byte = 0x1d; /* FNC1 */
                     }
 
-                    bp = bin_append_posn(byte, byte > 0xFF ? 16 : 8, binary, bp);
+                    bits_append(&bits, byte, byte > 0xFF ? 16 : 8);
 
                     if (debug_print) {
                         printf("0x%02X(%d) ", byte, byte);
@@ -517,7 +633,7 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
                 }
 
                 /* Character count indicator */
-                bp = bin_append_posn(short_data_block_length + percent_count, cci_bits(version, data_block), binary, bp);
+                bits_append(&bits, short_data_block_length + percent_count, cci_bits(version, data_block));
 
                 if (debug_print) {
                     printf("Alpha block (length %d)\n\t", short_data_block_length + percent_count);
@@ -590,7 +706,7 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
                         }
                     }
 
-                    bp = bin_append_posn(prod, 1 + (5 * count), binary, bp);
+                    bits_append(&bits, prod, 1 + (5 * count));
 
                     if (debug_print) {
                         printf("0x%X ", prod);
@@ -606,7 +722,7 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
                 /* Numeric mode */
 
                 /* Character count indicator */
-                bp = bin_append_posn(short_data_block_length, cci_bits(version, data_block), binary, bp);
+                bits_append(&bits, short_data_block_length, cci_bits(version, data_block));
 
                 if (debug_print) {
                     printf("Number block (length %d)\n\t", short_data_block_length);
@@ -634,7 +750,7 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
                         }
                     }
 
-                    bp = bin_append_posn(prod, 1 + (3 * count), binary, bp);
+                    bits_append(&bits, prod, 1 + (3 * count));
 
                     if (debug_print) {
                         printf("0x%X(%d) ", prod, prod);
@@ -655,44 +771,30 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
 
     if (version >= MICROQR_VERSION && version < MICROQR_VERSION + 4) {
         /* MICROQR does its own terminating/padding */
-        binary[bp] = '\0';
-        strcpy((char*)datastream, binary);
-        return;
+        return bits_flush(&bits);
     }
 
     /* Terminator */
-    termbits = 8 - bp % 8;
+    termbits = 8 - bits.posn % 8;
     if (termbits == 8) {
         termbits = 0;
     }
-    current_bytes = (bp + termbits) / 8;
+    current_bytes = (bits.posn + termbits) / 8;
     if (termbits || current_bytes < target_codewords) {
         int max_termbits = terminator_bits(version);
         termbits = termbits < max_termbits && current_bytes == target_codewords ? termbits : max_termbits;
-        bp = bin_append_posn(0, termbits, binary, bp);
+        bits_append(&bits, 0, termbits);
     }
 
     /* Padding bits */
-    padbits = 8 - bp % 8;
+    padbits = 8 - bits.posn % 8;
     if (padbits == 8) {
         padbits = 0;
     }
     if (padbits) {
-        current_bytes = (bp + padbits) / 8;
-        (void) bin_append_posn(0, padbits, binary, bp); /* Last use so not setting bp */
-    }
-
-    /* Put data into 8-bit codewords */
-    for (i = 0; i < current_bytes; i++) {
-        int p;
-        j = i * 8;
-        datastream[i] = 0x00;
-        for (p = 0; p < 8; p++) {
-            if (binary[j + p] == '1') {
-                datastream[i] |= (0x80 >> p);
-            }
-        }
+        bits_append(&bits, 0, padbits);
     }
+    current_bytes = bits.posn / 8; /* Now whole bytes, already in `datastream` */
 
     /* Add pad codewords */
     toggle = 0;
@@ -713,6 +815,8 @@ static void qr_binary(unsigned char datastream[], const int version, const int t
         }
         printf("\n");
     }
+
+    return bits.posn;
 }
 
 /* Split data into blocks, add error correction and then interleave the blocks and error correction data */
@@ -725,12 +829,6 @@ static void add_ecc(unsigned char fullstream[], const unsigned char datastream[]
     int ecc_block_length;
     int i, j, length_this_block, in_posn;
     rs_t rs;
-#ifdef _MSC_VER
-    unsigned char* data_block;
-    unsigned char* ecc_block;
-    unsigned char* interleaved_data;
-    unsigned char* interleaved_ecc;
-#endif
 
     if (version < RMQR_VERSION) {
         ecc_cw = qr_total_codewords[version - 1] - data_cw;
@@ -747,23 +845,12 @@ static void add_ecc(unsigned char fullstream[], const unsigned char datastream[]
     assert(short_data_block_length >= 0);
     assert(ecc_block_length * blocks == ecc_cw);
 
-#ifndef _MSC_VER
-    unsigned char data_block[short_data_block_length + 1];
-    unsigned char ecc_block[ecc_block_length];
-    unsigned char interleaved_data[data_cw];
-    unsigned char interleaved_ecc[ecc_cw];
-#else
-    data_block = (unsigned char *) _alloca(short_data_block_length + 1);
-    ecc_block = (unsigned char *) _alloca(ecc_block_length);
-    interleaved_data = (unsigned char *) _alloca(data_cw);
-    interleaved_ecc = (unsigned char *) _alloca(ecc_cw);
-#endif
-
     rs_init_gf(&rs, 0x11d);
     rs_init_code(&rs, ecc_block_length, 0);
 
     in_posn = 0;
 
+    /* Interleave the data and error correction codewords of each block straight into `fullstream` */
     for (i = 0; i < blocks; i++) {
         if (i < qty_short_blocks) {
             length_this_block = short_data_block_length;
@@ -771,53 +858,35 @@ static void add_ecc(unsigned char fullstream[], const unsigned char datastream[]
             length_this_block = short_data_block_length + 1;
         }
 
-        for (j = 0; j < ecc_block_length; j++) {
-            ecc_block[j] = 0;
+        for (j = 0; j < short_data_block_length; j++) {
+            fullstream[(j * blocks) + i] = datastream[in_posn + j];
         }
 
-        for (j = 0; j < length_this_block; j++) {
-            data_block[j] = datastream[in_posn + j];
+        if (i >= qty_short_blocks) {
+            fullstream[(short_data_block_length * blocks) + (i - qty_short_blocks)]
+                = datastream[in_posn + short_data_block_length];
         }
 
-        rs_encode(&rs, length_this_block, data_block, ecc_block);
+        rs_encode_step(&rs, length_this_block, datastream + in_posn, 1, fullstream + data_cw + i, blocks);
 
         if (debug_print) {
             printf("Block %d: ", i + 1);
             for (j = 0; j < length_this_block; j++) {
-                printf("%2X ", data_block[j]);
+                printf("%2X ", datastream[in_posn + j]);
             }
             if (i < qty_short_blocks) {
                 printf("   ");
             }
             printf(" // ");
             for (j = 0; j < ecc_block_length; j++) {
-                printf("%2X ", ecc_block[ecc_block_length - j - 1]);
+                printf("%2X ", fullstream[data_cw + (j * blocks) + i]);
             }
             printf("\n");
         }
 
-        for (j = 0; j < short_data_block_length; j++) {
-            interleaved_data[(j * blocks) + i] = data_block[j];
-        }
-
-        if (i >= qty_short_blocks) {
-            interleaved_data[(short_data_block_length * blocks) + (i - qty_short_blocks)] = data_block[short_data_block_length];
-        }
-
-        for (j = 0; j < ecc_block_length; j++) {
-            interleaved_ecc[(j * blocks) + i] = ecc_block[ecc_block_length - j - 1];
-        }
-
         in_posn += length_this_block;
     }
 
-    for (j = 0; j < data_cw; j++) {
-        fullstream[j] = interleaved_data[j]; // NOLINT suppress clang-tidy warning: interleaved_data[data_cw] fully set
-    }
-    for (j = 0; j < ecc_cw; j++) {
-        fullstream[j + data_cw] = interleaved_ecc[j]; // NOLINT suppress clang-tidy warning: interleaved_ecc[ecc_cw] fully set
-    }
-
     if (debug_print) {
         printf("\nData Stream: \n");
         for (j = 0; j < (data_cw + ecc_cw); j++) {
@@ -829,7 +898,7 @@ static void add_ecc(unsigned char fullstream[], const unsigned char datastream[]
 
 static void place_finder(unsigned char grid[], const int size, const int x, const int y) {
     int xp, yp;
-    char finder[] = {0x7F, 0x41, 0x5D, 0x5D, 0x5D, 0x41, 0x7F};
+    static const char finder[] = {0x7F, 0x41, 0x5D, 0x5D, 0x5D, 0x41, 0x7F};
 
     for (xp = 0; xp < 7; xp++) {
         for (yp = 0; yp < 7; yp++) {
@@ -844,7 +913,7 @@ static void place_finder(unsigned char grid[], const int size, const int x, cons
 
 static void place_align(unsigned char grid[], const int size, int x, int y) {
     int xp, yp;
-    char alignment[] = {0x1F, 0x11, 0x15, 0x11, 0x1F};
+    static const char alignment[] = {0x1F, 0x11, 0x15, 0x11, 0x1F};
 
     x -= 2;
     y -= 2; /* Input values represent centre of pattern */
@@ -993,223 +1062,145 @@ static void populate_grid(unsigned char *grid, const int h_size, const int v_siz
     }
 }
 
-#ifdef ZINTLOG
+#define QR_LINE_WORDS   3 /* 64-bit words per row or column of the largest QR Code (177 modules) */
 
-static int append_log(char log) {
-    FILE *file;
-
-    file = fopen("zintlog.txt", "a+");
-    fprintf(file, "%c", log);
-    fclose(file);
-    return 0;
+/* Return number of set bits in `word` */
+static int qr_popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word -= (word >> 1) & 0x5555555555555555;
+    word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return (int) ((word * 0x0101010101010101) >> 56);
+#endif
 }
 
-static int write_log(char log[]) {
-    FILE *file;
-
-    file = fopen("zintlog.txt", "a+");
-    fprintf(file, log); /*writes*/
-    fprintf(file, "\r\n"); /*writes*/
-    fclose(file);
-    return 0;
+/* In the mask evaluation each row and column of modules is a line of bits, module `i` being bit `i & 63` of word
+   `i >> 6`, with bits past the end clear. Shift line `v` down by `n` (1 to 63), so bit `i` of `out` is bit `i + n`
+   of `v` (clear past the end) */
+static void qr_line_down(const uint64_t *v, const int n, uint64_t *out) {
+    int i;
+    for (i = 0; i < QR_LINE_WORDS - 1; i++) {
+        out[i] = (v[i] >> n) | (v[i + 1] << (64 - n));
+    }
+    out[QR_LINE_WORDS - 1] = v[QR_LINE_WORDS - 1] >> n;
 }
-#endif
 
-static int evaluate(unsigned char *local, const int size) {
-    static const unsigned char h1011101[7] = { 1, 0, 1, 1, 1, 0, 1 };
-
-    int x, y, r, k, block;
-    int result = 0;
-    char state;
-    int dark_mods;
-    double percentage;
-    int a, b, afterCount, beforeCount;
-#ifdef ZINTLOG
-    int result_b = 0;
-    char str[15];
-#endif
+/* Shift line `v` up by `n` (1 to 63), so bit `i` of `out` is bit `i - n` of `v` (clear before the start) */
+static void qr_line_up(const uint64_t *v, const int n, uint64_t *out) {
+    int i;
+    for (i = QR_LINE_WORDS - 1; i > 0; i--) {
+        out[i] = (v[i] << n) | (v[i - 1] >> (64 - n));
+    }
+    out[0] = v[0] << n;
+}
 
-    /* Suppresses clang-tidy clang-analyzer-core.UndefinedBinaryOperatorResult warnings */
-    assert(size > 0);
+/* Penalties of line `v` for adjacent modules of the same colour (Test 1), returned, and for the 1:1:3:1:1
+   finder-like pattern with 4 light modules (or the edge) before or after it (Test 3), added to `p_finder`. `pairs`
+   has the bits set of the modules that have a next module (all but the last) */
+static int evaluate_line(const uint64_t *v, const uint64_t *pairs, int *p_finder) {
+    uint64_t down[11][QR_LINE_WORDS], up[5][QR_LINE_WORDS];
+    uint64_t eq[QR_LINE_WORDS], eq_down[QR_LINE_WORDS], eq_up[QR_LINE_WORDS];
+    int n, i;
+    int result = 0, finder = 0;
 
-#ifdef ZINTLOG
-    //bitmask output
-    for (y = 0; y < size; y++) {
-        strcpy(str, "");
-        for (x = 0; x < size; x++) {
-            state = local[(y * size) + x];
-            append_log(state);
-        }
-        write_log("");
+    for (n = 1; n <= 10; n++) {
+        qr_line_down(v, n, down[n]);
+    }
+    for (n = 1; n <= 4; n++) {
+        qr_line_up(v, n, up[n]);
     }
-    write_log("");
-#endif
 
-    /* Test 1: Adjacent modules in row/column in same colour */
-    /* Vertical */
-    for (x = 0; x < size; x++) {
-        block = 0;
-        state = 0;
-        for (y = 0; y < size; y++) {
-            if (local[(y * size) + x] == state) {
-                block++;
-            } else {
-                if (block >= 5) {
-                    result += block - 2;
-                }
-                block = 1;
-                state = local[(y * size) + x];
+    /* Test 1: `eq` bit set if module same as the next. A run of length L >= 5 has L - 4 windows of 5 the same, and
+       scores L - 2, i.e. 1 for each window plus 2 for the window starting it */
+    for (i = 0; i < QR_LINE_WORDS; i++) {
+        eq[i] = ~(v[i] ^ down[1][i]) & pairs[i];
+    }
+    {
+        uint64_t windows[QR_LINE_WORDS];
+        memcpy(windows, eq, sizeof(windows));
+        for (n = 1; n <= 3; n++) {
+            qr_line_down(eq, n, eq_down);
+            for (i = 0; i < QR_LINE_WORDS; i++) {
+                windows[i] &= eq_down[i];
             }
         }
-        if (block >= 5) {
-            result += block - 2;
+        qr_line_up(eq, 1, eq_up);
+        for (i = 0; i < QR_LINE_WORDS; i++) {
+            result += qr_popcount(windows[i]) + 2 * qr_popcount(windows[i] & ~eq_up[i]);
         }
     }
 
-    /* Horizontal */
-    dark_mods = 0; /* Count dark mods simultaneously (see Test 4 below) */
-    for (y = 0; y < size; y++) {
-        r = y * size;
-        block = 0;
-        state = 0;
-        for (x = 0; x < size; x++) {
-            if (local[r + x] == state) {
-                block++;
-            } else {
-                if (block >= 5) {
-                    result += block - 2;
-                }
-                block = 1;
-                state = local[r + x];
-            }
-            if (state) {
-                dark_mods++;
-            }
-        }
-        if (block >= 5) {
-            result += block - 2;
-        }
+    /* Test 3: 1011101 at each position with light before or after (out of range modules being clear) */
+    for (i = 0; i < QR_LINE_WORDS; i++) {
+        const uint64_t match = v[i] & ~down[1][i] & down[2][i] & down[3][i] & down[4][i] & ~down[5][i] & down[6][i];
+        const uint64_t light_before = ~(up[1][i] | up[2][i] | up[3][i] | up[4][i]);
+        const uint64_t light_after = ~(down[7][i] | down[8][i] | down[9][i] | down[10][i]);
+        finder += qr_popcount(match & (light_before | light_after));
     }
 
-#ifdef ZINTLOG
-    /* output Test 1 */
-    sprintf(str, "%d", result);
-    result_b = result;
-    write_log(str);
-#endif
+    *p_finder += 40 * finder;
+    return result;
+}
 
-    /* Test 2: Block of modules in same color */
-    for (x = 0; x < size - 1; x++) {
-        for (y = 0; y < size - 1; y++) {
-            k = local[(y * size) + x];
-            if (((k == local[((y + 1) * size) + x]) &&
-                    (k == local[(y * size) + (x + 1)])) &&
-                    (k == local[((y + 1) * size) + (x + 1)])) {
-                result += 3;
-            }
-        }
-    }
+/* Evaluate penalty of masked symbol, given as its `rows` and its `cols` of bits (see `qr_line_down()`). As all the
+   tests add to the penalty, stops early returning the partial penalty once it reaches `bound` */
+static int evaluate(const uint64_t *rows, const uint64_t *cols, const int size, const int bound) {
+    uint64_t pairs[QR_LINE_WORDS];
+    int x, y, i, k;
+    int result = 0, finder = 0;
+    int dark_mods = 0;
+    double percentage;
 
-#ifdef ZINTLOG
-    /* output Test 2 */
-    sprintf(str, "%d", result - result_b);
-    result_b = result;
-    write_log(str);
-#endif
+    /* Suppresses clang-tidy clang-analyzer-core.UndefinedBinaryOperatorResult warnings */
+    assert(size > 0);
 
-    /* Test 3: 1:1:3:1:1 ratio pattern in row/column */
-    /* Vertical */
+    for (i = 0; i < QR_LINE_WORDS; i++) {
+        const int n = size - 1 - 64 * i; /* Modules in this word with a next module */
+        pairs[i] = n >= 64 ? ~((uint64_t) 0) : n > 0 ? ((uint64_t) 1 << n) - 1 : 0;
+    }
+
+    /* Tests 1 and 3 on each column and row, counting dark modules (Test 4) at the same time */
     for (x = 0; x < size; x++) {
-        for (y = 0; y <= (size - 7); y++) {
-            if (local[y * size + x] && !local[(y + 1) * size + x] && local[(y + 2) * size + x] &&
-                    local[(y + 3) * size + x] && local[(y + 4) * size + x] &&
-                    !local[(y + 5) * size + x] && local[(y + 6) * size + x]) {
-                /* Pattern found, check before and after */
-                beforeCount = 0;
-                for (b = (y - 1); b >= (y - 4); b--) {
-                    if (b < 0) { /* Count < edge as whitespace */
-                        beforeCount = 4;
-                        break;
-                    }
-                    if (local[(b * size) + x]) {
-                        break;
-                    }
-                    beforeCount++;
-                }
-                if (beforeCount == 4) {
-                    /* Pattern is preceded by light area 4 modules wide */
-                    result += 40;
-                } else {
-                    afterCount = 0;
-                    for (a = (y + 7); a <= (y + 10); a++) {
-                        if (a >= size) { /* Count > edge as whitespace */
-                            afterCount = 4;
-                            break;
-                        }
-                        if (local[(a * size) + x]) {
-                            break;
-                        }
-                        afterCount++;
-                    }
-                    if (afterCount == 4) {
-                        /* Pattern is followed by light area 4 modules wide */
-                        result += 40;
-                    }
-                }
-                y += 3; /* Skip to next possible match */
-            }
+        result += evaluate_line(cols + x * QR_LINE_WORDS, pairs, &finder);
+        if (result + finder >= bound) {
+            return result + finder;
         }
     }
-
-    /* Horizontal */
     for (y = 0; y < size; y++) {
-        r = y * size;
-        for (x = 0; x <= (size - 7); x++) {
-            if (memcmp(local + r + x, h1011101, 7) == 0) {
-                /* Pattern found, check before and after */
-                beforeCount = 0;
-                for (b = (x - 1); b >= (x - 4); b--) {
-                    if (b < 0) { /* Count < edge as whitespace */
-                        beforeCount = 4;
-                        break;
-                    }
-                    if (local[r + b]) {
-                        break;
-                    }
-                    beforeCount++;
-                }
+        const uint64_t *const row = rows + y * QR_LINE_WORDS;
+        result += evaluate_line(row, pairs, &finder);
+        for (i = 0; i < QR_LINE_WORDS; i++) {
+            dark_mods += qr_popcount(row[i]);
+        }
+        if (result + finder >= bound) {
+            return result + finder;
+        }
+    }
 
-                if (beforeCount == 4) {
-                    /* Pattern is preceded by light area 4 modules wide */
-                    result += 40;
-                } else {
-                    afterCount = 0;
-                    for (a = (x + 7); a <= (x + 10); a++) {
-                        if (a >= size) { /* Count > edge as whitespace */
-                            afterCount = 4;
-                            break;
-                        }
-                        if (local[r + a]) {
-                            break;
-                        }
-                        afterCount++;
-                    }
-                    if (afterCount == 4) {
-                        /* Pattern is followed by light area 4 modules wide */
-                        result += 40;
-                    }
+    /* Test 2: Block of modules in same color, where module same as the one to its right in both rows and as the
+       one below it */
+    {
+        uint64_t right[QR_LINE_WORDS], eq_above[QR_LINE_WORDS], eq_row[QR_LINE_WORDS];
+
+        for (y = 0; y < size; y++) {
+            const uint64_t *const row = rows + y * QR_LINE_WORDS;
+            qr_line_down(row, 1, right);
+            for (i = 0; i < QR_LINE_WORDS; i++) {
+                eq_row[i] = ~(row[i] ^ right[i]) & pairs[i];
+            }
+            if (y) {
+                const uint64_t *const above = row - QR_LINE_WORDS;
+                for (i = 0; i < QR_LINE_WORDS; i++) {
+                    result += 3 * qr_popcount(eq_above[i] & eq_row[i] & ~(above[i] ^ row[i]));
                 }
-                x += 3; /* Skip to next possible match */
             }
+            memcpy(eq_above, eq_row, sizeof(eq_above));
         }
     }
 
-#ifdef ZINTLOG
-    /* output Test 3 */
-    sprintf(str, "%d", result - result_b);
-    result_b = result;
-    write_log(str);
-#endif
+    result += finder;
 
     /* Test 4: Proportion of dark modules in entire symbol */
     percentage = (100.0 * dark_mods) / (size * size);
@@ -1217,23 +1208,12 @@ static int evaluate(unsigned char *local, const int size) {
 
     result += 10 * k;
 
-#ifdef ZINTLOG
-    /* output Test 4+summary */
-    sprintf(str, "%d", result - result_b);
-    write_log(str);
-    write_log("==========");
-    sprintf(str, "%d", result);
-    write_log(str);
-#endif
-
     return result;
 }
 
-/* Add format information to grid */
-static void add_format_info(unsigned char *grid, const int size, const int ecc_level, const int pattern) {
+/* Format information sequence for `ecc_level` and mask `pattern` */
+static unsigned int format_seq(const int ecc_level, const int pattern) {
     int format = pattern;
-    unsigned int seq;
-    int i;
 
     switch (ecc_level) {
         case LEVEL_L: format |= 0x08;
@@ -1244,7 +1224,13 @@ static void add_format_info(unsigned char *grid, const int size, const int ecc_l
             break;
     }
 
-    seq = qr_annex_c[format];
+    return qr_annex_c[format];
+}
+
+/* Add format information to grid */
+static void add_format_info(unsigned char *grid, const int size, const int ecc_level, const int pattern) {
+    const unsigned int seq = format_seq(ecc_level, pattern);
+    int i;
 
     for (i = 0; i < 6; i++) {
         grid[(i * size) + 8] |= (seq >> i) & 0x01;
@@ -1267,55 +1253,134 @@ static void add_format_info(unsigned char *grid, const int size, const int ecc_l
     grid[(8 * size) + 7] |= (seq >> 8) & 0x01;
 }
 
-static int apply_bitmask(unsigned char *grid, const int size, const int ecc_level, const int user_mask,
-            const int debug_print) {
+/* Set module `x`, `y` in `rows` and `cols` of bits (see `qr_line_down()`) if `bit` set */
+static void qr_set_module(uint64_t *rows, uint64_t *cols, const int x, const int y, const unsigned int bit) {
+    rows[y * QR_LINE_WORDS + (x >> 6)] |= (uint64_t) (bit & 0x01) << (x & 63);
+    cols[x * QR_LINE_WORDS + (y >> 6)] |= (uint64_t) (bit & 0x01) << (y & 63);
+}
+
+/* Add format information to `rows` and `cols` of bits, as `add_format_info()` */
+static void add_format_info_bits(uint64_t *rows, uint64_t *cols, const int size, const int ecc_level,
+            const int pattern) {
+    const unsigned int seq = format_seq(ecc_level, pattern);
+    int i;
+
+    for (i = 0; i < 6; i++) {
+        qr_set_module(rows, cols, 8, i, seq >> i);
+    }
+
+    for (i = 0; i < 8; i++) {
+        qr_set_module(rows, cols, size - i - 1, 8, seq >> i);
+    }
+
+    for (i = 0; i < 6; i++) {
+        qr_set_module(rows, cols, 5 - i, 8, seq >> (i + 9));
+    }
+
+    for (i = 0; i < 7; i++) {
+        qr_set_module(rows, cols, 8, (size - 7) + i, seq >> (i + 8));
+    }
+
+    qr_set_module(rows, cols, 8, 7, seq >> 6);
+    qr_set_module(rows, cols, 8, 8, seq >> 7);
+    qr_set_module(rows, cols, 7, 8, seq >> 8);
+}
+
+/* All eight mask patterns for module `x`, `y`, encoded in the 8 bits returned */
+static unsigned int qr_mask_patterns(const int x, const int y) {
+    unsigned int mask = 0;
+
+    if (((y + x) & 1) == 0) {
+        mask |= 0x01;
+    }
+    if ((y & 1) == 0) {
+        mask |= 0x02;
+    }
+    if ((x % 3) == 0) {
+        mask |= 0x04;
+    }
+    if (((y + x) % 3) == 0) {
+        mask |= 0x08;
+    }
+    if ((((y / 2) + (x / 3)) & 1) == 0) {
+        mask |= 0x10;
+    }
+    if ((y * x) % 6 == 0) { /* Equivalent to (y * x) % 2 + (y * x) % 3 == 0 */
+        mask |= 0x20;
+    }
+    if (((((y * x) & 1) + ((y * x) % 3)) & 1) == 0) {
+        mask |= 0x40;
+    }
+    if (((((y + x) & 1) + ((y * x) % 3)) & 1) == 0) {
+        mask |= 0x80;
+    }
+
+    return mask;
+}
+
+/* The mask patterns repeat every 12 rows and every 12 columns */
+#define QR_MASK_PERIOD 12
+
+/* Choose the mask with the lowest penalty (unless `user_mask`) and apply it. The grid and the masks are held as
+   rows and columns of bits so that each mask is evaluated a word at a time */
+static int apply_bitmask(struct zint_symbol *symbol, unsigned char *grid, const int size, const int ecc_level,
+            const int user_mask, const int debug_print) {
     int x, y;
     int r, k;
-    int bit;
     int pattern, penalty[8];
-    int best_pattern;
-    int size_squared = size * size;
+    int best_pattern, evaluated = 0;
+    const int lines_size = size * QR_LINE_WORDS; /* Words in the rows (or columns) of the symbol */
+    const uint64_t *best_mask;
+    const int full_penalties = debug_print || (symbol->debug & ZINT_DEBUG_TRACE);
+    uint64_t tiles[8][2][QR_MASK_PERIOD][QR_LINE_WORDS]; /* Rows then columns of each pattern, see below */
 
-#ifndef _MSC_VER
-    unsigned char mask[size_squared];
-    unsigned char local[size_squared];
-#else
-    unsigned char *mask = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-    unsigned char *local = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
+    /* Rows then columns of the modules each mask pattern flips */
+    z_work_array(symbol, uint64_t, masks, 8 * 2 * lines_size);
+    z_work_array(symbol, uint64_t, unmasked, 2 * lines_size);
+    /* Rows then columns of the modules that may be masked */
+    z_work_array(symbol, uint64_t, maskable, 2 * lines_size);
+    z_work_array(symbol, uint64_t, local, 2 * lines_size);
+
+    if (z_work_failed(masks) || z_work_failed(unmasked) || z_work_failed(maskable) || z_work_failed(local)) {
+        z_work_error(symbol);
+        return -1;
+    }
+
+    assert(size <= 64 * QR_LINE_WORDS);
 
     /* Perform data masking */
-    memset(mask, 0, size_squared);
+    memset(unmasked, 0, sizeof(uint64_t) * 2 * lines_size);
+    memset(maskable, 0, sizeof(uint64_t) * 2 * lines_size);
     for (y = 0; y < size; y++) {
         r = y * size;
         for (x = 0; x < size; x++) {
+            qr_set_module(unmasked, unmasked + lines_size, x, y, grid[r + x]);
+            // exclude areas not to be masked.
+            qr_set_module(maskable, maskable + lines_size, x, y, !(grid[r + x] & 0xf0));
+        }
+    }
 
-            // all eight bitmask variants are encoded in the 8 bits of the bytes that make up the mask array.
-            if (!(grid[r + x] & 0xf0)) { // exclude areas not to be masked.
-                if (((y + x) & 1) == 0) {
-                    mask[r + x] |= 0x01;
-                }
-                if ((y & 1) == 0) {
-                    mask[r + x] |= 0x02;
-                }
-                if ((x % 3) == 0) {
-                    mask[r + x] |= 0x04;
-                }
-                if (((y + x) % 3) == 0) {
-                    mask[r + x] |= 0x08;
-                }
-                if ((((y / 2) + (x / 3)) & 1) == 0) {
-                    mask[r + x] |= 0x10;
-                }
-                if ((y * x) % 6 == 0) { /* Equivalent to (y * x) % 2 + (y * x) % 3 == 0 */
-                    mask[r + x] |= 0x20;
-                }
-                if (((((y * x) & 1) + ((y * x) % 3)) & 1) == 0) {
-                    mask[r + x] |= 0x40;
-                }
-                if (((((y + x) & 1) + ((y * x) % 3)) & 1) == 0) {
-                    mask[r + x] |= 0x80;
-                }
+    /* Each pattern's rows (and columns), one per row (column) modulo the period, from which its masks are cut */
+    memset(tiles, 0, sizeof(tiles));
+    for (k = 0; k < QR_MASK_PERIOD; k++) {
+        for (x = 0; x < size; x++) {
+            const unsigned int row_mask = qr_mask_patterns(x, k);
+            const unsigned int col_mask = qr_mask_patterns(k, x);
+            for (pattern = 0; pattern < 8; pattern++) {
+                tiles[pattern][0][k][x >> 6] |= (uint64_t) ((row_mask >> pattern) & 0x01) << (x & 63);
+                tiles[pattern][1][k][x >> 6] |= (uint64_t) ((col_mask >> pattern) & 0x01) << (x & 63);
+            }
+        }
+    }
+    for (pattern = 0; pattern < 8; pattern++) {
+        uint64_t *const mask_rows = masks + pattern * 2 * lines_size;
+        uint64_t *const mask_cols = mask_rows + lines_size;
+        for (y = 0; y < size; y++) { /* Row `y` and column `y` */
+            const uint64_t *const row_tile = tiles[pattern][0][y % QR_MASK_PERIOD];
+            const uint64_t *const col_tile = tiles[pattern][1][y % QR_MASK_PERIOD];
+            for (k = 0; k < QR_LINE_WORDS; k++) {
+                mask_rows[y * QR_LINE_WORDS + k] = row_tile[k] & maskable[y * QR_LINE_WORDS + k];
+                mask_cols[y * QR_LINE_WORDS + k] = col_tile[k] & maskable[lines_size + y * QR_LINE_WORDS + k];
             }
         }
     }
@@ -1323,53 +1388,48 @@ static int apply_bitmask(unsigned char *grid, const int size, const int ecc_leve
     if (user_mask) {
         best_pattern = user_mask - 1;
     } else {
-        /* all eight bitmask variants have been encoded in the 8 bits of the bytes
-         * that make up the mask array. select them for evaluation according to the
-         * desired pattern.*/
+        /* Evaluate each mask applied to the grid along with its format information */
         best_pattern = 0;
         for (pattern = 0; pattern < 8; pattern++) {
+            const uint64_t *const mask_rows = masks + pattern * 2 * lines_size;
 
-            bit = 1 << pattern;
-            for (k = 0; k < size_squared; k++) {
-                if (mask[k] & bit) {
-                    local[k] = grid[k] ^ 0x01;
-                } else {
-                    local[k] = grid[k] & 0x0f;
-                }
+            /* Past the time budget keep the best so far (or pattern 0 if none evaluated yet) */
+            if (z_over_budget(symbol)) {
+                break;
+            }
+            for (k = 0; k < 2 * lines_size; k++) {
+                local[k] = unmasked[k] ^ mask_rows[k];
             }
-            add_format_info(local, size, ecc_level, pattern);
+            add_format_info_bits(local, local + lines_size, size, ecc_level, pattern);
 
-            penalty[pattern] = evaluate(local, size);
+            /* Masks can't beat the best so far once their penalty reaches it, so stop evaluating them there
+               (unless debugging or tracing, which give the full penalties) */
+            penalty[pattern] = evaluate(local, local + lines_size, size,
+                                    pattern && !full_penalties ? penalty[best_pattern] : INT_MAX);
+            z_record(symbol, ZINT_PHASE_MASK, ZINT_RECORD_PENALTY, pattern, penalty[pattern], 0, 0);
 
             if (penalty[pattern] < penalty[best_pattern]) {
                 best_pattern = pattern;
             }
+            evaluated++;
         }
     }
+    z_record(symbol, ZINT_PHASE_MASK, ZINT_RECORD_MASK, best_pattern, evaluated ? penalty[best_pattern] : -1,
+            !!user_mask, 0);
 
     if (debug_print) {
-        printf("Mask: %d (%s)", best_pattern, user_mask ? "specified" : "automatic");
-        if (!user_mask) {
-            for (pattern = 0; pattern < 8; pattern++) printf(" %d:%d", pattern, penalty[pattern]);
-        }
+        printf("Mask: %d (%s)", best_pattern, user_mask ? "specified" : evaluated < 8 ? "time budget" : "automatic");
+        for (pattern = 0; pattern < evaluated; pattern++) printf(" %d:%d", pattern, penalty[pattern]);
         printf("\n");
     }
 
-#ifdef ZINTLOG
-    char str[15];
-    sprintf(str, "%d", best_val);
-    write_log("choosed pattern:");
-    write_log(str);
-#endif
-
     /* Apply mask */
-    if (!user_mask && best_pattern == 7) { /* Reuse last */
-        memcpy(grid, local, size_squared);
-    } else {
-        bit = 1 << best_pattern;
-        for (y = 0; y < size_squared; y++) {
-            if (mask[y] & bit) {
-                grid[y] ^= 0x01;
+    best_mask = masks + best_pattern * 2 * lines_size;
+    for (y = 0; y < size; y++) {
+        r = y * size;
+        for (x = 0; x < size; x++) {
+            if ((best_mask[y * QR_LINE_WORDS + (x >> 6)] >> (x & 63)) & 1) {
+                grid[r + x] ^= 0x01;
             }
         }
     }
@@ -1409,7 +1469,7 @@ static int blockLength(const int start, const char inputMode[], const int inputL
 }
 
 static int getBinaryLength(const int version, char inputMode[], const unsigned int inputData[], const int inputLength,
-            const int gs1, const int eci, const int debug_print) {
+            const int gs1, const int eci, const int fast, const int debug_print) {
     /* Calculate the actual bitlength of the proposed binary string */
     int i, j;
     char currentMode;
@@ -1417,7 +1477,11 @@ static int getBinaryLength(const int version, char inputMode[], const unsigned i
     int alphalength;
     int blocklength;
 
-    qr_define_mode(inputMode, inputData, inputLength, gs1, version, debug_print);
+    if (fast) {
+        qr_fast_mode(inputMode, inputData, inputLength, gs1, version, debug_print);
+    } else {
+        qr_define_mode(inputMode, inputData, inputLength, gs1, version, debug_print);
+    }
 
     currentMode = ' '; // Null
 
@@ -1504,31 +1568,62 @@ static int getBinaryLength(const int version, char inputMode[], const unsigned i
     return count;
 }
 
+/* QR Code versions with the same character count indicator bits (1-9, 10-26, 27-40) have the same optimal modes
+   and binary length, so calculate them once per class, caching them in `class_modes` and `class_binlens` (initially
+   -1) */
+static int getBinaryLengthCached(const int version, char inputMode[], char class_modes[], int class_binlens[3],
+            const unsigned int inputData[], const int inputLength, const int gs1, const int eci,
+            const struct zint_eci_segs *segs, const int structapp, const int fast, const int debug_print) {
+    const int class_idx = version < 10 ? 0 : version < 27 ? 1 : 2;
+    char *const class_mode = class_modes + class_idx * inputLength;
+
+    if (class_binlens[class_idx] == -1) {
+        if (segs) {
+            /* Each ECI segment starts afresh, so define its modes separately */
+            int i;
+            class_binlens[class_idx] = 0;
+            for (i = 0; i < segs->count; i++) {
+                const int start = segs->segs[i].start;
+                class_binlens[class_idx] += getBinaryLength(version, class_mode + start, inputData + start,
+                                                segs->segs[i].length, gs1, segs->segs[i].eci, fast, debug_print);
+            }
+        } else {
+            class_binlens[class_idx] = getBinaryLength(version, class_mode, inputData, inputLength, gs1, eci, fast,
+                                        debug_print);
+        }
+    }
+    memcpy(inputMode, class_mode, inputLength);
+
+    return class_binlens[class_idx] + (structapp ? 20 : 0);
+}
+
 INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int length) {
     int i, j, est_binlen, prev_est_binlen;
+    int structapp = 0;
+    int class_binlens[3] = { -1, -1, -1 };
     int ecc_level, autosize, version, max_cw, target_codewords, blocks, size;
     int bitmask, gs1;
+    int fast;
     int full_multibyte;
     int user_mask;
     int canShrink;
     int size_squared;
     int debug_print = symbol->debug & ZINT_DEBUG_PRINT;
     int eci_length = get_eci_length(symbol->eci, source, length);
+    struct zint_eci_segs qr_segs;
+    const struct zint_eci_segs *segs = NULL; /* Set if switching ECIs within the data */
 
-#ifndef _MSC_VER
-    unsigned int jisdata[eci_length + 1];
-    char mode[eci_length];
-    char prev_mode[eci_length];
-#else
-    unsigned char *datastream;
-    unsigned char *fullstream;
-    unsigned char *grid;
-    unsigned int *jisdata = (unsigned int *) _alloca((eci_length + 1) * sizeof(unsigned int));
-    char *mode = (char *) _alloca(eci_length);
-    char *prev_mode = (char *) _alloca(eci_length);
-#endif
+    z_work_array(symbol, unsigned int, jisdata, eci_length + 1);
+    z_work_array(symbol, char, mode, eci_length);
+    z_work_array(symbol, char, prev_mode, eci_length);
+    z_work_array(symbol, char, class_modes, 3 * eci_length);
+
+    if (z_work_failed(jisdata) || z_work_failed(mode) || z_work_failed(prev_mode) || z_work_failed(class_modes)) {
+        return z_work_error(symbol);
+    }
 
     gs1 = ((symbol->input_mode & 0x07) == GS1_MODE);
+    fast = symbol->input_mode & FAST_MODE; /* Also once past any time budget (see `z_over_budget()`) */
     /* If ZINT_FULL_MULTIBYTE use Kanji mode in DATA_MODE or for non-Shift JIS in UNICODE_MODE */
     full_multibyte = (symbol->option_3 & 0xFF) == ZINT_FULL_MULTIBYTE;
     user_mask = (symbol->option_3 >> 8) & 0x0F; /* User mask is pattern + 1, so >= 1 and <= 8 */
@@ -1536,17 +1631,78 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
         user_mask = 0; /* Ignore */
     }
 
-    if ((symbol->input_mode & 0x07) == DATA_MODE) {
+    if (symbol->structapp.count) {
+        int parity = 0;
+        if (symbol->structapp.count < 2 || symbol->structapp.count > 16) {
+            strcpy(symbol->errtxt, "710: Structured Append count out of range (2-16)");
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        if (symbol->structapp.index < 1 || symbol->structapp.index > symbol->structapp.count) {
+            sprintf(symbol->errtxt, "711: Structured Append index out of range (1-%d)", symbol->structapp.count);
+            return ZINT_ERROR_INVALID_OPTION;
+        }
+        if (symbol->structapp.id[0]) {
+            /* ID is the parity of the whole message */
+            const int id_len = (int) strlen(symbol->structapp.id);
+            if (id_len > 3 || (parity = to_int((const unsigned char *) symbol->structapp.id, id_len)) == -1) {
+                strcpy(symbol->errtxt, "712: Invalid Structured Append ID (digits only)");
+                return ZINT_ERROR_INVALID_OPTION;
+            }
+            if (parity > 255) {
+                strcpy(symbol->errtxt, "713: Structured Append ID out of range (0-255)");
+                return ZINT_ERROR_INVALID_OPTION;
+            }
+        } else {
+            /* Default to the parity of this symbol's data */
+            for (i = 0; i < length; i++) {
+                parity ^= source[i];
+            }
+        }
+        structapp = ((symbol->structapp.index - 1) << 12) | ((symbol->structapp.count - 1) << 8) | parity;
+    }
+
+    if (symbol->internal->eci_segs) {
+        /* UNICODE_MODE data split into ECI segments (see MULTI_ECI_MODE), each converted separately (none growing) */
+        int jis_length = 0;
+        z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_BEGIN, length);
+        for (i = 0; i < symbol->internal->eci_segs->count; i++) {
+            const struct zint_eci_seg *const in_seg = symbol->internal->eci_segs->segs + i;
+            int seg_length = in_seg->length;
+            int error_number = sjis_utf8_to_eci(symbol, in_seg->eci, source + in_seg->start, &seg_length,
+                                                jisdata + jis_length, full_multibyte);
+            if (error_number != 0) {
+                if (error_number != ZINT_ERROR_MEMORY) {
+                    strcpy(symbol->errtxt, "575: Invalid characters in input data");
+                }
+                z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, -1);
+                return error_number;
+            }
+            /* ISO/IEC 8859-1 is the default interpretation so needs no ECI at the start */
+            qr_segs.segs[i].eci = i == 0 && in_seg->eci == 3 ? 0 : in_seg->eci;
+            qr_segs.segs[i].start = jis_length;
+            qr_segs.segs[i].length = seg_length;
+            jis_length += seg_length;
+        }
+        qr_segs.count = symbol->internal->eci_segs->count;
+        segs = &qr_segs;
+        length = jis_length;
+        z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, length);
+    } else if ((symbol->input_mode & 0x07) == DATA_MODE) {
         sjis_cpy(source, &length, jisdata, full_multibyte);
     } else {
         int done = 0;
+        z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_BEGIN, length);
         if (symbol->eci != 20) { /* Unless ECI 20 (Shift JIS) */
             /* Try other encodings (ECI 0 defaults to ISO/IEC 8859-1) */
-            int error_number = sjis_utf8_to_eci(symbol->eci, source, &length, jisdata, full_multibyte);
+            int error_number = sjis_utf8_to_eci(symbol, symbol->eci, source, &length, jisdata, full_multibyte);
             if (error_number == 0) {
                 done = 1;
+            } else if (error_number == ZINT_ERROR_MEMORY) {
+                z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, -1);
+                return error_number;
             } else if (symbol->eci) {
                 strcpy(symbol->errtxt, "575: Invalid characters in input data");
+                z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, -1);
                 return error_number;
             }
         }
@@ -1554,12 +1710,16 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
             /* Try Shift-JIS */
             int error_number = sjis_utf8(symbol, source, &length, jisdata);
             if (error_number != 0) {
+                z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, -1);
                 return error_number;
             }
         }
+        z_trace(symbol, ZINT_PHASE_ECI, ZINT_TRACE_END, length);
     }
 
-    est_binlen = getBinaryLength(40, mode, jisdata, length, gs1, symbol->eci, debug_print);
+    z_trace(symbol, ZINT_PHASE_MODES, ZINT_TRACE_BEGIN, length);
+    est_binlen = getBinaryLengthCached(40, mode, class_modes, class_binlens, jisdata, length, gs1, symbol->eci,
+                        segs, structapp, fast || z_over_budget(symbol), debug_print);
 
     ecc_level = LEVEL_L;
     max_cw = 2956;
@@ -1581,6 +1741,7 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
 
     if (est_binlen > (8 * max_cw)) {
         strcpy(symbol->errtxt, "561: Input too long for selected error correction level");
+        z_trace(symbol, ZINT_PHASE_MODES, ZINT_TRACE_END, -1);
         return ZINT_ERROR_TOO_LONG;
     }
 
@@ -1610,7 +1771,8 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
         }
     }
     if (autosize != 40) {
-        est_binlen = getBinaryLength(autosize, mode, jisdata, length, gs1, symbol->eci, debug_print);
+        est_binlen = getBinaryLengthCached(autosize, mode, class_modes, class_binlens, jisdata, length, gs1,
+                                symbol->eci, segs, structapp, fast || z_over_budget(symbol), debug_print);
     }
 
     // Now see if the optimised binary will fit in a smaller symbol.
@@ -1622,7 +1784,8 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
         } else {
             prev_est_binlen = est_binlen;
             memcpy(prev_mode, mode, length);
-            est_binlen = getBinaryLength(autosize - 1, mode, jisdata, length, gs1, symbol->eci, debug_print);
+            est_binlen = getBinaryLengthCached(autosize - 1, mode, class_modes, class_binlens, jisdata, length, gs1,
+                                    symbol->eci, segs, structapp, fast || z_over_budget(symbol), debug_print);
 
             switch (ecc_level) {
                 case LEVEL_L:
@@ -1667,14 +1830,17 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
          */
         if (symbol->option_2 > version) {
             version = symbol->option_2;
-            est_binlen = getBinaryLength(symbol->option_2, mode, jisdata, length, gs1, symbol->eci, debug_print);
+            est_binlen = getBinaryLengthCached(symbol->option_2, mode, class_modes, class_binlens, jisdata, length,
+                                    gs1, symbol->eci, segs, structapp, fast || z_over_budget(symbol), debug_print);
         }
 
         if (symbol->option_2 < version) {
             strcpy(symbol->errtxt, "569: Input too long for selected symbol size");
+            z_trace(symbol, ZINT_PHASE_MODES, ZINT_TRACE_END, -1);
             return ZINT_ERROR_TOO_LONG;
         }
     }
+    z_trace(symbol, ZINT_PHASE_MODES, ZINT_TRACE_END, (est_binlen + 7) / 8);
 
     /* Ensure maxium error correction capacity unless user-specified */
     if (symbol->option_1 == -1 || symbol->option_1 != ecc_level) {
@@ -1703,27 +1869,38 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
             break;
     }
 
-#ifndef _MSC_VER
-    unsigned char datastream[target_codewords + 1];
-    unsigned char fullstream[qr_total_codewords[version - 1] + 1];
-#else
-    datastream = (unsigned char *) _alloca(target_codewords + 1);
-    fullstream = (unsigned char *) _alloca(qr_total_codewords[version - 1] + 1);
-#endif
+    z_work_array(symbol, unsigned char, datastream, target_codewords + 1);
+    z_work_array(symbol, unsigned char, fullstream, qr_total_codewords[version - 1] + 1);
 
-    qr_binary(datastream, version, target_codewords, mode, jisdata, length, gs1, symbol->eci, est_binlen, debug_print);
+    if (z_work_failed(datastream) || z_work_failed(fullstream)) {
+        return z_work_error(symbol);
+    }
+
+    z_record_modes(symbol, mode, length);
+    z_record(symbol, ZINT_PHASE_ENCODE, ZINT_RECORD_SIZE, version, qr_sizes[version - 1], qr_sizes[version - 1],
+            ecc_level);
+    z_record(symbol, ZINT_PHASE_RS, ZINT_RECORD_CODEWORDS, target_codewords,
+            qr_total_codewords[version - 1] - target_codewords, (est_binlen + 7) / 8, 0);
+    if (symbol->debug & ZINT_MEASURE_ONLY) {
+        return z_measured(symbol, qr_sizes[version - 1], qr_sizes[version - 1]);
+    }
+
+    qr_binary(datastream, version, target_codewords, mode, jisdata, length, gs1, symbol->eci, segs, structapp,
+            debug_print);
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, datastream, target_codewords);
 #endif
+    z_trace(symbol, ZINT_PHASE_RS, ZINT_TRACE_BEGIN, target_codewords);
     add_ecc(fullstream, datastream, version, target_codewords, blocks, debug_print);
+    z_trace(symbol, ZINT_PHASE_RS, ZINT_TRACE_END, qr_total_codewords[version - 1]);
 
     size = qr_sizes[version - 1];
     size_squared = size * size;
-#ifndef _MSC_VER
-    unsigned char grid[size_squared];
-#else
-    grid = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
+    z_work_array(symbol, unsigned char, grid, size_squared);
+
+    if (z_work_failed(grid)) {
+        return z_work_error(symbol);
+    }
 
     memset(grid, 0, size_squared);
 
@@ -1734,7 +1911,13 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
         add_version_info(grid, size, version);
     }
 
-    bitmask = apply_bitmask(grid, size, ecc_level, user_mask, debug_print);
+    z_trace(symbol, ZINT_PHASE_MASK, ZINT_TRACE_BEGIN, size_squared);
+    bitmask = apply_bitmask(symbol, grid, size, ecc_level, user_mask, debug_print);
+    if (bitmask < 0) {
+        z_trace(symbol, ZINT_PHASE_MASK, ZINT_TRACE_END, -1);
+        return ZINT_ERROR_MEMORY;
+    }
+    z_trace(symbol, ZINT_PHASE_MASK, ZINT_TRACE_END, size_squared);
 
     add_format_info(grid, size, ecc_level, bitmask);
 
@@ -1754,77 +1937,63 @@ INTERNAL int qr_code(struct zint_symbol *symbol, unsigned char source[], int len
     return 0;
 }
 
-static void micro_qr_m1(struct zint_symbol *symbol, char binary_data[]) {
-    int i, j, latch;
+static int micro_qr_m1(struct zint_symbol *symbol, unsigned char data[], const int bp) {
+    int i, latch;
     int bits_total, bits_left;
     int data_codewords, ecc_codewords;
     unsigned char data_blocks[4], ecc_blocks[3];
     rs_t rs;
+    struct zint_bits bits;
+
+    bits_init(&bits, data, bp);
 
     bits_total = 20;
     latch = 0;
 
     /* Add terminator */
-    bits_left = bits_total - (int)strlen(binary_data);
+    bits_left = bits_total - bits.posn;
     if (bits_left <= 3) {
-        for (i = 0; i < bits_left; i++) {
-            strcat(binary_data, "0");
-        }
+        bits_append(&bits, 0, bits_left);
         latch = 1;
     } else {
-        strcat(binary_data, "000");
+        bits_append(&bits, 0, 3);
     }
 
     if (latch == 0) {
         /* Manage last (4-bit) block */
-        bits_left = bits_total - (int)strlen(binary_data);
+        bits_left = bits_total - bits.posn;
         if (bits_left <= 4) {
-            for (i = 0; i < bits_left; i++) {
-                strcat(binary_data, "0");
-            }
+            bits_append(&bits, 0, bits_left);
             latch = 1;
         }
     }
 
     if (latch == 0) {
         /* Complete current byte */
-        int remainder = 8 - (strlen(binary_data) % 8);
+        int remainder = 8 - (bits.posn % 8);
         if (remainder == 8) {
             remainder = 0;
         }
-        for (i = 0; i < remainder; i++) {
-            strcat(binary_data, "0");
-        }
+        bits_append(&bits, 0, remainder);
 
         /* Add padding */
-        bits_left = bits_total - (int)strlen(binary_data);
+        bits_left = bits_total - bits.posn;
         if (bits_left > 4) {
             remainder = (bits_left - 4) / 8;
             for (i = 0; i < remainder; i++) {
-                strcat(binary_data, (i & 1) ? "00010001" : "11101100");
+                bits_append(&bits, (i & 1) ? 0x11 : 0xEC, 8);
             }
         }
-        bin_append(0, 4, binary_data);
+        bits_append(&bits, 0, 4);
     }
 
     data_codewords = 3;
     ecc_codewords = 2;
 
-    /* Copy data into codewords */
-    for (i = 0; i < (data_codewords - 1); i++) {
-        data_blocks[i] = 0;
-        for (j = 0; j < 8; j++) {
-            if (binary_data[(i * 8) + j] == '1') {
-                data_blocks[i] |= 0x80 >> j;
-            }
-        }
-    }
-    data_blocks[2] = 0;
-    for (j = 0; j < 4; j++) {
-        if (binary_data[16 + j] == '1') {
-            data_blocks[2] |= 0x80 >> j;
-        }
-    }
+    /* Copy data into codewords, last one 4-bit */
+    (void) bits_flush(&bits);
+    memcpy(data_blocks, data, data_codewords);
+    data_blocks[2] &= 0xF0;
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, data_blocks, data_codewords);
 #else
@@ -1838,16 +2007,21 @@ static void micro_qr_m1(struct zint_symbol *symbol, char binary_data[]) {
 
     /* Add Reed-Solomon codewords to binary data */
     for (i = 0; i < ecc_codewords; i++) {
-        bin_append(ecc_blocks[ecc_codewords - i - 1], 8, binary_data);
+        bits_append(&bits, ecc_blocks[ecc_codewords - i - 1], 8);
     }
+
+    return bits_flush(&bits);
 }
 
-static void micro_qr_m2(struct zint_symbol *symbol, char binary_data[], const int ecc_mode) {
-    int i, j, latch;
+static int micro_qr_m2(struct zint_symbol *symbol, unsigned char data[], const int bp, const int ecc_mode) {
+    int i, latch;
     int bits_total=0, bits_left;
     int data_codewords=0, ecc_codewords=0;
     unsigned char data_blocks[6], ecc_blocks[7];
     rs_t rs;
+    struct zint_bits bits;
+
+    bits_init(&bits, data, bp);
 
     latch = 0;
 
@@ -1860,31 +2034,27 @@ static void micro_qr_m2(struct zint_symbol *symbol, char binary_data[], const in
     else assert(0);
 
     /* Add terminator */
-    bits_left = bits_total - (int)strlen(binary_data);
+    bits_left = bits_total - bits.posn;
     if (bits_left <= 5) {
-        for (i = 0; i < bits_left; i++) {
-            strcat(binary_data, "0");
-        }
+        bits_append(&bits, 0, bits_left);
         latch = 1;
     } else {
-        bin_append(0, 5, binary_data);
+        bits_append(&bits, 0, 5);
     }
 
     if (latch == 0) {
         /* Complete current byte */
-        int remainder = 8 - (strlen(binary_data) % 8);
+        int remainder = 8 - (bits.posn % 8);
         if (remainder == 8) {
             remainder = 0;
         }
-        for (i = 0; i < remainder; i++) {
-            strcat(binary_data, "0");
-        }
+        bits_append(&bits, 0, remainder);
 
         /* Add padding */
-        bits_left = bits_total - (int)strlen(binary_data);
+        bits_left = bits_total - bits.posn;
         remainder = bits_left / 8;
         for (i = 0; i < remainder; i++) {
-            strcat(binary_data, (i & 1) ? "00010001" : "11101100");
+            bits_append(&bits, (i & 1) ? 0x11 : 0xEC, 8);
         }
     }
 
@@ -1899,15 +2069,7 @@ static void micro_qr_m2(struct zint_symbol *symbol, char binary_data[], const in
     else assert(0);
 
     /* Copy data into codewords */
-    for (i = 0; i < data_codewords; i++) {
-        data_blocks[i] = 0;
-
-        for (j = 0; j < 8; j++) {
-            if (binary_data[(i * 8) + j] == '1') {
-                data_blocks[i] |= 0x80 >> j;
-            }
-        }
-    }
+    memcpy(data_blocks, data, data_codewords);
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, data_blocks, data_codewords);
 #else
@@ -1921,18 +2083,21 @@ static void micro_qr_m2(struct zint_symbol *symbol, char binary_data[], const in
 
     /* Add Reed-Solomon codewords to binary data */
     for (i = 0; i < ecc_codewords; i++) {
-        bin_append(ecc_blocks[ecc_codewords - i - 1], 8, binary_data);
+        bits_append(&bits, ecc_blocks[ecc_codewords - i - 1], 8);
     }
 
-    return;
+    return bits_flush(&bits);
 }
 
-static void micro_qr_m3(struct zint_symbol *symbol, char binary_data[], const int ecc_mode) {
-    int i, j, latch;
+static int micro_qr_m3(struct zint_symbol *symbol, unsigned char data[], const int bp, const int ecc_mode) {
+    int i, latch;
     int bits_total=0, bits_left;
     int data_codewords=0, ecc_codewords=0;
     unsigned char data_blocks[12], ecc_blocks[9];
     rs_t rs;
+    struct zint_bits bits;
+
+    bits_init(&bits, data, bp);
 
     latch = 0;
 
@@ -1945,46 +2110,40 @@ static void micro_qr_m3(struct zint_symbol *symbol, char binary_data[], const in
     else assert(0);
 
     /* Add terminator */
-    bits_left = bits_total - (int)strlen(binary_data);
+    bits_left = bits_total - bits.posn;
     if (bits_left <= 7) {
-        for (i = 0; i < bits_left; i++) {
-            strcat(binary_data, "0");
-        }
+        bits_append(&bits, 0, bits_left);
         latch = 1;
     } else {
-        bin_append(0, 7, binary_data);
+        bits_append(&bits, 0, 7);
     }
 
     if (latch == 0) {
         /* Manage last (4-bit) block */
-        bits_left = bits_total - (int)strlen(binary_data);
+        bits_left = bits_total - bits.posn;
         if (bits_left <= 4) {
-            for (i = 0; i < bits_left; i++) {
-                strcat(binary_data, "0");
-            }
+            bits_append(&bits, 0, bits_left);
             latch = 1;
         }
     }
 
     if (latch == 0) {
         /* Complete current byte */
-        int remainder = 8 - (strlen(binary_data) % 8);
+        int remainder = 8 - (bits.posn % 8);
         if (remainder == 8) {
             remainder = 0;
         }
-        for (i = 0; i < remainder; i++) {
-            strcat(binary_data, "0");
-        }
+        bits_append(&bits, 0, remainder);
 
         /* Add padding */
-        bits_left = bits_total - (int)strlen(binary_data);
+        bits_left = bits_total - bits.posn;
         if (bits_left > 4) {
             remainder = (bits_left - 4) / 8;
             for (i = 0; i < remainder; i++) {
-                strcat(binary_data, (i & 1) ? "00010001" : "11101100");
+                bits_append(&bits, (i & 1) ? 0x11 : 0xEC, 8);
             }
         }
-        bin_append(0, 4, binary_data);
+        bits_append(&bits, 0, 4);
     }
 
     if (ecc_mode == LEVEL_L) {
@@ -1997,34 +2156,10 @@ static void micro_qr_m3(struct zint_symbol *symbol, char binary_data[], const in
     }
     else assert(0);
 
-    /* Copy data into codewords */
-    for (i = 0; i < (data_codewords - 1); i++) {
-        data_blocks[i] = 0;
-
-        for (j = 0; j < 8; j++) {
-            if (binary_data[(i * 8) + j] == '1') {
-                data_blocks[i] |= 0x80 >> j;
-            }
-        }
-    }
-
-    if (ecc_mode == LEVEL_L) {
-        data_blocks[10] = 0;
-        for (j = 0; j < 4; j++) {
-            if (binary_data[80 + j] == '1') {
-                data_blocks[10] |= 0x80 >> j;
-            }
-        }
-    }
-
-    if (ecc_mode == LEVEL_M) {
-        data_blocks[8] = 0;
-        for (j = 0; j < 4; j++) {
-            if (binary_data[64 + j] == '1') {
-                data_blocks[8] |= 0x80 >> j;
-            }
-        }
-    }
+    /* Copy data into codewords, last one 4-bit */
+    (void) bits_flush(&bits);
+    memcpy(data_blocks, data, data_codewords);
+    data_blocks[data_codewords - 1] &= 0xF0;
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, data_blocks, data_codewords);
 #else
@@ -2038,18 +2173,21 @@ static void micro_qr_m3(struct zint_symbol *symbol, char binary_data[], const in
 
     /* Add Reed-Solomon codewords to binary data */
     for (i = 0; i < ecc_codewords; i++) {
-        bin_append(ecc_blocks[ecc_codewords - i - 1], 8, binary_data);
+        bits_append(&bits, ecc_blocks[ecc_codewords - i - 1], 8);
     }
 
-    return;
+    return bits_flush(&bits);
 }
 
-static void micro_qr_m4(struct zint_symbol *symbol, char binary_data[], const int ecc_mode) {
-    int i, j, latch;
+static int micro_qr_m4(struct zint_symbol *symbol, unsigned char data[], const int bp, const int ecc_mode) {
+    int i, latch;
     int bits_total=0, bits_left;
     int data_codewords=0, ecc_codewords=0;
     unsigned char data_blocks[17], ecc_blocks[15];
     rs_t rs;
+    struct zint_bits bits;
+
+    bits_init(&bits, data, bp);
 
     latch = 0;
 
@@ -2065,31 +2203,27 @@ static void micro_qr_m4(struct zint_symbol *symbol, char binary_data[], const in
     else assert(0);
 
     /* Add terminator */
-    bits_left = bits_total - (int)strlen(binary_data);
+    bits_left = bits_total - bits.posn;
     if (bits_left <= 9) {
-        for (i = 0; i < bits_left; i++) {
-            strcat(binary_data, "0");
-        }
+        bits_append(&bits, 0, bits_left);
         latch = 1;
     } else {
-        bin_append(0, 9, binary_data);
+        bits_append(&bits, 0, 9);
     }
 
     if (latch == 0) {
         /* Complete current byte */
-        int remainder = 8 - (strlen(binary_data) % 8);
+        int remainder = 8 - (bits.posn % 8);
         if (remainder == 8) {
             remainder = 0;
         }
-        for (i = 0; i < remainder; i++) {
-            strcat(binary_data, "0");
-        }
+        bits_append(&bits, 0, remainder);
 
         /* Add padding */
-        bits_left = bits_total - (int)strlen(binary_data);
+        bits_left = bits_total - bits.posn;
         remainder = bits_left / 8;
         for (i = 0; i < remainder; i++) {
-            strcat(binary_data, (i & 1) ? "00010001" : "11101100");
+            bits_append(&bits, (i & 1) ? 0x11 : 0xEC, 8);
         }
     }
 
@@ -2108,15 +2242,7 @@ static void micro_qr_m4(struct zint_symbol *symbol, char binary_data[], const in
     else assert(0);
 
     /* Copy data into codewords */
-    for (i = 0; i < data_codewords; i++) {
-        data_blocks[i] = 0;
-
-        for (j = 0; j < 8; j++) {
-            if (binary_data[(i * 8) + j] == '1') {
-                data_blocks[i] |= 0x80 >> j;
-            }
-        }
-    }
+    memcpy(data_blocks, data, data_codewords);
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, data_blocks, data_codewords);
 #else
@@ -2130,8 +2256,10 @@ static void micro_qr_m4(struct zint_symbol *symbol, char binary_data[], const in
 
     /* Add Reed-Solomon codewords to binary data */
     for (i = 0; i < ecc_codewords; i++) {
-        bin_append(ecc_blocks[ecc_codewords - i - 1], 8, binary_data);
+        bits_append(&bits, ecc_blocks[ecc_codewords - i - 1], 8);
     }
+
+    return bits_flush(&bits);
 }
 
 static void micro_setup_grid(unsigned char *grid, const int size) {
@@ -2160,7 +2288,6 @@ static void micro_setup_grid(unsigned char *grid, const int size) {
     }
     grid[(7 * size) + 7] = 0x10;
 
-
     /* Reserve space for format information */
     for (i = 0; i < 8; i++) {
         grid[(8 * size) + i] |= 0x20;
@@ -2169,34 +2296,25 @@ static void micro_setup_grid(unsigned char *grid, const int size) {
     grid[(8 * size) + 8] |= 20;
 }
 
-static void micro_populate_grid(unsigned char *grid, const int size, const char full_stream[]) {
+static void micro_populate_grid(unsigned char *grid, const int size, const unsigned char full_stream[], const int n) {
     int direction = 1; /* up */
     int row = 0; /* right hand side */
-    int n, i;
+    int i;
     int y;
 
-    n = strlen(full_stream);
     y = size - 1;
     i = 0;
     do {
         int x = (size - 2) - (row * 2);
 
         if (!(grid[(y * size) + (x + 1)] & 0xf0)) {
-            if (full_stream[i] == '1') {
-                grid[(y * size) + (x + 1)] = 0x01;
-            } else {
-                grid[(y * size) + (x + 1)] = 0x00;
-            }
+            grid[(y * size) + (x + 1)] = bits_is_set(full_stream, i);
             i++;
         }
 
         if (i < n) {
             if (!(grid[(y * size) + x] & 0xf0)) {
-                if (full_stream[i] == '1') {
-                    grid[(y * size) + x] = 0x01;
-                } else {
-                    grid[(y * size) + x] = 0x00;
-                }
+                grid[(y * size) + x] = bits_is_set(full_stream, i);
                 i++;
             }
         }
@@ -2255,7 +2373,8 @@ static int micro_evaluate(const unsigned char *grid, const int size, const int p
     return retval;
 }
 
-static int micro_apply_bitmask(unsigned char *grid, const int size, const int user_mask, const int debug_print) {
+static int micro_apply_bitmask(struct zint_symbol *symbol, unsigned char *grid, const int size, const int user_mask,
+            const int debug_print) {
     int x, y;
     int r, k;
     int bit;
@@ -2263,13 +2382,13 @@ static int micro_apply_bitmask(unsigned char *grid, const int size, const int us
     int best_pattern;
     int size_squared = size * size;
 
-#ifndef _MSC_VER
-    unsigned char mask[size_squared];
-    unsigned char eval[size_squared];
-#else
-    unsigned char *mask = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-    unsigned char *eval = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
+    z_work_array(symbol, unsigned char, mask, size_squared);
+    z_work_array(symbol, unsigned char, eval, size_squared);
+
+    if (z_work_failed(mask) || z_work_failed(eval)) {
+        z_work_error(symbol);
+        return -1;
+    }
 
     /* Perform data masking */
     memset(mask, 0, size_squared);
@@ -2308,16 +2427,18 @@ static int micro_apply_bitmask(unsigned char *grid, const int size, const int us
             }
         }
 
-
         /* Evaluate result */
         best_pattern = 0;
         for (pattern = 0; pattern < 4; pattern++) {
             value[pattern] = micro_evaluate(eval, size, pattern);
+            z_record(symbol, ZINT_PHASE_MASK, ZINT_RECORD_PENALTY, pattern, value[pattern], 0, 0);
             if (value[pattern] > value[best_pattern]) {
                 best_pattern = pattern;
             }
         }
     }
+    z_record(symbol, ZINT_PHASE_MASK, ZINT_RECORD_MASK, best_pattern, user_mask ? -1 : value[best_pattern],
+            !!user_mask, 0);
 
     if (debug_print) {
         printf("Mask: %d (%s)", best_pattern, user_mask ? "specified" : "automatic");
@@ -2344,7 +2465,8 @@ static int micro_apply_bitmask(unsigned char *grid, const int size, const int us
 
 INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int length) {
     int i, size, j;
-    char full_stream[200];
+    unsigned char full_stream[40];
+    int bp;
     int full_multibyte;
     int user_mask;
 
@@ -2353,13 +2475,10 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
     int alpha_used = 0, byte_or_kanji_used = 0;
     int version_valid[4];
     int binary_count[4];
-    int ecc_level, autoversion, version;
+    int ecc_level, ecc_idx, autoversion, version, mode_version = 0;
     int bitmask, format, format_full;
     int size_squared;
     int debug_print = symbol->debug & ZINT_DEBUG_PRINT;
-#ifdef _MSC_VER
-    unsigned char* grid;
-#endif
 
     if (length > 35) {
         strcpy(symbol->errtxt, "562: Input data too long");
@@ -2397,7 +2516,10 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
         sjis_cpy(source, &length, jisdata, full_multibyte);
     } else {
         /* Try ISO 8859-1 conversion first */
-        int error_number = sjis_utf8_to_eci(3, source, &length, jisdata, full_multibyte);
+        int error_number = sjis_utf8_to_eci(symbol, 3, source, &length, jisdata, full_multibyte);
+        if (error_number == ZINT_ERROR_MEMORY) {
+            return error_number;
+        }
         if (error_number != 0) {
             /* Try Shift-JIS */
             error_number = sjis_utf8(symbol, source, &length, jisdata);
@@ -2439,59 +2561,32 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
         version_valid[0] = 0;
     }
 
-    /* Determine length of binary data */
+    /* Determine length of binary data, stopping at the first version it fits as the length for a given input can
+       only grow with the version (mode and character count indicators are never narrower) */
+    ecc_idx = ecc_level == LEVEL_Q ? 2 : ecc_level == LEVEL_M ? 1 : 0;
     for (i = 0; i < 4; i++) {
         if (version_valid[i]) {
-            binary_count[i] = getBinaryLength(MICROQR_VERSION + i, mode, jisdata, length, 0 /*gs1*/, 0 /*eci*/, debug_print);
-        } else {
-            binary_count[i] = 128 + 1;
+            binary_count[i] = getBinaryLength(MICROQR_VERSION + i, mode, jisdata, length, 0 /*gs1*/, 0 /*eci*/,
+                                0 /*fast*/, debug_print);
+            mode_version = i;
+            if (binary_count[i] <= micro_qr_data_bits[i][ecc_idx]) {
+                break;
+            }
         }
     }
-
-    /* Eliminate possible versions depending on length of binary data */
-    if (binary_count[0] > 20) {
-        version_valid[0] = 0;
-    }
-    if (binary_count[1] > 40) {
-        version_valid[1] = 0;
-    }
-    if (binary_count[2] > 84) {
-        version_valid[2] = 0;
-    }
-    if (binary_count[3] > 128) {
-        strcpy(symbol->errtxt, "565: Input data too long");
-        return ZINT_ERROR_TOO_LONG;
-    }
-
-    /* Eliminate possible versions depending on binary length and error correction level specified */
-    if (ecc_level == LEVEL_Q) {
-        if (binary_count[3] > 80) {
-            strcpy(symbol->errtxt, "567: Input data too long");
+    if (i == 4) {
+        if (binary_count[3] > 128) {
+            strcpy(symbol->errtxt, "565: Input data too long");
             return ZINT_ERROR_TOO_LONG;
         }
-    } else if (ecc_level == LEVEL_M) {
-        if (binary_count[1] > 32) {
-            version_valid[1] = 0;
-        }
-        if (binary_count[2] > 68) {
-            version_valid[2] = 0;
-        }
-        if (binary_count[3] > 112) {
-            strcpy(symbol->errtxt, "568: Input data too long");
+        if (ecc_level == LEVEL_Q) {
+            strcpy(symbol->errtxt, "567: Input data too long");
             return ZINT_ERROR_TOO_LONG;
         }
+        strcpy(symbol->errtxt, "568: Input data too long");
+        return ZINT_ERROR_TOO_LONG;
     }
-
-    autoversion = 3;
-    if (version_valid[2]) {
-        autoversion = 2;
-    }
-    if (version_valid[1]) {
-        autoversion = 1;
-    }
-    if (version_valid[0]) {
-        autoversion = 0;
-    }
+    autoversion = i;
 
     version = autoversion;
     /* Get version from user */
@@ -2504,6 +2599,12 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
         }
     }
 
+    /* Modes (and length) as last determined unless user selected a larger version */
+    if (version != mode_version) {
+        binary_count[version] = getBinaryLength(MICROQR_VERSION + version, mode, jisdata, length, 0 /*gs1*/,
+                                    0 /*eci*/, 0 /*fast*/, debug_print);
+    }
+
     /* If there is enough unused space then increase the error correction level, unless user-specified */
     if (symbol->option_1 == -1 || symbol->option_1 != ecc_level) {
         if (version == 3) {
@@ -2524,35 +2625,43 @@ INTERNAL int microqr(struct zint_symbol *symbol, unsigned char source[], int len
         }
     }
 
-    qr_define_mode(mode, jisdata, length, 0 /*gs1*/, MICROQR_VERSION + version, debug_print);
+    z_record_modes(symbol, mode, length);
+    z_record(symbol, ZINT_PHASE_ENCODE, ZINT_RECORD_SIZE, version + 1, micro_qr_sizes[version],
+            micro_qr_sizes[version], ecc_level);
+    if (symbol->debug & ZINT_MEASURE_ONLY) {
+        return z_measured(symbol, micro_qr_sizes[version], micro_qr_sizes[version]);
+    }
 
-    qr_binary((unsigned char *) full_stream, MICROQR_VERSION + version, 0 /*target_codewords*/, mode, jisdata, length,
-            0 /*gs1*/, 0 /*eci*/, binary_count[version], debug_print);
+    bp = qr_binary(full_stream, MICROQR_VERSION + version, 0 /*target_codewords*/, mode, jisdata, length,
+            0 /*gs1*/, 0 /*eci*/, NULL /*segs*/, 0 /*structapp*/, debug_print);
 
     switch (version) {
-        case 0: micro_qr_m1(symbol, full_stream);
+        case 0: bp = micro_qr_m1(symbol, full_stream, bp);
             break;
-        case 1: micro_qr_m2(symbol, full_stream, ecc_level);
+        case 1: bp = micro_qr_m2(symbol, full_stream, bp, ecc_level);
             break;
-        case 2: micro_qr_m3(symbol, full_stream, ecc_level);
+        case 2: bp = micro_qr_m3(symbol, full_stream, bp, ecc_level);
             break;
-        case 3: micro_qr_m4(symbol, full_stream, ecc_level);
+        case 3: bp = micro_qr_m4(symbol, full_stream, bp, ecc_level);
             break;
     }
 
     size = micro_qr_sizes[version];
     size_squared = size * size;
-#ifndef _MSC_VER
-    unsigned char grid[size_squared];
-#else
-    grid = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
+    z_work_array(symbol, unsigned char, grid, size_squared);
+
+    if (z_work_failed(grid)) {
+        return z_work_error(symbol);
+    }
 
     memset(grid, 0, size_squared);
 
     micro_setup_grid(grid, size);
-    micro_populate_grid(grid, size, full_stream);
-    bitmask = micro_apply_bitmask(grid, size, user_mask, debug_print);
+    micro_populate_grid(grid, size, full_stream, bp);
+    bitmask = micro_apply_bitmask(symbol, grid, size, user_mask, debug_print);
+    if (bitmask < 0) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     /* Add format data */
     format = 0;
@@ -2653,22 +2762,13 @@ INTERNAL int upnqr(struct zint_symbol *symbol, unsigned char source[], int lengt
     int size_squared;
     int debug_print = symbol->debug & ZINT_DEBUG_PRINT;
 
-#ifndef _MSC_VER
-    unsigned int jisdata[length + 1];
-    char mode[length + 1];
-#else
-    unsigned char* datastream;
-    unsigned char* fullstream;
-    unsigned char* grid;
-    unsigned int* jisdata = (unsigned int *) _alloca((length + 1) * sizeof (unsigned int));
-    char* mode = (char *) _alloca(length + 1);
-#endif
+    z_work_array(symbol, unsigned int, jisdata, length + 1);
+    z_work_array(symbol, char, mode, length + 1);
+    z_work_array(symbol, unsigned char, preprocessed, length + 1);
 
-#ifndef _MSC_VER
-    unsigned char preprocessed[length + 1];
-#else
-    unsigned char* preprocessed = (unsigned char*) _alloca(length + 1);
-#endif
+    if (z_work_failed(jisdata) || z_work_failed(mode) || z_work_failed(preprocessed)) {
+        return z_work_error(symbol);
+    }
 
     symbol->eci = 4; /* Set before any processing */
 
@@ -2697,7 +2797,7 @@ INTERNAL int upnqr(struct zint_symbol *symbol, unsigned char source[], int lengt
             break;
     }
 
-    est_binlen = getBinaryLength(15, mode, jisdata, length, 0, symbol->eci, debug_print);
+    est_binlen = getBinaryLength(15, mode, jisdata, length, 0, symbol->eci, 0 /*fast*/, debug_print);
 
     ecc_level = LEVEL_M;
 
@@ -2710,27 +2810,38 @@ INTERNAL int upnqr(struct zint_symbol *symbol, unsigned char source[], int lengt
 
     target_codewords = qr_data_codewords_M[version - 1];
     blocks = qr_blocks_M[version - 1];
-#ifndef _MSC_VER
-    unsigned char datastream[target_codewords + 1];
-    unsigned char fullstream[qr_total_codewords[version - 1] + 1];
-#else
-    datastream = (unsigned char *) _alloca(target_codewords + 1);
-    fullstream = (unsigned char *) _alloca(qr_total_codewords[version - 1] + 1);
-#endif
+    z_work_array(symbol, unsigned char, datastream, target_codewords + 1);
+    z_work_array(symbol, unsigned char, fullstream, qr_total_codewords[version - 1] + 1);
+
+    if (z_work_failed(datastream) || z_work_failed(fullstream)) {
+        return z_work_error(symbol);
+    }
+
+    z_record_modes(symbol, mode, length);
+    z_record(symbol, ZINT_PHASE_ENCODE, ZINT_RECORD_SIZE, version, qr_sizes[version - 1], qr_sizes[version - 1],
+            ecc_level);
+    z_record(symbol, ZINT_PHASE_RS, ZINT_RECORD_CODEWORDS, target_codewords,
+            qr_total_codewords[version - 1] - target_codewords, (est_binlen + 7) / 8, 0);
+    if (symbol->debug & ZINT_MEASURE_ONLY) {
+        return z_measured(symbol, qr_sizes[version - 1], qr_sizes[version - 1]);
+    }
 
-    qr_binary(datastream, version, target_codewords, mode, jisdata, length, 0, symbol->eci, est_binlen, debug_print);
+    qr_binary(datastream, version, target_codewords, mode, jisdata, length, 0, symbol->eci, NULL /*segs*/,
+            0 /*structapp*/, debug_print);
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, datastream, target_codewords);
 #endif
+    z_trace(symbol, ZINT_PHASE_RS, ZINT_TRACE_BEGIN, target_codewords);
     add_ecc(fullstream, datastream, version, target_codewords, blocks, debug_print);
+    z_trace(symbol, ZINT_PHASE_RS, ZINT_TRACE_END, qr_total_codewords[version - 1]);
 
     size = qr_sizes[version - 1];
     size_squared = size * size;
-#ifndef _MSC_VER
-    unsigned char grid[size_squared];
-#else
-    grid = (unsigned char *) _alloca(size_squared * sizeof (unsigned char));
-#endif
+    z_work_array(symbol, unsigned char, grid, size_squared);
+
+    if (z_work_failed(grid)) {
+        return z_work_error(symbol);
+    }
 
     memset(grid, 0, size_squared);
 
@@ -2739,7 +2850,13 @@ INTERNAL int upnqr(struct zint_symbol *symbol, unsigned char source[], int lengt
 
     add_version_info(grid, size, version);
 
-    bitmask = apply_bitmask(grid, size, ecc_level, 0 /*user_mask*/, debug_print);
+    z_trace(symbol, ZINT_PHASE_MASK, ZINT_TRACE_BEGIN, size_squared);
+    bitmask = apply_bitmask(symbol, grid, size, ecc_level, 0 /*user_mask*/, debug_print);
+    if (bitmask < 0) {
+        z_trace(symbol, ZINT_PHASE_MASK, ZINT_TRACE_END, -1);
+        return ZINT_ERROR_MEMORY;
+    }
+    z_trace(symbol, ZINT_PHASE_MASK, ZINT_TRACE_END, size_squared);
 
     add_format_info(grid, size, ecc_level, bitmask);
 
@@ -2761,7 +2878,7 @@ INTERNAL int upnqr(struct zint_symbol *symbol, unsigned char source[], int lengt
 
 static void setup_rmqr_grid(unsigned char* grid, const int h_size, const int v_size) {
     int i, j;
-    char alignment[] = {0x1F, 0x11, 0x15, 0x11, 0x1F};
+    static const char alignment[] = {0x1F, 0x11, 0x15, 0x11, 0x1F};
     int h_version, finder_position;
 
     /* Add timing patterns - top and bottom */
@@ -2874,27 +2991,44 @@ static void setup_rmqr_grid(unsigned char* grid, const int h_size, const int v_s
 }
 
 /* rMQR according to 2018 draft standard */
+/* rMQR sizes with the same character count indicator bits (see `rmqr_cci_class[]`) have the same optimal modes and
+   binary length, so as for QR Code calculate them once per class, caching them in `class_modes` and `class_binlens`
+   (initially -1) */
+static int rmqr_binlen_cached(const int version, char mode[], char class_modes[], int class_binlens[RMQR_CCI_CLASSES],
+            const unsigned int jisdata[], const int length, const int gs1, const int fast, const int debug_print) {
+    const int class_idx = rmqr_cci_class[version];
+    char *const class_mode = class_modes + class_idx * length;
+
+    if (class_binlens[class_idx] == -1) {
+        class_binlens[class_idx] = getBinaryLength(RMQR_VERSION + version, class_mode, jisdata, length, gs1,
+                                    0 /*eci*/, fast, debug_print);
+    }
+    memcpy(mode, class_mode, length);
+
+    return class_binlens[class_idx];
+}
+
 INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length) {
     int i, j, est_binlen;
-    int ecc_level, autosize, version, max_cw, target_codewords, blocks, h_size, v_size;
+    int class_binlens[RMQR_CCI_CLASSES];
+    int ecc_level, version, max_cw, target_codewords, blocks, h_size, v_size;
     int gs1;
+    int fast;
     int full_multibyte;
-    int footprint, best_footprint, format_data;
+    int format_data;
     unsigned int left_format_info, right_format_info;
     int debug_print = symbol->debug & ZINT_DEBUG_PRINT;
 
-#ifndef _MSC_VER
-    unsigned int jisdata[length + 1];
-    char mode[length + 1];
-#else
-    unsigned char* datastream;
-    unsigned char* fullstream;
-    unsigned char* grid;
-    unsigned int* jisdata = (unsigned int *) _alloca((length + 1) * sizeof (unsigned int));
-    char* mode = (char *) _alloca(length + 1);
-#endif
+    z_work_array(symbol, unsigned int, jisdata, length + 1);
+    z_work_array(symbol, char, mode, length + 1);
+    z_work_array(symbol, char, class_modes, RMQR_CCI_CLASSES * length);
+
+    if (z_work_failed(jisdata) || z_work_failed(mode) || z_work_failed(class_modes)) {
+        return z_work_error(symbol);
+    }
 
     gs1 = ((symbol->input_mode & 0x07) == GS1_MODE);
+    fast = symbol->input_mode & FAST_MODE; /* Also once past any time budget (see `z_over_budget()`) */
     /* If ZINT_FULL_MULTIBYTE use Kanji mode in DATA_MODE or for non-Shift JIS in UNICODE_MODE */
     full_multibyte = (symbol->option_3 & 0xFF) == ZINT_FULL_MULTIBYTE;
 
@@ -2902,7 +3036,10 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
         sjis_cpy(source, &length, jisdata, full_multibyte);
     } else {
         /* Try ISO 8859-1 conversion first */
-        int error_number = sjis_utf8_to_eci(3, source, &length, jisdata, full_multibyte);
+        int error_number = sjis_utf8_to_eci(symbol, 3, source, &length, jisdata, full_multibyte);
+        if (error_number == ZINT_ERROR_MEMORY) {
+            return error_number;
+        }
         if (error_number != 0) {
             /* Try Shift-JIS */
             error_number = sjis_utf8(symbol, source, &length, jisdata);
@@ -2912,7 +3049,11 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
         }
     }
 
-    est_binlen = getBinaryLength(RMQR_VERSION + 31, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+    for (i = 0; i < RMQR_CCI_CLASSES; i++) {
+        class_binlens[i] = -1;
+    }
+    est_binlen = rmqr_binlen_cached(31, mode, class_modes, class_binlens, jisdata, length, gs1,
+                    fast || z_over_budget(symbol), debug_print);
 
     ecc_level = LEVEL_M;
     max_cw = 152;
@@ -2944,54 +3085,43 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
     version = 31; // Set default to keep compiler happy
 
     if (symbol->option_2 == 0) {
-        // Automatic symbol size
-        autosize = 31;
-        best_footprint = rmqr_height[31] * rmqr_width[31];
-        for (version = 30; version >= 0; version--) {
-            est_binlen = getBinaryLength(RMQR_VERSION + version, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
-            footprint = rmqr_height[version] * rmqr_width[version];
-            if (ecc_level == LEVEL_M) {
-                if (8 * rmqr_data_codewords_M[version] >= est_binlen) {
-                    if (footprint < best_footprint) {
-                        autosize = version;
-                        best_footprint = footprint;
-                    }
-                }
-            } else {
-                if (8 * rmqr_data_codewords_H[version] >= est_binlen) {
-                    if (footprint < best_footprint) {
-                        autosize = version;
-                        best_footprint = footprint;
-                    }
-                }
+        // Automatic symbol size, smallest area that fits
+        for (i = 0; i < 31; i++) {
+            version = rmqr_area_order[i];
+            est_binlen = rmqr_binlen_cached(version, mode, class_modes, class_binlens, jisdata, length, gs1,
+                            fast || z_over_budget(symbol), debug_print);
+            if (8 * (ecc_level == LEVEL_M ? rmqr_data_codewords_M[version] : rmqr_data_codewords_H[version])
+                    >= est_binlen) {
+                break;
             }
         }
-        version = autosize;
-        est_binlen = getBinaryLength(RMQR_VERSION + version, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+        if (i == 31) {
+            version = 31;
+            est_binlen = rmqr_binlen_cached(version, mode, class_modes, class_binlens, jisdata, length, gs1,
+                            fast || z_over_budget(symbol), debug_print);
+        }
     }
 
     if ((symbol->option_2 >= 1) && (symbol->option_2 <= 32)) {
         // User specified symbol size
         version = symbol->option_2 - 1;
-        est_binlen = getBinaryLength(RMQR_VERSION + version, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+        est_binlen = rmqr_binlen_cached(version, mode, class_modes, class_binlens, jisdata, length, gs1,
+                        fast || z_over_budget(symbol), debug_print);
     }
 
     if (symbol->option_2 >= 33) {
-        // User has specified symbol height only
-        version = rmqr_fixed_height_upper_bound[symbol->option_2 - 32];
-        for(i = version - 1; i > rmqr_fixed_height_upper_bound[symbol->option_2 - 33]; i--) {
-            est_binlen = getBinaryLength(RMQR_VERSION + i, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
-            if (ecc_level == LEVEL_M) {
-                if (8 * rmqr_data_codewords_M[i] >= est_binlen) {
-                    version = i;
-                }
-            } else {
-                if (8 * rmqr_data_codewords_H[i] >= est_binlen) {
-                    version = i;
-                }
+        // User has specified symbol height only, narrowest that fits
+        for (version = rmqr_fixed_height_upper_bound[symbol->option_2 - 33] + 1;
+                version < rmqr_fixed_height_upper_bound[symbol->option_2 - 32]; version++) {
+            est_binlen = rmqr_binlen_cached(version, mode, class_modes, class_binlens, jisdata, length, gs1,
+                            fast || z_over_budget(symbol), debug_print);
+            if (8 * (ecc_level == LEVEL_M ? rmqr_data_codewords_M[version] : rmqr_data_codewords_H[version])
+                    >= est_binlen) {
+                break;
             }
         }
-        est_binlen = getBinaryLength(RMQR_VERSION + version, mode, jisdata, length, gs1, 0 /*eci*/, debug_print);
+        est_binlen = rmqr_binlen_cached(version, mode, class_modes, class_binlens, jisdata, length, gs1,
+                        fast || z_over_budget(symbol), debug_print);
     }
 
     if (symbol->option_1 == -1) {
@@ -3027,15 +3157,24 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
         printf("Number of ECC blocks = %d\n", blocks);
     }
 
-#ifndef _MSC_VER
-    unsigned char datastream[target_codewords + 1];
-    unsigned char fullstream[rmqr_total_codewords[version] + 1];
-#else
-    datastream = (unsigned char *) _alloca((target_codewords + 1) * sizeof (unsigned char));
-    fullstream = (unsigned char *) _alloca((rmqr_total_codewords[version] + 1) * sizeof (unsigned char));
-#endif
+    z_work_array(symbol, unsigned char, datastream, target_codewords + 1);
+    z_work_array(symbol, unsigned char, fullstream, rmqr_total_codewords[version] + 1);
+
+    if (z_work_failed(datastream) || z_work_failed(fullstream)) {
+        return z_work_error(symbol);
+    }
+
+    z_record_modes(symbol, mode, length);
+    z_record(symbol, ZINT_PHASE_ENCODE, ZINT_RECORD_SIZE, version + 1, rmqr_height[version], rmqr_width[version],
+            ecc_level);
+    z_record(symbol, ZINT_PHASE_RS, ZINT_RECORD_CODEWORDS, target_codewords,
+            rmqr_total_codewords[version] - target_codewords, (est_binlen + 7) / 8, 0);
+    if (symbol->debug & ZINT_MEASURE_ONLY) {
+        return z_measured(symbol, rmqr_height[version], rmqr_width[version]);
+    }
 
-    qr_binary(datastream, RMQR_VERSION + version, target_codewords, mode, jisdata, length, gs1, 0 /*eci*/, est_binlen, debug_print);
+    qr_binary(datastream, RMQR_VERSION + version, target_codewords, mode, jisdata, length, gs1, 0 /*eci*/,
+            NULL /*segs*/, 0 /*structapp*/, debug_print);
 #ifdef ZINT_TEST
     if (symbol->debug & ZINT_DEBUG_TEST) debug_test_codeword_dump(symbol, datastream, target_codewords);
 #endif
@@ -3044,11 +3183,11 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
     h_size = rmqr_width[version];
     v_size = rmqr_height[version];
 
-#ifndef _MSC_VER
-    unsigned char grid[h_size * v_size];
-#else
-    grid = (unsigned char *) _alloca((h_size * v_size) * sizeof (unsigned char));
-#endif
+    z_work_array(symbol, unsigned char, grid, h_size * v_size);
+
+    if (z_work_failed(grid)) {
+        return z_work_error(symbol);
+    }
 
     memset(grid, 0, h_size * v_size);
 
@@ -3094,7 +3233,6 @@ INTERNAL int rmqr(struct zint_symbol *symbol, unsigned char source[], int length
     grid[(h_size * (v_size - 6)) + (h_size - 4)] = (right_format_info >> 16) & 0x01;
     grid[(h_size * (v_size - 6)) + (h_size - 3)] = (right_format_info >> 17) & 0x01;
 
-
     symbol->width = h_size;
     symbol->rows = v_size;
 
@@ -130,6 +130,23 @@ static const unsigned short int rmqr_total_codewords[] = {
 };
 
 
+/* rMQR sizes with the same character count indicator bits for all modes share a class (first appearance order) */
+#define RMQR_CCI_CLASSES 13
+static const unsigned char rmqr_cci_class[] = {
+    0, 1, 2, 3, 4, // R7x
+    1, 2, 3, 4, 5, // R9x
+    6, 2, 3, 4, 5, 7, // R11x
+    1, 3, 4, 5, 7, 8, // R13x
+    4, 9, 7, 7, 10, // R15x
+    4, 5, 7, 11, 12 // R17x
+};
+
+/* rMQR sizes by ascending area, ties (R7x99, R9x77) going to the taller */
+static const unsigned char rmqr_area_order[] = {
+    10, 0, 16, 5, 1, 11, 6, 2, 17, 22, 12, 7, 3, 27, 18, 13,
+    23, 8, 4, 19, 28, 14, 24, 9, 20, 29, 25, 15, 30, 21, 26, 31
+};
+
 static const unsigned short int rmqr_numeric_cci[] = {
     4, 5, 6, 7, 7,
     5, 6, 7, 7, 8,
@@ -213,6 +230,11 @@ static const char micro_qr_sizes[] = {
     11, 13, 15, 17
 };
 
+/* Data capacity in bits of M1 to M4 at error correction levels L, M and Q (0 if not available) */
+static const unsigned char micro_qr_data_bits[4][3] = {
+    { 20, 0, 0 }, { 40, 32, 0 }, { 84, 68, 0 }, { 128, 112, 80 }
+};
+
 static const char qr_align_loopsize[] = {
     0, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7
 };
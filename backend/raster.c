@@ -39,6 +39,7 @@
 #include <malloc.h>
 #include <fcntl.h>
 #include <io.h>
+#include "ms_stdint.h"
 /* ceilf, floorf, roundf not before MSVC++2013 (C++ 12.0) */
 #if _MSC_VER < 1800
 #define ceilf (float) ceil
@@ -49,10 +50,13 @@
 #if _MSC_VER == 1200
 #pragma warning(disable: 4244)
 #endif
+#else
+#include <stdint.h>
 #endif /* _MSC_VER */
 
 #include "common.h"
 #include "output.h"
+#include "raster.h"
 #include "zfiletypes.h"
 
 #include "font.h" /* Font for human readable text */
@@ -62,212 +66,1030 @@
 
 #define UPCEAN_TEXT     1
 
-#ifndef NO_PNG
 INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
-#endif /* NO_PNG */
 INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
 INTERNAL int pcx_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+INTERNAL int pbm_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+INTERNAL int pgm_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+INTERNAL int zpl_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+INTERNAL int epl_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+INTERNAL int pcl_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+INTERNAL int qoi_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
 INTERNAL int gif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
 INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
 
+/* Formats left out of the build (see ZINT_OUTPUTS in "CMakeLists.txt") */
+#ifdef ZINT_NO_OUT_PNG
+#define png_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#define png_plot_rows(symbol, rows) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_BMP
+#define bmp_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#define bmp_plot_rows(symbol, rows) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_TIF
+#define tif_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#define tif_plot_rows(symbol, rows) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_PCX
+#define pcx_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_PNM
+#define pbm_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#define pgm_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_PRN
+#define zpl_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#define epl_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#define pcl_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_QOI
+#define qoi_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_GIF
+#define gif_pixel_plot(symbol, pixelbuf) output_excluded(symbol)
+#endif
+
 static const char ultra_colour[] = "0CBMRYGKW";
 
-static int buffer_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
-    /* Place pixelbuffer into symbol */
-    int fgalpha, bgalpha;
-    unsigned char fg[3], bg[3];
-    unsigned char white[3] =   { 0xff, 0xff, 0xff };
-    unsigned char cyan[3] =    {    0, 0xff, 0xff };
-    unsigned char blue[3] =    {    0,    0, 0xff };
-    unsigned char magenta[3] = { 0xff,    0, 0xff };
-    unsigned char red[3] =     { 0xff,    0,    0 };
-    unsigned char yellow[3] =  { 0xff, 0xff,    0 };
-    unsigned char green[3] =   {    0, 0xff,    0 };
-    unsigned char black[3] =   {    0,    0,    0 };
-    unsigned char *map[91] = {
-        NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* 0x00-0F */
-        NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* 0x10-1F */
-        NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* 0x20-2F */
-        bg, fg, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* 0-9 */
-        NULL, NULL, NULL, NULL, NULL, NULL, NULL, /* :;<=>?@ */
-        NULL, blue, cyan, NULL, NULL, NULL, green, NULL, NULL, NULL, black, NULL, magenta, /* A-M */
-        NULL, NULL, NULL, NULL, red, NULL, NULL, NULL, NULL, white, NULL, yellow, NULL /* N-Z */
-    };
-    int row, column;
-    int plot_alpha = 0;
-    unsigned char *bitmap;
+#define RASTER_TILE     32 /* Side of tiles rotated 90/270 degrees at a time */
+
+#define RASTER_BAND_PIXELS  0x100000 /* Least pixels of a band of lines rendered in parallel (RASTER_PARALLEL) */
+#define RASTER_THREADS      8        /* Most bands rendered at once */
+
+/* Scratch buffer slots */
+#define RASTER_PIXELBUF     0 /* Unscaled (or half-integer scaled) image */
+#define RASTER_SCALED       1 /* Dotty mode image, or for MaxiCode the scaled hexagon */
+#define RASTER_OUTPUT       2 /* Scaled and/or rotated image */
+#define RASTER_REMAP        3 /* Scaling maps (see `remap_init()`) */
+#define RASTER_BITMAP       4 /* Lent to `symbol->bitmap` */
+#define RASTER_ALPHAMAP     5 /* Lent to `symbol->alphamap` */
+#define RASTER_STAMP        6 /* Cached MaxiCode hexagon or dotty mode dot (see `raster_stamp()`) */
+#define RASTER_ROTATE       7 /* Row and column flags for 90/270 degree rotation (see `remap_rotate()`) */
+#define RASTER_ANTIALIAS    8 /* Anti-aliased scaled image (see `raster_antialias()`) */
+#define RASTER_SHEET        9 /* Pixelbuffer of a sheet (see `plot_raster_sheet()`) */
+#define RASTER_ROW_LINES    10 /* Line of each row of a 4-state symbol (see `plot_4state_lines()`) */
+#define RASTER_FORMAT_BUF   11 /* Output format work buffers (see `raster_output_buffer()`) */
+#define RASTER_FORMAT_NUM   2
+#define RASTER_SCRATCH_NUM  (RASTER_FORMAT_BUF + RASTER_FORMAT_NUM)
+
+/* Fonts, each with its own glyph cache */
+#define RASTER_FONT_NORMAL          0
+#define RASTER_FONT_BOLD            1
+#define RASTER_FONT_SMALL           2
+#define RASTER_FONT_UPCEAN          3
+#define RASTER_FONT_UPCEAN_SMALL    4
+#define RASTER_FONT_NUM             5
+
+#define RASTER_GLYPH_NUM    189 /* 33 to 126 and 161 to 255 */
+
+#define RASTER_PALETTE      91 /* Pixelbuffer values up to 'Z' */
+
+#define RASTER_PIXEL_VALUES 0 /* Internal target format, pixelbuffer values as is (see `plot_raster_sheet()`) */
+
+/* Kinds of stamp */
+#define RASTER_STAMP_HEXAGON    1
+#define RASTER_STAMP_CIRCLE     2
+
+/* Working buffers owned by the symbol and kept across calls, so that rendering same-size symbols repeatedly
+   doesn't allocate. Only freed by `ZBarcode_Delete()` */
+struct zint_scratch {
+    unsigned char *buf[RASTER_SCRATCH_NUM];
+    size_t size[RASTER_SCRATCH_NUM];
+    int stamp_kind; /* RASTER_STAMP_XXX of stamp in `buf[RASTER_STAMP]`, 0 if none */
+    float stamp_size; /* Scale (hexagon) or radius (circle) stamp made for */
+    int stamp_runs; /* Number of `struct raster_run`s in stamp */
+    struct raster_font *fonts[RASTER_FONT_NUM]; /* Glyph caches, allocated as needed (see `raster_glyph()`) */
+    void *output_context; /* Output format state kept across calls (see `raster_output_context()`) */
+    void (*output_context_free)(void *context);
+};
+
+/* Horizontal run of ink in a stamp, relative to its top left */
+struct raster_run {
+    int row;
+    int start;
+    int len;
+};
+
+/* Glyphs of a font pre-rendered as runs for text scale `si`, each made when first drawn */
+struct raster_font {
+    int si; /* Scale glyphs made for */
+    int first[RASTER_GLYPH_NUM]; /* Index of glyph's first run in `runs` */
+    int count[RASTER_GLYPH_NUM]; /* Number of runs in glyph, -1 if not made yet */
+    struct raster_run *runs;
+    int runs_size; /* Allocated */
+    int runs_used;
+};
+
+/* Return scratch buffer `slot` of at least `size` bytes, allocating or growing it if necessary (contents are not
+   preserved) */
+static unsigned char *raster_scratch(struct zint_symbol *symbol, const int slot, const size_t size) {
+    struct zint_scratch *scratch = symbol->internal->scratch;
+
+    if (!scratch) {
+        if (!(scratch = (struct zint_scratch *) z_calloc(z_allocator(symbol), 1, sizeof(*scratch)))) {
+            return NULL;
+        }
+        symbol->internal->scratch = scratch;
+    }
+    if (scratch->size[slot] < size) {
+        z_free(z_allocator(symbol), scratch->buf[slot]);
+        if (!(scratch->buf[slot] = (unsigned char *) z_malloc(z_allocator(symbol), size))) {
+            scratch->size[slot] = 0;
+            return NULL;
+        }
+        scratch->size[slot] = size;
+    }
+    return scratch->buf[slot];
+}
 
-    fg[0] = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
-    fg[1] = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
-    fg[2] = (16 * ctoi(symbol->fgcolour[4])) + ctoi(symbol->fgcolour[5]);
-    bg[0] = (16 * ctoi(symbol->bgcolour[0])) + ctoi(symbol->bgcolour[1]);
-    bg[1] = (16 * ctoi(symbol->bgcolour[2])) + ctoi(symbol->bgcolour[3]);
-    bg[2] = (16 * ctoi(symbol->bgcolour[4])) + ctoi(symbol->bgcolour[5]);
+/* Return output format work buffer `index` (0 to RASTER_FORMAT_NUM - 1) of at least `size` bytes, kept with the
+   scratch buffers so that printing again needs no allocation (NULL on failure, contents are not preserved) */
+INTERNAL unsigned char *raster_output_buffer(struct zint_symbol *symbol, const int index, const size_t size) {
+    return raster_scratch(symbol, RASTER_FORMAT_BUF + index, size);
+}
 
-    if (strlen(symbol->fgcolour) > 6) {
-        fgalpha = (16 * ctoi(symbol->fgcolour[6])) + ctoi(symbol->fgcolour[7]);
-        plot_alpha = 1;
-    } else {
-        fgalpha = 0xff;
-    }
+/* Return slot for output format state kept with the scratch buffers, allocating them if necessary (NULL on
+   failure). `free_fn` is called on any state left in the slot when they're freed */
+INTERNAL void **raster_output_context(struct zint_symbol *symbol, void (*free_fn)(void *context)) {
+    struct zint_scratch *scratch = symbol->internal->scratch;
 
-    if (strlen(symbol->bgcolour) > 6) {
-        bgalpha = (16 * ctoi(symbol->bgcolour[6])) + ctoi(symbol->bgcolour[7]);
-        plot_alpha = 1;
-    } else {
-        bgalpha = 0xff;
+    if (!scratch) {
+        if (!(scratch = (struct zint_scratch *) z_calloc(z_allocator(symbol), 1, sizeof(*scratch)))) {
+            return NULL;
+        }
+        symbol->internal->scratch = scratch;
     }
+    scratch->output_context_free = free_fn;
+    return &scratch->output_context;
+}
+
+/* Release `symbol->bitmap` and `symbol->alphamap`, freeing them unless lent from the scratch buffers */
+INTERNAL void raster_release_bitmap(struct zint_symbol *symbol) {
+    const struct zint_scratch *scratch = symbol->internal->scratch;
 
-    /* Free any previous bitmap */
     if (symbol->bitmap != NULL) {
-        free(symbol->bitmap);
+        if (!scratch || symbol->bitmap != scratch->buf[RASTER_BITMAP]) {
+            z_free(z_allocator(symbol), symbol->bitmap);
+        }
         symbol->bitmap = NULL;
     }
     if (symbol->alphamap != NULL) {
-        free(symbol->alphamap);
+        if (!scratch || symbol->alphamap != scratch->buf[RASTER_ALPHAMAP]) {
+            z_free(z_allocator(symbol), symbol->alphamap);
+        }
         symbol->alphamap = NULL;
     }
+}
+
+/* Free the scratch buffers (`symbol->bitmap` and `symbol->alphamap` should be released first) */
+INTERNAL void raster_free_scratch(struct zint_symbol *symbol) {
+    struct zint_scratch *scratch = symbol->internal->scratch;
+
+    if (scratch) {
+        int i;
+        for (i = 0; i < RASTER_SCRATCH_NUM; i++) {
+            z_free(z_allocator(symbol), scratch->buf[i]);
+        }
+        for (i = 0; i < RASTER_FONT_NUM; i++) {
+            if (scratch->fonts[i]) {
+                z_free(z_allocator(symbol), scratch->fonts[i]->runs);
+                z_free(z_allocator(symbol), scratch->fonts[i]);
+            }
+        }
+        if (scratch->output_context) {
+            scratch->output_context_free(scratch->output_context);
+        }
+        z_free(z_allocator(symbol), scratch);
+        symbol->internal->scratch = NULL;
+    }
+}
+
+/* Mapping of output (scaled and rotated) pixels to image pixels, set up by `remap_init()` */
+struct remap {
+    int rotate_angle;
+    int image_width;
+    int image_height;
+    int scale_width; /* Dimensions after scaling, before rotation */
+    int scale_height;
+    const int *xmap; /* Image column of each scaled column */
+    const int *yoff; /* Image row offset (row * image_width) of each scaled row */
+};
+
+/* Set up scaling maps, `scaler` zero meaning no scaling. Returns 0 if out of memory */
+static int remap_init(struct zint_symbol *symbol, struct remap *rm, const int image_width, const int image_height,
+            const float scaler, const int rotate_angle) {
+    int *xmap, *yoff;
+    int i;
+
+    rm->rotate_angle = rotate_angle;
+    rm->image_width = image_width;
+    rm->image_height = image_height;
+    rm->scale_width = scaler ? (int) (image_width * scaler) : image_width;
+    rm->scale_height = scaler ? (int) (image_height * scaler) : image_height;
+
+    xmap = (int *) raster_scratch(symbol, RASTER_REMAP, sizeof(int) * (rm->scale_width + rm->scale_height));
+    if (!xmap) {
+        return 0;
+    }
+    yoff = xmap + rm->scale_width;
+    for (i = 0; i < rm->scale_width; i++) {
+        xmap[i] = scaler ? (int) (i / scaler) : i;
+    }
+    for (i = 0; i < rm->scale_height; i++) {
+        yoff[i] = (scaler ? (int) (i / scaler) : i) * image_width;
+    }
+    rm->xmap = xmap;
+    rm->yoff = yoff;
+
+    return 1;
+}
+
+/* Set up output row `row`: its pixel at column `x` is `pixelbuf[base + inner[start + x * step]]` */
+static const int *remap_row(const struct remap *rm, const int row, int *p_base, int *p_start, int *p_step) {
+    switch (rm->rotate_angle) {
+        case 90: /* Output row is scaled column, running up the scaled rows */
+            *p_base = rm->xmap[row];
+            *p_start = rm->scale_height - 1;
+            *p_step = -1;
+            return rm->yoff;
+        case 180:
+            *p_base = rm->yoff[rm->scale_height - 1 - row];
+            *p_start = rm->scale_width - 1;
+            *p_step = -1;
+            return rm->xmap;
+        case 270: /* Output row is scaled column (from the right), running down the scaled rows */
+            *p_base = rm->xmap[rm->scale_width - 1 - row];
+            *p_start = 0;
+            *p_step = 1;
+            return rm->yoff;
+    }
+    *p_base = rm->yoff[row];
+    *p_start = 0;
+    *p_step = 1;
+    return rm->xmap;
+}
+
+/* Whether output row with image row offset `base` is the same as the previous one, of offset `prev_base` (-1 if
+   none). Only for rotations 0 and 180, where output rows are (scaled) image rows, so repeat if the image rows do.
+   Typically true for most of linear symbols, allowing the previous output row to be copied */
+static int remap_repeats(const struct remap *rm, const unsigned char *pixelbuf, const int base, const int prev_base) {
+    return prev_base != -1 && (rm->rotate_angle == 0 || rm->rotate_angle == 180)
+            && (base == prev_base || memcmp(pixelbuf + base, pixelbuf + prev_base, rm->image_width) == 0);
+}
+
+/* Set up `rows` for complete image `pixelbuf` */
+INTERNAL void raster_rows_image(struct raster_rows *rows, const struct zint_symbol *symbol,
+            const unsigned char *pixelbuf) {
+    memset(rows, 0, sizeof(*rows));
+    rows->image = pixelbuf;
+    rows->width = symbol->bitmap_width;
+}
+
+/* Set up `rows` to be made from `pixelbuf` as mapped by `rm`, a row at a time for rotations 0 and 180, and in
+   bands of RASTER_TILE rows for 90 and 270 (so that reads down the image columns stay in cache). Returns 0 if out
+   of memory */
+static int raster_rows_remap(struct zint_symbol *symbol, struct raster_rows *rows, const struct remap *rm,
+            const unsigned char *pixelbuf) {
+    const int band_rows = rm->rotate_angle == 90 || rm->rotate_angle == 270 ? RASTER_TILE : 1;
+    const size_t band_size = (size_t) band_rows * symbol->bitmap_width;
+
+    memset(rows, 0, sizeof(*rows));
+    if (!(rows->band[0] = raster_scratch(symbol, RASTER_OUTPUT, band_size * 2))) {
+        return 0;
+    }
+    rows->band[1] = rows->band[0] + band_size;
+    rows->band_start[0] = rows->band_start[1] = -1;
+    rows->pixelbuf = pixelbuf;
+    rows->rm = rm;
+    rows->width = symbol->bitmap_width;
+    rows->band_rows = band_rows;
+    rows->prev_base = -1;
+    return 1;
+}
+
+/* Return row `row` of the image. The row returned by the previous call remains valid */
+INTERNAL const unsigned char *raster_rows_get(struct raster_rows *rows, const int row) {
+    const struct remap *rm = rows->rm;
+    const int width = rows->width;
+    const int *inner;
+    unsigned char *out;
+    int base, start, step;
+    int column, i;
+
+    if (rows->image) {
+        return rows->image + (size_t) row * width;
+    }
+    if (rows->band_start[rows->cur] != -1 && row >= rows->band_start[rows->cur]
+            && row < rows->band_start[rows->cur] + rows->band_rows) {
+        return rows->band[rows->cur] + (size_t) (row - rows->band_start[rows->cur]) * width;
+    }
+
+    if (rows->band_rows == 1) { /* Rotation 0 or 180 */
+        inner = remap_row(rm, row, &base, &start, &step);
+        if (remap_repeats(rm, rows->pixelbuf, base, rows->prev_base)) {
+            /* Same as the row in the current band, so just relabel it */
+            rows->band_start[rows->cur] = row;
+            return rows->band[rows->cur];
+        }
+        rows->cur ^= 1;
+        rows->band_start[rows->cur] = row;
+        rows->prev_base = base;
+        out = rows->band[rows->cur];
+        for (column = 0, i = start; column < width; column++, i += step) {
+            out[column] = rows->pixelbuf[base + inner[i]];
+        }
+        return out;
+    }
 
-    symbol->bitmap = (unsigned char *) malloc((size_t) symbol->bitmap_width * symbol->bitmap_height * 3);
+    /* Rotation 90 or 270, make the band's rows (image columns) going down the image */
+    {
+        const int band_start = row - row % rows->band_rows;
+        const int band_end = band_start + rows->band_rows < rm->scale_width ? band_start + rows->band_rows
+                                : rm->scale_width;
+        int bases[RASTER_TILE];
+        int r;
+
+        rows->cur ^= 1;
+        rows->band_start[rows->cur] = band_start;
+        out = rows->band[rows->cur];
+        inner = NULL;
+        for (r = band_start; r < band_end; r++) {
+            inner = remap_row(rm, r, &bases[r - band_start], &start, &step);
+        }
+        for (column = 0, i = start; column < width; column++, i += step) {
+            const unsigned char *const pb = rows->pixelbuf + inner[i];
+            unsigned char *o = out + column;
+            for (r = 0; r < band_end - band_start; r++, o += width) {
+                *o = pb[bases[r]];
+            }
+        }
+        return out + (size_t) (row - band_start) * width;
+    }
+}
+
+/* Rotate (and scale) pixelbuffer 90 or 270 degrees into `out`. Output rows are image columns, so an output row is
+   a copy of the one above if from the same image column, or from an identical neighbouring one, found in a single
+   row-wise pass. Only the other rows are transposed, in square tiles so that reads down the image columns stay in
+   cache, then the copies are filled in. Returns 0 if out of memory */
+static int remap_rotate(struct zint_symbol *symbol, const struct remap *rm, const unsigned char *pixelbuf,
+            unsigned char *out) {
+    const int out_width = rm->scale_height;
+    const int out_height = rm->scale_width;
+    unsigned char *buf;
+    int *uniq; /* Output rows to transpose */
+    unsigned char *repeat; /* Set if output row same as the one above */
+    unsigned char *same_col; /* Set if image column same as the one to its left */
+    int uniq_cnt = 0;
+    int row, column, x, y;
+    int base, start, step;
+    int prev_base = -1;
+    int u, u_tile, col_tile;
+
+    if (!(buf = raster_scratch(symbol, RASTER_ROTATE,
+                                (sizeof(int) + 1) * out_height + rm->image_width))) {
+        return 0;
+    }
+    uniq = (int *) buf;
+    repeat = buf + sizeof(int) * out_height;
+    same_col = repeat + out_height;
+
+    memset(same_col, 1, rm->image_width);
+    same_col[0] = 0;
+    for (y = 0; y < rm->image_height; y++) {
+        const unsigned char *pb = pixelbuf + (size_t) y * rm->image_width;
+        if (y && memcmp(pb, pb - rm->image_width, rm->image_width) == 0) {
+            continue; /* Same row as above so nothing new */
+        }
+        /* Compare a word of neighbours at a time, as most are equal */
+        for (x = 1; x + (int) sizeof(size_t) <= rm->image_width; x += sizeof(size_t)) {
+            size_t word, word_left;
+            memcpy(&word, pb + x, sizeof(size_t));
+            memcpy(&word_left, pb + x - 1, sizeof(size_t));
+            if (word != word_left) {
+                int i;
+                for (i = x; i < x + (int) sizeof(size_t); i++) {
+                    same_col[i] &= pb[i] == pb[i - 1];
+                }
+            }
+        }
+        for (; x < rm->image_width; x++) {
+            same_col[x] &= pb[x] == pb[x - 1];
+        }
+    }
+
+    for (row = 0; row < out_height; row++) {
+        (void) remap_row(rm, row, &base, &start, &step); /* `base` is image column */
+        repeat[row] = prev_base != -1 && (base == prev_base || (base == prev_base + 1 && same_col[base])
+                                            || (base == prev_base - 1 && same_col[prev_base]));
+        if (!repeat[row]) {
+            uniq[uniq_cnt++] = row;
+        }
+        prev_base = base;
+    }
+
+    for (u_tile = 0; u_tile < uniq_cnt; u_tile += RASTER_TILE) {
+        const int u_end = u_tile + RASTER_TILE < uniq_cnt ? u_tile + RASTER_TILE : uniq_cnt;
+        for (col_tile = 0; col_tile < out_width; col_tile += RASTER_TILE) {
+            const int col_end = col_tile + RASTER_TILE < out_width ? col_tile + RASTER_TILE : out_width;
+            for (u = u_tile; u < u_end; u++) {
+                const int *inner = remap_row(rm, uniq[u], &base, &start, &step);
+                const unsigned char *pb = pixelbuf + base;
+                unsigned char *o = out + (size_t) uniq[u] * out_width + col_tile;
+                int i = start + col_tile * step;
+                for (column = col_tile; column < col_end; column++, i += step) {
+                    *o++ = pb[inner[i]];
+                }
+            }
+        }
+    }
+
+    for (row = 1; row < out_height; row++) {
+        if (repeat[row]) {
+            memcpy(out + (size_t) row * out_width, out + (size_t) (row - 1) * out_width, out_width);
+        }
+    }
+
+    return 1;
+}
+
+/* Set `count` pixels of `bpp` bytes to `colour`, doubling the copied span each time */
+static void pixel_fill(unsigned char *bitmap, const unsigned char *colour, const int bpp, const int count) {
+    const size_t total = (size_t) count * bpp;
+    size_t done = bpp;
+
+    if (bpp == 1) {
+        memset(bitmap, colour[0], count);
+        return;
+    }
+    if (bpp == 4 && count <= 16) {
+        /* Short runs (the most common) as whole pixel stores */
+        uint32_t pixel;
+        int i;
+        memcpy(&pixel, colour, 4);
+        for (i = 0; i < count; i++, bitmap += 4) {
+            memcpy(bitmap, &pixel, 4);
+        }
+        return;
+    }
+    memcpy(bitmap, colour, bpp);
+    while (done < total) {
+        const size_t chunk = done < total - done ? done : total - done;
+        memcpy(bitmap + done, bitmap, chunk);
+        done += chunk;
+    }
+}
+
+/* Set the RGB colour and alpha of each pixelbuffer value (background, foreground, anti-aliased levels and
+   Ultracode colours). Returns 1 if either foreground or background has alpha, else 0 */
+static int plot_palette(const struct zint_symbol *symbol, unsigned char rgb[RASTER_PALETTE][3],
+            unsigned char alpha[RASTER_PALETTE]) {
+    static const char ultra_letters[] = "WCBMRYGK";
+    static const unsigned char ultra_rgb[8][3] = {
+        { 0xff, 0xff, 0xff }, {    0, 0xff, 0xff }, {    0,    0, 0xff }, { 0xff,    0, 0xff },
+        { 0xff,    0,    0 }, { 0xff, 0xff,    0 }, {    0, 0xff,    0 }, {    0,    0,    0 },
+    };
+    unsigned char *const fg = rgb[DEFAULT_INK];
+    unsigned char *const bg = rgb[DEFAULT_PAPER];
+    int fgalpha, bgalpha;
+    int plot_alpha;
+    int i, level;
+
+    memset(rgb, 0, sizeof(rgb[0]) * RASTER_PALETTE);
+
+    fg[0] = OUT_RED(symbol->fgcolour_rgba);
+    fg[1] = OUT_GREEN(symbol->fgcolour_rgba);
+    fg[2] = OUT_BLUE(symbol->fgcolour_rgba);
+    bg[0] = OUT_RED(symbol->bgcolour_rgba);
+    bg[1] = OUT_GREEN(symbol->bgcolour_rgba);
+    bg[2] = OUT_BLUE(symbol->bgcolour_rgba);
+    fgalpha = OUT_ALPHA(symbol->fgcolour_rgba);
+    bgalpha = OUT_ALPHA(symbol->bgcolour_rgba);
+
+    /* Alpha given, even if opaque */
+    plot_alpha = symbol->fgcolour[6] != '\0' || symbol->bgcolour[6] != '\0';
+
+    memset(alpha, fgalpha, RASTER_PALETTE);
+    alpha[DEFAULT_PAPER] = (unsigned char) bgalpha;
+
+    for (level = 1; level < RASTER_AA_LEVELS; level++) {
+        unsigned char *const colour = rgb['1' + level];
+        colour[0] = RASTER_AA_BLEND(bg[0], fg[0], level);
+        colour[1] = RASTER_AA_BLEND(bg[1], fg[1], level);
+        colour[2] = RASTER_AA_BLEND(bg[2], fg[2], level);
+        alpha['1' + level] = RASTER_AA_BLEND(bgalpha, fgalpha, level);
+    }
+
+    for (i = 0; i < 8; i++) {
+        memcpy(rgb[(unsigned char) ultra_letters[i]], ultra_rgb[i], 3);
+    }
+
+    return plot_alpha;
+}
+
+/* Set the output bytes of each pixelbuffer value for pixel format `format` (ZINT_PIXEL_XXX other than
+   ZINT_PIXEL_MONO1, or RASTER_PIXEL_VALUES), returning the bytes per pixel */
+static int plot_colours(const struct zint_symbol *symbol, const int format,
+            unsigned char colours[RASTER_PALETTE][4]) {
+    unsigned char rgb[RASTER_PALETTE][3], alpha[RASTER_PALETTE];
+    int i;
+
+    (void) plot_palette(symbol, rgb, alpha);
+
+    for (i = 0; i < RASTER_PALETTE; i++) {
+        unsigned char *const colour = colours[i];
+        switch (format) {
+            case RASTER_PIXEL_VALUES:
+                colour[0] = (unsigned char) i;
+                break;
+            case ZINT_PIXEL_GRAY8:
+                colour[0] = (unsigned char) ((rgb[i][0] * 299 + rgb[i][1] * 587 + rgb[i][2] * 114 + 500) / 1000);
+                break;
+            case ZINT_PIXEL_BGRA32:
+                colour[0] = rgb[i][2];
+                colour[1] = rgb[i][1];
+                colour[2] = rgb[i][0];
+                colour[3] = alpha[i];
+                break;
+            default: /* ZINT_PIXEL_RGB24, ZINT_PIXEL_RGBA32 */
+                memcpy(colour, rgb[i], 3);
+                colour[3] = alpha[i];
+                break;
+        }
+    }
+
+    return format == RASTER_PIXEL_VALUES || format == ZINT_PIXEL_GRAY8 ? 1 : format == ZINT_PIXEL_RGB24 ? 3 : 4;
+}
+
+/* Scale, rotate and colourise pixelbuffer as mapped by `rm` into `bitmap`, its rows `stride` bytes apart, in a
+   single pass, each pixel being the `bpp` bytes of `colours` for its value. Each output row is expanded a run of
+   same-coloured pixels at a time, or copied from the row above if the same */
+static void plot_rows(const struct zint_symbol *symbol, const unsigned char *pixelbuf, const struct remap *rm,
+            unsigned char colours[RASTER_PALETTE][4], const int bpp, unsigned char *bitmap,
+            const size_t stride) {
+    const size_t row_size = (size_t) symbol->bitmap_width * bpp;
+    int row, column, len;
+    int base, start, step;
+    int prev_base = -1;
+
+    for (row = 0; row < symbol->bitmap_height; row++, bitmap += stride) {
+        const int *inner = remap_row(rm, row, &base, &start, &step);
+        const unsigned char *pb = pixelbuf + base;
+        unsigned char *out = bitmap;
+        int i = start;
+        if (remap_repeats(rm, pixelbuf, base, prev_base)) {
+            memcpy(bitmap, bitmap - stride, row_size);
+            continue;
+        }
+        prev_base = base;
+        for (column = 0; column < symbol->bitmap_width; column += len) {
+            const unsigned char p = pb[inner[i]];
+            for (len = 1, i += step; column + len < symbol->bitmap_width && pb[inner[i]] == p; len++, i += step);
+            pixel_fill(out, colours[p], bpp, len);
+            out += (size_t) len * bpp;
+        }
+    }
+}
+
+/* Scale, rotate and colourise pixelbuffer into the symbol's bitmap, RGB with separate alphamap if foreground or
+   background has alpha, or RGBA if OUT_BUFFER_RGBA */
+static int buffer_plot(struct zint_symbol *symbol, const unsigned char *pixelbuf, const struct remap *rm) {
+    unsigned char colours[RASTER_PALETTE][4];
+    unsigned char rgb[RASTER_PALETTE][3], alpha[RASTER_PALETTE];
+    const int plot_alpha = plot_palette(symbol, rgb, alpha);
+    const int rgba = symbol->output_options & OUT_BUFFER_RGBA;
+    const int bpp = plot_colours(symbol, rgba ? ZINT_PIXEL_RGBA32 : ZINT_PIXEL_RGB24, colours);
+    const size_t bitmap_row_size = (size_t) symbol->bitmap_width * bpp;
+
+    /* Release any previous bitmap */
+    raster_release_bitmap(symbol);
+
+    symbol->bitmap = raster_scratch(symbol, RASTER_BITMAP, bitmap_row_size * symbol->bitmap_height);
     if (symbol->bitmap == NULL) {
         strcpy(symbol->errtxt, "661: Insufficient memory for bitmap buffer");
         return ZINT_ERROR_MEMORY;
     }
 
-    if (plot_alpha) {
-        symbol->alphamap = (unsigned char *) malloc((size_t) symbol->bitmap_width * symbol->bitmap_height);
+    plot_rows(symbol, pixelbuf, rm, colours, bpp, symbol->bitmap, bitmap_row_size);
+
+    /* Alpha interleaved if RGBA, so no alphamap */
+    if (!rgba && plot_alpha) {
+        int i;
+        symbol->alphamap = raster_scratch(symbol, RASTER_ALPHAMAP,
+                                (size_t) symbol->bitmap_width * symbol->bitmap_height);
         if (symbol->alphamap == NULL) {
             strcpy(symbol->errtxt, "662: Insufficient memory for alphamap buffer");
             return ZINT_ERROR_MEMORY;
         }
-        for (row = 0; row < symbol->bitmap_height; row++) {
-            int p = row * symbol->bitmap_width;
-            bitmap = symbol->bitmap + p * 3;
-            for (column = 0; column < symbol->bitmap_width; column++, p++, bitmap += 3) {
-                memcpy(bitmap, map[pixelbuf[p]], 3);
-                symbol->alphamap[p] = pixelbuf[p] == DEFAULT_PAPER ? bgalpha : fgalpha;
+        for (i = 0; i < RASTER_PALETTE; i++) {
+            colours[i][0] = alpha[i];
+        }
+        plot_rows(symbol, pixelbuf, rm, colours, 1 /*bpp*/, symbol->alphamap, symbol->bitmap_width);
+    }
+
+    return 0;
+}
+
+/* Pack pixelbuffer into symbol at 1 bit per pixel (set for foreground), MSB first, each row padded to a byte,
+   scaling and rotating in the same pass */
+static int buffer_plot_1bpp(struct zint_symbol *symbol, const unsigned char *pixelbuf, const struct remap *rm) {
+    const int row_bytes = (symbol->bitmap_width + 7) / 8;
+    const int remainder = symbol->bitmap_width & 7;
+    int row, column;
+    int base, start, step;
+    int prev_base = -1;
+    unsigned char *bitmap;
+
+    /* Release any previous bitmap */
+    raster_release_bitmap(symbol);
+
+    symbol->bitmap = raster_scratch(symbol, RASTER_BITMAP, (size_t) row_bytes * symbol->bitmap_height);
+    if (symbol->bitmap == NULL) {
+        strcpy(symbol->errtxt, "664: Insufficient memory for bitmap buffer");
+        return ZINT_ERROR_MEMORY;
+    }
+
+    bitmap = symbol->bitmap;
+    for (row = 0; row < symbol->bitmap_height; row++) {
+        const int *inner = remap_row(rm, row, &base, &start, &step);
+        const unsigned char *pb = pixelbuf + base;
+        unsigned char byte = 0;
+        int i = start;
+        if (remap_repeats(rm, pixelbuf, base, prev_base)) {
+            memcpy(bitmap, bitmap - row_bytes, row_bytes);
+            bitmap += row_bytes;
+            continue;
+        }
+        prev_base = base;
+        for (column = 0; column < symbol->bitmap_width; column++, i += step) {
+            const unsigned char p = pb[inner[i]];
+            /* Ultracode white counts as background */
+            byte = (unsigned char) ((byte << 1) | (p != DEFAULT_PAPER && p != 'W'));
+            if ((column & 7) == 7) {
+                *bitmap++ = byte;
+                byte = 0;
+            }
+        }
+        if (remainder) {
+            *bitmap++ = (unsigned char) (byte << (8 - remainder));
+        }
+    }
+
+    return 0;
+}
+
+/* As `buffer_plot_1bpp()` but into 1 bit per pixel `target` at its offset, leaving the bits either side of each
+   row untouched */
+static void target_plot_1bpp(const struct zint_symbol *symbol, const unsigned char *pixelbuf,
+            const struct remap *rm, const struct zint_target *target) {
+    unsigned char *bitmap = target->pixels + (size_t) target->y * target->stride;
+    int row, column;
+    int base, start, step;
+
+    for (row = 0; row < symbol->bitmap_height; row++, bitmap += target->stride) {
+        const int *inner = remap_row(rm, row, &base, &start, &step);
+        const unsigned char *pb = pixelbuf + base;
+        int i = start;
+        int x = target->x;
+        for (column = 0; column < symbol->bitmap_width; column++, i += step, x++) {
+            const unsigned char p = pb[inner[i]];
+            const unsigned char bit = (unsigned char) (0x80 >> (x & 7));
+            /* Ultracode white counts as background */
+            if (p != DEFAULT_PAPER && p != 'W') {
+                bitmap[x >> 3] |= bit;
+            } else {
+                bitmap[x >> 3] &= (unsigned char) ~bit;
             }
         }
+    }
+}
+
+/* Scale, rotate and colourise pixelbuffer into caller's buffer `target` (see `ZBarcode_Buffer_Target()`). The
+   symbol's bitmap is released, and its dimensions set */
+static int target_plot(struct zint_symbol *symbol, const unsigned char *pixelbuf, const struct remap *rm,
+            const struct zint_target *target) {
+
+    if (target->x < 0 || target->y < 0 || symbol->bitmap_width > target->width - target->x
+            || symbol->bitmap_height > target->height - target->y) {
+        sprintf(symbol->errtxt, "668: Symbol size %dx%d at %d,%d outside target %dx%d", symbol->bitmap_width,
+                symbol->bitmap_height, target->x, target->y, target->width, target->height);
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+
+    /* Release any previous bitmap, which isn't set */
+    raster_release_bitmap(symbol);
+
+    if (target->format == ZINT_PIXEL_MONO1) {
+        target_plot_1bpp(symbol, pixelbuf, rm, target);
     } else {
-        for (row = 0; row < symbol->bitmap_height; row++) {
-            int r = row * symbol->bitmap_width;
-            unsigned char *pb = pixelbuf + r;
-            bitmap = symbol->bitmap + r * 3;
-            for (column = 0; column < symbol->bitmap_width; column++, pb++, bitmap += 3) {
-                memcpy(bitmap, map[*pb], 3);
+        unsigned char colours[RASTER_PALETTE][4];
+        const int bpp = plot_colours(symbol, target->format, colours);
+        plot_rows(symbol, pixelbuf, rm, colours, bpp,
+                target->pixels + (size_t) target->y * target->stride + (size_t) target->x * bpp, target->stride);
+    }
+
+    return 0;
+}
+
+/* Plot pixelbuffer into `target` if given, else into the symbol's bitmap */
+static int buffer_plot_target(struct zint_symbol *symbol, const unsigned char *pixelbuf, const struct remap *rm,
+            const struct zint_target *target) {
+    if (target) {
+        return target_plot(symbol, pixelbuf, rm, target);
+    }
+    if (symbol->output_options & OUT_BUFFER_1BPP) {
+        return buffer_plot_1bpp(symbol, pixelbuf, rm);
+    }
+    return buffer_plot(symbol, pixelbuf, rm);
+}
+
+/* Set the image pixels overlapped by each of `n` output pixels along an axis of `n_image` image pixels scaled by
+   `scaler`, `starts` getting the first and `weights` (`kmax` per output pixel) the fractions of the output pixel
+   they cover, zero after the last */
+static void antialias_spans(const int n_image, const int n, const float scaler, const int kmax, int *starts,
+            float *weights) {
+    int i, k;
+
+    for (i = 0; i < n; i++) {
+        const float a = i / scaler;
+        const float b = (i + 1) / scaler < n_image ? (i + 1) / scaler : n_image;
+        float *const w = weights + (size_t) i * kmax;
+        int j = (int) a;
+
+        if (j >= n_image) { /* Float rounding at the end */
+            j = n_image - 1;
+        }
+        starts[i] = j;
+        if (b <= a) {
+            w[0] = 1.0f;
+            k = 1;
+        } else {
+            for (k = 0; k < kmax && j + k < n_image; k++) {
+                const float lo = a > j + k ? a : j + k;
+                const float hi = b < j + k + 1 ? b : j + k + 1;
+                if (hi <= lo) {
+                    break;
+                }
+                w[k] = (hi - lo) / (b - a);
+            }
+        }
+        for (; k < kmax; k++) {
+            w[k] = 0.0f;
+        }
+    }
+}
+
+/* Scale `image_width` x `image_height` pixelbuffer by `scaler` into anti-aliased coverage levels (see
+   `RASTER_AA_LEVELS`), each output pixel getting the fraction of its area covered by ink (a box filter). As bars
+   and modules are on image pixel boundaries their edges come out at their exact sub-pixel positions. Sets
+   `p_width` and `p_height` to the scaled size. Returns NULL if out of memory */
+static unsigned char *raster_antialias(struct zint_symbol *symbol, const unsigned char *pixelbuf,
+            const int image_width, const int image_height, const float scaler, int *p_width, int *p_height) {
+    const int width = (int) (image_width * scaler);
+    const int height = (int) (image_height * scaler);
+    const int kmax = (int) (1.0f / scaler) + 2; /* Most image pixels an output pixel can overlap on an axis */
+    unsigned char *out, *ob;
+    int *xs, *ys;
+    float *xw, *yw;
+    int x, y, k, m;
+
+    if (!(out = raster_scratch(symbol, RASTER_ANTIALIAS, (size_t) width * height))) {
+        return NULL;
+    }
+    /* Use the remap slot for the spans, as the scaling maps aren't set up until after */
+    if (!(xs = (int *) raster_scratch(symbol, RASTER_REMAP, (sizeof(int) + sizeof(float) * kmax) * (width + height)))) {
+        return NULL;
+    }
+    ys = xs + width;
+    xw = (float *) (ys + height);
+    yw = xw + (size_t) kmax * width;
+    antialias_spans(image_width, width, scaler, kmax, xs, xw);
+    antialias_spans(image_height, height, scaler, kmax, ys, yw);
+
+    for (y = 0, ob = out; y < height; y++) {
+        const float *const wy = yw + (size_t) y * kmax;
+        if (y && ys[y] == ys[y - 1] && memcmp(wy, wy - kmax, sizeof(float) * kmax) == 0) {
+            /* Same image rows in the same proportions as the row above */
+            memcpy(ob, ob - width, width);
+            ob += width;
+            continue;
+        }
+        for (x = 0; x < width; x++) {
+            const float *const wx = xw + (size_t) x * kmax;
+            float cover = 0.0f;
+            int level;
+            for (k = 0; k < kmax && wy[k]; k++) {
+                const unsigned char *const pb = pixelbuf + (size_t) (ys[y] + k) * image_width + xs[x];
+                for (m = 0; m < kmax && wx[m]; m++) {
+                    if (pb[m] != DEFAULT_PAPER) {
+                        cover += wy[k] * wx[m];
+                    }
+                }
             }
+            level = (int) (cover * RASTER_AA_LEVELS + 0.5f);
+            *ob++ = level <= 0 ? DEFAULT_PAPER : level >= RASTER_AA_LEVELS ? DEFAULT_INK : '1' + level;
         }
     }
 
+    *p_width = width;
+    *p_height = height;
+    return out;
+}
+
+/* Set the bitmap dimensions that `save_raster_image_to_file()` would give an `image_width` x `image_height` image,
+   without plotting (`OUT_MEASURE`) */
+static int raster_measure(struct zint_symbol *symbol, const int image_width, const int image_height,
+            const float scaler, const int rotate_angle) {
+    const int scale_width = scaler ? (int) (image_width * scaler) : image_width;
+    const int scale_height = scaler ? (int) (image_height * scaler) : image_height;
+
+    if (rotate_angle == 90 || rotate_angle == 270) {
+        symbol->bitmap_width = scale_height;
+        symbol->bitmap_height = scale_width;
+    } else {
+        symbol->bitmap_width = scale_width;
+        symbol->bitmap_height = scale_height;
+    }
     return 0;
 }
 
-static int save_raster_image_to_file(struct zint_symbol *symbol, const int image_height, const int image_width,
-            unsigned char *pixelbuf, int rotate_angle, const int file_type) {
+/* Output pixelbuffer (scratch buffer `pixelbuf_slot`), scaling by `scaler` if non-zero and rotating.
+   For `OUT_BUFFER` unrotated or rotated 180 degrees this is done in one pass straight into the bitmap, otherwise in
+   one pass into an output buffer (skipped if neither scaling nor rotating), see `remap_rotate()` for 90 and 270
+   degrees. If BARCODE_ANTIALIAS set the scaling is first done by `raster_antialias()` instead (buffer and PNG
+   only, and not for Ultracode, whose colours aren't blended) */
+/* Write the final (scaled and rotated) image `pixelbuf` of `symbol->bitmap_width` x `symbol->bitmap_height` to
+   raster file `file_type` */
+static int raster_write(struct zint_symbol *symbol, const int file_type, unsigned char *pixelbuf) {
     int error_number;
-    int row, column;
 
-    unsigned char *rotated_pixbuf = pixelbuf;
+    switch (file_type) {
+        case OUT_PNG_FILE:
+            error_number = png_pixel_plot(symbol, pixelbuf);
+            break;
+        case OUT_PCX_FILE:
+            error_number = pcx_pixel_plot(symbol, pixelbuf);
+            break;
+        case OUT_PBM_FILE:
+            error_number = pbm_pixel_plot(symbol, pixelbuf);
+            break;
+        case OUT_PGM_FILE:
+            error_number = pgm_pixel_plot(symbol, pixelbuf);
+            break;
+        case OUT_ZPL_FILE:
+            error_number = zpl_pixel_plot(symbol, pixelbuf);
+            break;
+        case OUT_EPL_FILE:
+            error_number = epl_pixel_plot(symbol, pixelbuf);
+            break;
+        case OUT_PCL_FILE:
+            error_number = pcl_pixel_plot(symbol, pixelbuf);
+            break;
+        case OUT_QOI_FILE:
+            error_number = qoi_pixel_plot(symbol, pixelbuf);
+            break;
+        case OUT_GIF_FILE:
+            error_number = gif_pixel_plot(symbol, pixelbuf);
+            break;
+        case OUT_TIF_FILE:
+            error_number = tif_pixel_plot(symbol, pixelbuf);
+            break;
+        default:
+            error_number = bmp_pixel_plot(symbol, pixelbuf);
+            break;
+    }
+
+    return error_number;
+}
+
+static int save_raster_image_to_file(struct zint_symbol *symbol, int image_height, int image_width,
+            unsigned char *pixelbuf, const int pixelbuf_slot, float scaler, const int rotate_angle,
+            const int file_type, const struct zint_target *target) {
+    int row, column;
+    int base, start, step;
+    int prev_base = -1;
+    struct remap rm;
+
+    unsigned char *out_pixbuf = pixelbuf;
+    int out_slot = pixelbuf_slot;
+    /* Targets are never intermediate */
+    const int mono = target ? target->format == ZINT_PIXEL_MONO1 : symbol->output_options & OUT_BUFFER_1BPP;
+    const int intermediate = !target
+            && (symbol->output_options & (OUT_BUFFER_1BPP | OUT_BUFFER_RGBA | OUT_BUFFER_INTERMEDIATE))
+                == OUT_BUFFER_INTERMEDIATE;
 
     /* Suppress clang-analyzer-core.UndefinedBinaryOperatorResult warning */
     assert(rotate_angle == 0 || rotate_angle == 90 || rotate_angle == 180 || rotate_angle == 270);
+
+    if (scaler && (symbol->output_options & BARCODE_ANTIALIAS) && symbol->symbology != BARCODE_ULTRA
+            && (file_type == OUT_PNG_FILE
+                || (file_type == OUT_BUFFER && !mono))) {
+        if (!(pixelbuf = raster_antialias(symbol, pixelbuf, image_width, image_height, scaler, &image_width,
+                                            &image_height))) {
+            strcpy(symbol->errtxt, "667: Insufficient memory for anti-aliased pixel buffer");
+            return ZINT_ERROR_MEMORY;
+        }
+        out_pixbuf = pixelbuf;
+        out_slot = RASTER_ANTIALIAS;
+        scaler = 0.0f;
+    }
+
+    if (!remap_init(symbol, &rm, image_width, image_height, scaler, rotate_angle)) {
+        strcpy(symbol->errtxt, "650: Insufficient memory for pixel buffer");
+        return ZINT_ERROR_ENCODING_PROBLEM;
+    }
+
     switch (rotate_angle) {
         case 0:
         case 180:
-            symbol->bitmap_width = image_width;
-            symbol->bitmap_height = image_height;
+            symbol->bitmap_width = rm.scale_width;
+            symbol->bitmap_height = rm.scale_height;
             break;
         case 90:
         case 270:
-            symbol->bitmap_width = image_height;
-            symbol->bitmap_height = image_width;
+            symbol->bitmap_width = rm.scale_height;
+            symbol->bitmap_height = rm.scale_width;
             break;
     }
 
-    if (rotate_angle) {
-        if (!(rotated_pixbuf = (unsigned char *) malloc((size_t) image_width * image_height))) {
-            strcpy(symbol->errtxt, "650: Insufficient memory for pixel buffer");
+    if (file_type == OUT_BUFFER && (rotate_angle == 0 || rotate_angle == 180) && !intermediate) {
+        return buffer_plot_target(symbol, pixelbuf, &rm, target);
+    }
+
+    if ((scaler || rotate_angle)
+            && (file_type == OUT_PNG_FILE || file_type == OUT_TIF_FILE || file_type == OUT_BMP_FILE)) {
+        /* Formats that take rows get them scaled and rotated as written rather than from a full-size copy */
+        struct raster_rows rows;
+        if (!raster_rows_remap(symbol, &rows, &rm, pixelbuf)) {
+            strcpy(symbol->errtxt, "666: Insufficient memory for pixel buffer");
             return ZINT_ERROR_ENCODING_PROBLEM;
         }
+        if (file_type == OUT_PNG_FILE) {
+            return png_plot_rows(symbol, &rows);
+        }
+        if (file_type == OUT_TIF_FILE) {
+            return tif_plot_rows(symbol, &rows);
+        }
+        return bmp_plot_rows(symbol, &rows);
     }
 
-    /* Rotate image before plotting */
-    switch (rotate_angle) {
-        case 0: /* Plot the right way up */
-            /* Nothing to do */
-            break;
-        case 90: /* Plot 90 degrees clockwise */
-            for (row = 0; row < image_width; row++) {
-                for (column = 0; column < image_height; column++) {
-                    rotated_pixbuf[(row * image_height) + column] =
-                            *(pixelbuf + (image_width * (image_height - column - 1)) + row);
-                }
+    if (scaler || rotate_angle) {
+        unsigned char *out;
+        if (!(out_pixbuf = raster_scratch(symbol, RASTER_OUTPUT,
+                                        (size_t) symbol->bitmap_width * symbol->bitmap_height))) {
+            strcpy(symbol->errtxt, "659: Insufficient memory for pixel buffer");
+            return ZINT_ERROR_ENCODING_PROBLEM;
+        }
+        out_slot = RASTER_OUTPUT;
+        if (rotate_angle == 90 || rotate_angle == 270) {
+            if (!remap_rotate(symbol, &rm, pixelbuf, out_pixbuf)) {
+                strcpy(symbol->errtxt, "665: Insufficient memory for pixel buffer");
+                return ZINT_ERROR_ENCODING_PROBLEM;
             }
-            break;
-        case 180: /* Plot upside down */
-            for (row = 0; row < image_height; row++) {
-                for (column = 0; column < image_width; column++) {
-                    rotated_pixbuf[(row * image_width) + column] =
-                            *(pixelbuf + (image_width * (image_height - row - 1)) + (image_width - column - 1));
+        } else {
+            out = out_pixbuf;
+            for (row = 0; row < symbol->bitmap_height; row++) {
+                const int *inner = remap_row(&rm, row, &base, &start, &step);
+                const unsigned char *pb = pixelbuf + base;
+                int i = start;
+                if (remap_repeats(&rm, pixelbuf, base, prev_base)) {
+                    memcpy(out, out - symbol->bitmap_width, symbol->bitmap_width);
+                    out += symbol->bitmap_width;
+                    continue;
                 }
-            }
-            break;
-        case 270: /* Plot 90 degrees anti-clockwise */
-            for (row = 0; row < image_width; row++) {
-                for (column = 0; column < image_height; column++) {
-                    rotated_pixbuf[(row * image_height) + column] =
-                            *(pixelbuf + (image_width * column) + (image_width - row - 1));
+                prev_base = base;
+                for (column = 0; column < symbol->bitmap_width; column++, i += step) {
+                    *out++ = pb[inner[i]];
                 }
             }
-            break;
+        }
     }
 
-    switch (file_type) {
-        case OUT_BUFFER:
-            if (symbol->output_options & OUT_BUFFER_INTERMEDIATE) {
-                if (symbol->bitmap != NULL) {
-                    free(symbol->bitmap);
-                    symbol->bitmap = NULL;
-                }
-                if (symbol->alphamap != NULL) {
-                    free(symbol->alphamap);
-                    symbol->alphamap = NULL;
-                }
-                symbol->bitmap = rotated_pixbuf;
-                rotate_angle = 0; /* Suppress freeing buffer if rotated */
-                error_number = 0;
-            } else {
-                error_number = buffer_plot(symbol, rotated_pixbuf);
-            }
-            break;
-        case OUT_PNG_FILE:
-#ifndef NO_PNG
-            error_number = png_pixel_plot(symbol, rotated_pixbuf);
-#else
-            if (rotate_angle) {
-                free(rotated_pixbuf);
-            }
-            return ZINT_ERROR_INVALID_OPTION;
-#endif
-            break;
-        case OUT_PCX_FILE:
-            error_number = pcx_pixel_plot(symbol, rotated_pixbuf);
-            break;
-        case OUT_GIF_FILE:
-            error_number = gif_pixel_plot(symbol, rotated_pixbuf);
-            break;
-        case OUT_TIF_FILE:
-            error_number = tif_pixel_plot(symbol, rotated_pixbuf);
-            break;
-        default:
-            error_number = bmp_pixel_plot(symbol, rotated_pixbuf);
-            break;
+    if (file_type == OUT_BUFFER && !intermediate) {
+        /* Rotated 90 or 270 degrees, now colourise (or pack) the rotated image as is */
+        if (!remap_init(symbol, &rm, symbol->bitmap_width, symbol->bitmap_height, 0.0f /*scaler*/,
+                        0 /*rotate_angle*/)) {
+            strcpy(symbol->errtxt, "679: Insufficient memory for pixel buffer");
+            return ZINT_ERROR_ENCODING_PROBLEM;
+        }
+        return buffer_plot_target(symbol, out_pixbuf, &rm, target);
     }
 
-    if (rotate_angle) {
-        free(rotated_pixbuf);
+    if (file_type == OUT_BUFFER) { /* OUT_BUFFER_INTERMEDIATE */
+        /* Swap the image buffer into the bitmap slot rather than copying */
+        struct zint_scratch *scratch = symbol->internal->scratch;
+        const size_t size = scratch->size[out_slot];
+
+        raster_release_bitmap(symbol);
+        scratch->buf[out_slot] = scratch->buf[RASTER_BITMAP];
+        scratch->size[out_slot] = scratch->size[RASTER_BITMAP];
+        scratch->buf[RASTER_BITMAP] = out_pixbuf;
+        scratch->size[RASTER_BITMAP] = size;
+        symbol->bitmap = out_pixbuf;
+        return 0;
     }
-    return error_number;
+
+    return raster_write(symbol, file_type, out_pixbuf);
 }
 
 /* Helper to check point within bounds before setting */
@@ -281,143 +1103,295 @@ static void draw_pt(unsigned char *buf, const int buf_width, const int buf_heigh
 /* Draw a rectangle */
 static void draw_bar(unsigned char *pixelbuf, const int xpos, const int xlen, const int ypos, const int ylen,
             const int image_width, const int image_height, const char fill) {
-    int i, j, png_ypos;
+    int j, png_ypos;
 
     png_ypos = image_height - ypos - ylen;
     /* This fudge is needed because EPS measures height from the bottom up but
     PNG measures y position from the top down */
 
-    for (i = (xpos); i < (xpos + xlen); i++) {
+    if (xlen > 0) {
         for (j = (png_ypos); j < (png_ypos + ylen); j++) {
-            *(pixelbuf + (image_width * j) + i) = fill;
+            memset(pixelbuf + (size_t) image_width * j + xpos, fill, xlen);
         }
     }
 }
 
-/* Put a letter into a position */
-static void draw_letter(unsigned char *pixelbuf, const unsigned char letter, int xposn, const int yposn,
-            const int textflags, const int image_width, const int image_height, const int si) {
-    int skip;
+/* Copy top line of a `ylen` high band at `ypos` (measured as in `draw_bar()`) to the rest of the band */
+static void copy_bar_line(unsigned char *pixelbuf, const int ypos, const int ylen, const int image_width,
+            const int image_height) {
+    const unsigned char *top = pixelbuf + (size_t) image_width * (image_height - ypos - ylen);
+    int j;
+
+    for (j = 1; j < ylen; j++) {
+        memcpy(pixelbuf + (size_t) image_width * (image_height - ypos - ylen + j), top, image_width);
+    }
+}
+
+/* Return cached stamp if made for `kind` and `size`, setting `p_runs` */
+static const struct raster_run *raster_stamp(const struct zint_symbol *symbol, const int kind, const float size,
+            int *p_runs) {
+    const struct zint_scratch *scratch = symbol->internal->scratch;
+
+    if (scratch && scratch->stamp_kind == kind && scratch->stamp_size == size) {
+        *p_runs = scratch->stamp_runs;
+        return (const struct raster_run *) scratch->buf[RASTER_STAMP];
+    }
+    return NULL;
+}
+
+/* Return scratch buffer for a stamp of up to `max_runs` runs, invalidating any current stamp */
+static struct raster_run *raster_stamp_buf(struct zint_symbol *symbol, const int max_runs) {
+    if (symbol->internal->scratch) {
+        symbol->internal->scratch->stamp_kind = 0;
+    }
+    return (struct raster_run *) raster_scratch(symbol, RASTER_STAMP, sizeof(struct raster_run) * max_runs);
+}
+
+/* Mark stamp just made in `raster_stamp_buf()` as cached */
+static void raster_stamp_set(struct zint_symbol *symbol, const int kind, const float size, const int runs) {
+    symbol->internal->scratch->stamp_kind = kind;
+    symbol->internal->scratch->stamp_size = size;
+    symbol->internal->scratch->stamp_runs = runs;
+}
+
+/* Put stamp with top left at `xposn`, `yposn` into the pixel buffer, a row of memset per run */
+static void draw_stamp(unsigned char *pixelbuf, const int image_width, const int image_height,
+            const struct raster_run *runs, const int run_cnt, const int xposn, const int yposn, const char fill) {
+    int i;
+
+    for (i = 0; i < run_cnt; i++) {
+        const int y = yposn + runs[i].row;
+        int x = xposn + runs[i].start;
+        int x_end = x + runs[i].len;
+        if (y < 0 || y >= image_height) {
+            continue;
+        }
+        if (x < 0) {
+            x = 0;
+        }
+        if (x_end > image_width) {
+            x_end = image_width;
+        }
+        if (x < x_end) {
+            memset(pixelbuf + (size_t) y * image_width + x, fill, x_end - x);
+        }
+    }
+}
+
+/* Append to `runs` those of glyph row `bits` scaled by `si`, putting them in stamp row `row`. Half-integer scales
+   widen odd columns by an extra pixel, and bold adds a pixel after each set column. Returns number appended (at most
+   `max_x + 1`) */
+static int glyph_row_runs(struct raster_run *runs, const int row, const unsigned bits, const int max_x,
+            const int bold, const int si) {
+    const unsigned glyph_mask = ((unsigned) 1) << (max_x - 1);
+    const int half_si = si / 2;
+    const int odd_si = si & 1;
+    int run_cnt = 0;
+    int run_start = -1;
+    int extra_dot = 0;
+    int px = 0;
+    int x, x_si;
+
+#define GLYPH_PUT(ink) do { \
+            if (ink) { \
+                if (run_start == -1) run_start = px; \
+            } else if (run_start != -1) { \
+                runs[run_cnt].row = row; runs[run_cnt].start = run_start; runs[run_cnt++].len = px - run_start; \
+                run_start = -1; \
+            } \
+            px++; \
+        } while (0)
+
+    for (x = 0; x < max_x; x++) {
+        const unsigned set = bits & (glyph_mask >> x);
+        for (x_si = 0; x_si < half_si; x_si++) {
+            if (set) {
+                GLYPH_PUT(1);
+                extra_dot = bold;
+            } else if (extra_dot) {
+                GLYPH_PUT(1);
+                extra_dot = 0;
+            } else {
+                GLYPH_PUT(0);
+            }
+        }
+        if (odd_si && (x & 1)) {
+            GLYPH_PUT(set);
+        }
+    }
+    if (extra_dot) {
+        GLYPH_PUT(1);
+    }
+    GLYPH_PUT(0); /* Flush */
 
-    skip = 0;
+#undef GLYPH_PUT
+
+    return run_cnt;
+}
+
+/* Return runs of glyph `glyph_no` of `font` at scale `si`, making and caching them in `internal->scratch` if need be.
+   Returns NULL if memory can't be allocated */
+static const struct raster_run *raster_glyph(struct zint_symbol *symbol, const int font, const int glyph_no,
+            const font_item *font_table, const int max_x, const int max_y, const int bold, const int si,
+            int *p_runs) {
+    struct raster_font *cache;
+    struct raster_run *runs;
+    const int half_si = si / 2;
+    const int odd_si = si & 1;
+    /* Upper bound, each scaled row of `max_x` columns having at most `max_x + 1` runs */
+    const int max_runs = (max_y * half_si + (odd_si ? max_y / 2 : 0)) * (max_x + 1);
+    int row, y, y_si, run_cnt;
+
+    if (!symbol->internal->scratch) {
+        if (!(symbol->internal->scratch = (struct zint_scratch *) z_calloc(z_allocator(symbol), 1,
+                                                                            sizeof(struct zint_scratch)))) {
+            return NULL;
+        }
+    }
+    if (!(cache = symbol->internal->scratch->fonts[font])) {
+        if (!(cache = (struct raster_font *) z_calloc(z_allocator(symbol), 1, sizeof(struct raster_font)))) {
+            return NULL;
+        }
+        symbol->internal->scratch->fonts[font] = cache;
+    }
+    if (cache->si != si) {
+        cache->si = si;
+        cache->runs_used = 0;
+        memset(cache->count, 0xFF, sizeof(cache->count)); /* -1 */
+    }
+    if (cache->count[glyph_no] != -1) {
+        *p_runs = cache->count[glyph_no];
+        return cache->runs + cache->first[glyph_no];
+    }
+
+    if (cache->runs_used + max_runs > cache->runs_size) {
+        int new_size = cache->runs_size * 2;
+        if (new_size < cache->runs_used + max_runs) {
+            new_size = cache->runs_used + max_runs;
+        }
+        if (!(runs = (struct raster_run *) z_realloc(z_allocator(symbol), cache->runs,
+                                                        sizeof(struct raster_run) * new_size))) {
+            return NULL;
+        }
+        cache->runs = runs;
+        cache->runs_size = new_size;
+    }
+
+    runs = cache->runs + cache->runs_used;
+    run_cnt = 0;
+    row = 0;
+    for (y = 0; y < max_y; y++) {
+        const int row_runs = glyph_row_runs(runs + run_cnt, row, font_table[glyph_no * max_y + y], max_x, bold, si);
+        const int lines = half_si + (odd_si && (y & 1));
+        run_cnt += row_runs;
+        row++;
+        /* Remaining scaled lines are copies */
+        for (y_si = 1; y_si < lines; y_si++, row++) {
+            int i;
+            for (i = 0; i < row_runs; i++) {
+                runs[run_cnt] = runs[run_cnt - row_runs];
+                runs[run_cnt++].row = row;
+            }
+        }
+    }
+    cache->first[glyph_no] = cache->runs_used;
+    cache->count[glyph_no] = run_cnt;
+    cache->runs_used += run_cnt;
+
+    *p_runs = run_cnt;
+    return runs;
+}
+
+/* Put a letter into a position */
+static void draw_letter(struct zint_symbol *symbol, unsigned char *pixelbuf, const unsigned char letter,
+            const int xposn, const int yposn, const int textflags, const int image_width, const int image_height,
+            const int si) {
+    int glyph_no;
+    int max_x, max_y;
+    const font_item *font_table;
+    int font;
+    int bold = 0;
+    const struct raster_run *runs;
+    int run_cnt;
 
     if (letter < 33) {
-        skip = 1;
+        return;
     }
 
     if ((letter >= 127) && (letter < 161)) {
-        skip = 1;
+        return;
     }
 
     if ((textflags & UPCEAN_TEXT) && (letter < '0' || letter > '9')) {
-        skip = 1;
+        return;
     }
 
-    if (yposn < 0) { /* Allow xposn < 0, dealt with below */
-        skip = 1;
+    if (yposn < 0 || si < 2) { /* Allow xposn < 0, clipped by `draw_stamp()` */
+        return;
     }
 
-    if (skip == 0) {
-        int glyph_no;
-        int x, y;
-        int max_x, max_y;
-        font_item *font_table;
-        int bold = 0;
-        unsigned glyph_mask;
-        int font_y;
-        int half_si = si / 2;
-        int odd_si = si & 1;
-        unsigned char *linePtr, *maxPtr;
-        int x_start = 0;
+    if (letter > 127) {
+        glyph_no = letter - 67; /* 161 - (127 - 33) */
+    } else {
+        glyph_no = letter - 33;
+    }
 
-        if (letter > 127) {
-            glyph_no = letter - 67; /* 161 - (127 - 33) */
+    if (textflags & UPCEAN_TEXT) { /* Needs to be before SMALL_TEXT check */
+        /* No bold for UPCEAN */
+        if (textflags & SMALL_TEXT) {
+            font_table = upcean_small_font;
+            max_x = UPCEAN_SMALL_FONT_WIDTH;
+            max_y = UPCEAN_SMALL_FONT_HEIGHT;
+            font = RASTER_FONT_UPCEAN_SMALL;
         } else {
-            glyph_no = letter - 33;
+            font_table = upcean_font;
+            max_x = UPCEAN_FONT_WIDTH;
+            max_y = UPCEAN_FONT_HEIGHT;
+            font = RASTER_FONT_UPCEAN;
         }
+        glyph_no = letter - '0';
+    } else if (textflags & SMALL_TEXT) { // small font 5x9
+        /* No bold for small */
+        max_x = SMALL_FONT_WIDTH;
+        max_y = SMALL_FONT_HEIGHT;
+        font_table = small_font;
+        font = RASTER_FONT_SMALL;
+    } else if (textflags & BOLD_TEXT) { // bold font -> regular font + 1
+        max_x = NORMAL_FONT_WIDTH + 1;
+        max_y = NORMAL_FONT_HEIGHT;
+        font_table = ascii_font;
+        font = RASTER_FONT_BOLD;
+        bold = 1;
+    } else { // regular font 7x14
+        max_x = NORMAL_FONT_WIDTH;
+        max_y = NORMAL_FONT_HEIGHT;
+        font_table = ascii_font;
+        font = RASTER_FONT_NORMAL;
+    }
 
-        if (textflags & UPCEAN_TEXT) { /* Needs to be before SMALL_TEXT check */
-            /* No bold for UPCEAN */
-            if (textflags & SMALL_TEXT) {
-                font_table = upcean_small_font;
-                max_x = UPCEAN_SMALL_FONT_WIDTH;
-                max_y = UPCEAN_SMALL_FONT_HEIGHT;
-            } else {
-                font_table = upcean_font;
-                max_x = UPCEAN_FONT_WIDTH;
-                max_y = UPCEAN_FONT_HEIGHT;
-            }
-            glyph_no = letter - '0';
-        } else if (textflags & SMALL_TEXT) { // small font 5x9
-            /* No bold for small */
-            max_x = SMALL_FONT_WIDTH;
-            max_y = SMALL_FONT_HEIGHT;
-            font_table = small_font;
-        } else if (textflags & BOLD_TEXT) { // bold font -> regular font + 1
-            max_x = NORMAL_FONT_WIDTH + 1;
-            max_y = NORMAL_FONT_HEIGHT;
-            font_table = ascii_font;
-            bold = 1;
-        } else { // regular font 7x14
-            max_x = NORMAL_FONT_WIDTH;
-            max_y = NORMAL_FONT_HEIGHT;
-            font_table = ascii_font;
-        }
-        glyph_mask = ((unsigned) 1) << (max_x - 1);
-        font_y = glyph_no * max_y;
-
-        if (xposn < 0) {
-            x_start = -xposn;
-            xposn = 0;
-        }
-
-        if (yposn + max_y > image_height) {
-            max_y = image_height - yposn;
-        }
-
-        linePtr = pixelbuf + (yposn * image_width) + xposn;
+    if ((runs = raster_glyph(symbol, font, glyph_no, font_table, max_x, max_y, bold, si, &run_cnt))) {
+        draw_stamp(pixelbuf, image_width, image_height, runs, run_cnt, xposn, yposn, DEFAULT_INK);
+    } else {
+        /* No memory for cache, so draw a row at a time */
+        struct raster_run row_runs[UPCEAN_FONT_WIDTH + 2]; /* Widest font + bold + 1 */
+        const int half_si = si / 2;
+        const int odd_si = si & 1;
+        int row = 0;
+        int y, y_si;
         for (y = 0; y < max_y; y++) {
-            int x_si, y_si;
-            unsigned char *pixelPtr = linePtr; /* Avoid warning */
-            for (y_si = 0; y_si < half_si; y_si++) {
-                int extra_dot = 0;
-                pixelPtr = linePtr;
-                maxPtr = linePtr + image_width - xposn;
-                for (x = x_start; x < max_x && pixelPtr < maxPtr; x++) {
-                    unsigned set = font_table[font_y + y] & (glyph_mask >> x);
-                    for (x_si = 0; x_si < half_si && pixelPtr < maxPtr; x_si++) {
-                        if (set) {
-                            *pixelPtr = DEFAULT_INK;
-                            extra_dot = bold;
-                        } else if (extra_dot) {
-                            *pixelPtr = DEFAULT_INK;
-                            extra_dot = 0;
-                        }
-                        pixelPtr++;
-                    }
-                    if (pixelPtr < maxPtr && odd_si && (x & 1)) {
-                        if (set) {
-                            *pixelPtr = DEFAULT_INK;
-                        }
-                        pixelPtr++;
-                    }
-                }
-                if (pixelPtr < maxPtr && extra_dot) {
-                    *pixelPtr++ = DEFAULT_INK;
-                }
-                linePtr += image_width;
-            }
-            if (odd_si && (y & 1)) {
-                memcpy(linePtr, linePtr - image_width, pixelPtr - (linePtr - image_width));
-                linePtr += image_width;
+            const int lines = half_si + (odd_si && (y & 1));
+            run_cnt = glyph_row_runs(row_runs, 0, font_table[glyph_no * max_y + y], max_x, bold, si);
+            for (y_si = 0; y_si < lines; y_si++, row++) {
+                draw_stamp(pixelbuf, image_width, image_height, row_runs, run_cnt, xposn, yposn + row, DEFAULT_INK);
             }
         }
     }
 }
 
 /* Plot a string into the pixel buffer */
-static void draw_string(unsigned char *pixbuf, const unsigned char input_string[], const int xposn, const int yposn,
-            const int textflags, const int image_width, const int image_height, const int si) {
+static void draw_string(struct zint_symbol *symbol, unsigned char *pixbuf, const unsigned char input_string[],
+            const int xposn, const int yposn, const int textflags, const int image_width, const int image_height,
+            const int si) {
     int i, string_length, string_left_hand, letter_width, letter_gap;
     int half_si = si / 2, odd_si = si & 1, x_incr;
 
@@ -449,28 +1423,33 @@ static void draw_string(unsigned char *pixbuf, const unsigned char input_string[
         if (odd_si) {
             x_incr += i * letter_width / 2;
         }
-        draw_letter(pixbuf, input_string[i], string_left_hand + x_incr, yposn, textflags, image_width, image_height, si);
+        draw_letter(symbol, pixbuf, input_string[i], string_left_hand + x_incr, yposn, textflags, image_width,
+                image_height, si);
     }
 }
 
-/* Draw disc using x² + y² <= r² */
-static void draw_circle(unsigned char *pixelbuf, const int image_width, const int image_height,
-            const int x0, const int y0, const float radius, const char fill) {
-    int x, y;
-    const int radius_i = (int) floorf(radius);
+/* Return stamp of disc of radius `radius_i` using x² + y² <= r², top left being (-radius_i, -radius_i) */
+static const struct raster_run *stamp_circle(struct zint_symbol *symbol, const int radius_i, int *p_runs) {
+    struct raster_run *runs;
     const int radius_squared = radius_i * radius_i;
+    int x, y;
 
+    if ((runs = (struct raster_run *) raster_stamp(symbol, RASTER_STAMP_CIRCLE, (float) radius_i, p_runs))) {
+        return runs;
+    }
+    if (!(runs = raster_stamp_buf(symbol, radius_i * 2 + 1))) {
+        return NULL;
+    }
     for (y = -radius_i; y <= radius_i; y++) {
-        const int y_squared = y * y;
-        for (x = -radius_i; x <= radius_i; x++) {
-            if ((x * x) + y_squared <= radius_squared) {
-                if ((y + y0 >= 0) && (y + y0 < image_height)
-                        && (x + x0 >= 0) && (x + x0 < image_width)) {
-                    *(pixelbuf + ((y + y0) * image_width) + (x + x0)) = fill;
-                }
-            }
-        }
+        for (x = radius_i; x * x + y * y > radius_squared; x--);
+        runs[y + radius_i].row = y + radius_i;
+        runs[y + radius_i].start = radius_i - x;
+        runs[y + radius_i].len = x * 2 + 1;
     }
+    *p_runs = radius_i * 2 + 1;
+    raster_stamp_set(symbol, RASTER_STAMP_CIRCLE, (float) radius_i, *p_runs);
+
+    return runs;
 }
 
 /* Helper for `draw_wp_circle()` to draw horizontal filler lines within disc */
@@ -487,7 +1466,7 @@ static void draw_mp_circle_lines(unsigned char *pixelbuf, const int image_width,
     }
 }
 
-/* Draw disc using Midpoint Circle Algorithm. Using this for MaxiCode rather than `draw_circle()` because it gives a
+/* Draw disc using Midpoint Circle Algorithm. Using this for MaxiCode rather than `stamp_circle()` because it gives a
  * flatter circumference with no single pixel peaks, similar to Figures J3 and J6 in ISO/IEC 16023:2000.
  * Taken from https://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
  * "Content is available under GNU Free Documentation License 1.2 unless otherwise noted."
@@ -544,21 +1523,6 @@ static void draw_bullseye(unsigned char *pixelbuf, const int image_width, const
     draw_mp_circle(pixelbuf, image_width, image_height, x, y, r1, DEFAULT_PAPER);
 }
 
-/* Put a hexagon into the pixel buffer */
-static void draw_hexagon(unsigned char *pixelbuf, const int image_width, const int image_height,
-            unsigned char *scaled_hexagon, const int hex_width, const int hex_height, const int xposn,
-            const int yposn) {
-    int i, j;
-
-    for (i = 0; i < hex_height; i++) {
-        for (j = 0; j < hex_width; j++) {
-            if (scaled_hexagon[(i * hex_width) + j] == DEFAULT_INK) {
-                draw_pt(pixelbuf, image_width, image_height, xposn + j, yposn + i, DEFAULT_INK);
-            }
-        }
-    }
-}
-
 /* Bresenham's line algorithm https://en.wikipedia.org/wiki/Bresenham's_line_algorithm
  * Creative Commons Attribution-ShareAlike License
  * https://en.wikipedia.org/wiki/Wikipedia:Text_of_Creative_Commons_Attribution-ShareAlike_3.0_Unported_License */
@@ -653,8 +1617,50 @@ static void plot_hexagon(unsigned char *scaled_hexagon, const int hex_width, con
     }
 }
 
+/* Return stamp of hexagon for scale `scaler`, rendering it with `plot_hexagon()` into the hex_width x hex_height
+   buffer `RASTER_SCALED` if not cached */
+static const struct raster_run *stamp_hexagon(struct zint_symbol *symbol, const float scaler, const int hex_width,
+            const int hex_height, const int hx_start, const int hy_start, const int hx_end, const int hy_end,
+            int *p_runs) {
+    struct raster_run *runs;
+    unsigned char *scaled_hexagon;
+    int run_cnt = 0;
+    int i, j;
+
+    if ((runs = (struct raster_run *) raster_stamp(symbol, RASTER_STAMP_HEXAGON, scaler, p_runs))) {
+        return runs;
+    }
+    if (!(scaled_hexagon = raster_scratch(symbol, RASTER_SCALED, (size_t) hex_width * hex_height))) {
+        return NULL;
+    }
+    memset(scaled_hexagon, DEFAULT_PAPER, (size_t) hex_width * hex_height);
+
+    plot_hexagon(scaled_hexagon, hex_width, hex_height, hx_start, hy_start, hx_end, hy_end);
+
+    if (!(runs = raster_stamp_buf(symbol, hex_height * ((hex_width + 1) / 2)))) {
+        return NULL;
+    }
+    for (i = 0; i < hex_height; i++) {
+        const unsigned char *line = scaled_hexagon + (size_t) i * hex_width;
+        for (j = 0; j < hex_width; j++) {
+            if (line[j] == DEFAULT_INK) {
+                runs[run_cnt].row = i;
+                runs[run_cnt].start = j;
+                for (j++; j < hex_width && line[j] == DEFAULT_INK; j++);
+                runs[run_cnt].len = j - runs[run_cnt].start;
+                run_cnt++;
+            }
+        }
+    }
+    *p_runs = run_cnt;
+    raster_stamp_set(symbol, RASTER_STAMP_HEXAGON, scaler, run_cnt);
+
+    return runs;
+}
+
 /* Plot a MaxiCode symbol with hexagons and bullseye */
-static int plot_raster_maxicode(struct zint_symbol *symbol, const int rotate_angle, const int file_type) {
+static int plot_raster_maxicode(struct zint_symbol *symbol, const int rotate_angle, const int file_type,
+            const struct zint_target *target) {
     int row, column;
     int image_height, image_width;
     unsigned char *pixelbuf;
@@ -662,7 +1668,8 @@ static int plot_raster_maxicode(struct zint_symbol *symbol, const int rotate_ang
     int xoffset, yoffset, roffset, boffset;
     float scaler = symbol->scale;
     int xoffset_scaled, yoffset_scaled;
-    unsigned char *scaled_hexagon;
+    const struct raster_run *hexagon;
+    int hexagon_runs;
     int hex_width, hex_height;
     int hx_start, hy_start, hx_end, hy_end;
     int hex_image_width, hex_image_height;
@@ -703,20 +1710,21 @@ static int plot_raster_maxicode(struct zint_symbol *symbol, const int rotate_ang
     image_width = (int) ceilf(hex_image_width + (xoffset + roffset) * scaler);
     image_height = (int) ceilf(hex_image_height + (yoffset + boffset) * scaler);
 
-    if (!(pixelbuf = (unsigned char *) malloc((size_t) image_width * image_height))) {
+    if (file_type == OUT_MEASURE) {
+        return raster_measure(symbol, image_width, image_height, 0.0f /*scaler*/, rotate_angle);
+    }
+
+    if (!(pixelbuf = raster_scratch(symbol, RASTER_PIXELBUF, (size_t) image_width * image_height))) {
         strcpy(symbol->errtxt, "655: Insufficient memory for pixel buffer");
         return ZINT_ERROR_ENCODING_PROBLEM;
     }
     memset(pixelbuf, DEFAULT_PAPER, (size_t) image_width * image_height);
 
-    if (!(scaled_hexagon = (unsigned char *) malloc((size_t) hex_width * hex_height))) {
+    if (!(hexagon = stamp_hexagon(symbol, scaler, hex_width, hex_height, hx_start, hy_start, hx_end, hy_end,
+                                    &hexagon_runs))) {
         strcpy(symbol->errtxt, "656: Insufficient memory for pixel buffer");
-        free(pixelbuf);
         return ZINT_ERROR_ENCODING_PROBLEM;
     }
-    memset(scaled_hexagon, DEFAULT_PAPER, (size_t) hex_width * hex_height);
-
-    plot_hexagon(scaled_hexagon, hex_width, hex_height, hx_start, hy_start, hx_end, hy_end);
 
     for (row = 0; row < symbol->rows; row++) {
         const int odd_row = row & 1; /* Odd (reduced) row, even (full) row */
@@ -725,7 +1733,7 @@ static int plot_raster_maxicode(struct zint_symbol *symbol, const int rotate_ang
         for (column = 0; column < symbol->width - odd_row; column++) {
             const int xposn = column * hex_width + xposn_offset;
             if (module_is_set(symbol, row, column)) {
-                draw_hexagon(pixelbuf, image_width, image_height, scaled_hexagon, hex_width, hex_height, xposn, yposn);
+                draw_stamp(pixelbuf, image_width, image_height, hexagon, hexagon_runs, xposn, yposn, DEFAULT_INK);
             }
         }
     }
@@ -752,11 +1760,8 @@ static int plot_raster_maxicode(struct zint_symbol *symbol, const int rotate_ang
         }
     }
 
-    error_number = save_raster_image_to_file(symbol, image_height, image_width, pixelbuf, rotate_angle, file_type);
-    free(scaled_hexagon);
-    if (rotate_angle || file_type != OUT_BUFFER || !(symbol->output_options & OUT_BUFFER_INTERMEDIATE)) {
-        free(pixelbuf);
-    }
+    error_number = save_raster_image_to_file(symbol, image_height, image_width, pixelbuf, RASTER_PIXELBUF,
+                    0.0f /*scaler*/, rotate_angle, file_type, target);
     if (error_number == 0) {
         /* Check whether size is compliant */
         const float size_ratio = (float) hex_image_width / hex_image_height;
@@ -800,16 +1805,82 @@ static void draw_bind_box(struct zint_symbol *symbol, unsigned char *pixelbuf, c
     }
 }
 
-static int plot_raster_dotty(struct zint_symbol *symbol, const int rotate_angle, const int file_type) {
+/* Number of bands of lines to render `image_width` x `image_height` image in, 1 unless RASTER_PARALLEL set and
+   the image large enough, setting `p_band_lines` to the lines of each (the last may have fewer) */
+static int raster_bands(const struct zint_symbol *symbol, const int image_width, const int image_height,
+            int *p_band_lines) {
+    int count = 1;
+
+    if ((symbol->output_options & RASTER_PARALLEL) && image_height > 1) {
+        const size_t bands = (size_t) image_width * image_height / RASTER_BAND_PIXELS;
+        count = bands > RASTER_THREADS ? RASTER_THREADS : bands < 1 ? 1 : (int) bands;
+    }
+    *p_band_lines = (image_height + count - 1) / count;
+
+    return (image_height + *p_band_lines - 1) / *p_band_lines;
+}
+
+/* A dotty mode image rendered in bands of lines, see `plot_raster_dotty()` */
+struct dotty_bands {
+    const struct zint_symbol *symbol;
+    unsigned char *pixelbuf;
+    int image_width;
+    int image_height;
+    int band_lines;
+    const struct raster_run *dot;
+    int dot_runs;
+    int dotradius_i;
+    float dotradius_scaled;
+    float dotoffset;
+    float scaler;
+    int xoffset;
+    int yoffset;
+};
+
+/* Task of `z_parallel()`, clearing band `index` and drawing the parts of the dots falling in it */
+static void dotty_band_task(void *arg, int index) {
+    const struct dotty_bands *bands = (const struct dotty_bands *) arg;
+    const struct zint_symbol *symbol = bands->symbol;
+    const int y0 = index * bands->band_lines;
+    const int lines = y0 + bands->band_lines > bands->image_height ? bands->image_height - y0 : bands->band_lines;
+    unsigned char *band = bands->pixelbuf + (size_t) bands->image_width * y0;
+    const float scaler = bands->scaler;
+    int r, i;
+
+    memset(band, DEFAULT_PAPER, (size_t) bands->image_width * lines);
+
+    for (r = 0; r < symbol->rows; r++) {
+        const int yposn = (int) floorf((r + bands->dotoffset + bands->yoffset) * scaler + bands->dotradius_scaled)
+                            - bands->dotradius_i;
+        if (yposn + bands->dotradius_i * 2 < y0 || yposn >= y0 + lines) {
+            continue;
+        }
+        for (i = 0; i < symbol->width; i++) {
+            if (module_is_set(symbol, r, i)) {
+                draw_stamp(band, bands->image_width, lines, bands->dot, bands->dot_runs,
+                        (int) floorf((i + bands->dotoffset + bands->xoffset) * scaler + bands->dotradius_scaled)
+                            - bands->dotradius_i,
+                        yposn - y0, DEFAULT_INK);
+            }
+        }
+    }
+}
+
+static int plot_raster_dotty(struct zint_symbol *symbol, const int rotate_angle, const int file_type,
+            const struct zint_target *target) {
     float scaler = 2 * symbol->scale;
     unsigned char *scaled_pixelbuf;
-    int r, i;
+    struct dotty_bands bands;
+    int band_count;
     int scale_width, scale_height;
     int error_number = 0;
     int xoffset, yoffset, roffset, boffset;
     float dot_overspill;
     float dotoffset;
     float dotradius_scaled;
+    int dotradius_i;
+    const struct raster_run *dot;
+    int dot_runs;
     int dot_overspill_scaled;
 
     if (scaler < 2.0f) {
@@ -835,35 +1906,43 @@ static int plot_raster_dotty(struct zint_symbol *symbol, const int rotate_angle,
     scale_width = (symbol->width + xoffset + roffset) * scaler + dot_overspill_scaled;
     scale_height = (symbol->height + yoffset + boffset) * scaler + dot_overspill_scaled;
 
+    if (file_type == OUT_MEASURE) {
+        return raster_measure(symbol, scale_width, scale_height, 0.0f /*scaler*/, rotate_angle);
+    }
+
     /* Apply scale options by creating another pixel buffer */
-    if (!(scaled_pixelbuf = (unsigned char *) malloc((size_t) scale_width * scale_height))) {
+    if (!(scaled_pixelbuf = raster_scratch(symbol, RASTER_SCALED, (size_t) scale_width * scale_height))) {
         strcpy(symbol->errtxt, "657: Insufficient memory for pixel buffer");
         return ZINT_ERROR_ENCODING_PROBLEM;
     }
-    memset(scaled_pixelbuf, DEFAULT_PAPER, (size_t) scale_width * scale_height);
 
-    /* Plot the body of the symbol to the pixel buffer */
+    /* Plot the body of the symbol to the pixel buffer, in bands of lines on multiple threads if RASTER_PARALLEL */
     dotradius_scaled = (symbol->dot_size * scaler) / 2.0f;
-    for (r = 0; r < symbol->rows; r++) {
-        float row_scaled = (r + dotoffset + yoffset) * scaler + dotradius_scaled;
-        for (i = 0; i < symbol->width; i++) {
-            if (module_is_set(symbol, r, i)) {
-                draw_circle(scaled_pixelbuf, scale_width, scale_height,
-                        (int) floorf((i + dotoffset + xoffset) * scaler + dotradius_scaled),
-                        (int) floorf(row_scaled),
-                        (int) floorf(dotradius_scaled),
-                        DEFAULT_INK);
-            }
-        }
+    dotradius_i = (int) floorf(dotradius_scaled);
+    if (!(dot = stamp_circle(symbol, dotradius_i, &dot_runs))) {
+        strcpy(symbol->errtxt, "678: Insufficient memory for pixel buffer");
+        return ZINT_ERROR_ENCODING_PROBLEM;
     }
+    bands.symbol = symbol;
+    bands.pixelbuf = scaled_pixelbuf;
+    bands.image_width = scale_width;
+    bands.image_height = scale_height;
+    bands.dot = dot;
+    bands.dot_runs = dot_runs;
+    bands.dotradius_i = dotradius_i;
+    bands.dotradius_scaled = dotradius_scaled;
+    bands.dotoffset = dotoffset;
+    bands.scaler = scaler;
+    bands.xoffset = xoffset;
+    bands.yoffset = yoffset;
+    band_count = raster_bands(symbol, scale_width, scale_height, &bands.band_lines);
+    z_parallel(symbol, dotty_band_task, &bands, band_count, band_count);
 
     draw_bind_box(symbol, scaled_pixelbuf, xoffset, roffset, 0 /*textoffset*/, dot_overspill_scaled,
                     scale_width, scale_height, (int) floorf(scaler));
 
-    error_number = save_raster_image_to_file(symbol, scale_height, scale_width, scaled_pixelbuf, rotate_angle, file_type);
-    if (rotate_angle || file_type != OUT_BUFFER || !(symbol->output_options & OUT_BUFFER_INTERMEDIATE)) {
-        free(scaled_pixelbuf);
-    }
+    error_number = save_raster_image_to_file(symbol, scale_height, scale_width, scaled_pixelbuf, RASTER_SCALED,
+                    0.0f /*scaler*/, rotate_angle, file_type, target);
 
     return error_number;
 }
@@ -909,7 +1988,133 @@ static void to_iso8859_1(const unsigned char source[], unsigned char preprocesse
     return;
 }
 
-static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angle, const int file_type) {
+/* Draw the bars (or for Ultracode colour blocks) of `this_row` on line `line` (top down), copying it to the
+   following `lines - 1` lines */
+static void plot_row_lines(const struct zint_symbol *symbol, unsigned char *pixelbuf, const int this_row,
+            const int line, const int lines, const int xoffset, const int si, const int image_width) {
+    unsigned char *top = pixelbuf + (size_t) image_width * line;
+    int i = 0, j;
+
+    if (lines <= 0) {
+        return;
+    }
+    if (symbol->symbology == BARCODE_ULTRA) {
+        do {
+            const int module_fill = module_colour_is_set(symbol, this_row, i);
+            int block_width = 0;
+            do {
+                block_width++;
+            } while (i + block_width < symbol->width
+                    && module_colour_is_set(symbol, this_row, i + block_width) == module_fill);
+            if (module_fill) {
+                memset(top + (i + xoffset) * si, ultra_colour[module_fill], block_width * si);
+            }
+            i += block_width;
+        } while (i < symbol->width);
+    } else {
+        do {
+            const int block_width = module_run_length(symbol, this_row, i);
+            if (module_is_set(symbol, this_row, i)) {
+                memset(top + (i + xoffset) * si, DEFAULT_INK, block_width * si);
+            }
+            i += block_width;
+        } while (i < symbol->width);
+    }
+    for (j = 1; j < lines; j++) {
+        memcpy(top + (size_t) image_width * j, top, image_width);
+    }
+}
+
+/* Whether a 4-state postal symbology, whose 3 rows (ascender, tracker, descender) are made up of just 4 kinds of
+   bar - full, ascender, descender and tracker */
+static int is_4state(const int symbology) {
+
+    switch (symbology) {
+        case BARCODE_AUSPOST:
+        case BARCODE_AUSREPLY:
+        case BARCODE_AUSROUTE:
+        case BARCODE_AUSREDIRECT:
+        case BARCODE_RM4SCC:
+        case BARCODE_KIX:
+        case BARCODE_JAPANPOST:
+        case BARCODE_USPS_IMAIL:
+        case BARCODE_DAFT:
+        case BARCODE_MAILMARK:
+            return 1;
+            break;
+    }
+
+    return 0;
+}
+
+/* Stamp the bars of a 4-state symbol into `row_lines`, the `image_width` line of each of its 3 rows, in one pass
+   over the columns. Each row being the same line throughout, `row_band_task()` then only needs to copy them */
+static void plot_4state_lines(const struct zint_symbol *symbol, unsigned char *row_lines, const int xoffset,
+            const int si, const int image_width) {
+    int i, r;
+
+    memset(row_lines, DEFAULT_PAPER, (size_t) image_width * 3);
+
+    for (i = 0; i < symbol->width; i++) {
+        /* Bar kind as bit flags of the rows it covers (0 for a space) */
+        const int kind = module_is_set(symbol, 0, i) | (module_is_set(symbol, 1, i) << 1)
+                            | (module_is_set(symbol, 2, i) << 2);
+        if (kind) {
+            unsigned char *column = row_lines + (i + xoffset) * si;
+            for (r = 0; r < 3; r++) {
+                if (kind & (1 << r)) {
+                    memset(column + (size_t) image_width * r, DEFAULT_INK, si);
+                }
+            }
+        }
+    }
+}
+
+/* The rows of a (non-UPC/EAN) symbol rendered in bands of lines, see `plot_raster_default()` */
+struct row_bands {
+    const struct zint_symbol *symbol;
+    unsigned char *pixelbuf;
+    const unsigned char *row_lines; /* If non-NULL the line of each row, pre-rendered (4-state only) */
+    int image_width;
+    int image_height;
+    int band_lines;
+    int xoffset;
+    int si;
+    int line[200]; /* First line (top down) of each row */
+    int lines[200]; /* Height of each row in lines */
+};
+
+/* Task of `z_parallel()`, clearing band `index` and drawing the parts of the rows falling in it */
+static void row_band_task(void *arg, int index) {
+    const struct row_bands *bands = (const struct row_bands *) arg;
+    const struct zint_symbol *symbol = bands->symbol;
+    const int y0 = index * bands->band_lines;
+    const int y1 = y0 + bands->band_lines > bands->image_height ? bands->image_height : y0 + bands->band_lines;
+    int r;
+
+    memset(bands->pixelbuf + (size_t) bands->image_width * y0, DEFAULT_PAPER,
+            (size_t) bands->image_width * (y1 - y0));
+
+    for (r = 0; r < symbol->rows; r++) {
+        const int start = bands->line[r] > y0 ? bands->line[r] : y0;
+        const int end = bands->line[r] + bands->lines[r] < y1 ? bands->line[r] + bands->lines[r] : y1;
+        if (start < end) {
+            if (bands->row_lines) {
+                const unsigned char *row_line = bands->row_lines + (size_t) bands->image_width * r;
+                int j;
+                for (j = start; j < end; j++) {
+                    memcpy(bands->pixelbuf + (size_t) bands->image_width * j, row_line, bands->image_width);
+                }
+            } else {
+                plot_row_lines(symbol, bands->pixelbuf, r, start, end - start, bands->xoffset, bands->si,
+                                bands->image_width);
+            }
+        }
+    }
+}
+
+static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angle, const int file_type,
+            const struct zint_target *target) {
     int error_number;
     float large_bar_height;
     int textdone = 0;
@@ -935,14 +2140,13 @@ static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angl
     int guardoffset = 0;
     int image_width, image_height;
     unsigned char *pixelbuf;
+    struct row_bands bands;
+    int band_count;
     int next_yposn;
     int latch;
     float scaler = symbol->scale;
     int si;
     int half_int_scaling;
-    int scale_width, scale_height;
-    unsigned char *scaled_pixelbuf;
-    int horiz, vert;
 
     /* Ignore scaling < 0.5 for raster as would drop modules */
     if (scaler < 0.5f) {
@@ -995,11 +2199,17 @@ static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angl
     image_width = (symbol->width + xoffset + roffset) * si;
     image_height = (symbol->height + textoffset + yoffset + boffset) * si;
 
-    if (!(pixelbuf = (unsigned char *) malloc((size_t) image_width * image_height))) {
+    if (file_type == OUT_MEASURE) {
+        return raster_measure(symbol, image_width, image_height, half_int_scaling ? 0.0f : scaler, rotate_angle);
+    }
+
+    if (!(pixelbuf = raster_scratch(symbol, RASTER_PIXELBUF, (size_t) image_width * image_height))) {
         strcpy(symbol->errtxt, "658: Insufficient memory for pixel buffer");
         return ZINT_ERROR_ENCODING_PROBLEM;
     }
-    memset(pixelbuf, DEFAULT_PAPER, (size_t) image_width * image_height);
+    if (upceanflag) {
+        memset(pixelbuf, DEFAULT_PAPER, (size_t) image_width * image_height);
+    }
 
     default_text_posn = image_height - (textoffset - text_gap + symbol->whitespace_height) * si;
 
@@ -1021,32 +2231,23 @@ static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angl
         plot_yposn *= si;
         plot_height *= si;
 
-        i = 0;
-
-        if (symbol->symbology == BARCODE_ULTRA) {
-            do {
-                int module_fill = module_colour_is_set(symbol, this_row, i);
-                int block_width = 0;
-                do {
-                    block_width++;
-                } while ((i + block_width < symbol->width) && module_colour_is_set(symbol, this_row, i + block_width) == module_fill);
-
-                if (module_fill) {
-                    /* a colour block */
-                    draw_bar(pixelbuf, (i + xoffset) * si, block_width * si, plot_yposn, plot_height, image_width, image_height, ultra_colour[module_fill]);
-                }
-                i += block_width;
-
-            } while (i < symbol->width);
+        if (!upceanflag) {
+            /* Rows other than UPC/EAN are drawn below, in bands of lines on multiple threads if RASTER_PARALLEL */
+            bands.line[this_row] = image_height - plot_yposn - (int) plot_height;
+            bands.lines[this_row] = (int) plot_height;
         } else {
+            /* The row's bars are drawn one line high, at the top of the row, which is then copied down (UPC/EAN
+               add-on bars, which differ in height, are drawn in full afterwards) */
+            const int band_yposn = plot_yposn, band_height = (int) plot_height;
+            int band_done = 0;
+            i = 0;
             do {
                 int module_fill = module_is_set(symbol, this_row, i);
-                int block_width = 0;
-                do {
-                    block_width++;
-                } while ((i + block_width < symbol->width) && module_is_set(symbol, this_row, i + block_width) == module_fill);
+                const int block_width = module_run_length(symbol, this_row, i);
 
                 if (upceanflag && (addon_latch == 0) && (r == 0) && (i > main_width)) {
+                    copy_bar_line(pixelbuf, band_yposn, band_height, image_width, image_height);
+                    band_done = 1;
                     plot_height = row_height - (text_height + text_gap) + 5.0f;
                     plot_yposn = row_posn - 5.0f;
                     if (plot_yposn < 0.0f) {
@@ -1067,12 +2268,39 @@ static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angl
                 }
                 if (module_fill) {
                     /* a bar */
-                    draw_bar(pixelbuf, (i + xoffset) * si, block_width * si, plot_yposn, plot_height, image_width, image_height, DEFAULT_INK);
+                    if (band_done) {
+                        draw_bar(pixelbuf, (i + xoffset) * si, block_width * si, plot_yposn, plot_height, image_width, image_height, DEFAULT_INK);
+                    } else if (band_height > 0) {
+                        draw_bar(pixelbuf, (i + xoffset) * si, block_width * si, band_yposn + band_height - 1, 1, image_width, image_height, DEFAULT_INK);
+                    }
                 }
                 i += block_width;
 
             } while (i < symbol->width);
+            if (!band_done) {
+                copy_bar_line(pixelbuf, band_yposn, band_height, image_width, image_height);
+            }
+        }
+    }
+    if (!upceanflag) {
+        bands.symbol = symbol;
+        bands.pixelbuf = pixelbuf;
+        bands.image_width = image_width;
+        bands.image_height = image_height;
+        bands.xoffset = xoffset;
+        bands.si = si;
+        bands.row_lines = NULL;
+        /* 4-state rows are each a single line repeated, so stamp them once up front (drawn generically if no
+           memory) */
+        if (symbol->rows == 3 && is_4state(symbol->symbology)) {
+            unsigned char *row_lines = raster_scratch(symbol, RASTER_ROW_LINES, (size_t) image_width * 3);
+            if (row_lines) {
+                plot_4state_lines(symbol, row_lines, xoffset, si, image_width);
+                bands.row_lines = row_lines;
+            }
         }
+        band_count = raster_bands(symbol, image_width, image_height, &bands.band_lines);
+        z_parallel(symbol, row_band_task, &bands, band_count, band_count);
     }
 
     xoffset += comp_offset;
@@ -1100,11 +2328,7 @@ static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angl
 
             i = 0 + comp_offset;
             do {
-                int module_fill = module_is_set(symbol, symbol->rows - 1, i);
-                int block_width = 0;
-                do {
-                    block_width++;
-                } while ((i + block_width < symbol->width) && module_is_set(symbol, symbol->rows - 1, i + block_width) == module_fill);
+                const int block_width = module_run_length(symbol, symbol->rows - 1, i);
                 if (latch == 1) {
                     /* a bar */
                     draw_bar(pixelbuf, (i + xoffset - comp_offset) * si, block_width * si, guardoffset * si, 5 * si, image_width, image_height, DEFAULT_INK);
@@ -1120,11 +2344,7 @@ static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angl
             latch = 1;
             i = 85 + comp_offset;
             do {
-                int module_fill = module_is_set(symbol, symbol->rows - 1, i);
-                int block_width = 0;
-                do {
-                    block_width++;
-                } while ((i + block_width < symbol->width) && module_is_set(symbol, symbol->rows - 1, i + block_width) == module_fill);
+                const int block_width = module_run_length(symbol, symbol->rows - 1, i);
                 if (latch == 1) {
                     /* a bar */
                     draw_bar(pixelbuf, (i + xoffset - comp_offset) * si, block_width * si, guardoffset * si, 5 * si, image_width, image_height, DEFAULT_INK);
@@ -1158,77 +2378,77 @@ static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angl
 
             if (upceanflag == 6) { /* UPC-E */
                 textpos = (-(5 + upcea_width_adj) + xoffset) * si;
-                draw_string(pixelbuf, textpart1, textpos, default_text_posn + upcea_height_adj, textflags | SMALL_TEXT, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart1, textpos, default_text_posn + upcea_height_adj, textflags | SMALL_TEXT, image_width, image_height, si);
                 textpos = (24 + xoffset) * si;
-                draw_string(pixelbuf, textpart2, textpos, default_text_posn, textflags, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart2, textpos, default_text_posn, textflags, image_width, image_height, si);
                 textpos = (51 + 3 + upcea_width_adj + xoffset) * si;
-                draw_string(pixelbuf, textpart3, textpos, default_text_posn + upcea_height_adj, textflags | SMALL_TEXT, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart3, textpos, default_text_posn + upcea_height_adj, textflags | SMALL_TEXT, image_width, image_height, si);
                 textdone = 1;
                 switch (ustrlen(addon)) {
                     case 2:
                         textpos = (61 + xoffset + addon_gap) * si;
-                        draw_string(pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
+                        draw_string(symbol, pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
                         break;
                     case 5:
                         textpos = (75 + xoffset + addon_gap) * si;
-                        draw_string(pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
+                        draw_string(symbol, pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
                         break;
                 }
 
             } else if (upceanflag == 8) { /* EAN-8 */
                 textpos = (17 + xoffset) * si;
-                draw_string(pixelbuf, textpart1, textpos, default_text_posn, textflags, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart1, textpos, default_text_posn, textflags, image_width, image_height, si);
                 textpos = (50 + xoffset) * si;
-                draw_string(pixelbuf, textpart2, textpos, default_text_posn, textflags, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart2, textpos, default_text_posn, textflags, image_width, image_height, si);
                 textdone = 1;
                 switch (ustrlen(addon)) {
                     case 2:
                         textpos = (77 + xoffset + addon_gap) * si;
-                        draw_string(pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
+                        draw_string(symbol, pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
                         break;
                     case 5:
                         textpos = (91 + xoffset + addon_gap) * si;
-                        draw_string(pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
+                        draw_string(symbol, pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
                         break;
                 }
 
             } else if (upceanflag == 12) { /* UPC-A */
                 textpos = (-(5 + upcea_width_adj) + xoffset) * si;
-                draw_string(pixelbuf, textpart1, textpos, default_text_posn + upcea_height_adj, textflags | SMALL_TEXT, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart1, textpos, default_text_posn + upcea_height_adj, textflags | SMALL_TEXT, image_width, image_height, si);
                 textpos = (27 + xoffset) * si;
-                draw_string(pixelbuf, textpart2, textpos, default_text_posn, textflags, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart2, textpos, default_text_posn, textflags, image_width, image_height, si);
                 textpos = (67 + xoffset) * si;
-                draw_string(pixelbuf, textpart3, textpos, default_text_posn, textflags, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart3, textpos, default_text_posn, textflags, image_width, image_height, si);
                 textpos = (95 + 5 + upcea_width_adj + xoffset) * si;
-                draw_string(pixelbuf, textpart4, textpos, default_text_posn + upcea_height_adj, textflags | SMALL_TEXT, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart4, textpos, default_text_posn + upcea_height_adj, textflags | SMALL_TEXT, image_width, image_height, si);
                 textdone = 1;
                 switch (ustrlen(addon)) {
                     case 2:
                         textpos = (105 + xoffset + addon_gap) * si;
-                        draw_string(pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
+                        draw_string(symbol, pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
                         break;
                     case 5:
                         textpos = (119 + xoffset + addon_gap) * si;
-                        draw_string(pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
+                        draw_string(symbol, pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
                         break;
                 }
 
             } else if (upceanflag == 13) { /* EAN-13 */
                 textpos = (-(5 + ean_width_adj) + xoffset) * si;
-                draw_string(pixelbuf, textpart1, textpos, default_text_posn, textflags, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart1, textpos, default_text_posn, textflags, image_width, image_height, si);
                 textpos = (24 + xoffset) * si;
-                draw_string(pixelbuf, textpart2, textpos, default_text_posn, textflags, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart2, textpos, default_text_posn, textflags, image_width, image_height, si);
                 textpos = (71 + xoffset) * si;
-                draw_string(pixelbuf, textpart3, textpos, default_text_posn, textflags, image_width, image_height, si);
+                draw_string(symbol, pixelbuf, textpart3, textpos, default_text_posn, textflags, image_width, image_height, si);
                 textdone = 1;
                 switch (ustrlen(addon)) {
                     case 2:
                         textpos = (105 + xoffset + addon_gap) * si;
-                        draw_string(pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
+                        draw_string(symbol, pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
                         break;
                     case 5:
                         textpos = (119 + xoffset + addon_gap) * si;
-                        draw_string(pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
+                        draw_string(symbol, pixelbuf, addon, textpos, addon_text_posn, textflags, image_width, image_height, si);
                         break;
                 }
             }
@@ -1239,7 +2459,7 @@ static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angl
             to_iso8859_1(symbol->text, local_text);
             /* Put the human readable text at the bottom */
             textpos = (main_width / 2 + xoffset) * si;
-            draw_string(pixelbuf, local_text, textpos, default_text_posn, textflags, image_width, image_height, si);
+            draw_string(symbol, pixelbuf, local_text, textpos, default_text_posn, textflags, image_width, image_height, si);
         }
     }
 
@@ -1272,62 +2492,169 @@ static int plot_raster_default(struct zint_symbol *symbol, const int rotate_angl
 
     draw_bind_box(symbol, pixelbuf, xoffset, roffset, textoffset, 0 /*overspill*/, image_width, image_height, si);
 
-    if (!half_int_scaling) {
-        scale_width = image_width * scaler;
-        scale_height = image_height * scaler;
-
-        /* Apply scale options by creating another pixel buffer */
-        if (!(scaled_pixelbuf = (unsigned char *) malloc((size_t) scale_width * scale_height))) {
-            free(pixelbuf);
-            strcpy(symbol->errtxt, "659: Insufficient memory for pixel buffer");
-            return ZINT_ERROR_ENCODING_PROBLEM;
-        }
-        memset(scaled_pixelbuf, DEFAULT_PAPER, (size_t) scale_width * scale_height);
-
-        for (vert = 0; vert < scale_height; vert++) {
-            int vert_row = vert * scale_width;
-            int image_vert_row = ((int) (vert / scaler)) * image_width;
-            for (horiz = 0; horiz < scale_width; horiz++) {
-                *(scaled_pixelbuf + vert_row + horiz) = *(pixelbuf + image_vert_row + (int) (horiz / scaler));
-            }
-        }
-
-        error_number = save_raster_image_to_file(symbol, scale_height, scale_width, scaled_pixelbuf, rotate_angle, file_type);
-        if (rotate_angle || file_type != OUT_BUFFER || !(symbol->output_options & OUT_BUFFER_INTERMEDIATE)) {
-            free(scaled_pixelbuf);
-        }
-        free(pixelbuf);
-    } else {
-        error_number = save_raster_image_to_file(symbol, image_height, image_width, pixelbuf, rotate_angle, file_type);
-        if (rotate_angle || file_type != OUT_BUFFER || !(symbol->output_options & OUT_BUFFER_INTERMEDIATE)) {
-            free(pixelbuf);
-        }
-    }
+    /* Apply any non-half-integer scaling while outputting */
+    error_number = save_raster_image_to_file(symbol, image_height, image_width, pixelbuf, RASTER_PIXELBUF,
+                    half_int_scaling ? 0.0f : scaler, rotate_angle, file_type, target);
     return error_number;
 }
 
-INTERNAL int plot_raster(struct zint_symbol *symbol, int rotate_angle, int file_type) {
+/* Plot to file or buffer `file_type`, or into caller's buffer `target` if non-NULL (`file_type` OUT_BUFFER) */
+static int raster_plot(struct zint_symbol *symbol, const int rotate_angle, const int file_type,
+            const struct zint_target *target) {
     int error;
 
-#ifdef NO_PNG
-    if (file_type == OUT_PNG_FILE) {
-        strcpy(symbol->errtxt, "660: PNG format disabled at compile time");
-        return ZINT_ERROR_INVALID_OPTION;
-    }
-#endif /* NO_PNG */
-
     error = output_check_colour_options(symbol);
     if (error != 0) {
         return error;
     }
 
+    z_trace(symbol, ZINT_PHASE_RASTER, ZINT_TRACE_BEGIN, symbol->rows * symbol->width);
+
     if (symbol->symbology == BARCODE_MAXICODE) {
-        error = plot_raster_maxicode(symbol, rotate_angle, file_type);
+        error = plot_raster_maxicode(symbol, rotate_angle, file_type, target);
     } else if (symbol->output_options & BARCODE_DOTTY_MODE) {
-        error = plot_raster_dotty(symbol, rotate_angle, file_type);
+        error = plot_raster_dotty(symbol, rotate_angle, file_type, target);
     } else {
-        error = plot_raster_default(symbol, rotate_angle, file_type);
+        error = plot_raster_default(symbol, rotate_angle, file_type, target);
     }
 
+    z_trace(symbol, ZINT_PHASE_RASTER, ZINT_TRACE_END,
+            error >= ZINT_ERROR ? -1 : symbol->bitmap_width * symbol->bitmap_height);
+
     return error;
 }
+
+INTERNAL int plot_raster(struct zint_symbol *symbol, int rotate_angle, int file_type) {
+    return raster_plot(symbol, rotate_angle, file_type, NULL /*target*/);
+}
+
+/* Plot into caller's buffer `target`, which is assumed valid (see `ZBarcode_Buffer_Target()`) */
+INTERNAL int plot_raster_target(struct zint_symbol *symbol, int rotate_angle, const struct zint_target *target) {
+    return raster_plot(symbol, rotate_angle, OUT_BUFFER, target);
+}
+
+/* Write the raster `targets` of `count` (others ignored). If more than one, the symbol is plotted once as
+   OUT_BUFFER_INTERMEDIATE (left in `symbol->bitmap`), scaled and rotated, and each written from that, except that
+   if anti-aliasing PNG along with other formats, which can't take the anti-aliased levels, the PNGs are plotted
+   separately. Stops on the first error */
+INTERNAL int plot_raster_multi(struct zint_symbol *symbol, int rotate_angle, const struct out_target *targets,
+            const int count) {
+    const int output_options = symbol->output_options;
+    int num_rasters = 0, num_pngs = 0;
+    int separate_pngs, shared;
+    int warn_number = 0;
+    int error_number;
+    int pass, i;
+
+    for (i = 0; i < count; i++) {
+        if (targets[i].file_type >= OUT_PNG_FILE) {
+            num_rasters++;
+            num_pngs += targets[i].file_type == OUT_PNG_FILE;
+        }
+    }
+    separate_pngs = (output_options & BARCODE_ANTIALIAS) && num_pngs && num_pngs != num_rasters;
+    shared = num_rasters - (separate_pngs ? num_pngs : 0) > 1;
+
+    if (shared) {
+        symbol->output_options = (output_options & ~(OUT_BUFFER_1BPP | OUT_BUFFER_RGBA
+                                                        | (separate_pngs ? BARCODE_ANTIALIAS : 0)))
+                                    | OUT_BUFFER_INTERMEDIATE;
+        error_number = raster_plot(symbol, rotate_angle, OUT_BUFFER, NULL /*target*/);
+        symbol->output_options = output_options;
+        if (error_number >= ZINT_ERROR) {
+            return error_number;
+        }
+        warn_number = error_number;
+    }
+
+    /* Written from the shared image first, as plotting separately may reuse its buffer */
+    for (pass = shared ? 0 : 1; pass < 2; pass++) {
+        for (i = 0; i < count; i++) {
+            if (targets[i].file_type < OUT_PNG_FILE
+                    || (!shared || (separate_pngs && targets[i].file_type == OUT_PNG_FILE)) != pass) {
+                continue;
+            }
+            strcpy(symbol->outfile, targets[i].outfile);
+            symbol->output_options = output_options | targets[i].output_options;
+            if (pass == 0) {
+                error_number = raster_write(symbol, targets[i].file_type, symbol->bitmap);
+            } else {
+                error_number = raster_plot(symbol, rotate_angle, targets[i].file_type, NULL /*target*/);
+            }
+            symbol->output_options = output_options;
+            if (error_number >= ZINT_ERROR) {
+                return error_number;
+            }
+            if (error_number > warn_number) {
+                warn_number = error_number;
+            }
+        }
+    }
+
+    return warn_number;
+}
+
+/* Render encoded symbols `items` onto a `width` x `height` sheet in the background colour of `sheet` and output it
+   once as `file_type`. Each symbol is plotted as pixelbuffer values straight into the sheet (so in the sheet's
+   colours), borrowing the sheet's scratch buffers so that glyph and stamp caches are shared between them.
+   Anti-aliased only if the sheet is PNG with BARCODE_ANTIALIAS, whatever the items' options. Items are assumed
+   valid (see `ZBarcode_Print_Sheet()`) */
+INTERNAL int plot_raster_sheet(struct zint_symbol *sheet, const int width, const int height,
+            const struct zint_sheet_item *items, const int count, const int file_type) {
+    const int antialias = file_type == OUT_PNG_FILE && (sheet->output_options & BARCODE_ANTIALIAS);
+    const size_t size = (size_t) width * height;
+    struct zint_target target;
+    unsigned char *page;
+    int error_number;
+    int i;
+
+    error_number = output_check_colour_options(sheet);
+    if (error_number != 0) {
+        return error_number;
+    }
+
+    if (!(page = raster_scratch(sheet, RASTER_SHEET, size))) {
+        strcpy(sheet->errtxt, "671: Insufficient memory for sheet buffer");
+        return ZINT_ERROR_MEMORY;
+    }
+    memset(page, DEFAULT_PAPER, size);
+
+    target.pixels = page;
+    target.stride = width;
+    target.width = width;
+    target.height = height;
+    target.format = RASTER_PIXEL_VALUES;
+
+    for (i = 0; i < count; i++) {
+        struct zint_symbol *const symbol = items[i].symbol;
+        struct zint_scratch *const own_scratch = symbol->internal->scratch;
+        const int output_options = symbol->output_options;
+
+        /* Release with its own scratch buffers before borrowing the sheet's */
+        raster_release_bitmap(symbol);
+        symbol->internal->scratch = sheet->internal->scratch;
+        symbol->output_options = (output_options & ~BARCODE_ANTIALIAS) | (antialias ? BARCODE_ANTIALIAS : 0);
+
+        target.x = items[i].x;
+        target.y = items[i].y;
+        error_number = raster_plot(symbol, items[i].rotate_angle, OUT_BUFFER, &target);
+
+        symbol->output_options = output_options;
+        symbol->internal->scratch = own_scratch;
+
+        if (error_number >= ZINT_ERROR) {
+            sprintf(sheet->errtxt, "684: Sheet item %d: %.60s", i, symbol->errtxt);
+            return error_number;
+        }
+    }
+
+    return save_raster_image_to_file(sheet, height, width, page, RASTER_SHEET, 0.0f /*scaler*/, 0 /*rotate_angle*/,
+                file_type, NULL /*target*/);
+}
+
+/* Page in the fonts (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t raster_fonts_warm(const int touch) {
+    return z_table_warm(ascii_font, sizeof(ascii_font), touch) + z_table_warm(small_font, sizeof(small_font), touch)
+            + z_table_warm(upcean_font, sizeof(upcean_font), touch)
+            + z_table_warm(upcean_small_font, sizeof(upcean_small_font), touch);
+}
@@ -0,0 +1,96 @@
+/*  raster.h - row access to raster images for the raster file formats */
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+
+#ifndef RASTER_H
+#define RASTER_H
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+struct remap;
+
+/* Rows of a `symbol->bitmap_width` by `symbol->bitmap_height` raster image as given to the raster file formats,
+   either from a complete pixel buffer or, when the image is scaled or rotated, made from the unscaled image on
+   demand a band at a time, so that the full-size image is never held in memory */
+struct raster_rows {
+    const unsigned char *image; /* Complete image, or NULL if rows are made on demand */
+    const unsigned char *pixelbuf; /* Unscaled, unrotated image rows are made from */
+    const struct remap *rm;
+    int width;
+    int band_rows; /* Rows per band */
+    unsigned char *band[2]; /* Alternated so that the row returned before stays valid */
+    int band_start[2]; /* First row of each band, -1 if none */
+    int cur; /* Band last returned from */
+    int prev_base; /* Image row offset of the row in `band[cur]` (rotations 0 and 180 only) */
+};
+
+/* Coverage levels of anti-aliased (BARCODE_ANTIALIAS) images, level 0 being paper '0', 1 to RASTER_AA_LEVELS - 1
+   partial ink '2' to '?' and RASTER_AA_LEVELS ink '1' */
+#define RASTER_AA_LEVELS        15
+#define RASTER_AA_IS_LEVEL(ch)  ((ch) >= '2' && (ch) <= '?')
+#define RASTER_AA_LEVEL(ch)     ((ch) - '1')
+
+/* Blend colour component `bg` to `fg` by coverage level `level` */
+#define RASTER_AA_BLEND(bg, fg, level) \
+            (((bg) * (RASTER_AA_LEVELS - (level)) + (fg) * (level) + RASTER_AA_LEVELS / 2) / RASTER_AA_LEVELS)
+
+/* Set up `rows` for complete image `pixelbuf` */
+INTERNAL void raster_rows_image(struct raster_rows *rows, const struct zint_symbol *symbol,
+                const unsigned char *pixelbuf);
+
+/* Return row `row` of the image. The row returned by the previous call remains valid */
+INTERNAL const unsigned char *raster_rows_get(struct raster_rows *rows, const int row);
+
+/* Return output format work buffer `index` (0 or 1) of at least `size` bytes, kept across calls with the symbol's
+   scratch buffers and freed by `ZBarcode_Delete()` (NULL on failure, contents are not preserved) */
+INTERNAL unsigned char *raster_output_buffer(struct zint_symbol *symbol, const int index, const size_t size);
+
+/* Return slot for output format state kept across calls with the symbol's scratch buffers (NULL on failure),
+   `free_fn` being called on it by `ZBarcode_Delete()` */
+INTERNAL void **raster_output_context(struct zint_symbol *symbol, void (*free_fn)(void *context));
+
+/* Plot `symbol` to `file_type` (OUT_BUFFER for `symbol->bitmap`) */
+INTERNAL int plot_raster(struct zint_symbol *symbol, int rotate_angle, int file_type);
+
+INTERNAL int png_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows);
+INTERNAL int bmp_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows);
+INTERNAL int tif_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RASTER_H */
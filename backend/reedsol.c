@@ -48,10 +48,14 @@
 // replaced with constants in the obvious way, and additionally
 // malloc/free can be avoided by using static arrays of a suitable
 // size.
-// Note: use of statics has been done for (up to) 8-bit tables.
+// Note: use of statics has been done for (up to) 8-bit tables and for the
+// 10-bit and 12-bit Aztec Code tables.
 
-#ifdef _MSC_VER
+#ifndef _MSC_VER
+#include <stdint.h>
+#else
 #include <malloc.h>
+#include "ms_stdint.h"
 #endif
 #include "common.h"
 #include "reedsol.h"
@@ -60,7 +64,7 @@
 // rs_init_gf(&rs, prime_poly) initialises the parameters for the Galois Field.
 // The symbol size is determined from the highest bit set in poly
 // This implementation will support sizes up to 8 bits (see rs_uint_init_gf()
-// for sizes > 8 bits and <= 30 bits) - bit sizes of 8 or 4 are typical
+// for sizes > 8 bits and <= 12 bits) - bit sizes of 8 or 4 are typical
 //
 // The poly is the bit pattern representing the GF characteristic
 // polynomial.  e.g. for ECC200 (8-bit symbols) the polynomial is
@@ -95,6 +99,11 @@ INTERNAL void rs_init_gf(rs_t *rs, const unsigned int prime_poly) {
 
     rs->logt = data[hash].logt;
     rs->alog = data[hash].alog;
+    /* Field characteristic 2**bitlength - 1 from the highest bit set in poly */
+    rs->logmod = 1;
+    while ((prime_poly >> 1) > (unsigned int) rs->logmod) {
+        rs->logmod = rs->logmod * 2 + 1;
+    }
 }
 
 // rs_init_code(&rs, nsym, index) initialises the Reed-Solomon encoder
@@ -105,7 +114,7 @@ INTERNAL void rs_init_gf(rs_t *rs, const unsigned int prime_poly) {
 // For ECC200, index is 1.
 
 INTERNAL void rs_init_code(rs_t *rs, const int nsym, int index) {
-    int i, k;
+    int i, k, padded;
     const unsigned char *logt = rs->logt;
     const unsigned char *alog = rs->alog;
     unsigned char *rspoly = rs->rspoly;
@@ -123,33 +132,106 @@ INTERNAL void rs_init_code(rs_t *rs, const int nsym, int index) {
         rspoly[0] = alog[logt[rspoly[0]] + index]; /* 2**(i + (i+1) + ... + index) */
         index++;
     }
+
+    /* Multiplication distributes over XOR, so the product of a symbol with the coefficients is the XOR of the
+       products of its low and high nibbles, and those are in turn XORs of the products of their bits */
+    padded = (nsym + 7) & ~7;
+    memset(rs->lo_prods[0], 0, padded);
+    memset(rs->hi_prods[0], 0, padded);
+    for (i = 0; i < 8; i++) {
+        unsigned char *const row = i < 4 ? rs->lo_prods[1 << i] : rs->hi_prods[1 << (i - 4)];
+        for (k = 0; k < padded; k++) {
+            const unsigned char coeff = k < nsym ? rspoly[nsym - 1 - k] : 0;
+            /* Bits beyond the field don't occur */
+            row[k] = coeff && (1 << i) <= rs->logmod ? alog[logt[coeff] + i] : 0;
+        }
+    }
+    for (i = 3; i < 16; i++) {
+        if (i & (i - 1)) { /* Not a single bit */
+            const int low_bit = i & -i;
+            for (k = 0; k < padded; k++) {
+                rs->lo_prods[i][k] = rs->lo_prods[i - low_bit][k] ^ rs->lo_prods[low_bit][k];
+                rs->hi_prods[i][k] = rs->hi_prods[i - low_bit][k] ^ rs->hi_prods[low_bit][k];
+            }
+        }
+    }
+}
+
+/* Divide `w[]`, the `datalen` data symbols followed by nsym zeroes (and padding to a multiple of 8), by the
+ * generator polynomial, leaving the remainder after the data. Each data symbol in turn is multiplied by all the
+ * coefficients at once, 8 at a time, using its nibble product rows */
+static void rs_divide(const rs_t *rs, const int datalen, unsigned char *w) {
+    int i, k;
+    const int padded = (rs->nsym + 7) & ~7;
+
+    for (i = 0; i < datalen; i++) {
+        const unsigned int m = w[i];
+        if (m) {
+            const unsigned char *const lo = rs->lo_prods[m & 0x0F];
+            const unsigned char *const hi = rs->hi_prods[m >> 4];
+            unsigned char *const w1 = w + i + 1;
+            for (k = 0; k < padded; k += 8) {
+                uint64_t word, lo_word, hi_word;
+                memcpy(&word, w1 + k, sizeof(word)); /* Not aligned */
+                memcpy(&lo_word, lo + k, sizeof(lo_word));
+                memcpy(&hi_word, hi + k, sizeof(hi_word));
+                word ^= lo_word ^ hi_word;
+                memcpy(w1 + k, &word, sizeof(word));
+            }
+        }
+    }
 }
 
 /* rs_encode(&rs, datalen, data, res) generates nsym Reed-Solomon codes (nsym as given in rs_init_code())
  * and places them in reverse order in res */
 
 INTERNAL void rs_encode(const rs_t *rs, const int datalen, const unsigned char *data, unsigned char *res) {
-    int i, k;
-    const unsigned char *logt = rs->logt;
-    const unsigned char *alog = rs->alog;
-    const unsigned char *rspoly = rs->rspoly;
+    int k;
     const int nsym = rs->nsym;
+    const int w_len = datalen + ((nsym + 7) & ~7);
+#ifndef _MSC_VER
+    unsigned char w[w_len];
+#else
+    unsigned char *w = (unsigned char *) _alloca(w_len);
+#endif
 
-    memset(res, 0, nsym);
-    for (i = 0; i < datalen; i++) {
-        unsigned int m = res[nsym - 1] ^ data[i];
-        if (m) {
-            unsigned int log_m = logt[m];
-            for (k = nsym - 1; k > 0; k--) {
-                if (rspoly[k])
-                    res[k] = (unsigned char) (res[k - 1] ^ alog[log_m + logt[rspoly[k]]]);
-                else
-                    res[k] = res[k - 1];
-            }
-            res[0] = alog[log_m + logt[rspoly[0]]]; /* rspoly[0] can't be zero */
-        } else {
-            memmove(res + 1, res, nsym - 1);
-            res[0] = 0;
+    memcpy(w, data, datalen);
+    memset(w + datalen, 0, w_len - datalen);
+    rs_divide(rs, datalen, w);
+    for (k = 0; k < nsym; k++) {
+        res[k] = w[datalen + nsym - 1 - k];
+    }
+}
+
+/* rs_encode_step(&rs, datalen, data, data_step, res, res_step) is the same as rs_encode() except that the data
+ * are every `data_step`th symbol of `data` and the nsym codes are placed in order (i.e. not reversed) at every
+ * `res_step`th position of `res`, allowing interleaved blocks to be encoded in place */
+
+INTERNAL void rs_encode_step(const rs_t *rs, const int datalen, const unsigned char *data, const int data_step,
+            unsigned char *res, const int res_step) {
+    int k;
+    const int nsym = rs->nsym;
+    const int w_len = datalen + ((nsym + 7) & ~7);
+#ifndef _MSC_VER
+    unsigned char w[w_len];
+#else
+    unsigned char *w = (unsigned char *) _alloca(w_len);
+#endif
+
+    if (data_step == 1) {
+        memcpy(w, data, datalen);
+    } else {
+        for (k = 0; k < datalen; k++) {
+            w[k] = data[k * data_step];
+        }
+    }
+    memset(w + datalen, 0, w_len - datalen);
+    rs_divide(rs, datalen, w);
+    if (res_step == 1) {
+        memcpy(res, w + datalen, nsym);
+    } else {
+        for (k = 0; k < nsym; k++) {
+            res[k * res_step] = w[datalen + k];
         }
     }
 }
@@ -157,66 +239,49 @@ INTERNAL void rs_encode(const rs_t *rs, const int datalen, const unsigned char *
 /* The same as above but for unsigned int data and result - Aztec code compatible */
 
 INTERNAL void rs_encode_uint(const rs_t *rs, const int datalen, const unsigned int *data, unsigned int *res) {
-    int i, k;
-    const unsigned char *logt = rs->logt;
-    const unsigned char *alog = rs->alog;
-    const unsigned char *rspoly = rs->rspoly;
+    int k;
     const int nsym = rs->nsym;
+    const int w_len = datalen + ((nsym + 7) & ~7);
+#ifndef _MSC_VER
+    unsigned char w[w_len];
+#else
+    unsigned char *w = (unsigned char *) _alloca(w_len);
+#endif
 
-    memset(res, 0, sizeof(unsigned int) * nsym);
-    for (i = 0; i < datalen; i++) {
-        unsigned int m = res[nsym - 1] ^ data[i];
-        if (m) {
-            unsigned int log_m = logt[m];
-            for (k = nsym - 1; k > 0; k--) {
-                if (rspoly[k])
-                    res[k] = res[k - 1] ^ alog[log_m + logt[rspoly[k]]];
-                else
-                    res[k] = res[k - 1];
-            }
-            res[0] = alog[log_m + logt[rspoly[0]]];
-        } else {
-            memmove(res + 1, res, sizeof(unsigned int) * (nsym - 1));
-            res[0] = 0;
-        }
+    for (k = 0; k < datalen; k++) {
+        w[k] = (unsigned char) data[k];
+    }
+    memset(w + datalen, 0, w_len - datalen);
+    rs_divide(rs, datalen, w);
+    for (k = 0; k < nsym; k++) {
+        res[k] = w[datalen + nsym - 1 - k];
     }
 }
 
-/* Versions of the above for bitlengths > 8 and <= 30 and unsigned int data and results - Aztec code compatible */
+/* Versions of the above for bitlengths > 8 and <= 12 and unsigned int data and results - Aztec code compatible */
 
 // Usage:
-// First call rs_uint_init_gf(&rs_uint, prime_poly, logmod) to set up the Galois Field parameters.
+// First call rs_uint_init_gf(&rs_uint, prime_poly) to set up the Galois Field parameters.
 // Then  call rs_uint_init_code(&rs_uint, nsym, index) to set the encoding size
 // Then  call rs_uint_encode(&rs_uint, datalen, data, out) to encode the data.
-// Then  call rs_uint_free(&rs_uint) to free the log tables.
-
-/* `logmod` (field characteristic) will be 2**bitlength - 1, eg 1023 for bitlength 10, 4095 for bitlength 12 */
-INTERNAL void rs_uint_init_gf(rs_uint_t *rs_uint, const unsigned int prime_poly, const int logmod) {
-    int b, p, v;
-    unsigned int *logt, *alog;
-
-    b = logmod + 1;
-
-    logt = (unsigned int *) malloc(sizeof(unsigned int) * b);
-    alog = (unsigned int *) malloc(sizeof(unsigned int) * b * 2);
-
-    // Calculate the log/alog tables
-    for (p = 1, v = 0; v < logmod; v++) {
-        alog[v] = p;
-        alog[logmod + v] = p; /* Double up, avoids mod */
-        logt[p] = v;
-        p <<= 1;
-        if (p & b) /* If overflow */
-            p ^= prime_poly; /* Subtract prime poly */
+
+/* Only the Aztec Code prime polys 0x409 (bitlength 10) and 0x1069 (bitlength 12) are supported - to add another add
+ * it to the table in `test_generate()` in "backend/tests/test_reedsol.c", regenerate and paste into "reedsol_logs.h"
+ * as for `rs_init_gf()` above */
+INTERNAL void rs_uint_init_gf(rs_uint_t *rs_uint, const unsigned int prime_poly) {
+    if (prime_poly == 0x409) {
+        rs_uint->logt = logt_0x409;
+        rs_uint->alog = alog_0x409;
+    } else {
+        rs_uint->logt = logt_0x1069;
+        rs_uint->alog = alog_0x1069;
     }
-    rs_uint->logt = logt;
-    rs_uint->alog = alog;
 }
 
 INTERNAL void rs_uint_init_code(rs_uint_t *rs_uint, const int nsym, int index) {
     int i, k;
-    const unsigned int *logt = rs_uint->logt;
-    const unsigned int *alog = rs_uint->alog;
+    const unsigned short *logt = rs_uint->logt;
+    const unsigned short *alog = rs_uint->alog;
     unsigned short *rspoly = rs_uint->rspoly;
 
     rs_uint->nsym = nsym;
@@ -232,27 +297,43 @@ INTERNAL void rs_uint_init_code(rs_uint_t *rs_uint, const int nsym, int index) {
         rspoly[0] = alog[(logt[rspoly[0]] + index)];
         index++;
     }
+
+    rs_uint->zero_coeffs = 0;
+    for (i = 0; i < nsym; i++) {
+        if (rspoly[i]) {
+            rs_uint->log_rspoly[i] = (unsigned short) logt[rspoly[i]];
+        } else {
+            rs_uint->zero_coeffs = 1;
+        }
+    }
 }
 
 INTERNAL void rs_uint_encode(const rs_uint_t *rs_uint, const int datalen, const unsigned int *data, unsigned int *res) {
     int i, k;
-    const unsigned int *logt = rs_uint->logt;
-    const unsigned int *alog = rs_uint->alog;
+    const unsigned short *logt = rs_uint->logt;
+    const unsigned short *alog = rs_uint->alog;
     const unsigned short *rspoly = rs_uint->rspoly;
+    const unsigned short *log_rspoly = rs_uint->log_rspoly;
     const int nsym = rs_uint->nsym;
 
     memset(res, 0, sizeof(unsigned int) * nsym);
     for (i = 0; i < datalen; i++) {
         unsigned int m = res[nsym - 1] ^ data[i];
         if (m) {
-            unsigned int log_m = logt[m];
-            for (k = nsym - 1; k > 0; k--) {
-                if (rspoly[k])
-                    res[k] = res[k - 1] ^ alog[log_m + logt[rspoly[k]]];
-                else
-                    res[k] = res[k - 1];
+            const unsigned short *alog_m = alog + logt[m];
+            if (!rs_uint->zero_coeffs) {
+                for (k = nsym - 1; k > 0; k--) {
+                    res[k] = res[k - 1] ^ alog_m[log_rspoly[k]];
+                }
+            } else {
+                for (k = nsym - 1; k > 0; k--) {
+                    if (rspoly[k])
+                        res[k] = res[k - 1] ^ alog_m[logt[rspoly[k]]];
+                    else
+                        res[k] = res[k - 1];
+                }
             }
-            res[0] = alog[log_m + logt[rspoly[0]]];
+            res[0] = alog_m[log_rspoly[0]];
         } else {
             memmove(res + 1, res, sizeof(unsigned int) * (nsym - 1));
             res[0] = 0;
@@ -260,7 +341,20 @@ INTERNAL void rs_uint_encode(const rs_uint_t *rs_uint, const int datalen, const
     }
 }
 
-INTERNAL void rs_uint_free(rs_uint_t *rs_uint) {
-    free(rs_uint->logt);
-    free(rs_uint->alog);
+/* Page in the static tables (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t rs_tables_warm(const int touch) {
+    return z_table_warm(logt_0x13, sizeof(logt_0x13), touch) + z_table_warm(alog_0x13, sizeof(alog_0x13), touch)
+            + z_table_warm(logt_0x25, sizeof(logt_0x25), touch) + z_table_warm(alog_0x25, sizeof(alog_0x25), touch)
+            + z_table_warm(logt_0x43, sizeof(logt_0x43), touch) + z_table_warm(alog_0x43, sizeof(alog_0x43), touch)
+            + z_table_warm(logt_0x89, sizeof(logt_0x89), touch) + z_table_warm(alog_0x89, sizeof(alog_0x89), touch)
+            + z_table_warm(logt_0x11d, sizeof(logt_0x11d), touch)
+            + z_table_warm(alog_0x11d, sizeof(alog_0x11d), touch)
+            + z_table_warm(logt_0x12d, sizeof(logt_0x12d), touch)
+            + z_table_warm(alog_0x12d, sizeof(alog_0x12d), touch)
+            + z_table_warm(logt_0x163, sizeof(logt_0x163), touch)
+            + z_table_warm(alog_0x163, sizeof(alog_0x163), touch)
+            + z_table_warm(logt_0x409, sizeof(logt_0x409), touch)
+            + z_table_warm(alog_0x409, sizeof(alog_0x409), touch)
+            + z_table_warm(logt_0x1069, sizeof(logt_0x1069), touch)
+            + z_table_warm(alog_0x1069, sizeof(alog_0x1069), touch);
 }
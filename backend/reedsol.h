@@ -41,27 +41,36 @@ extern "C" {
 typedef struct {
     const unsigned char *logt; /* These are static */
     const unsigned char *alog;
+    int logmod;
     unsigned char rspoly[256];
+    /* Products of each low and high nibble value with the `rspoly` coefficients, highest power first, padded with
+       zeroes to a multiple of 8 */
+    unsigned char lo_prods[16][256];
+    unsigned char hi_prods[16][256];
     int nsym;
 } rs_t;
 
 typedef struct {
-    unsigned int *logt; /* These are malloced */
-    unsigned int *alog;
+    const unsigned short *logt; /* These are static */
+    const unsigned short *alog;
     unsigned short rspoly[4096]; /* 12-bit max - needs to be enlarged if > 12-bit used */
+    unsigned short log_rspoly[4096]; /* Logs of the `rspoly` coefficients, valid if `zero_coeffs` not set */
     int nsym;
+    int zero_coeffs; /* Set if any of the `rspoly` coefficients is zero (so has no log) */
 } rs_uint_t;
 
 INTERNAL void rs_init_gf(rs_t *rs, const unsigned int prime_poly);
 INTERNAL void rs_init_code(rs_t *rs, const int nsym, int index);
 INTERNAL void rs_encode(const rs_t *rs, const int datalen, const unsigned char *data, unsigned char *res);
+INTERNAL void rs_encode_step(const rs_t *rs, const int datalen, const unsigned char *data, const int data_step,
+                unsigned char *res, const int res_step);
 INTERNAL void rs_encode_uint(const rs_t *rs, const int datalen, const unsigned int *data, unsigned int *res);
 /* No free needed as log tables static */
 
-INTERNAL void rs_uint_init_gf(rs_uint_t *rs_uint, const unsigned int prime_poly, const int logmod);
+INTERNAL void rs_uint_init_gf(rs_uint_t *rs_uint, const unsigned int prime_poly);
 INTERNAL void rs_uint_init_code(rs_uint_t *rs_uint, const int nsym, int index);
 INTERNAL void rs_uint_encode(const rs_uint_t *rs_uint, const int datalen, const unsigned int *data, unsigned int *res);
-INTERNAL void rs_uint_free(rs_uint_t *rs_uint);
+/* No free needed as log tables static */
 
 #ifdef __cplusplus
 }
@@ -73,35 +73,37 @@
 #include "gs1.h"
 #include "general_field.h"
 
+/* Binomial coefficients `combins_table[n][r]` = n! / ((n - r)! * r!), for n <= 19 (max modules) and r <= 5
+   (max elements - 2), these being the only ones `getRSSwidths()` uses */
+static const unsigned short combins_table[20][6] = {
+    {     1,     0,     0,     0,     0,     0 }, /*  0 */
+    {     1,     1,     0,     0,     0,     0 }, /*  1 */
+    {     1,     2,     1,     0,     0,     0 }, /*  2 */
+    {     1,     3,     3,     1,     0,     0 }, /*  3 */
+    {     1,     4,     6,     4,     1,     0 }, /*  4 */
+    {     1,     5,    10,    10,     5,     1 }, /*  5 */
+    {     1,     6,    15,    20,    15,     6 }, /*  6 */
+    {     1,     7,    21,    35,    35,    21 }, /*  7 */
+    {     1,     8,    28,    56,    70,    56 }, /*  8 */
+    {     1,     9,    36,    84,   126,   126 }, /*  9 */
+    {     1,    10,    45,   120,   210,   252 }, /* 10 */
+    {     1,    11,    55,   165,   330,   462 }, /* 11 */
+    {     1,    12,    66,   220,   495,   792 }, /* 12 */
+    {     1,    13,    78,   286,   715,  1287 }, /* 13 */
+    {     1,    14,    91,   364,  1001,  2002 }, /* 14 */
+    {     1,    15,   105,   455,  1365,  3003 }, /* 15 */
+    {     1,    16,   120,   560,  1820,  4368 }, /* 16 */
+    {     1,    17,   136,   680,  2380,  6188 }, /* 17 */
+    {     1,    18,   153,   816,  3060,  8568 }, /* 18 */
+    {     1,    19,   171,   969,  3876, 11628 }, /* 19 */
+};
+
 /**********************************************************************
  * combins(n,r): returns the number of Combinations of r selected from n:
  *   Combinations = n! / ((n - r)! * r!)
  **********************************************************************/
 static int combins(const int n, const int r) {
-    int i, j;
-    int maxDenom, minDenom;
-    int val;
-
-    if (n - r > r) {
-        minDenom = r;
-        maxDenom = n - r;
-    } else {
-        minDenom = n - r;
-        maxDenom = r;
-    }
-    val = 1;
-    j = 1;
-    for (i = n; i > maxDenom; i--) {
-        val *= i;
-        if (j <= minDenom) {
-            val /= j;
-            j++;
-        }
-    }
-    for (; j <= minDenom; j++) {
-        val /= j;
-    }
-    return (val);
+    return combins_table[n][r];
 }
 
 /**********************************************************************
@@ -120,7 +122,6 @@ static int combins(const int n, const int r) {
 static void getRSSwidths(int widths[], int val, int n, const int elements, const int maxWidth, const int noNarrow) {
     int bar;
     int elmWidth;
-    int mxwElement;
     int subVal, lessVal;
     int narrowMask = 0;
     for (bar = 0; bar < elements - 1; bar++) {
@@ -136,12 +137,11 @@ static void getRSSwidths(int widths[], int val, int n, const int elements, const
             }
             /* less combinations with elements > maxVal */
             if (elements - bar - 1 > 1) {
-                lessVal = 0;
-                for (mxwElement = n - elmWidth - (elements - bar - 2);
-                        mxwElement > maxWidth;
-                        mxwElement--) {
-                    lessVal += combins(n - elmWidth - mxwElement - 1, elements - bar - 3);
-                }
+                /* Sum of combins(n - elmWidth - mxwElement - 1, elements - bar - 3) for mxwElement from
+                   n - elmWidth - (elements - bar - 2) down to maxWidth + 1, which by the "hockey-stick" identity
+                   (sum of combins(j, r) for j = r to m gives combins(m + 1, r + 1)) is a single lookup */
+                lessVal = n - elmWidth - (elements - bar - 2) > maxWidth
+                            ? combins(n - elmWidth - maxWidth - 1, elements - bar - 2) : 0;
                 subVal -= lessVal * (elements - 1 - bar);
             } else if (n - elmWidth > maxWidth) {
                 subVal--;
@@ -178,6 +178,10 @@ static void set_gtin14_hrt(struct zint_symbol *symbol, const unsigned char *sour
     int i;
     unsigned char hrt[15];
 
+    if (!z_hrt(symbol)) {
+        return;
+    }
+
     ustrcpy(symbol->text, "(01)");
     for (i = 0; i < 12; i++) {
         hrt[i] = '0';
@@ -285,7 +289,7 @@ INTERNAL int rss14(struct zint_symbol *symbol, unsigned char source[], int src_l
         strcpy(symbol->errtxt, "380: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, src_len);
+    error_number = is_sane_chr(CHR_DIGIT, source, src_len);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "381: Invalid characters in data");
         return error_number;
@@ -594,7 +598,7 @@ INTERNAL int rsslimited(struct zint_symbol *symbol, unsigned char source[], int
         strcpy(symbol->errtxt, "382: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
-    error_number = is_sane(NEON, source, src_len);
+    error_number = is_sane_chr(CHR_DIGIT, source, src_len);
     if (error_number == ZINT_ERROR_INVALID_DATA) {
         strcpy(symbol->errtxt, "383: Invalid characters in data");
         return error_number;
@@ -764,22 +768,32 @@ INTERNAL int rss_date(const unsigned char source[], const int src_posn) {
     return yy * 384 + (mm - 1) * 32 + dd;
 }
 
+/* Debug print the binary stream so far, with the number of symbol characters if `symbol_characters` non-negative */
+static void rss_debug_binary(struct zint_bits *bits, const int symbol_characters) {
+    (void) bits_flush(bits);
+    fputs("Resultant binary = ", stdout);
+    bits_print(bits->data, 0, bits->posn);
+    if (symbol_characters >= 0) {
+        printf("\n\tLength: %d, Symbol chars: %d\n", bits->posn, symbol_characters);
+    } else {
+        printf("\n\tLength: %d\n", bits->posn);
+    }
+}
+
 /* Handles all data encodation from section 7.2.5 of ISO/IEC 24724 */
-static int rss_binary_string(struct zint_symbol *symbol, const unsigned char source[], char binary_string[],
-            int *p_bp) {
+static int rss_binary_string(struct zint_symbol *symbol, const unsigned char source[], const int length,
+            struct zint_bits *bits) {
     int encoding_method, i, j, read_posn, debug = (symbol->debug & ZINT_DEBUG_PRINT), mode = NUMERIC;
     char last_digit = '\0';
     int symbol_characters, characters_per_row;
-    int length = (int) ustrlen(source);
-#ifndef _MSC_VER
-    char general_field[length + 1];
-#else
-    char *general_field = (char *) _alloca(length + 1);
-#endif
-    int bp = *p_bp;
+    z_work_array(symbol, char, general_field, length + 1);
     int remainder, d1, d2;
     int cdf_bp_start; /* Compressed data field start - debug only */
 
+    if (z_work_failed(general_field)) {
+        return z_work_error(symbol);
+    }
+
     /* Decide whether a compressed data field is required and if so what
     method to use - method 2 = no compressed data field */
 
@@ -874,29 +888,34 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
     }
 
     switch (encoding_method) { /* Encoding method - Table 10 */
-        case 1: bp = bin_append_posn(4, 3, binary_string, bp); /* "1XX" */
+        case 1: bits_append(bits, 4, 3); /* "1XX" */
             read_posn = 16;
             break;
-        case 2: bp = bin_append_posn(0, 4, binary_string, bp); /* "00XX" */
+        case 2: bits_append(bits, 0, 4); /* "00XX" */
             read_posn = 0;
             break;
         case 3: // 0100
         case 4: // 0101
-            bp = bin_append_posn(4 + (encoding_method - 3), 4, binary_string, bp);
+            bits_append(bits, 4 + (encoding_method - 3), 4);
             read_posn = 26;
             break;
-        case 5: bp = bin_append_posn(0x30, 7, binary_string, bp); /* "01100XX" */
+        case 5: bits_append(bits, 0x30, 7); /* "01100XX" */
             read_posn = 20;
             break;
-        case 6: bp = bin_append_posn(0x34, 7, binary_string, bp); /* "01101XX" */
+        case 6: bits_append(bits, 0x34, 7); /* "01101XX" */
             read_posn = 23;
             break;
         default: /* modes 7 to 14 */
-            bp = bin_append_posn(56 + (encoding_method - 7), 7, binary_string, bp);
+            bits_append(bits, 56 + (encoding_method - 7), 7);
             read_posn = length; /* 34 or 26 */
             break;
     }
-    if (debug) printf("Setting binary = %.*s\n", bp, binary_string);
+    if (debug) {
+        (void) bits_flush(bits);
+        fputs("Setting binary = ", stdout);
+        bits_print(bits->data, 0, bits->posn);
+        putchar('\n');
+    }
 
     /* Variable length symbol bit field is just given a place holder (XX)
     for the time being */
@@ -916,15 +935,15 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
     /* Now encode the compressed data field */
 
     if (debug) printf("Proceeding to encode data\n");
-    cdf_bp_start = bp; /* Debug use only */
+    cdf_bp_start = bits->posn; /* Debug use only */
 
     if (encoding_method == 1) {
         /* Encoding method field "1" - general item identification data */
 
-        bp = bin_append_posn(ctoi(source[2]), 4, binary_string, bp); /* Leading digit after stripped "01" */
+        bits_append(bits, ctoi(source[2]), 4); /* Leading digit after stripped "01" */
 
         for (i = 3; i < 15; i += 3) { /* Next 12 digits, excluding final check digit */
-            bp = bin_append_posn(to_int(source + i, 3), 10, binary_string, bp);
+            bits_append(bits, to_int(source + i, 3), 10);
         }
 
     } else if ((encoding_method == 3) || (encoding_method == 4)) {
@@ -934,13 +953,13 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
         0,001 pound increment) */
 
         for (i = 3; i < 15; i += 3) { /* Leading "019" stripped, and final check digit excluded */
-            bp = bin_append_posn(to_int(source + i, 3), 10, binary_string, bp);
+            bits_append(bits, to_int(source + i, 3), 10);
         }
 
         if ((encoding_method == 4) && (source[19] == '3')) {
-            bp = bin_append_posn(to_int(source + 20, 6) + 10000, 15, binary_string, bp);
+            bits_append(bits, to_int(source + 20, 6) + 10000, 15);
         } else {
-            bp = bin_append_posn(to_int(source + 20, 6), 15, binary_string, bp);
+            bits_append(bits, to_int(source + 20, 6), 15);
         }
 
     } else if ((encoding_method == 5) || (encoding_method == 6)) {
@@ -949,13 +968,13 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
         Currency Code */
 
         for (i = 3; i < 15; i += 3) { /* Leading "019" stripped, and final check digit excluded */
-            bp = bin_append_posn(to_int(source + i, 3), 10, binary_string, bp);
+            bits_append(bits, to_int(source + i, 3), 10);
         }
 
-        bp = bin_append_posn(source[19] - '0', 2, binary_string, bp); /* 0-3 x of 392x/393x */
+        bits_append(bits, source[19] - '0', 2); /* 0-3 x of 392x/393x */
 
         if (encoding_method == 6) {
-            bp = bin_append_posn(to_int(source + 20, 3), 10, binary_string, bp); /* 3-digit currency */
+            bits_append(bits, to_int(source + 20, 3), 10); /* 3-digit currency */
         }
 
     } else if ((encoding_method >= 7) && (encoding_method <= 14)) {
@@ -965,7 +984,7 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
         char weight_str[8];
 
         for (i = 3; i < 15; i += 3) { /* Leading "019" stripped, and final check digit excluded */
-            bp = bin_append_posn(to_int(source + i, 3), 10, binary_string, bp);
+            bits_append(bits, to_int(source + i, 3), 10);
         }
 
         weight_str[0] = source[19]; /* 0-9 x of 310x/320x */
@@ -975,7 +994,7 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
         }
         weight_str[6] = '\0';
 
-        bp = bin_append_posn(atoi(weight_str), 20, binary_string, bp);
+        bits_append(bits, atoi(weight_str), 20);
 
         if (length == 34) {
             /* Date information is included */
@@ -984,12 +1003,14 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
             group_val = 38400;
         }
 
-        bp = bin_append_posn((int) group_val, 16, binary_string, bp);
+        bits_append(bits, (int) group_val, 16);
     }
 
-    if (debug && bp > cdf_bp_start) {
-        printf("Compressed data field (%d) = %.*s\n", bp - cdf_bp_start, bp - cdf_bp_start,
-            binary_string + cdf_bp_start);
+    if (debug && bits->posn > cdf_bp_start) {
+        (void) bits_flush(bits);
+        printf("Compressed data field (%d) = ", bits->posn - cdf_bp_start);
+        bits_print(bits->data, cdf_bp_start, bits->posn - cdf_bp_start);
+        putchar('\n');
     }
 
     /* The compressed data field has been processed if appropriate - the
@@ -1006,20 +1027,20 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
 
     if (j != 0) { /* If general field not empty */
 
-        if (!general_field_encode(general_field, j, &mode, &last_digit, binary_string, &bp)) {
+        if (!general_field_encode(general_field, j, &mode, &last_digit, bits)) {
             /* Invalid characters in input data */
             strcpy(symbol->errtxt, "386: Invalid characters in input data");
             return ZINT_ERROR_INVALID_DATA;
         }
     }
 
-    if (debug) printf("Resultant binary = %.*s\n\tLength: %d\n", bp, binary_string, bp);
+    if (debug) rss_debug_binary(bits, -1);
 
-    remainder = 12 - (bp % 12);
+    remainder = 12 - (bits->posn % 12);
     if (remainder == 12) {
         remainder = 0;
     }
-    symbol_characters = ((bp + remainder) / 12) + 1;
+    symbol_characters = ((bits->posn + remainder) / 12) + 1;
 
     if ((symbol->symbology == BARCODE_DBAR_EXPSTK) || (symbol->symbology == BARCODE_DBAR_EXPSTK_CC)) {
         characters_per_row = symbol->option_2 * 2;
@@ -1037,26 +1058,26 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
         symbol_characters = 4;
     }
 
-    remainder = (12 * (symbol_characters - 1)) - bp;
+    remainder = (12 * (symbol_characters - 1)) - bits->posn;
 
     if (last_digit) {
         /* There is still one more numeric digit to encode */
         if (debug) printf("Adding extra (odd) numeric digit\n");
 
         if ((remainder >= 4) && (remainder <= 6)) {
-            bp = bin_append_posn(ctoi(last_digit) + 1, 4, binary_string, bp);
+            bits_append(bits, ctoi(last_digit) + 1, 4);
         } else {
             d1 = ctoi(last_digit);
             d2 = 10;
 
-            bp = bin_append_posn((11 * d1) + d2 + 8, 7, binary_string, bp);
+            bits_append(bits, (11 * d1) + d2 + 8, 7);
         }
 
-        remainder = 12 - (bp % 12);
+        remainder = 12 - (bits->posn % 12);
         if (remainder == 12) {
             remainder = 0;
         }
-        symbol_characters = ((bp + remainder) / 12) + 1;
+        symbol_characters = ((bits->posn + remainder) / 12) + 1;
 
         if ((symbol->symbology == BARCODE_DBAR_EXPSTK) || (symbol->symbology == BARCODE_DBAR_EXPSTK_CC)) {
             characters_per_row = symbol->option_2 * 2;
@@ -1074,12 +1095,12 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
             symbol_characters = 4;
         }
 
-        remainder = (12 * (symbol_characters - 1)) - bp;
+        remainder = (12 * (symbol_characters - 1)) - bits->posn;
 
-        if (debug) printf("Resultant binary = %.*s\n\tLength: %d\n", bp, binary_string, bp);
+        if (debug) rss_debug_binary(bits, -1);
     }
 
-    if (bp > 252) { /* 252 = (21 * 12) */
+    if (bits->posn > 252) { /* 252 = (21 * 12) */
         strcpy(symbol->errtxt, "387: Input too long");
         return ZINT_ERROR_TOO_LONG;
     }
@@ -1087,11 +1108,11 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
     /* Now add padding to binary string (7.2.5.5.4) */
     i = remainder;
     if (mode == NUMERIC) {
-        bp = bin_append_posn(0, 4, binary_string, bp); /* "0000" */
+        bits_append(bits, 0, 4); /* "0000" */
         i -= 4;
     }
     for (; i > 0; i -= 5) {
-        bp = bin_append_posn(4, 5, binary_string, bp); /* "00100" */
+        bits_append(bits, 4, 5); /* "00100" */
     }
 
     /* Patch variable length symbol bit field */
@@ -1104,20 +1125,13 @@ static int rss_binary_string(struct zint_symbol *symbol, const unsigned char sou
     }
 
     if (encoding_method == 1) {
-        binary_string[2] = d1 ? '1' : '0';
-        binary_string[3] = d2 ? '1' : '0';
+        bits_put(bits, 2, (d1 << 1) | d2, 2);
     } else if (encoding_method == 2) {
-        binary_string[3] = d1 ? '1' : '0';
-        binary_string[4] = d2 ? '1' : '0';
+        bits_put(bits, 3, (d1 << 1) | d2, 2);
     } else if ((encoding_method == 5) || (encoding_method == 6)) {
-        binary_string[6] = d1 ? '1' : '0';
-        binary_string[7] = d2 ? '1' : '0';
-    }
-    if (debug) {
-        printf("Resultant binary = %.*s\n\tLength: %d, Symbol chars: %d\n", bp, binary_string, bp, symbol_characters);
+        bits_put(bits, 6, (d1 << 1) | d2, 2);
     }
-
-    *p_bp = bp;
+    if (debug) rss_debug_binary(bits, symbol_characters);
 
     return 0;
 }
@@ -1200,24 +1214,25 @@ INTERNAL int rssexpanded(struct zint_symbol *symbol, unsigned char source[], int
     /* Allow for 8 bits + 5-bit latch per char + 200 bits overhead/padding */
     unsigned int bin_len = 13 * src_len + 200 + 1;
     int widths[4];
-    int bp = 0;
-#ifndef _MSC_VER
-    unsigned char reduced[src_len + 1];
-    char binary_string[bin_len];
-#else
-    unsigned char *reduced = (unsigned char *) _alloca(src_len + 1);
-    char *binary_string = (char *) _alloca(bin_len);
-#endif
+    int bp;
+    struct zint_bits bits;
+    int reduced_length;
+    z_work_array(symbol, unsigned char, reduced, src_len + 1);
+    z_work_array(symbol, unsigned char, binary_string, (bin_len + 7) / 8);
+
+    if (z_work_failed(reduced) || z_work_failed(binary_string)) {
+        return z_work_error(symbol);
+    }
 
     separator_row = 0;
 
-    error_number = gs1_verify(symbol, source, src_len, reduced);
+    error_number = gs1_verify(symbol, source, src_len, reduced, &reduced_length);
     if (error_number >= ZINT_ERROR) {
         return error_number;
     }
 
     if (symbol->debug & ZINT_DEBUG_PRINT) {
-        printf("Reduced (%d): %s\n", (int) ustrlen(reduced), reduced);
+        printf("Reduced (%d): %s\n", reduced_length, reduced);
     }
 
     if ((symbol->symbology == BARCODE_DBAR_EXP_CC) || (symbol->symbology == BARCODE_DBAR_EXPSTK_CC)) {
@@ -1227,27 +1242,19 @@ INTERNAL int rssexpanded(struct zint_symbol *symbol, unsigned char source[], int
         symbol->rows += 1;
     }
 
-    if (symbol->option_1 == 2) { /* The "component linkage" flag */
-        binary_string[bp++] = '1';
-    } else {
-        binary_string[bp++] = '0';
-    }
+    bits_init(&bits, binary_string, 0);
+    bits_append(&bits, symbol->option_1 == 2, 1); /* The "component linkage" flag */
 
-    i = rss_binary_string(symbol, reduced, binary_string, &bp);
+    i = rss_binary_string(symbol, reduced, reduced_length, &bits);
     if (i != 0) {
         return i;
     }
+    bp = bits_flush(&bits);
 
     data_chars = bp / 12;
 
     for (i = 0; i < data_chars; i++) {
-        k = i * 12;
-        vs = 0;
-        for (j = 0; j < 12; j++) {
-            if (binary_string[k + j] == '1') {
-                vs |= (0x800 >> j);
-            }
-        }
+        vs = bits_get(binary_string, i * 12, 12);
 
         if (vs <= 347) {
             group = 1;
@@ -1374,15 +1381,17 @@ INTERNAL int rssexpanded(struct zint_symbol *symbol, unsigned char source[], int
         symbol->rows = symbol->rows + 1;
 
         /* Add human readable text */
-        for (i = 0; i <= src_len; i++) {
-            if ((source[i] != '[') && (source[i] != ']')) {
-                symbol->text[i] = source[i];
-            } else {
-                if (source[i] == '[') {
-                    symbol->text[i] = '(';
-                }
-                if (source[i] == ']') {
-                    symbol->text[i] = ')';
+        if (z_hrt(symbol)) {
+            for (i = 0; i <= src_len; i++) {
+                if ((source[i] != '[') && (source[i] != ']')) {
+                    symbol->text[i] = source[i];
+                } else {
+                    if (source[i] == '[') {
+                        symbol->text[i] = '(';
+                    }
+                    if (source[i] == ']') {
+                        symbol->text[i] = ')';
+                    }
                 }
             }
         }
@@ -83,6 +83,7 @@ static int jisx0201_wctomb(unsigned int *r, const unsigned int wc) {
     return 0;
 }
 
+#ifndef NO_CJK /* JIS X 0208 tables excluded if NO_CJK */
 /*
  * JISX0208.1990-0 (libiconv-1.16/lib/jisx0208.h)
  */
@@ -976,7 +977,7 @@ static const Summary16 jisx0208_uni2indx_page00[16] = {
   {    0, 0x0000 }, {    0, 0x0000 }, {    0, 0x118c }, {    5, 0x0053 },
   {    9, 0x0000 }, {    9, 0x0080 }, {   10, 0x0000 }, {   10, 0x0080 },
 };
-static const Summary16 jisx0208_uni2indx_page03[22] = {
+static const Summary16 jisx0208_uni2indx_page03[32] = {
   /* 0x0300 */
   {   11, 0x0000 }, {   11, 0x0000 }, {   11, 0x0000 }, {   11, 0x0000 },
   {   11, 0x0000 }, {   11, 0x0000 }, {   11, 0x0000 }, {   11, 0x0000 },
@@ -984,9 +985,11 @@ static const Summary16 jisx0208_uni2indx_page03[22] = {
   {   50, 0x03fb }, {   59, 0x0000 }, {   59, 0x0000 }, {   59, 0x0000 },
   /* 0x0400 */
   {   59, 0x0002 }, {   60, 0xffff }, {   76, 0xffff }, {   92, 0xffff },
-  {  108, 0xffff }, {  124, 0x0002 },
+  {  108, 0xffff }, {  124, 0x0002 }, {  125, 0x0000 }, {  125, 0x0000 },
+  {  125, 0x0000 }, {  125, 0x0000 }, {  125, 0x0000 }, {  125, 0x0000 },
+  {  125, 0x0000 }, {  125, 0x0000 }, {  125, 0x0000 }, {  125, 0x0000 },
 };
-static const Summary16 jisx0208_uni2indx_page20[50] = {
+static const Summary16 jisx0208_uni2indx_page20[64] = {
   /* 0x2000 */
   {  125, 0x0000 }, {  125, 0x3361 }, {  132, 0x0063 }, {  136, 0x080d },
   {  140, 0x0000 }, {  140, 0x0000 }, {  140, 0x0000 }, {  140, 0x0000 },
@@ -1003,9 +1006,12 @@ static const Summary16 jisx0208_uni2indx_page20[50] = {
   {  175, 0x00cc }, {  179, 0x0000 }, {  179, 0x0020 }, {  180, 0x0000 },
   {  180, 0x0000 }, {  180, 0x0000 }, {  180, 0x0000 }, {  180, 0x0000 },
   /* 0x2300 */
-  {  180, 0x0000 }, {  180, 0x0004 },
+  {  180, 0x0000 }, {  180, 0x0004 }, {  181, 0x0000 }, {  181, 0x0000 },
+  {  181, 0x0000 }, {  181, 0x0000 }, {  181, 0x0000 }, {  181, 0x0000 },
+  {  181, 0x0000 }, {  181, 0x0000 }, {  181, 0x0000 }, {  181, 0x0000 },
+  {  181, 0x0000 }, {  181, 0x0000 }, {  181, 0x0000 }, {  181, 0x0000 },
 };
-static const Summary16 jisx0208_uni2indx_page25[23] = {
+static const Summary16 jisx0208_uni2indx_page25[32] = {
   /* 0x2500 */
   {  181, 0x900f }, {  187, 0x3999 }, {  195, 0x9939 }, {  203, 0x9999 },
   {  211, 0x0804 }, {  213, 0x0000 }, {  213, 0x0000 }, {  213, 0x0000 },
@@ -1013,7 +1019,9 @@ static const Summary16 jisx0208_uni2indx_page25[23] = {
   {  219, 0xc8c0 }, {  224, 0x0000 }, {  224, 0x8000 }, {  225, 0x0000 },
   /* 0x2600 */
   {  225, 0x0060 }, {  227, 0x0000 }, {  227, 0x0000 }, {  227, 0x0000 },
-  {  227, 0x0005 }, {  229, 0x0000 }, {  229, 0xa400 },
+  {  227, 0x0005 }, {  229, 0x0000 }, {  229, 0xa400 }, {  232, 0x0000 },
+  {  232, 0x0000 }, {  232, 0x0000 }, {  232, 0x0000 }, {  232, 0x0000 },
+  {  232, 0x0000 }, {  232, 0x0000 }, {  232, 0x0000 }, {  232, 0x0000 },
 };
 static const Summary16 jisx0208_uni2indx_page30[16] = {
   /* 0x3000 */
@@ -1022,7 +1030,7 @@ static const Summary16 jisx0208_uni2indx_page30[16] = {
   {  317, 0xffff }, {  333, 0x780f }, {  341, 0xfffe }, {  356, 0xffff },
   {  372, 0xffff }, {  388, 0xffff }, {  404, 0xffff }, {  420, 0x787f },
 };
-static const Summary16 jisx0208_uni2indx_page4e[1307] = {
+static const Summary16 jisx0208_uni2indx_page4e[1312] = {
   /* 0x4e00 */
   {  431, 0x6f8b }, {  441, 0x43f3 }, {  450, 0x2442 }, {  454, 0x9b46 },
   {  462, 0xe82c }, {  469, 0xe3e0 }, {  477, 0x0004 }, {  478, 0x400a },
@@ -1431,33 +1439,102 @@ static const Summary16 jisx0208_uni2indx_page4e[1307] = {
   /* 0x9f00 */
   { 6754, 0x4180 }, { 6757, 0x0028 }, { 6759, 0x1003 }, { 6762, 0x4800 },
   { 6764, 0xcc00 }, { 6768, 0x8014 }, { 6771, 0x14cf }, { 6779, 0x00c4 },
-  { 6782, 0x2000 }, { 6783, 0x3020 }, { 6786, 0x0001 },
+  { 6782, 0x2000 }, { 6783, 0x3020 }, { 6786, 0x0001 }, { 6787, 0x0000 },
+  { 6787, 0x0000 }, { 6787, 0x0000 }, { 6787, 0x0000 }, { 6787, 0x0000 },
 };
 
-static const Summary16 jisx0208_uni2indx_pageff[15] = {
+static const Summary16 jisx0208_uni2indx_pageff[16] = {
   /* 0xff00 */
   { 6787, 0xdf7a }, { 6799, 0xffff }, { 6815, 0xffff }, { 6831, 0xffff },
   { 6847, 0xffff }, { 6863, 0x3fff }, { 6877, 0x0000 }, { 6877, 0x0000 },
   { 6877, 0x0000 }, { 6877, 0x0000 }, { 6877, 0x0000 }, { 6877, 0x0000 },
-  { 6877, 0x0000 }, { 6877, 0x0000 }, { 6877, 0x0028 },
+  { 6877, 0x0000 }, { 6877, 0x0000 }, { 6877, 0x0028 }, { 6879, 0x0000 },
+};
+
+/* ZINT: Direct index by Unicode high byte to pages of 16 summaries (page arrays padded to a multiple of
+ * 16 entries), replacing range checks */
+static const Summary16 *const jisx0208_uni2indx_pages[256] = {
+  /* 0x00 */ jisx0208_uni2indx_page00 + 0x000,
+  /* 0x01 */ NULL, NULL,
+  /* 0x03 */ jisx0208_uni2indx_page03 + 0x000, jisx0208_uni2indx_page03 + 0x010,
+  /* 0x05 */ NULL, NULL, NULL,
+  /* 0x08 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x10 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x18 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x20 */ jisx0208_uni2indx_page20 + 0x000, jisx0208_uni2indx_page20 + 0x010,
+  /* 0x22 */ jisx0208_uni2indx_page20 + 0x020, jisx0208_uni2indx_page20 + 0x030,
+  /* 0x24 */ NULL,
+  /* 0x25 */ jisx0208_uni2indx_page25 + 0x000, jisx0208_uni2indx_page25 + 0x010,
+  /* 0x27 */ NULL,
+  /* 0x28 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x30 */ jisx0208_uni2indx_page30 + 0x000,
+  /* 0x31 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x38 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x40 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x48 */ NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0x4e */ jisx0208_uni2indx_page4e + 0x000, jisx0208_uni2indx_page4e + 0x010,
+  /* 0x50 */ jisx0208_uni2indx_page4e + 0x020, jisx0208_uni2indx_page4e + 0x030,
+  /* 0x52 */ jisx0208_uni2indx_page4e + 0x040, jisx0208_uni2indx_page4e + 0x050,
+  /* 0x54 */ jisx0208_uni2indx_page4e + 0x060, jisx0208_uni2indx_page4e + 0x070,
+  /* 0x56 */ jisx0208_uni2indx_page4e + 0x080, jisx0208_uni2indx_page4e + 0x090,
+  /* 0x58 */ jisx0208_uni2indx_page4e + 0x0a0, jisx0208_uni2indx_page4e + 0x0b0,
+  /* 0x5a */ jisx0208_uni2indx_page4e + 0x0c0, jisx0208_uni2indx_page4e + 0x0d0,
+  /* 0x5c */ jisx0208_uni2indx_page4e + 0x0e0, jisx0208_uni2indx_page4e + 0x0f0,
+  /* 0x5e */ jisx0208_uni2indx_page4e + 0x100, jisx0208_uni2indx_page4e + 0x110,
+  /* 0x60 */ jisx0208_uni2indx_page4e + 0x120, jisx0208_uni2indx_page4e + 0x130,
+  /* 0x62 */ jisx0208_uni2indx_page4e + 0x140, jisx0208_uni2indx_page4e + 0x150,
+  /* 0x64 */ jisx0208_uni2indx_page4e + 0x160, jisx0208_uni2indx_page4e + 0x170,
+  /* 0x66 */ jisx0208_uni2indx_page4e + 0x180, jisx0208_uni2indx_page4e + 0x190,
+  /* 0x68 */ jisx0208_uni2indx_page4e + 0x1a0, jisx0208_uni2indx_page4e + 0x1b0,
+  /* 0x6a */ jisx0208_uni2indx_page4e + 0x1c0, jisx0208_uni2indx_page4e + 0x1d0,
+  /* 0x6c */ jisx0208_uni2indx_page4e + 0x1e0, jisx0208_uni2indx_page4e + 0x1f0,
+  /* 0x6e */ jisx0208_uni2indx_page4e + 0x200, jisx0208_uni2indx_page4e + 0x210,
+  /* 0x70 */ jisx0208_uni2indx_page4e + 0x220, jisx0208_uni2indx_page4e + 0x230,
+  /* 0x72 */ jisx0208_uni2indx_page4e + 0x240, jisx0208_uni2indx_page4e + 0x250,
+  /* 0x74 */ jisx0208_uni2indx_page4e + 0x260, jisx0208_uni2indx_page4e + 0x270,
+  /* 0x76 */ jisx0208_uni2indx_page4e + 0x280, jisx0208_uni2indx_page4e + 0x290,
+  /* 0x78 */ jisx0208_uni2indx_page4e + 0x2a0, jisx0208_uni2indx_page4e + 0x2b0,
+  /* 0x7a */ jisx0208_uni2indx_page4e + 0x2c0, jisx0208_uni2indx_page4e + 0x2d0,
+  /* 0x7c */ jisx0208_uni2indx_page4e + 0x2e0, jisx0208_uni2indx_page4e + 0x2f0,
+  /* 0x7e */ jisx0208_uni2indx_page4e + 0x300, jisx0208_uni2indx_page4e + 0x310,
+  /* 0x80 */ jisx0208_uni2indx_page4e + 0x320, jisx0208_uni2indx_page4e + 0x330,
+  /* 0x82 */ jisx0208_uni2indx_page4e + 0x340, jisx0208_uni2indx_page4e + 0x350,
+  /* 0x84 */ jisx0208_uni2indx_page4e + 0x360, jisx0208_uni2indx_page4e + 0x370,
+  /* 0x86 */ jisx0208_uni2indx_page4e + 0x380, jisx0208_uni2indx_page4e + 0x390,
+  /* 0x88 */ jisx0208_uni2indx_page4e + 0x3a0, jisx0208_uni2indx_page4e + 0x3b0,
+  /* 0x8a */ jisx0208_uni2indx_page4e + 0x3c0, jisx0208_uni2indx_page4e + 0x3d0,
+  /* 0x8c */ jisx0208_uni2indx_page4e + 0x3e0, jisx0208_uni2indx_page4e + 0x3f0,
+  /* 0x8e */ jisx0208_uni2indx_page4e + 0x400, jisx0208_uni2indx_page4e + 0x410,
+  /* 0x90 */ jisx0208_uni2indx_page4e + 0x420, jisx0208_uni2indx_page4e + 0x430,
+  /* 0x92 */ jisx0208_uni2indx_page4e + 0x440, jisx0208_uni2indx_page4e + 0x450,
+  /* 0x94 */ jisx0208_uni2indx_page4e + 0x460, jisx0208_uni2indx_page4e + 0x470,
+  /* 0x96 */ jisx0208_uni2indx_page4e + 0x480, jisx0208_uni2indx_page4e + 0x490,
+  /* 0x98 */ jisx0208_uni2indx_page4e + 0x4a0, jisx0208_uni2indx_page4e + 0x4b0,
+  /* 0x9a */ jisx0208_uni2indx_page4e + 0x4c0, jisx0208_uni2indx_page4e + 0x4d0,
+  /* 0x9c */ jisx0208_uni2indx_page4e + 0x4e0, jisx0208_uni2indx_page4e + 0x4f0,
+  /* 0x9e */ jisx0208_uni2indx_page4e + 0x500, jisx0208_uni2indx_page4e + 0x510,
+  /* 0xa0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xa8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xb0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xb8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xc0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xc8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xd0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xd8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xe8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf0 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xf8 */ NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+  /* 0xff */ jisx0208_uni2indx_pageff + 0x000,
 };
 
 static int jisx0208_wctomb(unsigned int *r, const unsigned int wc) {
     const Summary16 *summary = NULL;
-    if (wc < 0x0100) {
-        summary = &jisx0208_uni2indx_page00[(wc>>4)];
-    } else if (wc >= 0x0300 && wc < 0x0460) {
-        summary = &jisx0208_uni2indx_page03[(wc>>4)-0x030];
-    } else if (wc >= 0x2000 && wc < 0x2320) {
-        summary = &jisx0208_uni2indx_page20[(wc>>4)-0x200];
-    } else if (wc >= 0x2500 && wc < 0x2670) {
-        summary = &jisx0208_uni2indx_page25[(wc>>4)-0x250];
-    } else if (wc >= 0x3000 && wc < 0x3100) {
-        summary = &jisx0208_uni2indx_page30[(wc>>4)-0x300];
-    } else if (wc >= 0x4e00 && wc < 0x9fb0) {
-        summary = &jisx0208_uni2indx_page4e[(wc>>4)-0x4e0];
-    } else if (wc >= 0xff00 && wc < 0xfff0) {
-        summary = &jisx0208_uni2indx_pageff[(wc>>4)-0xff0];
+    if (wc < 0x10000) {
+        const Summary16 *page = jisx0208_uni2indx_pages[wc >> 8];
+        if (page) {
+            summary = &page[(wc >> 4) & 0x0f];
+        }
     }
     if (summary) {
         unsigned short used = summary->used;
@@ -1477,6 +1554,8 @@ static int jisx0208_wctomb(unsigned int *r, const unsigned int wc) {
     return 0;
 }
 
+#endif /* NO_CJK */
+
 /*
  * SHIFT_JIS (libiconv-1.16/lib/sjis.h)
  */
@@ -1491,6 +1570,7 @@ INTERNAL int sjis_wctomb_zint(unsigned int *r, const unsigned int wc) {
         return ret;
     }
 
+#ifndef NO_CJK
     /* Try JIS X 0208-1990. */
     /* ZINT: Note leaving mapping of full-width reverse solidus U+FF3C to 0x815F (duplicate of patched U+005C) to
      * avoid having to regen tables */
@@ -1498,6 +1578,7 @@ INTERNAL int sjis_wctomb_zint(unsigned int *r, const unsigned int wc) {
     if (ret) {
         return ret;
     }
+#endif
 
     /* User-defined range. See
     * Ken Lunde's "CJKV Information Processing", table 4-66, p. 206. */
@@ -1518,19 +1599,15 @@ INTERNAL int sjis_utf8(struct zint_symbol *symbol, const unsigned char source[],
                 unsigned int *jisdata) {
     int error_number;
     unsigned int i, length;
-#ifndef _MSC_VER
-    unsigned int utfdata[*p_length + 1];
-#else
-    unsigned int *utfdata = (unsigned int *) _alloca((*p_length + 1) * sizeof(unsigned int));
-#endif
 
-    error_number = utf8_to_unicode(symbol, source, utfdata, p_length, 1 /*disallow_4byte*/);
+    /* Decode into `jisdata` and convert in place, each character giving one entry */
+    error_number = utf8_to_unicode(symbol, source, jisdata, p_length, 1 /*disallow_4byte*/);
     if (error_number != 0) {
         return error_number;
     }
 
     for (i = 0, length = *p_length; i < length; i++) {
-        if (!sjis_wctomb_zint(jisdata + i, utfdata[i])) {
+        if (!sjis_wctomb_zint(jisdata + i, jisdata[i])) {
             strcpy(symbol->errtxt, "800: Invalid character in input data");
             return ZINT_ERROR_INVALID_DATA;
         }
@@ -1540,17 +1617,17 @@ INTERNAL int sjis_utf8(struct zint_symbol *symbol, const unsigned char source[],
 }
 
 /* Convert UTF-8 string to ECI and place in array of ints */
-INTERNAL int sjis_utf8_to_eci(const int eci, const unsigned char source[], int *p_length, unsigned int *jisdata,
-                const int full_multibyte) {
+INTERNAL int sjis_utf8_to_eci(struct zint_symbol *symbol, const int eci, const unsigned char source[],
+                int *p_length, unsigned int *jisdata, const int full_multibyte) {
 
     if (is_eci_convertible(eci)) {
         int error_number;
         int eci_length = get_eci_length(eci, source, *p_length);
-#ifndef _MSC_VER
-        unsigned char converted[eci_length + 1];
-#else
-        unsigned char *converted = (unsigned char *) _alloca(eci_length + 1);
-#endif
+        z_work_array(symbol, unsigned char, converted, eci_length + 1);
+
+        if (z_work_failed(converted)) {
+            return z_work_error(symbol);
+        }
 
         error_number = utf8_to_eci(eci, source, converted, p_length);
         if (error_number != 0) {
@@ -1597,3 +1674,9 @@ INTERNAL void sjis_cpy(const unsigned char source[], int *p_length, unsigned int
         }
     }
 }
+
+/* Page in the main conversion tables (if `touch`) for `ZBarcode_Init()`, returning their size */
+INTERNAL size_t sjis_tables_warm(const int touch) {
+    return z_table_warm(jisx0208_2charset, sizeof(jisx0208_2charset), touch)
+            + z_table_warm(jisx0208_uni2indx_page4e, sizeof(jisx0208_uni2indx_page4e), touch);
+}
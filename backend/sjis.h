@@ -40,8 +40,8 @@ extern "C" {
 INTERNAL int sjis_wctomb_zint(unsigned int *r, const unsigned int wc);
 INTERNAL int sjis_utf8(struct zint_symbol *symbol, const unsigned char source[], int *p_length,
                 unsigned int *jisdata);
-INTERNAL int sjis_utf8_to_eci(const int eci, const unsigned char source[], int *p_length, unsigned int *jisdata,
-                const int full_multibyte);
+INTERNAL int sjis_utf8_to_eci(struct zint_symbol *symbol, const int eci, const unsigned char source[],
+                int *p_length, unsigned int *jisdata, const int full_multibyte);
 INTERNAL void sjis_cpy(const unsigned char source[], int *p_length, unsigned int *jisdata, const int full_multibyte);
 
 #ifdef __cplusplus
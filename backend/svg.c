@@ -31,7 +31,6 @@
  */
 /* vim: set ts=4 sw=4 et : */
 
-#include <locale.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
@@ -40,6 +39,8 @@
 #endif
 
 #include "common.h"
+#include "output.h"
+#include "filemem.h"
 
 static void pick_colour(int colour, char colour_code[]) {
     switch(colour) {
@@ -114,14 +115,210 @@ static void make_html_friendly(unsigned char * string, char * html_version) {
     }
 }
 
+/* Vertices of hexagon `hex` as x, y pairs, `radius` etc. being for its diameter */
+static void svg_hex_vertices(const struct zint_vector_hexagon *hex, const float radius, const float half_radius,
+            const float half_sqrt3_radius, float v[12]) {
+    if ((hex->rotation == 0) || (hex->rotation == 180)) {
+        v[1] = hex->y + radius;
+        v[3] = hex->y + half_radius;
+        v[5] = hex->y - half_radius;
+        v[7] = hex->y - radius;
+        v[9] = hex->y - half_radius;
+        v[11] = hex->y + half_radius;
+        v[0] = hex->x;
+        v[2] = hex->x + half_sqrt3_radius;
+        v[4] = hex->x + half_sqrt3_radius;
+        v[6] = hex->x;
+        v[8] = hex->x - half_sqrt3_radius;
+        v[10] = hex->x - half_sqrt3_radius;
+    } else {
+        v[1] = hex->y;
+        v[3] = hex->y + half_sqrt3_radius;
+        v[5] = hex->y + half_sqrt3_radius;
+        v[7] = hex->y;
+        v[9] = hex->y - half_sqrt3_radius;
+        v[11] = hex->y - half_sqrt3_radius;
+        v[0] = hex->x - radius;
+        v[2] = hex->x - half_radius;
+        v[4] = hex->x + half_radius;
+        v[6] = hex->x + radius;
+        v[8] = hex->x + half_radius;
+        v[10] = hex->x - half_radius;
+    }
+}
+
+/* Compact output (SVG_COMPACT) - elements of the same colour are merged into a single path using relative moves,
+   with coordinates rounded to hundredths as integers so that relative offsets don't accumulate rounding errors */
+
+/* Put closing quote of path "d" attribute, followed by `fill` if any and opacity if `alpha` not opaque */
+static void svg_path_end(struct filemem *fmp, const char *fill, const int alpha, const float opacity) {
+    fm_putc('"', fmp);
+    if (fill) {
+        fm_printf(fmp, " fill=\"#%s\"", fill);
+    }
+    if (alpha != 0xff) {
+        fm_putsf(" opacity=\"", 3, opacity, fmp);
+        fm_putc('"', fmp);
+    }
+    fm_puts(" />\n", fmp);
+}
+
+/* Rectangles, one path per colour in order of first appearance (bars and modules don't overlap) */
+static void svg_compact_rects(struct filemem *fmp, const struct zint_vector_rect *rects, const int fg_alpha,
+            const float fg_alpha_opacity) {
+    const struct zint_vector_rect *rect;
+    int colours[10]; /* Foreground (-1) and Ultracode colours 0 to 8 */
+    int colours_size = 0;
+    int i;
+    char buf[72];
+    char colour_code[7];
+
+    for (rect = rects; rect; rect = rect->next) {
+        for (i = 0; i < colours_size && colours[i] != rect->colour; i++);
+        if (i == colours_size) {
+            colours[colours_size++] = rect->colour;
+        }
+    }
+
+    for (i = 0; i < colours_size; i++) {
+        int px = 0, py = 0;
+        int first = 1;
+        fm_puts("      <path d=\"", fmp);
+        for (rect = rects; rect; rect = rect->next) {
+            if (rect->colour == colours[i]) {
+                const int x = output_hundredths(rect->x), y = output_hundredths(rect->y);
+                const int w = output_hundredths(rect->width), h = output_hundredths(rect->height);
+                char *b = buf;
+                if (first) {
+                    b = output_put_hundredths(b, 'M', x);
+                    b = output_put_hundredths(b, ' ', y);
+                    first = 0;
+                } else {
+                    b = output_put_hundredths(b, 'm', x - px);
+                    b = output_put_hundredths(b, ' ', y - py);
+                }
+                b = output_put_hundredths(b, 'h', w);
+                b = output_put_hundredths(b, 'v', h);
+                b = output_put_hundredths(b, 'h', -w);
+                *b++ = 'Z';
+                fm_write(buf, 1, b - buf, fmp);
+                px = x; /* Current point after close path is start of sub-path */
+                py = y;
+            }
+        }
+        if (colours[i] != -1) {
+            pick_colour(colours[i], colour_code);
+        }
+        svg_path_end(fmp, colours[i] != -1 ? colour_code : NULL, fg_alpha, fg_alpha_opacity);
+    }
+}
+
+/* Hexagons, all foreground, as a single path */
+static void svg_compact_hexagons(struct filemem *fmp, const struct zint_vector_hexagon *hexes, const int fg_alpha,
+            const float fg_alpha_opacity) {
+    const struct zint_vector_hexagon *hex;
+    float previous_diameter = 0.0f, radius = 0.0f, half_radius = 0.0f, half_sqrt3_radius = 0.0f;
+    float v[12];
+    int px = 0, py = 0;
+    int first = 1;
+    int i;
+    char buf[160];
+
+    fm_puts("      <path d=\"", fmp);
+    for (hex = hexes; hex; hex = hex->next) {
+        int vx[6], vy[6];
+        char *b = buf;
+        if (previous_diameter != hex->diameter) {
+            previous_diameter = hex->diameter;
+            radius = (float) (0.5 * previous_diameter);
+            half_radius = (float) (0.25 * previous_diameter);
+            half_sqrt3_radius = (float) (0.43301270189221932338 * previous_diameter);
+        }
+        svg_hex_vertices(hex, radius, half_radius, half_sqrt3_radius, v);
+        for (i = 0; i < 6; i++) {
+            vx[i] = output_hundredths(v[i * 2]);
+            vy[i] = output_hundredths(v[i * 2 + 1]);
+        }
+        if (first) {
+            b = output_put_hundredths(b, 'M', vx[0]);
+            b = output_put_hundredths(b, ' ', vy[0]);
+            first = 0;
+        } else {
+            b = output_put_hundredths(b, 'm', vx[0] - px);
+            b = output_put_hundredths(b, ' ', vy[0] - py);
+        }
+        b = output_put_hundredths(b, 'l', vx[1] - vx[0]);
+        b = output_put_hundredths(b, ' ', vy[1] - vy[0]);
+        for (i = 2; i < 6; i++) {
+            b = output_put_hundredths(b, ' ', vx[i] - vx[i - 1]);
+            b = output_put_hundredths(b, ' ', vy[i] - vy[i - 1]);
+        }
+        *b++ = 'Z';
+        fm_write(buf, 1, b - buf, fmp);
+        px = vx[0];
+        py = vy[0];
+    }
+    svg_path_end(fmp, NULL, fg_alpha, fg_alpha_opacity);
+}
+
+/* Circles, as a path for each run of the same colour (order matters as they can overlap, e.g. MaxiCode
+   bullseye), each circle being 2 arcs starting from its leftmost point */
+static void svg_compact_circles(struct filemem *fmp, const struct zint_vector_circle *circles,
+            const char *bgcolour_string, const int fg_alpha, const float fg_alpha_opacity, const int bg_alpha,
+            const float bg_alpha_opacity) {
+    const struct zint_vector_circle *circle = circles;
+    char buf[128];
+
+    while (circle) {
+        const int colour = circle->colour;
+        int px = 0, py = 0;
+        int first = 1;
+        fm_puts("      <path d=\"", fmp);
+        for (; circle && circle->colour == colour; circle = circle->next) {
+            const int r = output_hundredths((float) (0.5 * circle->diameter));
+            const int x = output_hundredths(circle->x) - r, y = output_hundredths(circle->y);
+            char *b = buf;
+            if (first) {
+                b = output_put_hundredths(b, 'M', x);
+                b = output_put_hundredths(b, ' ', y);
+                first = 0;
+            } else {
+                b = output_put_hundredths(b, 'm', x - px);
+                b = output_put_hundredths(b, ' ', y - py);
+            }
+            b = output_put_hundredths(b, 'a', r);
+            b = output_put_hundredths(b, ' ', r);
+            memcpy(b, " 0 1 0", 6);
+            b = output_put_hundredths(b + 6, ' ', r * 2);
+            *b++ = ' ';
+            *b++ = '0';
+            b = output_put_hundredths(b, 'a', r);
+            b = output_put_hundredths(b, ' ', r);
+            memcpy(b, " 0 1 0", 6);
+            b = output_put_hundredths(b + 6, ' ', -r * 2);
+            *b++ = ' ';
+            *b++ = '0';
+            *b++ = 'Z';
+            fm_write(buf, 1, b - buf, fmp);
+            px = x;
+            py = y;
+        }
+        if (colour) {
+            svg_path_end(fmp, bgcolour_string, bg_alpha, bg_alpha_opacity);
+        } else {
+            svg_path_end(fmp, NULL, fg_alpha, fg_alpha_opacity);
+        }
+    }
+}
+
 INTERNAL int svg_plot(struct zint_symbol *symbol) {
-    FILE *fsvg;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
     int error_number = 0;
-    const char *locale = NULL;
-    float ax, ay, bx, by, cx, cy, dx, dy, ex, ey, fx, fy;
+    float v[12]; /* Hexagon vertices */
     float previous_diameter;
     float radius, half_radius, half_sqrt3_radius;
-    int i;
+    int i, j;
     char fgcolour_string[7];
     char bgcolour_string[7];
     int bg_alpha = 0xff;
@@ -137,6 +334,8 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
 
     char colour_code[7];
     int html_len;
+    const float *t;
+    int transformed;
 
 #ifdef _MSC_VER
     char* html_string;
@@ -149,17 +348,13 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
     fgcolour_string[6] = '\0';
     bgcolour_string[6] = '\0';
     
-    if (strlen(symbol->fgcolour) > 6) {
-        fg_alpha = (16 * ctoi(symbol->fgcolour[6])) + ctoi(symbol->fgcolour[7]);
-        if (fg_alpha != 0xff) {
-            fg_alpha_opacity = (float) (fg_alpha / 255.0);
-        }
+    fg_alpha = OUT_ALPHA(symbol->fgcolour_rgba);
+    if (fg_alpha != 0xff) {
+        fg_alpha_opacity = (float) (fg_alpha / 255.0);
     }
-    if (strlen(symbol->bgcolour) > 6) {
-        bg_alpha = (16 * ctoi(symbol->bgcolour[6])) + ctoi(symbol->bgcolour[7]);
-        if (bg_alpha != 0xff) {
-            bg_alpha_opacity = (float) (bg_alpha / 255.0);
-        }
+    bg_alpha = OUT_ALPHA(symbol->bgcolour_rgba);
+    if (bg_alpha != 0xff) {
+        bg_alpha_opacity = (float) (bg_alpha / 255.0);
     }
     
     html_len = strlen((char *)symbol->text) + 1;
@@ -187,52 +382,89 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
     if (symbol->vector == NULL) {
         return ZINT_ERROR_INVALID_DATA;
     }
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fsvg = stdout;
-    } else {
-        fsvg = fopen(symbol->outfile, "w");
+    t = symbol->vector->transform;
+    transformed = t[0] != 1.0f || t[1] != 0.0f || t[2] != 0.0f || t[3] != 1.0f || t[4] != 0.0f || t[5] != 0.0f;
+
+#ifdef NO_PNG
+    if (symbol->output_options & SVG_GZIP) {
+        strcpy(symbol->errtxt, "744: SVG gzip compression not available (no zlib)");
+        return ZINT_ERROR_INVALID_OPTION;
     }
-    if (fsvg == NULL) {
+#endif
+
+    if (!fm_open(fmp, symbol, symbol->output_options & SVG_GZIP ? "wb" : "w")) {
         strcpy(symbol->errtxt, "680: Could not open output file");
         return ZINT_ERROR_FILE_ACCESS;
     }
-
-    locale = setlocale(LC_ALL, "C");
+    /* Deflated as it's output (SVGZ) */
+    if ((symbol->output_options & SVG_GZIP) && !fm_gzip(fmp, symbol->output_options & BARCODE_FAST_COMPRESS)) {
+        (void) fm_close(fmp, symbol);
+        strcpy(symbol->errtxt, "745: Insufficient memory for SVG gzip compression");
+        return ZINT_ERROR_MEMORY;
+    }
 
     /* Start writing the header */
-    fprintf(fsvg, "<?xml version=\"1.0\" standalone=\"no\"?>\n");
-    fprintf(fsvg, "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\"\n");
-    fprintf(fsvg, "   \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n");
-    fprintf(fsvg, "<svg width=\"%d\" height=\"%d\" version=\"1.1\"\n", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height));
-    fprintf(fsvg, "   xmlns=\"http://www.w3.org/2000/svg\">\n");
-    fprintf(fsvg, "   <desc>Zint Generated Symbol\n");
-    fprintf(fsvg, "   </desc>\n");
-    fprintf(fsvg, "\n   <g id=\"barcode\" fill=\"#%s\">\n", fgcolour_string);
+    fm_printf(fmp, "<?xml version=\"1.0\" standalone=\"no\"?>\n");
+    fm_printf(fmp, "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\"\n");
+    fm_printf(fmp, "   \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n");
+    fm_printf(fmp, "<svg width=\"%d\" height=\"%d\" version=\"1.1\"\n", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height));
+    fm_printf(fmp, "   xmlns=\"http://www.w3.org/2000/svg\">\n");
+    fm_printf(fmp, "   <desc>Zint Generated Symbol\n");
+    fm_printf(fmp, "   </desc>\n");
+    fm_printf(fmp, "\n   <g id=\"barcode\" fill=\"#%s\">\n", fgcolour_string);
 
     if (bg_alpha != 0) {
-        fprintf(fsvg, "      <rect x=\"0\" y=\"0\" width=\"%d\" height=\"%d\" fill=\"#%s\"", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height), bgcolour_string);
+        fm_printf(fmp, "      <rect x=\"0\" y=\"0\" width=\"%d\" height=\"%d\" fill=\"#%s\"", (int) ceil(symbol->vector->width), (int) ceil(symbol->vector->height), bgcolour_string);
         if (bg_alpha != 0xff) {
-            fprintf(fsvg, " opacity=\"%.3f\"", bg_alpha_opacity);
+            fm_putsf(" opacity=\"", 3, bg_alpha_opacity, fmp);
+            fm_putc('"', fmp);
         }
-        fprintf(fsvg, " />\n");
+        fm_printf(fmp, " />\n");
     }
 
-    rect = symbol->vector->rectangles;
+    if (transformed) {
+        /* Elements left unscaled and unrotated, see VECTOR_TRANSFORM */
+        fm_puts("   <g transform=\"matrix(", fmp);
+        for (i = 0; i < 6; i++) {
+            fm_putsf(i ? " " : "", 4, t[i], fmp);
+        }
+        fm_puts(")\">\n", fmp);
+    }
+
+    if (symbol->output_options & SVG_COMPACT) {
+        if (symbol->vector->rectangles) {
+            svg_compact_rects(fmp, symbol->vector->rectangles, fg_alpha, fg_alpha_opacity);
+        }
+        if (symbol->vector->hexagons) {
+            svg_compact_hexagons(fmp, symbol->vector->hexagons, fg_alpha, fg_alpha_opacity);
+        }
+        if (symbol->vector->circles) {
+            svg_compact_circles(fmp, symbol->vector->circles, bgcolour_string, fg_alpha, fg_alpha_opacity,
+                                bg_alpha, bg_alpha_opacity);
+        }
+    }
+
+    rect = (symbol->output_options & SVG_COMPACT) ? NULL : symbol->vector->rectangles;
     while (rect) {
-        fprintf(fsvg, "      <rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\"", rect->x, rect->y, rect->width, rect->height);
+        fm_putsf("      <rect x=\"", 2, rect->x, fmp);
+        fm_putsf("\" y=\"", 2, rect->y, fmp);
+        fm_putsf("\" width=\"", 2, rect->width, fmp);
+        fm_putsf("\" height=\"", 2, rect->height, fmp);
+        fm_putc('"', fmp);
         if (rect->colour != -1) {
             pick_colour(rect->colour, colour_code);
-            fprintf(fsvg, " fill=\"#%s\"", colour_code);
+            fm_printf(fmp, " fill=\"#%s\"", colour_code);
         }
         if (fg_alpha != 0xff) {
-            fprintf(fsvg, " opacity=\"%.3f\"", fg_alpha_opacity);
+            fm_putsf(" opacity=\"", 3, fg_alpha_opacity, fmp);
+            fm_putc('"', fmp);
         }
-        fprintf(fsvg, " />\n");
+        fm_printf(fmp, " />\n");
         rect = rect->next;
     }
 
     previous_diameter = radius = half_radius = half_sqrt3_radius = 0.0f;
-    hex = symbol->vector->hexagons;
+    hex = (symbol->output_options & SVG_COMPACT) ? NULL : symbol->vector->hexagons;
     while (hex) {
         if (previous_diameter != hex->diameter) {
             previous_diameter = hex->diameter;
@@ -240,62 +472,48 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
             half_radius = (float) (0.25 * previous_diameter);
             half_sqrt3_radius = (float) (0.43301270189221932338 * previous_diameter);
         }
-        if ((hex->rotation == 0) || (hex->rotation == 180)) {
-            ay = hex->y + radius;
-            by = hex->y + half_radius;
-            cy = hex->y - half_radius;
-            dy = hex->y - radius;
-            ey = hex->y - half_radius;
-            fy = hex->y + half_radius;
-            ax = hex->x;
-            bx = hex->x + half_sqrt3_radius;
-            cx = hex->x + half_sqrt3_radius;
-            dx = hex->x;
-            ex = hex->x - half_sqrt3_radius;
-            fx = hex->x - half_sqrt3_radius;
-        } else {
-            ay = hex->y;
-            by = hex->y + half_sqrt3_radius;
-            cy = hex->y + half_sqrt3_radius;
-            dy = hex->y;
-            ey = hex->y - half_sqrt3_radius;
-            fy = hex->y - half_sqrt3_radius;
-            ax = hex->x - radius;
-            bx = hex->x - half_radius;
-            cx = hex->x + half_radius;
-            dx = hex->x + radius;
-            ex = hex->x + half_radius;
-            fx = hex->x - half_radius;
+        svg_hex_vertices(hex, radius, half_radius, half_sqrt3_radius, v);
+        fm_putsf("      <path d=\"M ", 2, v[0], fmp);
+        fm_putsf(" ", 2, v[1], fmp);
+        for (j = 2; j < 12; j += 2) {
+            fm_putsf(" L ", 2, v[j], fmp);
+            fm_putsf(" ", 2, v[j + 1], fmp);
         }
-        fprintf(fsvg, "      <path d=\"M %.2f %.2f L %.2f %.2f L %.2f %.2f L %.2f %.2f L %.2f %.2f L %.2f %.2f Z\"", ax, ay, bx, by, cx, cy, dx, dy, ex, ey, fx, fy);
+        fm_puts(" Z\"", fmp);
         if (fg_alpha != 0xff) {
-            fprintf(fsvg, " opacity=\"%.3f\"", fg_alpha_opacity);
+            fm_putsf(" opacity=\"", 3, fg_alpha_opacity, fmp);
+            fm_putc('"', fmp);
         }
-        fprintf(fsvg, " />\n");
+        fm_printf(fmp, " />\n");
         hex = hex->next;
     }
 
     previous_diameter = radius = 0.0f;
-    circle = symbol->vector->circles;
+    circle = (symbol->output_options & SVG_COMPACT) ? NULL : symbol->vector->circles;
     while (circle) {
         if (previous_diameter != circle->diameter) {
             previous_diameter = circle->diameter;
             radius = (float) (0.5 * previous_diameter);
         }
-        fprintf(fsvg, "      <circle cx=\"%.2f\" cy=\"%.2f\" r=\"%.2f\"", circle->x, circle->y, radius);
+        fm_putsf("      <circle cx=\"", 2, circle->x, fmp);
+        fm_putsf("\" cy=\"", 2, circle->y, fmp);
+        fm_putsf("\" r=\"", 2, radius, fmp);
+        fm_putc('"', fmp);
         
         if (circle->colour) {
-            fprintf(fsvg, " fill=\"#%s\"", bgcolour_string);
+            fm_printf(fmp, " fill=\"#%s\"", bgcolour_string);
             if (bg_alpha != 0xff) {
                 // This doesn't work how the user is likely to expect - more work needed!
-                fprintf(fsvg, " opacity=\"%.3f\"", bg_alpha_opacity);
+                fm_putsf(" opacity=\"", 3, bg_alpha_opacity, fmp);
+                fm_putc('"', fmp);
             }
         } else {
             if (fg_alpha != 0xff) {
-                fprintf(fsvg, " opacity=\"%.3f\"", fg_alpha_opacity);
+                fm_putsf(" opacity=\"", 3, fg_alpha_opacity, fmp);
+                fm_putc('"', fmp);
             }
         }
-        fprintf(fsvg, " />\n");
+        fm_printf(fmp, " />\n");
         circle = circle->next;
     }
 
@@ -303,35 +521,42 @@ INTERNAL int svg_plot(struct zint_symbol *symbol) {
     string = symbol->vector->strings;
     while (string) {
         const char *halign = string->halign == 2 ? "end" : string->halign == 1 ? "start" : "middle";
-        fprintf(fsvg, "      <text x=\"%.2f\" y=\"%.2f\" text-anchor=\"%s\"\n", string->x, string->y, halign);
-        fprintf(fsvg, "         font-family=\"%s\" font-size=\"%.1f\"", font_family, string->fsize);
+        fm_putsf("      <text x=\"", 2, string->x, fmp);
+        fm_putsf("\" y=\"", 2, string->y, fmp);
+        fm_printf(fmp, "\" text-anchor=\"%s\"\n", halign);
+        fm_printf(fmp, "         font-family=\"%s\"", font_family);
+        fm_putsf(" font-size=\"", 1, string->fsize, fmp);
+        fm_putc('"', fmp);
         if (bold) {
-            fprintf(fsvg, " font-weight=\"bold\"");
+            fm_printf(fmp, " font-weight=\"bold\"");
         }
         if (fg_alpha != 0xff) {
-            fprintf(fsvg, " opacity=\"%.3f\"", fg_alpha_opacity);
+            fm_putsf(" opacity=\"", 3, fg_alpha_opacity, fmp);
+            fm_putc('"', fmp);
         }
         if (string->rotation != 0) {
-            fprintf(fsvg, " transform=\"rotate(%d,%.2f,%.2f)\"", string->rotation, string->x, string->y);
+            fm_printf(fmp, " transform=\"rotate(%d", string->rotation);
+            fm_putsf(",", 2, string->x, fmp);
+            fm_putsf(",", 2, string->y, fmp);
+            fm_puts(")\"", fmp);
         }
-        fprintf(fsvg, " >\n");
+        fm_printf(fmp, " >\n");
         make_html_friendly(string->text, html_string);
-        fprintf(fsvg, "         %s\n", html_string);
-        fprintf(fsvg, "      </text>\n");
+        fm_printf(fmp, "         %s\n", html_string);
+        fm_printf(fmp, "      </text>\n");
         string = string->next;
     }
 
-    fprintf(fsvg, "   </g>\n");
-    fprintf(fsvg, "</svg>\n");
-
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(fsvg);
-    } else {
-        fclose(fsvg);
+    if (transformed) {
+        fm_printf(fmp, "   </g>\n");
     }
+    fm_printf(fmp, "   </g>\n");
+    fm_printf(fmp, "</svg>\n");
 
-    if (locale)
-        setlocale(LC_ALL, locale);
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "681: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
+    }
 
     return error_number;
 }
@@ -0,0 +1,285 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+/* Fuzz target for `ZBarcode_Encode()` over every symbology and input mode, failing (by `abort()`) any input that
+ * takes longer than a time budget to encode, so that quadratic or worse behaviour shows up as a crash.
+ *
+ * Each input is a 6-byte header selecting the settings followed by the data:
+ *   byte 0: symbology (index into the valid symbologies, modulo their number)
+ *   byte 1: input mode (bits 0-1 DATA_MODE/UNICODE_MODE/GS1_MODE, bits 2-7 ESCAPE_MODE, GS1PARENS_MODE,
+ *           MINIMAL_MODE, GS1NOCHECK_MODE, FAST_MODE and whether data up to the first 0x1F byte is `primary`)
+ *   byte 2: `option_1`, -1 (default) if < 128, else value modulo 10
+ *   byte 3: `option_2`, 0 (default) if < 128, else value modulo 100
+ *   byte 4: `option_3`, 0 (default) if < 128, else one of `option3s[]`
+ *   byte 5: ECI, 0 (default) if < 128, else one of `ecis[]`
+ *
+ * Built with libFuzzer if ZINT_FUZZ_LIBFUZZER defined (see CMakeLists.txt option ZINT_FUZZ), e.g.
+ *   ./fuzz_encode_libfuzzer -timeout=5 -max_len=4096 corpus/
+ * and otherwise as a standalone driver that runs the files given (or stdin if none, as for AFL), e.g.
+ *   afl-fuzz -t 2000 -i in -o out -- ./fuzz_encode @@
+ * or generates its own random inputs (-n), see usage(). The budget in milliseconds is set by -b, or else the
+ * environment variable ZINT_FUZZ_BUDGET_MS, default 1000 (CPU time, encoding only) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../zint.h"
+
+static const int option3s[] = {
+    DM_SQUARE, DM_DMRE, ZINT_FULL_MULTIBYTE, ZINT_FULL_MULTIBYTE | (1 << 8), ZINT_FULL_MULTIBYTE | (8 << 8),
+    ULTRA_COMPRESSION, 4, 8, 11
+};
+
+static const int ecis[] = {
+    3, 4, 7, 9, 13, 17, 20, 25, 26, 28, 29, 30, 899
+};
+
+static int symbologies[256];
+static int symbologies_count;
+
+static long budget_ms;
+
+/* Set up list of valid symbologies and the budget */
+static void fuzz_init(void) {
+    const char *env;
+    int i;
+
+    if (symbologies_count) {
+        return;
+    }
+    for (i = 1; i < 256; i++) {
+        if (ZBarcode_ValidID(i)) {
+            symbologies[symbologies_count++] = i;
+        }
+    }
+    if (!budget_ms) {
+        budget_ms = (env = getenv("ZINT_FUZZ_BUDGET_MS")) && atol(env) > 0 ? atol(env) : 1000;
+    }
+}
+
+/* Encode one input, aborting if over budget */
+static int fuzz_one(const unsigned char *input, size_t size) {
+    static const int input_flags[] = {
+        ESCAPE_MODE, GS1PARENS_MODE, MINIMAL_MODE, GS1NOCHECK_MODE, FAST_MODE
+    };
+    struct zint_symbol *symbol;
+    const unsigned char *data;
+    int length, i;
+    clock_t start;
+    long elapsed_ms;
+
+    fuzz_init();
+
+    if (size < 6 || size > ZINT_MAX_DATA_LEN + 6) {
+        return 0;
+    }
+    if (!(symbol = ZBarcode_Create())) {
+        return 0;
+    }
+    symbol->symbology = symbologies[input[0] % symbologies_count];
+    symbol->input_mode = (input[1] & 0x03) % 3;
+    for (i = 0; i < 5; i++) {
+        if (input[1] & (0x04 << i)) {
+            symbol->input_mode |= input_flags[i];
+        }
+    }
+    symbol->option_1 = input[2] < 128 ? -1 : input[2] % 10;
+    symbol->option_2 = input[3] < 128 ? 0 : input[3] % 100;
+    symbol->option_3 = input[4] < 128 ? 0 : option3s[input[4] % (sizeof(option3s) / sizeof(option3s[0]))];
+    symbol->eci = input[5] < 128 ? 0 : ecis[input[5] % (sizeof(ecis) / sizeof(ecis[0]))];
+    data = input + 6;
+    length = (int) (size - 6);
+    if (input[1] & 0x80) {
+        const unsigned char *sep = (const unsigned char *) memchr(data, 0x1F, length);
+        if (sep && sep - data < (int) sizeof(symbol->primary)) {
+            memcpy(symbol->primary, data, sep - data);
+            symbol->primary[sep - data] = '\0';
+            length -= (int) (sep - data) + 1;
+            data = sep + 1;
+        }
+    }
+
+    start = clock();
+    (void) ZBarcode_Encode(symbol, data, length);
+    elapsed_ms = (long) ((clock() - start) * 1000 / CLOCKS_PER_SEC);
+
+    if (elapsed_ms > budget_ms) {
+        fprintf(stderr, "fuzz_encode: over budget %ld ms > %ld ms: symbology %d, input_mode 0x%X, option_1 %d,"
+                " option_2 %d, option_3 0x%X, eci %d, primary \"%s\", length %d\n",
+                elapsed_ms, budget_ms, symbol->symbology, symbol->input_mode, symbol->option_1, symbol->option_2,
+                symbol->option_3, symbol->eci, symbol->primary, length);
+        abort();
+    }
+
+    ZBarcode_Delete(symbol);
+
+    return 0;
+}
+
+#ifdef ZINT_FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size);
+
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size) {
+    return fuzz_one(data, size);
+}
+
+#else
+
+/* Alphabets for generated data, chosen per run of characters so that mode switching is exercised */
+static const char *const alphabets[] = {
+    "0123456789",
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ 0123456789",
+    "abcdefghijklmnopqrstuvwxyz",
+    "ABC*>\r 0123",
+    "@ABC^_ !\"#$%&'()*+,-./:;<=>?",
+    "[](){}\\|~`",
+    "\x80\x91\xA0\xC3\xA9\xE6\x97\xA5\xFF",
+    "\r\t\x1D\x1E\x04",
+};
+
+static unsigned int rand_state = 1;
+
+/* Linear congruential generator, so that runs can be repeated on all platforms */
+static unsigned int fuzz_rand(void) {
+    rand_state = rand_state * 1103515245 + 12345;
+    return (rand_state >> 16) & 0x7FFF;
+}
+
+/* Generate a random input of up to `max_len` data bytes in `buf`, returning its size */
+static size_t fuzz_generate(unsigned char *buf, const int max_len) {
+    const int len = max_len ? (int) (((unsigned long) fuzz_rand() << 15 | fuzz_rand()) % (max_len + 1)) : 0;
+    int i;
+
+    /* Mostly DATA_MODE and default options so that most inputs get past the checks, no primary */
+    buf[0] = (unsigned char) fuzz_rand();
+    buf[1] = (unsigned char) ((fuzz_rand() % 4 == 0 ? fuzz_rand() & 0x7C : 0) | (fuzz_rand() % 8 == 0 ? 2 : 0));
+    for (i = 2; i < 6; i++) {
+        buf[i] = (unsigned char) (fuzz_rand() % 8 == 0 ? fuzz_rand() | 0x80 : 0);
+    }
+    for (i = 0; i < len;) {
+        const char *alphabet = alphabets[fuzz_rand() % (sizeof(alphabets) / sizeof(alphabets[0]))];
+        const int alen = (int) strlen(alphabet);
+        int run = fuzz_rand() % 4 == 0 ? (int) (fuzz_rand() % 2000 + 1) : (int) (fuzz_rand() % 16 + 1);
+        for (; run && i < len; run--, i++) {
+            buf[6 + i] = (unsigned char) alphabet[fuzz_rand() % alen];
+        }
+    }
+
+    return 6 + len;
+}
+
+static int fuzz_file(const char *filename, unsigned char *buf) {
+    FILE *fp = filename ? fopen(filename, "rb") : stdin;
+    size_t size;
+
+    if (!fp) {
+        fprintf(stderr, "fuzz_encode: failed to open '%s'\n", filename);
+        return 1;
+    }
+    size = fread(buf, 1, ZINT_MAX_DATA_LEN + 6, fp);
+    if (filename) {
+        (void) fclose(fp);
+    }
+    return fuzz_one(buf, size);
+}
+
+static void usage(void) {
+    printf("Usage: fuzz_encode [-b <budget_ms>] [<file>...]\n"
+           "       fuzz_encode [-b <budget_ms>] -n <count> [-s <seed>] [-l <max_len>] [-o <file>]\n"
+           "  Encode each file (or stdin if none), or <count> random inputs of up to <max_len> (default 2000)\n"
+           "  data bytes from <seed> (default 1), aborting any over <budget_ms> (default 1000, or\n"
+           "  ZINT_FUZZ_BUDGET_MS). If -o given, each random input is first written to <file> so that it is\n"
+           "  left behind for replaying should it abort\n");
+}
+
+int main(int argc, char *argv[]) {
+    static unsigned char buf[ZINT_MAX_DATA_LEN + 6];
+    long count = -1;
+    int max_len = 2000;
+    const char *outfile = NULL;
+    int i, files = 0, ret = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0) {
+            usage();
+            return 0;
+        }
+        if (argv[i][0] == '-' && argv[i][1] && !argv[i][2] && strchr("bnslo", argv[i][1]) && i + 1 < argc) {
+            switch (argv[i++][1]) {
+                case 'b': budget_ms = atol(argv[i]); break;
+                case 'n': count = atol(argv[i]); break;
+                case 's': rand_state = (unsigned int) strtoul(argv[i], NULL, 10); break;
+                case 'l': max_len = atoi(argv[i]); break;
+                case 'o': outfile = argv[i]; break;
+            }
+        } else if (argv[i][0] == '-' && argv[i][1]) {
+            usage();
+            return 1;
+        }
+    }
+    if (max_len < 0 || max_len > ZINT_MAX_DATA_LEN) {
+        max_len = ZINT_MAX_DATA_LEN;
+    }
+
+    if (count >= 0) {
+        long n;
+        for (n = 0; n < count; n++) {
+            const size_t size = fuzz_generate(buf, max_len);
+            if (outfile) {
+                FILE *fp = fopen(outfile, "wb");
+                if (!fp || fwrite(buf, 1, size, fp) != size || fclose(fp) != 0) {
+                    fprintf(stderr, "fuzz_encode: failed to write '%s'\n", outfile);
+                    return 1;
+                }
+            }
+            (void) fuzz_one(buf, size);
+        }
+        return 0;
+    }
+
+    for (i = 1; i < argc; i++) {
+        if (argv[i][0] == '-' && argv[i][1]) {
+            i++;
+            continue;
+        }
+        ret |= fuzz_file(argv[i], buf);
+        files++;
+    }
+    if (!files) {
+        ret = fuzz_file(NULL, buf);
+    }
+
+    return ret;
+}
+
+#endif /* ZINT_FUZZ_LIBFUZZER */
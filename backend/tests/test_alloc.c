@@ -0,0 +1,359 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include "testcommon.h"
+
+/* Allocations made by the library's steady-state (i.e. repeated) `ZBarcode_Encode()`, `ZBarcode_Buffer()` and
+   `ZBarcode_Print()` (to a GIF memory file) for each symbology. Counts must match exactly (so that any increase, and
+   in particular of a currently zero count, is caught), printing needing none at all. Re-record with `-g` when an
+   allocation is deliberately added or removed. The heap used by each call over what is already allocated when it
+   is made (its working peak) may not exceed that of the first call, so that nothing kept between calls grows.
+   Working peaks are printed with `-d 16` */
+static void test_steady_state(int index, int generate, int debug) {
+
+    testStart("");
+
+#ifdef ZINT_BOUNDED_STACK
+    testSkip("Encoder working arrays allocated in ZINT_BOUNDED_STACK builds");
+    return;
+#endif
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        char *data;
+        char *primary;
+
+        long expected_encode_allocs;
+        long expected_buffer_allocs;
+        long expected_print_allocs;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE11, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /*  1*/ { BARCODE_C25STANDARD, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /*  2*/ { BARCODE_C25INTER, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /*  3*/ { BARCODE_C25IATA, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /*  4*/ { BARCODE_C25LOGIC, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /*  5*/ { BARCODE_C25IND, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /*  6*/ { BARCODE_CODE39, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /*  7*/ { BARCODE_EXCODE39, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /*  8*/ { BARCODE_EANX, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /*  9*/ { BARCODE_EANX_CHK, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 10*/ { BARCODE_GS1_128, GS1_MODE, "[01]12345678901231[10]ABC123", "", 0, 0, 0 },
+        /* 11*/ { BARCODE_CODABAR, UNICODE_MODE, "A0123456789B", "", 0, 0, 0 },
+        /* 12*/ { BARCODE_CODE128, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 13*/ { BARCODE_DPLEIT, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 14*/ { BARCODE_DPIDENT, UNICODE_MODE, "01234565", "", 0, 0, 0 },
+        /* 15*/ { BARCODE_CODE16K, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 16*/ { BARCODE_CODE49, UNICODE_MODE, "ZINT BARCODE 0123456789", "", 0, 0, 0 },
+        /* 17*/ { BARCODE_CODE93, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 18*/ { BARCODE_FLAT, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 19*/ { BARCODE_DBAR_OMN, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 20*/ { BARCODE_DBAR_LTD, UNICODE_MODE, "036000291452", "", 0, 0, 0 },
+        /* 21*/ { BARCODE_DBAR_EXP, GS1_MODE, "[01]12345678901231[10]ABC123", "", 0, 0, 0 },
+        /* 22*/ { BARCODE_TELEPEN, UNICODE_MODE, "ZINT BARCODE 0123456789", "", 0, 0, 0 },
+        /* 23*/ { BARCODE_UPCA, UNICODE_MODE, "036000291452", "", 0, 0, 0 },
+        /* 24*/ { BARCODE_UPCA_CHK, UNICODE_MODE, "036000291452", "", 0, 0, 0 },
+        /* 25*/ { BARCODE_UPCE, UNICODE_MODE, "0123456", "", 0, 0, 0 },
+        /* 26*/ { BARCODE_UPCE_CHK, UNICODE_MODE, "01234565", "", 0, 0, 0 },
+        /* 27*/ { BARCODE_POSTNET, UNICODE_MODE, "12345678901", "", 0, 0, 0 },
+        /* 28*/ { BARCODE_MSI_PLESSEY, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 29*/ { BARCODE_FIM, UNICODE_MODE, "A", "", 0, 0, 0 },
+        /* 30*/ { BARCODE_LOGMARS, UNICODE_MODE, "ZINT BARCODE 0123456789", "", 0, 0, 0 },
+        /* 31*/ { BARCODE_PHARMA, UNICODE_MODE, "123456", "", 0, 0, 0 },
+        /* 32*/ { BARCODE_PZN, UNICODE_MODE, "0123456", "", 0, 0, 0 },
+        /* 33*/ { BARCODE_PHARMA_TWO, UNICODE_MODE, "01234565", "", 0, 0, 0 },
+        /* 34*/ { BARCODE_PDF417, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 35*/ { BARCODE_PDF417COMP, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 36*/ { BARCODE_MAXICODE, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 37*/ { BARCODE_QRCODE, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 38*/ { BARCODE_CODE128B, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 39*/ { BARCODE_AUSPOST, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 40*/ { BARCODE_AUSREPLY, UNICODE_MODE, "01234565", "", 0, 0, 0 },
+        /* 41*/ { BARCODE_AUSROUTE, UNICODE_MODE, "01234565", "", 0, 0, 0 },
+        /* 42*/ { BARCODE_AUSREDIRECT, UNICODE_MODE, "01234565", "", 0, 0, 0 },
+        /* 43*/ { BARCODE_ISBNX, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 44*/ { BARCODE_RM4SCC, UNICODE_MODE, "SN34RD1A", "", 0, 0, 0 },
+        /* 45*/ { BARCODE_DATAMATRIX, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 1, 0, 0 },
+        /* 46*/ { BARCODE_EAN14, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 47*/ { BARCODE_VIN, UNICODE_MODE, "1M8GDM9AXKP042788", "", 0, 0, 0 },
+        /* 48*/ { BARCODE_CODABLOCKF, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 49*/ { BARCODE_NVE18, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 50*/ { BARCODE_JAPANPOST, UNICODE_MODE, "SN34RD1A", "", 0, 0, 0 },
+        /* 51*/ { BARCODE_KOREAPOST, UNICODE_MODE, "123456", "", 0, 0, 0 },
+        /* 52*/ { BARCODE_DBAR_STK, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 53*/ { BARCODE_DBAR_OMNSTK, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 54*/ { BARCODE_DBAR_EXPSTK, GS1_MODE, "[01]12345678901231[10]ABC123", "", 0, 0, 0 },
+        /* 55*/ { BARCODE_PLANET, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 56*/ { BARCODE_MICROPDF417, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 57*/ { BARCODE_USPS_IMAIL, UNICODE_MODE, "01234567094987654321", "", 0, 0, 0 },
+        /* 58*/ { BARCODE_PLESSEY, UNICODE_MODE, "A0123456789B", "", 1, 0, 0 },
+        /* 59*/ { BARCODE_TELEPEN_NUM, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 60*/ { BARCODE_ITF14, UNICODE_MODE, "9780306406157", "", 0, 0, 0 },
+        /* 61*/ { BARCODE_KIX, UNICODE_MODE, "SN34RD1A", "", 0, 0, 0 },
+        /* 62*/ { BARCODE_AZTEC, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 63*/ { BARCODE_DAFT, UNICODE_MODE, "FADT", "", 0, 0, 0 },
+        /* 64*/ { BARCODE_DPD, UNICODE_MODE, "%000393206219912345678101040", "", 0, 0, 0 },
+        /* 65*/ { BARCODE_MICROQR, UNICODE_MODE, "ZINT BARCODE 0123456789", "", 0, 0, 0 },
+        /* 66*/ { BARCODE_HIBC_128, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 67*/ { BARCODE_HIBC_39, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 68*/ { BARCODE_HIBC_DM, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 1, 0, 0 },
+        /* 69*/ { BARCODE_HIBC_QR, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 70*/ { BARCODE_HIBC_PDF, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 71*/ { BARCODE_HIBC_MICPDF, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 72*/ { BARCODE_HIBC_BLOCKF, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 73*/ { BARCODE_HIBC_AZTEC, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 74*/ { BARCODE_DOTCODE, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 75*/ { BARCODE_HANXIN, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 76*/ { BARCODE_MAILMARK, UNICODE_MODE, "11210012341234567AB19XY1A", "", 0, 0, 0 },
+        /* 77*/ { BARCODE_AZRUNE, UNICODE_MODE, "123", "", 0, 0, 0 },
+        /* 78*/ { BARCODE_CODE32, UNICODE_MODE, "01234565", "", 0, 0, 0 },
+        /* 79*/ { BARCODE_EANX_CC, GS1_MODE, "[21]A12345678", "331234567890", 1, 0, 0 },
+        /* 80*/ { BARCODE_GS1_128_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231", 1, 0, 0 },
+        /* 81*/ { BARCODE_DBAR_OMN_CC, GS1_MODE, "[21]A12345678", "331234567890", 1, 0, 0 },
+        /* 82*/ { BARCODE_DBAR_LTD_CC, GS1_MODE, "[21]A12345678", "331234567890", 1, 0, 0 },
+        /* 83*/ { BARCODE_DBAR_EXP_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231", 1, 0, 0 },
+        /* 84*/ { BARCODE_UPCA_CC, GS1_MODE, "[21]A12345678", "12345678901", 1, 0, 0 },
+        /* 85*/ { BARCODE_UPCE_CC, GS1_MODE, "[21]A12345678", "0123456", 1, 0, 0 },
+        /* 86*/ { BARCODE_DBAR_STK_CC, GS1_MODE, "[21]A12345678", "331234567890", 1, 0, 0 },
+        /* 87*/ { BARCODE_DBAR_OMNSTK_CC, GS1_MODE, "[21]A12345678", "331234567890", 1, 0, 0 },
+        /* 88*/ { BARCODE_DBAR_EXPSTK_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231", 1, 0, 0 },
+        /* 89*/ { BARCODE_CHANNEL, UNICODE_MODE, "0123456", "", 0, 0, 0 },
+        /* 90*/ { BARCODE_CODEONE, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 91*/ { BARCODE_GRIDMATRIX, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 92*/ { BARCODE_UPNQR, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 93*/ { BARCODE_ULTRA, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+        /* 94*/ { BARCODE_RMQR, UNICODE_MODE, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", 0, 0, 0 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct testAllocStats stats;
+    long encode_allocs, encode_peak, buffer_allocs, buffer_peak, print_allocs, print_peak;
+    long first_encode_peak, first_buffer_peak, first_print_peak;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = testAllocCreate(&stats);
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->symbology = data[i].symbology;
+        symbol->input_mode = data[i].input_mode;
+        strcpy(symbol->primary, data[i].primary);
+        strcpy(symbol->outfile, "mem.gif");
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+        symbol->debug |= debug;
+
+        int length = (int) strlen(data[i].data);
+
+        /* Warm up, allowing the library to set up anything it keeps between calls */
+        testAllocReset(&stats);
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_nonzero(ret < ZINT_ERROR, "i:%d ZBarcode_Encode(%s) ret %d >= ZINT_ERROR (%s)\n",
+                    i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+        first_encode_peak = stats.peak - stats.start;
+
+        testAllocReset(&stats);
+        ret = ZBarcode_Buffer(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer(%s) ret %d != 0 (%s)\n",
+                    i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+        first_buffer_peak = stats.peak - stats.start;
+
+        testAllocReset(&stats);
+        ret = ZBarcode_Print(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Print(%s) ret %d != 0 (%s)\n",
+                    i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+        first_print_peak = stats.peak - stats.start;
+
+        ZBarcode_Clear(symbol);
+        symbol->eci = 0; /* May be set by encoding (UPNQR) */
+
+        testAllocReset(&stats);
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_nonzero(ret < ZINT_ERROR, "i:%d ZBarcode_Encode(%s) ret %d >= ZINT_ERROR (%s)\n",
+                    i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+        encode_allocs = stats.allocs + stats.reallocs;
+        encode_peak = stats.peak - stats.start;
+
+        testAllocReset(&stats);
+        ret = ZBarcode_Buffer(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer(%s) ret %d != 0 (%s)\n",
+                    i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+        buffer_allocs = stats.allocs + stats.reallocs;
+        buffer_peak = stats.peak - stats.start;
+
+        testAllocReset(&stats);
+        ret = ZBarcode_Print(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Print(%s) ret %d != 0 (%s)\n",
+                    i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+        print_allocs = stats.allocs + stats.reallocs;
+        print_peak = stats.peak - stats.start;
+
+        ZBarcode_Delete(symbol);
+
+        assert_zero(stats.outstanding, "i:%d (%s) stats.outstanding %ld != 0\n",
+                    i, testUtilBarcodeName(data[i].symbology), stats.outstanding);
+        assert_zero(stats.current, "i:%d (%s) stats.current %ld != 0\n",
+                    i, testUtilBarcodeName(data[i].symbology), stats.current);
+
+        if (debug & ZINT_DEBUG_TEST_PRINT) {
+            printf("i:%d %s working peaks encode %ld (first %ld), buffer %ld (first %ld), print %ld (first %ld)\n",
+                    i, testUtilBarcodeName(data[i].symbology), encode_peak, first_encode_peak, buffer_peak,
+                    first_buffer_peak, print_peak, first_print_peak);
+        }
+
+        if (generate) {
+            printf("        /*%3d*/ { %s, %s, \"%s\", \"%s\", %ld, %ld, %ld },\n",
+                    i, testUtilBarcodeName(data[i].symbology), testUtilInputModeName(data[i].input_mode),
+                    data[i].data, data[i].primary, encode_allocs, buffer_allocs, print_allocs);
+        } else {
+            assert_equal(encode_allocs, data[i].expected_encode_allocs, "i:%d (%s) encode allocs %ld != %ld\n",
+                    i, testUtilBarcodeName(data[i].symbology), encode_allocs, data[i].expected_encode_allocs);
+            assert_equal(buffer_allocs, data[i].expected_buffer_allocs, "i:%d (%s) buffer allocs %ld != %ld\n",
+                    i, testUtilBarcodeName(data[i].symbology), buffer_allocs, data[i].expected_buffer_allocs);
+            assert_equal(print_allocs, data[i].expected_print_allocs, "i:%d (%s) print allocs %ld != %ld\n",
+                    i, testUtilBarcodeName(data[i].symbology), print_allocs, data[i].expected_print_allocs);
+        }
+        assert_nonzero(encode_peak <= first_encode_peak, "i:%d (%s) encode working peak %ld > first %ld\n",
+                    i, testUtilBarcodeName(data[i].symbology), encode_peak, first_encode_peak);
+        assert_nonzero(buffer_peak <= first_buffer_peak, "i:%d (%s) buffer working peak %ld > first %ld\n",
+                    i, testUtilBarcodeName(data[i].symbology), buffer_peak, first_buffer_peak);
+        assert_nonzero(print_peak <= first_print_peak, "i:%d (%s) print working peak %ld > first %ld\n",
+                    i, testUtilBarcodeName(data[i].symbology), print_peak, first_print_peak);
+    }
+
+    testFinish();
+}
+
+/* Allocations made by the steady-state `ZBarcode_Print()` to a memory file for each output format. GIF, PNG, BMP,
+   PCX and TXT must not allocate, their work buffers and the memory file being kept with the symbol. TIF (its strip
+   buffers and LZW table, per page), EMF (its record buffers) and the vector formats (the vector, rebuilt by each
+   print) have a small fixed bound, counts again having to match exactly. Re-record with `-g` */
+static void test_print_formats(int index, int generate, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        char *outfile;
+        char *data;
+
+        long expected_print_allocs;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, "mem.gif", "Zint Barcode 0123456789", 0 },
+        /*  1*/ { BARCODE_CODE128, "mem.png", "Zint Barcode 0123456789", 0 },
+        /*  2*/ { BARCODE_CODE128, "mem.bmp", "Zint Barcode 0123456789", 0 },
+        /*  3*/ { BARCODE_CODE128, "mem.pcx", "Zint Barcode 0123456789", 0 },
+        /*  4*/ { BARCODE_CODE128, "mem.tif", "Zint Barcode 0123456789", 5 },
+        /*  5*/ { BARCODE_CODE128, "mem.svg", "Zint Barcode 0123456789", 1 },
+        /*  6*/ { BARCODE_CODE128, "mem.eps", "Zint Barcode 0123456789", 1 },
+        /*  7*/ { BARCODE_CODE128, "mem.emf", "Zint Barcode 0123456789", 7 },
+        /*  8*/ { BARCODE_CODE128, "mem.txt", "Zint Barcode 0123456789", 0 },
+        /*  9*/ { BARCODE_QRCODE, "mem.gif", "Zint Barcode 0123456789", 0 },
+        /* 10*/ { BARCODE_QRCODE, "mem.png", "Zint Barcode 0123456789", 0 },
+        /* 11*/ { BARCODE_QRCODE, "mem.bmp", "Zint Barcode 0123456789", 0 },
+        /* 12*/ { BARCODE_QRCODE, "mem.pcx", "Zint Barcode 0123456789", 0 },
+        /* 13*/ { BARCODE_QRCODE, "mem.tif", "Zint Barcode 0123456789", 4 },
+        /* 14*/ { BARCODE_QRCODE, "mem.svg", "Zint Barcode 0123456789", 2 },
+        /* 15*/ { BARCODE_QRCODE, "mem.eps", "Zint Barcode 0123456789", 2 },
+        /* 16*/ { BARCODE_QRCODE, "mem.emf", "Zint Barcode 0123456789", 7 },
+        /* 17*/ { BARCODE_QRCODE, "mem.txt", "Zint Barcode 0123456789", 0 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct testAllocStats stats;
+    long print_allocs;
+
+    (void)debug;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = testAllocCreate(&stats);
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->symbology = data[i].symbology;
+        strcpy(symbol->outfile, data[i].outfile);
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, (int) strlen(data[i].data));
+        assert_zero(ret, "i:%d ZBarcode_Encode(%s) ret %d != 0 (%s)\n",
+                    i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+
+        /* Warm up */
+        ret = ZBarcode_Print(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Print(%s) ret %d != 0 (%s)\n", i, data[i].outfile, ret, symbol->errtxt);
+        assert_nonnull(symbol->memfile, "i:%d (%s) memfile NULL\n", i, data[i].outfile);
+
+        testAllocReset(&stats);
+        ret = ZBarcode_Print(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Print(%s) ret %d != 0 (%s)\n", i, data[i].outfile, ret, symbol->errtxt);
+        print_allocs = stats.allocs + stats.reallocs;
+        assert_nonnull(symbol->memfile, "i:%d (%s) memfile NULL\n", i, data[i].outfile);
+        assert_nonzero(symbol->memfile_size, "i:%d (%s) memfile_size 0\n", i, data[i].outfile);
+
+        ZBarcode_Delete(symbol);
+
+        assert_zero(stats.outstanding, "i:%d (%s) stats.outstanding %ld != 0\n",
+                    i, data[i].outfile, stats.outstanding);
+
+        if (generate) {
+            printf("        /*%3d*/ { %s, \"%s\", \"%s\", %ld },\n",
+                    i, testUtilBarcodeName(data[i].symbology), data[i].outfile, data[i].data, print_allocs);
+        } else {
+            assert_equal(print_allocs, data[i].expected_print_allocs, "i:%d (%s) print allocs %ld != %ld\n",
+                    i, data[i].outfile, print_allocs, data[i].expected_print_allocs);
+        }
+    }
+
+    testFinish();
+}
+
+int main(int argc, char *argv[]) {
+
+    testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
+        { "test_steady_state", test_steady_state, 1, 1, 1 },
+        { "test_print_formats", test_print_formats, 1, 1, 1 },
+    };
+
+    testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
+
+    testReport();
+
+    return 0;
+}
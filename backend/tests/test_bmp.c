@@ -65,7 +65,7 @@ static void test_pixel_plot(int index, int debug) {
     };
     int data_size = ARRAY_SIZE(data);
 
-    char *bmp = "out.bmp";
+    char bmp[256];
 
     char data_buf[8 * 2 + 1];
 
@@ -73,6 +73,8 @@ static void test_pixel_plot(int index, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(bmp, i, "bmp");
+
         struct zint_symbol *symbol = ZBarcode_Create();
         assert_nonnull(symbol, "Symbol not created\n");
 
@@ -123,20 +125,25 @@ static void test_print(int index, int generate, int debug) {
         int whitespace_height;
         int option_1;
         int option_2;
+        int output_options;
         char *fgcolour;
         char *bgcolour;
         char* data;
         char* expected_file;
     };
     struct item data[] = {
-        /*  0*/ { BARCODE_PDF417, 5, -1, -1, -1, "147AD0", "FC9630", "123", "../data/bmp/pdf417_fg_bg.bmp" },
-        /*  1*/ { BARCODE_ULTRA, 5, -1, -1, -1, "147AD0", "FC9630", "123", "../data/bmp/ultracode_fg_bg.bmp" },
-        /*  2*/ { BARCODE_PDF417COMP, 2, 2, -1, -1, "", "", "123", "../data/bmp/pdf417comp_hvwsp2.bmp" },
+        /*  0*/ { BARCODE_PDF417, 5, -1, -1, -1, -1, "147AD0", "FC9630", "123", "../data/bmp/pdf417_fg_bg.bmp" },
+        /*  1*/ { BARCODE_ULTRA, 5, -1, -1, -1, -1, "147AD0", "FC9630", "123", "../data/bmp/ultracode_fg_bg.bmp" },
+        /*  2*/ { BARCODE_PDF417COMP, 2, 2, -1, -1, -1, "", "", "123", "../data/bmp/pdf417comp_hvwsp2.bmp" },
+        /*  3*/ { BARCODE_PDF417, 5, -1, -1, -1, BMP_RLE8, "147AD0", "FC9630", "123", "../data/bmp/pdf417_fg_bg_rle8.bmp" },
+        /*  4*/ { BARCODE_ULTRA, 5, -1, -1, -1, BMP_RLE8, "147AD0", "FC9630", "123", "../data/bmp/ultracode_fg_bg_rle8.bmp" },
+        /*  5*/ { BARCODE_CODE128, -1, -1, -1, -1, BMP_RLE8, "", "", "1234567890", "../data/bmp/code128_rle8.bmp" },
+        /*  6*/ { BARCODE_DAFT, -1, -1, -1, -1, BMP_RLE8, "", "", "FADT", "../data/bmp/daft_rle8.bmp" },
     };
     int data_size = ARRAY_SIZE(data);
 
     char* data_dir = "../data/bmp";
-    char* bmp = "out.bmp";
+    char bmp[256];
     char escaped[1024];
     int escaped_size = 1024;
 
@@ -151,10 +158,12 @@ static void test_print(int index, int generate, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(bmp, i, "bmp");
+
         struct zint_symbol* symbol = ZBarcode_Create();
         assert_nonnull(symbol, "Symbol not created\n");
 
-        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, data[i].option_1, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, data[i].option_1, data[i].option_2, -1, data[i].output_options, data[i].data, -1, debug);
         if (data[i].whitespace_width != -1) {
             symbol->whitespace_width = data[i].whitespace_width;
         }
@@ -176,9 +185,10 @@ static void test_print(int index, int generate, int debug) {
         assert_zero(ret, "i:%d %s ZBarcode_Print %s ret %d != 0\n", i, testUtilBarcodeName(data[i].symbology), symbol->outfile, ret);
 
         if (generate) {
-            printf("        /*%3d*/ { %s, %d, %d, %d, %d, \"%s\", \"%s\", \"%s\", \"%s\"},\n",
+            printf("        /*%3d*/ { %s, %d, %d, %d, %d, %s, \"%s\", \"%s\", \"%s\", \"%s\"},\n",
                     i, testUtilBarcodeName(data[i].symbology), data[i].whitespace_width, data[i].whitespace_height,
-                    data[i].option_1, data[i].option_2, data[i].fgcolour, data[i].bgcolour,
+                    data[i].option_1, data[i].option_2, testUtilOutputOptionsName(data[i].output_options),
+                    data[i].fgcolour, data[i].bgcolour,
                     testUtilEscape(data[i].data, length, escaped, escaped_size), data[i].expected_file);
             ret = rename(symbol->outfile, data[i].expected_file);
             assert_zero(ret, "i:%d rename(%s, %s) ret %d != 0\n", i, symbol->outfile, data[i].expected_file, ret);
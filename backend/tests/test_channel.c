@@ -397,7 +397,7 @@ static void test_encode(int index, int generate, int debug) {
     testFinish();
 }
 
-// Dummy to generate pre-calculated tables for channels 7/8
+// Dummy to generate pre-calculated table of symbol counts
 static void test_generate(int generate) {
 
     if (!generate) {
@@ -408,7 +408,7 @@ static void test_generate(int generate) {
     struct item {
         char *data;
     };
-    struct item data[] = { { "576688" }, { "7742862" } };
+    struct item data[] = { { "0" } };
     int data_size = ARRAY_SIZE(data);
 
     for (int i = 0; i < data_size; i++) {
@@ -2500,6 +2500,108 @@ static void test_encode(int index, int generate, int debug) {
                     "011100010001100101"
                     "101000101000110110"
                 },
+        /* 83*/ { -1, -1, -1, "\101\052\102\076\103\052\104\076\105\052\106\076\242", -1, 0, 22, 22, 0, "EDI with unlatch before last extended ASCII; BWIPP not checked",
+                    "1110110101101100000000"
+                    "1110100111100011110010"
+                    "0110101010000000111111"
+                    "1010100011100110111111"
+                    "1110100010100010001000"
+                    "1011100011000100010001"
+                    "1000101000100010000001"
+                    "0000100000000000100000"
+                    "1111111111111111111111"
+                    "0000000000000000000000"
+                    "0111111111111111111110"
+                    "0100000000000000000010"
+                    "0111111111111111111110"
+                    "0100000000000000000010"
+                    "0111111111111111111110"
+                    "0001000100010001100011"
+                    "0100010110000010101010"
+                    "0010010111001111100110"
+                    "0010101010110111101100"
+                    "1100011101101011101000"
+                    "1010010101101011101110"
+                    "1001100101001011110001"
+                },
+        /* 84*/ { MINIMAL_MODE, -1, -1, "094 ji. l4gh6", -1, 0, 16, 18, 0, "Minimal encodation Version A (default Version B); BWIPP different encodation",
+                    "100011111000111001"
+                    "101110111100100000"
+                    "100010101100011011"
+                    "100110011001100001"
+                    "100010010111110100"
+                    "000010000000100000"
+                    "111111111111111111"
+                    "000000000000000000"
+                    "011111111111111110"
+                    "010000000000000010"
+                    "011111111111111110"
+                    "000000111010101100"
+                    "001000100111101000"
+                    "101010000010101011"
+                    "100010101010100100"
+                    "001000111001111000"
+                },
+        /* 85*/ { MINIMAL_MODE, -1, -1, "7cF6 r/ >4y28VS7OI>U ", -1, 0, 22, 22, 0, "Minimal encodation Version B (default Version C); BWIPP different encodation",
+                    "0011110110010000110010"
+                    "1000100100011101110001"
+                    "0111100011001000110011"
+                    "0011100000000111110101"
+                    "0111101110001010001100"
+                    "1010101110011101001001"
+                    "1101101000111100100101"
+                    "0000100000000000100000"
+                    "1111111111111111111111"
+                    "0000000000000000000000"
+                    "0111111111111111111110"
+                    "0100000000000000000010"
+                    "0111111111111111111110"
+                    "0100000000000000000010"
+                    "0111111111111111111110"
+                    "0101100100110001100001"
+                    "1010101001111010101010"
+                    "0111110001000011101100"
+                    "1000000010110001101100"
+                    "1110001111001101100110"
+                    "0111010001010000101011"
+                    "1100101110010011110011"
+                },
+        /* 86*/ { GS1_MODE | MINIMAL_MODE, -1, -1, "[90]F37113806017360", -1, 0, 16, 18, 0, "Minimal encodation Version A (default Version B); BWIPP different encodation",
+                    "111011110101001010"
+                    "100010110001110111"
+                    "100010101010001000"
+                    "110110100010000011"
+                    "110010101110010000"
+                    "000010000000100000"
+                    "111111111111111111"
+                    "000000000000000000"
+                    "011111111111111110"
+                    "010000000000000010"
+                    "011111111111111110"
+                    "101111101101101001"
+                    "011001111111101111"
+                    "101101111100101001"
+                    "101100111100100100"
+                    "100101101101110000"
+                },
+        /* 87*/ { GS1_MODE | MINIMAL_MODE, -1, -1, "[90]110623748055430435", -1, 0, 16, 18, 0, "Minimal encodation Version A (default Version B); BWIPP different encodation",
+                    "111011110111111011"
+                    "100010110000011110"
+                    "011110101101001000"
+                    "000010101100110110"
+                    "101110101111110001"
+                    "000010000000100000"
+                    "111111111111111111"
+                    "000000000000000000"
+                    "011111111111111110"
+                    "010000000000000010"
+                    "011111111111111110"
+                    "110101000100101000"
+                    "011010100011100111"
+                    "101011011001101010"
+                    "010001110001100011"
+                    "111110010000110010"
+                },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -2603,6 +2705,65 @@ static void test_fuzz(int index, int debug) {
     testFinish();
 }
 
+/* Encoding again with the same symbol re-uses the recognition pattern template kept for the version */
+static void test_template(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int option_2;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { -1, "1234" },
+        /*  1*/ { -1, "5678" }, // Same version
+        /*  2*/ { 8, "1234" }, // Version H
+        /*  3*/ { 8, "Code One" },
+        /*  4*/ { 3, "1234" },
+        /*  5*/ { 9, "1234" }, // Version S-10
+        /*  6*/ { 9, "1234567890" }, // Version S-20
+        /*  7*/ { 9, "12345678901234" }, // Version S-30
+        /*  8*/ { 10, "ABC" }, // Version T-16
+        /*  9*/ { 10, "ABCDEFGHIJKLMNOPQRSTU" }, // Version T-32
+        /* 10*/ { 10, "ABC" },
+        /* 11*/ { -1, "1234" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct zint_symbol *symbol = ZBarcode_Create();
+    assert_nonnull(symbol, "Symbol not created\n");
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *expected = ZBarcode_Create();
+        assert_nonnull(expected, "Symbol expected not created\n");
+
+        int length = testUtilSetSymbol(expected, BARCODE_CODEONE, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        ret = ZBarcode_Encode(expected, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode expected ret %d != 0 (%s)\n", i, ret, expected->errtxt);
+
+        ZBarcode_Clear(symbol);
+        symbol->option_2 = 0; /* Not reset by `ZBarcode_Clear()` */
+        (void) testUtilSetSymbol(symbol, BARCODE_CODEONE, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_nonnull(symbol->internal->grid_template, "i:%d grid_template NULL\n", i);
+
+        ret = testUtilSymbolCmp(symbol, expected);
+        assert_zero(ret, "i:%d testUtilSymbolCmp ret %d != 0\n", i, ret);
+
+        ZBarcode_Delete(expected);
+    }
+
+    ZBarcode_Delete(symbol);
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
@@ -2610,6 +2771,7 @@ int main(int argc, char *argv[]) {
         { "test_input", test_input, 1, 0, 1 },
         { "test_encode", test_encode, 1, 1, 1 },
         { "test_fuzz", test_fuzz, 1, 0, 1 },
+        { "test_template", test_template, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
@@ -326,6 +326,14 @@ static void test_input(int index, int generate, int debug) {
         /* 31*/ { UNICODE_MODE, "aééééébcdeéé", -1, 0, 233, "(21) 104 65 100 100 73 73 73 73 73 100 100 66 67 68 69 100 73 100 73 19 106", "StartB a Latch é (5) Unlatch b c d e FNC4 é (2)" },
         /* 32*/ { UNICODE_MODE, "aééééébcdeééé", -1, 0, 244, "(22) 104 65 100 100 73 73 73 73 73 100 66 100 67 100 68 100 69 73 73 73 83 106", "StartB a Latch é (5) Shift b Shift c Shift d Shift e é (3)" },
         /* 33*/ { UNICODE_MODE, "aééééébcdefééé", -1, 0, 255, "(23) 104 65 100 100 73 73 73 73 73 100 100 66 67 68 69 70 100 100 73 73 73 67 106", "StartB a Latch é (5) Unlatch b c d e f Latch é (3)" },
+        /* 34*/ { UNICODE_MODE | MINIMAL_MODE, "AIM1234", -1, 0, 101, "(9) 104 33 41 45 99 12 34 87 106", "Same as Annex E" },
+        /* 35*/ { UNICODE_MODE, "1A\037", -1, 0, 79, "(7) 104 17 33 98 95 37 106", "StartB 1 A Shift US" },
+        /* 36*/ { UNICODE_MODE | MINIMAL_MODE, "1A\037", -1, 0, 68, "(6) 103 17 33 95 59 106", "StartA 1 A US" },
+        /* 37*/ { UNICODE_MODE, "\037a20615", -1, 0, 123, "(11) 103 95 98 65 98 18 99 6 15 76 106", "StartA US Shift a Shift 2 CodeC 06 15" },
+        /* 38*/ { UNICODE_MODE | MINIMAL_MODE, "\037a20615", -1, 0, 112, "(10) 103 95 100 65 18 99 6 15 65 106", "StartA US CodeB a 2 CodeC 06 15" },
+        /* 39*/ { UNICODE_MODE, "0122B9\037", -1, 0, 112, "(10) 105 1 22 100 34 25 98 95 7 106", "StartC 01 22 CodeB B 9 Shift US" },
+        /* 40*/ { UNICODE_MODE | MINIMAL_MODE, "0122B9\037", -1, 0, 101, "(9) 105 1 22 101 34 25 95 48 106", "StartC 01 22 CodeA B 9 US" },
+        /* 41*/ { UNICODE_MODE | MINIMAL_MODE, "aééééébcdefééé", -1, 0, 255, "(23) 104 65 100 100 73 73 73 73 73 100 100 66 67 68 69 70 100 100 73 73 73 67 106", "Same as Annex E" },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -398,7 +406,12 @@ static void test_ean128_input(int index, int generate, int debug) {
         /* 19*/ { GS1_MODE, "[90]12345[90]1234[90]1", 0, 211, "(19) 105 102 90 12 34 100 21 99 102 90 12 34 102 100 25 99 1 30 106", "StartC FNC1 90 12 34 CodeB 5 CodeC FNC1 90 12 34 FNC1 CodeB 9 CodeC 01" },
         /* 20*/ { GS1_MODE, "[90]1A[90]1", 0, 134, "(12) 104 102 25 16 17 33 102 25 99 1 65 106", "StartB FNC1 9 0 1 A FNC1 9 CodeC 01" },
         /* 21*/ { GS1_MODE, "[90]12A[90]123", 0, 145, "(13) 105 102 90 12 100 33 102 25 99 1 23 25 106", "StartC FNC1 90 12 CodeB A FNC1 9 CodeC 01 23" },
-        /* 22*/ { GS1_MODE, "[90]123[90]A234[90]123", 0, 244, "(22) 105 102 90 12 100 19 99 102 90 100 33 18 99 34 102 100 25 99 1 23 37 106", "StartC FNC1 90 12 CodeB 3 CodeC FNC1 90 CodeB A 2 CodeC 34 FNC1 CodeB 9 CodeC 01 23" }    };
+        /* 22*/ { GS1_MODE, "[90]123[90]A234[90]123", 0, 244, "(22) 105 102 90 12 100 19 99 102 90 100 33 18 99 34 102 100 25 99 1 23 37 106", "StartC FNC1 90 12 CodeB 3 CodeC FNC1 90 CodeB A 2 CodeC 34 FNC1 CodeB 9 CodeC 01 23" },
+        /* 23*/ { GS1_MODE | MINIMAL_MODE, "[90]1[90]1[90]1", 0, 167, "(15) 104 102 25 16 17 102 25 16 17 102 25 16 17 47 106", "StartB FNC1 9 0 1 FNC1 9 0 1 FNC1 9 0 1" },
+        /* 24*/ { GS1_MODE | MINIMAL_MODE, "[90]12345[90]1234[90]1", 0, 189, "(17) 104 102 25 99 1 23 45 102 90 12 34 102 90 100 17 75 106", "StartB FNC1 9 CodeC 01 23 45 FNC1 90 12 34 FNC1 90 CodeB 1" },
+        /* 25*/ { GS1_MODE | MINIMAL_MODE, "[90]123[90]A234[90]123", 0, 222, "(20) 105 102 90 12 100 19 102 25 16 33 18 99 34 102 90 12 100 19 50 106", "StartC FNC1 90 12 CodeB 3 FNC1 9 0 A 2 CodeC 34 FNC1 90 12 CodeB 3" },
+        /* 26*/ { GS1_MODE | MINIMAL_MODE, "[90]12[90]12", 0, 101, "(9) 105 102 90 12 102 90 12 14 106", "Same as Annex E" },
+    };
     int data_size = ARRAY_SIZE(data);
 
     char escaped[1024];
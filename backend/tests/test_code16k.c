@@ -180,6 +180,13 @@ static void test_input(int index, int generate, int debug) {
         /* 16*/ { UNICODE_MODE, "aééééb", -1, 0, 3, 70, "(15) 8 65 100 73 100 73 100 73 100 73 66 103 103 39 83", "ModeB a FNC4 é (4) b Pad (2)" },
         /* 17*/ { UNICODE_MODE, "aéééééb", -1, 0, 3, 70, "(15) 8 65 100 73 100 73 100 73 100 73 100 73 66 74 106", "ModeB a FNC4 é (5) b" },
         /* 18*/ { UNICODE_MODE, "aééééébcdeé", -1, 0, 4, 70, "(20) 15 65 100 73 100 73 100 73 100 73 100 73 66 67 68 69 100 73 14 69", "ModeB a FNC4 é (5) b c d e FNC4 é" },
+        /* 19*/ { DATA_MODE, "\001\001" "7a4a4", -1, 0, 3, 70, "(15) 7 65 65 23 98 65 20 98 65 20 103 103 103 66 48", "ModeA SOH SOH 7 1SB a 4 1SB a 4 Pad (3)" },
+        /* 20*/ { DATA_MODE | MINIMAL_MODE, "\001\001" "7a4a4", -1, 0, 2, 70, "(15) 0 65 65 100 23 65 20 65 20 103 103 103 103 46 69", "ModeA SOH SOH CodeB 7 a 4 a 4 Pad (4)" },
+        /* 21*/ { UNICODE_MODE | MINIMAL_MODE, "a0123456789", -1, 0, 2, 70, "(10) 5 65 1 23 45 67 89 103 27 86", "ModeC1SB a 01 23 45 67 89 Pad" },
+        /* 22*/ { UNICODE_MODE | MINIMAL_MODE, "ab0123456789", -1, 0, 2, 70, "(10) 6 65 66 1 23 45 67 89 19 42", "ModeC2SB a b 01 23 45 67 89" },
+        /* 23*/ { UNICODE_MODE | MINIMAL_MODE, "\000\037éa", 5, 0, 2, 70, "(10) 0 64 95 100 100 73 65 103 99 69", "ModeA NUL US CodeB FNC4 é a Pad" },
+        /* 24*/ { GS1_MODE | MINIMAL_MODE, "[90]A", -1, 0, 2, 70, "(10) 3 25 16 33 103 103 103 103 83 20", "ModeBFNC1 9 0 A Pad (4)" },
+        /* 25*/ { GS1_MODE | MINIMAL_MODE, "[90]1[91]12", -1, 0, 2, 70, "(10) 3 25 99 1 102 91 12 103 79 33", "ModeBFNC1 9 CodeC 01 FNC1 91 12 Pad" },
     };
     int data_size = ARRAY_SIZE(data);
 
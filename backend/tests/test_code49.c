@@ -113,6 +113,11 @@ static void test_input(int index, int generate, int debug) {
         /* 12*/ { UNICODE_MODE, "1234\037aA12345A", -1, 0, 3, 70, "(24) 1 2 3 4 43 5 44 4 10 10 48 5 17 9 48 0 10 48 19 2 13 32 7 33", "1 2 3 4 S1 US S2 (C18 4) a A NS 12345 NS (C28 0) A (Start 0, Alpha)" },
         /* 13*/ { GS1_MODE, "[90]12345[91]AB12345", -1, 0, 4, 70, "(32) 45 48 47 15 4 7 9 28 48 45 9 1 10 11 48 25 5 17 9 48 48 48 48 27 48 48 37 39 26 8 14", "FNC1 NS 9012345 (C18 28) NS FNC1 9 1 A B NS (C28 25) 12345 Pad (4) (C38 27) (Start 0, Alpha)" },
         /* 14*/ { GS1_MODE | GS1PARENS_MODE, "(90)12345(91)AB12345", -1, 0, 4, 70, "(32) 45 48 47 15 4 7 9 28 48 45 9 1 10 11 48 25 5 17 9 48 48 48 48 27 48 48 37 39 26 8 14", "FNC1 NS 9012345 (C18 28) NS FNC1 9 1 A B NS (C28 25) 12345 Pad (4) (C38 27) (Start 0, Alpha)" },
+        /* 15*/ { UNICODE_MODE, "\0332345", -1, 0, 2, 70, "(16) 1 2 3 4 5 48 48 13 48 48 14 47 33 7 4 5", "ESC 2 3 4 5 (Start 4, Alphanumeric S1, not Numeric after S1)" },
+        /* 16*/ { UNICODE_MODE, "123", -1, 0, 2, 70, "(16) 1 2 3 48 48 48 48 2 48 48 32 2 3 36 0 22", "1 2 3 (Start 0, Alpha)" },
+        /* 17*/ { UNICODE_MODE | MINIMAL_MODE, "123", -1, 0, 2, 70, "(16) 2 27 48 48 48 48 48 24 48 48 21 9 47 22 2 1", "123 (Start 2, Numeric)" },
+        /* 18*/ { UNICODE_MODE | MINIMAL_MODE, "1234", -1, 0, 2, 70, "(16) 43 45 2 48 48 48 48 37 48 48 46 1 28 37 2 14", "1234 (Start 2, Numeric)" },
+        /* 19*/ { UNICODE_MODE | MINIMAL_MODE, "1234A", -1, 0, 2, 70, "(16) 1 2 3 4 10 48 48 18 48 48 45 42 20 46 0 4", "1 2 3 4 A (Start 0, Alpha)" },
     };
     int data_size = ARRAY_SIZE(data);
 
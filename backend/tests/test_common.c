@@ -52,6 +52,7 @@ static void test_utf8_to_unicode(int index, int debug) {
         /*  2*/ { "\357\277\277", -1, 1, 0, 1, { 0xFFFF }, "EFBFBF" },
         /*  3*/ { "\360\220\200\200", -1, 1, ZINT_ERROR_INVALID_DATA, -1, {}, "Four-byte F0908080" },
         /*  4*/ { "a\200b", -1, 1, ZINT_ERROR_INVALID_DATA, -1, {}, "Orphan continuation 0x80" },
+        /*  5*/ { "ab\303\251c\303", -1, 1, ZINT_ERROR_INVALID_DATA, -1, {}, "Missing 2nd byte at end" },
     };
     int data_size = sizeof(data) / sizeof(struct item);
 
@@ -102,6 +103,9 @@ static void test_is_valid_utf8(int index) {
         /*  6*/ { "a\200b", -1, 0, "Orphan continuation 0x80" },
         /*  7*/ { "\300\201", -1, 0, "Overlong 0xC081" },
         /*  8*/ { "\355\240\200", -1, 0, "Surrogate 0xEDA080" },
+        /*  9*/ { "abcdefghijklmnop\200", -1, 0, "Orphan continuation after 16 ASCII" },
+        /* 10*/ { "abcdefgh\xC2", -1, 0, "Missing 2nd byte after 8 ASCII" },
+        /* 11*/ { "abcdefg\303\251abcdefgh", -1, 1, "2-byte sequence straddling 8 ASCII" },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -118,6 +122,167 @@ static void test_is_valid_utf8(int index) {
     testFinish();
 }
 
+static void test_is_sane_lookup(int index) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        char* test_string;
+        char* data;
+        int ret;
+        int posns[10];
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { "0123456789", "", 0, {0} },
+        /*  1*/ { "0123456789", "1029", 0, { 1, 0, 2, 9 } },
+        /*  2*/ { "0123456789-$:/.+", "$+-", 0, { 11, 15, 10 } },
+        /*  3*/ { "ABCD", "DCBAABCD", 0, { 3, 2, 1, 0, 0, 1, 2, 3 } },
+        /*  4*/ { "0123456789", "12A", ZINT_ERROR_INVALID_DATA, {0} },
+        /*  5*/ { "0123456789", "A", ZINT_ERROR_INVALID_DATA, {0} },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        int length = (int) strlen(data[i].data);
+        int posns[10];
+
+        ret = is_sane_lookup(data[i].test_string, (int) strlen(data[i].test_string),
+                    (const unsigned char *) data[i].data, length, posns);
+        assert_equal(ret, data[i].ret, "i:%d ret %d != %d\n", i, ret, data[i].ret);
+        if (ret == 0) {
+            for (int j = 0; j < length; j++) {
+                assert_equal(posns[j], data[i].posns[j], "i:%d posns[%d] %d != %d\n", i, j, posns[j], data[i].posns[j]);
+            }
+        }
+    }
+
+    testFinish();
+}
+
+static void test_chr_class(int index) {
+
+    testStart("");
+
+    struct item {
+        int flags;
+        char *chars;
+        int chars_len;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { CHR_DIGIT, "0123456789", -1 },
+        /*  1*/ { CHR_UPPER, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", -1 },
+        /*  2*/ { CHR_LOWER, "abcdefghijklmnopqrstuvwxyz", -1 },
+        /*  3*/ { CHR_SPACE, " ", -1 },
+        /*  4*/ { CHR_X12_TERM, "\r*>", -1 },
+        /*  5*/ { CHR_EDIFACT, " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^", -1 },
+        /*  6*/ { CHR_QR_PUNCT, " $%*+-./:", -1 },
+        /*  7*/ { CHR_C40, "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ ", -1 },
+        /*  8*/ { CHR_TEXT, "0123456789abcdefghijklmnopqrstuvwxyz ", -1 },
+        /*  9*/ { CHR_X12, "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ \r*>", -1 },
+        /* 10*/ { CHR_QR_ALNUM, "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:", -1 },
+        /* 11*/ { CHR_AZ_U, "ABCDEFGHIJKLMNOPQRSTUVWXYZ ", -1 },
+        /* 12*/ { CHR_AZ_L, "abcdefghijklmnopqrstuvwxyz ", -1 },
+        /* 13*/ { CHR_AZ_M, "\001\002\003\004\005\006\007\010\011\012\013\014\r\033\034\035\036\037 @\\^_`|~\177", 28 },
+        /* 14*/ { CHR_AZ_P, "\r!\"#$%&'()*+,-./:;<=>?[]{}", -1 },
+        /* 15*/ { CHR_AZ_D, "0123456789 ,.", -1 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        int chars_len = data[i].chars_len == -1 ? (int) strlen(data[i].chars) : data[i].chars_len;
+
+        for (int c = 0; c < 256; c++) {
+            int in_chars = c != 0 && memchr(data[i].chars, c, chars_len) != NULL;
+            assert_equal(!!is_chr(data[i].flags, c), in_chars, "i:%d c 0x%02X is_chr %d != %d\n", i, c, !!is_chr(data[i].flags, c), in_chars);
+        }
+    }
+
+    /* Aztec mode flags shifted down are the mode bit flags */
+    assert_equal(CHR_AZ_U >> CHR_AZ_SHIFT, 0x01, "CHR_AZ_U >> CHR_AZ_SHIFT 0x%X != 0x01\n", CHR_AZ_U >> CHR_AZ_SHIFT);
+    assert_equal(CHR_AZ_D >> CHR_AZ_SHIFT, 0x10, "CHR_AZ_D >> CHR_AZ_SHIFT 0x%X != 0x10\n", CHR_AZ_D >> CHR_AZ_SHIFT);
+
+    testFinish();
+}
+
+static void test_is_sane_chr(int index) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int flags;
+        char *data;
+        int ret;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { CHR_DIGIT, "", 0 },
+        /*  1*/ { CHR_DIGIT, "0123456789", 0 },
+        /*  2*/ { CHR_DIGIT, "12A", ZINT_ERROR_INVALID_DATA },
+        /*  3*/ { CHR_DIGIT, "1\3002", ZINT_ERROR_INVALID_DATA },
+        /*  4*/ { CHR_DIGIT | CHR_UPPER, "A1B2", 0 },
+        /*  5*/ { CHR_C40, "A1 B2", 0 },
+        /*  6*/ { CHR_C40, "A1 b2", ZINT_ERROR_INVALID_DATA },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        ret = is_sane_chr(data[i].flags, (const unsigned char *) data[i].data, (int) strlen(data[i].data));
+        assert_equal(ret, data[i].ret, "i:%d ret %d != %d\n", i, ret, data[i].ret);
+    }
+
+    testFinish();
+}
+
+static void test_chr_runs(int index) {
+
+    testStart("");
+
+    struct item {
+        int flags;
+        char *data;
+        int runs[12];
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { CHR_DIGIT, "", { 0 } },
+        /*  1*/ { CHR_DIGIT, "1", { 1, 0 } },
+        /*  2*/ { CHR_DIGIT, "A", { 0, 0 } },
+        /*  3*/ { CHR_DIGIT, "12A345", { 2, 1, 0, 3, 2, 1, 0 } },
+        /*  4*/ { CHR_DIGIT, "A12\3003", { 0, 2, 1, 0, 1, 0 } },
+        /*  5*/ { CHR_C40, "AB c12", { 3, 2, 1, 0, 2, 1, 0 } },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        int length = (int) strlen(data[i].data);
+        int runs[12];
+
+        memset(runs, 0xFF, sizeof(runs));
+        chr_runs(data[i].flags, (const unsigned char *) data[i].data, length, runs);
+        for (int j = 0; j <= length; j++) {
+            assert_equal(runs[j], data[i].runs[j], "i:%d runs[%d] %d != %d\n", i, j, runs[j], data[i].runs[j]);
+        }
+    }
+
+    testFinish();
+}
+
 static void test_debug_test_codeword_dump_int(int index, int debug) {
 
     testStart("");
@@ -149,12 +314,172 @@ static void test_debug_test_codeword_dump_int(int index, int debug) {
     testFinish();
 }
 
+static void test_module_runs(int index) {
+
+    testStart("");
+
+    struct item {
+        int width;
+        int x;
+        int length;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { 10, 0, 1 },
+        /*  1*/ { 10, 3, 4 },
+        /*  2*/ { 16, 0, 16 },
+        /*  3*/ { 20, 5, 11 },
+        /*  4*/ { 143 * 8, 0, 143 * 8 },
+        /*  5*/ { 143 * 8, 1, 143 * 8 - 1 },
+        /*  6*/ { 143 * 8, 7, 130 },
+        /*  7*/ { 143 * 8, 64, 64 },
+        /*  8*/ { 143 * 8, 63, 66 },
+        /*  9*/ { 143 * 8, 1000, 143 * 8 - 1000 },
+        /* 10*/ { 300, 8, 200 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct zint_symbol *symbol = ZBarcode_Create();
+    assert_nonnull(symbol, "Symbol not created\n");
+
+    for (int i = 0; i < data_size; i++) {
+        int j, x, expected;
+
+        if (index != -1 && i != index) continue;
+
+        memset(symbol->internal->encoded_data, 0, sizeof(symbol->internal->encoded_data));
+        symbol->width = data[i].width;
+
+        set_module_run(symbol, 1, data[i].x, data[i].length);
+        for (j = 0; j < data[i].width; j++) {
+            expected = j >= data[i].x && j < data[i].x + data[i].length;
+            assert_equal(module_is_set(symbol, 1, j), expected, "i:%d module_is_set(%d) %d != %d\n", i, j, module_is_set(symbol, 1, j), expected);
+            assert_zero(module_is_set(symbol, 0, j), "i:%d row 0 module_is_set(%d) non-zero\n", i, j);
+            assert_zero(module_is_set(symbol, 2, j), "i:%d row 2 module_is_set(%d) non-zero\n", i, j);
+        }
+
+        /* Run lengths from every position compared to bit-by-bit count */
+        for (x = 0; x < data[i].width; x++) {
+            const int fill = module_is_set(symbol, 1, x);
+            for (expected = 1; x + expected < data[i].width && module_is_set(symbol, 1, x + expected) == fill; expected++) {
+                ; /* Count */
+            }
+            assert_equal(module_run_length(symbol, 1, x), expected, "i:%d x:%d module_run_length %d != %d\n", i, x, module_run_length(symbol, 1, x), expected);
+        }
+    }
+
+    /* Pseudo-random pattern */
+    if (index == -1) {
+        unsigned int seed = 12345;
+        int x, expected;
+
+        memset(symbol->internal->encoded_data, 0, sizeof(symbol->internal->encoded_data));
+        symbol->width = 143 * 8;
+        for (x = 0; x < symbol->width; ) {
+            int length;
+            seed = seed * 1103515245 + 12345;
+            length = (seed >> 16) % 150 + 1;
+            if ((seed >> 8) & 1) {
+                set_module_run(symbol, 0, x, x + length > symbol->width ? symbol->width - x : length);
+            }
+            x += length;
+        }
+        for (x = 0; x < symbol->width; x++) {
+            const int fill = module_is_set(symbol, 0, x);
+            for (expected = 1; x + expected < symbol->width && module_is_set(symbol, 0, x + expected) == fill; expected++) {
+                ; /* Count */
+            }
+            assert_equal(module_run_length(symbol, 0, x), expected, "random x:%d module_run_length %d != %d\n", x, module_run_length(symbol, 0, x), expected);
+        }
+    }
+
+    ZBarcode_Delete(symbol);
+
+    testFinish();
+}
+
+static void test_bits(int index) {
+
+    testStart("");
+
+    struct item {
+        int start; /* Bits already in stream */
+        int lengths[8];
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { 0, { 8 } },
+        /*  1*/ { 0, { 1, 2, 3, 4, 5, 6, 7 } },
+        /*  2*/ { 0, { 24, 24, 24 } },
+        /*  3*/ { 3, { 13, 13, 13, 9 } },
+        /*  4*/ { 7, { 0, 1, 23, 4 } },
+        /*  5*/ { 12, { 16, 11, 8, 8 } },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+        unsigned char packed[32];
+        char binary[256];
+        struct zint_bits bits;
+        unsigned int seed = 12345 + i;
+        int bp = 0, j, ret;
+
+        if (index != -1 && i != index) continue;
+
+        memset(packed, 0, sizeof(packed));
+        if (data[i].start) {
+            bits_init(&bits, packed, 0);
+            bits_append(&bits, 0x5A5A5A >> (24 - data[i].start), data[i].start);
+            (void) bits_flush(&bits);
+            bp = bin_append_posn(0x5A5A5A >> (24 - data[i].start), data[i].start, binary, bp);
+        }
+        bits_init(&bits, packed, data[i].start);
+        for (j = 0; j < 8 && (j == 0 || data[i].lengths[j]); j++) {
+            seed = seed * 1103515245 + 12345;
+            bits_append(&bits, seed >> 4, data[i].lengths[j]); /* Excess high bits ignored */
+            bp = bin_append_posn((int) ((seed >> 4) & ((1U << data[i].lengths[j]) - 1)), data[i].lengths[j], binary,
+                    bp);
+        }
+        if (bp >= 10) { /* Overwrite fields spanning written bytes and the pending accumulator */
+            bits_put(&bits, bp - 10, 0x155, 9);
+            (void) bin_append_posn(0x155, 9, binary, bp - 10);
+            bits_put(&bits, 1, 0x0A, 4);
+            (void) bin_append_posn(0x0A, 4, binary, 1);
+        }
+        ret = bits_flush(&bits);
+        assert_equal(ret, bp, "i:%d bits_flush %d != %d\n", i, ret, bp);
+
+        for (j = 0; j < bp; j++) {
+            assert_equal(bits_is_set(packed, j), binary[j] == '1', "i:%d bits_is_set(%d) %d != %d\n", i, j, bits_is_set(packed, j), binary[j] == '1');
+        }
+        for (j = bp; j < ((bp + 7) & ~7); j++) {
+            assert_zero(bits_is_set(packed, j), "i:%d padding bits_is_set(%d) non-zero\n", i, j);
+        }
+        for (j = 0; j + 11 <= bp; j += 5) {
+            int expected = 0, k;
+            for (k = 0; k < 11; k++) {
+                expected = (expected << 1) | (binary[j + k] == '1');
+            }
+            ret = bits_get(packed, j, 11);
+            assert_equal(ret, expected, "i:%d bits_get(%d, 11) 0x%X != 0x%X\n", i, j, ret, expected);
+        }
+    }
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
         { "test_utf8_to_unicode", test_utf8_to_unicode, 1, 0, 1 },
         { "test_debug_test_codeword_dump_int", test_debug_test_codeword_dump_int, 1, 0, 1 },
         { "test_is_valid_utf8", test_is_valid_utf8, 1, 0, 0 },
+        { "test_is_sane_lookup", test_is_sane_lookup, 1, 0, 0 },
+        { "test_chr_class", test_chr_class, 1, 0, 0 },
+        { "test_is_sane_chr", test_is_sane_chr, 1, 0, 0 },
+        { "test_chr_runs", test_chr_runs, 1, 0, 0 },
+        { "test_module_runs", test_module_runs, 1, 0, 0 },
+        { "test_bits", test_bits, 1, 0, 0 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
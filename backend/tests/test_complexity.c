@@ -0,0 +1,138 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+/* Worst-case (max length, maximal mode switching) inputs with generous encoding time budgets, so that quadratic or
+ * worse behaviour in the mode selection and look-ahead code paths gets caught. Inputs found by `fuzz_encode` that
+ * took too long (or crashed) go here too (see README) */
+
+#include "testcommon.h"
+#include <time.h>
+
+/* Budgets are in CPU milliseconds, scaled by env ZINT_TEST_BUDGET_SCALE if set, e.g. for sanitizer or valgrind
+ * runs */
+static long budget_scale(void) {
+    const char *env = getenv("ZINT_TEST_BUDGET_SCALE");
+
+    return env && atol(env) > 0 ? atol(env) : 1;
+}
+
+static void test_budget(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int option_1;
+        int option_2;
+        int option_3;
+        char *pattern;
+        int length;
+        int ret;
+        long budget_ms;
+        char *comment;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_PDF417, DATA_MODE, -1, -1, -1, "a;;", 2709, ZINT_ERROR_TOO_LONG, 100, "fuzz_encode: 3 text values per char overflowed compacted stream" },
+        /*  1*/ { BARCODE_PDF417, DATA_MODE | MINIMAL_MODE, -1, -1, -1, "a;;", 2709, ZINT_ERROR_TOO_LONG, 100, "" },
+        /*  2*/ { BARCODE_PDF417COMP, DATA_MODE, -1, -1, -1, "a;;", 2709, ZINT_ERROR_TOO_LONG, 100, "" },
+        /*  3*/ { BARCODE_PDF417, DATA_MODE, 0, -1, -1, "1A\2001a", 800, 0, 100, "Alternating numeric/text/byte, regroupe() & pdfsmooth()" },
+        /*  4*/ { BARCODE_PDF417, DATA_MODE | MINIMAL_MODE, 0, -1, -1, "1A\2001a", 800, 0, 100, "" },
+        /*  5*/ { BARCODE_MICROPDF417, DATA_MODE, -1, -1, -1, "a;;", 366, ZINT_ERROR_TOO_LONG, 100, "" },
+        /*  6*/ { BARCODE_DATAMATRIX, DATA_MODE, -1, -1, -1, "aB1;\200", 1555, 0, 100, "Max mixed, look_ahead_test() at each position" },
+        /*  7*/ { BARCODE_DATAMATRIX, DATA_MODE, -1, -1, -1, "A1B2*>", 2334, 0, 100, "C40/X12" },
+        /*  8*/ { BARCODE_DATAMATRIX, DATA_MODE | MINIMAL_MODE, -1, -1, -1, "aB1;\200", 1555, 0, 200, "" },
+        /*  9*/ { BARCODE_DATAMATRIX, DATA_MODE, -1, -1, -1, "0", 3117, ZINT_ERROR_TOO_LONG, 100, "" },
+        /* 10*/ { BARCODE_CODEONE, DATA_MODE, -1, -1, -1, "aB1;\200", 1000, 0, 100, "c1_look_ahead_test() at each position" },
+        /* 11*/ { BARCODE_CODEONE, DATA_MODE, -1, -1, -1, "A1B2*>", 2200, 0, 100, "" },
+        /* 12*/ { BARCODE_CODEONE, DATA_MODE, -1, -1, -1, "0", 3551, ZINT_ERROR_TOO_LONG, 100, "" },
+        /* 13*/ { BARCODE_DOTCODE, DATA_MODE, -1, 200, -1, "0", 2940, 0, 200, "Max Code Set C, dotcode padding" },
+        /* 14*/ { BARCODE_DOTCODE, DATA_MODE, -1, 200, -1, "aB1;\200", 1000, 0, 200, "" },
+        /* 15*/ { BARCODE_QRCODE, DATA_MODE, -1, -1, -1, "1A\200a", 2000, 0, 200, "" },
+        /* 16*/ { BARCODE_QRCODE, DATA_MODE | MINIMAL_MODE, -1, -1, -1, "1A\200a", 2000, 0, 200, "" },
+        /* 17*/ { BARCODE_QRCODE, DATA_MODE | FAST_MODE, -1, -1, -1, "1A\200a", 2000, 0, 200, "" },
+        /* 18*/ { BARCODE_HANXIN, DATA_MODE, -1, -1, -1, "1A\200a", 2000, 0, 200, "" },
+        /* 19*/ { BARCODE_GRIDMATRIX, DATA_MODE, -1, -1, -1, "1A\200a", 1000, 0, 200, "" },
+        /* 20*/ { BARCODE_AZTEC, DATA_MODE, -1, -1, -1, "1A;a\200", 1000, 0, 200, "" },
+        /* 21*/ { BARCODE_RMQR, DATA_MODE, -1, -1, -1, "1A\200a", 150, 0, 100, "" },
+        /* 22*/ { BARCODE_ULTRA, DATA_MODE, -1, -1, -1, "1Aa\200", 150, 0, 100, "" },
+        /* 23*/ { BARCODE_MAXICODE, DATA_MODE, -1, -1, -1, "1Aa\200", 90, ZINT_ERROR_TOO_LONG, 100, "" },
+        /* 24*/ { BARCODE_CODABLOCKF, DATA_MODE, -1, -1, -1, "1Aa\200\001", 1000, 0, 200, "" },
+        /* 25*/ { BARCODE_CODE16K, DATA_MODE, -1, -1, -1, "1Aa\001", 40, 0, 100, "" },
+        /* 26*/ { BARCODE_CODE128, DATA_MODE, -1, -1, -1, "1Aa\001", 40, 0, 100, "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char data_buf[ZINT_MAX_DATA_LEN + 1];
+    long scale = budget_scale();
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        testUtilStrCpyRepeat(data_buf, data[i].pattern, data[i].length);
+        assert_equal(data[i].length, (int) strlen(data_buf), "i:%d length %d != strlen(data_buf) %d\n", i, data[i].length, (int) strlen(data_buf));
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, data[i].option_1, data[i].option_2, data[i].option_3, -1 /*output_options*/, data_buf, data[i].length, debug);
+
+        clock_t start = clock();
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data_buf, length);
+        long elapsed_ms = (long) ((clock() - start) * 1000 / CLOCKS_PER_SEC);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        if (debug & ZINT_DEBUG_TEST_PRINT) {
+            printf("i:%d %s length %d: %ld ms (budget %ld ms)\n", i, testUtilBarcodeName(data[i].symbology), length, elapsed_ms, data[i].budget_ms * scale);
+        }
+        assert_nonzero(elapsed_ms <= data[i].budget_ms * scale, "i:%d %s elapsed %ld ms > budget %ld ms (%s)\n", i, testUtilBarcodeName(data[i].symbology), elapsed_ms, data[i].budget_ms * scale, data[i].comment);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+int main(int argc, char *argv[]) {
+
+    testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
+        { "test_budget", test_budget, 1, 0, 1 },
+    };
+
+    testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
+
+    testReport();
+
+    return 0;
+}
@@ -529,6 +529,68 @@ static void test_reader_init(int index, int generate, int debug) {
     testFinish();
 }
 
+static void test_structapp(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int input_mode;
+        int output_options;
+        struct zint_structapp structapp;
+        char *data;
+        int ret;
+        int expected_rows;
+        int expected_width;
+        char *expected;
+        char *comment;
+    };
+    struct item data[] = {
+        /*  0*/ { UNICODE_MODE, -1, { 1, 2, "" }, "A", 0, 12, 12, "E9 0F 01 01 42 CB AA 3F C3 74 E6 E0", "ID1 ID2 default 1 1" },
+        /*  1*/ { UNICODE_MODE, -1, { 2, 2, "" }, "A", 0, 12, 12, "E9 1F 01 01 42 D6 C8 F4 21 EF 61 27", "" },
+        /*  2*/ { UNICODE_MODE, -1, { 16, 16, "254254" }, "A", 0, 12, 12, "E9 F1 FE FE 42 A4 05 3F F6 C7 25 79", "" },
+        /*  3*/ { UNICODE_MODE, -1, { 1, 3, "1002" }, "A", 0, 12, 12, "E9 0E 01 02 42 63 93 96 C8 38 AE BC", "" },
+        /*  4*/ { GS1_MODE, -1, { 1, 2, "" }, "[91]A", 0, 14, 14, "E9 0F 01 01 E8 DD 42 81 7A 07 59 8C 8F 4A 55 75 74 0B", "SA before FNC1" },
+        /*  5*/ { UNICODE_MODE, -1, { 1, 2, "" }, "[)>\03605\035A\036\004", 0, 12, 26, "E9 0F 01 01 5C 2A 3F 1F 87 1E 42 1F 05 81 57 ED 2A B6 4E 8B F8 D5 6E 60 CC 45 75 EE 10 92", "Macro05 not used" },
+        /*  6*/ { UNICODE_MODE, READER_INIT, { 1, 2, "" }, "A", ZINT_ERROR_INVALID_OPTION, -1, -1, "Error 722: Cannot have Structured Append and Reader Initialisation at the same time", "" },
+        /*  7*/ { UNICODE_MODE, -1, { 1, 1, "" }, "A", ZINT_ERROR_INVALID_OPTION, -1, -1, "Error 720: Structured Append count out of range (2-16)", "" },
+        /*  8*/ { UNICODE_MODE, -1, { 1, 17, "" }, "A", ZINT_ERROR_INVALID_OPTION, -1, -1, "Error 720: Structured Append count out of range (2-16)", "" },
+        /*  9*/ { UNICODE_MODE, -1, { 3, 2, "" }, "A", ZINT_ERROR_INVALID_OPTION, -1, -1, "Error 721: Structured Append index out of range (1-2)", "" },
+        /* 10*/ { UNICODE_MODE, -1, { 1, 2, "1234567" }, "A", ZINT_ERROR_INVALID_OPTION, -1, -1, "Error 723: Invalid Structured Append ID (6 digits maximum)", "" },
+        /* 11*/ { UNICODE_MODE, -1, { 1, 2, "A" }, "A", ZINT_ERROR_INVALID_OPTION, -1, -1, "Error 723: Invalid Structured Append ID (6 digits maximum)", "" },
+        /* 12*/ { UNICODE_MODE, -1, { 1, 2, "1" }, "A", ZINT_ERROR_INVALID_OPTION, -1, -1, "Error 724: Structured Append ID1 or ID2 out of range (001-254)", "ID1 0" },
+        /* 13*/ { UNICODE_MODE, -1, { 1, 2, "1000" }, "A", ZINT_ERROR_INVALID_OPTION, -1, -1, "Error 724: Structured Append ID1 or ID2 out of range (001-254)", "ID2 0" },
+        /* 14*/ { UNICODE_MODE, -1, { 1, 2, "255001" }, "A", ZINT_ERROR_INVALID_OPTION, -1, -1, "Error 724: Structured Append ID1 or ID2 out of range (001-254)", "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->debug = ZINT_DEBUG_TEST; // Needed to get codeword dump in errtxt
+
+        int length = testUtilSetSymbol(symbol, BARCODE_DATAMATRIX, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1 /*option_2*/, -1, data[i].output_options, data[i].data, -1, debug);
+        symbol->structapp = data[i].structapp;
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        if (ret < ZINT_ERROR) {
+            assert_equal(symbol->rows, data[i].expected_rows, "i:%d symbol->rows %d != %d\n", i, symbol->rows, data[i].expected_rows);
+            assert_equal(symbol->width, data[i].expected_width, "i:%d symbol->width %d != %d\n", i, symbol->width, data[i].expected_width);
+        }
+        assert_zero(strcmp(symbol->errtxt, data[i].expected), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 static void test_input(int index, int generate, int debug) {
 
     testStart("");
@@ -643,6 +705,16 @@ static void test_input(int index, int generate, int debug) {
         /* 89*/ { UNICODE_MODE, 16382, -1, -1, "A", 0, 16382, 12, 12, "F1 BF FE 42 81 29 57 AA A0 92 B2 45", "ECI 16383 A41" },
         /* 90*/ { UNICODE_MODE, 810899, -1, -1, "A", 0, 810899, 12, 12, "F1 CC 51 05 42 BB A5 A7 8A C6 6E 0F", "ECI 810900 A41" },
         /* 91*/ { UNICODE_MODE | ESCAPE_MODE, -1, -1, -1, "[)>\\R05\\GA\\R\\E", 0, 0, 10, 10, "EC 42 81 5D 17 49 F6 B6", "Macro05 A41" },
+        /* 92*/ { UNICODE_MODE, 0, -1, -1, "0*C>*>1A", 0, 0, 8, 32, "E6 19 32 64 3C 07 AA 77 97 FE 6A 46 3F E1 BD B8 F2 B7 35 D5 CA", "C40 10 codewords" },
+        /* 93*/ { UNICODE_MODE | MINIMAL_MODE, 0, -1, -1, "0*C>*>1A", 0, 0, 14, 14, "F0 C2 A0 FE AB EC 41 81 F9 BC 7E 9E C3 34 22 8D 57 8C", "EDIFACT 7 codewords" },
+        /* 94*/ { DATA_MODE, 0, -1, -1, "ABCDEF\351abcdef", 0, 0, 12, 26, "E7 39 02 99 2F C6 5D F3 2C 39 D0 67 FD 94 2A 81 27 9F C9 1E 19 2F 10 82 B1 9A 49 2F 33 38", "Base 256 15 codewords" },
+        /* 95*/ { DATA_MODE | MINIMAL_MODE, 0, -1, -1, "ABCDEF\351abcdef", 0, 0, 12, 26, "42 43 44 45 46 47 EB 6A 62 63 64 65 66 67 81 ED D3 A4 6A 8C BA 74 13 E4 09 0A A8 87 ED AA", "ASCII 14 codewords" },
+        /* 96*/ { DATA_MODE, 0, -1, -1, "2c48\200!8@93#bC", 0, 0, 12, 26, "33 64 B2 E7 F5 02 39 E5 83 11 A1 27 FB 72 81 ED 26 90 12 E4 55 DE 44 8B 43 15 D7 A7 3C C3", "" },
+        /* 97*/ { DATA_MODE | MINIMAL_MODE, 0, -1, -1, "2c48\200!8@93#bC", 0, 0, 16, 16, "33 64 B2 EB 01 22 39 41 DF 24 63 44 27 DB 0A 9B 99 76 4F D2 0A C0 2F 6B", "ASCII 12 codewords" },
+        /* 98*/ { UNICODE_MODE | MINIMAL_MODE, 0, -1, -1, "0466010592130100000k*AGUATY80", 0, 0, 18, 18, "(32) 86 C4 83 87 DE 8F 83 82 82 31 6C EE 08 85 D6 D2 EF 65 93 B0 1C 3C 76 FB D4 AB 16 11", "Same as Annex P" },
+        /* 99*/ { GS1_MODE | MINIMAL_MODE, 0, -1, -1, "[01]12345678901231[10]ABC123abc[21]ABCDEFGH", 0, 0, 22, 22, "(50) E8 83 8E A4 BA D0 DC 8E A1 8C 42 43 44 8E 34 62 63 64 E8 97 42 43 44 45 46 47 48 49", "" },
+        /*100*/ { UNICODE_MODE | ESCAPE_MODE | MINIMAL_MODE, -1, -1, -1, "[)>\\R05\\GA*>\\r*>\\R\\E", 0, 0, 14, 14, "EC 42 2B 3F 0E 2B 3F 81 CA 19 A5 2A 99 DF 0B 7E 92 5F", "Macro05" },
+        /*101*/ { UNICODE_MODE | MINIMAL_MODE, 26, -1, -1, "ABCDÀEÈ", 0, 26, 12, 26, "F1 1B E7 60 2D C4 5B F1 06 58 B3 C7 21 81 57 ED 3D C0 12 2E 6C 80 58 CC 2C 05 0D 31 FC 2D", "ECI 27 BAS" },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -2206,6 +2278,7 @@ int main(int argc, char *argv[]) {
         { "test_buffer", test_buffer, 1, 0, 1 },
         { "test_options", test_options, 1, 0, 1 },
         { "test_reader_init", test_reader_init, 1, 1, 1 },
+        { "test_structapp", test_structapp, 1, 0, 1 },
         { "test_input", test_input, 1, 1, 1 },
         { "test_encode", test_encode, 1, 1, 1 },
         { "test_perf", test_perf, 1, 0, 1 },
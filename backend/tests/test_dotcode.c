@@ -786,6 +786,86 @@ static void test_encode(int index, int generate, int debug) {
     testFinish();
 }
 
+/* Automatic sizing is closed form (one size record), and masks are scored once each, the forced-corners fallback
+   (masks 4-7) only adding a second set of scores rather than redoing the encoding */
+static void test_sizing_masks(int index, int generate, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int option_2;
+        char *data;
+        int ret;
+
+        int expected_rows;
+        int expected_width;
+        int expected_penalties;
+        int expected_mask;
+        char *comment;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { -1, "1", 0, 9, 14, 4, 0, "" },
+        /*  1*/ { -1, "0", 0, 9, 14, 4, 3, "" },
+        /*  2*/ { -1, "9a", 0, 10, 13, 8, 5, "Fallback" },
+        /*  3*/ { -1, "1234567890", 0, 12, 19, 4, 1, "" },
+        /*  4*/ { -1, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", 0, 23, 34, 4, 3, "" },
+        /*  5*/ { -1, "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", 0, 31, 46, 4, 0, "" },
+        /*  6*/ { 13, "0", 0, 10, 13, 8, 5, "Fallback" },
+        /*  7*/ { 7, "0", 0, 16, 7, 8, 7, "Fallback" },
+        /*  8*/ { 7, "9C3", 0, 24, 7, 8, 7, "Fallback" },
+        /*  9*/ { 17, "4 c4a", 0, 14, 17, 8, 5, "Fallback" },
+        /* 10*/ { 23, "C31", 0, 8, 23, 8, 7, "Fallback" },
+        /* 11*/ { 200, "12345678901234567890123456789012345678901234567890123456789012345678901234567890", 0, 7, 200, 4, 3, "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, BARCODE_DOTCODE, UNICODE_MODE, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug | ZINT_DEBUG_TRACE);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        if (ret < ZINT_ERROR) {
+            const struct zint_trace_record *record;
+            int sizes = 0, penalties = 0, mask = -1;
+
+            for (int j = 0; (record = ZBarcode_Trace_Record(symbol, j)); j++) {
+                if (record->kind == ZINT_RECORD_SIZE) {
+                    sizes++;
+                } else if (record->kind == ZINT_RECORD_PENALTY) {
+                    assert_equal(record->values[0], penalties, "i:%d mask %d scored out of order (expected %d)\n", i, record->values[0], penalties);
+                    penalties++;
+                } else if (record->kind == ZINT_RECORD_MASK) {
+                    mask = record->values[0];
+                }
+            }
+
+            if (generate) {
+                printf("        /*%3d*/ { %d, \"%s\", %s, %d, %d, %d, %d, \"%s\" },\n",
+                        i, data[i].option_2, data[i].data, testUtilErrorName(data[i].ret), symbol->rows, symbol->width, penalties, mask, data[i].comment);
+            } else {
+                assert_equal(sizes, 1, "i:%d size records %d != 1\n", i, sizes);
+                assert_equal(symbol->rows, data[i].expected_rows, "i:%d symbol->rows %d != %d\n", i, symbol->rows, data[i].expected_rows);
+                assert_equal(symbol->width, data[i].expected_width, "i:%d symbol->width %d != %d\n", i, symbol->width, data[i].expected_width);
+                assert_equal(penalties, data[i].expected_penalties, "i:%d penalties %d != %d\n", i, penalties, data[i].expected_penalties);
+                assert_equal(mask, data[i].expected_mask, "i:%d mask %d != %d\n", i, mask, data[i].expected_mask);
+            }
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 // #181 Christian Hartlage / Nico Gunkel OSS-Fuzz
 static void test_fuzz(int index, int debug) {
 
@@ -850,6 +930,7 @@ int main(int argc, char *argv[]) {
         { "test_options", test_options, 1, 0, 1 },
         { "test_input", test_input, 1, 1, 1 },
         { "test_encode", test_encode, 1, 1, 1 },
+        { "test_sizing_masks", test_sizing_masks, 1, 1, 1 },
         { "test_fuzz", test_fuzz, 1, 0, 1 },
     };
 
@@ -670,6 +670,8 @@ static void test_utf8_to_eci_sb(int index) {
 
     unsigned char source[5];
     unsigned char dest[2] = {0};
+    unsigned char str_source[128 * 4 + 1];
+    unsigned char str_dest[128 + 1];
 
     for (int i = 0; i < data_size; i++) {
 
@@ -701,6 +703,36 @@ static void test_utf8_to_eci_sb(int index) {
                 }
             }
         }
+
+        // Every other code point must fail (checks the reverse tables have no stray entries)
+        unsigned char mapped[0x10000] = {0};
+        for (int j = 0; j < 128; j++) {
+            mapped[data[i].tab[j]] = 1;
+        }
+        for (unsigned int codepoint = 0x80; codepoint < 0x110000; codepoint += codepoint < 0x10000 ? 1 : 0x7F) {
+            if (codepoint >= 0xD800 && codepoint < 0xE000) continue;
+            if (codepoint < 0x10000 && mapped[codepoint]) continue;
+            int length = to_utf8(codepoint, source);
+            ret = utf8_to_eci(data[i].eci, source, dest, &length);
+            assert_equal(ret, ZINT_ERROR_INVALID_DATA, "i:%d eci:%d codepoint:0x%x utf8_to_eci ret %d != ZINT_ERROR_INVALID_DATA\n", i, data[i].eci, codepoint, ret);
+        }
+
+        // Whole string of all the mapped characters interspersed with ASCII
+        int str_length = 0, expected_length = 0;
+        unsigned char expected[128 + 1];
+        for (int j = 0; j < 128; j++) {
+            if (data[i].tab[j]) {
+                str_length += to_utf8(data[i].tab[j], str_source + str_length);
+                expected[expected_length++] = (unsigned char) (j + 128);
+            } else {
+                str_source[str_length++] = (unsigned char) j;
+                expected[expected_length++] = (unsigned char) j;
+            }
+        }
+        ret = utf8_to_eci(data[i].eci, str_source, str_dest, &str_length);
+        assert_zero(ret, "i:%d eci:%d string utf8_to_eci ret %d != 0\n", i, data[i].eci, ret);
+        assert_equal(str_length, expected_length, "i:%d eci:%d string length %d != %d\n", i, data[i].eci, str_length, expected_length);
+        assert_zero(memcmp(str_dest, expected, expected_length), "i:%d eci:%d string memcmp != 0\n", i, data[i].eci);
     }
 
     testFinish();
@@ -811,6 +843,9 @@ static void test_get_best_eci(int index) {
         /*  5*/ { "˜", -1, 23 },
         /*  6*/ { "βЂ", -1, 26 },
         /*  7*/ { "AB\200", -1, 0 },
+        /*  8*/ { "éگ", -1, 24 }, // Persian U+06AF only in Windows-1256
+        /*  9*/ { "é\303", -1, 0 }, // Truncated UTF-8
+        /* 10*/ { "", -1, 3 },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -827,6 +862,61 @@ static void test_get_best_eci(int index) {
     testFinish();
 }
 
+static void test_get_best_eci_segs(int index) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        const char *data;
+        int switch_bits;
+        int ret;
+        const char *expected;
+    };
+    // βγ U+03B2/3 ISO 8859-7 only, Жз U+0416/37 ISO 8859-5 & Win 1251, éá U+00E9/E1 ISO 8859-1 & most others (not 5 or 7)
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { "", 32, 0, "" },
+        /*  1*/ { "AB", 32, 1, "3:0:2" },
+        /*  2*/ { "éá", 32, 1, "3:0:4" },
+        /*  3*/ { "βγ", 32, 1, "9:0:4" },
+        /*  4*/ { "éβ", 32, 2, "3:0:2,9:2:2" },
+        /*  5*/ { "ééééβγβγβγ", 32, 2, "3:0:8,9:8:12" },
+        /*  6*/ { "éééééββββββ", 32, 2, "3:0:10,9:10:12" },
+        /*  7*/ { "ββββββéééééé", 32, 2, "9:0:12,3:12:12" },
+        /*  8*/ { "ββββββéééééé", 200, 1, "26:0:24" },
+        /*  9*/ { "ββββββ ΑΒΓ ЖЖЖЖзз ééé", 32, 3, "9:0:19,7:19:13,3:32:7" },
+        /* 10*/ { "ββββββ\303", 32, 0, "" }, // Truncated UTF-8
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char buf[512];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        struct zint_eci_segs segs;
+        int length = (int) strlen(data[i].data);
+
+        ret = get_best_eci_segs(symbol, (const unsigned char *) data[i].data, length, data[i].switch_bits, &segs);
+        assert_equal(ret, data[i].ret, "i:%d get_best_eci_segs ret %d != %d\n", i, ret, data[i].ret);
+
+        buf[0] = '\0';
+        for (int j = 0; j < ret; j++) {
+            sprintf(buf + strlen(buf), "%s%d:%d:%d", j ? "," : "", segs.segs[j].eci, segs.segs[j].start, segs.segs[j].length);
+        }
+        assert_zero(strcmp(buf, data[i].expected), "i:%d segs %s != %s\n", i, buf, data[i].expected);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
@@ -837,6 +927,7 @@ int main(int argc, char *argv[]) {
         { "test_utf8_to_eci_ascii", test_utf8_to_eci_ascii, 0, 0, 0 },
         { "test_utf8_to_eci_ucs2be", test_utf8_to_eci_ucs2be, 0, 0, 0 },
         { "test_get_best_eci", test_get_best_eci, 1, 0, 0 },
+        { "test_get_best_eci_segs", test_get_best_eci_segs, 1, 0, 0 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
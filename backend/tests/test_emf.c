@@ -70,11 +70,16 @@ static void test_print(int index, int generate, int debug) {
         /* 10*/ { BARCODE_CODE39, -1, -1, -1, -1, -1, "", "", 180, "123", "../data/emf/code39_rotate_180.emf", "" },
         /* 11*/ { BARCODE_CODE39, -1, -1, -1, -1, -1, "", "", 270, "123", "../data/emf/code39_rotate_270.emf", "" },
         /* 12*/ { BARCODE_MAXICODE, -1, -1, -1, -1, -1, "E0E0E0", "700070", 0, "THIS IS A 93 CHARACTER CODE SET A MESSAGE THAT FILLS A MODE 4, UNAPPENDED, MAXICODE SYMBOL...", "../data/emf/maxicode_#185.emf", "#185 Maxicode scaling" },
+        /* 13*/ { BARCODE_CODE128, -1, EMF_COMPACT, -1, -1, -1, "", "", 0, "Hello1234", "../data/emf/code128_compact.emf", "" },
+        /* 14*/ { BARCODE_EANX, -1, EMF_COMPACT, -1, -1, -1, "", "", 0, "9780877799306+54321", "../data/emf/ean13_5addon_compact.emf", "" },
+        /* 15*/ { BARCODE_ULTRA, -1, EMF_COMPACT, 5, -1, -1, "147AD0", "FC9630", 0, "123", "../data/emf/ultracode_fg_bg_compact.emf", "" },
+        /* 16*/ { BARCODE_CODE39, -1, EMF_COMPACT, -1, -1, -1, "", "", 90, "123", "../data/emf/code39_rotate_90_compact.emf", "" },
+        /* 17*/ { BARCODE_MAXICODE, -1, EMF_COMPACT, -1, -1, -1, "E0E0E0", "700070", 0, "THIS IS A 93 CHARACTER CODE SET A MESSAGE THAT FILLS A MODE 4, UNAPPENDED, MAXICODE SYMBOL...", "../data/emf/maxicode_compact.emf", "" },
     };
     int data_size = ARRAY_SIZE(data);
 
     char *data_dir = "../data/emf";
-    char *emf = "out.emf";
+    char emf[256];
     char escaped[1024];
     int escaped_size = 1024;
 
@@ -89,6 +94,8 @@ static void test_print(int index, int generate, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(emf, i, "emf");
+
         struct zint_symbol* symbol = ZBarcode_Create();
         assert_nonnull(symbol, "Symbol not created\n");
 
@@ -224,8 +224,14 @@ static void test_gb2312_utf8_to_eci(int index) {
 
     int data_size = sizeof(data) / sizeof(struct item);
 
+    struct zint_symbol symbol;
+    struct zint_internal internal;
     unsigned int gbdata[20];
 
+    memset(&symbol, 0, sizeof(symbol));
+    memset(&internal, 0, sizeof(internal));
+    symbol.internal = &internal;
+
     for (int i = 0; i < data_size; i++) {
 
         if (index != -1 && i != index) continue;
@@ -233,7 +239,8 @@ static void test_gb2312_utf8_to_eci(int index) {
         int length = data[i].length == -1 ? (int) strlen(data[i].data) : data[i].length;
         int ret_length = length;
 
-        ret = gb2312_utf8_to_eci(data[i].eci, (unsigned char *) data[i].data, &ret_length, gbdata, data[i].full_multibyte);
+        ret = gb2312_utf8_to_eci(&symbol, data[i].eci, (unsigned char *) data[i].data, &ret_length, gbdata, data[i].full_multibyte);
+        z_work_free(&symbol);
         assert_equal(ret, data[i].ret, "i:%d ret %d != %d\n", i, ret, data[i].ret);
         if (ret == 0) {
             assert_equal(ret_length, data[i].ret_length, "i:%d ret_length %d != %d\n", i, ret_length, data[i].ret_length);
@@ -64,7 +64,7 @@ static void test_pixel_plot(int index, int debug) {
     };
     int data_size = ARRAY_SIZE(data);
 
-    char *gif = "out.gif";
+    char gif[256];
 
     char data_buf[19 * 32 + 1]; // 19 * 32 == 608
 
@@ -72,6 +72,8 @@ static void test_pixel_plot(int index, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(gif, i, "gif");
+
         struct zint_symbol *symbol = ZBarcode_Create();
         assert_nonnull(symbol, "Symbol not created\n");
 
@@ -109,10 +111,162 @@ static void test_pixel_plot(int index, int debug) {
     testFinish();
 }
 
+/* Decode the LZW image data of GIF `gif` into palette indexes, returning number of pixels or -1 on error */
+static int decode_gif(const unsigned char *gif, int gif_size, unsigned char *pixels, int pixels_size) {
+    static unsigned short prefix[4096];
+    static unsigned char suffix[4096], first[4096], stack[4096];
+    int pos = 13 + 3 * (2 << (gif[10] & 0x07)); /* Header, screen descriptor and global colour table */
+    int min_code_size, code_size, clear_code, next_code, prev = -1;
+    unsigned int bits = 0;
+    int bit_count = 0, block_left, count = 0;
+    int i;
+
+    if (pos < gif_size && gif[pos] == 0x21) { /* Graphic control extension */
+        pos += 8;
+    }
+    if (pos + 12 > gif_size || gif[pos] != 0x2C) {
+        return -1;
+    }
+    pos += 10;
+    min_code_size = gif[pos++];
+    clear_code = 1 << min_code_size;
+    for (i = 0; i < clear_code; i++) {
+        suffix[i] = first[i] = (unsigned char) i;
+    }
+    code_size = min_code_size + 1;
+    next_code = clear_code + 2;
+    block_left = gif[pos++];
+
+    for (;;) {
+        int code, cur, sp = 0;
+        while (bit_count < code_size) {
+            if (block_left == 0 && (pos >= gif_size || (block_left = gif[pos++]) == 0)) {
+                return -1;
+            }
+            if (pos >= gif_size) {
+                return -1;
+            }
+            bits |= gif[pos++] << bit_count;
+            bit_count += 8;
+            block_left--;
+        }
+        code = bits & ((1 << code_size) - 1);
+        bits >>= code_size;
+        bit_count -= code_size;
+
+        if (code == clear_code) {
+            code_size = min_code_size + 1;
+            next_code = clear_code + 2;
+            prev = -1;
+            continue;
+        }
+        if (code == clear_code + 1) {
+            return count;
+        }
+        if (code > next_code || (prev == -1 && code >= clear_code)) {
+            return -1;
+        }
+        if (prev != -1 && next_code < 4096) {
+            prefix[next_code] = prev;
+            suffix[next_code] = first[code == next_code ? prev : code];
+            first[next_code] = first[prev];
+            if (++next_code == (1 << code_size) && code_size < 12) {
+                code_size++;
+            }
+        }
+        for (cur = code; cur >= clear_code; cur = prefix[cur]) {
+            stack[sp++] = suffix[cur];
+        }
+        stack[sp++] = (unsigned char) cur;
+        if (count + sp > pixels_size) {
+            return -1;
+        }
+        while (sp) {
+            pixels[count++] = stack[--sp];
+        }
+        prev = code;
+    }
+}
+
+static void test_large(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        float scale;
+        char *fgcolour;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, 20, "", "1234567890" },
+        /*  1*/ { BARCODE_MAXICODE, 12, "", "1234" },
+        /*  2*/ { BARCODE_ULTRA, 10, "", "12345678901234567890123456789012345678901234567890" },
+        /*  3*/ { BARCODE_DATAMATRIX, 10, "FF000000", "12345678901234567890123456789012345678901234567890" }, /* Transparent */
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, OUT_BUFFER_INTERMEDIATE, data[i].data, -1, debug);
+        symbol->scale = data[i].scale;
+        if (*data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+
+        ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        int size = symbol->bitmap_width * symbol->bitmap_height;
+        unsigned char *pixelbuf = (unsigned char *) malloc(size);
+        assert_nonnull(pixelbuf, "i:%d malloc pixelbuf fail\n", i);
+        memcpy(pixelbuf, symbol->bitmap, size);
+
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+        strcpy(symbol->outfile, "mem.gif");
+        ret = gif_pixel_plot(symbol, pixelbuf);
+        assert_zero(ret, "i:%d gif_pixel_plot ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_nonnull(symbol->memfile, "i:%d memfile NULL\n", i);
+
+        unsigned char *pixels = (unsigned char *) malloc(size);
+        assert_nonnull(pixels, "i:%d malloc pixels fail\n", i);
+        ret = decode_gif(symbol->memfile, symbol->memfile_size, pixels, size);
+        assert_equal(ret, size, "i:%d decode_gif ret %d != %d\n", i, ret, size);
+
+        /* The first occurrence of each colour code gives its palette index */
+        unsigned char map[256];
+        memset(map, 0xFF, sizeof(map));
+        int j;
+        for (j = 0; j < size; j++) {
+            if (map[pixelbuf[j]] == 0xFF) {
+                map[pixelbuf[j]] = pixels[j];
+            }
+            if (pixels[j] != map[pixelbuf[j]]) {
+                break;
+            }
+        }
+        assert_equal(j, size, "i:%d pixel %d index %d != %d\n", i, j, pixels[j], map[pixelbuf[j]]);
+
+        free(pixels);
+        free(pixelbuf);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
         { "test_pixel_plot", test_pixel_plot, 1, 0, 1 },
+        { "test_large", test_large, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
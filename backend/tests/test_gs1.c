@@ -1313,6 +1313,7 @@ static void test_gs1_verify(int index, int debug) {
     int data_size = ARRAY_SIZE(data);
 
     char reduced[1024];
+    int reduced_length;
 
     for (int i = 0; i < data_size; i++) {
 
@@ -1324,11 +1325,12 @@ static void test_gs1_verify(int index, int debug) {
 
         int length = strlen(data[i].data);
 
-        ret = gs1_verify(symbol, (unsigned char *) data[i].data, length, (unsigned char *) reduced);
+        ret = gs1_verify(symbol, (unsigned char *) data[i].data, length, (unsigned char *) reduced, &reduced_length);
         assert_equal(ret, data[i].ret, "i:%d ret %d != %d (length %d \"%s\") %s\n", i, ret, data[i].ret, length, data[i].data, symbol->errtxt);
 
         if (ret < ZINT_ERROR) {
             assert_zero(strcmp(reduced, data[i].expected), "i:%d strcmp(%s, %s) != 0\n", i, reduced, data[i].expected);
+            assert_equal(reduced_length, (int) strlen(reduced), "i:%d reduced_length %d != strlen %d\n", i, reduced_length, (int) strlen(reduced));
         }
 
         ZBarcode_Delete(symbol);
@@ -1717,6 +1719,7 @@ static void test_gs1_lint(int index, int debug) {
     int data_size = ARRAY_SIZE(data);
 
     char reduced[1024];
+    int reduced_length;
 
     for (int i = 0; i < data_size; i++) {
 
@@ -1728,11 +1731,12 @@ static void test_gs1_lint(int index, int debug) {
 
         int length = strlen(data[i].data);
 
-        ret = gs1_verify(symbol, (unsigned char *) data[i].data, length, (unsigned char *) reduced);
+        ret = gs1_verify(symbol, (unsigned char *) data[i].data, length, (unsigned char *) reduced, &reduced_length);
         assert_equal(ret, data[i].ret, "i:%d ret %d != %d (length %d \"%s\") %s\n", i, ret, data[i].ret, length, data[i].data, symbol->errtxt);
 
         if (ret < ZINT_ERROR) {
             assert_zero(strcmp(reduced, data[i].expected), "i:%d strcmp(%s, %s) != 0\n", i, reduced, data[i].expected);
+            assert_equal(reduced_length, (int) strlen(reduced), "i:%d reduced_length %d != strlen %d\n", i, reduced_length, (int) strlen(reduced));
         }
         assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected_errtxt);
 
@@ -1801,11 +1805,21 @@ static void test_input_mode(int index, int debug) {
         /* 40*/ { BARCODE_QRCODE, "(01)12345678901231", "", GS1_MODE | ESCAPE_MODE | GS1PARENS_MODE, -1, 0, 1 },
         /* 41*/ { BARCODE_QRCODE, "1234", "", GS1_MODE, -1, ZINT_ERROR_INVALID_DATA, 0 },
         /* 42*/ { BARCODE_QRCODE, "1234", "", GS1_MODE | ESCAPE_MODE, -1, ZINT_ERROR_INVALID_DATA, 0 },
+        /* 43*/ { BARCODE_AZTEC, "[01]12345678901234", "", GS1_MODE, -1, ZINT_WARN_NONCOMPLIANT, 0 },
+        /* 44*/ { BARCODE_AZTEC, "[01]12345678901234", "", GS1_MODE | GS1NOCHECK_MODE, -1, 0, 0 },
+        /* 45*/ { BARCODE_AZTEC, "[9999]1234", "", GS1_MODE, -1, ZINT_ERROR_INVALID_DATA, 0 },
+        /* 46*/ { BARCODE_AZTEC, "[9999]1234", "", GS1_MODE | GS1NOCHECK_MODE, -1, 0, 0 },
+        /* 47*/ { BARCODE_AZTEC, "(9999)1234", "", GS1_MODE | GS1PARENS_MODE | GS1NOCHECK_MODE, -1, 0, 1 },
+        /* 48*/ { BARCODE_AZTEC, "1234", "", GS1_MODE | GS1NOCHECK_MODE, -1, ZINT_ERROR_INVALID_DATA, 0 },
+        /* 49*/ { BARCODE_AZTEC, "[01]", "", GS1_MODE | GS1NOCHECK_MODE, -1, ZINT_ERROR_INVALID_DATA, 0 },
+        /* 50*/ { BARCODE_GS1_128, "[01]12345678901234", "", GS1NOCHECK_MODE, -1, 0, 0 },
+        /* 51*/ { BARCODE_GS1_128_CC, "[01]12345678901234", "[21]A1B2C3", GS1NOCHECK_MODE, -1, 0, 0 },
     };
     int data_size = ARRAY_SIZE(data);
 
     char *text;
     struct zint_symbol previous_symbol;
+    struct zint_internal previous_internal;
 
     for (int i = 0; i < data_size; i++) {
 
@@ -1828,7 +1842,105 @@ static void test_input_mode(int index, int debug) {
             ret = testUtilSymbolCmp(symbol, &previous_symbol);
             assert_zero(ret, "i:%d testUtilSymbolCmp ret %d != 0\n", i, ret);
         }
-        memcpy(&previous_symbol, symbol, sizeof(previous_symbol));
+        testUtilSymbolCopy(&previous_symbol, &previous_internal, symbol);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_encode_gs1(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct element {
+        int ai;
+        char *data;
+    };
+    struct item {
+        int symbology;
+        int input_mode;
+        char *primary;
+        struct element elements[4];
+        int count;
+        char *data; /* Equivalent bracketed data, NULL if none */
+        int ret;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_GS1_128, -1, "", { { 1, "12345678901231" }, { 10, "ABC123" }, { 17, "251231" } }, 3, "[01]12345678901231[10]ABC123[17]251231", 0, "" },
+        /*  1*/ { BARCODE_GS1_128, GS1PARENS_MODE, "", { { 1, "12345678901231" }, { 10, "(A)" } }, 2, "[01]12345678901231[10](A)", 0, "" },
+        /*  2*/ { BARCODE_DBAR_EXP, -1, "", { { 1, "12345678901231" }, { 3103, "001750" } }, 2, "[01]12345678901231[3103]001750", 0, "" },
+        /*  3*/ { BARCODE_DBAR_EXPSTK, -1, "", { { 8004, "9501101020917" }, { 21, "12345" }, { 240, "XYZ" } }, 3, "[8004]9501101020917[21]12345[240]XYZ", 0, "" },
+        /*  4*/ { BARCODE_DATAMATRIX, -1, "", { { 0, "123456789012345675" }, { 400, "PO123" }, { 11, "210101" } }, 3, "[00]123456789012345675[400]PO123[11]210101", 0, "" },
+        /*  5*/ { BARCODE_QRCODE, -1, "", { { 1, "12345678901231" }, { 21, "A;B" }, { 99, "X" } }, 3, "[01]12345678901231[21]A;B[99]X", 0, "" },
+        /*  6*/ { BARCODE_AZTEC, ESCAPE_MODE, "", { { 90, "\\d" } }, 1, "[90]\\d", ZINT_WARN_NONCOMPLIANT, "Warning 261: AI (90) position 1: Invalid CSET 82 character '\\'" },
+        /*  7*/ { BARCODE_CODE16K, -1, "", { { 1, "12345678901231" } }, 1, "[01]12345678901231", 0, "" },
+        /*  8*/ { BARCODE_GS1_128_CC, -1, "[01]12345678901231", { { 10, "LOT1" }, { 21, "S1" } }, 2, "[10]LOT1[21]S1", 0, "" },
+        /*  9*/ { BARCODE_DBAR_EXP_CC, -1, "[01]12345678901231", { { 91, "ABCDEFG" } }, 1, "[91]ABCDEFG", 0, "" },
+        /* 10*/ { BARCODE_GS1_128, -1, "", { { 1, "12345678901234" } }, 1, "[01]12345678901234", ZINT_WARN_NONCOMPLIANT, "Warning 261: AI (01) position 14: Bad checksum '4', expected '1'" },
+        /* 11*/ { BARCODE_DATAMATRIX, -1, "", { { 1, "123" } }, 1, "[01]123", ZINT_ERROR_INVALID_DATA, "Error 259: Invalid data length for AI (01)" },
+        /* 12*/ { BARCODE_DATAMATRIX, GS1NOCHECK_MODE, "", { { 1, "123" } }, 1, "[01]123", 0, "" },
+        /* 13*/ { BARCODE_QRCODE, -1, "", { { 5, "1" } }, 1, "[05]1", ZINT_ERROR_INVALID_DATA, "Error 260: Invalid AI (05)" },
+        /* 14*/ { BARCODE_QRCODE, -1, "", { { 10, "\001" } }, 1, "[10]\001", ZINT_ERROR_INVALID_DATA, "Error 251: Control characters are not supported by GS1" },
+        /* 15*/ { BARCODE_QRCODE, -1, "", { { 10, "A" }, { 21, "" } }, 2, "[10]A[21]", ZINT_ERROR_INVALID_DATA, "Error 258: Empty data field in input data" },
+        /* 16*/ { BARCODE_QRCODE, -1, "", { { 10, "A[1]" } }, 1, NULL, ZINT_ERROR_INVALID_DATA, "Error 760: Brackets not permitted in AI (10) data" },
+        /* 17*/ { BARCODE_QRCODE, -1, "", { { 10000, "A" } }, 1, NULL, ZINT_ERROR_INVALID_DATA, "Error 759: Invalid AI 10000 in element 0" },
+        /* 18*/ { BARCODE_QRCODE, -1, "", { { 10, "A" } }, 0, NULL, ZINT_ERROR_INVALID_DATA, "Error 761: GS1 elements NULL or count not positive" },
+        /* 19*/ { BARCODE_EAN14, -1, "", { { 1, "1234567890123" } }, 1, NULL, ZINT_ERROR_INVALID_OPTION, "Error 762: Selected symbology does not support GS1 elements" },
+        /* 20*/ { BARCODE_CODE128, -1, "", { { 10, "A" } }, 1, "[10]A", ZINT_ERROR_INVALID_OPTION, "Error 220: Selected symbology does not support GS1 mode" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_gs1_element elements[4];
+        for (int j = 0; j < data[i].count; j++) {
+            elements[j].ai = data[i].elements[j].ai;
+            elements[j].data = (const unsigned char *) data[i].elements[j].data;
+            elements[j].length = -1;
+        }
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1, -1, -1, -1 /*output_options*/, "", -1, debug);
+        const int input_mode = symbol->input_mode;
+        if (data[i].primary[0]) {
+            strcpy(symbol->primary, data[i].primary);
+        }
+
+        ret = ZBarcode_Encode_GS1(symbol, elements, data[i].count);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode_GS1 ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d errtxt %s != %s\n", i, symbol->errtxt, data[i].expected_errtxt);
+        assert_equal(symbol->input_mode, input_mode, "i:%d input_mode 0x%X != 0x%X\n", i, symbol->input_mode, input_mode);
+        assert_null(symbol->internal->gs1_prepared, "i:%d gs1_prepared not NULL\n", i);
+
+        if (data[i].data) {
+            /* Same as bracketed (in GS1_MODE, with no escapes or parentheses) */
+            struct zint_symbol *symbol2 = ZBarcode_Create();
+            assert_nonnull(symbol2, "Symbol2 not created\n");
+
+            int length2 = testUtilSetSymbol(symbol2, data[i].symbology, GS1_MODE | (data[i].input_mode != -1 ? data[i].input_mode & GS1NOCHECK_MODE : 0), -1 /*eci*/, -1, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+            if (data[i].primary[0]) {
+                strcpy(symbol2->primary, data[i].primary);
+            }
+            ret = ZBarcode_Encode(symbol2, (const unsigned char *) data[i].data, length2);
+            assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol2->errtxt);
+            assert_zero(strcmp(symbol2->errtxt, symbol->errtxt), "i:%d errtxt %s != %s\n", i, symbol2->errtxt, symbol->errtxt);
+            if (ret < ZINT_ERROR) {
+                ret = testUtilSymbolCmp(symbol, symbol2);
+                assert_zero(ret, "i:%d testUtilSymbolCmp ret %d != 0\n", i, ret);
+                assert_zero(strcmp((const char *) symbol->text, (const char *) symbol2->text), "i:%d text %s != %s\n", i, symbol->text, symbol2->text);
+            }
+
+            ZBarcode_Delete(symbol2);
+        }
 
         ZBarcode_Delete(symbol);
     }
@@ -1844,6 +1956,7 @@ int main(int argc, char *argv[]) {
         { "test_gs1_verify", test_gs1_verify, 1, 0, 1 },
         { "test_gs1_lint", test_gs1_lint, 1, 0, 1 },
         { "test_input_mode", test_input_mode, 1, 0, 1 },
+        { "test_encode_gs1", test_encode_gs1, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
@@ -242,6 +242,10 @@ static void test_input(int index, int generate, int debug) {
         /* 76*/ { UNICODE_MODE, 170, -1, "?", -1, 0, 170, "88 0A A2 FB 1F C0 00 00 00", "ECI-170 L1 (ASCII invariant)" },
         /* 77*/ { DATA_MODE, 899, -1, "\200", -1, 0, 899, "88 38 33 00 0C 00 00 00 00", "ECI-899 B1 (8-bit binary)" },
         /* 78*/ { UNICODE_MODE, 900, -1, "é", -1, 0, 900, "88 38 43 00 16 1D 48 00 00", "ECI-900 B2 (no conversion)" },
+        /* 79*/ { UNICODE_MODE | FAST_MODE, 0, -1, "啊亍齄丂\302\200", -1, 0, 0, "64 68 50 3C AC 28 80 00 FF FE E0 00 00 00 00 00 00", "H(d)4 H(f)1 (GB 18030)" },
+        /* 80*/ { UNICODE_MODE | FAST_MODE, 0, -1, "Aa%$Bb9", -1, 0, 0, "22 A4 FA 18 3E 2E 52 7F 00", "T7 (ASCII)" },
+        /* 81*/ { UNICODE_MODE | FAST_MODE, 0, -1, "Summer Palace Ticket for 6 June 2015 13:00;2015年6月6日夜01時00分PM頤和園のチケット;2015년6월6일13시오후여름궁전티켓.2015年6月6号下午13:00的颐和园门票;", -1, 0, 0, "(189) 27 38 C3 0A 35 F9 CF 99 92 F9 26 A3 E7 3E 76 C9 AE A3 7F 9C FA 9C B5 F9 CF 86 F9 CF", "T20 B64 N4 H(f)1 T1 H(f)1 T1 H(f)1 T2 H(f)9 B35 (GB 18030)" },
+        /* 82*/ { UNICODE_MODE | FAST_MODE, 0, -1, "啊啊啊啊亍亍啊", -1, 0, 0, "40 00 00 00 00 00 0F FE 00 00 00 FF E0 00 FF F0 00", "Region 1 (FFE) -> Region 2 (FFE) -> Region 1" },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -1488,6 +1492,64 @@ static void test_encode(int index, int generate, int debug) {
     testFinish();
 }
 
+/* Encoding again with the same symbol re-uses the function pattern template kept for the version */
+static void test_template(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int option_1;
+        int option_2;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { -1, -1, "1234" },
+        /*  1*/ { -1, -1, "5678" }, // Same version
+        /*  2*/ { -1, 24, "1234" }, // Different version
+        /*  3*/ { 4, 24, "Han Xin Code" }, // Same version, different ECC
+        /*  4*/ { -1, 84, "1234" },
+        /*  5*/ { -1, 84, "abcdefghijklmnopqrstuvwxyz" },
+        /*  6*/ { -1, 3, "1234" }, // No alignment patterns
+        /*  7*/ { -1, 4, "1234" },
+        /*  8*/ { -1, -1, "1234" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct zint_symbol *symbol = ZBarcode_Create();
+    assert_nonnull(symbol, "Symbol not created\n");
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *expected = ZBarcode_Create();
+        assert_nonnull(expected, "Symbol expected not created\n");
+
+        int length = testUtilSetSymbol(expected, BARCODE_HANXIN, -1 /*input_mode*/, -1 /*eci*/, data[i].option_1, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        ret = ZBarcode_Encode(expected, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode expected ret %d != 0 (%s)\n", i, ret, expected->errtxt);
+
+        ZBarcode_Clear(symbol);
+        symbol->option_1 = -1; /* Options not reset by `ZBarcode_Clear()` */
+        symbol->option_2 = 0;
+        (void) testUtilSetSymbol(symbol, BARCODE_HANXIN, -1 /*input_mode*/, -1 /*eci*/, data[i].option_1, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_nonnull(symbol->internal->grid_template, "i:%d grid_template NULL\n", i);
+
+        ret = testUtilSymbolCmp(symbol, expected);
+        assert_zero(ret, "i:%d testUtilSymbolCmp ret %d != 0\n", i, ret);
+
+        ZBarcode_Delete(expected);
+    }
+
+    ZBarcode_Delete(symbol);
+
+    testFinish();
+}
+
 #include <time.h>
 
 #define TEST_PERF_ITERATIONS    1000
@@ -1595,6 +1657,7 @@ int main(int argc, char *argv[]) {
         { "test_options", test_options, 1, 0, 1 },
         { "test_input", test_input, 1, 1, 1 },
         { "test_encode", test_encode, 1, 1, 1 },
+        { "test_template", test_template, 1, 0, 1 },
         { "test_perf", test_perf, 1, 0, 1 },
     };
 
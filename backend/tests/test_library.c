@@ -33,6 +33,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <limits.h>
 #include <unistd.h>
 
 static void test_checks(int index, int debug) {
@@ -98,6 +99,10 @@ static void test_checks(int index, int debug) {
         /* 40*/ { 146, "1", -1, -1, -1, -1, -1, ZINT_WARN_INVALID_OPTION, "Warning 216: Symbology out of range", BARCODE_CODE128 },
         /* 41*/ { 146, "1", -1, -1, -1, -1, WARN_FAIL_ALL, ZINT_ERROR_INVALID_OPTION, "Error 216: Symbology out of range", -1 },
         /* 42*/ { BARCODE_CODE128, "\200", -1, UNICODE_MODE, -1, -1, -1, ZINT_ERROR_INVALID_DATA, "Error 245: Invalid UTF-8", -1 },
+        /* 43*/ { -1, "1", -1, -1, -1, -1, -1, ZINT_WARN_INVALID_OPTION, "Warning 206: Symbology out of range", BARCODE_CODE128 },
+        /* 44*/ { 33, "[01]12345678901231", -1, GS1_MODE, -1, -1, -1, 0, "", BARCODE_GS1_128 },
+        /* 45*/ { 45, "12345", -1, -1, -1, -1, -1, 0, "", BARCODE_POSTNET },
+        /* 46*/ { 105, "1", -1, -1, -1, -1, WARN_FAIL_ALL, 0, "", BARCODE_HIBC_QR },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -223,11 +228,18 @@ static void test_escape_char_process(int index, int generate, int debug) {
         /* 23*/ { DATA_MODE, 17, "\\xA4", 0, 12, "F1 12 EB 25 81 4A 0A 8C 31 AC E3 2E", 1, "" },
         /* 24*/ { DATA_MODE, 28, "\\xB1\\x60", 0, 12, "F1 1D EB 32 61 D9 1C 0C C2 46 C3 B2", 0, "Zint manual 4.10 Ex2" },
         /* 25*/ { UNICODE_MODE, 28, "\\u5E38", 0, 12, "F1 1D EB 32 61 D9 1C 0C C2 46 C3 B2", 1, "" },
+        /* 26*/ { DATA_MODE, -1, "ABC\tDE", 0, 14, "42 43 44 0A 45 46 81 38 3A 72 33 DE 67 61 49 23 11 E6", 0, "No escapes" },
+        /* 27*/ { DATA_MODE, -1, "ABC\\tDE", 0, 14, "42 43 44 0A 45 46 81 38 3A 72 33 DE 67 61 49 23 11 E6", 1, "Escape between runs" },
+        /* 28*/ { DATA_MODE, -1, "\\x41BC\\tD\\x45", 0, 14, "42 43 44 0A 45 46 81 38 3A 72 33 DE 67 61 49 23 11 E6", 1, "Escapes at start and end" },
+        /* 29*/ { DATA_MODE, -1, "ABC\\", ZINT_ERROR_INVALID_DATA, 0, "Error 236: Incomplete escape character in input data", 0, "After run" },
+        /* 30*/ { DATA_MODE, -1, "AB\\\\\\\\C", 0, 12, "42 43 5D 5D 44 28 FA A4 55 ED 2C 13", 0, "Consecutive escapes" },
+        /* 31*/ { DATA_MODE, -1, "AB\\\\C", 0, 12, "42 43 5D 44 81 83 6B D9 A0 59 73 3A", 0, "" },
     };
     int data_size = ARRAY_SIZE(data);
 
     char escaped[1024];
     struct zint_symbol previous_symbol;
+    struct zint_internal previous_internal;
     char *input_filename = "test_escape.txt";
 
     for (int i = 0; i < data_size; i++) {
@@ -258,7 +270,7 @@ static void test_escape_char_process(int index, int generate, int debug) {
                     assert_zero(ret, "i:%d testUtilSymbolCmp ret %d != 0\n", i, ret);
                 }
             }
-            memcpy(&previous_symbol, symbol, sizeof(previous_symbol));
+            testUtilSymbolCopy(&previous_symbol, &previous_internal, symbol);
 
             if (ret < 5) {
                 // Test from input file
@@ -330,6 +342,30 @@ static void test_cap(int index) {
     testFinish();
 }
 
+/* Check capabilities shared with the renderers' `is_stackable()` etc. agree, and no internal flags leak */
+static void test_cap_common(void) {
+
+    testStart("");
+
+    unsigned int ret;
+    int symbology;
+
+    for (symbology = -1; symbology <= 150; symbology++) {
+        const int valid = ZBarcode_ValidID(symbology);
+
+        ret = ZBarcode_Cap(symbology, ZINT_CAP_STACKABLE);
+        assert_equal(ret, valid && is_stackable(symbology) ? ZINT_CAP_STACKABLE : 0, "symbology %d ZBarcode_Cap(ZINT_CAP_STACKABLE) 0x%X wrong\n", symbology, ret);
+        ret = ZBarcode_Cap(symbology, ZINT_CAP_EXTENDABLE);
+        assert_equal(ret, valid && is_extendable(symbology) ? ZINT_CAP_EXTENDABLE : 0, "symbology %d ZBarcode_Cap(ZINT_CAP_EXTENDABLE) 0x%X wrong\n", symbology, ret);
+        ret = ZBarcode_Cap(symbology, ZINT_CAP_COMPOSITE);
+        assert_equal(ret, valid && is_composite(symbology) ? ZINT_CAP_COMPOSITE : 0, "symbology %d ZBarcode_Cap(ZINT_CAP_COMPOSITE) 0x%X wrong\n", symbology, ret);
+        ret = ZBarcode_Cap(symbology, ~0xFFFFu);
+        assert_zero(ret, "symbology %d ZBarcode_Cap(~0xFFFF) 0x%X != 0\n", symbology, ret);
+    }
+
+    testFinish();
+}
+
 // #181 Nico Gunkel OSS-Fuzz
 static void test_encode_file_length(void) {
 
@@ -408,6 +444,82 @@ static void test_encode_file_directory(void) {
     testFinish();
 }
 
+static void test_encode_file_mapped(void) {
+
+    testStart("");
+
+    int ret;
+    char filename[] = "in_mapped.bin";
+    char data[5001];
+    int length = (int) sizeof(data) - 1;
+    int fds[2];
+    int stdin_fd;
+    int fd;
+    int i;
+
+    struct zint_symbol *symbol = ZBarcode_Create();
+    assert_nonnull(symbol, "Symbol not created\n");
+    struct zint_symbol *symbol2 = ZBarcode_Create();
+    assert_nonnull(symbol2, "Symbol2 not created\n");
+
+    for (i = 0; i < length; i++) {
+        data[i] = '0' + i % 10;
+    }
+    data[length] = '\0';
+
+    symbol2->symbology = BARCODE_QRCODE;
+    ret = ZBarcode_Encode(symbol2, (unsigned char *) data, length);
+    assert_zero(ret, "ZBarcode_Encode ret %d != 0 (%s)\n", ret, symbol2->errtxt);
+
+    (void)remove(filename); // In case junk hanging around
+
+    // Regular file (memory-mapped where available)
+    fd = creat(filename, S_IRUSR | S_IWUSR);
+    assert_nonzero(fd, "Input file not created\n");
+    ret = write(fd, data, length);
+    assert_equal(ret, length, "write ret %d != %d\n", ret, length);
+    assert_zero(close(fd), "close(%s) != 0\n", filename);
+
+    symbol->symbology = BARCODE_QRCODE;
+    ret = ZBarcode_Encode_File(symbol, filename);
+    assert_zero(ret, "ZBarcode_Encode_File ret %d != 0 (%s)\n", ret, symbol->errtxt);
+    assert_equal(symbol->rows, symbol2->rows, "rows %d != %d\n", symbol->rows, symbol2->rows);
+    assert_equal(symbol->width, symbol2->width, "width %d != %d\n", symbol->width, symbol2->width);
+    assert_zero(memcmp(symbol->internal->encoded_data, symbol2->internal->encoded_data, sizeof(symbol->internal->encoded_data)),
+                "encoded_data differs\n");
+
+    assert_zero(remove(filename), "remove(%s) != 0\n", filename);
+
+    // Stdin pipe (streamed)
+    assert_zero(pipe(fds), "pipe() != 0 (%d: %s)\n", errno, strerror(errno));
+    ret = write(fds[1], data, length);
+    assert_equal(ret, length, "pipe write ret %d != %d\n", ret, length);
+    assert_zero(close(fds[1]), "close(fds[1]) != 0\n");
+    stdin_fd = dup(0);
+    assert_notequal(stdin_fd, -1, "dup(0) == -1 (%d: %s)\n", errno, strerror(errno));
+    assert_notequal(dup2(fds[0], 0), -1, "dup2(fds[0], 0) == -1 (%d: %s)\n", errno, strerror(errno));
+    assert_zero(close(fds[0]), "close(fds[0]) != 0\n");
+    clearerr(stdin);
+
+    ZBarcode_Clear(symbol);
+    ret = ZBarcode_Encode_File(symbol, "-");
+
+    assert_notequal(dup2(stdin_fd, 0), -1, "dup2(stdin_fd, 0) == -1 (%d: %s)\n", errno, strerror(errno));
+    assert_zero(close(stdin_fd), "close(stdin_fd) != 0\n");
+    clearerr(stdin);
+
+    assert_zero(ret, "ZBarcode_Encode_File stdin ret %d != 0 (%s)\n", ret, symbol->errtxt);
+    assert_equal(symbol->rows, symbol2->rows, "stdin rows %d != %d\n", symbol->rows, symbol2->rows);
+    assert_equal(symbol->width, symbol2->width, "stdin width %d != %d\n", symbol->width, symbol2->width);
+    assert_zero(memcmp(symbol->internal->encoded_data, symbol2->internal->encoded_data, sizeof(symbol->internal->encoded_data)),
+                "stdin encoded_data differs\n");
+
+    ZBarcode_Delete(symbol);
+    ZBarcode_Delete(symbol2);
+
+    testFinish();
+}
+
 static void test_bad_args(void) {
 
     testStart("");
@@ -519,6 +631,42 @@ static void test_valid_id(void) {
     testFinish();
 }
 
+static void test_init(void) {
+
+    testStart("");
+
+    int ret;
+    static const int flags[] = { ZINT_INIT_RS, ZINT_INIT_ECI, ZINT_INIT_SYMBOLOGY, ZINT_INIT_FONTS };
+    const int flags_size = ARRAY_SIZE(flags);
+    int total = 0;
+
+    for (int i = 0; i < flags_size; i++) {
+        ret = ZBarcode_Init(flags[i]);
+        assert_zero(ret, "i:%d ZBarcode_Init(0x%X) ret %d != 0\n", i, flags[i], ret);
+        ret = ZBarcode_Init_Memory(flags[i]);
+        assert_nonzero(ret > 0, "i:%d ZBarcode_Init_Memory(0x%X) ret %d <= 0\n", i, flags[i], ret);
+        total += ret;
+    }
+    ret = ZBarcode_Init_Memory(ZINT_INIT_ALL);
+    assert_equal(ret, total, "ZBarcode_Init_Memory(ZINT_INIT_ALL) ret %d != %d\n", ret, total);
+    ret = ZBarcode_Init_Memory(ZINT_INIT_RS);
+    assert_equal(ret, 33722, "ZBarcode_Init_Memory(ZINT_INIT_RS) ret %d != 33722\n", ret);
+    ret = ZBarcode_Init_Memory(0);
+    assert_zero(ret, "ZBarcode_Init_Memory(0) ret %d != 0\n", ret);
+
+    ret = ZBarcode_Init(ZINT_INIT_ALL);
+    assert_zero(ret, "ZBarcode_Init(ZINT_INIT_ALL) ret %d != 0\n", ret);
+    ret = ZBarcode_Init(0); /* No-op */
+    assert_zero(ret, "ZBarcode_Init(0) ret %d != 0\n", ret);
+
+    ret = ZBarcode_Init(ZINT_INIT_ALL + 1);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Init(invalid) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+    ret = ZBarcode_Init_Memory(ZINT_INIT_ALL + 1);
+    assert_equal(ret, -1, "ZBarcode_Init_Memory(invalid) ret %d != -1\n", ret);
+
+    testFinish();
+}
+
 STATIC_UNLESS_ZINT_TEST int error_tag(char error_string[100], int error_number);
 
 static void test_error_tag(int index) {
@@ -558,7 +706,7 @@ static void test_error_tag(int index) {
     testFinish();
 }
 
-STATIC_UNLESS_ZINT_TEST void strip_bom(unsigned char *source, int *input_length);
+STATIC_UNLESS_ZINT_TEST int bom_length(const unsigned char *source, const int length);
 
 static void test_strip_bom(void) {
 
@@ -566,25 +714,1974 @@ static void test_strip_bom(void) {
 
     int ret;
     char data[] = "\357\273\277A"; // U+FEFF BOM, with "A"
-    int length;
-    char buf[6];
 
-    strcpy(buf, data);
-    length = (int) strlen(buf);
-    strip_bom((unsigned char *) buf, &length);
-    assert_equal(length, 1, "length %d != 1\n", length);
-    assert_zero(buf[1], "buf[1] %d != 0\n", buf[1]);
+    ret = bom_length((unsigned char *) data, (int) strlen(data));
+    assert_equal(ret, 3, "bom_length %d != 3\n", ret);
 
     // BOM not stripped if only data
 
     char bom_only[] = "\357\273\277"; // U+FEFF BOM only
 
-    strcpy(buf, bom_only);
-    length = (int) strlen(buf);
-    strip_bom((unsigned char *) buf, &length);
-    assert_equal(length, 3, "BOM only length %d != 3\n", length);
-    ret = strcmp(buf, bom_only);
-    assert_zero(ret, "BOM only strcmp ret %d != 0\n", ret);
+    ret = bom_length((unsigned char *) bom_only, (int) strlen(bom_only));
+    assert_zero(ret, "BOM only bom_length %d != 0\n", ret);
+
+    // Or if not at start
+
+    char not_start[] = "A\357\273\277B";
+
+    ret = bom_length((unsigned char *) not_start, (int) strlen(not_start));
+    assert_zero(ret, "Not at start bom_length %d != 0\n", ret);
+
+    testFinish();
+}
+
+/* Check input is passed through unmodified and not relied on to be NUL-terminated */
+static void test_input_unmodified(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        char *data;
+        int ret;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, UNICODE_MODE, "1234ABCé", 0 },
+        /*  1*/ { BARCODE_QRCODE, DATA_MODE, "\357\273\2771234", 0 },
+        /*  2*/ { BARCODE_QRCODE, UNICODE_MODE, "\357\273\2771234", 0 }, /* BOM stripped */
+        /*  3*/ { BARCODE_QRCODE, UNICODE_MODE | ESCAPE_MODE, "12\\x41\\t4", 0 },
+        /*  4*/ { BARCODE_QRCODE, GS1_MODE, "[01]12345678901231[10]AB", 0 },
+        /*  5*/ { BARCODE_DATAMATRIX, DATA_MODE, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", 0 },
+        /*  6*/ { BARCODE_DATAMATRIX, UNICODE_MODE, "Ж", ZINT_WARN_USES_ECI },
+        /*  7*/ { BARCODE_AZTEC, DATA_MODE, "1234", 0 },
+        /*  8*/ { BARCODE_CODE128, DATA_MODE, "abc123", 0 },
+        /*  9*/ { BARCODE_CODE39, UNICODE_MODE, "abc123", 0 }, /* Up-cased by encoder, so copied */
+        /* 10*/ { BARCODE_EANX, UNICODE_MODE, "123456789012", 0 }, /* Check digit added by encoder, so copied */
+        /* 11*/ { BARCODE_GS1_128, GS1_MODE, "[01]12345678901231", 0 },
+        /* 12*/ { BARCODE_HANXIN, UNICODE_MODE, "1234é", 0 },
+        /* 13*/ { BARCODE_DOTCODE, GS1_MODE, "[01]12345678901231", 0 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+        unsigned char buf[64], terminated[64];
+        char dump[4096], dump2[4096];
+
+        if (index != -1 && i != index) continue;
+
+        int length = (int) strlen(data[i].data);
+        memset(buf, 'X', sizeof(buf)); /* Not NUL-terminated */
+        memcpy(buf, data[i].data, length);
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+        (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+
+        ret = ZBarcode_Encode(symbol, buf, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        assert_zero(memcmp(buf, data[i].data, length), "i:%d input modified\n", i);
+        assert_equal(buf[length], 'X', "i:%d buf[length] 0x%02X != 'X'\n", i, buf[length]);
+
+        struct zint_symbol *symbol2 = ZBarcode_Create();
+        assert_nonnull(symbol2, "Symbol not created\n");
+        (void) testUtilSetSymbol(symbol2, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        strcpy((char *) terminated, data[i].data);
+
+        ret = ZBarcode_Encode(symbol2, terminated, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode terminated ret %d != %d (%s)\n", i, ret, data[i].ret, symbol2->errtxt);
+        assert_zero(strcmp((char *) symbol->text, (char *) symbol2->text), "i:%d text %s != %s\n", i, symbol->text, symbol2->text);
+        testUtilModulesDump(symbol, dump, sizeof(dump));
+        testUtilModulesDump(symbol2, dump2, sizeof(dump2));
+        assert_zero(strcmp(dump, dump2), "i:%d dumps differ\n", i);
+
+        ZBarcode_Delete(symbol2);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+struct batch_context {
+    int calls;
+    int stop_at; /* Return non-zero at this index if >= 0 */
+    char dumps[4][4096];
+};
+
+static int batch_func(void *context, struct zint_symbol *symbol, int index, int error_number) {
+    struct batch_context *bc = (struct batch_context *) context;
+
+    bc->calls++;
+    if (error_number < ZINT_ERROR) {
+        testUtilModulesDump(symbol, bc->dumps[index], sizeof(bc->dumps[index]));
+    } else {
+        bc->dumps[index][0] = '\0';
+    }
+    return index == bc->stop_at;
+}
+
+static void test_encode_batch(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int eci;
+        int option_2;
+        int warn_level;
+        char *data[4];
+        int stop_at;
+        int ret;
+        char *expected_errtxt;
+        int expected_calls;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, -1, -1, -1, { "1234", "AIM", "A", "12345678901234567890" }, -1, 0, "", 4 },
+        /*  1*/ { BARCODE_EANX, -1, -1, -1, -1, { "123456789012", "A", "1234567", "12345678901234" }, -1, ZINT_ERROR_INVALID_DATA, "", 4 },
+        /*  2*/ { BARCODE_QRCODE, UNICODE_MODE, -1, -1, -1, { "1234", "é", "Ж", "\200" }, -1, ZINT_ERROR_INVALID_DATA, "", 4 }, /* ECI auto-selected per item */
+        /*  3*/ { BARCODE_QRCODE, UNICODE_MODE, -1, 1, -1, { "1234", "abcdefghijklmnopqrstuvwxyz", "12345678901234567890", "1" }, -1, ZINT_ERROR_TOO_LONG, "", 4 }, /* Version fixed */
+        /*  4*/ { BARCODE_DATAMATRIX, -1, -1, -1, -1, { "1234", "", "ABC", "1" }, 1, ZINT_ERROR_INVALID_DATA, "", 2 },
+        /*  5*/ { 0, -1, -1, -1, -1, { "1234", "1", "12", "123" }, -1, ZINT_WARN_INVALID_OPTION, "", 4 },
+        /*  6*/ { 0, -1, -1, -1, WARN_FAIL_ALL, { "1234", "1", "12", "123" }, -1, ZINT_ERROR_INVALID_OPTION, "Error 206: Symbology out of range", 0 },
+        /*  7*/ { BARCODE_CODE128, -1, 3, -1, -1, { "1234", "1", "12", "123" }, -1, ZINT_ERROR_INVALID_OPTION, "Error 217: Symbology does not support ECI switching", 0 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+        struct zint_batch_item items[4];
+        struct batch_context bc;
+        int items_size = ARRAY_SIZE(items);
+        int j;
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, data[i].eci, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data[i].data[0], -1, debug);
+        if (data[i].warn_level != -1) {
+            symbol->warn_level = data[i].warn_level;
+        }
+
+        memset(items, 0, sizeof(items));
+        for (j = 0; j < items_size; j++) {
+            items[j].source = (const unsigned char *) data[i].data[j];
+            items[j].error_number = -1;
+        }
+        memset(&bc, 0, sizeof(bc));
+        bc.stop_at = data[i].stop_at;
+
+        ret = ZBarcode_Encode_Batch(symbol, items, items_size, batch_func, &bc);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode_Batch ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        assert_equal(bc.calls, data[i].expected_calls, "i:%d bc.calls %d != %d\n", i, bc.calls, data[i].expected_calls);
+        if (data[i].expected_calls == 0) {
+            assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected_errtxt);
+        }
+
+        /* Compare with encoding each individually */
+        for (j = 0; j < bc.calls; j++) {
+            struct zint_symbol *symbol2 = ZBarcode_Create();
+            assert_nonnull(symbol2, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol2, data[i].symbology, data[i].input_mode, data[i].eci, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data[i].data[j], -1, debug);
+            if (data[i].warn_level != -1) {
+                symbol2->warn_level = data[i].warn_level;
+            }
+            ret = ZBarcode_Encode(symbol2, (unsigned char *) data[i].data[j], length);
+            assert_equal(items[j].error_number, ret, "i:%d j:%d items[j].error_number %d != %d\n", i, j, items[j].error_number, ret);
+            assert_zero(strcmp(items[j].errtxt, symbol2->errtxt), "i:%d j:%d strcmp(%s, %s) != 0\n", i, j, items[j].errtxt, symbol2->errtxt);
+            if (ret < ZINT_ERROR) {
+                char dump[4096];
+                testUtilModulesDump(symbol2, dump, sizeof(dump));
+                assert_zero(strcmp(bc.dumps[j], dump), "i:%d j:%d dumps differ\n", i, j);
+            }
+
+            ZBarcode_Delete(symbol2);
+        }
+        for (; j < items_size; j++) {
+            assert_equal(items[j].error_number, -1, "i:%d j:%d items[j].error_number %d != -1\n", i, j, items[j].error_number);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    /* Bad args */
+    {
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        ret = ZBarcode_Encode_Batch(NULL, NULL, 0, NULL, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Encode_Batch(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        ret = ZBarcode_Encode_Batch(symbol, NULL, 1, NULL, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Encode_Batch(items NULL) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+        assert_zero(strcmp(symbol->errtxt, "Error 227: Invalid batch items"), "strcmp(%s) != 0\n", symbol->errtxt);
+        ret = ZBarcode_Encode_Batch(symbol, NULL, 0, NULL, NULL);
+        assert_zero(ret, "ZBarcode_Encode_Batch(count 0) ret %d != 0\n", ret);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+#define TEST_BATCH_FAST_ITEMS 24
+
+struct batch_fast_context {
+    int calls;
+    char dumps[TEST_BATCH_FAST_ITEMS][512];
+    char texts[TEST_BATCH_FAST_ITEMS][128];
+    int rows[TEST_BATCH_FAST_ITEMS];
+    int widths[TEST_BATCH_FAST_ITEMS];
+    int heights[TEST_BATCH_FAST_ITEMS];
+    int row_heights[TEST_BATCH_FAST_ITEMS];
+    int output_options[TEST_BATCH_FAST_ITEMS];
+    int border_widths[TEST_BATCH_FAST_ITEMS];
+};
+
+static int batch_fast_func(void *context, struct zint_symbol *symbol, int index, int error_number) {
+    struct batch_fast_context *bc = (struct batch_fast_context *) context;
+
+    bc->calls++;
+    bc->dumps[index][0] = '\0';
+    if (error_number < ZINT_ERROR) {
+        testUtilModulesDump(symbol, bc->dumps[index], sizeof(bc->dumps[index]));
+    }
+    strcpy(bc->texts[index], (const char *) symbol->text);
+    bc->rows[index] = symbol->rows;
+    bc->widths[index] = symbol->width;
+    bc->heights[index] = symbol->height;
+    bc->row_heights[index] = symbol->row_height[0];
+    bc->output_options[index] = symbol->output_options;
+    bc->border_widths[index] = symbol->border_width;
+    return 0;
+}
+
+/* Fixed-length fast path of EAN-13, UPC-A and ITF-14, checking every item against encoding it individually */
+static void test_encode_batch_fast(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int output_options;
+        int option_2;
+        int show_hrt;
+        char *data[TEST_BATCH_FAST_ITEMS];
+        int ret;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_EANX, -1, -1, -1, -1, { "945807302157", "368193036426", "212997220033", "224538323640", "562241549909", "514547527720", "405608656907", "029313758584", "719540613589", "525481454212", "472019860395", "476200753292", "612652064279", "287757447621", "682752174888", "515904584744", "529078454748", "554565275582", "9458073021575", "3681930364264", "2129972200336", "12345678901A", "12345", "2245383236402" }, ZINT_ERROR_INVALID_CHECK },
+        /*  1*/ { BARCODE_EANX_CHK, -1, -1, -1, -1, { "9458073021575", "3681930364263", "2129972200331", "2245383236402", "945807302157", "368193036426", "A129972200336" }, ZINT_ERROR_INVALID_CHECK },
+        /*  2*/ { BARCODE_EANX, UNICODE_MODE | ESCAPE_MODE, -1, -1, 0, { "945807302157", "368193036426", "9458073021575", "3681930364263" }, 0 },
+        /*  3*/ { BARCODE_UPCA, -1, -1, -1, -1, { "82357416299", "86498403297", "92320732021", "52738067569", "19335056461", "85089414885", "94526698572", "29697329150", "61599825966", "63747662994", "47460547427", "01973402607", "88437037424", "47978910244", "85948075592", "00487183066", "99767634714", "06947422787", "823574162994", "864984032973", "923207320217", "527380675692" }, ZINT_ERROR_INVALID_CHECK },
+        /*  4*/ { BARCODE_UPCA_CHK, -1, -1, -1, -1, { "823574162994", "864984032972", "92320732021", "527380675691" }, ZINT_ERROR_INVALID_CHECK },
+        /*  5*/ { BARCODE_ITF14, -1, -1, -1, -1, { "5826980134110", "5616701139124", "7229262193081", "6140991692061", "5977550242984", "8893418344823", "5762205190118", "9736775180860", "2631173296534", "5956625465809", "9326110023307", "7506749657713", "2215672841424", "3070555007721", "5473203093196", "5427541723230", "9640707620088", "9511371703076", "1", "2", "12345", "12345678901234", "123456789012A", "5826980134110" }, ZINT_ERROR_INVALID_DATA },
+        /*  6*/ { BARCODE_ITF14, -1, BARCODE_BIND, -1, 0, { "5826980134110", "5616701139124", "123", "7229262193081" }, 0 },
+        /*  7*/ { BARCODE_ITF14, DATA_MODE, BARCODE_NO_HRT, -1, -1, { "5826980134110", "5616701139124", "7229262193081" }, 0 },
+        /*  8*/ { BARCODE_ITF14, -1, -1, 1, -1, { "5826980134110", "5616701139124", "7229262193081" }, 0 }, /* Check digit option not fast path */
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+        struct zint_batch_item items[TEST_BATCH_FAST_ITEMS];
+        struct batch_fast_context bc;
+        int items_size;
+        int j;
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, data[i].output_options, data[i].data[0], -1, debug);
+        if (data[i].show_hrt != -1) {
+            symbol->show_hrt = data[i].show_hrt;
+        }
+
+        memset(items, 0, sizeof(items));
+        for (items_size = 0; items_size < TEST_BATCH_FAST_ITEMS && data[i].data[items_size]; items_size++) {
+            items[items_size].source = (const unsigned char *) data[i].data[items_size];
+        }
+        memset(&bc, 0, sizeof(bc));
+
+        ret = ZBarcode_Encode_Batch(symbol, items, items_size, batch_fast_func, &bc);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode_Batch ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        assert_equal(bc.calls, items_size, "i:%d bc.calls %d != %d\n", i, bc.calls, items_size);
+
+        for (j = 0; j < items_size; j++) {
+            struct zint_symbol *symbol2 = ZBarcode_Create();
+            assert_nonnull(symbol2, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol2, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, data[i].output_options, data[i].data[j], -1, debug);
+            if (data[i].show_hrt != -1) {
+                symbol2->show_hrt = data[i].show_hrt;
+            }
+            ret = ZBarcode_Encode(symbol2, (unsigned char *) data[i].data[j], length);
+            assert_equal(items[j].error_number, ret, "i:%d j:%d items[j].error_number %d != %d\n", i, j, items[j].error_number, ret);
+            assert_zero(strcmp(items[j].errtxt, symbol2->errtxt), "i:%d j:%d strcmp(%s, %s) != 0\n", i, j, items[j].errtxt, symbol2->errtxt);
+            if (ret < ZINT_ERROR) {
+                char dump[512];
+                testUtilModulesDump(symbol2, dump, sizeof(dump));
+                assert_zero(strcmp(bc.dumps[j], dump), "i:%d j:%d dumps differ\n  %s\n  %s\n", i, j, bc.dumps[j], dump);
+                assert_zero(strcmp(bc.texts[j], (const char *) symbol2->text), "i:%d j:%d text %s != %s\n", i, j, bc.texts[j], symbol2->text);
+                assert_equal(bc.rows[j], symbol2->rows, "i:%d j:%d rows %d != %d\n", i, j, bc.rows[j], symbol2->rows);
+                assert_equal(bc.widths[j], symbol2->width, "i:%d j:%d width %d != %d\n", i, j, bc.widths[j], symbol2->width);
+                assert_equal(bc.heights[j], symbol2->height, "i:%d j:%d height %d != %d\n", i, j, bc.heights[j], symbol2->height);
+                assert_equal(bc.row_heights[j], symbol2->row_height[0], "i:%d j:%d row_height[0] %d != %d\n", i, j, bc.row_heights[j], symbol2->row_height[0]);
+                assert_equal(bc.output_options[j], symbol2->output_options, "i:%d j:%d output_options 0x%X != 0x%X\n", i, j, bc.output_options[j], symbol2->output_options);
+                assert_equal(bc.border_widths[j], symbol2->border_width, "i:%d j:%d border_width %d != %d\n", i, j, bc.border_widths[j], symbol2->border_width);
+            }
+
+            ZBarcode_Delete(symbol2);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_encode_sequence(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int eci;
+        char *prefix;
+        char *suffix;
+        long start;
+        long step;
+        int width;
+        char pad;
+        int check_digit;
+        int count;
+        int stop_at;
+        int ret;
+        char *expected_errtxt;
+        char *expected[4];
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_DATAMATRIX, -1, -1, "SN", NULL, 998, 1, 8, '\0', SEQUENCE_CHECK_NONE, 4, -1, 0, "", { "SN00000998", "SN00000999", "SN00001000", "SN00001001" } },
+        /*  1*/ { BARCODE_DATAMATRIX, GS1_MODE, -1, "[00]0950110153", NULL, 1, 1, 7, '\0', SEQUENCE_CHECK_GS1, 3, -1, 0, "", { "[00]095011015300000010", "[00]095011015300000027", "[00]095011015300000034", "" } }, /* SSCC */
+        /*  2*/ { BARCODE_CODE128, -1, -1, "7", "X", 9927398, 1, 0, '\0', SEQUENCE_CHECK_LUHN, 2, -1, 0, "", { "799273982X", "799273990X", "", "" } },
+        /*  3*/ { BARCODE_CODE128, -1, -1, "A", "Z", 10, -5, 3, ' ', SEQUENCE_CHECK_NONE, 3, -1, 0, "", { "A 10Z", "A  5Z", "A  0Z", "" } },
+        /*  4*/ { BARCODE_QRCODE, -1, -1, "LOT1-", NULL, 1234567890, 0, 0, '\0', SEQUENCE_CHECK_NONE, 2, -1, 0, "", { "LOT1-1234567890", "LOT1-1234567890", "", "" } },
+        /*  5*/ { BARCODE_DATAMATRIX, -1, -1, "SN", NULL, 1, 1, 0, '\0', SEQUENCE_CHECK_NONE, 4, 1, 0, "", { "SN1", "SN2", "", "" } },
+        /*  6*/ { BARCODE_EANX, -1, -1, "12345678901", NULL, 8, 1, 1, '\0', SEQUENCE_CHECK_NONE, 3, -1, ZINT_ERROR_INVALID_CHECK, "", { "123456789018", "123456789019", "1234567890110", "" } },
+        /*  7*/ { BARCODE_DATAMATRIX, -1, -1, NULL, NULL, 0, 1, 21, '\0', SEQUENCE_CHECK_NONE, 1, -1, ZINT_ERROR_INVALID_OPTION, "Error 726: Sequence counter width out of range (0 to 20)", { "", "", "", "" } },
+        /*  8*/ { BARCODE_DATAMATRIX, -1, -1, NULL, NULL, 0, 1, 0, '\0', 3, 1, -1, ZINT_ERROR_INVALID_OPTION, "Error 727: Invalid sequence check digit type", { "", "", "", "" } },
+        /*  9*/ { BARCODE_DATAMATRIX, -1, -1, NULL, NULL, -1, 1, 0, '\0', SEQUENCE_CHECK_NONE, 1, -1, ZINT_ERROR_INVALID_OPTION, "Error 728: Sequence counter out of range", { "", "", "", "" } },
+        /* 10*/ { BARCODE_DATAMATRIX, -1, -1, NULL, NULL, 1, -1, 0, '\0', SEQUENCE_CHECK_NONE, 3, -1, ZINT_ERROR_INVALID_OPTION, "Error 728: Sequence counter out of range", { "", "", "", "" } },
+        /* 11*/ { BARCODE_DATAMATRIX, -1, -1, NULL, NULL, LONG_MAX - 1, 1, 0, '\0', SEQUENCE_CHECK_NONE, 3, -1, ZINT_ERROR_INVALID_OPTION, "Error 728: Sequence counter out of range", { "", "", "", "" } },
+        /* 12*/ { BARCODE_CODE128, -1, 3, NULL, NULL, 1, 1, 0, '\0', SEQUENCE_CHECK_NONE, 1, -1, ZINT_ERROR_INVALID_OPTION, "Error 217: Symbology does not support ECI switching", { "", "", "", "" } },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+        struct zint_sequence sequence;
+        struct batch_context bc;
+        int expected_calls;
+        int j;
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, data[i].eci, -1 /*option_1*/, -1, -1, -1 /*output_options*/, "1", -1, debug);
+
+        memset(&sequence, 0, sizeof(sequence));
+        sequence.prefix = data[i].prefix;
+        sequence.suffix = data[i].suffix;
+        sequence.start = data[i].start;
+        sequence.step = data[i].step;
+        sequence.width = data[i].width;
+        sequence.pad = data[i].pad;
+        sequence.check_digit = data[i].check_digit;
+        memset(&bc, 0, sizeof(bc));
+        bc.stop_at = data[i].stop_at;
+
+        ret = ZBarcode_Encode_Sequence(symbol, &sequence, data[i].count, batch_func, &bc);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode_Sequence ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        expected_calls = data[i].expected_errtxt[0] ? 0 : data[i].stop_at != -1 ? data[i].stop_at + 1 : data[i].count;
+        assert_equal(bc.calls, expected_calls, "i:%d bc.calls %d != %d\n", i, bc.calls, expected_calls);
+        if (expected_calls == 0) {
+            assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected_errtxt);
+        }
+
+        /* Compare with encoding the expected data individually */
+        for (j = 0; j < bc.calls; j++) {
+            struct zint_symbol *symbol2 = ZBarcode_Create();
+            assert_nonnull(symbol2, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol2, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].expected[j], -1, debug);
+            ret = ZBarcode_Encode(symbol2, (unsigned char *) data[i].expected[j], length);
+            if (ret < ZINT_ERROR) {
+                char dump[4096];
+                testUtilModulesDump(symbol2, dump, sizeof(dump));
+                assert_zero(strcmp(bc.dumps[j], dump), "i:%d j:%d dumps differ (%s)\n", i, j, data[i].expected[j]);
+            } else {
+                assert_zero(bc.dumps[j][0], "i:%d j:%d dump set for error %d\n", i, j, ret);
+            }
+
+            ZBarcode_Delete(symbol2);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    /* Bad args */
+    {
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        ret = ZBarcode_Encode_Sequence(NULL, NULL, 0, NULL, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Encode_Sequence(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        ret = ZBarcode_Encode_Sequence(symbol, NULL, 1, NULL, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Encode_Sequence(sequence NULL) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+        assert_zero(strcmp(symbol->errtxt, "Error 725: Invalid sequence"), "strcmp(%s) != 0\n", symbol->errtxt);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_encode_structapp(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        char *id;
+        char *pattern;
+        int repeat;
+        int ret;
+        int expected_count;
+        char *expected_id;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, -1, "", "1234567890", 1, 0, 1, "", "" }, /* Fits so no Structured Append */
+        /*  1*/ { BARCODE_QRCODE, -1, "", "ABCDEFGHIJ", 500, 0, 2, "0", "" }, /* Parity of whole, even repeat so 0 */
+        /*  2*/ { BARCODE_QRCODE, -1, "", "ABCDEFGHIJK", 401, 0, 2, "64", "" }, /* Odd repeat so parity of "ABCDEFGHIJK" 0x40 */
+        /*  3*/ { BARCODE_QRCODE, -1, "99", "1234567890", 1500, 0, 3, "99", "" },
+        /*  4*/ { BARCODE_DATAMATRIX, UNICODE_MODE, "", "é", 2000, 0, 2, "", "" }, /* UTF-8 not split */
+        /*  5*/ { BARCODE_DATAMATRIX, DATA_MODE, "", "\351", 4000, 0, 3, "", "" },
+        /*  6*/ { BARCODE_AZTEC, UNICODE_MODE, "ZINT", "Aé", 1500, 0, 2, "ZINT", "" },
+        /*  7*/ { BARCODE_MAXICODE, -1, "", "ABCD", 100, 0, 5, "", "" },
+        /*  8*/ { BARCODE_MAXICODE, -1, "", "ABCD", 300, ZINT_ERROR_TOO_LONG, 0, "", "Error 705: Input too long for Structured Append sequence (maximum 8 symbols)" },
+        /*  9*/ { BARCODE_QRCODE, DATA_MODE, "", "\001", 3000, 0, 2, "0", "" },
+        /* 10*/ { BARCODE_CODE128, -1, "", "1234", 1, ZINT_ERROR_INVALID_OPTION, 0, "", "Error 703: Symbology does not support Structured Append" },
+        /* 11*/ { BARCODE_QRCODE, GS1_MODE, "", "[01]12345678901231", 1, ZINT_ERROR_INVALID_OPTION, 0, "", "Error 702: Cannot split input for Structured Append in GS1 or escape mode" },
+        /* 12*/ { BARCODE_QRCODE, UNICODE_MODE | ESCAPE_MODE, "", "1234", 1, ZINT_ERROR_INVALID_OPTION, 0, "", "Error 702: Cannot split input for Structured Append in GS1 or escape mode" },
+        /* 13*/ { BARCODE_QRCODE, UNICODE_MODE, "", "\200", 1, ZINT_ERROR_INVALID_DATA, 0, "", "Error 245: Invalid UTF-8" },
+        /* 14*/ { BARCODE_MAXICODE, -1, "1", "ABCD", 100, ZINT_ERROR_INVALID_OPTION, 0, "", "Error 742: Structured Append ID not available for MaxiCode" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    static unsigned char buf[ZINT_MAX_DATA_LEN + 1];
+
+    for (int i = 0; i < data_size; i++) {
+        struct zint_symbol **symbols[2] = { NULL, NULL };
+        int counts[2] = { -1, -1 };
+        int length = 0;
+        int t, j, r;
+
+        if (index != -1 && i != index) continue;
+
+        for (j = 0; j < data[i].repeat; j++) {
+            strcpy((char *) buf + length, data[i].pattern);
+            length += (int) strlen(data[i].pattern);
+        }
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, (char *) buf, length, debug);
+        strcpy(symbol->structapp.id, data[i].id);
+
+        /* Serially then on 4 threads, which should give the same symbols */
+        for (t = 0; t < 2; t++) {
+            ret = ZBarcode_Encode_Structapp(symbol, buf, length, t ? 4 : 1, &symbols[t], &counts[t]);
+            assert_equal(ret, data[i].ret, "i:%d t:%d ZBarcode_Encode_Structapp ret %d != %d (%s)\n", i, t, ret, data[i].ret, symbol->errtxt);
+            assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d t:%d strcmp(%s, %s) != 0\n", i, t, symbol->errtxt, data[i].expected_errtxt);
+            assert_equal(counts[t], data[i].expected_count, "i:%d t:%d count %d != %d\n", i, t, counts[t], data[i].expected_count);
+            if (ret >= ZINT_ERROR) {
+                assert_null(symbols[t], "i:%d t:%d symbols non-NULL\n", i, t);
+            }
+        }
+        /* Template unchanged */
+        assert_zero(symbol->structapp.count, "i:%d symbol->structapp.count %d != 0\n", i, symbol->structapp.count);
+        assert_zero(strcmp(symbol->structapp.id, data[i].id), "i:%d symbol->structapp.id %s != %s\n", i, symbol->structapp.id, data[i].id);
+
+        for (j = 0; j < counts[0]; j++) {
+            const struct zint_symbol *s0 = symbols[0][j], *s1 = symbols[1][j];
+            if (counts[0] == 1) {
+                assert_zero(s0->structapp.count, "i:%d structapp.count %d != 0\n", i, s0->structapp.count);
+            } else {
+                assert_equal(s0->structapp.index, j + 1, "i:%d j:%d structapp.index %d != %d\n", i, j, s0->structapp.index, j + 1);
+                assert_equal(s0->structapp.count, counts[0], "i:%d j:%d structapp.count %d != %d\n", i, j, s0->structapp.count, counts[0]);
+                assert_zero(strcmp(s0->structapp.id, data[i].expected_id), "i:%d j:%d structapp.id %s != %s\n", i, j, s0->structapp.id, data[i].expected_id);
+            }
+            assert_equal(s0->rows, s1->rows, "i:%d j:%d rows %d != %d\n", i, j, s0->rows, s1->rows);
+            assert_equal(s0->width, s1->width, "i:%d j:%d width %d != %d\n", i, j, s0->width, s1->width);
+            for (r = 0; r < s0->rows; r++) {
+                assert_zero(memcmp(s0->internal->encoded_data[r], s1->internal->encoded_data[r], sizeof(s0->internal->encoded_data[r])), "i:%d j:%d row %d encoded_data differ\n", i, j, r);
+            }
+        }
+
+        ZBarcode_Structapp_Delete(symbols[0], counts[0]);
+        ZBarcode_Structapp_Delete(symbols[1], counts[1]);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+struct executor_calls {
+    int calls;
+    int tasks;
+    int max_threads;
+    int decline;
+};
+
+/* Executor for `ZBarcode_SetExecutor()` that records its calls and runs the tasks backwards on the calling thread
+   (or declines if `decline` set) */
+static int record_executor(void *context, void (*task_fn)(void *arg, int index), void *arg, int count,
+            int max_threads) {
+    struct executor_calls *calls = (struct executor_calls *) context;
+    calls->calls++;
+    calls->max_threads = max_threads;
+    if (calls->decline) {
+        return 1;
+    }
+    for (int i = count - 1; i >= 0; i--) {
+        (*task_fn)(arg, i);
+        calls->tasks++;
+    }
+    return 0;
+}
+
+static void test_executor(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        char *pattern;
+        int repeat;
+        int threads;
+        int decline;
+        int expected_count;
+        int expected_calls;
+        int expected_max_threads;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, "1234567890", 1500, 4, 0, 3, 1, 3 }, /* Limited to count */
+        /*  1*/ { BARCODE_QRCODE, "1234567890", 1500, 2, 0, 3, 1, 2 },
+        /*  2*/ { BARCODE_QRCODE, "1234567890", 1500, 1, 0, 3, 0, 0 }, /* Serial so not called */
+        /*  3*/ { BARCODE_QRCODE, "1234567890", 1500, 4, 1, 3, 1, 3 }, /* Declined so serial */
+        /*  4*/ { BARCODE_MAXICODE, "ABCD", 100, 8, 0, 5, 1, 5 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    static unsigned char buf[ZINT_MAX_DATA_LEN + 1];
+
+    for (int i = 0; i < data_size; i++) {
+        struct zint_symbol **symbols[2] = { NULL, NULL };
+        int counts[2] = { -1, -1 };
+        struct executor_calls calls = {0};
+        int length = 0;
+        int t, j, r;
+
+        if (index != -1 && i != index) continue;
+
+        for (j = 0; j < data[i].repeat; j++) {
+            strcpy((char *) buf + length, data[i].pattern);
+            length += (int) strlen(data[i].pattern);
+        }
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        (void) testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, (char *) buf, length, debug);
+
+        /* With built-in executor then the recording one, which should give the same symbols */
+        calls.decline = data[i].decline;
+        for (t = 0; t < 2; t++) {
+            if (t) {
+                ret = ZBarcode_SetExecutor(symbol, record_executor, &calls);
+                assert_zero(ret, "i:%d ZBarcode_SetExecutor ret %d != 0\n", i, ret);
+            }
+            ret = ZBarcode_Encode_Structapp(symbol, buf, length, data[i].threads, &symbols[t], &counts[t]);
+            assert_zero(ret, "i:%d t:%d ZBarcode_Encode_Structapp ret %d != 0 (%s)\n", i, t, ret, symbol->errtxt);
+            assert_equal(counts[t], data[i].expected_count, "i:%d t:%d count %d != %d\n", i, t, counts[t], data[i].expected_count);
+        }
+        assert_equal(calls.calls, data[i].expected_calls, "i:%d calls %d != %d\n", i, calls.calls, data[i].expected_calls);
+        assert_equal(calls.max_threads, data[i].expected_max_threads, "i:%d max_threads %d != %d\n", i, calls.max_threads, data[i].expected_max_threads);
+        assert_equal(calls.tasks, data[i].expected_calls && !data[i].decline ? data[i].expected_count : 0, "i:%d tasks %d != %d\n", i, calls.tasks, data[i].expected_calls && !data[i].decline ? data[i].expected_count : 0);
+
+        for (j = 0; j < counts[0]; j++) {
+            const struct zint_symbol *s0 = symbols[0][j], *s1 = symbols[1][j];
+            assert_equal(s1->structapp.index, j + 1, "i:%d j:%d structapp.index %d != %d\n", i, j, s1->structapp.index, j + 1);
+            assert_equal(s0->rows, s1->rows, "i:%d j:%d rows %d != %d\n", i, j, s0->rows, s1->rows);
+            assert_equal(s0->width, s1->width, "i:%d j:%d width %d != %d\n", i, j, s0->width, s1->width);
+            for (r = 0; r < s0->rows; r++) {
+                assert_zero(memcmp(s0->internal->encoded_data[r], s1->internal->encoded_data[r], sizeof(s0->internal->encoded_data[r])), "i:%d j:%d row %d encoded_data differ\n", i, j, r);
+            }
+        }
+
+        /* The executor belongs to the symbol, so others keep the built-in one */
+        struct zint_symbol *other = ZBarcode_Create();
+        assert_nonnull(other, "Other symbol not created\n");
+        (void) testUtilSetSymbol(other, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, (char *) buf, length, debug);
+        struct zint_symbol **other_symbols = NULL;
+        int other_count = -1;
+        ret = ZBarcode_Encode_Structapp(other, buf, length, data[i].threads, &other_symbols, &other_count);
+        assert_zero(ret, "i:%d other ZBarcode_Encode_Structapp ret %d != 0 (%s)\n", i, ret, other->errtxt);
+        assert_equal(calls.calls, data[i].expected_calls, "i:%d other calls %d != %d\n", i, calls.calls, data[i].expected_calls);
+        ZBarcode_Structapp_Delete(other_symbols, other_count);
+        ZBarcode_Delete(other);
+
+        ZBarcode_Structapp_Delete(symbols[0], counts[0]);
+        ZBarcode_Structapp_Delete(symbols[1], counts[1]);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+struct submit_result {
+    volatile int calls;
+    int error_number;
+    char errtxt[100];
+    int sleep_us; /* Slept by `slow_trace()` on starting encoding */
+};
+
+static void submit_callback(void *user_data, struct zint_symbol *symbol, int error_number) {
+    struct submit_result *result = (struct submit_result *) user_data;
+    result->error_number = error_number;
+    strcpy(result->errtxt, symbol->errtxt);
+    result->calls++;
+}
+
+static void slow_trace(void *trace_context, const struct zint_symbol *symbol, int phase, int event, int length) {
+    (void)symbol; (void)length;
+    if (phase == ZINT_PHASE_ENCODE && event == ZINT_TRACE_BEGIN) {
+        usleep(((struct submit_result *) trace_context)->sleep_us);
+    }
+}
+
+static void test_submit(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        char *data;
+        int timeout_ms;
+        int sleep_us;
+        int cancel;
+        int ret;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, "1234", 0, 0, 0, 0, "" },
+        /*  1*/ { BARCODE_QRCODE, "1234", 10000, 0, 0, 0, "" },
+        /*  2*/ { BARCODE_CODE128, "1234", 0, 0, 0, 0, "" },
+        /*  3*/ { BARCODE_EANX, "123A", 0, 0, 0, ZINT_ERROR_INVALID_DATA, "Error 284: Invalid characters in data" },
+        /*  4*/ { BARCODE_QRCODE, "1234", 1, 20000, 0, ZINT_ERROR_CANCELLED, "Error 719: Request deadline exceeded" },
+        /*  5*/ { BARCODE_QRCODE, "1234", 0, 50000, 1, ZINT_ERROR_CANCELLED, "Error 718: Request cancelled" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+        struct submit_result result = {0};
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+        struct zint_symbol *expected = ZBarcode_Create();
+        assert_nonnull(expected, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        (void) testUtilSetSymbol(expected, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, BARCODE_MEMORY_FILE, data[i].data, -1, debug);
+        if (data[i].sleep_us) {
+            result.sleep_us = data[i].sleep_us;
+            symbol->trace_func = slow_trace;
+            symbol->trace_context = &result;
+        }
+
+        struct zint_request *request = ZBarcode_Submit(symbol, (const unsigned char *) data[i].data, length, 0, data[i].timeout_ms, submit_callback, &result);
+        assert_nonnull(request, "i:%d ZBarcode_Submit NULL (%s)\n", i, symbol->errtxt);
+        if (data[i].cancel) {
+            ret = ZBarcode_Cancel(request);
+            assert_zero(ret, "i:%d ZBarcode_Cancel ret %d != 0\n", i, ret);
+        }
+        while (!result.calls) {
+            usleep(1000);
+        }
+        ret = ZBarcode_Cancel(request); /* Too late now */
+        assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "i:%d ZBarcode_Cancel after ret %d != ZINT_ERROR_INVALID_OPTION\n", i, ret);
+        ZBarcode_Request_Delete(request);
+
+        assert_equal(result.calls, 1, "i:%d calls %d != 1\n", i, result.calls);
+        assert_equal(result.error_number, data[i].ret, "i:%d error_number %d != %d (%s)\n", i, result.error_number, data[i].ret, result.errtxt);
+        assert_zero(strcmp(result.errtxt, data[i].expected_errtxt), "i:%d errtxt %s != %s\n", i, result.errtxt, data[i].expected_errtxt);
+
+        if (data[i].ret == 0) {
+            ret = ZBarcode_Encode_and_Print(expected, (unsigned char *) data[i].data, length, 0);
+            assert_zero(ret, "i:%d ZBarcode_Encode_and_Print ret %d != 0\n", i, ret);
+            assert_nonnull(symbol->memfile, "i:%d memfile NULL\n", i);
+            assert_equal(symbol->memfile_size, expected->memfile_size, "i:%d memfile_size %d != %d\n", i, symbol->memfile_size, expected->memfile_size);
+            assert_zero(memcmp(symbol->memfile, expected->memfile, expected->memfile_size), "i:%d memfile differs\n", i);
+        }
+
+        ZBarcode_Delete(expected);
+        ZBarcode_Delete(symbol);
+    }
+
+    /* Invalid requests */
+    struct submit_result result = {0};
+    struct zint_symbol *symbol = ZBarcode_Create();
+    assert_nonnull(symbol, "Symbol not created\n");
+    assert_null(ZBarcode_Submit(NULL, (const unsigned char *) "1", 1, 0, 0, submit_callback, &result), "NULL symbol ZBarcode_Submit non-NULL\n");
+    assert_null(ZBarcode_Submit(symbol, (const unsigned char *) "1", 1, 0, 0, NULL, &result), "NULL callback ZBarcode_Submit non-NULL\n");
+    assert_zero(strcmp(symbol->errtxt, "Error 748: Callback NULL"), "errtxt %s != Error 748: Callback NULL\n", symbol->errtxt);
+    assert_null(ZBarcode_Submit(symbol, NULL, 1, 0, 0, submit_callback, &result), "NULL source ZBarcode_Submit non-NULL\n");
+    assert_zero(strcmp(symbol->errtxt, "Error 200: Input data NULL"), "errtxt %s != Error 200: Input data NULL\n", symbol->errtxt);
+    assert_zero(result.calls, "calls %d != 0\n", result.calls);
+    assert_equal(ZBarcode_Cancel(NULL), ZINT_ERROR_INVALID_DATA, "ZBarcode_Cancel(NULL) != ZINT_ERROR_INVALID_DATA\n");
+    ZBarcode_Request_Delete(NULL);
+    ZBarcode_Delete(symbol);
+
+    testFinish();
+}
+
+static void test_modules(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int option_2;
+        char *data;
+        int expected_row_stride;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_EANX, -1, "123456789012+12", 16 },
+        /*  1*/ { BARCODE_CODE128, -1, "AIM", 9 },
+        /*  2*/ { BARCODE_QRCODE, -1, "1234567890", 3 },
+        /*  3*/ { BARCODE_PDF417, -1, "1234567890", 13 },
+        /*  4*/ { BARCODE_ULTRA, -1, "A", 13 },
+        /*  5*/ { BARCODE_MAXICODE, -1, "1234", 4 },
+        /*  6*/ { BARCODE_HANXIN, 84, "1", 24 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        ret = ZBarcode_Buffer(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        struct zint_modules *modules = ZBarcode_Modules(symbol);
+        assert_nonnull(modules, "i:%d ZBarcode_Modules NULL\n", i);
+        assert_equal(modules->rows, symbol->rows, "i:%d modules->rows %d != %d\n", i, modules->rows, symbol->rows);
+        assert_equal(modules->width, symbol->width, "i:%d modules->width %d != %d\n", i, modules->width, symbol->width);
+        assert_equal(modules->row_stride, data[i].expected_row_stride, "i:%d modules->row_stride %d != %d\n", i, modules->row_stride, data[i].expected_row_stride);
+
+        /* Load into a fresh symbol (with same settings) and compare */
+        struct zint_symbol *symbol2 = ZBarcode_Create();
+        assert_nonnull(symbol2, "Symbol2 not created\n");
+        (void) testUtilSetSymbol(symbol2, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+
+        ret = ZBarcode_Load_Modules(symbol2, modules);
+        assert_zero(ret, "i:%d ZBarcode_Load_Modules ret %d != 0 (%s)\n", i, ret, symbol2->errtxt);
+        assert_zero(memcmp(symbol2->internal->encoded_data, symbol->internal->encoded_data, sizeof(symbol->internal->encoded_data)), "i:%d encoded_data differ\n", i);
+        assert_zero(memcmp(symbol2->row_height, symbol->row_height, sizeof(symbol->row_height)), "i:%d row_height differ\n", i);
+        assert_zero(strcmp((char *) symbol2->text, (char *) symbol->text), "i:%d text %s != %s\n", i, symbol2->text, symbol->text);
+
+        ret = ZBarcode_Buffer(symbol2, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer symbol2 ret %d != 0 (%s)\n", i, ret, symbol2->errtxt);
+        assert_equal(symbol2->bitmap_width, symbol->bitmap_width, "i:%d bitmap_width %d != %d\n", i, symbol2->bitmap_width, symbol->bitmap_width);
+        assert_equal(symbol2->bitmap_height, symbol->bitmap_height, "i:%d bitmap_height %d != %d\n", i, symbol2->bitmap_height, symbol->bitmap_height);
+        assert_zero(memcmp(symbol2->bitmap, symbol->bitmap, symbol->bitmap_width * symbol->bitmap_height * 3), "i:%d bitmaps differ\n", i);
+
+        /* Clear only clears used rows but must leave symbol as new */
+        ZBarcode_Clear(symbol2);
+        for (int j = 0; j < 200; j++) {
+            for (int k = 0; k < 143; k++) {
+                assert_zero(symbol2->internal->encoded_data[j][k], "i:%d encoded_data[%d][%d] %d != 0 after clear\n", i, j, k, symbol2->internal->encoded_data[j][k]);
+            }
+        }
+
+        assert_null(modules->run_offset, "i:%d modules->run_offset non-NULL\n", i);
+        assert_null(modules->runs, "i:%d modules->runs non-NULL\n", i);
+
+        /* Export gives same data plus run-lengths (except for Ultracode) which must expand back to the modules */
+        struct zint_modules *exported = ZBarcode_Export_Modules(symbol);
+        assert_nonnull(exported, "i:%d ZBarcode_Export_Modules NULL\n", i);
+        assert_equal(exported->row_stride, modules->row_stride, "i:%d exported->row_stride %d != %d\n", i, exported->row_stride, modules->row_stride);
+        assert_zero(memcmp(exported->data, modules->data, modules->row_stride * modules->rows), "i:%d exported data differ\n", i);
+        assert_zero(memcmp(exported->row_height, modules->row_height, sizeof(int) * modules->rows), "i:%d exported row_height differ\n", i);
+        assert_zero(strcmp((char *) exported->text, (char *) modules->text), "i:%d exported text %s != %s\n", i, exported->text, modules->text);
+        if (data[i].symbology == BARCODE_ULTRA) {
+            assert_null(exported->runs, "i:%d exported->runs non-NULL\n", i);
+        } else {
+            assert_nonnull(exported->run_offset, "i:%d exported->run_offset NULL\n", i);
+            assert_nonnull(exported->runs, "i:%d exported->runs NULL\n", i);
+            for (int r = 0; r < exported->rows; r++) {
+                int x = 0;
+                for (int j = exported->run_offset[r]; j < exported->run_offset[r + 1]; j++) {
+                    int bar = (j - exported->run_offset[r]) & 1;
+                    assert_nonzero(exported->runs[j] > 0 || j == exported->run_offset[r], "i:%d row %d run %d zero length (only allowed first)\n", i, r, j);
+                    for (int k = 0; k < exported->runs[j]; k++, x++) {
+                        assert_equal(module_is_set(symbol, r, x), bar, "i:%d row %d module %d %d != %d\n", i, r, x, module_is_set(symbol, r, x), bar);
+                    }
+                }
+                assert_equal(x, exported->width, "i:%d row %d runs total %d != width %d\n", i, r, x, exported->width);
+            }
+        }
+        ZBarcode_Modules_Delete(exported);
+
+        ZBarcode_Modules_Delete(modules);
+        ZBarcode_Delete(symbol2);
+        ZBarcode_Delete(symbol);
+    }
+
+    /* Bad args */
+    {
+        struct zint_symbol *symbol = ZBarcode_Create();
+        struct zint_modules modules = {0};
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        assert_null(ZBarcode_Modules(NULL), "ZBarcode_Modules(NULL) non-NULL\n");
+        assert_null(ZBarcode_Modules(symbol), "ZBarcode_Modules(unencoded) non-NULL\n");
+        assert_null(ZBarcode_Export_Modules(NULL), "ZBarcode_Export_Modules(NULL) non-NULL\n");
+        assert_null(ZBarcode_Export_Modules(symbol), "ZBarcode_Export_Modules(unencoded) non-NULL\n");
+
+        ret = ZBarcode_Load_Modules(NULL, &modules);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Load_Modules(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        ret = ZBarcode_Load_Modules(symbol, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Load_Modules(symbol, NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        assert_zero(strcmp(symbol->errtxt, "Error 240: Invalid modules"), "strcmp(%s) != 0\n", symbol->errtxt);
+        ret = ZBarcode_Load_Modules(symbol, &modules); /* Zero rows */
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Load_Modules(zero rows) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+
+        ZBarcode_Modules_Delete(NULL); /* No-op */
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+struct alloc_counts {
+    int mallocs;
+    int reallocs;
+    int frees;
+    int outstanding;
+};
+
+static void *count_malloc(void *context, size_t size) {
+    struct alloc_counts *counts = (struct alloc_counts *) context;
+    counts->mallocs++;
+    counts->outstanding++;
+    return malloc(size);
+}
+
+static void *count_realloc(void *context, void *ptr, size_t size) {
+    struct alloc_counts *counts = (struct alloc_counts *) context;
+    counts->reallocs++;
+    if (!ptr) {
+        counts->outstanding++;
+    }
+    return realloc(ptr, size);
+}
+
+static void count_free(void *context, void *ptr) {
+    struct alloc_counts *counts = (struct alloc_counts *) context;
+    counts->frees++;
+    counts->outstanding--;
+    free(ptr);
+}
+
+static void test_allocator(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        char *data;
+        char *outfile;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, "1234", "mem.png" },
+        /*  1*/ { BARCODE_DATAMATRIX, "1234", "mem.svg" },
+        /*  2*/ { BARCODE_MAXICODE, "1234", "mem.emf" },
+        /*  3*/ { BARCODE_HANXIN, "1234", "mem.tif" },
+        /*  4*/ { BARCODE_PLESSEY, "1234", "mem.bmp" },
+        /*  5*/ { BARCODE_ULTRA, "1234", "mem.eps" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct alloc_counts counts;
+    struct zint_allocator allocator = { count_malloc, count_realloc, count_free, &counts };
+    struct zint_allocator no_realloc = { count_malloc, NULL, count_free, &counts };
+    struct zint_allocator no_malloc = { NULL, count_realloc, count_free, &counts };
+
+    assert_null(ZBarcode_Create_Allocator(&no_realloc), "ZBarcode_Create_Allocator no realloc not NULL\n");
+    assert_null(ZBarcode_Create_Allocator(&no_malloc), "ZBarcode_Create_Allocator no malloc not NULL\n");
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        memset(&counts, 0, sizeof(counts));
+
+        struct zint_symbol *symbol = ZBarcode_Create_Allocator(&allocator);
+        assert_nonnull(symbol, "Symbol not created\n");
+        assert_equal(counts.mallocs, 1, "i:%d counts.mallocs %d != 1\n", i, counts.mallocs);
+
+        /* A symbol made with the default allocator doesn't use it */
+        struct zint_symbol *other = ZBarcode_Create();
+        assert_nonnull(other, "Other symbol not created\n");
+        other->symbology = data[i].symbology;
+        ret = ZBarcode_Encode_and_Buffer(other, (unsigned char *) data[i].data, -1, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer(other) ret %d != 0 (%s)\n", i, ret, other->errtxt);
+        ZBarcode_Delete(other);
+        assert_equal(counts.mallocs, 1, "i:%d counts.mallocs %d != 1 after other symbol\n", i, counts.mallocs);
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, BARCODE_MEMORY_FILE /*output_options*/, data[i].data, -1, debug);
+        strcpy(symbol->outfile, data[i].outfile);
+
+        ret = ZBarcode_Encode_and_Print(symbol, (unsigned char *) data[i].data, length, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Print ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_nonnull(symbol->memfile, "i:%d memfile NULL\n", i);
+        ret = ZBarcode_Buffer(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        ret = ZBarcode_Buffer_Vector(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer_Vector ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        /* Copies made from the symbol use its allocator, and may outlive it */
+        struct zint_modules *modules = ZBarcode_Modules(symbol);
+        assert_nonnull(modules, "i:%d ZBarcode_Modules NULL\n", i);
+        unsigned char *buffer;
+        int size;
+        ret = ZBarcode_Serialize(symbol, &buffer, &size);
+        assert_zero(ret, "i:%d ZBarcode_Serialize ret %d != 0\n", i, ret);
+
+        ZBarcode_Delete(symbol);
+
+        assert_nonzero(counts.outstanding >= 2, "i:%d counts.outstanding %d < 2\n", i, counts.outstanding);
+        ZBarcode_Modules_Delete(modules);
+        ZBarcode_Serialize_Delete(buffer);
+
+        assert_nonzero(counts.mallocs > 1, "i:%d counts.mallocs %d <= 1\n", i, counts.mallocs);
+        assert_nonzero(counts.frees > 1, "i:%d counts.frees %d <= 1\n", i, counts.frees);
+        assert_zero(counts.outstanding, "i:%d counts.outstanding %d != 0 (mallocs %d, reallocs %d, frees %d)\n", i, counts.outstanding, counts.mallocs, counts.reallocs, counts.frees);
+    }
+
+    testFinish();
+}
+
+struct alloc_fail {
+    int countdown; /* Allocations to allow before failing, -1 for never */
+    int failed;
+    int outstanding;
+};
+
+static void *fail_malloc(void *context, size_t size) {
+    struct alloc_fail *fail = (struct alloc_fail *) context;
+    if (fail->countdown == 0) {
+        fail->failed = 1;
+        return NULL;
+    }
+    if (fail->countdown > 0) {
+        fail->countdown--;
+    }
+    fail->outstanding++;
+    return malloc(size);
+}
+
+static void *fail_realloc(void *context, void *ptr, size_t size) {
+    struct alloc_fail *fail = (struct alloc_fail *) context;
+    if (fail->countdown == 0) {
+        fail->failed = 1;
+        return NULL;
+    }
+    if (fail->countdown > 0) {
+        fail->countdown--;
+    }
+    if (!ptr) {
+        fail->outstanding++;
+    }
+    return realloc(ptr, size);
+}
+
+static void fail_free(void *context, void *ptr) {
+    struct alloc_fail *fail = (struct alloc_fail *) context;
+    fail->outstanding--;
+    free(ptr);
+}
+
+/* Fail each allocation made by `ZBarcode_Encode()` in turn, checking that ZINT_ERROR_MEMORY is returned and nothing
+   leaked (in ZINT_BOUNDED_STACK builds this includes the encoders' working arrays) */
+static void test_alloc_fail(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, UNICODE_MODE, "1234" },
+        /*  1*/ { BARCODE_QRCODE, UNICODE_MODE, "1234テ" },
+        /*  2*/ { BARCODE_AZTEC, UNICODE_MODE, "1234abcDEF" },
+        /*  3*/ { BARCODE_PDF417, UNICODE_MODE, "1234abcDEF" },
+        /*  4*/ { BARCODE_HANXIN, UNICODE_MODE, "1234汉信" },
+        /*  5*/ { BARCODE_GRIDMATRIX, UNICODE_MODE, "1234汉信" },
+        /*  6*/ { BARCODE_CODEONE, UNICODE_MODE, "1234abcDEF" },
+        /*  7*/ { BARCODE_DOTCODE, UNICODE_MODE, "1234abcDEF" },
+        /*  8*/ { BARCODE_ULTRA, UNICODE_MODE, "1234abcDEF" },
+        /*  9*/ { BARCODE_CODABLOCKF, UNICODE_MODE, "1234abcDEF" },
+        /* 10*/ { BARCODE_DBAR_EXP, GS1_MODE, "[01]12345678901231[10]ABC" },
+        /* 11*/ { BARCODE_MICROQR, UNICODE_MODE, "1234テ" },
+        /* 12*/ { BARCODE_RMQR, UNICODE_MODE, "1234テ" },
+        /* 13*/ { BARCODE_UPNQR, UNICODE_MODE, "1234" },
+        /* 14*/ { BARCODE_MICROPDF417, UNICODE_MODE, "1234abcDEF" },
+        /* 15*/ { BARCODE_MAXICODE, UNICODE_MODE, "1234abcDEF" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct alloc_fail fail;
+    struct zint_allocator allocator = { fail_malloc, fail_realloc, fail_free, &fail };
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        for (int countdown = 0; ; countdown++) {
+            memset(&fail, 0, sizeof(fail));
+            fail.countdown = -1;
+
+            struct zint_symbol *symbol = ZBarcode_Create_Allocator(&allocator);
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+
+            fail.countdown = countdown;
+            ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+            if (fail.failed) {
+                assert_equal(ret, ZINT_ERROR_MEMORY, "i:%d countdown %d ret %d != ZINT_ERROR_MEMORY (%s)\n", i, countdown, ret, symbol->errtxt);
+            } else {
+                assert_zero(ret, "i:%d countdown %d ret %d != 0 (%s)\n", i, countdown, ret, symbol->errtxt);
+            }
+            fail.countdown = -1;
+
+            ZBarcode_Delete(symbol);
+
+            assert_zero(fail.outstanding, "i:%d countdown %d fail.outstanding %d != 0\n", i, countdown, fail.outstanding);
+
+            if (!fail.failed) {
+                break;
+            }
+        }
+    }
+
+    testFinish();
+}
+
+static void test_serialize(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int option_2;
+        int output_options;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_EANX, -1, -1, "123456789012+12" },
+        /*  1*/ { BARCODE_CODE128, -1, BARCODE_BOX, "AIM" },
+        /*  2*/ { BARCODE_QRCODE, -1, -1, "1234567890" },
+        /*  3*/ { BARCODE_PDF417, -1, -1, "1234567890" },
+        /*  4*/ { BARCODE_ULTRA, -1, -1, "A" },
+        /*  5*/ { BARCODE_MAXICODE, -1, -1, "1234" },
+        /*  6*/ { BARCODE_DOTCODE, -1, -1, "1234" },
+        /*  7*/ { BARCODE_HANXIN, 84, -1, "1" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, data[i].output_options, data[i].data, -1, debug);
+
+        char hash[17], hash2[17];
+        ret = ZBarcode_Content_Hash(symbol, (unsigned char *) data[i].data, length, hash);
+        assert_zero(ret, "i:%d ZBarcode_Content_Hash ret %d != 0\n", i, ret);
+        assert_equal((int) strlen(hash), 16, "i:%d strlen(hash) %d != 16\n", i, (int) strlen(hash));
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        ret = ZBarcode_Buffer(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        unsigned char *buffer;
+        int size;
+        ret = ZBarcode_Serialize(symbol, &buffer, &size);
+        assert_zero(ret, "i:%d ZBarcode_Serialize ret %d != 0\n", i, ret);
+        assert_nonnull(buffer, "i:%d ZBarcode_Serialize buffer NULL\n", i);
+        assert_zero(memcmp(buffer, "ZSYM", 4), "i:%d buffer magic differs\n", i);
+
+        /* Load into a fresh (default) symbol and compare */
+        struct zint_symbol *symbol2 = ZBarcode_Create();
+        assert_nonnull(symbol2, "Symbol2 not created\n");
+        ret = ZBarcode_Deserialize(symbol2, buffer, size);
+        assert_zero(ret, "i:%d ZBarcode_Deserialize ret %d != 0 (%s)\n", i, ret, symbol2->errtxt);
+        assert_equal(symbol2->symbology, symbol->symbology, "i:%d symbology %d != %d\n", i, symbol2->symbology, symbol->symbology);
+        assert_equal(symbol2->rows, symbol->rows, "i:%d rows %d != %d\n", i, symbol2->rows, symbol->rows);
+        assert_equal(symbol2->width, symbol->width, "i:%d width %d != %d\n", i, symbol2->width, symbol->width);
+        assert_equal(symbol2->height, symbol->height, "i:%d height %d != %d\n", i, symbol2->height, symbol->height);
+        assert_equal(symbol2->option_2, symbol->option_2, "i:%d option_2 %d != %d\n", i, symbol2->option_2, symbol->option_2);
+        assert_equal(symbol2->output_options, symbol->output_options, "i:%d output_options %d != %d\n", i, symbol2->output_options, symbol->output_options);
+        assert_zero(memcmp(symbol2->internal->encoded_data, symbol->internal->encoded_data, sizeof(symbol->internal->encoded_data)), "i:%d encoded_data differ\n", i);
+        assert_zero(memcmp(symbol2->row_height, symbol->row_height, sizeof(symbol->row_height)), "i:%d row_height differ\n", i);
+        assert_zero(strcmp((char *) symbol2->text, (char *) symbol->text), "i:%d text %s != %s\n", i, symbol2->text, symbol->text);
+
+        ret = ZBarcode_Buffer(symbol2, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer symbol2 ret %d != 0 (%s)\n", i, ret, symbol2->errtxt);
+        assert_equal(symbol2->bitmap_width, symbol->bitmap_width, "i:%d bitmap_width %d != %d\n", i, symbol2->bitmap_width, symbol->bitmap_width);
+        assert_equal(symbol2->bitmap_height, symbol->bitmap_height, "i:%d bitmap_height %d != %d\n", i, symbol2->bitmap_height, symbol->bitmap_height);
+        assert_zero(memcmp(symbol2->bitmap, symbol->bitmap, symbol->bitmap_width * symbol->bitmap_height * 3), "i:%d bitmaps differ\n", i);
+
+        /* Corruption detected */
+        buffer[size / 2] ^= 0x01;
+        ret = ZBarcode_Deserialize(symbol2, buffer, size);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "i:%d ZBarcode_Deserialize(corrupt) ret %d != ZINT_ERROR_INVALID_DATA\n", i, ret);
+        assert_zero(strcmp(symbol2->errtxt, "Error 737: Serialized symbol check value mismatch"), "i:%d strcmp(%s) != 0\n", i, symbol2->errtxt);
+        ret = ZBarcode_Deserialize(symbol2, buffer, size - 1);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "i:%d ZBarcode_Deserialize(short) ret %d != ZINT_ERROR_INVALID_DATA\n", i, ret);
+        ZBarcode_Serialize_Delete(buffer);
+
+        /* Hash stable, and differs on changing data or options */
+        struct zint_symbol *symbol3 = ZBarcode_Create();
+        assert_nonnull(symbol3, "Symbol3 not created\n");
+        (void) testUtilSetSymbol(symbol3, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, data[i].output_options, data[i].data, -1, debug);
+        symbol3->output_options |= BARCODE_MEMORY_FILE; /* Output destination ignored */
+        ret = ZBarcode_Content_Hash(symbol3, (unsigned char *) data[i].data, length, hash2);
+        assert_zero(ret, "i:%d ZBarcode_Content_Hash ret %d != 0\n", i, ret);
+        assert_zero(strcmp(hash2, hash), "i:%d hash %s != %s\n", i, hash2, hash);
+        char data2[64];
+        strcpy(data2, data[i].data);
+        data2[length - 1] ^= 0x01;
+        ret = ZBarcode_Content_Hash(symbol3, (unsigned char *) data2, length, hash2);
+        assert_zero(ret, "i:%d ZBarcode_Content_Hash ret %d != 0\n", i, ret);
+        assert_nonzero(strcmp(hash2, hash), "i:%d hash %s same for different data\n", i, hash2);
+        symbol3->scale = 2.0f;
+        ret = ZBarcode_Content_Hash(symbol3, (unsigned char *) data[i].data, length, hash2);
+        assert_zero(ret, "i:%d ZBarcode_Content_Hash ret %d != 0\n", i, ret);
+        assert_nonzero(strcmp(hash2, hash), "i:%d hash %s same for different scale\n", i, hash2);
+
+        ZBarcode_Delete(symbol3);
+        ZBarcode_Delete(symbol2);
+        ZBarcode_Delete(symbol);
+    }
+
+    /* Bad args */
+    {
+        struct zint_symbol *symbol = ZBarcode_Create();
+        unsigned char *buffer = (unsigned char *) "";
+        int size = 1;
+        char hash[17];
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        ret = ZBarcode_Serialize(symbol, NULL, &size);
+        assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Serialize(NULL buffer) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+        ret = ZBarcode_Serialize(symbol, &buffer, &size); /* Unencoded */
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Serialize(unencoded) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        assert_null(buffer, "ZBarcode_Serialize(unencoded) buffer non-NULL\n");
+        assert_zero(size, "ZBarcode_Serialize(unencoded) size %d != 0\n", size);
+
+        ret = ZBarcode_Deserialize(NULL, (unsigned char *) "ZSYM", 4);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Deserialize(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        ret = ZBarcode_Deserialize(symbol, (unsigned char *) "ZSYM", 4);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Deserialize(short) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        assert_zero(strcmp(symbol->errtxt, "Error 735: Invalid serialized symbol"), "strcmp(%s) != 0\n", symbol->errtxt);
+
+        ret = ZBarcode_Content_Hash(NULL, (unsigned char *) "1", 1, hash);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Content_Hash(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+
+        ZBarcode_Serialize_Delete(NULL); /* No-op */
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+#define TRACE_MAX   1024
+
+struct trace_log {
+    char events[TRACE_MAX];
+    int depth; /* Nesting, must return to 0 */
+    int mismatched;
+    int stack[32];
+};
+
+static void trace_func(void *context, const struct zint_symbol *symbol, int phase, int event, int length) {
+    static const char *const names[] = { "", "pre", "gs1", "eci", "enc", "mod", "rs", "msk", "ras", "vec", "out" };
+    struct trace_log *log = (struct trace_log *) context;
+    char buf[32];
+
+    (void)symbol;
+    if (event == ZINT_TRACE_BEGIN) {
+        if (log->depth < 32) {
+            log->stack[log->depth] = phase;
+        }
+        log->depth++;
+    } else if (--log->depth < 0 || (log->depth < 32 && log->stack[log->depth] != phase)) {
+        log->mismatched = 1;
+    }
+    sprintf(buf, "%s%c%d ", phase >= 1 && phase <= 10 ? names[phase] : "?", event == ZINT_TRACE_BEGIN ? '<' : '>',
+            length);
+    if (strlen(log->events) + strlen(buf) < TRACE_MAX) {
+        strcat(log->events, buf);
+    }
+}
+
+static void test_trace(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        char *data;
+        char *outfile; /* "" for ZBarcode_Buffer_Vector() */
+        int ret;
+        char *expected;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, UNICODE_MODE, "1234", "mem.bmp", 0, "pre<4 pre>4 enc<4 eci<4 eci>4 mod<4 mod>4 rs<9 rs>26 msk<441 msk>441 enc>441 ras<441 out<0 out>398 ras>1764 " },
+        /*  1*/ { BARCODE_HANXIN, UNICODE_MODE, "1234", "mem.svg", 0, "pre<4 pre>4 enc<4 eci<4 eci>4 mod<4 mod>5 rs<9 rs>25 msk<529 msk>529 enc>529 vec<529 out<0 out>5812 vec>0 " },
+        /*  2*/ { BARCODE_DATAMATRIX, GS1_MODE, "[01]12345678901231", "", 0, "pre<18 pre>18 gs1<18 gs1>16 enc<16 mod<16 mod>9 rs<10 rs>21 enc>256 vec<256 vec>0 " },
+        /*  3*/ { BARCODE_CODE128, UNICODE_MODE | ESCAPE_MODE, "A\\tB", "mem.gif", 0, "pre<4 pre>3 enc<3 eci<3 eci>3 enc>68 ras<68 out<0 out>1377 ras>15776 " },
+        /*  4*/ { BARCODE_CODE128, UNICODE_MODE, "\xFF", "mem.png", ZINT_ERROR_INVALID_DATA, "pre<1 pre>-1 " },
+        /*  5*/ { BARCODE_DATAMATRIX, GS1_MODE, "[01]123", "mem.png", ZINT_ERROR_INVALID_DATA, "pre<7 pre>7 gs1<7 gs1>-1 " },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct trace_log log;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, BARCODE_MEMORY_FILE /*output_options*/, data[i].data, -1, debug);
+        strcpy(symbol->outfile, data[i].outfile);
+
+        memset(&log, 0, sizeof(log));
+        symbol->trace_func = trace_func;
+        symbol->trace_context = &log;
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        if (ret < ZINT_ERROR) {
+            ret = data[i].outfile[0] ? ZBarcode_Print(symbol, 0) : ZBarcode_Buffer_Vector(symbol, 0);
+        }
+        assert_equal(ret, data[i].ret, "i:%d ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        assert_zero(log.depth, "i:%d depth %d != 0 (%s)\n", i, log.depth, log.events);
+        assert_zero(log.mismatched, "i:%d mismatched (%s)\n", i, log.events);
+        assert_zero(strcmp(log.events, data[i].expected), "i:%d events \"%s\" != \"%s\"\n", i, log.events, data[i].expected);
+
+        /* No events when unset */
+        symbol->trace_func = NULL;
+        log.events[0] = '\0';
+        ZBarcode_Clear(symbol);
+        (void) ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(log.events[0], "i:%d events \"%s\" when unset\n", i, log.events);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+/* Structured trace records as "phase:kind v0 v1 v2 v3 " each, with the mode of ZINT_RECORD_MODE as a character */
+static char *trace_records_str(const struct zint_symbol *symbol, char *buf) {
+    const struct zint_trace_record *record;
+    char *b = buf;
+    int i;
+
+    *b = '\0';
+    for (i = 0; (record = ZBarcode_Trace_Record(symbol, i)); i++) {
+        if (record->kind == ZINT_RECORD_MODE) {
+            b += sprintf(b, "%d:%d %c %d %d %d ", record->phase, record->kind, record->values[0], record->values[1],
+                        record->values[2], record->values[3]);
+        } else {
+            b += sprintf(b, "%d:%d %d %d %d %d ", record->phase, record->kind, record->values[0], record->values[1],
+                        record->values[2], record->values[3]);
+        }
+    }
+    return buf;
+}
+
+static void test_trace_records(int index, int generate, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int option_3;
+        char *data;
+        int ret;
+        int expected_count;
+        char *expected;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, UNICODE_MODE, -1, "1234", 0, 12, "5:1 N 0 4 -1 4:2 1 21 21 4 6:3 9 17 4 0 7:4 0 1103 0 0 7:4 1 1082 0 0 7:4 2 1065 0 0 7:4 3 1061 0 0 7:4 4 1125 0 0 7:4 5 1098 0 0 7:4 6 1018 0 0 7:4 7 1144 0 0 7:5 6 1018 0 0 " },
+        /*  1*/ { BARCODE_QRCODE, UNICODE_MODE, 3 << 8, "1234", 0, 4, "5:1 N 0 4 -1 4:2 1 21 21 4 6:3 9 17 4 0 7:5 2 -1 1 0 " },
+        /*  2*/ { BARCODE_QRCODE, UNICODE_MODE, -1, "ABCDEFGHIJ1234567890123abc", 0, 14, "5:1 A 0 10 -1 5:1 N 10 13 -1 5:1 B 23 3 -1 4:2 2 25 25 3 6:3 22 22 21 0 7:4 0 1086 0 0 7:4 1 1125 0 0 7:4 2 1305 0 0 7:4 3 1187 0 0 7:4 4 1201 0 0 7:4 5 1237 0 0 7:4 6 1240 0 0 7:4 7 1156 0 0 7:5 0 1086 0 0 " },
+        /*  3*/ { BARCODE_MICROQR, UNICODE_MODE, -1, "12345", 0, 7, "5:1 N 0 5 -1 4:2 1 11 11 1 7:4 0 69 0 0 7:4 1 38 0 0 7:4 2 85 0 0 7:4 3 70 0 0 7:5 2 85 0 0 " },
+        /*  4*/ { BARCODE_RMQR, UNICODE_MODE, -1, "ABC", 0, 3, "5:1 A 0 3 -1 4:2 11 11 27 4 6:3 5 10 3 0 " },
+        /*  5*/ { BARCODE_DATAMATRIX, UNICODE_MODE, -1, "ABCDEFGHIJKLMNOPabc", 0, 5, "5:1 A 0 -1 0 5:1 C 0 -1 1 5:1 A 15 -1 12 4:2 27 12 26 -1 6:3 16 14 16 0 " },
+        /*  6*/ { BARCODE_DATAMATRIX, GS1_MODE, -1, "[01]12345678901231", 0, 3, "5:1 A 0 -1 1 4:2 26 8 32 -1 6:3 10 11 9 0 " },
+        /*  7*/ { BARCODE_CODE128, UNICODE_MODE, -1, "AB12345678cd", 0, 3, "5:1 B 0 2 -1 5:1 C 2 8 -1 5:1 B 10 2 -1 " },
+        /*  8*/ { BARCODE_GS1_128, GS1_MODE, -1, "[01]12345678901231[10]AB", 0, 2, "5:1 C 0 18 -1 5:1 B 18 2 -1 " },
+        /*  9*/ { BARCODE_DOTCODE, UNICODE_MODE, -1, "1234", 0, 7, "4:2 0 10 13 -1 6:3 3 4 3 0 7:4 0 74 0 0 7:4 1 48 0 0 7:4 2 74 0 0 7:4 3 126 0 0 7:5 3 126 0 0 " },
+        /* 10*/ { BARCODE_CODE39, UNICODE_MODE, -1, "1234", 0, 0, "" },
+        /* 11*/ { BARCODE_QRCODE, UNICODE_MODE, -1, "\xFF", ZINT_ERROR_INVALID_DATA, 0, "" },
+        /* 12*/ { BARCODE_HANXIN, UNICODE_MODE, -1, "1234abc", 0, 1, "5:1 t 0 7 -1 " },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char records[4096];
+    char escaped[1024];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, data[i].option_3, -1 /*output_options*/, data[i].data, -1, debug);
+        symbol->debug |= ZINT_DEBUG_TRACE;
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_equal(ret, data[i].ret, "i:%d ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        trace_records_str(symbol, records);
+
+        if (generate) {
+            printf("        /*%3d*/ { %s, %s, %s, \"%s\", %s, %d, \"%s\" },\n",
+                    i, testUtilBarcodeName(data[i].symbology), testUtilInputModeName(data[i].input_mode),
+                    testUtilOption3Name(data[i].option_3), testUtilEscape(data[i].data, length, escaped, sizeof(escaped)),
+                    testUtilErrorName(data[i].ret), symbol->trace_record_count, records);
+        } else {
+            assert_equal(symbol->trace_record_count, data[i].expected_count, "i:%d trace_record_count %d != %d\n",
+                    i, symbol->trace_record_count, data[i].expected_count);
+            assert_zero(strcmp(records, data[i].expected), "i:%d records \"%s\" != \"%s\"\n",
+                    i, records, data[i].expected);
+        }
+
+        /* None kept when unset, and none left over from previous encode */
+        symbol->debug &= ~ZINT_DEBUG_TRACE;
+        (void) ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(symbol->trace_record_count, "i:%d trace_record_count %d != 0 when unset\n",
+                    i, symbol->trace_record_count);
+        assert_null(ZBarcode_Trace_Record(symbol, 0), "i:%d ZBarcode_Trace_Record(0) non-NULL when unset\n", i);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    if (index == -1) {
+        /* Ring wraps, oldest first */
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        assert_null(symbol->internal->trace_records, "trace_records allocated before first record\n");
+        for (int i = 0; i < 70; i++) {
+            z_trace_record(symbol, ZINT_PHASE_ENCODE, ZINT_RECORD_MODE, i, 0, 0, 0);
+        }
+        assert_equal(symbol->trace_record_count, 70, "trace_record_count %d != 70\n", symbol->trace_record_count);
+        for (int i = 0; i < 64; i++) {
+            const struct zint_trace_record *record = ZBarcode_Trace_Record(symbol, i);
+            assert_nonnull(record, "ZBarcode_Trace_Record(%d) NULL\n", i);
+            assert_equal(record->values[0], i + 6, "ZBarcode_Trace_Record(%d) values[0] %d != %d\n",
+                    i, record->values[0], i + 6);
+        }
+        assert_null(ZBarcode_Trace_Record(symbol, 64), "ZBarcode_Trace_Record(64) non-NULL\n");
+        assert_null(ZBarcode_Trace_Record(symbol, -1), "ZBarcode_Trace_Record(-1) non-NULL\n");
+        assert_null(ZBarcode_Trace_Record(NULL, 0), "ZBarcode_Trace_Record(NULL) non-NULL\n");
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_measure(int index, int generate, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int option_1;
+        int option_2;
+        int option_3;
+        int output_options;
+        float scale;
+        int whitespace_width;
+        int rotate_angle;
+        char *data;
+        int ret;
+        int expected_version;
+        int expected_ecc_level;
+        int expected_data_codewords;
+        int expected_ecc_codewords;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, UNICODE_MODE, -1, -1, -1, -1, 0, -1, 0, "1234", 0, 1, 4, 9, 17, "" },
+        /*  1*/ { BARCODE_QRCODE, UNICODE_MODE, 1, -1, -1, -1, 2.5f, 3, 90, "ABCDEFGHIJ1234567890123abc", 0, 2, 1, 34, 10, "" },
+        /*  2*/ { BARCODE_QRCODE, UNICODE_MODE, -1, 10, -1, BARCODE_DOTTY_MODE, 0, -1, 0, "1234", 0, 10, 4, 122, 224, "" },
+        /*  3*/ { BARCODE_MICROQR, UNICODE_MODE, -1, -1, -1, -1, 0, -1, 0, "12345", 0, 1, 1, -1, -1, "" },
+        /*  4*/ { BARCODE_RMQR, UNICODE_MODE, -1, -1, -1, -1, 0, -1, 180, "ABC", 0, 11, 4, 5, 10, "" },
+        /*  5*/ { BARCODE_UPNQR, UNICODE_MODE, -1, -1, -1, -1, 0.5f, -1, 0, "ABC", 0, 15, 2, 415, 240, "" },
+        /*  6*/ { BARCODE_DATAMATRIX, UNICODE_MODE, -1, -1, -1, -1, 0, -1, 0, "ABCDEFGHIJKLMNOPabc", 0, 27, -1, 16, 14, "" },
+        /*  7*/ { BARCODE_DATAMATRIX, GS1_MODE, -1, -1, DM_DMRE, BARCODE_BOX, 3, 2, 270, "[01]12345678901231", 0, 26, -1, 10, 11, "" },
+        /*  8*/ { BARCODE_DOTCODE, UNICODE_MODE, -1, -1, -1, -1, 0, -1, 0, "1234", 0, 0, -1, 3, 4, "" },
+        /*  9*/ { BARCODE_CODE128, UNICODE_MODE, -1, -1, -1, -1, 1.5f, -1, 0, "AB12345678cd", 0, 0, -1, -1, -1, "" },
+        /* 10*/ { BARCODE_EANX, UNICODE_MODE, -1, -1, -1, -1, 0, -1, 0, "123456789012+12", 0, 0, -1, -1, -1, "" },
+        /* 11*/ { BARCODE_MAXICODE, UNICODE_MODE, -1, -1, -1, -1, 0, -1, 90, "ABCDEF", 0, 0, -1, -1, -1, "" },
+        /* 12*/ { BARCODE_HANXIN, UNICODE_MODE, -1, -1, -1, -1, 0, -1, 0, "1234abc", 0, 0, -1, -1, -1, "" },
+        /* 13*/ { BARCODE_QRCODE, UNICODE_MODE, -1, 1, -1, -1, 0, -1, 0, "12345678901234567890123456789012345678901234567890", ZINT_ERROR_TOO_LONG, 0, -1, -1, -1, "Error 569: Input too long for selected symbol size" },
+        /* 14*/ { BARCODE_CODE128, UNICODE_MODE, -1, -1, -1, BARCODE_DOTTY_MODE, 0, -1, 0, "1234", ZINT_ERROR_INVALID_OPTION, 0, -1, -1, -1, "Error 299: Selected symbology cannot be rendered as dots" },
+        /* 15*/ { BARCODE_CODE128, UNICODE_MODE, -1, -1, -1, -1, 0, -1, 45, "1234", ZINT_ERROR_INVALID_OPTION, 0, -1, -1, -1, "Error 298: Invalid rotation angle" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct zint_measure measure;
+    char escaped[1024];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, data[i].option_1, data[i].option_2, data[i].option_3, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+        if (data[i].whitespace_width != -1) {
+            symbol->whitespace_width = data[i].whitespace_width;
+        }
+
+        ret = ZBarcode_Measure(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle, &measure);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Measure ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        /* Left cleared */
+        assert_zero(symbol->rows, "i:%d rows %d != 0\n", i, symbol->rows);
+        assert_null(symbol->bitmap, "i:%d bitmap non-NULL\n", i);
+        assert_zero(symbol->trace_record_count, "i:%d trace_record_count %d != 0\n", i, symbol->trace_record_count);
+
+        if (generate) {
+            printf("        /*%3d*/ { %s, %s, %d, %d, %s, %s, %.8g, %d, %d, \"%s\", %s, %d, %d, %d, %d, \"%s\" },\n",
+                    i, testUtilBarcodeName(data[i].symbology), testUtilInputModeName(data[i].input_mode),
+                    data[i].option_1, data[i].option_2, testUtilOption3Name(data[i].option_3),
+                    testUtilOutputOptionsName(data[i].output_options), data[i].scale, data[i].whitespace_width,
+                    data[i].rotate_angle, testUtilEscape(data[i].data, length, escaped, sizeof(escaped)),
+                    testUtilErrorName(data[i].ret), measure.version, measure.ecc_level, measure.data_codewords,
+                    measure.ecc_codewords, symbol->errtxt);
+        } else {
+            assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d errtxt \"%s\" != \"%s\"\n", i, symbol->errtxt, data[i].expected_errtxt);
+            assert_equal(measure.version, data[i].expected_version, "i:%d version %d != %d\n", i, measure.version, data[i].expected_version);
+            assert_equal(measure.ecc_level, data[i].expected_ecc_level, "i:%d ecc_level %d != %d\n", i, measure.ecc_level, data[i].expected_ecc_level);
+            assert_equal(measure.data_codewords, data[i].expected_data_codewords, "i:%d data_codewords %d != %d\n", i, measure.data_codewords, data[i].expected_data_codewords);
+            assert_equal(measure.ecc_codewords, data[i].expected_ecc_codewords, "i:%d ecc_codewords %d != %d\n", i, measure.ecc_codewords, data[i].expected_ecc_codewords);
+        }
+
+        if (ret < ZINT_ERROR) {
+            /* Same sizes as encoding and buffering */
+            ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+            assert_nonzero(ret < ZINT_ERROR, "i:%d ZBarcode_Encode ret %d >= ZINT_ERROR (%s)\n", i, ret, symbol->errtxt);
+            assert_equal(measure.rows, symbol->rows, "i:%d rows %d != %d\n", i, measure.rows, symbol->rows);
+            assert_equal(measure.width, symbol->width, "i:%d width %d != %d\n", i, measure.width, symbol->width);
+            assert_equal(measure.height, symbol->height, "i:%d height %d != %d\n", i, measure.height, symbol->height);
+            ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            assert_equal(measure.bitmap_width, symbol->bitmap_width, "i:%d bitmap_width %d != %d\n", i, measure.bitmap_width, symbol->bitmap_width);
+            assert_equal(measure.bitmap_height, symbol->bitmap_height, "i:%d bitmap_height %d != %d\n", i, measure.bitmap_height, symbol->bitmap_height);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    {
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        ret = ZBarcode_Measure(NULL, (unsigned char *) "1", 1, 0, &measure);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Measure(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        ret = ZBarcode_Measure(symbol, (unsigned char *) "1", 1, 0, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Measure(measure NULL) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+        assert_zero(strcmp(symbol->errtxt, "Error 297: Invalid measure argument"), "errtxt \"%s\"\n", symbol->errtxt);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_prepared(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int eci;
+        int option_1;
+        int option_2;
+        int warn_level;
+        char *fgcolour;
+        char *data[3];
+        int prepare_ret;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, -1, -1, -1, -1, "", { "1234", "AIM", "\351" }, 0, "" },
+        /*  1*/ { BARCODE_EANX, -1, -1, -1, -1, -1, "", { "123456789012", "A", "12345678901234" }, 0, "" },
+        /*  2*/ { BARCODE_QRCODE, UNICODE_MODE, -1, -1, -1, -1, "", { "1234", "é", "\200" }, 0, "" }, /* ECI auto-selected per input */
+        /*  3*/ { BARCODE_QRCODE, UNICODE_MODE, -1, 2, 1, -1, "", { "1234", "abcdefghijklmnopqrstuvwxyz", "1" }, 0, "" }, /* Version fixed */
+        /*  4*/ { BARCODE_DATAMATRIX, ESCAPE_MODE, -1, -1, -1, -1, "", { "12\\d034", "", "\\x" }, 0, "" },
+        /*  5*/ { BARCODE_AZTEC, DATA_MODE, 26, -1, -1, -1, "112233", { "1234", "\377\376", "A" }, 0, "" },
+        /*  6*/ { 0, -1, -1, -1, -1, -1, "", { "1234", "1", "12" }, ZINT_WARN_INVALID_OPTION, "Warning 206: Symbology out of range" },
+        /*  7*/ { 10, -1, -1, -1, -1, -1, "", { "123456789012", "1234567", "1" }, 0, "" }, /* Remapped to EANX */
+        /*  8*/ { 0, -1, -1, -1, -1, WARN_FAIL_ALL, "", { "1234", "1", "12" }, ZINT_ERROR_INVALID_OPTION, "Error 206: Symbology out of range" },
+        /*  9*/ { BARCODE_CODE128, -1, 3, -1, -1, -1, "", { "1234", "1", "12" }, ZINT_ERROR_INVALID_OPTION, "Error 217: Symbology does not support ECI switching" },
+        /* 10*/ { BARCODE_CODE128, -1, -1, -1, -1, -1, "12345", { "1234", "1", "12" }, ZINT_ERROR_INVALID_OPTION, "Error 651: Malformed foreground colour target" },
+        /* 11*/ { BARCODE_CODE128, -1, -1, -1, -1, -1, "GG0000", { "1234", "1", "12" }, ZINT_ERROR_INVALID_OPTION, "Error 653: Malformed foreground colour target" },
+    };
+    int data_size = ARRAY_SIZE(data);
+    int data_items_size = ARRAY_SIZE(data[0].data);
+
+    for (int i = 0; i < data_size; i++) {
+        struct zint_prepared *prepared = NULL;
+        int j;
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, data[i].eci, data[i].option_1, data[i].option_2, -1, -1 /*output_options*/, data[i].data[0], -1, debug);
+        if (data[i].warn_level != -1) {
+            symbol->warn_level = data[i].warn_level;
+        }
+        if (*data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+
+        ret = ZBarcode_Prepare(symbol, &prepared);
+        assert_equal(ret, data[i].prepare_ret, "i:%d ZBarcode_Prepare ret %d != %d (%s)\n", i, ret, data[i].prepare_ret, symbol->errtxt);
+        assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected_errtxt);
+        /* Settings left unchanged */
+        assert_equal(symbol->symbology, data[i].symbology, "i:%d symbol->symbology %d != %d\n", i, symbol->symbology, data[i].symbology);
+        if (ret >= ZINT_ERROR) {
+            assert_null(prepared, "i:%d prepared non-NULL\n", i);
+            ZBarcode_Delete(symbol);
+            continue;
+        }
+        assert_nonnull(prepared, "i:%d prepared NULL\n", i);
+
+        /* Compare with encoding each individually, re-using the one symbol */
+        for (j = 0; j < data_items_size; j++) {
+            struct zint_symbol *symbol2 = ZBarcode_Create();
+            assert_nonnull(symbol2, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol2, data[i].symbology, data[i].input_mode, data[i].eci, data[i].option_1, data[i].option_2, -1, -1 /*output_options*/, data[i].data[j], -1, debug);
+            if (*data[i].fgcolour) {
+                strcpy(symbol2->fgcolour, data[i].fgcolour);
+            }
+            int ret2 = ZBarcode_Encode(symbol2, (unsigned char *) data[i].data[j], length);
+
+            ret = ZBarcode_Encode_Prepared(prepared, symbol, (unsigned char *) data[i].data[j], length);
+            assert_equal(ret, ret2, "i:%d j:%d ZBarcode_Encode_Prepared ret %d != %d (%s)\n", i, j, ret, ret2, symbol->errtxt);
+            assert_zero(strcmp(symbol->errtxt, symbol2->errtxt), "i:%d j:%d strcmp(%s, %s) != 0\n", i, j, symbol->errtxt, symbol2->errtxt);
+            if (ret < ZINT_ERROR) {
+                char dump[4096], dump2[4096];
+                assert_equal(symbol->symbology, symbol2->symbology, "i:%d j:%d symbol->symbology %d != %d\n", i, j, symbol->symbology, symbol2->symbology);
+                assert_equal(symbol->eci, symbol2->eci, "i:%d j:%d symbol->eci %d != %d\n", i, j, symbol->eci, symbol2->eci);
+                testUtilModulesDump(symbol, dump, sizeof(dump));
+                testUtilModulesDump(symbol2, dump2, sizeof(dump2));
+                assert_zero(strcmp(dump, dump2), "i:%d j:%d dumps differ\n", i, j);
+
+                ret = ZBarcode_Buffer(symbol, 0);
+                ret2 = ZBarcode_Buffer(symbol2, 0);
+                assert_equal(ret, ret2, "i:%d j:%d ZBarcode_Buffer ret %d != %d (%s)\n", i, j, ret, ret2, symbol->errtxt);
+                if (ret < ZINT_ERROR) {
+                    assert_equal(symbol->bitmap_width, symbol2->bitmap_width, "i:%d j:%d bitmap_width %d != %d\n", i, j, symbol->bitmap_width, symbol2->bitmap_width);
+                    assert_equal(symbol->bitmap_height, symbol2->bitmap_height, "i:%d j:%d bitmap_height %d != %d\n", i, j, symbol->bitmap_height, symbol2->bitmap_height);
+                    assert_zero(memcmp(symbol->bitmap, symbol2->bitmap, symbol->bitmap_width * symbol->bitmap_height * 3), "i:%d j:%d bitmaps differ\n", i, j);
+                }
+            }
+
+            ZBarcode_Delete(symbol2);
+        }
+
+        ZBarcode_Prepared_Delete(prepared);
+        ZBarcode_Delete(symbol);
+    }
+
+    /* Bad args */
+    {
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        ret = ZBarcode_Prepare(NULL, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Prepare(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        ret = ZBarcode_Prepare(symbol, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Prepare(p_prepared NULL) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+        assert_zero(strcmp(symbol->errtxt, "Error 462: Prepared encoder pointer NULL"), "strcmp(%s) != 0\n", symbol->errtxt);
+        ret = ZBarcode_Encode_Prepared(NULL, NULL, NULL, 0);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Encode_Prepared(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        ret = ZBarcode_Encode_Prepared(NULL, symbol, (const unsigned char *) "1", 1);
+        assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Encode_Prepared(prepared NULL) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+        assert_zero(strcmp(symbol->errtxt, "Error 476: Prepared encoder NULL"), "strcmp(%s) != 0\n", symbol->errtxt);
+        ZBarcode_Prepared_Delete(NULL);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_no_hrt(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int output_options;
+        int show_hrt;
+        char *data;
+        char *expected_text;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, BARCODE_NO_HRT, -1, "AIM", "" },
+        /*  1*/ { BARCODE_CODE128, -1, -1, 0, "AIM", "" },
+        /*  2*/ { BARCODE_CODE39, -1, BARCODE_NO_HRT, -1, "1A", "" },
+        /*  3*/ { BARCODE_EXCODE39, -1, BARCODE_NO_HRT, -1, "1a", "" },
+        /*  4*/ { BARCODE_HIBC_128, -1, BARCODE_NO_HRT, -1, "A123", "" },
+        /*  5*/ { BARCODE_GS1_128, GS1_MODE, BARCODE_NO_HRT, -1, "[01]12345678901231", "" },
+        /*  6*/ { BARCODE_DBAR_OMN, -1, BARCODE_NO_HRT, -1, "1234567890123", "" },
+        /*  7*/ { BARCODE_DBAR_EXP, GS1_MODE, -1, 0, "[01]12345678901231", "" },
+        /*  8*/ { BARCODE_ITF14, -1, BARCODE_NO_HRT, -1, "1234567890123", "" },
+        /*  9*/ { BARCODE_MSI_PLESSEY, -1, BARCODE_NO_HRT, -1, "1234", "" },
+        /* 10*/ { BARCODE_TELEPEN, -1, BARCODE_NO_HRT, -1, "AB", "" },
+        /* 11*/ { BARCODE_DPD, -1, BARCODE_NO_HRT, -1, "%000393206219912345678101040", "" },
+        /* 12*/ { BARCODE_EANX, -1, BARCODE_NO_HRT, -1, "123456789012", "1234567890128" }, /* EAN/UPC keep text for layout */
+        /* 13*/ { BARCODE_UPCA, -1, -1, 0, "12345678901", "123456789012" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].show_hrt != -1) {
+            symbol->show_hrt = data[i].show_hrt;
+        }
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_zero(strcmp((char *) symbol->text, data[i].expected_text), "i:%d text \"%s\" != \"%s\"\n", i, symbol->text, data[i].expected_text);
+
+        /* Modules must be the same as when text is generated */
+        struct zint_symbol *symbol2 = ZBarcode_Create();
+        assert_nonnull(symbol2, "Symbol2 not created\n");
+        (void) testUtilSetSymbol(symbol2, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+
+        ret = ZBarcode_Encode(symbol2, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode symbol2 ret %d != 0 (%s)\n", i, ret, symbol2->errtxt);
+        assert_nonzero(symbol2->text[0], "i:%d symbol2 text empty\n", i);
+        assert_equal(symbol->rows, symbol2->rows, "i:%d rows %d != %d\n", i, symbol->rows, symbol2->rows);
+        assert_equal(symbol->width, symbol2->width, "i:%d width %d != %d\n", i, symbol->width, symbol2->width);
+        assert_zero(memcmp(symbol->internal->encoded_data, symbol2->internal->encoded_data, sizeof(symbol->internal->encoded_data)), "i:%d encoded_data differ\n", i);
+        assert_zero(symbol->debug & ZINT_NO_HRT_TEXT, "i:%d ZINT_NO_HRT_TEXT left set\n", i);
+
+        ZBarcode_Delete(symbol2);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_set_colours(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        char *fgcolour;
+        char *bgcolour;
+        int ret;
+        char *expected_fgcolour;
+        char *expected_bgcolour;
+        unsigned int expected_fgcolour_rgba;
+        unsigned int expected_bgcolour_rgba;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { NULL, NULL, 0, "000000", "FFFFFF", 0x000000FF, 0xFFFFFFFF, "" },
+        /*  1*/ { "123abc", NULL, 0, "123ABC", "FFFFFF", 0x123ABCFF, 0xFFFFFFFF, "" },
+        /*  2*/ { NULL, "ABCDEF80", 0, "000000", "ABCDEF80", 0x000000FF, 0xABCDEF80, "" },
+        /*  3*/ { "FF000000", "00FF00FF", 0, "FF000000", "00FF00FF", 0xFF000000, 0x00FF00FF, "" },
+        /*  4*/ { "12345", NULL, ZINT_ERROR_INVALID_OPTION, "000000", "ffffff", 0x000000FF, 0xFFFFFFFF, "Error 651: Malformed foreground colour target" },
+        /*  5*/ { "123456789", NULL, ZINT_ERROR_INVALID_OPTION, "000000", "ffffff", 0x000000FF, 0xFFFFFFFF, "Error 651: Malformed foreground colour target" },
+        /*  6*/ { NULL, "1234567", ZINT_ERROR_INVALID_OPTION, "000000", "ffffff", 0x000000FF, 0xFFFFFFFF, "Error 652: Malformed background colour target" },
+        /*  7*/ { "12345G", "123456", ZINT_ERROR_INVALID_OPTION, "000000", "ffffff", 0x000000FF, 0xFFFFFFFF, "Error 653: Malformed foreground colour target" },
+        /*  8*/ { "123456", "1234567X", ZINT_ERROR_INVALID_OPTION, "000000", "ffffff", 0x000000FF, 0xFFFFFFFF, "Error 654: Malformed background colour target" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+        symbol->debug = debug;
+
+        ret = ZBarcode_Set_Colours(symbol, data[i].fgcolour, data[i].bgcolour);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Set_Colours ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d errtxt \"%s\" != \"%s\"\n", i, symbol->errtxt, data[i].expected_errtxt);
+        assert_zero(strcmp(symbol->fgcolour, data[i].expected_fgcolour), "i:%d fgcolour \"%s\" != \"%s\"\n", i, symbol->fgcolour, data[i].expected_fgcolour);
+        assert_zero(strcmp(symbol->bgcolour, data[i].expected_bgcolour), "i:%d bgcolour \"%s\" != \"%s\"\n", i, symbol->bgcolour, data[i].expected_bgcolour);
+        assert_equal(symbol->fgcolour_rgba, data[i].expected_fgcolour_rgba, "i:%d fgcolour_rgba 0x%08X != 0x%08X\n", i, symbol->fgcolour_rgba, data[i].expected_fgcolour_rgba);
+        assert_equal(symbol->bgcolour_rgba, data[i].expected_bgcolour_rgba, "i:%d bgcolour_rgba 0x%08X != 0x%08X\n", i, symbol->bgcolour_rgba, data[i].expected_bgcolour_rgba);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_incremental(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int output_options;
+        int option_3;
+        char *data[4];
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_DATAMATRIX, -1, -1, -1, { "SN00000998", "SN00000999", "SN00001000", "SN00001001" } },
+        /*  1*/ { BARCODE_DATAMATRIX, GS1_MODE, -1, -1, { "[01]09501101530003[21]A98", "[01]09501101530003[21]A99", "[01]09501101530003[21]B00", "[01]09501101530003[21]B01" } },
+        /*  2*/ { BARCODE_DATAMATRIX, GS1_MODE, GS1_GS_SEPARATOR, -1, { "[01]09501101530003[10]LOT1[21]1", "[01]09501101530003[10]LOT1[21]2", "[01]1234", "[01]09501101530003[10]LOT1[21]3" } },
+        /*  3*/ { BARCODE_DATAMATRIX, -1, -1, -1, { "ABCDEFGHIJKLMNOP0001", "ABCDEFGHIJKLMNOP0002", "ABCDEFGHIJKLMNOPabc", "ABCDEFGHIJKLMNOP" } },
+        /*  4*/ { BARCODE_DATAMATRIX, -1, -1, -1, { "ABC*DEF>GHI\015JKL0001", "ABC*DEF>GHI\015JKL0002", "ABC*DEF>GHI\015JKL00", "ABC*DEF>GHI\015JKL003" } },
+        /*  5*/ { BARCODE_DATAMATRIX, -1, -1, -1, { "@@@@@@@@ABC^^^^0001", "@@@@@@@@ABC^^^^0002", "@@@@@@@@ABC^^^^0002@@@", "@@@@@@@@ABC^^^" } },
+        /*  6*/ { BARCODE_DATAMATRIX, DATA_MODE, -1, -1, { "\200\201\202\203\204\205 0001", "\200\201\202\203\204\205 0002", "\200\201\202\203\204\205 0003\206", "\200\201\202\203\204\205" } },
+        /*  7*/ { BARCODE_DATAMATRIX, -1, -1, DM_SQUARE, { "1", "12345678901234567890123456789012345678901234567890", "123456789012345678901234567890123456789012345678", "2" } },
+        /*  8*/ { BARCODE_DATAMATRIX, -1, READER_INIT, -1, { "abcdefgh12", "abcdefgh13", "abcdefgh", "abcdefgh1300" } },
+        /*  9*/ { BARCODE_HIBC_DM, -1, -1, -1, { "A123BJC5D6E71", "A123BJC5D6E72", "A123BJC5D6E73", "A123BJC5D6E8" } },
+        /* 10*/ { BARCODE_QRCODE, -1, -1, -1, { "SN00000998", "SN00000999", "SN00001000", "SN00001001" } },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_incremental *incremental = ZBarcode_Incremental_Create();
+        assert_nonnull(incremental, "i:%d ZBarcode_Incremental_Create NULL\n", i);
+
+        /* Each of the sequence encoded incrementally must be the same as encoded afresh */
+        for (int j = 0; j < (int) ARRAY_SIZE(data[i].data); j++) {
+            struct zint_symbol *expected = ZBarcode_Create();
+            assert_nonnull(expected, "Symbol not created\n");
+            int length = testUtilSetSymbol(expected, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, data[i].option_3, data[i].output_options, data[i].data[j], -1, debug);
+            int expected_ret = ZBarcode_Encode(expected, (unsigned char *) data[i].data[j], length);
+
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+            (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, data[i].option_3, data[i].output_options, data[i].data[j], -1, debug);
+            ret = ZBarcode_Encode_Incremental(incremental, symbol, (unsigned char *) data[i].data[j], length);
+            assert_equal(ret, expected_ret, "i:%d j:%d ZBarcode_Encode_Incremental ret %d != %d (%s)\n", i, j, ret, expected_ret, symbol->errtxt);
+            assert_zero(strcmp(symbol->errtxt, expected->errtxt), "i:%d j:%d errtxt \"%s\" != \"%s\"\n", i, j, symbol->errtxt, expected->errtxt);
+            if (ret < ZINT_ERROR) {
+                ret = testUtilSymbolCmp(symbol, expected);
+                assert_zero(ret, "i:%d j:%d testUtilSymbolCmp ret %d != 0\n", i, j, ret);
+            }
+            assert_null(symbol->internal->incremental, "i:%d j:%d symbol->internal->incremental not NULL\n", i, j);
+
+            ZBarcode_Delete(symbol);
+            ZBarcode_Delete(expected);
+        }
+
+        ZBarcode_Incremental_Delete(incremental);
+    }
+
+    testFinish();
+}
+
+struct budget_stall {
+    int phase; /* Phase at whose start `stall_trace()` sleeps */
+    int sleep_us;
+};
+
+static void stall_trace(void *trace_context, const struct zint_symbol *symbol, int phase, int event, int length) {
+    const struct budget_stall *stall = (const struct budget_stall *) trace_context;
+    (void)symbol; (void)length;
+    if (phase == stall->phase && event == ZINT_TRACE_BEGIN) {
+        usleep(stall->sleep_us);
+    }
+}
+
+static void test_time_budget(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int time_budget_ms;
+        int stall_phase;
+        char *data;
+        int ret;
+        int expected_input_mode;
+        int expected_option_3;
+        char *comment;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, -1, 0, ZINT_PHASE_ENCODE, "1234ABCDabcd1234", 0, -1, -1, "No budget" },
+        /*  1*/ { BARCODE_QRCODE, -1, 10000, ZINT_PHASE_ENCODE, "1234ABCDabcd1234", 0, -1, -1, "Within budget" },
+        /*  2*/ { BARCODE_QRCODE, -1, 1, ZINT_PHASE_ENCODE, "1234ABCDabcd1234", ZINT_WARN_TIME_BUDGET, FAST_MODE, 1 << 8, "Fast modes, mask 0" },
+        /*  3*/ { BARCODE_QRCODE, -1, 1, ZINT_PHASE_MASK, "1234ABCDabcd1234", ZINT_WARN_TIME_BUDGET, -1, 1 << 8, "Mask 0 only" },
+        /*  4*/ { BARCODE_QRCODE, FAST_MODE, 1, ZINT_PHASE_ENCODE, "1234ABCDabcd1234", ZINT_WARN_TIME_BUDGET, FAST_MODE, 1 << 8, "" },
+        /*  5*/ { BARCODE_RMQR, -1, 1, ZINT_PHASE_ENCODE, "1234ABCDabcd1234", ZINT_WARN_TIME_BUDGET, FAST_MODE, -1, "Fast modes (no masking)" },
+        /*  6*/ { BARCODE_HANXIN, -1, 1, ZINT_PHASE_ENCODE, "1234ABCDabcd1234", ZINT_WARN_TIME_BUDGET, FAST_MODE, 1 << 8, "Fast modes, mask 0" },
+        /*  7*/ { BARCODE_HANXIN, -1, 10000, ZINT_PHASE_ENCODE, "1234ABCDabcd1234", 0, -1, -1, "" },
+        /*  8*/ { BARCODE_DATAMATRIX, MINIMAL_MODE, 1, ZINT_PHASE_ENCODE, "1234ABCDabcd1234*>", ZINT_WARN_TIME_BUDGET, -1, -1, "look_ahead_test() instead" },
+        /*  9*/ { BARCODE_DATAMATRIX, MINIMAL_MODE, 10000, ZINT_PHASE_ENCODE, "1234ABCDabcd1234*>", 0, MINIMAL_MODE, -1, "" },
+        /* 10*/ { BARCODE_DATAMATRIX, -1, 1, ZINT_PHASE_ENCODE, "1234ABCDabcd1234*>", 0, -1, -1, "Nothing to degrade" },
+        /* 11*/ { BARCODE_CODE128, -1, 1, ZINT_PHASE_ENCODE, "1234ABCD", 0, -1, -1, "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+        struct budget_stall stall = { 0, 5000 };
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        symbol->time_budget_ms = data[i].time_budget_ms;
+        stall.phase = data[i].stall_phase;
+        symbol->trace_func = stall_trace;
+        symbol->trace_context = &stall;
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        if (ret == ZINT_WARN_TIME_BUDGET) {
+            assert_zero(strcmp(symbol->errtxt, "Warning 743: Time budget exceeded, faster encoding used"), "i:%d errtxt %s\n", i, symbol->errtxt);
+        } else {
+            assert_zero(symbol->errtxt[0], "i:%d errtxt %s\n", i, symbol->errtxt);
+        }
+        assert_null(symbol->internal->budget, "i:%d symbol->internal->budget not NULL\n", i);
+
+        /* Same as encoding (afresh) with the faster settings */
+        struct zint_symbol *expected = ZBarcode_Create();
+        assert_nonnull(expected, "Symbol not created\n");
+        (void) testUtilSetSymbol(expected, data[i].symbology, data[i].expected_input_mode, -1 /*eci*/, -1 /*option_1*/, -1, data[i].expected_option_3, -1 /*output_options*/, data[i].data, -1, debug);
+        ret = ZBarcode_Encode(expected, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode expected ret %d != 0 (%s)\n", i, ret, expected->errtxt);
+
+        ret = testUtilSymbolCmp(symbol, expected);
+        assert_zero(ret, "i:%d testUtilSymbolCmp ret %d != 0 (%s)\n", i, ret, data[i].comment);
+
+        ZBarcode_Delete(expected);
+        ZBarcode_Delete(symbol);
+    }
 
     testFinish();
 }
@@ -596,12 +2693,34 @@ int main(int argc, char *argv[]) {
         { "test_input_mode", test_input_mode, 1, 0, 1 },
         { "test_escape_char_process", test_escape_char_process, 1, 1, 1 },
         { "test_cap", test_cap, 1, 0, 0 },
+        { "test_cap_common", test_cap_common, 0, 0, 0 },
         { "test_encode_file_length", test_encode_file_length, 0, 0, 0 },
         { "test_encode_file_directory", test_encode_file_directory, 0, 0, 0 },
+        { "test_encode_file_mapped", test_encode_file_mapped, 0, 0, 0 },
         { "test_bad_args", test_bad_args, 0, 0, 0 },
         { "test_valid_id", test_valid_id, 0, 0, 0 },
+        { "test_init", test_init, 0, 0, 0 },
         { "test_error_tag", test_error_tag, 1, 0, 0 },
         { "test_strip_bom", test_strip_bom, 0, 0, 0 },
+        { "test_input_unmodified", test_input_unmodified, 1, 0, 1 },
+        { "test_encode_batch", test_encode_batch, 1, 0, 1 },
+        { "test_encode_batch_fast", test_encode_batch_fast, 1, 0, 1 },
+        { "test_encode_sequence", test_encode_sequence, 1, 0, 1 },
+        { "test_encode_structapp", test_encode_structapp, 1, 0, 1 },
+        { "test_executor", test_executor, 1, 0, 1 },
+        { "test_submit", test_submit, 1, 0, 1 },
+        { "test_modules", test_modules, 1, 0, 1 },
+        { "test_allocator", test_allocator, 1, 0, 1 },
+        { "test_alloc_fail", test_alloc_fail, 1, 0, 1 },
+        { "test_serialize", test_serialize, 1, 0, 1 },
+        { "test_trace", test_trace, 1, 0, 1 },
+        { "test_trace_records", test_trace_records, 1, 1, 1 },
+        { "test_measure", test_measure, 1, 1, 1 },
+        { "test_prepared", test_prepared, 1, 0, 1 },
+        { "test_no_hrt", test_no_hrt, 1, 0, 1 },
+        { "test_set_colours", test_set_colours, 1, 0, 1 },
+        { "test_incremental", test_incremental, 1, 0, 1 },
+        { "test_time_budget", test_time_budget, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
@@ -210,6 +210,55 @@ static void test_input(int index, int generate, int debug) {
     testFinish();
 }
 
+static void test_structapp(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int option_1;
+        char *primary;
+        struct zint_structapp structapp;
+        char *data;
+        int ret;
+        char *expected;
+        char *comment;
+    };
+    struct item data[] = {
+        /*  0*/ { 4, "", { 1, 2, "" }, "A", 0, "(144) 04 21 01 01 21 21 21 21 21 21 09 0B 26 03 37 0E 25 27 07 1E 21 21 21 21 21 21 21 21", "PAD then 1 (index 1, count 2)" },
+        /*  1*/ { 4, "", { 8, 8, "" }, "A", 0, "(144) 04 21 3F 01 21 21 21 21 21 21 0A 3F 16 2E 2D 3B 2E 0F 1A 2F 21 21 21 21 21 21 21 21", "" },
+        /*  2*/ { 2, "152382802840001", { 3, 5, "" }, "A", 0, "(144) 22 14 2D 14 11 12 02 12 07 00 3D 35 0C 01 26 37 37 06 1F 28 21 14 01 21 21 21 21 21", "SA at start of secondary" },
+        /*  3*/ { 4, "", { 1, 1, "" }, "A", ZINT_ERROR_INVALID_OPTION, "Error 740: Structured Append count out of range (2-8)", "" },
+        /*  4*/ { 4, "", { 1, 9, "" }, "A", ZINT_ERROR_INVALID_OPTION, "Error 740: Structured Append count out of range (2-8)", "" },
+        /*  5*/ { 4, "", { 3, 2, "" }, "A", ZINT_ERROR_INVALID_OPTION, "Error 741: Structured Append index out of range (1-2)", "" },
+        /*  6*/ { 4, "", { 1, 2, "1" }, "A", ZINT_ERROR_INVALID_OPTION, "Error 742: Structured Append ID not available for MaxiCode", "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->debug = ZINT_DEBUG_TEST; // Needed to get codeword dump in errtxt
+
+        int length = testUtilSetSymbol(symbol, BARCODE_MAXICODE, -1 /*input_mode*/, -1 /*eci*/, data[i].option_1, -1 /*option_2*/, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        strcpy(symbol->primary, data[i].primary);
+        symbol->structapp = data[i].structapp;
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        assert_zero(strcmp(symbol->errtxt, data[i].expected), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 static void test_encode(int index, int generate, int debug) {
 
     testStart("");
@@ -1062,6 +1111,7 @@ int main(int argc, char *argv[]) {
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
         { "test_large", test_large, 1, 0, 1 },
         { "test_input", test_input, 1, 1, 1 },
+        { "test_structapp", test_structapp, 1, 0, 1 },
         { "test_encode", test_encode, 1, 1, 1 },
         { "test_best_supported_set", test_best_supported_set, 1, 1, 1 },
         { "test_fuzz", test_fuzz, 1, 0, 1 },
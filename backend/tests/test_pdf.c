@@ -0,0 +1,216 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include "testcommon.h"
+#include <sys/stat.h>
+
+static void test_print(int index, int generate, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int output_options;
+        int rotate_angle;
+        char *fgcolour;
+        char *bgcolour;
+        char *data;
+        char *expected_file;
+    };
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, UNICODE_MODE, BOLD_TEXT, 0, "", "", "Égjpqy", "../data/pdf/code128_egrave_bold.pdf" },
+        /*  1*/ { BARCODE_CODE128, UNICODE_MODE, -1, 0, "", "", "A\\B)ç(D", "../data/pdf/code128_escape_latin1.pdf" },
+        /*  2*/ { BARCODE_EANX, -1, -1, 90, "", "", "9771384524017+12", "../data/pdf/ean13_2addon_rotate_90.pdf" },
+        /*  3*/ { BARCODE_UPCE, -1, SMALL_TEXT | BOLD_TEXT, 270, "", "", "0123456+12345", "../data/pdf/upce_5addon_small_bold_rotate_270.pdf" },
+        /*  4*/ { BARCODE_ULTRA, -1, -1, 0, "147AD0", "FC9630", "123", "../data/pdf/ultra_fg_bg.pdf" },
+        /*  5*/ { BARCODE_MAXICODE, -1, -1, 0, "", "", "Hello1234", "../data/pdf/maxicode.pdf" },
+        /*  6*/ { BARCODE_DOTCODE, -1, CMYK_COLOUR, 180, "147AD0", "FC9630", "1234Hello", "../data/pdf/dotcode_cmyk_rotate_180.pdf" },
+        /*  7*/ { BARCODE_QRCODE, -1, -1, 0, "", "FFFFFF00", "1234Hello", "../data/pdf/qr_bg_transparent.pdf" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char *data_dir = "../data/pdf";
+    char pdf[256];
+    char escaped[1024];
+    int escaped_size = 1024;
+
+    if (generate) {
+        if (!testUtilExists(data_dir)) {
+            ret = mkdir(data_dir, 0755);
+            assert_zero(ret, "mkdir(%s) ret %d != 0\n", data_dir, ret);
+        }
+    }
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        testUtilOutFile(pdf, i, "pdf");
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (*data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+        if (*data[i].bgcolour) {
+            strcpy(symbol->bgcolour, data[i].bgcolour);
+        }
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+
+        strcpy(symbol->outfile, pdf);
+        ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+        assert_zero(ret, "i:%d %s ZBarcode_Print %s ret %d != 0\n", i, testUtilBarcodeName(data[i].symbology), symbol->outfile, ret);
+
+        if (generate) {
+            printf("        /*%3d*/ { %s, %s, %s, %d, \"%s\", \"%s\", \"%s\", \"%s\" },\n",
+                    i, testUtilBarcodeName(data[i].symbology), testUtilInputModeName(data[i].input_mode), testUtilOutputOptionsName(data[i].output_options),
+                    data[i].rotate_angle, data[i].fgcolour, data[i].bgcolour, testUtilEscape(data[i].data, length, escaped, escaped_size), data[i].expected_file);
+            ret = rename(symbol->outfile, data[i].expected_file);
+            assert_zero(ret, "i:%d rename(%s, %s) ret %d != 0\n", i, symbol->outfile, data[i].expected_file, ret);
+        } else {
+            assert_nonzero(testUtilExists(symbol->outfile), "i:%d testUtilExists(%s) == 0\n", i, symbol->outfile);
+            assert_nonzero(testUtilExists(data[i].expected_file), "i:%d testUtilExists(%s) == 0\n", i, data[i].expected_file);
+
+            ret = testUtilCmpBins(symbol->outfile, data[i].expected_file);
+            assert_zero(ret, "i:%d %s testUtilCmpBins(%s, %s) %d != 0\n", i, testUtilBarcodeName(data[i].symbology), symbol->outfile, data[i].expected_file, ret);
+            assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+/* Count occurrences of `str` in `length` bytes of `buf` */
+static int count_str(const unsigned char *buf, int length, const char *str) {
+    int count = 0;
+    int str_len = (int) strlen(str);
+    for (int i = 0; i + str_len <= length; i++) {
+        if (memcmp(buf + i, str, str_len) == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void test_multi(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        char *data;
+    };
+    /* Pages in order, with symbols 0 and 3 the same, and 2 being 1 with different options */
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, "1Z999AA10123456784" },
+        /*  1*/ { BARCODE_QRCODE, -1, "SHIP-0001" },
+        /*  2*/ { BARCODE_QRCODE, CMYK_COLOUR, "SHIP-0001" },
+        /*  3*/ { BARCODE_CODE128, -1, "1Z999AA10123456784" },
+        /*  4*/ { BARCODE_CODE128, BOLD_TEXT, "1Z999AA10123456785" },
+    };
+    int data_size = ARRAY_SIZE(data);
+    struct zint_symbol *symbols[ARRAY_SIZE(data)];
+
+    (void)index;
+
+    for (int i = 0; i < data_size; i++) {
+        symbols[i] = ZBarcode_Create();
+        assert_nonnull(symbols[i], "i:%d Symbol not created\n", i);
+
+        int length = testUtilSetSymbol(symbols[i], data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+
+        ret = ZBarcode_Encode(symbols[i], (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbols[i]->errtxt);
+    }
+    symbols[0]->output_options |= BARCODE_MEMORY_FILE;
+
+    ret = ZBarcode_Print_PDF(symbols, data_size, 0);
+    assert_zero(ret, "ZBarcode_Print_PDF ret %d != 0 (%s)\n", ret, symbols[0]->errtxt);
+    assert_nonnull(symbols[0]->memfile, "memfile NULL\n");
+
+    for (int i = 0; i < data_size; i++) {
+        assert_nonnull(symbols[i]->vector, "i:%d vector NULL\n", i);
+    }
+
+    const unsigned char *mem = symbols[0]->memfile;
+    int mem_size = symbols[0]->memfile_size;
+    assert_zero(memcmp(mem, "%PDF-1.4\n", 9), "Not PDF header\n");
+    assert_equal(count_str(mem, mem_size, "/Type /Page "), data_size, "Pages %d != %d\n", count_str(mem, mem_size, "/Type /Page "), data_size);
+    assert_equal(count_str(mem, mem_size, "/Subtype /Form"), 4, "Forms %d != 4\n", count_str(mem, mem_size, "/Subtype /Form"));
+    assert_equal(count_str(mem, mem_size, "/Type /Font"), 2, "Fonts %d != 2\n", count_str(mem, mem_size, "/Type /Font"));
+    assert_equal(count_str(mem, mem_size, "%%EOF\n"), 1, "EOF markers != 1\n");
+    assert_nonnull(strstr((const char *) mem, "/Count 5 >>"), "Page count not 5\n");
+
+    /* Errors */
+    ret = ZBarcode_Print_PDF(symbols, 0, 0);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "count 0 ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+    ret = ZBarcode_Print_PDF(symbols, data_size, 45);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "rotate 45 ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+    ret = ZBarcode_Print_PDF(NULL, data_size, 0);
+    assert_equal(ret, ZINT_ERROR_INVALID_DATA, "NULL ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+
+    struct zint_symbol *last = symbols[data_size - 1];
+    symbols[data_size - 1] = NULL;
+    ret = ZBarcode_Print_PDF(symbols, data_size, 0);
+    assert_equal(ret, ZINT_ERROR_INVALID_DATA, "NULL symbol ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+    assert_zero(strcmp(symbols[0]->errtxt, "Error 248: Invalid symbol"), "errtxt %s != Error 248: Invalid symbol\n", symbols[0]->errtxt);
+    symbols[data_size - 1] = last;
+
+    for (int i = 0; i < data_size; i++) {
+        ZBarcode_Delete(symbols[i]);
+    }
+
+    testFinish();
+}
+
+int main(int argc, char *argv[]) {
+
+    testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
+        { "test_print", test_print, 1, 1, 1 },
+        { "test_multi", test_multi, 1, 0, 1 },
+    };
+
+    testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
+
+    testReport();
+
+    return 0;
+}
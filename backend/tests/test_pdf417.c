@@ -70,6 +70,7 @@ static void test_options(int index, int debug) {
     int data_size = ARRAY_SIZE(data);
 
     struct zint_symbol previous_symbol;
+    struct zint_internal previous_internal;
 
     for (int i = 0; i < data_size; i++) {
 
@@ -98,7 +99,7 @@ static void test_options(int index, int debug) {
             ret = testUtilSymbolCmp(symbol, &previous_symbol);
             assert_equal(!ret, !data[i].compare_previous, "i:%d testUtilSymbolCmp !ret %d != %d\n", i, ret, data[i].compare_previous);
         }
-        memcpy(&previous_symbol, symbol, sizeof(previous_symbol));
+        testUtilSymbolCopy(&previous_symbol, &previous_internal, symbol);
 
         if (data[i].ret_vector != -1) {
             ret = ZBarcode_Buffer_Vector(symbol, 0);
@@ -215,6 +216,13 @@ static void test_input(int index, int generate, int debug) {
         /* 24*/ { BARCODE_HIBC_MICPDF, UNICODE_MODE, -1, ",", ZINT_ERROR_INVALID_DATA, 0, 0, 0, "Error 203: Invalid characters in data", "" },
         /* 25*/ { BARCODE_PDF417, UNICODE_MODE, -1, "AB{}  C#+  de{}  {}F  12{}  G{}  H", 0, 0, 12, 120, "(36) 28 1 865 807 896 782 855 626 807 94 865 807 896 808 776 839 176 808 32 776 839 806 208", "" },
         /* 26*/ { BARCODE_PDF417, UNICODE_MODE, -1, "{}  #+ de{}  12{}  {}  H", 0, 0, 10, 120, "(30) 22 865 807 896 808 470 807 94 865 807 896 808 32 776 839 806 865 807 896 787 900 900", "" },
+        /* 27*/ { BARCODE_PDF417, UNICODE_MODE | MINIMAL_MODE, -1, "AB{}  C#+  de{}  {}F  12{}  G{}  H", 0, 0, 11, 120, "(33) 25 1 896 897 806 88 470 836 783 148 776 839 806 896 897 178 806 32 776 839 806 209 809", "Fewer codewords than default" },
+        /* 28*/ { BARCODE_PDF417, UNICODE_MODE | MINIMAL_MODE, -1, "{}  #+ de{}  12{}  {}  H", 0, 0, 9, 120, "(27) 19 869 809 836 795 627 783 148 896 897 806 32 869 809 836 809 809 836 787 244 504 454", "" },
+        /* 29*/ { BARCODE_PDF417, UNICODE_MODE | MINIMAL_MODE, -1, "a1b2c3d4e5f6", 0, 0, 7, 120, "(21) 13 924 162 790 763 812 339 167 833 298 772 582 900 467 108 236 864 764 227 679 297", "Byte Compaction" },
+        /* 30*/ { BARCODE_PDF417, UNICODE_MODE | MINIMAL_MODE, 3, "é", 0, 3, 7, 103, "(14) 6 927 3 913 233 900 162 81 551 529 607 384 164 108", "Text latch not implied after ECI, same as default" },
+        /* 31*/ { BARCODE_PDF417, UNICODE_MODE | MINIMAL_MODE, -1, "ABCDEFG1234567890123HIJ", 0, 0, 8, 120, "(24) 16 1 63 125 208 32 902 184 533 177 823 900 218 299 900 900 52 757 568 95 220 589 306", "Same as default" },
+        /* 32*/ { BARCODE_MICROPDF417, UNICODE_MODE | MINIMAL_MODE, -1, "a1b2c3d4e5f6", 0, 0, 6, 99, "(24) 924 162 790 763 812 339 167 833 298 772 582 900 539 561 446 294 159 759 826 300 323 83", "" },
+        /* 33*/ { BARCODE_MICROPDF417, UNICODE_MODE | MINIMAL_MODE, -1, "Aaé12345678", 0, 0, 8, 55, "(16) 901 65 97 233 902 138 628 478 329 368 819 344 124 407 453 788", "Fewer codewords than default" },
     };
     int data_size = ARRAY_SIZE(data);
 
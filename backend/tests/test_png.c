@@ -31,8 +31,10 @@
 
 #include "testcommon.h"
 #include <sys/stat.h>
+#include <png.h>
 
 INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+INTERNAL int png_builtin_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
 
 static void test_pixel_plot(int index, int debug) {
 
@@ -62,7 +64,7 @@ static void test_pixel_plot(int index, int debug) {
     };
     int data_size = ARRAY_SIZE(data);
 
-    char *png = "out.png";
+    char png[256];
 
     char data_buf[8 * 2 + 1];
 
@@ -70,6 +72,8 @@ static void test_pixel_plot(int index, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(png, i, "png");
+
         struct zint_symbol *symbol = ZBarcode_Create();
         assert_nonnull(symbol, "Symbol not created\n");
 
@@ -185,11 +189,13 @@ static void test_print(int index, int generate, int debug) {
         /* 48*/ { BARCODE_MAXICODE, -1, 1, BARCODE_BIND, -1, 1, -1, -1, -1, 0, 0, "", "", "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "", "../data/png/maxicode_vwsp1_bind1.png", "" },
         /* 49*/ { BARCODE_DATAMATRIX, -1, 1, BARCODE_BIND | BARCODE_DOTTY_MODE, -1, -1, -1, -1, -1, 0, 2.0f, "", "", "1234", "", "../data/png/datamatrix_2.0_bind1_dotty.png", "" },
         /* 50*/ { BARCODE_DATAMATRIX, -1, 1, BARCODE_BIND | BARCODE_DOTTY_MODE, 1, 1, -1, -1, -1, 0, 2.0f, "", "", "1234", "", "../data/png/datamatrix_2.0_hvwsp1_bind1_dotty.png", "" },
+        /* 51*/ { BARCODE_CODE128, -1, -1, BARCODE_ANTIALIAS, -1, -1, -1, -1, -1, 0, 1.3f, "", "", "1234", "", "../data/png/code128_1.3_antialias.png", "" },
+        /* 52*/ { BARCODE_PDF417, -1, -1, BARCODE_ANTIALIAS, -1, -1, -1, -1, -1, 0, 0.7f, "30313233", "CFCECDCC", "12345", "", "../data/png/pdf417_0.7_bgfgalpha_antialias.png", "" },
     };
     int data_size = ARRAY_SIZE(data);
 
     char *data_dir = "../data/png";
-    char *png = "out.png";
+    char png[256];
     char escaped[1024];
     int escaped_size = 1024;
     char *text;
@@ -205,6 +211,8 @@ static void test_print(int index, int generate, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(png, i, "png");
+
         struct zint_symbol* symbol = ZBarcode_Create();
         assert_nonnull(symbol, "Symbol not created\n");
 
@@ -276,11 +284,448 @@ static void test_print(int index, int generate, int debug) {
     testFinish();
 }
 
+static int get_bit_depth(char *filename) {
+    unsigned char header[25];
+    FILE *fp = fopen(filename, "rb");
+    int ret;
+
+    if (!fp) {
+        return -1;
+    }
+    ret = (int) fread(header, 1, sizeof(header), fp);
+    fclose(fp);
+
+    /* IHDR bit depth is at offset 24 */
+    return ret == (int) sizeof(header) ? header[24] : -1;
+}
+
+/* Check compression choices (including fast) don't affect pixels, and resulting bit depth */
+static void test_compress(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int whitespace_width;
+        float scale;
+        char *data;
+        int expected_bit_depth;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, 0, "1234", 1 },
+        /*  1*/ { BARCODE_CODE128, -1, 12, "1234567890", 1 }, /* Rows > 258 bytes */
+        /*  2*/ { BARCODE_QRCODE, -1, 3.5f, "1234", 1 },
+        /*  3*/ { BARCODE_MAXICODE, -1, 0, "1234", 1 },
+        /*  4*/ { BARCODE_ULTRA, -1, 0, "1", 4 },
+        /*  5*/ { BARCODE_ULTRA, 1, 0, "123456789012345678901234567890", 4 },
+    };
+    int data_size = ARRAY_SIZE(data);
+    char png[256];
+    char png_fast[256];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        testUtilOutFile(png, i, "png");
+        testUtilOutFile(png_fast, i, "fast.png");
+
+        for (int j = 0; j < 2; j++) {
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, j ? BARCODE_FAST_COMPRESS : -1, data[i].data, -1, debug);
+            if (data[i].whitespace_width != -1) {
+                symbol->whitespace_width = data[i].whitespace_width;
+            }
+            if (data[i].scale) {
+                symbol->scale = data[i].scale;
+            }
+            strcpy(symbol->outfile, j ? png_fast : png);
+
+            ret = ZBarcode_Encode_and_Print(symbol, (unsigned char *) data[i].data, length, 0);
+            assert_zero(ret, "i:%d j:%d ZBarcode_Encode_and_Print ret %d != 0 (%s)\n", i, j, ret, symbol->errtxt);
+
+            ZBarcode_Delete(symbol);
+
+            ret = get_bit_depth(j ? png_fast : png);
+            assert_equal(ret, data[i].expected_bit_depth, "i:%d j:%d bit depth %d != %d\n", i, j, ret, data[i].expected_bit_depth);
+        }
+
+        ret = testUtilCmpPngs(png, png_fast);
+        assert_zero(ret, "i:%d testUtilCmpPngs(%s, %s) %d != 0\n", i, png, png_fast, ret);
+
+        assert_zero(remove(png), "i:%d remove(%s) != 0\n", i, png);
+        assert_zero(remove(png_fast), "i:%d remove(%s) != 0\n", i, png_fast);
+    }
+
+    testFinish();
+}
+
+/* Check Ultracode palette only includes colours used */
+static void test_ultra_palette(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        char *pattern;
+        int expected_bit_depth;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { "WKWKWKWK", 1 },
+        /*  1*/ { "WKCWKCWK", 2 },
+        /*  2*/ { "RKCWKCWR", 2 },
+        /*  3*/ { "RKCWKCWY", 4 },
+        /*  4*/ { "WKCBMRYG", 4 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    static const char colour_chars[] = "WCBMRYGK";
+    static const unsigned char colours[8][3] = {
+        { 0xff, 0xff, 0xff }, { 0, 0xff, 0xff }, { 0, 0, 0xff }, { 0xff, 0, 0xff },
+        { 0xff, 0, 0 }, { 0xff, 0xff, 0 }, { 0, 0xff, 0 }, { 0, 0, 0 },
+    };
+    char png[256];
+    char data_buf[8 + 1];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        testUtilOutFile(png, i, "png");
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->symbology = BARCODE_ULTRA;
+        symbol->bitmap_width = 4;
+        symbol->bitmap_height = 2;
+        symbol->debug |= debug;
+
+        strcpy(data_buf, data[i].pattern);
+        strcpy(symbol->outfile, png);
+        ret = png_pixel_plot(symbol, (unsigned char *) data_buf);
+        assert_zero(ret, "i:%d png_pixel_plot ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        ret = get_bit_depth(png);
+        assert_equal(ret, data[i].expected_bit_depth, "i:%d bit depth %d != %d\n", i, ret, data[i].expected_bit_depth);
+
+        /* Check colours */
+        png_image image;
+        unsigned char rgb[8 * 3];
+        memset(&image, 0, sizeof(image));
+        image.version = PNG_IMAGE_VERSION;
+        ret = png_image_begin_read_from_file(&image, png);
+        assert_nonzero(ret, "i:%d png_image_begin_read_from_file fail (%s)\n", i, image.message);
+        image.format = PNG_FORMAT_RGB;
+        ret = png_image_finish_read(&image, NULL, rgb, 0, NULL);
+        assert_nonzero(ret, "i:%d png_image_finish_read fail (%s)\n", i, image.message);
+        for (int j = 0; j < 8; j++) {
+            const char *colour = strchr(colour_chars, data[i].pattern[j]);
+            const unsigned char *expected = colours[colour - colour_chars];
+            assert_zero(memcmp(rgb + j * 3, expected, 3), "i:%d j:%d pixel %02X%02X%02X != %02X%02X%02X\n",
+                        i, j, rgb[j * 3], rgb[j * 3 + 1], rgb[j * 3 + 2], expected[0], expected[1], expected[2]);
+        }
+
+        ZBarcode_Delete(symbol);
+
+        assert_zero(remove(png), "i:%d remove(%s) != 0\n", i, png);
+    }
+
+    testFinish();
+}
+
+static void test_builtin(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int whitespace_width;
+        float scale;
+        char *fgcolour;
+        char *bgcolour;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, 0, "", "", "1234" },
+        /*  1*/ { BARCODE_CODE128, -1, 12, "", "", "1234567890" }, /* Rows > 258 bytes */
+        /*  2*/ { BARCODE_QRCODE, -1, 3.5f, "", "", "1234" },
+        /*  3*/ { BARCODE_MAXICODE, -1, 0, "", "", "1234" },
+        /*  4*/ { BARCODE_DOTCODE, -1, 0, "", "", "1234" },
+        /*  5*/ { BARCODE_ULTRA, -1, 0, "", "", "1" },
+        /*  6*/ { BARCODE_ULTRA, 1, 0, "", "FFFFFF80", "123456789012345678901234567890" },
+        /*  7*/ { BARCODE_DATAMATRIX, -1, 0, "FF000080", "00FF0000", "1234" },
+        /*  8*/ { -1, -1, 0, "", "", "" }, /* Pseudo-random Ultracode colours, so stored */
+    };
+    int data_size = ARRAY_SIZE(data);
+    char png[256];
+    char png_builtin[256];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        testUtilOutFile(png, i, "png");
+        testUtilOutFile(png_builtin, i, "builtin.png");
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        unsigned char *pixelbuf;
+        unsigned char random_buf[64 * 64];
+        if (data[i].symbology == -1) {
+            static const char colour_chars[] = "WCBMRYGK";
+            unsigned int seed = 12345;
+            for (int j = 0; j < (int) sizeof(random_buf); j++) {
+                seed = seed * 1103515245 + 12345;
+                random_buf[j] = colour_chars[(seed >> 16) & 7];
+            }
+            symbol->symbology = BARCODE_ULTRA;
+            symbol->bitmap_width = symbol->bitmap_height = 64;
+            symbol->debug |= debug;
+            pixelbuf = random_buf;
+        } else {
+            int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, OUT_BUFFER_INTERMEDIATE, data[i].data, -1, debug);
+            if (data[i].whitespace_width != -1) {
+                symbol->whitespace_width = data[i].whitespace_width;
+            }
+            if (data[i].scale) {
+                symbol->scale = data[i].scale;
+            }
+            if (*data[i].fgcolour) {
+                strcpy(symbol->fgcolour, data[i].fgcolour);
+            }
+            if (*data[i].bgcolour) {
+                strcpy(symbol->bgcolour, data[i].bgcolour);
+            }
+
+            ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, 0);
+            assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            pixelbuf = symbol->bitmap;
+        }
+
+        strcpy(symbol->outfile, png);
+        ret = png_pixel_plot(symbol, pixelbuf);
+        assert_zero(ret, "i:%d png_pixel_plot ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        strcpy(symbol->outfile, png_builtin);
+        ret = png_builtin_pixel_plot(symbol, pixelbuf);
+        assert_zero(ret, "i:%d png_builtin_pixel_plot ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        ZBarcode_Delete(symbol);
+
+        ret = get_bit_depth(png_builtin);
+        int expected_bit_depth = get_bit_depth(png);
+        assert_equal(ret, expected_bit_depth, "i:%d bit depth %d != %d\n", i, ret, expected_bit_depth);
+
+        ret = testUtilCmpPngs(png, png_builtin);
+        assert_zero(ret, "i:%d testUtilCmpPngs(%s, %s) %d != 0\n", i, png, png_builtin, ret);
+
+        if (testUtilHaveIdentify()) {
+            ret = testUtilVerifyIdentify(png_builtin, debug);
+            assert_zero(ret, "i:%d identify %s ret %d != 0\n", i, png_builtin, ret);
+        }
+
+        assert_zero(remove(png), "i:%d remove(%s) != 0\n", i, png);
+        assert_zero(remove(png_builtin), "i:%d remove(%s) != 0\n", i, png_builtin);
+    }
+
+    testFinish();
+}
+
+/* Return number of IDAT chunks in PNG `filename`, or -1 on error */
+static int count_idats(char *filename) {
+    unsigned char buf[8];
+    FILE *fp = fopen(filename, "rb");
+    int count = 0;
+
+    if (!fp) {
+        return -1;
+    }
+    if (fread(buf, 1, 8, fp) != 8) { /* Signature */
+        fclose(fp);
+        return -1;
+    }
+    while (fread(buf, 1, 8, fp) == 8) {
+        long length = ((long) buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+        if (memcmp(buf + 4, "IDAT", 4) == 0) {
+            count++;
+        }
+        if (fseek(fp, length + 4, SEEK_CUR) != 0) { /* Data and CRC */
+            fclose(fp);
+            return -1;
+        }
+    }
+    fclose(fp);
+
+    return count;
+}
+
+/* Check parallel deflate gives the same pixels, with one IDAT per band */
+static void test_parallel(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        int rotate_angle;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_PDF417, -1, 20, 0, "1234567890123456789012345678901234567890" },
+        /*  1*/ { BARCODE_PDF417, BARCODE_FAST_COMPRESS, 20, 0, "1234567890123456789012345678901234567890" },
+        /*  2*/ { BARCODE_PDF417, -1, 20, 90, "1234567890123456789012345678901234567890" },
+        /*  3*/ { BARCODE_CODE128, -1, 50, 0, "1234567890" }, /* All rows repeated */
+        /*  4*/ { BARCODE_MAXICODE, -1, 30, 270, "1234" },
+        /*  5*/ { BARCODE_ULTRA, -1, 40, 180, "123456789012345678901234567890" },
+        /*  6*/ { BARCODE_QRCODE, BARCODE_ANTIALIAS, 10.3f, 0, "1234567890" },
+        /*  7*/ { BARCODE_QRCODE, -1, 1, 0, "1234" }, /* Single band, so not parallel */
+    };
+    int data_size = ARRAY_SIZE(data);
+    char png[256];
+    char png_parallel[256];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        testUtilOutFile(png, i, "png");
+        testUtilOutFile(png_parallel, i, "parallel.png");
+
+        int bitmap_width = 0, bitmap_height = 0;
+        for (int j = 0; j < 2; j++) {
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            int output_options = data[i].output_options == -1 ? 0 : data[i].output_options;
+            if (j) {
+                output_options |= PNG_PARALLEL;
+            }
+            int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, output_options, data[i].data, -1, debug);
+            symbol->scale = data[i].scale;
+            strcpy(symbol->outfile, j ? png_parallel : png);
+
+            ret = ZBarcode_Encode_and_Print(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+            assert_zero(ret, "i:%d j:%d ZBarcode_Encode_and_Print ret %d != 0 (%s)\n", i, j, ret, symbol->errtxt);
+            bitmap_width = symbol->bitmap_width;
+            bitmap_height = symbol->bitmap_height;
+
+            ZBarcode_Delete(symbol);
+        }
+
+        ret = testUtilCmpPngs(png, png_parallel);
+        assert_zero(ret, "i:%d testUtilCmpPngs(%s, %s) %d != 0\n", i, png, png_parallel, ret);
+
+        /* Matches `band_rows()` in "png.c" */
+        int row_bytes = (bitmap_width * get_bit_depth(png_parallel) + 7) / 8;
+        int rows_per_band = 0x40000 / (row_bytes + 1);
+        int expected_idats = (bitmap_height + rows_per_band - 1) / rows_per_band;
+        if (expected_idats > 1) {
+            ret = count_idats(png_parallel);
+            assert_equal(ret, expected_idats, "i:%d IDATs %d != %d\n", i, ret, expected_idats);
+        }
+
+        if (testUtilHaveIdentify()) {
+            ret = testUtilVerifyIdentify(png_parallel, debug);
+            assert_zero(ret, "i:%d identify %s ret %d != 0\n", i, png_parallel, ret);
+        }
+
+        assert_zero(remove(png), "i:%d remove(%s) != 0\n", i, png);
+        assert_zero(remove(png_parallel), "i:%d remove(%s) != 0\n", i, png_parallel);
+    }
+
+    testFinish();
+}
+
+/* Check reusing a symbol (and so its deflate context) gives the same output as a fresh one */
+static void test_reuse(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, -1, 0, "1234" },
+        /*  1*/ { BARCODE_QRCODE, -1, 0, "1234" }, /* Same again, so context reset */
+        /*  2*/ { BARCODE_CODE128, -1, 0, "1234567890" }, /* Different window */
+        /*  3*/ { BARCODE_CODE128, BARCODE_FAST_COMPRESS, 0, "1234567890" }, /* Different level */
+        /*  4*/ { BARCODE_MAXICODE, -1, 0, "1234" },
+        /*  5*/ { BARCODE_ULTRA, -1, 0, "1234" },
+        /*  6*/ { BARCODE_DATAMATRIX, -1, 20, "1234" }, /* Large, so not using context */
+        /*  7*/ { BARCODE_QRCODE, -1, 0, "1234" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct zint_symbol *reused = ZBarcode_Create();
+    assert_nonnull(reused, "Symbol not created\n");
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int output_options = BARCODE_MEMORY_FILE | (data[i].output_options == -1 ? 0 : data[i].output_options);
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+        strcpy(symbol->outfile, "mem.png");
+
+        ZBarcode_Clear(reused);
+        reused->symbology = symbol->symbology;
+        reused->height = symbol->height;
+        memset(reused->row_height, 0, sizeof(reused->row_height)); /* Not reset by `ZBarcode_Clear()` */
+        reused->output_options = symbol->output_options;
+        reused->scale = symbol->scale;
+        reused->debug = symbol->debug;
+        strcpy(reused->outfile, symbol->outfile);
+
+        ret = ZBarcode_Encode_and_Print(symbol, (unsigned char *) data[i].data, length, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Print ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        ret = ZBarcode_Encode_and_Print(reused, (unsigned char *) data[i].data, length, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Print(reused) ret %d != 0 (%s)\n", i, ret, reused->errtxt);
+
+        assert_nonnull(reused->memfile, "i:%d reused memfile NULL\n", i);
+        assert_equal(reused->memfile_size, symbol->memfile_size, "i:%d memfile_size %d != %d\n", i, reused->memfile_size, symbol->memfile_size);
+        assert_zero(memcmp(reused->memfile, symbol->memfile, symbol->memfile_size), "i:%d memfile differs\n", i);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    ZBarcode_Delete(reused);
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
         { "test_pixel_plot", test_pixel_plot, 1, 0, 1 },
         { "test_print", test_print, 1, 1, 1 },
+        { "test_compress", test_compress, 1, 0, 1 },
+        { "test_ultra_palette", test_ultra_palette, 1, 0, 1 },
+        { "test_builtin", test_builtin, 1, 0, 1 },
+        { "test_parallel", test_parallel, 1, 0, 1 },
+        { "test_reuse", test_reuse, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
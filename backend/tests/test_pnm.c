@@ -0,0 +1,142 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include "testcommon.h"
+#include <sys/stat.h>
+
+static void test_print(int index, int generate, int debug) {
+
+    testStart("");
+
+    int have_identify = testUtilHaveIdentify();
+
+    int ret;
+    struct item {
+        int symbology;
+        int whitespace_width;
+        int option_1;
+        int option_2;
+        float scale;
+        char *fgcolour;
+        char *bgcolour;
+        char* data;
+        char* expected_file;
+    };
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, -1, -1, 0, "", "", "AIM", "../data/pnm/code128.pbm" },
+        /*  1*/ { BARCODE_CODE128, -1, -1, -1, 0, "", "", "AIM", "../data/pnm/code128.pgm" },
+        /*  2*/ { BARCODE_PDF417, 5, -1, -1, 0, "147AD0", "FC9630", "123", "../data/pnm/pdf417_fg_bg.pbm" },
+        /*  3*/ { BARCODE_PDF417, 5, -1, -1, 0, "147AD0", "FC9630", "123", "../data/pnm/pdf417_fg_bg.pgm" },
+        /*  4*/ { BARCODE_ULTRA, 5, -1, -1, 0, "147AD0", "FC9630", "123", "../data/pnm/ultracode_fg_bg.pbm" },
+        /*  5*/ { BARCODE_ULTRA, 5, -1, -1, 0, "147AD0", "FC9630", "123", "../data/pnm/ultracode_fg_bg.pgm" },
+        /*  6*/ { BARCODE_QRCODE, -1, 2, 1, 0, "FFFFFF", "000000", "1234567890", "../data/pnm/qr_reverse.pbm" },
+        /*  7*/ { BARCODE_DAFT, -1, -1, -1, 0.5, "", "", "FADT", "../data/pnm/daft_odd_width.pbm" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char* data_dir = "../data/pnm";
+    char escaped[1024];
+    int escaped_size = 1024;
+
+    if (generate) {
+        if (!testUtilExists(data_dir)) {
+            ret = mkdir(data_dir, 0755);
+            assert_zero(ret, "mkdir(%s) ret %d != 0\n", data_dir, ret);
+        }
+    }
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol* symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, data[i].option_1, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        if (data[i].whitespace_width != -1) {
+            symbol->whitespace_width = data[i].whitespace_width;
+        }
+        if (data[i].scale != 0) {
+            symbol->scale = data[i].scale;
+        }
+        if (*data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+        if (*data[i].bgcolour) {
+            strcpy(symbol->bgcolour, data[i].bgcolour);
+        }
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+
+        /* Output file type from extension of expected file */
+        testUtilOutFile(symbol->outfile, i, strrchr(data[i].expected_file, '.') + 1);
+        ret = ZBarcode_Print(symbol, 0);
+        assert_zero(ret, "i:%d %s ZBarcode_Print %s ret %d != 0\n", i, testUtilBarcodeName(data[i].symbology), symbol->outfile, ret);
+
+        if (generate) {
+            printf("        /*%3d*/ { %s, %d, %d, %d, %.8g, \"%s\", \"%s\", \"%s\", \"%s\" },\n",
+                    i, testUtilBarcodeName(data[i].symbology), data[i].whitespace_width,
+                    data[i].option_1, data[i].option_2, data[i].scale, data[i].fgcolour, data[i].bgcolour,
+                    testUtilEscape(data[i].data, length, escaped, escaped_size), data[i].expected_file);
+            ret = rename(symbol->outfile, data[i].expected_file);
+            assert_zero(ret, "i:%d rename(%s, %s) ret %d != 0\n", i, symbol->outfile, data[i].expected_file, ret);
+            if (have_identify) {
+                ret = testUtilVerifyIdentify(data[i].expected_file, debug);
+                assert_zero(ret, "i:%d %s identify %s ret %d != 0\n", i, testUtilBarcodeName(data[i].symbology), data[i].expected_file, ret);
+            }
+        } else {
+            assert_nonzero(testUtilExists(symbol->outfile), "i:%d testUtilExists(%s) == 0\n", i, symbol->outfile);
+            assert_nonzero(testUtilExists(data[i].expected_file), "i:%d testUtilExists(%s) == 0\n", i, data[i].expected_file);
+
+            ret = testUtilCmpBins(symbol->outfile, data[i].expected_file);
+            assert_zero(ret, "i:%d %s testUtilCmpBins(%s, %s) %d != 0\n", i, testUtilBarcodeName(data[i].symbology), symbol->outfile, data[i].expected_file, ret);
+            assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+int main(int argc, char *argv[]) {
+
+    testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
+        { "test_print", test_print, 1, 1, 1 },
+    };
+
+    testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
+
+    testReport();
+
+    return 0;
+}
@@ -120,8 +120,7 @@ static void test_print(int index, int generate, int debug) {
             ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
             assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
 
-            strcpy(symbol->outfile, "out.");
-            strcat(symbol->outfile, exts[j]);
+            testUtilOutFile(symbol->outfile, i, exts[j]);
 
             strcpy(expected_file, data_dir);
             strcat(expected_file, "/");
@@ -197,10 +196,348 @@ static void test_print(int index, int generate, int debug) {
     testFinish();
 }
 
+static void test_memfile(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int rotate_angle;
+        char *data;
+    };
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, 0, "AIM" },
+        /*  1*/ { BARCODE_QRCODE, 90, "1234567890" },
+        /*  2*/ { BARCODE_ULTRA, 0, "A" },
+        /*  3*/ { BARCODE_MAXICODE, 180, "THIS IS A 93 CHARACTER CODE SET A MESSAGE THAT FILLS A MODE 4, UNAPPENDED, MAXICODE SYMBOL..." },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char *exts[] = { "bmp", "emf", "eps", "gif", "pbm", "pcx", "pgm", "png", "svg", "tif", "txt" };
+    int exts_len = ARRAY_SIZE(exts);
+
+    for (int j = 0; j < exts_len; j++) {
+#ifdef NO_PNG
+        if (strcmp(exts[j], "png") == 0) continue;
+#endif
+        for (int i = 0; i < data_size; i++) {
+
+            if (index != -1 && i != index) continue;
+
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+
+            ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+            assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+
+            char out_file[256];
+            testUtilOutFile(out_file, i, exts[j]);
+            strcpy(symbol->outfile, out_file);
+
+            ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d j:%d %s ZBarcode_Print ret %d != 0 (%s)\n", i, j, exts[j], ret, symbol->errtxt);
+            assert_null(symbol->memfile, "i:%d j:%d %s memfile non-NULL\n", i, j, exts[j]);
+
+            FILE *fp = fopen(symbol->outfile, "rb");
+            assert_nonnull(fp, "i:%d j:%d fopen(%s) failed\n", i, j, symbol->outfile);
+            fseek(fp, 0, SEEK_END);
+            long file_size = ftell(fp);
+            fseek(fp, 0, SEEK_SET);
+            assert_nonzero(file_size > 0, "i:%d j:%d %s file_size %ld <= 0\n", i, j, exts[j], file_size);
+            char *file_buf = (char *) malloc(file_size);
+            assert_nonnull(file_buf, "i:%d j:%d malloc failed\n", i, j);
+            assert_equal((long) fread(file_buf, 1, file_size, fp), file_size, "i:%d j:%d fread failed\n", i, j);
+            fclose(fp);
+
+            /* Same plotted straight into a memory-mapped file (BMP and PBM/PGM only, others ignore OUT_FILE_MMAP) */
+            symbol->output_options |= OUT_FILE_MMAP;
+            char mmap_ext[24];
+            sprintf(mmap_ext, "mmap.%s", exts[j]);
+            testUtilOutFile(symbol->outfile, i, mmap_ext);
+            ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d j:%d %s ZBarcode_Print mmap ret %d != 0 (%s)\n", i, j, exts[j], ret, symbol->errtxt);
+            ret = testUtilCmpBins(symbol->outfile, out_file);
+            assert_zero(ret, "i:%d j:%d %s testUtilCmpBins(%s, %s) %d != 0\n", i, j, exts[j], symbol->outfile, out_file, ret);
+            assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
+            assert_zero(remove(out_file), "i:%d remove(%s) != 0\n", i, out_file);
+            symbol->output_options &= ~OUT_FILE_MMAP;
+
+            symbol->output_options |= BARCODE_MEMORY_FILE;
+            strcpy(symbol->outfile, "mem.");
+            strcat(symbol->outfile, exts[j]);
+
+            ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d j:%d %s ZBarcode_Print memory ret %d != 0 (%s)\n", i, j, exts[j], ret, symbol->errtxt);
+            assert_zero(testUtilExists(symbol->outfile), "i:%d j:%d %s testUtilExists(%s) != 0\n", i, j, exts[j], symbol->outfile);
+            assert_nonnull(symbol->memfile, "i:%d j:%d %s memfile NULL\n", i, j, exts[j]);
+            assert_equal(symbol->memfile_size, file_size, "i:%d j:%d %s memfile_size %d != file_size %ld\n", i, j, exts[j], symbol->memfile_size, file_size);
+            assert_zero(memcmp(symbol->memfile, file_buf, file_size), "i:%d j:%d %s memcmp != 0\n", i, j, exts[j]);
+
+            /* Second print replaces previous memory file */
+            ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d j:%d %s ZBarcode_Print memory 2nd ret %d != 0 (%s)\n", i, j, exts[j], ret, symbol->errtxt);
+            assert_equal(symbol->memfile_size, file_size, "i:%d j:%d %s memfile_size %d != file_size %ld\n", i, j, exts[j], symbol->memfile_size, file_size);
+
+            ZBarcode_Clear(symbol);
+            assert_null(symbol->memfile, "i:%d j:%d %s memfile non-NULL after clear\n", i, j, exts[j]);
+            assert_zero(symbol->memfile_size, "i:%d j:%d %s memfile_size %d != 0 after clear\n", i, j, exts[j], symbol->memfile_size);
+
+            free(file_buf);
+            ZBarcode_Delete(symbol);
+        }
+    }
+
+    testFinish();
+}
+
+struct write_func_buf {
+    unsigned char *buf;
+    int size;
+    int calls;
+    int fail; /* Fail if set */
+};
+
+static int write_func(void *write_context, const unsigned char *data, int length) {
+    struct write_func_buf *wfb = (struct write_func_buf *) write_context;
+    unsigned char *new_buf;
+
+    if (wfb->fail) {
+        return 1;
+    }
+    wfb->calls++;
+    if (!(new_buf = (unsigned char *) realloc(wfb->buf, wfb->size + length))) {
+        return 1;
+    }
+    wfb->buf = new_buf;
+    memcpy(wfb->buf + wfb->size, data, length);
+    wfb->size += length;
+    return 0;
+}
+
+static void test_write_func(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int rotate_angle;
+        char *data;
+    };
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, 0, "AIM" },
+        /*  1*/ { BARCODE_QRCODE, 90, "1234567890" },
+        /*  2*/ { BARCODE_ULTRA, 0, "A" },
+        /*  3*/ { BARCODE_MAXICODE, 180, "THIS IS A 93 CHARACTER CODE SET A MESSAGE THAT FILLS A MODE 4, UNAPPENDED, MAXICODE SYMBOL..." },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char *exts[] = { "bmp", "emf", "eps", "gif", "pcx", "png", "svg", "tif", "txt" };
+    int exts_len = ARRAY_SIZE(exts);
+
+    for (int j = 0; j < exts_len; j++) {
+#ifdef NO_PNG
+        if (strcmp(exts[j], "png") == 0) continue;
+#endif
+        for (int i = 0; i < data_size; i++) {
+            struct write_func_buf wfb = { NULL, 0, 0, 0 };
+
+            if (index != -1 && i != index) continue;
+
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1, -1, -1, BARCODE_STDOUT /*output_options*/, data[i].data, -1, debug);
+
+            ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+            assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+
+            strcpy(symbol->outfile, "func.");
+            strcat(symbol->outfile, exts[j]);
+
+            /* No callback set */
+            symbol->output_options = BARCODE_WRITE_FUNC;
+            ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+            assert_equal(ret, ZINT_ERROR_FILE_ACCESS, "i:%d j:%d %s ZBarcode_Print no func ret %d != ZINT_ERROR_FILE_ACCESS (%s)\n", i, j, exts[j], ret, symbol->errtxt);
+
+            /* Memory file as reference */
+            symbol->output_options = BARCODE_MEMORY_FILE;
+            ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d j:%d %s ZBarcode_Print memory ret %d != 0 (%s)\n", i, j, exts[j], ret, symbol->errtxt);
+            assert_nonnull(symbol->memfile, "i:%d j:%d %s memfile NULL\n", i, j, exts[j]);
+
+            symbol->output_options = BARCODE_WRITE_FUNC | BARCODE_STDOUT; /* BARCODE_WRITE_FUNC has priority */
+            symbol->write_func = write_func;
+            symbol->write_context = &wfb;
+            ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d j:%d %s ZBarcode_Print func ret %d != 0 (%s)\n", i, j, exts[j], ret, symbol->errtxt);
+            assert_zero(testUtilExists(symbol->outfile), "i:%d j:%d %s testUtilExists(%s) != 0\n", i, j, exts[j], symbol->outfile);
+            assert_nonzero(wfb.calls, "i:%d j:%d %s wfb.calls zero\n", i, j, exts[j]);
+            assert_equal(wfb.size, symbol->memfile_size, "i:%d j:%d %s wfb.size %d != memfile_size %d\n", i, j, exts[j], wfb.size, symbol->memfile_size);
+            assert_zero(memcmp(wfb.buf, symbol->memfile, wfb.size), "i:%d j:%d %s memcmp != 0\n", i, j, exts[j]);
+
+            /* Callback failure */
+            free(wfb.buf);
+            wfb.buf = NULL;
+            wfb.size = wfb.calls = 0;
+            wfb.fail = 1;
+            ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+            assert_equal(ret, ZINT_ERROR_FILE_WRITE, "i:%d j:%d %s ZBarcode_Print fail ret %d != ZINT_ERROR_FILE_WRITE (%s)\n", i, j, exts[j], ret, symbol->errtxt);
+
+            free(wfb.buf);
+            ZBarcode_Delete(symbol);
+        }
+    }
+
+    testFinish();
+}
+
+static void test_print_multi(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        int rotate_angle;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, 0, 0, "AIM" },
+        /*  1*/ { BARCODE_QRCODE, -1, 0, 90, "1234567890" },
+        /*  2*/ { BARCODE_MAXICODE, -1, 0, 180, "THIS IS A 93 CHARACTER CODE SET A MESSAGE THAT FILLS A MODE 4, UNAPPENDED, MAXICODE SYMBOL..." },
+        /*  3*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 0, 270, "1234567890" },
+        /*  4*/ { BARCODE_QRCODE, BARCODE_ANTIALIAS, 2.5f, 0, "1234567890" },
+        /*  5*/ { BARCODE_PDF417, VECTOR_TRANSFORM, 0, 90, "1234567890" },
+        /*  6*/ { BARCODE_ULTRA, -1, 0, 0, "A" },
+        /*  7*/ { BARCODE_EANX, BARCODE_BOX, 1.5f, 270, "123456789012+12" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    const char *exts[] = {
+        "bmp", "emf", "eps", "gif", "pbm", "pcx", "pgm", "svg", "tif", "txt", "qoi", "pdf",
+#ifndef NO_PNG
+        "png", "svgz",
+#endif
+    };
+    const int exts_len = ARRAY_SIZE(exts);
+    char multi_files[ARRAY_SIZE(exts)][256];
+    const char *outfiles[ARRAY_SIZE(exts)];
+    char ext_buf[24];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        for (int j = 0; j < exts_len; j++) {
+            sprintf(ext_buf, "out.%s", exts[j]);
+            outfiles[j] = testUtilOutFile(multi_files[j], i, ext_buf);
+        }
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+
+        strcpy(symbol->outfile, "unchanged.svg");
+        ret = ZBarcode_Print_Multi(symbol, data[i].rotate_angle, outfiles, exts_len);
+        assert_zero(ret, "i:%d ZBarcode_Print_Multi ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_zero(strcmp(symbol->outfile, "unchanged.svg"), "i:%d outfile %s changed\n", i, symbol->outfile);
+
+        for (int j = 0; j < exts_len; j++) {
+            char ref_file[256];
+            sprintf(ext_buf, "ref.%s", exts[j]);
+            testUtilOutFile(ref_file, i, ext_buf);
+            strcpy(symbol->outfile, ref_file);
+            ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d ZBarcode_Print %s ret %d != 0 (%s)\n", i, ref_file, ret, symbol->errtxt);
+
+            ret = testUtilCmpBins(multi_files[j], ref_file);
+            assert_zero(ret, "i:%d %s testUtilCmpBins(%s, %s) %d != 0\n", i, testUtilBarcodeName(data[i].symbology), multi_files[j], ref_file, ret);
+
+            if (!(debug & ZINT_DEBUG_TEST_KEEP_OUTFILE)) {
+                assert_zero(remove(multi_files[j]), "i:%d remove(%s) != 0\n", i, multi_files[j]);
+                assert_zero(remove(ref_file), "i:%d remove(%s) != 0\n", i, ref_file);
+            }
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_print_multi_args(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int output_options;
+        int rotate_angle;
+        int count;
+        const char *outfiles[2];
+        int ret;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { -1, 0, 0, { "out.svg", NULL }, ZINT_ERROR_INVALID_DATA, "Error 750: Output files NULL or count not positive" },
+        /*  1*/ { -1, 45, 1, { "out.svg", NULL }, ZINT_ERROR_INVALID_OPTION, "Error 223: Invalid rotation angle" },
+        /*  2*/ { BARCODE_MEMORY_FILE, 0, 2, { "out.svg", "out.png" }, ZINT_ERROR_INVALID_OPTION, "Error 751: Memory file output limited to one output file" },
+        /*  3*/ { -1, 0, 2, { "out.svg", "out.jpg" }, ZINT_ERROR_INVALID_OPTION, "Error 754: Output file 1 unknown output format" },
+        /*  4*/ { -1, 0, 2, { "out.svg", "out.vgz" }, ZINT_ERROR_INVALID_OPTION, "Error 754: Output file 1 unknown output format" },
+        /*  5*/ { -1, 0, 2, { NULL, "out.svg" }, ZINT_ERROR_INVALID_OPTION, "Error 754: Output file 0 unknown output format" },
+        /*  6*/ { -1, 0, 2, { "out.svg", "out_too_long_012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789.svg" }, ZINT_ERROR_INVALID_OPTION, "Error 753: Output file 1 name too long" },
+        /*  7*/ { BARCODE_MEMORY_FILE, 0, 1, { "out.svg", NULL }, 0, "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, BARCODE_CODE128, -1 /*input_mode*/, -1 /*eci*/, -1, -1, -1, data[i].output_options, "A", -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) "A", length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 %s\n", i, ret, symbol->errtxt);
+
+        ret = ZBarcode_Print_Multi(symbol, data[i].rotate_angle, data[i].outfiles, data[i].count);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Print_Multi ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d errtxt %s != %s\n", i, symbol->errtxt, data[i].expected_errtxt);
+        if (ret == 0) {
+            assert_nonzero(symbol->memfile_size, "i:%d memfile_size 0\n", i);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
         { "test_print", test_print, 1, 1, 1 },
+        { "test_memfile", test_memfile, 1, 0, 1 },
+        { "test_write_func", test_write_func, 1, 0, 1 },
+        { "test_print_multi", test_print_multi, 1, 0, 1 },
+        { "test_print_multi_args", test_print_multi_args, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
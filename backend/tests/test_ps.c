@@ -61,11 +61,16 @@ static void test_print(int index, int generate, int debug) {
         /*  6*/ { BARCODE_UPCE, -1, SMALL_TEXT | BOLD_TEXT, -1, -1, -1, "", "", "0123456+12345", "../data/eps/upce_5addon_small_bold.eps" },
         /*  7*/ { BARCODE_CODE128, UNICODE_MODE, -1, -1, -1, -1, "", "", "A\\B)ç(D", "../data/eps/code128_escape_latin1.eps" },
         /*  8*/ { BARCODE_DBAR_LTD, -1, BOLD_TEXT, -1, -1, -1, "", "", "1501234567890", "../data/eps/dbar_ltd_24724_fig7_bold.eps" },
+        /*  9*/ { BARCODE_CODE128, -1, EPS_COMPACT, -1, -1, -1, "", "", "Hello1234", "../data/eps/code128_compact.eps" },
+        /* 10*/ { BARCODE_MAXICODE, -1, EPS_COMPACT, -1, -1, -1, "", "", "Hello1234", "../data/eps/maxicode_compact.eps" },
+        /* 11*/ { BARCODE_DOTCODE, -1, EPS_COMPACT | CMYK_COLOUR, -1, -1, -1, "147AD0", "FC9630", "1234Hello", "../data/eps/dotcode_cmyk_compact.eps" },
+        /* 12*/ { BARCODE_ULTRA, -1, EPS_COMPACT, -1, -1, -1, "147AD0", "FC9630", "123", "../data/eps/ultra_fg_bg_compact.eps" },
+        /* 13*/ { BARCODE_QRCODE, -1, EPS_COMPACT, -1, -1, -1, "", "", "1234Hello", "../data/eps/qr_compact.eps" },
     };
     int data_size = ARRAY_SIZE(data);
 
     char *data_dir = "../data/eps";
-    char *eps = "out.eps";
+    char eps[256];
     char escaped[1024];
     int escaped_size = 1024;
 
@@ -80,6 +85,8 @@ static void test_print(int index, int generate, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(eps, i, "eps");
+
         struct zint_symbol *symbol = ZBarcode_Create();
         assert_nonnull(symbol, "Symbol not created\n");
 
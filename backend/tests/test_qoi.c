@@ -0,0 +1,283 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+#include "testcommon.h"
+#include <sys/stat.h>
+
+static void test_print(int index, int generate, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int whitespace_width;
+        int option_1;
+        int option_2;
+        float scale;
+        char *fgcolour;
+        char *bgcolour;
+        char* data;
+        char* expected_file;
+    };
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, -1, -1, 0, "", "", "AIM", "../data/qoi/code128.qoi" },
+        /*  1*/ { BARCODE_PDF417, 5, -1, -1, 0, "147AD0", "FC9630", "123", "../data/qoi/pdf417_fg_bg.qoi" },
+        /*  2*/ { BARCODE_PDF417, -1, -1, -1, 0, "14AD0080", "FC963000", "123", "../data/qoi/pdf417_fg_bg_alpha.qoi" },
+        /*  3*/ { BARCODE_ULTRA, 5, -1, -1, 0, "147AD0", "FC9630", "123", "../data/qoi/ultracode_fg_bg.qoi" },
+        /*  4*/ { BARCODE_QRCODE, -1, 2, 1, 0, "FFFFFF", "000000", "1234567890", "../data/qoi/qr_reverse.qoi" },
+        /*  5*/ { BARCODE_QRCODE, -1, 2, 1, 0, "000000", "000000", "1234567890", "../data/qoi/qr_fg_eq_bg.qoi" },
+        /*  6*/ { BARCODE_MAXICODE, -1, -1, -1, 0, "", "", "1234567890", "../data/qoi/maxicode.qoi" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char* data_dir = "../data/qoi";
+    char escaped[1024];
+    int escaped_size = 1024;
+
+    if (generate) {
+        if (!testUtilExists(data_dir)) {
+            ret = mkdir(data_dir, 0755);
+            assert_zero(ret, "mkdir(%s) ret %d != 0\n", data_dir, ret);
+        }
+    }
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol* symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, data[i].option_1, data[i].option_2, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        if (data[i].whitespace_width != -1) {
+            symbol->whitespace_width = data[i].whitespace_width;
+        }
+        if (data[i].scale != 0) {
+            symbol->scale = data[i].scale;
+        }
+        if (*data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+        if (*data[i].bgcolour) {
+            strcpy(symbol->bgcolour, data[i].bgcolour);
+        }
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+
+        testUtilOutFile(symbol->outfile, i, "qoi");
+        ret = ZBarcode_Print(symbol, 0);
+        assert_zero(ret, "i:%d %s ZBarcode_Print %s ret %d != 0\n", i, testUtilBarcodeName(data[i].symbology), symbol->outfile, ret);
+
+        if (generate) {
+            printf("        /*%3d*/ { %s, %d, %d, %d, %.8g, \"%s\", \"%s\", \"%s\", \"%s\" },\n",
+                    i, testUtilBarcodeName(data[i].symbology), data[i].whitespace_width,
+                    data[i].option_1, data[i].option_2, data[i].scale, data[i].fgcolour, data[i].bgcolour,
+                    testUtilEscape(data[i].data, length, escaped, escaped_size), data[i].expected_file);
+            ret = rename(symbol->outfile, data[i].expected_file);
+            assert_zero(ret, "i:%d rename(%s, %s) ret %d != 0\n", i, symbol->outfile, data[i].expected_file, ret);
+        } else {
+            assert_nonzero(testUtilExists(symbol->outfile), "i:%d testUtilExists(%s) == 0\n", i, symbol->outfile);
+            assert_nonzero(testUtilExists(data[i].expected_file), "i:%d testUtilExists(%s) == 0\n", i, data[i].expected_file);
+
+            ret = testUtilCmpBins(symbol->outfile, data[i].expected_file);
+            assert_zero(ret, "i:%d %s testUtilCmpBins(%s, %s) %d != 0\n", i, testUtilBarcodeName(data[i].symbology), symbol->outfile, data[i].expected_file, ret);
+            assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+/* Minimal QOI decoder (to RGBA) of `size` bytes `qoi`, returning 0 on error */
+static int test_qoi_decode(const unsigned char *qoi, const int size, int *p_width, int *p_height, int *p_channels,
+            unsigned char *rgba, const int rgba_size) {
+    unsigned char index[64][4] = {{0}};
+    unsigned char px[4] = { 0, 0, 0, 0xFF };
+    int posn = 14, pixels, p, run = 0;
+
+    if (size < 14 + 8 || memcmp(qoi, "qoif", 4) != 0) return 0;
+    *p_width = (qoi[4] << 24) | (qoi[5] << 16) | (qoi[6] << 8) | qoi[7];
+    *p_height = (qoi[8] << 24) | (qoi[9] << 16) | (qoi[10] << 8) | qoi[11];
+    *p_channels = qoi[12];
+    pixels = *p_width * *p_height;
+    if (pixels * 4 > rgba_size) return 0;
+
+    for (p = 0; p < pixels; p++) {
+        if (run) {
+            run--;
+        } else if (posn < size - 8) {
+            const int b1 = qoi[posn++];
+            if (b1 == 0xFE) {
+                memcpy(px, qoi + posn, 3);
+                posn += 3;
+            } else if (b1 == 0xFF) {
+                memcpy(px, qoi + posn, 4);
+                posn += 4;
+            } else if ((b1 & 0xC0) == 0x00) {
+                memcpy(px, index[b1], 4);
+            } else if ((b1 & 0xC0) == 0x40) {
+                px[0] += ((b1 >> 4) & 0x03) - 2;
+                px[1] += ((b1 >> 2) & 0x03) - 2;
+                px[2] += (b1 & 0x03) - 2;
+            } else if ((b1 & 0xC0) == 0x80) {
+                const int b2 = qoi[posn++];
+                const int vg = (b1 & 0x3F) - 32;
+                px[0] += vg - 8 + ((b2 >> 4) & 0x0F);
+                px[1] += vg;
+                px[2] += vg - 8 + (b2 & 0x0F);
+            } else {
+                run = b1 & 0x3F;
+            }
+            memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+        } else {
+            return 0;
+        }
+        memcpy(rgba + p * 4, px, 4);
+    }
+    /* All data used, run finished and end marker */
+    return run == 0 && posn == size - 8 && memcmp(qoi + posn, "\0\0\0\0\0\0\0\1", 8) == 0;
+}
+
+/* Check output decodes to the RGBA buffer */
+static void test_decode(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int option_2;
+        int output_options;
+        float scale;
+        char *fgcolour;
+        char *bgcolour;
+        char *data;
+        int expected_channels;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, -1, -1, 0, "", "", "AIM", 3 },
+        /*  1*/ { BARCODE_CODE128, -1, -1, -1, 10, "", "", "AIM1234567890", 3 }, /* Long runs, > 62 */
+        /*  2*/ { BARCODE_EANX, -1, -1, -1, 0, "FF0000", "00FF00", "123456789012+12", 3 },
+        /*  3*/ { BARCODE_DATAMATRIX, -1, -1, -1, 0, "010203", "020304", "1234567890", 3 }, /* DIFF */
+        /*  4*/ { BARCODE_DATAMATRIX, -1, -1, -1, 0, "102030", "1A2C3B", "1234567890", 3 }, /* LUMA */
+        /*  5*/ { BARCODE_QRCODE, -1, -1, -1, 2.5, "11223344", "FFEEDDCC", "1234567890", 4 },
+        /*  6*/ { BARCODE_QRCODE, -1, -1, -1, 0, "00000000", "FFFFFF", "1234567890", 4 },
+        /*  7*/ { BARCODE_ULTRA, -1, -1, -1, 0, "", "", "ABCDEFGHIJKLMNOPQRSTUVWXYZ", 3 },
+        /*  8*/ { BARCODE_ULTRA, -1, -1, -1, 0, "000000A0", "", "1234", 4 },
+        /*  9*/ { BARCODE_MAXICODE, -1, -1, -1, 0, "", "", "1234567890", 3 },
+        /* 10*/ { BARCODE_DOTCODE, -1, -1, BARCODE_DOTTY_MODE, 0, "", "", "1234567890", 3 },
+        /* 11*/ { BARCODE_HANXIN, -1, 84, -1, 0, "", "", "1", 3 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct zint_symbol *symbol = NULL;
+    unsigned char *rgba = NULL;
+    unsigned char *qoi = NULL;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale != 0) {
+            symbol->scale = data[i].scale;
+        }
+        if (*data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+        if (*data[i].bgcolour) {
+            strcpy(symbol->bgcolour, data[i].bgcolour);
+        }
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+        strcpy(symbol->outfile, "mem.qoi");
+        ret = ZBarcode_Print(symbol, 0);
+        assert_zero(ret, "i:%d %s ZBarcode_Print ret %d != 0 (%s)\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+        assert_nonnull(symbol->memfile, "i:%d memfile NULL\n", i);
+        qoi = (unsigned char *) malloc(symbol->memfile_size);
+        assert_nonnull(qoi, "i:%d malloc qoi NULL\n", i);
+        memcpy(qoi, symbol->memfile, symbol->memfile_size);
+        int qoi_size = symbol->memfile_size;
+
+        /* Compare against RGBA buffer */
+        symbol->output_options = (symbol->output_options & ~BARCODE_MEMORY_FILE) | OUT_BUFFER_RGBA;
+        ret = ZBarcode_Buffer(symbol, 0);
+        assert_zero(ret, "i:%d %s ZBarcode_Buffer ret %d != 0 (%s)\n", i, testUtilBarcodeName(data[i].symbology), ret, symbol->errtxt);
+
+        int rgba_size = symbol->bitmap_width * symbol->bitmap_height * 4;
+        rgba = (unsigned char *) malloc(rgba_size);
+        assert_nonnull(rgba, "i:%d malloc rgba NULL\n", i);
+
+        int width, height, channels;
+        ret = test_qoi_decode(qoi, qoi_size, &width, &height, &channels, rgba, rgba_size);
+        assert_nonzero(ret, "i:%d %s test_qoi_decode fail\n", i, testUtilBarcodeName(data[i].symbology));
+        assert_equal(width, symbol->bitmap_width, "i:%d width %d != %d\n", i, width, symbol->bitmap_width);
+        assert_equal(height, symbol->bitmap_height, "i:%d height %d != %d\n", i, height, symbol->bitmap_height);
+        assert_equal(channels, data[i].expected_channels, "i:%d channels %d != %d\n", i, channels, data[i].expected_channels);
+        assert_zero(memcmp(rgba, symbol->bitmap, rgba_size), "i:%d %s pixels differ\n", i, testUtilBarcodeName(data[i].symbology));
+
+        if (debug & ZINT_DEBUG_TEST_PRINT) {
+            printf("i:%d %s %dx%d QOI %d bytes\n", i, testUtilBarcodeName(data[i].symbology), width, height, qoi_size);
+        }
+
+        free(rgba);
+        free(qoi);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+int main(int argc, char *argv[]) {
+
+    testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
+        { "test_print", test_print, 1, 1, 1 },
+        { "test_decode", test_decode, 1, 0, 1 },
+    };
+
+    testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
+
+    testReport();
+
+    return 0;
+}
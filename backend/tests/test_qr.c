@@ -83,6 +83,7 @@ static void test_qr_options(int index, int debug) {
     int data_size = ARRAY_SIZE(data);
 
     struct zint_symbol previous_symbol;
+    struct zint_internal previous_internal;
 
     for (int i = 0; i < data_size; i++) {
 
@@ -100,7 +101,7 @@ static void test_qr_options(int index, int debug) {
             ret = testUtilSymbolCmp(symbol, &previous_symbol);
             assert_equal(!ret, !data[i].compare_previous, "i:%d testUtilSymbolCmp !ret %d != %d\n", i, ret, data[i].compare_previous);
         }
-        memcpy(&previous_symbol, symbol, sizeof(previous_symbol));
+        testUtilSymbolCopy(&previous_symbol, &previous_internal, symbol);
 
         if (data[i].ret_vector != -1) {
             ret = ZBarcode_Buffer_Vector(symbol, 0);
@@ -271,6 +272,12 @@ static void test_qr_input(int index, int generate, int debug) {
         /*123*/ { UNICODE_MODE, 170, -1, "?", 0, 170, "78 0A A4 01 3F 00 EC 11 EC", "ECI-170 B1 (ASCII invariant)" },
         /*124*/ { DATA_MODE, 899, -1, "\200", 0, 899, "78 38 34 01 80 00 EC 11 EC", "ECI-899 B1 (8-bit binary)" },
         /*125*/ { UNICODE_MODE, 900, -1, "é", 0, 900, "78 38 44 02 C3 A9 00 EC 11", "ECI-900 B2 (no conversion)" },
+        /*126*/ { UNICODE_MODE | MULTI_ECI_MODE, 0, -1, "é", 0, 0, "40 1E 90 EC 11 EC 11 EC 11", "B1 (ISO 8859-1)" },
+        /*127*/ { UNICODE_MODE | MULTI_ECI_MODE, 0, -1, "ก", ZINT_WARN_USES_ECI, 13, "Warning 70 D4 01 A1 00 EC 11 EC 11", "ECI-13 B1 (ISO 8859-11)" },
+        /*128*/ { UNICODE_MODE | MULTI_ECI_MODE, 0, -1, "éβ", ZINT_WARN_USES_ECI, 0, "Warning 40 1E 97 09 40 1E 20 EC 11", "B1 (ISO 8859-1) ECI-9 B1 (ISO 8859-7)" },
+        /*129*/ { UNICODE_MODE | MULTI_ECI_MODE, 0, -1, "ÁȁȁȁȁȁȁȂ¢", ZINT_WARN_USES_ECI, 0, "Warning 40 1C 17 1A 41 0C 88 1C 88 1C 88 1C 88 1C 88 1C 88 1C 88 2C 2A 20", "B1 (ISO 8859-1) ECI-26 B17 (UTF-8)" },
+        /*130*/ { UNICODE_MODE | MULTI_ECI_MODE, 0, -1, "αβγδ ééééé", ZINT_WARN_USES_ECI, 0, "Warning 70 94 04 E1 E2 E3 E4 70 34 06 20 E9 E9 E9 E9 E9", "ECI-9 B4 (ISO 8859-7) ECI-3 B6 (ISO 8859-1)" },
+        /*131*/ { UNICODE_MODE | MULTI_ECI_MODE, 0, -1, "αβγδ 123456 ééééé", ZINT_WARN_USES_ECI, 0, "Warning 70 94 04 E1 E2 E3 E4 70 32 04 65 50 BA 2E 49 92 02 F4 F4 F4 F4 F4 80 EC 11 EC 11 EC", "ECI-9 B4 (ISO 8859-7) ECI-3 A8 B5 (ISO 8859-1)" },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -414,6 +421,15 @@ static void test_qr_optimize(int index, int generate, int debug) {
         /* 27*/ { UNICODE_MODE, -1, "テéaABCDE1", ZINT_WARN_USES_ECI, "Warning 71 A4 06 E3 83 86 C3 A9 61 20 31 CD 45 29 DC 00", "B6 A6" },
         /* 28*/ { UNICODE_MODE, -1, "貫やぐ識禁ぱい再2間変字全ノレ没無8裁", 0, "(44) 80 83 A8 85 88 25 CA 2F 40 B0 53 C2 44 98 41 00 4A 02 0E A8 F8 F5 0D 30 4C 35 A1 CC", "K8 N1 K8 B3" },
         /* 29*/ { UNICODE_MODE, -1, "貫やぐ識禁ぱい再2間変字全ノレ没無8裁花ほゃ過法ひなご札17能つーびれ投覧マ勝動エヨ額界よみ作皇ナヲニ打題ヌルヲ掲布益フが。入35能ト権話しこを断兆モヘ細情おじ名4減エヘイハ側機はょが意見想ハ業独案ユヲウ患職ヲ平美さ毎放どぽたけ家没べお化富べ町大シ情魚ッでれ一冬すぼめり。社ト可化モマ試音ばじご育青康演ぴぎ権型固スで能麩ぜらもほ河都しちほラ収90作の年要とだむ部動ま者断チ第41一1米索焦茂げむしれ。測フ物使だて目月国スリカハ夏検にいへ児72告物ゆは載核ロアメヱ登輸どべゃ催行アフエハ議歌ワ河倫剖だ。記タケウ因載ヒイホヤ禁3輩彦関トえび肝区勝ワリロ成禁ぼよ界白ウヒキレ中島べせぜい各安うしぽリ覧生テ基一でむしゃ中新トヒキソ声碁スしび起田ア信大未ゅもばち。", 0, "(589) 80 20 EA 21 62 09 72 8B D0 2C 14 F0 91 26 10 40 04 A0 08 3A A3 E3 D4 34 C1 30 D6 87", "K8 N1 K8 N1 K10 N2 K33 N2 K16 N1 K89 N2 K14 B5 K28 N2 K40 N1 K65" },
+        /* 30*/ { UNICODE_MODE | FAST_MODE, -1, "0123456A", 0, "10 1C 0C 56 58 80 25 00 EC", "N7 A1 (nayuki.io - alpha/numeric) (note same bits as A8)" },
+        /* 31*/ { UNICODE_MODE | FAST_MODE, -1, "ABCDEa", 0, "40 64 14 24 34 44 56 10 EC", "B6 (nayuki.io - alphanumeric/byte)" },
+        /* 32*/ { UNICODE_MODE | FAST_MODE, -1, "ABCDEFa", 0, "20 31 CD 45 2A 15 00 58 40", "A6 B1 (nayuki.io - alphanumeric/byte)" },
+        /* 33*/ { UNICODE_MODE | FAST_MODE, 1, "THE SQUARE ROOT OF 2 IS 1.41421356237309504880168872420969807856967187537694807317667973799", 0, "(55) 20 D5 2A 53 54 1A A8 4C DC DF 14 29 EC 47 CA D9 9A 88 05 71 10 59 E3 56 32 5D 45 F0", " A26 N65 (nayuki.io - alpha/numeric)" },
+        /* 34*/ { UNICODE_MODE | FAST_MODE, 1, "Golden ratio φ = 1.6180339887498948482045868343656381177203091798057628621354486227052604628189024497072072041893911374......", 0, "(80) 41 14 76 F6 C6 46 56 E2 07 26 17 46 96 F2 08 3D 32 03 D2 01 E5 5A 84 64 9A 82 1F 72", "B16 A3 N100 A6 (FAST_MODE **NOT SAME** as B20 N100 A6, same codewords)" },
+        /* 35*/ { UNICODE_MODE | FAST_MODE, -1, "AB1234567890123A", 0, "20 11 CD 10 34 7B 72 31 50 30 C8 02 50", "A2 N13 A1" },
+        /* 36*/ { UNICODE_MODE | FAST_MODE, -1, "テaABCDE1", 0, "40 38 36 56 12 03 1C D4 52 9D C0 EC 11", "B3 A6" },
+        /* 37*/ { UNICODE_MODE | FAST_MODE, 1, "67128177921547861663com.acme35584af52fa3-88d0-093b-6c14-b37ddafb59c528908608sg.com.dash.www0530329356521790265903SG.COM.NETS46968696003522G33250183309051017567088693441243693268766948304B2AE13344004SG.SGQR209710339366720B439682.63667470805057501195235502733744600368027857918629797829126902859SG8236HELLO FOO2517Singapore3272B815", 0, "(232) 10 52 9F 46 70 B3 5D DE 9A 1F A1 7B 1B 7B 69 73 0B 1B 6B 29 99 A9 A9 C1 A3 0B 31 A9", "N20 B47 N9 B15 N22 A11 N14 A1 N47 A19 N15 A8 N65 A20 B8 A8 (nayuki.io - SGQR alpha/numeric/byte)" },
+        /* 38*/ { UNICODE_MODE | FAST_MODE, -1, "貫やぐ識禁ぱい再2間変字全ノレ没無8裁", 0, "(44) 80 83 A8 85 88 25 CA 2F 40 B0 53 C2 44 98 41 00 4A 02 0E A8 F8 F5 0D 30 4C 35 A1 CC", "K8 N1 K8 B3" },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -1308,6 +1324,56 @@ static void test_qr_encode(int index, int generate, int debug) {
 #define TEST_PERF_ITERATIONS    1000
 
 // Not a real test, just performance indicator
+static void test_qr_structapp(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int input_mode;
+        struct zint_structapp structapp;
+        char *data;
+        int ret;
+        char *expected;
+        char *comment;
+    };
+    struct item data[] = {
+        /*  0*/ { UNICODE_MODE, { 1, 2, "" }, "123", 0, "30 13 01 00 C7 B0 EC 11 EC", "Parity of own data 0x30" },
+        /*  1*/ { UNICODE_MODE, { 2, 2, "" }, "123", 0, "31 13 01 00 C7 B0 EC 11 EC", "" },
+        /*  2*/ { UNICODE_MODE, { 16, 16, "255" }, "123", 0, "3F FF F1 00 C7 B0 EC 11 EC", "" },
+        /*  3*/ { UNICODE_MODE, { 1, 2, "0" }, "A", 0, "30 10 02 00 94 00 EC 11 EC", "" },
+        /*  4*/ { UNICODE_MODE, { 0, 2, "" }, "123", ZINT_ERROR_INVALID_OPTION, "Error 711: Structured Append index out of range (1-2)", "" },
+        /*  5*/ { UNICODE_MODE, { 3, 2, "" }, "123", ZINT_ERROR_INVALID_OPTION, "Error 711: Structured Append index out of range (1-2)", "" },
+        /*  6*/ { UNICODE_MODE, { 1, 1, "" }, "123", ZINT_ERROR_INVALID_OPTION, "Error 710: Structured Append count out of range (2-16)", "" },
+        /*  7*/ { UNICODE_MODE, { 1, 17, "" }, "123", ZINT_ERROR_INVALID_OPTION, "Error 710: Structured Append count out of range (2-16)", "" },
+        /*  8*/ { UNICODE_MODE, { 1, 2, "1A" }, "123", ZINT_ERROR_INVALID_OPTION, "Error 712: Invalid Structured Append ID (digits only)", "" },
+        /*  9*/ { UNICODE_MODE, { 1, 2, "1234" }, "123", ZINT_ERROR_INVALID_OPTION, "Error 712: Invalid Structured Append ID (digits only)", "" },
+        /* 10*/ { UNICODE_MODE, { 1, 2, "256" }, "123", ZINT_ERROR_INVALID_OPTION, "Error 713: Structured Append ID out of range (0-255)", "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, BARCODE_QRCODE, data[i].input_mode, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, data[i].data, -1, debug);
+        symbol->debug |= ZINT_DEBUG_TEST; // Needed to get codeword dump in errtxt
+        symbol->structapp = data[i].structapp;
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Encode ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        assert_zero(strcmp(symbol->errtxt, data[i].expected), "i:%d strcmp(%s, %s) != 0\n", i, symbol->errtxt, data[i].expected);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 static void test_qr_perf(int index, int debug) {
 
     if (!(debug & ZINT_DEBUG_TEST_PERFORMANCE)) { /* -d 256 */
@@ -1454,6 +1520,7 @@ static void test_microqr_options(int index, int debug) {
     int data_size = ARRAY_SIZE(data);
 
     struct zint_symbol previous_symbol;
+    struct zint_internal previous_internal;
 
     for (int i = 0; i < data_size; i++) {
 
@@ -1470,7 +1537,7 @@ static void test_microqr_options(int index, int debug) {
             ret = testUtilSymbolCmp(symbol, &previous_symbol);
             assert_equal(!ret, !data[i].compare_previous, "i:%d testUtilSymbolCmp !ret %d != %d\n", i, ret, data[i].compare_previous);
         }
-        memcpy(&previous_symbol, symbol, sizeof(previous_symbol));
+        testUtilSymbolCopy(&previous_symbol, &previous_internal, symbol);
 
         if (data[i].ret_vector != -1) {
             ret = ZBarcode_Buffer_Vector(symbol, 0);
@@ -2587,6 +2654,10 @@ static void test_rmqr_optimize(int index, int generate, int debug) {
         /* 19*/ { UNICODE_MODE, "テaA1", -1, 0, "76 0D 95 85 04 C4 00", "B4" },
         /* 20*/ { UNICODE_MODE, "テaAB1", -1, 0, "6E 0D 95 85 19 CD 04", "B3 A3" },
         /* 21*/ { UNICODE_MODE, "貫やぐ識禁ぱい再2間変字全ノレ没無8裁花ほゃ過法ひなご札17能つーびれ投覧マ勝動エヨ額界よみ作皇ナヲニ打題ヌルヲ掲布益フが。入35能ト権話しこを断兆モヘ細情おじ名4減エヘイハ側機", -1, 0, "(152) 82 0E A2 16 20 97 28 BD 02 C1 4F 09 12 61 08 04 A0 83 AA 3E 3D 43 4C 13 0D 68 73 1F", "K8 N1 K8 N1 K10 N2 K33 N2 K16 N1 K7" },
+        /* 22*/ { UNICODE_MODE | FAST_MODE, "THE SQUARE ROOT OF 2 IS 1.41421356237309504880168872420969807856967187537694807317667973799", -1, 0, "(48) 46 A9 52 9A A0 D5 42 66 E6 F8 A1 4F 62 3E 56 CC D4 40 2B 98 2C F1 AB 19 2E A2 F8 61", " A26 N65 (nayuki.io - alpha/numeric)" },
+        /* 23*/ { UNICODE_MODE | FAST_MODE, "6547861663com.acme35584af52fa3-88d0-093b-6c14-b37ddafb59c528908608sg.com.dash.www05303790265903SG.COM.NETS46967004B2AE13344004SG.SGQR209710339382.6359SG8236HELLO FOO2517Singapore3272B815", -1, 0, "(152) 20 AA 3B 12 29 8D 97 B1 B7 B6 97 30 B1 B6 B2 99 9A 9A 9C 1A 30 B3 1A 99 33 30 99 96", "N10 B47 N9 B15 N14 A38 N12 A25 B8 A8 (nayuki.io - SGQR alpha/numeric/byte)" },
+        /* 24*/ { UNICODE_MODE | FAST_MODE, "AB12345678A", -1, 0, "42 39 A5 03 DB 91 39 04 A0 EC 11 EC", "A2 N8 A1" },
+        /* 25*/ { UNICODE_MODE | FAST_MODE, "テaAB1", -1, 0, "7A 0D 95 85 05 08 C4", "B5 (FAST_MODE **NOT SAME** as B3 A3, same codewords)" },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -2714,6 +2785,7 @@ int main(int argc, char *argv[]) {
         { "test_qr_gs1", test_qr_gs1, 1, 1, 1 },
         { "test_qr_optimize", test_qr_optimize, 1, 1, 1 },
         { "test_qr_encode", test_qr_encode, 1, 1, 1 },
+        { "test_qr_structapp", test_qr_structapp, 1, 0, 1 },
         { "test_qr_perf", test_qr_perf, 1, 0, 1 },
 
         { "test_microqr_options", test_microqr_options, 1, 0, 1 },
@@ -31,6 +31,10 @@
 
 #include "testcommon.h"
 
+INTERNAL int png_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+INTERNAL int bmp_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf);
+
 static int is_row_column_black(struct zint_symbol *symbol, int row, int column) {
     int i;
     if (symbol->output_options & OUT_BUFFER_INTERMEDIATE) {
@@ -821,8 +825,10 @@ static void test_draw_string_wrap(int index, int debug) {
 
         if (index != -1 && (debug & ZINT_DEBUG_TEST_PRINT)) testUtilBitmapPrint(symbol, NULL, NULL); // ZINT_DEBUG_TEST_PRINT 16
 
+        testUtilOutFile(symbol->outfile, i, "png");
         ret = ZBarcode_Print(symbol, 0);
         assert_zero(ret, "i:%d ZBarcode_Print(%d) ret %d != 0\n", i, data[i].symbology, ret);
+        assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
 
         int text_bits_set = 0;
         int row = data[i].expected_no_text_row;
@@ -887,8 +893,10 @@ static void test_code128_utf8(int index, int debug) {
 
         if (index != -1 && (debug & ZINT_DEBUG_TEST_PRINT)) testUtilBitmapPrint(symbol, NULL, NULL); // ZINT_DEBUG_TEST_PRINT 16
 
+        testUtilOutFile(symbol->outfile, i, "png");
         ret = ZBarcode_Print(symbol, 0);
         assert_zero(ret, "i:%d ZBarcode_Print(%d) ret %d != 0\n", i, BARCODE_CODE128, ret);
+        assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
 
         int text_bits_set = 0;
         int row = data[i].expected_text_row;
@@ -997,8 +1005,10 @@ static void test_scale(int index, int debug) {
         assert_equal(symbol->bitmap_width, data[i].expected_bitmap_width, "i:%d (%d) symbol->bitmap_width %d != %d\n", i, data[i].symbology, symbol->bitmap_width, data[i].expected_bitmap_width);
         assert_equal(symbol->bitmap_height, data[i].expected_bitmap_height, "i:%d (%d) symbol->bitmap_height %d != %d\n", i, data[i].symbology, symbol->bitmap_height, data[i].expected_bitmap_height);
 
+        testUtilOutFile(symbol->outfile, i, "png");
         ret = ZBarcode_Print(symbol, 0);
         assert_zero(ret, "i:%d ZBarcode_Print(%d) ret %d != 0\n", i, data[i].symbology, ret);
+        assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
 
         assert_nonzero(symbol->bitmap_height >= data[i].expected_set_rows, "i:%d (%d) symbol->bitmap_height %d < expected_set_rows %d\n",
                 i, data[i].symbology, symbol->bitmap_height, data[i].expected_set_rows);
@@ -1202,6 +1212,1304 @@ static void test_buffer_plot(int index, int generate, int debug) {
     testFinish();
 }
 
+/* Check scaled and rotated output (plain and intermediate) against rotating the unrotated output */
+static void test_scale_rotate(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, 0, "1234" },
+        /*  1*/ { BARCODE_CODE128, -1, 2.7f, "1234" },
+        /*  2*/ { BARCODE_EANX, -1, 1.3f, "123456789012+12" },
+        /*  3*/ { BARCODE_QRCODE, -1, 3.1f, "1234" },
+        /*  4*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 2.2f, "1234" },
+        /*  5*/ { BARCODE_MAXICODE, -1, 0.7f, "1234" },
+        /*  6*/ { BARCODE_ULTRA, -1, 1.9f, "1234" },
+        /*  7*/ { BARCODE_CODE16K, BARCODE_BIND, 1.5f, "1234567890abcdefghij" },
+        /*  8*/ { BARCODE_DBAR_STK, -1, 2.5f, "1234567890123" },
+        /*  9*/ { BARCODE_QRCODE, -1, 4.5f, "12345678901234567890" }, /* Over several rotation tiles */
+        /* 10*/ { BARCODE_AZTEC, -1, 7, "1234567890" },
+    };
+    int data_size = ARRAY_SIZE(data);
+    int angles[] = { 90, 180, 270 };
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+        int output_options = symbol->output_options;
+
+        ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        int width = symbol->bitmap_width;
+        int height = symbol->bitmap_height;
+        unsigned char *unrotated = (unsigned char *) malloc(width * height * 3);
+        assert_nonnull(unrotated, "i:%d malloc unrotated NULL\n", i);
+        memcpy(unrotated, symbol->bitmap, width * height * 3);
+
+        for (int j = 0; j < (int) ARRAY_SIZE(angles); j++) {
+            int rotated_width = angles[j] == 180 ? width : height;
+            int rotated_height = angles[j] == 180 ? height : width;
+
+            symbol->output_options = output_options;
+            ret = ZBarcode_Buffer(symbol, angles[j]);
+            assert_zero(ret, "i:%d angle %d ZBarcode_Buffer ret %d != 0 (%s)\n", i, angles[j], ret, symbol->errtxt);
+            assert_equal(symbol->bitmap_width, rotated_width, "i:%d angle %d bitmap_width %d != %d\n", i, angles[j], symbol->bitmap_width, rotated_width);
+            assert_equal(symbol->bitmap_height, rotated_height, "i:%d angle %d bitmap_height %d != %d\n", i, angles[j], symbol->bitmap_height, rotated_height);
+
+            unsigned char *rotated = (unsigned char *) malloc(width * height * 3);
+            assert_nonnull(rotated, "i:%d malloc rotated NULL\n", i);
+            memcpy(rotated, symbol->bitmap, width * height * 3);
+
+            symbol->output_options = output_options | OUT_BUFFER_INTERMEDIATE;
+            ret = ZBarcode_Buffer(symbol, angles[j]);
+            assert_zero(ret, "i:%d angle %d ZBarcode_Buffer intermediate ret %d != 0 (%s)\n", i, angles[j], ret, symbol->errtxt);
+
+            for (int row = 0; row < rotated_height; row++) {
+                for (int column = 0; column < rotated_width; column++) {
+                    int x, y;
+                    if (angles[j] == 90) {
+                        x = row;
+                        y = height - 1 - column;
+                    } else if (angles[j] == 180) {
+                        x = width - 1 - column;
+                        y = height - 1 - row;
+                    } else {
+                        x = width - 1 - row;
+                        y = column;
+                    }
+                    const unsigned char *expected = unrotated + (y * width + x) * 3;
+                    const unsigned char *pixel = rotated + (row * rotated_width + column) * 3;
+                    assert_zero(memcmp(pixel, expected, 3), "i:%d angle %d row %d column %d RGB differs\n", i, angles[j], row, column);
+                    const unsigned char ch = symbol->bitmap[row * rotated_width + column];
+                    if (data[i].symbology != BARCODE_ULTRA) {
+                        assert_equal(ch, expected[0] ? '0' : '1', "i:%d angle %d row %d column %d intermediate '%c' != '%c'\n", i, angles[j], row, column, ch, expected[0] ? '0' : '1');
+                    } else {
+                        assert_nonzero(ch >= '0', "i:%d angle %d row %d column %d intermediate 0x%02X invalid\n", i, angles[j], row, column, ch);
+                    }
+                }
+            }
+            free(rotated);
+        }
+
+        free(unrotated);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_buffer_1bpp(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        int rotate_angle;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, 0, 0, "1234" },
+        /*  1*/ { BARCODE_CODE128, OUT_BUFFER_INTERMEDIATE, 2.7f, 90, "1234" },
+        /*  2*/ { BARCODE_EANX, -1, 1.5f, 180, "123456789012+12" },
+        /*  3*/ { BARCODE_QRCODE, -1, 3.1f, 270, "1234" },
+        /*  4*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 2.2f, 0, "1234" },
+        /*  5*/ { BARCODE_MAXICODE, -1, 0.7f, 90, "1234" },
+        /*  6*/ { BARCODE_ULTRA, -1, 1.9f, 0, "1234" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+        int output_options = symbol->output_options;
+
+        /* Reference from intermediate buffer */
+        symbol->output_options = output_options | OUT_BUFFER_INTERMEDIATE;
+        ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        int width = symbol->bitmap_width;
+        int height = symbol->bitmap_height;
+        unsigned char *intermediate = (unsigned char *) malloc(width * height);
+        assert_nonnull(intermediate, "i:%d malloc intermediate NULL\n", i);
+        memcpy(intermediate, symbol->bitmap, width * height);
+
+        symbol->output_options = output_options | OUT_BUFFER_1BPP;
+        ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Buffer 1bpp ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_equal(symbol->bitmap_width, width, "i:%d bitmap_width %d != %d\n", i, symbol->bitmap_width, width);
+        assert_equal(symbol->bitmap_height, height, "i:%d bitmap_height %d != %d\n", i, symbol->bitmap_height, height);
+        assert_null(symbol->alphamap, "i:%d alphamap not NULL\n", i);
+
+        int row_bytes = (width + 7) / 8;
+        for (int row = 0; row < height; row++) {
+            const unsigned char *bits = symbol->bitmap + row * row_bytes;
+            for (int column = 0; column < row_bytes * 8; column++) {
+                int bit = (bits[column >> 3] >> (7 - (column & 7))) & 1;
+                int expected = 0;
+                if (column < width) {
+                    unsigned char ch = intermediate[row * width + column];
+                    expected = ch != '0' && ch != 'W';
+                }
+                assert_equal(bit, expected, "i:%d row %d column %d bit %d != %d\n", i, row, column, bit, expected);
+            }
+        }
+
+        free(intermediate);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_buffer_rgba(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        char *fgcolour;
+        char *bgcolour;
+        float scale;
+        int rotate_angle;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, NULL, NULL, 0, 0, "1234" },
+        /*  1*/ { BARCODE_CODE128, OUT_BUFFER_INTERMEDIATE, "112233", "FFEEDD80", 2.7f, 90, "1234" },
+        /*  2*/ { BARCODE_EANX, -1, "11223344", NULL, 1.5f, 180, "123456789012+12" },
+        /*  3*/ { BARCODE_QRCODE, BARCODE_ANTIALIAS, "00000040", "FFFFFFC0", 3.1f, 270, "1234" },
+        /*  4*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, NULL, "FFFFFF00", 2.2f, 0, "1234" },
+        /*  5*/ { BARCODE_MAXICODE, -1, NULL, NULL, 0.7f, 90, "1234" },
+        /*  6*/ { BARCODE_ULTRA, -1, NULL, "00FF0020", 1.9f, 0, "1234" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+        if (data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+        if (data[i].bgcolour) {
+            strcpy(symbol->bgcolour, data[i].bgcolour);
+        }
+        int output_options = symbol->output_options;
+
+        /* Reference from RGB buffer and alphamap */
+        symbol->output_options = output_options & ~OUT_BUFFER_INTERMEDIATE;
+        ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        int width = symbol->bitmap_width;
+        int height = symbol->bitmap_height;
+        unsigned char *rgb = (unsigned char *) malloc(width * height * 3);
+        assert_nonnull(rgb, "i:%d malloc rgb NULL\n", i);
+        memcpy(rgb, symbol->bitmap, width * height * 3);
+        unsigned char *alpha = NULL;
+        if (symbol->alphamap) {
+            alpha = (unsigned char *) malloc(width * height);
+            assert_nonnull(alpha, "i:%d malloc alpha NULL\n", i);
+            memcpy(alpha, symbol->alphamap, width * height);
+        }
+
+        symbol->output_options = output_options | OUT_BUFFER_RGBA;
+        ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Buffer RGBA ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_equal(symbol->bitmap_width, width, "i:%d bitmap_width %d != %d\n", i, symbol->bitmap_width, width);
+        assert_equal(symbol->bitmap_height, height, "i:%d bitmap_height %d != %d\n", i, symbol->bitmap_height, height);
+        assert_null(symbol->alphamap, "i:%d alphamap not NULL\n", i);
+
+        for (int j = 0; j < width * height; j++) {
+            const unsigned char *pixel = symbol->bitmap + j * 4;
+            int expected_alpha = alpha ? alpha[j] : 0xFF;
+            assert_zero(memcmp(pixel, rgb + j * 3, 3), "i:%d pixel %d RGB %02X%02X%02X != %02X%02X%02X\n",
+                        i, j, pixel[0], pixel[1], pixel[2], rgb[j * 3], rgb[j * 3 + 1], rgb[j * 3 + 2]);
+            assert_equal(pixel[3], expected_alpha, "i:%d pixel %d alpha %02X != %02X\n", i, j, pixel[3], expected_alpha);
+        }
+
+        free(rgb);
+        free(alpha);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_buffer_target(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        char *fgcolour;
+        char *bgcolour;
+        float scale;
+        int rotate_angle;
+        int format;
+        int x;
+        int y;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, NULL, NULL, 0, 0, ZINT_PIXEL_RGB24, 0, 0, "1234" },
+        /*  1*/ { BARCODE_CODE128, -1, "112233", "FFEEDD80", 2.7f, 90, ZINT_PIXEL_RGBA32, 3, 5, "1234" },
+        /*  2*/ { BARCODE_EANX, -1, "11223344", NULL, 1.5f, 180, ZINT_PIXEL_BGRA32, 7, 1, "123456789012+12" },
+        /*  3*/ { BARCODE_QRCODE, BARCODE_ANTIALIAS, "00000040", "FFFFFFC0", 3.1f, 270, ZINT_PIXEL_GRAY8, 2, 9, "1234" },
+        /*  4*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, NULL, "FFFFFF00", 2.2f, 0, ZINT_PIXEL_RGBA32, 1, 0, "1234" },
+        /*  5*/ { BARCODE_MAXICODE, -1, NULL, NULL, 0.7f, 90, ZINT_PIXEL_RGB24, 4, 4, "1234" },
+        /*  6*/ { BARCODE_ULTRA, -1, NULL, "00FF0020", 1.9f, 0, ZINT_PIXEL_BGRA32, 0, 2, "1234" },
+        /*  7*/ { BARCODE_CODE128, OUT_BUFFER_INTERMEDIATE, "112233", NULL, 1.2f, 0, ZINT_PIXEL_GRAY8, 5, 0, "1234" },
+        /*  8*/ { BARCODE_CODE128, -1, NULL, NULL, 0, 0, ZINT_PIXEL_MONO1, 3, 2, "1234" },
+        /*  9*/ { BARCODE_QRCODE, -1, NULL, NULL, 2.5f, 90, ZINT_PIXEL_MONO1, 8, 1, "1234" },
+        /* 10*/ { BARCODE_ULTRA, -1, NULL, NULL, 1.3f, 180, ZINT_PIXEL_MONO1, 13, 0, "1234" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+        if (data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+        if (data[i].bgcolour) {
+            strcpy(symbol->bgcolour, data[i].bgcolour);
+        }
+        int output_options = symbol->output_options;
+        int mono = data[i].format == ZINT_PIXEL_MONO1;
+
+        /* Reference from RGBA or 1bpp buffer */
+        symbol->output_options = (output_options & ~OUT_BUFFER_INTERMEDIATE) | (mono ? OUT_BUFFER_1BPP : OUT_BUFFER_RGBA);
+        ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        int width = symbol->bitmap_width;
+        int height = symbol->bitmap_height;
+        int ref_row_size = mono ? (width + 7) / 8 : width * 4;
+        unsigned char *ref = (unsigned char *) malloc(ref_row_size * height);
+        assert_nonnull(ref, "i:%d malloc ref NULL\n", i);
+        memcpy(ref, symbol->bitmap, ref_row_size * height);
+
+        /* Target bigger than the symbol with padded rows, filled with a marker to check nothing outside written */
+        int bpp = data[i].format == ZINT_PIXEL_GRAY8 ? 1 : data[i].format == ZINT_PIXEL_RGB24 ? 3 : 4;
+        struct zint_target target;
+        target.width = data[i].x + width + 5;
+        target.height = data[i].y + height + 3;
+        target.stride = (mono ? (target.width + 7) / 8 : target.width * bpp) + 7;
+        target.format = data[i].format;
+        target.x = data[i].x;
+        target.y = data[i].y;
+        target.pixels = (unsigned char *) malloc(target.stride * target.height);
+        assert_nonnull(target.pixels, "i:%d malloc target NULL\n", i);
+        memset(target.pixels, 0xA5, target.stride * target.height);
+
+        symbol->output_options = output_options;
+        ret = ZBarcode_Buffer_Target(symbol, data[i].rotate_angle, &target);
+        assert_zero(ret, "i:%d ZBarcode_Buffer_Target ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_equal(symbol->bitmap_width, width, "i:%d bitmap_width %d != %d\n", i, symbol->bitmap_width, width);
+        assert_equal(symbol->bitmap_height, height, "i:%d bitmap_height %d != %d\n", i, symbol->bitmap_height, height);
+        assert_null(symbol->bitmap, "i:%d bitmap not NULL\n", i);
+        assert_null(symbol->alphamap, "i:%d alphamap not NULL\n", i);
+
+        for (int row = 0; row < target.height; row++) {
+            const unsigned char *trow = target.pixels + row * target.stride;
+            int in_row = row >= target.y && row < target.y + height;
+            for (int x = 0; x < target.width; x++) {
+                int inside = in_row && x >= target.x && x < target.x + width;
+                if (mono) {
+                    int bit = (trow[x >> 3] >> (7 - (x & 7))) & 1;
+                    int expected_bit = (0xA5 >> (7 - (x & 7))) & 1;
+                    if (inside) {
+                        const unsigned char *rrow = ref + (row - target.y) * ref_row_size;
+                        int rx = x - target.x;
+                        expected_bit = (rrow[rx >> 3] >> (7 - (rx & 7))) & 1;
+                    }
+                    assert_equal(bit, expected_bit, "i:%d row %d x %d bit %d != %d\n", i, row, x, bit, expected_bit);
+                } else {
+                    const unsigned char *pixel = trow + x * bpp;
+                    unsigned char expected[4] = { 0xA5, 0xA5, 0xA5, 0xA5 };
+                    if (inside) {
+                        const unsigned char *rgba = ref + (row - target.y) * ref_row_size + (x - target.x) * 4;
+                        if (data[i].format == ZINT_PIXEL_GRAY8) {
+                            expected[0] = (unsigned char) ((rgba[0] * 299 + rgba[1] * 587 + rgba[2] * 114 + 500) / 1000);
+                        } else if (data[i].format == ZINT_PIXEL_BGRA32) {
+                            expected[0] = rgba[2];
+                            expected[1] = rgba[1];
+                            expected[2] = rgba[0];
+                            expected[3] = rgba[3];
+                        } else {
+                            memcpy(expected, rgba, 4);
+                        }
+                    }
+                    assert_zero(memcmp(pixel, expected, bpp), "i:%d row %d x %d pixel %02X%02X%02X != %02X%02X%02X\n",
+                                i, row, x, pixel[0], bpp > 1 ? pixel[1] : 0, bpp > 1 ? pixel[2] : 0,
+                                expected[0], expected[1], expected[2]);
+                }
+            }
+            /* Row padding untouched */
+            int used = mono ? (target.width + 7) / 8 : target.width * bpp;
+            for (int j = used; j < target.stride; j++) {
+                assert_equal(trow[j], 0xA5, "i:%d row %d padding %d 0x%02X != 0xA5\n", i, row, j, trow[j]);
+            }
+        }
+
+        free(ref);
+        free(target.pixels);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_buffer_target_errors(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        unsigned char *pixels;
+        int stride;
+        int width;
+        int height;
+        int format;
+        int x;
+        int y;
+        int rotate_angle;
+        int ret;
+        char *expected_errtxt;
+    };
+    unsigned char pixels[200 * 200 * 4];
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { pixels, 800, 200, 200, ZINT_PIXEL_RGBA32, 0, 0, 0, 0, "" },
+        /*  1*/ { pixels, 800, 200, 200, 0, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 478: Invalid target pixel format 0" },
+        /*  2*/ { pixels, 800, 200, 200, ZINT_PIXEL_BGRA32 + 1, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 478: Invalid target pixel format 6" },
+        /*  3*/ { NULL, 800, 200, 200, ZINT_PIXEL_RGBA32, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 479: Invalid target buffer, size or stride" },
+        /*  4*/ { pixels, 799, 200, 200, ZINT_PIXEL_RGBA32, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 479: Invalid target buffer, size or stride" },
+        /*  5*/ { pixels, 25, 200, 200, ZINT_PIXEL_MONO1, 0, 0, 0, 0, "" },
+        /*  6*/ { pixels, 24, 200, 200, ZINT_PIXEL_MONO1, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 479: Invalid target buffer, size or stride" },
+        /*  7*/ { pixels, 400, 0, 100, ZINT_PIXEL_GRAY8, 0, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 479: Invalid target buffer, size or stride" },
+        /*  8*/ { pixels, 800, 200, 200, ZINT_PIXEL_RGBA32, 0, 0, 45, ZINT_ERROR_INVALID_OPTION, "Error 536: Invalid rotation angle" },
+        /*  9*/ { pixels, 800, 200, 200, ZINT_PIXEL_RGB24, 109, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 668: Symbol size 92x116 at 109,0 outside target 200x200" },
+        /* 10*/ { pixels, 800, 200, 200, ZINT_PIXEL_RGB24, 108, 84, 0, 0, "" },
+        /* 11*/ { pixels, 800, 200, 200, ZINT_PIXEL_RGB24, 108, 85, 0, ZINT_ERROR_INVALID_OPTION, "Error 668: Symbol size 92x116 at 108,85 outside target 200x200" },
+        /* 12*/ { pixels, 800, 200, 200, ZINT_PIXEL_RGB24, 0, 0, 90, 0, "" },
+        /* 13*/ { pixels, 800, 200, 200, ZINT_PIXEL_RGB24, 85, 0, 90, ZINT_ERROR_INVALID_OPTION, "Error 668: Symbol size 116x92 at 85,0 outside target 200x200" },
+        /* 14*/ { pixels, 800, 200, 200, ZINT_PIXEL_RGB24, -1, 0, 0, ZINT_ERROR_INVALID_OPTION, "Error 668: Symbol size 92x116 at -1,0 outside target 200x200" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, BARCODE_CODE128, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, -1 /*output_options*/, "1", -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) "1", length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        struct zint_target target = { data[i].pixels, data[i].stride, data[i].width, data[i].height, data[i].format, data[i].x, data[i].y };
+        ret = ZBarcode_Buffer_Target(symbol, data[i].rotate_angle, &target);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Buffer_Target ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+        assert_zero(strcmp(symbol->errtxt, data[i].expected_errtxt), "i:%d errtxt \"%s\" != \"%s\"\n", i, symbol->errtxt, data[i].expected_errtxt);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    if (index == -1) {
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        ret = ZBarcode_Buffer_Target(NULL, 0, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Buffer_Target(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+
+        ret = ZBarcode_Buffer_Target(symbol, 0, NULL);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Buffer_Target(symbol, NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+        assert_zero(strcmp(symbol->errtxt, "Error 477: Target NULL"), "errtxt \"%s\" != \"Error 477: Target NULL\"\n", symbol->errtxt);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_sheet(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        int rotate_angle;
+        int x;
+        int y;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, 0, 0, 0, 0, "1234" },
+        /*  1*/ { BARCODE_EANX, -1, 1.0f, 90, 130, 3, "123456789012+12" },
+        /*  2*/ { BARCODE_QRCODE, BARCODE_ANTIALIAS, 2.3f, 180, 10, 140, "1234" },
+        /*  3*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 2.2f, 270, 240, 180, "1234" },
+        /*  4*/ { BARCODE_MAXICODE, -1, 0.7f, 0, 290, 0, "1234" },
+        /*  5*/ { BARCODE_CODE128, -1, 0.5f, 0, 110, 190, "1234" }, /* Overlaps previous */
+    };
+    int data_size = ARRAY_SIZE(data);
+    int width = 500, height = 320;
+    struct zint_symbol *symbols[ARRAY_SIZE(data)];
+    struct zint_sheet_item items[ARRAY_SIZE(data)];
+    char *fgcolour = "102030", *bgcolour = "F0E0D0";
+
+    (void)index;
+
+    struct zint_symbol *sheet = ZBarcode_Create();
+    assert_nonnull(sheet, "Sheet not created\n");
+    sheet->output_options = BARCODE_MEMORY_FILE;
+    strcpy(sheet->outfile, "mem.pgm");
+    strcpy(sheet->fgcolour, fgcolour);
+    strcpy(sheet->bgcolour, bgcolour);
+
+    /* Reference page, each symbol rendered into it in turn in the sheet's colours */
+    struct zint_target target;
+    target.width = width;
+    target.height = height;
+    target.stride = width;
+    target.format = ZINT_PIXEL_GRAY8;
+    target.pixels = (unsigned char *) malloc(width * height);
+    assert_nonnull(target.pixels, "malloc target NULL\n");
+    memset(target.pixels, (0xF0 * 299 + 0xE0 * 587 + 0xD0 * 114 + 500) / 1000, width * height);
+
+    for (int i = 0; i < data_size; i++) {
+        symbols[i] = ZBarcode_Create();
+        assert_nonnull(symbols[i], "i:%d Symbol not created\n", i);
+
+        int length = testUtilSetSymbol(symbols[i], data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbols[i]->scale = data[i].scale;
+        }
+        ret = ZBarcode_Encode(symbols[i], (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbols[i]->errtxt);
+
+        items[i].symbol = symbols[i];
+        items[i].x = data[i].x;
+        items[i].y = data[i].y;
+        items[i].rotate_angle = data[i].rotate_angle;
+
+        /* No anti-aliasing as sheet not PNG */
+        symbols[i]->output_options &= ~BARCODE_ANTIALIAS;
+        strcpy(symbols[i]->fgcolour, fgcolour);
+        strcpy(symbols[i]->bgcolour, bgcolour);
+        target.x = data[i].x;
+        target.y = data[i].y;
+        ret = ZBarcode_Buffer_Target(symbols[i], data[i].rotate_angle, &target);
+        assert_zero(ret, "i:%d ZBarcode_Buffer_Target ret %d != 0 (%s)\n", i, ret, symbols[i]->errtxt);
+
+        /* Items' own colours and options ignored on sheet */
+        symbols[i]->output_options = data[i].output_options == -1 ? 0 : data[i].output_options;
+        strcpy(symbols[i]->fgcolour, "FF0000");
+        strcpy(symbols[i]->bgcolour, "00FF00");
+    }
+
+    ret = ZBarcode_Print_Sheet(sheet, width, height, items, data_size);
+    assert_zero(ret, "ZBarcode_Print_Sheet ret %d != 0 (%s)\n", ret, sheet->errtxt);
+
+    char header[32];
+    int header_len = sprintf(header, "P5\n%d %d\n255\n", width, height);
+    assert_equal(sheet->memfile_size, header_len + width * height, "memfile_size %d != %d\n", sheet->memfile_size, header_len + width * height);
+    assert_zero(memcmp(sheet->memfile, header, header_len), "memfile header mismatch\n");
+    for (int j = 0; j < width * height; j++) {
+        assert_equal(sheet->memfile[header_len + j], target.pixels[j], "pixel %d (%d,%d) 0x%02X != 0x%02X\n", j, j % width, j / width, sheet->memfile[header_len + j], target.pixels[j]);
+    }
+
+    /* Items unchanged */
+    for (int i = 0; i < data_size; i++) {
+        assert_zero(strcmp(symbols[i]->fgcolour, "FF0000"), "i:%d fgcolour changed\n", i);
+        assert_equal(symbols[i]->output_options, data[i].output_options == -1 ? 0 : data[i].output_options, "i:%d output_options 0x%X changed\n", i, symbols[i]->output_options);
+    }
+
+    /* PNG sheet, anti-aliased */
+    strcpy(sheet->outfile, "mem.png");
+    sheet->output_options |= BARCODE_ANTIALIAS;
+    ret = ZBarcode_Print_Sheet(sheet, width, height, items, data_size);
+    assert_zero(ret, "ZBarcode_Print_Sheet PNG ret %d != 0 (%s)\n", ret, sheet->errtxt);
+    assert_nonzero(sheet->memfile_size > 8, "PNG memfile_size %d <= 8\n", sheet->memfile_size);
+    assert_zero(memcmp(sheet->memfile, "\x89PNG\r\n\x1A\n", 8), "PNG signature mismatch\n");
+
+    /* Empty sheet */
+    ret = ZBarcode_Print_Sheet(sheet, 10, 10, NULL, 0);
+    assert_zero(ret, "ZBarcode_Print_Sheet empty ret %d != 0 (%s)\n", ret, sheet->errtxt);
+
+    free(target.pixels);
+    for (int i = 0; i < data_size; i++) {
+        ZBarcode_Delete(symbols[i]);
+    }
+    ZBarcode_Delete(sheet);
+
+    testFinish();
+}
+
+static void test_sheet_errors(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        int null_symbol;
+        int rotate_angle;
+        int x;
+        int y;
+        char *outfile;
+        int width;
+        int height;
+        int count;
+        int ret;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, 0, 0, 0, 0, "out.gif", 200, 200, 1, 0, "" },
+        /*  1*/ { BARCODE_CODE128, -1, 0, 0, 0, 0, "out.gif", 0, 200, 1, ZINT_ERROR_INVALID_OPTION, "Error 538: Invalid sheet size 0x200" },
+        /*  2*/ { BARCODE_CODE128, -1, 0, 0, 0, 0, "out.gif", 200, -1, 1, ZINT_ERROR_INVALID_OPTION, "Error 538: Invalid sheet size 200x-1" },
+        /*  3*/ { BARCODE_CODE128, -1, 0, 0, 0, 0, "out.gif", 65536, 65536, 1, ZINT_ERROR_INVALID_OPTION, "Error 538: Invalid sheet size 65536x65536" },
+        /*  4*/ { BARCODE_CODE128, -1, 0, 0, 0, 0, "out.gif", 200, 200, -1, ZINT_ERROR_INVALID_DATA, "Error 539: Sheet items NULL or count negative" },
+        /*  5*/ { BARCODE_CODE128, -1, 0, 0, 0, 0, "out.svg", 200, 200, 1, ZINT_ERROR_INVALID_OPTION, "Error 540: Unknown or non-raster sheet output format" },
+        /*  6*/ { BARCODE_CODE128, -1, 0, 0, 0, 0, "png", 200, 200, 1, ZINT_ERROR_INVALID_OPTION, "Error 540: Unknown or non-raster sheet output format" },
+        /*  7*/ { BARCODE_CODE128, -1, 1, 0, 0, 0, "out.gif", 200, 200, 1, ZINT_ERROR_INVALID_DATA, "Error 543: Sheet item 0 symbol NULL" },
+        /*  8*/ { BARCODE_CODE128, -1, 0, 45, 0, 0, "out.gif", 200, 200, 1, ZINT_ERROR_INVALID_OPTION, "Error 544: Sheet item 0 invalid rotation angle" },
+        /*  9*/ { BARCODE_ULTRA, -1, 0, 0, 0, 0, "out.gif", 200, 200, 1, ZINT_ERROR_INVALID_OPTION, "Error 545: Sheet item 0 Ultracode not supported" },
+        /* 10*/ { BARCODE_CODE128, BARCODE_DOTTY_MODE, 0, 0, 0, 0, "out.gif", 200, 200, 1, ZINT_ERROR_INVALID_OPTION, "Error 546: Sheet item 0 symbology cannot be rendered as dots" },
+        /* 11*/ { BARCODE_CODE128, -1, 0, 0, 109, 0, "out.gif", 200, 200, 1, ZINT_ERROR_INVALID_OPTION, "Error 684: Sheet item 0: 668: Symbol size 92x116 at 109,0 outside target 200x200" },
+        /* 12*/ { BARCODE_CODE128, -1, 0, 90, 85, 0, "out.gif", 200, 200, 1, ZINT_ERROR_INVALID_OPTION, "Error 684: Sheet item 0: 668: Symbol size 116x92 at 85,0 outside target 200x200" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *sheet = ZBarcode_Create();
+        assert_nonnull(sheet, "Sheet not created\n");
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, "1", -1, debug);
+        ret = ZBarcode_Encode(symbol, (unsigned char *) "1", length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        sheet->output_options = BARCODE_MEMORY_FILE;
+        strcpy(sheet->outfile, data[i].outfile);
+        struct zint_sheet_item item = { data[i].null_symbol ? NULL : symbol, data[i].x, data[i].y, data[i].rotate_angle };
+
+        ret = ZBarcode_Print_Sheet(sheet, data[i].width, data[i].height, &item, data[i].count);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Print_Sheet ret %d != %d (%s)\n", i, ret, data[i].ret, sheet->errtxt);
+        assert_zero(strcmp(sheet->errtxt, data[i].expected_errtxt), "i:%d errtxt \"%s\" != \"%s\"\n", i, sheet->errtxt, data[i].expected_errtxt);
+
+        ZBarcode_Delete(symbol);
+        ZBarcode_Delete(sheet);
+    }
+
+    if (index == -1) {
+        ret = ZBarcode_Print_Sheet(NULL, 10, 10, NULL, 0);
+        assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Print_Sheet(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+    }
+
+    testFinish();
+}
+
+struct alloc_counts {
+    int mallocs;
+    int reallocs;
+    int frees;
+};
+
+static void *count_malloc(void *context, size_t size) {
+    ((struct alloc_counts *) context)->mallocs++;
+    return malloc(size);
+}
+
+static void *count_realloc(void *context, void *ptr, size_t size) {
+    ((struct alloc_counts *) context)->reallocs++;
+    return realloc(ptr, size);
+}
+
+static void count_free(void *context, void *ptr) {
+    ((struct alloc_counts *) context)->frees++;
+    free(ptr);
+}
+
+static void test_scratch_reuse(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        char *fgcolour;
+        float scale;
+        int rotate_angle;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, "", 0, 0, "1234" },
+        /*  1*/ { BARCODE_CODE128, -1, "", 2.5f, 90, "1234" },
+        /*  2*/ { BARCODE_EANX, -1, "", 0, 180, "123456789012" },
+        /*  3*/ { BARCODE_QRCODE, -1, "000000AA", 0, 0, "1234" },
+        /*  4*/ { BARCODE_QRCODE, OUT_BUFFER_INTERMEDIATE, "", 0, 0, "1234" },
+        /*  5*/ { BARCODE_QRCODE, OUT_BUFFER_INTERMEDIATE, "", 0, 270, "1234" },
+        /*  6*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, "", 0, 0, "1234" },
+        /*  7*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE | OUT_BUFFER_INTERMEDIATE, "", 0, 90, "1234" },
+        /*  8*/ { BARCODE_MAXICODE, -1, "", 0, 0, "1234" },
+        /*  9*/ { BARCODE_MAXICODE, OUT_BUFFER_INTERMEDIATE, "", 0, 0, "1234" },
+        /* 10*/ { BARCODE_ULTRA, -1, "", 0, 90, "1234" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct alloc_counts counts;
+    struct zint_allocator allocator = { count_malloc, count_realloc, count_free, &counts };
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create_Allocator(&allocator);
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (*data[i].fgcolour) {
+            strcpy(symbol->fgcolour, data[i].fgcolour);
+        }
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+
+        ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_nonnull(symbol->bitmap, "i:%d bitmap NULL\n", i);
+
+        int bitmap_size = symbol->bitmap_width * symbol->bitmap_height * (data[i].output_options != -1 && (data[i].output_options & OUT_BUFFER_INTERMEDIATE) ? 1 : 3);
+        unsigned char *bitmap = (unsigned char *) malloc(bitmap_size);
+        assert_nonnull(bitmap, "i:%d malloc bitmap NULL\n", i);
+        memcpy(bitmap, symbol->bitmap, bitmap_size);
+
+        /* Printing to a file neither allocates raster buffers nor disturbs the bitmap */
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+        strcpy(symbol->outfile, "mem.gif");
+        ret = ZBarcode_Print(symbol, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Print ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_zero(memcmp(symbol->bitmap, bitmap, bitmap_size), "i:%d bitmap changed by ZBarcode_Print\n", i);
+        symbol->output_options &= ~BARCODE_MEMORY_FILE;
+
+        ZBarcode_Clear(symbol);
+        assert_null(symbol->bitmap, "i:%d bitmap not NULL after ZBarcode_Clear\n", i);
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        /* Same size again, so no allocation */
+        memset(&counts, 0, sizeof(counts));
+        ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_zero(counts.mallocs, "i:%d counts.mallocs %d != 0\n", i, counts.mallocs);
+        assert_zero(counts.reallocs, "i:%d counts.reallocs %d != 0\n", i, counts.reallocs);
+        assert_zero(counts.frees, "i:%d counts.frees %d != 0\n", i, counts.frees);
+        assert_zero(memcmp(symbol->bitmap, bitmap, bitmap_size), "i:%d bitmap differs on re-use\n", i);
+        if (*data[i].fgcolour) {
+            assert_nonnull(symbol->alphamap, "i:%d alphamap NULL\n", i);
+        } else {
+            assert_null(symbol->alphamap, "i:%d alphamap not NULL\n", i);
+        }
+
+        free(bitmap);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+/* Scaled or rotated PNG, TIF and BMP files, made as written a row at a time, are the same as from the full image */
+static void test_print_rows(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        char *fgcolour;
+        float scale;
+        int rotate_angle;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, "", 2.5f, 0, "1234" },
+        /*  1*/ { BARCODE_CODE128, -1, "", 0.5f, 90, "1234" },
+        /*  2*/ { BARCODE_EANX, BARCODE_FAST_COMPRESS, "", 3.3f, 180, "123456789012+12" },
+        /*  3*/ { BARCODE_QRCODE, -1, "000000AA", 4.5f, 270, "12345678901234567890" }, /* Over several bands */
+        /*  4*/ { BARCODE_QRCODE, TIFF_CCITT_G4, "", 0, 90, "1234" },
+        /*  5*/ { BARCODE_QRCODE, TIFF_PACKBITS | BMP_RLE8, "", 1.7f, 180, "1234" },
+        /*  6*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, "", 2.2f, 270, "1234" },
+        /*  7*/ { BARCODE_MAXICODE, -1, "", 0.7f, 0, "1234" },
+        /*  8*/ { BARCODE_ULTRA, -1, "", 1.9f, 90, "1234" },
+    };
+    int data_size = ARRAY_SIZE(data);
+    const char *exts[] = { "png", "tif", "bmp" };
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        for (int j = 0; j < (int) ARRAY_SIZE(exts); j++) {
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+            if (*data[i].fgcolour) {
+                strcpy(symbol->fgcolour, data[i].fgcolour);
+            }
+            if (data[i].scale) {
+                symbol->scale = data[i].scale;
+            }
+            symbol->output_options |= BARCODE_MEMORY_FILE;
+            sprintf(symbol->outfile, "mem.%s", exts[j]);
+
+            ret = ZBarcode_Encode_and_Print(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+            assert_zero(ret, "i:%d %s ZBarcode_Encode_and_Print ret %d != 0 (%s)\n", i, exts[j], ret, symbol->errtxt);
+            assert_nonnull(symbol->memfile, "i:%d %s memfile NULL\n", i, exts[j]);
+
+            int rows_size = symbol->memfile_size;
+            unsigned char *rows_file = (unsigned char *) malloc(rows_size);
+            assert_nonnull(rows_file, "i:%d %s malloc rows_file NULL\n", i, exts[j]);
+            memcpy(rows_file, symbol->memfile, rows_size);
+
+            symbol->output_options |= OUT_BUFFER_INTERMEDIATE;
+            ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d %s ZBarcode_Buffer ret %d != 0 (%s)\n", i, exts[j], ret, symbol->errtxt);
+
+            if (j == 0) {
+                ret = png_pixel_plot(symbol, symbol->bitmap);
+            } else if (j == 1) {
+                ret = tif_pixel_plot(symbol, symbol->bitmap);
+            } else {
+                ret = bmp_pixel_plot(symbol, symbol->bitmap);
+            }
+            assert_zero(ret, "i:%d %s pixel_plot ret %d != 0 (%s)\n", i, exts[j], ret, symbol->errtxt);
+            assert_equal(symbol->memfile_size, rows_size, "i:%d %s memfile_size %d != %d\n", i, exts[j], symbol->memfile_size, rows_size);
+            assert_zero(memcmp(symbol->memfile, rows_file, rows_size), "i:%d %s memfile differs\n", i, exts[j]);
+
+            free(rows_file);
+            ZBarcode_Delete(symbol);
+        }
+    }
+
+    testFinish();
+}
+
+/* Anti-aliased output is the same size, unchanged at half-integer scales, and otherwise covers each row with
+   the same amount of ink as the modules to within the coverage level steps */
+static void test_antialias(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        int rotate_angle;
+        char *data;
+        int expected_levels; /* Whether partial coverage levels expected */
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, 1.3f, 0, "1234", 1 },
+        /*  1*/ { BARCODE_CODE128, -1, 0.7f, 180, "1234", 1 },
+        /*  2*/ { BARCODE_CODE128, -1, 2.5f, 0, "1234", 0 },
+        /*  3*/ { BARCODE_QRCODE, -1, 3.3f, 90, "1234", 1 },
+        /*  4*/ { BARCODE_DATAMATRIX, -1, 1.7f, 270, "1234", 1 },
+        /*  5*/ { BARCODE_DATAMATRIX, -1, 2, 0, "1234", 0 },
+        /*  6*/ { BARCODE_ULTRA, -1, 1.3f, 0, "1234", 0 }, /* Not anti-aliased */
+        /*  7*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 1.7f, 0, "1234", 0 }, /* Not scaled at end */
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        symbol->scale = data[i].scale;
+        symbol->show_hrt = 0;
+        int output_options = symbol->output_options;
+
+        ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        int width = symbol->bitmap_width;
+        int height = symbol->bitmap_height;
+        int bitmap_size = width * height * 3;
+        unsigned char *plain = (unsigned char *) malloc(bitmap_size);
+        assert_nonnull(plain, "i:%d malloc plain NULL\n", i);
+        memcpy(plain, symbol->bitmap, bitmap_size);
+
+        symbol->output_options = output_options | BARCODE_ANTIALIAS;
+        ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_equal(symbol->bitmap_width, width, "i:%d bitmap_width %d != %d\n", i, symbol->bitmap_width, width);
+        assert_equal(symbol->bitmap_height, height, "i:%d bitmap_height %d != %d\n", i, symbol->bitmap_height, height);
+
+        if (!data[i].expected_levels) {
+            assert_zero(memcmp(symbol->bitmap, plain, bitmap_size), "i:%d anti-aliased bitmap differs\n", i);
+        } else {
+            int grey_count = 0;
+            for (int j = 0; j < bitmap_size; j += 3) {
+                const unsigned char *pixel = symbol->bitmap + j;
+                assert_nonzero(pixel[0] == pixel[1] && pixel[1] == pixel[2], "i:%d pixel %d not grey\n", i, j / 3);
+                grey_count += pixel[0] != 0 && pixel[0] != 0xFF;
+            }
+            assert_nonzero(grey_count, "i:%d no grey pixels\n", i);
+
+            /* Compare the ink of each row (column if rotated) with that of the modules it comes from */
+            symbol->output_options = output_options | BARCODE_ANTIALIAS | OUT_BUFFER_INTERMEDIATE;
+            ret = ZBarcode_Buffer(symbol, 0);
+            assert_zero(ret, "i:%d ZBarcode_Buffer intermediate ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            const float module_size = symbol->scale * 2.0f; /* Pixels per module */
+            int whole_rows = 0;
+            for (int row = 0; row < symbol->bitmap_height; row++) {
+                float ink = 0.0f;
+                int module_row = (int) (row / module_size); /* No quiet zones, so rows map to module rows */
+                int dark = 0;
+                for (int column = 0; column < symbol->bitmap_width; column++) {
+                    const unsigned char ch = symbol->bitmap[row * symbol->bitmap_width + column];
+                    assert_nonzero(ch == '0' || ch == '1' || (ch >= '2' && ch <= '?'), "i:%d row %d column %d '%c' invalid\n", i, row, column, ch);
+                    ink += ch == '0' ? 0.0f : ch == '1' ? 1.0f : (ch - '1') / 15.0f;
+                }
+                if (data[i].symbology == BARCODE_CODE128 || module_row < symbol->rows) {
+                    for (int column = 0; column < symbol->width; column++) {
+                        dark += module_is_set(symbol, data[i].symbology == BARCODE_CODE128 ? 0 : module_row, column) ? 1 : 0;
+                    }
+                    /* Rows within a module row only (those across module row edges are blended vertically too) */
+                    if ((int) ((row + 1) / module_size) == module_row) {
+                        float expected = dark * module_size;
+                        float tolerance = symbol->width / 15.0f + 1.0f;
+                        assert_nonzero(ink - expected <= tolerance && expected - ink <= tolerance, "i:%d row %d ink %g != expected %g\n", i, row, ink, expected);
+                        whole_rows++;
+                    }
+                }
+            }
+            assert_nonzero(whole_rows, "i:%d no rows checked\n", i);
+        }
+
+        free(plain);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+/* Rendering in bands of lines on multiple threads gives the same image */
+static void test_parallel(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        float dot_size;
+        int rotate_angle;
+        char *data;
+        int expected_bands; /* Whether large enough to be rendered in more than one band */
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_QRCODE, -1, 50, 0.0f, 0, "1234567890", 1 },
+        /*  1*/ { BARCODE_QRCODE, BARCODE_BOX, 47.5f, 0.0f, 90, "1234567890", 1 },
+        /*  2*/ { BARCODE_PDF417, BARCODE_BIND, 20, 0.0f, 0, "1234567890ABCDEFGHIJ", 1 },
+        /*  3*/ { BARCODE_CODE128, -1, 100, 0.0f, 0, "1234", 1 },
+        /*  4*/ { BARCODE_ULTRA, -1, 60, 0.0f, 0, "1234", 1 },
+        /*  5*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 30, 0.0f, 0, "1234567890123456789012345678901234567890ABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJ", 1 },
+        /*  6*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 30, 1.5f, 180, "1234567890123456789012345678901234567890ABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJ", 1 },
+        /*  7*/ { BARCODE_DOTCODE, -1, 40, 0.0f, 0, "1234567890ABCDEFGHIJ", 1 },
+        /*  8*/ { BARCODE_QRCODE, -1, 1, 0.0f, 0, "1234", 0 },
+        /*  9*/ { BARCODE_EANX, -1, 50, 0.0f, 0, "123456789012+12", 1 }, /* UPC/EAN rendered on calling thread */
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        unsigned char *plain = NULL;
+        size_t bitmap_size = 0;
+        int width = 0, height = 0;
+
+        /* Without and then with RASTER_PARALLEL, each in a fresh symbol as rendering may set `height` */
+        for (int j = 0; j < 2; j++) {
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+            symbol->scale = data[i].scale;
+            if (data[i].dot_size) {
+                symbol->dot_size = data[i].dot_size;
+            }
+            if (j == 1) {
+                symbol->output_options |= RASTER_PARALLEL;
+            }
+
+            ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+            assert_zero(ret, "i:%d j:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, j, ret, symbol->errtxt);
+
+            if (j == 0) {
+                width = symbol->bitmap_width;
+                height = symbol->bitmap_height;
+                bitmap_size = (size_t) width * height * 3;
+                if (debug & ZINT_DEBUG_TEST_PRINT) {
+                    printf("i:%d %s %dx%d\n", i, testUtilBarcodeName(data[i].symbology), width, height);
+                }
+                assert_equal(width * height >= 0x200000, data[i].expected_bands, "i:%d %dx%d bands %d != %d\n", i, width, height, width * height >= 0x200000, data[i].expected_bands);
+                plain = (unsigned char *) malloc(bitmap_size);
+                assert_nonnull(plain, "i:%d malloc plain NULL\n", i);
+                memcpy(plain, symbol->bitmap, bitmap_size);
+            } else {
+                assert_equal(symbol->bitmap_width, width, "i:%d bitmap_width %d != %d\n", i, symbol->bitmap_width, width);
+                assert_equal(symbol->bitmap_height, height, "i:%d bitmap_height %d != %d\n", i, symbol->bitmap_height, height);
+                assert_zero(memcmp(symbol->bitmap, plain, bitmap_size), "i:%d parallel bitmap differs\n", i);
+            }
+
+            ZBarcode_Delete(symbol);
+        }
+
+        free(plain);
+    }
+
+    testFinish();
+}
+
+/* Cached hexagon/dot stamps and text glyphs are re-made when scale or dot size changes */
+static void test_stamp_cache(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        float dot_size;
+        float scale2;
+        float dot_size2;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_MAXICODE, -1, 1, 0, 3.5f, 0, "1234" },
+        /* 1*/ { BARCODE_MAXICODE, -1, 12, 0, 0.5f, 0, "1234" },
+        /* 2*/ { BARCODE_DOTCODE, -1, 1, 0, 5, 0, "1234" },
+        /* 3*/ { BARCODE_DOTCODE, -1, 4, 0.6f, 4, 1.5f, "1234" },
+        /* 4*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 2, 0, 2, 3, "1234" },
+        /* 5*/ { BARCODE_EANX, -1, 1, 0, 3.5f, 0, "123456789012+12" },
+        /* 6*/ { BARCODE_UPCE, -1, 10, 0, 2, 0, "1234567+12345" },
+        /* 7*/ { BARCODE_CODE128, BOLD_TEXT, 2, 0, 1.5f, 0, "Aé\\{" },
+        /* 8*/ { BARCODE_CODE128, SMALL_TEXT, 0.5f, 0, 7.5f, 0, "1234" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+        struct zint_symbol *symbol2 = ZBarcode_Create();
+        assert_nonnull(symbol2, "Symbol2 not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        symbol->scale = data[i].scale;
+        if (data[i].dot_size) {
+            symbol->dot_size = data[i].dot_size;
+        }
+        (void) testUtilSetSymbol(symbol2, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        symbol2->scale = data[i].scale2;
+        if (data[i].dot_size2) {
+            symbol2->dot_size = data[i].dot_size2;
+        }
+
+        ret = ZBarcode_Encode_and_Buffer(symbol, (unsigned char *) data[i].data, length, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        int bitmap_size = symbol->bitmap_width * symbol->bitmap_height * 3;
+        unsigned char *bitmap = (unsigned char *) malloc(bitmap_size);
+        assert_nonnull(bitmap, "i:%d malloc bitmap NULL\n", i);
+        memcpy(bitmap, symbol->bitmap, bitmap_size);
+
+        ret = ZBarcode_Encode_and_Buffer(symbol2, (unsigned char *) data[i].data, length, 0);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer symbol2 ret %d != 0 (%s)\n", i, ret, symbol2->errtxt);
+
+        /* Change to second scale/dot size, using stamp cached for first */
+        symbol->scale = symbol2->scale;
+        symbol->dot_size = symbol2->dot_size;
+        ret = ZBarcode_Buffer(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer 2 ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_equal(symbol->bitmap_width, symbol2->bitmap_width, "i:%d bitmap_width %d != %d\n", i, symbol->bitmap_width, symbol2->bitmap_width);
+        assert_equal(symbol->bitmap_height, symbol2->bitmap_height, "i:%d bitmap_height %d != %d\n", i, symbol->bitmap_height, symbol2->bitmap_height);
+        assert_zero(memcmp(symbol->bitmap, symbol2->bitmap, symbol2->bitmap_width * symbol2->bitmap_height * 3), "i:%d bitmap differs from fresh symbol\n", i);
+
+        /* And back again */
+        symbol->scale = data[i].scale;
+        symbol->dot_size = data[i].dot_size ? data[i].dot_size : 4.0f / 5.0f;
+        ret = ZBarcode_Buffer(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer 3 ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_equal(symbol->bitmap_width * symbol->bitmap_height * 3, bitmap_size, "i:%d bitmap size %d != %d\n", i, symbol->bitmap_width * symbol->bitmap_height * 3, bitmap_size);
+        assert_zero(memcmp(symbol->bitmap, bitmap, bitmap_size), "i:%d bitmap differs on return to first scale\n", i);
+
+        free(bitmap);
+        ZBarcode_Delete(symbol);
+        ZBarcode_Delete(symbol2);
+    }
+
+    testFinish();
+}
+
+/* 4-state symbols (rows pre-rendered by `plot_4state_lines()`) same as when drawn generically */
+static void test_4state(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        int whitespace_width;
+        int whitespace_height;
+        int rotate_angle;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_AUSPOST, -1, 0, 0, 0, 0, "12345678901234567890123" },
+        /*  1*/ { BARCODE_AUSREPLY, -1, 1.5f, 0, 0, 0, "12345678" },
+        /*  2*/ { BARCODE_AUSROUTE, -1, 0.5f, 0, 0, 0, "12345678" },
+        /*  3*/ { BARCODE_AUSREDIRECT, -1, 3, 0, 0, 90, "12345678" },
+        /*  4*/ { BARCODE_RM4SCC, -1, 0, 0, 0, 0, "1234567890" },
+        /*  5*/ { BARCODE_RM4SCC, BARCODE_BOX, 2.7f, 3, 2, 0, "1234567890" },
+        /*  6*/ { BARCODE_KIX, -1, 4, 0, 0, 180, "123456ABCDE" },
+        /*  7*/ { BARCODE_JAPANPOST, -1, 2, 0, 0, 0, "1234567890" },
+        /*  8*/ { BARCODE_USPS_IMAIL, BARCODE_BIND, 1, 5, 0, 270, "12345678901234567890" },
+        /*  9*/ { BARCODE_DAFT, -1, 7.5f, 0, 0, 0, "DAFTDAFTDAFTDAFT" },
+        /* 10*/ { BARCODE_MAILMARK, -1, 0, 0, 0, 0, "01000000000000000AA00AA0A" },
+        /* 11*/ { BARCODE_MAILMARK, RASTER_PARALLEL, 50, 0, 0, 0, "01000000000000000AA00AA0A" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+        symbol->whitespace_width = data[i].whitespace_width;
+        symbol->whitespace_height = data[i].whitespace_height;
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_equal(symbol->rows, 3, "i:%d rows %d != 3\n", i, symbol->rows);
+
+        /* Copy as a symbology drawn generically (4-state has no text) */
+        struct zint_symbol *generic = ZBarcode_Create();
+        assert_nonnull(generic, "Generic symbol not created\n");
+        generic->symbology = BARCODE_PHARMA_TWO; /* Also not stackable */
+        generic->output_options = symbol->output_options;
+        generic->scale = symbol->scale;
+        generic->whitespace_width = symbol->whitespace_width;
+        generic->whitespace_height = symbol->whitespace_height;
+        generic->border_width = symbol->border_width;
+        generic->show_hrt = 0;
+        generic->rows = symbol->rows;
+        generic->width = symbol->width;
+        generic->height = symbol->height;
+        memcpy(generic->internal->encoded_data, symbol->internal->encoded_data, sizeof(symbol->internal->encoded_data));
+        memcpy(generic->row_height, symbol->row_height, sizeof(symbol->row_height));
+
+        ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        ret = ZBarcode_Buffer(generic, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Buffer generic ret %d != 0 (%s)\n", i, ret, generic->errtxt);
+
+        if (debug & ZINT_DEBUG_TEST_PRINT) {
+            printf("i:%d %s %dx%d\n", i, testUtilBarcodeName(data[i].symbology), symbol->bitmap_width, symbol->bitmap_height);
+        }
+        assert_equal(symbol->bitmap_width, generic->bitmap_width, "i:%d bitmap_width %d != %d\n", i, symbol->bitmap_width, generic->bitmap_width);
+        assert_equal(symbol->bitmap_height, generic->bitmap_height, "i:%d bitmap_height %d != %d\n", i, symbol->bitmap_height, generic->bitmap_height);
+        assert_zero(memcmp(symbol->bitmap, generic->bitmap, (size_t) symbol->bitmap_width * symbol->bitmap_height * 3), "i:%d bitmap differs from generic\n", i);
+
+        ZBarcode_Delete(generic);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_buffer_fit(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        int rotate_angle;
+        int max_width;
+        int max_height;
+        int integer_modules_only;
+        char *data;
+        int ret;
+        char *expected_errtxt;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, -1, 0, 400, 200, 0, "AIM", 0, "" },
+        /*  1*/ { BARCODE_CODE128, -1, 0, 400, 200, 1, "AIM", 0, "" },
+        /*  2*/ { BARCODE_CODE128, -1, 90, 400, 0, 0, "AIM", 0, "" },
+        /*  3*/ { BARCODE_QRCODE, -1, 0, 333, 333, 1, "1234567890", 0, "" },
+        /*  4*/ { BARCODE_QRCODE, -1, 270, 0, 1000, 0, "1234567890", 0, "" },
+        /*  5*/ { BARCODE_EANX, -1, 0, 500, 97, 0, "123456789012+12", 0, "" },
+        /*  6*/ { BARCODE_EANX, BARCODE_BOX, 180, 511, 1000, 1, "123456789012", 0, "" },
+        /*  7*/ { BARCODE_PDF417, -1, 0, 640, 480, 0, "1234567890", 0, "" },
+        /*  8*/ { BARCODE_MAXICODE, -1, 0, 300, 300, 0, "1234", 0, "" },
+        /*  9*/ { BARCODE_MAXICODE, -1, 90, 300, 300, 1, "1234", 0, "" },
+        /* 10*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 0, 250, 250, 0, "1234567890", 0, "" },
+        /* 11*/ { BARCODE_ULTRA, -1, 0, 123, 456, 1, "A", 0, "" },
+        /* 12*/ { BARCODE_CODE128, -1, 0, 1, 1, 0, "AIM", ZINT_ERROR_INVALID_OPTION, "Error 758: Symbol too large (" },
+        /* 13*/ { BARCODE_CODE128, -1, 0, 0, 0, 0, "AIM", ZINT_ERROR_INVALID_OPTION, "Error 755: Invalid maximum size 0x0" },
+        /* 14*/ { BARCODE_CODE128, -1, 0, -1, 10, 0, "AIM", ZINT_ERROR_INVALID_OPTION, "Error 755: Invalid maximum size -1x10" },
+        /* 15*/ { BARCODE_CODE128, -1, 45, 10, 10, 0, "AIM", ZINT_ERROR_INVALID_OPTION, "Error 756: Invalid rotation angle" },
+        /* 16*/ { BARCODE_CODE128, BARCODE_DOTTY_MODE, 0, 10, 10, 0, "AIM", ZINT_ERROR_INVALID_OPTION, "Error 757: Selected symbology cannot be rendered as dots" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1, -1, -1, data[i].output_options, data[i].data, -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        ret = ZBarcode_Buffer_Fit(symbol, data[i].rotate_angle, data[i].max_width, data[i].max_height, data[i].integer_modules_only);
+        assert_equal(ret, data[i].ret, "i:%d ZBarcode_Buffer_Fit ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
+
+        if (ret < ZINT_ERROR) {
+            const float step = data[i].integer_modules_only ? 0.5f : 0.01f;
+            const float scale = symbol->scale;
+            const int fit_width = symbol->bitmap_width;
+            const int fit_height = symbol->bitmap_height;
+            int steps = (int) (scale / step + 0.5f);
+
+            if (debug & ZINT_DEBUG_TEST_PRINT) {
+                printf("i:%d %s max %dx%d scale %g bitmap %dx%d\n", i, testUtilBarcodeName(data[i].symbology), data[i].max_width, data[i].max_height, scale, fit_width, fit_height);
+            }
+            assert_nonnull(symbol->bitmap, "i:%d bitmap NULL\n", i);
+            assert_nonzero(steps * step - scale < 0.0001f && scale - steps * step < 0.0001f, "i:%d scale %g not multiple of %g\n", i, scale, step);
+            assert_nonzero(!data[i].max_width || fit_width <= data[i].max_width, "i:%d bitmap_width %d > %d\n", i, fit_width, data[i].max_width);
+            assert_nonzero(!data[i].max_height || fit_height <= data[i].max_height, "i:%d bitmap_height %d > %d\n", i, fit_height, data[i].max_height);
+
+            /* Same as buffering at that scale */
+            ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            assert_equal(symbol->bitmap_width, fit_width, "i:%d bitmap_width %d != %d\n", i, symbol->bitmap_width, fit_width);
+            assert_equal(symbol->bitmap_height, fit_height, "i:%d bitmap_height %d != %d\n", i, symbol->bitmap_height, fit_height);
+
+            /* And the next step up doesn't fit */
+            symbol->scale = (steps + 1) * step;
+            ret = ZBarcode_Buffer(symbol, data[i].rotate_angle);
+            assert_zero(ret, "i:%d ZBarcode_Buffer ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+            assert_nonzero((data[i].max_width && symbol->bitmap_width > data[i].max_width) || (data[i].max_height && symbol->bitmap_height > data[i].max_height),
+                        "i:%d scale %g bitmap %dx%d fits %dx%d\n", i, symbol->scale, symbol->bitmap_width, symbol->bitmap_height, data[i].max_width, data[i].max_height);
+        } else {
+            assert_zero(strncmp(symbol->errtxt, data[i].expected_errtxt, strlen(data[i].expected_errtxt)), "i:%d errtxt %s != %s\n", i, symbol->errtxt, data[i].expected_errtxt);
+            assert_equal(symbol->scale, 1.0f, "i:%d scale %g != 1\n", i, symbol->scale);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
@@ -1215,6 +2523,20 @@ int main(int argc, char *argv[]) {
         { "test_code128_utf8", test_code128_utf8, 1, 0, 1 },
         { "test_scale", test_scale, 1, 0, 1 },
         { "test_buffer_plot", test_buffer_plot, 1, 1, 1 },
+        { "test_scale_rotate", test_scale_rotate, 1, 0, 1 },
+        { "test_buffer_1bpp", test_buffer_1bpp, 1, 0, 1 },
+        { "test_buffer_rgba", test_buffer_rgba, 1, 0, 1 },
+        { "test_buffer_target", test_buffer_target, 1, 0, 1 },
+        { "test_buffer_target_errors", test_buffer_target_errors, 1, 0, 1 },
+        { "test_sheet", test_sheet, 1, 0, 1 },
+        { "test_sheet_errors", test_sheet_errors, 1, 0, 1 },
+        { "test_scratch_reuse", test_scratch_reuse, 1, 0, 1 },
+        { "test_print_rows", test_print_rows, 1, 0, 1 },
+        { "test_antialias", test_antialias, 1, 0, 1 },
+        { "test_stamp_cache", test_stamp_cache, 1, 0, 1 },
+        { "test_parallel", test_parallel, 1, 0, 1 },
+        { "test_4state", test_4state, 1, 0, 1 },
+        { "test_buffer_fit", test_buffer_fit, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
@@ -97,6 +97,8 @@ static void test_generate(int generate) {
         { "0x11d", 255, 0x11d, 0 },
         { "0x12d", 255, 0x12d, 0 },
         { "0x163", 255, 0x163, 0 },
+        { "0x409", 1023, 0x409, 1 },
+        { "0x1069", 4095, 0x1069, 1 },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -142,6 +144,7 @@ static void test_encoding(int index) {
         /* 15*/ { 0x43, 20, 1, 42, { 47, 40, 57, 3, 1, 19, 41, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33 }, { 1, 15, 22, 28, 39, 17, 60, 5, 35, 35, 4, 8, 0, 32, 51, 45, 63, 53, 61, 14 } }, // MAXICODE Annex H Secondary even
         /* 16*/ { 0x11d, 10, 0, 16, { 0x10, 0x20, 0x0C, 0x56, 0x61, 0x80, 0xEC, 0x11, 0xEC, 0x11, 0xEC, 0x11, 0xEC, 0x11, 0xEC, 0x11 }, { 0xA5, 0x24, 0xD4, 0xC1, 0xED, 0x36, 0xC7, 0x87, 0x2C, 0x55 } }, // QRCODE Annex I.2
         /* 17*/ { 0x11d, 5, 0, 5, { 0x40, 0x18, 0xAC, 0xC3, 0x00 }, { 0x86, 0x0D, 0x22, 0xAE, 0x30 } }, // QRCODE Annex I.3
+        /* 18*/ { 0x13, 15, 1, 3, { 1, 2, 3 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3 } }, // Generator x^15 + 1 has zero coefficients, so remainder is data
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -162,6 +165,16 @@ static void test_encoding(int index) {
             int k = data[i].nsym - 1 - j;
             assert_equal(res[k], data[i].expected[j], "i:%d res[%d] %d != expected[%d] %d\n", i, k, res[k], j, data[i].expected[j]);
         }
+
+        // Strided (interleaved) version, data every 3rd and result every 2nd
+        unsigned char strided[768];
+        for (int j = 0; j < data[i].datalen; j++) {
+            strided[j * 3] = data[i].data[j];
+        }
+        rs_encode_step(&rs, data[i].datalen, strided, 3, res, 2);
+        for (int j = 0; j < data[i].nsym; j++) {
+            assert_equal(res[j * 2], data[i].expected[j], "i:%d step res[%d] %d != expected[%d] %d\n", i, j * 2, res[j * 2], j, data[i].expected[j]);
+        }
     }
 
     testFinish();
@@ -195,10 +208,9 @@ static void test_encoding_uint(int index) {
 
         if (index != -1 && i != index) continue;
 
-        rs_uint_init_gf(&rs_uint, data[i].prime_poly, data[i].logmod);
+        rs_uint_init_gf(&rs_uint, data[i].prime_poly);
         rs_uint_init_code(&rs_uint, data[i].nsym, data[i].index);
         rs_uint_encode(&rs_uint, data[i].datalen, data[i].data, res);
-        rs_uint_free(&rs_uint);
 
         //fprintf(stderr, "res "); for (int j = data[i].nsym - 1; j >= 0; j--) fprintf(stderr, "%d ", res[j]); fprintf(stderr, "\n");
         //fprintf(stderr, "exp "); for (int j = 0; j < data[i].nsym; j++) fprintf(stderr, "%d ", data[i].expected[j]); fprintf(stderr, "\n");
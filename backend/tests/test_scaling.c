@@ -0,0 +1,175 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+/* Encode time versus input length for the variable-length symbologies, encoding each at 10%, 25%, 50% and 100% of
+ * its max capacity (for a mode switching pattern) and fitting a power curve `t = c * length^slope` by least squares
+ * on log-log, failing if the slope shows clearly superlinear growth. Fixed costs (symbol size selection, masking,
+ * error correction of the smallest sizes) pull the slope below 1, so a quadratic algorithm leaves a wide margin.
+ * With '-d 16' the timings are printed, giving the worst-case (max capacity) latency of each symbology */
+
+#include "testcommon.h"
+#include <math.h>
+#include <time.h>
+
+#define TEST_SCALING_MAX_SLOPE  1.6
+#define TEST_SCALING_BATCH_MS   10  /* Minimum time of a batch of encodes */
+#define TEST_SCALING_BATCHES    3   /* Best batch is taken, to reduce noise */
+
+/* Return the best per-encode time in microseconds of batches of encoding `data_buf` with the settings of `settings` */
+static double test_scaling_time(const struct zint_symbol *settings, const char *data_buf, const int length) {
+    double best = -1.0;
+    int b;
+
+    for (b = 0; b < TEST_SCALING_BATCHES; b++) {
+        clock_t start = clock(), elapsed;
+        int count = 0;
+        double us;
+
+        do {
+            struct zint_symbol *symbol = ZBarcode_Create();
+            symbol->symbology = settings->symbology;
+            symbol->input_mode = settings->input_mode;
+            symbol->option_1 = settings->option_1;
+            symbol->option_2 = settings->option_2;
+            (void) ZBarcode_Encode(symbol, (const unsigned char *) data_buf, length);
+            ZBarcode_Delete(symbol);
+            count++;
+            elapsed = clock() - start;
+        } while (elapsed < (clock_t) (CLOCKS_PER_SEC / 1000 * TEST_SCALING_BATCH_MS));
+
+        us = (double) elapsed * 1000000.0 / CLOCKS_PER_SEC / count;
+        if (best < 0.0 || us < best) {
+            best = us;
+        }
+    }
+
+    return best;
+}
+
+static void test_scaling(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int input_mode;
+        int option_1;
+        int option_2;
+        char *pattern;
+        int max_length;
+        char *comment;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, DATA_MODE, -1, -1, "1Aa", 60, "" },
+        /*  1*/ { BARCODE_CODABLOCKF, DATA_MODE, -1, -1, "1Aa", 2726, "" },
+        /*  2*/ { BARCODE_PDF417, DATA_MODE, 0, -1, "1A;a", 926, "Text/numeric/punctuation switching" },
+        /*  3*/ { BARCODE_PDF417, DATA_MODE, 0, -1, "0", 2710, "Numeric" },
+        /*  4*/ { BARCODE_PDF417, DATA_MODE | MINIMAL_MODE, 0, -1, "1A;a", 1110, "" },
+        /*  5*/ { BARCODE_MICROPDF417, DATA_MODE, -1, -1, "1Aa;", 125, "" },
+        /*  6*/ { BARCODE_MAXICODE, DATA_MODE, -1, -1, "AB", 93, "" },
+        /*  7*/ { BARCODE_QRCODE, DATA_MODE, -1, -1, "1A;a", 2953, "" },
+        /*  8*/ { BARCODE_QRCODE, DATA_MODE | MINIMAL_MODE, -1, -1, "1A;a", 2953, "" },
+        /*  9*/ { BARCODE_DATAMATRIX, DATA_MODE, -1, -1, "aB1;", 1558, "look_ahead_test() switching" },
+        /* 10*/ { BARCODE_DATAMATRIX, DATA_MODE, -1, -1, "0", 3116, "ASCII double digits" },
+        /* 11*/ { BARCODE_DATAMATRIX, DATA_MODE | MINIMAL_MODE, -1, -1, "aB1;", 1558, "" },
+        /* 12*/ { BARCODE_AZTEC, DATA_MODE, -1, -1, "1A;a", 1915, "" },
+        /* 13*/ { BARCODE_DOTCODE, DATA_MODE, -1, -1, "aB1;", 984, "" },
+        /* 14*/ { BARCODE_HANXIN, DATA_MODE, -1, -1, "1A;a", 3260, "" },
+        /* 15*/ { BARCODE_CODEONE, DATA_MODE, -1, -1, "aB1;", 1480, "c1_look_ahead_test() switching" },
+        /* 16*/ { BARCODE_CODEONE, DATA_MODE, -1, -1, "A1B2*>", 2218, "C40/X12" },
+        /* 17*/ { BARCODE_GRIDMATRIX, DATA_MODE, -1, -1, "1Aa", 1529, "" },
+        /* 18*/ { BARCODE_ULTRA, DATA_MODE, -1, -1, "1Aa", 249, "" },
+        /* 19*/ { BARCODE_RMQR, DATA_MODE, -1, -1, "1A;a", 150, "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+    static const int percents[] = { 10, 25, 50, 100 };
+    const int percents_size = ARRAY_SIZE(percents);
+
+    char data_buf[ZINT_MAX_DATA_LEN + 1];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+        double us[4];
+
+        for (int j = 0; j < percents_size; j++) {
+            int length = data[i].max_length * percents[j] / 100;
+
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+
+            testUtilStrCpyRepeat(data_buf, data[i].pattern, length);
+            assert_equal(length, (int) strlen(data_buf), "i:%d length %d != strlen(data_buf) %d\n", i, length, (int) strlen(data_buf));
+
+            (void) testUtilSetSymbol(symbol, data[i].symbology, data[i].input_mode, -1 /*eci*/, data[i].option_1, data[i].option_2, -1, -1 /*output_options*/, data_buf, length, debug);
+
+            /* Time first as encoding may adjust the options */
+            us[j] = test_scaling_time(symbol, data_buf, length);
+
+            /* Check it encodes (in particular that 100% is within capacity) */
+            ret = ZBarcode_Encode(symbol, (unsigned char *) data_buf, length);
+            assert_zero(ret >= ZINT_ERROR, "i:%d %s length %d ZBarcode_Encode ret %d >= ZINT_ERROR (%s)\n", i, testUtilBarcodeName(data[i].symbology), length, ret, symbol->errtxt);
+
+            sum_x += log(length);
+            sum_y += log(us[j]);
+            sum_xx += log(length) * log(length);
+            sum_xy += log(length) * log(us[j]);
+
+            ZBarcode_Delete(symbol);
+        }
+
+        double slope = (percents_size * sum_xy - sum_x * sum_y) / (percents_size * sum_xx - sum_x * sum_x);
+
+        if (debug & ZINT_DEBUG_TEST_PRINT) {
+            printf("i:%d %s max length %d: %.1f, %.1f, %.1f, %.1f us, slope %.2f\n", i, testUtilBarcodeName(data[i].symbology), data[i].max_length, us[0], us[1], us[2], us[3], slope);
+        }
+        assert_nonzero(slope <= TEST_SCALING_MAX_SLOPE, "i:%d %s slope %.2f > %.2f (%.1f, %.1f, %.1f, %.1f us) (%s)\n", i, testUtilBarcodeName(data[i].symbology), slope, TEST_SCALING_MAX_SLOPE, us[0], us[1], us[2], us[3], data[i].comment);
+    }
+
+    testFinish();
+}
+
+int main(int argc, char *argv[]) {
+
+    testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
+        { "test_scaling", test_scaling, 1, 0, 1 },
+    };
+
+    testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
+
+    testReport();
+
+    return 0;
+}
@@ -31,6 +31,9 @@
 
 #include "testcommon.h"
 #include <sys/stat.h>
+#ifndef NO_PNG
+#include <zlib.h>
+#endif
 
 static void test_print(int index, int generate, int debug) {
 
@@ -100,11 +103,15 @@ static void test_print(int index, int generate, int debug) {
         /* 38*/ { BARCODE_MAXICODE, -1, 1, BARCODE_BIND, -1, 1, -1, -1, -1, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "", "../data/svg/maxicode_vwsp1_bind1.svg" },
         /* 39*/ { BARCODE_DATAMATRIX, -1, 1, BARCODE_BIND | BARCODE_DOTTY_MODE, -1, 1, -1, -1, -1, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "", "../data/svg/datamatrix_vwsp1_bind1_dotty.svg" },
         /* 40*/ { BARCODE_DATAMATRIX, -1, 1, BARCODE_BIND | BARCODE_DOTTY_MODE, 1, 1, -1, -1, -1, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "", "../data/svg/datamatrix_hvwsp1_bind1_dotty.svg" },
+        /* 41*/ { BARCODE_CODE128, UNICODE_MODE, 3, BOLD_TEXT | BARCODE_BOX | SVG_COMPACT, -1, -1, -1, -1, -1, "Égjpqy", "", "../data/svg/code128_egrave_bold_box3_compact.svg" },
+        /* 42*/ { BARCODE_MAXICODE, -1, 2, BARCODE_BOX | SVG_COMPACT, -1, -1, -1, -1, -1, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "", "../data/svg/maxicode_box2_compact.svg" },
+        /* 43*/ { BARCODE_DATAMATRIX, -1, 1, BARCODE_BIND | BARCODE_DOTTY_MODE | SVG_COMPACT, -1, 1, -1, -1, -1, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "", "../data/svg/datamatrix_vwsp1_bind1_dotty_compact.svg" },
+        /* 44*/ { BARCODE_ULTRA, -1, -1, SVG_COMPACT, -1, -1, -1, -1, -1, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "", "../data/svg/ultra_compact.svg" },
     };
     int data_size = ARRAY_SIZE(data);
 
     char *data_dir = "../data/svg";
-    char *svg = "out.svg";
+    char svg[256];
     char escaped[1024];
     int escaped_size = 1024;
     char *text;
@@ -120,6 +127,8 @@ static void test_print(int index, int generate, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(svg, i, "svg");
+
         struct zint_symbol *symbol = ZBarcode_Create();
         assert_nonnull(symbol, "Symbol not created\n");
 
@@ -181,10 +190,124 @@ static void test_print(int index, int generate, int debug) {
     testFinish();
 }
 
+#ifndef NO_PNG
+/* Gunzip `size` bytes of `gz` into `out` of `out_size`, returning length or -1 on error */
+static int test_gunzip(const unsigned char *gz, const int size, unsigned char *out, const int out_size) {
+    z_stream strm;
+    int ret;
+
+    memset(&strm, 0, sizeof(strm));
+    if (inflateInit2(&strm, 15 + 16 /*gzip*/) != Z_OK) {
+        return -1;
+    }
+    strm.next_in = (unsigned char *) gz;
+    strm.avail_in = size;
+    strm.next_out = out;
+    strm.avail_out = out_size;
+    ret = inflate(&strm, Z_FINISH);
+    (void) inflateEnd(&strm);
+
+    return ret == Z_STREAM_END && strm.avail_in == 0 ? (int) strm.total_out : -1;
+}
+#endif
+
+static void test_gzip(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        char *outfile;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, BARCODE_MEMORY_FILE | SVG_GZIP, "out.svg", "AIM" },
+        /*  1*/ { BARCODE_DATAMATRIX, BARCODE_MEMORY_FILE | SVG_GZIP, "out.svg", "1234567890123456789012345678901234567890ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz1234567890123456789012345678901234567890ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz" },
+        /*  2*/ { BARCODE_PDF417, BARCODE_MEMORY_FILE | SVG_GZIP | BARCODE_FAST_COMPRESS, "out.svg", "1234567890123456789012345678901234567890ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz" },
+        /*  3*/ { BARCODE_MAXICODE, BARCODE_MEMORY_FILE | SVG_GZIP | SVG_COMPACT, "out.svg", "1234" },
+        /*  4*/ { BARCODE_QRCODE, BARCODE_MEMORY_FILE, "out.svgz", "1234567890" },
+        /*  5*/ { BARCODE_QRCODE, BARCODE_MEMORY_FILE, "OUT.SVGZ", "1234567890" },
+        /*  6*/ { BARCODE_QRCODE, -1, "out.svgz", "1234567890" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    static unsigned char plain[0x100000];
+    static unsigned char unzipped[0x100000];
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        /* Uncompressed reference */
+        const int output_options = symbol->output_options;
+        symbol->output_options = (output_options & ~SVG_GZIP) | BARCODE_MEMORY_FILE;
+        strcpy(symbol->outfile, "out.svg");
+        ret = ZBarcode_Print(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Print plain ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_nonzero(symbol->memfile_size <= (int) sizeof(plain), "i:%d memfile_size %d too big\n", i, symbol->memfile_size);
+        const int plain_size = symbol->memfile_size;
+        memcpy(plain, symbol->memfile, plain_size);
+
+        symbol->output_options = output_options;
+        if (output_options & BARCODE_MEMORY_FILE) {
+            strcpy(symbol->outfile, data[i].outfile);
+        } else {
+            testUtilOutFile(symbol->outfile, i, strrchr(data[i].outfile, '.') + 1);
+        }
+        ret = ZBarcode_Print(symbol, 0);
+#ifdef NO_PNG
+        assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "i:%d ZBarcode_Print ret %d != ZINT_ERROR_INVALID_OPTION (%s)\n", i, ret, symbol->errtxt);
+        assert_zero(strcmp(symbol->errtxt, "Error 744: SVG gzip compression not available (no zlib)"), "i:%d errtxt %s\n", i, symbol->errtxt);
+        (void) plain_size; (void) unzipped;
+#else
+        assert_zero(ret, "i:%d ZBarcode_Print ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+
+        unsigned char *gz = symbol->memfile;
+        int gz_size = symbol->memfile_size;
+        if (!(output_options & BARCODE_MEMORY_FILE)) {
+            FILE *fp = fopen(symbol->outfile, "rb");
+            assert_nonnull(fp, "i:%d fopen(%s) failed\n", i, symbol->outfile);
+            gz = (unsigned char *) malloc(sizeof(plain));
+            assert_nonnull(gz, "i:%d malloc failed\n", i);
+            gz_size = (int) fread(gz, 1, sizeof(plain), fp);
+            fclose(fp);
+            assert_zero(remove(symbol->outfile), "i:%d remove(%s) != 0\n", i, symbol->outfile);
+        }
+        assert_nonzero(gz_size > 10 && gz[0] == 0x1F && gz[1] == 0x8B, "i:%d not gzip (size %d)\n", i, gz_size);
+
+        ret = test_gunzip(gz, gz_size, unzipped, (int) sizeof(unzipped));
+        if (debug & ZINT_DEBUG_TEST_PRINT) {
+            printf("i:%d %s plain %d, gzipped %d\n", i, testUtilBarcodeName(data[i].symbology), plain_size, gz_size);
+        }
+        assert_equal(ret, plain_size, "i:%d gunzipped size %d != %d\n", i, ret, plain_size);
+        assert_zero(memcmp(unzipped, plain, plain_size), "i:%d gunzipped differs\n", i);
+        if (gz != symbol->memfile) {
+            free(gz);
+        }
+#endif
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
         { "test_print", test_print, 1, 1, 1 },
+        { "test_gzip", test_gzip, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
@@ -0,0 +1,314 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+/* Stress test of concurrent encoding and output, one symbol per thread */
+
+#include "testcommon.h"
+#include <pthread.h>
+
+#define THREADS_NUM         8
+#define THREADS_ITERATIONS  3
+
+/* Per-symbology data, tried in order with each primary (if composite) until one encodes */
+static const char *candidate_data[] = {
+    "12345678901", "123456789012", "1234567", "1234567890123", "12345678901234567", "1234",
+    "[01]12345678901231", "A1B", "1", "DAFT",
+};
+static const char *candidate_primary[] = {
+    "331234567890", "12345678901", "1234567", "[01]12345678901231",
+};
+
+/* Symbologies needing specific data */
+struct special_data {
+    int symbology;
+    int input_mode;
+    const char *data;
+    const char *primary;
+};
+static const struct special_data special_data[] = {
+    { BARCODE_UPCE_CHK, -1, "12345670", "" },
+    { BARCODE_FIM, -1, "A", "" },
+    { BARCODE_ISBNX, -1, "0123456789", "" },
+    { BARCODE_USPS_IMAIL, -1, "01234567094987654321", "" },
+    { BARCODE_MAILMARK, -1, "01000000000000000AA00AA0A", "" },
+    { BARCODE_DPD, -1, "%000393206219912345678101040", "" },
+    { BARCODE_VIN, -1, "2FTPX28L0XCA15511", "" },
+    { BARCODE_GS1_128_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231" },
+    { BARCODE_DBAR_OMN_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231" },
+    { BARCODE_DBAR_LTD_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231" },
+    { BARCODE_DBAR_EXP_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231" },
+    { BARCODE_DBAR_STK_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231" },
+    { BARCODE_DBAR_OMNSTK_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231" },
+    { BARCODE_DBAR_EXPSTK_CC, GS1_MODE, "[21]A12345678", "[01]12345678901231" },
+    { BARCODE_EANX_CC, GS1_MODE, "[21]A12345678", "331234567890" },
+    { BARCODE_UPCA_CC, GS1_MODE, "[21]A12345678", "12345678901" },
+    { BARCODE_UPCE_CC, GS1_MODE, "[21]A12345678", "1234567" },
+};
+
+struct thread_item {
+    int symbology;
+    int input_mode;
+    const char *data;
+    const char *primary;
+    unsigned int expected_hash;
+    struct zint_prepared *prepared; /* Shared by all threads if `use_prepared` */
+};
+
+static struct thread_item items[146];
+static int items_size;
+
+/* FNV-1a */
+static unsigned int hash_bytes(unsigned int hash, const unsigned char *bytes, const int length) {
+    int i;
+    for (i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619;
+    }
+    return hash;
+}
+
+/* Encode (using its prepared encoder if `use_prepared`) and output item, returning a hash of the modules, bitmap
+   and SVG output, or 0 on failure */
+static unsigned int encode_item(const struct thread_item *item, const int use_prepared) {
+    unsigned int hash = 2166136261u;
+    int ret;
+    struct zint_symbol *symbol = ZBarcode_Create();
+
+    if (!symbol) {
+        return 0;
+    }
+    symbol->symbology = item->symbology;
+    if (item->input_mode != -1) {
+        symbol->input_mode = item->input_mode;
+    }
+    strcpy(symbol->primary, item->primary);
+
+    if (use_prepared) {
+        ret = ZBarcode_Encode_Prepared(item->prepared, symbol, (const unsigned char *) item->data,
+                (int) strlen(item->data));
+    } else {
+        ret = ZBarcode_Encode(symbol, (const unsigned char *) item->data, (int) strlen(item->data));
+    }
+    if (ret >= ZINT_ERROR) {
+        ZBarcode_Delete(symbol);
+        return 0;
+    }
+    hash = hash_bytes(hash, (const unsigned char *) symbol->internal->encoded_data, sizeof(symbol->internal->encoded_data));
+    hash = hash_bytes(hash, (const unsigned char *) &symbol->width, sizeof(symbol->width));
+    hash = hash_bytes(hash, (const unsigned char *) &symbol->rows, sizeof(symbol->rows));
+
+    ret = ZBarcode_Buffer(symbol, 0);
+    if (ret >= ZINT_ERROR) {
+        ZBarcode_Delete(symbol);
+        return 0;
+    }
+    hash = hash_bytes(hash, symbol->bitmap, symbol->bitmap_width * symbol->bitmap_height * 3);
+
+    symbol->output_options |= BARCODE_MEMORY_FILE;
+    strcpy(symbol->outfile, "mem.svg");
+    ret = ZBarcode_Print(symbol, 0);
+    if (ret >= ZINT_ERROR) {
+        ZBarcode_Delete(symbol);
+        return 0;
+    }
+    hash = hash_bytes(hash, symbol->memfile, symbol->memfile_size);
+
+    ZBarcode_Delete(symbol);
+
+    return hash ? hash : 1;
+}
+
+struct thread_result {
+    int offset;
+    int use_prepared;
+    int mismatches;
+};
+
+static void *thread_func(void *arg) {
+    struct thread_result *result = (struct thread_result *) arg;
+    int i, j;
+
+    for (j = 0; j < THREADS_ITERATIONS; j++) {
+        for (i = 0; i < items_size; i++) {
+            /* Stagger start so threads are encoding different symbologies at the same time */
+            const struct thread_item *item = &items[(i + result->offset) % items_size];
+            if (encode_item(item, result->use_prepared) != item->expected_hash) {
+                result->mismatches++;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* Set up items with single-threaded reference results, returning 0 on success, else the symbology with no data */
+static int setup_items(int debug) {
+    int symbology, i, j;
+
+    /* Single-threaded reference results */
+    items_size = 0;
+    for (symbology = 1; symbology <= BARCODE_RMQR; symbology++) {
+        struct thread_item *item = &items[items_size];
+        int found = 0;
+
+        if (!ZBarcode_ValidID(symbology)) continue;
+
+        item->symbology = symbology;
+        for (i = 0; i < (int) ARRAY_SIZE(special_data) && !found; i++) {
+            if (special_data[i].symbology == symbology) {
+                item->input_mode = special_data[i].input_mode;
+                item->data = special_data[i].data;
+                item->primary = special_data[i].primary;
+                found = (item->expected_hash = encode_item(item, 0)) != 0;
+            }
+        }
+        for (i = 0; i < (int) ARRAY_SIZE(candidate_data) && !found; i++) {
+            for (j = 0; j < (int) ARRAY_SIZE(candidate_primary) + 1 && !found; j++) {
+                item->input_mode = -1;
+                item->data = candidate_data[i];
+                item->primary = j ? candidate_primary[j - 1] : "";
+                found = (item->expected_hash = encode_item(item, 0)) != 0;
+            }
+        }
+        if (!found) {
+            return symbology;
+        }
+        if (debug & ZINT_DEBUG_PRINT) {
+            printf("%s: \"%s\", primary \"%s\", hash 0x%08X\n", testUtilBarcodeName(symbology), item->data,
+                    item->primary, item->expected_hash);
+        }
+        items_size++;
+    }
+
+    return 0;
+}
+
+/* Run THREADS_NUM threads over the items, placing each thread's mismatches with the reference results in `results`.
+   Returns 0 on success, else the pthread error */
+static int run_threads(const int use_prepared, struct thread_result results[THREADS_NUM]) {
+    int ret;
+    int k;
+    pthread_t threads[THREADS_NUM];
+
+    for (k = 0; k < THREADS_NUM; k++) {
+        results[k].offset = k * (items_size / THREADS_NUM);
+        results[k].use_prepared = use_prepared;
+        results[k].mismatches = 0;
+        if ((ret = pthread_create(&threads[k], NULL, thread_func, &results[k])) != 0) {
+            while (--k >= 0) {
+                (void) pthread_join(threads[k], NULL);
+            }
+            return ret;
+        }
+    }
+    for (k = 0; k < THREADS_NUM; k++) {
+        if ((ret = pthread_join(threads[k], NULL)) != 0) {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static void test_threads(int debug) {
+
+    testStart("");
+
+    int ret;
+    int k;
+    struct thread_result results[THREADS_NUM];
+
+    ret = setup_items(debug);
+    assert_zero(ret, "symbology %d (%s) no data found\n", ret, testUtilBarcodeName(ret));
+
+    ret = run_threads(0 /*use_prepared*/, results);
+    assert_zero(ret, "run_threads ret %d != 0\n", ret);
+    for (k = 0; k < THREADS_NUM; k++) {
+        assert_zero(results[k].mismatches, "k:%d mismatches %d != 0\n", k, results[k].mismatches);
+    }
+
+    testFinish();
+}
+
+/* Threads encoding concurrently from prepared encoders shared between them */
+static void test_threads_prepared(int debug) {
+
+    testStart("");
+
+    int ret;
+    int i, k;
+    struct thread_result results[THREADS_NUM];
+
+    ret = setup_items(debug);
+    assert_zero(ret, "symbology %d (%s) no data found\n", ret, testUtilBarcodeName(ret));
+
+    for (i = 0; i < items_size; i++) {
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        symbol->symbology = items[i].symbology;
+        if (items[i].input_mode != -1) {
+            symbol->input_mode = items[i].input_mode;
+        }
+        ret = ZBarcode_Prepare(symbol, &items[i].prepared);
+        assert_zero(ret, "i:%d ZBarcode_Prepare ret %d != 0 (%s)\n", i, ret, symbol->errtxt);
+        assert_nonnull(items[i].prepared, "i:%d prepared NULL\n", i);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    ret = run_threads(1 /*use_prepared*/, results);
+
+    for (i = 0; i < items_size; i++) {
+        ZBarcode_Prepared_Delete(items[i].prepared);
+        items[i].prepared = NULL;
+    }
+
+    assert_zero(ret, "run_threads ret %d != 0\n", ret);
+    for (k = 0; k < THREADS_NUM; k++) {
+        assert_zero(results[k].mismatches, "k:%d mismatches %d != 0\n", k, results[k].mismatches);
+    }
+
+    testFinish();
+}
+
+int main(int argc, char *argv[]) {
+
+    testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
+        { "test_threads", test_threads, 0, 0, 1 },
+        { "test_threads_prepared", test_threads_prepared, 0, 0, 1 },
+    };
+
+    testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
+
+    testReport();
+
+    return 0;
+}
@@ -83,7 +83,7 @@ static void test_pixel_plot(int index, int debug) {
     };
     int data_size = ARRAY_SIZE(data);
 
-    char *tif = "out.tif";
+    char tif[256];
 
     char data_buf[65536];
 
@@ -94,6 +94,8 @@ static void test_pixel_plot(int index, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(tif, i, "tif");
+
         strcpy(symbol->outfile, tif);
 
         symbol->bitmap_width = data[i].width;
@@ -179,11 +181,15 @@ static void test_print(int index, int generate, int debug) {
         /* 12*/ { BARCODE_HANXIN, UNICODE_MODE, -1, -1, -1, -1, 4, 84, 0, 2, "", "", "1", "", "../data/tif/hanxin_v84_l4_scale2.tif", "" },
         /* 13*/ { BARCODE_AZTEC, -1, -1, -1, -1, -1, -1, 32, 0, 0, "4BE055", "", "1", "", "../data/tif/aztec_v32_fg.tif", "" },
         /* 14*/ { BARCODE_DAFT, -1, -1, -1, -1, -1, -1, -1, 1, 0.5f, "", "", "F", "", "../data/tif/daft_scale0.5.tif", "" },
+        /* 15*/ { BARCODE_CODE128, -1, -1, TIFF_PACKBITS, -1, -1, -1, -1, 0, 0, "", "", "A", "", "../data/tif/code128_packbits.tif", "" },
+        /* 16*/ { BARCODE_MAXICODE, -1, -1, TIFF_CCITT_G4, -1, -1, -1, -1, 0, 0, "", "", "1", "", "../data/tif/maxicode_g4.tif", "Strip Count 2" },
+        /* 17*/ { BARCODE_CODE128, -1, -1, TIFF_CCITT_G4, -1, -1, -1, -1, 0, 0, "FFFFFF", "000000", "A", "", "../data/tif/code128_g4_blackiszero.tif", "" },
+        /* 18*/ { BARCODE_ULTRA, -1, -1, TIFF_PACKBITS | TIFF_CCITT_G4, -1, -1, -1, -1, 0, 0, "", "", "1234", "", "../data/tif/ultra_packbits.tif", "Not bilevel so G4 ignored" },
     };
     int data_size = ARRAY_SIZE(data);
 
     char *data_dir = "../data/tif";
-    char *tif = "out.tif";
+    char tif[256];
     char escaped[1024];
     int escaped_size = 1024;
     char *text;
@@ -199,6 +205,8 @@ static void test_print(int index, int generate, int debug) {
 
         if (index != -1 && i != index) continue;
 
+        testUtilOutFile(tif, i, "tif");
+
         struct zint_symbol* symbol = ZBarcode_Create();
         assert_nonnull(symbol, "Symbol not created\n");
 
@@ -268,11 +276,150 @@ static void test_print(int index, int generate, int debug) {
     testFinish();
 }
 
+/* Return the value of the single-valued SHORT or LONG tag `tag` of the IFD at `ifd`, or -1 if none */
+static long ifd_tag(const unsigned char *mem, unsigned int ifd, int tag) {
+    unsigned short entries, tag_tag, tag_type;
+    unsigned int offset;
+    memcpy(&entries, mem + ifd, 2);
+    for (int i = 0; i < entries; i++) {
+        const unsigned char *entry = mem + ifd + 2 + i * 12;
+        memcpy(&tag_tag, entry, 2);
+        if (tag_tag == tag) {
+            memcpy(&tag_type, entry + 2, 2);
+            if (tag_type == 3) {
+                memcpy(&tag_type, entry + 8, 2);
+                return tag_type;
+            }
+            memcpy(&offset, entry + 8, 4);
+            return offset;
+        }
+    }
+    return -1;
+}
+
+static void test_multi(int index, int debug) {
+
+    testStart("");
+
+    int have_tiffinfo = testUtilHaveTiffInfo();
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        char *fgcolour;
+        char *data;
+        int expected_compression;
+    };
+    /* Pages in order, each with its own options */
+    struct item data[] = {
+        /*  0*/ { BARCODE_CODE128, TIFF_CCITT_G4, "", "1Z999AA10123456784", 4 },
+        /*  1*/ { BARCODE_MAXICODE, TIFF_CCITT_G4, "", "1", 4 }, /* 2 strips */
+        /*  2*/ { BARCODE_QRCODE, TIFF_CCITT_G4, "112233", "SHIP-0001", 5 }, /* Palette so LZW */
+        /*  3*/ { BARCODE_ULTRA, TIFF_PACKBITS, "", "1234", 32773 },
+        /*  4*/ { BARCODE_CODE128, TIFF_CCITT_G4, "", "1Z999AA10123456785", 4 },
+    };
+    int data_size = ARRAY_SIZE(data);
+    struct zint_symbol *symbols[ARRAY_SIZE(data)];
+    char tif[256];
+    testUtilOutFile(tif, 0, "multi.tif");
+
+    (void)index;
+
+    for (int i = 0; i < data_size; i++) {
+        symbols[i] = ZBarcode_Create();
+        assert_nonnull(symbols[i], "i:%d Symbol not created\n", i);
+
+        int length = testUtilSetSymbol(symbols[i], data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (*data[i].fgcolour) {
+            strcpy(symbols[i]->fgcolour, data[i].fgcolour);
+        }
+
+        ret = ZBarcode_Encode(symbols[i], (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d %s ZBarcode_Encode ret %d != 0 %s\n", i, testUtilBarcodeName(data[i].symbology), ret, symbols[i]->errtxt);
+    }
+    symbols[0]->output_options |= BARCODE_MEMORY_FILE;
+
+    ret = ZBarcode_Print_TIF(symbols, data_size, 0);
+    assert_zero(ret, "ZBarcode_Print_TIF ret %d != 0 (%s)\n", ret, symbols[0]->errtxt);
+    assert_nonnull(symbols[0]->memfile, "memfile NULL\n");
+
+    /* Walk the IFD chain */
+    const unsigned char *mem = symbols[0]->memfile;
+    int mem_size = symbols[0]->memfile_size;
+    unsigned int ifd;
+    int pages = 0;
+    memcpy(&ifd, mem + 4, 4);
+    while (ifd) {
+        unsigned short entries;
+        assert_nonzero(pages < data_size, "pages %d >= %d\n", pages, data_size);
+        assert_zero(ifd & 1, "page %d IFD %u not on word boundary\n", pages, ifd);
+        assert_nonzero(ifd + 2 < (unsigned int) mem_size, "page %d IFD %u >= size %d\n", pages, ifd, mem_size);
+        memcpy(&entries, mem + ifd, 2);
+        assert_nonzero(ifd + 2 + entries * 12 + 4 <= (unsigned int) mem_size, "page %d IFD %u entries %d > size %d\n", pages, ifd, entries, mem_size);
+
+        assert_equal(ifd_tag(mem, ifd, 0x0100), symbols[pages]->bitmap_width, "page %d width %ld != %d\n", pages, ifd_tag(mem, ifd, 0x0100), symbols[pages]->bitmap_width);
+        assert_equal(ifd_tag(mem, ifd, 0x0101), symbols[pages]->bitmap_height, "page %d height %ld != %d\n", pages, ifd_tag(mem, ifd, 0x0101), symbols[pages]->bitmap_height);
+        assert_equal(ifd_tag(mem, ifd, 0x0103), data[pages].expected_compression, "page %d compression %ld != %d\n", pages, ifd_tag(mem, ifd, 0x0103), data[pages].expected_compression);
+
+        memcpy(&ifd, mem + ifd + 2 + entries * 12, 4);
+        pages++;
+    }
+    assert_equal(pages, data_size, "pages %d != %d\n", pages, data_size);
+
+    if (have_tiffinfo) {
+        FILE *fp = fopen(tif, "wb");
+        assert_nonnull(fp, "fopen(%s) failed\n", tif);
+        assert_equal((int) fwrite(mem, 1, mem_size, fp), mem_size, "fwrite(%s) failed\n", tif);
+        assert_zero(fclose(fp), "fclose(%s) failed\n", tif);
+        ret = testUtilVerifyTiffInfo(tif, debug);
+        assert_zero(ret, "tiffinfo %s ret %d != 0\n", tif, ret);
+        assert_zero(remove(tif), "remove(%s) != 0\n", tif);
+    }
+
+    /* A single page is the same as `ZBarcode_Print()` */
+    strcpy(symbols[1]->outfile, "mem.tif"); /* For `ZBarcode_Print()` */
+    symbols[1]->output_options |= BARCODE_MEMORY_FILE;
+    ret = ZBarcode_Print_TIF(symbols + 1, 1, 90);
+    assert_zero(ret, "ZBarcode_Print_TIF 1 ret %d != 0 (%s)\n", ret, symbols[1]->errtxt);
+    int multi_size = symbols[1]->memfile_size;
+    unsigned char *multi_mem = (unsigned char *) malloc(multi_size);
+    assert_nonnull(multi_mem, "malloc failed\n");
+    memcpy(multi_mem, symbols[1]->memfile, multi_size);
+    ret = ZBarcode_Print(symbols[1], 90);
+    assert_zero(ret, "ZBarcode_Print ret %d != 0 (%s)\n", ret, symbols[1]->errtxt);
+    assert_equal(symbols[1]->memfile_size, multi_size, "memfile_size %d != %d\n", symbols[1]->memfile_size, multi_size);
+    assert_zero(memcmp(symbols[1]->memfile, multi_mem, multi_size), "Single page differs from ZBarcode_Print()\n");
+    free(multi_mem);
+
+    /* Errors */
+    ret = ZBarcode_Print_TIF(symbols, 0, 0);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "count 0 ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+    ret = ZBarcode_Print_TIF(symbols, data_size, 45);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "rotate 45 ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+    ret = ZBarcode_Print_TIF(NULL, data_size, 0);
+    assert_equal(ret, ZINT_ERROR_INVALID_DATA, "NULL ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+
+    struct zint_symbol *last = symbols[data_size - 1];
+    symbols[data_size - 1] = NULL;
+    ret = ZBarcode_Print_TIF(symbols, data_size, 0);
+    assert_equal(ret, ZINT_ERROR_INVALID_DATA, "NULL symbol ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+    assert_zero(strcmp(symbols[0]->errtxt, "Error 716: Invalid symbol"), "errtxt %s != Error 716: Invalid symbol\n", symbols[0]->errtxt);
+    symbols[data_size - 1] = last;
+
+    for (int i = 0; i < data_size; i++) {
+        ZBarcode_Delete(symbols[i]);
+    }
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
         { "test_pixel_plot", test_pixel_plot, 1, 0, 1 },
         { "test_print", test_print, 1, 1, 1 },
+        { "test_multi", test_multi, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
@@ -136,7 +136,7 @@ static void test_upca_print(int index, int debug) {
         ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
         assert_equal(ret, data[i].ret, "i:%d ret %d != %d (%s)\n", i, ret, data[i].ret, symbol->errtxt);
 
-        strcpy(symbol->outfile, "out.gif");
+        testUtilOutFile(symbol->outfile, i, "gif");
         ret = ZBarcode_Print(symbol, 0);
         assert_zero(ret, "i:%d %s ZBarcode_Print %s ret %d != 0 (%s)\n", i, testUtilBarcodeName(data[i].symbology), symbol->outfile, ret, symbol->errtxt);
 
@@ -380,6 +380,10 @@ static void test_eanx_input(int index, int debug) {
         /*119*/ { BARCODE_EANX_CHK, "12345678901234567", ZINT_ERROR_TOO_LONG },
         /*120*/ { BARCODE_EANX_CHK, "123456789012345678", ZINT_ERROR_TOO_LONG },
         /*121*/ { BARCODE_EANX_CHK, "1234567890123456789", ZINT_ERROR_TOO_LONG },
+        /*122*/ { BARCODE_EANX, "123456+12+1", ZINT_ERROR_INVALID_DATA },
+        /*123*/ { BARCODE_EANX, "12345A", ZINT_ERROR_INVALID_DATA },
+        /*124*/ { BARCODE_EANX, "1+2+X", ZINT_ERROR_INVALID_DATA },
+        /*125*/ { BARCODE_EANX_CHK, "1234567890128+", 0 },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -468,6 +472,11 @@ static void test_isbn_input(int index, int debug) {
         /* 52*/ { "97912345678961+", ZINT_ERROR_TOO_LONG, -1 },
         /* 53*/ { "97912345678961+12345", ZINT_ERROR_TOO_LONG, -1 },
         /* 54*/ { "9791234567896+123456", ZINT_ERROR_TOO_LONG, -1 },
+        /* 55*/ { "12345X789X", ZINT_ERROR_INVALID_DATA, -1 },
+        /* 56*/ { "X23456789", ZINT_ERROR_INVALID_DATA, -1 },
+        /* 57*/ { "978123456789X", ZINT_ERROR_INVALID_DATA, -1 },
+        /* 58*/ { "10000007X", 0, 0 }, // X is correct check digit
+        /* 59*/ { "199900003X+1X", ZINT_ERROR_INVALID_DATA, -1 },
     };
     int data_size = ARRAY_SIZE(data);
 
@@ -544,9 +553,7 @@ static void test_vector_same(int index, int debug) {
         }
 
         for (int j = 0; j < vectors_size; j++) {
-            struct zint_symbol symbol_vector;
-            symbol_vector.vector = vectors[j];
-            vector_free(&symbol_vector);
+            testUtilVectorFree(vectors[j]);
         }
     }
 
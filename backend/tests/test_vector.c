@@ -30,6 +30,7 @@
 /* vim: set ts=4 sw=4 et : */
 
 #include "testcommon.h"
+#include <math.h>
 
 static struct zint_vector_rect *find_rect(struct zint_symbol *symbol, float x, float y, float height, float width) {
     struct zint_vector_rect *rect;
@@ -838,6 +839,513 @@ static void test_upcean_whitespace_width(int index, int debug) {
     testFinish();
 }
 
+/* Elements are in contiguous arrays of the given counts, linked in order */
+static void test_arrays(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        int option_2;
+        char *data;
+
+        int expected_rectangles;
+        int expected_hexagons;
+        int expected_strings;
+        int expected_circles;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_CODE128, -1, -1, "1234", -1, 0, 1, 0 },
+        /* 1*/ { BARCODE_UPCA, -1, -1, "12345678904+12345", -1, 0, 5, 0 },
+        /* 2*/ { BARCODE_DATAMATRIX, -1, 24, "1234567890", -1, 0, 0, 0 },
+        /* 3*/ { BARCODE_MAXICODE, -1, -1, "1234567890", 0, -1, 0, 6 },
+        /* 4*/ { BARCODE_DOTCODE, BARCODE_DOTTY_MODE, -1, "1234567890", 0, 0, 0, -1 },
+        /* 5*/ { BARCODE_ULTRA, -1, -1, "1234567890", -1, 0, 0, 0 },
+    };
+    int data_size = sizeof(data) / sizeof(struct item);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, data[i].option_2, -1, data[i].output_options, data[i].data, -1, debug);
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode(%d) ret %d != 0 %s\n", i, data[i].symbology, ret, symbol->errtxt);
+
+        ret = ZBarcode_Buffer_Vector(symbol, 0);
+        assert_zero(ret, "i:%d ZBarcode_Buffer_Vector(%d) ret %d != 0\n", i, data[i].symbology, ret);
+        assert_nonnull(symbol->vector, "i:%d ZBarcode_Buffer_Vector(%d) vector NULL\n", i, data[i].symbology);
+
+        struct zint_vector *vector = symbol->vector;
+        int cnt;
+
+        if (data[i].expected_rectangles != -1) {
+            assert_equal(vector->rectangles_count, data[i].expected_rectangles, "i:%d rectangles_count %d != %d\n", i, vector->rectangles_count, data[i].expected_rectangles);
+        } else {
+            assert_nonzero(vector->rectangles_count, "i:%d rectangles_count zero\n", i);
+        }
+        cnt = 0;
+        for (struct zint_vector_rect *rect = vector->rectangles; rect; rect = rect->next, cnt++) {
+            assert_equal(rect, vector->rectangles + cnt, "i:%d rectangles[%d] not contiguous\n", i, cnt);
+        }
+        assert_equal(cnt, vector->rectangles_count, "i:%d rectangles %d != count %d\n", i, cnt, vector->rectangles_count);
+
+        if (data[i].expected_hexagons != -1) {
+            assert_equal(vector->hexagons_count, data[i].expected_hexagons, "i:%d hexagons_count %d != %d\n", i, vector->hexagons_count, data[i].expected_hexagons);
+        } else {
+            assert_nonzero(vector->hexagons_count, "i:%d hexagons_count zero\n", i);
+        }
+        cnt = 0;
+        for (struct zint_vector_hexagon *hex = vector->hexagons; hex; hex = hex->next, cnt++) {
+            assert_equal(hex, vector->hexagons + cnt, "i:%d hexagons[%d] not contiguous\n", i, cnt);
+        }
+        assert_equal(cnt, vector->hexagons_count, "i:%d hexagons %d != count %d\n", i, cnt, vector->hexagons_count);
+
+        assert_equal(vector->strings_count, data[i].expected_strings, "i:%d strings_count %d != %d\n", i, vector->strings_count, data[i].expected_strings);
+        cnt = 0;
+        for (struct zint_vector_string *string = vector->strings; string; string = string->next, cnt++) {
+            assert_equal(string, vector->strings + cnt, "i:%d strings[%d] not contiguous\n", i, cnt);
+            assert_equal((int) ustrlen(string->text), string->length, "i:%d strings[%d] length %d != %d\n", i, cnt, (int) ustrlen(string->text), string->length);
+        }
+        assert_equal(cnt, vector->strings_count, "i:%d strings %d != count %d\n", i, cnt, vector->strings_count);
+
+        if (data[i].expected_circles != -1) {
+            assert_equal(vector->circles_count, data[i].expected_circles, "i:%d circles_count %d != %d\n", i, vector->circles_count, data[i].expected_circles);
+        } else {
+            assert_nonzero(vector->circles_count, "i:%d circles_count zero\n", i);
+        }
+        cnt = 0;
+        for (struct zint_vector_circle *circle = vector->circles; circle; circle = circle->next, cnt++) {
+            assert_equal(circle, vector->circles + cnt, "i:%d circles[%d] not contiguous\n", i, cnt);
+        }
+        assert_equal(cnt, vector->circles_count, "i:%d circles %d != count %d\n", i, cnt, vector->circles_count);
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_shared_shapes(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        int rotate_angle;
+        char *data;
+
+        float expected_hexagons_diameter;
+        float expected_circles_diameter;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_CODE128, -1, 0, 0, "1234", 0, 0 },
+        /* 1*/ { BARCODE_MAXICODE, -1, 0, 0, "1234567890", 2, 0 },
+        /* 2*/ { BARCODE_MAXICODE, -1, 2, 90, "1234567890", 4, 0 },
+        /* 3*/ { BARCODE_DOTCODE, -1, 0, 0, "1234567890", 0, 1.6f },
+        /* 4*/ { BARCODE_DOTCODE, -1, 1.5, 270, "1234567890", 0, 2.4f },
+        /* 5*/ { BARCODE_DATAMATRIX, BARCODE_DOTTY_MODE, 0, 0, "1234567890", 0, 1.6f },
+        /* 6*/ { BARCODE_QRCODE, BARCODE_DOTTY_MODE, 0, 180, "1234567890", 0, 1.6f },
+    };
+    int data_size = sizeof(data) / sizeof(struct item);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+        }
+
+        ret = ZBarcode_Encode(symbol, (unsigned char *) data[i].data, length);
+        assert_zero(ret, "i:%d ZBarcode_Encode(%d) ret %d != 0 %s\n", i, data[i].symbology, ret, symbol->errtxt);
+
+        ret = ZBarcode_Buffer_Vector(symbol, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Buffer_Vector(%d) ret %d != 0\n", i, data[i].symbology, ret);
+        assert_nonnull(symbol->vector, "i:%d ZBarcode_Buffer_Vector(%d) vector NULL\n", i, data[i].symbology);
+
+        struct zint_vector *vector = symbol->vector;
+
+        if (index != -1 && (debug & ZINT_DEBUG_TEST_PRINT)) {
+            printf("i:%d hexagons_diameter %.8g, circles_diameter %.8g\n", i, vector->hexagons_diameter, vector->circles_diameter);
+        }
+
+        assert_equal(vector->hexagons_diameter, data[i].expected_hexagons_diameter, "i:%d hexagons_diameter %.8g != %.8g\n", i, vector->hexagons_diameter, data[i].expected_hexagons_diameter);
+        for (struct zint_vector_hexagon *hex = vector->hexagons; hex && vector->hexagons_diameter; hex = hex->next) {
+            assert_equal(hex->diameter, vector->hexagons_diameter, "i:%d hex->diameter %.8g != %.8g\n", i, hex->diameter, vector->hexagons_diameter);
+            assert_equal(hex->rotation, vector->hexagons->rotation, "i:%d hex->rotation %d != %d\n", i, hex->rotation, vector->hexagons->rotation);
+        }
+
+        assert_equal(vector->circles_diameter, data[i].expected_circles_diameter, "i:%d circles_diameter %.8g != %.8g\n", i, vector->circles_diameter, data[i].expected_circles_diameter);
+        for (struct zint_vector_circle *circle = vector->circles; circle && vector->circles_diameter; circle = circle->next) {
+            assert_equal(circle->diameter, vector->circles_diameter, "i:%d circle->diameter %.8g != %.8g\n", i, circle->diameter, vector->circles_diameter);
+            assert_equal(circle->colour, vector->circles->colour, "i:%d circle->colour %d != %d\n", i, circle->colour, vector->circles->colour);
+        }
+
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+static void test_transform(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        int rotate_angle;
+        char *data;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_CODE128, -1, 0, 0, "1234" },
+        /* 1*/ { BARCODE_CODE128, BARCODE_BOX, 2.5f, 90, "1234" },
+        /* 2*/ { BARCODE_EANX, -1, 1, 180, "123456789012+12" },
+        /* 3*/ { BARCODE_QRCODE, -1, 3, 270, "1234567890" },
+        /* 4*/ { BARCODE_MAXICODE, -1, 0, 90, "1234567890" },
+        /* 5*/ { BARCODE_DOTCODE, -1, 1.5, 180, "1234567890" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        struct zint_symbol *symbol = ZBarcode_Create();
+        assert_nonnull(symbol, "Symbol not created\n");
+        struct zint_symbol *symbol2 = ZBarcode_Create();
+        assert_nonnull(symbol2, "Symbol2 not created\n");
+
+        int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        (void) testUtilSetSymbol(symbol2, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+        symbol2->output_options = (data[i].output_options == -1 ? 0 : data[i].output_options) | VECTOR_TRANSFORM;
+        if (data[i].scale) {
+            symbol->scale = data[i].scale;
+            symbol2->scale = data[i].scale;
+        }
+
+        ret = ZBarcode_Encode_and_Buffer_Vector(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer_Vector ret %d != 0 %s\n", i, ret, symbol->errtxt);
+        ret = ZBarcode_Encode_and_Buffer_Vector(symbol2, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer_Vector symbol2 ret %d != 0 %s\n", i, ret, symbol2->errtxt);
+
+        struct zint_vector *vector = symbol->vector;
+        struct zint_vector *vector2 = symbol2->vector;
+        const float *t = vector2->transform;
+        const float scale = fabsf(t[0]) + fabsf(t[1]);
+
+        assert_equal(vector->transform[0], 1.0f, "i:%d transform[0] %g != 1\n", i, vector->transform[0]);
+        assert_equal(vector->transform[4], 0.0f, "i:%d transform[4] %g != 0\n", i, vector->transform[4]);
+        assert_equal(vector2->width, vector->width, "i:%d width %g != %g\n", i, vector2->width, vector->width);
+        assert_equal(vector2->height, vector->height, "i:%d height %g != %g\n", i, vector2->height, vector->height);
+        assert_equal(vector2->rectangles_count, vector->rectangles_count, "i:%d rectangles_count %d != %d\n", i, vector2->rectangles_count, vector->rectangles_count);
+        assert_equal(vector2->hexagons_count, vector->hexagons_count, "i:%d hexagons_count %d != %d\n", i, vector2->hexagons_count, vector->hexagons_count);
+        assert_equal(vector2->circles_count, vector->circles_count, "i:%d circles_count %d != %d\n", i, vector2->circles_count, vector->circles_count);
+        assert_equal(vector2->strings_count, vector->strings_count, "i:%d strings_count %d != %d\n", i, vector2->strings_count, vector->strings_count);
+
+        /* Applying the transform gives the same elements */
+        struct zint_vector_rect *rect, *rect2;
+        for (rect = vector->rectangles, rect2 = vector2->rectangles; rect; rect = rect->next, rect2 = rect2->next) {
+            float x0 = t[0] * rect2->x + t[2] * rect2->y + t[4];
+            float y0 = t[1] * rect2->x + t[3] * rect2->y + t[5];
+            float x1 = t[0] * (rect2->x + rect2->width) + t[2] * (rect2->y + rect2->height) + t[4];
+            float y1 = t[1] * (rect2->x + rect2->width) + t[3] * (rect2->y + rect2->height) + t[5];
+            assert_nonzero(fabsf((x0 < x1 ? x0 : x1) - rect->x) < 0.01f, "i:%d rect x %g != %g\n", i, x0 < x1 ? x0 : x1, rect->x);
+            assert_nonzero(fabsf((y0 < y1 ? y0 : y1) - rect->y) < 0.01f, "i:%d rect y %g != %g\n", i, y0 < y1 ? y0 : y1, rect->y);
+            assert_nonzero(fabsf(fabsf(x1 - x0) - rect->width) < 0.01f, "i:%d rect width %g != %g\n", i, fabsf(x1 - x0), rect->width);
+            assert_nonzero(fabsf(fabsf(y1 - y0) - rect->height) < 0.01f, "i:%d rect height %g != %g\n", i, fabsf(y1 - y0), rect->height);
+        }
+        struct zint_vector_hexagon *hex, *hex2;
+        for (hex = vector->hexagons, hex2 = vector2->hexagons; hex; hex = hex->next, hex2 = hex2->next) {
+            float x = t[0] * hex2->x + t[2] * hex2->y + t[4];
+            float y = t[1] * hex2->x + t[3] * hex2->y + t[5];
+            assert_nonzero(fabsf(x - hex->x) < 0.01f && fabsf(y - hex->y) < 0.01f, "i:%d hex %g, %g != %g, %g\n", i, x, y, hex->x, hex->y);
+            assert_nonzero(fabsf(hex2->diameter * scale - hex->diameter) < 0.01f, "i:%d hex diameter %g != %g\n", i, hex2->diameter * scale, hex->diameter);
+            assert_zero(hex2->rotation, "i:%d hex2 rotation %d != 0\n", i, hex2->rotation);
+        }
+        struct zint_vector_circle *circle, *circle2;
+        for (circle = vector->circles, circle2 = vector2->circles; circle; circle = circle->next, circle2 = circle2->next) {
+            float x = t[0] * circle2->x + t[2] * circle2->y + t[4];
+            float y = t[1] * circle2->x + t[3] * circle2->y + t[5];
+            assert_nonzero(fabsf(x - circle->x) < 0.01f && fabsf(y - circle->y) < 0.01f, "i:%d circle %g, %g != %g, %g\n", i, x, y, circle->x, circle->y);
+            assert_nonzero(fabsf(circle2->diameter * scale - circle->diameter) < 0.01f, "i:%d circle diameter %g != %g\n", i, circle2->diameter * scale, circle->diameter);
+        }
+        struct zint_vector_string *string, *string2;
+        for (string = vector->strings, string2 = vector2->strings; string; string = string->next, string2 = string2->next) {
+            float x = t[0] * string2->x + t[2] * string2->y + t[4];
+            float y = t[1] * string2->x + t[3] * string2->y + t[5];
+            assert_nonzero(fabsf(x - string->x) < 0.01f && fabsf(y - string->y) < 0.01f, "i:%d string %g, %g != %g, %g\n", i, x, y, string->x, string->y);
+            assert_nonzero(fabsf(string2->fsize * scale - string->fsize) < 0.01f, "i:%d string fsize %g != %g\n", i, string2->fsize * scale, string->fsize);
+            assert_equal(string->rotation, data[i].rotate_angle, "i:%d string rotation %d != %d\n", i, string->rotation, data[i].rotate_angle);
+            assert_zero(string2->rotation, "i:%d string2 rotation %d != 0\n", i, string2->rotation);
+        }
+
+        /* SVG takes the transform as is */
+        strcpy(symbol2->outfile, "out.svg");
+        symbol2->output_options |= BARCODE_MEMORY_FILE;
+        ret = ZBarcode_Print(symbol2, data[i].rotate_angle);
+        assert_zero(ret, "i:%d ZBarcode_Print ret %d != 0 %s\n", i, ret, symbol2->errtxt);
+        assert_nonnull(symbol2->memfile, "i:%d memfile NULL\n", i);
+        symbol2->memfile[symbol2->memfile_size - 1] = '\0'; /* Overwrite final newline */
+        assert_nonnull(strstr((char *) symbol2->memfile, "<g transform=\"matrix("), "i:%d no transform in SVG\n", i);
+
+        ZBarcode_Delete(symbol2);
+        ZBarcode_Delete(symbol);
+    }
+
+    testFinish();
+}
+
+#define TEST_CALLBACKS_MAX 4096
+
+struct test_callbacks_ctx {
+    int begin_count;
+    int out_of_order; /* Element before `begin` */
+    float width, height;
+    int rects_calls;
+    int rect_count, hex_count, circle_count, string_count;
+    struct zint_vector_rect rects[TEST_CALLBACKS_MAX];
+    struct zint_vector_hexagon hexes[TEST_CALLBACKS_MAX];
+    struct zint_vector_circle circles[TEST_CALLBACKS_MAX];
+    struct zint_vector_string strings[16];
+    unsigned char texts[16][64];
+};
+
+static void test_cb_begin(void *context, float width, float height) {
+    struct test_callbacks_ctx *ctx = (struct test_callbacks_ctx *) context;
+    ctx->begin_count++;
+    ctx->width = width;
+    ctx->height = height;
+}
+
+static void test_cb_rect(void *context, const struct zint_vector_rect *rect) {
+    struct test_callbacks_ctx *ctx = (struct test_callbacks_ctx *) context;
+    ctx->out_of_order |= !ctx->begin_count;
+    if (ctx->rect_count < TEST_CALLBACKS_MAX) {
+        ctx->rects[ctx->rect_count] = *rect;
+    }
+    ctx->rect_count++;
+}
+
+static void test_cb_rects(void *context, const struct zint_vector_rect *rects, int count) {
+    struct test_callbacks_ctx *ctx = (struct test_callbacks_ctx *) context;
+    ctx->rects_calls++;
+    for (int i = 0; i < count; i++) {
+        test_cb_rect(context, rects + i);
+    }
+}
+
+static void test_cb_hexagon(void *context, const struct zint_vector_hexagon *hexagon) {
+    struct test_callbacks_ctx *ctx = (struct test_callbacks_ctx *) context;
+    ctx->out_of_order |= !ctx->begin_count;
+    if (ctx->hex_count < TEST_CALLBACKS_MAX) {
+        ctx->hexes[ctx->hex_count] = *hexagon;
+    }
+    ctx->hex_count++;
+}
+
+static void test_cb_circle(void *context, const struct zint_vector_circle *circle) {
+    struct test_callbacks_ctx *ctx = (struct test_callbacks_ctx *) context;
+    ctx->out_of_order |= !ctx->begin_count;
+    if (ctx->circle_count < TEST_CALLBACKS_MAX) {
+        ctx->circles[ctx->circle_count] = *circle;
+    }
+    ctx->circle_count++;
+}
+
+static void test_cb_string(void *context, const struct zint_vector_string *string) {
+    struct test_callbacks_ctx *ctx = (struct test_callbacks_ctx *) context;
+    ctx->out_of_order |= !ctx->begin_count;
+    if (ctx->string_count < 16 && string->length < 64) {
+        ctx->strings[ctx->string_count] = *string;
+        memcpy(ctx->texts[ctx->string_count], string->text, string->length + 1); /* Only valid for the call */
+        ctx->strings[ctx->string_count].text = ctx->texts[ctx->string_count];
+    }
+    ctx->string_count++;
+}
+
+static void test_render_callbacks(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct item {
+        int symbology;
+        int output_options;
+        float scale;
+        int rotate_angle;
+        char *data;
+        int exact_rects; /* No rectangles merged vertically by `ZBarcode_Buffer_Vector()` */
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%2d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /* 0*/ { BARCODE_CODE128, -1, 0, 0, "1234", 1 },
+        /* 1*/ { BARCODE_CODE128, BARCODE_BOX, 2.5f, 90, "1234", 1 },
+        /* 2*/ { BARCODE_EANX, -1, 1, 180, "123456789012+12", 1 },
+        /* 3*/ { BARCODE_UPCE, -1, 0, 270, "1234567", 1 },
+        /* 4*/ { BARCODE_QRCODE, -1, 3, 270, "1234567890", 0 },
+        /* 5*/ { BARCODE_MAXICODE, -1, 0, 90, "1234567890", 1 },
+        /* 6*/ { BARCODE_DOTCODE, BARCODE_DOTTY_MODE, 1.5, 180, "1234567890", 1 },
+        /* 7*/ { BARCODE_ULTRA, -1, 0, 0, "1234567890", 0 },
+        /* 8*/ { BARCODE_PDF417, BARCODE_BIND, 0, 90, "1234567890", 0 },
+        /* 9*/ { BARCODE_DATAMATRIX, -1, 0, 0, "1234567890123456789012345678901234567890", 0 },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    struct test_callbacks_ctx *ctx = (struct test_callbacks_ctx *) malloc(sizeof(struct test_callbacks_ctx));
+    assert_nonnull(ctx, "ctx malloc failed\n");
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+
+        for (int batch = 0; batch < 2; batch++) {
+            struct zint_symbol *symbol = ZBarcode_Create();
+            assert_nonnull(symbol, "Symbol not created\n");
+            struct zint_symbol *symbol2 = ZBarcode_Create();
+            assert_nonnull(symbol2, "Symbol2 not created\n");
+
+            int length = testUtilSetSymbol(symbol, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+            (void) testUtilSetSymbol(symbol2, data[i].symbology, -1 /*input_mode*/, -1 /*eci*/, -1 /*option_1*/, -1, -1, data[i].output_options, data[i].data, -1, debug);
+            if (data[i].scale) {
+                symbol->scale = data[i].scale;
+                symbol2->scale = data[i].scale;
+            }
+
+            ret = ZBarcode_Encode_and_Buffer_Vector(symbol, (unsigned char *) data[i].data, length, data[i].rotate_angle);
+            assert_zero(ret, "i:%d ZBarcode_Encode_and_Buffer_Vector ret %d != 0 %s\n", i, ret, symbol->errtxt);
+
+            ret = ZBarcode_Encode(symbol2, (unsigned char *) data[i].data, length);
+            assert_zero(ret, "i:%d ZBarcode_Encode ret %d != 0 %s\n", i, ret, symbol2->errtxt);
+
+            struct zint_render_callbacks callbacks = {
+                ctx, test_cb_begin, test_cb_rect, batch ? test_cb_rects : NULL, test_cb_hexagon, test_cb_circle,
+                test_cb_string
+            };
+            memset(ctx, 0, sizeof(struct test_callbacks_ctx));
+            ret = ZBarcode_Render_Callbacks(symbol2, data[i].rotate_angle, &callbacks);
+            assert_zero(ret, "i:%d ZBarcode_Render_Callbacks ret %d != 0 %s\n", i, ret, symbol2->errtxt);
+            assert_null(symbol2->vector, "i:%d symbol2->vector not NULL\n", i);
+
+            struct zint_vector *vector = symbol->vector;
+
+            assert_equal(ctx->begin_count, 1, "i:%d begin_count %d != 1\n", i, ctx->begin_count);
+            assert_zero(ctx->out_of_order, "i:%d element before begin\n", i);
+            assert_equal(ctx->width, vector->width, "i:%d width %g != %g\n", i, ctx->width, vector->width);
+            assert_equal(ctx->height, vector->height, "i:%d height %g != %g\n", i, ctx->height, vector->height);
+            assert_equal(ctx->hex_count, vector->hexagons_count, "i:%d hex_count %d != %d\n", i, ctx->hex_count, vector->hexagons_count);
+            assert_equal(ctx->circle_count, vector->circles_count, "i:%d circle_count %d != %d\n", i, ctx->circle_count, vector->circles_count);
+            assert_equal(ctx->string_count, vector->strings_count, "i:%d string_count %d != %d\n", i, ctx->string_count, vector->strings_count);
+            assert_nonzero(ctx->rect_count <= TEST_CALLBACKS_MAX, "i:%d rect_count %d > %d\n", i, ctx->rect_count, TEST_CALLBACKS_MAX);
+            if (batch) {
+                assert_nonzero(ctx->rects_calls >= (ctx->rect_count + 63) / 64, "i:%d rects_calls %d < %d\n", i, ctx->rects_calls, (ctx->rect_count + 63) / 64);
+            }
+
+            /* Rectangles are the same, though only merged vertically by `ZBarcode_Buffer_Vector()` */
+            float area = 0.0f, area2 = 0.0f;
+            struct zint_vector_rect *rect;
+            int j;
+            for (rect = vector->rectangles; rect; rect = rect->next) {
+                area += rect->width * rect->height;
+            }
+            for (j = 0; j < ctx->rect_count; j++) {
+                area2 += ctx->rects[j].width * ctx->rects[j].height;
+                assert_null(ctx->rects[j].next, "i:%d rect %d next not NULL\n", i, j);
+            }
+            assert_nonzero(fabsf(area - area2) < 0.01f * (area > 1.0f ? area : 1.0f), "i:%d area %g != %g\n", i, area2, area);
+            if (data[i].exact_rects) {
+                assert_equal(ctx->rect_count, vector->rectangles_count, "i:%d rect_count %d != %d\n", i, ctx->rect_count, vector->rectangles_count);
+                for (rect = vector->rectangles, j = 0; rect; rect = rect->next, j++) {
+                    assert_nonzero(rect->x == ctx->rects[j].x && rect->y == ctx->rects[j].y && rect->width == ctx->rects[j].width && rect->height == ctx->rects[j].height && rect->colour == ctx->rects[j].colour,
+                                "i:%d rect %d (%g, %g, %g, %g, %d) != (%g, %g, %g, %g, %d)\n", i, j, ctx->rects[j].x, ctx->rects[j].y, ctx->rects[j].width, ctx->rects[j].height, ctx->rects[j].colour, rect->x, rect->y, rect->width, rect->height, rect->colour);
+                }
+            } else {
+                assert_nonzero(ctx->rect_count >= vector->rectangles_count, "i:%d rect_count %d < %d\n", i, ctx->rect_count, vector->rectangles_count);
+            }
+
+            /* Other elements are identical */
+            struct zint_vector_hexagon *hex;
+            for (hex = vector->hexagons, j = 0; hex; hex = hex->next, j++) {
+                assert_nonzero(hex->x == ctx->hexes[j].x && hex->y == ctx->hexes[j].y && hex->diameter == ctx->hexes[j].diameter && hex->rotation == ctx->hexes[j].rotation,
+                            "i:%d hex %d (%g, %g, %g, %d) != (%g, %g, %g, %d)\n", i, j, ctx->hexes[j].x, ctx->hexes[j].y, ctx->hexes[j].diameter, ctx->hexes[j].rotation, hex->x, hex->y, hex->diameter, hex->rotation);
+            }
+            struct zint_vector_circle *circle;
+            for (circle = vector->circles, j = 0; circle; circle = circle->next, j++) {
+                assert_nonzero(circle->x == ctx->circles[j].x && circle->y == ctx->circles[j].y && circle->diameter == ctx->circles[j].diameter && circle->colour == ctx->circles[j].colour,
+                            "i:%d circle %d (%g, %g, %g, %d) != (%g, %g, %g, %d)\n", i, j, ctx->circles[j].x, ctx->circles[j].y, ctx->circles[j].diameter, ctx->circles[j].colour, circle->x, circle->y, circle->diameter, circle->colour);
+            }
+            struct zint_vector_string *string;
+            for (string = vector->strings, j = 0; string; string = string->next, j++) {
+                assert_nonzero(string->x == ctx->strings[j].x && string->y == ctx->strings[j].y && string->fsize == ctx->strings[j].fsize && string->width == ctx->strings[j].width
+                            && string->rotation == ctx->strings[j].rotation && string->halign == ctx->strings[j].halign,
+                            "i:%d string %d (%g, %g) != (%g, %g)\n", i, j, ctx->strings[j].x, ctx->strings[j].y, string->x, string->y);
+                assert_zero(strcmp((char *) string->text, (char *) ctx->strings[j].text), "i:%d string %d text \"%s\" != \"%s\"\n", i, j, ctx->strings[j].text, string->text);
+            }
+
+            ZBarcode_Delete(symbol2);
+            ZBarcode_Delete(symbol);
+        }
+    }
+
+    free(ctx);
+
+    testFinish();
+}
+
+static void test_render_callbacks_args(int index, int debug) {
+
+    testStart("");
+
+    int ret;
+    struct zint_render_callbacks callbacks = { NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+
+    (void) index; (void) debug;
+
+    ret = ZBarcode_Render_Callbacks(NULL, 0, &callbacks);
+    assert_equal(ret, ZINT_ERROR_INVALID_DATA, "ZBarcode_Render_Callbacks(NULL) ret %d != ZINT_ERROR_INVALID_DATA\n", ret);
+
+    struct zint_symbol *symbol = ZBarcode_Create();
+    assert_nonnull(symbol, "Symbol not created\n");
+
+    ret = ZBarcode_Encode(symbol, (unsigned char *) "1234", 0);
+    assert_zero(ret, "ZBarcode_Encode ret %d != 0 %s\n", ret, symbol->errtxt);
+
+    ret = ZBarcode_Render_Callbacks(symbol, 0, NULL);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Render_Callbacks(NULL callbacks) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+    assert_zero(strcmp(symbol->errtxt, "Error 738: Invalid render callbacks argument"), "errtxt \"%s\"\n", symbol->errtxt);
+
+    ret = ZBarcode_Render_Callbacks(symbol, 45, &callbacks);
+    assert_equal(ret, ZINT_ERROR_INVALID_OPTION, "ZBarcode_Render_Callbacks(45) ret %d != ZINT_ERROR_INVALID_OPTION\n", ret);
+
+    /* All callbacks NULL is fine */
+    ret = ZBarcode_Render_Callbacks(symbol, 0, &callbacks);
+    assert_zero(ret, "ZBarcode_Render_Callbacks ret %d != 0 %s\n", ret, symbol->errtxt);
+    assert_null(symbol->vector, "symbol->vector not NULL\n");
+
+    ZBarcode_Delete(symbol);
+
+    testFinish();
+}
+
 int main(int argc, char *argv[]) {
 
     testFunction funcs[] = { /* name, func, has_index, has_generate, has_debug */
@@ -849,6 +1357,11 @@ int main(int argc, char *argv[]) {
         { "test_output_options", test_output_options, 1, 0, 1 },
         { "test_noncomposite_string_x", test_noncomposite_string_x, 1, 0, 1 },
         { "test_upcean_whitespace_width", test_upcean_whitespace_width, 1, 0, 1 },
+        { "test_arrays", test_arrays, 1, 0, 1 },
+        { "test_shared_shapes", test_shared_shapes, 1, 0, 1 },
+        { "test_transform", test_transform, 1, 0, 1 },
+        { "test_render_callbacks", test_render_callbacks, 1, 0, 1 },
+        { "test_render_callbacks_args", test_render_callbacks_args, 1, 0, 1 },
     };
 
     testRun(argc, argv, funcs, ARRAY_SIZE(funcs));
@@ -52,6 +52,15 @@ int assertionFailed = 0;
 int assertionNum = 0;
 static const char *testName = NULL;
 static const char *testFunc = NULL;
+static const char *testProg = ""; /* Base name of the test executable, see `testUtilOutFile()` */
+
+#ifdef ZINT_TEST_ALLOCS
+/* Build mode where every test counts library allocations, failing if any not freed */
+static struct testAllocStats testAllocs;
+static void testAllocsBegin(void);
+static int testAllocsCheck(void);
+#undef ZBarcode_Create
+#endif
 
 void testStartReal(const char *func, const char *name) {
     tests++;
@@ -60,9 +69,17 @@ void testStartReal(const char *func, const char *name) {
     assertionFailed = 0;
     assertionNum = 0;
     printf("_____%d: %s: %s...\n", tests, func, name);
+#ifdef ZINT_TEST_ALLOCS
+    testAllocsBegin();
+#endif
 }
 
 void testEnd(int result) {
+#ifdef ZINT_TEST_ALLOCS
+    if (testAllocsCheck()) {
+        result = 1;
+    }
+#endif
     if (testName && testName[0]) {
         printf(".....%d: %s: %s ", tests, testFunc, testName);
     } else {
@@ -77,6 +94,9 @@ void testEnd(int result) {
 }
 
 void testFinish(void) {
+#ifdef ZINT_TEST_ALLOCS
+    (void) testAllocsCheck();
+#endif
     if (testName && testName[0]) {
         printf(".....%d: %s: %s ", tests, testFunc, testName);
     } else {
@@ -91,6 +111,9 @@ void testFinish(void) {
 }
 
 void testSkip(const char *msg) {
+#ifdef ZINT_TEST_ALLOCS
+    (void) testAllocsCheck();
+#endif
     skipped++;
     if (testName && testName[0]) {
         printf(".....%d: %s: %s ", tests, testFunc, testName);
@@ -105,6 +128,184 @@ void testSkip(const char *msg) {
     }
 }
 
+/* Sizes of counted blocks by pointer (open addressing), rather than a header before each block, so that blocks
+   allocated or freed by other allocators (e.g. when a test sets its own) are tolerated */
+#define TEST_ALLOC_TABLE_SIZE   65536 /* Power of 2 */
+
+static struct test_alloc_entry {
+    void *ptr;
+    size_t size;
+} test_alloc_table[TEST_ALLOC_TABLE_SIZE];
+static int test_alloc_table_count = 0;
+
+static unsigned int test_alloc_hash(const void *ptr) {
+    return (unsigned int) (((size_t) ptr >> 4) * 2654435761U) & (TEST_ALLOC_TABLE_SIZE - 1);
+}
+
+/* Record block, returning size of any stale entry for the same pointer (freed elsewhere) plus 1, else 0 */
+static size_t test_alloc_add(void *ptr, size_t size) {
+    unsigned int i = test_alloc_hash(ptr);
+
+    while (test_alloc_table[i].ptr) {
+        if (test_alloc_table[i].ptr == ptr) {
+            const size_t stale = test_alloc_table[i].size + 1;
+            test_alloc_table[i].size = size;
+            return stale;
+        }
+        i = (i + 1) & (TEST_ALLOC_TABLE_SIZE - 1);
+    }
+    if (test_alloc_table_count < TEST_ALLOC_TABLE_SIZE * 3 / 4) {
+        test_alloc_table[i].ptr = ptr;
+        test_alloc_table[i].size = size;
+        test_alloc_table_count++;
+    }
+    return 0;
+}
+
+/* Remove block, returning its size plus 1, or 0 if not counted */
+static size_t test_alloc_remove(const void *ptr) {
+    unsigned int i = test_alloc_hash(ptr);
+    size_t size;
+
+    while (test_alloc_table[i].ptr != ptr) {
+        if (!test_alloc_table[i].ptr) {
+            return 0;
+        }
+        i = (i + 1) & (TEST_ALLOC_TABLE_SIZE - 1);
+    }
+    size = test_alloc_table[i].size + 1;
+    test_alloc_table_count--;
+    /* Backward shift deletion, moving up any following entries whose probe sequence passes through `i` */
+    for (;;) {
+        unsigned int j = i, home;
+        test_alloc_table[i].ptr = NULL;
+        do {
+            j = (j + 1) & (TEST_ALLOC_TABLE_SIZE - 1);
+            if (!test_alloc_table[j].ptr) {
+                return size;
+            }
+            home = test_alloc_hash(test_alloc_table[j].ptr);
+        } while (i <= j ? i < home && home <= j : i < home || home <= j);
+        test_alloc_table[i] = test_alloc_table[j];
+        i = j;
+    }
+}
+
+static void test_alloc_count(struct testAllocStats *stats, void *ptr, size_t size) {
+    const size_t stale = test_alloc_add(ptr, size);
+
+    if (stale) {
+        stats->outstanding--;
+        stats->current -= (long) (stale - 1);
+    }
+    stats->outstanding++;
+    stats->bytes += size;
+    stats->current += (long) size;
+    if (stats->current > stats->peak) {
+        stats->peak = stats->current;
+    }
+}
+
+static void *test_alloc_malloc(void *context, size_t size) {
+    struct testAllocStats *stats = (struct testAllocStats *) context;
+    void *ptr = malloc(size);
+
+    if (ptr) {
+        stats->allocs++;
+        test_alloc_count(stats, ptr, size);
+    }
+    return ptr;
+}
+
+static void *test_alloc_realloc(void *context, void *ptr, size_t size) {
+    struct testAllocStats *stats = (struct testAllocStats *) context;
+    void *new_ptr;
+    size_t old_size;
+
+    if (!ptr) {
+        return test_alloc_malloc(context, size);
+    }
+    old_size = test_alloc_remove(ptr);
+    if (!(new_ptr = realloc(ptr, size))) {
+        if (old_size) {
+            (void) test_alloc_add(ptr, old_size - 1);
+        }
+        return NULL;
+    }
+    stats->reallocs++;
+    if (old_size) {
+        stats->outstanding--;
+        stats->current -= (long) (old_size - 1);
+    }
+    test_alloc_count(stats, new_ptr, size);
+    return new_ptr;
+}
+
+static void test_alloc_free(void *context, void *ptr) {
+    struct testAllocStats *stats = (struct testAllocStats *) context;
+    size_t size;
+
+    if (!ptr) {
+        return;
+    }
+    if ((size = test_alloc_remove(ptr))) {
+        stats->frees++;
+        stats->outstanding--;
+        stats->current -= (long) (size - 1);
+    }
+    free(ptr);
+}
+
+/* Create a symbol whose allocations (including of the symbol itself) are counted in `stats`, which is zeroed.
+   Returns NULL on failure */
+struct zint_symbol *testAllocCreate(struct testAllocStats *stats) {
+    struct zint_allocator allocator;
+
+    memset(stats, 0, sizeof(*stats));
+    allocator.malloc_fn = test_alloc_malloc;
+    allocator.realloc_fn = test_alloc_realloc;
+    allocator.free_fn = test_alloc_free;
+    allocator.context = stats;
+    return ZBarcode_Create_Allocator(&allocator);
+}
+
+/* Zero the counts of `stats`, keeping `outstanding` and `current`, with `start` and `peak` set to `current` */
+void testAllocReset(struct testAllocStats *stats) {
+    stats->allocs = stats->reallocs = stats->frees = 0;
+    stats->bytes = 0;
+    stats->start = stats->peak = stats->current;
+}
+
+#ifdef ZINT_TEST_ALLOCS
+/* Start counting for a new test */
+static void testAllocsBegin(void) {
+    memset(test_alloc_table, 0, sizeof(test_alloc_table));
+    test_alloc_table_count = 0;
+    memset(&testAllocs, 0, sizeof(testAllocs));
+}
+
+/* `ZBarcode_Create()` as called by tests, counting the symbol's allocations for the test */
+struct zint_symbol *testAllocCreateCounted(void) {
+    struct zint_allocator allocator;
+
+    allocator.malloc_fn = test_alloc_malloc;
+    allocator.realloc_fn = test_alloc_realloc;
+    allocator.free_fn = test_alloc_free;
+    allocator.context = &testAllocs;
+    return ZBarcode_Create_Allocator(&allocator);
+}
+
+/* Fail the test if there are blocks not freed, returning 1 if so */
+static int testAllocsCheck(void) {
+    if (testAllocs.outstanding > 0 && !assertionFailed) {
+        printf("%s: %ld blocks (%ld bytes) not freed\n", testFunc, testAllocs.outstanding, testAllocs.current);
+        assertionFailed++;
+        return 1;
+    }
+    return 0;
+}
+#endif
+
 void testReport() {
     if (failed && skipped) {
         printf("Total %d tests, %d skipped, %d fails.\n", tests, skipped, failed);
@@ -142,6 +343,12 @@ void testRun(int argc, char *argv[], testFunction funcs[], int funcs_size) {
     typedef void (*func_index_generate)(int index, int generate);
     typedef void (*func_index_generate_debug)(int index, int generate, int debug);
 
+    if (argc > 0 && argv[0]) {
+        const char *slash = strrchr(argv[0], '/');
+        const char *backslash = strrchr(slash ? slash : argv[0], '\\');
+        testProg = backslash ? backslash + 1 : slash ? slash + 1 : argv[0];
+    }
+
     while ((opt = getopt(argc, argv, "d:f:gi:")) != -1) {
         switch (opt) {
             case 'd':
@@ -439,6 +646,8 @@ const char *testUtilErrorName(int error_number) {
         { "ZINT_ERROR_ENCODING_PROBLEM", ZINT_ERROR_ENCODING_PROBLEM, 9 },
         { "ZINT_ERROR_FILE_ACCESS", ZINT_ERROR_FILE_ACCESS, 10 },
         { "ZINT_ERROR_MEMORY", ZINT_ERROR_MEMORY, 11 },
+        { "ZINT_ERROR_FILE_WRITE", ZINT_ERROR_FILE_WRITE, 12 },
+        { "ZINT_ERROR_CANCELLED", ZINT_ERROR_CANCELLED, 13 },
     };
     static const int data_size = sizeof(data) / sizeof(struct item);
 
@@ -463,6 +672,10 @@ const char *testUtilInputModeName(int input_mode) {
     static const struct item data[] = {
         { "ESCAPE_MODE", ESCAPE_MODE, 8 },
         { "GS1PARENS_MODE", GS1PARENS_MODE, 16 },
+        { "MINIMAL_MODE", MINIMAL_MODE, 32 },
+        { "GS1NOCHECK_MODE", GS1NOCHECK_MODE, 64 },
+        { "FAST_MODE", FAST_MODE, 128 },
+        { "MULTI_ECI_MODE", MULTI_ECI_MODE, 256 },
     };
     static const int data_size = ARRAY_SIZE(data);
     int set, i;
@@ -560,6 +773,24 @@ const char *testUtilOutputOptionsName(int output_options) {
         { "BARCODE_DOTTY_MODE", BARCODE_DOTTY_MODE, 256 },
         { "GS1_GS_SEPARATOR", GS1_GS_SEPARATOR, 512 },
         { "OUT_BUFFER_INTERMEDIATE", OUT_BUFFER_INTERMEDIATE, 1024 },
+        { "BARCODE_MEMORY_FILE", BARCODE_MEMORY_FILE, 2048 },
+        { "BARCODE_WRITE_FUNC", BARCODE_WRITE_FUNC, 4096 },
+        { "OUT_BUFFER_1BPP", OUT_BUFFER_1BPP, 8192 },
+        { "BARCODE_FAST_COMPRESS", BARCODE_FAST_COMPRESS, 16384 },
+        { "TIFF_PACKBITS", TIFF_PACKBITS, 32768 },
+        { "TIFF_CCITT_G4", TIFF_CCITT_G4, 65536 },
+        { "BMP_RLE8", BMP_RLE8, 131072 },
+        { "SVG_COMPACT", SVG_COMPACT, 262144 },
+        { "EPS_COMPACT", EPS_COMPACT, 524288 },
+        { "EMF_COMPACT", EMF_COMPACT, 1048576 },
+        { "BARCODE_ANTIALIAS", BARCODE_ANTIALIAS, 2097152 },
+        { "OUT_BUFFER_RGBA", OUT_BUFFER_RGBA, 4194304 },
+        { "BARCODE_NO_HRT", BARCODE_NO_HRT, 8388608 },
+        { "VECTOR_TRANSFORM", VECTOR_TRANSFORM, 16777216 },
+        { "PNG_PARALLEL", PNG_PARALLEL, 33554432 },
+        { "RASTER_PARALLEL", RASTER_PARALLEL, 67108864 },
+        { "OUT_FILE_MMAP", OUT_FILE_MMAP, 134217728 },
+        { "SVG_GZIP", SVG_GZIP, 268435456 },
     };
     static int const data_size = ARRAY_SIZE(data);
     int set = 0;
@@ -690,6 +921,14 @@ void testUtilStrCpyRepeat(char *buffer, char *repeat, int size) {
     buffer[size] = '\0';
 }
 
+/* Shallow copy of `src` for `testUtilSymbolCmp()` once `src` is deleted, its modules copied into `dst_internal` */
+void testUtilSymbolCopy(struct zint_symbol *dst, struct zint_internal *dst_internal, const struct zint_symbol *src) {
+    memcpy(dst, src, sizeof(*dst));
+    memset(dst_internal, 0, sizeof(*dst_internal));
+    memcpy(dst_internal->encoded_data, src->internal->encoded_data, sizeof(dst_internal->encoded_data));
+    dst->internal = dst_internal;
+}
+
 int testUtilSymbolCmp(const struct zint_symbol *a, const struct zint_symbol *b) {
     if (a->symbology != b->symbology) {
         return 1;
@@ -745,6 +984,12 @@ struct zint_vector *testUtilVectorCpy(const struct zint_vector *in) {
     out->strings = NULL;
     out->circles = NULL;
     out->hexagons = NULL;
+    out->rectangles_count = in->rectangles_count;
+    out->hexagons_count = in->hexagons_count;
+    out->strings_count = in->strings_count;
+    out->circles_count = in->circles_count;
+    out->hexagons_diameter = in->hexagons_diameter;
+    out->circles_diameter = in->circles_diameter;
 
     struct zint_vector_rect *rect;
     struct zint_vector_string *string;
@@ -810,6 +1055,33 @@ struct zint_vector *testUtilVectorCpy(const struct zint_vector *in) {
     return out;
 }
 
+/* Free a copy made by `testUtilVectorCpy()` (elements allocated individually, unlike `vector_free()`) */
+void testUtilVectorFree(struct zint_vector *vector) {
+    struct zint_vector_rect *rect, *r;
+    struct zint_vector_string *string, *s;
+    struct zint_vector_circle *circle, *c;
+    struct zint_vector_hexagon *hexagon, *h;
+
+    for (rect = vector->rectangles; rect; rect = r) {
+        r = rect->next;
+        free(rect);
+    }
+    for (string = vector->strings; string; string = s) {
+        s = string->next;
+        free(string->text);
+        free(string);
+    }
+    for (circle = vector->circles; circle; circle = c) {
+        c = circle->next;
+        free(circle);
+    }
+    for (hexagon = vector->hexagons; hexagon; hexagon = h) {
+        h = hexagon->next;
+        free(hexagon);
+    }
+    free(vector);
+}
+
 int testUtilVectorCmp(const struct zint_vector *a, const struct zint_vector *b) {
     struct zint_vector_rect *arect;
     struct zint_vector_string *astring;
@@ -1230,6 +1502,28 @@ int testUtilExists(char *filename) {
     return 1;
 }
 
+/* Put in `buffer` (at least 256 bytes) an output filename unique to the test executable, function and index `i`,
+   e.g. "test_png_print.3.png" for `test_print()` of test_png, so that tests run in parallel (`ctest -j`) don't
+   write the same file. `ext` is appended after a dot unless NULL or empty */
+char *testUtilOutFile(char *buffer, const int i, const char *ext) {
+    const char *prog = strncmp(testProg, "test_", 5) == 0 ? testProg + 5 : testProg;
+    const char *func = testFunc ? testFunc : "";
+    int prog_len = (int) strlen(prog);
+
+    if (strncmp(func, "test_", 5) == 0) {
+        func += 5;
+    }
+    if (prog_len > 4 && strcmp(prog + prog_len - 4, ".exe") == 0) {
+        prog_len -= 4;
+    }
+    if (ext && *ext) {
+        sprintf(buffer, "test_%.*s_%.80s.%d.%.16s", prog_len > 80 ? 80 : prog_len, prog, func, i, ext);
+    } else {
+        sprintf(buffer, "test_%.*s_%.80s.%d", prog_len > 80 ? 80 : prog_len, prog, func, i);
+    }
+    return buffer;
+}
+
 int testUtilCmpPngs(char *png1, char *png2) {
     int ret = -1;
 #ifdef NO_PNG
@@ -1945,6 +2239,12 @@ static const char *testUtilBwippName(int index, const struct zint_symbol *symbol
             return NULL;
         }
     }
+    if (symbol->input_mode & MINIMAL_MODE) { /* Minimal encodation differs from BWIPP's Annex E/P based modes */
+        if (debug & ZINT_DEBUG_TEST_PRINT) {
+            printf("i:%d %s not BWIPP compatible, minimal encodation not supported\n", index, testUtilBarcodeName(symbology));
+        }
+        return NULL;
+    }
 
     if (linear_row_height) {
         *linear_row_height = data[symbology].linear_row_height;
@@ -2716,3 +3016,176 @@ int testUtilBwippCmpRow(const struct zint_symbol *symbol, int row, char *msg, co
 
     return 0;
 }
+
+/* Writes benchmark results to `filename` ("-" for stdout) as CSV with a header line or as JSON, an array with
+   one result object per line. Returns 0 on success */
+int testBenchWrite(const char *filename, int format, const struct testBenchResult *results, int count) {
+    FILE *fp;
+    int i;
+
+    if (strcmp(filename, "-") == 0) {
+        fp = stdout;
+    } else if (!(fp = fopen(filename, "w"))) {
+        fprintf(stderr, "testBenchWrite: failed to open \"%s\" for writing\n", filename);
+        return -1;
+    }
+
+    if (format == TEST_BENCH_JSON) {
+        fputs("[\n", fp);
+        for (i = 0; i < count; i++) {
+            fprintf(fp, "  {\"symbology\": \"%s\", \"input_class\": \"%s\", \"phase\": \"%s\", \"median\": %.1f,"
+                        " \"p99\": %.1f, \"allocs\": %.1f, \"bytes\": %.0f}%s\n",
+                    results[i].symbology, results[i].input_class, results[i].phase, results[i].median,
+                    results[i].p99, results[i].allocs, results[i].bytes, i + 1 < count ? "," : "");
+        }
+        fputs("]\n", fp);
+    } else {
+        fputs("symbology,input_class,phase,median,p99,allocs,bytes\n", fp);
+        for (i = 0; i < count; i++) {
+            fprintf(fp, "%s,%s,%s,%.1f,%.1f,%.1f,%.0f\n", results[i].symbology, results[i].input_class,
+                    results[i].phase, results[i].median, results[i].p99, results[i].allocs, results[i].bytes);
+        }
+    }
+
+    if (fp != stdout) {
+        if (fclose(fp) != 0) {
+            fprintf(stderr, "testBenchWrite: failed to write \"%s\"\n", filename);
+            return -1;
+        }
+    } else {
+        fflush(fp);
+    }
+    return 0;
+}
+
+/* Parses a CSV line of results as written by `testBenchWrite()`. Returns 0 on success */
+static int testBenchReadCSVLine(char *line, struct testBenchResult *result) {
+    char field[64];
+    char *b = line;
+    double *values[4];
+    int i;
+
+    values[0] = &result->median;
+    values[1] = &result->p99;
+    values[2] = &result->allocs;
+    values[3] = &result->bytes;
+
+    if (!(b = testUtilReadCSVField(b, result->symbology, sizeof(result->symbology))) || *b++ != ','
+            || !(b = testUtilReadCSVField(b, result->input_class, sizeof(result->input_class))) || *b++ != ','
+            || !(b = testUtilReadCSVField(b, result->phase, sizeof(result->phase)))) {
+        return -1;
+    }
+    for (i = 0; i < 4; i++) {
+        char *endptr = NULL;
+        if (*b++ != ',' || !(b = testUtilReadCSVField(b, field, sizeof(field)))) {
+            return -1;
+        }
+        *values[i] = strtod(field, &endptr);
+        if (endptr == field || *endptr) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Reads benchmark results written by `testBenchWrite()`, the format being detected from the first character.
+   On success returns 0 and sets `*p_results` (to be freed by caller) and `*p_count` */
+int testBenchRead(const char *filename, struct testBenchResult **p_results, int *p_count) {
+    FILE *fp;
+    char line[512];
+    struct testBenchResult *results = NULL;
+    int size = 0, count = 0;
+    int json = -1;
+    int line_no = 0;
+
+    if (!(fp = fopen(filename, "r"))) {
+        fprintf(stderr, "testBenchRead: failed to open \"%s\"\n", filename);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        struct testBenchResult result;
+        char *l = line;
+
+        line_no++;
+        while (*l == ' ' || *l == '\t') {
+            l++;
+        }
+        if (json == -1) {
+            /* First line, either "[" or the CSV header */
+            json = *l == '[';
+            continue;
+        }
+        if (*l == '\n' || *l == '\r' || *l == '\0' || (json && *l == ']')) {
+            continue;
+        }
+        memset(&result, 0, sizeof(result));
+        if (json ? sscanf(l, "{\"symbology\": \"%39[^\"]\", \"input_class\": \"%15[^\"]\", \"phase\": \"%15[^\"]\","
+                            " \"median\": %lf, \"p99\": %lf, \"allocs\": %lf, \"bytes\": %lf}",
+                            result.symbology, result.input_class, result.phase, &result.median, &result.p99,
+                            &result.allocs, &result.bytes) != 7
+                 : testBenchReadCSVLine(l, &result) != 0) {
+            fprintf(stderr, "testBenchRead: \"%s\" line %d invalid\n", filename, line_no);
+            free(results);
+            fclose(fp);
+            return -1;
+        }
+        if (count == size) {
+            struct testBenchResult *new_results;
+            size = size ? size * 2 : 256;
+            if (!(new_results = (struct testBenchResult *) realloc(results, size * sizeof(results[0])))) {
+                fprintf(stderr, "testBenchRead: out of memory\n");
+                free(results);
+                fclose(fp);
+                return -1;
+            }
+            results = new_results;
+        }
+        results[count++] = result;
+    }
+    fclose(fp);
+
+    *p_results = results;
+    *p_count = count;
+    return 0;
+}
+
+/* Compares results against a baseline, matching on symbology, input class and phase, reporting to `report` (if
+   non-NULL) each whose median is more than `max_slowdown` (a fraction, e.g. 0.1 for 10%) slower, or whose
+   allocations are more than `max_allocs_increase` (a fraction) greater. Results not in the baseline are ignored.
+   Returns the number of regressions */
+int testBenchCompare(const struct testBenchResult *results, int count, const struct testBenchResult *baseline,
+            int baseline_count, double max_slowdown, double max_allocs_increase, FILE *report) {
+    int regressions = 0;
+    int i, j;
+
+    for (i = 0; i < count; i++) {
+        const struct testBenchResult *r = &results[i];
+        for (j = 0; j < baseline_count; j++) {
+            const struct testBenchResult *b = &baseline[j];
+            if (strcmp(r->symbology, b->symbology) == 0 && strcmp(r->input_class, b->input_class) == 0
+                    && strcmp(r->phase, b->phase) == 0) {
+                break;
+            }
+        }
+        if (j == baseline_count) {
+            continue;
+        }
+        if (r->median > baseline[j].median * (1.0 + max_slowdown)) {
+            if (report) {
+                fprintf(report, "REGRESSION %s %s %s: median %.1f ns/op, baseline %.1f (+%.1f%%)\n",
+                        r->symbology, r->input_class, r->phase, r->median, baseline[j].median,
+                        baseline[j].median > 0.0 ? (r->median / baseline[j].median - 1.0) * 100.0 : 100.0);
+            }
+            regressions++;
+        } else if (r->allocs > baseline[j].allocs * (1.0 + max_allocs_increase)) {
+            if (report) {
+                fprintf(report, "REGRESSION %s %s %s: allocs %.1f per op, baseline %.1f\n",
+                        r->symbology, r->input_class, r->phase, r->allocs, baseline[j].allocs);
+            }
+            regressions++;
+        }
+    }
+
+    return regressions;
+}
@@ -93,7 +93,9 @@ char *testUtilEscape(char *buffer, int length, char *escaped, int escaped_size);
 char *testUtilReadCSVField(char *buffer, char *field, int field_size);
 void testUtilStrCpyRepeat(char *buffer, char *repeat, int size);
 int testUtilSymbolCmp(const struct zint_symbol *a, const struct zint_symbol *b);
+void testUtilSymbolCopy(struct zint_symbol *dst, struct zint_internal *dst_internal, const struct zint_symbol *src);
 struct zint_vector *testUtilVectorCpy(const struct zint_vector *in);
+void testUtilVectorFree(struct zint_vector *vector);
 int testUtilVectorCmp(const struct zint_vector *a, const struct zint_vector *b);
 int testUtilModulesDump(const struct zint_symbol *symbol, char dump[], int dump_size);
 void testUtilModulesPrint(const struct zint_symbol *symbol, const char *prefix, const char *postfix);
@@ -106,6 +108,7 @@ char *testUtilUCharArrayDump(unsigned char *array, int size, char *dump, int dum
 void testUtilBitmapPrint(const struct zint_symbol *symbol, const char *prefix, const char *postfix);
 int testUtilBitmapCmp(const struct zint_symbol *symbol, const char *expected, int *row, int *column);
 int testUtilExists(char *filename);
+char *testUtilOutFile(char *buffer, const int i, const char *ext);
 int testUtilCmpPngs(char *file1, char *file2);
 int testUtilCmpTxts(char *txt1, char *txt2);
 int testUtilCmpBins(char *bin1, char *bin2);
@@ -126,6 +129,46 @@ int testUtilBwipp(int index, const struct zint_symbol *symbol, int option_1, int
 int testUtilBwippCmp(const struct zint_symbol *symbol, char *msg, const char *bwipp_buf, const char *expected);
 int testUtilBwippCmpRow(const struct zint_symbol *symbol, int row, char *msg, const char *bwipp_buf, const char *expected);
 
+/* Benchmark result, as written by `testBenchWrite()` and read back by `testBenchRead()` */
+struct testBenchResult {
+    char symbology[40];
+    char input_class[16];
+    char phase[16];
+    double median; /* ns/op */
+    double p99; /* ns/op */
+    double allocs; /* Library allocations per op */
+    double bytes; /* Bytes allocated per op */
+};
+
+#define TEST_BENCH_CSV  0
+#define TEST_BENCH_JSON 1
+
+int testBenchWrite(const char *filename, int format, const struct testBenchResult *results, int count);
+int testBenchRead(const char *filename, struct testBenchResult **p_results, int *p_count);
+int testBenchCompare(const struct testBenchResult *results, int count, const struct testBenchResult *baseline,
+            int baseline_count, double max_slowdown, double max_allocs_increase, FILE *report);
+
+/* Allocation accounting of a symbol's allocations, see `testAllocCreate()` */
+struct testAllocStats {
+    long allocs; /* Number of `malloc()`s (including `calloc()`s and `realloc()`s of NULL) */
+    long reallocs; /* Number of `realloc()`s of non-NULL */
+    long frees;
+    long outstanding; /* Blocks not freed */
+    double bytes; /* Total bytes requested */
+    long current; /* Bytes currently allocated */
+    long start; /* `current` when last reset */
+    long peak; /* Peak of `current` */
+};
+
+struct zint_symbol *testAllocCreate(struct testAllocStats *stats);
+void testAllocReset(struct testAllocStats *stats);
+
+#ifdef ZINT_TEST_ALLOCS
+/* Every test counts the allocations of the symbols it creates, failing if any not freed */
+struct zint_symbol *testAllocCreateCounted(void);
+#define ZBarcode_Create testAllocCreateCounted
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,1392 @@
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+/* Benchmarks encoding, ZBarcode_Buffer(), ZBarcode_Buffer_Vector() and each file writer (to memory) separately
+ * for every symbology, using a monotonic clock with warm-up and repetitions, reporting ns/op, MB/s and
+ * allocations per op. Results can be written as CSV or JSON and compared against a baseline (see testcommon.c).
+ * Besides the built-in samples, production-like corpora are read from "../data/bench" (see `bench_corpora[]`),
+ * which are (re)generated by running with -g. See usage() or run with -h */
+
+#include "testcommon.h"
+#include <errno.h>
+#include <limits.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(_MSC_VER)
+#define ZINT_WIN
+#include <windows.h>
+#endif
+
+/* Phases, "encode", "buffer", "vector" then the file writers */
+#define PHASE_ENCODE    0
+#define PHASE_BUFFER    1
+#define PHASE_VECTOR    2
+#define PHASE_WRITER    3
+
+static const char *const phase_names[] = {
+    "encode", "buffer", "vector",
+    "png", "gif", "bmp", "pcx", "pbm", "pgm", "tif", "zpl", "epl", "pcl", "qoi", "txt", "svg", "eps", "emf", "pdf",
+};
+
+/* Sample inputs, tried in turn with each symbology until one encodes without error */
+struct bench_sample {
+    const char *data;
+    const char *primary;
+    int input_mode;
+};
+
+static const struct bench_sample samples[] = {
+    { "Zint Barcode 0123456789 abcdefghijklmnopqrstuvwxyz", "", UNICODE_MODE },
+    { "ZINT BARCODE 0123456789", "", UNICODE_MODE },
+    { "SN34RD1A", "", UNICODE_MODE }, /* RM4SCC */
+    { "1231FZ13XHS", "", UNICODE_MODE }, /* KIX */
+    { "A0123456789B", "", UNICODE_MODE }, /* Codabar */
+    { "[01]12345678901231[10]ABC123", "", GS1_MODE },
+    { "[21]A12345678", "331234567890", GS1_MODE }, /* Composites */
+    { "[21]A12345678", "[01]12345678901231", GS1_MODE },
+    { "[21]A12345678", "1234567890123", GS1_MODE },
+    { "[21]A12345678", "12345678901", GS1_MODE },
+    { "[21]A12345678", "0123456", GS1_MODE },
+    { "9780306406157", "", UNICODE_MODE }, /* ISBN, EAN-13 with check digit */
+    { "036000291452", "", UNICODE_MODE }, /* UPC-A with check digit */
+    { "01234565", "", UNICODE_MODE }, /* UPC-E with check digit */
+    { "12345678901", "", UNICODE_MODE },
+    { "1234567890123", "", UNICODE_MODE },
+    { "12345678901234567", "", UNICODE_MODE },
+    { "123456789012", "", UNICODE_MODE },
+    { "0123456", "", UNICODE_MODE },
+    { "12345678", "", UNICODE_MODE },
+    { "123456", "", UNICODE_MODE },
+    { "12345", "", UNICODE_MODE },
+    { "123", "", UNICODE_MODE },
+    { "FADT", "", UNICODE_MODE }, /* DAFT */
+    { "15400233-16-4-205", "", UNICODE_MODE }, /* Japan Post */
+    { "11210012341234567AB19XY1A", "", UNICODE_MODE }, /* Mailmark */
+    { "01234567094987654321", "", UNICODE_MODE }, /* USPS Intelligent Mail */
+    { "%000393206219912345678101040", "", UNICODE_MODE }, /* DPD */
+    { "1M8GDM9AXKP042788", "", UNICODE_MODE }, /* VIN */
+    { "A", "", UNICODE_MODE }, /* FIM */
+};
+
+/* Settings which encoding may change, restored before each encode */
+struct bench_settings {
+    int symbology;
+    int height;
+    int whitespace_width;
+    int whitespace_height;
+    int border_width;
+    int output_options;
+    float scale;
+    int option_1;
+    int option_2;
+    int option_3;
+    int show_hrt;
+    int input_mode;
+    int eci;
+};
+
+static void bench_settings_save(const struct zint_symbol *symbol, struct bench_settings *settings) {
+    settings->symbology = symbol->symbology;
+    settings->height = symbol->height;
+    settings->whitespace_width = symbol->whitespace_width;
+    settings->whitespace_height = symbol->whitespace_height;
+    settings->border_width = symbol->border_width;
+    settings->output_options = symbol->output_options;
+    settings->scale = symbol->scale;
+    settings->option_1 = symbol->option_1;
+    settings->option_2 = symbol->option_2;
+    settings->option_3 = symbol->option_3;
+    settings->show_hrt = symbol->show_hrt;
+    settings->input_mode = symbol->input_mode;
+    settings->eci = symbol->eci;
+}
+
+static void bench_settings_restore(struct zint_symbol *symbol, const struct bench_settings *settings) {
+    symbol->symbology = settings->symbology;
+    symbol->height = settings->height;
+    symbol->whitespace_width = settings->whitespace_width;
+    symbol->whitespace_height = settings->whitespace_height;
+    symbol->border_width = settings->border_width;
+    symbol->output_options = settings->output_options;
+    symbol->scale = settings->scale;
+    symbol->option_1 = settings->option_1;
+    symbol->option_2 = settings->option_2;
+    symbol->option_3 = settings->option_3;
+    symbol->show_hrt = settings->show_hrt;
+    symbol->input_mode = settings->input_mode;
+    symbol->eci = settings->eci;
+}
+
+/* Corpus input item */
+struct bench_item {
+    unsigned char *data;
+    int length;
+    char primary[128];
+};
+
+/* Benchmark state for one symbology */
+struct bench {
+    struct zint_symbol *symbol;
+    struct bench_settings settings;
+    const unsigned char *data;
+    int length;
+    int phase;
+    const struct bench_item *items; /* Corpus items if any, cycled through by each operation */
+    int item_count;
+    int item;
+    struct zint_symbol **symbols; /* Encoded symbol of each corpus item for the output phases */
+};
+
+/* Counts allocations made through the allocator of the benchmarked symbols while `counting` */
+struct bench_allocs {
+    long count;
+    double bytes;
+    int counting;
+};
+
+static struct bench_allocs bench_allocs;
+
+static void *bench_malloc(void *context, size_t size) {
+    struct bench_allocs *allocs = (struct bench_allocs *) context;
+    if (allocs->counting) {
+        allocs->count++;
+        allocs->bytes += size;
+    }
+    return malloc(size);
+}
+
+static void *bench_realloc(void *context, void *ptr, size_t size) {
+    struct bench_allocs *allocs = (struct bench_allocs *) context;
+    if (allocs->counting) {
+        allocs->count++;
+        allocs->bytes += size;
+    }
+    return realloc(ptr, size);
+}
+
+static void bench_free(void *context, void *ptr) {
+    (void)context;
+    free(ptr);
+}
+
+/* Creates a symbol whose allocations are counted in `bench_allocs`, exiting on failure */
+static struct zint_symbol *bench_create(void) {
+    struct zint_allocator allocator;
+    struct zint_symbol *symbol;
+
+    allocator.malloc_fn = bench_malloc;
+    allocator.realloc_fn = bench_realloc;
+    allocator.free_fn = bench_free;
+    allocator.context = &bench_allocs;
+    if (!(symbol = ZBarcode_Create_Allocator(&allocator))) {
+        fprintf(stderr, "zint_bench: out of memory\n");
+        exit(1);
+    }
+    return symbol;
+}
+
+/* Monotonic time in nanoseconds */
+static double bench_now(void) {
+#if defined(ZINT_WIN)
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double) count.QuadPart * 1e9 / (double) frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + ts.tv_nsec;
+#else
+    return (double) clock() * 1e9 / CLOCKS_PER_SEC;
+#endif
+}
+
+/* Does one operation of the phase, returning the error number */
+static int bench_op(struct bench *b) {
+    struct zint_symbol *symbol;
+
+    if (b->items) {
+        const int item = b->item;
+        if (++b->item == b->item_count) {
+            b->item = 0;
+        }
+        if (b->phase == PHASE_ENCODE) {
+            b->data = b->items[item].data;
+            b->length = b->items[item].length;
+            strcpy(b->symbol->primary, b->items[item].primary);
+        } else {
+            b->symbol = b->symbols[item];
+        }
+    }
+    symbol = b->symbol;
+
+    switch (b->phase) {
+        case PHASE_ENCODE:
+            ZBarcode_Clear(symbol);
+            bench_settings_restore(symbol, &b->settings);
+            return ZBarcode_Encode(symbol, b->data, b->length);
+        case PHASE_BUFFER:
+            return ZBarcode_Buffer(symbol, 0);
+        case PHASE_VECTOR:
+            return ZBarcode_Buffer_Vector(symbol, 0);
+    }
+    return ZBarcode_Print(symbol, 0);
+}
+
+/* Bytes processed by an operation of the phase, 0 if not applicable */
+static double bench_bytes(const struct bench *b) {
+    switch (b->phase) {
+        case PHASE_ENCODE:
+            return b->length;
+        case PHASE_BUFFER:
+            return (double) b->symbol->bitmap_width * b->symbol->bitmap_height * 3;
+        case PHASE_VECTOR:
+            return 0;
+    }
+    return b->symbol->memfile_size;
+}
+
+/* Average ns taken by `iterations` operations */
+static double bench_time(struct bench *b, long iterations) {
+    double start = bench_now();
+    long i;
+
+    for (i = 0; i < iterations; i++) {
+        (void) bench_op(b);
+    }
+    return (bench_now() - start) / iterations;
+}
+
+static int bench_cmp_double(const void *a, const void *b) {
+    const double da = *(const double *) a, db = *(const double *) b;
+    return da < db ? -1 : da > db;
+}
+
+/* Options */
+struct bench_opts {
+    int symbology; /* 0 for all */
+    int phase; /* -1 for all */
+    int input_class; /* -1 for all, 0 small, 1 large, 2 + index of corpus */
+    int warmups;
+    int reps;
+    double target_ns;
+    const char *data;
+    int csv;
+    const char *corpus_dir;
+};
+
+/* Results collected for writing and comparing */
+struct bench_results {
+    struct testBenchResult *results;
+    int count;
+    int size;
+};
+
+#define BENCH_MAX_REPS  1000
+#define BENCH_LARGE_MAX 4096 /* Maximum length of large class input */
+
+static const char *const input_class_names[] = { "small", "large" };
+
+/* Times the phase, printing a line unless CSV, and adds to results */
+static void bench_phase(struct bench *b, const char *input_class, const struct bench_opts *opts,
+            struct bench_results *res) {
+    double samples[BENCH_MAX_REPS];
+    struct testBenchResult *result;
+    double t, bytes, median;
+    long iterations;
+    const int ops = b->items ? b->item_count : 1; /* Operations to go through all corpus items */
+    int i;
+
+    /* Check and size the operation, averaging over corpus items */
+    bytes = 0;
+    for (i = 0; i < ops; i++) {
+        if (bench_op(b) >= ZINT_ERROR) {
+            if (!opts->csv) {
+                printf("%-28s %-14s %-7s skipped: %s\n", testUtilBarcodeName(b->symbol->symbology), input_class,
+                        phase_names[b->phase], b->symbol->errtxt);
+            }
+            return;
+        }
+        bytes += bench_bytes(b);
+    }
+    bytes /= ops;
+
+    /* Calibrate number of iterations to take the target time per repetition */
+    iterations = 1;
+    while ((t = bench_time(b, iterations) * iterations) < opts->target_ns && iterations < LONG_MAX / 2) {
+        if (t * 10 < opts->target_ns) {
+            iterations *= 10;
+        } else {
+            iterations = (long) (iterations * opts->target_ns / t) + 1;
+            break;
+        }
+    }
+
+    for (i = 0; i < opts->warmups; i++) {
+        (void) bench_time(b, iterations);
+    }
+    for (i = 0; i < opts->reps; i++) {
+        samples[i] = bench_time(b, iterations);
+    }
+    qsort(samples, opts->reps, sizeof(samples[0]), bench_cmp_double);
+    median = opts->reps & 1 ? samples[opts->reps / 2]
+                            : (samples[opts->reps / 2 - 1] + samples[opts->reps / 2]) / 2.0;
+
+    /* Count allocations of one operation (averaged over corpus items) */
+    bench_allocs.count = 0;
+    bench_allocs.bytes = 0;
+    bench_allocs.counting = 1;
+    for (i = 0; i < ops; i++) {
+        (void) bench_op(b);
+    }
+    bench_allocs.counting = 0;
+
+    if (res->count == res->size) {
+        struct testBenchResult *results;
+        res->size = res->size ? res->size * 2 : 256;
+        if (!(results = (struct testBenchResult *) realloc(res->results, res->size * sizeof(res->results[0])))) {
+            fprintf(stderr, "zint_bench: out of memory\n");
+            exit(1);
+        }
+        res->results = results;
+    }
+    result = &res->results[res->count++];
+    strcpy(result->symbology, testUtilBarcodeName(b->symbol->symbology));
+    strcpy(result->input_class, input_class);
+    strcpy(result->phase, phase_names[b->phase]);
+    result->median = median;
+    /* Nearest rank, the maximum for under 100 repetitions */
+    result->p99 = samples[(opts->reps * 99 + 99) / 100 - 1];
+    result->allocs = (double) bench_allocs.count / ops;
+    result->bytes = bench_allocs.bytes / ops;
+
+    if (!opts->csv) {
+        printf("%-28s %-14s %-7s %12.1f %12.1f %9.2f %9.1f %11.0f\n", result->symbology, input_class,
+                result->phase, median, result->p99, bytes ? bytes * 1e3 / median : 0.0, result->allocs,
+                result->bytes);
+    }
+}
+
+/* Sets up a new symbol to encode sample `sample_idx` (or the user data) with symbology */
+static void bench_setup(struct bench *b, int symbology, const struct bench_opts *opts, int sample_idx) {
+    b->symbol = bench_create();
+    b->symbol->symbology = symbology;
+    if (opts->data) {
+        b->data = (const unsigned char *) opts->data;
+    } else {
+        b->symbol->input_mode = samples[sample_idx].input_mode;
+        strcpy(b->symbol->primary, samples[sample_idx].primary);
+        b->data = (const unsigned char *) samples[sample_idx].data;
+    }
+    b->length = (int) strlen((const char *) b->data);
+    bench_settings_save(b->symbol, &b->settings);
+    b->items = NULL;
+    b->item_count = b->item = 0;
+    b->symbols = NULL;
+}
+
+/* Encodes with the saved settings */
+static int bench_encode(struct bench *b) {
+    ZBarcode_Clear(b->symbol);
+    bench_settings_restore(b->symbol, &b->settings);
+    return ZBarcode_Encode(b->symbol, b->data, b->length);
+}
+
+/* Sets `large` to the input repeated as often as will encode (doubling, up to BENCH_LARGE_MAX), returning
+   its length, or 0 if can't be repeated */
+static int bench_large(struct bench *b, unsigned char large[BENCH_LARGE_MAX + 1]) {
+    const unsigned char *data = b->data;
+    const int length = b->length;
+    int large_length = 0;
+    int repeat;
+
+    for (repeat = 2; repeat * length <= BENCH_LARGE_MAX; repeat *= 2) {
+        int i;
+        for (i = repeat / 2; i < repeat; i++) {
+            memcpy(large + i * length, data, length);
+        }
+        b->data = large;
+        b->length = repeat * length;
+        if (bench_encode(b) >= ZINT_ERROR) {
+            break;
+        }
+        large_length = b->length;
+    }
+    if (repeat == 2) {
+        memcpy(large, data, length); /* First half for the next doubling */
+    }
+    b->data = data;
+    b->length = length;
+    return large_length;
+}
+
+/* Symbology from number or name with or without "BARCODE_" prefix, 0 if not found */
+static int bench_symbology_id(const char *arg) {
+    char *endptr = NULL;
+    long val;
+    int i;
+
+    errno = 0;
+    val = strtol(arg, &endptr, 10);
+    if (!errno && endptr != arg && *endptr == '\0') {
+        return val > 0 && val < 256 && ZBarcode_ValidID(val) ? (int) val : 0;
+    }
+    for (i = 1; i < 256; i++) {
+        const char *name;
+        if (!ZBarcode_ValidID(i) || !*(name = testUtilBarcodeName(i))) {
+            continue;
+        }
+        if (strcasecmp(name, arg) == 0 || (strncmp(name, "BARCODE_", 8) == 0 && strcasecmp(name + 8, arg) == 0)) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+/* Production-like corpora, generated deterministically by `bench_generate()` (-g) and checked in as
+   "<corpus_dir>/<name>.txt". A corpus file has "#" comment lines, then "key=value" settings lines ("symbology",
+   "input_mode", "option_1", "option_2", "option_3", "eci" and "primary"), then a "---" line followed by one item
+   per line, prefixed by the primary message and a tab if "primary=1" */
+
+#define BENCH_ITEM_MAX  4096 /* Maximum length of a corpus item */
+
+/* Pseudo-random generator, a fixed LCG so that corpora are reproducible across platforms */
+struct bench_rand {
+    unsigned long state;
+};
+
+/* Random int from 0 to `n` - 1 */
+static int bench_rand(struct bench_rand *r, int n) {
+    r->state = (r->state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+    return (int) ((r->state >> 8) % (unsigned long) n);
+}
+
+/* Random element of string array */
+#define BENCH_PICK(r, arr) (arr[bench_rand(r, (int) ARRAY_SIZE(arr))])
+
+/* Appends `len` random chars from `set` */
+static void gen_chars(struct bench_rand *r, char *s, const char *set, int len) {
+    const int set_len = (int) strlen(set);
+    char *d = s + strlen(s);
+    int i;
+
+    for (i = 0; i < len; i++) {
+        d[i] = set[bench_rand(r, set_len)];
+    }
+    d[len] = '\0';
+}
+
+#define GEN_DIGITS  "0123456789"
+#define GEN_UPPER   "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define GEN_ALNUM   "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+
+/* Appends a `len` digit GS1 number starting with `prefix`, with random digits and a mod 10 check digit */
+static void gen_gs1_number(struct bench_rand *r, char *s, const char *prefix, int len) {
+    char *d = s + strlen(s);
+    int sum = 0;
+    int i;
+
+    strcpy(d, prefix);
+    gen_chars(r, d, GEN_DIGITS, len - 1 - (int) strlen(prefix));
+    for (i = len - 2; i >= 0; i--) {
+        sum += (d[i] - '0') * ((len - 2 - i) & 1 ? 1 : 3);
+    }
+    d[len - 1] = '0' + (10 - sum % 10) % 10;
+    d[len] = '\0';
+}
+
+/* Appends a valid YYMMDD date */
+static void gen_date(struct bench_rand *r, char *s) {
+    sprintf(s + strlen(s), "%02d%02d%02d", 20 + bench_rand(r, 10), 1 + bench_rand(r, 12), 1 + bench_rand(r, 28));
+}
+
+/* GS1 prefixes of some member organisations (company prefixes start with these) */
+static const char *const gen_gs1_prefixes[] = {
+    "000", "001", "030", "050", "073", "300", "340", "376", "400", "409", "425", "440", "450", "471", "490",
+    "500", "539", "540", "560", "590", "690", "693", "729", "760", "773", "780", "800", "840", "870", "880", "890",
+    "930", "940",
+};
+
+/* GS1-128 logistics labels, SSCCs, GTINs with dates, batches, counts, weights and shipping details */
+static void gen_gs1_128(struct bench_rand *r, char *primary, char *data) {
+    char prefix[8];
+
+    (void) primary;
+    sprintf(prefix, "%d%s", bench_rand(r, 10), BENCH_PICK(r, gen_gs1_prefixes));
+    switch (bench_rand(r, 6)) {
+        case 0:
+            strcpy(data, "[00]");
+            gen_gs1_number(r, data, prefix, 18);
+            break;
+        case 1:
+            strcpy(data, "[01]");
+            gen_gs1_number(r, data, prefix, 14);
+            strcat(data, "[17]");
+            gen_date(r, data);
+            strcat(data, "[10]");
+            gen_chars(r, data, GEN_ALNUM, 4 + bench_rand(r, 5));
+            break;
+        case 2:
+            strcpy(data, "[02]");
+            gen_gs1_number(r, data, prefix, 14);
+            strcat(data, "[37]");
+            gen_chars(r, data, "123456789", 1);
+            gen_chars(r, data, GEN_DIGITS, bench_rand(r, 4));
+            strcat(data, "[10]");
+            gen_chars(r, data, GEN_ALNUM, 3 + bench_rand(r, 4));
+            break;
+        case 3:
+            strcpy(data, "[01]");
+            gen_gs1_number(r, data, prefix, 14);
+            strcat(data, "[3103]");
+            gen_chars(r, data, GEN_DIGITS, 6);
+            strcat(data, "[15]");
+            gen_date(r, data);
+            break;
+        case 4:
+            strcpy(data, "[410]");
+            gen_gs1_number(r, data, BENCH_PICK(r, gen_gs1_prefixes), 13);
+            strcat(data, "[420]");
+            gen_chars(r, data, GEN_DIGITS, 5);
+            break;
+        default:
+            strcpy(data, "[00]");
+            gen_gs1_number(r, data, prefix, 18);
+            strcat(data, "[400]");
+            gen_chars(r, data, GEN_ALNUM, 6 + bench_rand(r, 5));
+            break;
+    }
+}
+
+/* EAN-13 mostly, some EAN-8, with occasional 2 or 5 digit add-ons (periodicals, books) */
+static void gen_ean(struct bench_rand *r, char *primary, char *data) {
+    const int type = bench_rand(r, 20);
+
+    (void) primary;
+    data[0] = '\0';
+    if (type < 2) {
+        gen_gs1_number(r, data, BENCH_PICK(r, gen_gs1_prefixes) + 1, 8);
+    } else if (type < 4) {
+        gen_gs1_number(r, data, type == 2 ? "977" : "978", 13); /* ISSN, ISBN */
+        if (type == 2) {
+            strcat(data, "+");
+            gen_chars(r, data, GEN_DIGITS, 2);
+        } else if (bench_rand(r, 2)) {
+            strcat(data, "+5");
+            gen_chars(r, data, GEN_DIGITS, 4);
+        }
+    } else {
+        gen_gs1_number(r, data, BENCH_PICK(r, gen_gs1_prefixes), 13);
+    }
+}
+
+/* GS1 Data Matrix 1 to 3 KB, product identification followed by company internal data (AIs 91 to 99) */
+static void gen_gs1_datamatrix(struct bench_rand *r, char *primary, char *data) {
+    const int target = 1000 + bench_rand(r, 1400);
+    int ai = 91;
+
+    (void) primary;
+    strcpy(data, "[01]");
+    gen_gs1_number(r, data, BENCH_PICK(r, gen_gs1_prefixes), 14);
+    strcat(data, "[10]");
+    gen_chars(r, data, GEN_ALNUM, 4 + bench_rand(r, 7));
+    strcat(data, "[17]");
+    gen_date(r, data);
+    strcat(data, "[21]");
+    gen_chars(r, data, GEN_DIGITS, 12);
+    while ((int) strlen(data) < target - 94) {
+        sprintf(data + strlen(data), "[%d]", ai);
+        if (bench_rand(r, 4)) {
+            gen_chars(r, data, GEN_DIGITS, 60 + bench_rand(r, 31));
+        } else {
+            gen_chars(r, data, GEN_ALNUM, 30 + bench_rand(r, 61));
+        }
+        ai = ai == 99 ? 91 : ai + 1;
+    }
+}
+
+/* Japanese vocabulary, all in JIS X 0208 */
+static const char *const gen_kanji_words[] = {
+    "東京都", "大阪府", "京都府", "北海道", "神奈川県", "横浜市", "名古屋市", "福岡市", "株式会社", "配送", "伝票番号",
+    "住所", "電話", "品名", "数量", "重量", "受取人", "差出人", "日本郵便", "倉庫", "在庫", "管理", "注文", "確認",
+    "発送", "予定", "品質", "検査", "合格", "製造", "工場", "部品", "番地", "丁目", "様", "御中", "精密機械", "電子部品",
+    "食品", "冷蔵", "取扱注意", "至急", "生年月日", "氏名", "会員番号", "有効期限", "領収書", "合計金額", "消費税",
+};
+
+/* QR Code, Kanji-heavy business data (converted to Shift JIS and encoded in Kanji mode) */
+static void gen_qr_kanji(struct bench_rand *r, char *primary, char *data) {
+    const int words = 8 + bench_rand(r, 40);
+    int i;
+
+    (void) primary;
+    data[0] = '\0';
+    for (i = 0; i < words; i++) {
+        strcat(data, BENCH_PICK(r, gen_kanji_words));
+        if (bench_rand(r, 6) == 0) {
+            gen_chars(r, data, GEN_DIGITS, 1 + bench_rand(r, 4));
+        }
+    }
+}
+
+/* Chinese vocabulary, mostly GB 2312, with some CJK Extension A (GB 18030 4-byte) characters */
+static const char *const gen_hanzi_words[] = {
+    "北京市", "上海市", "广州市", "深圳市", "杭州市", "成都市", "物流", "快递", "订单", "编号", "收件人", "寄件人",
+    "地址", "电话", "商品", "数量", "重量", "仓库", "条码", "中国邮政", "有限公司", "科技", "省", "区", "路", "号",
+    "街道", "大厦", "室", "生产日期", "保质期", "批号", "产地", "合格证", "检验员", "价格", "元", "发票", "税号",
+    "㐀", "䶮", "㙍", "䲜", "㑇",
+};
+
+/* Han Xin, Chinese logistics and product data (converted to GB 18030) */
+static void gen_hanxin_gb18030(struct bench_rand *r, char *primary, char *data) {
+    const int words = 8 + bench_rand(r, 40);
+    int i;
+
+    (void) primary;
+    data[0] = '\0';
+    for (i = 0; i < words; i++) {
+        strcat(data, BENCH_PICK(r, gen_hanzi_words));
+        if (bench_rand(r, 5) == 0) {
+            gen_chars(r, data, GEN_DIGITS, 1 + bench_rand(r, 6));
+        }
+    }
+}
+
+static const char *const gen_ups_services[] = { "001", "002", "003", "004", "007", "012", "013", "054", "065" };
+static const char *const gen_us_states[] = { "CA", "GA", "IL", "KY", "NJ", "NY", "OH", "TX", "WA" };
+static const char *const gen_us_cities[] = {
+    "ATLANTA", "CHICAGO", "LOUISVILLE", "NEW YORK", "NEWARK", "COLUMBUS", "DALLAS", "SEATTLE", "LOS ANGELES",
+};
+
+/* MaxiCode, UPS shipping labels, structured carrier primary (US ZIP+4 Mode 2, Canadian Mode 3) with ANSI MH10.8.3
+   secondary message (escape sequences for RS, GS and EOT) */
+static void gen_maxicode_ups(struct bench_rand *r, char *primary, char *data) {
+    const int canada = bench_rand(r, 5) == 0;
+
+    primary[0] = '\0';
+    if (canada) {
+        gen_chars(r, primary, GEN_UPPER, 1);
+        gen_chars(r, primary, GEN_DIGITS, 1);
+        gen_chars(r, primary, GEN_UPPER, 1);
+        gen_chars(r, primary, GEN_DIGITS, 1);
+        gen_chars(r, primary, GEN_UPPER, 1);
+        gen_chars(r, primary, GEN_DIGITS, 1);
+        strcat(primary, "124");
+    } else {
+        gen_chars(r, primary, GEN_DIGITS, 9);
+        strcat(primary, "840");
+    }
+    strcat(primary, BENCH_PICK(r, gen_ups_services));
+
+    strcpy(data, "[)>\\R01\\G96"); /* Message header, format 01, version 96 */
+    strcat(data, "1Z");
+    gen_chars(r, data, GEN_ALNUM, 8); /* Tracking number */
+    strcat(data, "\\GUPSN\\G");
+    gen_chars(r, data, GEN_ALNUM, 6); /* Shipper number */
+    strcat(data, "\\G");
+    sprintf(data + strlen(data), "%03d", 1 + bench_rand(r, 365)); /* Julian day of pickup */
+    strcat(data, "\\G\\G");
+    sprintf(data + strlen(data), "%d/%d", 1, 1 + bench_rand(r, 3)); /* Package n/x */
+    strcat(data, "\\G");
+    sprintf(data + strlen(data), "%d", 1 + bench_rand(r, 70)); /* Weight */
+    strcat(data, "\\GY\\G");
+    sprintf(data + strlen(data), "%d MAIN ST", 1 + bench_rand(r, 9999));
+    strcat(data, "\\G");
+    if (canada) {
+        strcat(data, "TORONTO\\GON");
+    } else {
+        const int city = bench_rand(r, (int) ARRAY_SIZE(gen_us_cities));
+        sprintf(data + strlen(data), "%s\\G%s", gen_us_cities[city], gen_us_states[city]);
+    }
+    strcat(data, "\\R\\E");
+}
+
+static const char *const gen_airports[] = {
+    "AMS", "ATL", "CDG", "DXB", "FRA", "HKG", "JFK", "LAX", "LHR", "MAD", "MUC", "NRT", "ORD", "SIN", "SYD", "ZRH",
+};
+static const char *const gen_airlines[] = { "AA ", "AF ", "BA ", "EK ", "KL ", "LH ", "LX ", "QF ", "SQ ", "UA " };
+static const char *const gen_surnames[] = {
+    "SMITH", "JONES", "MUELLER", "DUBOIS", "ROSSI", "GARCIA", "TANAKA", "WANG", "NGUYEN", "KOWALSKI", "OBRIEN",
+};
+static const char *const gen_forenames[] = {
+    "JOHN", "MARY", "HANS", "MARIE", "LUCA", "ANA", "YUKI", "WEI", "LINH", "PIOTR", "SEAN", "ELIZABETHANN",
+};
+
+/* PDF417 airline boarding passes, IATA Bar Coded Boarding Pass (BCBP) mandatory items */
+static void gen_pdf417_bcbp(struct bench_rand *r, char *primary, char *data) {
+    char name[64];
+    int from, to;
+
+    (void) primary;
+    sprintf(name, "%s/%s", BENCH_PICK(r, gen_surnames), BENCH_PICK(r, gen_forenames));
+    name[20] = '\0';
+    from = bench_rand(r, (int) ARRAY_SIZE(gen_airports));
+    to = (from + 1 + bench_rand(r, (int) ARRAY_SIZE(gen_airports) - 1)) % (int) ARRAY_SIZE(gen_airports);
+    sprintf(data, "M1%-20sE", name);
+    gen_chars(r, data, GEN_UPPER, 1);
+    gen_chars(r, data, GEN_ALNUM, 5); /* PNR */
+    strcat(data, " ");
+    strcat(data, gen_airports[from]);
+    strcat(data, gen_airports[to]);
+    strcat(data, BENCH_PICK(r, gen_airlines));
+    sprintf(data + strlen(data), "%04d %03d", 1 + bench_rand(r, 9999), 1 + bench_rand(r, 365)); /* Flight, date */
+    gen_chars(r, data, "CFJWY", 1); /* Compartment */
+    sprintf(data + strlen(data), "%03d", 1 + bench_rand(r, 60)); /* Seat */
+    gen_chars(r, data, "ABCDEFHJK", 1);
+    sprintf(data + strlen(data), "%04d ", 1 + bench_rand(r, 400)); /* Check-in sequence */
+    strcat(data, "100"); /* Passenger status, size of conditional items */
+}
+
+/* DotCode, GS1 product marking (GTIN, serial, batch, expiry) as printed by high-speed inkjet */
+static void gen_dotcode_gs1(struct bench_rand *r, char *primary, char *data) {
+    (void) primary;
+    strcpy(data, "[01]");
+    gen_gs1_number(r, data, BENCH_PICK(r, gen_gs1_prefixes), 14);
+    strcat(data, "[17]");
+    gen_date(r, data);
+    strcat(data, "[10]");
+    gen_chars(r, data, GEN_ALNUM, 4 + bench_rand(r, 7));
+    strcat(data, "[21]");
+    gen_chars(r, data, GEN_ALNUM, 8 + bench_rand(r, 13));
+}
+
+/* Corpus definitions */
+struct bench_corpus_def {
+    const char *name;
+    int symbology;
+    int input_mode;
+    int primary;
+    int count;
+    const char *description;
+    void (*generate)(struct bench_rand *r, char *primary, char *data);
+};
+
+static const struct bench_corpus_def bench_corpora[] = {
+    { "gs1_128", BARCODE_GS1_128, GS1_MODE, 0, 100, "GS1-128 logistics labels", gen_gs1_128 },
+    { "ean", BARCODE_EANX, UNICODE_MODE, 0, 100, "EAN-13/EAN-8 retail, some add-ons", gen_ean },
+    { "gs1_datamatrix", BARCODE_DATAMATRIX, GS1_MODE, 0, 32, "GS1 Data Matrix 1 to 3 KB",
+        gen_gs1_datamatrix },
+    { "qr_kanji", BARCODE_QRCODE, UNICODE_MODE, 0, 100, "QR Code Kanji-heavy", gen_qr_kanji },
+    { "hanxin_gb18030", BARCODE_HANXIN, UNICODE_MODE, 0, 100, "Han Xin GB 18030 Chinese",
+        gen_hanxin_gb18030 },
+    { "maxicode_ups", BARCODE_MAXICODE, UNICODE_MODE | ESCAPE_MODE, 1, 100, "MaxiCode UPS shipping labels",
+        gen_maxicode_ups },
+    { "pdf417_bcbp", BARCODE_PDF417, UNICODE_MODE, 0, 100, "PDF417 IATA boarding passes",
+        gen_pdf417_bcbp },
+    { "dotcode_gs1", BARCODE_DOTCODE, GS1_MODE, 0, 100, "DotCode GS1 product marking", gen_dotcode_gs1 },
+};
+
+/* Input mode flags for corpus files */
+static const struct bench_mode_name {
+    const char *name;
+    int mode;
+} bench_mode_names[] = {
+    { "UNICODE_MODE", UNICODE_MODE }, { "GS1_MODE", GS1_MODE }, { "ESCAPE_MODE", ESCAPE_MODE },
+    { "GS1PARENS_MODE", GS1PARENS_MODE }, { "MINIMAL_MODE", MINIMAL_MODE }, { "GS1NOCHECK_MODE", GS1NOCHECK_MODE },
+};
+
+/* Loaded corpus */
+struct bench_corpus {
+    struct bench_settings settings;
+    struct bench_item *items;
+    int count;
+};
+
+/* Creates a symbol with the corpus settings */
+static struct zint_symbol *bench_corpus_symbol(const struct bench_settings *settings) {
+    struct zint_symbol *symbol = bench_create();
+
+    bench_settings_restore(symbol, settings);
+    return symbol;
+}
+
+/* Default settings of a corpus */
+static void bench_corpus_settings(const struct bench_corpus_def *def, struct bench_settings *settings) {
+    struct zint_symbol *symbol = ZBarcode_Create();
+
+    if (!symbol) {
+        fprintf(stderr, "zint_bench: out of memory\n");
+        exit(1);
+    }
+    symbol->symbology = def->symbology;
+    symbol->input_mode = def->input_mode;
+    bench_settings_save(symbol, settings);
+    ZBarcode_Delete(symbol);
+}
+
+/* Generates corpus, validating each item by encoding it, returning 0 on success */
+static int bench_generate_corpus(const struct bench_corpus_def *def, const char *dir) {
+    struct bench_settings settings;
+    struct zint_symbol *symbol;
+    struct bench_rand r;
+    char primary[128], data[BENCH_ITEM_MAX + 1];
+    char filename[1024];
+    FILE *fp;
+    int i;
+
+    if (strlen(dir) + strlen(def->name) + 6 > sizeof(filename)) {
+        fprintf(stderr, "zint_bench: corpus directory \"%s\" too long\n", dir);
+        return 1;
+    }
+    sprintf(filename, "%s/%s.txt", dir, def->name);
+    if (!(fp = fopen(filename, "w"))) {
+        fprintf(stderr, "zint_bench: failed to open \"%s\" for writing\n", filename);
+        return 1;
+    }
+    bench_corpus_settings(def, &settings);
+    symbol = bench_corpus_symbol(&settings);
+
+    fprintf(fp, "# %s\n# Generated by \"zint_bench -g\", do not edit\n", def->description);
+    fprintf(fp, "symbology=%s\ninput_mode=", testUtilBarcodeName(def->symbology));
+    if (def->input_mode == DATA_MODE) {
+        fputs("DATA_MODE", fp);
+    } else {
+        const char *sep = "";
+        for (i = 0; i < (int) ARRAY_SIZE(bench_mode_names); i++) {
+            if ((def->input_mode & bench_mode_names[i].mode) == bench_mode_names[i].mode
+                    && (bench_mode_names[i].mode != UNICODE_MODE || (def->input_mode & 0x07) == UNICODE_MODE)) {
+                fprintf(fp, "%s%s", sep, bench_mode_names[i].name);
+                sep = "|";
+            }
+        }
+    }
+    fputc('\n', fp);
+    if (def->primary) {
+        fputs("primary=1\n", fp);
+    }
+    fputs("---\n", fp);
+
+    r.state = 1;
+    for (i = 0; def->name[i]; i++) {
+        r.state = (r.state * 31 + (unsigned char) def->name[i]) & 0xFFFFFFFFUL; /* Seed from name */
+    }
+    for (i = 0; i < def->count; i++) {
+        primary[0] = '\0';
+        def->generate(&r, primary, data);
+        ZBarcode_Clear(symbol);
+        bench_settings_restore(symbol, &settings);
+        strcpy(symbol->primary, primary);
+        if (ZBarcode_Encode(symbol, (const unsigned char *) data, (int) strlen(data)) >= ZINT_ERROR) {
+            fprintf(stderr, "zint_bench: %s item %d \"%s\" invalid: %s\n", def->name, i, data, symbol->errtxt);
+            ZBarcode_Delete(symbol);
+            fclose(fp);
+            return 1;
+        }
+        if (def->primary) {
+            fprintf(fp, "%s\t", primary);
+        }
+        fprintf(fp, "%s\n", data);
+    }
+    ZBarcode_Delete(symbol);
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "zint_bench: failed to write \"%s\"\n", filename);
+        return 1;
+    }
+    printf("%s: %d items\n", filename, def->count);
+    return 0;
+}
+
+static void bench_free_corpus(struct bench_corpus *corpus) {
+    int i;
+
+    for (i = 0; i < corpus->count; i++) {
+        free(corpus->items[i].data);
+    }
+    free(corpus->items);
+    corpus->items = NULL;
+    corpus->count = 0;
+}
+
+/* Reads corpus of definition `def` from `dir`, returning 0 on success */
+static int bench_read_corpus(const struct bench_corpus_def *def, const char *dir, struct bench_corpus *corpus) {
+    char filename[1024];
+    char line[BENCH_ITEM_MAX + 256];
+    struct zint_symbol *symbol;
+    int items = 0, size = 0;
+    int primary = 0;
+    FILE *fp;
+
+    if (strlen(dir) + strlen(def->name) + 6 > sizeof(filename)) {
+        return 1;
+    }
+    sprintf(filename, "%s/%s.txt", dir, def->name);
+    if (!(fp = fopen(filename, "r"))) {
+        return 1;
+    }
+    if (!(symbol = ZBarcode_Create())) {
+        fprintf(stderr, "zint_bench: out of memory\n");
+        exit(1);
+    }
+    corpus->items = NULL;
+    corpus->count = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        char *value;
+        size_t len = strlen(line);
+        while (len && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+            line[--len] = '\0';
+        }
+        if (items) {
+            struct bench_item *item;
+            char *data = line;
+            if (corpus->count == size) {
+                size = size ? size * 2 : 128;
+                if (!(item = (struct bench_item *) realloc(corpus->items, size * sizeof(corpus->items[0])))) {
+                    fprintf(stderr, "zint_bench: out of memory\n");
+                    exit(1);
+                }
+                corpus->items = item;
+            }
+            item = &corpus->items[corpus->count];
+            item->primary[0] = '\0';
+            if (primary) {
+                char *tab = strchr(line, '\t');
+                if (!tab || tab - line >= (int) sizeof(item->primary)) {
+                    fprintf(stderr, "zint_bench: \"%s\" item %d has no primary\n", filename, corpus->count);
+                    continue;
+                }
+                memcpy(item->primary, line, tab - line);
+                item->primary[tab - line] = '\0';
+                data = tab + 1;
+            }
+            item->length = (int) strlen(data);
+            if (!(item->data = (unsigned char *) malloc(item->length + 1))) {
+                fprintf(stderr, "zint_bench: out of memory\n");
+                exit(1);
+            }
+            memcpy(item->data, data, item->length + 1);
+            corpus->count++;
+        } else if (line[0] == '#' || line[0] == '\0') {
+            continue;
+        } else if (strcmp(line, "---") == 0) {
+            items = 1;
+        } else if (!(value = strchr(line, '='))) {
+            fprintf(stderr, "zint_bench: \"%s\" invalid line \"%s\"\n", filename, line);
+        } else {
+            *value++ = '\0';
+            if (strcmp(line, "symbology") == 0) {
+                symbol->symbology = bench_symbology_id(value);
+            } else if (strcmp(line, "input_mode") == 0) {
+                char *mode = strtok(value, "|");
+                symbol->input_mode = DATA_MODE;
+                while (mode) {
+                    int i;
+                    for (i = 0; i < (int) ARRAY_SIZE(bench_mode_names)
+                            && strcmp(bench_mode_names[i].name, mode) != 0; i++);
+                    if (i < (int) ARRAY_SIZE(bench_mode_names)) {
+                        symbol->input_mode |= bench_mode_names[i].mode;
+                    } else if (strcmp(mode, "DATA_MODE") != 0) {
+                        fprintf(stderr, "zint_bench: \"%s\" invalid input mode \"%s\"\n", filename, mode);
+                    }
+                    mode = strtok(NULL, "|");
+                }
+            } else if (strcmp(line, "option_1") == 0) {
+                symbol->option_1 = atoi(value);
+            } else if (strcmp(line, "option_2") == 0) {
+                symbol->option_2 = atoi(value);
+            } else if (strcmp(line, "option_3") == 0) {
+                symbol->option_3 = atoi(value);
+            } else if (strcmp(line, "eci") == 0) {
+                symbol->eci = atoi(value);
+            } else if (strcmp(line, "primary") == 0) {
+                primary = atoi(value);
+            } else {
+                fprintf(stderr, "zint_bench: \"%s\" unknown setting \"%s\"\n", filename, line);
+            }
+        }
+    }
+    fclose(fp);
+
+    bench_settings_save(symbol, &corpus->settings);
+    ZBarcode_Delete(symbol);
+
+    if (!corpus->settings.symbology || corpus->count == 0) {
+        fprintf(stderr, "zint_bench: \"%s\" has no symbology or no items\n", filename);
+        bench_free_corpus(corpus);
+        return 1;
+    }
+    return 0;
+}
+
+/* Generates all corpora into `dir`, returning 0 on success */
+static int bench_generate(const char *dir) {
+    int i;
+
+    for (i = 0; i < (int) ARRAY_SIZE(bench_corpora); i++) {
+        if (bench_generate_corpus(&bench_corpora[i], dir) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Benchmarks all (or the selected) phases of corpus `idx`, each operation taking the next item */
+static void bench_corpus(int idx, const struct bench_opts *opts, struct bench_results *res) {
+    const struct bench_corpus_def *def = &bench_corpora[idx];
+    struct bench_corpus corpus;
+    struct zint_symbol *symbol;
+    struct bench b;
+    int i;
+
+    if (bench_read_corpus(def, opts->corpus_dir, &corpus) != 0) {
+        if (!opts->csv) {
+            printf("%-28s %-14s no corpus in \"%s\" (see -g)\n", testUtilBarcodeName(def->symbology), def->name,
+                    opts->corpus_dir);
+        }
+        return;
+    }
+    b.settings = corpus.settings;
+    b.items = corpus.items;
+    b.item_count = corpus.count;
+    b.symbol = symbol = bench_corpus_symbol(&corpus.settings);
+    if (!(b.symbols = (struct zint_symbol **) malloc(corpus.count * sizeof(b.symbols[0])))) {
+        fprintf(stderr, "zint_bench: out of memory\n");
+        exit(1);
+    }
+    for (i = 0; i < corpus.count; i++) {
+        b.symbols[i] = bench_corpus_symbol(&corpus.settings);
+        strcpy(b.symbols[i]->primary, corpus.items[i].primary);
+        if (ZBarcode_Encode(b.symbols[i], corpus.items[i].data, corpus.items[i].length) >= ZINT_ERROR) {
+            if (!opts->csv) {
+                printf("%-28s %-14s item %d skipped: %s\n", testUtilBarcodeName(corpus.settings.symbology),
+                        def->name, i, b.symbols[i]->errtxt);
+            }
+            ZBarcode_Delete(b.symbols[i]);
+            free(corpus.items[i].data);
+            memmove(corpus.items + i, corpus.items + i + 1, (corpus.count - i - 1) * sizeof(corpus.items[0]));
+            corpus.count--;
+            b.item_count--;
+            i--;
+        }
+    }
+
+    if (b.item_count) {
+        for (b.phase = 0; b.phase < (int) ARRAY_SIZE(phase_names); b.phase++) {
+            if (opts->phase != -1 && b.phase != opts->phase) {
+                continue;
+            }
+            if (b.phase == PHASE_ENCODE) {
+                b.symbol = symbol;
+            } else if (b.phase >= PHASE_WRITER) {
+                for (i = 0; i < b.item_count; i++) {
+                    sprintf(b.symbols[i]->outfile, "out.%s", phase_names[b.phase]);
+                    b.symbols[i]->output_options |= BARCODE_MEMORY_FILE;
+                }
+            }
+            b.item = 0;
+            bench_phase(&b, def->name, opts, res);
+        }
+    }
+
+    for (i = 0; i < b.item_count; i++) {
+        ZBarcode_Delete(b.symbols[i]);
+    }
+    free(b.symbols);
+    ZBarcode_Delete(symbol);
+    bench_free_corpus(&corpus);
+}
+
+/* Benchmarks all (or the selected) phases of a symbology with the built-in samples (or user data) */
+static void bench_samples(int symbology, const struct bench_opts *opts, struct bench_results *res) {
+    const int samples_size = opts->data ? 1 : (int) ARRAY_SIZE(samples);
+    unsigned char large[BENCH_LARGE_MAX + 1];
+    int lengths[2];
+    struct bench b;
+    int input_class;
+    int i;
+
+    /* Find data which encodes */
+    for (i = 0; i < samples_size; i++) {
+        bench_setup(&b, symbology, opts, i);
+        if (ZBarcode_Encode(b.symbol, b.data, b.length) < ZINT_ERROR) {
+            break;
+        }
+        ZBarcode_Delete(b.symbol);
+    }
+    if (i == samples_size) {
+        if (!opts->csv) {
+            printf("%-28s no sample data\n", testUtilBarcodeName(symbology));
+        }
+        return;
+    }
+    lengths[0] = b.length;
+    lengths[1] = opts->input_class != 0 ? bench_large(&b, large) : 0;
+
+    for (input_class = 0; input_class < 2; input_class++) {
+        if (opts->input_class != -1 && input_class != opts->input_class) {
+            continue;
+        }
+        if (lengths[input_class] == 0) {
+            if (!opts->csv) {
+                printf("%-28s %-14s no input\n", testUtilBarcodeName(symbology), input_class_names[input_class]);
+            }
+            continue;
+        }
+        if (input_class == 1) {
+            memcpy(large, b.data, b.length);
+            b.data = large;
+            b.length = lengths[1];
+        }
+        for (b.phase = 0; b.phase < (int) ARRAY_SIZE(phase_names); b.phase++) {
+            if (opts->phase != -1 && b.phase != opts->phase) {
+                continue;
+            }
+            /* Encoded symbol for the output phases */
+            (void) bench_encode(&b);
+            if (b.phase >= PHASE_WRITER) {
+                sprintf(b.symbol->outfile, "out.%s", phase_names[b.phase]);
+                b.symbol->output_options |= BARCODE_MEMORY_FILE;
+            }
+            bench_phase(&b, input_class_names[input_class], opts, res);
+        }
+    }
+
+    ZBarcode_Delete(b.symbol);
+}
+
+/* Benchmarks a symbology with the selected (or all) input classes */
+static void bench_symbology(int symbology, const struct bench_opts *opts, struct bench_results *res) {
+    int i;
+
+    if (opts->input_class < 2) {
+        bench_samples(symbology, opts, res);
+    }
+    if (opts->data) {
+        return;
+    }
+    for (i = 0; i < (int) ARRAY_SIZE(bench_corpora); i++) {
+        if (bench_corpora[i].symbology == symbology && (opts->input_class == -1 || opts->input_class == 2 + i)) {
+            bench_corpus(i, opts, res);
+        }
+    }
+}
+
+static void usage(void) {
+    int i;
+
+    printf("Usage: zint_bench [-b symbology] [-p phase] [-i class] [-d data] [-C dir] [-r reps] [-w warmups] [-t ms]\n"
+           "                  [-c] [-o file] [-B baseline] [-s percent] [-a percent]\n"
+           "       zint_bench -g [-C dir]\n"
+           "  -b symbology  Only this symbology, number or name (e.g. 58 or QRCODE)\n"
+           "  -p phase      Only this phase: encode, buffer, vector or writer file type (e.g. png)\n"
+           "  -i class      Only this input class: small (sample data), large (repeated sample data) or a corpus\n"
+           "  -d data       Data to encode instead of built-in samples and corpora\n"
+           "  -C dir        Corpora directory (default \"../data/bench\")\n"
+           "  -g            Generate corpora into corpora directory and exit\n"
+           "  -r reps       Timed repetitions (default 7)\n"
+           "  -w warmups    Untimed warm-up repetitions (default 2)\n"
+           "  -t ms         Target milliseconds per repetition (default 5)\n"
+           "  -c            CSV results to stdout instead of table\n"
+           "  -o file       Write results to file, as JSON if it ends \".json\", else CSV\n"
+           "  -B baseline   Compare with results file, exit status 2 if any regressions\n"
+           "  -s percent    Median slowdown over baseline counted as regression (default 10)\n"
+           "  -a percent    Allocations increase over baseline counted as regression (default 0)\n"
+           "Reports ns per operation (median and 99th percentile of repetitions), MB/s of input (encode), bitmap\n"
+           "(buffer) or file (writers, vector 0), and library allocations and bytes allocated per operation.\n"
+           "Writers print to memory. Corpus operations cycle through the corpus items, averaging MB/s and allocations.\n"
+           "Corpora:\n");
+    for (i = 0; i < (int) ARRAY_SIZE(bench_corpora); i++) {
+        printf("  %-14s %s (%d items)\n", bench_corpora[i].name, bench_corpora[i].description,
+                bench_corpora[i].count);
+    }
+}
+
+/* Positive int option value, -1 if invalid */
+static int bench_int_arg(const char *arg, int max) {
+    char *endptr = NULL;
+    long val;
+
+    errno = 0;
+    val = strtol(arg, &endptr, 10);
+    if (errno || endptr == arg || *endptr != '\0' || val < 0 || val > max) {
+        return -1;
+    }
+    return (int) val;
+}
+
+int main(int argc, char *argv[]) {
+    struct bench_opts opts;
+    struct bench_results res;
+    const char *outfile = NULL;
+    const char *baseline_file = NULL;
+    double max_slowdown = 0.1, max_allocs_increase = 0.0;
+    int opt, val;
+    int generate = 0;
+    int ret = 0;
+    int i;
+
+    opts.symbology = 0;
+    opts.phase = -1;
+    opts.input_class = -1;
+    opts.warmups = 2;
+    opts.reps = 7;
+    opts.target_ns = 5e6;
+    opts.data = NULL;
+    opts.csv = 0;
+    opts.corpus_dir = "../data/bench";
+
+    res.results = NULL;
+    res.count = res.size = 0;
+
+    while ((opt = getopt(argc, argv, "b:p:i:d:C:gr:w:t:co:B:s:a:h")) != -1) {
+        switch (opt) {
+            case 'b':
+                if (!(opts.symbology = bench_symbology_id(optarg))) {
+                    fprintf(stderr, "zint_bench: -b symbology invalid\n");
+                    return 1;
+                }
+                break;
+            case 'p':
+                for (i = 0; i < (int) ARRAY_SIZE(phase_names) && strcasecmp(phase_names[i], optarg) != 0; i++);
+                if (i == (int) ARRAY_SIZE(phase_names)) {
+                    fprintf(stderr, "zint_bench: -p phase invalid\n");
+                    return 1;
+                }
+                opts.phase = i;
+                break;
+            case 'i':
+                for (i = 0; i < 2 && strcasecmp(input_class_names[i], optarg) != 0; i++);
+                if (i == 2) {
+                    for (i = 0; i < (int) ARRAY_SIZE(bench_corpora) && strcasecmp(bench_corpora[i].name, optarg) != 0;
+                            i++);
+                    if (i == (int) ARRAY_SIZE(bench_corpora)) {
+                        fprintf(stderr, "zint_bench: -i class invalid\n");
+                        return 1;
+                    }
+                    i += 2;
+                }
+                opts.input_class = i;
+                break;
+            case 'd':
+                opts.data = optarg;
+                break;
+            case 'C':
+                opts.corpus_dir = optarg;
+                break;
+            case 'g':
+                generate = 1;
+                break;
+            case 'r':
+                if ((val = bench_int_arg(optarg, BENCH_MAX_REPS)) < 1) {
+                    fprintf(stderr, "zint_bench: -r reps invalid (1 to %d)\n", BENCH_MAX_REPS);
+                    return 1;
+                }
+                opts.reps = val;
+                break;
+            case 'w':
+                if ((val = bench_int_arg(optarg, BENCH_MAX_REPS)) < 0) {
+                    fprintf(stderr, "zint_bench: -w warmups invalid (0 to %d)\n", BENCH_MAX_REPS);
+                    return 1;
+                }
+                opts.warmups = val;
+                break;
+            case 't':
+                if ((val = bench_int_arg(optarg, 60000)) < 1) {
+                    fprintf(stderr, "zint_bench: -t ms invalid (1 to 60000)\n");
+                    return 1;
+                }
+                opts.target_ns = val * 1e6;
+                break;
+            case 'c':
+                opts.csv = 1;
+                break;
+            case 'o':
+                outfile = optarg;
+                break;
+            case 'B':
+                baseline_file = optarg;
+                break;
+            case 's':
+            case 'a':
+                if ((val = bench_int_arg(optarg, 10000)) < 0) {
+                    fprintf(stderr, "zint_bench: -%c percent invalid (0 to 10000)\n", opt);
+                    return 1;
+                }
+                if (opt == 's') {
+                    max_slowdown = val / 100.0;
+                } else {
+                    max_allocs_increase = val / 100.0;
+                }
+                break;
+            default:
+                usage();
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (generate) {
+        return bench_generate(opts.corpus_dir);
+    }
+
+    if (!opts.csv) {
+        printf("%-28s %-14s %-7s %12s %12s %9s %9s %11s\n",
+                "symbology", "class", "phase", "ns/op", "p99 ns/op", "MB/s", "allocs/op", "bytes/op");
+    }
+
+    for (i = 1; i < 256; i++) {
+        if ((opts.symbology && i != opts.symbology) || !ZBarcode_ValidID(i)) {
+            continue;
+        }
+        bench_symbology(i, &opts, &res);
+    }
+
+    if (opts.csv && testBenchWrite("-", TEST_BENCH_CSV, res.results, res.count) != 0) {
+        ret = 1;
+    }
+    if (outfile) {
+        const size_t len = strlen(outfile);
+        const int format = len > 5 && strcasecmp(outfile + len - 5, ".json") == 0 ? TEST_BENCH_JSON : TEST_BENCH_CSV;
+        if (testBenchWrite(outfile, format, res.results, res.count) != 0) {
+            ret = 1;
+        }
+    }
+    if (baseline_file && ret == 0) {
+        struct testBenchResult *baseline;
+        int baseline_count;
+        if (testBenchRead(baseline_file, &baseline, &baseline_count) != 0) {
+            ret = 1;
+        } else {
+            const int regressions = testBenchCompare(res.results, res.count, baseline, baseline_count,
+                                                    max_slowdown, max_allocs_increase, stderr);
+            if (regressions) {
+                fprintf(stderr, "zint_bench: %d regression%s against \"%s\"\n", regressions,
+                        regressions == 1 ? "" : "s", baseline_file);
+                ret = 2;
+            }
+            free(baseline);
+        }
+    }
+
+    free(res.results);
+
+    return ret;
+}
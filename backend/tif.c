@@ -37,11 +37,13 @@
 #include <assert.h>
 #include <limits.h>
 #include "common.h"
+#include "filemem.h"
+#include "output.h"
+#include "raster.h"
 #include "tif.h"
 #include "tif_lzw.h"
+#include "zfiletypes.h"
 #ifdef _MSC_VER
-#include <io.h>
-#include <fcntl.h>
 #include <malloc.h>
 #endif
 
@@ -54,7 +56,9 @@
 
 /* Compression */
 #define TIF_NO_COMPRESSION      1
+#define TIF_CCITT_G4            4
 #define TIF_LZW                 5
+#define TIF_PACKBITS            32773
 
 static void to_color_map(unsigned char rgb[4], tiff_color_t *color_map_entry) {
     color_map_entry->red = (rgb[0] << 8) | rgb[0];
@@ -62,7 +66,7 @@ static void to_color_map(unsigned char rgb[4], tiff_color_t *color_map_entry) {
     color_map_entry->blue = (rgb[2] << 8) | rgb[2];
 }
 
-static void to_cmyk(unsigned char rgb[3], unsigned char alpha, unsigned char *cmyk) {
+static void to_cmyk(const unsigned char rgb[3], unsigned char alpha, unsigned char *cmyk) {
     unsigned char max = rgb[0];
     if (rgb[1] > max) {
         max = rgb[1];
@@ -78,72 +82,275 @@ static void to_cmyk(unsigned char rgb[3], unsigned char alpha, unsigned char *cm
 
 }
 
+/* PackBits (TIFF Rev 6 Section 9) a row of `length` bytes, replicating runs of 3 or more */
+static void tif_packbits(struct filemem *fmp, const unsigned char *row, const int length) {
+    int i = 0;
+
+    while (i < length) {
+        int run = 1;
+        while (i + run < length && run < 128 && row[i + run] == row[i]) {
+            run++;
+        }
+        if (run >= 3) {
+            fm_putc(257 - run, fmp); /* -(run - 1) */
+            fm_putc(row[i], fmp);
+            i += run;
+        } else {
+            const int start = i;
+            /* Extend literal until the next run of 3 or more */
+            while (i < length && i - start < 128
+                    && !(i + 2 < length && row[i] == row[i + 1] && row[i] == row[i + 2])) {
+                i++;
+            }
+            fm_putc(i - start - 1, fmp);
+            fm_write(row + start, 1, i - start, fmp);
+        }
+    }
+}
+
+/* CCITT T.4 run length codes, terminating 0-63, make-up 64-1728, then extended make-up 1792-2560 (both colours)
+   { length, code } */
+static const unsigned short tif_g4_white_codes[104][2] = {
+    {  8, 0x035 }, {  6, 0x007 }, {  4, 0x007 }, {  4, 0x008 }, {  4, 0x00B }, {  4, 0x00C },
+    {  4, 0x00E }, {  4, 0x00F }, {  5, 0x013 }, {  5, 0x014 }, {  5, 0x007 }, {  5, 0x008 },
+    {  6, 0x008 }, {  6, 0x003 }, {  6, 0x034 }, {  6, 0x035 }, {  6, 0x02A }, {  6, 0x02B },
+    {  7, 0x027 }, {  7, 0x00C }, {  7, 0x008 }, {  7, 0x017 }, {  7, 0x003 }, {  7, 0x004 },
+    {  7, 0x028 }, {  7, 0x02B }, {  7, 0x013 }, {  7, 0x024 }, {  7, 0x018 }, {  8, 0x002 },
+    {  8, 0x003 }, {  8, 0x01A }, {  8, 0x01B }, {  8, 0x012 }, {  8, 0x013 }, {  8, 0x014 },
+    {  8, 0x015 }, {  8, 0x016 }, {  8, 0x017 }, {  8, 0x028 }, {  8, 0x029 }, {  8, 0x02A },
+    {  8, 0x02B }, {  8, 0x02C }, {  8, 0x02D }, {  8, 0x004 }, {  8, 0x005 }, {  8, 0x00A },
+    {  8, 0x00B }, {  8, 0x052 }, {  8, 0x053 }, {  8, 0x054 }, {  8, 0x055 }, {  8, 0x024 },
+    {  8, 0x025 }, {  8, 0x058 }, {  8, 0x059 }, {  8, 0x05A }, {  8, 0x05B }, {  8, 0x04A },
+    {  8, 0x04B }, {  8, 0x032 }, {  8, 0x033 }, {  8, 0x034 }, {  5, 0x01B }, {  5, 0x012 },
+    {  6, 0x017 }, {  7, 0x037 }, {  8, 0x036 }, {  8, 0x037 }, {  8, 0x064 }, {  8, 0x065 },
+    {  8, 0x068 }, {  8, 0x067 }, {  9, 0x0CC }, {  9, 0x0CD }, {  9, 0x0D2 }, {  9, 0x0D3 },
+    {  9, 0x0D4 }, {  9, 0x0D5 }, {  9, 0x0D6 }, {  9, 0x0D7 }, {  9, 0x0D8 }, {  9, 0x0D9 },
+    {  9, 0x0DA }, {  9, 0x0DB }, {  9, 0x098 }, {  9, 0x099 }, {  9, 0x09A }, {  6, 0x018 },
+    {  9, 0x09B }, { 11, 0x008 }, { 11, 0x00C }, { 11, 0x00D }, { 12, 0x012 }, { 12, 0x013 },
+    { 12, 0x014 }, { 12, 0x015 }, { 12, 0x016 }, { 12, 0x017 }, { 12, 0x01C }, { 12, 0x01D },
+    { 12, 0x01E }, { 12, 0x01F },
+};
+
+static const unsigned short tif_g4_black_codes[104][2] = {
+    { 10, 0x037 }, {  3, 0x002 }, {  2, 0x003 }, {  2, 0x002 }, {  3, 0x003 }, {  4, 0x003 },
+    {  4, 0x002 }, {  5, 0x003 }, {  6, 0x005 }, {  6, 0x004 }, {  7, 0x004 }, {  7, 0x005 },
+    {  7, 0x007 }, {  8, 0x004 }, {  8, 0x007 }, {  9, 0x018 }, { 10, 0x017 }, { 10, 0x018 },
+    { 10, 0x008 }, { 11, 0x067 }, { 11, 0x068 }, { 11, 0x06C }, { 11, 0x037 }, { 11, 0x028 },
+    { 11, 0x017 }, { 11, 0x018 }, { 12, 0x0CA }, { 12, 0x0CB }, { 12, 0x0CC }, { 12, 0x0CD },
+    { 12, 0x068 }, { 12, 0x069 }, { 12, 0x06A }, { 12, 0x06B }, { 12, 0x0D2 }, { 12, 0x0D3 },
+    { 12, 0x0D4 }, { 12, 0x0D5 }, { 12, 0x0D6 }, { 12, 0x0D7 }, { 12, 0x06C }, { 12, 0x06D },
+    { 12, 0x0DA }, { 12, 0x0DB }, { 12, 0x054 }, { 12, 0x055 }, { 12, 0x056 }, { 12, 0x057 },
+    { 12, 0x064 }, { 12, 0x065 }, { 12, 0x052 }, { 12, 0x053 }, { 12, 0x024 }, { 12, 0x037 },
+    { 12, 0x038 }, { 12, 0x027 }, { 12, 0x028 }, { 12, 0x058 }, { 12, 0x059 }, { 12, 0x02B },
+    { 12, 0x02C }, { 12, 0x05A }, { 12, 0x066 }, { 12, 0x067 }, { 10, 0x00F }, { 12, 0x0C8 },
+    { 12, 0x0C9 }, { 12, 0x05B }, { 12, 0x033 }, { 12, 0x034 }, { 12, 0x035 }, { 13, 0x06C },
+    { 13, 0x06D }, { 13, 0x04A }, { 13, 0x04B }, { 13, 0x04C }, { 13, 0x04D }, { 13, 0x072 },
+    { 13, 0x073 }, { 13, 0x074 }, { 13, 0x075 }, { 13, 0x076 }, { 13, 0x077 }, { 13, 0x052 },
+    { 13, 0x053 }, { 13, 0x054 }, { 13, 0x055 }, { 13, 0x05A }, { 13, 0x05B }, { 13, 0x064 },
+    { 13, 0x065 }, { 11, 0x008 }, { 11, 0x00C }, { 11, 0x00D }, { 12, 0x012 }, { 12, 0x013 },
+    { 12, 0x014 }, { 12, 0x015 }, { 12, 0x016 }, { 12, 0x017 }, { 12, 0x01C }, { 12, 0x01D },
+    { 12, 0x01E }, { 12, 0x01F },
+};
+
+/* Vertical mode codes indexed by `b1 - a1 + 3`, i.e. VR3, VR2, VR1, V0, VL1, VL2, VL3 */
+static const unsigned char tif_g4_vert_codes[7][2] = {
+    { 7, 0x03 }, { 6, 0x03 }, { 3, 0x03 }, { 1, 0x01 }, { 3, 0x02 }, { 6, 0x02 }, { 7, 0x02 },
+};
+
+/* Bit accumulator for CCITT G4, most significant bit first (FillOrder 1) */
+struct tif_g4_bits {
+    struct filemem *fmp;
+    unsigned int data;
+    int count;
+};
+
+static void tif_g4_put(struct tif_g4_bits *bp, const unsigned int code, const int length) {
+    bp->data = (bp->data << length) | code;
+    bp->count += length;
+    while (bp->count >= 8) {
+        bp->count -= 8;
+        fm_putc((bp->data >> bp->count) & 0xff, bp->fmp);
+    }
+    bp->data &= (1 << bp->count) - 1;
+}
+
+/* Output run length `run` using make-up code(s) if necessary followed by terminating code */
+static void tif_g4_put_run(struct tif_g4_bits *bp, const unsigned short (*codes)[2], int run) {
+    while (run >= 2624) { /* 2560 + 64 */
+        tif_g4_put(bp, codes[103][1], codes[103][0]);
+        run -= 2560;
+    }
+    if (run >= 64) {
+        tif_g4_put(bp, codes[63 + run / 64][1], codes[63 + run / 64][0]);
+        run &= 63;
+    }
+    tif_g4_put(bp, codes[run][1], codes[run][0]);
+}
+
+/* Colour (0 white, 1 black) of pixel `x` of `row`, which if NULL is the imaginary all-white reference line */
+#define TIF_G4_PIXEL(row, x) ((row) ? map[(row)[x]] : 0)
+
+/* Position of first pixel at or after `x` that isn't `colour`, or `width` if none */
+static int tif_g4_find_diff(const unsigned char *row, const unsigned char map[128], int x, const int width,
+            const int colour) {
+    if (!row) {
+        return colour ? x : width;
+    }
+    while (x < width && map[row[x]] == colour) {
+        x++;
+    }
+    return x;
+}
+
+/* Position of next changing element after pixel `x` (which may be `width`) */
+static int tif_g4_next_change(const unsigned char *row, const unsigned char map[128], const int x,
+            const int width) {
+    return x < width ? tif_g4_find_diff(row, map, x, width, TIF_G4_PIXEL(row, x)) : width;
+}
+
+/* Encode `row` against reference line `ref` using CCITT T.6 2-dimensional coding (as libtiff `Fax3Encode2DRow()`)
+   where pixels are mapped to colours by `map` */
+static void tif_g4_row(struct tif_g4_bits *bp, const unsigned char *row, const unsigned char *ref,
+            const unsigned char map[128], const int width) {
+    int a0 = 0, a1, a2, b1, b2;
+
+    a1 = TIF_G4_PIXEL(row, 0) ? 0 : tif_g4_find_diff(row, map, 0, width, 0);
+    b1 = TIF_G4_PIXEL(ref, 0) ? 0 : tif_g4_find_diff(ref, map, 0, width, 0);
+
+    for (;;) {
+        b2 = tif_g4_next_change(ref, map, b1, width);
+        if (b2 >= a1) {
+            const int d = b1 - a1;
+            if (d < -3 || d > 3) { /* Horizontal mode */
+                a2 = tif_g4_next_change(row, map, a1, width);
+                tif_g4_put(bp, 0x01, 3); /* 001 */
+                if (a0 + a1 == 0 || TIF_G4_PIXEL(row, a0) == 0) {
+                    tif_g4_put_run(bp, tif_g4_white_codes, a1 - a0);
+                    tif_g4_put_run(bp, tif_g4_black_codes, a2 - a1);
+                } else {
+                    tif_g4_put_run(bp, tif_g4_black_codes, a1 - a0);
+                    tif_g4_put_run(bp, tif_g4_white_codes, a2 - a1);
+                }
+                a0 = a2;
+            } else { /* Vertical mode */
+                tif_g4_put(bp, tif_g4_vert_codes[d + 3][1], tif_g4_vert_codes[d + 3][0]);
+                a0 = a1;
+            }
+        } else { /* Pass mode */
+            tif_g4_put(bp, 0x01, 4); /* 0001 */
+            a0 = b2;
+        }
+        if (a0 >= width) {
+            break;
+        }
+        a1 = tif_g4_find_diff(row, map, a0, width, TIF_G4_PIXEL(row, a0));
+        b1 = tif_g4_find_diff(ref, map, a0, width, !TIF_G4_PIXEL(row, a0));
+        b1 = tif_g4_find_diff(ref, map, b1, width, TIF_G4_PIXEL(row, a0));
+    }
+}
+
+/* End of facsimile block (2 EOLs), padded to byte boundary */
+static void tif_g4_eofb(struct tif_g4_bits *bp) {
+    tif_g4_put(bp, 0x001, 12);
+    tif_g4_put(bp, 0x001, 12);
+    if (bp->count) {
+        tif_g4_put(bp, 0, 8 - bp->count);
+    }
+}
+
 static int is_big_endian() {
     return (*((const uint16_t *)"\x11\x22") == 0x1122);
 }
 
-INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+/* A page (image) of a TIFF, with its strips compressed in memory, ready for `tif_make_ifd()` */
+struct tif_page {
+    int width;
+    int height;
+    int pmi; /* PhotometricInterpretation */
+    int compression;
+    uint16_t bits_per_sample;
+    int samples_per_pixel;
+    int extra_samples;
+    int rows_per_strip;
+    int strip_count;
+    uint32_t *strip_offset; /* Relative to `strips_pos` */
+    uint32_t *strip_bytes;
+    struct filemem strips_fm; /* Compressed strips */
+    long strips_pos; /* Offset of strips in file, once written */
+    tiff_color_t color_map[256];
+    int color_map_size;
+};
+
+/* An Image File Directory, made by `tif_make_ifd()` */
+struct tif_ifd {
+    uint16_t entries;
+    tiff_tag_t tags[20];
+    uint32_t size; /* Including the values that don't fit in the tags, which follow it */
+};
+
+/* Free the buffers of `page`, allocated with the allocator of its symbol (kept in `strips_fm`) */
+static void tif_page_free(struct tif_page *page) {
+    const struct zint_allocator *allocator = page->strips_fm.allocator;
+
+    z_free(allocator, page->strips_fm.mem);
+    z_free(allocator, page->strip_offset);
+    z_free(allocator, page->strip_bytes);
+    page->strips_fm.mem = NULL;
+    page->strip_offset = page->strip_bytes = NULL;
+}
+
+/* Return size of `page`'s strips in file, padded to a word boundary */
+static long tif_strips_size(const struct tif_page *page) {
+    return ((long) page->strips_fm.memend + 1) & ~1L;
+}
+
+/* Set up `page` for the image `rows` of `symbol`, compressing its strips into memory */
+static int tif_page_strips(struct zint_symbol *symbol, struct raster_rows *rows, struct tif_page *page) {
     unsigned char fg[4], bg[4];
     int i;
     int pmi; /* PhotometricInterpretation */
     int rows_per_strip, strip_count;
     int rows_last_strip;
-    int bytes_per_strip;
+    int bytes_per_strip, bytes_per_row;
     uint16_t bits_per_sample;
     int samples_per_pixel;
     int pixels_per_sample;
     unsigned char map[128];
-    tiff_color_t color_map[256] = {0};
+    tiff_color_t *const color_map = page->color_map;
     unsigned char palette[32][5];
     int color_map_size = 0;
     int extra_samples = 0;
-    uint32_t free_memory;
     int row, column, strip;
     int strip_row;
     unsigned int bytes_put;
-    long total_bytes_put;
-    FILE *tif_file;
-    unsigned char *pb;
-    int compression = TIF_NO_COMPRESSION;
+    struct filemem *const sfmp = &page->strips_fm; /* Compressed strips, buffered in memory */
+    const unsigned char *pb, *prev = NULL;
+    int compression;
     tif_lzw_state lzw_state;
+    struct tif_g4_bits g4_bits;
     long file_pos;
+    uint32_t *strip_offset;
+    uint32_t *strip_bytes;
 #ifdef _MSC_VER
-    uint32_t* strip_offset;
-    uint32_t* strip_bytes;
     unsigned char *strip_buf;
 #endif
 
-    tiff_header_t header;
-    uint16_t entries = 0;
-    tiff_tag_t tags[20];
-    uint32_t offset = 0;
-    int update_offsets[20];
-    int offsets = 0;
-    int ifd_size;
-    uint32_t temp32;
-
-    fg[0] = (16 * ctoi(symbol->fgcolour[0])) + ctoi(symbol->fgcolour[1]);
-    fg[1] = (16 * ctoi(symbol->fgcolour[2])) + ctoi(symbol->fgcolour[3]);
-    fg[2] = (16 * ctoi(symbol->fgcolour[4])) + ctoi(symbol->fgcolour[5]);
-    bg[0] = (16 * ctoi(symbol->bgcolour[0])) + ctoi(symbol->bgcolour[1]);
-    bg[1] = (16 * ctoi(symbol->bgcolour[2])) + ctoi(symbol->bgcolour[3]);
-    bg[2] = (16 * ctoi(symbol->bgcolour[4])) + ctoi(symbol->bgcolour[5]);
+    memset(page, 0, sizeof(*page));
+    sfmp->allocator = z_allocator(symbol);
 
-    if (strlen(symbol->fgcolour) > 6) {
-        fg[3] = (16 * ctoi(symbol->fgcolour[6])) + ctoi(symbol->fgcolour[7]);
-    } else {
-        fg[3] = 0xff;
-    }
+    fg[0] = OUT_RED(symbol->fgcolour_rgba);
+    fg[1] = OUT_GREEN(symbol->fgcolour_rgba);
+    fg[2] = OUT_BLUE(symbol->fgcolour_rgba);
+    bg[0] = OUT_RED(symbol->bgcolour_rgba);
+    bg[1] = OUT_GREEN(symbol->bgcolour_rgba);
+    bg[2] = OUT_BLUE(symbol->bgcolour_rgba);
 
-    if (strlen(symbol->bgcolour) > 6) {
-        bg[3] = (16 * ctoi(symbol->bgcolour[6])) + ctoi(symbol->bgcolour[7]);
-    } else {
-        bg[3] = 0xff;
-    }
+    fg[3] = OUT_ALPHA(symbol->fgcolour_rgba);
+    bg[3] = OUT_ALPHA(symbol->bgcolour_rgba);
 
     if (symbol->symbology == BARCODE_ULTRA) {
         static const int ultra_chars[8] = { 'W', 'C', 'B', 'M', 'R', 'Y', 'G', 'K' };
-        static unsigned char ultra_rgbs[8][3] = {
+        static const unsigned char ultra_rgbs[8][3] = {
             { 0xff, 0xff, 0xff, }, /* White */
             {    0, 0xff, 0xff, }, /* Cyan */
             {    0,    0, 0xff, }, /* Blue */
@@ -260,6 +467,14 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         }
     }
 
+    if ((symbol->output_options & TIFF_CCITT_G4) && samples_per_pixel == 1 && bits_per_sample == 1) {
+        compression = TIF_CCITT_G4;
+    } else if (symbol->output_options & TIFF_PACKBITS) {
+        compression = TIF_PACKBITS;
+    } else {
+        compression = TIF_LZW;
+    }
+
     /* TIFF Rev 6 Section 7 p.27 "Set RowsPerStrip such that the size of each strip is about 8K bytes...
      * Note that extremely wide high resolution images may have rows larger than 8K bytes; in this case,
      * RowsPerStrip should be 1, and the strip will be larger than 8K." */
@@ -287,85 +502,51 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     assert(strip_count > 0); /* Suppress clang-analyzer-core.UndefinedBinaryOperatorResult */
 
     if (symbol->debug & ZINT_DEBUG_PRINT) {
-        printf("TIFF (%dx%d) Strip Count %d, Rows Per Strip %d, Pixels Per Sample %d, Samples Per Pixel %d, PMI %d\n",
-            symbol->bitmap_width, symbol->bitmap_height, strip_count, rows_per_strip, pixels_per_sample,
-            samples_per_pixel, pmi);
+        printf("TIFF (%dx%d) Strip Count %d, Rows Per Strip %d, Pixels Per Sample %d, Samples Per Pixel %d, PMI %d,"
+                " Compression %d\n", symbol->bitmap_width, symbol->bitmap_height, strip_count, rows_per_strip,
+                pixels_per_sample, samples_per_pixel, pmi, compression);
     }
 
-    bytes_per_strip = rows_per_strip * ((symbol->bitmap_width + pixels_per_sample - 1) / pixels_per_sample)
-                        * samples_per_pixel;
+    bytes_per_row = ((symbol->bitmap_width + pixels_per_sample - 1) / pixels_per_sample) * samples_per_pixel;
+    bytes_per_strip = rows_per_strip * bytes_per_row;
 
+    page->strip_offset = strip_offset = (uint32_t *) z_malloc(sfmp->allocator, strip_count * sizeof(uint32_t));
+    page->strip_bytes = strip_bytes = (uint32_t *) z_malloc(sfmp->allocator, strip_count * sizeof(uint32_t));
+    if (!strip_offset || !strip_bytes) {
+        tif_page_free(page);
+        strcpy(symbol->errtxt, "677: Insufficient memory for TIF strip offsets");
+        return ZINT_ERROR_MEMORY;
+    }
 #ifndef _MSC_VER
-    uint32_t strip_offset[strip_count];
-    uint32_t strip_bytes[strip_count];
     unsigned char strip_buf[bytes_per_strip + 1];
 #else
-    strip_offset = (uint32_t *) _alloca(strip_count * sizeof(uint32_t));
-    strip_bytes = (uint32_t *) _alloca(strip_count * sizeof(uint32_t));
     strip_buf = (unsigned char *) _alloca(bytes_per_strip + 1);
 #endif
-    free_memory = sizeof(tiff_header_t);
 
-    for (i = 0; i < strip_count; i++) {
-        strip_offset[i] = free_memory;
-        if (i != (strip_count - 1)) {
-            strip_bytes[i] = bytes_per_strip;
-        } else {
-            if (rows_last_strip) {
-                strip_bytes[i] = rows_last_strip * ((symbol->bitmap_width + pixels_per_sample - 1) / pixels_per_sample)
-                                    * samples_per_pixel;
-            } else {
-                strip_bytes[i] = bytes_per_strip;
-            }
-        }
-        free_memory += strip_bytes[i];
-    }
-    if (free_memory & 1) {
-        free_memory++; // IFD must be on word boundary
-    }
-
-    if (free_memory > 0xffff0000) {
-        strcpy(symbol->errtxt, "670: Output file size too big");
-        return ZINT_ERROR_MEMORY;
-    }
-
-    /* Open output file in binary mode */
-    if (symbol->output_options & BARCODE_STDOUT) {
-#ifdef _MSC_VER
-        if (-1 == _setmode(_fileno(stdout), _O_BINARY)) {
-            strcpy(symbol->errtxt, "671: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-#endif
-        tif_file = stdout;
-    } else {
-        if (!(tif_file = fopen(symbol->outfile, "wb+"))) {
-            strcpy(symbol->errtxt, "672: Can't open output file");
-            return ZINT_ERROR_FILE_ACCESS;
-        }
-        compression = TIF_LZW;
-        tif_lzw_init(&lzw_state);
-    }
-
-    /* Header */
-    if (is_big_endian()) {
-        header.byte_order = 0x4D4D; // "MM" big-endian
-    } else {
-        header.byte_order = 0x4949; // "II" little-endian
+    /* Compress each strip independently into memory first, so that the IFD offset is known when the header (or
+       the previous page's IFD) is written and output never has to seek back (works for stdout and `write_func`
+       also) */
+    sfmp->flags = BARCODE_MEMORY_FILE;
+    if (compression == TIF_LZW) {
+        tif_lzw_init(&lzw_state, sfmp->allocator);
+    } else if (compression == TIF_CCITT_G4) {
+        g4_bits.fmp = sfmp;
+        g4_bits.data = 0;
+        g4_bits.count = 0;
     }
-    header.identity = 42;
-    header.offset = free_memory;
-
-    fwrite(&header, sizeof(tiff_header_t), 1, tif_file);
-    total_bytes_put = sizeof(tiff_header_t);
 
-    /* Pixel data */
-    pb = pixelbuf;
     strip = 0;
     strip_row = 0;
     bytes_put = 0;
+    strip_offset[0] = 0; /* Relative to `strips_pos` */
+    file_pos = 0; /* Start of strip in `strips_fm` */
     for (row = 0; row < symbol->bitmap_height; row++) {
-        if (samples_per_pixel == 1) {
+        pb = raster_rows_get(rows, row);
+        if (compression == TIF_CCITT_G4) {
+            /* Each strip is coded separately, starting with an imaginary all-white reference line */
+            tif_g4_row(&g4_bits, pb, strip_row ? prev : NULL, map, symbol->bitmap_width);
+            prev = pb;
+        } else if (samples_per_pixel == 1) {
             if (bits_per_sample == 1) { /* WHITEISZERO or BLACKISZERO */
                 for (column = 0; column < symbol->bitmap_width; column += 8) {
                     unsigned char byte = 0;
@@ -402,116 +583,138 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
         if (strip_row == rows_per_strip || (strip == strip_count - 1 && strip_row == rows_last_strip)) {
             // End of strip
             if (compression == TIF_LZW) {
-                file_pos = ftell(tif_file);
-                if (!tif_lzw_encode(&lzw_state, tif_file, strip_buf, bytes_put)) { /* Only fails if can't malloc */
+                if (!tif_lzw_encode(&lzw_state, sfmp, strip_buf, bytes_put)) { /* Only fails if can't malloc */
                     tif_lzw_cleanup(&lzw_state);
-                    fclose(tif_file); /* Only use LZW if not STDOUT, so ok to close */
+                    tif_page_free(page);
                     strcpy(symbol->errtxt, "673: Failed to malloc LZW hash table");
                     return ZINT_ERROR_MEMORY;
                 }
-                bytes_put = ftell(tif_file) - file_pos;
-                if (bytes_put != strip_bytes[strip]) {
-                    int diff = bytes_put - strip_bytes[strip];
-                    strip_bytes[strip] = bytes_put;
-                    for (i = strip + 1; i < strip_count; i++) {
-                        strip_offset[i] += diff;
-                    }
+            } else if (compression == TIF_PACKBITS) {
+                for (i = 0; i < (int) bytes_put; i += bytes_per_row) { /* Rows are packed separately */
+                    tif_packbits(sfmp, strip_buf + i, bytes_per_row);
                 }
-            } else {
-                fwrite(strip_buf, 1, bytes_put, tif_file);
+            } else { /* TIF_CCITT_G4 */
+                tif_g4_eofb(&g4_bits);
+            }
+            strip_bytes[strip] = fm_tell(sfmp) - file_pos;
+            file_pos += strip_bytes[strip];
+            if (strip + 1 < strip_count) {
+                strip_offset[strip + 1] = strip_offset[strip] + strip_bytes[strip];
             }
             strip++;
-            total_bytes_put += bytes_put;
             bytes_put = 0;
             strip_row = 0;
             /* Suppress clang-analyzer-core.UndefinedBinaryOperatorResult */
             assert(strip < strip_count || row + 1 == symbol->bitmap_height);
         }
     }
-
-    if (total_bytes_put & 1) {
-        putc(0, tif_file); // IFD must be on word boundary
-        total_bytes_put++;
-    }
-
     if (compression == TIF_LZW) {
         tif_lzw_cleanup(&lzw_state);
+    }
+    if (fm_error(sfmp)) {
+        tif_page_free(page);
+        strcpy(symbol->errtxt, "676: Insufficient memory for TIF strip buffer");
+        return ZINT_ERROR_MEMORY;
+    }
 
-        file_pos = ftell(tif_file);
-        fseek(tif_file, 4, SEEK_SET);
-        free_memory = file_pos;
-        fwrite(&free_memory, 4, 1, tif_file);
-        fseek(tif_file, file_pos, SEEK_SET);
+    if (sfmp->memend > 0xffff0000 - sizeof(tiff_header_t)) {
+        tif_page_free(page);
+        strcpy(symbol->errtxt, "670: Output file size too big");
+        return ZINT_ERROR_MEMORY;
     }
 
+    page->width = symbol->bitmap_width;
+    page->height = symbol->bitmap_height;
+    page->pmi = pmi;
+    page->compression = compression;
+    page->bits_per_sample = bits_per_sample;
+    page->samples_per_pixel = samples_per_pixel;
+    page->extra_samples = extra_samples;
+    page->rows_per_strip = rows_per_strip;
+    page->strip_count = strip_count;
+    page->color_map_size = color_map_size;
+
+    return 0;
+}
+
+/* Make the IFD of `page` (whose strips are at `page->strips_pos`) to go at `ifd_pos`, setting its size */
+static void tif_make_ifd(const struct tif_page *page, const uint32_t ifd_pos, struct tif_ifd *ifd) {
+    tiff_tag_t *const tags = ifd->tags;
+    uint16_t entries = 0;
+    int update_offsets[20];
+    int offsets = 0;
+    uint32_t free_memory = ifd_pos; /* Adjusted by the IFD size below */
+    uint32_t ifd_size;
+    int i;
+
     /* Image File Directory */
     tags[entries].tag = 0x0100; // ImageWidth
-    tags[entries].type = 3; // SHORT
+    tags[entries].type = page->width > 0xffff ? 4 : 3; // LONG or SHORT
     tags[entries].count = 1;
-    tags[entries++].offset = symbol->bitmap_width;
+    tags[entries++].offset = page->width;
 
     tags[entries].tag = 0x0101; // ImageLength - number of rows
-    tags[entries].type = 3; // SHORT
+    tags[entries].type = page->height > 0xffff ? 4 : 3; // LONG or SHORT
     tags[entries].count = 1;
-    tags[entries++].offset = symbol->bitmap_height;
+    tags[entries++].offset = page->height;
 
-    if (samples_per_pixel != 1 || bits_per_sample != 1) {
+    if (page->samples_per_pixel != 1 || page->bits_per_sample != 1) {
         tags[entries].tag = 0x0102; // BitsPerSample
         tags[entries].type = 3; // SHORT
-        tags[entries].count = samples_per_pixel;
-        if (samples_per_pixel == 1) {
-            tags[entries++].offset = bits_per_sample;
-        } else if (samples_per_pixel == 2) { /* 2 SHORTS fit into LONG offset so packed into offset */
-            tags[entries++].offset = (bits_per_sample << 16) | bits_per_sample;
+        tags[entries].count = page->samples_per_pixel;
+        if (page->samples_per_pixel == 1) {
+            tags[entries++].offset = page->bits_per_sample;
+        } else if (page->samples_per_pixel == 2) { /* 2 SHORTS fit into LONG offset so packed into offset */
+            tags[entries++].offset = (page->bits_per_sample << 16) | page->bits_per_sample;
         } else {
             update_offsets[offsets++] = entries;
             tags[entries++].offset = free_memory;
-            free_memory += samples_per_pixel * 2;
+            free_memory += page->samples_per_pixel * 2;
         }
     }
 
     tags[entries].tag = 0x0103; // Compression
     tags[entries].type = 3; // SHORT
     tags[entries].count = 1;
-    tags[entries++].offset = compression;
+    tags[entries++].offset = page->compression;
 
     tags[entries].tag = 0x0106; // PhotometricInterpretation
     tags[entries].type = 3; // SHORT
     tags[entries].count = 1;
-    tags[entries++].offset = pmi;
+    tags[entries++].offset = page->pmi;
 
     tags[entries].tag = 0x0111; // StripOffsets
     tags[entries].type = 4; // LONG
-    tags[entries].count = strip_count;
-    if (strip_count == 1) {
-        tags[entries++].offset = strip_offset[0];
+    tags[entries].count = page->strip_count;
+    if (page->strip_count == 1) {
+        tags[entries++].offset = (uint32_t) page->strips_pos + page->strip_offset[0];
     } else {
         update_offsets[offsets++] = entries;
         tags[entries++].offset = free_memory;
-        free_memory += strip_count * 4;
+        free_memory += page->strip_count * 4;
     }
 
-    if (samples_per_pixel > 1) {
+    if (page->samples_per_pixel > 1) {
         tags[entries].tag = 0x0115; // SamplesPerPixel
         tags[entries].type = 3; // SHORT
         tags[entries].count = 1;
-        tags[entries++].offset = samples_per_pixel;
+        tags[entries++].offset = page->samples_per_pixel;
     }
 
     tags[entries].tag = 0x0116; // RowsPerStrip
     tags[entries].type = 4; // LONG
     tags[entries].count = 1;
-    tags[entries++].offset = rows_per_strip;
+    tags[entries++].offset = page->rows_per_strip;
 
     tags[entries].tag = 0x0117; // StripByteCounts
     tags[entries].type = 4; // LONG
-    tags[entries].count = strip_count;
-    if (strip_count == 1) {
-        tags[entries++].offset = strip_bytes[0];
+    tags[entries].count = page->strip_count;
+    if (page->strip_count == 1) {
+        tags[entries++].offset = page->strip_bytes[0];
     } else {
         update_offsets[offsets++] = entries;
         tags[entries++].offset = free_memory;
-        free_memory += strip_count * 4;
+        free_memory += page->strip_count * 4;
     }
 
     tags[entries].tag = 0x011a; // XResolution
@@ -533,89 +736,227 @@ INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf)
     tags[entries].count = 1;
     tags[entries++].offset = 2; // Inches
 
-    if (color_map_size) {
+    if (page->color_map_size) {
         tags[entries].tag = 0x0140; // ColorMap
         tags[entries].type = 3; // SHORT
-        tags[entries].count = color_map_size * 3;
+        tags[entries].count = page->color_map_size * 3;
         update_offsets[offsets++] = entries;
         tags[entries++].offset = free_memory;
-        //free_memory += color_map_size * 3 * 2; /* Unnecessary as long as last use */
+        free_memory += page->color_map_size * 3 * 2;
     }
 
-    if (extra_samples) {
+    if (page->extra_samples) {
         tags[entries].tag = 0x0152; // ExtraSamples
         tags[entries].type = 3; // SHORT
         tags[entries].count = 1;
-        tags[entries++].offset = extra_samples;
+        tags[entries++].offset = page->extra_samples;
     }
 
-    ifd_size = sizeof(entries) + sizeof(tiff_tag_t) * entries + sizeof(offset);
+    ifd_size = sizeof(entries) + sizeof(tiff_tag_t) * entries + sizeof(uint32_t);
     for (i = 0; i < offsets; i++) {
         tags[update_offsets[i]].offset += ifd_size;
     }
+    ifd->entries = entries;
+    ifd->size = ifd_size + (free_memory - ifd_pos);
+}
 
-    fwrite(&entries, sizeof(entries), 1, tif_file);
-    fwrite(&tags, sizeof(tiff_tag_t), entries, tif_file);
-    fwrite(&offset, sizeof(offset), 1, tif_file);
-    total_bytes_put += ifd_size;
+/* Write `page`'s IFD `ifd` as made by `tif_make_ifd()`, followed by the values that don't fit in its tags, linking
+   to the next IFD at `next_ifd` (0 if none) */
+static void tif_write_ifd(struct filemem *fmp, const struct tif_page *page, const struct tif_ifd *ifd,
+            const uint32_t next_ifd) {
+    uint32_t temp32;
+    int i;
 
-    if (samples_per_pixel > 2) {
-        for (i = 0; i < samples_per_pixel; i++) {
-            fwrite(&bits_per_sample, sizeof(bits_per_sample), 1, tif_file);
+    fm_write(&ifd->entries, sizeof(ifd->entries), 1, fmp);
+    fm_write(ifd->tags, sizeof(tiff_tag_t), ifd->entries, fmp);
+    fm_write(&next_ifd, sizeof(next_ifd), 1, fmp);
+
+    if (page->samples_per_pixel > 2) {
+        for (i = 0; i < page->samples_per_pixel; i++) {
+            fm_write(&page->bits_per_sample, sizeof(page->bits_per_sample), 1, fmp);
         }
-        total_bytes_put += sizeof(bits_per_sample) * samples_per_pixel;
     }
 
-    if (strip_count != 1) {
+    if (page->strip_count != 1) {
         /* Strip offsets */
-        for (i = 0; i < strip_count; i++) {
-            fwrite(&strip_offset[i], 4, 1, tif_file);
+        for (i = 0; i < page->strip_count; i++) {
+            temp32 = (uint32_t) page->strips_pos + page->strip_offset[i];
+            fm_write(&temp32, 4, 1, fmp);
         }
 
         /* Strip byte lengths */
-        for (i = 0; i < strip_count; i++) {
-            fwrite(&strip_bytes[i], 4, 1, tif_file);
+        for (i = 0; i < page->strip_count; i++) {
+            fm_write(&page->strip_bytes[i], 4, 1, fmp);
         }
-        total_bytes_put += strip_count * 8;
     }
 
     /* X Resolution */
     temp32 = 72;
-    fwrite(&temp32, 4, 1, tif_file);
+    fm_write(&temp32, 4, 1, fmp);
     temp32 = 1;
-    fwrite(&temp32, 4, 1, tif_file);
-    total_bytes_put += 8;
+    fm_write(&temp32, 4, 1, fmp);
 
     /* Y Resolution */
     temp32 = 72;
-    fwrite(&temp32, 4, 1, tif_file);
+    fm_write(&temp32, 4, 1, fmp);
     temp32 = 1;
-    fwrite(&temp32, 4, 1, tif_file);
-    total_bytes_put += 8;
+    fm_write(&temp32, 4, 1, fmp);
 
-    if (color_map_size) {
-        for (i = 0; i < color_map_size; i++) {
-            fwrite(&color_map[i].red, 2, 1, tif_file);
+    if (page->color_map_size) {
+        for (i = 0; i < page->color_map_size; i++) {
+            fm_write(&page->color_map[i].red, 2, 1, fmp);
+        }
+        for (i = 0; i < page->color_map_size; i++) {
+            fm_write(&page->color_map[i].green, 2, 1, fmp);
         }
-        for (i = 0; i < color_map_size; i++) {
-            fwrite(&color_map[i].green, 2, 1, tif_file);
+        for (i = 0; i < page->color_map_size; i++) {
+            fm_write(&page->color_map[i].blue, 2, 1, fmp);
         }
-        for (i = 0; i < color_map_size; i++) {
-            fwrite(&color_map[i].blue, 2, 1, tif_file);
+    }
+}
+
+/* Write `page`'s strips at file offset `pos`, padded to a word boundary */
+static void tif_write_strips(struct filemem *fmp, struct tif_page *page, const long pos) {
+    page->strips_pos = pos;
+    if (page->strips_fm.memend) {
+        fm_write(page->strips_fm.mem, 1, page->strips_fm.memend, fmp);
+    }
+    if (page->strips_fm.memend & 1) {
+        fm_putc(0, fmp); // IFD must be on word boundary
+    }
+}
+
+/* Set up page `index` from `rows` if given, else from `symbols[index]`, first plotting it unscaled into its bitmap
+   (as for OUT_BUFFER_INTERMEDIATE). Any error is reported in `symbols[0]` */
+static int tif_next_page(struct zint_symbol *symbols[], const int index, const int rotate_angle,
+            struct raster_rows *rows, struct tif_page *page) {
+    struct zint_symbol *const symbol = symbols[index];
+    struct raster_rows image_rows;
+    int error_number;
+
+    if (!rows) {
+        const int output_options = symbol->output_options;
+        symbol->output_options = (output_options & ~(OUT_BUFFER_1BPP | OUT_BUFFER_RGBA | BARCODE_ANTIALIAS))
+                                    | OUT_BUFFER_INTERMEDIATE;
+        error_number = plot_raster(symbol, rotate_angle, OUT_BUFFER);
+        symbol->output_options = output_options;
+        if (error_number >= ZINT_ERROR) {
+            if (index) {
+                strcpy(symbols[0]->errtxt, symbol->errtxt);
+            }
+            return error_number;
         }
-        total_bytes_put += 6 * color_map_size;
+        raster_rows_image(&image_rows, symbol, symbol->bitmap);
+        rows = &image_rows;
+    }
+    if ((error_number = tif_page_strips(symbol, rows, page)) && index) {
+        strcpy(symbols[0]->errtxt, symbol->errtxt);
+    }
+    return error_number;
+}
+
+/* Output `count` pages to the output of `symbols[0]`, each page's strips followed by its IFD, which links to the
+   next page's IFD after the next page's strips. Only the current and next pages are held in memory */
+static int tif_output(struct zint_symbol *symbols[], const int count, const int rotate_angle,
+            struct raster_rows *rows) {
+    struct zint_symbol *const symbol = symbols[0];
+    struct tif_page pages[2];
+    struct tif_ifd ifd;
+    tiff_header_t header;
+    struct filemem fm;
+    struct filemem *const fmp = &fm;
+    long pos, next_size;
+    int seekable;
+    int error_number;
+    int i;
+
+    if ((error_number = tif_next_page(symbols, 0, rotate_angle, rows, &pages[0]))) {
+        return error_number;
     }
 
-    if (symbol->output_options & BARCODE_STDOUT) {
-        fflush(tif_file);
+    /* Open output file in binary mode */
+    if (!fm_open(fmp, symbol, "wb")) {
+        tif_page_free(&pages[0]);
+        strcpy(symbol->errtxt, "672: Can't open output file");
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+    seekable = fm_seekable(fmp);
+
+    /* Header */
+    if (is_big_endian()) {
+        header.byte_order = 0x4D4D; // "MM" big-endian
     } else {
-        if (ftell(tif_file) != total_bytes_put) {
-            fclose(tif_file);
+        header.byte_order = 0x4949; // "II" little-endian
+    }
+    header.identity = 42;
+    header.offset = sizeof(tiff_header_t) + (uint32_t) tif_strips_size(&pages[0]);
+
+    fm_write(&header, sizeof(tiff_header_t), 1, fmp);
+
+    /* Pixel data */
+    tif_write_strips(fmp, &pages[0], sizeof(tiff_header_t));
+    pos = header.offset;
+
+    for (i = 0; i < count; i++) {
+        struct tif_page *const page = &pages[i & 1];
+        struct tif_page *const next = &pages[(i + 1) & 1];
+        const int last = i + 1 == count;
+
+        /* Next page's strips must be compressed to know where its IFD will go */
+        if (!last && (error_number = tif_next_page(symbols, i + 1, rotate_angle, NULL /*rows*/, next))) {
+            tif_page_free(page);
+            (void) fm_close(fmp, symbol);
+            return error_number;
+        }
+        next_size = last ? 0 : tif_strips_size(next);
+        tif_make_ifd(page, (uint32_t) pos, &ifd);
+        if (pos + ifd.size + next_size > 0xffff0000) {
+            tif_page_free(page);
+            if (!last) {
+                tif_page_free(next);
+            }
+            (void) fm_close(fmp, symbol);
+            strcpy(symbol->errtxt, "678: Output file size too big");
+            return ZINT_ERROR_MEMORY;
+        }
+        tif_write_ifd(fmp, page, &ifd, last ? 0 : (uint32_t) (pos + ifd.size + next_size));
+        pos += ifd.size;
+        tif_page_free(page);
+
+        if (!last) {
+            tif_write_strips(fmp, next, pos);
+            pos += next_size;
+        }
+    }
+
+    if (seekable) {
+        if (fm_tell(fmp) != pos) {
+            (void) fm_close(fmp, symbol);
             strcpy(symbol->errtxt, "674: Failed to write all output");
             return ZINT_ERROR_FILE_WRITE;
         }
-        fclose(tif_file);
+    }
+    if (!fm_close(fmp, symbol)) {
+        strcpy(symbol->errtxt, "675: Failed to write output");
+        return ZINT_ERROR_FILE_WRITE;
     }
 
     return 0;
 }
+
+INTERNAL int tif_plot_rows(struct zint_symbol *symbol, struct raster_rows *rows) {
+    return tif_output(&symbol, 1, 0 /*rotate_angle*/, rows);
+}
+
+INTERNAL int tif_pixel_plot(struct zint_symbol *symbol, unsigned char *pixelbuf) {
+    struct raster_rows rows;
+
+    raster_rows_image(&rows, symbol, pixelbuf);
+    return tif_plot_rows(symbol, &rows);
+}
+
+/* Output the `count` encoded `symbols` as pages of a multi-page TIFF, each rotated by `rotate_angle`, to the output
+   of `symbols[0]` */
+INTERNAL int tif_plot_symbols(struct zint_symbol *symbols[], const int count, const int rotate_angle) {
+    return tif_output(symbols, count, rotate_angle, NULL /*rows*/);
+}
@@ -121,6 +121,7 @@ typedef struct {
  */
 typedef struct {
     tif_lzw_hash *enc_hashtab;  /* kept separate for small machines */
+    const struct zint_allocator *allocator; /* of the symbol, for `enc_hashtab` */
 } tif_lzw_state;
 
 /*
@@ -161,13 +162,13 @@ static void tif_lzw_cl_hash(tif_lzw_state *sp) {
 }
 
 /* Explicit 0xff masking to make icc -check=conversions happy */
-#define PutNextCode(op_file, c) { \
+#define PutNextCode(op_fmp, c) { \
     nextdata = (nextdata << nbits) | c; \
     nextbits += nbits; \
-    putc((nextdata >> (nextbits - 8)) & 0xff, op_file); \
+    fm_putc((nextdata >> (nextbits - 8)) & 0xff, op_fmp); \
     nextbits -= 8; \
     if (nextbits >= 8) { \
-        putc((nextdata >> (nextbits - 8)) & 0xff, op_file); \
+        fm_putc((nextdata >> (nextbits - 8)) & 0xff, op_fmp); \
         nextbits -= 8; \
     } \
     outcount += nbits; \
@@ -187,7 +188,7 @@ static void tif_lzw_cl_hash(tif_lzw_state *sp) {
  * are re-sized at this point, and a CODE_CLEAR is generated
  * for the decoder. 
  */
-static int tif_lzw_encode(tif_lzw_state *sp, FILE *op_file, const unsigned char *bp, int cc) {
+static int tif_lzw_encode(tif_lzw_state *sp, struct filemem *op_fmp, const unsigned char *bp, int cc) {
     register long fcode;
     register tif_lzw_hash *hp;
     register int h, c;
@@ -208,7 +209,7 @@ static int tif_lzw_encode(tif_lzw_state *sp, FILE *op_file, const unsigned char
      * Reset encoding state at the start of a strip.
      */
     if (sp->enc_hashtab == NULL) {
-        sp->enc_hashtab = (tif_lzw_hash *) malloc(HSIZE * sizeof(tif_lzw_hash));
+        sp->enc_hashtab = (tif_lzw_hash *) z_malloc(sp->allocator, HSIZE * sizeof(tif_lzw_hash));
         if (sp->enc_hashtab == NULL) {
             return 0;
         }
@@ -229,7 +230,7 @@ static int tif_lzw_encode(tif_lzw_state *sp, FILE *op_file, const unsigned char
     ent = (tif_lzw_hcode) -1;
 
     if (cc > 0) {
-        PutNextCode(op_file, CODE_CLEAR);
+        PutNextCode(op_fmp, CODE_CLEAR);
         ent = *bp++; cc--; incount++;
     }
     while (cc > 0) {
@@ -275,7 +276,7 @@ static int tif_lzw_encode(tif_lzw_state *sp, FILE *op_file, const unsigned char
         /*
          * New entry, emit code and add to table.
          */
-        PutNextCode(op_file, ent);
+        PutNextCode(op_fmp, ent);
         ent = (tif_lzw_hcode) c;
         hp->code = (tif_lzw_hcode) (free_ent++);
         hp->hash = fcode;
@@ -286,7 +287,7 @@ static int tif_lzw_encode(tif_lzw_state *sp, FILE *op_file, const unsigned char
             incount = 0;
             outcount = 0;
             free_ent = CODE_FIRST;
-            PutNextCode(op_file, CODE_CLEAR);
+            PutNextCode(op_fmp, CODE_CLEAR);
             nbits = BITS_MIN;
             maxcode = MAXCODE(BITS_MIN);
         } else {
@@ -314,7 +315,7 @@ static int tif_lzw_encode(tif_lzw_state *sp, FILE *op_file, const unsigned char
                     incount = 0;
                     outcount = 0;
                     free_ent = CODE_FIRST;
-                    PutNextCode(op_file, CODE_CLEAR);
+                    PutNextCode(op_fmp, CODE_CLEAR);
                     nbits = BITS_MIN;
                     maxcode = MAXCODE(BITS_MIN);
                 } else {
@@ -332,13 +333,13 @@ static int tif_lzw_encode(tif_lzw_state *sp, FILE *op_file, const unsigned char
      */
     if (ent != (tif_lzw_hcode) -1) {
 
-        PutNextCode(op_file, ent);
+        PutNextCode(op_fmp, ent);
         free_ent++;
 
         if (free_ent == CODE_MAX - 1) {
             /* table is full, emit clear code and reset */
             outcount = 0;
-            PutNextCode(op_file, CODE_CLEAR);
+            PutNextCode(op_fmp, CODE_CLEAR);
             nbits = BITS_MIN;
         } else {
             /*
@@ -351,10 +352,10 @@ static int tif_lzw_encode(tif_lzw_state *sp, FILE *op_file, const unsigned char
             }
         }
     }
-    PutNextCode(op_file, CODE_EOI);
+    PutNextCode(op_fmp, CODE_EOI);
     /* Explicit 0xff masking to make icc -check=conversions happy */
     if (nextbits > 0) {
-        putc((nextdata << (8 - nextbits)) & 0xff, op_file);
+        fm_putc((nextdata << (8 - nextbits)) & 0xff, op_fmp);
     }
 
     return 1;
@@ -362,12 +363,13 @@ static int tif_lzw_encode(tif_lzw_state *sp, FILE *op_file, const unsigned char
 
 static void tif_lzw_cleanup(tif_lzw_state *sp) {
     if (sp->enc_hashtab) {
-        free(sp->enc_hashtab);
+        z_free(sp->allocator, sp->enc_hashtab);
     }
 }
 
-static void tif_lzw_init(tif_lzw_state *sp) {
+static void tif_lzw_init(tif_lzw_state *sp, const struct zint_allocator *allocator) {
     sp->enc_hashtab = NULL;
+    sp->allocator = allocator;
 }
 
 #endif   /* TIF_LZW_H */
@@ -50,6 +50,8 @@ static const char fragment[27][14] = {"http://", "https://", "http://www.", "htt
         "ftp://", "www.", ".com", ".edu", ".gov", ".int", ".mil", ".net", ".org",
         ".mobi", ".coop", ".biz", ".info", "mailto:", "tel:", ".cgi", ".asp",
         ".aspx", ".php", ".htm", ".html", ".shtml", "file:"};
+static const char fragment_len[27] = { 7, 8, 11, 12, 6, 4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 4, 5, 7, 4, 4, 4, 5, 4, 4, 5, 6,
+        5 };
 
 static const char ultra_c43_set1[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 .,%";
 static const char ultra_c43_set2[] = "abcdefghijklmnopqrstuvwxyz:/?#[]@=_~!.,-";
@@ -128,8 +130,70 @@ static const int tiles[] = {
  * a more reliable version of the specification.
  */
 
+/* Antilog (powers of 3) and log tables for GF283() multiplication & division, antilog table doubled so the
+ * (gfLog[i] + gfLog[j]) index in GFMUL needs no modulo operation */
+static const unsigned short gfPwr[564] = {
+      1,   3,   9,  27,  81, 243, 163, 206,  52, 156, 185, 272, 250, 184, 269, 241,
+    157, 188, 281, 277, 265, 229, 121,  80, 240, 154, 179, 254, 196,  22,  66, 198,
+     28,  84, 252, 190,   4,  12,  36, 108,  41, 123,  86, 258, 208,  58, 174, 239,
+    151, 170, 227, 115,  62, 186, 275, 259, 211,  67, 201,  37, 111,  50, 150, 167,
+    218,  88, 264, 226, 112,  53, 159, 194,  16,  48, 144, 149, 164, 209,  61, 183,
+    266, 232, 130, 107,  38, 114,  59, 177, 248, 178, 251, 187, 278, 268, 238, 148,
+    161, 200,  34, 102,  23,  69, 207,  55, 165, 212,  70, 210,  64, 192,  10,  30,
+     90, 270, 244, 166, 215,  79, 237, 145, 152, 173, 236, 142, 143, 146, 155, 182,
+    263, 223, 103,  26,  78, 234, 136, 125,  92, 276, 262, 220,  94, 282, 280, 274,
+    256, 202,  40, 120,  77, 231, 127,  98,  11,  33,  99,  14,  42, 126,  95,   2,
+      6,  18,  54, 162, 203,  43, 129, 104,  29,  87, 261, 217,  85, 255, 199,  31,
+     93, 279, 271, 247, 175, 242, 160, 197,  25,  75, 225, 109,  44, 132, 113,  56,
+    168, 221,  97,   8,  24,  72, 216,  82, 246, 172, 233, 133, 116,  65, 195,  19,
+     57, 171, 230, 124,  89, 267, 235, 139, 134, 119,  74, 222, 100,  17,  51, 153,
+    176, 245, 169, 224, 106,  35, 105,  32,  96,   5,  15,  45, 135, 122,  83, 249,
+    181, 260, 214,  76, 228, 118,  71, 213,  73, 219,  91, 273, 253, 193,  13,  39,
+    117,  68, 204,  46, 138, 131, 110,  47, 141, 140, 137, 128, 101,  20,  60, 180,
+    257, 205,  49, 147, 158, 191,   7,  21,  63, 189,   1,   3,   9,  27,  81, 243,
+    163, 206,  52, 156, 185, 272, 250, 184, 269, 241, 157, 188, 281, 277, 265, 229,
+    121,  80, 240, 154, 179, 254, 196,  22,  66, 198,  28,  84, 252, 190,   4,  12,
+     36, 108,  41, 123,  86, 258, 208,  58, 174, 239, 151, 170, 227, 115,  62, 186,
+    275, 259, 211,  67, 201,  37, 111,  50, 150, 167, 218,  88, 264, 226, 112,  53,
+    159, 194,  16,  48, 144, 149, 164, 209,  61, 183, 266, 232, 130, 107,  38, 114,
+     59, 177, 248, 178, 251, 187, 278, 268, 238, 148, 161, 200,  34, 102,  23,  69,
+    207,  55, 165, 212,  70, 210,  64, 192,  10,  30,  90, 270, 244, 166, 215,  79,
+    237, 145, 152, 173, 236, 142, 143, 146, 155, 182, 263, 223, 103,  26,  78, 234,
+    136, 125,  92, 276, 262, 220,  94, 282, 280, 274, 256, 202,  40, 120,  77, 231,
+    127,  98,  11,  33,  99,  14,  42, 126,  95,   2,   6,  18,  54, 162, 203,  43,
+    129, 104,  29,  87, 261, 217,  85, 255, 199,  31,  93, 279, 271, 247, 175, 242,
+    160, 197,  25,  75, 225, 109,  44, 132, 113,  56, 168, 221,  97,   8,  24,  72,
+    216,  82, 246, 172, 233, 133, 116,  65, 195,  19,  57, 171, 230, 124,  89, 267,
+    235, 139, 134, 119,  74, 222, 100,  17,  51, 153, 176, 245, 169, 224, 106,  35,
+    105,  32,  96,   5,  15,  45, 135, 122,  83, 249, 181, 260, 214,  76, 228, 118,
+     71, 213,  73, 219,  91, 273, 253, 193,  13,  39, 117,  68, 204,  46, 138, 131,
+    110,  47, 141, 140, 137, 128, 101,  20,  60, 180, 257, 205,  49, 147, 158, 191,
+      7,  21,  63, 189,
+};
+
+static const unsigned short gfLog[283] = {
+      0,   0, 159,   1,  36, 233, 160, 278, 195,   2, 110, 152,  37, 254, 155, 234,
+     72, 221, 161, 207, 269, 279,  29, 100, 196, 184, 131,   3,  32, 168, 111, 175,
+    231, 153,  98, 229,  38,  59,  84, 255, 146,  40, 156, 165, 188, 235, 259, 263,
+     73, 274,  61, 222,   8,  69, 162, 103, 191, 208,  45,  86, 270,  78,  52, 280,
+    108, 205,  30,  57, 257, 101, 106, 246, 197, 248, 218, 185, 243, 148, 132, 117,
+     23,   4, 199, 238,  33, 172,  42, 169,  65, 212, 112, 250, 136, 176, 140, 158,
+    232, 194, 151, 154, 220, 268,  99, 130, 167, 230, 228,  83,  39, 187, 262,  60,
+     68, 190,  85,  51, 204, 256, 245, 217, 147,  22, 237,  41, 211, 135, 157, 150,
+    267, 166,  82, 261, 189, 203, 216, 236, 134, 266, 260, 215, 265, 264, 123, 124,
+     74, 119, 125, 275,  95,  75,  62,  48, 120, 223,  25, 126,   9,  16, 276,  70,
+    182,  96, 163,   6,  76, 104, 115,  63, 192, 226,  49, 209, 201, 121,  46, 180,
+    224,  87,  89,  26, 271, 240, 127,  79,  13,  10,  53,  91,  17, 281,  35, 277,
+    109, 253,  71, 206,  28, 183,  31, 174,  97,  58, 145, 164, 258, 273,   7, 102,
+     44,  77, 107,  56, 105, 247, 242, 116, 198, 171,  64, 249, 139, 193, 219, 129,
+    227, 186,  67,  50, 244,  21, 210, 149,  81, 202, 133, 214, 122, 118,  94,  47,
+     24,  15, 181,   5, 114, 225, 200, 179,  88, 239,  12,  90,  34, 252,  27, 173,
+    144, 272,  43,  55, 241, 170, 138, 128,  66,  20,  80, 213,  93,  14, 113, 178,
+     11, 251, 143,  54, 137,  19,  92, 177, 142,  18, 141,
+};
+
 /* Generate divisor polynomial gQ(x) for GF283() given the required ECC size, 3 to 101 */
-static void ultra_genPoly(short EccSize, unsigned short gPoly[], unsigned short gfPwr[], unsigned short gfLog[]) {
+static void ultra_genPoly(short EccSize, unsigned short gPoly[]) {
     int i, j;
 
     gPoly[0] = 1;
@@ -145,20 +209,6 @@ static void ultra_genPoly(short EccSize, unsigned short gPoly[], unsigned short
     /* gPoly[i] is > 0 so modulo operation not needed */
 }
 
-/* Generate the log and antilog tables for GF283() multiplication & division */
-static void ultra_initLogTables(unsigned short gfPwr[], unsigned short gfLog[]) {
-    int i, j;
-
-    for (j = 0; j < 283; j++) gfLog[j] = 0;
-    i = 1;
-    for (j = 0; j < 282; j++) {
-        /* j + 282 indicies save doing the modulo operation in GFMUL */
-        gfPwr[j + 282] = gfPwr[j] = (short) i;
-        gfLog[i] = (short) j;
-        i = (i * 3) % 283;
-    }
-}
-
 static void ultra_gf283(short DataSize, short EccSize, int Message[]) {
     /* Input is complete message codewords in array Message[282]
      * DataSize is number of message codewords
@@ -167,15 +217,12 @@ static void ultra_gf283(short DataSize, short EccSize, int Message[]) {
      * Upon exit, Message[282] contains complete 282 codeword Symbol Message
      * including leading zeroes corresponding to each truncated codeword */
 
-    unsigned short gPoly[283], gfPwr[(282 * 2)], gfLog[283];
+    unsigned short gPoly[283];
     int i, j, n;
     unsigned short t;
 
-    /* first build the log & antilog tables used in multiplication & division */
-    ultra_initLogTables(gfPwr, gfLog);
-
-    /* then generate the division polynomial of length EccSize */
-    ultra_genPoly(EccSize, gPoly, gfPwr, gfLog);
+    /* first generate the division polynomial of length EccSize */
+    ultra_genPoly(EccSize, gPoly);
 
     /* zero all EccSize codeword values */
     for (j = 281; (j > (281 - EccSize)); j--) Message[j] = 0;
@@ -202,82 +249,140 @@ static void ultra_gf283(short DataSize, short EccSize, int Message[]) {
 
 /* End of Ted Williams code */
 
+/* Returns the index of the fragment at `position`, or -1 if none. Candidates are chosen by the first character (and
+   for "." the second), and tried highest index first as that's the one to use if more than one matches (i.e. the
+   longest, "http://www." over "http://", ".html" over ".htm" etc) */
 static int ultra_find_fragment(const unsigned char source[], int source_length, int position) {
-    int retval = -1;
-    int j, k, latch, fraglen;
-
-    for (j = 0; j < 27; j++) {
-        latch = 0;
-        fraglen = strlen(fragment[j]);
-        if ((position + fraglen) <= source_length) {
-            latch = 1;
-            for (k = 0; k < fraglen; k++) {
-                if (source[position + k] != fragment[j][k]) {
-                    latch = 0;
-                    break;
-                }
+    static const signed char h_frags[] = { 3, 2, 1, 0, -1 };
+    static const signed char f_frags[] = { 26, 4, -1 };
+    static const signed char w_frags[] = { 5, -1 };
+    static const signed char m_frags[] = { 17, -1 };
+    static const signed char t_frags[] = { 18, -1 };
+    static const signed char dot_a_frags[] = { 21, 20, -1 };
+    static const signed char dot_b_frags[] = { 15, -1 };
+    static const signed char dot_c_frags[] = { 19, 14, 6, -1 };
+    static const signed char dot_e_frags[] = { 7, -1 };
+    static const signed char dot_g_frags[] = { 8, -1 };
+    static const signed char dot_h_frags[] = { 24, 23, -1 };
+    static const signed char dot_i_frags[] = { 16, 9, -1 };
+    static const signed char dot_m_frags[] = { 13, 10, -1 };
+    static const signed char dot_n_frags[] = { 11, -1 };
+    static const signed char dot_o_frags[] = { 12, -1 };
+    static const signed char dot_p_frags[] = { 22, -1 };
+    static const signed char dot_s_frags[] = { 25, -1 };
+    const signed char *frags;
+    int i;
+
+    if (position + 4 > source_length) { /* Shortest fragment 4 */
+        return -1;
+    }
+    switch (source[position]) {
+        case 'h': frags = h_frags; break;
+        case 'f': frags = f_frags; break;
+        case 'w': frags = w_frags; break;
+        case 'm': frags = m_frags; break;
+        case 't': frags = t_frags; break;
+        case '.':
+            switch (source[position + 1]) {
+                case 'a': frags = dot_a_frags; break;
+                case 'b': frags = dot_b_frags; break;
+                case 'c': frags = dot_c_frags; break;
+                case 'e': frags = dot_e_frags; break;
+                case 'g': frags = dot_g_frags; break;
+                case 'h': frags = dot_h_frags; break;
+                case 'i': frags = dot_i_frags; break;
+                case 'm': frags = dot_m_frags; break;
+                case 'n': frags = dot_n_frags; break;
+                case 'o': frags = dot_o_frags; break;
+                case 'p': frags = dot_p_frags; break;
+                case 's': frags = dot_s_frags; break;
+                default: return -1;
             }
-        }
+            break;
+        default:
+            return -1;
+    }
 
-        if (latch) {
-            retval = j;
+    for (i = 0; frags[i] != -1; i++) {
+        const int fraglen = fragment_len[frags[i]];
+        if (position + fraglen <= source_length
+                && memcmp(source + position, fragment[frags[i]], fraglen) == 0) {
+            return frags[i];
         }
     }
 
-    return retval;
+    return -1;
+}
+
+/* Set `fragnos[i]` to the index of the fragment at each position `i` of `source`, or -1 if none */
+static void ultra_find_fragments(const unsigned char source[], const int length, signed char fragnos[]) {
+    int i;
+
+    for (i = 0; i < length; i++) {
+        fragnos[i] = (signed char) ultra_find_fragment(source, length, i);
+    }
 }
 
-/* Encode characters in 8-bit mode */
-static float look_ahead_eightbit(unsigned char source[], int in_length, int in_locn, char current_mode, int end_char, int cw[], int* cw_len, int gs1)
-{
+/* Encode characters in 8-bit mode (or if `cw` NULL just count the codewords) */
+static void look_ahead_eightbit(unsigned char source[], int in_length, int in_locn, char current_mode, int end_char,
+            int cw[], int* cw_len, int* encoded, int gs1) {
     int codeword_count = 0;
     int i;
     int letters_encoded = 0;
 
     if (current_mode != EIGHTBIT_MODE) {
-        cw[codeword_count] = 282; // Unlatch
+        if (cw) {
+            cw[codeword_count] = 282; // Unlatch
+        }
         codeword_count += 1;
     }
 
     i = in_locn;
     while ((i < in_length) && (i < end_char)) {
-        if ((source[i] == '[') && gs1) {
-            cw[codeword_count] = 268; // FNC1
-        } else {
-            cw[codeword_count] = source[i];
+        if (cw) {
+            if ((source[i] == '[') && gs1) {
+                cw[codeword_count] = 268; // FNC1
+            } else {
+                cw[codeword_count] = source[i];
+            }
         }
         i++;
         codeword_count++;
     }
 
     letters_encoded = i - in_locn;
+    if (encoded != NULL) {
+        *encoded = letters_encoded;
+    }
 
     *cw_len = codeword_count;
-
-    if (codeword_count == 0) {
-        return 0.0;
-    } else {
-        return (float)letters_encoded / (float)codeword_count;
-    }
 }
 
-/* Encode character in the ASCII mode/submode (including numeric compression) */
-static float look_ahead_ascii(unsigned char source[], int in_length, int in_locn, char current_mode, int symbol_mode, int end_char, int cw[], int* cw_len, int* encoded, int gs1) {
+/* Encode character in the ASCII mode/submode (including numeric compression) (or if `cw` NULL just count the
+   codewords) */
+static void look_ahead_ascii(unsigned char source[], int in_length, int in_locn, char current_mode, int symbol_mode,
+            int end_char, int cw[], int* cw_len, int* encoded, int gs1) {
     int codeword_count = 0;
     int i;
-    int first_digit, second_digit, done;
+    int first_digit, second_digit, value;
     int letters_encoded = 0;
 
     if (current_mode == EIGHTBIT_MODE) {
-        cw[codeword_count] = 267; // Latch ASCII Submode
+        if (cw) {
+            cw[codeword_count] = 267; // Latch ASCII Submode
+        }
         codeword_count++;
     }
 
     if (current_mode == C43_MODE) {
-        cw[codeword_count] = 282; // Unlatch
+        if (cw) {
+            cw[codeword_count] = 282; // Unlatch
+        }
         codeword_count++;
         if (symbol_mode == EIGHTBIT_MODE) {
-            cw[codeword_count] = 267; // Latch ASCII Submode
+            if (cw) {
+                cw[codeword_count] = 267; // Latch ASCII Submode
+            }
             codeword_count++;
         }
     }
@@ -285,7 +390,7 @@ static float look_ahead_ascii(unsigned char source[], int in_length, int in_locn
     i = in_locn;
     do {
         /* Check for double digits */
-        done = 0;
+        value = -1;
         if (i + 1 < in_length) {
             first_digit = posn(ultra_digit, source[i]);
             second_digit = posn(ultra_digit, source[i + 1]);
@@ -293,43 +398,36 @@ static float look_ahead_ascii(unsigned char source[], int in_length, int in_locn
                 /* Double digit can be encoded */
                 if ((first_digit >= 0) && (first_digit <= 9) && (second_digit >= 0) && (second_digit <= 9)) {
                     /* Double digit numerics */
-                    cw[codeword_count] = (10 * first_digit) + second_digit + 128;
-                    codeword_count++;
-                    i += 2;
-                    done = 1;
+                    value = (10 * first_digit) + second_digit + 128;
                 } else if ((first_digit >= 0) && (first_digit <= 9) && (second_digit == 10)) {
                     /* Single digit followed by selected decimal point character */
-                    cw[codeword_count] = first_digit + 228;
-                    codeword_count++;
-                    i += 2;
-                    done = 1;
+                    value = first_digit + 228;
                 } else if ((first_digit == 10) && (second_digit >= 0) && (second_digit <= 9)) {
                     /* Selected decimal point character followed by single digit */
-                    cw[codeword_count] = second_digit + 238;
-                    codeword_count++;
-                    i += 2;
-                    done = 1;
+                    value = second_digit + 238;
                 } else if ((first_digit >= 0) && (first_digit <= 9) && (second_digit == 11)) {
                     /* Single digit or decimal point followed by field deliminator */
-                    cw[codeword_count] = first_digit + 248;
-                    codeword_count++;
-                    i += 2;
-                    done = 1;
+                    value = first_digit + 248;
                 } else if ((first_digit == 11) && (second_digit >= 0) && (second_digit <= 9)) {
                     /* Field deliminator followed by single digit or decimal point */
-                    cw[codeword_count] = second_digit + 259;
-                    codeword_count++;
-                    i += 2;
-                    done = 1;
+                    value = second_digit + 259;
                 }
             }
         }
 
-        if (!done && source[i] < 0x80) {
-            if ((source[i] == '[') && gs1) {
-                cw[codeword_count] = 272; // FNC1
-            } else {
-                cw[codeword_count] = source[i];
+        if (value != -1) {
+            if (cw) {
+                cw[codeword_count] = value;
+            }
+            codeword_count++;
+            i += 2;
+        } else if (source[i] < 0x80) {
+            if (cw) {
+                if ((source[i] == '[') && gs1) {
+                    cw[codeword_count] = 272; // FNC1
+                } else {
+                    cw[codeword_count] = source[i];
+                }
             }
             codeword_count++;
             i++;
@@ -342,17 +440,11 @@ static float look_ahead_ascii(unsigned char source[], int in_length, int in_locn
     }
 
     *cw_len = codeword_count;
-
-    if (codeword_count == 0) {
-        return 0.0;
-    } else {
-        return (float)letters_encoded / (float)codeword_count;
-    }
 }
 
 /* Returns true if should latch to subset other than given `subset` */
-static int c43_should_latch_other(const unsigned char data[], const int length, const int locn, const int subset,
-            const int gs1) {
+static int c43_should_latch_other(const unsigned char data[], const int length, const signed char fragnos[],
+            const int locn, const int subset, const int gs1) {
     int i, fraglen, predict_window;
     int cnt, alt_cnt, fragno;
     const char* set = subset == 1 ? ultra_c43_set1 : ultra_c43_set2;
@@ -368,9 +460,9 @@ static int c43_should_latch_other(const unsigned char data[], const int length,
             break;
         }
 
-        fragno = ultra_find_fragment(data, length, i);
+        fragno = fragnos[i];
         if (fragno != -1 && fragno != 26) {
-            fraglen = strlen(fragment[fragno]);
+            fraglen = fragment_len[fragno];
             predict_window += fraglen;
             if (predict_window > length) {
                 predict_window = length;
@@ -389,11 +481,11 @@ static int c43_should_latch_other(const unsigned char data[], const int length,
     return alt_cnt > cnt;
 }
 
-static int get_subset(unsigned char source[], int in_length, int in_locn, int current_subset) {
+static int get_subset(unsigned char source[], const signed char fragnos[], int in_locn, int current_subset) {
     int fragno;
     int subset = 0;
 
-    fragno = ultra_find_fragment(source, in_length, in_locn);
+    fragno = fragnos[in_locn];
     if ((fragno != -1) && (fragno != 26)) {
         subset = 3;
     } else if (current_subset == 2) {
@@ -419,8 +511,9 @@ static int get_subset(unsigned char source[], int in_length, int in_locn, int cu
     return subset;
 }
 
-/* Encode characters in the C43 compaction submode */
-static float look_ahead_c43(unsigned char source[], int in_length, int in_locn, char current_mode, int end_char, int subset, int cw[], int* cw_len, int* encoded, int gs1, int debug) {
+/* Encode characters in the C43 compaction submode (or if `cw` NULL just count the codewords) */
+static void look_ahead_c43(unsigned char source[], int in_length, const signed char fragnos[], int in_locn,
+            char current_mode, int end_char, int subset, int cw[], int* cw_len, int* encoded, int gs1, int debug) {
     int codeword_count = 0;
     int subcodeword_count = 0;
     int i;
@@ -431,6 +524,7 @@ static float look_ahead_c43(unsigned char source[], int in_length, int in_locn,
     int base43_value;
     int letters_encoded = 0;
     int pad;
+    int latch = 0;
 
 #ifndef _MSC_VER
     int subcw[(in_length + 3) * 2];
@@ -440,7 +534,7 @@ static float look_ahead_c43(unsigned char source[], int in_length, int in_locn,
 
     if (current_mode == EIGHTBIT_MODE) {
         /* Check for permissable URL C43 macro sequences, otherwise encode directly */
-        fragno = ultra_find_fragment(source, in_length, sublocn);
+        fragno = fragnos[sublocn];
 
         if ((fragno == 2) || (fragno == 3)) {
             // http://www. > http://
@@ -450,44 +544,34 @@ static float look_ahead_c43(unsigned char source[], int in_length, int in_locn,
 
         switch(fragno) {
             case 17: // mailto:
-                cw[codeword_count] = 276;
-                sublocn += strlen(fragment[fragno]);
-                codeword_count++;
+                latch = 276;
+                sublocn += fragment_len[fragno];
                 break;
             case 18: // tel:
-                cw[codeword_count] = 277;
-                sublocn += strlen(fragment[fragno]);
-                codeword_count++;
+                latch = 277;
+                sublocn += fragment_len[fragno];
                 break;
             case 26: // file:
-                cw[codeword_count] = 278;
-                sublocn += strlen(fragment[fragno]);
-                codeword_count++;
+                latch = 278;
+                sublocn += fragment_len[fragno];
                 break;
             case 0: // http://
-                cw[codeword_count] = 279;
-                sublocn += strlen(fragment[fragno]);
-                codeword_count++;
+                latch = 279;
+                sublocn += fragment_len[fragno];
                 break;
             case 1: // https://
-                cw[codeword_count] = 280;
-                sublocn += strlen(fragment[fragno]);
-                codeword_count++;
+                latch = 280;
+                sublocn += fragment_len[fragno];
                 break;
             case 4: // ftp://
-                cw[codeword_count] = 281;
-                sublocn += strlen(fragment[fragno]);
-                codeword_count++;
+                latch = 281;
+                sublocn += fragment_len[fragno];
                 break;
             default:
                 if (subset == 1) {
-                    cw[codeword_count] = 260; // C43 Compaction Submode C1
-                    codeword_count++;
-                }
-
-                if ((subset == 2) || (subset == 3)) {
-                    cw[codeword_count] = 266; // C43 Compaction Submode C2
-                    codeword_count++;
+                    latch = 260; // C43 Compaction Submode C1
+                } else if ((subset == 2) || (subset == 3)) {
+                    latch = 266; // C43 Compaction Submode C2
                 }
                 break;
         }
@@ -495,14 +579,16 @@ static float look_ahead_c43(unsigned char source[], int in_length, int in_locn,
 
     if (current_mode == ASCII_MODE) {
         if (subset == 1) {
-            cw[codeword_count] = 278; // C43 Compaction Submode C1
-            codeword_count++;
+            latch = 278; // C43 Compaction Submode C1
+        } else if ((subset == 2) || (subset == 3)) {
+            latch = 280; // C43 Compaction Submode C2
         }
-
-        if ((subset == 2) || (subset == 3)) {
-            cw[codeword_count] = 280; // C43 Compaction Submode C2
-            codeword_count++;
+    }
+    if (latch) {
+        if (cw) {
+            cw[codeword_count] = latch;
         }
+        codeword_count++;
     }
     unshift_set = subset;
 
@@ -512,14 +598,14 @@ static float look_ahead_c43(unsigned char source[], int in_length, int in_locn,
             break;
         }
 
-        new_subset = get_subset(source, in_length, sublocn, subset);
+        new_subset = get_subset(source, fragnos, sublocn, subset);
 
         if (new_subset == 0) {
             break;
         }
 
         if ((new_subset != subset) && ((new_subset == 1) || (new_subset == 2))) {
-            if (c43_should_latch_other(source, in_length, sublocn, subset, gs1)) {
+            if (c43_should_latch_other(source, in_length, fragnos, sublocn, subset, gs1)) {
                 subcw[subcodeword_count] = 42; // Latch to other C43 set
                 subcodeword_count++;
                 unshift_set = new_subset;
@@ -551,19 +637,19 @@ static float look_ahead_c43(unsigned char source[], int in_length, int in_locn,
             subcw[subcodeword_count] = 41; // Shift to set 3
             subcodeword_count++;
 
-            fragno = ultra_find_fragment(source, in_length, sublocn);
+            fragno = fragnos[sublocn];
             if (fragno == 26) {
                 fragno = -1;
             }
             if ((fragno >= 0) && (fragno <= 18)) {
                 subcw[subcodeword_count] = fragno; // C43 Set 3 codewords 0 to 18
                 subcodeword_count++;
-                sublocn += strlen(fragment[fragno]);
+                sublocn += fragment_len[fragno];
             }
             if ((fragno >= 19) && (fragno <= 25)) {
                 subcw[subcodeword_count] = fragno + 17; // C43 Set 3 codewords 36 to 42
                 subcodeword_count++;
-                sublocn += strlen(fragment[fragno]);
+                sublocn += fragment_len[fragno];
             }
             if (fragno == -1) {
                 subcw[subcodeword_count] = posn(ultra_c43_set3, source[sublocn]) + 19; // C43 Set 3 codewords 19 to 35
@@ -595,21 +681,31 @@ static float look_ahead_c43(unsigned char source[], int in_length, int in_locn,
         *encoded = letters_encoded;
     }
 
-    for (i = 0; i < subcodeword_count; i += 3) {
-        base43_value = (43 * 43 * subcw[i]) + (43 * subcw[i + 1]) + subcw[i + 2];
-        cw[codeword_count] = base43_value / 282;
-        codeword_count++;
-        cw[codeword_count] = base43_value % 282;
-        codeword_count++;
+    if (cw) {
+        for (i = 0; i < subcodeword_count; i += 3) {
+            base43_value = (43 * 43 * subcw[i]) + (43 * subcw[i + 1]) + subcw[i + 2];
+            cw[codeword_count] = base43_value / 282;
+            codeword_count++;
+            cw[codeword_count] = base43_value % 282;
+            codeword_count++;
+        }
+    } else {
+        codeword_count += (subcodeword_count / 3) * 2;
     }
 
     *cw_len = codeword_count;
+}
 
-    if (codeword_count == 0) {
-        return 0.0;
-    } else {
-        return (float)letters_encoded / (float)codeword_count;
+/* Whether `encoded_a` characters in `cws_a` codewords scores higher than `encoded_b` in `cws_b`, where the score is
+   characters per codeword, or zero if no codewords (cross-multiplied to compare exactly in integers) */
+static int ultra_score_higher(const int encoded_a, const int cws_a, const int encoded_b, const int cws_b) {
+    if (cws_a == 0) {
+        return 0;
+    }
+    if (cws_b == 0) {
+        return encoded_a > 0;
     }
+    return encoded_a * cws_b > encoded_b * cws_a;
 }
 
 /* Produces a set of codewords which are "somewhat" optimised - this could be improved on */
@@ -622,25 +718,23 @@ static int ultra_generate_codewords(struct zint_symbol *symbol, const unsigned c
     char symbol_mode;
     char current_mode;
     int subset;
-    float eightbit_score;
-    float ascii_score;
-    float c43_score;
+    int eightbit_cws, ascii_cws, c43_cws;
     int end_char;
     int block_length;
     int fragment_length;
     int fragno;
     int gs1 = 0;
-    int ascii_encoded, c43_encoded;
+    int eightbit_encoded, ascii_encoded, c43_encoded;
 
-#ifndef _MSC_VER
-    unsigned char crop_source[in_length + 1];
-    char mode[in_length + 1];
-    int cw_fragment[in_length * 2 + 1];
-#else
-    unsigned char * crop_source = (unsigned char *) _alloca((in_length + 1) * sizeof (unsigned char));
-    char * mode = (char *) _alloca((in_length + 1) * sizeof (char));
-    int * cw_fragment = (int *) _alloca((in_length * 2 + 1) * sizeof (int));
-#endif /* _MSC_VER */
+    z_work_array(symbol, unsigned char, crop_source, in_length + 1);
+    z_work_array(symbol, signed char, fragnos, in_length + 1);
+    z_work_array(symbol, char, mode, in_length + 1);
+    z_work_array(symbol, int, cw_fragment, in_length * 2 + 1);
+
+    if (z_work_failed(crop_source) || z_work_failed(fragnos) || z_work_failed(mode) || z_work_failed(cw_fragment)) {
+        z_work_error(symbol);
+        return -1;
+    }
 
     if ((symbol->input_mode & 0x07) == GS1_MODE) {
         gs1 = 1;
@@ -765,24 +859,33 @@ static int ultra_generate_codewords(struct zint_symbol *symbol, const unsigned c
 
     /* Attempt encoding in all three modes to see which offers best compaction and store results */
     if (symbol->option_3 == ULTRA_COMPRESSION || gs1) {
+        /* Look up URL fragments once (C43 only) */
+        ultra_find_fragments(crop_source, crop_length, fragnos);
+
         current_mode = symbol_mode;
         input_locn = 0;
         do {
+            /* Count codewords only */
             end_char = input_locn + PREDICT_WINDOW;
-            eightbit_score = look_ahead_eightbit(crop_source, crop_length, input_locn, current_mode, end_char, cw_fragment, &fragment_length, gs1);
-            ascii_score = look_ahead_ascii(crop_source, crop_length, input_locn, current_mode, symbol_mode, end_char, cw_fragment, &fragment_length, &ascii_encoded, gs1);
-            subset = c43_should_latch_other(crop_source, crop_length, input_locn, 1 /*subset*/, gs1) ? 2 : 1;
-            c43_score = look_ahead_c43(crop_source, crop_length, input_locn, current_mode, end_char, subset, cw_fragment, &fragment_length, &c43_encoded, gs1, 0 /*debug*/);
+            look_ahead_eightbit(crop_source, crop_length, input_locn, current_mode, end_char, NULL, &eightbit_cws,
+                &eightbit_encoded, gs1);
+            look_ahead_ascii(crop_source, crop_length, input_locn, current_mode, symbol_mode, end_char, NULL,
+                &ascii_cws, &ascii_encoded, gs1);
+            subset = c43_should_latch_other(crop_source, crop_length, fragnos, input_locn, 1 /*subset*/, gs1) ? 2 : 1;
+            look_ahead_c43(crop_source, crop_length, fragnos, input_locn, current_mode, end_char, subset, NULL,
+                &c43_cws, &c43_encoded, gs1, 0 /*debug*/);
 
             mode[input_locn] = 'a';
             current_mode = ASCII_MODE;
 
-            if ((c43_score > ascii_score) && (c43_score > eightbit_score)) {
+            if (ultra_score_higher(c43_encoded, c43_cws, ascii_encoded, ascii_cws)
+                    && ultra_score_higher(c43_encoded, c43_cws, eightbit_encoded, eightbit_cws)) {
                 mode[input_locn] = 'c';
                 current_mode = C43_MODE;
             }
 
-            if ((eightbit_score > ascii_score) && (eightbit_score > c43_score)) {
+            if (ultra_score_higher(eightbit_encoded, eightbit_cws, ascii_encoded, ascii_cws)
+                    && ultra_score_higher(eightbit_encoded, eightbit_cws, c43_encoded, c43_cws)) {
                 mode[input_locn] = '8';
                 current_mode = EIGHTBIT_MODE;
             }
@@ -824,12 +927,15 @@ static int ultra_generate_codewords(struct zint_symbol *symbol, const unsigned c
 
         switch(mode[input_locn]) {
             case 'a':
-                look_ahead_ascii(crop_source, crop_length, input_locn, current_mode, symbol_mode, input_locn + block_length, cw_fragment, &fragment_length, NULL, gs1);
+                look_ahead_ascii(crop_source, crop_length, input_locn, current_mode, symbol_mode,
+                    input_locn + block_length, cw_fragment, &fragment_length, NULL, gs1);
                 current_mode = ASCII_MODE;
                 break;
             case 'c':
-                subset = c43_should_latch_other(crop_source, crop_length, input_locn, 1 /*subset*/, gs1) ? 2 : 1;
-                look_ahead_c43(crop_source, crop_length, input_locn, current_mode, input_locn + block_length, subset, cw_fragment, &fragment_length, NULL, gs1, symbol->debug);
+                subset = c43_should_latch_other(crop_source, crop_length, fragnos, input_locn, 1 /*subset*/, gs1)
+                            ? 2 : 1;
+                look_ahead_c43(crop_source, crop_length, fragnos, input_locn, current_mode, input_locn + block_length,
+                    subset, cw_fragment, &fragment_length, NULL, gs1, symbol->debug);
 
                 /* Substitute temporary latch if possible */
                 if ((current_mode == EIGHTBIT_MODE) && (cw_fragment[0] == 260) && (fragment_length >= 5) && (fragment_length <= 11)) {
@@ -846,7 +952,8 @@ static int ultra_generate_codewords(struct zint_symbol *symbol, const unsigned c
                 }
                 break;
             case '8':
-                look_ahead_eightbit(crop_source, crop_length, input_locn, current_mode, input_locn + block_length, cw_fragment, &fragment_length, gs1);
+                look_ahead_eightbit(crop_source, crop_length, input_locn, current_mode, input_locn + block_length,
+                    cw_fragment, &fragment_length, NULL, gs1);
                 current_mode = EIGHTBIT_MODE;
                 break;
         }
@@ -876,10 +983,6 @@ INTERNAL int ultracode(struct zint_symbol *symbol, unsigned char source[], int l
     char tilepat[6];
     int tilex, tiley;
     int dcc;
-#ifdef _MSC_VER
-    int* data_codewords;
-    char* pattern;
-#endif /* _MSC_VER */
 
     cw_memalloc = length * 2;
     if (cw_memalloc < 283) {
@@ -891,13 +994,16 @@ INTERNAL int ultracode(struct zint_symbol *symbol, unsigned char source[], int l
         return ZINT_ERROR_INVALID_OPTION;
     }
 
-#ifndef _MSC_VER
-    int data_codewords[cw_memalloc];
-#else
-    data_codewords = (int *) _alloca(cw_memalloc * sizeof (int));
-#endif /* _MSC_VER */
+    z_work_array(symbol, int, data_codewords, cw_memalloc);
+
+    if (z_work_failed(data_codewords)) {
+        return z_work_error(symbol);
+    }
 
     data_cw_count = ultra_generate_codewords(symbol, source, length, data_codewords);
+    if (data_cw_count < 0) {
+        return ZINT_ERROR_MEMORY;
+    }
 
     if (symbol->debug & ZINT_DEBUG_PRINT) {
         printf("Codewords returned = %d\n", data_cw_count);
@@ -1002,11 +1108,11 @@ INTERNAL int ultracode(struct zint_symbol *symbol, unsigned char source[], int l
     total_width = columns + 6;
 
     /* Build symbol */
-#ifndef _MSC_VER
-    char pattern[total_height * total_width];
-#else
-    pattern = (char *) _alloca(total_height * total_width * sizeof (char));
-#endif /* _MSC_VER */
+    z_work_array(symbol, char, pattern, total_height * total_width);
+
+    if (z_work_failed(pattern)) {
+        return z_work_error(symbol);
+    }
 
     for (i = 0; i < (total_height * total_width); i++) {
         pattern[i] = 'W';
@@ -48,12 +48,317 @@
 INTERNAL int ps_plot(struct zint_symbol *symbol);
 INTERNAL int svg_plot(struct zint_symbol *symbol);
 INTERNAL int emf_plot(struct zint_symbol *symbol, int rotate_angle);
+INTERNAL int pdf_plot(struct zint_symbol *symbol);
 
-static struct zint_vector_rect *vector_plot_create_rect(float x, float y, float width, float height) {
+/* Formats left out of the build (see ZINT_OUTPUTS in "CMakeLists.txt") */
+#ifdef ZINT_NO_OUT_PS
+#define ps_plot(symbol) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_SVG
+#define svg_plot(symbol) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_EMF
+#define emf_plot(symbol, rotate_angle) output_excluded(symbol)
+#endif
+#ifdef ZINT_NO_OUT_PDF
+#define pdf_plot(symbol) output_excluded(symbol)
+#endif
+
+/* While plotting, elements are allocated from an arena of blocks of doubling size (the first on the stack) so that
+   they stay put. Once plotting is done `vector_arena_finish()` copies them into a single allocation, each type in
+   a contiguous array in list order whose `next` pointers link up the array, so the lists can still be walked */
+union vector_align {
+    void *p;
+    double d;
+    long l;
+};
+
+#define VECTOR_ARENA_STACK_UNITS 1024 /* 8K on 64-bit */
+
+struct vector_block {
+    struct vector_block *prev;
+    union vector_align data[1]; /* Actually as many units as the arena `size` when allocated */
+};
+
+/* Rectangles batched up for the `rects` callback */
+#define VECTOR_STREAM_RECTS 64
+
+/* State of `ZBarcode_Render_Callbacks()`, where elements are transformed and passed to the callbacks as they're
+   plotted, each created in the single scratch element of its type instead of being allocated */
+struct vector_stream {
+    const struct zint_render_callbacks *callbacks;
+    float scale;
+    int rotate_angle;
+    int begun; /* Set once `begin` called */
+    int rects_count;
+    struct zint_vector_rect rects[VECTOR_STREAM_RECTS];
+    struct zint_vector_rect rect;
+    struct zint_vector_hexagon hexagon;
+    struct zint_vector_circle circle;
+    struct zint_vector_string string;
+};
+
+struct vector_arena {
+    union vector_align *data; /* Current block */
+    size_t size; /* Units in current block */
+    size_t used; /* Units used in current block */
+    struct vector_block *blocks; /* Heap-allocated blocks, most recent first */
+    int err; /* Set if an allocation failed */
+    struct vector_stream *stream; /* If set, elements are streamed instead, see `vector_stream_rect()` etc */
+    const struct zint_allocator *allocator; /* Of the symbol, for `blocks` */
+};
+
+static void vector_arena_init(struct vector_arena *arena, const struct zint_allocator *allocator,
+            union vector_align *stack_data, const size_t stack_size) {
+    arena->allocator = allocator;
+    arena->data = stack_data;
+    arena->size = stack_size;
+    arena->used = 0;
+    arena->blocks = NULL;
+    arena->err = 0;
+    arena->stream = NULL;
+}
+
+static void *vector_arena_alloc(struct vector_arena *arena, const size_t size) {
+    const size_t units = (size + sizeof(union vector_align) - 1) / sizeof(union vector_align);
+    void *ptr;
+
+    if (arena->used + units > arena->size) {
+        struct vector_block *block;
+        size_t new_size = arena->size * 2;
+        if (new_size < units) {
+            new_size = units;
+        }
+        block = (struct vector_block *) z_malloc(arena->allocator, sizeof(struct vector_block)
+                                                    + sizeof(union vector_align) * (new_size - 1));
+        if (!block) {
+            arena->err = 1;
+            return NULL;
+        }
+        block->prev = arena->blocks;
+        arena->blocks = block;
+        arena->data = block->data;
+        arena->size = new_size;
+        arena->used = 0;
+    }
+    ptr = arena->data + arena->used;
+    arena->used += units;
+
+    return ptr;
+}
+
+static void vector_arena_free(struct vector_arena *arena) {
+    while (arena->blocks) {
+        struct vector_block *prev = arena->blocks->prev;
+        z_free(arena->allocator, arena->blocks);
+        arena->blocks = prev;
+    }
+}
+
+/* Scale `rect` by `scale` and rotate it by `rotate_angle` within the scaled, unrotated `width` by `height` */
+static void vector_transform_rect(struct zint_vector_rect *rect, const float scale, const int rotate_angle,
+            const float width, const float height) {
+    float temp;
+
+    rect->x *= scale;
+    rect->y *= scale;
+    rect->height *= scale;
+    rect->width *= scale;
+    if (rotate_angle == 90) {
+        temp = rect->x;
+        rect->x = height - (rect->y + rect->height);
+        rect->y = temp;
+        temp = rect->width;
+        rect->width = rect->height;
+        rect->height = temp;
+    } else if (rotate_angle == 180) {
+        rect->x = width - (rect->x + rect->width);
+        rect->y = height - (rect->y + rect->height);
+    } else if (rotate_angle == 270) {
+        temp = rect->x;
+        rect->x = rect->y;
+        rect->y = width - (temp + rect->width);
+        temp = rect->width;
+        rect->width = rect->height;
+        rect->height = temp;
+    }
+}
+
+/* Scale and rotate the centre `*p_x`, `*p_y`, as `vector_transform_rect()` */
+static void vector_transform_point(float *p_x, float *p_y, const float scale, const int rotate_angle,
+            const float width, const float height) {
+    float temp;
+
+    *p_x *= scale;
+    *p_y *= scale;
+    if (rotate_angle == 90) {
+        temp = *p_x;
+        *p_x = height - *p_y;
+        *p_y = temp;
+    } else if (rotate_angle == 180) {
+        *p_x = width - *p_x;
+        *p_y = height - *p_y;
+    } else if (rotate_angle == 270) {
+        temp = *p_x;
+        *p_x = *p_y;
+        *p_y = width - temp;
+    }
+}
+
+static void vector_transform_hexagon(struct zint_vector_hexagon *hex, const float scale, const int rotate_angle,
+            const float width, const float height) {
+    vector_transform_point(&hex->x, &hex->y, scale, rotate_angle, width, height);
+    hex->diameter *= scale;
+    if (rotate_angle) {
+        hex->rotation = rotate_angle;
+    }
+}
+
+static void vector_transform_circle(struct zint_vector_circle *circle, const float scale, const int rotate_angle,
+            const float width, const float height) {
+    vector_transform_point(&circle->x, &circle->y, scale, rotate_angle, width, height);
+    circle->diameter *= scale;
+}
+
+static void vector_transform_string(struct zint_vector_string *string, const float scale, const int rotate_angle,
+            const float width, const float height) {
+    vector_transform_point(&string->x, &string->y, scale, rotate_angle, width, height);
+    string->width *= scale;
+    string->fsize *= scale;
+    if (rotate_angle) {
+        string->rotation = rotate_angle;
+    }
+}
+
+/* Call `begin` with the output dimensions before the first element, the plotted ones being final by then */
+static void vector_stream_begin(const struct zint_symbol *symbol, struct vector_stream *stream) {
+    const struct zint_render_callbacks *callbacks = stream->callbacks;
+    const float width = symbol->vector->width * stream->scale;
+    const float height = symbol->vector->height * stream->scale;
+
+    stream->begun = 1;
+    if (callbacks->begin) {
+        if (stream->rotate_angle == 90 || stream->rotate_angle == 270) {
+            callbacks->begin(callbacks->context, height, width);
+        } else {
+            callbacks->begin(callbacks->context, width, height);
+        }
+    }
+}
+
+/* Pass any batched rectangles to `rects` */
+static void vector_stream_flush(struct vector_stream *stream) {
+    if (stream->rects_count) {
+        stream->callbacks->rects(stream->callbacks->context, stream->rects, stream->rects_count);
+        stream->rects_count = 0;
+    }
+}
+
+static void vector_stream_rect(const struct zint_symbol *symbol, struct vector_stream *stream,
+            const struct zint_vector_rect *rect) {
+    const struct zint_render_callbacks *callbacks = stream->callbacks;
+    struct zint_vector_rect out = *rect;
+
+    if (!stream->begun) {
+        vector_stream_begin(symbol, stream);
+    }
+    out.next = NULL;
+    vector_transform_rect(&out, stream->scale, stream->rotate_angle, symbol->vector->width * stream->scale,
+                            symbol->vector->height * stream->scale);
+    if (callbacks->rects) {
+        if (stream->rects_count == VECTOR_STREAM_RECTS) {
+            vector_stream_flush(stream);
+        }
+        stream->rects[stream->rects_count++] = out;
+    } else if (callbacks->rect) {
+        callbacks->rect(callbacks->context, &out);
+    }
+}
+
+static void vector_stream_hexagon(const struct zint_symbol *symbol, struct vector_stream *stream,
+            const struct zint_vector_hexagon *hexagon) {
+    struct zint_vector_hexagon out = *hexagon;
+
+    if (!stream->begun) {
+        vector_stream_begin(symbol, stream);
+    }
+    if (stream->callbacks->hexagon) {
+        vector_stream_flush(stream); /* Keep in plotting order */
+        out.next = NULL;
+        vector_transform_hexagon(&out, stream->scale, stream->rotate_angle, symbol->vector->width * stream->scale,
+                                    symbol->vector->height * stream->scale);
+        stream->callbacks->hexagon(stream->callbacks->context, &out);
+    }
+}
+
+static void vector_stream_circle(const struct zint_symbol *symbol, struct vector_stream *stream,
+            const struct zint_vector_circle *circle) {
+    struct zint_vector_circle out = *circle;
+
+    if (!stream->begun) {
+        vector_stream_begin(symbol, stream);
+    }
+    if (stream->callbacks->circle) {
+        vector_stream_flush(stream);
+        out.next = NULL;
+        vector_transform_circle(&out, stream->scale, stream->rotate_angle, symbol->vector->width * stream->scale,
+                                    symbol->vector->height * stream->scale);
+        stream->callbacks->circle(stream->callbacks->context, &out);
+    }
+}
+
+static void vector_stream_string(const struct zint_symbol *symbol, struct vector_stream *stream,
+            const struct zint_vector_string *string) {
+    struct zint_vector_string out = *string;
+
+    if (!stream->begun) {
+        vector_stream_begin(symbol, stream);
+    }
+    if (stream->callbacks->string) {
+        vector_stream_flush(stream);
+        out.next = NULL;
+        vector_transform_string(&out, stream->scale, stream->rotate_angle, symbol->vector->width * stream->scale,
+                                    symbol->vector->height * stream->scale);
+        stream->callbacks->string(stream->callbacks->context, &out);
+    }
+}
+
+/* Stream the elements collected in `symbol->vector` (when they had to be adjusted after plotting), then finish */
+static void vector_stream_finish(const struct zint_symbol *symbol, struct vector_stream *stream) {
+    const struct zint_vector *vector = symbol->vector;
+    const struct zint_vector_rect *rect;
+    const struct zint_vector_hexagon *hex;
+    const struct zint_vector_circle *circle;
+    const struct zint_vector_string *string;
+
+    for (rect = vector->rectangles; rect; rect = rect->next) {
+        vector_stream_rect(symbol, stream, rect);
+    }
+    for (hex = vector->hexagons; hex; hex = hex->next) {
+        vector_stream_hexagon(symbol, stream, hex);
+    }
+    for (circle = vector->circles; circle; circle = circle->next) {
+        vector_stream_circle(symbol, stream, circle);
+    }
+    for (string = vector->strings; string; string = string->next) {
+        vector_stream_string(symbol, stream, string);
+    }
+    vector_stream_flush(stream);
+    if (!stream->begun) {
+        vector_stream_begin(symbol, stream);
+    }
+}
+
+static struct zint_vector_rect *vector_plot_create_rect(struct vector_arena *arena, float x, float y, float width,
+            float height) {
     struct zint_vector_rect *rect;
 
-    rect = (struct zint_vector_rect*) malloc(sizeof (struct zint_vector_rect));
-    if (!rect) return NULL;
+    if (arena->stream) {
+        rect = &arena->stream->rect;
+    } else {
+        rect = (struct zint_vector_rect*) vector_arena_alloc(arena, sizeof (struct zint_vector_rect));
+        if (!rect) return NULL;
+    }
 
     rect->next = NULL;
     rect->x = x;
@@ -65,8 +370,13 @@ static struct zint_vector_rect *vector_plot_create_rect(float x, float y, float
     return rect;
 }
 
-static int vector_plot_add_rect(struct zint_symbol *symbol, struct zint_vector_rect *rect, struct zint_vector_rect **last_rect) {
+static int vector_plot_add_rect(struct zint_symbol *symbol, struct vector_arena *arena, struct zint_vector_rect *rect,
+            struct zint_vector_rect **last_rect) {
     if (!rect) return ZINT_ERROR_MEMORY;
+    if (arena->stream) {
+        vector_stream_rect(symbol, arena->stream, rect);
+        return 1;
+    }
     if (*last_rect)
         (*last_rect)->next = rect;
     else
@@ -76,11 +386,16 @@ static int vector_plot_add_rect(struct zint_symbol *symbol, struct zint_vector_r
     return 1;
 }
 
-static struct zint_vector_hexagon *vector_plot_create_hexagon(float x, float y, float diameter) {
+static struct zint_vector_hexagon *vector_plot_create_hexagon(struct vector_arena *arena, float x, float y,
+            float diameter) {
     struct zint_vector_hexagon *hexagon;
 
-    hexagon = (struct zint_vector_hexagon*) malloc(sizeof (struct zint_vector_hexagon));
-    if (!hexagon) return NULL;
+    if (arena->stream) {
+        hexagon = &arena->stream->hexagon;
+    } else {
+        hexagon = (struct zint_vector_hexagon*) vector_arena_alloc(arena, sizeof (struct zint_vector_hexagon));
+        if (!hexagon) return NULL;
+    }
     hexagon->next = NULL;
     hexagon->x = x;
     hexagon->y = y;
@@ -90,8 +405,13 @@ static struct zint_vector_hexagon *vector_plot_create_hexagon(float x, float y,
     return hexagon;
 }
 
-static int vector_plot_add_hexagon(struct zint_symbol *symbol, struct zint_vector_hexagon *hexagon, struct zint_vector_hexagon **last_hexagon) {
+static int vector_plot_add_hexagon(struct zint_symbol *symbol, struct vector_arena *arena,
+            struct zint_vector_hexagon *hexagon, struct zint_vector_hexagon **last_hexagon) {
     if (!hexagon) return ZINT_ERROR_MEMORY;
+    if (arena->stream) {
+        vector_stream_hexagon(symbol, arena->stream, hexagon);
+        return 1;
+    }
     if (*last_hexagon)
         (*last_hexagon)->next = hexagon;
     else
@@ -101,11 +421,16 @@ static int vector_plot_add_hexagon(struct zint_symbol *symbol, struct zint_vecto
     return 1;
 }
 
-static struct zint_vector_circle *vector_plot_create_circle(float x, float y, float diameter, int colour) {
+static struct zint_vector_circle *vector_plot_create_circle(struct vector_arena *arena, float x, float y,
+            float diameter, int colour) {
     struct zint_vector_circle *circle;
 
-    circle = (struct zint_vector_circle *) malloc(sizeof (struct zint_vector_circle));
-    if (!circle) return NULL;
+    if (arena->stream) {
+        circle = &arena->stream->circle;
+    } else {
+        circle = (struct zint_vector_circle *) vector_arena_alloc(arena, sizeof (struct zint_vector_circle));
+        if (!circle) return NULL;
+    }
     circle->next = NULL;
     circle->x = x;
     circle->y = y;
@@ -115,8 +440,13 @@ static struct zint_vector_circle *vector_plot_create_circle(float x, float y, fl
     return circle;
 }
 
-static int vector_plot_add_circle(struct zint_symbol *symbol, struct zint_vector_circle *circle, struct zint_vector_circle **last_circle) {
+static int vector_plot_add_circle(struct zint_symbol *symbol, struct vector_arena *arena,
+            struct zint_vector_circle *circle, struct zint_vector_circle **last_circle) {
     if (!circle) return ZINT_ERROR_MEMORY;
+    if (arena->stream) {
+        vector_stream_circle(symbol, arena->stream, circle);
+        return 1;
+    }
     if (*last_circle)
         (*last_circle)->next = circle;
     else
@@ -126,13 +456,17 @@ static int vector_plot_add_circle(struct zint_symbol *symbol, struct zint_vector
     return 1;
 }
 
-static int vector_plot_add_string(struct zint_symbol *symbol,
+static int vector_plot_add_string(struct zint_symbol *symbol, struct vector_arena *arena,
         unsigned char *text, float x, float y, float fsize, float width, int halign,
         struct zint_vector_string **last_string) {
     struct zint_vector_string *string;
 
-    string = (struct zint_vector_string*) malloc(sizeof (struct zint_vector_string));
-    if (!string) return 0;
+    if (arena->stream) {
+        string = &arena->stream->string;
+    } else {
+        string = (struct zint_vector_string*) vector_arena_alloc(arena, sizeof (struct zint_vector_string));
+        if (!string) return 0;
+    }
     string->next = NULL;
     string->x = x;
     string->y = y;
@@ -141,8 +475,13 @@ static int vector_plot_add_string(struct zint_symbol *symbol,
     string->length = ustrlen(text);
     string->rotation = 0;
     string->halign = halign;
-    string->text = (unsigned char*) malloc(sizeof (unsigned char) * (ustrlen(text) + 1));
-    if (!string->text) { free(string); return 0; }
+    if (arena->stream) {
+        string->text = text; /* Passed on straight away */
+        vector_stream_string(symbol, arena->stream, string);
+        return 1;
+    }
+    string->text = (unsigned char*) vector_arena_alloc(arena, sizeof (unsigned char) * (ustrlen(text) + 1));
+    if (!string->text) return 0;
     ustrcpy(string->text, text);
 
     if (*last_string)
@@ -154,240 +493,289 @@ static int vector_plot_add_string(struct zint_symbol *symbol,
     return 1;
 }
 
+/* Replace `symbol->vector` (on the stack, with its elements in `arena`) by a copy in a single allocation with its
+   elements in contiguous arrays and their counts set, then free `arena`. On failure `symbol->vector` is NULL */
+static int vector_arena_finish(struct zint_symbol *symbol, struct vector_arena *arena) {
+    struct zint_vector *vector = symbol->vector;
+    struct zint_vector *out = NULL;
+    struct zint_vector_rect *rect, *out_rects;
+    struct zint_vector_hexagon *hex, *out_hexes;
+    struct zint_vector_circle *circle, *out_circles;
+    struct zint_vector_string *string, *out_strings;
+    unsigned char *out_text;
+    int rect_count = 0, hex_count = 0, circle_count = 0, string_count = 0;
+    size_t text_size = 0;
+    int i;
+
+    if (!arena->err) {
+        for (rect = vector->rectangles; rect; rect = rect->next, rect_count++);
+        for (hex = vector->hexagons; hex; hex = hex->next, hex_count++);
+        for (circle = vector->circles; circle; circle = circle->next, circle_count++);
+        for (string = vector->strings; string; string = string->next, string_count++) {
+            text_size += string->length + 1;
+        }
+        /* The element structs all contain a pointer so the arrays following each other stay aligned */
+        out = (struct zint_vector *) z_malloc(z_allocator(symbol), sizeof(struct zint_vector)
+                                                + sizeof(struct zint_vector_rect) * rect_count
+                                                + sizeof(struct zint_vector_hexagon) * hex_count
+                                                + sizeof(struct zint_vector_circle) * circle_count
+                                                + sizeof(struct zint_vector_string) * string_count + text_size);
+    }
+    if (!out) {
+        vector_arena_free(arena);
+        symbol->vector = NULL;
+        return ZINT_ERROR_MEMORY;
+    }
+
+    out_rects = (struct zint_vector_rect *) (out + 1);
+    out_hexes = (struct zint_vector_hexagon *) (out_rects + rect_count);
+    out_circles = (struct zint_vector_circle *) (out_hexes + hex_count);
+    out_strings = (struct zint_vector_string *) (out_circles + circle_count);
+    out_text = (unsigned char *) (out_strings + string_count);
+
+    for (rect = vector->rectangles, i = 0; rect; rect = rect->next, i++) {
+        out_rects[i] = *rect;
+        out_rects[i].next = i + 1 < rect_count ? out_rects + i + 1 : NULL;
+    }
+    for (hex = vector->hexagons, i = 0; hex; hex = hex->next, i++) {
+        out_hexes[i] = *hex;
+        out_hexes[i].next = i + 1 < hex_count ? out_hexes + i + 1 : NULL;
+    }
+    for (circle = vector->circles, i = 0; circle; circle = circle->next, i++) {
+        out_circles[i] = *circle;
+        out_circles[i].next = i + 1 < circle_count ? out_circles + i + 1 : NULL;
+    }
+    for (string = vector->strings, i = 0; string; string = string->next, i++) {
+        out_strings[i] = *string;
+        out_strings[i].next = i + 1 < string_count ? out_strings + i + 1 : NULL;
+        out_strings[i].text = out_text;
+        memcpy(out_text, string->text, string->length + 1);
+        out_text += string->length + 1;
+    }
+
+    out->width = vector->width;
+    out->height = vector->height;
+    out->rectangles = rect_count ? out_rects : NULL;
+    out->hexagons = hex_count ? out_hexes : NULL;
+    out->strings = string_count ? out_strings : NULL;
+    out->circles = circle_count ? out_circles : NULL;
+    out->rectangles_count = rect_count;
+    out->hexagons_count = hex_count;
+    out->strings_count = string_count;
+    out->circles_count = circle_count;
+
+    vector_arena_free(arena);
+    symbol->vector = out;
+
+    return 0;
+}
+
+/* The vector and its elements are a single allocation, see `vector_arena_finish()` */
 INTERNAL void vector_free(struct zint_symbol *symbol) {
     if (symbol->vector != NULL) {
-        struct zint_vector_rect *rect;
-        struct zint_vector_hexagon *hex;
-        struct zint_vector_circle *circle;
-        struct zint_vector_string *string;
-
-        // Free Rectangles
-        rect = symbol->vector->rectangles;
-        while (rect) {
-            struct zint_vector_rect *r = rect;
-            rect = rect->next;
-            free(r);
-        }
+        z_free(z_allocator(symbol), symbol->vector);
+        symbol->vector = NULL;
+    }
+}
 
-        // Free Hexagons
-        hex = symbol->vector->hexagons;
-        while (hex) {
-            struct zint_vector_hexagon *h = hex;
-            hex = hex->next;
-            free(h);
-        }
+/* Set `hexagons_diameter` and `circles_diameter` if the hexagons, circles respectively are all the same shape */
+static void vector_shared_shapes(struct zint_vector *vector) {
+    const struct zint_vector_hexagon *hex;
+    const struct zint_vector_circle *circle;
 
-        // Free Circles
-        circle = symbol->vector->circles;
-        while (circle) {
-            struct zint_vector_circle *c = circle;
-            circle = circle->next;
-            free(c);
+    vector->hexagons_diameter = 0.0f;
+    if (vector->hexagons) {
+        for (hex = vector->hexagons->next; hex; hex = hex->next) {
+            if (hex->diameter != vector->hexagons->diameter || hex->rotation != vector->hexagons->rotation) {
+                break;
+            }
         }
-
-        // Free Strings
-        string = symbol->vector->strings;
-        while (string) {
-            struct zint_vector_string *s = string;
-            string = string->next;
-            free(s->text);
-            free(s);
+        if (!hex) {
+            vector->hexagons_diameter = vector->hexagons->diameter;
         }
+    }
 
-        // Free vector
-        free(symbol->vector);
-        symbol->vector = NULL;
+    vector->circles_diameter = 0.0f;
+    if (vector->circles) {
+        for (circle = vector->circles->next; circle; circle = circle->next) {
+            if (circle->diameter != vector->circles->diameter || circle->colour != vector->circles->colour) {
+                break;
+            }
+        }
+        if (!circle) {
+            vector->circles_diameter = vector->circles->diameter;
+        }
     }
 }
 
-static void vector_scale(struct zint_symbol *symbol, int file_type) {
+/* Set `transform` to scale by `symbol->scale` (doubled) and rotate by `rotate_angle` (0, 90, 180 or 270 clockwise),
+   and `width` and `height` to the output dimensions. If `apply` set, applies the transform to the elements in the
+   same pass, leaving `transform` identity, otherwise leaves the elements untouched */
+static void vector_transform(struct zint_symbol *symbol, int rotate_angle, const int file_type, const int apply) {
+    struct zint_vector *vector = symbol->vector;
     struct zint_vector_rect *rect;
     struct zint_vector_hexagon *hex;
     struct zint_vector_circle *circle;
     struct zint_vector_string *string;
     float scale = symbol->scale * 2.0f;
+    float *t = vector->transform;
+    float width, height; /* Scaled, unrotated */
 
     if ((file_type == OUT_EMF_FILE) && (symbol->symbology == BARCODE_MAXICODE)) {
         // Increase size to overcome limitations in EMF file format
         scale *= 20;
     }
-    
-    symbol->vector->width *= scale;
-    symbol->vector->height *= scale;
-
-    rect = symbol->vector->rectangles;
-    while (rect) {
-        rect->x *= scale;
-        rect->y *= scale;
-        rect->height *= scale;
-        rect->width *= scale;
-        rect = rect->next;
+    if (file_type == OUT_EMF_FILE) {
+        /* EMF does its own rotation (with mixed results in various apps) */
+        rotate_angle = 0;
     }
 
-    hex = symbol->vector->hexagons;
-    while (hex) {
-        hex->x *= scale;
-        hex->y *= scale;
-        hex->diameter *= scale;
-        hex = hex->next;
+    width = vector->width * scale;
+    height = vector->height * scale;
+
+    /* x' = t[0] * x + t[2] * y + t[4], y' = t[1] * x + t[3] * y + t[5] */
+    t[0] = t[3] = rotate_angle == 0 ? scale : rotate_angle == 180 ? -scale : 0.0f;
+    t[1] = rotate_angle == 90 ? scale : rotate_angle == 270 ? -scale : 0.0f;
+    t[2] = -t[1];
+    t[4] = rotate_angle == 90 ? height : rotate_angle == 180 ? width : 0.0f;
+    t[5] = rotate_angle == 180 ? height : rotate_angle == 270 ? width : 0.0f;
+
+    if (rotate_angle == 90 || rotate_angle == 270) {
+        vector->width = height;
+        vector->height = width;
+    } else {
+        vector->width = width;
+        vector->height = height;
     }
 
-    circle = symbol->vector->circles;
-    while (circle) {
-        circle->x *= scale;
-        circle->y *= scale;
-        circle->diameter *= scale;
-        circle = circle->next;
+    if (!apply) {
+        return;
     }
 
-    string = symbol->vector->strings;
-    while (string) {
-        string->x *= scale;
-        string->y *= scale;
-        string->width *= scale;
-        string->fsize *= scale;
-        string = string->next;
+    for (rect = vector->rectangles; rect; rect = rect->next) {
+        vector_transform_rect(rect, scale, rotate_angle, width, height);
+    }
+    for (hex = vector->hexagons; hex; hex = hex->next) {
+        vector_transform_hexagon(hex, scale, rotate_angle, width, height);
+    }
+    for (circle = vector->circles; circle; circle = circle->next) {
+        vector_transform_circle(circle, scale, rotate_angle, width, height);
     }
-    return;
+    for (string = vector->strings; string; string = string->next) {
+        vector_transform_string(string, scale, rotate_angle, width, height);
+    }
+
+    t[0] = t[3] = 1.0f;
+    t[1] = t[2] = t[4] = t[5] = 0.0f;
 }
 
-static void vector_rotate(struct zint_symbol *symbol, int rotate_angle) {
-    // Rotates the image
+struct vector_merge_node {
     struct zint_vector_rect *rect;
-    struct zint_vector_hexagon *hex;
-    struct zint_vector_circle *circle;
-    struct zint_vector_string *string;
-    float temp;
-    
-    if (rotate_angle == 0) {
-        // No rotation needed
-        return;
-    }
-    
-    rect = symbol->vector->rectangles;
-    while (rect) {
-        if (rotate_angle == 90) {
-            temp = rect->x;
-            rect->x = symbol->vector->height - (rect->y + rect->height);
-            rect->y = temp;
-            temp = rect->width;
-            rect->width = rect->height;
-            rect->height = temp;
-        }
-        if (rotate_angle == 180) {
-            rect->x = symbol->vector->width - (rect->x + rect->width);
-            rect->y = symbol->vector->height - (rect->y + rect->height);
-        }
-        if (rotate_angle == 270) {
-            temp = rect->x;
-            rect->x = rect->y;
-            rect->y = symbol->vector->width - (temp + rect->width);
-            temp = rect->width;
-            rect->width = rect->height;
-            rect->height = temp;
-        }
-        rect = rect->next;
-    }
-    
-    hex = symbol->vector->hexagons;
-    while (hex) {
-        if (rotate_angle == 90) {
-            temp = hex->x;
-            hex->x = symbol->vector->height - hex->y;
-            hex->y = temp;
-            hex->rotation = 90;
-        }
-        if (rotate_angle == 180) {
-            hex->x = symbol->vector->width - hex->x;
-            hex->y = symbol->vector->height - hex->y;
-            hex->rotation = 180;
-        }
-        if (rotate_angle == 270) {
-            temp = hex->x;
-            hex->x = hex->y;
-            hex->y = symbol->vector->width - temp;
-            hex->rotation = 270;
-        }
-        hex = hex->next;
-    }
-    
-    circle = symbol->vector->circles;
-    while (circle) {
-        if (rotate_angle == 90) {
-            temp = circle->x;
-            circle->x = symbol->vector->height - circle->y;
-            circle->y = temp;
-        }
-        if (rotate_angle == 180) {
-            circle->x = symbol->vector->width - circle->x;
-            circle->y = symbol->vector->height - circle->y;
-        }
-        if (rotate_angle == 270) {
-            temp = circle->x;
-            circle->x = circle->y;
-            circle->y = symbol->vector->width - temp;
+    int index; /* Position of `rect` in list, so earliest wins if there are duplicates */
+    int next; /* Next node in bucket chain, -1 if none */
+};
+
+/* Hash rectangle column `x`, `width`, `colour` together with vertical position `y` */
+static unsigned int vector_merge_hash(const float x, const float width, const int colour, const float y) {
+    const float vals[3] = { x + 0.0f, width + 0.0f, y + 0.0f }; /* Adding zero normalises -0 to +0 */
+    unsigned int h = 2166136261u ^ (unsigned int) colour; /* FNV-1a */
+    unsigned int bits;
+    int i, j;
+
+    for (i = 0; i < 3; i++) {
+        memcpy(&bits, &vals[i], sizeof(bits));
+        for (j = 0; j < 4; j++) {
+            h = (h ^ (bits & 0xFF)) * 16777619u;
+            bits >>= 8;
         }
-        circle = circle->next;
-    }
-    
-    string = symbol->vector->strings;
-    while (string) {
-        if (rotate_angle == 90) {
-            temp = string->x;
-            string->x = symbol->vector->height - string->y;
-            string->y = temp;
-            string->rotation = 90;
-        }
-        if (rotate_angle == 180) {
-            string->x = symbol->vector->width - string->x;
-            string->y = symbol->vector->height - string->y;
-            string->rotation = 180;
-        }
-        if (rotate_angle == 270) {
-            temp = string->x;
-            string->x = string->y;
-            string->y = symbol->vector->width - temp;
-            string->rotation = 270;
-        }
-        string = string->next;
-    }
-    
-    if ((rotate_angle == 90) || (rotate_angle == 270)) {
-        temp = symbol->vector->height;
-        symbol->vector->height = symbol->vector->width;
-        symbol->vector->width = temp;
     }
-
-    return;
+    return h;
 }
 
-static void vector_reduce_rectangles(struct zint_symbol *symbol) {
-    // Looks for vertically aligned rectangles and merges them together
-    struct zint_vector_rect *rect, *target, *prev;
+static void vector_reduce_rectangles(struct zint_symbol *symbol, struct vector_arena *arena) {
+    /* Looks for vertically aligned rectangles and merges them together. Each rectangle is hashed on its bottom
+       edge, so a rectangle can find the one directly above it (same column, width & colour) in constant time */
+    struct zint_vector_rect *rect, *prev, *above;
+    struct vector_merge_node *nodes;
+    int *buckets;
+    int count = 0, num_buckets, num_nodes = 0;
+    int index, n, match, match_index;
+    unsigned int h;
+
+    for (rect = symbol->vector->rectangles; rect; rect = rect->next) {
+        count++;
+    }
+    if (count < 2) {
+        return;
+    }
+    for (num_buckets = 16; num_buckets < count; num_buckets <<= 1);
+
+    buckets = (int *) vector_arena_alloc(arena, sizeof(int) * num_buckets);
+    /* Each rectangle is added once, plus once more for each merge into it (merges < `count`) */
+    nodes = (struct vector_merge_node *) vector_arena_alloc(arena, sizeof(struct vector_merge_node) * count * 2);
+    if (!buckets || !nodes) {
+        return; /* `arena->err` set, will be reported when finishing */
+    }
+    memset(buckets, 0xFF, sizeof(int) * num_buckets); /* -1 */
 
+    prev = NULL;
     rect = symbol->vector->rectangles;
-    while (rect) {
-        prev = rect;
-        target = prev->next;
-
-        while (target) {
-            if ((rect->x == target->x) && (rect->width == target->width) && ((rect->y + rect->height) == target->y) && (rect->colour == target->colour)) {
-                rect->height += target->height;
-                prev->next = target->next;
-                free(target);
-            } else {
-                prev = target;
+    for (index = 0; rect; index++) {
+        h = vector_merge_hash(rect->x, rect->width, rect->colour, rect->y) & (num_buckets - 1);
+        match = -1;
+        match_index = index;
+        /* Nodes left behind by rectangles that have since grown simply fail the bottom edge check */
+        for (n = buckets[h]; n != -1; n = nodes[n].next) {
+            above = nodes[n].rect;
+            if (nodes[n].index < match_index && above->x == rect->x && above->width == rect->width
+                    && above->y + above->height == rect->y && above->colour == rect->colour) {
+                match = n;
+                match_index = nodes[n].index;
             }
-            target = prev->next;
         }
+        if (match != -1) {
+            above = nodes[match].rect;
+            above->height += rect->height;
+            prev->next = rect->next; /* Left in arena */
+        } else {
+            above = rect;
+            prev = rect;
+        }
+        h = vector_merge_hash(above->x, above->width, above->colour, above->y + above->height) & (num_buckets - 1);
+        nodes[num_nodes].rect = above;
+        nodes[num_nodes].index = match != -1 ? match_index : index;
+        nodes[num_nodes].next = buckets[h];
+        buckets[h] = num_nodes++;
 
-        rect = rect->next;
+        rect = prev->next;
     }
+}
 
-    return;
+/* Write the plotted `symbol->vector` to `file_type` (nothing for OUT_BUFFER) */
+static int vector_write(struct zint_symbol *symbol, const int rotate_angle, const int file_type) {
+    int error_number = 0;
+
+    switch (file_type) {
+        case OUT_EPS_FILE:
+            error_number = ps_plot(symbol);
+            break;
+        case OUT_SVG_FILE:
+            error_number = svg_plot(symbol);
+            break;
+        case OUT_EMF_FILE:
+            error_number = emf_plot(symbol, rotate_angle);
+            break;
+        case OUT_PDF_FILE:
+            error_number = pdf_plot(symbol);
+            break;
+        /* case OUT_BUFFER: No more work needed */
+    }
+
+    return error_number;
 }
 
-INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_type) {
+static int plot_vector_symbol(struct zint_symbol *symbol, int rotate_angle, int file_type,
+            const struct zint_render_callbacks *callbacks) {
     int error_number;
     float large_bar_height;
     int textdone = 0;
@@ -418,6 +806,10 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
     int this_row;
 
     struct zint_vector *vector;
+    struct zint_vector plot_vector_header; /* Replaced by a single allocation once plotted */
+    struct vector_arena arena;
+    union vector_align arena_stack_data[VECTOR_ARENA_STACK_UNITS];
+    struct vector_stream stream;
     struct zint_vector_rect *rectangle, *rect, *last_rectangle = NULL;
     struct zint_vector_hexagon *last_hexagon = NULL;
     struct zint_vector_string *last_string = NULL;
@@ -432,9 +824,8 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
         return error_number;
     }
 
-    // Allocate memory
-    vector = symbol->vector = (struct zint_vector *) malloc(sizeof (struct zint_vector));
-    if (!vector) return ZINT_ERROR_MEMORY;
+    vector_arena_init(&arena, z_allocator(symbol), arena_stack_data, VECTOR_ARENA_STACK_UNITS);
+    vector = symbol->vector = &plot_vector_header;
     vector->rectangles = NULL;
     vector->hexagons = NULL;
     vector->circles = NULL;
@@ -448,6 +839,18 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
         upceanflag = output_process_upcean(symbol, &main_width, &comp_offset, addon, &addon_gap);
     }
 
+    if (callbacks) {
+        stream.callbacks = callbacks;
+        stream.scale = symbol->scale * 2.0f;
+        stream.rotate_angle = rotate_angle;
+        stream.begun = 0;
+        stream.rects_count = 0;
+        /* UPC/EAN guard bars are extended once plotted, so collect their (few) elements and stream them after */
+        if (!upceanflag) {
+            arena.stream = &stream;
+        }
+    }
+
     output_set_whitespace_offsets(symbol, &xoffset, &yoffset, &roffset, &boffset);
 
     hide_text = ((!symbol->show_hrt) || (ustrlen(symbol->text) == 0));
@@ -519,18 +922,18 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
         bull_d_incr = (hex_diameter * 9 - hex_ydiameter) / 5.0f;
 
         // TODO: Add width to circle so can draw rings instead of overlaying circles
-        circle = vector_plot_create_circle(bull_x, bull_y, hex_ydiameter + bull_d_incr * 5, 0);
-        vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(bull_x, bull_y, hex_ydiameter + bull_d_incr * 4, 1);
-        vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(bull_x, bull_y, hex_ydiameter + bull_d_incr * 3, 0);
-        vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(bull_x, bull_y, hex_ydiameter + bull_d_incr * 2, 1);
-        vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(bull_x, bull_y, hex_ydiameter + bull_d_incr, 0);
-        vector_plot_add_circle(symbol, circle, &last_circle);
-        circle = vector_plot_create_circle(bull_x, bull_y, hex_ydiameter, 1);
-        vector_plot_add_circle(symbol, circle, &last_circle);
+        circle = vector_plot_create_circle(&arena, bull_x, bull_y, hex_ydiameter + bull_d_incr * 5, 0);
+        vector_plot_add_circle(symbol, &arena, circle, &last_circle);
+        circle = vector_plot_create_circle(&arena, bull_x, bull_y, hex_ydiameter + bull_d_incr * 4, 1);
+        vector_plot_add_circle(symbol, &arena, circle, &last_circle);
+        circle = vector_plot_create_circle(&arena, bull_x, bull_y, hex_ydiameter + bull_d_incr * 3, 0);
+        vector_plot_add_circle(symbol, &arena, circle, &last_circle);
+        circle = vector_plot_create_circle(&arena, bull_x, bull_y, hex_ydiameter + bull_d_incr * 2, 1);
+        vector_plot_add_circle(symbol, &arena, circle, &last_circle);
+        circle = vector_plot_create_circle(&arena, bull_x, bull_y, hex_ydiameter + bull_d_incr, 0);
+        vector_plot_add_circle(symbol, &arena, circle, &last_circle);
+        circle = vector_plot_create_circle(&arena, bull_x, bull_y, hex_ydiameter, 1);
+        vector_plot_add_circle(symbol, &arena, circle, &last_circle);
 
         /* Hexagons */
         for (r = 0; r < symbol->rows; r++) {
@@ -540,8 +943,8 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
             for (i = 0; i < symbol->width - odd_row; i++) {
                 if (module_is_set(symbol, r, i)) {
                     const float xposn = i * hex_diameter + xposn_offset;
-                    struct zint_vector_hexagon *hexagon = vector_plot_create_hexagon(xposn, yposn, hex_diameter);
-                    vector_plot_add_hexagon(symbol, hexagon, &last_hexagon);
+                    struct zint_vector_hexagon *hexagon = vector_plot_create_hexagon(&arena, xposn, yposn, hex_diameter);
+                    vector_plot_add_hexagon(symbol, &arena, hexagon, &last_hexagon);
                 }
             }
         }
@@ -551,8 +954,8 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
         for (r = 0; r < symbol->rows; r++) {
             for (i = 0; i < symbol->width; i++) {
                 if (module_is_set(symbol, r, i)) {
-                    struct zint_vector_circle *circle = vector_plot_create_circle(i + dotradius + dotoffset + xoffset, r + dotradius + dotoffset + yoffset, symbol->dot_size, 0);
-                    vector_plot_add_circle(symbol, circle, &last_circle);
+                    struct zint_vector_circle *circle = vector_plot_create_circle(&arena, i + dotradius + dotoffset + xoffset, r + dotradius + dotoffset + yoffset, symbol->dot_size, 0);
+                    vector_plot_add_circle(symbol, &arena, circle, &last_circle);
                 }
             }
         }
@@ -576,9 +979,9 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
                     } while (i + block_width < symbol->width && module_colour_is_set(symbol, this_row, i + block_width) == module_fill);
                     if (module_fill) {
                         /* a colour block */
-                        rectangle = vector_plot_create_rect(i + xoffset, row_posn, block_width, row_height);
+                        rectangle = vector_plot_create_rect(&arena, i + xoffset, row_posn, block_width, row_height);
                         rectangle->colour = module_colour_is_set(symbol, this_row, i);
-                        vector_plot_add_rect(symbol, rectangle, &last_rectangle);
+                        vector_plot_add_rect(symbol, &arena, rectangle, &last_rectangle);
                         rect_count++;
                     }
                     i += block_width;
@@ -587,10 +990,7 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
             } else {
                 do {
                     int module_fill = module_is_set(symbol, this_row, i);
-                    int block_width = 0;
-                    do {
-                        block_width++;
-                    } while (i + block_width < symbol->width && module_is_set(symbol, this_row, i + block_width) == module_fill);
+                    const int block_width = module_run_length(symbol, this_row, i);
                     if (upceanflag && (addon_latch == 0) && (r == (symbol->rows - 1)) && (i > main_width)) {
                         addon_text_posn = row_posn + text_height - text_height * digit_ascent_factor;
                         if (addon_text_posn < 0.0f) {
@@ -608,11 +1008,11 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
                     if (module_fill) {
                         /* a bar */
                         if (addon_latch == 0) {
-                            rectangle = vector_plot_create_rect(i + xoffset, row_posn, block_width, row_height);
+                            rectangle = vector_plot_create_rect(&arena, i + xoffset, row_posn, block_width, row_height);
                         } else {
-                            rectangle = vector_plot_create_rect(i + xoffset, addon_text_posn - text_gap, block_width, addon_bar_height);
+                            rectangle = vector_plot_create_rect(&arena, i + xoffset, addon_text_posn - text_gap, block_width, addon_bar_height);
                         }
-                        vector_plot_add_rect(symbol, rectangle, &last_rectangle);
+                        vector_plot_add_rect(symbol, &arena, rectangle, &last_rectangle);
                         rect_count++;
                     }
                     i += block_width;
@@ -706,93 +1106,93 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
             if (upceanflag == 6) { /* UPC-E */
                 textpos = -5.0f + xoffset;
                 textwidth = 6.2f;
-                vector_plot_add_string(symbol, textpart1, textpos, default_text_posn, upcae_outside_text_height, textwidth, 2 /*right align*/, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart1, textpos, default_text_posn, upcae_outside_text_height, textwidth, 2 /*right align*/, &last_string);
                 textpos = 24.0f + xoffset;
                 textwidth = 6.0f * 8.5f;
-                vector_plot_add_string(symbol, textpart2, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart2, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
                 textpos = 51.0f + 3.0f + xoffset;
                 textwidth = 6.2f;
-                vector_plot_add_string(symbol, textpart3, textpos, default_text_posn, upcae_outside_text_height, textwidth, 1 /*left align*/, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart3, textpos, default_text_posn, upcae_outside_text_height, textwidth, 1 /*left align*/, &last_string);
                 textdone = 1;
                 switch (ustrlen(addon)) {
                     case 2:
                         textpos = 61.0f + xoffset + addon_gap;
                         textwidth = 2.0f * 8.5f;
-                        vector_plot_add_string(symbol, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
+                        vector_plot_add_string(symbol, &arena, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
                         break;
                     case 5:
                         textpos = 75.0f + xoffset + addon_gap;
                         textwidth = 5.0f * 8.5f;
-                        vector_plot_add_string(symbol, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
+                        vector_plot_add_string(symbol, &arena, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
                         break;
                 }
 
             } else if (upceanflag == 8) { /* EAN-8 */
                 textpos = 17.0f + xoffset;
                 textwidth = 4.0f * 8.5f;
-                vector_plot_add_string(symbol, textpart1, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart1, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
                 textpos = 50.0f + xoffset;
-                vector_plot_add_string(symbol, textpart2, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart2, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
                 textdone = 1;
                 switch (ustrlen(addon)) {
                     case 2:
                         textpos = 77.0f + xoffset + addon_gap;
                         textwidth = 2.0f * 8.5f;
-                        vector_plot_add_string(symbol, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
+                        vector_plot_add_string(symbol, &arena, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
                         break;
                     case 5:
                         textpos = 91.0f + xoffset + addon_gap;
                         textwidth = 5.0f * 8.5f;
-                        vector_plot_add_string(symbol, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
+                        vector_plot_add_string(symbol, &arena, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
                         break;
                 }
 
             } else if (upceanflag == 12) { /* UPC-A */
                 textpos = -5.0f + xoffset;
                 textwidth = 6.2f;
-                vector_plot_add_string(symbol, textpart1, textpos, default_text_posn, upcae_outside_text_height, textwidth, 2 /*right align*/, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart1, textpos, default_text_posn, upcae_outside_text_height, textwidth, 2 /*right align*/, &last_string);
                 textpos = 27.0f + xoffset;
                 textwidth = 5.0f * 8.5f;
-                vector_plot_add_string(symbol, textpart2, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart2, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
                 textpos = 67.0f + xoffset;
-                vector_plot_add_string(symbol, textpart3, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart3, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
                 textpos = 95.0f + 5.0f + xoffset;
                 textwidth = 6.2f;
-                vector_plot_add_string(symbol, textpart4, textpos, default_text_posn, upcae_outside_text_height, textwidth, 1 /*left align*/, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart4, textpos, default_text_posn, upcae_outside_text_height, textwidth, 1 /*left align*/, &last_string);
                 textdone = 1;
                 switch (ustrlen(addon)) {
                     case 2:
                         textpos = 105.0f + xoffset + addon_gap;
                         textwidth = 2.0f * 8.5f;
-                        vector_plot_add_string(symbol, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
+                        vector_plot_add_string(symbol, &arena, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
                         break;
                     case 5:
                         textpos = 119.0f + xoffset + addon_gap;
                         textwidth = 5.0f * 8.5f;
-                        vector_plot_add_string(symbol, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
+                        vector_plot_add_string(symbol, &arena, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
                         break;
                 }
 
             } else if (upceanflag == 13) { /* EAN-13 */
                 textpos = -5.0f + xoffset;
                 textwidth = 8.5f;
-                vector_plot_add_string(symbol, textpart1, textpos, default_text_posn, text_height, textwidth, 2 /*right align*/, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart1, textpos, default_text_posn, text_height, textwidth, 2 /*right align*/, &last_string);
                 textpos = 24.0f + xoffset;
                 textwidth = 6.0f * 8.5f;
-                vector_plot_add_string(symbol, textpart2, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart2, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
                 textpos = 71.0f + xoffset;
-                vector_plot_add_string(symbol, textpart3, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
+                vector_plot_add_string(symbol, &arena, textpart3, textpos, default_text_posn, text_height, textwidth, 0, &last_string);
                 textdone = 1;
                 switch (ustrlen(addon)) {
                     case 2:
                         textpos = 105.0f + xoffset + addon_gap;
                         textwidth = 2.0f * 8.5f;
-                        vector_plot_add_string(symbol, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
+                        vector_plot_add_string(symbol, &arena, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
                         break;
                     case 5:
                         textpos = 119.0f + xoffset + addon_gap;
                         textwidth = 5.0f * 8.5f;
-                        vector_plot_add_string(symbol, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
+                        vector_plot_add_string(symbol, &arena, addon, textpos, addon_text_posn, text_height, textwidth, 0, &last_string);
                         break;
                 }
             }
@@ -801,7 +1201,7 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
         if (!textdone) {
             /* Put normal human readable text at the bottom (and centered) */
             // calculate start xoffset to center text
-            vector_plot_add_string(symbol, symbol->text, main_width / 2.0f + xoffset, default_text_posn, text_height, symbol->width, 0, &last_string);
+            vector_plot_add_string(symbol, &arena, symbol->text, main_width / 2.0f + xoffset, default_text_posn, text_height, symbol->width, 0, &last_string);
         }
 
         xoffset -= comp_offset; // Restore xoffset
@@ -818,15 +1218,15 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
             if (symbol->symbology != BARCODE_CODABLOCKF && symbol->symbology != BARCODE_HIBC_BLOCKF) {
                 for (r = 1; r < symbol->rows; r++) {
                     row_height = symbol->row_height[r - 1] ? symbol->row_height[r - 1] : large_bar_height;
-                    rectangle = vector_plot_create_rect(xoffset, (r * row_height) + yoffset - sep_height / 2, symbol->width, sep_height);
-                    vector_plot_add_rect(symbol, rectangle, &last_rectangle);
+                    rectangle = vector_plot_create_rect(&arena, xoffset, (r * row_height) + yoffset - sep_height / 2, symbol->width, sep_height);
+                    vector_plot_add_rect(symbol, &arena, rectangle, &last_rectangle);
                 }
             } else {
                 for (r = 1; r < symbol->rows; r++) {
                     /* Avoid 11-module start and 13-module stop chars */
                     row_height = symbol->row_height[r - 1] ? symbol->row_height[r - 1] : large_bar_height;
-                    rectangle = vector_plot_create_rect(xoffset + 11, (r * row_height) + yoffset - sep_height / 2, symbol->width - 24, sep_height);
-                    vector_plot_add_rect(symbol, rectangle, &last_rectangle);
+                    rectangle = vector_plot_create_rect(&arena, xoffset + 11, (r * row_height) + yoffset - sep_height / 2, symbol->width - 24, sep_height);
+                    vector_plot_add_rect(symbol, &arena, rectangle, &last_rectangle);
                 }
             }
         }
@@ -835,57 +1235,128 @@ INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_
         if (symbol->output_options & (BARCODE_BOX | BARCODE_BIND)) {
             float ybind_bottom = vector->height - symbol->border_width - textoffset - symbol->whitespace_height;
             // Top
-            rectangle = vector_plot_create_rect(0.0f, symbol->whitespace_height, vector->width, symbol->border_width);
+            rectangle = vector_plot_create_rect(&arena, 0.0f, symbol->whitespace_height, vector->width, symbol->border_width);
             if (!(symbol->output_options & BARCODE_BOX)
                     && (symbol->symbology == BARCODE_CODABLOCKF || symbol->symbology == BARCODE_HIBC_BLOCKF)) {
                 /* CodaBlockF bind - does not extend over horizontal whitespace */
                 rectangle->x = xoffset;
                 rectangle->width -= (2.0f * xoffset);
             }
-            vector_plot_add_rect(symbol, rectangle, &last_rectangle);
+            vector_plot_add_rect(symbol, &arena, rectangle, &last_rectangle);
             // Bottom
-            rectangle = vector_plot_create_rect(0.0f, ybind_bottom, vector->width, symbol->border_width);
+            rectangle = vector_plot_create_rect(&arena, 0.0f, ybind_bottom, vector->width, symbol->border_width);
             if (!(symbol->output_options & BARCODE_BOX)
                     && (symbol->symbology == BARCODE_CODABLOCKF || symbol->symbology == BARCODE_HIBC_BLOCKF)) {
                 /* CodaBlockF bind - does not extend over horizontal whitespace */
                 rectangle->x = xoffset;
                 rectangle->width -= (2.0f * xoffset);
             }
-            vector_plot_add_rect(symbol, rectangle, &last_rectangle);
+            vector_plot_add_rect(symbol, &arena, rectangle, &last_rectangle);
         }
         if (symbol->output_options & BARCODE_BOX) {
             float xbox_right = vector->width - symbol->border_width;
             float box_height = vector->height - textoffset - (symbol->whitespace_height + symbol->border_width) * 2;
             // Left
-            rectangle = vector_plot_create_rect(0.0f, yoffset, symbol->border_width, box_height);
-            vector_plot_add_rect(symbol, rectangle, &last_rectangle);
+            rectangle = vector_plot_create_rect(&arena, 0.0f, yoffset, symbol->border_width, box_height);
+            vector_plot_add_rect(symbol, &arena, rectangle, &last_rectangle);
             // Right
-            rectangle = vector_plot_create_rect(xbox_right, yoffset, symbol->border_width, box_height);
-            vector_plot_add_rect(symbol, rectangle, &last_rectangle);
+            rectangle = vector_plot_create_rect(&arena, xbox_right, yoffset, symbol->border_width, box_height);
+            vector_plot_add_rect(symbol, &arena, rectangle, &last_rectangle);
         }
     }
 
-    vector_reduce_rectangles(symbol);
+    vector_reduce_rectangles(symbol, &arena);
 
-    vector_scale(symbol, file_type);
-    
-    if (file_type != OUT_EMF_FILE) {
-        /* EMF does its own rotation (with mixed results in various apps) */
-        vector_rotate(symbol, rotate_angle);
+    if (callbacks) {
+        if (!arena.err) {
+            arena.stream = NULL; /* Stream the collected elements, if any */
+            vector_stream_finish(symbol, &stream);
+        }
+        vector_arena_free(&arena);
+        symbol->vector = NULL;
+        return arena.err ? ZINT_ERROR_MEMORY : 0;
     }
 
-    switch (file_type) {
-        case OUT_EPS_FILE:
-            error_number = ps_plot(symbol);
-            break;
-        case OUT_SVG_FILE:
-            error_number = svg_plot(symbol);
-            break;
-        case OUT_EMF_FILE:
-            error_number = emf_plot(symbol, rotate_angle);
-            break;
-        /* case OUT_BUFFER: No more work needed */
+    error_number = vector_arena_finish(symbol, &arena);
+    if (error_number != 0) {
+        return error_number;
     }
 
+    /* Elements left as plotted if wanted and the output can take a transform */
+    vector_transform(symbol, rotate_angle, file_type, !(symbol->output_options & VECTOR_TRANSFORM)
+                        || (file_type != OUT_BUFFER && file_type != OUT_SVG_FILE));
+
+    vector_shared_shapes(symbol->vector);
+
+    return vector_write(symbol, rotate_angle, file_type);
+}
+
+INTERNAL int plot_vector(struct zint_symbol *symbol, int rotate_angle, int file_type) {
+    int error_number;
+
+    z_trace(symbol, ZINT_PHASE_VECTOR, ZINT_TRACE_BEGIN, symbol->rows * symbol->width);
+    error_number = plot_vector_symbol(symbol, rotate_angle, file_type, NULL /*callbacks*/);
+    z_trace(symbol, ZINT_PHASE_VECTOR, ZINT_TRACE_END, error_number >= ZINT_ERROR ? -1 : 0);
+
     return error_number;
 }
+
+/* Pass the elements to `callbacks` as they're plotted instead of building `symbol->vector`, which is left NULL */
+INTERNAL int plot_vector_callbacks(struct zint_symbol *symbol, int rotate_angle,
+            const struct zint_render_callbacks *callbacks) {
+    int error_number;
+
+    z_trace(symbol, ZINT_PHASE_VECTOR, ZINT_TRACE_BEGIN, symbol->rows * symbol->width);
+    error_number = plot_vector_symbol(symbol, rotate_angle, OUT_BUFFER, callbacks);
+    z_trace(symbol, ZINT_PHASE_VECTOR, ZINT_TRACE_END, error_number >= ZINT_ERROR ? -1 : 0);
+
+    return error_number;
+}
+
+/* Group of vector `file_type` by transformed geometry: EMF does its own rotation (and scales up MaxiCode), and SVG
+   takes the transform as is if VECTOR_TRANSFORM, the others sharing the fully transformed elements */
+static int vector_multi_group(const struct zint_symbol *symbol, const int file_type) {
+    if (file_type == OUT_EMF_FILE) {
+        return 1;
+    }
+    if (file_type == OUT_SVG_FILE && (symbol->output_options & VECTOR_TRANSFORM)) {
+        return 2;
+    }
+    return 0;
+}
+
+/* Write the vector `targets` of `count` (others ignored), plotting the vector once for each group of formats
+   sharing the same geometry, then writing it to each of the group. Stops on the first error */
+INTERNAL int plot_vector_multi(struct zint_symbol *symbol, int rotate_angle, const struct out_target *targets,
+            const int count) {
+    const int output_options = symbol->output_options;
+    int warn_number = 0;
+    int group, i;
+
+    for (group = 0; group < 3; group++) {
+        int plotted = 0;
+        for (i = 0; i < count; i++) {
+            int error_number;
+            if (targets[i].file_type >= OUT_PNG_FILE || vector_multi_group(symbol, targets[i].file_type) != group) {
+                continue;
+            }
+            strcpy(symbol->outfile, targets[i].outfile);
+            symbol->output_options = output_options | targets[i].output_options;
+            if (!plotted) {
+                error_number = plot_vector(symbol, rotate_angle, targets[i].file_type);
+                plotted = 1;
+            } else {
+                error_number = vector_write(symbol, rotate_angle, targets[i].file_type);
+            }
+            symbol->output_options = output_options;
+            if (error_number >= ZINT_ERROR) {
+                return error_number;
+            }
+            if (error_number > warn_number) {
+                warn_number = error_number;
+            }
+        }
+    }
+
+    return warn_number;
+}
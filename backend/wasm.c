@@ -0,0 +1,83 @@
+/* wasm.c - WebAssembly (Emscripten) module entry points */
+
+/*
+    libzint - the open source barcode library
+    Copyright (C) 2021 Robin Stuart <rstuart114@gmail.com>
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the project nor the names of its contributors
+       may be used to endorse or promote products derived from this software
+       without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+    HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+    OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+    SUCH DAMAGE.
+ */
+/* vim: set ts=4 sw=4 et : */
+
+/* Only built into the Emscripten module "zint.js" (see "CMakeLists.txt"), giving JavaScript a way to print a symbol
+   to memory (BARCODE_MEMORY_FILE) without having to know the layout of `struct zint_symbol`. The symbol is created
+   and deleted with `ZBarcode_Create()` and `ZBarcode_Delete()`, which are exported as is:
+
+       const zint = await createZint();
+       const symbol = zint._ZBarcode_Create();
+       const error = zint.ccall('zint_wasm_print', 'number',
+                                ['number', 'number', 'string', 'number', 'string', 'number', 'number'],
+                                [symbol, 58, 'Hello', 5, 'svg', 1.0, 0]);
+       const svg = zint.HEAPU8.slice(zint._zint_wasm_memfile(symbol),
+                                      zint._zint_wasm_memfile(symbol) + zint._zint_wasm_memfile_size(symbol));
+       zint._ZBarcode_Delete(symbol);
+ */
+
+#include <string.h>
+#include <emscripten.h>
+#include "common.h"
+
+/* Encode `length` bytes of `data` as `symbology` and print it to memory as file type `filetype` (e.g. "png" or
+   "svg") scaled by `scale` (if > 0) and rotated by `rotate_angle`, returning the error number */
+EMSCRIPTEN_KEEPALIVE int zint_wasm_print(struct zint_symbol *symbol, const int symbology, const unsigned char *data,
+            const int length, const char *filetype, const float scale, const int rotate_angle) {
+    if (!symbol) return ZINT_ERROR_INVALID_DATA;
+
+    if (!filetype || strlen(filetype) > 3) {
+        strcpy(symbol->errtxt, "739: Invalid file type");
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+    symbol->symbology = symbology;
+    if (scale > 0.0f) {
+        symbol->scale = scale;
+    }
+    symbol->output_options |= BARCODE_MEMORY_FILE;
+    strcpy(symbol->outfile, "mem.");
+    strcat(symbol->outfile, filetype);
+
+    return ZBarcode_Encode_and_Print(symbol, (unsigned char *) data, length, rotate_angle);
+}
+
+EMSCRIPTEN_KEEPALIVE const unsigned char *zint_wasm_memfile(const struct zint_symbol *symbol) {
+    return symbol ? symbol->memfile : NULL;
+}
+
+EMSCRIPTEN_KEEPALIVE int zint_wasm_memfile_size(const struct zint_symbol *symbol) {
+    return symbol ? symbol->memfile_size : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE const char *zint_wasm_errtxt(const struct zint_symbol *symbol) {
+    return symbol ? symbol->errtxt : "";
+}
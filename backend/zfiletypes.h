@@ -35,13 +35,21 @@
 
 // File types
 #define OUT_BUFFER              0
+#define OUT_MEASURE             1   /* Bitmap dimensions of OUT_BUFFER only, see `ZBarcode_Measure()` */
 #define OUT_SVG_FILE            10
 #define OUT_EPS_FILE            20
 #define OUT_EMF_FILE            30
+#define OUT_PDF_FILE            40
 #define OUT_PNG_FILE            100
 #define OUT_BMP_FILE            120
 #define OUT_GIF_FILE            140
 #define OUT_PCX_FILE            160
+#define OUT_PBM_FILE            170
+#define OUT_PGM_FILE            175
+#define OUT_ZPL_FILE            176
+#define OUT_EPL_FILE            177
+#define OUT_PCL_FILE            178
+#define OUT_QOI_FILE            179
 #define OUT_JPG_FILE            180
 #define OUT_TIF_FILE            200
 
@@ -33,6 +33,8 @@
 #ifndef ZINT_H
 #define ZINT_H
 
+#include <stddef.h> /* For size_t */
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -71,6 +73,45 @@ extern "C" {
         struct zint_vector_hexagon *hexagons; /* Pointer to first hexagon */
         struct zint_vector_string *strings; /* Points to first string */
         struct zint_vector_circle *circles; /* Points to first circle */
+        /* Each of the above is a contiguous array of the following number of elements (linked in order by `next`) */
+        int rectangles_count;
+        int hexagons_count;
+        int strings_count;
+        int circles_count;
+        /* Non-zero if all hexagons are the same shape (diameter and rotation), when it's their common diameter and
+           the hexagons may be drawn as copies of the first centred on each x, y. Likewise circles (diameter and
+           colour) */
+        float hexagons_diameter;
+        float circles_diameter;
+        /* Affine transform (a, b, c, d, e, f) from element co-ordinates to output ones, x' = a * x + c * y + e,
+           y' = b * x + d * y + f. Identity unless VECTOR_TRANSFORM set, when the elements are left unscaled and
+           unrotated (`width` and `height` are always the output dimensions) */
+        float transform[6];
+    };
+
+    /* Structured trace record, kept if `debug` ZINT_DEBUG_TRACE set, see `ZBarcode_Trace_Record()` */
+    struct zint_trace_record {
+        int phase; /* ZINT_PHASE_XXX in which recorded */
+        int kind; /* ZINT_RECORD_XXX */
+        int values[4]; /* Depend on `kind`, see below */
+    };
+
+    /* Memory allocator of a symbol, see `ZBarcode_Create_Allocator()`. `context` is passed to each function */
+    struct zint_allocator {
+        void *(*malloc_fn)(void *context, size_t size); /* As `malloc()` */
+        void *(*realloc_fn)(void *context, void *ptr, size_t size); /* As `realloc()` */
+        void (*free_fn)(void *context, void *ptr); /* As `free()`, never called with NULL `ptr` */
+        void *context;
+    };
+
+    /* Opaque library-private state of a symbol (its modules and working buffers) */
+    struct zint_internal;
+
+    /* Structured Append info - ignored unless `zint_structapp.count` non-zero */
+    struct zint_structapp {
+        int index; /* Position in Structured Append sequence, 1-based. Must be <= `count` */
+        int count; /* Number of symbols in Structured Append sequence. Set >= 2 to add SA Info */
+        char id[32]; /* Optional ID to distinguish sequence, ASCII, NUL-terminated unless 32 long */
     };
 
     struct zint_symbol {
@@ -97,7 +138,6 @@ extern "C" {
         int rows;
         int width;
         char primary[128];
-        unsigned char encoded_data[200][143];
         int row_height[200]; /* Largest symbol is 189 x 189 Han Xin */
         char errtxt[100];
         unsigned char *bitmap;
@@ -109,6 +149,121 @@ extern "C" {
         struct zint_vector *vector;
         int debug;
         int warn_level;
+        unsigned char *memfile; /* Output file in memory if BARCODE_MEMORY_FILE set */
+        int memfile_size; /* Length of `memfile` */
+        /* Output callback if BARCODE_WRITE_FUNC set, called with `write_context`, returns 0 on success */
+        int (*write_func)(void *write_context, const unsigned char *data, int length);
+        void *write_context;
+        /* Instrumentation callback if set, called with `trace_context` at the begin and end (`event`
+           ZINT_TRACE_BEGIN/END) of each processing phase (`phase` ZINT_PHASE_XXX), see below for `length` */
+        void (*trace_func)(void *trace_context, const struct zint_symbol *symbol, int phase, int event, int length);
+        void *trace_context;
+        int trace_record_count; /* Trace records made if `debug` ZINT_DEBUG_TRACE, see `ZBarcode_Trace_Record()` */
+        struct zint_structapp structapp; /* Structured Append info */
+        /* `fgcolour` and `bgcolour` parsed as 0xRRGGBBAA (alpha 0xFF if none) once checked, either on output or by
+           `ZBarcode_Set_Colours()` (output only) */
+        unsigned int fgcolour_rgba;
+        unsigned int bgcolour_rgba;
+        /* Time budget in milliseconds of each encode (0 for none). Once past it, mode optimisation and mask
+           selection (QR Code, rMQR, Han Xin, Data Matrix MINIMAL_MODE) fall back to faster choices, which may give a
+           larger symbol, with warning ZINT_WARN_TIME_BUDGET */
+        int time_budget_ms;
+        struct zint_internal *internal; /* Library-private state, allocated with the symbol */
+    };
+
+    /* Sizes found by `ZBarcode_Measure()` */
+    struct zint_measure {
+        int rows; /* Size in modules */
+        int width;
+        int height; /* Height in X-dimensions */
+        int version; /* Version or size chosen, as `option_2` (0 if none) */
+        int ecc_level; /* Error correction level, as `option_1` (-1 if none or unknown) */
+        int data_codewords; /* Data codewords including padding (-1 if unknown) */
+        int ecc_codewords; /* Error correction codewords (-1 if unknown) */
+        int bitmap_width; /* Dimensions of the `ZBarcode_Buffer()` bitmap */
+        int bitmap_height;
+    };
+
+    /* GS1 Application Identifier and its data for `ZBarcode_Encode_GS1()` */
+    struct zint_gs1_element {
+        int ai; /* AI as a number, e.g. 1 for "01", 8004 for "8004" */
+        const unsigned char *data;
+        int length; /* Length of `data`, or -1 if NUL-terminated */
+    };
+
+    /* Caller's pixel buffer for `ZBarcode_Buffer_Target()` to render into */
+    struct zint_target {
+        unsigned char *pixels; /* Start of first row */
+        int stride; /* Bytes from one row to the next */
+        int width; /* Size in pixels */
+        int height;
+        int format; /* ZINT_PIXEL_XXX */
+        int x; /* Position of the symbol's top left pixel, which must fit entirely within the buffer */
+        int y;
+    };
+
+    /* Encoded symbol placed on a sheet by `ZBarcode_Print_Sheet()` */
+    struct zint_sheet_item {
+        struct zint_symbol *symbol;
+        int x; /* Position in pixels on the sheet of the (rotated) symbol's top left pixel */
+        int y;
+        int rotate_angle;
+    };
+
+    /* Callbacks for `ZBarcode_Render_Callbacks()`, each called with `context` and optional (if NULL skipped). The
+       elements are in output co-ordinates (scaled and rotated), `next` NULL, and only valid for the call */
+    struct zint_render_callbacks {
+        void *context;
+        void (*begin)(void *context, float width, float height); /* Output dimensions, called first */
+        void (*rect)(void *context, const struct zint_vector_rect *rect);
+        /* Runs of up to 64 consecutive rectangles, called instead of `rect` if set */
+        void (*rects)(void *context, const struct zint_vector_rect *rects, int count);
+        void (*hexagon)(void *context, const struct zint_vector_hexagon *hexagon);
+        void (*circle)(void *context, const struct zint_vector_circle *circle);
+        void (*string)(void *context, const struct zint_vector_string *string);
+    };
+
+    /* Right-sized copy of an encoded symbol's modules, as returned by `ZBarcode_Modules()` */
+    struct zint_modules {
+        int symbology;
+        int height;
+        int rows;
+        int width;
+        int row_stride; /* Bytes per row of `data` */
+        int *row_height; /* Array of `rows` row heights */
+        unsigned char *data; /* `rows` x `row_stride` bytes, bit-packed LSB first (Ultracode byte per module) */
+        unsigned char *text; /* Human readable text (UTF-8) */
+        int *run_offset; /* `ZBarcode_Export_Modules()` only: array of `rows` + 1 offsets into `runs` of each row */
+        int *runs; /* `ZBarcode_Export_Modules()` only: run-lengths, alternately space & bar, starting with space */
+    };
+
+    /* Opaque prepared encoder, see `ZBarcode_Prepare()` */
+    struct zint_prepared;
+
+    /* Opaque background request, see `ZBarcode_Submit()` */
+    struct zint_request;
+
+    /* Opaque incremental encoder state, see `ZBarcode_Incremental_Create()` */
+    struct zint_incremental;
+
+    /* Input item for `ZBarcode_Encode_Batch()` */
+    struct zint_batch_item {
+        const unsigned char *source; /* Input data */
+        int length; /* Length of `source`, or 0 if NUL-terminated */
+        int error_number; /* Result of encoding (output only) */
+        char errtxt[100]; /* Error message if any (output only) */
+    };
+
+    /* Generated data for `ZBarcode_Encode_Sequence()`, item `i` being `prefix`, the counter `start + i * step`
+       (padded to at least `width` digits with `pad`), an optional check digit and then `suffix` */
+    struct zint_sequence {
+        const char *prefix; /* NUL-terminated, may be NULL */
+        const char *suffix; /* NUL-terminated, may be NULL */
+        long start; /* First counter value, >= 0 */
+        long step; /* Counter increment, which may be 0 or negative (if all values stay >= 0) */
+        int width; /* Minimum number of counter characters (0-20) */
+        char pad; /* Character padding counter to `width`, '0' if NUL */
+        int check_digit; /* SEQUENCE_CHECK_XXX */
     };
 
 // Symbologies (symbology)
@@ -248,6 +403,26 @@ extern "C" {
 #define BARCODE_DOTTY_MODE      256
 #define GS1_GS_SEPARATOR        512
 #define OUT_BUFFER_INTERMEDIATE 1024
+#define BARCODE_MEMORY_FILE     2048 /* Output file to memory `memfile` instead of `outfile` */
+#define BARCODE_WRITE_FUNC      4096 /* Output file through callback `write_func` instead of `outfile` */
+#define OUT_BUFFER_1BPP         8192 /* Return bitmap packed 1 bit per pixel, rows padded to a byte */
+#define BARCODE_FAST_COMPRESS   16384 /* Favour speed over size when compressing output (PNG, SVGZ) */
+#define TIFF_PACKBITS           32768 /* Compress TIFF output using PackBits instead of LZW */
+#define TIFF_CCITT_G4           65536 /* Compress bilevel TIFF output using CCITT Group 4 instead of LZW */
+#define BMP_RLE8                131072 /* Run-length encode BMP output (8-bit BI_RLE8) */
+#define SVG_COMPACT             262144 /* Merge SVG elements of the same colour into paths */
+#define EPS_COMPACT             524288 /* Draw EPS rows of bars and hexagons/circles using short procedures */
+#define EMF_COMPACT             1048576 /* Batch EMF rectangles and hexagons into a polypolygon per colour */
+#define BARCODE_ANTIALIAS       2097152 /* Anti-alias buffer and PNG output at scales not a multiple of 0.5 */
+#define OUT_BUFFER_RGBA         4194304 /* Return bitmap 4 bytes per pixel RGBA, alpha interleaved, no alphamap */
+#define BARCODE_NO_HRT          8388608 /* Encode modules only, leaving `text` empty (except EAN/UPC) */
+#define VECTOR_TRANSFORM        16777216 /* Leave vector elements unscaled & unrotated, see `zint_vector.transform` */
+#define PNG_PARALLEL            33554432 /* Deflate large PNG output in bands of rows on multiple threads */
+#define RASTER_PARALLEL         67108864 /* Render large raster output in bands of lines on multiple threads */
+#define OUT_FILE_MMAP           134217728 /* Plot uncompressed BMP and PBM/PGM output straight into the memory-mapped,
+                                             pre-sized file */
+#define SVG_GZIP                268435456 /* Compress SVG output with gzip as it's written (SVGZ), also set by
+                                             extension ".svgz" */
 
 // Input data types (input_mode)
 #define DATA_MODE               0
@@ -255,6 +430,16 @@ extern "C" {
 #define GS1_MODE                2
 #define ESCAPE_MODE             8
 #define GS1PARENS_MODE          16
+#define MINIMAL_MODE            32 /* Code 128/16K/49/PDF417/Data Matrix/Code One: choose modes for fewest codewords */
+#define GS1NOCHECK_MODE         64 /* Do not check GS1 AI data (bracket structure still checked) */
+#define FAST_MODE               128 /* QR Code/rMQR/Han Xin: choose modes in a single greedy pass (may be larger) */
+#define MULTI_ECI_MODE          256 /* QR Code: if no single ECI encodes the data, switch ECIs within it where that
+                                       makes for a smaller symbol than UTF-8 */
+
+// Sequence check digits (`zint_sequence.check_digit`)
+#define SEQUENCE_CHECK_NONE     0
+#define SEQUENCE_CHECK_GS1      1 /* GS1 Mod 10 of the counter and any digits of `prefix` directly before it */
+#define SEQUENCE_CHECK_LUHN     2 /* Luhn Mod 10 of the same digits */
 
 // Data Matrix specific options (option_3)
 #define DM_SQUARE               100
@@ -267,6 +452,7 @@ extern "C" {
 #define ULTRA_COMPRESSION       128
 
 // Warning and error conditions (return values)
+#define ZINT_WARN_TIME_BUDGET           1 /* Past `time_budget_ms`, faster (possibly larger) encoding used */
 #define ZINT_WARN_INVALID_OPTION        2
 #define ZINT_WARN_USES_ECI              3
 #define ZINT_WARN_NONCOMPLIANT          4
@@ -279,12 +465,20 @@ extern "C" {
 #define ZINT_ERROR_FILE_ACCESS          10
 #define ZINT_ERROR_MEMORY               11
 #define ZINT_ERROR_FILE_WRITE           12
+#define ZINT_ERROR_CANCELLED            13 /* Request of `ZBarcode_Submit()` cancelled or past its deadline */
 
 // Warning warn (warn_level)
 #define WARN_DEFAULT     0
 #define WARN_ZPL_COMPAT  1
 #define WARN_FAIL_ALL    2
 
+// Pixel formats (zint_target format)
+#define ZINT_PIXEL_GRAY8        1 /* 8-bit luminance */
+#define ZINT_PIXEL_MONO1        2 /* 1 bit per pixel, set for foreground, MSB first */
+#define ZINT_PIXEL_RGB24        3 /* 3 bytes per pixel R, G, B (alpha ignored) */
+#define ZINT_PIXEL_RGBA32       4 /* 4 bytes per pixel R, G, B, A */
+#define ZINT_PIXEL_BGRA32       5 /* 4 bytes per pixel B, G, R, A */
+
 // Capability flags (cap_flag)
 #define ZINT_CAP_HRT            0x0001
 #define ZINT_CAP_STACKABLE      0x0002
@@ -297,13 +491,50 @@ extern "C" {
 #define ZINT_CAP_READER_INIT    0x0200
 #define ZINT_CAP_FULL_MULTIBYTE 0x0400
 #define ZINT_CAP_MASK           0x0800
+#define ZINT_CAP_STRUCTAPP      0x1000 /* Structured Append */
 
 // The largest amount of data that can be encoded is 4350 4-byte UTF-8 chars in Han Xin Code
 #define ZINT_MAX_DATA_LEN       17400
 
+// Instrumentation phases (`trace_func` phase). At ZINT_TRACE_BEGIN `length` is the size of the phase's input, at
+// ZINT_TRACE_END the size of its output, or -1 if the phase failed. Phases may nest (e.g. ZINT_PHASE_OUTPUT within
+// ZINT_PHASE_RASTER) and repeat (e.g. ZINT_PHASE_ENCODE if another ECI is tried). The callback takes any timestamps
+#define ZINT_PHASE_PREPROCESS   1  /* UTF-8 validation, escape sequences and BOM (bytes in, bytes out) */
+#define ZINT_PHASE_GS1          2  /* GS1 verification (bytes in, reduced bytes out) */
+#define ZINT_PHASE_ECI          3  /* Conversion from UTF-8 (bytes in, characters out) */
+#define ZINT_PHASE_ENCODE       4  /* Symbology encoding (bytes in, modules out) */
+#define ZINT_PHASE_MODES        5  /* Mode optimisation (characters in, estimated data bytes out) */
+#define ZINT_PHASE_RS           6  /* Reed-Solomon error correction (data codewords in, total codewords out) */
+#define ZINT_PHASE_MASK         7  /* Mask selection (modules in, modules out) */
+#define ZINT_PHASE_RASTER       8  /* Raster rendering (modules in, pixels out) */
+#define ZINT_PHASE_VECTOR       9  /* Vector rendering (modules in, 0 out) */
+#define ZINT_PHASE_OUTPUT       10 /* File output, from open to close (0 in, bytes written out) */
+
+// Instrumentation events (`trace_func` event)
+#define ZINT_TRACE_BEGIN        0
+#define ZINT_TRACE_END          1
+
+// Structured trace record kinds (`zint_trace_record` kind), with their values. Modes are symbology-specific
+// characters, e.g. QR Code 'N', 'A', 'B', 'K' (Numeric, Alphanumeric, Byte, Kanji), Code 128 the set 'A', 'B', 'C'
+// (with 'a', 'b' for shifts), Data Matrix 'A', 'C', 'T', 'X', 'E', 'B' (ASCII, C40, Text, X12, EDIFACT, Base 256)
+#define ZINT_RECORD_MODE        1  /* Mode: mode, start position, length (-1 if unknown), codeword position (or -1) */
+#define ZINT_RECORD_SIZE        2  /* Chosen size: version (or 0), rows, columns, ECC level (or -1) */
+#define ZINT_RECORD_CODEWORDS   3  /* Codewords: data (including padding), ECC, data before padding (or -1), 0 */
+#define ZINT_RECORD_PENALTY     4  /* Mask evaluated: mask, penalty (score if Micro QR or DotCode), 0, 0 */
+#define ZINT_RECORD_MASK        5  /* Mask chosen: mask, penalty (or score, -1 if specified), specified, 0 */
+
+// Table groups made resident by `ZBarcode_Init()`
+#define ZINT_INIT_RS            0x0001 /* Reed-Solomon log tables */
+#define ZINT_INIT_ECI           0x0002 /* Character set conversion (single-byte ECIs, Shift JIS, GB 2312, GB 18030,
+                                          Big5, KS X 1001) */
+#define ZINT_INIT_SYMBOLOGY     0x0004 /* Symbology tables (Aztec Code, PDF417, Code 49, Han Xin) */
+#define ZINT_INIT_FONTS         0x0008 /* Raster fonts */
+#define ZINT_INIT_ALL           0x000F
+
 // Debug flags (debug)
 #define ZINT_DEBUG_PRINT        1
 #define ZINT_DEBUG_TEST         2
+#define ZINT_DEBUG_TRACE        4  /* Keep structured trace records (`ZBarcode_Trace_Record()`) */
 
 #if defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_MSC_VER)
 #if defined (DLL_EXPORT) || defined(PIC) || defined(_USRDLL)
@@ -318,18 +549,51 @@ extern "C" {
 #endif
 
     ZINT_EXTERN struct zint_symbol *ZBarcode_Create(void);
+    ZINT_EXTERN struct zint_symbol *ZBarcode_Create_Allocator(const struct zint_allocator *allocator);
     ZINT_EXTERN void ZBarcode_Clear(struct zint_symbol *symbol);
     ZINT_EXTERN void ZBarcode_Delete(struct zint_symbol *symbol);
 
     ZINT_EXTERN int ZBarcode_Encode(struct zint_symbol *symbol, const unsigned char *source, int in_length);
+    ZINT_EXTERN int ZBarcode_Encode_GS1(struct zint_symbol *symbol, const struct zint_gs1_element *elements,
+                int count);
+    ZINT_EXTERN int ZBarcode_Encode_Batch(struct zint_symbol *symbol, struct zint_batch_item items[], int count,
+                int (*item_func)(void *context, struct zint_symbol *symbol, int index, int error_number),
+                void *context);
+    ZINT_EXTERN int ZBarcode_Encode_Sequence(struct zint_symbol *symbol, const struct zint_sequence *sequence,
+                int count, int (*item_func)(void *context, struct zint_symbol *symbol, int index, int error_number),
+                void *context);
+    ZINT_EXTERN int ZBarcode_Prepare(struct zint_symbol *symbol, struct zint_prepared **p_prepared);
+    ZINT_EXTERN int ZBarcode_Encode_Prepared(const struct zint_prepared *prepared, struct zint_symbol *symbol,
+                const unsigned char *source, int in_length);
+    ZINT_EXTERN void ZBarcode_Prepared_Delete(struct zint_prepared *prepared);
+    ZINT_EXTERN int ZBarcode_Encode_Structapp(struct zint_symbol *symbol, const unsigned char *source, int in_length,
+                int threads, struct zint_symbol ***p_symbols, int *p_count);
+    ZINT_EXTERN void ZBarcode_Structapp_Delete(struct zint_symbol **symbols, int count);
     ZINT_EXTERN int ZBarcode_Encode_File(struct zint_symbol *symbol, char *filename);
     ZINT_EXTERN int ZBarcode_Print(struct zint_symbol *symbol, int rotate_angle);
+    ZINT_EXTERN int ZBarcode_Print_PDF(struct zint_symbol *symbols[], int count, int rotate_angle);
+    ZINT_EXTERN int ZBarcode_Print_TIF(struct zint_symbol *symbols[], int count, int rotate_angle);
     ZINT_EXTERN int ZBarcode_Encode_and_Print(struct zint_symbol *symbol, unsigned char *input, int length,
                         int rotate_angle);
     ZINT_EXTERN int ZBarcode_Encode_File_and_Print(struct zint_symbol *symbol, char *filename, int rotate_angle);
+    ZINT_EXTERN struct zint_request *ZBarcode_Submit(struct zint_symbol *symbol, const unsigned char *source,
+                int in_length, int rotate_angle, int timeout_ms,
+                void (*callback)(void *user_data, struct zint_symbol *symbol, int error_number), void *user_data);
+    ZINT_EXTERN int ZBarcode_Cancel(struct zint_request *request);
+    ZINT_EXTERN void ZBarcode_Request_Delete(struct zint_request *request);
 
     ZINT_EXTERN int ZBarcode_Buffer(struct zint_symbol *symbol, int rotate_angle);
     ZINT_EXTERN int ZBarcode_Buffer_Vector(struct zint_symbol *symbol, int rotate_angle);
+    ZINT_EXTERN int ZBarcode_Render_Callbacks(struct zint_symbol *symbol, int rotate_angle,
+                        const struct zint_render_callbacks *callbacks);
+    ZINT_EXTERN int ZBarcode_Buffer_Target(struct zint_symbol *symbol, int rotate_angle,
+                        const struct zint_target *target);
+    ZINT_EXTERN int ZBarcode_Buffer_Fit(struct zint_symbol *symbol, int rotate_angle, int max_width, int max_height,
+                        int integer_modules_only);
+    ZINT_EXTERN int ZBarcode_Print_Multi(struct zint_symbol *symbol, int rotate_angle, const char *const *outfiles,
+                        int count);
+    ZINT_EXTERN int ZBarcode_Print_Sheet(struct zint_symbol *sheet, int width, int height,
+                        const struct zint_sheet_item *items, int count);
     ZINT_EXTERN int ZBarcode_Encode_and_Buffer(struct zint_symbol *symbol, unsigned char *input, int length,
                         int rotate_angle);
     ZINT_EXTERN int ZBarcode_Encode_and_Buffer_Vector(struct zint_symbol *symbol, unsigned char *input, int length,
@@ -338,8 +602,38 @@ extern "C" {
     ZINT_EXTERN int ZBarcode_Encode_File_and_Buffer_Vector(struct zint_symbol *symbol, char *filename,
                         int rotate_angle);
 
+    ZINT_EXTERN int ZBarcode_Measure(struct zint_symbol *symbol, const unsigned char *source, int in_length,
+                int rotate_angle, struct zint_measure *measure);
+
+    ZINT_EXTERN struct zint_modules *ZBarcode_Modules(const struct zint_symbol *symbol);
+    ZINT_EXTERN struct zint_modules *ZBarcode_Export_Modules(const struct zint_symbol *symbol);
+    ZINT_EXTERN int ZBarcode_Load_Modules(struct zint_symbol *symbol, const struct zint_modules *modules);
+    ZINT_EXTERN void ZBarcode_Modules_Delete(struct zint_modules *modules);
+
+    ZINT_EXTERN int ZBarcode_Serialize(const struct zint_symbol *symbol, unsigned char **p_buffer, int *p_size);
+    ZINT_EXTERN int ZBarcode_Deserialize(struct zint_symbol *symbol, const unsigned char *buffer, int size);
+    ZINT_EXTERN void ZBarcode_Serialize_Delete(unsigned char *buffer);
+    ZINT_EXTERN int ZBarcode_Content_Hash(const struct zint_symbol *symbol, const unsigned char *source,
+                int in_length, char hash[17]);
+
+    ZINT_EXTERN struct zint_incremental *ZBarcode_Incremental_Create(void);
+    ZINT_EXTERN int ZBarcode_Encode_Incremental(struct zint_incremental *incremental, struct zint_symbol *symbol,
+                const unsigned char *source, int in_length);
+    ZINT_EXTERN void ZBarcode_Incremental_Delete(struct zint_incremental *incremental);
+
+    ZINT_EXTERN const struct zint_trace_record *ZBarcode_Trace_Record(const struct zint_symbol *symbol, int index);
+
+    ZINT_EXTERN int ZBarcode_SetExecutor(struct zint_symbol *symbol, int (*run_fn)(void *context,
+                void (*task_fn)(void *arg, int index), void *arg, int count, int max_threads), void *context);
+
+    ZINT_EXTERN int ZBarcode_Set_Colours(struct zint_symbol *symbol, const char *fgcolour, const char *bgcolour);
+
     ZINT_EXTERN int ZBarcode_ValidID(int symbol_id);
     ZINT_EXTERN unsigned int ZBarcode_Cap(int symbol_id, unsigned int cap_flag);
+
+    ZINT_EXTERN int ZBarcode_Init(int flags);
+    ZINT_EXTERN int ZBarcode_Init_Memory(int flags);
+
     ZINT_EXTERN int ZBarcode_Version();
 
 #ifdef __cplusplus
@@ -0,0 +1,13 @@
+# all.tcl --
+#
+# Runs all the zint Tcl binding tests, e.g. "make test" in the build
+# directory, passing any TESTFLAGS to tcltest
+
+package prefer latest
+package require Tcl 8.5
+package require tcltest 2.2
+namespace import ::tcltest::*
+
+configure {*}$argv -testdir [file dirname [file normalize [info script]]]
+runAllTests
+exit
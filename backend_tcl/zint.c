@@ -117,6 +117,9 @@
 - Added -vwhitesp option
 2021-05-28 GL
 - -cols maximum changed from 108 to 200 (DotCode)
+2021-06-14 GL
+- Added symbol objects "zint symbol create" keeping the decoded options, and
+  "zint encodebatch" to encode a list of data with options checked once only
 */
 
 #if defined(__WIN32__) || defined(_WIN32) || defined(WIN32)
@@ -172,12 +175,43 @@
 EXPORT int Zint_Init (Tcl_Interp *interp);
 EXPORT int Zint_Unload (Tcl_Interp *Interp, int Flags);
 /*----------------------------------------------------------------------------*/
+/* >>>> local types */
+
+/* Options not held in the symbol, or only applied depending on the symbology
+ * once all options are decoded */
+struct EncodeOptions {
+    int rotate_angle;
+    int destX0;
+    int destY0;
+    int destWidth;
+    int destHeight;
+    int fFullMultiByte;
+    int addon_gap;
+    int Separator;
+    int Mask;
+};
+
+/* Symbol object created by "zint symbol create" */
+struct SymbolObject {
+    struct zint_symbol *settings;   /* Configured by the options, not encoded */
+    struct zint_symbol *symbol;     /* Encoded, re-used for each call */
+    struct EncodeOptions options;
+    Tcl_Encoding hZINTEncoding;
+    int *tkFlagPtr;
+    Tcl_Command token;
+};
+/*----------------------------------------------------------------------------*/
 /* >>>> local prototypes */
 static void InterpCleanupProc(ClientData clientData, Tcl_Interp *interp);
 static int CheckForTk(Tcl_Interp *interp, int *tkFlagPtr);
 static int Zint(ClientData unused, Tcl_Interp *interp, int objc,
     Tcl_Obj *CONST objv[]);
 static int Encode(Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[], int fBatch);
+static int SymbolCreate(Tcl_Interp *interp, int *tkFlagPtr, int objc,
+    Tcl_Obj *CONST objv[]);
+static void SymbolDelete(ClientData clientData);
+static int SymbolCmd(ClientData clientData, Tcl_Interp *interp, int objc,
     Tcl_Obj *CONST objv[]);
 /*----------------------------------------------------------------------------*/
 /* >>>> File Global Variables */
@@ -483,6 +517,16 @@ static char help_message[] = "zint tcl(stub,obj) dll\n"
     "   -wzpl bool: ZPL compatibility mode (allows non-standard symbols)\n"
     "   -to {x0 y0 ?width? ?height?}: place to put in photo image\n"
     "\n"
+    "zint encodebatch dataList photoList ?option value? ...\n"
+    "  Encode each data of dataList into the photo at the same position of\n"
+    "  photoList with the same options, which are checked once only.\n"
+    "  Returns a list of the message of each data (empty if none).\n"
+    "zint symbol create name ?option value? ...\n"
+    "  Create a symbol object command 'name' keeping the decoded options:\n"
+    "  name configure ?option value? ...: change options\n"
+    "  name encode data photo: as 'zint encode' with the symbol's options\n"
+    "  name encodebatch dataList photoList: as 'zint encodebatch'\n"
+    "  name destroy: delete the symbol object\n"
     "zint symbologies: List available symbologies\n"
     "zint eci: List available eci tables\n"
     "zint help\n"
@@ -552,14 +596,16 @@ static int Zint(ClientData tkFlagPtr, Tcl_Interp *interp, int objc,
     Tcl_Obj *CONST objv[])
 {
     /* Option list and indexes */
-    enum iCommand {iEncode, iSymbologies, iECI, iVersion, iHelp};
+    enum iCommand {iEncode, iEncodeBatch, iSymbol, iSymbologies, iECI,
+        iVersion, iHelp};
     /* choice of option */
     int Index;
     /*------------------------------------------------------------------------*/
     /* > Check if option argument is given and decode it */
     if (objc > 1)
     {
-    char *subCmds[] = {"encode", "symbologies", "eci", "version", "help", NULL};
+    char *subCmds[] = {"encode", "encodebatch", "symbol", "symbologies",
+        "eci", "version", "help", NULL};
         if(Tcl_GetIndexFromObj(interp, objv[1], (const char **) subCmds,
             "option", 0, &Index)
             == TCL_ERROR)
@@ -579,7 +625,14 @@ static int Zint(ClientData tkFlagPtr, Tcl_Interp *interp, int objc,
         if (CheckForTk(interp, (int *)tkFlagPtr) != TCL_OK) {
             return TCL_ERROR;
         }
-        return Encode(interp, objc, objv);
+        return Encode(interp, objc, objv, 0);
+    case iEncodeBatch:
+        if (CheckForTk(interp, (int *)tkFlagPtr) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        return Encode(interp, objc, objv, 1);
+    case iSymbol:
+        return SymbolCreate(interp, (int *)tkFlagPtr, objc, objv);
     case iSymbologies:
         {
             Tcl_Obj *oRes;
@@ -648,53 +701,30 @@ static int CheckForTk(Tcl_Interp *interp, int *tkFlagPtr)
     *tkFlagPtr = 1;
     return TCL_OK;
 }/*----------------------------------------------------------------------------*/
-/* >>>>> Encode */
 /*----------------------------------------------------------------------------*/
-/* Encode image */
-static int Encode(Tcl_Interp *interp, int objc,
-    Tcl_Obj *CONST objv[])
+/* >>>>> Options */
+/*----------------------------------------------------------------------------*/
+/* Initialise the options not held in the symbol to their defaults */
+static void InitOptions(struct EncodeOptions *opts)
+{
+    memset(opts, 0, sizeof(struct EncodeOptions));
+    opts->Separator = 1;
+}
+/*----------------------------------------------------------------------------*/
+/* Decode the option value pairs objv[optionPos..objc-1] into the symbol and */
+/* the other options. */
+static int DecodeOptions(Tcl_Interp *interp, Tcl_Encoding hZINTEncoding,
+    int objc, Tcl_Obj *CONST objv[], int optionPos,
+    struct zint_symbol *my_symbol, struct EncodeOptions *opts)
 {
-    struct zint_symbol *my_symbol;
-    Tcl_DString dsInput;
     char *pStr = NULL;
     int lStr;
-    Tcl_Encoding hZINTEncoding;
-    int rotate_angle=0;
     int fError = 0;
     Tcl_DString dString;
-    int optionPos;
-    int destX0 = 0;
-    int destY0 = 0;
-    int destWidth = 0;
-    int destHeight = 0;
     int ECIIndex = 0;
-    int fFullMultiByte = 0;
-    int addon_gap = 0;
-    int Separator = 1;
-    int Mask = 0;
-    unsigned int cap;
-    /*------------------------------------------------------------------------*/
-    /* >> Check if at least data and object is given and a pair number of */
-    /* >> options */
-    if ( objc < 4 || (objc % 2) != 0 )
-    {
-        Tcl_WrongNumArgs(interp, 2, objv, "data photo ?-switch value?...");
-        return TCL_ERROR;
-    }
-    /*------------------------------------------------------------------------*/
-    /* >>> Prepare encoding */
-    hZINTEncoding = Tcl_GetEncoding(interp, "utf-8");
-    if (NULL == hZINTEncoding) {
-        return TCL_ERROR;
-    }
-    /*------------------------------------------------------------------------*/
-    /* >>> Prepare zint object */
-    my_symbol = ZBarcode_Create();
-    my_symbol->input_mode = UNICODE_MODE;
-    my_symbol->option_3 = 0;
     /*------------------------------------------------------------------------*/
     /* >> Decode options */
-    for (optionPos = 4; optionPos < objc; optionPos+=2) {
+    for (; optionPos < objc; optionPos+=2) {
         /*--------------------------------------------------------------------*/
         /* Option list and indexes */
         char *optionList[] = {
@@ -815,7 +845,7 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("Invalid add-on gap value not within 7 to 12", -1));
                 fError = 1;
             } else {
-                addon_gap = intValue;
+                opts->addon_gap = intValue;
             }
             break;
         case iBind:
@@ -870,7 +900,7 @@ static int Encode(Tcl_Interp *interp, int objc,
             }
             break;
         case iFullMultiByte:
-            fFullMultiByte = intValue;
+            opts->fFullMultiByte = intValue;
             break;
         case iECI:
             if(Tcl_GetIndexFromObj(interp, objv[optionPos+1],
@@ -971,7 +1001,7 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("Separator out of range", -1));
                 fError = 1;
             } else {
-                Separator = intValue;
+                opts->Separator = intValue;
             }
             break;
         case iMask:
@@ -980,7 +1010,7 @@ static int Encode(Tcl_Interp *interp, int objc,
                     Tcl_NewStringObj("Mask out of range", -1));
                 fError = 1;
             } else {
-                Mask = intValue + 1;
+                opts->Mask = intValue + 1;
             }
             break;
         case iSCMvv:
@@ -1041,10 +1071,10 @@ static int Encode(Tcl_Interp *interp, int objc,
                     break;
                 }
                 switch (intValue) {
-                    case iRotate90: rotate_angle = 90; break;
-                    case iRotate180: rotate_angle = 180; break;
-                    case iRotate270: rotate_angle = 270; break;
-                    default: rotate_angle = 0; break;
+                    case iRotate90: opts->rotate_angle = 90; break;
+                    case iRotate180: opts->rotate_angle = 180; break;
+                    case iRotate270: opts->rotate_angle = 270; break;
+                    default: opts->rotate_angle = 0; break;
                 }
             }
             break;
@@ -1080,19 +1110,19 @@ static int Encode(Tcl_Interp *interp, int objc,
                 } else if ((
                     TCL_OK != Tcl_ListObjIndex(interp, objv[optionPos+1],
                         0, &poParam)
-                    || TCL_OK != Tcl_GetIntFromObj(interp,poParam,&destX0)
+                    || TCL_OK != Tcl_GetIntFromObj(interp,poParam,&opts->destX0)
                     || TCL_OK != Tcl_ListObjIndex(interp, objv[optionPos+1],
                         1, &poParam)
-                    || TCL_OK != Tcl_GetIntFromObj(interp,poParam,&destY0)
+                    || TCL_OK != Tcl_GetIntFromObj(interp,poParam,&opts->destY0)
                     || lStr == 4) && (
                     TCL_OK != Tcl_ListObjIndex(interp, objv[optionPos+1],
                         2, &poParam)
                     || TCL_OK != Tcl_GetIntFromObj(interp,poParam,
-                        &destWidth)
+                        &opts->destWidth)
                     || TCL_OK != Tcl_ListObjIndex(interp, objv[optionPos+1],
                         3, &poParam)
                     || TCL_OK != Tcl_GetIntFromObj(interp,poParam,
-                        &destHeight)
+                        &opts->destHeight)
                     ))
                 {
                     fError = 1;
@@ -1122,6 +1152,18 @@ static int Encode(Tcl_Interp *interp, int objc,
             }
         }
     }
+    if (fError) {
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+/*----------------------------------------------------------------------------*/
+/* Apply the options which depend on the symbology to the symbol, to be done */
+/* after any options are decoded */
+static void ApplyOptions(struct zint_symbol *my_symbol,
+    const struct EncodeOptions *opts)
+{
+    unsigned int cap;
     /*------------------------------------------------------------------------*/
     /* >>> Get symbology capability mask */
     cap = ZBarcode_Cap(my_symbol->symbology,
@@ -1130,121 +1172,484 @@ static int Encode(Tcl_Interp *interp, int objc,
     /*------------------------------------------------------------------------*/
     /* >>> option_3 is set by three values depending on the symbology */
     /* On wrong symbology, the option is ignored(as does the zint program)*/
-	if (fFullMultiByte && (cap & ZINT_CAP_FULL_MULTIBYTE)) {
+	if (opts->fFullMultiByte && (cap & ZINT_CAP_FULL_MULTIBYTE)) {
 		my_symbol->option_3 = ZINT_FULL_MULTIBYTE;
 	}
-	if (Mask && (cap & ZINT_CAP_MASK)) {
-		my_symbol->option_3 |= Mask << 8;
+	if (opts->Mask && (cap & ZINT_CAP_MASK)) {
+		my_symbol->option_3 |= opts->Mask << 8;
 	}
-    if (Separator && (cap & ZINT_CAP_STACKABLE)) {
-		my_symbol->option_3 = Separator;
+    if (opts->Separator && (cap & ZINT_CAP_STACKABLE)) {
+		my_symbol->option_3 = opts->Separator;
 	}
     /*------------------------------------------------------------------------*/
     /* >>> option_2 is set by two values depending on the symbology */
     /* On wrong symbology, the option is ignored(as does the zint program)*/
-    if (addon_gap && (cap & ZINT_CAP_EXTENDABLE)) {
-        my_symbol->option_2 = addon_gap;
+    if (opts->addon_gap && (cap & ZINT_CAP_EXTENDABLE)) {
+        my_symbol->option_2 = opts->addon_gap;
+    }
+    /*------------------------------------------------------------------------*/
+    /* >>> If alpha present get it interleaved as RGBA, the layout Tk takes */
+    if (strlen(my_symbol->fgcolour) > 6 || strlen(my_symbol->bgcolour) > 6) {
+        my_symbol->output_options |= OUT_BUFFER_RGBA;
+    } else {
+        my_symbol->output_options &= ~OUT_BUFFER_RGBA;
+    }
+}
+/*----------------------------------------------------------------------------*/
+/* Copy the settings of a configured symbol into the symbol to encode */
+static void CopySettings(struct zint_symbol *dst,
+    const struct zint_symbol *src)
+{
+    dst->symbology = src->symbology;
+    dst->height = src->height;
+    dst->whitespace_width = src->whitespace_width;
+    dst->whitespace_height = src->whitespace_height;
+    dst->border_width = src->border_width;
+    dst->output_options = src->output_options;
+    strcpy(dst->fgcolour, src->fgcolour);
+    strcpy(dst->bgcolour, src->bgcolour);
+    dst->scale = src->scale;
+    dst->option_1 = src->option_1;
+    dst->option_2 = src->option_2;
+    dst->option_3 = src->option_3;
+    dst->show_hrt = src->show_hrt;
+    dst->input_mode = src->input_mode;
+    dst->eci = src->eci;
+    strcpy(dst->primary, src->primary);
+    dst->dot_size = src->dot_size;
+    dst->warn_level = src->warn_level;
+}
+/*----------------------------------------------------------------------------*/
+/* >>>>> Encode */
+/*----------------------------------------------------------------------------*/
+/* Get the data to encode: binary data as is, else converted to utf-8 in */
+/* dsInput, which must be initialised */
+static unsigned char *GetInput(Tcl_Encoding hZINTEncoding, int input_mode,
+    Tcl_Obj *oData, Tcl_DString *dsInput, int *lStrPtr)
+{
+    char *pStr;
+    if (input_mode == DATA_MODE) {
+        /* Binary data */
+        return Tcl_GetByteArrayFromObj(oData, lStrPtr);
+    }
+    /* UTF8 Data */
+    pStr = Tcl_GetStringFromObj(oData, lStrPtr);
+    Tcl_UtfToExternalDString( hZINTEncoding, pStr, *lStrPtr, dsInput);
+    *lStrPtr = Tcl_DStringLength( dsInput );
+    return (unsigned char *) Tcl_DStringValue( dsInput );
+}
+/*----------------------------------------------------------------------------*/
+/* Put the bitmap of a buffered symbol into a photo image */
+static int PutPhoto(Tcl_Interp *interp, struct zint_symbol *my_symbol,
+    Tk_PhotoHandle hPhoto, const struct EncodeOptions *opts)
+{
+    Tk_PhotoImageBlock sImageBlock;
+    int destWidth = opts->destWidth;
+    int destHeight = opts->destHeight;
+    /* Pass the bitmap directly, no copy */
+    sImageBlock.pixelPtr = (unsigned char *) my_symbol->bitmap;
+    sImageBlock.width = my_symbol->bitmap_width;
+    sImageBlock.height = my_symbol->bitmap_height;
+    sImageBlock.offset[0] = 0;
+    sImageBlock.offset[1] = 1;
+    sImageBlock.offset[2] = 2;
+    if (my_symbol->output_options & OUT_BUFFER_RGBA) {
+        sImageBlock.pitch = 4*my_symbol->bitmap_width;
+        sImageBlock.pixelSize = 4;
+        sImageBlock.offset[3] = 3;
+    } else {
+        sImageBlock.pitch = 3*my_symbol->bitmap_width;
+        sImageBlock.pixelSize = 3;
+        sImageBlock.offset[3] = 0;
+    }
+    if (0 == destWidth) {
+        destWidth = my_symbol->bitmap_width;
+    }
+    if (0 == destHeight) {
+        destHeight = my_symbol->bitmap_height;
     }
+    return Tk_PhotoPutBlock(interp, hPhoto, &sImageBlock,
+        opts->destX0, opts->destY0, destWidth, destHeight,
+        TK_PHOTO_COMPOSITE_OVERLAY);
+}
+/*----------------------------------------------------------------------------*/
+/* Encode data into a photo image with a prepared symbol */
+static int EncodePhoto(Tcl_Interp *interp, Tcl_Encoding hZINTEncoding,
+    struct zint_symbol *my_symbol, Tcl_Obj *oData, Tcl_Obj *oPhoto,
+    const struct EncodeOptions *opts)
+{
+    Tcl_DString dsInput;
+    unsigned char *pStr;
+    int lStr;
+    int ErrorNumber;
+    int fError = 0;
+    Tk_PhotoHandle hPhoto;
     /*------------------------------------------------------------------------*/
     /* >>> Prepare input dstring and encode it to ECI encoding*/
     Tcl_DStringInit(& dsInput);
+    pStr = GetInput(hZINTEncoding, my_symbol->input_mode, oData, &dsInput,
+        &lStr);
     /*------------------------------------------------------------------------*/
-    if (!fError) {
-        /*--------------------------------------------------------------------*/
-        /* >>> Get input mode */
-        if (my_symbol->input_mode == DATA_MODE) {
-            /* Binary data */
-            pStr = (char *) Tcl_GetByteArrayFromObj(objv[2], &lStr);
-        } else {
-            /* UTF8 Data */
-			pStr = Tcl_GetStringFromObj(objv[2], &lStr);
-			Tcl_UtfToExternalDString( hZINTEncoding, pStr, lStr, &dsInput);
-			pStr = Tcl_DStringValue( &dsInput );
-			lStr = Tcl_DStringLength( &dsInput );
+    /* >>> Build symbol graphic */
+    /* call zint graphic creation to buffer */
+    ErrorNumber = ZBarcode_Encode_and_Buffer(my_symbol, pStr, lStr,
+        opts->rotate_angle);
+    Tcl_DStringFree(& dsInput);
+    /*------------------------------------------------------------------------*/
+    /* >> Show a message */
+    if( 0 != ErrorNumber )
+    {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(my_symbol->errtxt, -1));
+    }
+    if( ZINT_ERROR <= ErrorNumber )
+    {
+        /* >> Encode error */
+        fError = 1;
+    } else if (
+        NULL == (hPhoto = Tk_FindPhoto(interp, Tcl_GetString(oPhoto))))
+    {
+        Tcl_SetObjResult(interp,
+            Tcl_NewStringObj("Unknown photo image", -1));
+        fError = 1;
+    } else if (TCL_OK != PutPhoto(interp, my_symbol, hPhoto, opts)) {
+        fError = 1;
+    }
+    /*------------------------------------------------------------------------*/
+    if (fError) {
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+/*----------------------------------------------------------------------------*/
+/* Context of the batch item function */
+struct BatchContext {
+    Tcl_Interp *interp;
+    Tk_PhotoHandle *hPhotos;
+    struct zint_batch_item *items;
+    const struct EncodeOptions *opts;
+    int done;
+    int fError;
+};
+/*----------------------------------------------------------------------------*/
+/* Batch item function: buffer an encoded item and put it into its photo */
+static int BatchItem(void *context, struct zint_symbol *my_symbol, int index,
+    int error_number)
+{
+    struct BatchContext *ctx = (struct BatchContext *) context;
+    ctx->done++;
+    if (error_number >= ZINT_ERROR) {
+        /* Item not encoded, result in its errtxt */
+        return 0;
+    }
+    error_number = ZBarcode_Buffer(my_symbol, ctx->opts->rotate_angle);
+    if (error_number != 0) {
+        ctx->items[index].error_number = error_number;
+        strcpy(ctx->items[index].errtxt, my_symbol->errtxt);
+        if (error_number >= ZINT_ERROR) {
+            return 0;
         }
     }
+    if (TCL_OK != PutPhoto(ctx->interp, my_symbol, ctx->hPhotos[index],
+        ctx->opts))
+    {
+        ctx->fError = 1;
+        return 1;
+    }
+    return 0;
+}
+/*----------------------------------------------------------------------------*/
+/* Encode a list of data into a list of photo images with a prepared symbol */
+/* The settings are checked once only. The result is a list of the messages */
+/* of each item, empty if none */
+static int EncodeBatch(Tcl_Interp *interp, Tcl_Encoding hZINTEncoding,
+    struct zint_symbol *my_symbol, Tcl_Obj *oDataList, Tcl_Obj *oPhotoList,
+    const struct EncodeOptions *opts)
+{
+    Tcl_Obj **oData;
+    Tcl_Obj **oPhoto;
+    int count;
+    int photoCount;
+    int posCur;
+    int ErrorNumber;
+    int fError = 0;
+    Tcl_DString *dsInput;
+    Tk_PhotoHandle *hPhotos;
+    struct zint_batch_item *items;
+    struct BatchContext ctx;
+    Tcl_Obj *oRes;
     /*------------------------------------------------------------------------*/
-    /* >>> Build symbol graphic */
-    if (! fError ) {
-        int ErrorNumber;
-        Tk_PhotoHandle hPhoto;
-        /*--------------------------------------------------------------------*/
-        /* call zint graphic creation to buffer */
-        ErrorNumber = ZBarcode_Encode_and_Buffer(my_symbol,
-            (unsigned char *) pStr, lStr, rotate_angle);
-        /*--------------------------------------------------------------------*/
-        /* >> Show a message */
-        if( 0 != ErrorNumber )
-        {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(my_symbol->errtxt, -1));
-        }        
-        if( ZINT_ERROR <= ErrorNumber )
-        {
-            /* >> Encode error */
-            fError = 1;
-        } else if (
-            NULL == (hPhoto = Tk_FindPhoto(interp, Tcl_GetString(objv[3]))))
+    if (TCL_OK != Tcl_ListObjGetElements(interp, oDataList, &count, &oData)
+        || TCL_OK != Tcl_ListObjGetElements(interp, oPhotoList, &photoCount,
+            &oPhoto))
+    {
+        return TCL_ERROR;
+    }
+    if (count != photoCount) {
+        Tcl_SetObjResult(interp,
+            Tcl_NewStringObj("Data and photo lists differ in length", -1));
+        return TCL_ERROR;
+    }
+    if (0 == count) {
+        return TCL_OK;
+    }
+    /*------------------------------------------------------------------------*/
+    /* >>> Resolve all photos first, so no item is done on a wrong one */
+    hPhotos = (Tk_PhotoHandle *) ckalloc(count * sizeof(Tk_PhotoHandle));
+    for (posCur = 0; posCur < count; posCur++) {
+        if (NULL == (hPhotos[posCur] = Tk_FindPhoto(interp,
+            Tcl_GetString(oPhoto[posCur]))))
         {
             Tcl_SetObjResult(interp,
                 Tcl_NewStringObj("Unknown photo image", -1));
-            fError = 1;
+            ckfree((char *) hPhotos);
+            return TCL_ERROR;
+        }
+    }
+    /*------------------------------------------------------------------------*/
+    /* >>> Prepare input dstrings and encode them to ECI encoding */
+    dsInput = (Tcl_DString *) ckalloc(count * sizeof(Tcl_DString));
+    items = (struct zint_batch_item *) ckalloc(
+        count * sizeof(struct zint_batch_item));
+    for (posCur = 0; posCur < count; posCur++) {
+        Tcl_DStringInit(&dsInput[posCur]);
+        items[posCur].source = GetInput(hZINTEncoding, my_symbol->input_mode,
+            oData[posCur], &dsInput[posCur], &items[posCur].length);
+        if (0 == items[posCur].length) {
+            /* A zero length means NUL-terminated to zint */
+            items[posCur].source = (const unsigned char *) "";
+        }
+        items[posCur].error_number = 0;
+        items[posCur].errtxt[0] = '\0';
+    }
+    /*------------------------------------------------------------------------*/
+    /* >>> Encode, each item is put into its photo by the item function */
+    ctx.interp = interp;
+    ctx.hPhotos = hPhotos;
+    ctx.items = items;
+    ctx.opts = opts;
+    ctx.done = 0;
+    ctx.fError = 0;
+    ErrorNumber = ZBarcode_Encode_Batch(my_symbol, items, count, BatchItem,
+        &ctx);
+    if (ctx.fError) {
+        /* Photo error, result already set */
+        fError = 1;
+    } else if (0 == ctx.done && ZINT_ERROR <= ErrorNumber) {
+        /* >> Settings error */
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(my_symbol->errtxt, -1));
+        fError = 1;
+    } else {
+        /* >> Show the message of each item */
+        oRes = Tcl_NewObj();
+        for (posCur = 0; posCur < count; posCur++) {
+            Tcl_ListObjAppendElement(NULL, oRes,
+                Tcl_NewStringObj(items[posCur].errtxt, -1));
+        }
+        Tcl_SetObjResult(interp, oRes);
+    }
+    /*------------------------------------------------------------------------*/
+    for (posCur = 0; posCur < count; posCur++) {
+        Tcl_DStringFree(&dsInput[posCur]);
+    }
+    ckfree((char *) dsInput);
+    ckfree((char *) items);
+    ckfree((char *) hPhotos);
+    if (fError) {
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+/*----------------------------------------------------------------------------*/
+/* Encode image */
+/* zint encode data photo ?option value? ... */
+/* zint encodebatch dataList photoList ?option value? ... */
+static int Encode(Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[], int fBatch)
+{
+    struct zint_symbol *my_symbol;
+    Tcl_Encoding hZINTEncoding;
+    struct EncodeOptions opts;
+    int Result;
+    /*------------------------------------------------------------------------*/
+    /* >> Check if at least data and object is given and a pair number of */
+    /* >> options */
+    if ( objc < 4 || (objc % 2) != 0 )
+    {
+        Tcl_WrongNumArgs(interp, 2, objv, fBatch
+            ? "dataList photoList ?-switch value?..."
+            : "data photo ?-switch value?...");
+        return TCL_ERROR;
+    }
+    /*------------------------------------------------------------------------*/
+    /* >>> Prepare encoding */
+    hZINTEncoding = Tcl_GetEncoding(interp, "utf-8");
+    if (NULL == hZINTEncoding) {
+        return TCL_ERROR;
+    }
+    /*------------------------------------------------------------------------*/
+    /* >>> Prepare zint object */
+    my_symbol = ZBarcode_Create();
+    my_symbol->input_mode = UNICODE_MODE;
+    my_symbol->option_3 = 0;
+    InitOptions(&opts);
+    /*------------------------------------------------------------------------*/
+    Result = DecodeOptions(interp, hZINTEncoding, objc, objv, 4, my_symbol,
+        &opts);
+    if (TCL_OK == Result) {
+        ApplyOptions(my_symbol, &opts);
+        if (fBatch) {
+            Result = EncodeBatch(interp, hZINTEncoding, my_symbol, objv[2],
+                objv[3], &opts);
         } else {
-            Tk_PhotoImageBlock sImageBlock;
-            char * pImageRGBA = NULL;
-            if (my_symbol->alphamap == NULL) {
-                sImageBlock.pixelPtr = (unsigned char *) my_symbol->bitmap;
-                sImageBlock.width = my_symbol->bitmap_width;
-                sImageBlock.height = my_symbol->bitmap_height;
-                sImageBlock.pitch = 3*my_symbol->bitmap_width;
-                sImageBlock.pixelSize = 3;
-                sImageBlock.offset[0] = 0;
-                sImageBlock.offset[1] = 1;
-                sImageBlock.offset[2] = 2;
-                sImageBlock.offset[3] = 0;
-            } else {
-                int index;
-                /* Alpha channel present - prepare the image data in rgba order */
-                pImageRGBA = ckalloc(my_symbol->bitmap_width*my_symbol->bitmap_height*4);
-                for (index = 0; index < my_symbol->bitmap_width*my_symbol->bitmap_height; index++) {
-                    pImageRGBA[index*4] = my_symbol->bitmap[index*3];
-                    pImageRGBA[index*4+1] = my_symbol->bitmap[index*3+1];
-                    pImageRGBA[index*4+2] = my_symbol->bitmap[index*3+2];
-                    pImageRGBA[index*4+3] = my_symbol->alphamap[index];
-                }
-                sImageBlock.pixelPtr = (unsigned char *) pImageRGBA;
-                sImageBlock.width = my_symbol->bitmap_width;
-                sImageBlock.height = my_symbol->bitmap_height;
-                sImageBlock.pitch = 4*my_symbol->bitmap_width;
-                sImageBlock.pixelSize = 4;
-                sImageBlock.offset[0] = 0;
-                sImageBlock.offset[1] = 1;
-                sImageBlock.offset[2] = 2;
-                sImageBlock.offset[3] = 3;
-            }
-            if (0 == destWidth) {
-                destWidth = my_symbol->bitmap_width;
-            }
-            if (0 == destHeight) {
-                destHeight = my_symbol->bitmap_height;
-            }
-            if (TCL_OK != Tk_PhotoPutBlock(interp, hPhoto, &sImageBlock,
-                destX0, destY0, destWidth, destHeight,
-                TK_PHOTO_COMPOSITE_OVERLAY))
-            {
-                fError = 1;
-            }
-            if (pImageRGBA != NULL) {
-                ckfree(pImageRGBA);
-            }
+            Result = EncodePhoto(interp, hZINTEncoding, my_symbol, objv[2],
+                objv[3], &opts);
         }
     }
     /*------------------------------------------------------------------------*/
     Tcl_FreeEncoding(hZINTEncoding);
-    Tcl_DStringFree(& dsInput);
     ZBarcode_Delete(my_symbol);
+    return Result;
+}
+/*----------------------------------------------------------------------------*/
+/* >>>>> Symbol objects */
+/*----------------------------------------------------------------------------*/
+/* Create a symbol object command */
+/* zint symbol create name ?option value? ... */
+static int SymbolCreate(Tcl_Interp *interp, int *tkFlagPtr, int objc,
+    Tcl_Obj *CONST objv[])
+{
+    struct SymbolObject *pSymbol;
+    Tcl_CmdInfo cmdInfo;
+    char *subCmds[] = {"create", NULL};
+    int Index;
     /*------------------------------------------------------------------------*/
-    if (fError) {
+    if ( objc < 4 || (objc % 2) != 0 )
+    {
+        Tcl_WrongNumArgs(interp, 2, objv, "create name ?-switch value?...");
+        return TCL_ERROR;
+    }
+    if(Tcl_GetIndexFromObj(interp, objv[2], (const char **) subCmds,
+        "option", 0, &Index)
+        == TCL_ERROR)
+    {
+        return TCL_ERROR;
+    }
+    if (Tcl_GetCommandInfo(interp, Tcl_GetString(objv[3]), &cmdInfo)) {
+        Tcl_SetObjResult(interp,
+            Tcl_NewStringObj("Command already exists", -1));
+        return TCL_ERROR;
+    }
+    /*------------------------------------------------------------------------*/
+    pSymbol = (struct SymbolObject *) ckalloc(sizeof(struct SymbolObject));
+    pSymbol->hZINTEncoding = Tcl_GetEncoding(interp, "utf-8");
+    if (NULL == pSymbol->hZINTEncoding) {
+        ckfree((char *) pSymbol);
+        return TCL_ERROR;
+    }
+    pSymbol->settings = ZBarcode_Create();
+    pSymbol->settings->input_mode = UNICODE_MODE;
+    pSymbol->settings->option_3 = 0;
+    pSymbol->symbol = ZBarcode_Create();
+    pSymbol->tkFlagPtr = tkFlagPtr;
+    InitOptions(&pSymbol->options);
+    if (TCL_OK != DecodeOptions(interp, pSymbol->hZINTEncoding, objc, objv, 4,
+        pSymbol->settings, &pSymbol->options))
+    {
+        SymbolDelete((ClientData) pSymbol);
         return TCL_ERROR;
     }
+    /*------------------------------------------------------------------------*/
+    pSymbol->token = Tcl_CreateObjCommand(interp, Tcl_GetString(objv[3]),
+        SymbolCmd, (ClientData) pSymbol, SymbolDelete);
+    Tcl_SetObjResult(interp, objv[3]);
     return TCL_OK;
 }
+/*----------------------------------------------------------------------------*/
+/* Free a symbol object, called when its command is deleted */
+static void SymbolDelete(ClientData clientData)
+{
+    struct SymbolObject *pSymbol = (struct SymbolObject *) clientData;
+    Tcl_FreeEncoding(pSymbol->hZINTEncoding);
+    ZBarcode_Delete(pSymbol->settings);
+    ZBarcode_Delete(pSymbol->symbol);
+    ckfree((char *) pSymbol);
+}
+/*----------------------------------------------------------------------------*/
+/* Symbol object command */
+/* name configure ?option value? ... */
+/* name encode data photo */
+/* name encodebatch dataList photoList */
+/* name destroy */
+static int SymbolCmd(ClientData clientData, Tcl_Interp *interp, int objc,
+    Tcl_Obj *CONST objv[])
+{
+    struct SymbolObject *pSymbol = (struct SymbolObject *) clientData;
+    enum iSymbolCommand {iConfigure, iEncode, iEncodeBatch, iDestroy};
+    char *subCmds[] = {"configure", "encode", "encodebatch", "destroy", NULL};
+    int Index;
+    /*------------------------------------------------------------------------*/
+    if (objc < 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "option ?arg ...?");
+        return TCL_ERROR;
+    }
+    if(Tcl_GetIndexFromObj(interp, objv[1], (const char **) subCmds,
+        "option", 0, &Index)
+        == TCL_ERROR)
+    {
+        return TCL_ERROR;
+    }
+    /*------------------------------------------------------------------------*/
+    switch (Index) {
+    case iConfigure:
+        {
+            /* Decode into copies, so a wrong option leaves the object as is */
+            struct zint_symbol *settings;
+            struct EncodeOptions opts;
+            if ((objc % 2) != 0) {
+                Tcl_WrongNumArgs(interp, 2, objv, "?-switch value?...");
+                return TCL_ERROR;
+            }
+            settings = ZBarcode_Create();
+            CopySettings(settings, pSymbol->settings);
+            opts = pSymbol->options;
+            if (TCL_OK != DecodeOptions(interp, pSymbol->hZINTEncoding, objc,
+                objv, 2, settings, &opts))
+            {
+                ZBarcode_Delete(settings);
+                return TCL_ERROR;
+            }
+            CopySettings(pSymbol->settings, settings);
+            pSymbol->options = opts;
+            ZBarcode_Delete(settings);
+            return TCL_OK;
+        }
+    case iEncode:
+    case iEncodeBatch:
+        if (objc != 4) {
+            Tcl_WrongNumArgs(interp, 2, objv, Index == iEncode
+                ? "data photo" : "dataList photoList");
+            return TCL_ERROR;
+        }
+        if (CheckForTk(interp, pSymbol->tkFlagPtr) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        /* The encoded symbol is re-used, only its settings are renewed */
+        ZBarcode_Clear(pSymbol->symbol);
+        CopySettings(pSymbol->symbol, pSymbol->settings);
+        ApplyOptions(pSymbol->symbol, &pSymbol->options);
+        if (Index == iEncode) {
+            return EncodePhoto(interp, pSymbol->hZINTEncoding,
+                pSymbol->symbol, objv[2], objv[3], &pSymbol->options);
+        }
+        return EncodeBatch(interp, pSymbol->hZINTEncoding, pSymbol->symbol,
+            objv[2], objv[3], &pSymbol->options);
+    case iDestroy:
+    default:
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, NULL);
+            return TCL_ERROR;
+        }
+        Tcl_DeleteCommandFromToken(interp, pSymbol->token);
+        return TCL_OK;
+    }
+}
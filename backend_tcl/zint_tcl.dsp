@@ -96,6 +96,10 @@ SOURCE=..\backend\2of5.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\backend\async.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\backend\auspost.c
 # End Source File
 # Begin Source File
@@ -104,6 +108,10 @@ SOURCE=..\backend\aztec.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\backend\batch.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\backend\bmp.c
 # End Source File
 # Begin Source File
@@ -208,14 +216,42 @@ SOURCE=..\backend\medical.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\backend\modules.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\backend\multiout.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\backend\output.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\backend\filemem.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\backend\pcx.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\backend\pdf.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\backend\pnm.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\backend\prn.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\backend\qoi.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\backend\pdf417.c
 # End Source File
 # Begin Source File
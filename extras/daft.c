@@ -25,6 +25,7 @@
 int main(int argc, char **argv)
 {
     struct zint_symbol *my_symbol;
+    struct zint_modules *modules;
     int error = 0;
     int x, y, glyph;
     
@@ -44,12 +45,18 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    modules = ZBarcode_Modules(my_symbol); /* Bit-packed copy of the modules */
+    if (!modules) {
+        ZBarcode_Delete(my_symbol);
+        return 1;
+    }
+
     for (x = 0; x < my_symbol->width; x+= 2) {
         glyph = 0;
-        if ((my_symbol->encoded_data[2][x / 8] >> (x % 8)) & 1) {
+        if ((modules->data[2 * modules->row_stride + x / 8] >> (x % 8)) & 1) {
             glyph += 1;
         }
-        if ((my_symbol->encoded_data[0][x / 8] >> (x % 8)) & 1) {
+        if ((modules->data[x / 8] >> (x % 8)) & 1) {
             glyph += 2;
         }
         
@@ -63,6 +70,7 @@ int main(int argc, char **argv)
     }
     printf("\n");
     
+    ZBarcode_Modules_Delete(modules);
     ZBarcode_Delete(my_symbol);
     return 0;
 }
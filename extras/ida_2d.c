@@ -21,6 +21,7 @@
 int main(int argc, char **argv)
 {
     struct zint_symbol *my_symbol;
+    struct zint_modules *modules;
     int error = 0;
     int x, y, sub, glyph;
     
@@ -39,6 +40,12 @@ int main(int argc, char **argv)
         ZBarcode_Delete(my_symbol);
         return 1;
     }
+
+    modules = ZBarcode_Modules(my_symbol); /* Bit-packed copy of the modules */
+    if (!modules) {
+        ZBarcode_Delete(my_symbol);
+        return 1;
+    }
     
     for (y = 0; y < my_symbol->rows; y += 4) {
         for (x = 0; x < my_symbol->width; x++) {
@@ -46,7 +53,7 @@ int main(int argc, char **argv)
             for (sub = 0; sub < 4; sub++) {
                 glyph *= 2;
                 if ((y + sub) < my_symbol->rows) {
-                    if (((my_symbol->encoded_data[y + sub][x / 8] >> (x % 8)) & 1) == 0) {
+                    if (((modules->data[(y + sub) * modules->row_stride + x / 8] >> (x % 8)) & 1) == 0) {
                         glyph += 1;
                     }
                 } else {
@@ -59,6 +66,7 @@ int main(int argc, char **argv)
         printf("\n");
     }
     
+    ZBarcode_Modules_Delete(modules);
     ZBarcode_Delete(my_symbol);
     return 0;
 }
@@ -25,6 +25,7 @@
 int main(int argc, char **argv)
 {
     struct zint_symbol *my_symbol;
+    struct zint_modules *modules;
     int error = 0;
     int x, y, glyph, sub;
     
@@ -44,12 +45,18 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    modules = ZBarcode_Modules(my_symbol); /* Bit-packed copy of the modules */
+    if (!modules) {
+        ZBarcode_Delete(my_symbol);
+        return 1;
+    }
+
     sub = 0;
     glyph = 0;
     for (y = 0; y < my_symbol->rows; y++) {
         for (x = 0; x < my_symbol->width; x++) {
             glyph *= 2;
-            if ((my_symbol->encoded_data[y][x / 8] >> (x % 8)) & 1) {
+            if ((modules->data[y * modules->row_stride + x / 8] >> (x % 8)) & 1) {
                 glyph += 1;
             }
             sub++;
@@ -84,6 +91,7 @@ int main(int argc, char **argv)
         glyph = 0;
     }
     
+    ZBarcode_Modules_Delete(modules);
     ZBarcode_Delete(my_symbol);
     return 0;
 }
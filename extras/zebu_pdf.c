@@ -21,6 +21,7 @@
 int main(int argc, char **argv)
 {
     struct zint_symbol *my_symbol;
+    struct zint_modules *modules;
     int error = 0;
     int x, y, sub, glyph, group;
     
@@ -39,6 +40,12 @@ int main(int argc, char **argv)
         ZBarcode_Delete(my_symbol);
         return 1;
     }
+
+    modules = ZBarcode_Modules(my_symbol); /* Bit-packed copy of the modules */
+    if (!modules) {
+        ZBarcode_Delete(my_symbol);
+        return 1;
+    }
     
     for (y = 0; y < my_symbol->rows; y++) {
         printf("+*");
@@ -47,7 +54,7 @@ int main(int argc, char **argv)
         group = 0;
         for (x = 18; x < my_symbol->width - 19; x++) {
             glyph *= 2;
-            if ((my_symbol->encoded_data[y][x / 8] >> (x % 8)) & 1) {
+            if ((modules->data[y * modules->row_stride + x / 8] >> (x % 8)) & 1) {
                 glyph++;
             }
             sub++;
@@ -70,6 +77,7 @@ int main(int argc, char **argv)
         printf("-\n");
     }
     
+    ZBarcode_Modules_Delete(modules);
     ZBarcode_Delete(my_symbol);
     return 0;
 }
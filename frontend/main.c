@@ -24,14 +24,41 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <signal.h>
 #ifndef _MSC_VER
 #include <getopt.h>
+#include <stdint.h>
 #include <zint.h>
 #else
 #include <malloc.h>
 #include "getopt.h"
+#include "ms_stdint.h"
 #include "zint.h"
 #endif
+#if defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(_MSC_VER)
+#define ZINT_WIN
+#include <windows.h>
+#include <shellapi.h>
+#include <fcntl.h>
+#include <io.h>
+#ifndef WC_ERR_INVALID_CHARS
+#define WC_ERR_INVALID_CHARS    0x00000080
+#endif
+#else
+#ifdef ZINT_HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#define ZINT_HAVE_INOTIFY
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+#endif
 
 /* It's assumed that int is at least 32 bits, the following will compile-time fail if not
  * https://stackoverflow.com/a/1980056/664741 */
@@ -113,9 +140,10 @@ static void usage(void) {
         printf( "Zint version %d.%d.%d\n", version_major, version_minor, version_release);
     }
     
-    printf( "Encode input data in a barcode and save as BMP/EMF/EPS/GIF/PCX/PNG/SVG/TIF/TXT\n\n"
+    printf( "Encode input data in a barcode and save as BMP/EMF/EPL/EPS/GIF/PBM/PCL/PCX/PDF/PGM/PNG/QOI/SVG/TIF/TXT/ZPL\n\n"
             "  -b, --barcode=TYPE    Number or name of barcode type. Default is 20 (CODE128)\n"
             "  --addongap=NUMBER     Set add-on gap in multiples of X-dimension for UPC/EAN\n"
+            "  --archive=FILE        Write batch output to tar or zip archive FILE\n"
             "  --batch               Treat each line of input file as a separate data set\n"
             "  --bg=COLOUR           Specify a background colour (in hex RGB/RGBA)\n"
             "  --binary              Treat input as raw binary data\n"
@@ -126,6 +154,7 @@ static void usage(void) {
             "  --cmyk                Use CMYK colour space in EPS/TIF symbols\n"
             "  --cols=NUMBER         Set the number of data columns in symbol\n"
             "  -d, --data=DATA       Set the symbol content\n"
+            "  --dedupe              Reuse output of repeated data in batch/serve mode\n"
             "  --direct              Send output to stdout\n"
             "  --dmre                Allow Data Matrix Rectangular Extended\n"
             "  --dotsize=NUMBER      Set radius of dots in dotty mode\n"
@@ -135,7 +164,7 @@ static void usage(void) {
             "  --eci=NUMBER          Set the ECI (Extended Channel Interpretation) code\n"
             "  --esc                 Process escape characters in input data\n"
             "  --fg=COLOUR           Specify a foreground colour (in hex RGB/RGBA)\n"
-            "  --filetype=TYPE       Set output file type BMP/EMF/EPS/GIF/PCX/PNG/SVG/TIF/TXT\n"
+            "  --filetype=TYPE       Set output file type BMP/EMF/EPL/EPS/GIF/PBM/PCL/PCX/PDF/PGM/PNG/QOI/SVG/TIF/TXT/ZPL\n"
             "  --fullmultibyte       Use multibyte for binary/Latin (QR/Han Xin/Grid Matrix)\n"
             "  --gs1                 Treat input as GS1 compatible data\n"
             "  --gs1parens           GS1 AIs in parentheses instead of square brackets\n"
@@ -151,6 +180,7 @@ static void usage(void) {
             "  --notext              Remove human readable text\n"
             "  -o, --output=FILE     Send output to FILE. Default is out.png\n"
             "  --primary=STRING      Set structured primary message (MaxiCode/Composite)\n"
+            "  --records             Batch lines have NAME=VALUE fields before data (tab-separated)\n"
             "  -r, --reverse         Reverse colours (white on black)\n"
             "  --rotate=NUMBER       Rotate symbol by NUMBER degrees\n"
             "  --rows=NUMBER         Set number of rows (Codablock-F)\n"
@@ -158,11 +188,15 @@ static void usage(void) {
             "  --scmvv=NUMBER        Prefix SCM with [)>\\R01\\Gvv (vv is NUMBER) (MaxiCode)\n"
             "  --secure=NUMBER       Set error correction level (ECC)\n"
             "  --separator=NUMBER    Set height of row separator bars (stacked symbologies)\n"
+            "  --serve               Encode each request on stdin, writing framed output to stdout\n"
             "  --small               Use small text\n"
             "  --square              Force Data Matrix symbols to be square\n"
+            "  --stats[=FILE]        Print batch timing statistics (and write as JSON to FILE)\n"
+            "  --threads=NUMBER      Set number of threads for batch mode (0 = no. of CPUs)\n"
             "  -t, --types           Display table of barcode types\n"
             "  --vers=NUMBER         Set symbol version (size, check digits, other options)\n"
             "  --vwhitesp=NUMBER     Set height of vertical whitespace in multiples of X-dim\n"
+            "  --watch=DIR           Batch process each input file appearing in directory DIR\n"
             "  -w, --whitesp=NUMBER  Set width of horizontal whitespace in multiples of X-dim\n"
             "  --werror              Convert all warnings into errors\n"
             "  --wzpl                ZPL compatibility mode (allows non-standard symbols)\n"
@@ -373,316 +407,2386 @@ static int get_barcode_name(const char *barcode_name) {
         length = (int) strlen(n);
     }
 
-    /* Ignore any non-alphanumeric characters */
-    for (i = 0, j = 0; i < length; i++) {
-        if ((n[i] >= 'a' && n[i] <= 'z') || (n[i] >= '0' && n[i] <= '9')) {
-            n[j++] = n[i];
+    /* Ignore any non-alphanumeric characters */
+    for (i = 0, j = 0; i < length; i++) {
+        if ((n[i] >= 'a' && n[i] <= 'z') || (n[i] >= '0' && n[i] <= '9')) {
+            n[j++] = n[i];
+        }
+    }
+    if (j == 0) {
+        return 0;
+    }
+    n[j] = '\0';
+
+    while (s <= e) {
+        int m = (s + e) / 2;
+        int cmp = strcmp(names[m].n, n);
+        if (cmp == 0) {
+            return names[m].symbology;
+        }
+        if (cmp < 0) {
+            s = m + 1;
+        } else {
+            e = m - 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Whether `filetype` supported by Zint. Sets `png_refused` if `no_png` and PNG requested */
+static int supported_filetype(const char *filetype, const int no_png, int *png_refused) {
+    static const char *filetypes[] = {
+        "bmp", "emf", "epl", "eps", "gif", "pbm", "pcl", "pcx", "pdf", "pgm", "png", "qoi", "svg", "tif", "txt", "zpl",
+    };
+    char lc_filetype[4] = {0};
+    int i;
+
+    if (png_refused) {
+        *png_refused = 0;
+    }
+    strncpy(lc_filetype, filetype, 3);
+    to_lower(lc_filetype);
+
+    if (no_png && strcmp(lc_filetype, "png") == 0) {
+        if (png_refused) {
+            *png_refused = 1;
+        }
+        return 0;
+    }
+
+    for (i = 0; i < (int) ARRAY_SIZE(filetypes); i++) {
+        if (strcmp(lc_filetype, filetypes[i]) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Get file extension, excluding those of 4 or more letters */
+static char *get_extension(const char *file) {
+    char *dot;
+
+    dot = strrchr(file, '.');
+    if (dot && strlen(file) - (dot - file) <= 4) { /* Only recognize up to 3 letter extensions */
+        return dot + 1;
+    }
+    return NULL;
+}
+
+/* Set extension of `file` to `filetype`, replacing existing extension if any.
+ * Does nothing if file already has `filetype` extension */
+static void set_extension(char *file, const char *filetype) {
+    char lc_filetype[4] = {0};
+    char *extension;
+    char lc_extension[4];
+
+    strncpy(lc_filetype, filetype, 3);
+    to_lower(lc_filetype);
+
+    extension = get_extension(file);
+    if (extension) {
+        strcpy(lc_extension, extension);
+        to_lower(lc_extension);
+        if (strcmp(lc_filetype, lc_extension) == 0) {
+            return;
+        }
+        *(extension - 1) = '\0'; /* Cut off at dot */
+    }
+    if (strlen(file) > 251) {
+        file[251] = '\0';
+    }
+    strcat(file, ".");
+    strncat(file, filetype, 3);
+}
+
+/* Whether `filetype` is raster type */
+static int is_raster(const char *filetype, const int no_png) {
+    static const char *raster_filetypes[] = {
+        "bmp", "epl", "gif", "pbm", "pcl", "pcx", "pgm", "png", "qoi", "tif", "zpl",
+    };
+    int i;
+    char lc_filetype[4] = {0};
+
+    if (filetype == NULL) {
+        return 0;
+    }
+    strcpy(lc_filetype, filetype);
+    to_lower(lc_filetype);
+
+    if (no_png && strcmp(lc_filetype, "png") == 0) {
+        return 0;
+    }
+
+    for (i = 0; i < (int) ARRAY_SIZE(raster_filetypes); i++) {
+        if (strcmp(lc_filetype, raster_filetypes[i]) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Batch mode - lines are read in chunks, each line then being encoded and output by one of `threads` workers
+   (chosen by output filename, so that lines with the same filename are output in order by the same worker), with
+   any errors reported in line order once the chunk is done. Where threads are available and output is to files,
+   encoding and writing are pipelined, the workers printing to memory and passing the output through a bounded
+   queue to a writer thread, so that file I/O overlaps with encoding even when there's only one worker */
+
+#define BATCH_READ_SIZE         0x100000 /* Bytes of input read at a time, must exceed `ZINT_MAX_DATA_LEN` */
+#define BATCH_CHUNK_PER_THREAD  256 /* Lines per worker thread read before encoding */
+#define BATCH_MAX_THREADS       256
+#define BATCH_DEDUPE_ENTRIES    1024 /* Maximum symbols cached per worker thread if `--dedupe` */
+#define BATCH_QUEUE_SIZE        64 /* Maximum outputs waiting to be written if pipelining */
+
+/* Settings given by the fields of a batch record (`--records`), overriding the command line ones */
+struct batch_record {
+    int symbology; /* 0 if not given */
+    int option_1; /* -1 if not given */
+    int option_2; /* 0 if not given */
+    float scale; /* 0 if not given */
+    char filetype[4]; /* Empty if not given */
+};
+
+/* Line of batch input */
+struct batch_line {
+    unsigned char *data; /* NUL-terminated, points into read buffer */
+    int length;
+    int line_count;
+    int too_long; /* Set if line exceeded `ZINT_MAX_DATA_LEN` (not encoded) */
+    int worker; /* Index of worker assigned */
+    char outfile[256];
+    int error_number;
+    char errtxt[100];
+    unsigned char *memfile; /* Output file if archiving */
+    int memfile_size;
+    int invalid; /* Set if record fields invalid (not encoded), `errtxt` giving reason */
+    struct batch_record record;
+    int timed; /* Set if times below set (`--stats`) */
+    int rendered; /* Set if output rendered */
+    double encode_time;
+    double render_time;
+    double write_time;
+    int bytes; /* Size of output */
+    int write_failed; /* Set if pipelined write of output failed */
+};
+
+/* Batch worker, encoding its share of a chunk of lines with its own symbol */
+struct batch_worker {
+    const struct zint_symbol *settings; /* Symbol giving the settings to use */
+    struct batch_line **lines; /* This worker's lines, in input order */
+    struct zint_batch_item *items; /* Corresponding items for `ZBarcode_Encode_Batch()` */
+    int count;
+    int base; /* Index of first line of the group of lines with the same record settings being encoded */
+    int records; /* Set if lines may have record settings */
+    int dedupe; /* Set if repeated lines to be loaded from `cache` */
+    struct dedupe_cache *cache; /* Created on first use if `dedupe`, kept between chunks */
+    int stats; /* Set if timing lines, outputting to memory first to time rendering and writing separately */
+    double mark; /* Time encoding of the current line began if `stats` */
+    int rotate_angle;
+    int archive; /* Set if output to memory for archiving */
+    int atomic; /* Set if output files to be written whole to a temporary file and then renamed (`--watch`) */
+    struct batch_queue *queue; /* Write stage queue if pipelining, else NULL */
+};
+
+#if defined(ZINT_WIN)
+#define ZINT_THREADS
+typedef HANDLE batch_thread_t;
+#elif defined(ZINT_HAVE_PTHREAD)
+#define ZINT_THREADS
+typedef pthread_t batch_thread_t;
+#endif
+
+#ifdef ZINT_THREADS
+#ifdef ZINT_WIN
+typedef CRITICAL_SECTION batch_mutex_t;
+typedef CONDITION_VARIABLE batch_cond_t;
+#define batch_mutex_init(m)     InitializeCriticalSection(m)
+#define batch_mutex_destroy(m)  DeleteCriticalSection(m)
+#define batch_mutex_lock(m)     EnterCriticalSection(m)
+#define batch_mutex_unlock(m)   LeaveCriticalSection(m)
+#define batch_cond_init(c)      InitializeConditionVariable(c)
+#define batch_cond_destroy(c)
+#define batch_cond_wait(c, m)   SleepConditionVariableCS(c, m, INFINITE)
+#define batch_cond_signal(c)    WakeConditionVariable(c)
+#else
+typedef pthread_mutex_t batch_mutex_t;
+typedef pthread_cond_t batch_cond_t;
+#define batch_mutex_init(m)     pthread_mutex_init(m, NULL)
+#define batch_mutex_destroy(m)  pthread_mutex_destroy(m)
+#define batch_mutex_lock(m)     pthread_mutex_lock(m)
+#define batch_mutex_unlock(m)   pthread_mutex_unlock(m)
+#define batch_cond_init(c)      pthread_cond_init(c, NULL)
+#define batch_cond_destroy(c)   pthread_cond_destroy(c)
+#define batch_cond_wait(c, m)   pthread_cond_wait(c, m)
+#define batch_cond_signal(c)    pthread_cond_signal(c)
+#endif
+
+/* Bounded queue of outputs printed to memory by the workers, waiting to be written by the writer thread */
+struct batch_queue {
+    batch_mutex_t mutex;
+    batch_cond_t not_empty; /* Signalled when an output is added */
+    batch_cond_t not_full; /* Signalled when an output is taken */
+    batch_cond_t drained; /* Signalled when the last output waiting has been written */
+    struct batch_line *lines[BATCH_QUEUE_SIZE]; /* Ring buffer, each line's `memfile` being its output */
+    int head; /* Index of next line to be taken */
+    int count; /* Lines waiting */
+    int busy; /* Set while the writer is writing a line taken */
+    int done; /* Set when no more lines will be added */
+    int stats; /* Set if timing writes */
+    int atomic; /* Set if writing files atomically */
+};
+#endif
+
+#ifdef ZINT_THREADS
+/* Number of online processors, defaulting to 1 if unknown */
+static int batch_cpu_count(void) {
+#if defined(ZINT_WIN)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+#else
+    return 1;
+#endif
+}
+#endif
+
+/* Form output filename for a batch line, numbered according to `format_string` or, if `mirror_mode`,
+   named from the data itself */
+static void batch_outfile(const struct zint_symbol *symbol, const char *format_string, const int mirror_mode,
+            const char *filetype, const unsigned char buffer[], const int length, const int line_count,
+            char output_file[256]) {
+    char number[12], reverse_number[12];
+    int inpos, local_line_count;
+    char reversed_string[256], format_char;
+    int format_len, i, o;
+    char adjusted[2] = {0};
+
+    memset(output_file, 0, 256);
+    if (mirror_mode == 0) {
+        inpos = 0;
+        local_line_count = line_count;
+        memset(number, 0, sizeof(number));
+        memset(reverse_number, 0, sizeof(reverse_number));
+        memset(reversed_string, 0, sizeof(reversed_string));
+        do {
+            number[inpos] = itoc(local_line_count % 10);
+            local_line_count /= 10;
+            inpos++;
+        } while (local_line_count > 0);
+        number[inpos] = '\0';
+
+        for (i = 0; i < inpos; i++) {
+            reverse_number[i] = number[inpos - i - 1];
+        }
+
+        format_len = (int) strlen(format_string);
+        for (i = format_len; i > 0; i--) {
+            format_char = format_string[i - 1];
+
+            switch (format_char) {
+                case '#':
+                    if (inpos > 0) {
+                        adjusted[0] = reverse_number[inpos - 1];
+                        inpos--;
+                    } else {
+                        adjusted[0] = ' ';
+                    }
+                    break;
+                case '~':
+                    if (inpos > 0) {
+                        adjusted[0] = reverse_number[inpos - 1];
+                        inpos--;
+                    } else {
+                        adjusted[0] = '0';
+                    }
+                    break;
+                case '@':
+                    if (inpos > 0) {
+                        adjusted[0] = reverse_number[inpos - 1];
+                        inpos--;
+                    } else {
+                        adjusted[0] = '*';
+                    }
+                    break;
+                default:
+                    adjusted[0] = format_string[i - 1];
+                    break;
+            }
+            strcat(reversed_string, adjusted);
+        }
+
+        for (i = 0; i < format_len; i++) {
+            output_file[i] = reversed_string[format_len - i - 1];
+        }
+    } else {
+        /* Name the output file from the data being processed */
+        i = 0;
+        o = 0;
+        do {
+            if (buffer[i] < 0x20) {
+                output_file[o] = '_';
+            } else {
+                switch (buffer[i]) {
+                    case 0x21: // !
+                    case 0x22: // "
+                    case 0x2a: // *
+                    case 0x2f: // /
+                    case 0x3a: // :
+                    case 0x3c: // <
+                    case 0x3e: // >
+                    case 0x3f: // ?
+                    case 0x5c: // Backslash
+                    case 0x7c: // |
+                    case 0x7f: // DEL
+                        output_file[o] = '_';
+                        break;
+                    default:
+                        output_file[o] = buffer[i];
+                        break;
+                }
+            }
+
+            // Skip escape characters
+            if ((buffer[i] == 0x5c) && (symbol->input_mode & ESCAPE_MODE)) {
+                i++;
+                if (buffer[i] == 'x') {
+                    i += 2;
+                } else if (buffer[i] == 'u') {
+                    i += 4;
+                }
+            }
+            i++;
+            o++;
+        } while (i < length && o < 251);
+
+        /* Add file extension */
+        output_file[o] = '.';
+        output_file[o + 1] = '\0';
+
+        strncat(output_file, filetype, 3);
+    }
+}
+
+/* Parse the NUL-terminated NAME=VALUE fields of a batch record into `record`, placing any error in `errtxt` */
+static int batch_record_parse(char *field, const int count, const int no_png, struct batch_record *record,
+            char errtxt[100]) {
+    int i, val = 0;
+    char *next;
+
+    record->symbology = 0;
+    record->option_1 = -1;
+    record->option_2 = 0;
+    record->scale = 0.0f;
+    record->filetype[0] = '\0';
+
+    for (i = 0; i < count; i++, field = next) {
+        char *value = strchr(field, '=');
+        int valid;
+
+        next = field + strlen(field) + 1;
+        if (!value) {
+            sprintf(errtxt, "Error 166: Invalid record field '%.40s'", field);
+            return 0;
+        }
+        *value++ = '\0';
+        if (strcmp(field, "barcode") == 0) {
+            valid = (validate_int(value, &val) || (val = get_barcode_name(value))) && val > 0;
+            record->symbology = val;
+        } else if (strcmp(field, "secure") == 0) {
+            valid = validate_int(value, &val) && val <= 8;
+            record->option_1 = val;
+        } else if (strcmp(field, "mode") == 0) {
+            valid = validate_int(value, &val) && val <= 6;
+            record->option_1 = val;
+        } else if (strcmp(field, "rows") == 0) {
+            valid = validate_int(value, &val) && val >= 1 && val <= 44;
+            record->option_1 = val;
+        } else if (strcmp(field, "vers") == 0) {
+            valid = validate_int(value, &val) && val >= 1 && val <= 84;
+            record->option_2 = val;
+        } else if (strcmp(field, "cols") == 0) {
+            valid = validate_int(value, &val) && val >= 1 && val <= 200;
+            record->option_2 = val;
+        } else if (strcmp(field, "scale") == 0) {
+            record->scale = (float) atof(value);
+            valid = record->scale >= 0.01f;
+        } else if (strcmp(field, "filetype") == 0) {
+            valid = strlen(value) == 3 && supported_filetype(value, no_png, NULL);
+            if (valid) {
+                strcpy(record->filetype, value);
+                to_lower(record->filetype);
+            }
+        } else {
+            sprintf(errtxt, "Error 166: Invalid record field '%.40s'", field);
+            return 0;
+        }
+        if (!valid || *value == '\0') {
+            sprintf(errtxt, "Error 167: Invalid value for record field '%.20s'", field);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* Split a batch record line into its fields, setting `line->record` and leaving `line->data` as the data (the
+   last field). Fields are NUL-terminated in place. Returns 0 with `line->errtxt` set if a field is invalid */
+static int batch_line_record(struct batch_line *line, const int no_png) {
+    int i, count = 0, last_tab = -1;
+
+    for (i = 0; i < line->length; i++) {
+        if (line->data[i] == '\t') {
+            line->data[i] = '\0';
+            last_tab = i;
+            count++;
+        }
+    }
+    if (!batch_record_parse((char *) line->data, count, no_png, &line->record, line->errtxt)) {
+        return 0;
+    }
+    line->data += last_tab + 1;
+    line->length -= last_tab + 1;
+
+    return 1;
+}
+
+/* Batch statistics (`--stats`), timing each phase with a logarithmic histogram from which to estimate percentiles */
+
+#define STATS_READ      0
+#define STATS_ENCODE    1
+#define STATS_RENDER    2
+#define STATS_WRITE     3
+#define STATS_PHASES    4
+
+#define STATS_BUCKETS_PER_DECADE    20
+#define STATS_MIN_EXP               -7 /* Smallest bucket 0.1 microseconds */
+#define STATS_BUCKETS               (STATS_BUCKETS_PER_DECADE * 10) /* Up to 1000 seconds */
+
+struct stats_phase {
+    long count;
+    double total;
+    double max;
+    long buckets[STATS_BUCKETS];
+};
+
+struct batch_stats {
+    struct stats_phase phases[STATS_PHASES];
+    long lines;
+    long errors;
+    double bytes;
+    double start;
+};
+
+/* Monotonic time in seconds */
+static double stats_now(void) {
+#if defined(ZINT_WIN)
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double) count.QuadPart / (double) frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+    return (double) clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+static void stats_add(struct batch_stats *stats, const int phase, const double seconds) {
+    struct stats_phase *p = &stats->phases[phase];
+    int bucket = 0;
+
+    if (seconds > 0.0) {
+        bucket = (int) floor((log10(seconds) - STATS_MIN_EXP) * STATS_BUCKETS_PER_DECADE);
+        if (bucket < 0) {
+            bucket = 0;
+        } else if (bucket >= STATS_BUCKETS) {
+            bucket = STATS_BUCKETS - 1;
+        }
+    }
+    p->buckets[bucket]++;
+    p->count++;
+    p->total += seconds;
+    if (seconds > p->max) {
+        p->max = seconds;
+    }
+}
+
+/* Estimate the `percent` percentile of a phase as the geometric middle of the bucket it falls in */
+static double stats_percentile(const struct stats_phase *p, const double percent) {
+    const double rank = p->count * percent / 100.0;
+    long cumulative = 0;
+    int i;
+
+    for (i = 0; i < STATS_BUCKETS; i++) {
+        cumulative += p->buckets[i];
+        if (cumulative >= rank && cumulative) {
+            const double seconds = pow(10.0, STATS_MIN_EXP + (i + 0.5) / STATS_BUCKETS_PER_DECADE);
+            return seconds < p->max ? seconds : p->max;
+        }
+    }
+    return p->max;
+}
+
+/* Print a summary of `stats` to stderr, and if `json_filename` given write them in JSON to it ("-" for stdout) */
+static int stats_report(const struct batch_stats *stats, const int threads, const char *json_filename) {
+    static const char *names[STATS_PHASES] = { "read", "encode", "render", "write" };
+    static const double percents[3] = { 50.0, 90.0, 99.0 };
+    const double elapsed = stats_now() - stats->start;
+    const double rate = elapsed > 0.0 ? stats->lines / elapsed : 0.0;
+    int i, j;
+
+    fprintf(stderr, "Stats: %ld lines (%ld errors) in %.3fs with %d thread%s, %.1f lines/s, %.0f bytes written\n",
+            stats->lines, stats->errors, elapsed, threads, threads == 1 ? "" : "s", rate, stats->bytes);
+    fprintf(stderr, "  Phase      Count   Total(s)   Mean(ms)    p50(ms)    p90(ms)    p99(ms)    Max(ms)\n");
+    for (i = 0; i < STATS_PHASES; i++) {
+        const struct stats_phase *p = &stats->phases[i];
+        fprintf(stderr, "  %-6s %9ld %10.3f %10.3f", names[i], p->count, p->total,
+                p->count ? p->total * 1000.0 / p->count : 0.0);
+        for (j = 0; j < 3; j++) {
+            fprintf(stderr, " %10.3f", stats_percentile(p, percents[j]) * 1000.0);
+        }
+        fprintf(stderr, " %10.3f\n", p->max * 1000.0);
+    }
+    fflush(stderr);
+
+    if (json_filename) {
+        FILE *file = strcmp(json_filename, "-") == 0 ? stdout : fopen(json_filename, "w");
+        int ok;
+        if (!file) {
+            return 0;
+        }
+        fprintf(file, "{\n  \"zint_version\": %d,\n", ZBarcode_Version());
+        fprintf(file, "  \"threads\": %d,\n  \"lines\": %ld,\n  \"errors\": %ld,\n", threads, stats->lines,
+                stats->errors);
+        fprintf(file, "  \"elapsed_seconds\": %.9g,\n  \"lines_per_second\": %.9g,\n  \"bytes_written\": %.0f,\n",
+                elapsed, rate, stats->bytes);
+        fprintf(file, "  \"phases\": {\n");
+        for (i = 0; i < STATS_PHASES; i++) {
+            const struct stats_phase *p = &stats->phases[i];
+            fprintf(file, "    \"%s\": { \"count\": %ld, \"total_seconds\": %.9g, \"mean_seconds\": %.9g,",
+                    names[i], p->count, p->total, p->count ? p->total / p->count : 0.0);
+            fprintf(file, " \"p50_seconds\": %.9g, \"p90_seconds\": %.9g, \"p99_seconds\": %.9g,"
+                    " \"max_seconds\": %.9g }%s\n", stats_percentile(p, 50.0), stats_percentile(p, 90.0),
+                    stats_percentile(p, 99.0), p->max, i + 1 < STATS_PHASES ? "," : "");
+        }
+        fprintf(file, "  }\n}\n");
+        ok = !ferror(file);
+        if (file == stdout) {
+            fflush(file);
+        } else if (fclose(file) != 0) {
+            ok = 0;
+        }
+        return ok;
+    }
+    return 1;
+}
+
+/* Rename file `from` to `to`, replacing any existing `to` */
+static int file_replace(const char *from, const char *to) {
+#ifdef ZINT_WIN
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+/* Write in-memory output `data` to `outfile` or, if `to_stdout`, stdout, as `ZBarcode_Print()` would have done.
+   If `atomic`, the data is written to `outfile` with ".part" appended, which is then renamed to `outfile`, so that
+   `outfile` only ever appears complete */
+static int batch_write_file(const char *outfile, const int to_stdout, const int atomic, const unsigned char *data,
+            const int size) {
+    const char *extension = get_extension(outfile);
+    char filetype[4] = {0};
+    char partfile[256 + 5];
+    const char *filename = outfile;
+    int text;
+    FILE *file;
+    int ok;
+
+    if (extension) {
+        strncpy(filetype, extension, 3);
+        to_lower(filetype);
+    }
+    text = strcmp(filetype, "txt") == 0 || strcmp(filetype, "eps") == 0 || strcmp(filetype, "svg") == 0;
+
+    if (to_stdout) {
+#ifdef ZINT_WIN
+        if (!text) {
+            _setmode(_fileno(stdout), _O_BINARY);
+        }
+#endif
+        file = stdout;
+    } else {
+        if (atomic) {
+            strcpy(partfile, outfile);
+            strcat(partfile, ".part");
+            filename = partfile;
+        }
+        if (!(file = fopen(filename, text ? "w" : "wb"))) {
+            return 0;
+        }
+    }
+    ok = fwrite(data, 1, size, file) == (size_t) size;
+    if (file == stdout) {
+        ok = fflush(file) == 0 && ok;
+    } else if (fclose(file) != 0) {
+        ok = 0;
+    }
+    if (filename == partfile) {
+        if (ok) {
+            ok = file_replace(partfile, outfile);
+        }
+        if (!ok) {
+            (void) remove(partfile);
+        }
+    }
+    return ok;
+}
+
+/* Cache of repeated data for `--dedupe`, keyed by `ZBarcode_Content_Hash()` of the settings and data. Each entry
+   keeps the serialized encoded symbol (`ZBarcode_Serialize()`) and its last output, least recently used entries
+   being discarded first */
+struct dedupe_entry {
+    struct dedupe_entry *lru_prev; /* Least recently used list, most recent first */
+    struct dedupe_entry *lru_next;
+    struct dedupe_entry *hash_next; /* Next in hash chain */
+    char hash[17];
+    unsigned char *source; /* Part of the entry's allocation */
+    int length;
+    int error_number;
+    char errtxt[100];
+    unsigned char *serial; /* NULL if encoding failed */
+    int serial_size;
+    unsigned char *printed; /* Last output if any */
+    int printed_size;
+    int print_rotate;
+    char print_type[4];
+    int print_error_number;
+    char print_errtxt[100];
+};
+
+struct dedupe_cache {
+    int max_entries;
+    int count;
+    unsigned int table_mask;
+    struct dedupe_entry **table;
+    struct dedupe_entry *lru_head;
+    struct dedupe_entry *lru_tail;
+    struct dedupe_entry *last; /* Entry of last `dedupe_encode()` if cached */
+};
+
+static void dedupe_lru_unlink(struct dedupe_cache *cache, struct dedupe_entry *entry) {
+    if (entry->lru_prev) {
+        entry->lru_prev->lru_next = entry->lru_next;
+    } else {
+        cache->lru_head = entry->lru_next;
+    }
+    if (entry->lru_next) {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    } else {
+        cache->lru_tail = entry->lru_prev;
+    }
+}
+
+static void dedupe_lru_push(struct dedupe_cache *cache, struct dedupe_entry *entry) {
+    entry->lru_prev = NULL;
+    entry->lru_next = cache->lru_head;
+    if (cache->lru_head) {
+        cache->lru_head->lru_prev = entry;
+    } else {
+        cache->lru_tail = entry;
+    }
+    cache->lru_head = entry;
+}
+
+/* Index into hash table of content hash `hash` (hex digits) */
+static unsigned int dedupe_index(const struct dedupe_cache *cache, const char hash[17]) {
+    return (unsigned int) strtoul(hash + 8, NULL, 16) & cache->table_mask;
+}
+
+/* Remove the least recently used entry */
+static void dedupe_evict(struct dedupe_cache *cache) {
+    struct dedupe_entry *entry = cache->lru_tail;
+    struct dedupe_entry **p_chain = &cache->table[dedupe_index(cache, entry->hash)];
+
+    while (*p_chain != entry) {
+        p_chain = &(*p_chain)->hash_next;
+    }
+    *p_chain = entry->hash_next;
+    dedupe_lru_unlink(cache, entry);
+    if (cache->last == entry) {
+        cache->last = NULL;
+    }
+    ZBarcode_Serialize_Delete(entry->serial);
+    free(entry->printed);
+    free(entry);
+    cache->count--;
+}
+
+/* Create a cache of at most `max_entries` symbols, NULL on memory failure */
+static struct dedupe_cache *dedupe_create(const int max_entries) {
+    struct dedupe_cache *cache;
+    unsigned int table_size = 16;
+
+    while (table_size < (unsigned int) max_entries) {
+        table_size <<= 1;
+    }
+    if (!(cache = (struct dedupe_cache *) calloc(1, sizeof(struct dedupe_cache)))) {
+        return NULL;
+    }
+    if (!(cache->table = (struct dedupe_entry **) calloc(table_size, sizeof(struct dedupe_entry *)))) {
+        free(cache);
+        return NULL;
+    }
+    cache->max_entries = max_entries;
+    cache->table_mask = table_size - 1;
+
+    return cache;
+}
+
+static void dedupe_delete(struct dedupe_cache *cache) {
+    if (!cache) {
+        return;
+    }
+    while (cache->lru_tail) {
+        dedupe_evict(cache);
+    }
+    free(cache->table);
+    free(cache);
+}
+
+/* As `ZBarcode_Encode()`, except that if `symbol` has the same settings and `source` as an earlier call with
+   `cache` (which may be NULL) the serialized result is loaded instead of encoding again */
+static int dedupe_encode(struct dedupe_cache *cache, struct zint_symbol *symbol, const unsigned char *source,
+            const int length) {
+    struct dedupe_entry *entry;
+    char hash[17];
+    unsigned int index;
+    int error_number;
+
+    if (!cache || ZBarcode_Content_Hash(symbol, source, length, hash) != 0) {
+        return ZBarcode_Encode(symbol, source, length);
+    }
+    cache->last = NULL;
+
+    index = dedupe_index(cache, hash);
+    for (entry = cache->table[index]; entry; entry = entry->hash_next) {
+        if (strcmp(entry->hash, hash) == 0 && entry->length == length
+                && memcmp(entry->source, source, length) == 0) {
+            break;
+        }
+    }
+    if (entry) {
+        if (entry->serial) {
+            (void) ZBarcode_Deserialize(symbol, entry->serial, entry->serial_size);
+        } else {
+            ZBarcode_Clear(symbol);
+        }
+        strcpy(symbol->errtxt, entry->errtxt);
+        dedupe_lru_unlink(cache, entry);
+        dedupe_lru_push(cache, entry);
+        cache->last = entry;
+        return entry->error_number;
+    }
+
+    error_number = ZBarcode_Encode(symbol, source, length);
+
+    if (!(entry = (struct dedupe_entry *) calloc(1, sizeof(struct dedupe_entry) + length))) {
+        return error_number; /* Not cached */
+    }
+    if (error_number < ZINT_ERROR && ZBarcode_Serialize(symbol, &entry->serial, &entry->serial_size) != 0) {
+        free(entry);
+        return error_number; /* Not cached */
+    }
+    strcpy(entry->hash, hash);
+    entry->source = (unsigned char *) (entry + 1);
+    memcpy(entry->source, source, length);
+    entry->length = length;
+    entry->error_number = error_number;
+    strcpy(entry->errtxt, symbol->errtxt);
+
+    if (cache->count == cache->max_entries) {
+        dedupe_evict(cache);
+    }
+    entry->hash_next = cache->table[index];
+    cache->table[index] = entry;
+    dedupe_lru_push(cache, entry);
+    cache->count++;
+    cache->last = entry;
+
+    return error_number;
+}
+
+/* As `ZBarcode_Print()` (with `symbol` just encoded by `dedupe_encode()`), except that the output is kept in
+   `cache`, and taken from it if printed the same way before. The output is returned in `p_data` and `p_size`,
+   owned by the cache or `symbol`, unless it failed */
+static int dedupe_print(struct dedupe_cache *cache, struct zint_symbol *symbol, const int rotate_angle,
+            const unsigned char **p_data, int *p_size) {
+    struct dedupe_entry *entry;
+    const char *extension = get_extension(symbol->outfile);
+    const int to_memory = symbol->output_options & BARCODE_MEMORY_FILE;
+    char type[4] = {0};
+    int error_number;
+
+    *p_data = NULL;
+    *p_size = 0;
+    if (!cache || !(entry = cache->last) || !entry->serial || !extension) {
+        error_number = ZBarcode_Print(symbol, rotate_angle);
+        *p_data = symbol->memfile;
+        *p_size = symbol->memfile_size;
+        return error_number;
+    }
+    strncpy(type, extension, 3);
+    to_lower(type);
+
+    if (!entry->printed || entry->print_rotate != rotate_angle || strcmp(entry->print_type, type) != 0) {
+        unsigned char *printed;
+
+        /* Print to memory, keeping a copy */
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+        error_number = ZBarcode_Print(symbol, rotate_angle);
+        if (!to_memory) {
+            symbol->output_options &= ~BARCODE_MEMORY_FILE;
+        }
+        if (error_number >= ZINT_ERROR) {
+            return error_number;
+        }
+        if (!(printed = (unsigned char *) malloc(symbol->memfile_size + 1))) {
+            strcpy(symbol->errtxt, "Error 157: Memory failure");
+            return ZINT_ERROR_MEMORY;
+        }
+        free(entry->printed);
+        memcpy(printed, symbol->memfile, symbol->memfile_size);
+        entry->printed = printed;
+        entry->printed_size = symbol->memfile_size;
+        entry->print_rotate = rotate_angle;
+        strcpy(entry->print_type, type);
+        entry->print_error_number = error_number;
+        strcpy(entry->print_errtxt, symbol->errtxt);
+    } else {
+        strcpy(symbol->errtxt, entry->print_errtxt);
+    }
+    if (!to_memory && !batch_write_file(symbol->outfile, symbol->output_options & BARCODE_STDOUT, 0 /*atomic*/,
+                                        entry->printed, entry->printed_size)) {
+        sprintf(symbol->errtxt, "Error 170: Could not write output file '%.50s'", symbol->outfile);
+        return ZINT_ERROR_FILE_ACCESS;
+    }
+    *p_data = entry->printed;
+    *p_size = entry->printed_size;
+    return entry->print_error_number;
+}
+
+#ifdef ZINT_THREADS
+static void batch_queue_init(struct batch_queue *queue, const int stats, const int atomic) {
+    memset(queue, 0, sizeof(*queue));
+    batch_mutex_init(&queue->mutex);
+    batch_cond_init(&queue->not_empty);
+    batch_cond_init(&queue->not_full);
+    batch_cond_init(&queue->drained);
+    queue->stats = stats;
+    queue->atomic = atomic;
+}
+
+static void batch_queue_destroy(struct batch_queue *queue) {
+    batch_cond_destroy(&queue->drained);
+    batch_cond_destroy(&queue->not_full);
+    batch_cond_destroy(&queue->not_empty);
+    batch_mutex_destroy(&queue->mutex);
+}
+
+/* Add a line with output `memfile` to the queue, waiting while it's full */
+static void batch_queue_push(struct batch_queue *queue, struct batch_line *line) {
+    batch_mutex_lock(&queue->mutex);
+    while (queue->count == BATCH_QUEUE_SIZE) {
+        batch_cond_wait(&queue->not_full, &queue->mutex);
+    }
+    queue->lines[(queue->head + queue->count) % BATCH_QUEUE_SIZE] = line;
+    queue->count++;
+    batch_cond_signal(&queue->not_empty);
+    batch_mutex_unlock(&queue->mutex);
+}
+
+/* Wait until all the lines added have been written */
+static void batch_queue_drain(struct batch_queue *queue) {
+    batch_mutex_lock(&queue->mutex);
+    while (queue->count || queue->busy) {
+        batch_cond_wait(&queue->drained, &queue->mutex);
+    }
+    batch_mutex_unlock(&queue->mutex);
+}
+
+/* Tell the writer to finish once the queue is empty */
+static void batch_queue_finish(struct batch_queue *queue) {
+    batch_mutex_lock(&queue->mutex);
+    queue->done = 1;
+    batch_cond_signal(&queue->not_empty);
+    batch_mutex_unlock(&queue->mutex);
+}
+
+/* Writer stage - write each line's output taken from the queue to its output file, freeing it, until finished.
+   Failures are flagged by `write_failed` rather than `error_number`, which the worker may still be setting */
+static void batch_writer_run(struct batch_queue *queue) {
+    struct batch_line *line;
+
+    for (;;) {
+        batch_mutex_lock(&queue->mutex);
+        while (queue->count == 0 && !queue->done) {
+            batch_cond_wait(&queue->not_empty, &queue->mutex);
+        }
+        if (queue->count == 0) {
+            batch_mutex_unlock(&queue->mutex);
+            break;
+        }
+        line = queue->lines[queue->head];
+        queue->head = (queue->head + 1) % BATCH_QUEUE_SIZE;
+        queue->count--;
+        queue->busy = 1;
+        batch_cond_signal(&queue->not_full);
+        batch_mutex_unlock(&queue->mutex);
+
+        if (queue->stats) {
+            const double start = stats_now();
+            line->write_failed = !batch_write_file(line->outfile, 0, queue->atomic, line->memfile,
+                                    line->memfile_size);
+            line->write_time = stats_now() - start;
+        } else {
+            line->write_failed = !batch_write_file(line->outfile, 0, queue->atomic, line->memfile,
+                                    line->memfile_size);
+        }
+        free(line->memfile);
+        line->memfile = NULL;
+
+        batch_mutex_lock(&queue->mutex);
+        queue->busy = 0;
+        if (queue->count == 0) {
+            batch_cond_signal(&queue->drained);
+        }
+        batch_mutex_unlock(&queue->mutex);
+    }
+}
+#endif /* ZINT_THREADS */
+
+/* `ZBarcode_Encode_Batch()` callback to output each successfully encoded line */
+static int batch_item_print(void *context, struct zint_symbol *symbol, int index, int error_number) {
+    struct batch_worker *worker = (struct batch_worker *) context;
+
+    struct batch_line *line;
+    double encoded = 0.0, rendered = 0.0;
+
+    index += worker->base;
+    line = worker->lines[index];
+    if (worker->stats) {
+        encoded = stats_now();
+        line->timed = 1;
+        line->rendered = 0;
+        line->encode_time = encoded - worker->mark;
+    }
+    if (error_number < ZINT_ERROR) {
+        const unsigned char *memfile;
+        int memfile_size;
+        int print_number;
+
+        strcpy(symbol->outfile, line->outfile);
+        print_number = dedupe_print(worker->cache, symbol, worker->rotate_angle, &memfile, &memfile_size);
+        if (print_number != 0) {
+            worker->items[index].error_number = print_number;
+            strcpy(worker->items[index].errtxt, symbol->errtxt);
+        }
+        if (worker->stats && print_number < ZINT_ERROR) {
+            rendered = stats_now();
+            line->rendered = 1;
+            line->render_time = rendered - encoded;
+            line->bytes = memfile_size;
+        }
+        if ((worker->stats || worker->atomic) && !worker->archive && !worker->queue && print_number < ZINT_ERROR) {
+            if (!batch_write_file(symbol->outfile, symbol->output_options & BARCODE_STDOUT, worker->atomic,
+                    memfile, memfile_size)) {
+                worker->items[index].error_number = ZINT_ERROR_FILE_ACCESS;
+                sprintf(worker->items[index].errtxt, "Error 170: Could not write output file '%.50s'",
+                        symbol->outfile);
+            }
+            if (worker->stats) {
+                line->write_time = stats_now() - rendered;
+            }
+        }
+        if ((worker->archive || worker->queue) && print_number < ZINT_ERROR) {
+            /* Keep output file, as `ZBarcode_Encode_Batch()` clears the symbol before the next line */
+            if (!(line->memfile = (unsigned char *) malloc(memfile_size + 1))) {
+                worker->items[index].error_number = ZINT_ERROR_MEMORY;
+                strcpy(worker->items[index].errtxt, "Error 157: Memory failure");
+            } else {
+                memcpy(line->memfile, memfile, memfile_size);
+                line->memfile_size = memfile_size;
+#ifdef ZINT_THREADS
+                if (worker->queue) {
+                    batch_queue_push(worker->queue, line); /* Writer takes ownership of `memfile` */
+                }
+#endif
+            }
+        }
+    }
+    if (worker->stats) {
+        worker->mark = stats_now();
+    }
+    return 0;
+}
+
+/* Reset `symbol` to the settings of the (never encoded) `settings` symbol, keeping its own library-private state
+   (including its raster working buffers) */
+static void symbol_reset(struct zint_symbol *symbol, const struct zint_symbol *settings) {
+    struct zint_internal *internal;
+
+    ZBarcode_Clear(symbol);
+    internal = symbol->internal;
+    memcpy(symbol, settings, sizeof(*symbol));
+    symbol->internal = internal;
+    symbol->fgcolor = &symbol->fgcolour[0];
+    symbol->bgcolor = &symbol->bgcolour[0];
+}
+
+/* Compare record settings of lines for `qsort()`, keeping lines with the same settings in input order */
+static int batch_record_cmp(const void *a, const void *b) {
+    const struct batch_line *line_a = *((const struct batch_line **) a);
+    const struct batch_line *line_b = *((const struct batch_line **) b);
+    const struct batch_record *rec_a = &line_a->record;
+    const struct batch_record *rec_b = &line_b->record;
+    int cmp;
+
+    if (rec_a->symbology != rec_b->symbology) {
+        return rec_a->symbology < rec_b->symbology ? -1 : 1;
+    }
+    if (rec_a->option_1 != rec_b->option_1) {
+        return rec_a->option_1 < rec_b->option_1 ? -1 : 1;
+    }
+    if (rec_a->option_2 != rec_b->option_2) {
+        return rec_a->option_2 < rec_b->option_2 ? -1 : 1;
+    }
+    if (rec_a->scale != rec_b->scale) {
+        return rec_a->scale < rec_b->scale ? -1 : 1;
+    }
+    if ((cmp = strcmp(rec_a->filetype, rec_b->filetype)) != 0) {
+        return cmp;
+    }
+    return line_a->line_count < line_b->line_count ? -1 : line_a->line_count > line_b->line_count;
+}
+
+/* Whether lines have the same record settings */
+static int batch_record_same(const struct batch_line *line_a, const struct batch_line *line_b) {
+    const struct batch_record *rec_a = &line_a->record;
+    const struct batch_record *rec_b = &line_b->record;
+
+    return rec_a->symbology == rec_b->symbology && rec_a->option_1 == rec_b->option_1
+            && rec_a->option_2 == rec_b->option_2 && rec_a->scale == rec_b->scale
+            && strcmp(rec_a->filetype, rec_b->filetype) == 0;
+}
+
+/* Reset `symbol` to the worker's settings, overridden by `record` if using records */
+static void batch_symbol_setup(const struct batch_worker *worker, struct zint_symbol *symbol,
+            const struct batch_record *record) {
+    symbol_reset(symbol, worker->settings);
+    if (worker->archive || worker->stats || worker->atomic || worker->queue) {
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+    }
+    if (worker->records) {
+        if (record->symbology) {
+            symbol->symbology = record->symbology;
+        }
+        if (record->option_1 != -1) {
+            symbol->option_1 = record->option_1;
+        }
+        if (record->option_2) {
+            symbol->option_2 = record->option_2;
+        }
+        if (record->scale) {
+            symbol->scale = record->scale;
+        }
+    }
+}
+
+/* Encode and output a worker's lines using a copy of the settings symbol, with lines having the same record
+   settings (if any) grouped together so that each group is encoded in one `ZBarcode_Encode_Batch()` call */
+static void batch_worker_run(struct batch_worker *worker) {
+    struct zint_symbol *symbol;
+    int ret, i, end;
+
+    if (!(symbol = ZBarcode_Create())) {
+        for (i = 0; i < worker->count; i++) {
+            worker->lines[i]->error_number = ZINT_ERROR_MEMORY;
+            strcpy(worker->lines[i]->errtxt, "Error 157: Memory failure");
+        }
+        return;
+    }
+
+    if (worker->dedupe && !worker->cache) {
+        worker->cache = dedupe_create(BATCH_DEDUPE_ENTRIES); /* Not fatal if fails */
+    }
+    if (worker->records && worker->count > 1) {
+        qsort(worker->lines, worker->count, sizeof(struct batch_line *), batch_record_cmp);
+    }
+
+    for (i = 0; i < worker->count; i++) {
+        worker->items[i].source = worker->lines[i]->data;
+        worker->items[i].length = worker->lines[i]->length;
+        worker->items[i].error_number = -1;
+        worker->items[i].errtxt[0] = '\0';
+    }
+
+    for (worker->base = 0; worker->base < worker->count; worker->base = end) {
+        const struct batch_record *record = &worker->lines[worker->base]->record;
+
+        for (end = worker->base + 1; end < worker->count
+                && batch_record_same(worker->lines[worker->base], worker->lines[end]); end++);
+
+        if (worker->cache) {
+            /* Encode each line separately so that repeats are loaded from the cache */
+            ret = 0;
+            for (i = worker->base; i < end; i++) {
+                batch_symbol_setup(worker, symbol, record);
+                if (worker->stats) {
+                    worker->mark = stats_now();
+                }
+                worker->items[i].error_number = dedupe_encode(worker->cache, symbol, worker->items[i].source,
+                                                    worker->items[i].length);
+                strcpy(worker->items[i].errtxt, symbol->errtxt);
+                batch_item_print(worker, symbol, i - worker->base, worker->items[i].error_number);
+            }
+        } else {
+            batch_symbol_setup(worker, symbol, record);
+            if (worker->stats) {
+                worker->mark = stats_now();
+            }
+            ret = ZBarcode_Encode_Batch(symbol, worker->items + worker->base, end - worker->base,
+                    batch_item_print, worker);
+        }
+
+        for (i = worker->base; i < end; i++) {
+            if (worker->items[i].error_number == -1) { /* Settings invalid so not encoded */
+                worker->lines[i]->error_number = ret;
+                strcpy(worker->lines[i]->errtxt, symbol->errtxt);
+            } else {
+                worker->lines[i]->error_number = worker->items[i].error_number;
+                strcpy(worker->lines[i]->errtxt, worker->items[i].errtxt);
+            }
+        }
+    }
+
+    ZBarcode_Delete(symbol);
+}
+
+#ifdef ZINT_THREADS
+#ifdef ZINT_WIN
+static DWORD WINAPI batch_thread_func(LPVOID arg) {
+    batch_worker_run((struct batch_worker *) arg);
+    return 0;
+}
+
+static DWORD WINAPI batch_writer_func(LPVOID arg) {
+    batch_writer_run((struct batch_queue *) arg);
+    return 0;
+}
+#else
+static void *batch_thread_func(void *arg) {
+    batch_worker_run((struct batch_worker *) arg);
+    return NULL;
+}
+
+static void *batch_writer_func(void *arg) {
+    batch_writer_run((struct batch_queue *) arg);
+    return NULL;
+}
+#endif
+
+/* Start a thread running `worker`, or the writer stage if `queue` non-NULL, returning 0 on failure */
+static int batch_thread_start(batch_thread_t *p_thread, struct batch_worker *worker, struct batch_queue *queue) {
+#ifdef ZINT_WIN
+    if (queue) {
+        *p_thread = CreateThread(NULL, 0, batch_writer_func, queue, 0, NULL);
+    } else {
+        *p_thread = CreateThread(NULL, 0, batch_thread_func, worker, 0, NULL);
+    }
+    return *p_thread != NULL;
+#else
+    if (queue) {
+        return pthread_create(p_thread, NULL, batch_writer_func, queue) == 0;
+    }
+    return pthread_create(p_thread, NULL, batch_thread_func, worker) == 0;
+#endif
+}
+
+static void batch_thread_join(batch_thread_t thread) {
+#ifdef ZINT_WIN
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+#endif /* ZINT_THREADS */
+
+/* Worker for an output filename */
+static int batch_worker_index(const char *outfile, const int threads) {
+    unsigned int hash = 2166136261u; /* FNV-1a */
+
+    while (*outfile) {
+        hash = (hash ^ (unsigned char) *outfile++) * 16777619u;
+    }
+    return (int) (hash % (unsigned int) threads);
+}
+
+/* Batch archive output - all symbols written as entries of a single tar or zip (stored) file rather than a file
+   each, the entries being added in line order */
+
+/* Zip central directory record kept for each entry */
+struct archive_entry {
+    uint32_t crc;
+    uint32_t size;
+    uint64_t offset; /* Of local header */
+    int name_posn; /* Into `names` */
+    int name_len;
+};
+
+struct batch_archive {
+    FILE *file;
+    int zip; /* Else tar */
+    int error; /* Set on write failure */
+    unsigned long mtime; /* Seconds since epoch (tar) */
+    unsigned short dos_time, dos_date; /* (zip) */
+    uint64_t offset; /* Bytes written so far (zip) */
+    struct archive_entry *entries;
+    int entries_count, entries_size;
+    char *names;
+    int names_len, names_size;
+};
+
+/* Standard CRC-32 (reflected polynomial 0xEDB88320) */
+static const uint32_t archive_crc32_table[256] = {
+        0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+        0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+        0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+        0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+        0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+        0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+        0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+        0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+        0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+        0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+        0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+        0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+        0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+        0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+        0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+        0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+        0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+        0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+        0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+        0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+        0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+        0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+        0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+        0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+        0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+        0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+        0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+        0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+        0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+        0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+        0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+        0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
+};
+
+static uint32_t archive_crc32(const unsigned char *data, const int length) {
+    uint32_t crc = 0xFFFFFFFF;
+    int i;
+
+    for (i = 0; i < length; i++) {
+        crc = archive_crc32_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static void archive_write(struct batch_archive *archive, const void *data, const size_t length) {
+    if (!archive->error && length && fwrite(data, 1, length, archive->file) != length) {
+        archive->error = 1;
+    }
+    archive->offset += length;
+}
+
+/* Put little-endian value of `bytes` bytes */
+static unsigned char *archive_put_le(unsigned char *p, uint64_t val, int bytes) {
+    while (bytes--) {
+        *p++ = (unsigned char) (val & 0xFF);
+        val >>= 8;
+    }
+    return p;
+}
+
+/* Open archive `filename` ("-" for a tar to stdout), returning 0 on failure */
+static int archive_open(struct batch_archive *archive, const char *filename) {
+    time_t now = time(NULL);
+    struct tm *tm = localtime(&now);
+
+    memset(archive, 0, sizeof(*archive));
+    if (strcmp(filename, "-") == 0) {
+#ifdef ZINT_WIN
+        if (_setmode(_fileno(stdout), _O_BINARY) == -1) {
+            return 0;
+        }
+#endif
+        archive->file = stdout;
+    } else {
+        const char *extension = get_extension(filename);
+        char lc_extension[4] = {0};
+        if (extension) {
+            strncpy(lc_extension, extension, 3);
+            to_lower(lc_extension);
+        }
+        archive->zip = strcmp(lc_extension, "zip") == 0;
+        if (!(archive->file = fopen(filename, "wb"))) {
+            return 0;
+        }
+    }
+    archive->mtime = now > 0 ? (unsigned long) now : 0;
+    if (tm && tm->tm_year >= 80) {
+        archive->dos_time = (unsigned short) ((tm->tm_hour << 11) | (tm->tm_min << 5) | (tm->tm_sec >> 1));
+        archive->dos_date = (unsigned short) (((tm->tm_year - 80) << 9) | ((tm->tm_mon + 1) << 5) | tm->tm_mday);
+    } else {
+        archive->dos_date = (1 << 5) | 1; /* 1980-01-01 */
+    }
+    return 1;
+}
+
+/* Fill in and write a tar (ustar) header block */
+static void archive_tar_header(struct batch_archive *archive, const char *name, const unsigned long size,
+            const char typeflag) {
+    unsigned char header[512];
+    unsigned int checksum = 0;
+    int i;
+
+    memset(header, 0, sizeof(header));
+    strncpy((char *) header, name, 100);
+    strcpy((char *) header + 100, "0000644");
+    strcpy((char *) header + 108, "0000000");
+    strcpy((char *) header + 116, "0000000");
+    sprintf((char *) header + 124, "%011lo", size);
+    sprintf((char *) header + 136, "%011lo", archive->mtime);
+    memset(header + 148, ' ', 8); /* Checksum counted as spaces */
+    header[156] = typeflag;
+    memcpy(header + 257, "ustar", 6);
+    memcpy(header + 263, "00", 2);
+    for (i = 0; i < 512; i++) {
+        checksum += header[i];
+    }
+    sprintf((char *) header + 148, "%06o", checksum); /* Followed by NUL and space */
+    archive_write(archive, header, sizeof(header));
+}
+
+static void archive_tar_pad(struct batch_archive *archive, const unsigned long size) {
+    static const unsigned char zeroes[512] = {0};
+
+    if (size % 512) {
+        archive_write(archive, zeroes, 512 - size % 512);
+    }
+}
+
+/* Add a file entry to the archive */
+static void archive_add(struct batch_archive *archive, const char *name, const unsigned char *data,
+            const int length) {
+    const int name_len = (int) strlen(name);
+
+    if (!archive->zip) {
+        if (name_len > 100) {
+            /* GNU long name extension */
+            archive_tar_header(archive, "././@LongLink", name_len + 1, 'L');
+            archive_write(archive, name, name_len + 1);
+            archive_tar_pad(archive, name_len + 1);
+        }
+        archive_tar_header(archive, name, (unsigned long) length, '0');
+        archive_write(archive, data, length);
+        archive_tar_pad(archive, length);
+    } else {
+        unsigned char header[30], *p;
+        struct archive_entry *entry;
+
+        if (archive->entries_count == archive->entries_size) {
+            int new_size = archive->entries_size ? archive->entries_size * 2 : 1024;
+            struct archive_entry *entries = (struct archive_entry *) realloc(archive->entries,
+                                                sizeof(struct archive_entry) * new_size);
+            if (!entries) {
+                archive->error = 1;
+                return;
+            }
+            archive->entries = entries;
+            archive->entries_size = new_size;
+        }
+        if (archive->names_len + name_len > archive->names_size) {
+            int new_size = archive->names_size ? archive->names_size * 2 : 65536;
+            char *names;
+            while (new_size < archive->names_len + name_len) {
+                new_size *= 2;
+            }
+            if (!(names = (char *) realloc(archive->names, new_size))) {
+                archive->error = 1;
+                return;
+            }
+            archive->names = names;
+            archive->names_size = new_size;
+        }
+        entry = &archive->entries[archive->entries_count++];
+        entry->crc = archive_crc32(data, length);
+        entry->size = (uint32_t) length;
+        entry->offset = archive->offset;
+        entry->name_posn = archive->names_len;
+        entry->name_len = name_len;
+        memcpy(archive->names + archive->names_len, name, name_len);
+        archive->names_len += name_len;
+
+        p = archive_put_le(header, 0x04034B50, 4); /* Local file header signature */
+        p = archive_put_le(p, 20, 2); /* Version needed (2.0) */
+        p = archive_put_le(p, 0x0800, 2); /* Flags - UTF-8 name */
+        p = archive_put_le(p, 0, 2); /* Method - stored */
+        p = archive_put_le(p, archive->dos_time, 2);
+        p = archive_put_le(p, archive->dos_date, 2);
+        p = archive_put_le(p, entry->crc, 4);
+        p = archive_put_le(p, entry->size, 4); /* Compressed size */
+        p = archive_put_le(p, entry->size, 4); /* Uncompressed size */
+        p = archive_put_le(p, name_len, 2);
+        (void) archive_put_le(p, 0, 2); /* Extra field length */
+        archive_write(archive, header, sizeof(header));
+        archive_write(archive, name, name_len);
+        archive_write(archive, data, length);
+    }
+}
+
+/* Finish off and close the archive, returning 0 if any write failed */
+static int archive_close(struct batch_archive *archive) {
+    int ret;
+
+    if (!archive->zip) {
+        static const unsigned char zeroes[1024] = {0};
+        archive_write(archive, zeroes, sizeof(zeroes)); /* End of archive - 2 zero blocks */
+    } else {
+        const uint64_t cd_offset = archive->offset;
+        uint64_t cd_size;
+        int zip64 = archive->entries_count >= 0xFFFF;
+        unsigned char record[56], *p;
+        int i;
+
+        for (i = 0; i < archive->entries_count; i++) {
+            const struct archive_entry *entry = &archive->entries[i];
+            const int offset64 = entry->offset >= 0xFFFFFFFF;
+
+            p = archive_put_le(record, 0x02014B50, 4); /* Central directory header signature */
+            p = archive_put_le(p, offset64 ? 45 : 20, 2); /* Version made by */
+            p = archive_put_le(p, offset64 ? 45 : 20, 2); /* Version needed */
+            p = archive_put_le(p, 0x0800, 2); /* Flags - UTF-8 name */
+            p = archive_put_le(p, 0, 2); /* Method - stored */
+            p = archive_put_le(p, archive->dos_time, 2);
+            p = archive_put_le(p, archive->dos_date, 2);
+            p = archive_put_le(p, entry->crc, 4);
+            p = archive_put_le(p, entry->size, 4);
+            p = archive_put_le(p, entry->size, 4);
+            p = archive_put_le(p, entry->name_len, 2);
+            p = archive_put_le(p, offset64 ? 12 : 0, 2); /* Extra field length */
+            p = archive_put_le(p, 0, 2); /* Comment length */
+            p = archive_put_le(p, 0, 2); /* Disk number start */
+            p = archive_put_le(p, 0, 2); /* Internal attributes */
+            p = archive_put_le(p, 0, 4); /* External attributes */
+            p = archive_put_le(p, offset64 ? 0xFFFFFFFF : entry->offset, 4);
+            archive_write(archive, record, p - record);
+            archive_write(archive, archive->names + entry->name_posn, entry->name_len);
+            if (offset64) {
+                /* Zip64 extended information extra field */
+                p = archive_put_le(record, 0x0001, 2);
+                p = archive_put_le(p, 8, 2);
+                p = archive_put_le(p, entry->offset, 8);
+                archive_write(archive, record, p - record);
+            }
+        }
+        cd_size = archive->offset - cd_offset;
+
+        if (zip64 || cd_offset >= 0xFFFFFFFF || cd_size >= 0xFFFFFFFF) {
+            const uint64_t eocd64_offset = archive->offset;
+
+            zip64 = 1;
+            p = archive_put_le(record, 0x06064B50, 4); /* Zip64 end of central directory signature */
+            p = archive_put_le(p, 44, 8); /* Size of remaining record */
+            p = archive_put_le(p, 45, 2); /* Version made by */
+            p = archive_put_le(p, 45, 2); /* Version needed */
+            p = archive_put_le(p, 0, 4); /* Disk number */
+            p = archive_put_le(p, 0, 4); /* Disk with central directory */
+            p = archive_put_le(p, archive->entries_count, 8); /* Entries on this disk */
+            p = archive_put_le(p, archive->entries_count, 8); /* Total entries */
+            p = archive_put_le(p, cd_size, 8);
+            p = archive_put_le(p, cd_offset, 8);
+            archive_write(archive, record, p - record);
+
+            p = archive_put_le(record, 0x07064B50, 4); /* Zip64 end of central directory locator signature */
+            p = archive_put_le(p, 0, 4); /* Disk with zip64 end of central directory */
+            p = archive_put_le(p, eocd64_offset, 8);
+            p = archive_put_le(p, 1, 4); /* Total disks */
+            archive_write(archive, record, p - record);
+        }
+
+        p = archive_put_le(record, 0x06054B50, 4); /* End of central directory signature */
+        p = archive_put_le(p, 0, 2); /* Disk number */
+        p = archive_put_le(p, 0, 2); /* Disk with central directory */
+        p = archive_put_le(p, zip64 ? 0xFFFF : archive->entries_count, 2);
+        p = archive_put_le(p, zip64 ? 0xFFFF : archive->entries_count, 2);
+        p = archive_put_le(p, zip64 ? 0xFFFFFFFF : cd_size, 4);
+        p = archive_put_le(p, zip64 ? 0xFFFFFFFF : cd_offset, 4);
+        p = archive_put_le(p, 0, 2); /* Comment length */
+        archive_write(archive, record, p - record);
+    }
+
+    if (archive->file == stdout) {
+        ret = fflush(stdout) == 0;
+    } else {
+        ret = fclose(archive->file) == 0;
+    }
+    free(archive->entries);
+    free(archive->names);
+    return ret && !archive->error;
+}
+
+/* Encode and output a chunk of `count` lines with `threads` workers, then report errors (and add to `archive` if
+   non-NULL) in line order. If `queue` non-NULL, outputs are passed to the writer stage, which must finish with
+   them before errors are reported. `worker_lines` and `worker_items` are shared out between the workers, by data
+   if `dedupe` is 2, otherwise by output filename. If `stats` non-NULL, the lines' timings are added to it. Returns
+   the result of the last line encoded (if any), else `error_number` */
+static int batch_chunk(const struct zint_symbol *symbol, struct batch_line lines[], const int count,
+            struct batch_worker workers[], const int threads, struct batch_line *worker_lines[],
+            struct zint_batch_item worker_items[], struct batch_archive *archive, struct batch_queue *queue,
+            const int rotate_angle, const int records_mode, const int dedupe, struct batch_stats *stats,
+            int error_number) {
+    int i, w, offset;
+#ifdef ZINT_THREADS
+    batch_thread_t thread_handles[BATCH_MAX_THREADS];
+    int started[BATCH_MAX_THREADS];
+#endif
+
+    for (w = 0; w < threads; w++) {
+        workers[w].settings = symbol;
+        workers[w].count = 0;
+        workers[w].rotate_angle = rotate_angle;
+        workers[w].archive = archive != NULL;
+        workers[w].records = records_mode;
+        workers[w].dedupe = dedupe != 0;
+        workers[w].stats = stats != NULL;
+        workers[w].queue = queue;
+    }
+    for (i = 0; i < count; i++) {
+        if (!lines[i].too_long && !lines[i].invalid) {
+            if (threads == 1) {
+                lines[i].worker = 0;
+            } else if (dedupe == 2) {
+                /* Send repeats to the same worker so its cache will have them */
+                lines[i].worker = batch_worker_index((const char *) lines[i].data, threads);
+            } else {
+                lines[i].worker = batch_worker_index(lines[i].outfile, threads);
+            }
+            workers[lines[i].worker].count++;
+        }
+    }
+    for (w = 0, offset = 0; w < threads; w++) {
+        workers[w].lines = worker_lines + offset;
+        workers[w].items = worker_items + offset;
+        offset += workers[w].count;
+        workers[w].count = 0;
+    }
+    for (i = 0; i < count; i++) {
+        if (!lines[i].too_long && !lines[i].invalid) {
+            struct batch_worker *worker = &workers[lines[i].worker];
+            worker->lines[worker->count++] = &lines[i];
+        }
+    }
+
+#ifdef ZINT_THREADS
+    /* Main thread runs the first worker itself */
+    for (w = 1; w < threads; w++) {
+        started[w] = workers[w].count && batch_thread_start(&thread_handles[w], &workers[w], NULL);
+    }
+#endif
+    for (w = 0; w < threads; w++) {
+#ifdef ZINT_THREADS
+        if (w && started[w]) {
+            continue;
+        }
+#endif
+        if (workers[w].count) {
+            batch_worker_run(&workers[w]);
+        }
+    }
+#ifdef ZINT_THREADS
+    for (w = 1; w < threads; w++) {
+        if (started[w]) {
+            batch_thread_join(thread_handles[w]);
+        }
+    }
+    if (queue) {
+        batch_queue_drain(queue);
+    }
+#endif
+
+    for (i = 0; i < count; i++) {
+        if (lines[i].too_long) {
+            fprintf(stderr, "On line %d: Error 103: Input data too long\n", lines[i].line_count);
+            fflush(stderr);
+        } else if (lines[i].invalid) {
+            error_number = ZINT_ERROR_INVALID_OPTION;
+            fprintf(stderr, "On line %d: %s\n", lines[i].line_count, lines[i].errtxt);
+            fflush(stderr);
+        } else if (lines[i].write_failed) {
+            error_number = ZINT_ERROR_FILE_ACCESS;
+            fprintf(stderr, "On line %d: Error 170: Could not write output file '%.50s'\n", lines[i].line_count,
+                    lines[i].outfile);
+            fflush(stderr);
+        } else {
+            error_number = lines[i].error_number;
+            if (error_number != 0) {
+                fprintf(stderr, "On line %d: %s\n", lines[i].line_count, lines[i].errtxt);
+                fflush(stderr);
+            }
+            if (lines[i].memfile) {
+                const double start = stats ? stats_now() : 0.0;
+                archive_add(archive, lines[i].outfile, lines[i].memfile, lines[i].memfile_size);
+                free(lines[i].memfile);
+                lines[i].memfile = NULL;
+                if (stats) {
+                    lines[i].write_time = stats_now() - start;
+                }
+            }
+        }
+        if (stats) {
+            stats->lines++;
+            if (lines[i].too_long || lines[i].invalid || lines[i].write_failed
+                    || lines[i].error_number >= ZINT_ERROR) {
+                stats->errors++;
+            }
+            if (!lines[i].too_long && !lines[i].invalid && lines[i].timed) {
+                stats_add(stats, STATS_ENCODE, lines[i].encode_time);
+                if (lines[i].rendered) {
+                    stats_add(stats, STATS_RENDER, lines[i].render_time);
+                    stats_add(stats, STATS_WRITE, lines[i].write_time);
+                    stats->bytes += lines[i].bytes;
+                }
+            }
+        }
+    }
+
+    return error_number;
+}
+
+/* Batch mode - output symbol for each line of text in `filename`, or if `archive_name` given, add each symbol to a
+   tar or zip archive. If `records_mode`, each line is a record of tab-separated NAME=VALUE fields overriding
+   settings, followed by a tab and the data. If `dedupe`, repeated lines are loaded from a cache of encoded and
+   output symbols instead of being encoded and output again. If `stats_mode`, timing statistics are printed to
+   stderr at the end, and if `stats_filename` given also written to it as JSON. If `watch_caches` given (watch
+   mode), output files are written atomically, and the workers' caches are taken from and returned to it rather
+   than being deleted, so that they're kept from one input file to the next */
+static int batch_process(struct zint_symbol *symbol, const char *filename, const int mirror_mode,
+            const char *filetype, const int rotate_angle, int threads, const char *archive_name,
+            const int records_mode, int dedupe, const int no_png, const int stats_mode,
+            const char *stats_filename, struct dedupe_cache *watch_caches[]) {
+    FILE *file;
+    struct batch_archive archive, *p_archive = NULL;
+    struct batch_stats stats, *p_stats = NULL;
+    struct batch_queue *p_queue = NULL;
+#ifdef ZINT_THREADS
+    struct batch_queue queue;
+    batch_thread_t writer_thread;
+#endif
+    unsigned char *buffer;
+    int buf_len = 0, buf_posn, scan_posn = 0, error_number = 0, line_count = 1;
+    int skipping = 0; /* Set if discarding the rest of an over-long line */
+    int newline_last = 0;
+    char format_string[256];
+    struct batch_line *lines;
+    struct batch_worker *workers;
+    struct batch_line **worker_lines;
+    struct zint_batch_item *worker_items;
+    int chunk_max, count = 0;
+    int i;
+
+    if (stats_mode) {
+        memset(&stats, 0, sizeof(stats));
+        stats.start = stats_now();
+        p_stats = &stats;
+    }
+
+    if (symbol->outfile[0] == '\0') {
+        strcpy(format_string, "~~~~~.");
+        strncat(format_string, filetype, 3);
+    } else {
+        strcpy(format_string, symbol->outfile);
+        set_extension(format_string, filetype);
+    }
+
+#ifdef ZINT_THREADS
+    if (threads == 0) {
+        threads = batch_cpu_count();
+    }
+    if (threads > BATCH_MAX_THREADS) {
+        threads = BATCH_MAX_THREADS;
+    }
+    if (symbol->output_options & BARCODE_STDOUT) {
+        threads = 1; /* Keep output to stdout in order */
+    }
+#else
+    threads = 1;
+#endif
+    if (threads < 1) {
+        threads = 1;
+    }
+    chunk_max = threads * BATCH_CHUNK_PER_THREAD;
+    if (dedupe && !mirror_mode) {
+        dedupe = 2; /* Output filenames unique so can share out lines by data */
+    }
+
+    buffer = (unsigned char *) malloc(BATCH_READ_SIZE);
+    lines = (struct batch_line *) calloc(chunk_max, sizeof(struct batch_line));
+    workers = (struct batch_worker *) calloc(threads, sizeof(struct batch_worker));
+    worker_lines = (struct batch_line **) malloc(sizeof(struct batch_line *) * chunk_max);
+    worker_items = (struct zint_batch_item *) malloc(sizeof(struct zint_batch_item) * chunk_max);
+    if (!buffer || !lines || !workers || !worker_lines || !worker_items) {
+        free(buffer);
+        free(lines);
+        free(workers);
+        free(worker_lines);
+        free(worker_items);
+        strcpy(symbol->errtxt, "Error 157: Memory failure");
+        return ZINT_ERROR_MEMORY;
+    }
+    if (watch_caches) {
+        for (i = 0; i < threads; i++) {
+            workers[i].cache = watch_caches[i];
+            workers[i].atomic = 1;
+        }
+    }
+
+    if (!strcmp(filename, "-")) {
+        file = stdin;
+    } else {
+        file = fopen(filename, "rb");
+        if (!file) {
+            free(buffer);
+            free(lines);
+            free(workers);
+            free(worker_lines);
+            free(worker_items);
+            strcpy(symbol->errtxt, "102: Unable to read input file");
+            return ZINT_ERROR_INVALID_DATA;
+        }
+    }
+
+    if (archive_name) {
+        if (!archive_open(&archive, archive_name)) {
+            fclose(file);
+            free(buffer);
+            free(lines);
+            free(workers);
+            free(worker_lines);
+            free(worker_items);
+            strcpy(symbol->errtxt, "Error 159: Unable to open archive file for writing");
+            return ZINT_ERROR_FILE_ACCESS;
+        }
+        p_archive = &archive;
+    }
+
+#ifdef ZINT_THREADS
+    /* Pipeline writing of output files (not needed if archiving, which is done in order by the main thread) */
+    if (!p_archive && !(symbol->output_options & BARCODE_STDOUT)) {
+        batch_queue_init(&queue, p_stats != NULL, watch_caches != NULL);
+        if (batch_thread_start(&writer_thread, NULL, &queue)) {
+            p_queue = &queue;
+        } else {
+            batch_queue_destroy(&queue); /* Not fatal, just write directly */
+        }
+    }
+#endif
+
+    /* Read input in large blocks, splitting it into lines in place (each line being NUL-terminated where its
+       newline was), with any incomplete last line moved to the start of the buffer before reading more */
+    buf_posn = 0;
+    while (line_count < 2000000000 && !(p_archive && p_archive->error)) {
+        unsigned char *newline;
+        const double read_start = p_stats ? stats_now() : 0.0;
+        size_t read_len = fread(buffer + buf_len, 1, BATCH_READ_SIZE - buf_len, file);
+
+        if (p_stats) {
+            stats_add(p_stats, STATS_READ, stats_now() - read_start);
+        }
+        if (read_len == 0) {
+            break;
+        }
+        newline_last = buffer[buf_len + read_len - 1] == '\n';
+        buf_len += (int) read_len;
+
+        while (line_count < 2000000000
+                && (newline = (unsigned char *) memchr(buffer + scan_posn, '\n', buf_len - scan_posn)) != NULL) {
+            int length = (int) (newline - (buffer + buf_posn));
+            struct batch_line *line = &lines[count];
+
+            scan_posn = (int) (newline - buffer) + 1;
+            if (skipping) {
+                skipping = 0;
+                buf_posn = scan_posn;
+                continue; /* Already reported */
+            }
+            line->line_count = line_count++;
+            line->too_long = length >= ZINT_MAX_DATA_LEN;
+            line->timed = 0;
+            line->write_failed = 0;
+            if (!line->too_long) {
+                if (length > 0 && buffer[buf_posn + length - 1] == '\r') {
+                    /* CR+LF - assume Windows formatting and remove CR */
+                    length--;
+                }
+                buffer[buf_posn + length] = '\0';
+                line->data = buffer + buf_posn;
+                line->length = length;
+                line->invalid = records_mode && !batch_line_record(line, no_png);
+                if (!line->invalid) {
+                    if (records_mode && line->record.filetype[0]) {
+                        char record_format[256];
+                        strcpy(record_format, format_string);
+                        set_extension(record_format, line->record.filetype);
+                        batch_outfile(symbol, record_format, mirror_mode, line->record.filetype, line->data,
+                            line->length, line->line_count, line->outfile);
+                    } else {
+                        batch_outfile(symbol, format_string, mirror_mode, filetype, line->data, line->length,
+                            line->line_count, line->outfile);
+                    }
+                }
+            }
+            buf_posn = scan_posn;
+            if (++count == chunk_max) {
+                error_number = batch_chunk(symbol, lines, count, workers, threads, worker_lines, worker_items,
+                                p_archive, p_queue, rotate_angle, records_mode, dedupe, p_stats, error_number);
+                count = 0;
+            }
+        }
+
+        /* Lines point into the buffer so must be done before it's reused */
+        if (count) {
+            error_number = batch_chunk(symbol, lines, count, workers, threads, worker_lines, worker_items,
+                                p_archive, p_queue, rotate_angle, records_mode, dedupe, p_stats, error_number);
+            count = 0;
+        }
+        if (skipping || buf_len - buf_posn >= ZINT_MAX_DATA_LEN) {
+            if (!skipping) {
+                /* Over-long line, report now and discard the rest of it */
+                lines[0].line_count = line_count++;
+                lines[0].too_long = 1;
+                lines[0].timed = 0;
+                lines[0].write_failed = 0;
+                error_number = batch_chunk(symbol, lines, 1, workers, threads, worker_lines, worker_items,
+                                p_archive, p_queue, rotate_angle, records_mode, dedupe, p_stats, error_number);
+                skipping = 1;
+            }
+            buf_posn = buf_len;
+        }
+        buf_len -= buf_posn;
+        memmove(buffer, buffer + buf_posn, buf_len);
+        buf_posn = 0;
+        scan_posn = buf_len;
+    }
+
+    if (!newline_last) {
+        fprintf(stderr, "Warning 104: No newline at end of file\n");
+        fflush(stderr);
+    }
+
+    fclose(file);
+#ifdef ZINT_THREADS
+    if (p_queue) {
+        batch_queue_finish(p_queue);
+        batch_thread_join(writer_thread);
+        batch_queue_destroy(p_queue);
+    }
+#endif
+    for (i = 0; i < threads; i++) {
+        if (watch_caches) {
+            watch_caches[i] = workers[i].cache;
+        } else {
+            dedupe_delete(workers[i].cache);
+        }
+    }
+    if (p_archive && !archive_close(p_archive)) {
+        strcpy(symbol->errtxt, "Error 160: Failed to write archive file");
+        error_number = ZINT_ERROR_FILE_WRITE;
+    }
+    if (p_stats && !stats_report(p_stats, threads, stats_filename)) {
+        strcpy(symbol->errtxt, "Error 171: Could not write stats file");
+        error_number = ZINT_ERROR_FILE_ACCESS;
+    }
+    free(buffer);
+    free(lines);
+    free(workers);
+    free(worker_lines);
+    free(worker_items);
+    return error_number;
+}
+
+/* Write a serve mode response to stdout - a header line giving the error number, the length of the error/warning
+   text and the length of the image, followed by the text (if any) and then the image (if any) */
+static void serve_response(const int error_number, const char *errtxt, const unsigned char *image,
+            const int image_size) {
+    const int errtxt_len = (int) strlen(errtxt);
+
+    printf("%d %d %d\n", error_number, errtxt_len, image_size);
+    fwrite(errtxt, 1, errtxt_len, stdout);
+    if (image_size) {
+        fwrite(image, 1, image_size, stdout);
+    }
+    fflush(stdout);
+}
+
+/* Serve mode - encode each request read from stdin with the settings of `symbol`, writing a response for each to
+   stdout, until end of input. A request is either a line of data, or "#" followed by a decimal byte count, a
+   newline and then that many bytes of data (which may include newlines). The same symbol is used throughout so
+   that its raster working buffers are kept between requests. If `dedupe`, repeated requests are loaded from a
+   cache */
+static int serve_process(struct zint_symbol *symbol, const char *filetype, const int rotate_angle,
+            const int dedupe) {
+    struct zint_symbol *work;
+    struct dedupe_cache *cache = NULL;
+    unsigned char *buffer;
+    int c;
+
+    if (!(work = ZBarcode_Create())) {
+        strcpy(symbol->errtxt, "Error 157: Memory failure");
+        return ZINT_ERROR_MEMORY;
+    }
+    if (!(buffer = (unsigned char *) malloc(ZINT_MAX_DATA_LEN + 1))) {
+        ZBarcode_Delete(work);
+        strcpy(symbol->errtxt, "Error 157: Memory failure");
+        return ZINT_ERROR_MEMORY;
+    }
+    if (dedupe) {
+        cache = dedupe_create(BATCH_DEDUPE_ENTRIES); /* Not fatal if fails */
+    }
+#ifdef ZINT_WIN
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    symbol->output_options = (symbol->output_options & ~BARCODE_STDOUT) | BARCODE_MEMORY_FILE;
+    strcpy(symbol->outfile, "out.");
+    strcat(symbol->outfile, filetype);
+
+    while ((c = getc(stdin)) != EOF) {
+        const unsigned char *image;
+        int image_size;
+        int length = 0;
+        int too_long = 0;
+        int error_number;
+
+        if (c == '#') {
+            /* Length-prefixed data */
+            long count = 0;
+            int digits = 0;
+            while ((c = getc(stdin)) >= '0' && c <= '9') {
+                if (count <= ZINT_MAX_DATA_LEN) {
+                    count = count * 10 + c - '0';
+                }
+                digits++;
+            }
+            if (c == '\r') {
+                c = getc(stdin);
+            }
+            if (!digits || c != '\n') {
+                while (c != '\n' && c != EOF) { /* Discard rest of line */
+                    c = getc(stdin);
+                }
+                serve_response(ZINT_ERROR_INVALID_DATA, "Error 164: Invalid request length", NULL, 0);
+                continue;
+            }
+            if (count > ZINT_MAX_DATA_LEN) {
+                while (count-- > 0 && getc(stdin) != EOF);
+                too_long = 1;
+            } else {
+                length = (int) fread(buffer, 1, count, stdin);
+                if (length != count) {
+                    break; /* Truncated input */
+                }
+            }
+        } else {
+            /* Line of data */
+            while (c != '\n' && c != EOF) {
+                if (length < ZINT_MAX_DATA_LEN) {
+                    buffer[length++] = (unsigned char) c;
+                } else {
+                    too_long = 1;
+                }
+                c = getc(stdin);
+            }
+            if (length > 0 && buffer[length - 1] == '\r') {
+                /* CR+LF - assume Windows formatting and remove CR */
+                length--;
+            }
         }
-    }
-    if (j == 0) {
-        return 0;
-    }
-    n[j] = '\0';
+        if (too_long) {
+            serve_response(ZINT_ERROR_TOO_LONG, "Error 165: Request data too long", NULL, 0);
+            continue;
+        }
+        buffer[length] = '\0';
 
-    while (s <= e) {
-        int m = (s + e) / 2;
-        int cmp = strcmp(names[m].n, n);
-        if (cmp == 0) {
-            return names[m].symbology;
+        /* Reset to the original settings, as encoding may adjust them */
+        symbol_reset(work, symbol);
+
+        error_number = dedupe_encode(cache, work, buffer, length);
+        if (error_number < ZINT_ERROR) {
+            const int print_number = dedupe_print(cache, work, rotate_angle, &image, &image_size);
+            if (print_number != 0) {
+                error_number = print_number;
+            }
         }
-        if (cmp < 0) {
-            s = m + 1;
+        if (error_number < ZINT_ERROR) {
+            serve_response(error_number, work->errtxt, image, image_size);
         } else {
-            e = m - 1;
+            serve_response(error_number, work->errtxt, NULL, 0);
         }
     }
 
+    free(buffer);
+    dedupe_delete(cache);
+    ZBarcode_Delete(work);
     return 0;
 }
 
-/* Whether `filetype` supported by Zint. Sets `png_refused` if `no_png` and PNG requested */
-static int supported_filetype(const char *filetype, const int no_png, int *png_refused) {
-    static const char *filetypes[] = {
-        "bmp", "emf", "eps", "gif", "pcx", "png", "svg", "tif", "txt",
-    };
-    char lc_filetype[4] = {0};
-    int i;
+/* Watch mode - input files appearing in a directory are each batch processed in turn by the same process */
 
-    if (png_refused) {
-        *png_refused = 0;
-    }
-    strncpy(lc_filetype, filetype, 3);
-    to_lower(lc_filetype);
+#define WATCH_MAX_FILES     256 /* Maximum files tracked while waiting to be processed */
+#define WATCH_POLL_MS       1000 /* Interval between scans of the directory */
 
-    if (no_png && strcmp(lc_filetype, "png") == 0) {
-        if (png_refused) {
-            *png_refused = 1;
-        }
-        return 0;
-    }
+#ifdef ZINT_WIN
+#define WATCH_SEP   "\\"
+#else
+#define WATCH_SEP   "/"
+#endif
 
-    for (i = 0; i < (int) ARRAY_SIZE(filetypes); i++) {
-        if (strcmp(lc_filetype, filetypes[i]) == 0) {
+/* File found in the watched directory */
+struct watch_file {
+    char name[256];
+    uint64_t size;
+    uint64_t mtime;
+    int closed; /* Set if known to have been closed after writing (inotify) */
+    int seen; /* Set if found by the latest scan */
+    int ready; /* Set if complete, i.e. `closed` or unchanged since the previous scan */
+    int done; /* Set if processed but couldn't be renamed, so to be left alone */
+};
+
+/* Files being tracked, in order of discovery */
+struct watch_state {
+    struct watch_file files[WATCH_MAX_FILES];
+    int count;
+};
+
+static volatile sig_atomic_t watch_stop = 0; /* Set on SIGINT or SIGTERM */
+
+static void watch_signal(int sig) {
+    (void) sig;
+    watch_stop = 1;
+}
+
+/* Whether file `name` in the watched directory is to be left alone - hidden files, outputs being written
+   atomically, inputs already processed, and names too long to be renamed once processed */
+static int watch_ignore(const char *name) {
+    static const char *const suffixes[] = { ".part", ".done", ".err" };
+    const int len = (int) strlen(name);
+    int i;
+
+    if (name[0] == '.' || len > 250) {
+        return 1;
+    }
+    for (i = 0; i < (int) ARRAY_SIZE(suffixes); i++) {
+        const int suffix_len = (int) strlen(suffixes[i]);
+        if (len > suffix_len && strcmp(name + len - suffix_len, suffixes[i]) == 0) {
             return 1;
         }
     }
     return 0;
 }
 
-/* Get file extension, excluding those of 4 or more letters */
-static char *get_extension(const char *file) {
-    char *dot;
+/* Find tracked file `name`, adding it if new and there's room (setting `*p_added`). Returns NULL if not found and
+   no room */
+static struct watch_file *watch_find(struct watch_state *state, const char *name, int *p_added) {
+    struct watch_file *file;
+    int i;
 
-    dot = strrchr(file, '.');
-    if (dot && strlen(file) - (dot - file) <= 4) { /* Only recognize up to 3 letter extensions */
-        return dot + 1;
+    *p_added = 0;
+    for (i = 0; i < state->count; i++) {
+        if (strcmp(state->files[i].name, name) == 0) {
+            return &state->files[i];
+        }
     }
-    return NULL;
+    if (state->count == WATCH_MAX_FILES) {
+        return NULL; /* Will be picked up by a later scan once there's room */
+    }
+    file = &state->files[state->count++];
+    memset(file, 0, sizeof(*file));
+    strcpy(file->name, name);
+    *p_added = 1;
+    return file;
 }
 
-/* Set extension of `file` to `filetype`, replacing existing extension if any.
- * Does nothing if file already has `filetype` extension */
-static void set_extension(char *file, const char *filetype) {
-    char lc_filetype[4] = {0};
-    char *extension;
-    char lc_extension[4];
+/* Update tracked file `name` found by a scan to have `size` and modification time `mtime`, marking it ready if
+   it's known to have been closed or if it's unchanged since the previous scan */
+static void watch_update(struct watch_state *state, const char *name, const uint64_t size, const uint64_t mtime) {
+    struct watch_file *file;
+    int added;
 
-    strncpy(lc_filetype, filetype, 3);
-    to_lower(lc_filetype);
+    if (watch_ignore(name) || !(file = watch_find(state, name, &added))) {
+        return;
+    }
+    file->seen = 1;
+    file->ready = file->closed || (!added && file->size == size && file->mtime == mtime);
+    file->size = size;
+    file->mtime = mtime;
+}
 
-    extension = get_extension(file);
-    if (extension) {
-        strcpy(lc_extension, extension);
-        to_lower(lc_extension);
-        if (strcmp(lc_filetype, lc_extension) == 0) {
-            return;
+/* Stop tracking files not `seen` */
+static void watch_forget(struct watch_state *state) {
+    int i, j;
+
+    for (i = 0, j = 0; i < state->count; i++) {
+        if (state->files[i].seen) {
+            if (i != j) {
+                state->files[j] = state->files[i];
+            }
+            j++;
         }
-        *(extension - 1) = '\0'; /* Cut off at dot */
-    }
-    if (strlen(file) > 251) {
-        file[251] = '\0';
     }
-    strcat(file, ".");
-    strncat(file, filetype, 3);
+    state->count = j;
 }
 
-/* Whether `filetype` is raster type */
-static int is_raster(const char *filetype, const int no_png) {
-    static const char *raster_filetypes[] = {
-        "bmp", "gif", "pcx", "png", "tif",
-    };
+/* Scan directory `dirname`, updating the tracked files. Returns 0 if the directory can't be read */
+static int watch_scan(struct watch_state *state, const char *dirname) {
+    char path[512 + 256 + 2];
     int i;
-    char lc_filetype[4] = {0};
+#ifdef ZINT_WIN
+    WIN32_FIND_DATAA data;
+    HANDLE find;
+#else
+    DIR *dir;
+    struct dirent *entry;
+    struct stat st;
+#endif
 
-    if (filetype == NULL) {
-        return 0;
+    for (i = 0; i < state->count; i++) {
+        state->files[i].seen = 0;
     }
-    strcpy(lc_filetype, filetype);
-    to_lower(lc_filetype);
-
-    if (no_png && strcmp(lc_filetype, "png") == 0) {
+#ifdef ZINT_WIN
+    sprintf(path, "%.512s" WATCH_SEP "*", dirname);
+    if ((find = FindFirstFileA(path, &data)) == INVALID_HANDLE_VALUE) {
+        return GetLastError() == ERROR_FILE_NOT_FOUND; /* Empty */
+    }
+    do {
+        if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+            watch_update(state, data.cFileName, ((uint64_t) data.nFileSizeHigh << 32) | data.nFileSizeLow,
+                ((uint64_t) data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime);
+        }
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+#else
+    if (!(dir = opendir(dirname))) {
         return 0;
     }
-
-    for (i = 0; i < (int) ARRAY_SIZE(raster_filetypes); i++) {
-        if (strcmp(lc_filetype, raster_filetypes[i]) == 0) {
-            return 1;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!watch_ignore(entry->d_name)) {
+            sprintf(path, "%.512s" WATCH_SEP "%s", dirname, entry->d_name);
+            if (stat(path, &st) == 0 && S_ISREG(st.st_mode)) {
+                watch_update(state, entry->d_name, (uint64_t) st.st_size, (uint64_t) st.st_mtime);
+            }
         }
     }
-    return 0;
-}
+    closedir(dir);
+#endif
 
-/* Batch mode - output symbol for each line of text in `filename` */
-static int batch_process(struct zint_symbol *symbol, const char *filename, const int mirror_mode,
-            const char *filetype, const int rotate_angle) {
-    FILE *file;
-    unsigned char buffer[ZINT_MAX_DATA_LEN] = {0}; // Maximum HanXin input
-    unsigned char character = 0;
-    int buf_posn = 0, error_number = 0, line_count = 1;
-    char output_file[256];
-    char number[12], reverse_number[12];
-    int inpos, local_line_count;
-    char format_string[256], reversed_string[256], format_char;
-    int format_len, i, o;
-    char adjusted[2] = {0};
+    watch_forget(state);
+    return 1;
+}
 
-    if (symbol->outfile[0] == '\0') {
-        strcpy(format_string, "~~~~~.");
-        strncat(format_string, filetype, 3);
-    } else {
-        strcpy(format_string, symbol->outfile);
-        set_extension(format_string, filetype);
+/* Form the batch output filename format for input file `name` from `format_string` (the -o option), prefixing its
+   filename part with the stem of `name` and a hyphen so that the outputs of different input files don't clash */
+static void watch_outfile(const char *format_string, const char *name, char outfile[256]) {
+    const char *base = strrchr(format_string, '/');
+    const char *extension = strrchr(name, '.');
+    int dir_len, stem_len;
+#ifdef ZINT_WIN
+    const char *bslash = strrchr(format_string, '\\');
+    if (bslash && (!base || bslash > base)) {
+        base = bslash;
     }
+#endif
 
-    if (!strcmp(filename, "-")) {
-        file = stdin;
-    } else {
-        file = fopen(filename, "rb");
-        if (!file) {
-            strcpy(symbol->errtxt, "102: Unable to read input file");
-            return ZINT_ERROR_INVALID_DATA;
+    base = base ? base + 1 : format_string;
+    dir_len = (int) (base - format_string);
+    stem_len = extension ? (int) (extension - name) : (int) strlen(name);
+    if (dir_len + stem_len + 1 + (int) strlen(base) > 255) {
+        stem_len = 255 - dir_len - 1 - (int) strlen(base);
+        if (stem_len < 0) {
+            stem_len = 0;
         }
     }
+    memcpy(outfile, format_string, dir_len);
+    memcpy(outfile + dir_len, name, stem_len);
+    outfile[dir_len + stem_len] = '-';
+    strncpy(outfile + dir_len + stem_len + 1, base, 255 - dir_len - stem_len - 1);
+    outfile[255] = '\0';
+}
 
-    do {
-        int intChar;
-        intChar = fgetc(file);
-        if (intChar == EOF) {
-            break;
-        }
-        character = (unsigned char) intChar;
-        if (character == '\n') {
-            if (buf_posn > 0 && buffer[buf_posn - 1] == '\r') {
-                /* CR+LF - assume Windows formatting and remove CR */
-                buf_posn--;
-                buffer[buf_posn] = '\0';
-            }
-
-            if (mirror_mode == 0) {
-                inpos = 0;
-                local_line_count = line_count;
-                memset(number, 0, sizeof(number));
-                memset(reverse_number, 0, sizeof(reverse_number));
-                memset(reversed_string, 0, sizeof(reversed_string));
-                memset(output_file, 0, sizeof(output_file));
-                do {
-                    number[inpos] = itoc(local_line_count % 10);
-                    local_line_count /= 10;
-                    inpos++;
-                } while (local_line_count > 0);
-                number[inpos] = '\0';
-
-                for (i = 0; i < inpos; i++) {
-                    reverse_number[i] = number[inpos - i - 1];
-                }
-
-                format_len = (int) strlen(format_string);
-                for (i = format_len; i > 0; i--) {
-                    format_char = format_string[i - 1];
-
-                    switch (format_char) {
-                        case '#':
-                            if (inpos > 0) {
-                                adjusted[0] = reverse_number[inpos - 1];
-                                inpos--;
-                            } else {
-                                adjusted[0] = ' ';
-                            }
-                            break;
-                        case '~':
-                            if (inpos > 0) {
-                                adjusted[0] = reverse_number[inpos - 1];
-                                inpos--;
-                            } else {
-                                adjusted[0] = '0';
-                            }
-                            break;
-                        case '@':
-                            if (inpos > 0) {
-                                adjusted[0] = reverse_number[inpos - 1];
-                                inpos--;
-                            } else {
-                                adjusted[0] = '*';
-                            }
-                            break;
-                        default:
-                            adjusted[0] = format_string[i - 1];
-                            break;
-                    }
-                    strcat(reversed_string, adjusted);
-                }
+/* Watch mode - wait for input files to appear in directory `dirname`, processing each as `batch_process()` does
+   once it's complete (i.e. closed after writing, where known, or unchanged for a scan interval), until
+   interrupted. Files already there on starting are processed too. Outputs are written atomically, with the stem of
+   the input's name prefixed to the -o filename format, and the input is then renamed with ".done" appended, or
+   ".err" if it failed. Caches (`dedupe`) are kept from one input file to the next */
+static int watch_process(struct zint_symbol *symbol, const char *dirname, const int mirror_mode,
+            const char *filetype, const int rotate_angle, const int threads, const int records_mode,
+            const int dedupe, const int no_png, const int stats_mode, const char *stats_filename) {
+    struct watch_state *state;
+    struct dedupe_cache *caches[BATCH_MAX_THREADS] = {0};
+    char format_string[256];
+    char path[512 + 256 + 2], done_path[512 + 256 + 2 + 5];
+    int error_number = 0;
+    int i;
+#ifdef ZINT_HAVE_INOTIFY
+    int fd;
+    union {
+        struct inotify_event event; /* For alignment */
+        char buf[4096];
+    } events;
+#elif defined(ZINT_WIN)
+    HANDLE notify;
+#endif
 
-                for (i = 0; i < format_len; i++) {
-                    output_file[i] = reversed_string[format_len - i - 1];
-                }
-            } else {
-                /* Name the output file from the data being processed */
-                i = 0;
-                o = 0;
-                do {
-                    if (buffer[i] < 0x20) {
-                        output_file[o] = '_';
-                    } else {
-                        switch (buffer[i]) {
-                            case 0x21: // !
-                            case 0x22: // "
-                            case 0x2a: // *
-                            case 0x2f: // /
-                            case 0x3a: // :
-                            case 0x3c: // <
-                            case 0x3e: // >
-                            case 0x3f: // ?
-                            case 0x5c: // Backslash
-                            case 0x7c: // |
-                            case 0x7f: // DEL
-                                output_file[o] = '_';
-                                break;
-                            default:
-                                output_file[o] = buffer[i];
-                                break;
-                        }
-                    }
+    if (strlen(dirname) > 512) {
+        strcpy(symbol->errtxt, "Error 173: Watch directory name too long");
+        return ZINT_ERROR_INVALID_OPTION;
+    }
+    if (!(state = (struct watch_state *) calloc(1, sizeof(struct watch_state)))) {
+        strcpy(symbol->errtxt, "Error 157: Memory failure");
+        return ZINT_ERROR_MEMORY;
+    }
+    if (!watch_scan(state, dirname)) {
+        free(state);
+        strcpy(symbol->errtxt, "Error 174: Unable to read watch directory");
+        return ZINT_ERROR_INVALID_DATA;
+    }
+    strcpy(format_string, symbol->outfile);
 
-                    // Skip escape characters
-                    if ((buffer[i] == 0x5c) && (symbol->input_mode & ESCAPE_MODE)) {
-                        i++;
-                        if (buffer[i] == 'x') {
-                            i += 2;
-                        } else if (buffer[i] == 'u') {
-                            i += 4;
+#ifdef ZINT_HAVE_INOTIFY
+    if ((fd = inotify_init()) != -1 && inotify_add_watch(fd, dirname, IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+        close(fd);
+        fd = -1; /* Not fatal, just poll */
+    }
+#elif defined(ZINT_WIN)
+    notify = FindFirstChangeNotificationA(dirname, FALSE,
+                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+#endif
+    watch_stop = 0;
+    signal(SIGINT, watch_signal);
+    signal(SIGTERM, watch_signal);
+
+    while (!watch_stop) {
+        /* Wait for a change in the directory, or for the poll interval if not notified */
+#ifdef ZINT_HAVE_INOTIFY
+        if (fd != -1) {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            if (poll(&pfd, 1, WATCH_POLL_MS) > 0) {
+                const int len = (int) read(fd, events.buf, sizeof(events.buf));
+                int posn = 0;
+                while (posn + (int) sizeof(struct inotify_event) <= len) {
+                    const struct inotify_event *event = (const struct inotify_event *) (events.buf + posn);
+                    if (event->len && !watch_ignore(event->name)) {
+                        int added;
+                        struct watch_file *file = watch_find(state, event->name, &added);
+                        if (file) {
+                            file->closed = 1;
                         }
                     }
-                    i++;
-                    o++;
-                } while (i < buf_posn && o < 251);
-
-                /* Add file extension */
-                output_file[o] = '.';
-                output_file[o + 1] = '\0';
-
-                strncat(output_file, filetype, 3);
+                    posn += (int) sizeof(struct inotify_event) + event->len;
+                }
             }
-
-            strcpy(symbol->outfile, output_file);
-            error_number = ZBarcode_Encode_and_Print(symbol, buffer, buf_posn, rotate_angle);
-            if (error_number != 0) {
-                fprintf(stderr, "On line %d: %s\n", line_count, symbol->errtxt);
-                fflush(stderr);
+        } else {
+            (void) poll(NULL, 0, WATCH_POLL_MS);
+        }
+#elif defined(ZINT_WIN)
+        if (notify != INVALID_HANDLE_VALUE) {
+            if (WaitForSingleObject(notify, WATCH_POLL_MS) == WAIT_OBJECT_0) {
+                FindNextChangeNotification(notify);
             }
-            ZBarcode_Clear(symbol);
-            memset(buffer, 0, sizeof(buffer));
-            buf_posn = 0;
-            line_count++;
         } else {
-            buffer[buf_posn] = character;
-            buf_posn++;
+            Sleep(WATCH_POLL_MS);
         }
-        if (buf_posn >= (int) sizeof(buffer)) {
-            fprintf(stderr, "On line %d: Error 103: Input data too long\n", line_count);
-            fflush(stderr);
-            do {
-                character = fgetc(file);
-            } while ((!feof(file)) && (character != '\n'));
+#else
+        sleep(WATCH_POLL_MS / 1000);
+#endif
+        if (watch_stop) {
+            break;
+        }
+        if (!watch_scan(state, dirname)) {
+            strcpy(symbol->errtxt, "Error 174: Unable to read watch directory");
+            error_number = ZINT_ERROR_INVALID_DATA;
+            break;
         }
-    } while ((!feof(file)) && (line_count < 2000000000));
 
-    if (character != '\n') {
-        fprintf(stderr, "Warning 104: No newline at end of file\n");
-        fflush(stderr);
+        for (i = 0; i < state->count && !watch_stop; i++) {
+            struct watch_file *file = &state->files[i];
+            int ret;
+
+            if (!file->ready || file->done) {
+                continue;
+            }
+            sprintf(path, "%.512s" WATCH_SEP "%s", dirname, file->name);
+            watch_outfile(format_string, file->name, symbol->outfile);
+            symbol->errtxt[0] = '\0';
+            ret = batch_process(symbol, path, mirror_mode, filetype, rotate_angle, threads, NULL, records_mode,
+                    dedupe, no_png, stats_mode, stats_filename, caches);
+            if (ret != 0 && symbol->errtxt[0]) {
+                fprintf(stderr, "%s\n", symbol->errtxt);
+                fflush(stderr);
+            }
+            sprintf(done_path, "%s%s", path, ret >= ZINT_ERROR ? ".err" : ".done");
+            if (file_replace(path, done_path)) {
+                file->seen = 0; /* Forget it */
+            } else {
+                fprintf(stderr, "Warning 175: Could not rename processed input file '%s'\n", file->name);
+                fflush(stderr);
+                file->done = 1;
+            }
+        }
+        watch_forget(state);
     }
 
-    fclose(file);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+#ifdef ZINT_HAVE_INOTIFY
+    if (fd != -1) {
+        close(fd);
+    }
+#elif defined(ZINT_WIN)
+    if (notify != INVALID_HANDLE_VALUE) {
+        FindCloseChangeNotification(notify);
+    }
+#endif
+    strcpy(symbol->outfile, format_string);
+    for (i = 0; i < BATCH_MAX_THREADS; i++) {
+        dedupe_delete(caches[i]);
+    }
+    free(state);
     return error_number;
 }
 
 /* Stuff to convert args on Windows command line to UTF-8 */
-#if defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(_MSC_VER)
-#define ZINT_WIN
-#include <windows.h>
-#include <shellapi.h>
-#ifndef WC_ERR_INVALID_CHARS
-#define WC_ERR_INVALID_CHARS    0x00000080
-#endif
+#ifdef ZINT_WIN
 
 static int win_argc = 0;
 static char **win_argv = NULL;
@@ -756,6 +2860,14 @@ int main(int argc, char **argv) {
     int input_cnt = 0;
     int batch_mode = 0;
     int mirror_mode = 0;
+    int records_mode = 0;
+    int dedupe = 0;
+    int threads = 0;
+    int serve_mode = 0;
+    int stats_mode = 0;
+    char *stats_filename = NULL;
+    char *watch_dir = NULL;
+    char *archive_name = NULL;
     int fullmultibyte = 0;
     int mask = 0;
     int separator = 0;
@@ -793,17 +2905,18 @@ int main(int argc, char **argv) {
 
     while (1) {
         enum options {
-            OPT_ADDONGAP = 128, OPT_BATCH, OPT_BINARY, OPT_BG, OPT_BIND, OPT_BOLD, OPT_BORDER,
-            OPT_BOX, OPT_CMYK, OPT_COLS, OPT_DIRECT, OPT_DMRE, OPT_DOTSIZE, OPT_DOTTY, OPT_DUMP,
+            OPT_ADDONGAP = 128, OPT_ARCHIVE, OPT_BATCH, OPT_BINARY, OPT_BG, OPT_BIND, OPT_BOLD, OPT_BORDER,
+            OPT_BOX, OPT_CMYK, OPT_COLS, OPT_DEDUPE, OPT_DIRECT, OPT_DMRE, OPT_DOTSIZE, OPT_DOTTY, OPT_DUMP,
             OPT_ECI, OPT_ESC, OPT_FG, OPT_FILETYPE, OPT_FONTSIZE, OPT_FULLMULTIBYTE,
             OPT_GS1, OPT_GS1PARENS, OPT_GSSEP, OPT_HEIGHT, OPT_INIT, OPT_MIRROR, OPT_MASK, OPT_MODE,
-            OPT_NOBACKGROUND, OPT_NOTEXT, OPT_PRIMARY, OPT_ROTATE, OPT_ROWS, OPT_SCALE,
-            OPT_SCMVV, OPT_SECURE, OPT_SEPARATOR, OPT_SMALL, OPT_SQUARE, OPT_VERBOSE, OPT_VERS,
-            OPT_VWHITESP, OPT_WERROR, OPT_WZPL,
+            OPT_NOBACKGROUND, OPT_NOTEXT, OPT_PRIMARY, OPT_RECORDS, OPT_ROTATE, OPT_ROWS, OPT_SCALE,
+            OPT_SCMVV, OPT_SECURE, OPT_SEPARATOR, OPT_SERVE, OPT_SMALL, OPT_SQUARE, OPT_STATS,
+            OPT_THREADS, OPT_VERBOSE, OPT_VERS, OPT_VWHITESP, OPT_WATCH, OPT_WERROR, OPT_WZPL,
         };
         int option_index = 0;
         static struct option long_options[] = {
             {"addongap", 1, NULL, OPT_ADDONGAP},
+            {"archive", 1, NULL, OPT_ARCHIVE},
             {"barcode", 1, NULL, 'b'},
             {"batch", 0, NULL, OPT_BATCH},
             {"binary", 0, NULL, OPT_BINARY},
@@ -815,6 +2928,7 @@ int main(int argc, char **argv) {
             {"cmyk", 0, NULL, OPT_CMYK},
             {"cols", 1, NULL, OPT_COLS},
             {"data", 1, NULL, 'd'},
+            {"dedupe", 0, NULL, OPT_DEDUPE},
             {"direct", 0, NULL, OPT_DIRECT},
             {"dmre", 0, NULL, OPT_DMRE},
             {"dotsize", 1, NULL, OPT_DOTSIZE},
@@ -841,6 +2955,7 @@ int main(int argc, char **argv) {
             {"notext", 0, NULL, OPT_NOTEXT},
             {"output", 1, NULL, 'o'},
             {"primary", 1, NULL, OPT_PRIMARY},
+            {"records", 0, NULL, OPT_RECORDS},
             {"reverse", 0, NULL, 'r'},
             {"rotate", 1, NULL, OPT_ROTATE},
             {"rows", 1, NULL, OPT_ROWS},
@@ -848,12 +2963,16 @@ int main(int argc, char **argv) {
             {"scmvv", 1, NULL, OPT_SCMVV},
             {"secure", 1, NULL, OPT_SECURE},
             {"separator", 1, NULL, OPT_SEPARATOR},
+            {"serve", 0, NULL, OPT_SERVE},
             {"small", 0, NULL, OPT_SMALL},
             {"square", 0, NULL, OPT_SQUARE},
+            {"stats", 2, NULL, OPT_STATS},
+            {"threads", 1, NULL, OPT_THREADS},
             {"types", 0, NULL, 't'},
             {"verbose", 0, NULL, OPT_VERBOSE}, // Currently undocumented, output some debug info
             {"vers", 1, NULL, OPT_VERS},
             {"vwhitesp", 1, NULL, OPT_VWHITESP},
+            {"watch", 1, NULL, OPT_WATCH},
             {"werror", 0, NULL, OPT_WERROR},
             {"whitesp", 1, NULL, 'w'},
             {"wzpl", 0, NULL, OPT_WZPL},
@@ -875,6 +2994,22 @@ int main(int argc, char **argv) {
                     fflush(stderr);
                 }
                 break;
+            case OPT_ARCHIVE:
+                if (strcmp(optarg, "-") != 0) {
+                    char *extension = get_extension(optarg);
+                    char lc_extension[4] = {0};
+                    if (extension && strlen(extension) == 3) {
+                        strcpy(lc_extension, extension);
+                        to_lower(lc_extension);
+                    }
+                    if (strcmp(lc_extension, "tar") != 0 && strcmp(lc_extension, "zip") != 0) {
+                        fprintf(stderr, "Error 158: Archive file '%s' must have extension \"tar\" or \"zip\"\n",
+                                optarg);
+                        return do_exit(1);
+                    }
+                }
+                archive_name = optarg;
+                break;
             case OPT_BATCH:
                 if (data_cnt == 0) {
                     /* Switch to batch processing mode */
@@ -926,6 +3061,9 @@ int main(int argc, char **argv) {
                     fflush(stderr);
                 }
                 break;
+            case OPT_DEDUPE:
+                dedupe = 1;
+                break;
             case OPT_DIRECT:
                 my_symbol->output_options |= BARCODE_STDOUT;
                 break;
@@ -1064,6 +3202,9 @@ int main(int argc, char **argv) {
                     fflush(stderr);
                 }
                 break;
+            case OPT_RECORDS:
+                records_mode = 1;
+                break;
             case OPT_ROTATE:
                 /* Only certain inputs allowed */
                 if (!validate_int(optarg, &val)) {
@@ -1144,12 +3285,31 @@ int main(int argc, char **argv) {
                     fflush(stderr);
                 }
                 break;
+            case OPT_SERVE:
+                serve_mode = 1;
+                break;
             case OPT_SMALL:
                 my_symbol->output_options |= SMALL_TEXT;
                 break;
             case OPT_SQUARE:
                 my_symbol->option_3 = DM_SQUARE;
                 break;
+            case OPT_STATS:
+                stats_mode = 1;
+                stats_filename = optarg;
+                break;
+            case OPT_THREADS:
+                if (!validate_int(optarg, &val)) {
+                    fprintf(stderr, "Error 155: Invalid threads value\n");
+                    return do_exit(1);
+                }
+                if (val <= 256) { /* `val` >= 0 always */
+                    threads = val;
+                } else {
+                    fprintf(stderr, "Warning 156: Number of threads out of range\n");
+                    fflush(stderr);
+                }
+                break;
             case OPT_VERBOSE:
                 my_symbol->debug = 1;
                 break;
@@ -1180,6 +3340,9 @@ int main(int argc, char **argv) {
             case OPT_WERROR:
                 my_symbol->warn_level = WARN_FAIL_ALL;
                 break;
+            case OPT_WATCH:
+                watch_dir = optarg;
+                break;
             case OPT_WZPL:
                 my_symbol->warn_level = WARN_ZPL_COMPAT;
                 break;
@@ -1272,7 +3435,7 @@ int main(int argc, char **argv) {
         fflush(stderr);
     }
 
-    if (data_arg_num) {
+    if (data_arg_num || serve_mode || watch_dir) {
         unsigned int cap = ZBarcode_Cap(my_symbol->symbology, ZINT_CAP_STACKABLE | ZINT_CAP_EXTENDABLE |
                             ZINT_CAP_FULL_MULTIBYTE | ZINT_CAP_MASK);
         if (fullmultibyte && (cap & ZINT_CAP_FULL_MULTIBYTE)) {
@@ -1288,9 +3451,35 @@ int main(int argc, char **argv) {
             my_symbol->option_2 = addon_gap;
         }
 
-        if (batch_mode) {
+        if (serve_mode) {
+            /* Take each request on stdin as a separate data set */
+            if (data_arg_num) {
+                fprintf(stderr, "Warning 163: Input data ignored in serve mode\n");
+                fflush(stderr);
+            }
+            if (stats_mode) {
+                fprintf(stderr, "Warning 172: Stats only used in batch mode, ignoring\n");
+                fflush(stderr);
+            }
+            if (filetype[0] == '\0') {
+                outfile_extension = get_extension(my_symbol->outfile);
+                if (outfile_extension && supported_filetype(outfile_extension, no_png, NULL)) {
+                    strcpy(filetype, outfile_extension);
+                } else {
+                    strcpy(filetype, no_png ? "gif" : "png");
+                }
+            }
+            error_number = serve_process(my_symbol, filetype, rotate_angle, dedupe);
+            if (error_number != 0) {
+                fprintf(stderr, "%s\n", my_symbol->errtxt);
+                fflush(stderr);
+            }
+        } else if (batch_mode || watch_dir) {
             /* Take each line of text as a separate data set */
-            if (data_arg_num > 1) {
+            if (watch_dir && data_arg_num) {
+                fprintf(stderr, "Warning 176: Input data ignored in watch mode\n");
+                fflush(stderr);
+            } else if (data_arg_num > 1) {
                 fprintf(stderr, "Warning 144: Processing first input file '%s' only\n", arg_opts[0].arg);
                 fflush(stderr);
             }
@@ -1309,12 +3498,45 @@ int main(int argc, char **argv) {
                     filetype);
                 fflush(stderr);
             }
-            error_number = batch_process(my_symbol, arg_opts[0].arg, mirror_mode, filetype, rotate_angle);
+            if (archive_name && (my_symbol->output_options & BARCODE_STDOUT)) {
+                fprintf(stderr, "Warning 161: Can't use archive with direct output, ignoring '%s'\n", archive_name);
+                fflush(stderr);
+                archive_name = NULL;
+            }
+            if (watch_dir) {
+                if (archive_name || (my_symbol->output_options & BARCODE_STDOUT)) {
+                    fprintf(stderr, "Warning 177: Can't use archive or direct output in watch mode, ignoring\n");
+                    fflush(stderr);
+                    my_symbol->output_options &= ~BARCODE_STDOUT;
+                }
+                error_number = watch_process(my_symbol, watch_dir, mirror_mode, filetype, rotate_angle, threads,
+                                records_mode, dedupe, no_png, stats_mode, stats_filename);
+            } else {
+                error_number = batch_process(my_symbol, arg_opts[0].arg, mirror_mode, filetype, rotate_angle,
+                                threads, archive_name, records_mode, dedupe, no_png, stats_mode, stats_filename,
+                                NULL);
+            }
             if (error_number != 0) {
                 fprintf(stderr, "%s\n", my_symbol->errtxt);
                 fflush(stderr);
             }
         } else {
+            if (archive_name) {
+                fprintf(stderr, "Warning 162: Archive only used in batch mode, ignoring '%s'\n", archive_name);
+                fflush(stderr);
+            }
+            if (records_mode) {
+                fprintf(stderr, "Warning 168: Records only used in batch mode, ignoring\n");
+                fflush(stderr);
+            }
+            if (dedupe) {
+                fprintf(stderr, "Warning 169: Dedupe only used in batch or serve mode, ignoring\n");
+                fflush(stderr);
+            }
+            if (stats_mode) {
+                fprintf(stderr, "Warning 172: Stats only used in batch mode, ignoring\n");
+                fflush(stderr);
+            }
             if (filetype[0] != '\0') {
                 set_extension(my_symbol->outfile, filetype);
             }
@@ -30,6 +30,8 @@
 /* vim: set ts=4 sw=4 et : */
 
 #include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "testcommon.h"
 
 static char *exec(const char *cmd, char *buf, int buf_size, int debug, int index) {
@@ -524,6 +526,469 @@ static void test_batch_large(int index, int debug) {
     testFinish();
 }
 
+static void test_batch_threads(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        int threads;
+        int mirror;
+        char *outfile;
+        char *input;
+
+        char *expected;
+        int num_expected;
+        char *expected_files;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { -1, 0, NULL, "123\n\377\n456\n", "On line 2: Error 245: Invalid UTF-8", 2, "test_threads1.svg\000test_threads3.svg" },
+        /*  1*/ {  1, 0, NULL, "123\n\377\n456\n", "On line 2: Error 245: Invalid UTF-8", 2, "test_threads1.svg\000test_threads3.svg" },
+        /*  2*/ {  3, 0, NULL, "123\n\377\n456\n\377\n", "On line 2: Error 245: Invalid UTF-8\nOn line 4: Error 245: Invalid UTF-8", 2, "test_threads1.svg\000test_threads3.svg" },
+        /*  3*/ {  0, 1, NULL, "123\n456\n789\n", "", 3, "123.svg\000456.svg\000789.svg" },
+        /*  4*/ {  2, 1, NULL, "123\n456\n789", "Warning 104: No newline at end of file", 2, "123.svg\000456.svg" },
+        /*  5*/ { 257, 0, NULL, "123\n", "Warning 156: Number of threads out of range", 1, "test_threads1.svg" },
+        /*  6*/ { -2, 0, NULL, "123\n", "Error 155: Invalid threads value", 0, NULL },
+        /*  7*/ {  2, 0, "test_threads_nonexistent/test_threads~", "123\n\377\n456\n", "On line 1: Error 170: Could not write output file 'test_threads_nonexistent/test_threads1.svg'\nOn line 2: Error 245: Invalid UTF-8\nOn line 3: Error 170: Could not write output file 'test_threads_nonexistent/test_threads3.svg'", 0, NULL },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+
+    char *input_filename = "test_batch_threads.txt";
+    char *outfile;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+        if ((debug & ZINT_DEBUG_TEST_PRINT) && !(debug & ZINT_DEBUG_TEST_LESS_NOISY)) printf("i:%d\n", i);
+
+        strcpy(cmd, "zint --batch --filetype=svg");
+        if (debug & ZINT_DEBUG_PRINT) {
+            strcat(cmd, " --verbose");
+        }
+
+        arg_int(cmd, "--threads=", data[i].threads);
+        arg_bool(cmd, "--mirror", data[i].mirror);
+        if (!data[i].mirror) {
+            arg_data(cmd, "-o ", data[i].outfile ? data[i].outfile : "test_threads~");
+        }
+        arg_input(cmd, input_filename, data[i].input);
+
+        strcat(cmd, " 2>&1");
+
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_zero(strcmp(buf, data[i].expected), "i:%d buf (%s) != expected (%s)\n", i, buf, data[i].expected);
+
+        outfile = data[i].expected_files;
+        for (int j = 0; j < data[i].num_expected; j++) {
+            assert_nonzero(testUtilExists(outfile), "i:%d j:%d testUtilExists(%s) != 1\n", i, j, outfile);
+            assert_zero(remove(outfile), "i:%d j:%d remove(%s) != 0 (%d)\n", i, j, outfile, errno);
+            outfile += strlen(outfile) + 1;
+        }
+
+        assert_zero(remove(input_filename), "i:%d remove(%s) != 0 (%d)\n", i, input_filename, errno);
+    }
+
+    testFinish();
+}
+
+static void test_batch_archive(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        char *archive;
+        char *input;
+
+        char *expected;
+        int expected_posn;
+        char *expected_magic;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { "test_batch_archive.tar", "123\n456\n", "", 257, "ustar" },
+        /*  1*/ { "test_batch_archive.zip", "123\n456\n", "", 0, "PK\003\004" },
+        /*  2*/ { "test_batch_archive.zip", "123\n\377\n", "On line 2: Error 245: Invalid UTF-8", 0, "PK\003\004" },
+        /*  3*/ { "test_batch_archive.rar", "123\n", "Error 158: Archive file 'test_batch_archive.rar' must have extension \"tar\" or \"zip\"", 0, NULL },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+    char magic[8];
+
+    char *input_filename = "test_batch_archive.txt";
+    FILE *fp;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+        if ((debug & ZINT_DEBUG_TEST_PRINT) && !(debug & ZINT_DEBUG_TEST_LESS_NOISY)) printf("i:%d\n", i);
+
+        strcpy(cmd, "zint --batch --filetype=svg");
+        if (debug & ZINT_DEBUG_PRINT) {
+            strcat(cmd, " --verbose");
+        }
+
+        arg_data(cmd, "--archive=", data[i].archive);
+        arg_input(cmd, input_filename, data[i].input);
+
+        strcat(cmd, " 2>&1");
+
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_zero(strcmp(buf, data[i].expected), "i:%d buf (%s) != expected (%s)\n", i, buf, data[i].expected);
+
+        if (data[i].expected_magic) {
+            fp = fopen(data[i].archive, "rb");
+            assert_nonnull(fp, "i:%d fopen(%s) NULL\n", i, data[i].archive);
+            assert_zero(fseek(fp, data[i].expected_posn, SEEK_SET), "i:%d fseek(%s) != 0\n", i, data[i].archive);
+            memset(magic, 0, sizeof(magic));
+            assert_equal((int) fread(magic, 1, strlen(data[i].expected_magic), fp), (int) strlen(data[i].expected_magic),
+                        "i:%d fread(%s) short\n", i, data[i].archive);
+            fclose(fp);
+            assert_zero(strcmp(magic, data[i].expected_magic), "i:%d magic (%s) != expected (%s)\n", i, magic, data[i].expected_magic);
+            assert_zero(remove(data[i].archive), "i:%d remove(%s) != 0 (%d)\n", i, data[i].archive, errno);
+        } else {
+            assert_zero(testUtilExists(data[i].archive), "i:%d testUtilExists(%s) != 0\n", i, data[i].archive);
+        }
+
+        assert_zero(remove(input_filename), "i:%d remove(%s) != 0 (%d)\n", i, input_filename, errno);
+    }
+
+    testFinish();
+}
+
+static void test_batch_records(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        int records;
+        char *input;
+
+        char *expected;
+        int num_expected;
+        char *expected_files;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { 1, "barcode=71\tvers=12\tABC\n123\nbarcode=qrcode\tsecure=2\tABC\n", "", 3, "test_rec1.svg\000test_rec2.svg\000test_rec3.svg" },
+        /*  1*/ { 1, "filetype=EPS\t123\nscale=2\t456\n", "", 2, "test_rec1.eps\000test_rec2.svg" },
+        /*  2*/ { 1, "foo=1\t123\n456\n", "On line 1: Error 166: Invalid record field 'foo'", 1, "test_rec2.svg" },
+        /*  3*/ { 1, "123\nvers=100\t456\n", "On line 2: Error 167: Invalid value for record field 'vers'", 1, "test_rec1.svg" },
+        /*  4*/ { 1, "barcode=\t456\n", "On line 1: Error 167: Invalid value for record field 'barcode'", 0, NULL },
+        /*  5*/ { 0, "vers=12\t456\n", "", 1, "test_rec1.svg" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+
+    char *input_filename = "test_batch_records.txt";
+    char *outfile;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+        if ((debug & ZINT_DEBUG_TEST_PRINT) && !(debug & ZINT_DEBUG_TEST_LESS_NOISY)) printf("i:%d\n", i);
+
+        strcpy(cmd, "zint --batch --filetype=svg -o test_rec~");
+        if (debug & ZINT_DEBUG_PRINT) {
+            strcat(cmd, " --verbose");
+        }
+
+        arg_bool(cmd, "--records", data[i].records);
+        arg_input(cmd, input_filename, data[i].input);
+
+        strcat(cmd, " 2>&1");
+
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_zero(strcmp(buf, data[i].expected), "i:%d buf (%s) != expected (%s)\n", i, buf, data[i].expected);
+
+        outfile = data[i].expected_files;
+        for (int j = 0; j < data[i].num_expected; j++) {
+            assert_nonzero(testUtilExists(outfile), "i:%d j:%d testUtilExists(%s) != 1\n", i, j, outfile);
+            assert_zero(remove(outfile), "i:%d j:%d remove(%s) != 0 (%d)\n", i, j, outfile, errno);
+            outfile += strlen(outfile) + 1;
+        }
+
+        assert_zero(remove(input_filename), "i:%d remove(%s) != 0 (%d)\n", i, input_filename, errno);
+    }
+
+    testFinish();
+}
+
+static void test_batch_dedupe(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        int threads;
+        int mirror;
+        char *input;
+
+        char *expected;
+        int num_expected;
+        char *expected_files;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { 1, 0, "123\n456\n123\n", "", 3, "test_dedupe1.svg\000test_dedupe2.svg\000test_dedupe3.svg" },
+        /*  1*/ { 3, 0, "123\n\377\n123\n\377\n", "On line 2: Error 245: Invalid UTF-8\nOn line 4: Error 245: Invalid UTF-8", 2, "test_dedupe1.svg\000test_dedupe3.svg" },
+        /*  2*/ { 2, 1, "123\n456\n123\n456\n", "", 2, "123.svg\000456.svg" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+
+    char *input_filename = "test_batch_dedupe.txt";
+    char *outfile;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+        if ((debug & ZINT_DEBUG_TEST_PRINT) && !(debug & ZINT_DEBUG_TEST_LESS_NOISY)) printf("i:%d\n", i);
+
+        strcpy(cmd, "zint --batch --dedupe --filetype=svg");
+        if (debug & ZINT_DEBUG_PRINT) {
+            strcat(cmd, " --verbose");
+        }
+
+        arg_int(cmd, "--threads=", data[i].threads);
+        arg_bool(cmd, "--mirror", data[i].mirror);
+        if (!data[i].mirror) {
+            arg_data(cmd, "-o ", "test_dedupe~");
+        }
+        arg_input(cmd, input_filename, data[i].input);
+
+        strcat(cmd, " 2>&1");
+
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_zero(strcmp(buf, data[i].expected), "i:%d buf (%s) != expected (%s)\n", i, buf, data[i].expected);
+
+        outfile = data[i].expected_files;
+        for (int j = 0; j < data[i].num_expected; j++) {
+            assert_nonzero(testUtilExists(outfile), "i:%d j:%d testUtilExists(%s) != 1\n", i, j, outfile);
+            assert_zero(remove(outfile), "i:%d j:%d remove(%s) != 0 (%d)\n", i, j, outfile, errno);
+            outfile += strlen(outfile) + 1;
+        }
+
+        assert_zero(remove(input_filename), "i:%d remove(%s) != 0 (%d)\n", i, input_filename, errno);
+    }
+
+    testFinish();
+}
+
+static void test_batch_stats(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        int threads;
+        int archive;
+        char *stats;
+        char *input;
+
+        char *expected;
+        int num_expected;
+        char *expected_files;
+        char *expected_json;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { 1, 0, "", "123\n456\n", "Stats: 2 lines (0 errors) in ", 2, "test_stats1.svg\000test_stats2.svg", "" },
+        /*  1*/ { 2, 0, "test_stats.json", "123\n\377\n456\n", "On line 2: Error 245: Invalid UTF-8\nStats: 3 lines (1 errors) in ", 2, "test_stats1.svg\000test_stats3.svg", "\"lines\": 3," },
+        /*  2*/ { 1, 1, "test_stats.json", "123\n", "Stats: 1 lines (0 errors) in ", 1, "test_stats.zip", "\"write\": { \"count\": 1," },
+        /*  3*/ { 1, 0, "test_stats_nonexistent/test_stats.json", "123\n", "Stats: 1 lines (0 errors) in ", 1, "test_stats1.svg", "" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+    char json[4096];
+
+    char *input_filename = "test_batch_stats.txt";
+    char *outfile;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+        if ((debug & ZINT_DEBUG_TEST_PRINT) && !(debug & ZINT_DEBUG_TEST_LESS_NOISY)) printf("i:%d\n", i);
+
+        strcpy(cmd, "zint --batch --filetype=svg");
+        if (debug & ZINT_DEBUG_PRINT) {
+            strcat(cmd, " --verbose");
+        }
+
+        arg_int(cmd, "--threads=", data[i].threads);
+        arg_data(cmd, "-o ", "test_stats~");
+        if (data[i].archive) {
+            arg_data(cmd, "--archive=", "test_stats.zip");
+        }
+        if (*data[i].stats) {
+            arg_data(cmd, "--stats=", data[i].stats);
+        } else {
+            strcat(cmd, " --stats");
+        }
+        arg_input(cmd, input_filename, data[i].input);
+
+        strcat(cmd, " 2>&1");
+
+        memset(buf, 0, sizeof(buf));
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_nonnull(strstr(buf, data[i].expected), "i:%d buf (%s) doesn't contain expected (%s)\n",
+                    i, buf, data[i].expected);
+
+        outfile = data[i].expected_files;
+        for (int j = 0; j < data[i].num_expected; j++) {
+            assert_nonzero(testUtilExists(outfile), "i:%d j:%d testUtilExists(%s) != 1\n", i, j, outfile);
+            assert_zero(remove(outfile), "i:%d j:%d remove(%s) != 0 (%d)\n", i, j, outfile, errno);
+            outfile += strlen(outfile) + 1;
+        }
+
+        if (*data[i].expected_json) {
+            FILE *fp = fopen(data[i].stats, "r");
+            size_t len;
+            assert_nonnull(fp, "i:%d fopen(%s) NULL\n", i, data[i].stats);
+            len = fread(json, 1, sizeof(json) - 1, fp);
+            json[len] = '\0';
+            fclose(fp);
+            assert_nonnull(strstr(json, data[i].expected_json), "i:%d json (%s) doesn't contain expected (%s)\n",
+                        i, json, data[i].expected_json);
+            assert_zero(remove(data[i].stats), "i:%d remove(%s) != 0 (%d)\n", i, data[i].stats, errno);
+        } else if (*data[i].stats) {
+            assert_nonnull(strstr(buf, "Error 171: Could not write stats file"), "i:%d buf (%s) no Error 171\n",
+                        i, buf);
+        }
+
+        assert_zero(remove(input_filename), "i:%d remove(%s) != 0 (%d)\n", i, input_filename, errno);
+    }
+
+    testFinish();
+}
+
+static void test_serve(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        int use_stdin;
+        char *input;
+
+        char *expected;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { 1, "1\n", "0 0 18\nD2 13 9B 39 63 AC" },
+        /*  1*/ { 1, "1\r\n\377\n", "0 0 18\nD2 13 9B 39 63 AC\n6 24 0\nError 245: Invalid UTF-8" },
+        /*  2*/ { 1, "#2\n1\n", "0 0 23\nD0 93 9A 19 78 AC 75 8" },
+        /*  3*/ { 1, "#\n1\n", "6 33 0\nError 164: Invalid request length0 0 18\nD2 13 9B 39 63 AC" },
+        /*  4*/ { 1, "#99999\n", "5 32 0\nError 165: Request data too long" },
+        /*  5*/ { 0, "1\n", "Warning 163: Input data ignored in serve mode" },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+    char redirect[4096];
+
+    char *input_filename = "test_serve.txt";
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+        if ((debug & ZINT_DEBUG_TEST_PRINT) && !(debug & ZINT_DEBUG_TEST_LESS_NOISY)) printf("i:%d\n", i);
+
+        strcpy(cmd, "zint --serve --dump");
+        if (debug & ZINT_DEBUG_PRINT) {
+            strcat(cmd, " --verbose");
+        }
+
+        if (data[i].use_stdin) {
+            redirect[0] = '\0';
+            arg_input(redirect, input_filename, data[i].input);
+            sprintf(cmd + (int) strlen(cmd), " < '%s'", input_filename);
+        } else {
+            arg_input(cmd, input_filename, data[i].input);
+            strcat(cmd, " < /dev/null"); // Avoid waiting on terminal
+        }
+
+        strcat(cmd, " 2>&1");
+
+        memset(buf, 0, sizeof(buf)); // Responses needn't end in newline so clear previous output
+
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_zero(strcmp(buf, data[i].expected), "i:%d buf (%s) != expected (%s)\n", i, buf, data[i].expected);
+
+        assert_zero(remove(input_filename), "i:%d remove(%s) != 0 (%d)\n", i, input_filename, errno);
+    }
+
+    testFinish();
+}
+
+static void test_watch(int index, int debug) {
+
+    testStart("");
+
+    struct item {
+        char *dir;
+        char *input;
+
+        char *expected;
+        int num_expected;
+        char *expected_files;
+    };
+    // s/\/\*[ 0-9]*\*\//\=printf("\/*%3d*\/", line(".") - line("'<"))
+    struct item data[] = {
+        /*  0*/ { "test_watch_dir", "123\n456\n", "", 3, "test_watch_dir/test_watch.txt.done\000test_watch-1.svg\000test_watch-2.svg" },
+        /*  1*/ { "test_watch_dir", "123\n\377\n", "On line 2: Error 245: Invalid UTF-8", 2, "test_watch_dir/test_watch.txt.err\000test_watch-1.svg" },
+        /*  2*/ { "test_watch_nonexistent", NULL, "Error 174: Unable to read watch directory", 0, NULL },
+    };
+    int data_size = ARRAY_SIZE(data);
+
+    char cmd[4096];
+    char buf[4096];
+    char redirect[4096];
+
+    char *input_filename = "test_watch_dir/test_watch.txt";
+    char *outfile;
+
+    for (int i = 0; i < data_size; i++) {
+
+        if (index != -1 && i != index) continue;
+        if ((debug & ZINT_DEBUG_TEST_PRINT) && !(debug & ZINT_DEBUG_TEST_LESS_NOISY)) printf("i:%d\n", i);
+
+        if (data[i].input) {
+            assert_zero(mkdir(data[i].dir, 0755), "i:%d mkdir(%s) != 0 (%d)\n", i, data[i].dir, errno);
+            redirect[0] = '\0';
+            arg_input(redirect, input_filename, data[i].input);
+        }
+
+        /* Existing files are processed after a scan interval, then interrupt */
+        sprintf(cmd, "(zint --watch='%s' --filetype=svg -o '~'%s 2>&1 & pid=$!; sleep 2; kill -INT $pid 2> /dev/null;"
+                " wait $pid)", data[i].dir, debug & ZINT_DEBUG_PRINT ? " --verbose" : "");
+
+        assert_nonnull(exec(cmd, buf, sizeof(buf) - 1, debug, i), "i:%d exec(%s) NULL\n", i, cmd);
+        assert_zero(strcmp(buf, data[i].expected), "i:%d buf (%s) != expected (%s)\n", i, buf, data[i].expected);
+
+        outfile = data[i].expected_files;
+        for (int j = 0; j < data[i].num_expected; j++) {
+            assert_nonzero(testUtilExists(outfile), "i:%d j:%d testUtilExists(%s) != 1\n", i, j, outfile);
+            assert_zero(remove(outfile), "i:%d j:%d remove(%s) != 0 (%d)\n", i, j, outfile, errno);
+            outfile += strlen(outfile) + 1;
+        }
+
+        if (data[i].input) {
+            assert_zero(rmdir(data[i].dir), "i:%d rmdir(%s) != 0 (%d)\n", i, data[i].dir, errno);
+        }
+    }
+
+    testFinish();
+}
+
 static void test_checks(int index, int debug) {
 
     testStart("");
@@ -870,6 +1335,13 @@ int main(int argc, char *argv[]) {
         { "test_stdin_input", test_stdin_input, 1, 0, 1 },
         { "test_batch_input", test_batch_input, 1, 0, 1 },
         { "test_batch_large", test_batch_large, 1, 0, 1 },
+        { "test_batch_threads", test_batch_threads, 1, 0, 1 },
+        { "test_batch_archive", test_batch_archive, 1, 0, 1 },
+        { "test_batch_records", test_batch_records, 1, 0, 1 },
+        { "test_batch_dedupe", test_batch_dedupe, 1, 0, 1 },
+        { "test_batch_stats", test_batch_stats, 1, 0, 1 },
+        { "test_serve", test_serve, 1, 0, 1 },
+        { "test_watch", test_watch, 1, 0, 1 },
         { "test_checks", test_checks, 1, 0, 1 },
         { "test_barcode_symbology", test_barcode_symbology, 1, 0, 1 },
         { "test_other_opts", test_other_opts, 1, 0, 1 },
@@ -15,14 +15,24 @@
  ***************************************************************************/
 
 #include <QDebug>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include "barcodeitem.h"
 
+/* Level of detail (device pixels per item unit) below which the symbol is drawn from a downsampled raster */
+static const qreal rasterLOD = 1.0;
+/* Size in device pixels of the smaller side of the item below which a placeholder is drawn instead */
+static const qreal placeholderPixels = 16.0;
+
 BarcodeItem::BarcodeItem()
 		: QGraphicsItem()
 {
 	w=693;
 	h=378; // Default widget size when created
 	ar = Zint::QZint::AspectRatioMode::IgnoreAspectRatio;
+	levelOfDetail = true;
+	/* Redraw only on update() (i.e. symbol change) or on transform change, not on every scroll or expose */
+	setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 }
 
 BarcodeItem::~BarcodeItem()
@@ -30,6 +40,9 @@ BarcodeItem::~BarcodeItem()
 }
 
 void BarcodeItem::setSize(int width, int height) {
+    if (width != w || height != h) {
+        prepareGeometryChange(); /* Also invalidates the cache */
+    }
     w = width;
     h = height;
 }
@@ -39,8 +52,26 @@ QRectF BarcodeItem::boundingRect() const
 	return QRectF(0, 0, w, h);
 }
 
-void BarcodeItem::paint(QPainter * painter, const QStyleOptionGraphicsItem * /*option*/, QWidget * /*widget*/)
+void BarcodeItem::paint(QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * /*widget*/)
 {
+	if (levelOfDetail) {
+		const qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+
+		if (qMin(w, h) * lod < placeholderPixels) {
+			/* Too small to be readable, so don't encode or draw, just hatch the area */
+			painter->fillRect(boundingRect(), bc.bgColor());
+			painter->fillRect(boundingRect(), QBrush(bc.fgColor(), Qt::Dense5Pattern));
+			return;
+		}
+		if (lod < rasterLOD && bc.renderMode() != Zint::QZint::RasterRender) {
+			/* Modules smaller than a device pixel, so a raster at 1 pixel per module scaled down is cheapest */
+			const Zint::QZint::RenderMode mode = bc.renderMode();
+			bc.setRenderMode(Zint::QZint::RasterRender);
+			bc.render(*painter, boundingRect(), ar);
+			bc.setRenderMode(mode);
+			return;
+		}
+	}
 	bc.render(*painter,boundingRect(),ar);
 }
 
@@ -39,6 +39,8 @@ private:
 public:
 	mutable Zint::QZint bc;
 	Zint::QZint::AspectRatioMode ar;
+        /* If set (the default), draws a downsampled raster when zoomed out and a placeholder when tiny */
+        bool levelOfDetail;
 };
 
 #endif
@@ -23,9 +23,55 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QSettings>
+#include <QFile>
+#include <QMutexLocker>
 
 #include "exportwindow.h"
 
+/* Export worker, taking the next item to export until none left or cancelled, using its own QZint */
+class ExportWorker : public QThread
+{
+public:
+    ExportWorker(ExportWindow *window, Zint::QZint *bc) : m_window(window), m_bc(bc) {}
+    ~ExportWorker() { delete m_bc; }
+
+protected:
+    void run();
+
+private:
+    ExportWindow *m_window;
+    Zint::QZint *m_bc;
+};
+
+void ExportWorker::run()
+{
+    QByteArray data;
+    QString dataString, fileName, error;
+    int i;
+
+    while (!m_window->m_cancel.loadAcquire() && (i = m_window->m_next.fetchAndAddOrdered(1)) < m_window->m_lines) {
+        dataString = m_window->source->item(i);
+        fileName = QString(m_window->file_name(dataString, i).toLatin1().data());
+
+        m_bc->setText(dataString.toLatin1().data());
+        error.clear();
+        if (!m_bc->save_to_memfile(fileName, data)) {
+            error = m_bc->error_message();
+        } else {
+            QFile file(fileName);
+            if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+                error = "Could not write output file";
+            }
+        }
+        if (!error.isEmpty()) {
+            QMutexLocker locker(&m_window->m_errorsMutex);
+            m_window->m_errors.insert(i, error);
+        }
+        m_window->m_done.fetchAndAddOrdered(1);
+    }
+    QMetaObject::invokeMethod(m_window, "worker_finished", Qt::QueuedConnection);
+}
+
 ExportWindow::ExportWindow()
 {
     QSettings settings;
@@ -42,10 +88,26 @@ ExportWindow::ExportWindow()
     connect(btnCancel, SIGNAL( clicked( bool )), SLOT(quit_now()));
     connect(btnOK, SIGNAL( clicked( bool )), SLOT(process()));
     connect(btnDestPath, SIGNAL( clicked( bool )), SLOT(get_directory()));
+
+    source = NULL;
+    m_lines = 0;
+    m_name_format = 0;
+    m_running = 0;
+    prgExport->setValue(0);
+    m_progressTimer.setInterval(100);
+    connect(&m_progressTimer, SIGNAL(timeout()), SLOT(update_progress()));
 }
 
 ExportWindow::~ExportWindow()
 {
+    if (m_running) {
+        m_cancel.storeRelease(1);
+        for (int i = 0; i < m_workers.size(); i++) {
+            m_workers[i]->wait();
+        }
+        qDeleteAll(m_workers);
+    }
+
     QSettings settings;
 #if QT_VERSION < 0x60000
     settings.setIniCodec("UTF-8");
@@ -59,9 +121,23 @@ ExportWindow::~ExportWindow()
 
 void ExportWindow::quit_now()
 {
+    if (m_running) {
+        m_cancel.storeRelease(1); /* Workers stop after their current line */
+        btnCancel->setEnabled(false);
+        return;
+    }
     close();
 }
 
+void ExportWindow::reject()
+{
+    if (m_running) { /* Escape cancels an export in progress rather than closing */
+        quit_now();
+        return;
+    }
+    QDialog::reject();
+}
+
 void ExportWindow::get_directory()
 {
     QSettings settings;
@@ -84,27 +160,72 @@ void ExportWindow::get_directory()
     settings.setValue("studio/default_dir", directory);
 }
 
-void ExportWindow::process()
+/* Returns the output file name for item `i` with data `dataString`, using the settings snapshot taken by `process()`
+   so may be called from the workers */
+QString ExportWindow::file_name(const QString &dataString, int i) const
 {
     QString fileName;
-    QString dataString;
+
+    switch(m_name_format) {
+        case 0: { /* Same as Data (URL Escaped) */
+                QString url_escaped;
+                int m;
+                QChar name_qchar;
+
+                for(m = 0; m < dataString.length(); m++) {
+                    name_qchar = dataString[m];
+                    char name_char = name_qchar.toLatin1();
+
+                    switch(name_char) {
+                        case '\\': url_escaped += "%5C"; break;
+                        case '/': url_escaped += "%2F"; break;
+                        case ':': url_escaped += "%3A"; break;
+                        case '*': url_escaped += "%2A"; break;
+                        case '?': url_escaped += "%3F"; break;
+                        case '"': url_escaped += "%22"; break;
+                        case '<': url_escaped += "%3C"; break;
+                        case '>': url_escaped += "%3E"; break;
+                        case '|': url_escaped += "%7C"; break;
+                        case '%': url_escaped += "%25"; break;
+                        default: url_escaped += name_qchar; break;
+                    }
+                }
+                fileName = m_path_prefix + url_escaped + m_suffix;
+            }
+            break;
+        case 1: { /* Formatted Serial Number */
+                QString biggest, this_val, outnumber;
+                int number_size, val_size, m;
+
+                biggest = QString::number(m_lines + 1);
+                number_size = biggest.length();
+                this_val = QString::number(i + 1);
+                val_size = this_val.length();
+
+                for(m = 0; m < (number_size - val_size); m++) {
+                    outnumber += QChar('0');
+                }
+
+                outnumber += this_val;
+
+                fileName = m_path_prefix + outnumber + m_suffix;
+            }
+            break;
+    }
+
+    return fileName;
+}
+
+void ExportWindow::process()
+{
     QString suffix;
-    QString Feedback;
-    int lines, i, j, inputpos;
+    int i, threads;
 
-    lines = output_data.count(QChar('\n'), Qt::CaseInsensitive);
-    inputpos = 0;
+    if (m_running) {
+        return;
+    }
 
     switch(cmbFileFormat->currentIndex()) {
-#ifdef NO_PNG
-        case 0: suffix = ".eps"; break;
-        case 1: suffix = ".gif"; break;
-        case 2: suffix = ".svg"; break;
-        case 3: suffix = ".bmp"; break;
-        case 4: suffix = ".pcx"; break;
-        case 5: suffix = ".emf"; break;
-        case 6: suffix = ".tif"; break;
-#else
         case 0: suffix = ".png"; break;
         case 1: suffix = ".eps"; break;
         case 2: suffix = ".gif"; break;
@@ -113,75 +234,94 @@ void ExportWindow::process()
         case 5: suffix = ".pcx"; break;
         case 6: suffix = ".emf"; break;
         case 7: suffix = ".tif"; break;
-#endif
+        case 8: suffix = ".pbm"; break;
+        case 9: suffix = ".pgm"; break;
+        case 10: suffix = ".pdf"; break;
+        case 11: suffix = ".zpl"; break;
+        case 12: suffix = ".epl"; break;
+        case 13: suffix = ".pcl"; break;
+        case 14: suffix = ".qoi"; break;
     }
     txtFeedback->clear();
-    Feedback = "";
 
-    for(i = 0; i < lines; i++) {
-        int datalen = 0;
-        for(j = inputpos; ((j < output_data.length()) && (output_data[j] != '\n') ); j++) {
-            datalen++;
-        }
-        dataString = output_data.mid(inputpos, datalen);
-        switch(cmbFileName->currentIndex()) {
-            case 0: { /* Same as Data (URL Escaped) */
-                    QString url_escaped;
-                    int m;
-                    QChar name_qchar;
-
-                    for(m = 0; m < dataString.length(); m++) {
-                        name_qchar = dataString[m];
-                        char name_char = name_qchar.toLatin1();
-
-                        switch(name_char) {
-                            case '\\': url_escaped += "%5C"; break;
-                            case '/': url_escaped += "%2F"; break;
-                            case ':': url_escaped += "%3A"; break;
-                            case '*': url_escaped += "%2A"; break;
-                            case '?': url_escaped += "%3F"; break;
-                            case '"': url_escaped += "%22"; break;
-                            case '<': url_escaped += "%3C"; break;
-                            case '>': url_escaped += "%3E"; break;
-                            case '|': url_escaped += "%7C"; break;
-                            case '%': url_escaped += "%25"; break;
-                            default: url_escaped += name_qchar; break;
-                        }
-                    }
-                    fileName = linDestPath->text() + QDir::separator() + linPrefix->text() + url_escaped + suffix;
-                }
-                break;
-            case 1: { /* Formatted Serial Number */
-                    QString biggest, this_val, outnumber;
-                    int number_size, val_size, m;
-
-                    biggest = QString::number(lines + 1);
-                    number_size = biggest.length();
-                    this_val = QString::number(i + 1);
-                    val_size = this_val.length();
-
-                    for(m = 0; m < (number_size - val_size); m++) {
-                        outnumber += QChar('0');
-                    }
+    m_lines = source->count();
+    m_path_prefix = linDestPath->text() + QDir::separator() + linPrefix->text();
+    m_suffix = suffix;
+    m_name_format = cmbFileName->currentIndex();
+    m_errors.clear();
+    m_next.storeRelease(0);
+    m_cancel.storeRelease(0);
+    m_done.storeRelease(0);
+    if (m_lines == 0) {
+        return;
+    }
+    prgExport->setRange(0, m_lines);
+    prgExport->setValue(0);
+    btnOK->setEnabled(false);
+    btnCancel->setText("&Cancel");
+    btnCancel->setToolTip("Stop exporting");
 
-                    outnumber += this_val;
+    /* Each worker gets its own QZint, copied here on the GUI thread */
+    threads = QThread::idealThreadCount();
+    if (threads < 1) {
+        threads = 1;
+    } else if (threads > m_lines) {
+        threads = m_lines;
+    }
+    for (i = 0; i < threads; i++) {
+        Zint::QZint *bc = new Zint::QZint;
+        bc->copySettings(barcode->bc);
+        m_workers << new ExportWorker(this, bc);
+    }
+    m_running = threads;
+    for (i = 0; i < threads; i++) {
+        m_workers[i]->start();
+    }
+    m_progressTimer.start();
+}
 
-                    fileName = linDestPath->text() + QDir::separator() + linPrefix->text() + outnumber + suffix;
-                }
-                break;
-        }
-        barcode->bc.setText(dataString.toLatin1().data());
-        barcode->bc.save_to_file(fileName.toLatin1().data());
+void ExportWindow::update_progress()
+{
+    prgExport->setValue(m_done.loadAcquire());
+}
+
+void ExportWindow::worker_finished()
+{
+    QString Feedback;
+    QMap<int, QString>::const_iterator it;
+    int i, done;
+
+    if (--m_running) {
+        return;
+    }
+    m_progressTimer.stop();
+    for (i = 0; i < m_workers.size(); i++) {
+        m_workers[i]->wait();
+    }
+    qDeleteAll(m_workers);
+    m_workers.clear();
+    done = m_done.loadAcquire();
+    prgExport->setValue(done);
+
+    /* Failed lines in line order, then a summary */
+    for (it = m_errors.constBegin(); it != m_errors.constEnd(); ++it) {
         Feedback += "Line ";
-        Feedback += QString::number(i + 1);
+        Feedback += QString::number(it.key() + 1);
         Feedback += ": ";
-        if (barcode->bc.hasErrors()) {
-            Feedback += barcode->bc.error_message();
-            Feedback += "\n";
-        } else {
-            Feedback += "Success\n";
-        }
-        txtFeedback->document()->setPlainText(Feedback);
-        inputpos += datalen + 1;
+        Feedback += it.value();
+        Feedback += "\n";
     }
+    Feedback += QString::number(done - m_errors.size());
+    Feedback += " of ";
+    Feedback += QString::number(m_lines);
+    Feedback += " exported successfully\n";
+    if (m_cancel.loadAcquire()) {
+        Feedback += "Cancelled\n";
+    }
+    txtFeedback->document()->setPlainText(Feedback);
+
+    btnOK->setEnabled(true);
+    btnCancel->setEnabled(true);
+    btnCancel->setText("&Close");
+    btnCancel->setToolTip("Close window");
 }
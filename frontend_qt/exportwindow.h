@@ -20,9 +20,25 @@
 #ifndef EXPORTWINDOW_H
 #define EXPORTWINDOW_H
 
+#include <QThread>
+#include <QAtomicInt>
+#include <QMap>
+#include <QMutex>
+#include <QTimer>
 #include "ui_extExport.h"
 #include "barcodeitem.h"
 
+class ExportWorker;
+
+/* Source of the data items to export, read by the export workers so `item()` must be thread-safe */
+class SequenceSource
+{
+public:
+	virtual ~SequenceSource() {}
+	virtual int count() const = 0;
+	virtual QString item(int i) const = 0;
+};
+
 class ExportWindow : public QDialog, private Ui::ExportDialog
 {
 	Q_OBJECT
@@ -31,12 +47,36 @@ public:
 	ExportWindow();
 	~ExportWindow();
 	BarcodeItem *barcode;
-	QString output_data;
+	SequenceSource *source;
+
+public slots:
+	void reject();
 
 private slots:
 	void quit_now();
 	void process();
 	void get_directory();
+	void update_progress();
+	void worker_finished();
+
+private:
+	friend class ExportWorker;
+
+	QString file_name(const QString &dataString, int i) const;
+
+	/* Export state shared with the workers, fixed while they run apart from the atomics and `m_errors` */
+	int m_lines;
+	QString m_path_prefix;
+	QString m_suffix;
+	int m_name_format;
+	QMap<int, QString> m_errors; /* Error messages by line, guarded by `m_errorsMutex` */
+	QMutex m_errorsMutex;
+	QAtomicInt m_next; /* Next line to export */
+	QAtomicInt m_cancel;
+	QAtomicInt m_done; /* Lines exported */
+	QList<ExportWorker *> m_workers;
+	int m_running; /* Workers not yet finished */
+	QTimer m_progressTimer;
 };
 
 #endif
\ No newline at end of file
@@ -19,6 +19,7 @@ HEADERS += barcodeitem.h \
          mainwindow.h \
          sequencewindow.h \
          qzint.h \
+         qzintrenderer.h \
         ..\backend\aztec.h \
         ..\backend\big5.h \
         ..\backend\bmp.h \
@@ -41,9 +42,11 @@ HEADERS += barcodeitem.h \
         ..\backend\hanxin.h \
         ..\backend\ksx1001.h \
         ..\backend\large.h \
+        ..\backend\library.h \
         ..\backend\maxicode.h \
         ..\backend\ms_stdint.h \
         ..\backend\output.h \
+        ..\backend\filemem.h \
         ..\backend\pcx.h \
         ..\backend\pdf417.h \
         ..\backend\qr.h \
@@ -97,9 +100,12 @@ SOURCES += barcodeitem.cpp \
         mainwindow.cpp \
         sequencewindow.cpp \
         qzint.cpp \
+        qzintrenderer.cpp \
         ..\backend\2of5.c \
+        ..\backend\async.c \
         ..\backend\auspost.c \
         ..\backend\aztec.c \
+        ..\backend\batch.c \
         ..\backend\bmp.c \
         ..\backend\codablock.c \
         ..\backend\code.c \
@@ -127,8 +133,15 @@ SOURCES += barcodeitem.cpp \
         ..\backend\mailmark.c \
         ..\backend\maxicode.c \
         ..\backend\medical.c \
+        ..\backend\modules.c \
+        ..\backend\multiout.c \
         ..\backend\output.c \
+        ..\backend\filemem.c \
         ..\backend\pcx.c \
+        ..\backend\pdf.c \
+        ..\backend\pnm.c \
+        ..\backend\prn.c \
+        ..\backend\qoi.c \
         ..\backend\pdf417.c \
         ..\backend\plessey.c \
         ..\backend\png.c \
@@ -9,7 +9,8 @@ HEADERS += barcodeitem.h \
          exportwindow.h \
          mainwindow.h \
          sequencewindow.h \
-         qzint.h
+         qzint.h \
+         qzintrenderer.h
 
 FORMS += extData.ui \
          extExport.ui \
@@ -49,7 +50,8 @@ SOURCES += barcodeitem.cpp \
         main.cpp \
         mainwindow.cpp \
         sequencewindow.cpp \
-        qzint.cpp
+        qzint.cpp \
+        qzintrenderer.cpp
         
 RESOURCES += resources.qrc
 
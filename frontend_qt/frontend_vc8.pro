@@ -15,7 +15,8 @@ HEADERS = 	mainwindow.h \
 			datawindow.h \
 			exportwindow.h \
 			sequencewindow.h \
-			qzint.h
+			qzint.h \
+			qzintrenderer.h
 
 SOURCES = 	main.cpp \ 
 			mainwindow.cpp \
@@ -23,7 +24,8 @@ SOURCES = 	main.cpp \
 			datawindow.cpp \
 			exportwindow.cpp \
 			sequencewindow.cpp
-			qzint.cpp
+			qzint.cpp \
+			qzintrenderer.cpp
 
 RESOURCES = resources.qrc
 
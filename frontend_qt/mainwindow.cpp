@@ -191,8 +191,8 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags fl)
     connect(bwidth,  SIGNAL(valueChanged( int )), SLOT(update_preview()));
     connect(btype, SIGNAL(currentIndexChanged( int )), SLOT(update_preview()));
     connect(cmbFontSetting, SIGNAL(currentIndexChanged( int )), SLOT(update_preview()));
-    connect(txtData, SIGNAL(textChanged( const QString& )), SLOT(update_preview()));
-    connect(txtComposite, SIGNAL(textChanged()), SLOT(update_preview()));
+    connect(txtData, SIGNAL(textChanged( const QString& )), SLOT(schedule_preview()));
+    connect(txtComposite, SIGNAL(textChanged()), SLOT(schedule_preview()));
     connect(chkComposite, SIGNAL(stateChanged( int )), SLOT(composite_ui_set()));
     connect(chkComposite, SIGNAL(stateChanged( int )), SLOT(update_preview()));
     connect(cmbCompType, SIGNAL(currentIndexChanged( int )), SLOT(update_preview()));
@@ -223,6 +223,12 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags fl)
     connect(btnCopyBMP, SIGNAL(clicked( bool )), SLOT(copy_to_clipboard_bmp()));
 
     connect(&m_bc.bc, SIGNAL(encoded()), SLOT(on_encoded()));
+    connect(&m_bc.bc, SIGNAL(backgroundEncoded()), SLOT(redraw_preview()));
+
+    /* Coalesce data edits so that typing doesn't queue an encode per keystroke */
+    m_preview_timer.setSingleShot(true);
+    m_preview_timer.setInterval(100);
+    connect(&m_preview_timer, SIGNAL(timeout()), SLOT(update_preview()));
 
     QShortcut *ctrl_q = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_Q), this);
     connect(ctrl_q, SIGNAL(activated()), SLOT(quit_now()));
@@ -275,7 +281,10 @@ MainWindow::~MainWindow()
 void MainWindow::resizeEvent(QResizeEvent* event)
 {
     QWidget::resizeEvent(event);
-    update_preview();
+    /* Size only, no need to re-encode */
+    m_bc.setSize(view->geometry().width() - 10, view->geometry().height() - 10);
+    redraw_preview();
+    scene->setSceneRect(m_bc.boundingRect());
 }
 
 void MainWindow::reset_view()
@@ -299,13 +308,8 @@ bool MainWindow::save()
     save_dialog.setWindowTitle(tr("Save Barcode Image"));
     save_dialog.setDirectory(settings.value("studio/default_dir", QDir::toNativeSeparators(QDir::homePath())).toString());
 
-#ifdef NO_PNG
-    suffix = settings.value("studio/default_suffix", "gif").toString();
-    save_dialog.setNameFilter(tr("Encapsulated PostScript (*.eps);;Graphics Interchange Format (*.gif);;Scalable Vector Graphic (*.svg);;Windows Bitmap (*.bmp);;ZSoft PC Painter Image (*.pcx);;Enhanced Metafile (*.emf);;Tagged Image File Format (*.tif)"));
-#else
     suffix = settings.value("studio/default_suffix", "png").toString();
-    save_dialog.setNameFilter(tr("Portable Network Graphic (*.png);;Encapsulated PostScript (*.eps);;Graphics Interchange Format (*.gif);;Scalable Vector Graphic (*.svg);;Windows Bitmap (*.bmp);;ZSoft PC Painter Image (*.pcx);;Enhanced Metafile (*.emf);;Tagged Image File Format (*.tif)"));
-#endif
+    save_dialog.setNameFilter(tr("Portable Network Graphic (*.png);;Encapsulated PostScript (*.eps);;Graphics Interchange Format (*.gif);;Scalable Vector Graphic (*.svg);;Windows Bitmap (*.bmp);;ZSoft PC Painter Image (*.pcx);;Enhanced Metafile (*.emf);;Tagged Image File Format (*.tif);;Portable Bitmap (*.pbm);;Portable Graymap (*.pgm);;Portable Document Format (*.pdf);;Zebra Programming Language (*.zpl);;Eltron Programming Language (*.epl);;Printer Command Language (*.pcl);;Quite OK Image (*.qoi)"));
 
     if (QString::compare(suffix, "png", Qt::CaseInsensitive) == 0)
         save_dialog.selectNameFilter(tr("Portable Network Graphic (*.png)"));
@@ -323,6 +327,20 @@ bool MainWindow::save()
         save_dialog.selectNameFilter(tr("Enhanced Metafile (*.emf)"));
     if (QString::compare(suffix, "tif", Qt::CaseInsensitive) == 0)
         save_dialog.selectNameFilter(tr("Tagged Image File Format (*.tif)"));
+    if (QString::compare(suffix, "pbm", Qt::CaseInsensitive) == 0)
+        save_dialog.selectNameFilter(tr("Portable Bitmap (*.pbm)"));
+    if (QString::compare(suffix, "pgm", Qt::CaseInsensitive) == 0)
+        save_dialog.selectNameFilter(tr("Portable Graymap (*.pgm)"));
+    if (QString::compare(suffix, "pdf", Qt::CaseInsensitive) == 0)
+        save_dialog.selectNameFilter(tr("Portable Document Format (*.pdf)"));
+    if (QString::compare(suffix, "zpl", Qt::CaseInsensitive) == 0)
+        save_dialog.selectNameFilter(tr("Zebra Programming Language (*.zpl)"));
+    if (QString::compare(suffix, "epl", Qt::CaseInsensitive) == 0)
+        save_dialog.selectNameFilter(tr("Eltron Programming Language (*.epl)"));
+    if (QString::compare(suffix, "pcl", Qt::CaseInsensitive) == 0)
+        save_dialog.selectNameFilter(tr("Printer Command Language (*.pcl)"));
+    if (QString::compare(suffix, "qoi", Qt::CaseInsensitive) == 0)
+        save_dialog.selectNameFilter(tr("Quite OK Image (*.qoi)"));
 
     if (save_dialog.exec()) {
         filename = save_dialog.selectedFiles().at(0);
@@ -485,6 +503,17 @@ void MainWindow::on_encoded()
     }
 }
 
+void MainWindow::schedule_preview()
+{
+    m_preview_timer.start(); /* Restarts if already active */
+}
+
+void MainWindow::redraw_preview()
+{
+    m_bc.update();
+    scene->update();
+}
+
 void MainWindow::filter_symbologies()
 {
     QString filter = filter_bstyle->text().simplified(); /* `simplified()` trims and reduces inner whitespace to a single space - nice! */
@@ -1601,6 +1630,8 @@ void MainWindow::update_preview()
     m_bc.bc.setBgColor(m_bgcolor);
     change_print_scale();
     change_cmyk();
+    m_preview_timer.stop(); /* Any pending data edit is included */
+    m_bc.bc.encodeInBackground();
     m_bc.setSize(width - 10, height - 10);
     m_bc.update();
     scene->setSceneRect(m_bc.boundingRect());
@@ -21,6 +21,7 @@
 #include <QGraphicsItem>
 #include <QMainWindow>
 #include <QGraphicsScene>
+#include <QTimer>
 
 #include "ui_mainWindow.h"
 #include "barcodeitem.h"
@@ -128,6 +129,8 @@ public slots:
     void HRTShow_ui_set();
     void dotty_ui_set();
     void on_encoded();
+    void schedule_preview();
+    void redraw_preview();
 	void filter_symbologies();
 
 protected:
@@ -167,6 +170,7 @@ private:
     QWidget *m_optionWidget;
     QGraphicsScene *scene;
 	int m_symbology;
+    QTimer m_preview_timer;
 };
 
 #endif
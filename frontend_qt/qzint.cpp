@@ -19,16 +19,24 @@
 //#include <QDebug>
 #include "qzint.h"
 #include <stdio.h>
-#include <math.h>
-#include <QFontMetrics>
-/* the following include was necessary to compile with QT 5.18 on Windows */
-/* QT 8.7 did not require it. */
-#include <QPainterPath>
+#include <string.h>
+#include <QThread>
 
 namespace Zint {
-    static const char *fontStyle = "Helvetica";
-    static const char *fontStyleError = "Helvetica";
-    static const int fontSizeError = 14; /* Point size */
+    /* Background encoder, constructing a `QZintRenderer` from a copy of the settings on its own thread */
+    class QZintEncodeJob : public QThread {
+    public:
+        QZintEncodeJob(const QZintRenderer::Settings &settings) : m_settings(settings) {}
+
+        QZintRenderer::Settings m_settings;
+        QSharedPointer<QZintRenderer> m_renderer;
+
+    protected:
+        void run() {
+            m_renderer = QSharedPointer<QZintRenderer>(new QZintRenderer(m_settings));
+        }
+    };
+
 
     QZint::QZint() {
         m_symbol = BARCODE_CODE128;
@@ -40,7 +48,6 @@ namespace Zint {
         m_fgColor = Qt::black;
         m_bgColor = Qt::white;
         m_cmyk = false;
-        m_zintSymbol = NULL;
         m_error = 0;
         m_input_mode = UNICODE_MODE;
         m_scale = 1.0f;
@@ -59,85 +66,132 @@ namespace Zint {
         m_reader_init = false;
         m_rotate_angle = 0;
         m_debug = false;
+        m_dirty = true;
+        m_job = NULL;
+        m_render_mode = AutoRender;
     }
 
     QZint::~QZint() {
-        if (m_zintSymbol)
-            ZBarcode_Delete(m_zintSymbol);
-    }
-
-    void QZint::resetSymbol() {
-        if (m_zintSymbol)
-            ZBarcode_Delete(m_zintSymbol);
-
-        m_lastError.clear();
-        m_zintSymbol = ZBarcode_Create();
-        m_zintSymbol->output_options |= m_borderType | m_fontSetting;
-        m_zintSymbol->symbology = m_symbol;
-        m_zintSymbol->height = m_height;
-        m_zintSymbol->whitespace_width = m_whitespace;
-        m_zintSymbol->whitespace_height = m_vwhitespace;
-        m_zintSymbol->border_width = m_borderWidth;
-        m_zintSymbol->option_1 = m_option_1;
-        m_zintSymbol->input_mode = m_input_mode;
-        m_zintSymbol->option_2 = m_option_2;
-        if (m_dotty) {
-            m_zintSymbol->output_options |= BARCODE_DOTTY_MODE;
-        }
-        m_zintSymbol->dot_size = m_dot_size;
-        m_zintSymbol->show_hrt = m_show_hrt ? 1 : 0;
-        m_zintSymbol->eci = m_eci;
-        m_zintSymbol->option_3 = m_option_3;
-        m_zintSymbol->scale = m_scale;
-        if (m_gs1parens) {
-            m_zintSymbol->input_mode |= GS1PARENS_MODE;
-        }
-        if (m_gssep) {
-            m_zintSymbol->output_options |= GS1_GS_SEPARATOR;
-        }
-        if (m_reader_init) {
-            m_zintSymbol->output_options |= READER_INIT;
-        }
-        if (m_debug) {
-            m_zintSymbol->debug |= ZINT_DEBUG_PRINT;
+        if (m_job) {
+            m_job->wait();
+            delete m_job;
         }
+    }
 
-        strcpy(m_zintSymbol->fgcolour, m_fgColor.name().toLatin1().right(6));
-        if (m_fgColor.alpha() != 0xff) {
-            strcat(m_zintSymbol->fgcolour, m_fgColor.name(QColor::HexArgb).toLatin1().mid(1,2));
-        }
-        strcpy(m_zintSymbol->bgcolour, m_bgColor.name().toLatin1().right(6));
-        if (m_bgColor.alpha() != 0xff) {
-            strcat(m_zintSymbol->bgcolour, m_bgColor.name(QColor::HexArgb).toLatin1().mid(1,2));
-        }
-        if (m_cmyk) {
-            m_zintSymbol->output_options |= CMYK_COLOUR;
+    /* Returns the current settings affecting the encode */
+    QZintRenderer::Settings QZint::settings() const {
+        QZintRenderer::Settings settings;
+        settings.symbol = m_symbol;
+        settings.text = m_text;
+        settings.primaryMessage = m_primaryMessage;
+        settings.height = m_height;
+        settings.borderType = m_borderType;
+        settings.borderWidth = m_borderWidth;
+        settings.fontSetting = m_fontSetting;
+        settings.option_1 = m_option_1;
+        settings.option_2 = m_option_2;
+        settings.option_3 = m_option_3;
+        settings.input_mode = m_input_mode;
+        settings.cmyk = m_cmyk;
+        settings.whitespace = m_whitespace;
+        settings.vwhitespace = m_vwhitespace;
+        settings.scale = m_scale;
+        settings.show_hrt = m_show_hrt;
+        settings.eci = m_eci;
+        settings.dotty = m_dotty;
+        settings.dot_size = m_dot_size;
+        settings.gs1parens = m_gs1parens;
+        settings.gssep = m_gssep;
+        settings.reader_init = m_reader_init;
+        settings.debug = m_debug;
+        return settings;
+    }
+
+    /* Returns the current settings affecting only how the symbol is drawn */
+    QZintRenderer::Style QZint::style() const {
+        QZintRenderer::Style style;
+        style.fgColor = m_fgColor;
+        style.bgColor = m_bgColor;
+        style.rotateAngle = m_rotate_angle;
+        style.renderMode = (QZintRenderer::RenderMode) m_render_mode;
+        return style;
+    }
+
+    /* Returns a new symbol set up with the current settings */
+    zint_symbol *QZint::createSymbol() const {
+        return QZintRenderer::createSymbol(settings(), m_fgColor, m_bgColor);
+    }
+
+    /* Encodes only if a setting affecting the symbol has changed since the last encode, so that repaints
+       (resizing, scrolling, colour or rotation changes) reuse the existing renderer */
+    void QZint::encode() {
+        if (!m_dirty && m_renderer) {
+            return;
         }
-        strcpy(m_zintSymbol->primary, m_primaryMessage.toLatin1().left(127));
+        m_dirty = false;
+        m_renderer = QSharedPointer<QZintRenderer>(new QZintRenderer(settings()));
+        updateFromSymbol();
     }
 
-    void QZint::encode() {
-        resetSymbol();
-        QByteArray bstr = m_text.toUtf8();
-        m_error = ZBarcode_Encode_and_Buffer_Vector(m_zintSymbol, (unsigned char *) bstr.data(), bstr.length(), 0); /* Note do our own rotation */
-        m_lastError = m_zintSymbol->errtxt;
+    /* Sets error and settings adjusted by the encode from `m_renderer` */
+    void QZint::updateFromSymbol() {
+        m_error = m_renderer->error();
+        m_lastError = m_renderer->lastError();
 
         if (m_error < ZINT_ERROR) {
-            m_borderType = m_zintSymbol->output_options & (BARCODE_BIND | BARCODE_BOX);
-            m_height = m_zintSymbol->height;
-            m_borderWidth = m_zintSymbol->border_width;
-            m_whitespace = m_zintSymbol->whitespace_width;
-            m_vwhitespace = m_zintSymbol->whitespace_height;
+            m_borderType = m_renderer->borderType();
+            m_height = m_renderer->height();
+            m_borderWidth = m_renderer->borderWidth();
+            m_whitespace = m_renderer->whitespace();
+            m_vwhitespace = m_renderer->vwhitespace();
             emit encoded();
         }
     }
 
+    /* Returns the renderer of the current settings, encoding first if they've changed. It's not changed by later
+       settings (they get a new renderer), so can be kept and used from any thread, e.g. to render in a worker */
+    QSharedPointer<const QZintRenderer> QZint::renderer() {
+        encode();
+        return m_renderer;
+    }
+
+    /* Starts encoding on a background thread if settings have changed, with `render()` meanwhile drawing the previous
+       symbol. If a job is already running the latest settings are encoded once it finishes, its result being stale.
+       `backgroundEncoded()` is emitted when a result has been swapped in */
+    void QZint::encodeInBackground() {
+        if (!m_dirty || m_job) {
+            return;
+        }
+        m_job = new QZintEncodeJob(settings());
+        m_dirty = false; /* Any setting changed while the job is running will make it stale */
+        connect(m_job, SIGNAL(finished()), SLOT(encodeJobFinished()));
+        m_job->start();
+    }
+
+    void QZint::encodeJobFinished() {
+        QZintEncodeJob *job = m_job;
+
+        m_job = NULL;
+        job->wait();
+        if (m_dirty) { /* Stale */
+            job->deleteLater();
+            encodeInBackground();
+            return;
+        }
+        m_renderer = job->m_renderer;
+        job->deleteLater();
+
+        updateFromSymbol();
+        emit backgroundEncoded();
+    }
+
     int QZint::symbol() const {
         return m_symbol;
     }
 
     void QZint::setSymbol(int symbol) {
         m_symbol = symbol;
+        m_dirty = true;
     }
 
     int QZint::inputMode() const {
@@ -146,6 +200,7 @@ namespace Zint {
 
     void QZint::setInputMode(int input_mode) {
         m_input_mode = input_mode;
+        m_dirty = true;
     }
 
     QString QZint::text() const {
@@ -154,6 +209,7 @@ namespace Zint {
 
     void QZint::setText(const QString & text) {
         m_text = text;
+        m_dirty = true;
     }
 
     QString QZint::primaryMessage() const {
@@ -162,6 +218,7 @@ namespace Zint {
 
     void QZint::setPrimaryMessage(const QString & primaryMessage) {
         m_primaryMessage = primaryMessage;
+        m_dirty = true;
     }
 
     int QZint::height() const {
@@ -170,6 +227,7 @@ namespace Zint {
 
     void QZint::setHeight(int height) {
         m_height = height;
+        m_dirty = true;
     }
 
     int QZint::option2() const {
@@ -178,6 +236,7 @@ namespace Zint {
 
     void QZint::setOption2(int option) {
         m_option_2 = option;
+        m_dirty = true;
     }
 
     int QZint::option3() const {
@@ -186,6 +245,7 @@ namespace Zint {
 
     void QZint::setOption3(int option) {
         m_option_3 = option;
+        m_dirty = true;
     }
 
     float QZint::scale() const {
@@ -194,6 +254,7 @@ namespace Zint {
 
     void QZint::setScale(float scale) {
         m_scale = scale;
+        m_dirty = true;
     }
 
     bool QZint::dotty() const {
@@ -202,10 +263,12 @@ namespace Zint {
 
     void QZint::setDotty(bool dotty) {
         m_dotty = dotty;
+        m_dirty = true;
     }
 
     void QZint::setDotSize(float dot_size) {
         m_dot_size = dot_size;
+        m_dirty = true;
     }
 
     QColor QZint::fgColor() const {
@@ -240,6 +303,7 @@ namespace Zint {
         } else {
             m_borderType = 0;
         }
+        m_dirty = true;
     }
 
     int QZint::borderWidth() const {
@@ -250,14 +314,17 @@ namespace Zint {
         if (boderWidth < 0 || boderWidth > 16)
             boderWidth = 0;
         m_borderWidth = boderWidth;
+        m_dirty = true;
     }
 
     void QZint::setWhitespace(int whitespace) {
         m_whitespace = whitespace;
+        m_dirty = true;
     }
 
     void QZint::setVWhitespace(int vwhitespace) {
         m_vwhitespace = vwhitespace;
+        m_dirty = true;
     }
 
     int QZint::option1() const {
@@ -266,6 +333,7 @@ namespace Zint {
 
     void QZint::setOption1(int option_1) {
         m_option_1 = option_1;
+        m_dirty = true;
     }
 
     void QZint::setFontSetting(int fontSettingIndex) {
@@ -278,10 +346,12 @@ namespace Zint {
         } else {
             m_fontSetting = 0;
         }
+        m_dirty = true;
     }
 
     void QZint::setShowText(bool show) {
         m_show_hrt = show;
+        m_dirty = true;
     }
 
     void QZint::setTargetSize(int width, int height) {
@@ -291,6 +361,7 @@ namespace Zint {
 
     void QZint::setGSSep(bool gssep) {
         m_gssep = gssep;
+        m_dirty = true;
     }
 
     int QZint::rotateAngle() const {
@@ -321,18 +392,30 @@ namespace Zint {
         } else {
             m_eci = 0;
         }
+        m_dirty = true;
     }
 
     void QZint::setGS1Parens(bool gs1parens) {
         m_gs1parens = gs1parens;
+        m_dirty = true;
     }
 
     void QZint::setReaderInit(bool reader_init) {
         m_reader_init = reader_init;
+        m_dirty = true;
+    }
+
+    QZint::RenderMode QZint::renderMode() const {
+        return m_render_mode;
+    }
+
+    void QZint::setRenderMode(RenderMode mode) {
+        m_render_mode = mode;
     }
 
     void QZint::setDebug(bool debug) {
         m_debug = debug;
+        m_dirty = true;
     }
 
     bool QZint::hasHRT(int symbology) const {
@@ -384,209 +467,80 @@ namespace Zint {
     }
 
     bool QZint::save_to_file(QString filename) {
-        resetSymbol();
-        strcpy(m_zintSymbol->outfile, filename.toLatin1().left(255));
+        zint_symbol *symbol = createSymbol();
+        strcpy(symbol->outfile, filename.toLatin1().left(255));
         QByteArray bstr = m_text.toUtf8();
-        m_error = ZBarcode_Encode_and_Print(m_zintSymbol, (unsigned char *) bstr.data(), bstr.length(), m_rotate_angle);
-        if (m_error >= ZINT_ERROR) {
-            m_lastError = m_zintSymbol->errtxt;
-            return false;
-        } else {
-            return true;
-        }
-    }
-
-    Qt::GlobalColor QZint::colourToQtColor(int colour) {
-        switch (colour) {
-            case 1: // Cyan
-                return Qt::cyan;
-                break;
-            case 2: // Blue
-                return Qt::blue;
-                break;
-            case 3: // Magenta
-                return Qt::magenta;
-                break;
-            case 4: // Red
-                return Qt::red;
-                break;
-            case 5: // Yellow
-                return Qt::yellow;
-                break;
-            case 6: // Green
-                return Qt::green;
-                break;
-            case 8: // White
-                return Qt::white;
-                break;
-            default:
-                return Qt::black;
-                break;
+        m_error = ZBarcode_Encode_and_Print(symbol, (unsigned char *) bstr.data(), bstr.length(), m_rotate_angle);
+        m_lastError = m_error >= ZINT_ERROR ? QString(symbol->errtxt) : QString();
+        ZBarcode_Delete(symbol);
+        m_dirty = true; /* So error reset from the renderer on next render */
+        return m_error < ZINT_ERROR;
+    }
+
+    /* As `save_to_file()` but outputs to `data` instead, `filename` only determining the file type */
+    bool QZint::save_to_memfile(const QString &filename, QByteArray &data) {
+        zint_symbol *symbol = createSymbol();
+        symbol->output_options |= BARCODE_MEMORY_FILE;
+        strcpy(symbol->outfile, filename.toLatin1().left(255));
+        QByteArray bstr = m_text.toUtf8();
+        m_error = ZBarcode_Encode_and_Print(symbol, (unsigned char *) bstr.data(), bstr.length(), m_rotate_angle);
+        m_lastError = m_error >= ZINT_ERROR ? QString(symbol->errtxt) : QString();
+        if (m_error < ZINT_ERROR) {
+            data = QByteArray((const char *) symbol->memfile, symbol->memfile_size);
         }
+        ZBarcode_Delete(symbol);
+        m_dirty = true; /* So error reset from the renderer on next render */
+        return m_error < ZINT_ERROR;
+    }
+
+    /* Copies all settings (not the encoded symbol) from `other`, e.g. to set up a QZint for use on another thread */
+    void QZint::copySettings(const QZint &other) {
+        m_symbol = other.m_symbol;
+        m_text = other.m_text;
+        m_primaryMessage = other.m_primaryMessage;
+        m_height = other.m_height;
+        m_borderType = other.m_borderType;
+        m_borderWidth = other.m_borderWidth;
+        m_fontSetting = other.m_fontSetting;
+        m_option_2 = other.m_option_2;
+        m_option_1 = other.m_option_1;
+        m_input_mode = other.m_input_mode;
+        m_fgColor = other.m_fgColor;
+        m_bgColor = other.m_bgColor;
+        m_cmyk = other.m_cmyk;
+        m_whitespace = other.m_whitespace;
+        m_vwhitespace = other.m_vwhitespace;
+        m_scale = other.m_scale;
+        m_option_3 = other.m_option_3;
+        m_show_hrt = other.m_show_hrt;
+        m_eci = other.m_eci;
+        m_rotate_angle = other.m_rotate_angle;
+        m_dotty = other.m_dotty;
+        m_dot_size = other.m_dot_size;
+        target_size_horiz = other.target_size_horiz;
+        target_size_vert = other.target_size_vert;
+        m_gs1parens = other.m_gs1parens;
+        m_gssep = other.m_gssep;
+        m_reader_init = other.m_reader_init;
+        m_debug = other.m_debug;
+        m_dirty = true;
     }
 
     void QZint::render(QPainter & painter, const QRectF & paintRect, AspectRatioMode mode) {
-        struct zint_vector_rect *rect;
-        struct zint_vector_hexagon *hex;
-        struct zint_vector_circle *circle;
-        struct zint_vector_string *string;
-
         (void)mode; /* Not currently used */
 
-        encode();
-
-        painter.save();
-
-        if (m_error >= ZINT_ERROR) {
-            painter.setRenderHint(QPainter::Antialiasing);
-            QFont font(fontStyleError, fontSizeError);
-            painter.setFont(font);
-            painter.drawText(paintRect, Qt::AlignCenter | Qt::TextWordWrap, m_lastError);
-            painter.restore();
-            return;
-        }
-
-        painter.setClipRect(paintRect, Qt::IntersectClip);
-
-        qreal xtr = paintRect.x();
-        qreal ytr = paintRect.y();
-        qreal scale;
-
-        qreal gwidth = m_zintSymbol->vector->width;
-        qreal gheight = m_zintSymbol->vector->height;
-
-        if (m_rotate_angle == 90 || m_rotate_angle == 270) {
-            if (paintRect.width() / gheight < paintRect.height() / gwidth) {
-                scale = paintRect.width() / gheight;
-            } else {
-                scale = paintRect.height() / gwidth;
-            }
-        } else {
-            if (paintRect.width() / gwidth < paintRect.height() / gheight) {
-                scale = paintRect.width() / gwidth;
-            } else {
-                scale = paintRect.height() / gheight;
-            }
-        }
-
-        xtr += (qreal) (paintRect.width() - gwidth * scale) / 2.0;
-        ytr += (qreal) (paintRect.height() - gheight * scale) / 2.0;
-
-        if (m_rotate_angle) {
-            painter.translate(paintRect.width() / 2.0, paintRect.height() / 2.0); // Need to rotate around centre
-            painter.rotate(m_rotate_angle);
-            painter.translate(-paintRect.width() / 2.0, -paintRect.height() / 2.0); // Undo
-        }
-
-        painter.translate(xtr, ytr);
-        painter.scale(scale, scale);
-
-        QBrush bgBrush(m_bgColor);
-        painter.fillRect(QRectF(0, 0, gwidth, gheight), bgBrush);
-
-        //Red square for diagnostics
-        //painter.fillRect(QRect(0, 0, m_zintSymbol->vector->width, m_zintSymbol->vector->height), QBrush(QColor(255,0,0,255)));
-
-        // Plot rectangles
-        rect = m_zintSymbol->vector->rectangles;
-        if (rect) {
-            QBrush brush(Qt::SolidPattern);
-            while (rect) {
-                if (rect->colour == -1) {
-                    brush.setColor(m_fgColor);
-                } else {
-                    brush.setColor(colourToQtColor(rect->colour));
-                }
-                painter.fillRect(QRectF(rect->x, rect->y, rect->width, rect->height), brush);
-                rect = rect->next;
-            }
-        }
-
-        // Plot hexagons
-        hex = m_zintSymbol->vector->hexagons;
-        if (hex) {
-            painter.setRenderHint(QPainter::Antialiasing);
-            QBrush fgBrush(m_fgColor);
-            qreal previous_diameter = 0.0, radius = 0.0, half_radius = 0.0, half_sqrt3_radius = 0.0;
-            while (hex) {
-                if (previous_diameter != hex->diameter) {
-                    previous_diameter = hex->diameter;
-                    radius = 0.5 * previous_diameter;
-                    half_radius = 0.25 * previous_diameter;
-                    half_sqrt3_radius = 0.43301270189221932338 * previous_diameter;
-                }
-
-                QPainterPath pt;
-                pt.moveTo(hex->x, hex->y + radius);
-                pt.lineTo(hex->x + half_sqrt3_radius, hex->y + half_radius);
-                pt.lineTo(hex->x + half_sqrt3_radius, hex->y - half_radius);
-                pt.lineTo(hex->x, hex->y - radius);
-                pt.lineTo(hex->x - half_sqrt3_radius, hex->y - half_radius);
-                pt.lineTo(hex->x - half_sqrt3_radius, hex->y + half_radius);
-                pt.lineTo(hex->x, hex->y + radius);
-                painter.fillPath(pt, fgBrush);
-
-                hex = hex->next;
-            }
-        }
-
-        // Plot dots (circles)
-        circle = m_zintSymbol->vector->circles;
-        if (circle) {
-            painter.setRenderHint(QPainter::Antialiasing);
-            QPen p;
-            QBrush fgBrush(m_fgColor);
-            qreal previous_diameter = 0.0, radius = 0.0;
-            while (circle) {
-                if (previous_diameter != circle->diameter) {
-                    previous_diameter = circle->diameter;
-                    radius = 0.5 * previous_diameter;
-                }
-                if (circle->colour) { // Set means use background colour
-                    p.setColor(m_bgColor);
-                    p.setWidth(0);
-                    painter.setPen(p);
-                    painter.setBrush(bgBrush);
-                } else {
-                    p.setColor(m_fgColor);
-                    p.setWidth(0);
-                    painter.setPen(p);
-                    painter.setBrush(fgBrush);
-                }
-                painter.drawEllipse(QPointF(circle->x, circle->y), radius, radius);
-                circle = circle->next;
-            }
+        if (!m_job || !m_renderer) { /* If background encode in progress draw previous symbol */
+            encode();
         }
+        m_renderer->render(painter, paintRect, style());
+    }
 
-        // Plot text
-        string = m_zintSymbol->vector->strings;
-        if (string) {
-            painter.setRenderHint(QPainter::Antialiasing);
-            QPen p;
-            p.setColor(m_fgColor);
-            painter.setPen(p);
-            bool bold = (m_zintSymbol->output_options & BOLD_TEXT) && (!isExtendable() || (m_zintSymbol->output_options & SMALL_TEXT));
-            QFont font(fontStyle, -1 /*pointSize*/, bold ? QFont::Bold : -1);
-            while (string) {
-                font.setPixelSize(string->fsize);
-                painter.setFont(font);
-                QString content = QString::fromUtf8((const char *) string->text);
-                /* string->y is baseline of font */
-                if (string->halign == 1) { /* Left align */
-                    painter.drawText(QPointF(string->x, string->y), content);
-                } else {
-                    QFontMetrics fm(painter.fontMetrics());
-                    int width = fm.boundingRect(content).width();
-                    if (string->halign == 2) { /* Right align */
-                        painter.drawText(QPointF(string->x - width, string->y), content);
-                    } else { /* Centre align */
-                        painter.drawText(QPointF(string->x - (width / 2.0), string->y), content);
-                    }
-                }
-                string = string->next;
-            }
+    /* Draws the symbol fitted to `paintRect` at a whole number of device pixels per module (see
+       `QZintRenderer::renderPrint()`) */
+    void QZint::renderPrint(QPainter & painter, const QRectF & paintRect) {
+        if (!m_job || !m_renderer) { /* If background encode in progress draw previous symbol */
+            encode();
         }
-
-        painter.restore();
+        m_renderer->renderPrint(painter, paintRect, style());
     }
 }
@@ -20,17 +20,23 @@
 #define BARCODERENDER_H
 #include <QColor>
 #include <QPainter>
-#include "zint.h"
+#include <QSharedPointer>
+#include "qzintrenderer.h"
 
 namespace Zint
 {
 
+class QZintEncodeJob;
+
 class QZint : public QObject
 {
     Q_OBJECT
 
 public:
      enum AspectRatioMode{IgnoreAspectRatio=0, KeepAspectRatio=1, CenterBarCode=2};
+     /* How `render()` draws: `AutoRender` uses a raster image if the vector has many elements */
+     enum RenderMode{AutoRender=QZintRenderer::AutoRender, VectorRender=QZintRenderer::VectorRender,
+                     RasterRender=QZintRenderer::RasterRender};
 
 public:
     QZint();
@@ -105,6 +111,9 @@ public:
 
     void setDebug(bool debug);
 
+    RenderMode renderMode() const;
+    void setRenderMode(RenderMode mode);
+
     bool hasHRT(int symbology = 0) const;
     bool isExtendable(int symbology = 0) const;
     bool supportsECI(int symbology = 0) const;
@@ -121,18 +130,32 @@ public:
     bool hasErrors() const;
 
     bool save_to_file(QString filename);
+    bool save_to_memfile(const QString &filename, QByteArray &data);
+
+    void copySettings(const QZint &other);
 
     void render(QPainter & painter, const QRectF & paintRect, AspectRatioMode mode=IgnoreAspectRatio);
+    void renderPrint(QPainter & painter, const QRectF & paintRect);
+
+    void encodeInBackground();
+
+    QZintRenderer::Settings settings() const;
+    QZintRenderer::Style style() const;
+    QSharedPointer<const QZintRenderer> renderer();
     
     int getVersion() const;
 
 signals:
     void encoded();
+    void backgroundEncoded();
+
+private slots:
+    void encodeJobFinished();
 
 private:
-    void resetSymbol();
+    zint_symbol *createSymbol() const;
+    void updateFromSymbol();
     void encode();
-    static Qt::GlobalColor colourToQtColor(int colour);
 
 private:
     int m_symbol;
@@ -152,7 +175,7 @@ private:
     int m_error;
     int m_whitespace;
     int m_vwhitespace;
-    zint_symbol * m_zintSymbol;
+    QSharedPointer<QZintRenderer> m_renderer; /* Encoded symbol, NULL until first encode */
     float m_scale;
     int m_option_3;
     bool m_show_hrt;
@@ -166,6 +189,9 @@ private:
     bool m_gssep;
     bool m_reader_init;
     bool m_debug;
+    bool m_dirty; /* Set if symbol needs re-encoding */
+    QZintEncodeJob *m_job; /* Background encode in progress if non-NULL */
+    RenderMode m_render_mode;
 };
 }
 #endif
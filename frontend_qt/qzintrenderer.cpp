@@ -0,0 +1,610 @@
+/***************************************************************************
+ *   Copyright (C) 2008 by BogDan Vatra                                    *
+ *   bogdan@licentia.eu                                                    *
+ *   Copyright (C) 2010-2021 Robin Stuart                                  *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+/* vim: set ts=4 sw=4 et : */
+
+//#include <QDebug>
+#include "qzintrenderer.h"
+#include <string.h>
+#include <math.h>
+#include <QFont>
+#include <QFontMetrics>
+#include <QMutexLocker>
+
+namespace Zint {
+    static const char *fontStyle = "Helvetica";
+    static const char *fontStyleError = "Helvetica";
+    static const int fontSizeError = 14; /* Point size */
+    static const int rasterThreshold = 5000; /* Number of vector elements above which `AutoRender` uses raster */
+    static const qreal rasterMaxPixels = 64.0 * 1024 * 1024; /* Size limit of raster image, vector used if above */
+
+    QZintRenderer::Settings::Settings() {
+        symbol = BARCODE_CODE128;
+        height = 0;
+        borderType = 0;
+        borderWidth = 0;
+        fontSetting = 0;
+        option_1 = -1;
+        option_2 = 0;
+        option_3 = 0;
+        input_mode = UNICODE_MODE;
+        cmyk = false;
+        whitespace = 0;
+        vwhitespace = 0;
+        scale = 1.0f;
+        show_hrt = true;
+        eci = 0;
+        dotty = false;
+        dot_size = 4.0f / 5.0f;
+        gs1parens = false;
+        gssep = false;
+        reader_init = false;
+        debug = false;
+    }
+
+    QZintRenderer::Style::Style() {
+        fgColor = Qt::black;
+        bgColor = Qt::white;
+        rotateAngle = 0;
+        renderMode = AutoRender;
+    }
+
+    /* Encodes `settings`, building the paths here too so that all the work is done on the constructing thread */
+    QZintRenderer::QZintRenderer(const Settings &settings) : m_settings(settings) {
+        m_elements = 0;
+        m_raster_scale = 0;
+        m_raster_fg = m_raster_bg = 0;
+
+        m_zintSymbol = createSymbol(m_settings);
+        QByteArray bstr = m_settings.text.toUtf8();
+        m_error = ZBarcode_Encode_and_Buffer_Vector(m_zintSymbol, (unsigned char *) bstr.data(), bstr.length(),
+                    0); /* Note do our own rotation */
+        m_lastError = m_zintSymbol->errtxt;
+        m_bold = (m_zintSymbol->output_options & BOLD_TEXT)
+                    && (!ZBarcode_Cap(m_settings.symbol, ZINT_CAP_EXTENDABLE)
+                        || (m_zintSymbol->output_options & SMALL_TEXT));
+
+        if (m_error < ZINT_ERROR) {
+            buildPaths();
+        }
+    }
+
+    QZintRenderer::~QZintRenderer() {
+        ZBarcode_Delete(m_zintSymbol);
+    }
+
+    zint_symbol *QZintRenderer::createSymbol(const Settings &settings, const QColor &fgColor, const QColor &bgColor) {
+        zint_symbol *symbol = ZBarcode_Create();
+        symbol->output_options |= settings.borderType | settings.fontSetting;
+        symbol->symbology = settings.symbol;
+        symbol->height = settings.height;
+        symbol->whitespace_width = settings.whitespace;
+        symbol->whitespace_height = settings.vwhitespace;
+        symbol->border_width = settings.borderWidth;
+        symbol->option_1 = settings.option_1;
+        symbol->input_mode = settings.input_mode;
+        symbol->option_2 = settings.option_2;
+        if (settings.dotty) {
+            symbol->output_options |= BARCODE_DOTTY_MODE;
+        }
+        symbol->dot_size = settings.dot_size;
+        symbol->show_hrt = settings.show_hrt ? 1 : 0;
+        symbol->eci = settings.eci;
+        symbol->option_3 = settings.option_3;
+        symbol->scale = settings.scale;
+        if (settings.gs1parens) {
+            symbol->input_mode |= GS1PARENS_MODE;
+        }
+        if (settings.gssep) {
+            symbol->output_options |= GS1_GS_SEPARATOR;
+        }
+        if (settings.reader_init) {
+            symbol->output_options |= READER_INIT;
+        }
+        if (settings.debug) {
+            symbol->debug |= ZINT_DEBUG_PRINT;
+        }
+        strcpy(symbol->fgcolour, fgColor.name().toLatin1().right(6));
+        if (fgColor.alpha() != 0xff) {
+            strcat(symbol->fgcolour, fgColor.name(QColor::HexArgb).toLatin1().mid(1,2));
+        }
+        strcpy(symbol->bgcolour, bgColor.name().toLatin1().right(6));
+        if (bgColor.alpha() != 0xff) {
+            strcat(symbol->bgcolour, bgColor.name(QColor::HexArgb).toLatin1().mid(1,2));
+        }
+        if (settings.cmyk) {
+            symbol->output_options |= CMYK_COLOUR;
+        }
+        strcpy(symbol->primary, settings.primaryMessage.toLatin1().left(127));
+
+        return symbol;
+    }
+
+    const QZintRenderer::Settings &QZintRenderer::settings() const {
+        return m_settings;
+    }
+
+    int QZintRenderer::error() const {
+        return m_error;
+    }
+
+    const QString &QZintRenderer::lastError() const {
+        return m_lastError;
+    }
+
+    int QZintRenderer::borderType() const {
+        return m_zintSymbol->output_options & (BARCODE_BIND | BARCODE_BOX);
+    }
+
+    int QZintRenderer::height() const {
+        return m_zintSymbol->height;
+    }
+
+    int QZintRenderer::borderWidth() const {
+        return m_zintSymbol->border_width;
+    }
+
+    int QZintRenderer::whitespace() const {
+        return m_zintSymbol->whitespace_width;
+    }
+
+    int QZintRenderer::vwhitespace() const {
+        return m_zintSymbol->whitespace_height;
+    }
+
+    qreal QZintRenderer::vectorWidth() const {
+        return m_error < ZINT_ERROR ? m_zintSymbol->vector->width : 0.0;
+    }
+
+    qreal QZintRenderer::vectorHeight() const {
+        return m_error < ZINT_ERROR ? m_zintSymbol->vector->height : 0.0;
+    }
+
+    Qt::GlobalColor QZintRenderer::colourToQtColor(int colour) {
+        switch (colour) {
+            case 1: // Cyan
+                return Qt::cyan;
+                break;
+            case 2: // Blue
+                return Qt::blue;
+                break;
+            case 3: // Magenta
+                return Qt::magenta;
+                break;
+            case 4: // Red
+                return Qt::red;
+                break;
+            case 5: // Yellow
+                return Qt::yellow;
+                break;
+            case 6: // Green
+                return Qt::green;
+                break;
+            case 8: // White
+                return Qt::white;
+                break;
+            default:
+                return Qt::black;
+                break;
+        }
+    }
+
+    /* Builds the rectangle lists (grouped by colour), hexagon and dotty mode paths from the vector, in symbol
+       co-ordinates so independent of paint size and rotation */
+    void QZintRenderer::buildPaths() {
+        struct zint_vector_rect *rect;
+        struct zint_vector_hexagon *hex;
+        struct zint_vector_circle *circle;
+
+        rect = m_zintSymbol->vector->rectangles;
+        while (rect) {
+            m_elements++;
+            /* Index 0 foreground, 1-8 Ultracode colours, anything else black as `colourToQtColor()` */
+            int idx = rect->colour == -1 ? 0 : rect->colour >= 1 && rect->colour <= 8 ? rect->colour : 7;
+            m_rects[idx].append(QRectF(rect->x, rect->y, rect->width, rect->height));
+            rect = rect->next;
+        }
+
+        hex = m_zintSymbol->vector->hexagons;
+        if (hex) {
+            qreal previous_diameter = 0.0, radius = 0.0, half_radius = 0.0, half_sqrt3_radius = 0.0;
+            while (hex) {
+                if (previous_diameter != hex->diameter) {
+                    previous_diameter = hex->diameter;
+                    radius = 0.5 * previous_diameter;
+                    half_radius = 0.25 * previous_diameter;
+                    half_sqrt3_radius = 0.43301270189221932338 * previous_diameter;
+                }
+
+                m_hexPath.moveTo(hex->x, hex->y + radius);
+                m_hexPath.lineTo(hex->x + half_sqrt3_radius, hex->y + half_radius);
+                m_hexPath.lineTo(hex->x + half_sqrt3_radius, hex->y - half_radius);
+                m_hexPath.lineTo(hex->x, hex->y - radius);
+                m_hexPath.lineTo(hex->x - half_sqrt3_radius, hex->y - half_radius);
+                m_hexPath.lineTo(hex->x - half_sqrt3_radius, hex->y + half_radius);
+                m_hexPath.closeSubpath();
+
+                m_elements++;
+                hex = hex->next;
+            }
+        }
+
+        circle = m_zintSymbol->vector->circles;
+        if (circle && m_zintSymbol->vector->circles_diameter) {
+            // All the same shape (dotty mode), so a single path of copies of one dot
+            const qreal radius = 0.5 * m_zintSymbol->vector->circles_diameter;
+            QPainterPath dot;
+            dot.addEllipse(QPointF(0.0, 0.0), radius, radius);
+            m_dotsPath.setFillRule(Qt::WindingFill); // Large dots may overlap
+            while (circle) {
+                m_dotsPath.addPath(dot.translated(circle->x, circle->y));
+                m_elements++;
+                circle = circle->next;
+            }
+        }
+    }
+
+    /* Draws the symbol from a cached ZBarcode_Buffer() image at a whole number of device pixels per module, `painter`
+       being set up to draw in vector co-ordinates. If `raster_scale` is zero the number of pixels per module is taken
+       from the device transform. Returns false if couldn't, in which case caller draws vector */
+    bool QZintRenderer::renderRaster(QPainter &painter, const Style &style, int raster_scale) const {
+        const QTransform &t = painter.deviceTransform();
+        qreal pixels_per_unit = sqrt(t.m11() * t.m11() + t.m12() * t.m12()) * painter.device()->devicePixelRatioF();
+        const QRgb fg = style.fgColor.rgba();
+        const QRgb bg = style.bgColor.rgba();
+        QImage image;
+
+        if (raster_scale == 0) {
+            raster_scale = (int) (pixels_per_unit * 2.0 * m_settings.scale); /* Pixels per module */
+        }
+        if (raster_scale < 1) {
+            raster_scale = 1;
+        }
+
+        {
+            QMutexLocker locker(&m_raster_mutex);
+
+            if (raster_scale != m_raster_scale) {
+                const float scale = m_zintSymbol->scale;
+                const int output_options = m_zintSymbol->output_options;
+                int error;
+
+                /* Worst case pixel count of new image */
+                if ((qreal) m_zintSymbol->vector->width * m_zintSymbol->vector->height * raster_scale * raster_scale
+                        / (4.0 * m_settings.scale * m_settings.scale) > rasterMaxPixels) {
+                    return false;
+                }
+                /* Get colour codes rather than RGB, colours being applied by the colour table */
+                m_zintSymbol->scale = raster_scale / 2.0f;
+                m_zintSymbol->output_options |= OUT_BUFFER_INTERMEDIATE;
+                error = ZBarcode_Buffer(m_zintSymbol, 0);
+                m_zintSymbol->scale = scale;
+                m_zintSymbol->output_options = output_options;
+                if (error >= ZINT_ERROR) {
+                    return false;
+                }
+                m_raster_image = QImage(m_zintSymbol->bitmap, m_zintSymbol->bitmap_width,
+                                        m_zintSymbol->bitmap_height, m_zintSymbol->bitmap_width,
+                                        QImage::Format_Indexed8).copy();
+                m_raster_scale = raster_scale;
+                m_raster_fg = ~fg; /* Force colour table */
+            }
+
+            if (fg != m_raster_fg || bg != m_raster_bg) {
+                /* Detaches from any copies being drawn by other threads */
+                QVector<QRgb> colours(256, fg);
+                colours['0'] = bg;
+                colours['W'] = QColor(Qt::white).rgba();
+                colours['C'] = QColor(Qt::cyan).rgba();
+                colours['B'] = QColor(Qt::blue).rgba();
+                colours['M'] = QColor(Qt::magenta).rgba();
+                colours['R'] = QColor(Qt::red).rgba();
+                colours['Y'] = QColor(Qt::yellow).rgba();
+                colours['G'] = QColor(Qt::green).rgba();
+                colours['K'] = QColor(Qt::black).rgba();
+                m_raster_image.setColorTable(colours);
+                m_raster_fg = fg;
+                m_raster_bg = bg;
+            }
+            image = m_raster_image; /* Shallow copy */
+        }
+
+        /* One image pixel per device pixel, centred */
+        const qreal width = image.width() / pixels_per_unit;
+        const qreal height = image.height() / pixels_per_unit;
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+        painter.drawImage(QRectF((m_zintSymbol->vector->width - width) / 2.0,
+                                (m_zintSymbol->vector->height - height) / 2.0, width, height), image);
+        return true;
+    }
+
+    /* Draws the error message centred in `paintRect` */
+    void QZintRenderer::renderError(QPainter &painter, const QRectF &paintRect) const {
+        painter.save();
+        painter.setRenderHint(QPainter::Antialiasing);
+        QFont font(fontStyleError, fontSizeError);
+        painter.setFont(font);
+        painter.drawText(paintRect, Qt::AlignCenter | Qt::TextWordWrap, m_lastError);
+        painter.restore();
+    }
+
+    void QZintRenderer::render(QPainter &painter, const QRectF &paintRect, const Style &style) const {
+        if (m_error >= ZINT_ERROR) {
+            renderError(painter, paintRect);
+            return;
+        }
+
+        painter.save();
+
+        painter.setClipRect(paintRect, Qt::IntersectClip);
+
+        qreal xtr = paintRect.x();
+        qreal ytr = paintRect.y();
+        qreal scale;
+
+        qreal gwidth = m_zintSymbol->vector->width;
+        qreal gheight = m_zintSymbol->vector->height;
+
+        if (style.rotateAngle == 90 || style.rotateAngle == 270) {
+            if (paintRect.width() / gheight < paintRect.height() / gwidth) {
+                scale = paintRect.width() / gheight;
+            } else {
+                scale = paintRect.height() / gwidth;
+            }
+        } else {
+            if (paintRect.width() / gwidth < paintRect.height() / gheight) {
+                scale = paintRect.width() / gwidth;
+            } else {
+                scale = paintRect.height() / gheight;
+            }
+        }
+
+        xtr += (qreal) (paintRect.width() - gwidth * scale) / 2.0;
+        ytr += (qreal) (paintRect.height() - gheight * scale) / 2.0;
+
+        if (style.rotateAngle) {
+            painter.translate(paintRect.width() / 2.0, paintRect.height() / 2.0); // Need to rotate around centre
+            painter.rotate(style.rotateAngle);
+            painter.translate(-paintRect.width() / 2.0, -paintRect.height() / 2.0); // Undo
+        }
+
+        painter.translate(xtr, ytr);
+        painter.scale(scale, scale);
+
+        QBrush bgBrush(style.bgColor);
+        painter.fillRect(QRectF(0, 0, gwidth, gheight), bgBrush);
+
+        //Red square for diagnostics
+        //painter.fillRect(QRect(0, 0, m_zintSymbol->vector->width, m_zintSymbol->vector->height), QBrush(QColor(255,0,0,255)));
+
+        if (style.renderMode == RasterRender || (style.renderMode == AutoRender && m_elements > rasterThreshold)) {
+            if (renderRaster(painter, style)) {
+                painter.restore();
+                return;
+            }
+        }
+
+        renderVector(painter, style);
+
+        painter.restore();
+    }
+
+    /* Draws the symbol fitted to `paintRect` at a whole number of device pixels per module, with the origin on a
+       device pixel, so that the rectangles of each module map exactly onto device pixels with no resampling or
+       antialiasing. Intended for printers, drawing at their native resolution rather than as scaled for the screen.
+       Draws from a raster image if `RasterRender` set, else draws the vector */
+    void QZintRenderer::renderPrint(QPainter &painter, const QRectF &paintRect, const Style &style) const {
+        if (m_error >= ZINT_ERROR) {
+            renderError(painter, paintRect);
+            return;
+        }
+
+        const QRectF devRect = painter.deviceTransform().mapRect(paintRect);
+        const qreal units_per_module = 2.0 * m_settings.scale;
+        const qreal gwidth = m_zintSymbol->vector->width;
+        const qreal gheight = m_zintSymbol->vector->height;
+        const bool sideways = style.rotateAngle == 90 || style.rotateAngle == 270;
+        const qreal modules_across = (sideways ? gheight : gwidth) / units_per_module;
+        const qreal modules_down = (sideways ? gwidth : gheight) / units_per_module;
+
+        int pixels_per_module = (int) qMin(devRect.width() / modules_across, devRect.height() / modules_down);
+        if (pixels_per_module < 1) {
+            pixels_per_module = 1;
+        }
+        const qreal pixels_per_unit = pixels_per_module / units_per_module;
+        const qreal width = modules_across * pixels_per_module;
+        const qreal height = modules_down * pixels_per_module;
+
+        painter.save();
+
+        /* Work in device pixels */
+        painter.resetTransform();
+        painter.setClipRect(devRect, Qt::IntersectClip);
+        painter.translate(qRound(devRect.x() + (devRect.width() - width) / 2.0),
+                            qRound(devRect.y() + (devRect.height() - height) / 2.0));
+        if (style.rotateAngle) {
+            /* Rotating about the centre leaves the origin on a whole pixel as the sides are swapped if sideways */
+            painter.translate(width / 2.0, height / 2.0);
+            painter.rotate(style.rotateAngle);
+            painter.translate(-gwidth * pixels_per_unit / 2.0, -gheight * pixels_per_unit / 2.0);
+        }
+        painter.scale(pixels_per_unit, pixels_per_unit);
+
+        painter.setRenderHint(QPainter::Antialiasing, false);
+        painter.fillRect(QRectF(0, 0, gwidth, gheight), QBrush(style.bgColor));
+
+        if (style.renderMode != RasterRender || !renderRaster(painter, style, pixels_per_module)) {
+            renderVector(painter, style);
+        }
+
+        painter.restore();
+    }
+
+    /* Uses `renderPrint()` on an image of exactly the symbol's size at `pixelsPerModule` */
+    QImage QZintRenderer::toImage(int pixelsPerModule, const Style &style) const {
+        if (m_error >= ZINT_ERROR) {
+            return QImage();
+        }
+        if (pixelsPerModule < 1) {
+            pixelsPerModule = 1;
+        }
+        const qreal pixels_per_unit = pixelsPerModule / (2.0 * m_settings.scale);
+        const bool sideways = style.rotateAngle == 90 || style.rotateAngle == 270;
+        const int width = qRound((sideways ? m_zintSymbol->vector->height : m_zintSymbol->vector->width)
+                                    * pixels_per_unit);
+        const int height = qRound((sideways ? m_zintSymbol->vector->width : m_zintSymbol->vector->height)
+                                    * pixels_per_unit);
+
+        QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+        if (image.isNull()) { /* Too big */
+            return image;
+        }
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        renderPrint(painter, QRectF(0, 0, width, height), style);
+        painter.end();
+        return image;
+    }
+
+    QPainterPath QZintRenderer::toPath() const {
+        QPainterPath path;
+
+        if (m_error >= ZINT_ERROR) {
+            return path;
+        }
+        path.setFillRule(Qt::WindingFill);
+        for (int i = 0; i < 9; i++) {
+            for (int j = 0; j < m_rects[i].size(); j++) {
+                path.addRect(m_rects[i][j]);
+            }
+        }
+        path.addPath(m_hexPath);
+        if (m_zintSymbol->vector->circles_diameter) {
+            path.addPath(m_dotsPath);
+        } else {
+            struct zint_vector_circle *circle = m_zintSymbol->vector->circles;
+            while (circle) {
+                const qreal radius = 0.5 * circle->diameter;
+                path.addEllipse(QPointF(circle->x, circle->y), radius, radius);
+                circle = circle->next;
+            }
+        }
+
+        struct zint_vector_string *string = m_zintSymbol->vector->strings;
+        QFont font(fontStyle, -1 /*pointSize*/, m_bold ? QFont::Bold : -1);
+        while (string) {
+            font.setPixelSize(string->fsize);
+            QString content = QString::fromUtf8((const char *) string->text);
+            QFontMetrics fm(font);
+            int width = fm.boundingRect(content).width();
+            /* string->y is baseline of font */
+            qreal x = string->halign == 1 ? string->x : string->halign == 2 ? string->x - width
+                        : string->x - (width / 2.0);
+            path.addText(QPointF(x, string->y), font, content);
+            string = string->next;
+        }
+
+        return path;
+    }
+
+    /* Draws the vector elements, `painter` being set up to draw in vector co-ordinates over the background */
+    void QZintRenderer::renderVector(QPainter &painter, const Style &style) const {
+        struct zint_vector_circle *circle;
+        struct zint_vector_string *string;
+        QBrush bgBrush(style.bgColor);
+
+        // Plot rectangles, one call per colour
+        painter.setPen(Qt::NoPen);
+        for (int i = 0; i < 9; i++) {
+            if (!m_rects[i].isEmpty()) {
+                painter.setBrush(QBrush(i == 0 ? style.fgColor : QColor(colourToQtColor(i))));
+                painter.drawRects(m_rects[i].constData(), m_rects[i].size());
+            }
+        }
+
+        // Plot hexagons
+        if (m_zintSymbol->vector->hexagons) {
+            painter.setRenderHint(QPainter::Antialiasing);
+            QBrush fgBrush(style.fgColor);
+            // Hexagons don't overlap so can all be filled at once
+            painter.fillPath(m_hexPath, fgBrush);
+        }
+
+        // Plot dots (circles)
+        circle = m_zintSymbol->vector->circles;
+        if (circle && m_zintSymbol->vector->circles_diameter) {
+            // All the same shape (dotty mode), so draw as a single path of copies of one dot
+            painter.setRenderHint(QPainter::Antialiasing);
+            QPen p(circle->colour ? style.bgColor : style.fgColor); // Set means use background colour
+            p.setWidth(0);
+            painter.setPen(p);
+            painter.setBrush(circle->colour ? bgBrush : QBrush(style.fgColor));
+            painter.drawPath(m_dotsPath);
+        } else if (circle) {
+            painter.setRenderHint(QPainter::Antialiasing);
+            QPen p;
+            QBrush fgBrush(style.fgColor);
+            qreal previous_diameter = 0.0, radius = 0.0;
+            while (circle) {
+                if (previous_diameter != circle->diameter) {
+                    previous_diameter = circle->diameter;
+                    radius = 0.5 * previous_diameter;
+                }
+                if (circle->colour) { // Set means use background colour
+                    p.setColor(style.bgColor);
+                    p.setWidth(0);
+                    painter.setPen(p);
+                    painter.setBrush(bgBrush);
+                } else {
+                    p.setColor(style.fgColor);
+                    p.setWidth(0);
+                    painter.setPen(p);
+                    painter.setBrush(fgBrush);
+                }
+                painter.drawEllipse(QPointF(circle->x, circle->y), radius, radius);
+                circle = circle->next;
+            }
+        }
+
+        // Plot text
+        string = m_zintSymbol->vector->strings;
+        if (string) {
+            painter.setRenderHint(QPainter::Antialiasing);
+            QPen p;
+            p.setColor(style.fgColor);
+            painter.setPen(p);
+            QFont font(fontStyle, -1 /*pointSize*/, m_bold ? QFont::Bold : -1);
+            while (string) {
+                font.setPixelSize(string->fsize);
+                painter.setFont(font);
+                QString content = QString::fromUtf8((const char *) string->text);
+                /* string->y is baseline of font */
+                if (string->halign == 1) { /* Left align */
+                    painter.drawText(QPointF(string->x, string->y), content);
+                } else {
+                    QFontMetrics fm(painter.fontMetrics());
+                    int width = fm.boundingRect(content).width();
+                    if (string->halign == 2) { /* Right align */
+                        painter.drawText(QPointF(string->x - width, string->y), content);
+                    } else { /* Centre align */
+                        painter.drawText(QPointF(string->x - (width / 2.0), string->y), content);
+                    }
+                }
+                string = string->next;
+            }
+        }
+    }
+}
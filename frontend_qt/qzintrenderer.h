@@ -0,0 +1,145 @@
+/***************************************************************************
+ *   Copyright (C) 2008 by BogDan Vatra                                    *
+ *   bogdan@licentia.eu                                                    *
+ *   Copyright (C) 2010-2021 Robin Stuart                                  *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+/* vim: set ts=4 sw=4 et : */
+
+#ifndef QZINTRENDERER_H
+#define QZINTRENDERER_H
+#include <QColor>
+#include <QImage>
+#include <QMutex>
+#include <QPainter>
+#include <QPainterPath>
+#include <QString>
+#include <QVector>
+#include "zint.h"
+
+namespace Zint
+{
+
+/* Encodes a symbol once on construction from a copy of its settings and draws it with QPainter. Not a QObject and
+   never changed after construction (apart from an internal mutex-protected raster cache), so an instance can be
+   created on any thread and its const methods called from many threads at the same time, e.g. shared via
+   `QZint::renderer()`. Painting text needs a QGuiApplication to exist (for fonts) but not the GUI thread */
+class QZintRenderer
+{
+public:
+    /* How `render()` draws: `AutoRender` uses a raster image if the vector has many elements */
+    enum RenderMode{AutoRender=0, VectorRender=1, RasterRender=2};
+
+    /* Settings affecting the encode, as set by the `QZint` setters (already converted from their indexes) */
+    struct Settings {
+        int symbol;
+        QString text;
+        QString primaryMessage;
+        int height;
+        int borderType; /* BARCODE_BIND, BARCODE_BOX or 0 */
+        int borderWidth;
+        int fontSetting; /* BOLD_TEXT and/or SMALL_TEXT */
+        int option_1;
+        int option_2;
+        int option_3;
+        int input_mode;
+        bool cmyk;
+        int whitespace;
+        int vwhitespace;
+        float scale;
+        bool show_hrt;
+        int eci;
+        bool dotty;
+        float dot_size;
+        bool gs1parens;
+        bool gssep;
+        bool reader_init;
+        bool debug;
+
+        Settings();
+    };
+
+    /* How an encoded symbol is drawn, changeable without re-encoding */
+    struct Style {
+        QColor fgColor;
+        QColor bgColor;
+        int rotateAngle; /* 0, 90, 180 or 270 */
+        RenderMode renderMode;
+
+        Style();
+    };
+
+    explicit QZintRenderer(const Settings &settings);
+    ~QZintRenderer();
+
+    const Settings &settings() const;
+
+    int error() const;
+    const QString &lastError() const;
+
+    /* Settings as adjusted by the encode */
+    int borderType() const;
+    int height() const;
+    int borderWidth() const;
+    int whitespace() const;
+    int vwhitespace() const;
+
+    /* Size of the vector in symbol co-ordinates (unrotated), zero if error */
+    qreal vectorWidth() const;
+    qreal vectorHeight() const;
+
+    /* Draws the symbol scaled to fit `paintRect`, or the error message if encoding failed */
+    void render(QPainter &painter, const QRectF &paintRect, const Style &style = Style()) const;
+    /* As `render()` but at a whole number of device pixels per module, e.g. for printers */
+    void renderPrint(QPainter &painter, const QRectF &paintRect, const Style &style = Style()) const;
+
+    /* Returns the symbol drawn at `pixelsPerModule` (rotated as `style`), a null image if encoding failed */
+    QImage toImage(int pixelsPerModule, const Style &style = Style()) const;
+    /* Returns the outline of all the elements (incl. text) in symbol co-ordinates, colours ignored */
+    QPainterPath toPath() const;
+
+    /* Returns a new symbol set up with `settings`, `fgColor` and `bgColor`, for the caller to encode and delete */
+    static zint_symbol *createSymbol(const Settings &settings, const QColor &fgColor = Qt::black,
+                                        const QColor &bgColor = Qt::white);
+
+private:
+    QZintRenderer(const QZintRenderer &);
+    QZintRenderer &operator=(const QZintRenderer &);
+
+    void buildPaths();
+    bool renderRaster(QPainter &painter, const Style &style, int raster_scale = 0) const;
+    void renderVector(QPainter &painter, const Style &style) const;
+    void renderError(QPainter &painter, const QRectF &paintRect) const;
+    static Qt::GlobalColor colourToQtColor(int colour);
+
+private:
+    const Settings m_settings;
+    zint_symbol *m_zintSymbol;
+    int m_error;
+    QString m_lastError;
+    bool m_bold; /* Whether text is bold, from `m_zintSymbol->output_options` */
+    QVector<QRectF> m_rects[9]; /* Rectangles by colour, index 0 foreground, 1-8 Ultracode colours */
+    QPainterPath m_hexPath;
+    QPainterPath m_dotsPath;
+    int m_elements; /* Number of rectangles, hexagons and circles in vector */
+
+    /* Raster cache, only accessed with `m_raster_mutex` locked, as is `m_zintSymbol` when buffering; draws are done
+       from a shallow copy outside the lock */
+    mutable QMutex m_raster_mutex;
+    mutable QImage m_raster_image; /* Colour codes image from ZBarcode_Buffer() with OUT_BUFFER_INTERMEDIATE */
+    mutable int m_raster_scale; /* Pixels per module of `m_raster_image`, 0 if not valid */
+    mutable QRgb m_raster_fg; /* Colours of the colour table of `m_raster_image` */
+    mutable QRgb m_raster_bg;
+};
+}
+#endif
@@ -24,10 +24,52 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QSettings>
+#include <limits.h>
 
 #include "sequencewindow.h"
 #include "exportwindow.h"
 
+static const int previewMax = 1000; /* Maximum number of generated items shown in preview */
+
+SequenceText::SequenceText(const QString &text) : m_text(text)
+{
+    int i;
+
+    /* Only lines terminated by a newline are counted */
+    m_starts << 0;
+    for (i = m_text.indexOf(QChar('\n')); i != -1; i = m_text.indexOf(QChar('\n'), i + 1)) {
+        m_starts << i + 1;
+    }
+}
+
+int SequenceText::count() const
+{
+    return m_starts.size() - 1;
+}
+
+QString SequenceText::item(int i) const
+{
+    return m_text.mid(m_starts[i], m_starts[i + 1] - 1 - m_starts[i]);
+}
+
+SequenceGenerator::SequenceGenerator(int start, int stop, int step, const QString &format)
+        : m_start(start), m_step(step), m_format(format)
+{
+    qint64 count = ((qint64) stop - start) / step + 1;
+
+    m_count = count > INT_MAX ? INT_MAX : (int) count;
+}
+
+int SequenceGenerator::count() const
+{
+    return m_count;
+}
+
+QString SequenceGenerator::item(int i) const
+{
+    return apply_format(m_format, QString::number(m_start + (qint64) i * m_step, 10));
+}
+
 SequenceWindow::SequenceWindow()
 {
     setupUi(this);
@@ -45,6 +87,7 @@ SequenceWindow::SequenceWindow()
     linStartVal->setValidator(intvalid);
     linEndVal->setValidator(intvalid);
     linIncVal->setValidator(intvalid);
+    m_generator = NULL;
     connect(btnClose, SIGNAL( clicked( bool )), SLOT(quit_now()));
     connect(btnReset, SIGNAL( clicked( bool )), SLOT(reset_preview()));
     connect(btnCreate, SIGNAL( clicked( bool )), SLOT(create_sequence()));
@@ -64,6 +107,8 @@ SequenceWindow::~SequenceWindow()
     settings.setValue("studio/sequence/end_value", linEndVal->text());
     settings.setValue("studio/sequence/increment", linIncVal->text());
     settings.setValue("studio/sequence/format", linFormat->text());
+
+    delete m_generator;
 }
 
 void SequenceWindow::quit_now()
@@ -76,14 +121,12 @@ void SequenceWindow::reset_preview()
     txtPreview->clear();
 }
 
-QString SequenceWindow::apply_format(QString raw_number)
+QString SequenceGenerator::apply_format(const QString &format, const QString &raw_number)
 {
     QString adjusted, reversed;
-    QString format;
     int format_len, input_len, i, inpos;
     QChar format_qchar;
 
-    format = linFormat->text();
     input_len = raw_number.length();
     format_len = format.length();
 
@@ -133,7 +176,7 @@ QString SequenceWindow::apply_format(QString raw_number)
 void SequenceWindow::create_sequence()
 {
     QString startval, endval, incval, part, outputtext;
-    int start, stop, step, i;
+    int start, stop, step, i, count;
     bool ok;
 
     startval = linStartVal->text();
@@ -148,19 +191,37 @@ void SequenceWindow::create_sequence()
         return;
     }
 
-    for(i = start; i <= stop; i += step) {
-        part = apply_format(QString::number(i, 10));
+    /* Items are generated on demand when exporting, with only the first `previewMax` shown */
+    SequenceGenerator *generator = new SequenceGenerator(start, stop, step, linFormat->text());
+    count = generator->count();
+    for(i = 0; i < count && i < previewMax; i++) {
+        part = generator->item(i);
         part += '\n';
         outputtext += part;
     }
+    if (count > previewMax) {
+        outputtext += tr("... (%1 items)").arg(count);
+        outputtext += '\n';
+    }
 
     txtPreview->setPlainText(outputtext);
+    /* Set after `setPlainText()` as its `check_generate()` drops any generator */
+    m_generator = generator;
+    /* Can't edit a truncated preview */
+    txtPreview->setReadOnly(count > previewMax);
 }
 
 void SequenceWindow::check_generate()
 {
     QString preview_copy;
 
+    /* Preview edited, cleared or imported so no longer the generated sequence */
+    if (m_generator) {
+        delete m_generator;
+        m_generator = NULL;
+        txtPreview->setReadOnly(false);
+    }
+
     preview_copy = txtPreview->toPlainText();
     if(preview_copy.isEmpty()) {
         btnExport->setEnabled(false);
@@ -209,6 +270,12 @@ void SequenceWindow::generate_sequence()
 {
     ExportWindow dlg;
     dlg.barcode = barcode;
-    dlg.output_data = txtPreview->toPlainText();
-    dlg.exec();
+    if (m_generator) {
+        dlg.source = m_generator;
+        dlg.exec();
+    } else {
+        SequenceText text(txtPreview->toPlainText());
+        dlg.source = &text;
+        dlg.exec();
+    }
 }
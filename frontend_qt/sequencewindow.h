@@ -22,6 +22,37 @@
 
 #include "ui_extSequence.h"
 #include "barcodeitem.h"
+#include "exportwindow.h"
+
+/* Newline-terminated lines of text, e.g. an edited or imported preview */
+class SequenceText : public SequenceSource
+{
+public:
+	SequenceText(const QString &text);
+	int count() const;
+	QString item(int i) const;
+
+private:
+	QString m_text;
+	QVector<int> m_starts; /* Start of each line, plus one past the final newline */
+};
+
+/* Formatted numbers `start`, `start + step`, ... up to `stop`, generated on demand */
+class SequenceGenerator : public SequenceSource
+{
+public:
+	SequenceGenerator(int start, int stop, int step, const QString &format);
+	int count() const;
+	QString item(int i) const;
+
+	static QString apply_format(const QString &format, const QString &raw_number);
+
+private:
+	int m_start;
+	int m_step;
+	int m_count;
+	QString m_format;
+};
 
 class SequenceWindow : public QDialog, private Ui::SequenceDialog
 {
@@ -33,7 +64,7 @@ public:
 	BarcodeItem *barcode;
 
 private:
-	QString apply_format(QString raw_number);
+	SequenceGenerator *m_generator; /* Source of the preview if generated and not since edited */
 
 private slots:
 	void quit_now();
@@ -133,6 +133,7 @@ rm -rf $RPM_BUILD_ROOT
 %files -n %{name}-qt-devel
 %defattr(-,root,root,-)
 %{_includedir}/qzint.h
+%{_includedir}/qzintrenderer.h
 %{_libdir}/libQZint.so
 
 